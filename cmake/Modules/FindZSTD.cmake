@@ -0,0 +1,13 @@
+# Find zstd library
+# Once done this will define
+#  ZSTD_FOUND - libzstd found
+#  ZSTD_INCLUDE_DIR - directory of zstd.h
+#  ZSTD_LIBRARY - the library to link against
+if(NOT ZSTD_FOUND)
+  find_path(ZSTD_INCLUDE_DIR NAMES zstd.h)
+  find_library(ZSTD_LIBRARY NAMES zstd PATH_SUFFIXES lib lib64)
+
+  include(FindPackageHandleStandardArgs)
+  find_package_handle_standard_args(ZSTD DEFAULT_MSG ZSTD_LIBRARY ZSTD_INCLUDE_DIR)
+  mark_as_advanced(ZSTD_FOUND ZSTD_INCLUDE_DIR ZSTD_LIBRARY)
+endif()
@@ -24,6 +24,7 @@ endif ()
 set(GALOIS_ENABLE_PAPI OFF CACHE BOOL "Use PAPI counters for profiling")
 set(GALOIS_ENABLE_VTUNE OFF CACHE BOOL "Use VTune for profiling")
 set(GALOIS_STRICT_CONFIG OFF CACHE BOOL "Instead of falling back gracefully, fail")
+set(GALOIS_LOG_MIN_LEVEL "" CACHE STRING "Lowest level of GALOIS_LOG messages compiled in, from 0 (Debug) to 4 (Error); by default 0 in builds without NDEBUG and 1 otherwise")
 set(GALOIS_GRAPH_LOCATION "" CACHE PATH "Location of inputs for tests if downloaded/stored separately.")
 set(CXX_CLANG_TIDY "" CACHE STRING "Semi-colon separated list of clang-tidy command and arguments")
 set(CMAKE_CXX_COMPILER_LAUNCHER "" CACHE STRING "Semi-colon separated list of command and arguments to wrap compiler invocations (e.g., ccache)")
@@ -203,6 +204,10 @@ if (GALOIS_ENABLE_PAPI)
   add_definitions(-DGALOIS_ENABLE_PAPI)
 endif ()
 
+if (NOT GALOIS_LOG_MIN_LEVEL STREQUAL "")
+  add_definitions(-DGALOIS_LOG_MIN_LEVEL=${GALOIS_LOG_MIN_LEVEL})
+endif ()
+
 find_package(NUMA)
 
 find_package(Threads REQUIRED)
@@ -226,6 +231,11 @@ if (NOT MySQL_FOUND)
   message(STATUS "Library MySQL not found, not building MySQL support")
 endif ()
 
+find_package(ZSTD)
+if (NOT ZSTD_FOUND)
+  message(STATUS "Library zstd not found, not building zstd input support")
+endif ()
+
 foreach (llvm_step RANGE 2)
   # Range is [0, end]. Start version search from highest compatible version
   # first.
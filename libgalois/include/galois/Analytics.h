@@ -1,7 +1,19 @@
 #ifndef GALOIS_LIBGALOIS_GALOIS_ANALYTICS_H_
 #define GALOIS_LIBGALOIS_GALOIS_ANALYTICS_H_
 
+#include <galois/analytics/PartitionQuality.h>
 #include <galois/analytics/bfs/bfs.h>
+#include <galois/analytics/bipartite_matching/bipartite_matching.h>
+#include <galois/analytics/connected_components/connected_components.h>
+#include <galois/analytics/graph_coloring/graph_coloring.h>
+#include <galois/analytics/independent_set/independent_set.h>
+#include <galois/analytics/jaccard/jaccard.h>
+#include <galois/analytics/k_core/k_core.h>
+#include <galois/analytics/k_truss/k_truss.h>
+#include <galois/analytics/minimum_spanning_forest/minimum_spanning_forest.h>
+#include <galois/analytics/pagerank/pagerank.h>
+#include <galois/analytics/random_walks/random_walks.h>
 #include <galois/analytics/sssp/sssp.h>
+#include <galois/analytics/triangle_count/triangle_count.h>
 
 #endif
@@ -1,3 +1,11 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_ARROWRANDOMACCESSBUILDER_H_
+#define GALOIS_LIBGALOIS_GALOIS_ARROWRANDOMACCESSBUILDER_H_
+
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
 #include <arrow/api.h>
 
 #include "galois/ErrorCode.h"
@@ -5,6 +13,7 @@
 #include "galois/Logging.h"
 #include "galois/Properties.h"
 #include "galois/Result.h"
+#include "tsuba/MemoryPool.h"
 
 namespace galois {
 
@@ -28,13 +37,15 @@ public:
     return static_cast<ValueType*>(data_.data())[index];
   }
 
+  void SetValue(size_t index, ValueType value) { (*this)[index] = value; }
+
   bool IsValid(size_t) { return true; }
 
   size_t size() const { return data_.size(); }
 
   galois::Result<std::shared_ptr<arrow::Array>> Finalize() const {
     using ArrowBuilder = typename arrow::TypeTraits<ArrowType>::BuilderType;
-    ArrowBuilder builder;
+    ArrowBuilder builder(tsuba::GetArrowMemoryPool());
     if (data_.size() > 0) {
       if (auto r = builder.AppendValues(data_); !r.ok()) {
         GALOIS_LOG_DEBUG("arrow error: {}", r);
@@ -75,13 +86,15 @@ public:
     return reinterpret_cast<ValueType*>(data_.data())[index];
   }
 
+  void SetValue(size_t index, ValueType value) { (*this)[index] = value; }
+
   bool IsValid(size_t index) { return valid_[index]; }
 
   size_t size() const { return data_.size(); }
 
   galois::Result<void> Finalize(std::shared_ptr<arrow::Array>* array) const {
     using ArrowBuilder = typename arrow::TypeTraits<ArrowType>::BuilderType;
-    ArrowBuilder builder;
+    ArrowBuilder builder(tsuba::GetArrowMemoryPool());
     if (data_.size() > 0) {
       if constexpr (std::is_scalar_v<value_type>) {
         // TODO(danielmawhirter) find a better way to handle this
@@ -185,4 +198,98 @@ private:
   RandomBuilderType builder_;
 };
 
+/// ConcurrentArrowRandomAccessBuilder builds an arrow::Array of a number or
+/// boolean type from <index, value> pairs like ArrowRandomAccessBuilder, but
+/// SetValue may be called from parallel loops, e.g., to write the output
+/// property of an analytics algorithm from a do_all. The values go straight
+/// into the buffers of the array, whose bits, the validity bitmap and boolean
+/// values, are set atomically, so no copy is made. As with any array, calls
+/// for the same index race.
+template <typename ArrowType>
+class ConcurrentArrowRandomAccessBuilder {
+  static_assert(
+      arrow::is_number_type<ArrowType>::value ||
+          std::is_same_v<ArrowType, arrow::BooleanType>,
+      "ConcurrentArrowRandomAccessBuilder builds fixed-width arrays");
+  static constexpr bool kIsBoolean =
+      std::is_same_v<ArrowType, arrow::BooleanType>;
+
+public:
+  using value_type = typename arrow::TypeTraits<ArrowType>::CType;
+
+  /// Make returns a builder of an array of length values, all null
+  static galois::Result<std::unique_ptr<ConcurrentArrowRandomAccessBuilder>>
+  Make(size_t length) {
+    auto builder = std::unique_ptr<ConcurrentArrowRandomAccessBuilder>(
+        new ConcurrentArrowRandomAccessBuilder(length));
+    size_t bitmap_size = arrow::BitUtil::BytesForBits(length);
+    size_t data_size = kIsBoolean ? bitmap_size : length * sizeof(value_type);
+    if (auto res = builder->Allocate(bitmap_size, &builder->validity_); !res) {
+      return res.error();
+    }
+    if (auto res = builder->Allocate(data_size, &builder->data_); !res) {
+      return res.error();
+    }
+    std::memset(builder->validity_->mutable_data(), 0, bitmap_size);
+    if constexpr (kIsBoolean) {
+      std::memset(builder->data_->mutable_data(), 0, bitmap_size);
+    }
+    return std::unique_ptr<ConcurrentArrowRandomAccessBuilder>(
+        std::move(builder));
+  }
+
+  void SetValue(size_t index, value_type value) {
+    assert(index < length_);
+    uint8_t bit = uint8_t{1} << (index % 8);
+    if constexpr (kIsBoolean) {
+      uint8_t* byte = data_->mutable_data() + index / 8;
+      if (value) {
+        __atomic_fetch_or(byte, bit, __ATOMIC_RELAXED);
+      } else {
+        __atomic_fetch_and(byte, static_cast<uint8_t>(~bit), __ATOMIC_RELAXED);
+      }
+    } else {
+      reinterpret_cast<value_type*>(data_->mutable_data())[index] = value;
+    }
+    __atomic_fetch_or(
+        validity_->mutable_data() + index / 8, bit, __ATOMIC_RELAXED);
+  }
+
+  bool IsValid(size_t index) const {
+    return arrow::BitUtil::GetBit(validity_->data(), index);
+  }
+
+  size_t size() const { return length_; }
+
+  /// Finalize returns the array of the values set so far, sharing the
+  /// buffers of the builder, which must not be used after
+  galois::Result<std::shared_ptr<arrow::Array>> Finalize() {
+    auto array_data = arrow::ArrayData::Make(
+        arrow::TypeTraits<ArrowType>::type_singleton(), length_,
+        {std::move(validity_), std::move(data_)}, arrow::kUnknownNullCount);
+    return arrow::MakeArray(array_data);
+  }
+
+private:
+  ConcurrentArrowRandomAccessBuilder(size_t length) : length_(length) {}
+
+  galois::Result<void> Allocate(
+      size_t size, std::shared_ptr<arrow::Buffer>* buffer) {
+    auto alloc_result =
+        arrow::AllocateBuffer(size, tsuba::GetArrowMemoryPool());
+    if (!alloc_result.ok()) {
+      GALOIS_LOG_DEBUG("arrow error: {}", alloc_result.status());
+      return galois::ErrorCode::ArrowError;
+    }
+    *buffer = std::move(alloc_result.ValueOrDie());
+    return galois::ResultSuccess();
+  }
+
+  size_t length_;
+  std::shared_ptr<arrow::Buffer> validity_;
+  std::shared_ptr<arrow::Buffer> data_;
+};
+
 }  // namespace galois
+
+#endif
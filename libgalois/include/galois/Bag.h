@@ -21,7 +21,10 @@
 #define GALOIS_LIBGALOIS_GALOIS_BAG_H_
 
 #include <algorithm>
+#include <iterator>
+#include <memory>
 #include <stdexcept>
+#include <vector>
 
 #include <boost/iterator/iterator_facade.hpp>
 
@@ -36,7 +39,9 @@ namespace galois {
 
 /**
  * Unordered collection of elements. This data structure supports scalable
- * concurrent pushes but reading the bag can only be done serially.
+ * concurrent pushes but reading the bag can only be done serially, or in
+ * parallel after copying it to contiguous storage with flatten_parallel or
+ * copy_parallel.
  */
 template <typename T, unsigned int BlockSize = 0>
 class InsertBag {
@@ -125,6 +130,8 @@ public:
 private:
   galois::runtime::FixedSizeHeap heap;
   galois::substrate::PerThreadStorage<PerThread> heads;
+  // blocks kept by clear_keep_blocks for the pushes of each thread
+  galois::substrate::PerThreadStorage<header*> free_blocks;
 
   void insHeader(header* h) {
     PerThread& hpair = *heads.getLocal();
@@ -150,6 +157,13 @@ private:
   }
 
   header* newHeader() {
+    header*& free = *free_blocks.getLocal();
+    if (free) {
+      header* h = free;
+      free = h->next;
+      return newHeaderFromHeap(
+          h, BlockSize ? BlockSize : galois::substrate::allocSize());
+    }
     if (BlockSize) {
       return newHeaderFromHeap(heap.allocate(BlockSize), BlockSize);
     } else {
@@ -158,42 +172,59 @@ private:
     }
   }
 
-  void destruct_serial() {
-    for (unsigned x = 0; x < heads.size(); ++x) {
-      PerThread& hpair = *heads.getRemote(x);
-      header*& h = hpair.first;
-      while (h) {
-        uninitialized_destroy(h->dbegin, h->dend);
-        header* h2 = h;
-        h = h->next;
-        if (BlockSize)
-          heap.deallocate(h2);
-        else
-          galois::substrate::pagePoolFree(h2);
-      }
-      hpair.second = 0;
+  void freeBlocks(header* h) {
+    while (h) {
+      header* h2 = h;
+      h = h->next;
+      if (BlockSize)
+        heap.deallocate(h2);
+      else
+        galois::substrate::pagePoolFree(h2);
     }
   }
 
-  void destruct_parallel(void) {
+  //! Destroys the elements of thread x; returns its now empty blocks
+  header* destroyElements(unsigned x) {
+    PerThread& hpair = *heads.getRemote(x);
+    for (header* h = hpair.first; h; h = h->next) {
+      uninitialized_destroy(h->dbegin, h->dend);
+    }
+    header* blocks = hpair.first;
+    hpair.first = hpair.second = 0;
+    return blocks;
+  }
+
+  void destruct_thread(unsigned x) {
+    freeBlocks(destroyElements(x));
+    header*& free = *free_blocks.getRemote(x);
+    freeBlocks(free);
+    free = 0;
+  }
+
+  //! Calls fn(x) on every thread x of heads, which may be more than are
+  //! active, in parallel
+  template <typename FnTy>
+  void on_each_thread(const FnTy& fn) const {
+    const unsigned size = heads.size();
     galois::runtime::on_each_gen(
-        [this](const unsigned int tid, const unsigned int) {
-          PerThread& hpair = *heads.getLocal(tid);
-          header*& h = hpair.first;
-          while (h) {
-            uninitialized_destroy(h->dbegin, h->dend);
-            header* h2 = h;
-            h = h->next;
-            if (BlockSize)
-              heap.deallocate(h2);
-            else
-              galois::substrate::pagePoolFree(h2);
+        [&](const unsigned int tid, const unsigned int nthreads) {
+          for (unsigned x = tid; x < size; x += nthreads) {
+            fn(x);
           }
-          hpair.second = 0;
         },
         std::make_tuple(galois::no_stats()));
   }
 
+  void destruct_serial() {
+    for (unsigned x = 0; x < heads.size(); ++x) {
+      destruct_thread(x);
+    }
+  }
+
+  void destruct_parallel(void) {
+    on_each_thread([this](unsigned x) { destruct_thread(x); });
+  }
+
 public:
   // static_assert(BlockSize == 0 || BlockSize >= (2 * sizeof(T) +
   // sizeof(header)),
@@ -203,11 +234,13 @@ public:
   InsertBag(InsertBag&& o) : heap(BlockSize) {
     std::swap(heap, o.heap);
     std::swap(heads, o.heads);
+    std::swap(free_blocks, o.free_blocks);
   }
 
   InsertBag& operator=(InsertBag&& o) {
     std::swap(heap, o.heap);
     std::swap(heads, o.heads);
+    std::swap(free_blocks, o.free_blocks);
     return *this;
   }
 
@@ -220,9 +253,32 @@ public:
 
   void clear_serial() { destruct_serial(); }
 
+  /**
+   * Like clear but keeps the blocks of each thread for its next pushes
+   * instead of returning them to the page pool, so that a bag refilled
+   * every round (e.g., a frontier) stops allocating once it has grown to
+   * its largest round. The blocks are freed by clear or the destructor.
+   */
+  void clear_keep_blocks() {
+    on_each_thread([this](unsigned x) {
+      header* blocks = destroyElements(x);
+      if (!blocks) {
+        return;
+      }
+      header* last = blocks;
+      while (last->next) {
+        last = last->next;
+      }
+      header*& free = *free_blocks.getRemote(x);
+      last->next = free;
+      free = blocks;
+    });
+  }
+
   void swap(InsertBag& o) {
     std::swap(heap, o.heap);
     std::swap(heads, o.heads);
+    std::swap(free_blocks, o.free_blocks);
   }
 
   typedef T value_type;
@@ -297,6 +353,81 @@ public:
   reference push_back(ItemTy&& val) {
     return emplace(std::forward<ItemTy>(val));
   }
+
+  /**
+   * Thread safe bag insertion of the elements of [begin, end), which must be
+   * forward iterators. Copies a block at a time instead of checking for
+   * space on every element.
+   */
+  template <typename Iter>
+  void push_bulk(Iter begin, Iter end) {
+    size_t remaining = std::distance(begin, end);
+    header* H = heads.getLocal()->second;
+    while (remaining > 0) {
+      if (!H || H->dend == H->dlast) {
+        H = newHeader();
+        insHeader(H);
+      }
+      size_t n = std::min<size_t>(H->dlast - H->dend, remaining);
+      H->dend = std::uninitialized_copy_n(begin, n, H->dend);
+      std::advance(begin, n);
+      remaining -= n;
+    }
+  }
+
+  //! The number of elements; walks the blocks, not the elements, of each
+  //! thread
+  size_t size() const { return thread_offsets().back(); }
+
+  /**
+   * Copies the elements to out, which must have room for size() of them, in
+   * parallel. The elements are in the order of iteration over the bag: those
+   * pushed by each thread are contiguous and in the order pushed.
+   */
+  void copy_parallel(T* out) const { copy_parallel(thread_offsets(), out); }
+
+  /**
+   * Copies the elements to out in parallel, as copy_parallel does, and
+   * resizes it to their number. A vector reused across calls keeps its
+   * capacity.
+   *
+   * @param out vector (e.g., std::vector<T>) to hold the elements
+   */
+  template <typename VectorTy>
+  void flatten_parallel(VectorTy* out) const {
+    std::vector<size_t> offsets = thread_offsets();
+    out->resize(offsets.back());
+    copy_parallel(offsets, out->data());
+  }
+
+private:
+  //! The index in the iteration order of the first element of each thread,
+  //! followed by the number of elements
+  std::vector<size_t> thread_offsets() const {
+    const unsigned size = heads.size();
+    std::vector<size_t> offsets(size + 1);
+    on_each_thread([&](unsigned x) {
+      size_t count = 0;
+      for (header* h = heads.getRemote(x)->first; h; h = h->next) {
+        count += h->dend - h->dbegin;
+      }
+      offsets[x + 1] = count;
+    });
+    for (unsigned x = 0; x < size; ++x) {
+      offsets[x + 1] += offsets[x];
+    }
+    return offsets;
+  }
+
+  template <typename OutPtr>
+  void copy_parallel(const std::vector<size_t>& offsets, OutPtr data) const {
+    on_each_thread([&](unsigned x) {
+      auto p = data + offsets[x];
+      for (header* h = heads.getRemote(x)->first; h; h = h->next) {
+        p = std::copy(h->dbegin, h->dend, p);
+      }
+    });
+  }
 };
 
 }  // namespace galois
@@ -126,10 +126,15 @@ struct TopologyState {
   std::unordered_map<size_t, std::string> destinations_intermediate;
 };
 
+class ChunkSpiller;
+
 struct WriterProperties {
   NullMaps null_arrays;
   std::shared_ptr<arrow::Array> false_array;
   const size_t chunk_size;
+  // if set (via GALOIS_BUILD_SPILL_DIR), completed chunks are moved to
+  // file-backed memory
+  std::shared_ptr<ChunkSpiller> spiller;
 };
 
 struct GraphComponent {
@@ -0,0 +1,351 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_CONCURRENTHASHMAP_H_
+#define GALOIS_LIBGALOIS_GALOIS_CONCURRENTHASHMAP_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/Logging.h"
+#include "galois/Reduction.h"
+#include "galois/substrate/CompilerSpecific.h"
+#include "galois/substrate/PerThreadStorage.h"
+
+namespace galois {
+
+namespace internal {
+
+/// Spread the bits of a hash over all 64 bits (the finalizer of
+/// SplitMix64), as std::hash of an integer is usually the integer itself
+inline uint64_t
+MixHash(uint64_t h) {
+  h ^= h >> 30;
+  h *= UINT64_C(0xbf58476d1ce4e5b9);
+  h ^= h >> 27;
+  h *= UINT64_C(0x94d049bb133111eb);
+  h ^= h >> 31;
+  return h;
+}
+
+}  // namespace internal
+
+/// A concurrent hash map of a capacity fixed at construction, with open
+/// addressing and linear probing.
+///
+/// Entries are never removed, so inserts and lookups are lock-free but for
+/// the short wait on a slot whose entry is being constructed. A probe walks
+/// an array of one byte tags, either empty, busy or a fingerprint of the
+/// key of a full slot, and only compares keys whose fingerprints match, so
+/// a miss usually touches one cache line of tags; the entries are kept in a
+/// separate array. An insert claims an empty slot with compare-and-swap,
+/// constructs its entry and then publishes the slot by storing its
+/// fingerprint.
+///
+/// The table has at least twice as many slots as the capacity. Inserting
+/// more keys than the capacity still works, with longer probes, until every
+/// slot is taken, which is fatal.
+template <
+    typename Key, typename Value, typename Hash = std::hash<Key>,
+    typename KeyEqual = std::equal_to<Key>>
+class ConcurrentHashMap {
+public:
+  using value_type = std::pair<const Key, Value>;
+
+private:
+  enum : uint8_t { kEmpty = 0, kBusy = 1, kFirstFingerprint = 2 };
+
+  struct Slot {
+    alignas(value_type) unsigned char bytes[sizeof(value_type)];
+
+    value_type* entry() {
+      return std::launder(reinterpret_cast<value_type*>(bytes));
+    }
+  };
+
+  LargeArray<std::atomic<uint8_t>> tags_;
+  LargeArray<Slot> slots_;
+  size_t capacity_{0};
+  uint32_t shift_{64};
+  Hash hash_;
+  KeyEqual equal_;
+
+  uint64_t Mixed(const Key& key) const {
+    return internal::MixHash(static_cast<uint64_t>(hash_(key)));
+  }
+
+  /// The fingerprint is the low bits of the hash and the first slot its high
+  /// bits, so keys that collide on one rarely collide on the other
+  static uint8_t FingerprintOf(uint64_t mixed) {
+    auto fingerprint = static_cast<uint8_t>(mixed);
+    return fingerprint < kFirstFingerprint ? fingerprint + kFirstFingerprint
+                                           : fingerprint;
+  }
+
+  size_t FirstSlotOf(uint64_t mixed) const { return mixed >> shift_; }
+
+  size_t mask() const { return tags_.size() - 1; }
+
+  /// The tag of slot i once no entry is being constructed in it
+  uint8_t LoadSettled(size_t i) const {
+    uint8_t tag = tags_[i].load(std::memory_order_acquire);
+    while (tag == kBusy) {
+      substrate::asmPause();
+      tag = tags_[i].load(std::memory_order_acquire);
+    }
+    return tag;
+  }
+
+  Value* FindMixed(const Key& key, uint64_t mixed) const {
+    uint8_t fingerprint = FingerprintOf(mixed);
+    for (size_t i = FirstSlotOf(mixed), probes = 0; probes < tags_.size();
+         i = (i + 1) & mask(), ++probes) {
+      uint8_t tag = LoadSettled(i);
+      if (tag == kEmpty) {
+        return nullptr;
+      }
+      value_type* entry = const_cast<Slot&>(slots_[i]).entry();
+      if (tag == fingerprint && equal_(entry->first, key)) {
+        return &entry->second;
+      }
+    }
+    return nullptr;
+  }
+
+public:
+  /// A map for up to capacity keys; its tags are cleared in parallel
+  explicit ConcurrentHashMap(
+      size_t capacity, const Hash& hash = Hash(),
+      const KeyEqual& equal = KeyEqual())
+      : capacity_(capacity), hash_(hash), equal_(equal) {
+    size_t num_slots = 2;
+    shift_ = 63;
+    while (num_slots < 2 * capacity) {
+      num_slots *= 2;
+      --shift_;
+    }
+    tags_.allocateInterleaved(num_slots);
+    slots_.allocateInterleaved(num_slots);
+    galois::do_all(
+        galois::iterate(size_t{0}, num_slots),
+        [&](size_t i) { tags_.constructAt(i, kEmpty); }, galois::no_stats());
+  }
+
+  ConcurrentHashMap(const ConcurrentHashMap&) = delete;
+  ConcurrentHashMap& operator=(const ConcurrentHashMap&) = delete;
+  ConcurrentHashMap(ConcurrentHashMap&&) noexcept = default;
+  ConcurrentHashMap& operator=(ConcurrentHashMap&&) = delete;
+
+  ~ConcurrentHashMap() {
+    if constexpr (!std::is_trivially_destructible_v<value_type>) {
+      galois::do_all(
+          galois::iterate(size_t{0}, tags_.size()),
+          [&](size_t i) {
+            if (tags_[i].load(std::memory_order_relaxed) != kEmpty) {
+              slots_[i].entry()->~value_type();
+            }
+          },
+          galois::no_stats());
+    }
+  }
+
+  size_t capacity() const { return capacity_; }
+
+  /// The number of keys, counted in parallel; exact once no insert is in
+  /// flight
+  size_t size() const {
+    galois::GAccumulator<size_t> size;
+    galois::do_all(
+        galois::iterate(size_t{0}, tags_.size()),
+        [&](size_t i) {
+          if (tags_[i].load(std::memory_order_relaxed) != kEmpty) {
+            size += 1;
+          }
+        },
+        galois::no_stats());
+    return size.reduce();
+  }
+
+  /// The value of key, or null if there is none. The pointer stays valid
+  /// for the life of the map.
+  Value* Find(const Key& key) { return FindMixed(key, Mixed(key)); }
+  const Value* Find(const Key& key) const {
+    return FindMixed(key, Mixed(key));
+  }
+
+  /// Insert key with the value make_value() unless key is already in the
+  /// map. Only the thread that inserts key calls make_value, before other
+  /// threads can see the entry, which, e.g., lets an atomic counter hand out
+  /// dense ids to new keys. Returns the value of key and whether this call
+  /// inserted it.
+  template <typename MakeValue>
+  std::pair<Value*, bool> TryEmplace(const Key& key, MakeValue make_value) {
+    uint64_t mixed = Mixed(key);
+    uint8_t fingerprint = FingerprintOf(mixed);
+    for (size_t i = FirstSlotOf(mixed), probes = 0; probes < tags_.size();
+         i = (i + 1) & mask(), ++probes) {
+      uint8_t tag = tags_[i].load(std::memory_order_acquire);
+      if (tag == kEmpty) {
+        if (!tags_[i].compare_exchange_strong(
+                tag, kBusy, std::memory_order_acquire)) {
+          if (tag == kBusy) {
+            tag = LoadSettled(i);
+          }
+        } else {
+          value_type* entry =
+              new (slots_[i].bytes) value_type(key, make_value());
+          tags_[i].store(fingerprint, std::memory_order_release);
+          return {&entry->second, true};
+        }
+      } else if (tag == kBusy) {
+        tag = LoadSettled(i);
+      }
+      value_type* entry = slots_[i].entry();
+      if (tag == fingerprint && equal_(entry->first, key)) {
+        return {&entry->second, false};
+      }
+    }
+    GALOIS_LOG_FATAL("ConcurrentHashMap is full: {} slots", tags_.size());
+  }
+
+  /// Insert key with value unless key is already in the map (\see
+  /// TryEmplace)
+  std::pair<Value*, bool> Insert(const Key& key, const Value& value) {
+    return TryEmplace(key, [&]() -> const Value& { return value; });
+  }
+
+  /// Insert keys[i] with values[i] for every i, in parallel; keys already in
+  /// the map keep their values. Returns the number of keys inserted.
+  template <typename Keys, typename Values>
+  size_t InsertAll(
+      const Keys& keys, const Values& values, const char* loopname) {
+    galois::GAccumulator<size_t> inserted;
+    galois::do_all(
+        galois::iterate(size_t{0}, static_cast<size_t>(keys.size())),
+        [&](size_t i) {
+          if (Insert(keys[i], values[i]).second) {
+            inserted += 1;
+          }
+        },
+        galois::loopname(loopname));
+    return inserted.reduce();
+  }
+
+  /// Set out[i] to the value of keys[i], or to missing if there is none, for
+  /// every i, in parallel
+  template <typename Keys>
+  void FindAll(
+      const Keys& keys, Value* out, const Value& missing,
+      const char* loopname) const {
+    galois::do_all(
+        galois::iterate(size_t{0}, static_cast<size_t>(keys.size())),
+        [&](size_t i) {
+          const Value* value = Find(keys[i]);
+          out[i] = value != nullptr ? *value : missing;
+        },
+        galois::loopname(loopname));
+  }
+
+  /// Call fn(key, value) for every entry, in parallel; call it once the
+  /// inserts are done
+  template <typename Fn>
+  void ForEach(Fn fn, const char* loopname) {
+    galois::do_all(
+        galois::iterate(size_t{0}, tags_.size()),
+        [&](size_t i) {
+          if (tags_[i].load(std::memory_order_acquire) != kEmpty) {
+            value_type* entry = slots_[i].entry();
+            fn(entry->first, entry->second);
+          }
+        },
+        galois::loopname(loopname));
+  }
+};
+
+/// A hash map that every thread updates without synchronization, for
+/// aggregating values by key, e.g., the weights of the edges between
+/// communities, where a concurrent map would contend on the hot keys.
+///
+/// Each thread keeps its entries in one map per shard, and a key's shard is
+/// a range of the high bits of its hash, so Merge combines each shard on
+/// one thread without synchronizing on the values, and that thread inserts
+/// into one contiguous region of the slots of the merged map.
+template <
+    typename Key, typename Value, typename Hash = std::hash<Key>,
+    typename KeyEqual = std::equal_to<Key>>
+class PerThreadHashMap {
+  using LocalMap = std::unordered_map<Key, Value, Hash, KeyEqual>;
+
+  substrate::PerThreadStorage<std::vector<LocalMap>> shards_;
+  size_t num_shards_;
+  Hash hash_;
+
+  size_t ShardOf(const Key& key) const {
+    uint64_t high = internal::MixHash(static_cast<uint64_t>(hash_(key))) >> 32;
+    return (high * num_shards_) >> 32;
+  }
+
+public:
+  /// A map with a shard for each active thread
+  explicit PerThreadHashMap(const Hash& hash = Hash())
+      : num_shards_(galois::getActiveThreads()), hash_(hash) {
+    for (unsigned i = 0; i < shards_.size(); ++i) {
+      shards_.getRemote(i)->resize(num_shards_);
+    }
+  }
+
+  /// Set the value of key in the map of the calling thread to value if it
+  /// has none, or else to combine(old value, value)
+  template <typename Combine>
+  void Update(const Key& key, const Value& value, Combine combine) {
+    LocalMap& local = (*shards_.getLocal())[ShardOf(key)];
+    if (auto [it, inserted] = local.try_emplace(key, value); !inserted) {
+      it->second = combine(it->second, value);
+    }
+  }
+
+  /// Combine the maps of all threads with combine, in parallel, into one
+  /// concurrent map, and clear them; call it once the updates are done. The
+  /// order in which the values of a key are combined depends on the
+  /// scheduling of the threads.
+  template <typename Combine>
+  ConcurrentHashMap<Key, Value, Hash, KeyEqual> Merge(
+      Combine combine, const char* loopname) {
+    size_t num_entries = 0;
+    for (unsigned i = 0; i < shards_.size(); ++i) {
+      for (const LocalMap& local : *shards_.getRemote(i)) {
+        num_entries += local.size();
+      }
+    }
+
+    ConcurrentHashMap<Key, Value, Hash, KeyEqual> merged(num_entries, hash_);
+    galois::on_each(
+        [&](unsigned tid, unsigned num_threads) {
+          for (size_t shard = tid; shard < num_shards_; shard += num_threads) {
+            for (unsigned i = 0; i < shards_.size(); ++i) {
+              LocalMap& local = (*shards_.getRemote(i))[shard];
+              for (const auto& [key, value] : local) {
+                // no other thread sees the keys of this shard
+                if (auto [v, inserted] = merged.Insert(key, value);
+                    !inserted) {
+                  *v = combine(*v, value);
+                }
+              }
+              LocalMap().swap(local);
+            }
+          }
+        },
+        galois::loopname(loopname));
+    return merged;
+  }
+};
+
+}  // namespace galois
+
+#endif
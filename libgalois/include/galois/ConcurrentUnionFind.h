@@ -0,0 +1,190 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_CONCURRENTUNIONFIND_H_
+#define GALOIS_LIBGALOIS_GALOIS_CONCURRENTUNIONFIND_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "galois/EdgeTiles.h"
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/Reduction.h"
+
+namespace galois {
+
+/// A concurrent union-find forest over the indices [0, size), stored as an
+/// array of parent indices.
+///
+/// Every parent is at most its child, so a root is the least index of its
+/// set and the forest has no cycles however unions race. Unite is Rem's
+/// algorithm with splicing made lock-free with compare-and-swap (Patwary et
+/// al., SEA '10; the Rem-CAS variant of Dhulipala et al., VLDB '20): it
+/// walks up from both ends at once, always from the side with the larger
+/// parent, and splices that side onto the smaller parent as it goes, so the
+/// walk compresses the paths it takes. Find halves the path it takes.
+///
+/// Unite and Find are safe to call concurrently. While unions are in
+/// flight, a splice can leave a set briefly split in two, so Find and
+/// parent() are only exact once the unions of a batch are done, e.g., for
+/// CompressAll.
+template <typename Index>
+class ConcurrentUnionFind {
+  LargeArray<std::atomic<Index>> storage_;
+  std::atomic<Index>* parents_{nullptr};
+  size_t size_{0};
+
+  Index Load(Index n) const {
+    return parents_[n].load(std::memory_order_relaxed);
+  }
+
+public:
+  /// A forest of size singleton sets, initialized in parallel
+  explicit ConcurrentUnionFind(size_t size) : size_(size) {
+    storage_.allocateBlocked(size);
+    parents_ = storage_.data();
+    galois::do_all(
+        galois::iterate(size_t{0}, size),
+        [&](size_t n) { storage_.constructAt(n, static_cast<Index>(n)); },
+        galois::no_stats());
+  }
+
+  /// A forest over the caller's parent array, which must stay alive and
+  /// already hold a forest whose parents are at most their children, e.g.,
+  /// the output of an earlier CompressAll
+  ConcurrentUnionFind(std::atomic<Index>* parents, size_t size)
+      : parents_(parents), size_(size) {}
+
+  ConcurrentUnionFind(const ConcurrentUnionFind&) = delete;
+  ConcurrentUnionFind& operator=(const ConcurrentUnionFind&) = delete;
+
+  size_t size() const { return size_; }
+
+  Index parent(Index n) const { return Load(n); }
+  bool IsRoot(Index n) const { return Load(n) == n; }
+
+  /// The root of n. Halves the path to it on the way: halving only ever
+  /// points a node at one of its ancestors, so it is safe to race with
+  /// Unite.
+  Index Find(Index n) {
+    while (true) {
+      Index p = Load(n);
+      if (p == n) {
+        return n;
+      }
+      Index grandparent = Load(p);
+      if (grandparent != p) {
+        parents_[n].compare_exchange_weak(
+            p, grandparent, std::memory_order_relaxed);
+      }
+      n = grandparent;
+    }
+  }
+
+  /// The root of n without modifying the forest
+  Index FindConst(Index n) const {
+    Index p = Load(n);
+    while (p != n) {
+      n = p;
+      p = Load(n);
+    }
+    return n;
+  }
+
+  /// Unite the sets of a and b; returns whether they were different sets.
+  /// If hooked is not null and the call hooked a root, *hooked is set to
+  /// that root and *onto to the node it was hooked under.
+  bool Unite(Index a, Index b, Index* hooked = nullptr, Index* onto = nullptr) {
+    Index ra = a;
+    Index rb = b;
+    while (true) {
+      Index pa = Load(ra);
+      Index pb = Load(rb);
+      if (pa == pb) {
+        return false;
+      }
+      if (pa < pb) {
+        std::swap(ra, rb);
+        std::swap(pa, pb);
+      }
+      // Now pa > pb, so ra may point at pb without breaking the order
+      if (ra == pa) {
+        if (parents_[ra].compare_exchange_strong(
+                pa, pb, std::memory_order_relaxed)) {
+          if (hooked) {
+            *hooked = ra;
+          }
+          if (onto) {
+            *onto = pb;
+          }
+          return true;
+        }
+        continue;
+      }
+      // splice: move ra from its parent to the smaller parent of rb and go on
+      // from its old parent
+      parents_[ra].compare_exchange_weak(pa, pb, std::memory_order_relaxed);
+      ra = pa;
+    }
+  }
+
+  /// Unite the endpoints of every pair of edges, in parallel; returns the
+  /// number of pairs that were already in the same set
+  template <typename EdgeRange>
+  uint64_t UniteAll(const EdgeRange& edges, const char* loopname) {
+    galois::GAccumulator<uint64_t> redundant;
+    galois::do_all(
+        galois::iterate(edges),
+        [&](const auto& edge) {
+          if (!Unite(edge.first, edge.second)) {
+            redundant += 1;
+          }
+        },
+        galois::steal(), galois::loopname(loopname));
+    return redundant.reduce();
+  }
+
+  /// Unite the endpoints of every edge of graph, processing the edges in
+  /// tiles of at most max_tile_size edges (\see DoAllEdgeTiles). For
+  /// symmetric graphs, only the edges to larger nodes are needed; the
+  /// reverse edges are skipped. Returns the number of edges whose endpoints
+  /// were already in the same set.
+  template <typename Graph>
+  uint64_t UniteEdges(
+      const Graph& graph, ptrdiff_t max_tile_size, bool symmetric,
+      const char* loopname) {
+    galois::GAccumulator<uint64_t> redundant;
+    galois::DoAllEdgeTiles(
+        graph, max_tile_size,
+        [&](const typename Graph::Node& src,
+            typename Graph::edge_iterator beg,
+            typename Graph::edge_iterator end) {
+          for (auto e = beg; e != end; ++e) {
+            auto dest = *graph.GetEdgeDest(e);
+            if (symmetric && src >= dest) {
+              continue;
+            }
+            if (!Unite(src, dest)) {
+              redundant += 1;
+            }
+          }
+        },
+        loopname);
+    return redundant.reduce();
+  }
+
+  /// Point every index directly at its root, in parallel; call it once the
+  /// unions are done
+  void CompressAll(const char* loopname) {
+    galois::do_all(
+        galois::iterate(size_t{0}, size_),
+        [&](size_t n) {
+          parents_[n].store(Find(n), std::memory_order_relaxed);
+        },
+        galois::steal(), galois::loopname(loopname));
+  }
+};
+
+}  // namespace galois
+
+#endif
@@ -206,15 +206,14 @@ public:
     size_t bit_index = index / bits_uint64;
     uint64_t bit_offset = 1;
     bit_offset <<= (index % bits_uint64);
-    uint64_t old_val = bitvec[bit_index];
-    // test and set
-    // if old_bit is 0, then atomically set it
-    while (((old_val & bit_offset) == 0) &&
-           !bitvec[bit_index].compare_exchange_weak(
-               old_val, old_val | bit_offset, std::memory_order_relaxed)) {
-      ;
+    // test before the atomic update, which would take the cache line
+    // exclusively even if the bit is already set
+    if ((bitvec[bit_index].load(std::memory_order_relaxed) & bit_offset) !=
+        0) {
+      return true;
     }
-    return (old_val & bit_offset);
+    return (bitvec[bit_index].fetch_or(bit_offset, std::memory_order_relaxed) &
+            bit_offset) != 0;
   }
 
   /**
@@ -227,15 +226,13 @@ public:
     size_t bit_index = index / bits_uint64;
     uint64_t bit_offset = 1;
     bit_offset <<= (index % bits_uint64);
-    uint64_t old_val = bitvec[bit_index];
-    // test and reset
-    // if old_bit is 1, then atomically reset it
-    while (((old_val & bit_offset) != 0) &&
-           !bitvec[bit_index].compare_exchange_weak(
-               old_val, old_val & ~bit_offset, std::memory_order_relaxed)) {
-      ;
+    if ((bitvec[bit_index].load(std::memory_order_relaxed) & bit_offset) ==
+        0) {
+      return false;
     }
-    return (old_val & bit_offset);
+    return (bitvec[bit_index].fetch_and(
+                ~bit_offset, std::memory_order_relaxed) &
+            bit_offset) != 0;
   }
 
   // assumes bit_vector is not updated (set) in parallel
@@ -259,6 +256,14 @@ public:
    */
   void bitwise_and(const DynamicBitset& other1, const DynamicBitset& other2);
 
+  /**
+   * Does an IN-PLACE bitwise and of this bitset and the complement of another
+   * bitset, i.e., unsets the bits set in other
+   *
+   * @param other Bitset whose set bits to unset in this one
+   */
+  void bitwise_andnot(const DynamicBitset& other);
+
   /**
    * Does an IN-PLACE bitwise xor of this bitset and another bitset
    *
@@ -275,6 +280,16 @@ public:
    */
   void bitwise_xor(const DynamicBitset& other1, const DynamicBitset& other2);
 
+  /**
+   * Makes this bitset hold the bits of next and clears next, e.g., to move
+   * to the next frontier of a level-synchronous traversal. The bits move
+   * without copying; only next is written.
+   * Do NOT call in a parallel region as it uses galois::on_each.
+   *
+   * @param next Bitset of the same size to take the bits of
+   */
+  void swap_and_clear(DynamicBitset& next);
+
   /**
    * Count how many bits are set in the bitset
    *
@@ -0,0 +1,135 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_EDGETILES_H_
+#define GALOIS_LIBGALOIS_GALOIS_EDGETILES_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "galois/Bag.h"
+#include "galois/Galois.h"
+
+namespace galois {
+
+/// Edge tiling splits the edges of high-degree nodes into tiles, runs of at
+/// most a tile size of consecutive edges of one node, so that the edges of a
+/// node with millions of neighbors are shared among threads instead of
+/// serializing on the thread that draws the node.
+
+/// Tiles smaller than this cost more to schedule than they save in balance
+constexpr ptrdiff_t kMinEdgeTileSize = 64;
+
+/// AdaptiveEdgeTileSize aims for this many tiles per active thread
+constexpr uint64_t kEdgeTilesPerThread = 64;
+
+/// AdaptiveEdgeTileSize returns max_tile_size, or a smaller size for graphs
+/// of num_edges edges too small to make kEdgeTilesPerThread tiles of
+/// max_tile_size per active thread, but no less than kMinEdgeTileSize (or
+/// max_tile_size if that is less)
+inline ptrdiff_t
+AdaptiveEdgeTileSize(uint64_t num_edges, ptrdiff_t max_tile_size) {
+  uint64_t num_tiles = galois::getActiveThreads() * kEdgeTilesPerThread;
+  auto size = static_cast<ptrdiff_t>(num_edges / num_tiles);
+  return std::min(max_tile_size, std::max(kMinEdgeTileSize, size));
+}
+
+/// A tile: the edges [beg, end) of src
+template <typename Node, typename EdgeIterator>
+struct EdgeTile {
+  Node src;
+  EdgeIterator beg;
+  EdgeIterator end;
+};
+
+/// ForEachEdgeTile calls fn(tile_beg, tile_end) for consecutive tiles of
+/// tile_size edges covering [beg, end); the last tile may be shorter. It does
+/// not allocate, so callers that need the tiles later push whatever work
+/// item they need from fn.
+template <typename EdgeIterator, typename Fn>
+void
+ForEachEdgeTile(
+    EdgeIterator beg, const EdgeIterator end, ptrdiff_t tile_size,
+    const Fn& fn) {
+  assert(beg <= end);
+  assert(tile_size > 0);
+  while (end - beg > tile_size) {
+    EdgeIterator tile_end = beg + tile_size;
+    fn(beg, tile_end);
+    beg = tile_end;
+  }
+  if (end - beg > 0) {
+    fn(beg, end);
+  }
+}
+
+/// DoAllEdgeTiles calls fn(src, tile_beg, tile_end) in parallel for the
+/// tiles of at most tile_size edges of the edge range edges(src), a pair of
+/// edge iterators, of every node src of nodes.
+///
+/// Nodes with at most tile_size edges are handled whole by the loop over
+/// the nodes, so they cost no work item of their own. Only the edges of the
+/// other nodes are queued as tiles, in the blocks of a bag, for a second
+/// loop; the tiles are never allocated one by one. fn may be called for
+/// the edges of different nodes concurrently and in any order.
+template <typename NodeRange, typename EdgeRangeFn, typename TileFn>
+void
+DoAllEdgeTiles(
+    const NodeRange& nodes, const EdgeRangeFn& edges, ptrdiff_t tile_size,
+    const TileFn& fn, const char* loopname) {
+  using Node = std::decay_t<decltype(*std::begin(nodes))>;
+  using EdgeIterator =
+      std::decay_t<decltype(edges(std::declval<Node>()).first)>;
+  using Tile = EdgeTile<Node, EdgeIterator>;
+
+  galois::InsertBag<Tile> tiles;
+  galois::do_all(
+      galois::iterate(nodes),
+      [&](const Node& src) {
+        auto [beg, end] = edges(src);
+        if (end - beg <= tile_size) {
+          if (end - beg > 0) {
+            fn(src, beg, end);
+          }
+          return;
+        }
+        ForEachEdgeTile(
+            beg, end, tile_size,
+            [&](const EdgeIterator& tile_beg, const EdgeIterator& tile_end) {
+              tiles.push(Tile{src, tile_beg, tile_end});
+            });
+      },
+      galois::steal(), galois::loopname(loopname));
+
+  if (tiles.empty()) {
+    return;
+  }
+  std::string tiles_loopname = std::string(loopname) + "-Tiles";
+  galois::do_all(
+      galois::iterate(tiles),
+      [&](const Tile& tile) { fn(tile.src, tile.beg, tile.end); },
+      galois::steal(), galois::chunk_size<1>(),
+      galois::loopname(tiles_loopname.c_str()));
+}
+
+/// DoAllEdgeTiles over all the out-edges of graph, in tiles of
+/// AdaptiveEdgeTileSize(graph.num_edges(), max_tile_size) edges
+template <typename Graph, typename TileFn>
+void
+DoAllEdgeTiles(
+    const Graph& graph, ptrdiff_t max_tile_size, const TileFn& fn,
+    const char* loopname) {
+  DoAllEdgeTiles(
+      graph,
+      [&](const typename Graph::Node& n) {
+        return std::make_pair(graph.edge_begin(n), graph.edge_end(n));
+      },
+      AdaptiveEdgeTileSize(graph.num_edges(), max_tile_size), fn, loopname);
+}
+
+}  // namespace galois
+
+#endif
@@ -0,0 +1,283 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_EXTERNALSORT_H_
+#define GALOIS_LIBGALOIS_GALOIS_EXTERNALSORT_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <queue>
+#include <string>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/ParallelSTL.h"
+#include "galois/Result.h"
+#include "galois/Uri.h"
+#include "tsuba/file.h"
+
+namespace galois {
+
+/// The memory an ExternalSort may use
+struct ExternalSortOptions {
+  /// Bytes of records held in memory while records are appended. Half is the
+  /// buffer that is being filled and half the run that is being written.
+  uint64_t memory_budget{uint64_t{1} << 30};
+  /// The most records in a run; 0 means as many as memory_budget allows
+  uint64_t run_size{0};
+  /// Records read from each run at a time while runs are merged. A merge
+  /// holds two blocks per run plus one block of output.
+  uint64_t merge_block_size{uint64_t{1} << 16};
+};
+
+/// An ExternalSort sorts more records than fit in memory. Appended records
+/// are buffered; a full buffer is sorted in parallel and stored with tsuba as
+/// a run under a directory, on local disk or in a remote store, while the next
+/// buffer fills. Merge then reads every run a block ahead and merges them. If
+/// all the records fit in one buffer, no run is written.
+///
+/// T must be trivially copy constructible and destructible since runs are
+/// stored as bytes. The directory must not be shared with another sort.
+template <typename T, typename Compare = std::less<T>>
+class ExternalSort {
+  // Not is_trivially_copyable, which std::pair never is
+  static_assert(
+      std::is_trivially_copy_constructible_v<T> &&
+          std::is_trivially_destructible_v<T>,
+      "ExternalSort stores records as their bytes");
+
+  struct Run {
+    std::string name;
+    uint64_t size;
+  };
+
+  /// A run being merged: block is being merged and next is being read
+  struct Cursor {
+    std::string uri;
+    uint64_t size{0};
+    uint64_t fetched{0};
+    std::vector<T> block;
+    std::vector<T> next;
+    uint64_t pos{0};
+    std::future<Result<void>> pending;
+  };
+
+  galois::Uri dir_;
+  ExternalSortOptions options_;
+  Compare comp_;
+  uint64_t run_capacity_;
+
+  std::vector<T> buffer_;
+  /// The last run, kept until it is stored
+  std::vector<T> writing_;
+  std::future<Result<void>> pending_;
+  std::vector<Run> runs_;
+  uint64_t size_{0};
+
+  Result<void> WaitForWrite() {
+    if (!pending_.valid()) {
+      return ResultSuccess();
+    }
+    Result<void> res = pending_.get();
+    writing_.clear();
+    return res;
+  }
+
+  Result<void> Spill() {
+    if (auto res = WaitForWrite(); !res) {
+      return res.error();
+    }
+    galois::ParallelSTL::sort(buffer_.begin(), buffer_.end(), comp_);
+    std::swap(buffer_, writing_);
+    Run run{fmt::format("run_{:06}", runs_.size()), writing_.size()};
+    pending_ = tsuba::FileStoreAsync(
+        dir_.Join(run.name).string(),
+        reinterpret_cast<const uint8_t*>(writing_.data()),
+        writing_.size() * sizeof(T));
+    runs_.emplace_back(std::move(run));
+    buffer_.reserve(run_capacity_);
+    return ResultSuccess();
+  }
+
+  Result<void> DeleteRuns() {
+    if (runs_.empty()) {
+      return ResultSuccess();
+    }
+    std::unordered_set<std::string> names;
+    for (const Run& run : runs_) {
+      names.emplace(run.name);
+    }
+    runs_.clear();
+    return tsuba::FileDelete(dir_.string(), names);
+  }
+
+  /// Start reading the block after the one that was last started
+  void Fetch(Cursor* c) {
+    uint64_t n = std::min(options_.merge_block_size, c->size - c->fetched);
+    if (n == 0) {
+      return;
+    }
+    c->next.resize(n);
+    c->pending = tsuba::FileGetAsync(
+        c->uri, reinterpret_cast<uint8_t*>(c->next.data()),
+        c->fetched * sizeof(T), n * sizeof(T));
+    c->fetched += n;
+  }
+
+  /// Make the block being read the current one; an empty block means the
+  /// run is done
+  Result<void> Advance(Cursor* c) {
+    c->block.clear();
+    c->pos = 0;
+    if (!c->pending.valid()) {
+      return ResultSuccess();
+    }
+    if (auto res = c->pending.get(); !res) {
+      return res.error();
+    }
+    std::swap(c->block, c->next);
+    Fetch(c);
+    return ResultSuccess();
+  }
+
+  template <typename BlockFn>
+  void EmitSorted(const std::vector<T>& values, BlockFn& fn) {
+    for (uint64_t i = 0; i < values.size(); i += options_.merge_block_size) {
+      fn(values.data() + i,
+         std::min<uint64_t>(options_.merge_block_size, values.size() - i));
+    }
+  }
+
+public:
+  ExternalSort(
+      galois::Uri dir, ExternalSortOptions options = ExternalSortOptions(),
+      Compare comp = Compare())
+      : dir_(std::move(dir)), options_(options), comp_(std::move(comp)) {
+    run_capacity_ = std::max<uint64_t>(
+        options_.memory_budget / (2 * sizeof(T)), 1);
+    if (options_.run_size > 0) {
+      run_capacity_ = std::min(run_capacity_, options_.run_size);
+    }
+    options_.merge_block_size =
+        std::max<uint64_t>(options_.merge_block_size, 1);
+  }
+
+  ExternalSort(const ExternalSort&) = delete;
+  ExternalSort& operator=(const ExternalSort&) = delete;
+
+  ~ExternalSort() {
+    if (auto res = WaitForWrite(); !res) {
+      GALOIS_LOG_DEBUG("storing sort run: {}", res.error());
+    }
+    if (auto res = DeleteRuns(); !res) {
+      GALOIS_LOG_DEBUG("deleting sort runs: {}", res.error());
+    }
+  }
+
+  /// Append adds n records. Whenever the buffer fills, it is sorted and the
+  /// store of it as a run is started.
+  Result<void> Append(const T* values, uint64_t n) {
+    size_ += n;
+    while (n > 0) {
+      if (buffer_.size() == run_capacity_) {
+        if (auto res = Spill(); !res) {
+          return res.error();
+        }
+      }
+      uint64_t take = std::min(n, run_capacity_ - buffer_.size());
+      buffer_.insert(buffer_.end(), values, values + take);
+      values += take;
+      n -= take;
+    }
+    return ResultSuccess();
+  }
+
+  Result<void> Append(const T& value) { return Append(&value, 1); }
+
+  /// The number of records appended since the last Merge
+  uint64_t size() const { return size_; }
+  /// The number of runs stored so far
+  uint64_t num_runs() const { return runs_.size(); }
+
+  /// Merge calls fn(const T* values, uint64_t n) with consecutive blocks of
+  /// all the appended records in sorted order. The runs are deleted
+  /// afterwards and the sort is empty again.
+  template <typename BlockFn>
+  Result<void> Merge(BlockFn fn) {
+    if (runs_.empty()) {
+      galois::ParallelSTL::sort(buffer_.begin(), buffer_.end(), comp_);
+      EmitSorted(buffer_, fn);
+      buffer_.clear();
+      size_ = 0;
+      return ResultSuccess();
+    }
+
+    if (!buffer_.empty()) {
+      if (auto res = Spill(); !res) {
+        return res.error();
+      }
+    }
+    if (auto res = WaitForWrite(); !res) {
+      return res.error();
+    }
+    buffer_ = std::vector<T>();
+    writing_ = std::vector<T>();
+
+    std::vector<Cursor> cursors(runs_.size());
+    for (size_t i = 0; i < runs_.size(); ++i) {
+      cursors[i].uri = dir_.Join(runs_[i].name).string();
+      cursors[i].size = runs_[i].size;
+      Fetch(&cursors[i]);
+    }
+    auto later = [&](size_t a, size_t b) {
+      return comp_(
+          cursors[b].block[cursors[b].pos], cursors[a].block[cursors[a].pos]);
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(later)> heap(
+        later);
+    for (size_t i = 0; i < cursors.size(); ++i) {
+      if (auto res = Advance(&cursors[i]); !res) {
+        return res.error();
+      }
+      if (!cursors[i].block.empty()) {
+        heap.push(i);
+      }
+    }
+
+    std::vector<T> out;
+    out.reserve(options_.merge_block_size);
+    while (!heap.empty()) {
+      size_t i = heap.top();
+      heap.pop();
+      Cursor& c = cursors[i];
+      out.emplace_back(c.block[c.pos]);
+      if (++c.pos == c.block.size()) {
+        if (auto res = Advance(&c); !res) {
+          return res.error();
+        }
+      }
+      if (c.pos < c.block.size()) {
+        heap.push(i);
+      }
+      if (out.size() == options_.merge_block_size) {
+        fn(out.data(), out.size());
+        out.clear();
+      }
+    }
+    if (!out.empty()) {
+      fn(out.data(), out.size());
+    }
+
+    size_ = 0;
+    return DeleteRuns();
+  }
+};
+
+}  // namespace galois
+
+#endif
@@ -28,6 +28,7 @@
 #include "galois/runtime/Executor_OnEach.h"
 #include "galois/runtime/Executor_Ordered.h"
 #include "galois/runtime/Executor_ParaMeter.h"
+#include "galois/runtime/Executor_Phases.h"
 #include "galois/worklists/WorkList.h"
 
 namespace galois {
@@ -88,6 +89,29 @@ on_each(FunctionTy&& fn, Args&&... args) {
       std::make_tuple(std::forward<Args>(args)...));
 }
 
+using runtime::PhaseContext;
+
+/**
+ * Parallel region of several phases. Operator is applied once for each
+ * running thread, as in on_each, and should conform to
+ * <code>fn(ctx)</code> where ctx is a {@link PhaseContext}&. Its
+ * PhaseContext::DoAll, PhaseContext::Barrier and PhaseContext::AllReduce
+ * separate the phases with a barrier among the running threads rather than
+ * the wakeup and join of the thread pool that each do_all pays, so loops of
+ * many short rounds, e.g., the rounds of a pull-based PageRank until
+ * convergence, can run in one region.
+ *
+ * @param fn operator, which is never copied
+ * @param args optional arguments to loop, e.g., {@see loopname}
+ */
+template <typename FunctionTy, typename... Args>
+void
+run_phases(FunctionTy&& fn, Args&&... args) {
+  runtime::run_phases_gen(
+      std::forward<FunctionTy>(fn),
+      std::make_tuple(std::forward<Args>(args)...));
+}
+
 /**
  * Galois ordered set iterator for stable source algorithms.
  *
@@ -20,8 +20,11 @@
 #ifndef GALOIS_LIBGALOIS_GALOIS_MEM_H_
 #define GALOIS_LIBGALOIS_GALOIS_MEM_H_
 
+#include <vector>
+
 #include "galois/config.h"
 #include "galois/runtime/Mem.h"
+#include "galois/substrate/PerThreadStorage.h"
 
 namespace galois {
 
@@ -61,5 +64,58 @@ using FixedSizeAllocator = galois::runtime::FixedSizeAllocator<Ty>;
 template <typename T>
 using Pow2VarSizeAlloc = typename runtime::Pow2BlockAllocator<T>;
 
+//! Bump-pointer heap whose memory is released in bulk (\see PerThreadArena)
+using ArenaHeap = runtime::RewindableBumpHeap<runtime::SystemHeap>;
+
+//! Allocator over an ArenaHeap that conforms to STL allocator interface;
+//! deallocation does nothing
+template <typename T>
+using ArenaAllocator = runtime::ExternalHeapAllocator<T, ArenaHeap>;
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+/**
+ * A bump-pointer arena per thread for the scratch memory of bulk-synchronous
+ * algorithms that allocate, e.g., vectors in every round.
+ *
+ * Allocations in a round cost a pointer bump, and nothing is freed until the
+ * round is over: Rewind at the round barrier releases all of it in bulk but
+ * keeps the pages for the next round, so after the first rounds the arena
+ * stops asking the page pool for memory. A growing vector leaves its old
+ * buffers behind until then, so scratch vectors should reserve their size
+ * when it is known.
+ */
+class PerThreadArena {
+  substrate::PerThreadStorage<ArenaHeap> heaps_;
+
+public:
+  //! The arena of the calling thread
+  ArenaHeap& local() { return *heaps_.getLocal(); }
+
+  //! An allocator from the arena of the calling thread
+  template <typename T = char>
+  ArenaAllocator<T> allocator() {
+    return ArenaAllocator<T>(&local());
+  }
+
+  //! An empty vector allocated from the arena of the calling thread
+  template <typename T>
+  ArenaVector<T> MakeVector() {
+    return ArenaVector<T>(allocator<T>());
+  }
+
+  //! Release the memory of the calling thread, e.g., after the barrier that
+  //! ends a round of galois::run_phases; none of it may be in use
+  void RewindLocal() { local().Rewind(); }
+
+  //! Release the memory of every thread, between parallel loops
+  void Rewind() {
+    for (unsigned i = 0; i < heaps_.size(); ++i) {
+      heaps_.getRemote(i)->Rewind();
+    }
+  }
+};
+
 }  // namespace galois
 #endif
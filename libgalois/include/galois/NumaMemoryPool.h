@@ -0,0 +1,80 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_NUMAMEMORYPOOL_H_
+#define GALOIS_LIBGALOIS_GALOIS_NUMAMEMORYPOOL_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include <arrow/memory_pool.h>
+
+#include "galois/config.h"
+
+namespace galois {
+
+/// NumaMemoryPool is an arrow::MemoryPool that places large buffers, like the
+/// columns of property tables, on NUMA nodes the way LargeArray does, with the
+/// page allocator of substrate/NumaMem.h. Small buffers come from
+/// arrow::default_memory_pool().
+///
+/// Pages can only be distributed among the threads of the runtime from the
+/// thread that created the pool (normally the main thread) outside of parallel
+/// loops. Allocations by other threads, e.g., the threads that read property
+/// files, or from inside parallel loops are left to be placed by the threads
+/// that first touch them, as with kFloating.
+///
+/// Install a pool for every graph with tsuba::SetArrowMemoryPool, or for one
+/// graph with tsuba::ScopedArrowMemoryPool. SharedMemSys installs the pool
+/// named by the environment variable GALOIS_ARROW_MEMORY_POOL.
+class GALOIS_EXPORT NumaMemoryPool : public arrow::MemoryPool {
+public:
+  /// Where the pages of a buffer go, as in LargeArray::AllocType
+  enum Policy {
+    /// Split into one contiguous block per thread
+    kBlocked,
+    /// On the NUMA node of the allocating thread
+    kLocal,
+    /// Round robin, one page at a time, among the threads
+    kInterleaved,
+    /// Wherever the thread that first touches a page runs
+    kFloating,
+  };
+
+  /// \param policy placement of buffers of at least min_bytes
+  /// \param min_bytes smallest buffer to allocate with the page allocator;
+  ///   0 means one page, substrate::allocSize()
+  explicit NumaMemoryPool(Policy policy, int64_t min_bytes = 0);
+
+  NumaMemoryPool(const NumaMemoryPool&) = delete;
+  NumaMemoryPool& operator=(const NumaMemoryPool&) = delete;
+
+  /// A pool with the default min_bytes for policy. It is never destroyed, so
+  /// buffers allocated from it may outlive SharedMemSys.
+  static NumaMemoryPool* Get(Policy policy);
+
+  arrow::Status Allocate(int64_t size, uint8_t** out) override;
+  arrow::Status Reallocate(
+      int64_t old_size, int64_t new_size, uint8_t** ptr) override;
+  void Free(uint8_t* buffer, int64_t size) override;
+
+  int64_t bytes_allocated() const override { return bytes_allocated_; }
+  int64_t max_memory() const override { return max_memory_; }
+  std::string backend_name() const override { return "galois-numa"; }
+
+  Policy policy() const { return policy_; }
+
+private:
+  bool IsLarge(int64_t size) const { return size >= min_bytes_; }
+  void AddBytes(int64_t delta);
+  uint8_t* AllocatePages(int64_t size) const;
+
+  Policy policy_;
+  int64_t min_bytes_;
+  std::thread::id owner_;
+  std::atomic<int64_t> bytes_allocated_{0};
+  std::atomic<int64_t> max_memory_{0};
+};
+
+}  // namespace galois
+
+#endif
@@ -1,8 +1,14 @@
 #ifndef GALOIS_LIBGALOIS_GALOIS_OPLOG_H_
 #define GALOIS_LIBGALOIS_GALOIS_OPLOG_H_
 
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "galois/BuildGraph.h"
+#include "galois/Result.h"
 #include "galois/Uri.h"
+#include "galois/graphs/PropertyFileGraph.h"
 
 namespace galois {
 
@@ -45,21 +51,54 @@ public:
   galois::ImportData data() const { return data_; }
 };
 
+/// An OpLog is an append-only log of operations in a compact binary form.
+/// Each distinct property (its name, type and whether it is for nodes or
+/// edges) is recorded once and operations refer to it by number, so an
+/// operation takes a few bytes plus its value.
+///
+/// A log made with a URI is persistent: Commit stores the operations appended
+/// since the previous Commit as one new segment file under the URI, so many
+/// operations share one write, and Make reads the segments back in order.
 class GALOIS_EXPORT OpLog {
-  std::vector<Operation> log_;
+  /// The encoded log: property definitions and operations in append order
+  std::vector<uint8_t> records_;
+  /// Where each operation begins in records_
+  std::vector<uint64_t> offsets_;
+  /// The properties defined so far; the id of each key is empty
+  std::vector<galois::PropertyKey> keys_;
+  std::unordered_map<std::string, uint32_t> key_numbers_;
+
+  galois::Uri uri_;
+  uint64_t num_segments_{0};
+  /// The size of the prefix of records_ that is stored
+  uint64_t committed_size_{0};
+
+  uint32_t KeyNumber(const galois::PropertyKey& key);
+  Result<void> Decode(const uint8_t* begin, const uint8_t* end);
 
 public:
   OpLog() = default;
-  /// Read/write operation log to URI
-  OpLog(const galois::Uri& uri);
+
+  /// Make a log stored under uri, reading the segments already there
+  static Result<OpLog> Make(const galois::Uri& uri);
+
   /// Read an operation at the given index
   Operation GetOp(uint64_t idx) const;
   /// Write an operation, return the log offset that was written
   uint64_t AppendOp(const Operation& op);
   /// Get the number of log entries
   uint64_t size() const;
-  /// Erase log contents
-  void Clear();
+  /// The size of the encoded log in bytes
+  uint64_t num_bytes() const { return records_.size(); }
+  /// Whether there are operations that the next Commit would store
+  bool HasUncommitted() const { return committed_size_ < records_.size(); }
+  /// Erase log contents, including the committed segments
+  Result<void> Clear();
+
+  /// Store the operations appended since the last Commit as one segment.
+  ///
+  /// \returns InvalidArgument if the log was not made with a URI
+  Result<void> Commit();
 };
 
 /// A graph update object is constructed from a log to represent the graph state
@@ -72,58 +111,83 @@ public:
 /// The ingest process takes a GraphUpdate object and its log and merges it into an existing
 /// graph.
 class GALOIS_EXPORT GraphUpdate {
-  // A vector of node and edge property updates, one per property
-  // Each property update has an entry for each local node/edge.
-  // Each update is an index into an OpLog
-  std::vector<std::vector<uint64_t>> nprop_;
+public:
+  /// The log index of the last operation on each updated node or edge
+  using Updates = std::unordered_map<uint64_t, uint64_t>;
+
+private:
+  // A sparse map of node and edge property updates, one per property
+  std::vector<Updates> nprop_;
   std::vector<std::string> nprop_names_;
-  std::vector<std::vector<uint64_t>> eprop_;
+  std::vector<Updates> eprop_;
   std::vector<std::string> eprop_names_;
   uint64_t num_nodes_;
   uint64_t num_edges_;
 
   uint32_t RegisterProp(
-      const std::string& name, uint64_t num,
-      std::vector<std::vector<uint64_t>>& prop,
+      const std::string& name, std::vector<Updates>& prop,
       std::vector<std::string>& names) {
     uint32_t index = names.size();
     names.emplace_back(name);
-    std::vector<uint64_t> initial(num);
     GALOIS_LOG_ASSERT((uint64_t)index == prop.size());
-    prop.emplace_back(initial);
+    prop.emplace_back();
     return index;
   }
   /// Set the value of a property
   void SetProp(
-      uint32_t pnum, uint64_t index, uint64_t op_log_index,
-      std::vector<std::vector<uint64_t>>& prop) {
+      uint32_t pnum, uint64_t index, uint64_t num, uint64_t op_log_index,
+      std::vector<Updates>& prop) {
     if (pnum >= prop.size()) {
       GALOIS_LOG_DEBUG(
           "Property number {} is out of bounds ({})", pnum, prop.size());
       return;
     }
-    if (index >= prop[pnum].size()) {
-      GALOIS_LOG_DEBUG(
-          "Property index {} is out of bounds ({})", index, prop[pnum].size());
+    if (index >= num) {
+      GALOIS_LOG_DEBUG("Property index {} is out of bounds ({})", index, num);
       return;
     }
     prop[pnum][index] = op_log_index;
   }
+  std::vector<uint64_t> Dense(const Updates& updates, uint64_t num) const {
+    std::vector<uint64_t> dense(num);
+    for (const auto& [index, op_log_index] : updates) {
+      dense[index] = op_log_index;
+    }
+    return dense;
+  }
 
 public:
   GraphUpdate(uint64_t num_nodes, uint64_t num_edges)
       : num_nodes_(num_nodes), num_edges_(num_edges) {}
 
+  /// Play log into a GraphUpdate for a graph of num_nodes nodes and
+  /// num_edges edges, in parallel. Property operations on the same node or
+  /// edge resolve to the last of them; operations on nodes or edges out of
+  /// bounds are ignored.
+  ///
+  /// \returns NotImplemented if log adds or deletes nodes or edges
+  static Result<GraphUpdate> Make(
+      const OpLog& log, uint64_t num_nodes, uint64_t num_edges);
+
+  /// Merge the updates, played from log, into the properties of pfg in
+  /// parallel. Properties that pfg does not have are added with nulls for the
+  /// nodes or edges that were not updated, and deleted values become null.
+  ///
+  /// \returns TypeError if a value does not have the type of its property and
+  /// NotImplemented for list values
+  Result<void> MergeInto(
+      const OpLog& log, galois::graphs::PropertyFileGraph* pfg) const;
+
   uint32_t num_nprop() const { return nprop_.size(); }
   uint32_t num_eprop() const { return eprop_.size(); }
 
   /// When a new node/edge property is added, call these functions to register it and get back
   /// the property index.
   uint32_t RegisterNodeProp(const std::string& name) {
-    return RegisterProp(name, num_nodes_, nprop_, nprop_names_);
+    return RegisterProp(name, nprop_, nprop_names_);
   }
   uint32_t RegisterEdgeProp(const std::string& name) {
-    return RegisterProp(name, num_edges_, eprop_, eprop_names_);
+    return RegisterProp(name, eprop_, eprop_names_);
   }
   std::string GetNName(uint32_t pnum) {
     if (pnum >= nprop_names_.size()) {
@@ -134,6 +198,10 @@ public:
     }
     return nprop_names_[pnum];
   }
+  /// The updates of a node property
+  const Updates& GetNUpdates(uint32_t pnum) const { return nprop_.at(pnum); }
+  /// The log index of the update of each node, or 0; prefer GetNUpdates,
+  /// which does not take space for the nodes that were not updated
   std::vector<uint64_t> GetNIndices(uint32_t pnum) {
     if (pnum >= nprop_names_.size()) {
       GALOIS_LOG_DEBUG(
@@ -141,7 +209,7 @@ public:
           nprop_names_.size());
       return {};
     }
-    return nprop_[pnum];
+    return Dense(nprop_[pnum], num_nodes_);
   }
   std::string GetEName(uint32_t pnum) {
     if (pnum >= eprop_names_.size()) {
@@ -152,6 +220,9 @@ public:
     }
     return eprop_names_[pnum];
   }
+  /// The updates of an edge property
+  const Updates& GetEUpdates(uint32_t pnum) const { return eprop_.at(pnum); }
+  /// The log index of the update of each edge, or 0; prefer GetEUpdates
   std::vector<uint64_t> GetEIndices(uint32_t pnum) {
     if (pnum >= eprop_names_.size()) {
       GALOIS_LOG_DEBUG(
@@ -159,14 +230,14 @@ public:
           eprop_names_.size());
       return {};
     }
-    return eprop_[pnum];
+    return Dense(eprop_[pnum], num_edges_);
   }
 
   void SetNProp(uint32_t pnum, uint64_t index, uint64_t op_log_index) {
-    SetProp(pnum, index, op_log_index, nprop_);
+    SetProp(pnum, index, num_nodes_, op_log_index, nprop_);
   }
   void SetEProp(uint32_t pnum, uint64_t index, uint64_t op_log_index) {
-    SetProp(pnum, index, op_log_index, eprop_);
+    SetProp(pnum, index, num_edges_, op_log_index, eprop_);
   }
 };
 
@@ -20,6 +20,15 @@
 #ifndef GALOIS_LIBGALOIS_GALOIS_PARALLELSTL_H_
 #define GALOIS_LIBGALOIS_GALOIS_PARALLELSTL_H_
 
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <new>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 #include "galois/LoopsDecl.h"
 #include "galois/NoDerefIterator.h"
 #include "galois/Range.h"
@@ -28,6 +37,7 @@
 #include "galois/Traits.h"
 #include "galois/UserContext.h"
 #include "galois/config.h"
+#include "galois/substrate/NumaMem.h"
 #include "galois/worklists/Chunk.h"
 
 namespace galois {
@@ -35,6 +45,14 @@ namespace galois {
 // TODO: rename to gstl?
 namespace ParallelSTL {
 
+//! The range of block of num_blocks about equal blocks of [0, size)
+inline std::pair<size_t, size_t>
+block_range(size_t block, size_t num_blocks, size_t size) {
+  size_t block_size = (size + num_blocks - 1) / num_blocks;
+  size_t begin = std::min(block * block_size, size);
+  return std::make_pair(begin, std::min(begin + block_size, size));
+}
+
 template <class InputIterator, class Predicate>
 size_t
 count_if(InputIterator first, InputIterator last, Predicate pred) {
@@ -85,59 +103,6 @@ find_if(InputIterator first, InputIterator last, Predicate pred) {
   return last;
 }
 
-template <class Iterator>
-Iterator
-choose_rand(Iterator first, Iterator last) {
-  size_t dist = std::distance(first, last);
-  if (dist)
-    std::advance(first, rand() % dist);
-  return first;
-}
-
-template <class Compare>
-struct sort_helper {
-  Compare comp;
-
-  //! Not equal in terms of less-than
-  template <class value_type>
-  struct neq_to {
-    Compare comp;
-    neq_to(Compare c) : comp(c) {}
-    bool operator()(const value_type& a, const value_type& b) const {
-      return comp(a, b) || comp(b, a);
-    }
-  };
-
-  sort_helper(Compare c) : comp(c) {}
-
-  template <class RandomAccessIterator, class Context>
-  void operator()(
-      std::pair<RandomAccessIterator, RandomAccessIterator> bounds,
-      Context& ctx) {
-    if (std::distance(bounds.first, bounds.second) <= 1024) {
-      std::sort(bounds.first, bounds.second, comp);
-    } else {
-      typedef
-          typename std::iterator_traits<RandomAccessIterator>::value_type VT;
-      RandomAccessIterator pivot = choose_rand(bounds.first, bounds.second);
-      VT pv = *pivot;
-      pivot = std::partition(
-          bounds.first, bounds.second,
-          std::bind(comp, std::placeholders::_1, pv));
-      // push the lower bit
-      if (bounds.first != pivot)
-        ctx.push(std::make_pair(bounds.first, pivot));
-      // adjust the upper bit
-      pivot = std::find_if(
-          pivot, bounds.second,
-          std::bind(neq_to<VT>(comp), std::placeholders::_1, pv));
-      // push the upper bit
-      if (bounds.second != pivot)
-        ctx.push(std::make_pair(pivot, bounds.second));
-    }
-  }
-};
-
 template <typename RandomAccessIterator, class Predicate>
 std::pair<RandomAccessIterator, RandomAccessIterator>
 dual_partition(
@@ -248,30 +213,6 @@ struct pair_dist {
   }
 };
 
-template <class RandomAccessIterator, class Compare>
-void
-sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
-  if (std::distance(first, last) <= 1024) {
-    std::sort(first, last, comp);
-    return;
-  }
-  typedef galois::worklists::PerSocketChunkFIFO<1> WL;
-
-  for_each(
-      galois::iterate({std::make_pair(first, last)}),
-      sort_helper<Compare>(comp), galois::disable_conflict_detection(),
-      galois::wl<WL>());
-}
-
-template <class RandomAccessIterator>
-void
-sort(RandomAccessIterator first, RandomAccessIterator last) {
-  galois::ParallelSTL::sort(
-      first, last,
-      std::less<
-          typename std::iterator_traits<RandomAccessIterator>::value_type>());
-}
-
 template <class InputIterator, class T, typename BinaryOperation>
 T
 accumulate(
@@ -319,75 +260,618 @@ template <class I>
 std::enable_if_t<std::is_scalar<internal::Val_ty<I>>::value>
 destroy(I, I) {}
 
+//! Ranges shorter than this are scanned and packed serially
+constexpr size_t kParallelScanCutoff = size_t{1} << 14;
+
+/**
+ * Writes the inclusive scan of [first, last) by the associative op to the
+ * range starting at d_first, which may be first, and returns the end of it.
+ *
+ * Each thread first reduces a contiguous block, the sums of the blocks are
+ * scanned serially and then each thread scans its block again starting from
+ * the sum of the blocks before it, so every element is read twice and
+ * written once.
+ */
+template <class InputIt, class OutputIt, class BinaryOp>
+OutputIt
+inclusive_scan(InputIt first, InputIt last, OutputIt d_first, BinaryOp op) {
+  using ValueType = typename std::iterator_traits<InputIt>::value_type;
+
+  size_t size = std::distance(first, last);
+  const size_t num_blocks = galois::getActiveThreads();
+  if (size < kParallelScanCutoff || num_blocks == 1) {
+    return std::partial_sum(first, last, d_first, op);
+  }
+
+  // the sum of each block and then of the blocks before it
+  std::vector<ValueType> block_sums(num_blocks);
+  galois::on_each([&](unsigned tid, unsigned) {
+    auto [begin, end] = block_range(tid, num_blocks, size);
+    if (begin == end) {
+      return;
+    }
+    ValueType sum = first[begin];
+    for (size_t i = begin + 1; i < end; ++i) {
+      sum = op(sum, first[i]);
+    }
+    block_sums[tid] = sum;
+  });
+
+  // block 0 holds the first element, so only later blocks may be empty
+  ValueType running = block_sums[0];
+  for (size_t b = 1; b < num_blocks; ++b) {
+    auto [begin, end] = block_range(b, num_blocks, size);
+    ValueType block_sum = block_sums[b];
+    block_sums[b] = running;
+    if (begin != end) {
+      running = op(running, block_sum);
+    }
+  }
+
+  galois::on_each([&](unsigned tid, unsigned) {
+    auto [begin, end] = block_range(tid, num_blocks, size);
+    if (begin == end) {
+      return;
+    }
+    ValueType sum = tid == 0 ? first[begin] : op(block_sums[tid], first[begin]);
+    d_first[begin] = sum;
+    for (size_t i = begin + 1; i < end; ++i) {
+      sum = op(sum, first[i]);
+      d_first[i] = sum;
+    }
+  });
+  return d_first + size;
+}
+
+template <class InputIt, class OutputIt>
+OutputIt
+inclusive_scan(InputIt first, InputIt last, OutputIt d_first) {
+  using ValueType = typename std::iterator_traits<InputIt>::value_type;
+  return galois::ParallelSTL::inclusive_scan(
+      first, last, d_first, std::plus<ValueType>());
+}
+
+/**
+ * Writes the exclusive scan of [first, last) by the associative op starting
+ * from init to the range starting at d_first, which may be first, and
+ * returns the end of it: element i of the output is the sum of init and the
+ * elements before i, e.g., the first edge of each node given the degrees.
+ * Runs like inclusive_scan.
+ */
+template <class InputIt, class OutputIt, class T, class BinaryOp>
+OutputIt
+exclusive_scan(
+    InputIt first, InputIt last, OutputIt d_first, T init, BinaryOp op) {
+  size_t size = std::distance(first, last);
+  const size_t num_blocks = galois::getActiveThreads();
+  if (size < kParallelScanCutoff || num_blocks == 1) {
+    for (; first != last; ++first, ++d_first) {
+      T value = *first;
+      *d_first = init;
+      init = op(init, value);
+    }
+    return d_first;
+  }
+
+  // the sum of each block and then init and the sum of the blocks before it
+  std::vector<T> block_sums(num_blocks, init);
+  galois::on_each([&](unsigned tid, unsigned) {
+    auto [begin, end] = block_range(tid, num_blocks, size);
+    if (begin == end) {
+      return;
+    }
+    T sum = first[begin];
+    for (size_t i = begin + 1; i < end; ++i) {
+      sum = op(sum, first[i]);
+    }
+    block_sums[tid] = sum;
+  });
+
+  T running = init;
+  for (size_t b = 0; b < num_blocks; ++b) {
+    auto [begin, end] = block_range(b, num_blocks, size);
+    T block_sum = block_sums[b];
+    block_sums[b] = running;
+    if (begin != end) {
+      running = op(running, block_sum);
+    }
+  }
+
+  galois::on_each([&](unsigned tid, unsigned) {
+    auto [begin, end] = block_range(tid, num_blocks, size);
+    T sum = block_sums[tid];
+    for (size_t i = begin; i < end; ++i) {
+      T value = first[i];
+      d_first[i] = sum;
+      sum = op(sum, value);
+    }
+  });
+  return d_first + size;
+}
+
+template <class InputIt, class OutputIt, class T>
+OutputIt
+exclusive_scan(InputIt first, InputIt last, OutputIt d_first, T init) {
+  return galois::ParallelSTL::exclusive_scan(
+      first, last, d_first, init, std::plus<T>());
+}
+
 /**
  * Does a partial sum from first -> last and writes the results to the d_first
- * iterator.
+ * iterator; an inclusive_scan by addition.
  */
 template <class InputIt, class OutputIt>
 OutputIt
 partial_sum(InputIt first, InputIt last, OutputIt d_first) {
-  using ValueType = typename std::iterator_traits<InputIt>::value_type;
+  return galois::ParallelSTL::inclusive_scan(first, last, d_first);
+}
+
+/**
+ * The parallel part of copy_if and pack_index: writes get(i) for each i in
+ * [0, size) with keep(i), in order, to the range starting at d_first and
+ * returns the end of them. Each thread counts the kept elements of a
+ * contiguous block and then writes them after those of the blocks before it,
+ * so keep is called twice for each element.
+ */
+template <class OutputIt, class KeepFn, class GetFn>
+OutputIt
+pack(size_t size, OutputIt d_first, const KeepFn& keep, const GetFn& get) {
+  const size_t num_blocks = galois::getActiveThreads();
+  if (size < kParallelScanCutoff || num_blocks == 1) {
+    for (size_t i = 0; i < size; ++i) {
+      if (keep(i)) {
+        *d_first++ = get(i);
+      }
+    }
+    return d_first;
+  }
+
+  // the number of kept elements of each block and then of those before it
+  std::vector<size_t> offsets(num_blocks);
+  galois::on_each([&](unsigned tid, unsigned) {
+    auto [begin, end] = block_range(tid, num_blocks, size);
+    size_t count = 0;
+    for (size_t i = begin; i < end; ++i) {
+      count += keep(i) ? 1 : 0;
+    }
+    offsets[tid] = count;
+  });
 
-  size_t sizeOfVector = std::distance(first, last);
+  size_t total = 0;
+  for (size_t b = 0; b < num_blocks; ++b) {
+    size_t count = offsets[b];
+    offsets[b] = total;
+    total += count;
+  }
 
-  // only bother with parallel execution if vector is larger than some size
-  if (sizeOfVector >= 1024) {
-    const size_t numBlocks = galois::getActiveThreads();
-    const size_t blockSize = (sizeOfVector + numBlocks - 1) / numBlocks;
-    assert(numBlocks * blockSize >= sizeOfVector);
+  galois::on_each([&](unsigned tid, unsigned) {
+    auto [begin, end] = block_range(tid, num_blocks, size);
+    OutputIt out = d_first + offsets[tid];
+    for (size_t i = begin; i < end; ++i) {
+      if (keep(i)) {
+        *out++ = get(i);
+      }
+    }
+  });
+  return d_first + total;
+}
 
-    std::vector<ValueType> localSums(numBlocks);
+/**
+ * Copies the elements of [first, last) that satisfy pred, in order, to the
+ * range starting at d_first, which must not overlap the input, and returns
+ * the end of the copies. pred is called twice for each element.
+ */
+template <class InputIt, class OutputIt, class Predicate>
+OutputIt
+copy_if(InputIt first, InputIt last, OutputIt d_first, Predicate pred) {
+  return galois::ParallelSTL::pack(
+      std::distance(first, last), d_first,
+      [&](size_t i) { return pred(first[i]); },
+      [&](size_t i) { return first[i]; });
+}
 
-    // get the block sums
+/**
+ * Writes the index of each element of [first, last) that satisfies pred, in
+ * order, to the range starting at d_first and returns the end of them, e.g.,
+ * to turn a dense frontier of flags into a sparse one. pred is called twice
+ * for each element.
+ */
+template <class InputIt, class OutputIt, class Predicate>
+OutputIt
+pack_index(InputIt first, InputIt last, OutputIt d_first, Predicate pred) {
+  return galois::ParallelSTL::pack(
+      std::distance(first, last), d_first,
+      [&](size_t i) { return pred(first[i]); }, [](size_t i) { return i; });
+}
+
+//! pack_index of the elements of [first, last) that convert to true
+template <class InputIt, class OutputIt>
+OutputIt
+pack_index(InputIt first, InputIt last, OutputIt d_first) {
+  return galois::ParallelSTL::pack_index(
+      first, last, d_first,
+      [](const auto& v) { return static_cast<bool>(v); });
+}
+
+//! Bits of the digits of radix_sort; the counts of a thread for one digit
+//! fit in L1
+constexpr unsigned kRadixBits = 8;
+constexpr size_t kRadixBuckets = size_t{1} << kRadixBits;
+//! Ranges at most this long are sorted serially
+constexpr size_t kParallelSortCutoff = size_t{1} << 14;
+
+//! Integers that radix_sort orders by value
+template <typename T>
+struct is_radix_key
+    : std::bool_constant<std::is_integral_v<T> && !std::is_same_v<T, bool>> {
+};
+
+//! Values that radix_sort orders like std::less: integers and pairs of them
+template <typename T>
+struct is_radix_sortable : is_radix_key<T> {};
+
+template <typename T, typename U>
+struct is_radix_sortable<std::pair<T, U>>
+    : std::bool_constant<is_radix_key<T>::value && is_radix_key<U>::value> {
+};
+
+//! The unsigned integer whose order is the order of v
+template <typename T>
+std::make_unsigned_t<T>
+radix_key(T v) {
+  using U = std::make_unsigned_t<T>;
+  U key = static_cast<U>(v);
+  if constexpr (std::is_signed_v<T>) {
+    key ^= U{1} << (8 * sizeof(U) - 1);
+  }
+  return key;
+}
+
+//! The number of bits of the greatest of key(i) for i in [0, size)
+template <typename KeyFn>
+unsigned
+radix_key_bits(size_t size, const KeyFn& key) {
+  galois::GReduceMax<uint64_t> max_key;
+  galois::do_all(
+      galois::iterate(size_t{0}, size),
+      [&](size_t i) { max_key.update(key(i)); }, galois::no_stats());
+  uint64_t max = max_key.reduce();
+  return max == 0 ? 0 : 64 - __builtin_clzll(max);
+}
+
+/**
+ * One stable counting sort pass of a radix sort over size elements: moves
+ * element i of the source, whose digit is digit(i), to position j of the
+ * destination with move(i, j).
+ *
+ * Each thread counts and then moves a contiguous block of the source, so it
+ * reads the memory it first touched. Returns false, having moved nothing, if
+ * all the elements have the same digit.
+ */
+template <typename DigitFn, typename MoveFn>
+bool
+radix_pass(size_t size, const DigitFn& digit, const MoveFn& move) {
+  const size_t num_blocks = galois::getActiveThreads();
+  // offsets[b * kRadixBuckets + d] is the number of elements of block b with
+  // digit d and then the position of the first of them in the destination
+  std::vector<size_t> offsets(num_blocks * kRadixBuckets);
+
+  galois::on_each([&](unsigned tid, unsigned) {
+    auto [begin, end] = block_range(tid, num_blocks, size);
+    size_t* counts = &offsets[tid * kRadixBuckets];
+    for (size_t i = begin; i < end; ++i) {
+      ++counts[digit(i)];
+    }
+  });
+
+  size_t next = 0;
+  for (size_t d = 0; d < kRadixBuckets; ++d) {
+    size_t bucket_begin = next;
+    for (size_t b = 0; b < num_blocks; ++b) {
+      size_t count = offsets[b * kRadixBuckets + d];
+      offsets[b * kRadixBuckets + d] = next;
+      next += count;
+    }
+    if (next - bucket_begin == size) {
+      return false;
+    }
+  }
+
+  galois::on_each([&](unsigned tid, unsigned) {
+    auto [begin, end] = block_range(tid, num_blocks, size);
+    size_t* cursors = &offsets[tid * kRadixBuckets];
+    for (size_t i = begin; i < end; ++i) {
+      move(i, cursors[digit(i)]++);
+    }
+  });
+  return true;
+}
+
+/**
+ * Sorts [first, last) stably by the unsigned integer key(v) of each value v
+ * with a parallel LSD radix sort.
+ *
+ * There is one pass per 8 bits of the greatest key and passes where all the
+ * keys have the same digit move nothing, so small keys, e.g., node ids, take
+ * few passes. The values move between the range and a buffer interleaved
+ * across NUMA nodes, so they must be trivially copy constructible and
+ * destructible, like integers, pairs of them and plain structs.
+ */
+template <class RandomAccessIterator, class KeyFn>
+void
+radix_sort(RandomAccessIterator first, RandomAccessIterator last, KeyFn key) {
+  using VT = typename std::iterator_traits<RandomAccessIterator>::value_type;
+  static_assert(
+      std::is_trivially_copy_constructible_v<VT> &&
+          std::is_trivially_destructible_v<VT>,
+      "radix_sort copies values to a buffer of raw memory");
+  static_assert(
+      std::is_unsigned_v<std::invoke_result_t<KeyFn, const VT&>>,
+      "radix_sort keys are unsigned integers");
+
+  size_t size = std::distance(first, last);
+  if (size <= kParallelSortCutoff) {
+    std::stable_sort(first, last, [&](const VT& a, const VT& b) {
+      return key(a) < key(b);
+    });
+    return;
+  }
+
+  unsigned bits =
+      radix_key_bits(size, [&](size_t i) -> uint64_t { return key(first[i]); });
+  substrate::LAptr memory = substrate::largeMallocInterleaved(
+      size * sizeof(VT), galois::getActiveThreads());
+  VT* buffer = reinterpret_cast<VT*>(memory.get());
+
+  bool in_buffer = false;
+  for (unsigned shift = 0; shift < bits; shift += kRadixBits) {
+    auto pass = [&](auto src, auto dst) {
+      return radix_pass(
+          size,
+          [&](size_t i) {
+            return (key(src[i]) >> shift) & (kRadixBuckets - 1);
+          },
+          [&](size_t i, size_t j) { dst[j] = src[i]; });
+    };
+    if (in_buffer ? pass(buffer, first) : pass(first, buffer)) {
+      in_buffer = !in_buffer;
+    }
+  }
+
+  if (in_buffer) {
     galois::do_all(
-        galois::iterate((size_t)0, numBlocks), [&](const size_t& block) {
-          // block start can extend past sizeOfVector if doesn't divide evenly
-          size_t blockStart = std::min(block * blockSize, sizeOfVector);
-          size_t blockEnd = std::min((block + 1) * blockSize, sizeOfVector);
-          assert(blockStart <= blockEnd);
-
-          // partial accumulation of each block done now
-          std::partial_sum(
-              first + blockStart, first + blockEnd, d_first + blockStart);
-          // save the last number in this block: used for block prefix sum
-          if (blockEnd > 0) {
-            localSums[block] = *(d_first + blockEnd - 1);
-          } else {
-            localSums[block] = 0;
-          }
-        });
-
-    // bulkPrefix[i] holds the starting sum of a particular block i
-    std::vector<ValueType> bulkPrefix(numBlocks);
-    // exclusive scan on local sums to get number to add to each block's
-    // set of indices
-    // Not using std::exclusive_scan because apparently it doesn't work for
-    // some compilers
-    ValueType runningSum = 0;
-    for (size_t i = 0; i < numBlocks; i++) {
-      bulkPrefix[i] = runningSum;
-      runningSum += localSums[i];
+        galois::iterate(size_t{0}, size),
+        [&](size_t i) { first[i] = buffer[i]; }, galois::no_stats());
+  }
+}
+
+//! Sorts [first, last) of integers or pairs of integers like std::sort with
+//! radix_sort
+template <class RandomAccessIterator>
+void
+radix_sort(RandomAccessIterator first, RandomAccessIterator last) {
+  using VT = typename std::iterator_traits<RandomAccessIterator>::value_type;
+  static_assert(
+      is_radix_sortable<VT>::value,
+      "radix_sort without a key sorts integers and pairs of them");
+  if constexpr (is_radix_key<VT>::value) {
+    radix_sort(first, last, [](const VT& v) { return radix_key(v); });
+  } else {
+    // by the second member and then, keeping that order for ties, the first
+    radix_sort(first, last, [](const VT& v) { return radix_key(v.second); });
+    radix_sort(first, last, [](const VT& v) { return radix_key(v.first); });
+  }
+}
+
+/**
+ * Sorts the integers [keys_first, keys_last) and moves the values starting at
+ * values_first along with them, so that values_first[i] ends up paired with
+ * keys_first[i] again, e.g., to sort the destinations of a CSR by source.
+ * Values of equal keys keep their order. Like those of radix_sort, values
+ * must be trivially copy constructible and destructible.
+ */
+template <class KeyIterator, class ValueIterator>
+void
+sort_by_key(
+    KeyIterator keys_first, KeyIterator keys_last, ValueIterator values_first) {
+  using K = typename std::iterator_traits<KeyIterator>::value_type;
+  using V = typename std::iterator_traits<ValueIterator>::value_type;
+  static_assert(is_radix_key<K>::value, "sort_by_key keys are integers");
+  static_assert(
+      std::is_trivially_copy_constructible_v<V> &&
+          std::is_trivially_destructible_v<V>,
+      "sort_by_key copies values to a buffer of raw memory");
+
+  size_t size = std::distance(keys_first, keys_last);
+  if (size <= kParallelSortCutoff) {
+    std::vector<std::pair<K, V>> pairs(size);
+    for (size_t i = 0; i < size; ++i) {
+      pairs[i] = std::make_pair(keys_first[i], values_first[i]);
+    }
+    std::stable_sort(
+        pairs.begin(), pairs.end(),
+        [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (size_t i = 0; i < size; ++i) {
+      keys_first[i] = pairs[i].first;
+      values_first[i] = pairs[i].second;
+    }
+    return;
+  }
+
+  unsigned bits = radix_key_bits(
+      size, [&](size_t i) -> uint64_t { return radix_key(keys_first[i]); });
+  unsigned num_threads = galois::getActiveThreads();
+  substrate::LAptr key_memory =
+      substrate::largeMallocInterleaved(size * sizeof(K), num_threads);
+  substrate::LAptr value_memory =
+      substrate::largeMallocInterleaved(size * sizeof(V), num_threads);
+  K* key_buffer = reinterpret_cast<K*>(key_memory.get());
+  V* value_buffer = reinterpret_cast<V*>(value_memory.get());
+
+  bool in_buffer = false;
+  for (unsigned shift = 0; shift < bits; shift += kRadixBits) {
+    auto pass = [&](auto src_keys, auto src_values, auto dst_keys,
+                    auto dst_values) {
+      return radix_pass(
+          size,
+          [&](size_t i) {
+            return (radix_key(src_keys[i]) >> shift) & (kRadixBuckets - 1);
+          },
+          [&](size_t i, size_t j) {
+            dst_keys[j] = src_keys[i];
+            dst_values[j] = src_values[i];
+          });
+    };
+    if (in_buffer
+            ? pass(key_buffer, value_buffer, keys_first, values_first)
+            : pass(keys_first, values_first, key_buffer, value_buffer)) {
+      in_buffer = !in_buffer;
     }
+  }
 
+  if (in_buffer) {
     galois::do_all(
-        galois::iterate((size_t)0, numBlocks), [&](const size_t& block) {
-          // add the sums of previous elements to blocks
-          ValueType numToAdd = bulkPrefix[block];
-          size_t blockStart = std::min(block * blockSize, sizeOfVector);
-          size_t blockEnd = std::min((block + 1) * blockSize, sizeOfVector);
-          assert(blockStart <= blockEnd);
-
-          // transform applies addition to appropriate range
-          std::transform(
-              d_first + blockStart, d_first + blockEnd, d_first + blockStart,
-              [&](ValueType& val) { return val + numToAdd; });
-        });
-
-    // return the iterator past the last element written
-    return d_first + sizeOfVector;
+        galois::iterate(size_t{0}, size),
+        [&](size_t i) {
+          keys_first[i] = key_buffer[i];
+          values_first[i] = value_buffer[i];
+        },
+        galois::no_stats());
+  }
+}
+
+/**
+ * Sorts [first, last) by comp with a parallel sample sort.
+ *
+ * Splitters picked from a sorted random sample cut the values into about
+ * four buckets per thread, plus one bucket for the values equal to each
+ * splitter, so many equal values do not end up in one large bucket. Each
+ * thread classifies a contiguous block of the range and moves its values to
+ * their buckets in a buffer interleaved across NUMA nodes, and then the
+ * buckets are sorted and moved back in parallel. Values must be copy and
+ * move constructible.
+ */
+template <class RandomAccessIterator, class Compare>
+void
+sample_sort(
+    RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+  using VT = typename std::iterator_traits<RandomAccessIterator>::value_type;
+
+  size_t size = std::distance(first, last);
+  const size_t num_blocks = galois::getActiveThreads();
+  if (size <= kParallelSortCutoff || num_blocks == 1) {
+    std::sort(first, last, comp);
+    return;
+  }
+
+  // sample kOversampling values per bucket
+  constexpr size_t kOversampling = 32;
+  const size_t target_buckets = std::min<size_t>(4 * num_blocks, 4096);
+  std::vector<VT> samples;
+  samples.reserve(target_buckets * kOversampling);
+  std::minstd_rand gen(size);
+  std::uniform_int_distribution<size_t> dist(0, size - 1);
+  for (size_t i = 0; i < target_buckets * kOversampling; ++i) {
+    samples.emplace_back(first[dist(gen)]);
+  }
+  std::sort(samples.begin(), samples.end(), comp);
+  std::vector<VT> splitters;
+  for (size_t k = 1; k < target_buckets; ++k) {
+    splitters.emplace_back(samples[k * kOversampling]);
+  }
+  splitters.erase(
+      std::unique(
+          splitters.begin(), splitters.end(),
+          [&](const VT& a, const VT& b) { return !comp(a, b); }),
+      splitters.end());
+  samples = std::vector<VT>();
+
+  // bucket 2k holds the values between splitters k - 1 and k and bucket
+  // 2k + 1 the values equal to splitter k
+  const size_t num_splitters = splitters.size();
+  const size_t num_buckets = 2 * num_splitters + 1;
+  auto bucket_of = [&](const VT& v) -> uint16_t {
+    size_t k = std::lower_bound(splitters.begin(), splitters.end(), v, comp) -
+               splitters.begin();
+    return k < num_splitters && !comp(v, splitters[k]) ? 2 * k + 1 : 2 * k;
+  };
+
+  std::vector<uint16_t> buckets(size);
+  // offsets[b * num_buckets + k] is the number of values of block b in
+  // bucket k and then the position of the first of them in the buffer
+  std::vector<size_t> offsets(num_blocks * num_buckets);
+  galois::on_each([&](unsigned tid, unsigned) {
+    auto [begin, end] = block_range(tid, num_blocks, size);
+    size_t* counts = &offsets[tid * num_buckets];
+    for (size_t i = begin; i < end; ++i) {
+      buckets[i] = bucket_of(first[i]);
+      ++counts[buckets[i]];
+    }
+  });
+
+  std::vector<size_t> bucket_begins(num_buckets + 1);
+  size_t next = 0;
+  for (size_t k = 0; k < num_buckets; ++k) {
+    bucket_begins[k] = next;
+    for (size_t b = 0; b < num_blocks; ++b) {
+      size_t count = offsets[b * num_buckets + k];
+      offsets[b * num_buckets + k] = next;
+      next += count;
+    }
+  }
+  bucket_begins[num_buckets] = next;
+
+  substrate::LAptr memory =
+      substrate::largeMallocInterleaved(size * sizeof(VT), num_blocks);
+  VT* buffer = reinterpret_cast<VT*>(memory.get());
+  galois::on_each([&](unsigned tid, unsigned) {
+    auto [begin, end] = block_range(tid, num_blocks, size);
+    size_t* cursors = &offsets[tid * num_buckets];
+    for (size_t i = begin; i < end; ++i) {
+      new (&buffer[cursors[buckets[i]]++]) VT(std::move(first[i]));
+    }
+  });
+  buckets = std::vector<uint16_t>();
+
+  // the values of bucket 2k + 1 are all equal and need no sorting
+  galois::do_all(
+      galois::iterate(size_t{0}, num_buckets),
+      [&](size_t k) {
+        VT* begin = buffer + bucket_begins[k];
+        VT* end = buffer + bucket_begins[k + 1];
+        if (k % 2 == 0) {
+          std::sort(begin, end, comp);
+        }
+        auto out = first + bucket_begins[k];
+        for (VT* v = begin; v != end; ++v, ++out) {
+          *out = std::move(*v);
+          v->~VT();
+        }
+      },
+      galois::steal(), galois::no_stats());
+}
+
+/**
+ * Sorts [first, last) by comp in parallel with sample_sort.
+ */
+template <class RandomAccessIterator, class Compare>
+void
+sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+  galois::ParallelSTL::sample_sort(first, last, comp);
+}
+
+/**
+ * Sorts [first, last) in parallel: integers and pairs of them with
+ * radix_sort and other values with sample_sort.
+ */
+template <class RandomAccessIterator>
+void
+sort(RandomAccessIterator first, RandomAccessIterator last) {
+  using VT = typename std::iterator_traits<RandomAccessIterator>::value_type;
+  if constexpr (is_radix_sortable<VT>::value) {
+    galois::ParallelSTL::radix_sort(first, last);
   } else {
-    // vector is small; do it serially using standard library
-    return std::partial_sum(first, last, d_first);
+    galois::ParallelSTL::sample_sort(first, last, std::less<VT>());
   }
 }
 
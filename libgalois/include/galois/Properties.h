@@ -13,7 +13,9 @@
 #include "galois/ErrorCode.h"
 #include "galois/Logging.h"
 #include "galois/Result.h"
+#include "galois/Span.h"
 #include "galois/Traits.h"
+#include "tsuba/MemoryPool.h"
 
 namespace galois {
 
@@ -189,6 +191,10 @@ ConstructPropertyViews(const std::vector<arrow::Array*>& arrays) {
 /// POD types as a concept are deprecated in C++20, but POD so much shorter to
 /// say than trivial and standard.
 ///
+/// The view points at the first value of the array, so GetValue is a plain
+/// index into the values, and data() exposes them for loops over all
+/// elements.
+///
 /// \tparam T A plain old C datatype type like double or int32_t
 template <typename T>
 class PODPropertyView {
@@ -196,6 +202,7 @@ public:
   using value_type = T;
   using reference = T&;
   using const_reference = const T&;
+  using Unchecked = PODPropertyView;
 
   template <typename U>
   static Result<PODPropertyView> Make(const arrow::NumericArray<U>& array) {
@@ -204,7 +211,7 @@ public:
         "incompatible types");
     assert(array.offset() >= 0);
     return PODPropertyView(
-        array.data()->template GetMutableValues<T>(1, 0),
+        array.data()->template GetMutableValues<T>(1),
         array.data()->template GetValues<uint8_t>(0, 0), array.length(),
         array.offset());
   }
@@ -214,7 +221,7 @@ public:
     assert(array.byte_width() == sizeof(T));
     assert(array.offset() >= 0);
     return PODPropertyView(
-        array.data()->template GetMutableValues<T>(1, 0),
+        array.data()->template GetMutableValues<T>(1),
         array.data()->template GetValues<uint8_t>(0, 0), array.length(),
         array.offset());
   }
@@ -225,14 +232,18 @@ public:
            arrow::BitUtil::GetBit(null_bitmap_, i + offset_);
   }
 
-  reference GetValue(size_t i) { return values_[i + offset_]; }
+  reference GetValue(size_t i) { return values_[i]; }
 
-  const_reference GetValue(size_t i) const { return values_[i + offset_]; }
+  const_reference GetValue(size_t i) const { return values_[i]; }
 
   reference operator[](size_t i) { return GetValue(i); }
 
   const_reference operator[](size_t i) const { return GetValue(i); }
 
+  T* data() { return values_; }
+  const T* data() const { return values_; }
+  size_t size() const { return length_; }
+
 private:
   PODPropertyView(
       T* values, const uint8_t* null_bitmap, size_t length, size_t offset)
@@ -246,74 +257,249 @@ private:
   size_t length_, offset_;
 };
 
+/// DensePODPropertyView is a PODPropertyView for arrays without nulls, which
+/// it checks once in Make, so that the view is just a pointer and a length
+/// and IsValid is always true. Properties that algorithms allocate
+/// themselves have no nulls.
+template <typename T>
+class DensePODPropertyView {
+public:
+  using value_type = T;
+  using reference = T&;
+  using const_reference = const T&;
+  using Unchecked = DensePODPropertyView;
+
+  template <typename U>
+  static Result<DensePODPropertyView> Make(
+      const arrow::NumericArray<U>& array) {
+    static_assert(
+        sizeof(typename arrow::NumericArray<U>::value_type) == sizeof(T),
+        "incompatible types");
+    if (array.null_count() != 0) {
+      return ErrorCode::InvalidArgument;
+    }
+    return DensePODPropertyView(
+        array.data()->template GetMutableValues<T>(1), array.length());
+  }
+
+  static Result<DensePODPropertyView> Make(
+      const arrow::FixedSizeBinaryArray& array) {
+    assert(array.byte_width() == sizeof(T));
+    if (array.null_count() != 0) {
+      return ErrorCode::InvalidArgument;
+    }
+    return DensePODPropertyView(
+        array.data()->template GetMutableValues<T>(1), array.length());
+  }
+
+  bool IsValid([[maybe_unused]] size_t i) const {
+    assert(i < length_);
+    return true;
+  }
+
+  reference GetValue(size_t i) { return values_[i]; }
+
+  const_reference GetValue(size_t i) const { return values_[i]; }
+
+  reference operator[](size_t i) { return GetValue(i); }
+
+  const_reference operator[](size_t i) const { return GetValue(i); }
+
+  T* data() { return values_; }
+  const T* data() const { return values_; }
+  size_t size() const { return length_; }
+
+private:
+  DensePODPropertyView(T* values, size_t length)
+      : values_(values), length_(length) {}
+
+  T* values_;
+  size_t length_;
+};
+
+/// The read-only views below come in two variants, selected by kCheckNulls:
+/// the checked one, the default, returns a default value from operator[]
+/// for null elements, and the unchecked one reads operator[] straight from
+/// the arrow buffers, which is meant for properties without nulls (or
+/// callers that check IsValid themselves). Unchecked<Prop> is the unchecked
+/// variant of property Prop. Views hold pointers into the buffers of the
+/// array, so they are only valid while the array is.
+
 /// BooleanPropertyReadOnlyView provides a read-only property view over
 /// arrow::Arrays of boolean elements.
-class BooleanPropertyReadOnlyView {
+template <bool kCheckNulls = true>
+class BasicBooleanPropertyReadOnlyView {
 public:
   // use uint8_t instead of bool for value_type to avoid std::vector<bool>
   // (std::vector<bool> specialization leads to issues in concurrent writes
   // as well as serialization/deserialization)
   using value_type = uint8_t;
+  using reference = value_type;
+  using const_reference = value_type;
+  using Unchecked = BasicBooleanPropertyReadOnlyView<false>;
 
-  static Result<BooleanPropertyReadOnlyView> Make(
+  static Result<BasicBooleanPropertyReadOnlyView> Make(
       const arrow::BooleanArray& array) {
-    return BooleanPropertyReadOnlyView(array);
+    assert(array.offset() >= 0);
+    return BasicBooleanPropertyReadOnlyView(
+        array.values()->data(), array.null_bitmap_data(), array.length(),
+        array.offset());
   }
 
   bool IsValid(size_t i) const {
-    assert(i < (size_t)array_.length());
-    return array_.IsValid(i);
+    assert(i < length_);
+    return null_bitmap_ == nullptr ||
+           arrow::BitUtil::GetBit(null_bitmap_, i + offset_);
   }
 
   value_type GetValue(size_t i) const {
     assert(IsValid(i));
-    return array_.Value(i);
+    return arrow::BitUtil::GetBit(values_, i + offset_);
   }
 
   value_type operator[](size_t i) const {
-    if (!IsValid(i)) {
+    if (kCheckNulls && !IsValid(i)) {
       return false;
     }
     return GetValue(i);
   }
 
 private:
-  BooleanPropertyReadOnlyView(const arrow::BooleanArray& array)
-      : array_(array) {}
+  BasicBooleanPropertyReadOnlyView(
+      const uint8_t* values, const uint8_t* null_bitmap, size_t length,
+      size_t offset)
+      : values_(values),
+        null_bitmap_(null_bitmap),
+        length_(length),
+        offset_(offset) {}
 
-  const arrow::BooleanArray& array_;
+  const uint8_t* values_;
+  const uint8_t* null_bitmap_;
+  size_t length_, offset_;
 };
 
+using BooleanPropertyReadOnlyView = BasicBooleanPropertyReadOnlyView<>;
+
 /// StringPropertyReadOnlyView provides a read-only property view over
 /// arrow::Arrays of string elements
-/// (i.e., arrow::StringArray or arrow::LargeStringArray).
-template <typename ArrowArrayType>
+/// (i.e., arrow::StringArray or arrow::LargeStringArray). Values are
+/// std::string_views of the string data of the array.
+template <typename ArrowArrayType, bool kCheckNulls = true>
 class StringPropertyReadOnlyView {
+  using offset_type = typename ArrowArrayType::offset_type;
+
 public:
-  using value_type = std::string;
+  using value_type = std::string_view;
+  using reference = value_type;
+  using const_reference = value_type;
+  using Unchecked = StringPropertyReadOnlyView<ArrowArrayType, false>;
 
   static Result<StringPropertyReadOnlyView> Make(const ArrowArrayType& array) {
-    return StringPropertyReadOnlyView(array);
+    assert(array.offset() >= 0);
+    // raw_value_offsets already accounts for the offset of the array
+    return StringPropertyReadOnlyView(
+        array.raw_value_offsets(),
+        reinterpret_cast<const char*>(array.raw_data()),
+        array.null_bitmap_data(), array.length(), array.offset());
+  }
+
+  bool IsValid(size_t i) const {
+    assert(i < length_);
+    return null_bitmap_ == nullptr ||
+           arrow::BitUtil::GetBit(null_bitmap_, i + offset_);
+  }
+
+  value_type GetValue(size_t i) const {
+    assert(IsValid(i));
+    offset_type begin = value_offsets_[i];
+    return value_type(data_ + begin, value_offsets_[i + 1] - begin);
+  }
+
+  value_type operator[](size_t i) const {
+    if (kCheckNulls && !IsValid(i)) {
+      return value_type{};
+    }
+    return GetValue(i);
+  }
+
+private:
+  StringPropertyReadOnlyView(
+      const offset_type* value_offsets, const char* data,
+      const uint8_t* null_bitmap, size_t length, size_t offset)
+      : value_offsets_(value_offsets),
+        data_(data),
+        null_bitmap_(null_bitmap),
+        length_(length),
+        offset_(offset) {}
+
+  const offset_type* value_offsets_;
+  const char* data_;
+  const uint8_t* null_bitmap_;
+  size_t length_, offset_;
+};
+
+/// ListPropertyReadOnlyView provides a read-only property view over
+/// arrow::Arrays of lists of T (i.e., arrow::ListArray or
+/// arrow::LargeListArray whose values are numeric arrays of T). Values are
+/// Spans of the value array of the list array; nulls within a list are not
+/// checked.
+template <typename T, typename ArrowArrayType, bool kCheckNulls = true>
+class ListPropertyReadOnlyView {
+  using offset_type = typename ArrowArrayType::offset_type;
+
+public:
+  using value_type = Span<const T>;
+  using reference = value_type;
+  using const_reference = value_type;
+  using Unchecked = ListPropertyReadOnlyView<T, ArrowArrayType, false>;
+
+  static Result<ListPropertyReadOnlyView> Make(const ArrowArrayType& array) {
+    using ValueArrowType = typename arrow::CTypeTraits<T>::ArrowType;
+    if (array.value_type()->id() != ValueArrowType::type_id) {
+      return ErrorCode::TypeError;
+    }
+    assert(array.offset() >= 0);
+    // raw_value_offsets already accounts for the offset of the array and
+    // GetValues for the offset of the value array
+    return ListPropertyReadOnlyView(
+        array.raw_value_offsets(),
+        array.values()->data()->template GetValues<T>(1),
+        array.null_bitmap_data(), array.length(), array.offset());
   }
 
-  bool IsValid(size_t i) const { return array_.IsValid(i); }
+  bool IsValid(size_t i) const {
+    assert(i < length_);
+    return null_bitmap_ == nullptr ||
+           arrow::BitUtil::GetBit(null_bitmap_, i + offset_);
+  }
 
   value_type GetValue(size_t i) const {
     assert(IsValid(i));
-    return array_.GetString(i);
+    offset_type begin = value_offsets_[i];
+    return value_type(values_ + begin, value_offsets_[i + 1] - begin);
   }
 
   value_type operator[](size_t i) const {
-    if (!IsValid(i)) {
+    if (kCheckNulls && !IsValid(i)) {
       return value_type{};
     }
     return GetValue(i);
   }
 
 private:
-  StringPropertyReadOnlyView(const ArrowArrayType& array) : array_(array) {}
+  ListPropertyReadOnlyView(
+      const offset_type* value_offsets, const T* values,
+      const uint8_t* null_bitmap, size_t length, size_t offset)
+      : value_offsets_(value_offsets),
+        values_(values),
+        null_bitmap_(null_bitmap),
+        length_(length),
+        offset_(offset) {}
 
-  const ArrowArrayType& array_;
+  const offset_type* value_offsets_;
+  const T* values_;
+  const uint8_t* null_bitmap_;
+  size_t length_, offset_;
 };
 
 template <typename T>
@@ -322,6 +508,13 @@ struct PODProperty {
   using ViewType = PODPropertyView<T>;
 };
 
+/// A PODProperty whose arrays have no nulls (\see DensePODPropertyView)
+template <typename T>
+struct DensePODProperty {
+  using ArrowType = typename arrow::CTypeTraits<T>::ArrowType;
+  using ViewType = DensePODPropertyView<T>;
+};
+
 struct UInt8Property : public PODProperty<uint8_t> {};
 
 struct UInt16Property : public PODProperty<uint16_t> {};
@@ -345,6 +538,26 @@ struct LargeStringReadOnlyProperty {
   using ViewType = StringPropertyReadOnlyView<arrow::LargeStringArray>;
 };
 
+template <typename T>
+struct ListReadOnlyProperty {
+  using ArrowType = arrow::ListType;
+  using ViewType = ListPropertyReadOnlyView<T, arrow::ListArray>;
+};
+
+template <typename T>
+struct LargeListReadOnlyProperty {
+  using ArrowType = arrow::LargeListType;
+  using ViewType = ListPropertyReadOnlyView<T, arrow::LargeListArray>;
+};
+
+/// Unchecked<Prop> is read-only property Prop without null checks in
+/// operator[], e.g., Unchecked<StringReadOnlyProperty>
+template <typename Prop>
+struct Unchecked {
+  using ArrowType = PropertyArrowType<Prop>;
+  using ViewType = typename PropertyViewType<Prop>::Unchecked;
+};
+
 template <typename Props>
 Result<std::shared_ptr<arrow::Table>>
 AllocateTable(uint64_t num_rows, const std::vector<std::string>& names) {
@@ -353,9 +566,8 @@ AllocateTable(uint64_t num_rows, const std::vector<std::string>& names) {
   std::shared_ptr<arrow::Table> table;
   std::vector<galois::PropertyArrowTuple<Props>> rows(num_rows);
   GALOIS_ASSERT(names.size() == num_tuple_elem);
-  // TODO(gill): Replace this with NUMA allocated buffers.
   if (auto r = arrow::stl::TableFromTupleRange(
-          arrow::default_memory_pool(), std::move(rows), names, &table);
+          tsuba::GetArrowMemoryPool(), std::move(rows), names, &table);
       !r.ok()) {
     GALOIS_LOG_DEBUG("arrow error: {}", r);
     return galois::ErrorCode::ArrowError;
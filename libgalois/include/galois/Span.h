@@ -0,0 +1,72 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_LIBGALOIS_GALOIS_SPAN_H_
+#define GALOIS_LIBGALOIS_GALOIS_SPAN_H_
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+
+namespace galois {
+
+/// A Span is a view of a contiguous sequence of elements that does not own
+/// them, i.e., the subset of C++20 std::span with a dynamic extent that we
+/// use.
+template <typename T>
+class Span {
+public:
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+  using size_type = size_t;
+  using pointer = T*;
+  using reference = T&;
+  using iterator = T*;
+
+  constexpr Span() noexcept : data_(nullptr), size_(0) {}
+  constexpr Span(T* data, size_t size) noexcept : data_(data), size_(size) {}
+
+  constexpr iterator begin() const noexcept { return data_; }
+  constexpr iterator end() const noexcept { return data_ + size_; }
+
+  constexpr pointer data() const noexcept { return data_; }
+  constexpr size_t size() const noexcept { return size_; }
+  constexpr bool empty() const noexcept { return size_ == 0; }
+
+  constexpr reference operator[](size_t i) const {
+    assert(i < size_);
+    return data_[i];
+  }
+
+  constexpr reference front() const { return (*this)[0]; }
+  constexpr reference back() const { return (*this)[size_ - 1]; }
+
+  constexpr Span subspan(size_t offset, size_t count) const {
+    assert(offset + count <= size_);
+    return Span(data_ + offset, count);
+  }
+
+private:
+  T* data_;
+  size_t size_;
+};
+
+}  // namespace galois
+
+#endif
@@ -20,6 +20,9 @@
 #ifndef GALOIS_LIBGALOIS_GALOIS_STATISTICS_H_
 #define GALOIS_LIBGALOIS_GALOIS_STATISTICS_H_
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <limits>
 #include <string>
 #include <type_traits>
@@ -27,6 +30,7 @@
 #include "galois/config.h"
 #include "galois/gIO.h"
 #include "galois/gstl.h"
+#include "galois/substrate/PerThreadStorage.h"
 
 namespace galois {
 
@@ -286,8 +290,11 @@ using ScalarStatManager = BasicStatMap<ScalarStat<T>>;
 
 }  // end namespace internal
 
+class StatHandle;
+
 class GALOIS_EXPORT StatManager {
   class Impl;
+  friend class StatHandle;
 
   std::unique_ptr<Impl> impl_;
 
@@ -337,6 +344,15 @@ protected:
       StatTotal::Type& type, gstl::Vector<Str>& vec) const;
 
 public:
+  /// How Print writes the statistics
+  enum class Format {
+    /// One line per statistic (and one for its thread values if
+    /// PRINT_PER_THREAD_STATS is set), fields separated by kSep
+    kCSV,
+    /// One JSON object, \see PrintJSON
+    kJSON,
+  };
+
   StatManager();
 
   StatManager(const StatManager&) = delete;
@@ -348,6 +364,10 @@ public:
 
   void SetStatFile(const std::string& outfile);
 
+  /// Sets the format of Print; the default comes from GALOIS_STATS_FORMAT
+  /// (csv or json) and is kCSV if that is unset
+  void SetStatFormat(Format format);
+
   void AddInt(
       const std::string& region, const std::string& category, int64_t val,
       const StatTotal::Type& type);
@@ -359,7 +379,102 @@ public:
   void AddParam(
       const std::string& region, const std::string& category, const Str& val);
 
+  /// Adds a single timing of region, category (e.g., one run of a timed
+  /// loop) to a histogram with power of two buckets of microseconds
+  void AddTiming(
+      const std::string& region, const std::string& category, uint64_t usec);
+
+  /// Adds timings that were counted elsewhere in the buckets of AddTiming:
+  /// bucket_counts[b] timings took at most 2^b microseconds (and more than
+  /// the bound of bucket b - 1); buckets past the last one of AddTiming are
+  /// added to it
+  void AddTimings(
+      const std::string& region, const std::string& category,
+      const uint64_t* bucket_counts, size_t num_buckets, uint64_t sum_usec);
+
   void Print();
+
+  /// Writes the statistics reported so far as one JSON object that maps
+  /// each region (usually a loop name) to its categories; each category has
+  /// its total type, total, the value of each thread that reported it and
+  /// the histogram of its timings, if any. Unlike Print, this may be called
+  /// while loops run and report statistics.
+  void PrintJSON(std::ostream& out) const;
+
+  /// Writes the statistics reported so far in the Prometheus text format:
+  /// galois_stat and galois_stat_thread gauges, galois_param info metrics and
+  /// galois_timing_usec histograms, labelled by region and category. May be
+  /// called while loops run (\see StatsServer).
+  void PrintPrometheus(std::ostream& out) const;
+
+private:
+  void Register(StatHandle* handle);
+
+  /// Adds the values of handle to the statistics of the threads that counted
+  /// them and forgets handle
+  void Unregister(StatHandle* handle);
+};
+
+/// An integer statistic registered once with the system StatManager, for
+/// code that reports it often, e.g., once per round of an algorithm.
+///
+/// Add is a plain add to a counter of the calling thread: no lookup, lock
+/// or string copy. Like AddInt, the counter of each thread is the sum of
+/// what it added, and the threads are totalled by type. The StatManager
+/// reads the counters when it prints or exports statistics, and folds them
+/// into the statistics of each thread when the handle is destroyed.
+class GALOIS_EXPORT StatHandle {
+  friend class StatManager;
+
+  struct ThreadValue {
+    // Only the owner writes; others read while printing concurrently
+    std::atomic<int64_t> value{0};
+    std::atomic<bool> reported{false};
+  };
+
+  substrate::PerThreadStorage<ThreadValue> values_;
+  gstl::Str region_;
+  gstl::Str category_;
+  StatTotal::Type type_;
+  StatManager* manager_;
+
+public:
+  StatHandle(
+      const std::string& region, const std::string& category,
+      const StatTotal::Type& type = StatTotal::TSUM);
+
+  StatHandle(const StatHandle&) = delete;
+  StatHandle& operator=(const StatHandle&) = delete;
+  StatHandle(StatHandle&&) = delete;
+  StatHandle& operator=(StatHandle&&) = delete;
+
+  ~StatHandle();
+
+  void Add(int64_t val) {
+    ThreadValue& local = *values_.getLocal();
+    if (!local.reported.load(std::memory_order_relaxed)) {
+      local.reported.store(true, std::memory_order_relaxed);
+    }
+    local.value.store(
+        local.value.load(std::memory_order_relaxed) + val,
+        std::memory_order_relaxed);
+  }
+
+  /// Reads the counter of thread tid; returns false if it added nothing
+  bool Read(unsigned tid, int64_t* val) const {
+    const ThreadValue& remote = *values_.getRemote(tid);
+    if (!remote.reported.load(std::memory_order_relaxed)) {
+      return false;
+    }
+    *val = remote.value.load(std::memory_order_relaxed);
+    return true;
+  }
+
+  size_t num_threads() const { return values_.size(); }
+
+  const gstl::Str& region() const { return region_; }
+  const gstl::Str& category() const { return category_; }
+  const StatTotal::Type& type() const { return type_; }
 };
 
 namespace internal {
@@ -367,6 +482,11 @@ namespace internal {
 GALOIS_EXPORT void setSysStatManager(StatManager* sm);
 GALOIS_EXPORT StatManager* sysStatManager();
 
+/// Adds a timing to the system StatManager (\see StatManager::AddTiming) if
+/// there is one
+GALOIS_EXPORT void ReportTiming(
+    const std::string& region, const std::string& category, uint64_t usec);
+
 }  // end namespace internal
 
 template <typename T>
@@ -434,15 +554,19 @@ ReportStatAvg(
 //! @param id Identifier to prefix stat with in statistics output
 GALOIS_EXPORT void reportRUsage(const std::string& id);
 
-//! Reports Galois system memory stats for all threads
+//! Reports Galois system memory stats for all threads, and how many of the
+//! pages allocated so far have huge page backing (\see substrate::PageAllocStats)
 GALOIS_EXPORT void reportPageAlloc(const char* category);
 
 /// Prints statistics out to standard out or to the file indicated by
-/// SetStatFile
+/// SetStatFile, and writes the trace to the file named by GALOIS_TRACE, if
+/// any (\see galois/Trace.h)
 GALOIS_EXPORT void PrintStats();
 
 GALOIS_EXPORT void SetStatFile(const std::string& f);
 
+GALOIS_EXPORT void SetStatFormat(StatManager::Format format);
+
 }  // end namespace galois
 
 #endif
@@ -0,0 +1,64 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_LIBGALOIS_GALOIS_STATSSERVER_H_
+#define GALOIS_LIBGALOIS_GALOIS_STATSSERVER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#include "galois/Result.h"
+#include "galois/config.h"
+
+namespace galois {
+
+/// Serves the statistics of the system StatManager over HTTP in the
+/// Prometheus text format (\see StatManager::PrintPrometheus), so that
+/// long-running services can expose loop timings, worklist and I/O
+/// statistics while they run. Every request, whatever its path, gets the
+/// statistics reported so far. SharedMemSys starts one on the port in
+/// GALOIS_STATS_PROMETHEUS_PORT, if set.
+class GALOIS_EXPORT StatsServer {
+  int listen_fd_;
+  uint16_t port_;
+  std::atomic<bool> stop_{false};
+  std::thread thread_;
+
+  StatsServer(int listen_fd, uint16_t port);
+
+  void Serve();
+
+public:
+  /// Listens on port of all interfaces; port 0 picks a free port
+  static Result<std::unique_ptr<StatsServer>> Make(uint16_t port);
+
+  /// Stops serving; the request being served, if any, finishes first
+  ~StatsServer();
+
+  StatsServer(const StatsServer&) = delete;
+  StatsServer& operator=(const StatsServer&) = delete;
+
+  uint16_t port() const { return port_; }
+};
+
+}  // namespace galois
+
+#endif
@@ -59,6 +59,7 @@ public:
 };
 
 //! Galois Timer that automatically reports stats upon destruction
+//! and the time of each start/stop in a histogram (\see StatManager::AddTiming)
 //! Provides statistic interface around timer
 class GALOIS_EXPORT StatTimer : public TimeAccumulator {
   gstl::Str name_;
@@ -20,6 +20,10 @@
 #ifndef GALOIS_LIBGALOIS_GALOIS_TRAITS_H_
 #define GALOIS_LIBGALOIS_GALOIS_TRAITS_H_
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <tuple>
 #include <type_traits>
 
@@ -275,6 +279,16 @@ struct disable_conflict_detection_tag {};
 struct disable_conflict_detection : public trait_has_type<bool>,
                                     disable_conflict_detection_tag {};
 
+/**
+ * Indicates that objects the operator acquires with MethodFlag::READ should
+ * not be locked but validated with their versions before the operator first
+ * writes or, if it does not, before it commits (\see
+ * runtime::SimpleRuntimeContext). This saves the lock of each read when
+ * iterations mostly read their neighborhoods.
+ */
+struct optimistic_reads_tag {};
+struct optimistic_reads : public trait_has_type<bool>, optimistic_reads_tag {};
+
 /**
  * Indicates that the neighborhood set does not change through out i.e. is not
  * dependent on computed values. Examples of such fixed neighborhood is e.g.
@@ -383,6 +397,105 @@ public:
   chunk_size(unsigned cs = SZ) : trait_has_value(clamp(cs)) {}
 };
 
+/**
+ * How a {@link do_all()} loop divides its iterations among threads. Optional
+ * argument to {@link do_all()} loops; it takes precedence over steal and
+ * chunk_size.
+ *
+ * Each thread starts with its own part of the range. Every policy but Static
+ * shares the work stealing of steal(): a thread takes iterations from its
+ * part some at a time, and when its part is empty it steals half of what is
+ * left of the part of another thread.
+ */
+struct schedule_tag {};
+struct schedule : public schedule_tag {
+  enum Policy { kStatic, kDynamic, kGuided, kWeighted };
+
+  Policy policy;
+  //! Fewest iterations a thread takes from its part at once
+  unsigned grain;
+  //! Weights of kWeighted
+  const uint64_t* prefix_sum;
+
+  /// Each thread runs the iterations of its part, without stealing
+  static schedule Static() { return {kStatic, 1, nullptr}; }
+
+  /// Threads take grain iterations at a time
+  static schedule Dynamic(unsigned grain = chunk_size<>::value) {
+    return {kDynamic, grain, nullptr};
+  }
+
+  /// Threads take a 1 / p share of what is left of their part, for p
+  /// threads, and no fewer than grain iterations: chunks start large and
+  /// shrink as a part runs out, so there are few of them but the last ones
+  /// are small enough to balance the load
+  static schedule Guided(unsigned grain = 1) {
+    return {kGuided, grain, nullptr};
+  }
+
+  /// Like Dynamic, but the parts have about the same weight rather than the
+  /// same number of iterations. prefix_sum[i] is the total weight of the
+  /// first i + 1 iterations of the range, e.g., the out_indices of a graph
+  /// topology to balance edges over iterate(graph); each iteration also
+  /// weighs one. The range must be random access.
+  static schedule Weighted(
+      const uint64_t* prefix_sum, unsigned grain = chunk_size<>::value) {
+    return {kWeighted, grain, prefix_sum};
+  }
+
+private:
+  schedule(Policy p, unsigned g, const uint64_t* ps)
+      : policy(p), grain(std::max(g, 1U)), prefix_sum(ps) {}
+};
+
+/**
+ * A flag that ends the loops given it with {@link cancel_token} once set,
+ * e.g., by another thread when the result is no longer needed.
+ */
+class CancellationToken {
+  std::atomic<bool> cancelled_{false};
+
+public:
+  void Cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+  //! Lets the token end another loop after it was cancelled
+  void Reset() { cancelled_.store(false, std::memory_order_relaxed); }
+  bool cancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+};
+
+/**
+ * Ends a {@link do_all()} or {@link for_each()} loop early once the token is
+ * cancelled. Threads check the token between chunks of iterations and then
+ * stop taking work: the iterations they already started finish, the rest of
+ * the range is skipped, and for_each drops the work left on its worklist.
+ * Whether a loop ended early is for the caller to tell from the token.
+ */
+struct cancel_token_tag {};
+struct cancel_token : public trait_has_value<const CancellationToken*>,
+                      cancel_token_tag {
+  cancel_token(const CancellationToken& t)
+      : trait_has_value<const CancellationToken*>(&t) {}
+};
+
+/**
+ * Like {@link cancel_token}, but ends the loop once the steady clock reaches
+ * a time point; a duration is counted from when the option is made, e.g.,
+ * galois::deadline(std::chrono::milliseconds(50)).
+ */
+struct deadline_tag {};
+struct deadline
+    : public trait_has_value<std::chrono::steady_clock::time_point>,
+      deadline_tag {
+  using time_point = std::chrono::steady_clock::time_point;
+
+  deadline(time_point t) : trait_has_value<time_point>(t) {}
+  template <typename Rep, typename Period>
+  deadline(std::chrono::duration<Rep, Period> d)
+      : trait_has_value<time_point>(
+            std::chrono::steady_clock::now() +
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                d)) {}
+};
+
 typedef worklists::PerSocketChunkFIFO<chunk_size<>::value> defaultWL;
 
 namespace internal {
@@ -404,6 +517,53 @@ std::enable_if_t<!has_trait<loopname_tag, Tup>(), const char*>
 getLoopName(const Tup&) {
   return "ANON_LOOP";
 }
+
+/**
+ * Checks the cancel_token and deadline of the options Tup of a loop, if any;
+ * once either holds, it stays stopped so that the threads read the clock
+ * only until the first of them sees the deadline pass.
+ */
+template <typename Tup>
+class LoopStop {
+public:
+  static constexpr bool enabled =
+      has_trait<cancel_token_tag, Tup>() || has_trait<deadline_tag, Tup>();
+
+private:
+  using clock = std::chrono::steady_clock;
+
+  const CancellationToken* token_{nullptr};
+  clock::time_point deadline_{clock::time_point::max()};
+  mutable std::atomic<bool> stopped_{false};
+
+public:
+  explicit LoopStop(const Tup& t) {
+    if constexpr (has_trait<cancel_token_tag, Tup>()) {
+      token_ = get_trait_value<cancel_token_tag>(t).value;
+    }
+    if constexpr (has_trait<deadline_tag, Tup>()) {
+      deadline_ = get_trait_value<deadline_tag>(t).value;
+    }
+  }
+
+  //! Whether the loop should stop taking work
+  bool operator()() const {
+    if constexpr (!enabled) {
+      return false;
+    } else {
+      if (stopped_.load(std::memory_order_relaxed)) {
+        return true;
+      }
+      if ((token_ && token_->cancelled()) ||
+          (deadline_ != clock::time_point::max() &&
+           clock::now() >= deadline_)) {
+        stopped_.store(true, std::memory_order_relaxed);
+        return true;
+      }
+      return false;
+    }
+  }
+};
 }  // namespace internal
 
 }  // namespace galois
@@ -0,0 +1,347 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_LIBGALOIS_GALOIS_VECTORREDUCTION_H_
+#define GALOIS_LIBGALOIS_GALOIS_VECTORREDUCTION_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "galois/config.h"
+#include "galois/gstl.h"
+#include "galois/runtime/Executor_OnEach.h"
+#include "galois/substrate/PerThreadStorage.h"
+
+namespace galois {
+
+/**
+ * Accumulates a vector of values of type T, e.g., the counts of the buckets
+ * of a histogram, where accumulation is plus.
+ *
+ * Each thread adds to its own array, which it allocates from its own heap on
+ * its first update, so concurrent updates neither contend nor share cache
+ * lines, unlike atomic adds to one array. That costs one array per thread:
+ * for vectors as large as the graph, atomics on a shared array are usually
+ * the better choice.
+ */
+template <typename T>
+class GVectorAccumulator {
+  galois::substrate::PerThreadStorage<gstl::Vector<T>> data_;
+  size_t size_;
+
+  gstl::Vector<T>& local() {
+    gstl::Vector<T>& v = *data_.getLocal();
+    if (v.size() != size_) {
+      v.resize(size_);
+    }
+    return v;
+  }
+
+  //! Calls fn(x) on every thread x of data_, which may be more than are
+  //! active, in parallel
+  template <typename FnTy>
+  void on_each_slot(const FnTy& fn) const {
+    const unsigned size = data_.size();
+    galois::runtime::on_each_gen(
+        [&](const unsigned int tid, const unsigned int nthreads) {
+          for (unsigned x = tid; x < size; x += nthreads) {
+            fn(x);
+          }
+        },
+        std::make_tuple(galois::no_stats()));
+  }
+
+public:
+  using value_type = T;
+
+  explicit GVectorAccumulator(size_t size = 0) : size_(size) {}
+
+  size_t size() const { return size_; }
+
+  /**
+   * Changes the number of values and resets them to 0. Only valid outside
+   * the parallel region.
+   */
+  void resize(size_t size) {
+    size_ = size;
+    reset();
+  }
+
+  //! Adds value to the thread local value at index
+  void update(size_t index, const T& value) {
+    assert(index < size_);
+    local()[index] += value;
+  }
+
+  /**
+   * Returns the thread local values, e.g., to update several of them in a
+   * tight loop.
+   */
+  gstl::Vector<T>& getLocal() { return local(); }
+
+  /**
+   * Returns the sums of the per thread values. The merge is parallel over
+   * ranges of indices. The values are kept, so reduce may be called again.
+   * Only valid outside the parallel region.
+   */
+  std::vector<T> reduce() const {
+    std::vector<T> result(size_);
+    reduce_into(result.data());
+    return result;
+  }
+
+  /**
+   * Like reduce, but writes the sums to out, which must have room for size()
+   * values, e.g., the memory of a numpy array
+   */
+  void reduce_into(T* out) const {
+    const unsigned num_slots = data_.size();
+    galois::runtime::on_each_gen(
+        [&](const unsigned int tid, const unsigned int nthreads) {
+          auto [begin, end] =
+              galois::block_range(size_t{0}, size_, tid, nthreads);
+          std::fill(out + begin, out + end, T{0});
+          for (unsigned x = 0; x < num_slots; ++x) {
+            const gstl::Vector<T>& v = *data_.getRemote(x);
+            // threads that never updated have no values
+            if (v.size() != size_) {
+              continue;
+            }
+            for (size_t i = begin; i < end; ++i) {
+              out[i] += v[i];
+            }
+          }
+        },
+        std::make_tuple(galois::no_stats()));
+  }
+
+  /**
+   * Resets the values to 0, keeping the memory of each thread. Only valid
+   * outside the parallel region.
+   */
+  void reset() {
+    on_each_slot([this](unsigned x) {
+      gstl::Vector<T>& v = *data_.getRemote(x);
+      if (v.size() == size_) {
+        std::fill(v.begin(), v.end(), T{0});
+      } else {
+        v.clear();
+      }
+    });
+  }
+};
+
+/**
+ * Counts of the buckets [0, size) of a histogram
+ *
+ *   GHistogram<> degrees(max_degree + 1);
+ *   do_all(iterate(graph), [&](auto n) { degrees.update(degree(n), 1); });
+ *   std::vector<uint64_t> counts = degrees.reduce();
+ */
+template <typename T = uint64_t>
+using GHistogram = GVectorAccumulator<T>;
+
+/**
+ * Keeps the k greatest values of type T, as ordered by Compare, out of those
+ * passed to update. Each thread keeps its own k greatest in a heap, and
+ * reduce merges them.
+ */
+template <typename T, typename Compare = std::less<T>>
+class GTopK : public Compare {
+  using Heap = gstl::Vector<T>;
+  galois::substrate::PerThreadStorage<Heap> data_;
+  size_t k_;
+
+  // A heap ordered by greater keeps the least of the k greatest at the front
+  bool greater(const T& a, const T& b) const {
+    return Compare::operator()(b, a);
+  }
+
+public:
+  using value_type = T;
+
+  explicit GTopK(size_t k, Compare comp = Compare()) : Compare(comp), k_(k) {}
+
+  size_t k() const { return k_; }
+
+  //! Offers value to the thread local top k
+  void update(const T& value) {
+    Heap& heap = *data_.getLocal();
+    auto cmp = [this](const T& a, const T& b) { return greater(a, b); };
+    if (heap.size() < k_) {
+      heap.push_back(value);
+      std::push_heap(heap.begin(), heap.end(), cmp);
+    } else if (k_ > 0 && greater(value, heap.front())) {
+      std::pop_heap(heap.begin(), heap.end(), cmp);
+      heap.back() = value;
+      std::push_heap(heap.begin(), heap.end(), cmp);
+    }
+  }
+
+  /**
+   * Returns the k greatest values, or all of them if there were fewer, from
+   * greatest to least. Only valid outside the parallel region.
+   */
+  std::vector<T> reduce() const {
+    std::vector<T> result;
+    for (unsigned x = 0; x < data_.size(); ++x) {
+      const Heap& heap = *data_.getRemote(x);
+      result.insert(result.end(), heap.begin(), heap.end());
+    }
+    auto cmp = [this](const T& a, const T& b) { return greater(a, b); };
+    size_t n = std::min(k_, result.size());
+    std::partial_sort(result.begin(), result.begin() + n, result.end(), cmp);
+    result.resize(n);
+    return result;
+  }
+
+  //! Only valid outside the parallel region
+  void reset() {
+    for (unsigned x = 0; x < data_.size(); ++x) {
+      data_.getRemote(x)->clear();
+    }
+  }
+};
+
+/**
+ * Counts of the values passed to update, for histograms whose buckets are too
+ * many or too sparse for GHistogram, e.g., the degrees of a graph. Each
+ * thread counts in its own hash map, so memory grows with the number of
+ * distinct values rather than with the largest one.
+ */
+template <typename T = uint64_t>
+class GSparseHistogram {
+  using Counts = std::unordered_map<T, uint64_t>;
+  galois::substrate::PerThreadStorage<Counts> data_;
+
+public:
+  using value_type = T;
+
+  //! Adds count to the thread local count of value
+  void update(const T& value, uint64_t count = 1) {
+    (*data_.getLocal())[value] += count;
+  }
+
+  /**
+   * Returns the counts of the values that were seen, ordered by value. Only
+   * valid outside the parallel region.
+   */
+  std::map<T, uint64_t> reduce() const {
+    std::map<T, uint64_t> result;
+    for (unsigned x = 0; x < data_.size(); ++x) {
+      for (const auto& [value, count] : *data_.getRemote(x)) {
+        result[value] += count;
+      }
+    }
+    return result;
+  }
+
+  //! Only valid outside the parallel region
+  void reset() {
+    for (unsigned x = 0; x < data_.size(); ++x) {
+      data_.getRemote(x)->clear();
+    }
+  }
+};
+
+/**
+ * Estimates the number of distinct values passed to update with a
+ * HyperLogLog sketch. Each thread keeps 2^precision one-byte registers and
+ * reduce merges them, so memory is fixed however many values there are. The
+ * relative error is about 1.04 / sqrt(2^precision): 0.8% for the default.
+ */
+class GApproxDistinct {
+  galois::substrate::PerThreadStorage<gstl::Vector<uint8_t>> data_;
+  uint32_t precision_;
+
+  //! The finalizer of splitmix64, so that consecutive ids spread out
+  static uint64_t hash(uint64_t x) {
+    x ^= x >> 30;
+    x *= UINT64_C(0xbf58476d1ce4e5b9);
+    x ^= x >> 27;
+    x *= UINT64_C(0x94d049bb133111eb);
+    return x ^ (x >> 31);
+  }
+
+  size_t num_registers() const { return size_t{1} << precision_; }
+
+public:
+  explicit GApproxDistinct(uint32_t precision = 14)
+      : precision_(std::min<uint32_t>(std::max<uint32_t>(precision, 4), 18)) {}
+
+  //! Adds value to the thread local sketch
+  void update(uint64_t value) {
+    gstl::Vector<uint8_t>& registers = *data_.getLocal();
+    if (registers.size() != num_registers()) {
+      registers.resize(num_registers());
+    }
+    uint64_t h = hash(value);
+    size_t index = h >> (64 - precision_);
+    uint64_t rest = h << precision_;
+    uint8_t rank = rest == 0 ? 64 - precision_ + 1 : __builtin_clzll(rest) + 1;
+    if (registers[index] < rank) {
+      registers[index] = rank;
+    }
+  }
+
+  //! The estimate of the number of distinct values. Only valid outside the
+  //! parallel region.
+  double reduce() const {
+    std::vector<uint8_t> merged(num_registers());
+    for (unsigned x = 0; x < data_.size(); ++x) {
+      const gstl::Vector<uint8_t>& registers = *data_.getRemote(x);
+      // threads that never updated have no registers
+      if (registers.size() != merged.size()) {
+        continue;
+      }
+      for (size_t i = 0; i < merged.size(); ++i) {
+        merged[i] = std::max(merged[i], registers[i]);
+      }
+    }
+
+    double m = merged.size();
+    double sum = 0;
+    size_t zeros = 0;
+    for (uint8_t r : merged) {
+      sum += std::ldexp(1.0, -r);
+      zeros += r == 0 ? 1 : 0;
+    }
+    double estimate = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+    // linear counting is more accurate while many registers are unset
+    if (estimate <= 2.5 * m && zeros > 0) {
+      estimate = m * std::log(m / zeros);
+    }
+    return estimate;
+  }
+
+  //! Only valid outside the parallel region
+  void reset() {
+    for (unsigned x = 0; x < data_.size(); ++x) {
+      data_.getRemote(x)->clear();
+    }
+  }
+};
+
+}  // namespace galois
+#endif
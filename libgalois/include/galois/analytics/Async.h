@@ -0,0 +1,135 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_ANALYTICS_ASYNC_H_
+#define GALOIS_LIBGALOIS_GALOIS_ANALYTICS_ASYNC_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "galois/ErrorCode.h"
+#include "galois/Result.h"
+#include "galois/config.h"
+
+namespace galois::analytics {
+
+/// The state that an asynchronous analytics call shares with its
+/// AsyncResult: whether the caller asked it to stop and how far it got.
+/// Algorithms report and poll it between rounds with internal::EndRound, so
+/// a call stops at the end of its current round, and algorithms without
+/// rounds (e.g., the asynchronous BFS and SSSP plans) only stop at the end.
+class AsyncControl {
+  std::atomic<bool> cancelled_{false};
+  std::atomic<bool> stopped_{false};
+  std::atomic<uint64_t> rounds_{0};
+  std::atomic<uint64_t> work_items_{0};
+
+public:
+  /// Asks the call to stop at its next round boundary
+  void Cancel() { cancelled_ = true; }
+  bool cancelled() const { return cancelled_; }
+
+  /// Whether the call stopped early because it was cancelled
+  bool stopped() const { return stopped_; }
+
+  /// Rounds (e.g., BFS levels) finished so far
+  uint64_t rounds() const { return rounds_.load(std::memory_order_relaxed); }
+  /// Work items (e.g., frontier nodes) of the rounds finished so far
+  uint64_t work_items() const {
+    return work_items_.load(std::memory_order_relaxed);
+  }
+
+  /// Records a finished round with work_items items; returns whether the
+  /// call should stop
+  bool EndRound(uint64_t work_items) {
+    work_items_.fetch_add(work_items, std::memory_order_relaxed);
+    rounds_.fetch_add(1, std::memory_order_relaxed);
+    if (cancelled_) {
+      stopped_ = true;
+    }
+    return stopped_;
+  }
+};
+
+/// A handle to an asynchronous analytics call (\see RunAsync). Destroying it
+/// waits for the call to finish.
+template <typename T>
+class AsyncResult {
+  std::shared_ptr<AsyncControl> control_;
+  std::future<Result<T>> future_;
+
+public:
+  AsyncResult(
+      std::shared_ptr<AsyncControl> control, std::future<Result<T>> future)
+      : control_(std::move(control)), future_(std::move(future)) {}
+
+  /// Whether the call has finished, so that Wait will not block
+  bool Ready() const {
+    if (!future_.valid()) {
+      return true;
+    }
+    return future_.wait_for(std::chrono::seconds(0)) ==
+           std::future_status::ready;
+  }
+
+  /// Blocks until the call finishes and returns its result, which is
+  /// ErrorCode::Cancelled if it stopped early. May only be called once.
+  Result<T> Wait() { return future_.get(); }
+
+  /// Asks the call to stop at its next round boundary; the output of a
+  /// cancelled call is incomplete
+  void Cancel() { control_->Cancel(); }
+
+  /// Progress of the call (\see AsyncControl)
+  uint64_t rounds() const { return control_->rounds(); }
+  uint64_t work_items() const { return control_->work_items(); }
+};
+
+namespace internal {
+
+/// Runs an asynchronous call on the calling thread: serializes it with the
+/// other asynchronous calls, makes the thread stand in for thread 0 of the
+/// pool and makes control the control of EndRound on this thread
+class GALOIS_EXPORT AsyncScope {
+  std::unique_lock<std::mutex> lock_;
+
+public:
+  explicit AsyncScope(AsyncControl* control);
+  ~AsyncScope();
+
+  AsyncScope(const AsyncScope&) = delete;
+  AsyncScope& operator=(const AsyncScope&) = delete;
+};
+
+/// Called by algorithms after each round with the number of work items of
+/// the round. Returns true if the algorithm runs in an asynchronous call that
+/// was cancelled and should stop; always false outside of one.
+GALOIS_EXPORT bool EndRound(uint64_t work_items);
+
+}  // namespace internal
+
+/// Runs fn(), which returns Result<T>, on a new thread and returns at once.
+/// The thread runs its loops on the thread pool as thread 0, so the caller
+/// must not run parallel loops itself until the call finishes. Asynchronous
+/// calls run one at a time. Anything fn uses must outlive the call.
+template <typename T, typename Fn>
+AsyncResult<T>
+RunAsync(Fn fn) {
+  auto control = std::make_shared<AsyncControl>();
+  auto future = std::async(
+      std::launch::async, [control, fn = std::move(fn)]() -> Result<T> {
+        internal::AsyncScope scope(control.get());
+        Result<T> result = fn();
+        if (result && control->stopped()) {
+          return ErrorCode::Cancelled;
+        }
+        return result;
+      });
+  return AsyncResult<T>(std::move(control), std::move(future));
+}
+
+}  // namespace galois::analytics
+
+#endif
@@ -24,6 +24,8 @@
 #include <cstdlib>
 #include <iostream>
 
+#include "galois/DynamicBitset.h"
+#include "galois/EdgeTiles.h"
 #include "galois/analytics/Utils.h"
 
 namespace galois::analytics {
@@ -93,20 +95,11 @@ struct BfsSsspImplementationBase {
 
   template <typename WL, typename TileMaker>
   void PushEdgeTiles(WL& wl, EI beg, const EI end, const TileMaker& f) {
-    assert(beg <= end);
-
-    if ((end - beg) > edge_tile_size) {
-      for (; beg + edge_tile_size < end;) {
-        auto ne = beg + edge_tile_size;
-        assert(ne < end);
-        wl.push(f(beg, ne));
-        beg = ne;
-      }
-    }
-
-    if ((end - beg) > 0) {
-      wl.push(f(beg, end));
-    }
+    galois::ForEachEdgeTile(
+        beg, end, edge_tile_size,
+        [&](const EI& tile_beg, const EI& tile_end) {
+          wl.push(f(tile_beg, tile_end));
+        });
   }
 
   template <typename WL, typename TileMaker>
@@ -185,6 +178,98 @@ struct BfsSsspImplementationBase {
     }
   };
 
+  /// The set of nodes to visit in a round of a level-synchronous algorithm.
+  ///
+  /// Nodes are stored in a bag (sparse) or only in a bitset over all nodes
+  /// (dense). The representation is chosen when the frontier is reset, before
+  /// it is filled: following Ligra, a frontier reached from one whose nodes
+  /// and out-edges are a large fraction of the graph is likely to be large
+  /// itself, and dense frontiers avoid the bag push and iteration overhead
+  /// that dominates the middle rounds on power-law graphs. A node pushed more
+  /// than once in a round is stored once.
+  class Frontier {
+    Graph* graph_;
+    galois::InsertBag<GNode> bag_;
+    galois::DynamicBitset members_;
+    bool dense_{false};
+    galois::GAccumulator<uint64_t> size_acc_;
+    galois::GAccumulator<uint64_t> edges_acc_;
+    uint64_t size_{0};
+    uint64_t num_edges_{0};
+
+  public:
+    explicit Frontier(Graph* graph) : graph_(graph) {
+      members_.resize(graph->size());
+    }
+
+    bool dense() const { return dense_; }
+    /// Number of nodes, valid after Finish
+    uint64_t size() const { return size_; }
+    /// Number of out-edges of the nodes, valid after Finish
+    uint64_t num_edges() const { return num_edges_; }
+    bool empty() const { return size_ == 0; }
+
+    /// Whether the frontier reached from this one should be dense
+    bool NextIsDense(uint32_t dense_frontier_divisor) const {
+      return dense_frontier_divisor != 0 &&
+             size_ + num_edges_ > graph_->num_edges() / dense_frontier_divisor;
+    }
+
+    /// Empty the frontier and choose how the nodes pushed next are stored
+    void Reset(bool dense) {
+      if (dense_) {
+        members_.reset();
+      } else {
+        galois::do_all(
+            galois::iterate(bag_),
+            [&](const GNode& n) { members_.reset(n); }, galois::no_stats());
+        bag_.clear_keep_blocks();
+      }
+      dense_ = dense;
+      size_acc_.reset();
+      edges_acc_.reset();
+      size_ = 0;
+      num_edges_ = 0;
+    }
+
+    /// Add n to the frontier; safe to call concurrently
+    void Push(const GNode& n) {
+      if (members_.set(n)) {
+        return;
+      }
+      if (!dense_) {
+        bag_.push(n);
+      }
+      size_acc_ += 1;
+      edges_acc_ += graph_->edge_end(n) - graph_->edge_begin(n);
+    }
+
+    /// Finish a round of pushes
+    void Finish() {
+      size_ = size_acc_.reduce();
+      num_edges_ = edges_acc_.reduce();
+    }
+
+    /// Call fn(n) in parallel for each node n in the frontier
+    template <typename Fn>
+    void ForEach(const Fn& fn, const char* loopname) {
+      if (dense_) {
+        galois::do_all(
+            galois::iterate(graph_->begin(), graph_->end()),
+            [&](const GNode& n) {
+              if (members_.test(n)) {
+                fn(n);
+              }
+            },
+            galois::steal(), galois::loopname(loopname));
+      } else {
+        galois::do_all(
+            galois::iterate(bag_), fn, galois::steal(),
+            galois::loopname(loopname));
+      }
+    }
+  };
+
   template <typename NodeProp, typename EdgeProp>
   struct NotConsistent {
     Graph* g;
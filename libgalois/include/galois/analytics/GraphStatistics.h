@@ -0,0 +1,100 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_ANALYTICS_GRAPHSTATISTICS_H_
+#define GALOIS_LIBGALOIS_GALOIS_ANALYTICS_GRAPHSTATISTICS_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+#include "galois/Result.h"
+#include "galois/config.h"
+#include "galois/graphs/PropertyFileGraph.h"
+
+namespace galois::analytics {
+
+/// Cheap statistics of a graph from which the Automatic plans of the
+/// analytics choose an algorithm and its parameters. The skew, diameter and
+/// weights are estimated from deterministic samples, so a graph gets the same
+/// statistics regardless of the number of threads.
+struct GraphStatistics {
+  /// Out-degrees are sampled from at most this many evenly spaced nodes
+  static constexpr uint32_t kDegreeSamples = 1024;
+  /// Edge weights are sampled from at most this many evenly spaced edges
+  static constexpr uint64_t kWeightSamples = 1U << 16;
+  /// The number of BFS sweeps of the diameter estimate
+  static constexpr uint32_t kDiameterProbes = 2;
+
+  uint64_t num_nodes{0};
+  uint64_t num_edges{0};
+  double mean_degree{0};
+  uint64_t max_degree{0};
+  /// The mean of the sampled out-degrees over their median (at least 1); a
+  /// long tail of high-degree nodes makes it large
+  double degree_skew{1};
+  /// A lower bound of the diameter of the graph: the longest of the
+  /// distances, along out-edges, found by repeatedly sweeping a BFS from the
+  /// farthest node of the previous sweep
+  uint32_t estimated_diameter{0};
+
+  /// The edge property the weights were sampled from; empty if none were
+  std::string weight_property;
+  /// The mean, least and greatest magnitude of the sampled weights
+  double mean_weight{0};
+  double min_weight{0};
+  double max_weight{0};
+
+  /// Whether the degrees look like a power law: the test of the GAP
+  /// benchmark suite (\see isApproximateDegreeDistributionPowerLaw)
+  bool power_law() const { return mean_degree >= 10 && degree_skew > 1.3; }
+
+  /// Whether the BFS levels of the graph are many more than those of a
+  /// random graph of the same size, as in road networks and meshes, so that
+  /// round-based algorithms pay for many barriers
+  bool high_diameter() const {
+    return estimated_diameter >
+           8 * std::max(1.0, std::log2(static_cast<double>(num_nodes)));
+  }
+
+  /// An edge tile size for the edge-tiled algorithms: default_size, or the
+  /// least power of two no smaller than the mean degree if that is larger,
+  /// up to 4096, so that tiles do not split the edges of a typical node
+  int64_t EdgeTileSize(int64_t default_size) const {
+    int64_t size = default_size;
+    while (size < mean_degree && size < 4096) {
+      size *= 2;
+    }
+    return size;
+  }
+};
+
+/// ComputeGraphStatistics samples the statistics of pfg, and of the weights
+/// of its numeric edge property called weight_property unless it is empty,
+/// in parallel. The diameter estimate costs kDiameterProbes traversals of the
+/// graph; the rest is sampled in time independent of its size.
+///
+/// \returns PropertyNotFound if pfg has no edge property weight_property,
+/// TypeError if it is not numeric and InvalidArgument for graphs with 64-bit
+/// node ids
+GALOIS_EXPORT Result<GraphStatistics> ComputeGraphStatistics(
+    const graphs::PropertyFileGraph& pfg,
+    const std::string& weight_property = "");
+
+/// GetGraphStatistics returns the statistics cached with pfg (\see
+/// PropertyFileGraph::graph_statistics) if they are for its current size and
+/// for weight_property, and otherwise computes them and caches them. Write
+/// stores the cache in the RDG, so graphs loaded later reuse it.
+GALOIS_EXPORT Result<GraphStatistics> GetGraphStatistics(
+    const graphs::PropertyFileGraph& pfg,
+    const std::string& weight_property = "");
+
+/// The statistics as JSON, the format of PropertyFileGraph::graph_statistics
+GALOIS_EXPORT Result<std::string> DumpGraphStatistics(
+    const GraphStatistics& stats);
+
+/// Parse the output of DumpGraphStatistics
+GALOIS_EXPORT Result<GraphStatistics> ParseGraphStatistics(
+    const std::string& text);
+
+}  // namespace galois::analytics
+
+#endif
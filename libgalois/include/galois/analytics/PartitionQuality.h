@@ -0,0 +1,70 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_ANALYTICS_PARTITIONQUALITY_H_
+#define GALOIS_LIBGALOIS_GALOIS_ANALYTICS_PARTITIONQUALITY_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "galois/Result.h"
+#include "galois/config.h"
+#include "galois/graphs/PropertyFileGraph.h"
+
+namespace galois::analytics {
+
+/// The quality of a partition of the nodes of a graph into parts, e.g., the
+/// communities of a clustering or the blocks of a graph partitioner. Edges
+/// weigh their weight, or 1 each without weights. The volume of a part is the
+/// weight of the out-edges of its nodes and its cut the weight of those that
+/// lead to another part. Parts are indexed by their ids, up to the largest
+/// one, so some of them may be empty.
+struct PartitionQuality {
+  std::vector<uint64_t> part_sizes;
+  std::vector<double> part_volumes;
+  std::vector<double> part_cuts;
+  /// The cut of each part over the smaller of its volume and the volume of
+  /// the rest of the graph, or 0 if that is 0
+  std::vector<double> part_conductances;
+
+  /// The weight of the edges between parts
+  double edge_cut{0};
+  /// The number of parts other than its own among the out-neighbors of a
+  /// node, summed over the nodes: the values a distributed computation over
+  /// the partition sends per round (the communication volume of METIS)
+  uint64_t communication_volume{0};
+  /// Newman's modularity: over the parts, the fraction of the total weight
+  /// inside the part minus the square of the fraction that is its volume.
+  /// The usual definition for symmetric graphs, whose undirected edges are
+  /// stored in both directions.
+  double modularity{0};
+  /// The greatest of part_conductances
+  double max_conductance{0};
+  /// The size of the largest part over the mean size of a part; 1 is a
+  /// perfectly balanced partition, and an empty graph has balance 0
+  double balance{0};
+};
+
+/// Beyond this many parts, ComputePartitionQuality sums parts atomically
+constexpr uint64_t kMaxHistogramParts = uint64_t{1} << 16;
+
+/// ComputePartitionQuality measures the partition of pfg given by its
+/// integer node property part_property, the part of each node, with edge
+/// weights from its numeric edge property weight_property, or 1 if that is
+/// empty; null weights weigh 0.
+///
+/// Every metric comes from one parallel pass over the edges. Each thread sums
+/// the parts in its own histograms, so updates do not contend, unless there
+/// are more than kMaxHistogramParts parts, where per-thread histograms would
+/// take more memory than the graph and threads add atomically to shared sums
+/// instead.
+///
+/// \returns PropertyNotFound if a property does not exist, TypeError if it is
+/// not of an integer (parts) or numeric (weights) type, and InvalidArgument
+/// if a part is null, negative, or not less than both the number of nodes and
+/// kMaxHistogramParts
+GALOIS_EXPORT Result<PartitionQuality> ComputePartitionQuality(
+    const graphs::PropertyFileGraph& pfg, const std::string& part_property,
+    const std::string& weight_property = "");
+
+}  // namespace galois::analytics
+
+#endif
@@ -1,8 +1,12 @@
 #ifndef GALOIS_LIBGALOIS_GALOIS_ANALYTICS_PLAN_H_
 #define GALOIS_LIBGALOIS_GALOIS_ANALYTICS_PLAN_H_
 
+#include <cstdint>
+
 namespace galois::analytics {
 
+/// The hardware a Plan runs on. Only kCPU has a backend so far; the
+/// analytics fail with NotImplemented for plans of the others.
 enum Architecture {
   /// Local execution using CPUs only
   kCPU,
@@ -22,6 +26,12 @@ public:
   Architecture architecture() const { return architecture_; }
 };
 
+/// Level-synchronous algorithms store the next frontier as a bitset over all
+/// nodes instead of a bag of nodes when the current frontier and its out-edges
+/// exceed 1/dense_frontier_divisor of the edges of the graph (the threshold
+/// used by Ligra). A divisor of 0 keeps frontiers sparse.
+constexpr uint32_t kDefaultDenseFrontierDivisor = 20;
+
 }  // namespace galois::analytics
 
 #endif  //GALOIS_PLAN_H_
@@ -0,0 +1,83 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_ANALYTICS_TRAVERSALFILTER_H_
+#define GALOIS_LIBGALOIS_GALOIS_ANALYTICS_TRAVERSALFILTER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "galois/Result.h"
+#include "galois/config.h"
+#include "galois/graphs/EdgeTypeIndex.h"
+#include "galois/graphs/PropertyFileGraph.h"
+
+namespace galois::analytics {
+
+/// A TraversalFilter restricts a traversal to the edges of some types between
+/// the nodes of some labels, e.g., to ":FOLLOWS" edges between ":Person"
+/// nodes. Edge types and node labels are boolean edge and node properties, as
+/// recorded by PropertyGraphBuilder. Plans of BFS, SSSP and connected
+/// components accept a filter (\see BfsPlan::WithFilter).
+///
+/// Node labels are evaluated as a bitmap over the nodes, and edge types
+/// through an EdgeTypeIndex, so only the edges of the chosen types are
+/// visited to set up the traversal. Nodes without the labels keep their ids
+/// but have no edges in the traversal, not even from the source.
+struct TraversalFilter {
+  /// Follow only the edges with at least one of these types; all edges if
+  /// empty
+  std::vector<std::string> edge_types;
+  /// Visit only the nodes with at least one of these labels; all nodes if
+  /// empty
+  std::vector<std::string> node_labels;
+  /// An index of the graph for types that include edge_types; the one cached
+  /// by PropertyFileGraph::EdgeTypes is used if null
+  std::shared_ptr<const graphs::EdgeTypeIndex> edge_type_index;
+
+  bool empty() const { return edge_types.empty() && node_labels.empty(); }
+};
+
+namespace internal {
+
+/// FilterGraph returns a graph with the nodes of pfg and the edges of pfg
+/// that pass filter, in the same order, with copies of the named edge
+/// properties for them. It has no node properties.
+///
+/// \returns PropertyNotFound or TypeError if a type or label is not a
+/// boolean property of pfg and InvalidArgument if a type is not in
+/// filter.edge_type_index
+GALOIS_EXPORT Result<std::unique_ptr<graphs::PropertyFileGraph>> FilterGraph(
+    graphs::PropertyFileGraph* pfg, const TraversalFilter& filter,
+    const std::vector<std::string>& edge_properties);
+
+/// RunFiltered runs algorithm(filtered) on the FilterGraph of pfg and adds
+/// the node property named output_property_name that it computed to pfg
+template <typename F>
+Result<void>
+RunFiltered(
+    graphs::PropertyFileGraph* pfg, const TraversalFilter& filter,
+    const std::vector<std::string>& edge_properties,
+    const std::string& output_property_name, F algorithm) {
+  auto filtered_result = FilterGraph(pfg, filter, edge_properties);
+  if (!filtered_result) {
+    return filtered_result.error();
+  }
+  std::unique_ptr<graphs::PropertyFileGraph> filtered =
+      std::move(filtered_result.value());
+  if (auto res = algorithm(filtered.get()); !res) {
+    return res.error();
+  }
+
+  std::shared_ptr<arrow::ChunkedArray> output =
+      filtered->NodeProperty(output_property_name);
+  return pfg->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field(output_property_name, output->type())}),
+      {output}));
+}
+
+}  // namespace internal
+
+}  // namespace galois::analytics
+
+#endif
@@ -105,6 +105,18 @@ ConstructEdgeProperties(
   return pfg->AddEdgeProperties(res_table.value());
 }
 
+/// Adds node property Prop, a POD property, named name without initializing
+/// its values (\see PropertyFileGraph::AddUninitializedNodeProperty); for
+/// algorithms that write every value before reading any
+template <typename Prop>
+inline galois::Result<void>
+ConstructUninitializedNodeProperty(
+    galois::graphs::PropertyFileGraph* pfg, const std::string& name) {
+  using ArrowType = galois::PropertyArrowType<Prop>;
+  return pfg->AddUninitializedNodeProperty(
+      name, arrow::TypeTraits<ArrowType>::type_singleton());
+}
+
 }  // namespace galois::analytics
 
 #endif
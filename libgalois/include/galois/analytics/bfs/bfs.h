@@ -1,7 +1,10 @@
 #ifndef GALOIS_LIBGALOIS_GALOIS_ANALYTICS_BFS_BFS_H_
 #define GALOIS_LIBGALOIS_GALOIS_ANALYTICS_BFS_BFS_H_
 
+#include "galois/analytics/Async.h"
+#include "galois/analytics/GraphStatistics.h"
 #include "galois/analytics/Plan.h"
+#include "galois/analytics/TraversalFilter.h"
 #include "galois/analytics/Utils.h"
 
 namespace galois::analytics {
@@ -10,23 +13,56 @@ namespace galois::analytics {
 /// associated with it.
 class BfsPlan : Plan {
 public:
-  enum Algorithm { kAsyncTile = 0, kAsync, kSyncTile, kSync };
+  enum Algorithm {
+    kAsyncTile = 0,
+    kAsync,
+    kSyncTile,
+    kSync,
+    kSyncDirectionOpt
+  };
 
 private:
   Algorithm algorithm_;
   ptrdiff_t edge_tile_size_;
+  uint32_t alpha_;
+  uint32_t beta_;
+  uint32_t dense_frontier_divisor_;
+  TraversalFilter filter_;
 
   BfsPlan(
-      Architecture architecture, Algorithm algorithm, ptrdiff_t edge_tile_size)
+      Architecture architecture, Algorithm algorithm, ptrdiff_t edge_tile_size,
+      uint32_t alpha = 0, uint32_t beta = 0,
+      uint32_t dense_frontier_divisor = kDefaultDenseFrontierDivisor)
       : Plan(architecture),
         algorithm_(algorithm),
-        edge_tile_size_(edge_tile_size) {}
+        edge_tile_size_(edge_tile_size),
+        alpha_(alpha),
+        beta_(beta),
+        dense_frontier_divisor_(dense_frontier_divisor) {}
 
 public:
   BfsPlan() : BfsPlan{kCPU, kSyncTile, 256} {}
 
   Algorithm algorithm() const { return algorithm_; }
   ptrdiff_t edge_tile_size() const { return edge_tile_size_; }
+  /// Switch from pushing along out-edges to pulling along in-edges once the
+  /// frontier has more than 1/alpha of the unexplored edges
+  uint32_t alpha() const { return alpha_; }
+  /// Switch back to pushing once the frontier has fewer than 1/beta of the
+  /// nodes and is shrinking
+  uint32_t beta() const { return beta_; }
+  /// \see kDefaultDenseFrontierDivisor
+  uint32_t dense_frontier_divisor() const { return dense_frontier_divisor_; }
+
+  /// The edges and nodes the traversal is restricted to; none by default
+  const TraversalFilter& filter() const { return filter_; }
+
+  /// The same plan restricted to the edges and nodes that pass filter
+  BfsPlan WithFilter(TraversalFilter filter) const {
+    BfsPlan plan = *this;
+    plan.filter_ = std::move(filter);
+    return plan;
+  }
 
   static BfsPlan AsyncTile(ptrdiff_t edge_tile_size = 256) {
     return {kCPU, kAsyncTile, edge_tile_size};
@@ -38,10 +74,48 @@ public:
     return {kCPU, kSyncTile, edge_tile_size};
   }
 
-  static BfsPlan Sync() { return {kCPU, kSync, 0}; }
+  /// Level-synchronous BFS whose frontier switches between sparse and dense
+  /// representations (\see kDefaultDenseFrontierDivisor)
+  static BfsPlan Sync(
+      uint32_t dense_frontier_divisor = kDefaultDenseFrontierDivisor) {
+    return {kCPU, kSync, 0, 0, 0, dense_frontier_divisor};
+  }
+
+  /// Level-synchronous BFS that switches between top-down and bottom-up steps
+  /// (Beamer et al., SC '12). Bottom-up steps use the in-edge index of the
+  /// graph (\see PropertyFileGraph::InEdges), which is built on first use if
+  /// the graph does not store one.
+  static BfsPlan SyncDirectionOpt(uint32_t alpha = 15, uint32_t beta = 18) {
+    return {kCPU, kSyncDirectionOpt, 0, alpha, beta};
+  }
 
   static BfsPlan Automatic() { return {}; }
 
+  /// Choose an algorithm and tile size from the statistics of a graph:
+  /// AsyncTile on high-diameter graphs, where the barriers of thousands of
+  /// small levels dominate, SyncDirectionOpt on power-law graphs, whose few
+  /// large levels bottom-up steps mostly skip, and SyncTile otherwise
+  static BfsPlan Automatic(const GraphStatistics& stats) {
+    if (stats.high_diameter()) {
+      return AsyncTile(stats.EdgeTileSize(256));
+    }
+    if (stats.power_law()) {
+      return SyncDirectionOpt();
+    }
+    return SyncTile(stats.EdgeTileSize(256));
+  }
+
+  /// Automatic(GraphStatistics) with the statistics of pfg (\see
+  /// GetGraphStatistics)
+  static BfsPlan Automatic(const graphs::PropertyFileGraph* pfg) {
+    auto stats = GetGraphStatistics(*pfg);
+    if (!stats) {
+      GALOIS_LOG_WARN("no graph statistics: {}", stats.error());
+      return Automatic();
+    }
+    return Automatic(stats.value());
+  }
+
   static BfsPlan FromAlgorithm(Algorithm algo) {
     switch (algo) {
     case kAsync:
@@ -52,6 +126,8 @@ public:
       return Sync();
     case kSyncTile:
       return SyncTile();
+    case kSyncDirectionOpt:
+      return SyncDirectionOpt();
     default:
       return Automatic();
     }
@@ -59,7 +135,7 @@ public:
 };
 
 /// The tag for the output property of BFS in PropertyGraphs.
-using BfsNodeDistance = galois::PODProperty<uint32_t>;
+using BfsNodeDistance = galois::DensePODProperty<uint32_t>;
 // TODO: Should this be a struct to make it distinct from other types? Or should
 //  it be an alias like this so it's compatible with other properties of the
 //  same type?
@@ -74,6 +150,17 @@ GALOIS_EXPORT Result<void> Bfs(
     const std::string& output_property_name,
     BfsPlan algo = BfsPlan::Automatic());
 
+/// Start Bfs(pfg, start_node, output_property_name, algo) on its own thread
+/// and return a handle to it at once (\see RunAsync). The synchronous plans
+/// report each finished level, with the nodes it reached, and stop after the
+/// current level once cancelled, leaving the farther nodes unreached; the
+/// asynchronous plans only stop at the end. pfg must not be used until the
+/// call finishes.
+GALOIS_EXPORT AsyncResult<void> BfsAsync(
+    graphs::PropertyFileGraph* pfg, size_t start_node,
+    const std::string& output_property_name,
+    BfsPlan algo = BfsPlan::Automatic());
+
 /// Compute BFS level of nodes in the graph pfg starting from start_node. The
 /// result is stored in the node data of the graph. The plan controls the
 /// algorithm and parameters used to compute the BFS.
@@ -81,6 +168,32 @@ GALOIS_EXPORT Result<void> Bfs(
     graphs::PropertyGraph<std::tuple<BfsNodeDistance>, std::tuple<>>& graph,
     size_t start_node, BfsPlan algo = BfsPlan::Automatic());
 
+/// The number of sources that MultiSourceBfs and MultiSourceReachability
+/// explore together in one pass over the edges, one bit per source
+constexpr size_t kMultiSourceBfsBatchSize = 64;
+
+/// Compute BFS levels of nodes in the graph pfg from each of sources (MS-BFS,
+/// Then et al., VLDB '14). Batches of kMultiSourceBfsBatchSize sources share
+/// each traversal, so a batch costs little more than a single BFS. The levels
+/// from sources[i] are stored in a property named output_property_names[i],
+/// which is created by this function and may not exist before the call.
+GALOIS_EXPORT Result<void> MultiSourceBfs(
+    graphs::PropertyFileGraph* pfg, const std::vector<uint32_t>& sources,
+    const std::vector<std::string>& output_property_names);
+
+/// The tag for the output properties of MultiSourceReachability.
+using BfsReachability = galois::DensePODProperty<uint64_t>;
+
+/// Compute which nodes of the graph pfg are reachable from each of sources.
+/// Bit i of the value of a node in the property named output_property_names[b]
+/// is set if the node is reachable from
+/// sources[b * kMultiSourceBfsBatchSize + i], so there must be one name
+/// for every kMultiSourceBfsBatchSize sources. The properties are created by
+/// this function and may not exist before the call.
+GALOIS_EXPORT Result<void> MultiSourceReachability(
+    graphs::PropertyFileGraph* pfg, const std::vector<uint32_t>& sources,
+    const std::vector<std::string>& output_property_names);
+
 }  // namespace galois::analytics
 
 #endif
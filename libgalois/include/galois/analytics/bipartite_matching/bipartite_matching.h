@@ -0,0 +1,81 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_ANALYTICS_BIPARTITEMATCHING_BIPARTITEMATCHING_H_
+#define GALOIS_LIBGALOIS_GALOIS_ANALYTICS_BIPARTITEMATCHING_BIPARTITEMATCHING_H_
+
+#include "galois/analytics/Plan.h"
+#include "galois/analytics/Utils.h"
+
+namespace galois::analytics {
+
+/// A computational plan to for maximum bipartite matching, specifying the
+/// algorithm and any parameters associated with it.
+///
+/// Every edge goes from a left node, its source, to a right node, its
+/// destination. A matching is a set of edges no two of which share a left or
+/// a right node, and an augmenting path alternates between unmatched and
+/// matched edges from an unmatched left node to an unmatched right node; a
+/// matching is maximum when there is no augmenting path. Both algorithms
+/// start from a greedy matching and keep the matching state in dense arrays
+/// indexed by node: the matched edge of each left node and the matched left
+/// node of each right node.
+class BipartiteMatchingPlan : Plan {
+public:
+  enum Algorithm { kHopcroftKarp, kPushRelabel };
+
+private:
+  Algorithm algorithm_;
+
+  BipartiteMatchingPlan(Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  BipartiteMatchingPlan() : BipartiteMatchingPlan{kCPU, kHopcroftKarp} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Augment in phases (Hopcroft and Karp, SICOMP '73): a parallel
+  /// breadth-first search from all unmatched left nodes levels the left nodes
+  /// by their distance along alternating paths, until the level that reaches
+  /// an unmatched right node, and parallel depth-first searches from the
+  /// unmatched left nodes then augment along disjoint shortest paths, each
+  /// search claiming the right nodes it visits (Azad et al., IPDPS '12).
+  /// Serially, O(sqrt(n)) phases suffice.
+  static BipartiteMatchingPlan HopcroftKarp() {
+    return {kCPU, kHopcroftKarp};
+  }
+
+  /// Push-relabel (Kaya et al., ESA '11): every right node has a label, a
+  /// lower bound on its distance along alternating paths to an unmatched
+  /// right node, and in bulk-synchronous rounds the unmatched left nodes
+  /// take their neighbor with the lowest label, raising its label past their
+  /// next best neighbor and evicting its previous left node, which is
+  /// unmatched in the next round. After every n pushes, and when no left
+  /// node is left to push, a global relabeling sets the labels to the exact
+  /// distances, with a pull-style breadth-first search over the left nodes,
+  /// as the graph only has edges from left to right; the search also proves
+  /// the matching maximum. Suited to graphs with long augmenting paths.
+  static BipartiteMatchingPlan PushRelabel() { return {kCPU, kPushRelabel}; }
+
+  static BipartiteMatchingPlan Automatic() { return {}; }
+};
+
+/// The tag for the output property of bipartite matching in PropertyGraphs:
+/// 1 for the edges in the matching and 0 for the others.
+using BipartiteMatchingEdgeFlag = galois::DensePODProperty<uint8_t>;
+
+/// Compute a maximum matching of pfg, viewed as a bipartite graph with an
+/// edge from its source as a left node to its destination as a right node.
+/// Every node is both a left and a right node, so pfg is bipartite as stored
+/// if its edges go from one set of nodes to another; a node with both
+/// outgoing and incoming edges is matched on each side independently. Self
+/// loops are never matched. The edges of the matching are stored in an edge
+/// property named by output_property_name. Which maximum matching is found
+/// depends on the scheduling of the threads. The plan controls the algorithm
+/// used to compute the matching. The property named output_property_name is
+/// created by this function and may not exist before the call.
+GALOIS_EXPORT Result<void> BipartiteMatching(
+    graphs::PropertyFileGraph* pfg, const std::string& output_property_name,
+    BipartiteMatchingPlan plan = BipartiteMatchingPlan::Automatic());
+
+}  // namespace galois::analytics
+
+#endif
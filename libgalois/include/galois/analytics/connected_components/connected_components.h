@@ -0,0 +1,230 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_ANALYTICS_CONNECTEDCOMPONENTS_CONNECTEDCOMPONENTS_H_
+#define GALOIS_LIBGALOIS_GALOIS_ANALYTICS_CONNECTEDCOMPONENTS_CONNECTEDCOMPONENTS_H_
+
+#include <utility>
+#include <vector>
+
+#include "galois/analytics/GraphStatistics.h"
+#include "galois/analytics/Plan.h"
+#include "galois/analytics/TraversalFilter.h"
+#include "galois/analytics/Utils.h"
+
+namespace galois::analytics {
+
+/// A computational plan to for connected components, specifying the algorithm
+/// and any parameters associated with it.
+///
+/// All algorithms label a node with the smallest node id in its component, so
+/// every plan computes the same labels.
+class ConnectedComponentsPlan : Plan {
+public:
+  enum Algorithm {
+    kSerial,
+    kLabelProp,
+    kSynchronous,
+    kAsynchronous,
+    kEdgeAsynchronous,
+    kEdgeTiledAsynchronous,
+    kBlockedAsynchronous,
+    kAfforest,
+    kEdgeAfforest,
+    kEdgeTiledAfforest,
+    kAutomatic,
+  };
+
+  static constexpr ptrdiff_t kDefaultEdgeTileSize = 512;
+  static constexpr uint32_t kDefaultNeighborSampleSize = 2;
+  static constexpr uint32_t kDefaultComponentSampleFrequency = 1024;
+
+private:
+  Algorithm algorithm_;
+  ptrdiff_t edge_tile_size_;
+  uint32_t neighbor_sample_size_;
+  uint32_t component_sample_frequency_;
+  TraversalFilter filter_;
+
+  ConnectedComponentsPlan(
+      Architecture architecture, Algorithm algorithm,
+      ptrdiff_t edge_tile_size = kDefaultEdgeTileSize,
+      uint32_t neighbor_sample_size = kDefaultNeighborSampleSize,
+      uint32_t component_sample_frequency = kDefaultComponentSampleFrequency)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        edge_tile_size_(edge_tile_size),
+        neighbor_sample_size_(neighbor_sample_size),
+        component_sample_frequency_(component_sample_frequency) {}
+
+public:
+  ConnectedComponentsPlan() : ConnectedComponentsPlan{kCPU, kAutomatic} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// The number of edges of a work item of the edge-tiled algorithms
+  ptrdiff_t edge_tile_size() const { return edge_tile_size_; }
+  /// The number of edges per node the Afforest algorithms link before they
+  /// look for the largest component
+  uint32_t neighbor_sample_size() const { return neighbor_sample_size_; }
+  /// The number of nodes the Afforest algorithms sample to find the largest
+  /// component
+  uint32_t component_sample_frequency() const {
+    return component_sample_frequency_;
+  }
+
+  /// The edges and nodes the traversal is restricted to; none by default
+  const TraversalFilter& filter() const { return filter_; }
+
+  /// The same plan restricted to the edges and nodes that pass filter
+  ConnectedComponentsPlan WithFilter(TraversalFilter filter) const {
+    ConnectedComponentsPlan plan = *this;
+    plan.filter_ = std::move(filter);
+    return plan;
+  }
+
+  /// Serial union-find
+  static ConnectedComponentsPlan Serial() { return {kCPU, kSerial}; }
+
+  /// Each round, nodes whose label decreased push it to their neighbors
+  /// until no label changes. Works best on graphs whose node ids are
+  /// randomized.
+  static ConnectedComponentsPlan LabelProp() { return {kCPU, kLabelProp}; }
+
+  /// Bulk-synchronous union-find: rounds alternate between merging the
+  /// components of one edge per node and finding the next edge per node whose
+  /// endpoints are in different components
+  static ConnectedComponentsPlan Synchronous() {
+    return {kCPU, kSynchronous};
+  }
+
+  /// Topology-driven union-find with concurrent merges; a work item is a node
+  static ConnectedComponentsPlan Asynchronous() {
+    return {kCPU, kAsynchronous};
+  }
+
+  /// Like Asynchronous, but a work item is an edge
+  static ConnectedComponentsPlan EdgeAsynchronous() {
+    return {kCPU, kEdgeAsynchronous};
+  }
+
+  /// Like Asynchronous, but a work item is a tile of up to edge_tile_size
+  /// edges of a node
+  static ConnectedComponentsPlan EdgeTiledAsynchronous(
+      ptrdiff_t edge_tile_size = kDefaultEdgeTileSize) {
+    return {kCPU, kEdgeTiledAsynchronous, edge_tile_size};
+  }
+
+  /// Like Asynchronous, but threads off the first socket stop after the first
+  /// edge of each node and leave the rest to a NUMA-aware worklist
+  static ConnectedComponentsPlan BlockedAsynchronous() {
+    return {kCPU, kBlockedAsynchronous};
+  }
+
+  /// Union-find with subgraph sampling (Sutton et al., IPDPS '18): link the
+  /// first neighbor_sample_size edges of every node, estimate the largest
+  /// component from component_sample_frequency random nodes, then link the
+  /// remaining edges of the nodes outside of it only
+  static ConnectedComponentsPlan Afforest(
+      uint32_t neighbor_sample_size = kDefaultNeighborSampleSize,
+      uint32_t component_sample_frequency = kDefaultComponentSampleFrequency) {
+    return {
+        kCPU, kAfforest, kDefaultEdgeTileSize, neighbor_sample_size,
+        component_sample_frequency};
+  }
+
+  /// Like Afforest, but the remaining edges are processed as individual work
+  /// items
+  static ConnectedComponentsPlan EdgeAfforest(
+      uint32_t neighbor_sample_size = kDefaultNeighborSampleSize,
+      uint32_t component_sample_frequency = kDefaultComponentSampleFrequency) {
+    return {
+        kCPU, kEdgeAfforest, kDefaultEdgeTileSize, neighbor_sample_size,
+        component_sample_frequency};
+  }
+
+  /// Like Afforest, but the remaining edges are processed in tiles of up to
+  /// edge_tile_size edges
+  static ConnectedComponentsPlan EdgeTiledAfforest(
+      ptrdiff_t edge_tile_size = kDefaultEdgeTileSize,
+      uint32_t neighbor_sample_size = kDefaultNeighborSampleSize,
+      uint32_t component_sample_frequency = kDefaultComponentSampleFrequency) {
+    return {
+        kCPU, kEdgeTiledAfforest, edge_tile_size, neighbor_sample_size,
+        component_sample_frequency};
+  }
+
+  static ConnectedComponentsPlan Automatic() { return {}; }
+
+  /// Choose an algorithm from the statistics of a graph: Afforest on
+  /// power-law graphs, where sampling skips the edges of the giant component,
+  /// and EdgeTiledAsynchronous otherwise, where few edges per node leave
+  /// little to skip
+  static ConnectedComponentsPlan Automatic(const GraphStatistics& stats) {
+    if (stats.power_law()) {
+      return Afforest();
+    }
+    return EdgeTiledAsynchronous(stats.EdgeTileSize(kDefaultEdgeTileSize));
+  }
+
+  /// Automatic(GraphStatistics) with the statistics of pfg (\see
+  /// GetGraphStatistics)
+  static ConnectedComponentsPlan Automatic(
+      const galois::graphs::PropertyFileGraph* pfg) {
+    galois::StatTimer autoAlgoTimer("CC_Automatic_Algorithm_Selection");
+    autoAlgoTimer.start();
+    auto stats = GetGraphStatistics(*pfg);
+    autoAlgoTimer.stop();
+    if (!stats) {
+      GALOIS_LOG_WARN("no graph statistics: {}", stats.error());
+      return EdgeTiledAsynchronous();
+    }
+    return Automatic(stats.value());
+  }
+};
+
+/// The tag for the output property of connected components in PropertyGraphs.
+using ConnectedComponentsNodeComponent = galois::DensePODProperty<uint64_t>;
+
+/// Compute the connected components of pfg, which must be symmetric, i.e.,
+/// have the reverse of each of its edges. The component of each node, the
+/// smallest node id in it, is stored in a property named by
+/// output_property_name. The plan controls the algorithm and parameters used
+/// to compute the components; kAutomatic picks one from the degree
+/// distribution of pfg.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call.
+GALOIS_EXPORT Result<void> ConnectedComponents(
+    graphs::PropertyFileGraph* pfg, const std::string& output_property_name,
+    ConnectedComponentsPlan plan = ConnectedComponentsPlan::Automatic());
+
+/// Compute the connected components of pg, which must be symmetric. The
+/// results are stored in the node data of the graph. kAutomatic resolves to
+/// Afforest.
+GALOIS_EXPORT Result<void> ConnectedComponents(
+    graphs::PropertyGraph<
+        std::tuple<ConnectedComponentsNodeComponent>, std::tuple<>>& pg,
+    ConnectedComponentsPlan plan = ConnectedComponentsPlan::Automatic());
+
+/// Update the components stored by ConnectedComponents in the property of
+/// pfg named component_property_name after the edges new_edges, given as
+/// pairs of node ids, were added to pfg.
+///
+/// The property is used as the parent array of a union-find forest in which
+/// every node has a parent no larger than itself and a root is its own parent;
+/// the output of ConnectedComponents is such a forest of depth one. Linking
+/// new_edges only visits their endpoints and the ancestors of those, so the
+/// cost depends on the number of new edges rather than on the size of pfg, and
+/// the forest can be persisted with pfg and updated again after the next
+/// insertions. The component of a node stays the smallest node id in it, but
+/// nodes of merged components may be left pointing at a former root; the
+/// component of a node is its root. With compress, every node is then pointed
+/// directly at its root in one pass over the nodes, which gives the output of
+/// ConnectedComponents on the updated graph.
+///
+/// The property is marked as modified so that the next Write or Commit of pfg
+/// stores it again.
+GALOIS_EXPORT Result<void> ConnectedComponentsIncremental(
+    graphs::PropertyFileGraph* pfg, const std::string& component_property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& new_edges,
+    bool compress = false);
+
+}  // namespace galois::analytics
+
+#endif
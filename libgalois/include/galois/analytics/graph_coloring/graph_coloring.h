@@ -0,0 +1,62 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_ANALYTICS_GRAPHCOLORING_GRAPHCOLORING_H_
+#define GALOIS_LIBGALOIS_GALOIS_ANALYTICS_GRAPHCOLORING_GRAPHCOLORING_H_
+
+#include "galois/analytics/Plan.h"
+#include "galois/analytics/Utils.h"
+
+namespace galois::analytics {
+
+/// A computational plan to for graph coloring, specifying the algorithm and
+/// any parameters associated with it.
+///
+/// A coloring gives every node a color, numbered from 0, such that no two
+/// neighbors have the same color. Colorings with few colors are sought, but
+/// not the fewest, which is NP-hard to find.
+class GraphColoringPlan : Plan {
+public:
+  enum Algorithm { kJonesPlassmann };
+
+private:
+  Algorithm algorithm_;
+  ptrdiff_t edge_tile_size_;
+
+  GraphColoringPlan(
+      Architecture architecture, Algorithm algorithm, ptrdiff_t edge_tile_size)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        edge_tile_size_(edge_tile_size) {}
+
+public:
+  GraphColoringPlan() : GraphColoringPlan{kCPU, kJonesPlassmann, 256} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  ptrdiff_t edge_tile_size() const { return edge_tile_size_; }
+
+  /// Color the nodes in rounds (Jones and Plassmann, SISC '93): in each
+  /// round, the uncolored nodes whose priority is higher than that of all
+  /// their uncolored neighbors take the smallest color none of their
+  /// neighbors has. The rounds are those of IndependentSetPlan::Priority, so
+  /// a node of degree d gets a color of at most d, and low degree nodes go
+  /// first.
+  static GraphColoringPlan JonesPlassmann(ptrdiff_t edge_tile_size = 256) {
+    return {kCPU, kJonesPlassmann, edge_tile_size};
+  }
+
+  static GraphColoringPlan Automatic() { return {}; }
+};
+
+/// The tag for the output property of graph coloring in PropertyGraphs.
+using GraphColoringNodeColor = galois::DensePODProperty<uint32_t>;
+
+/// Color the nodes of pfg, which must be symmetric. The result is stored in a
+/// property named by output_property_name. Self loops are ignored. The plan
+/// controls the algorithm used to color the graph; the coloring is
+/// deterministic. The property named output_property_name is created by this
+/// function and may not exist before the call.
+GALOIS_EXPORT Result<void> GraphColoring(
+    graphs::PropertyFileGraph* pfg, const std::string& output_property_name,
+    GraphColoringPlan plan = GraphColoringPlan::Automatic());
+
+}  // namespace galois::analytics
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_ANALYTICS_GRAPHCOLORING_GRAPHCOLORINGINTERNAL_H_
+#define GALOIS_LIBGALOIS_GALOIS_ANALYTICS_GRAPHCOLORING_GRAPHCOLORINGINTERNAL_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+#include "galois/Galois.h"
+#include "galois/Reduction.h"
+#include "galois/analytics/independent_set/independent_set_internal.h"
+#include "galois/substrate/PerThreadStorage.h"
+
+namespace galois::analytics {
+
+/// The color of a node that is not colored yet
+constexpr uint32_t kUncolored = std::numeric_limits<uint32_t>::max();
+
+/// Color the nodes of graph, which should be symmetric, with the
+/// Jones-Plassmann rounds of GraphColoringPlan::JonesPlassmann. color(node)
+/// returns a reference to the std::atomic<uint32_t> that holds the color of
+/// node; any previous contents are overwritten. Returns the number of colors.
+template <typename Graph, typename ColorFn>
+uint32_t
+JonesPlassmannColoring(
+    const Graph& graph, ptrdiff_t max_tile_size, const ColorFn& color) {
+  using Node = typename Graph::Node;
+
+  galois::do_all(
+      galois::iterate(graph),
+      [&](const Node& node) {
+        color(node).store(kUncolored, std::memory_order_relaxed);
+      },
+      galois::no_stats());
+
+  // marks[c] is node + 1 while the color of node is chosen if a neighbor of
+  // node has color c; the marks of other nodes need no clearing
+  galois::substrate::PerThreadStorage<std::vector<uint32_t>> marks;
+  galois::GReduceMax<uint32_t> max_color;
+  PackedNodeStates states(graph.num_nodes());
+
+  size_t rounds = PriorityRounds(
+      graph, &states, max_tile_size,
+      [&](const Node& node) {
+        auto beg = graph.edge_begin(node);
+        auto end = graph.edge_end(node);
+        // Among degree + 1 colors, one is free
+        auto num_candidates = static_cast<size_t>(std::distance(beg, end)) + 1;
+        std::vector<uint32_t>& node_marks = *marks.getLocal();
+        if (node_marks.size() < num_candidates) {
+          node_marks.resize(num_candidates, 0);
+        }
+        uint32_t mark = node + 1;
+        for (auto e = beg; e != end; ++e) {
+          Node dest = *graph.GetEdgeDest(e);
+          uint32_t dest_color = color(dest).load(std::memory_order_relaxed);
+          if (dest != node && dest_color < num_candidates) {
+            node_marks[dest_color] = mark;
+          }
+        }
+        uint32_t node_color = 0;
+        while (node_marks[node_color] == mark) {
+          ++node_color;
+        }
+        color(node).store(node_color, std::memory_order_relaxed);
+        max_color.update(node_color);
+        states.Decide(node, PackedNodeStates::kIn);
+      },
+      "JonesPlassmann");
+
+  galois::ReportStatSingle("JonesPlassmann", "rounds", rounds);
+
+  return graph.num_nodes() == 0 ? 0 : max_color.reduce() + 1;
+}
+
+}  // namespace galois::analytics
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_ANALYTICS_INDEPENDENTSET_INDEPENDENTSET_H_
+#define GALOIS_LIBGALOIS_GALOIS_ANALYTICS_INDEPENDENTSET_INDEPENDENTSET_H_
+
+#include "galois/analytics/Plan.h"
+#include "galois/analytics/Utils.h"
+
+namespace galois::analytics {
+
+/// A computational plan to for maximal independent set, specifying the
+/// algorithm and any parameters associated with it.
+///
+/// An independent set has no two neighboring nodes, and it is maximal if no
+/// node can be added to it, i.e., every node outside the set has a neighbor in
+/// it. This is not the maximum independent set, which is NP-hard to find.
+class IndependentSetPlan : Plan {
+public:
+  enum Algorithm { kSerial, kPriority };
+
+private:
+  Algorithm algorithm_;
+  ptrdiff_t edge_tile_size_;
+
+  IndependentSetPlan(
+      Architecture architecture, Algorithm algorithm, ptrdiff_t edge_tile_size)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        edge_tile_size_(edge_tile_size) {}
+
+public:
+  IndependentSetPlan() : IndependentSetPlan{kCPU, kPriority, 256} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  ptrdiff_t edge_tile_size() const { return edge_tile_size_; }
+
+  /// Visit the nodes in order and add each node that has no neighbor in the
+  /// set yet
+  static IndependentSetPlan Serial() { return {kCPU, kSerial, 0}; }
+
+  /// Decide the nodes in rounds (Luby, STOC '85): in each round, the
+  /// undecided nodes whose priority is higher than that of all their
+  /// undecided neighbors join the set, and their neighbors are left out. Low
+  /// degree nodes have higher priority, as in ECL-MIS (Burtscher et al., TOPC
+  /// '18), which tends to give larger sets. The state of each node takes two
+  /// bits, and the neighbors of large nodes are compared in tiles of at most
+  /// edge_tile_size edges.
+  static IndependentSetPlan Priority(ptrdiff_t edge_tile_size = 256) {
+    return {kCPU, kPriority, edge_tile_size};
+  }
+
+  static IndependentSetPlan Automatic() { return {}; }
+};
+
+/// The tag for the output property of maximal independent set in
+/// PropertyGraphs: 1 for the nodes in the set and 0 for the others.
+using IndependentSetNodeFlag = galois::DensePODProperty<uint8_t>;
+
+/// Compute a maximal independent set of pfg, which must be symmetric. The
+/// result is stored in a property named by output_property_name. Self loops
+/// are ignored. The plan controls the algorithm used to compute the set; both
+/// algorithms are deterministic. The property named output_property_name is
+/// created by this function and may not exist before the call.
+GALOIS_EXPORT Result<void> IndependentSet(
+    graphs::PropertyFileGraph* pfg, const std::string& output_property_name,
+    IndependentSetPlan plan = IndependentSetPlan::Automatic());
+
+}  // namespace galois::analytics
+
+#endif
@@ -0,0 +1,207 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_ANALYTICS_INDEPENDENTSET_INDEPENDENTSETINTERNAL_H_
+#define GALOIS_LIBGALOIS_GALOIS_ANALYTICS_INDEPENDENTSET_INDEPENDENTSETINTERNAL_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <utility>
+
+#include "galois/Bag.h"
+#include "galois/EdgeTiles.h"
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+
+namespace galois::analytics {
+
+/// The state of every node of a graph in two bits, 32 nodes to a word, for
+/// the priority rounds of maximal independent set and coloring (\see
+/// PriorityRounds). A node is undecided until it is decided in or out, and
+/// within a round an undecided node may be blocked from being decided.
+///
+/// Blocking and unblocking are single atomic or and and operations on the
+/// word of the node, and deciding is a compare-and-swap of the word that only
+/// succeeds on an undecided or blocked node, so the nodes sharing a word can
+/// be updated by different threads.
+class PackedNodeStates {
+public:
+  enum State : uint64_t { kUndecided = 0, kIn = 1, kOut = 2, kBlocked = 3 };
+
+private:
+  static constexpr uint32_t kStatesPerWord = 32;
+  static constexpr uint64_t kStateMask = 3;
+
+  LargeArray<std::atomic<uint64_t>> words_;
+
+  static uint32_t Shift(uint32_t node) { return 2 * (node % kStatesPerWord); }
+
+  std::atomic<uint64_t>& Word(uint32_t node) {
+    return words_[node / kStatesPerWord];
+  }
+
+public:
+  /// num_nodes undecided nodes, initialized in parallel
+  explicit PackedNodeStates(size_t num_nodes) {
+    size_t num_words = (num_nodes + kStatesPerWord - 1) / kStatesPerWord;
+    words_.allocateBlocked(num_words);
+    galois::do_all(
+        galois::iterate(size_t{0}, num_words),
+        [&](size_t w) { words_.constructAt(w, uint64_t{0}); },
+        galois::no_stats());
+  }
+
+  static bool IsUndecided(State state) {
+    return state == kUndecided || state == kBlocked;
+  }
+
+  State Get(uint32_t node) const {
+    uint64_t word =
+        words_[node / kStatesPerWord].load(std::memory_order_relaxed);
+    return static_cast<State>((word >> Shift(node)) & kStateMask);
+  }
+
+  /// Block node, which must be undecided, until it is unblocked
+  void Block(uint32_t node) {
+    Word(node).fetch_or(kBlocked << Shift(node), std::memory_order_relaxed);
+  }
+
+  /// Make node, which must be blocked, undecided again
+  void Unblock(uint32_t node) {
+    Word(node).fetch_and(
+        ~(kBlocked << Shift(node)), std::memory_order_relaxed);
+  }
+
+  /// Decide node in or out; returns false, leaving node alone, if it was
+  /// already decided
+  bool Decide(uint32_t node, State state) {
+    std::atomic<uint64_t>& word = Word(node);
+    uint32_t shift = Shift(node);
+    uint64_t old_word = word.load(std::memory_order_relaxed);
+    while (true) {
+      if (!IsUndecided(static_cast<State>((old_word >> shift) & kStateMask))) {
+        return false;
+      }
+      uint64_t new_word =
+          (old_word & ~(kStateMask << shift)) | (uint64_t{state} << shift);
+      if (word.compare_exchange_weak(
+              old_word, new_word, std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+  }
+};
+
+/// The priority of node, of degree degree, in PriorityRounds: nodes of lower
+/// degree, in buckets by powers of two, come first, as small nodes leave more
+/// room for the others, and within a bucket a hash of the node orders the
+/// nodes randomly so that chains of waiting nodes stay short (Burtscher et
+/// al., ECL-MIS, TOPC '18). The hash is a bijection of 32-bit integers, so
+/// no two nodes have the same priority.
+inline uint64_t
+NodePriority(uint32_t node, uint64_t degree) {
+  uint64_t bucket = degree == 0 ? 0 : 64 - __builtin_clzll(degree);
+  uint32_t hash = node;
+  hash = ((hash >> 16) ^ hash) * 0x45d9f3b;
+  hash = ((hash >> 16) ^ hash) * 0x45d9f3b;
+  hash = (hash >> 16) ^ hash;
+  return ((64 - bucket) << 32) | hash;
+}
+
+/// Decide every undecided node of graph in rounds, as in Luby's algorithm. In
+/// each round, an undecided node that has an undecided neighbor of higher
+/// priority (\see NodePriority) is blocked; the scans over the neighbors are
+/// split into tiles of at most max_tile_size edges (\see DoAllEdgeTiles). The
+/// nodes left undecided win and are passed to decide(node), which decides
+/// them and may decide their neighbors, with states->Decide. The blocked
+/// nodes go on to the next round. The undecided node of highest priority
+/// always wins, so every round decides at least one node.
+///
+/// On a symmetric graph, no two winners of a round are neighbors. Returns the
+/// number of rounds.
+template <typename Graph, typename DecideFn>
+size_t
+PriorityRounds(
+    const Graph& graph, PackedNodeStates* states, ptrdiff_t max_tile_size,
+    const DecideFn& decide, const std::string& loopname) {
+  using Node = typename Graph::Node;
+
+  auto priority = [&](Node node) {
+    return NodePriority(
+        node, std::distance(graph.edge_begin(node), graph.edge_end(node)));
+  };
+
+  galois::InsertBag<Node> bags[2];
+  galois::InsertBag<Node>* current = &bags[0];
+  galois::InsertBag<Node>* next = &bags[1];
+  galois::do_all(
+      galois::iterate(graph),
+      [&](const Node& node) {
+        if (PackedNodeStates::IsUndecided(states->Get(node))) {
+          current->push(node);
+        }
+      },
+      galois::no_stats());
+
+  ptrdiff_t tile_size =
+      AdaptiveEdgeTileSize(graph.num_edges(), max_tile_size);
+  std::string block_loopname = loopname + "-Block";
+  std::string decide_loopname = loopname + "-Decide";
+  std::string unblock_loopname = loopname + "-Unblock";
+
+  size_t rounds = 0;
+  while (!current->empty()) {
+    ++rounds;
+
+    DoAllEdgeTiles(
+        *current,
+        [&](const Node& node) {
+          return std::make_pair(graph.edge_begin(node), graph.edge_end(node));
+        },
+        tile_size,
+        [&](const Node& src, auto beg, auto end) {
+          // Another tile of src may have blocked it already
+          if (states->Get(src) != PackedNodeStates::kUndecided) {
+            return;
+          }
+          uint64_t src_priority = priority(src);
+          for (auto e = beg; e != end; ++e) {
+            Node dest = *graph.GetEdgeDest(e);
+            if (dest != src &&
+                PackedNodeStates::IsUndecided(states->Get(dest)) &&
+                priority(dest) > src_priority) {
+              states->Block(src);
+              return;
+            }
+          }
+        },
+        block_loopname.c_str());
+
+    galois::do_all(
+        galois::iterate(*current),
+        [&](const Node& node) {
+          if (states->Get(node) == PackedNodeStates::kUndecided) {
+            decide(node);
+          }
+        },
+        galois::steal(), galois::loopname(decide_loopname.c_str()));
+
+    next->clear();
+    galois::do_all(
+        galois::iterate(*current),
+        [&](const Node& node) {
+          if (states->Get(node) == PackedNodeStates::kBlocked) {
+            states->Unblock(node);
+            next->push(node);
+          }
+        },
+        galois::steal(), galois::loopname(unblock_loopname.c_str()));
+    std::swap(current, next);
+  }
+
+  return rounds;
+}
+
+}  // namespace galois::analytics
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_ANALYTICS_JACCARD_JACCARD_H_
+#define GALOIS_LIBGALOIS_GALOIS_ANALYTICS_JACCARD_JACCARD_H_
+
+#include <vector>
+
+#include "galois/analytics/Plan.h"
+#include "galois/analytics/Utils.h"
+
+namespace galois::analytics {
+
+/// A computational plan to for Jaccard similarity, specifying the algorithm
+/// and any parameters associated with it.
+class JaccardPlan : Plan {
+public:
+  enum EdgeSorting {
+    /// The edges of each node are sorted by destination
+    kSorted,
+    /// The edges may be in any order
+    kUnsorted,
+    /// Use the sorting recorded in the topology of the graph
+    kUnknown
+  };
+
+private:
+  EdgeSorting edge_sorting_;
+
+  JaccardPlan(Architecture architecture, EdgeSorting edge_sorting)
+      : Plan(architecture), edge_sorting_(edge_sorting) {}
+
+public:
+  JaccardPlan() : JaccardPlan{kCPU, kUnknown} {}
+
+  EdgeSorting edge_sorting() const { return edge_sorting_; }
+
+  /// Intersect the sorted neighbors of each node with those of the compare
+  /// node with SIMD merges (\see CountSortedIntersection); requires that the
+  /// edges be sorted by destination (\see SortAllEdgesByDest)
+  static JaccardPlan Sorted() { return {kCPU, kSorted}; }
+
+  /// Look up the neighbors of each node in a bitset of the neighbors of the
+  /// compare node
+  static JaccardPlan Unsorted() { return {kCPU, kUnsorted}; }
+
+  /// Sorted if the edges of the graph are sorted by destination, Unsorted
+  /// otherwise
+  static JaccardPlan Automatic() { return {}; }
+};
+
+/// The tag for the output property of Jaccard similarity in PropertyGraphs.
+using JaccardSimilarity = galois::DensePODProperty<double>;
+
+/// Compute the Jaccard similarity of each node of pfg to compare_node, the
+/// number of neighbors they share divided by the number of nodes that are a
+/// neighbor of either; two nodes without neighbors have a similarity of 1.
+/// pfg must not have multi-edges. The result is stored in a property named by
+/// output_property_name. The plan controls how neighbors are intersected.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call.
+GALOIS_EXPORT Result<void> Jaccard(
+    graphs::PropertyFileGraph* pfg, uint32_t compare_node,
+    const std::string& output_property_name,
+    JaccardPlan plan = JaccardPlan::Automatic());
+
+/// How TopKSimilarNodes scores two nodes from the number of neighbors they
+/// share, c, and their numbers of neighbors, a and b.
+enum SimilarityMeasure {
+  /// c / (a + b - c), the fraction of the union of the neighbors that is shared
+  kJaccardSimilarity,
+  /// c / sqrt(a * b)
+  kCosineSimilarity,
+  /// c / min(a, b)
+  kOverlapSimilarity
+};
+
+/// The most similar nodes of each of a batch of query nodes. The results of
+/// query i are at positions [offsets[i], offsets[i + 1]) of nodes and
+/// similarities, from most to least similar.
+struct TopKSimilarity {
+  std::vector<uint64_t> offsets;
+  std::vector<uint32_t> nodes;
+  std::vector<double> similarities;
+};
+
+/// Find the k nodes most similar to each node of query_nodes by measure, ties
+/// broken by smaller node id. A query node is never among its own results, and
+/// only nodes that share a neighbor with it are considered, so a query may
+/// have fewer than k results.
+///
+/// Queries run in parallel and each considers only the nodes two hops away
+/// from it: their numbers of common neighbors come from counting the paths of
+/// length two, and each thread keeps the k best in a heap that it reuses
+/// across queries. Memory is proportional to k times the number of queries,
+/// not to the number of nodes, and no property is added to pfg. pfg must be
+/// symmetric, without multi-edges. Returns InvalidArgument if a query node is
+/// not a node of pfg.
+GALOIS_EXPORT Result<TopKSimilarity> TopKSimilarNodes(
+    graphs::PropertyFileGraph* pfg, const std::vector<uint32_t>& query_nodes,
+    uint32_t k, SimilarityMeasure measure = kJaccardSimilarity);
+
+}  // namespace galois::analytics
+
+#endif
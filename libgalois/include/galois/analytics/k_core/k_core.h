@@ -0,0 +1,62 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_ANALYTICS_KCORE_KCORE_H_
+#define GALOIS_LIBGALOIS_GALOIS_ANALYTICS_KCORE_KCORE_H_
+
+#include "galois/analytics/Plan.h"
+#include "galois/analytics/Utils.h"
+
+namespace galois::analytics {
+
+/// A computational plan to for k-core decomposition, specifying the algorithm
+/// and any parameters associated with it.
+///
+/// All algorithms peel the graph level by level: at level k, nodes with at
+/// most k remaining neighbors are removed, which may bring more nodes down to
+/// k, until every remaining node has more than k neighbors. The level at which
+/// a node is removed is its coreness, the largest k such that the node is in
+/// the k-core.
+class KCorePlan : Plan {
+public:
+  enum Algorithm { kSynchronous, kBucketed };
+
+private:
+  Algorithm algorithm_;
+
+  KCorePlan(Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  KCorePlan() : KCorePlan{kCPU, kBucketed} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Each level scans the remaining nodes for those with at most k neighbors
+  /// and peels them in bulk-synchronous rounds; the scans cost a pass over
+  /// the remaining nodes per distinct coreness
+  static KCorePlan Synchronous() { return {kCPU, kSynchronous}; }
+
+  /// Nodes wait in buckets by their remaining degree (Dhulipala et al., SPAA
+  /// '17), kept by an ordered-by-integer-metric worklist with a barrier
+  /// between priority levels: a node is moved to the bucket of its new degree,
+  /// or of the current level if that is lower, when a neighbor is removed, so
+  /// only the nodes whose degree changed are touched at each level
+  static KCorePlan Bucketed() { return {kCPU, kBucketed}; }
+
+  static KCorePlan Automatic() { return {}; }
+};
+
+/// The tag for the output property of k-core decomposition in PropertyGraphs.
+using KCoreNodeCoreness = galois::DensePODProperty<uint32_t>;
+
+/// Compute the coreness of each node of pfg, which must be symmetric. The
+/// result is stored in a property named by output_property_name; the k-core
+/// of pfg for any k is the subgraph induced by the nodes whose coreness is at
+/// least k. The plan controls the algorithm used to compute the coreness.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call.
+GALOIS_EXPORT Result<void> KCore(
+    graphs::PropertyFileGraph* pfg, const std::string& output_property_name,
+    KCorePlan plan = KCorePlan::Automatic());
+
+}  // namespace galois::analytics
+
+#endif
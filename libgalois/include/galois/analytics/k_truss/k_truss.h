@@ -0,0 +1,66 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_ANALYTICS_KTRUSS_KTRUSS_H_
+#define GALOIS_LIBGALOIS_GALOIS_ANALYTICS_KTRUSS_KTRUSS_H_
+
+#include "galois/analytics/Plan.h"
+#include "galois/analytics/Utils.h"
+
+namespace galois::analytics {
+
+/// A computational plan to for k-truss decomposition, specifying the algorithm
+/// and any parameters associated with it.
+///
+/// The support of an edge is the number of triangles it is part of. The
+/// trussness of an edge is the largest k such that the edge is in the
+/// k-truss, the largest subgraph in which every edge has a support of at least
+/// k - 2. Decomposition peels the graph level by level: at level s, edges with
+/// a support of at most s are removed, which lowers the support of the other
+/// edges of their triangles, until every remaining edge has a support of more
+/// than s. The edges removed at level s have trussness s + 2.
+class KTrussPlan : Plan {
+public:
+  enum Algorithm { kBucketed };
+
+private:
+  Algorithm algorithm_;
+
+  KTrussPlan(Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  KTrussPlan() : KTrussPlan{kCPU, kBucketed} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Copy the graph into a private sorted symmetric graph, count the support
+  /// of every edge in parallel with SIMD intersections (\see
+  /// CountSortedIntersection), then peel edges in bulk-synchronous rounds
+  /// from the bucket of the current level (Kabir and Madduri, IPDPSW '17):
+  /// removing the edges of a round only recomputes the support of the edges
+  /// of their triangles, and the edges whose support drops to the level form
+  /// the next round. Takes about 21 bytes per edge of the private graph,
+  /// which has both directions of every undirected edge.
+  static KTrussPlan Bucketed() { return {kCPU, kBucketed}; }
+
+  static KTrussPlan Automatic() { return {}; }
+};
+
+/// The tag for the output property of k-truss decomposition in
+/// PropertyGraphs.
+using KTrussEdgeTrussness = galois::DensePODProperty<uint32_t>;
+
+/// Compute the trussness of each edge of pfg, viewed as an undirected graph:
+/// an edge in either direction is an undirected edge, and both directions of
+/// an edge get its trussness. Multi-edges count as one edge, and self loops
+/// are in no triangle and get a trussness of 0. The result is stored in an
+/// edge property named by output_property_name; the k-truss of pfg for any
+/// k >= 2 is the subgraph of the edges whose trussness is at least k. The plan
+/// controls the algorithm used to compute the trussness. The property named
+/// output_property_name is created by this function and may not exist before
+/// the call. pfg is not otherwise modified.
+GALOIS_EXPORT Result<void> KTruss(
+    graphs::PropertyFileGraph* pfg, const std::string& output_property_name,
+    KTrussPlan plan = KTrussPlan::Automatic());
+
+}  // namespace galois::analytics
+
+#endif
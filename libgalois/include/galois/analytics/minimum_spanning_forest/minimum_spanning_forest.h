@@ -0,0 +1,72 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_ANALYTICS_MINIMUMSPANNINGFOREST_MINIMUMSPANNINGFOREST_H_
+#define GALOIS_LIBGALOIS_GALOIS_ANALYTICS_MINIMUMSPANNINGFOREST_MINIMUMSPANNINGFOREST_H_
+
+#include "galois/analytics/Plan.h"
+#include "galois/analytics/Utils.h"
+
+namespace galois::analytics {
+
+/// A computational plan to for minimum spanning forests, specifying the
+/// algorithm and any parameters associated with it.
+///
+/// Both algorithms order the edges by weight and then by edge index, so the
+/// minimum spanning forest is unique and both find the same one.
+class MinimumSpanningForestPlan : Plan {
+public:
+  enum Algorithm { kBoruvka, kFilterKruskal };
+
+private:
+  Algorithm algorithm_;
+
+  MinimumSpanningForestPlan(Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  MinimumSpanningForestPlan() : MinimumSpanningForestPlan{kCPU, kBoruvka} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Contract the graph in rounds: every tree picks its lightest edge to
+  /// another tree in parallel, with a compare-and-swap minimum, and the
+  /// picked edges join their trees in a concurrent union-find. The edges
+  /// inside a tree are then dropped, so each round only scans the edges
+  /// between trees, and the number of trees at least halves per round.
+  static MinimumSpanningForestPlan Boruvka() { return {kCPU, kBoruvka}; }
+
+  /// Kruskal's algorithm, which adds the edges to the forest from the
+  /// lightest up, with the sort replaced by a quicksort-like recursion
+  /// (Osipov et al., ALENEX '09): the edges are partitioned in parallel
+  /// around a pivot weight, the light part is processed first, and the
+  /// edges of the heavy part inside a tree are then filtered out before it
+  /// is processed. Only small parts are sorted, so on sparse graphs the
+  /// heavy edges are mostly dropped rather than sorted.
+  static MinimumSpanningForestPlan FilterKruskal() {
+    return {kCPU, kFilterKruskal};
+  }
+
+  static MinimumSpanningForestPlan Automatic() { return {}; }
+};
+
+/// The tag for the output property of minimum spanning forests in
+/// PropertyGraphs: 1 for the edges in the forest and 0 for the others.
+using MinimumSpanningForestEdgeFlag = galois::DensePODProperty<uint8_t>;
+
+/// Compute a minimum spanning forest of pfg, viewed as an undirected graph:
+/// an edge in either direction connects its endpoints, with the weight from
+/// the edge property named edge_weight_property_name, which may hold 32- or
+/// 64-bit signed or unsigned integers, floats or doubles. The edges of the
+/// forest are stored in an edge property named by output_property_name; each
+/// undirected edge of the forest is flagged on exactly one of the edges of
+/// pfg that stand for it. Self loops are never in the forest. The plan
+/// controls the algorithm used to compute the forest. The property named
+/// output_property_name is created by this function and may not exist before
+/// the call.
+GALOIS_EXPORT Result<void> MinimumSpanningForest(
+    graphs::PropertyFileGraph* pfg,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name,
+    MinimumSpanningForestPlan plan = MinimumSpanningForestPlan::Automatic());
+
+}  // namespace galois::analytics
+
+#endif
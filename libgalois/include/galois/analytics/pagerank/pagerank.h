@@ -0,0 +1,193 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_ANALYTICS_PAGERANK_PAGERANK_H_
+#define GALOIS_LIBGALOIS_GALOIS_ANALYTICS_PAGERANK_PAGERANK_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "galois/analytics/GraphStatistics.h"
+#include "galois/analytics/Plan.h"
+#include "galois/analytics/Utils.h"
+
+namespace galois::analytics {
+
+/// A computational plan to for PageRank, specifying the algorithm and any
+/// parameters associated with it.
+///
+/// All algorithms compute the same, unnormalized, ranks: the rank of a node is
+/// 1 - alpha plus alpha times the sum over its in-neighbors of their rank
+/// divided by their out-degree, so ranks sum to about the number of nodes.
+class PagerankPlan : Plan {
+public:
+  enum Algorithm {
+    kPullTopological,
+    kPullResidual,
+    kPushAsynchronous,
+    kPushSynchronous,
+    kPropagationBlocking
+  };
+
+  static constexpr float kDefaultTolerance = 1.0e-3;
+  static constexpr uint32_t kDefaultMaxIterations = 1000;
+  static constexpr float kDefaultAlpha = 0.85;
+  /// Bins of 64K nodes keep the 256KB of partial sums of a bin in L2
+  static constexpr uint32_t kDefaultBinShift = 16;
+
+private:
+  Algorithm algorithm_;
+  float tolerance_;
+  uint32_t max_iterations_;
+  float alpha_;
+  uint32_t bin_shift_;
+
+  PagerankPlan(
+      Architecture architecture, Algorithm algorithm, float tolerance,
+      uint32_t max_iterations, float alpha, uint32_t bin_shift = 0)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        tolerance_(tolerance),
+        max_iterations_(max_iterations),
+        alpha_(alpha),
+        bin_shift_(bin_shift) {}
+
+public:
+  PagerankPlan()
+      : PagerankPlan{
+            kCPU, kPushAsynchronous, kDefaultTolerance, kDefaultMaxIterations,
+            kDefaultAlpha} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// A node has converged once its rank changes by at most tolerance in a
+  /// round
+  float tolerance() const { return tolerance_; }
+  /// The maximum number of rounds of the round-based algorithms; the
+  /// asynchronous algorithm ignores it
+  uint32_t max_iterations() const { return max_iterations_; }
+  /// The damping factor
+  float alpha() const { return alpha_; }
+  /// log2 of the number of destinations per bin of kPropagationBlocking
+  uint32_t bin_shift() const { return bin_shift_; }
+
+  /// Each round recomputes the rank of every node from the ranks of its
+  /// in-neighbors (\see PropertyFileGraph::InEdges)
+  static PagerankPlan PullTopological(
+      float tolerance = kDefaultTolerance,
+      uint32_t max_iterations = kDefaultMaxIterations,
+      float alpha = kDefaultAlpha) {
+    return {kCPU, kPullTopological, tolerance, max_iterations, alpha};
+  }
+
+  /// Each round, nodes with a residual above tolerance add it to their rank,
+  /// and every node pulls its new residual from its in-neighbors
+  static PagerankPlan PullResidual(
+      float tolerance = kDefaultTolerance,
+      uint32_t max_iterations = kDefaultMaxIterations,
+      float alpha = kDefaultAlpha) {
+    return {kCPU, kPullResidual, tolerance, max_iterations, alpha};
+  }
+
+  /// Data-driven push of residuals along out-edges without rounds (Whang et
+  /// al., Euro-Par '15, Algorithm 4)
+  static PagerankPlan PushAsynchronous(
+      float tolerance = kDefaultTolerance, float alpha = kDefaultAlpha) {
+    return {kCPU, kPushAsynchronous, tolerance, kDefaultMaxIterations, alpha};
+  }
+
+  /// Delta-based PageRank: each round only the nodes whose residual grew past
+  /// tolerance push their change to their out-neighbors
+  static PagerankPlan PushSynchronous(
+      float tolerance = kDefaultTolerance,
+      uint32_t max_iterations = kDefaultMaxIterations,
+      float alpha = kDefaultAlpha) {
+    return {kCPU, kPushSynchronous, tolerance, max_iterations, alpha};
+  }
+
+  /// Pull-topological iteration with propagation blocking (Beamer et al.,
+  /// IPDPS '17). Each round first streams the contribution of every edge into
+  /// a bin by destination range, then sums each bin, so the random accesses
+  /// of a round stay within a range of 1 << bin_shift nodes instead of the
+  /// whole graph. The bins take 8 bytes per edge.
+  static PagerankPlan PropagationBlocking(
+      float tolerance = kDefaultTolerance,
+      uint32_t max_iterations = kDefaultMaxIterations,
+      float alpha = kDefaultAlpha, uint32_t bin_shift = kDefaultBinShift) {
+    return {
+        kCPU, kPropagationBlocking, tolerance, max_iterations, alpha,
+        bin_shift};
+  }
+
+  static PagerankPlan Automatic() { return {}; }
+
+  /// Choose an algorithm from the statistics of a graph: PropagationBlocking
+  /// once the ranks of the nodes (4 bytes each) outgrow a last-level cache of
+  /// about 16MB and there are enough edges per node to pay for the bins, and
+  /// PushAsynchronous otherwise
+  static PagerankPlan Automatic(const GraphStatistics& stats) {
+    if (stats.num_nodes > (uint64_t{1} << 22) && stats.mean_degree >= 4) {
+      return PropagationBlocking();
+    }
+    return PushAsynchronous();
+  }
+
+  /// Automatic(GraphStatistics) with the statistics of pfg (\see
+  /// GetGraphStatistics)
+  static PagerankPlan Automatic(const graphs::PropertyFileGraph* pfg) {
+    auto stats = GetGraphStatistics(*pfg);
+    if (!stats) {
+      GALOIS_LOG_WARN("no graph statistics: {}", stats.error());
+      return Automatic();
+    }
+    return Automatic(stats.value());
+  }
+};
+
+/// The tag for the output property of PageRank in PropertyGraphs.
+using PagerankNodeValue = galois::DensePODProperty<float>;
+
+/// Compute the PageRank of each node in the graph pfg. The result is stored in
+/// a property named by output_property_name. The plan controls the algorithm
+/// and parameters used to compute the ranks.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call.
+GALOIS_EXPORT Result<void> Pagerank(
+    graphs::PropertyFileGraph* pfg, const std::string& output_property_name,
+    PagerankPlan plan = PagerankPlan::Automatic());
+
+/// Compute the PageRank of each node in the graph pg. The result is stored in
+/// the node data of the graph. The plan controls the algorithm and parameters
+/// used to compute the ranks.
+GALOIS_EXPORT Result<void> Pagerank(
+    graphs::PropertyGraph<std::tuple<PagerankNodeValue>, std::tuple<>>& pg,
+    PagerankPlan plan = PagerankPlan::Automatic());
+
+/// The highest personalized PageRanks of each of a batch of seed nodes. The
+/// results of seed i are at positions [offsets[i], offsets[i + 1]) of nodes
+/// and ranks, from highest to lowest rank.
+struct TopKPersonalizedPagerank {
+  std::vector<uint64_t> offsets;
+  std::vector<uint32_t> nodes;
+  std::vector<double> ranks;
+};
+
+/// Find the k nodes of highest personalized PageRank for each of seeds: the
+/// probability of ending at a node for a walk from the seed that follows an
+/// out-edge with probability alpha and stops otherwise, so the ranks of a seed
+/// sum to at most 1. A seed can be among its own results.
+///
+/// Ranks are approximated by forward push (Andersen, Chung and Lang, FOCS
+/// '06): a node with residual probability at least epsilon times its
+/// out-degree keeps 1 - alpha of it and passes the rest to its out-neighbors,
+/// or back to the seed if it has none. The ranks found are lower bounds that
+/// miss at most the residual mass left at the end, and each seed costs
+/// O(1 / (epsilon (1 - alpha))) pushes whatever the size of pfg. Seeds run in
+/// parallel, each with its ranks and residuals in a hash map on the arena of
+/// its thread, so memory is proportional to the nodes a seed touches. No
+/// property is added to pfg. Returns InvalidArgument if a seed is not a node
+/// of pfg, epsilon is not positive or alpha is not in [0, 1).
+GALOIS_EXPORT Result<TopKPersonalizedPagerank> PersonalizedPagerank(
+    graphs::PropertyFileGraph* pfg, const std::vector<uint32_t>& seeds,
+    uint32_t k, double epsilon = 1.0e-6,
+    float alpha = PagerankPlan::kDefaultAlpha);
+
+}  // namespace galois::analytics
+
+#endif
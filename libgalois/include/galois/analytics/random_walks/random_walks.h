@@ -0,0 +1,137 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_ANALYTICS_RANDOMWALKS_RANDOMWALKS_H_
+#define GALOIS_LIBGALOIS_GALOIS_ANALYTICS_RANDOMWALKS_RANDOMWALKS_H_
+
+#include <memory>
+#include <string>
+
+#include <arrow/api.h>
+
+#include "galois/analytics/Plan.h"
+#include "galois/analytics/Utils.h"
+
+namespace galois::analytics {
+
+/// A computational plan for random-walk generation, e.g., for DeepWalk or
+/// node2vec embeddings, specifying the kind of walk and its parameters.
+///
+/// Every node starts walks_per_node walks of at most walk_length steps along
+/// out-edges. A walk stops early at a node without out-edges.
+class RandomWalksPlan : Plan {
+public:
+  enum Algorithm { kUniform, kWeighted, kNode2vec };
+
+  static constexpr uint32_t kDefaultWalkLength = 80;
+  static constexpr uint32_t kDefaultWalksPerNode = 10;
+  static constexpr double kDefaultReturnParameter = 1.0;
+  static constexpr double kDefaultInOutParameter = 1.0;
+
+private:
+  Algorithm algorithm_;
+  uint32_t walk_length_;
+  uint32_t walks_per_node_;
+  double return_parameter_;
+  double in_out_parameter_;
+
+  RandomWalksPlan(
+      Architecture architecture, Algorithm algorithm, uint32_t walk_length,
+      uint32_t walks_per_node, double return_parameter,
+      double in_out_parameter)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        walk_length_(walk_length),
+        walks_per_node_(walks_per_node),
+        return_parameter_(return_parameter),
+        in_out_parameter_(in_out_parameter) {}
+
+public:
+  RandomWalksPlan()
+      : RandomWalksPlan{
+            kCPU,
+            kUniform,
+            kDefaultWalkLength,
+            kDefaultWalksPerNode,
+            kDefaultReturnParameter,
+            kDefaultInOutParameter} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  uint32_t walk_length() const { return walk_length_; }
+  uint32_t walks_per_node() const { return walks_per_node_; }
+  double return_parameter() const { return return_parameter_; }
+  double in_out_parameter() const { return in_out_parameter_; }
+
+  /// Each step follows an out-edge chosen uniformly at random (DeepWalk)
+  static RandomWalksPlan Uniform(
+      uint32_t walk_length = kDefaultWalkLength,
+      uint32_t walks_per_node = kDefaultWalksPerNode) {
+    return {
+        kCPU,
+        kUniform,
+        walk_length,
+        walks_per_node,
+        kDefaultReturnParameter,
+        kDefaultInOutParameter};
+  }
+
+  /// Each step follows an out-edge chosen with probability proportional to
+  /// its weight, in constant time from an alias table built for each node
+  /// before walking
+  static RandomWalksPlan Weighted(
+      uint32_t walk_length = kDefaultWalkLength,
+      uint32_t walks_per_node = kDefaultWalksPerNode) {
+    return {
+        kCPU,
+        kWeighted,
+        walk_length,
+        walks_per_node,
+        kDefaultReturnParameter,
+        kDefaultInOutParameter};
+  }
+
+  /// Second-order walks of node2vec (Grover and Leskovec, KDD '16): the
+  /// weight of the edge from v to x after arriving from t is scaled by
+  /// 1/return_parameter if x is t, by 1 if x is a neighbor of t and by
+  /// 1/in_out_parameter otherwise. Steps are drawn from the alias table of v
+  /// and rejected in proportion to the scaling, so no table per edge is built.
+  static RandomWalksPlan Node2vec(
+      uint32_t walk_length = kDefaultWalkLength,
+      uint32_t walks_per_node = kDefaultWalksPerNode,
+      double return_parameter = kDefaultReturnParameter,
+      double in_out_parameter = kDefaultInOutParameter) {
+    return {kCPU,           kNode2vec,        walk_length,
+            walks_per_node, return_parameter, in_out_parameter};
+  }
+
+  static RandomWalksPlan Automatic() { return {}; }
+};
+
+/// The name of the column of the table returned by RandomWalks
+constexpr char kRandomWalksColumn[] = "walk";
+
+/// Generate random walks over pfg in parallel. The result is a table with a
+/// single large_list<uint32> column named kRandomWalksColumn with one row per
+/// walk: walk w starts at node w % num_nodes, so the walks of each round over
+/// the nodes are contiguous, and lists the nodes it visits, beginning with its
+/// start.
+///
+/// Weighted walks use the edge property named by edge_weight_property_name,
+/// which must be numeric and not negative, with nulls weighing zero; a walk
+/// stops at a node whose out-edges all weigh zero. Node2vec walks use it too,
+/// or weigh every edge 1 if the name is empty, and uniform walks ignore it.
+/// Walks are generated in blocks, each with its own random number generator
+/// seeded by random_seed and the block, so the same random_seed gives the same
+/// walks for any number of threads.
+///
+/// \returns InvalidArgument if the plan or the weights are not valid
+GALOIS_EXPORT Result<std::shared_ptr<arrow::Table>> RandomWalks(
+    graphs::PropertyFileGraph* pfg,
+    const std::string& edge_weight_property_name, uint64_t random_seed,
+    RandomWalksPlan plan = RandomWalksPlan::Automatic());
+
+/// Write walks, as returned by RandomWalks, to a parquet file at uri, which
+/// may be local or in a remote store.
+GALOIS_EXPORT Result<void> WriteRandomWalks(
+    const std::shared_ptr<arrow::Table>& walks, const std::string& uri);
+
+}  // namespace galois::analytics
+
+#endif
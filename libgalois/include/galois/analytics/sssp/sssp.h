@@ -3,9 +3,21 @@
 
 #include <galois/analytics/Plan.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "galois/AtomicHelpers.h"
+#include "galois/substrate/PerThreadStorage.h"
+#include "galois/analytics/Async.h"
 #include "galois/analytics/BfsSsspImplementationBase.h"
+#include "galois/analytics/GraphStatistics.h"
+#include "galois/analytics/TraversalFilter.h"
 #include "galois/analytics/Utils.h"
+#include "galois/graphs/InlineEdgeIndex.h"
 
 // API
 
@@ -26,15 +38,42 @@ public:
     kDijkstra,
     kTopo,
     kTopoTile,
+    kDeltaStepFusion,
+    kMultiQueue,
+    kDeltaStepPmod,
     kAutomatic,
   };
 
+  /// Passed as delta, asks for a delta estimated from the graph: the bucket
+  /// width is about twice the mean edge weight divided by the mean degree,
+  /// rounded to a power of two (Meyer and Sanders, J. Algorithms '03)
+  static constexpr unsigned kAdaptiveDelta =
+      std::numeric_limits<unsigned>::max();
+
+  /// The log2 of the bucket width of kAdaptiveDelta for edges whose weights
+  /// have magnitude mean_weight on average
+  static unsigned AdaptiveDeltaShift(double mean_weight, double mean_degree) {
+    constexpr unsigned kMaxShift = 30;
+    double delta = 2 * mean_weight / std::max(1.0, mean_degree);
+    if (!(delta > 1)) {
+      return 0;
+    }
+    return std::min<unsigned>(kMaxShift, std::lround(std::log2(delta)));
+  }
+
+  /// Default number of heaps per thread of MultiQueue
+  static constexpr unsigned kDefaultRelaxation = 2;
+
   // Don't allow people to directly construct these, so as to have only one
   // consistent way to configure.
 private:
   Algorithm algorithm_;
   unsigned delta_;
   ptrdiff_t edge_tile_size_;
+  uint32_t dense_frontier_divisor_;
+  unsigned relaxation_;
+  TraversalFilter filter_;
+  bool inline_edges_{false};
   // TODO: should chunk_size be in the plan? Or fixed?
   //  It cannot be in the plan currently because it is a template parameter and
   //  cannot be easily changed since the value is statically passed on to
@@ -43,11 +82,15 @@ private:
 
   SsspPlan(
       Architecture architecture, Algorithm algorithm, unsigned delta,
-      ptrdiff_t edge_tile_size)
+      ptrdiff_t edge_tile_size,
+      uint32_t dense_frontier_divisor = kDefaultDenseFrontierDivisor,
+      unsigned relaxation = kDefaultRelaxation)
       : Plan(architecture),
         algorithm_(algorithm),
         delta_(delta),
-        edge_tile_size_(edge_tile_size) {}
+        edge_tile_size_(edge_tile_size),
+        dense_frontier_divisor_(dense_frontier_divisor),
+        relaxation_(relaxation) {}
 
 public:
   SsspPlan() : SsspPlan{kCPU, kAutomatic, 0, 0} {}
@@ -55,6 +98,35 @@ public:
   Algorithm algorithm() const { return algorithm_; }
   unsigned delta() const { return delta_; }
   ptrdiff_t edge_tile_size() const { return edge_tile_size_; }
+  /// \see kDefaultDenseFrontierDivisor
+  uint32_t dense_frontier_divisor() const { return dense_frontier_divisor_; }
+  /// \see MultiQueue
+  unsigned relaxation() const { return relaxation_; }
+
+  /// The edges and nodes the traversal is restricted to; none by default
+  const TraversalFilter& filter() const { return filter_; }
+
+  /// The same plan restricted to the edges and nodes that pass filter
+  SsspPlan WithFilter(TraversalFilter filter) const {
+    SsspPlan plan = *this;
+    plan.filter_ = std::move(filter);
+    return plan;
+  }
+
+  /// Whether the edges are read from the inline edges of the graph for the
+  /// weights; off by default
+  bool inline_edges() const { return inline_edges_; }
+
+  /// The same plan reading the destination and the weight of each edge from
+  /// one array (\see PropertyFileGraph::InlineEdges), which is built and
+  /// cached with the graph on first use. It saves a stream of cache misses
+  /// per edge traversal at the cost of a copy of the destinations and the
+  /// weights.
+  SsspPlan WithInlineEdges(bool inline_edges = true) const {
+    SsspPlan plan = *this;
+    plan.inline_edges_ = inline_edges;
+    return plan;
+  }
 
   static SsspPlan DeltaTile(
       unsigned delta = 13, ptrdiff_t edge_tile_size = 512) {
@@ -69,6 +141,31 @@ public:
     return {kCPU, kDeltaStepBarrier, delta, 0};
   }
 
+  /// Bulk-synchronous delta-stepping with bucket fusion (Zhang et al.,
+  /// CGO '20): a thread keeps relaxing the nodes it adds to the current
+  /// bucket instead of deferring them to another round, which removes most
+  /// rounds, and their barriers, on high-diameter graphs like road networks.
+  static SsspPlan DeltaStepFusion(unsigned delta = kAdaptiveDelta) {
+    return {kCPU, kDeltaStepFusion, delta, 0};
+  }
+
+  /// Asynchronous SSSP over a relaxed concurrent priority queue of the nodes
+  /// to visit, ordered by distance (\see galois::worklists::MultiQueue). There
+  /// are relaxation heaps per thread; more heaps contend less but visit more
+  /// nodes out of order. Unlike delta-stepping, it needs no delta, which suits
+  /// floating point or widely spread weights.
+  static SsspPlan MultiQueue(unsigned relaxation = kDefaultRelaxation) {
+    return {kCPU, kMultiQueue, 0, 0, kDefaultDenseFrontierDivisor, relaxation};
+  }
+
+  /// Delta-stepping over buckets whose width adapts to the graph at runtime
+  /// (\see galois::worklists::AdaptiveOrderedByIntegerMetric): buckets merge
+  /// when they hold too little work for the threads and split when they hold
+  /// so much that work is wasted, so delta is only the initial bucket width.
+  static SsspPlan DeltaStepPmod(unsigned delta = kAdaptiveDelta) {
+    return {kCPU, kDeltaStepPmod, delta, 0};
+  }
+
   static SsspPlan SerialDeltaTile(
       unsigned delta = 13, ptrdiff_t edge_tile_size = 512) {
     return {kCPU, kSerialDeltaTile, delta, edge_tile_size};
@@ -85,7 +182,13 @@ public:
   static SsspPlan Dijkstra() { return {kCPU, kDijkstra, 0, 0}; }
 
   // TODO: Should this be "Topological"
-  static SsspPlan Topo() { return {kCPU, kTopo, 0, 0}; }
+  /// Synchronous Bellman-Ford over a frontier of the nodes whose distances
+  /// changed in the previous round; the frontier switches between sparse and
+  /// dense representations (\see kDefaultDenseFrontierDivisor)
+  static SsspPlan Topo(
+      uint32_t dense_frontier_divisor = kDefaultDenseFrontierDivisor) {
+    return {kCPU, kTopo, 0, 0, dense_frontier_divisor};
+  }
 
   static SsspPlan TopoTile(ptrdiff_t edge_tile_size = 512) {
     return {kCPU, kTopoTile, 0, edge_tile_size};
@@ -93,32 +196,50 @@ public:
 
   static SsspPlan Automatic() { return {}; }
 
-  static SsspPlan Automatic(const galois::graphs::PropertyFileGraph* pfg) {
-    // TODO: What to do about const cast? We know we don't modify pfg, but there
-    //  is no way to construct a const PropertyGraph.
-    auto graph =
-        galois::graphs::PropertyGraph<std::tuple<>, std::tuple<>>::Make(
-            const_cast<galois::graphs::PropertyFileGraph*>(pfg), {}, {});
-    if (!graph)
-      GALOIS_LOG_FATAL(
-          "PropertyGraph should always be constructable here: {}",
-          graph.error());
+  /// Choose an algorithm and delta from the statistics of a graph:
+  /// asynchronous delta-stepping on power-law graphs, whose few rounds leave
+  /// little for bucket fusion to save, and DeltaStepFusion otherwise, most of
+  /// all on high-diameter graphs. Weights spread over more than 2^20 times
+  /// their least magnitude, with which no single delta suits every bucket,
+  /// get DeltaStepPmod. The delta follows from the sampled weights when
+  /// stats has them (\see kAdaptiveDelta) and is kAdaptiveDelta otherwise.
+  static SsspPlan Automatic(const GraphStatistics& stats) {
+    unsigned delta = kAdaptiveDelta;
+    if (!stats.weight_property.empty()) {
+      delta = AdaptiveDeltaShift(stats.mean_weight, stats.mean_degree);
+    }
+    if (!stats.weight_property.empty() &&
+        stats.max_weight > (1 << 20) * std::max(1.0, stats.min_weight)) {
+      return DeltaStepPmod(delta);
+    }
+    if (stats.power_law() && !stats.high_diameter()) {
+      return DeltaStep(delta);
+    }
+    return DeltaStepFusion(delta);
+  }
+
+  /// Automatic(GraphStatistics) with the statistics of pfg and of its weights
+  /// in the edge property weight_property, if not empty (\see
+  /// GetGraphStatistics)
+  static SsspPlan Automatic(
+      const galois::graphs::PropertyFileGraph* pfg,
+      const std::string& weight_property = "") {
     galois::StatTimer autoAlgoTimer("SSSP_Automatic_Algorithm_Selection");
     autoAlgoTimer.start();
-    bool isPowerLaw = isApproximateDegreeDistributionPowerLaw(graph.value());
+    auto stats = GetGraphStatistics(*pfg, weight_property);
     autoAlgoTimer.stop();
-    if (isPowerLaw) {
-      return DeltaStep();
-    } else {
-      return DeltaStepBarrier();
+    if (!stats) {
+      GALOIS_LOG_WARN("no graph statistics: {}", stats.error());
+      return DeltaStepFusion(kAdaptiveDelta);
     }
+    return Automatic(stats.value());
   }
 };
 
 template <typename Weight>
 struct SsspNodeDistance {
   using ArrowType = typename arrow::CTypeTraits<Weight>::ArrowType;
-  using ViewType = galois::PODPropertyView<std::atomic<Weight>>;
+  using ViewType = galois::DensePODPropertyView<std::atomic<Weight>>;
 };
 
 template <typename Weight>
@@ -137,6 +258,70 @@ GALOIS_EXPORT Result<void> Sssp(
     std::string edge_weight_property_name, std::string output_property_name,
     SsspPlan plan = SsspPlan::Automatic());
 
+/// Start Sssp(pfg, start_node, edge_weight_property_name,
+/// output_property_name, plan) on its own thread and return a handle to it at
+/// once (\see RunAsync). The plans with rounds (kDeltaStepFusion, kTopo and
+/// kTopoTile) report each finished round, with the nodes it updated, and stop
+/// after the current round once cancelled, leaving some distances too large;
+/// the others only stop at the end. pfg must not be used until the call
+/// finishes.
+GALOIS_EXPORT AsyncResult<void> SsspAsync(
+    graphs::PropertyFileGraph* pfg, size_t start_node,
+    std::string edge_weight_property_name, std::string output_property_name,
+    SsspPlan plan = SsspPlan::Automatic());
+
+/// Compute the length of a shortest path from source to target in pfg, with
+/// edge weights taken from the property named edge_weight_property_name and
+/// converted to double. Unlike Sssp, the search stops once target is settled,
+/// so its cost depends on the nodes closer to source than target rather than
+/// on the size of pfg. With bidirectional, a second search runs from target
+/// over the in-edges of pfg (\see PropertyFileGraph::InEdges), which
+/// explores far fewer nodes on road-like graphs. Returns infinity if target is
+/// not reachable from source. Weights must be non-negative.
+GALOIS_EXPORT Result<double> SsspPointToPoint(
+    graphs::PropertyFileGraph* pfg, size_t source, size_t target,
+    const std::string& edge_weight_property_name, bool bidirectional = false);
+
+/// How SsspLandmarks picks its landmarks
+enum class LandmarkSelection {
+  /// Each landmark is the node farthest from the ones picked before it, and
+  /// the first is the node farthest from a node of highest degree. This puts
+  /// the landmarks on the edge of the graph, where their bounds are tightest,
+  /// at the cost of one more Sssp.
+  kFarthest,
+  /// The nodes of highest out-degree
+  kDegree,
+};
+
+/// Build a landmark index of pfg for SsspPointToPointLandmarks: pick
+/// num_landmarks landmarks (or all nodes if there are fewer) and store the
+/// distances from landmark i, as computed by Sssp(pfg, landmark,
+/// edge_weight_property_name, ..., plan), in the node property named
+/// output_property_prefix followed by i. These properties are created by this
+/// function and may not exist before the call; they are saved with the rest
+/// of the RDG, so the index only needs to be built once per graph. Returns
+/// the landmarks in order.
+GALOIS_EXPORT Result<std::vector<uint32_t>> SsspLandmarks(
+    graphs::PropertyFileGraph* pfg,
+    const std::string& edge_weight_property_name, uint32_t num_landmarks,
+    const std::string& output_property_prefix,
+    LandmarkSelection selection = LandmarkSelection::kFarthest,
+    SsspPlan plan = SsspPlan::Automatic());
+
+/// Like SsspPointToPoint, but with A* search (ALT, Goldberg and Harrelson,
+/// SODA '05) guided by the landmark index built by SsspLandmarks with
+/// landmark_property_prefix. By the triangle inequality, d(L, target) - d(L,
+/// v) is a lower bound on the distance from v to target for each landmark L,
+/// so the search is pulled towards target and settles a fraction of the nodes
+/// that Dijkstra does; a node that some landmark reaches but whose target it
+/// does not is never expanded. Only distances from the landmarks are stored,
+/// which gives all the ALT bounds when the edges of pfg are symmetric and
+/// some of them otherwise. The answer is the same as SsspPointToPoint's.
+GALOIS_EXPORT Result<double> SsspPointToPointLandmarks(
+    graphs::PropertyFileGraph* pfg, size_t source, size_t target,
+    const std::string& edge_weight_property_name,
+    const std::string& landmark_property_prefix);
+
 /// Compute the Single-Source Shortest Path for pg start from start_node.
 /// The edge weights are the edge data and the computed path lengths are stored
 /// in the edge data. The algorithm and delta stepping parameter can be
@@ -185,16 +370,47 @@ struct SsspImplementation : public galois::analytics::BfsSsspImplementationBase<
   static constexpr unsigned kChunkSize = 64;
   static constexpr Dist kDistanceInfinity = Base::kDistanceInfinity;
 
+  /// If set, the destinations and weights of the edges are read from these
+  /// inline edges of the graph rather than from the graph
+  /// (\see SsspPlan::WithInlineEdges)
+  const graphs::InlineEdgeIndex::Edge<Weight>* inline_edges{nullptr};
+
+  /// The destination and the weight of edge e
+  std::pair<typename Graph::Node, Weight> ReadEdge(
+      const Graph& graph, const typename Graph::edge_iterator& e) const {
+    if (inline_edges != nullptr) {
+      const auto& edge = inline_edges[*e];
+      return std::make_pair(edge.dest, edge.value);
+    }
+    return std::make_pair(
+        *graph.GetEdgeDest(e), graph.template GetEdgeData<EdgeWeight>(e));
+  }
+
   using PSchunk = galois::worklists::PerSocketChunkFIFO<kChunkSize>;
   using OBIM =
       galois::worklists::OrderedByIntegerMetric<UpdateRequestIndexer, PSchunk>;
   using OBIMBarrier = typename galois::worklists::OrderedByIntegerMetric<
       UpdateRequestIndexer, PSchunk>::template with_barrier<true>::type;
 
+  using MultiQueue = galois::worklists::MultiQueue<std::less<UpdateRequest>>;
+  using PMOD = galois::worklists::AdaptiveOrderedByIntegerMetric<
+      UpdateRequestIndexer, PSchunk>;
+
   template <typename T, typename OBIMTy = OBIM, typename P, typename R>
-  static void DeltaStepAlgo(
+  void DeltaStepAlgo(
       Graph* graph, const typename Graph::Node& source, const P& pushWrap,
       const R& edgeRange, unsigned stepShift) {
+    PriorityAlgo<T>(
+        graph, source, pushWrap, edgeRange,
+        galois::wl<OBIMTy>(UpdateRequestIndexer{stepShift}));
+  }
+
+  /// Asynchronous SSSP that pops requests from the priority worklist of
+  /// wl_tag
+  template <typename T, typename P, typename R, typename WLTag>
+  void PriorityAlgo(
+      Graph* graph, const typename Graph::Node& source, const P& pushWrap,
+      const R& edgeRange, const WLTag& wl_tag) {
     //! [reducible for self-defined stats]
     galois::GAccumulator<size_t> BadWork;
     //! [reducible for self-defined stats]
@@ -217,9 +433,8 @@ struct SsspImplementation : public galois::analytics::BfsSsspImplementationBase<
           }
 
           for (auto ii : edgeRange(item)) {
-            auto dest = graph->GetEdgeDest(ii);
+            auto [dest, ew] = ReadEdge(*graph, ii);
             auto& ddist = graph->template GetData<NodeDistance>(dest);
-            Dist ew = graph->template GetEdgeData<EdgeWeight>(ii);
             const Dist new_dist = sdata + ew;
             Dist old_dist = galois::atomicMin(ddist, new_dist);
             if (new_dist < old_dist) {
@@ -230,12 +445,11 @@ struct SsspImplementation : public galois::analytics::BfsSsspImplementationBase<
                 }
                 //! [per-thread contribution of self-defined stats]
               }
-              pushWrap(ctx, *dest, new_dist);
+              pushWrap(ctx, dest, new_dist);
             }
           }
         },
-        galois::wl<OBIMTy>(UpdateRequestIndexer{stepShift}),
-        galois::disable_conflict_detection(), galois::loopname("SSSP"));
+        wl_tag, galois::disable_conflict_detection(), galois::loopname("SSSP"));
 
     if (kTrackWork) {
       //! [report self-defined stats]
@@ -245,8 +459,135 @@ struct SsspImplementation : public galois::analytics::BfsSsspImplementationBase<
     }
   }
 
+  /// EstimateDeltaShift returns the log2 of the bucket width for
+  /// SsspPlan::kAdaptiveDelta from a sample of the edge weights
+  static unsigned EstimateDeltaShift(const Graph& graph) {
+    constexpr uint64_t kMaxSamples = 1U << 16;
+
+    uint64_t num_edges = graph.num_edges();
+    if (num_edges == 0 || graph.num_nodes() == 0) {
+      return 0;
+    }
+    uint64_t stride = std::max<uint64_t>(1, num_edges / kMaxSamples);
+
+    galois::GAccumulator<double> weight_sum;
+    galois::GAccumulator<uint64_t> num_samples;
+    galois::do_all(
+        galois::iterate(uint64_t{0}, (num_edges + stride - 1) / stride),
+        [&](uint64_t i) {
+          typename Graph::edge_iterator e(i * stride);
+          weight_sum += std::abs(
+              static_cast<double>(graph.template GetEdgeData<EdgeWeight>(e)));
+          num_samples += 1;
+        },
+        galois::no_stats());
+
+    double mean_weight = weight_sum.reduce() / num_samples.reduce();
+    double mean_degree = static_cast<double>(num_edges) / graph.num_nodes();
+    return SsspPlan::AdaptiveDeltaShift(mean_weight, mean_degree);
+  }
+
+  void DeltaStepFusionAlgo(
+      Graph* graph, const typename Graph::Node& source, unsigned stepShift) {
+    // Nodes whose distances were lowered into bucket i by this thread
+    using Buckets = std::vector<std::vector<typename Graph::Node>>;
+    // Past this many nodes, a thread's local work in the current bucket goes
+    // back to the shared frontier so that other threads can steal it
+    constexpr size_t kFusionLimit = 1000;
+
+    UpdateRequestIndexer indexer{stepShift};
+    auto bucket_of = [&](Dist d) -> size_t {
+      return indexer(UpdateRequest{typename Graph::Node{}, d});
+    };
+
+    galois::substrate::PerThreadStorage<Buckets> local_buckets;
+    galois::InsertBag<typename Graph::Node> frontier;
+
+    graph->template GetData<NodeDistance>(source) = 0;
+    frontier.push(source);
+
+    size_t curr_bucket = 0;
+    size_t rounds = 0;
+
+    while (true) {
+      ++rounds;
+
+      galois::do_all(
+          galois::iterate(frontier),
+          [&](const typename Graph::Node& node) {
+            Buckets& buckets = *local_buckets.getLocal();
+            std::vector<typename Graph::Node> local{node};
+
+            while (!local.empty()) {
+              typename Graph::Node n = local.back();
+              local.pop_back();
+
+              const Dist sdata = graph->template GetData<NodeDistance>(n);
+              // settled in an earlier bucket or stale
+              if (bucket_of(sdata) != curr_bucket) {
+                continue;
+              }
+
+              for (auto e : graph->edges(n)) {
+                auto [dest, weight] = ReadEdge(*graph, e);
+                const Dist new_dist = sdata + weight;
+                auto& ddata = graph->template GetData<NodeDistance>(dest);
+                if (galois::atomicMin(ddata, new_dist) <= new_dist) {
+                  continue;
+                }
+                size_t b = bucket_of(new_dist);
+                if (b == curr_bucket && local.size() < kFusionLimit) {
+                  local.push_back(dest);
+                  continue;
+                }
+                if (b >= buckets.size()) {
+                  buckets.resize(b + 1);
+                }
+                buckets[b].push_back(dest);
+              }
+            }
+          },
+          galois::steal(), galois::loopname("DeltaStepFusion"));
+
+      frontier.clear();
+
+      galois::GReduceMin<size_t> next_bucket;
+      galois::on_each([&](unsigned, unsigned) {
+        Buckets& buckets = *local_buckets.getLocal();
+        for (size_t b = curr_bucket; b < buckets.size(); ++b) {
+          if (!buckets[b].empty()) {
+            next_bucket.update(b);
+            break;
+          }
+        }
+      });
+      curr_bucket = next_bucket.reduce();
+      if (curr_bucket == std::numeric_limits<size_t>::max()) {
+        break;
+      }
+
+      galois::GAccumulator<uint64_t> frontier_size;
+      galois::on_each([&](unsigned, unsigned) {
+        Buckets& buckets = *local_buckets.getLocal();
+        if (curr_bucket < buckets.size()) {
+          for (auto n : buckets[curr_bucket]) {
+            frontier.push(n);
+          }
+          frontier_size += buckets[curr_bucket].size();
+          buckets[curr_bucket].clear();
+          buckets[curr_bucket].shrink_to_fit();
+        }
+      });
+      if (internal::EndRound(frontier_size.reduce())) {
+        break;
+      }
+    }
+
+    galois::ReportStatSingle("SSSP-DeltaStepFusion", "rounds", rounds);
+  }
+
   template <typename T, typename P, typename R>
-  static void SerDeltaAlgo(
+  void SerDeltaAlgo(
       Graph* graph, const typename Graph::Node& source, const P& pushWrap,
       const R& edgeRange, unsigned stepShift) {
     SerialBucketWL<T, UpdateRequestIndexer> wl(UpdateRequestIndexer{stepShift});
@@ -270,15 +611,14 @@ struct SsspImplementation : public galois::analytics::BfsSsspImplementationBase<
         }
 
         for (auto e : edgeRange(item)) {
-          auto dest = graph->GetEdgeDest(e);
+          auto [dest, weight] = ReadEdge(*graph, e);
           auto& ddata = graph->template GetData<NodeDistance>(dest);
 
-          const auto new_dist =
-              item.dist + graph->template GetEdgeData<EdgeWeight>(e);
+          const auto new_dist = item.dist + weight;
 
           if (new_dist < ddata) {
             ddata = new_dist;
-            pushWrap(wl, *dest, new_dist);
+            pushWrap(wl, dest, new_dist);
           }
         }
       }
@@ -293,7 +633,7 @@ struct SsspImplementation : public galois::analytics::BfsSsspImplementationBase<
   }
 
   template <typename T, typename P, typename R>
-  static void DijkstraAlgo(
+  void DijkstraAlgo(
       Graph* graph, const typename Graph::Node& source, const P& pushWrap,
       const R& edgeRange) {
     using WL = galois::MinHeap<T>;
@@ -316,15 +656,14 @@ struct SsspImplementation : public galois::analytics::BfsSsspImplementationBase<
       }
 
       for (auto e : edgeRange(item)) {
-        auto dest = graph->GetEdgeDest(e);
+        auto [dest, weight] = ReadEdge(*graph, e);
         auto& ddata = graph->template GetData<NodeDistance>(dest);
 
-        const auto new_dist =
-            item.dist + graph->template GetEdgeData<EdgeWeight>(e);
+        const auto new_dist = item.dist + weight;
 
         if (new_dist < ddata) {
           ddata = new_dist;
-          pushWrap(wl, *dest, new_dist);
+          pushWrap(wl, dest, new_dist);
         }
       }
     }
@@ -332,45 +671,48 @@ struct SsspImplementation : public galois::analytics::BfsSsspImplementationBase<
     galois::ReportStatSingle("SSSP-Dijkstra", "Iterations", iter);
   }
 
-  static void TopoAlgo(Graph* graph, const typename Graph::Node& source) {
-    galois::LargeArray<Dist> old_dist;
-    old_dist.allocateInterleaved(graph->size());
+  void TopoAlgo(
+      Graph* graph, const typename Graph::Node& source,
+      uint32_t dense_frontier_divisor) {
+    using Frontier = typename Base::Frontier;
 
-    galois::do_all(
-        galois::iterate(size_t{0}, graph->size()),
-        [&](size_t i) { old_dist.constructAt(i, kDistanceInfinity); },
-        galois::no_stats(), galois::loopname("initDistArray"));
+    Frontier frontier_a{graph};
+    Frontier frontier_b{graph};
+    Frontier* curr = &frontier_a;
+    Frontier* next = &frontier_b;
 
     graph->template GetData<NodeDistance>(source) = 0;
+    curr->Push(source);
+    curr->Finish();
 
-    galois::GReduceLogicalOr changed;
     size_t rounds = 0;
 
-    do {
+    while (!curr->empty()) {
       ++rounds;
-      changed.reset();
+      next->Reset(curr->NextIsDense(dense_frontier_divisor));
 
-      galois::do_all(
-          galois::iterate(*graph),
+      curr->ForEach(
           [&](const typename Graph::Node& n) {
-            const auto& sdata = graph->template GetData<NodeDistance>(n);
-
-            if (old_dist[n] > sdata) {
-              old_dist[n] = sdata;
-              changed.update(true);
-
-              for (auto e : graph->edges(n)) {
-                const Weight new_dist =
-                    sdata + graph->template GetEdgeData<EdgeWeight>(e);
-                auto dest = graph->GetEdgeDest(e);
-                auto& ddata = graph->template GetData<NodeDistance>(dest);
-                galois::atomicMin(ddata, new_dist);
+            const Weight sdata = graph->template GetData<NodeDistance>(n);
+
+            for (auto e : graph->edges(n)) {
+              auto [dest, weight] = ReadEdge(*graph, e);
+              const Weight new_dist = sdata + weight;
+              auto& ddata = graph->template GetData<NodeDistance>(dest);
+              if (galois::atomicMin(ddata, new_dist) > new_dist) {
+                next->Push(dest);
               }
             }
           },
-          galois::steal(), galois::loopname("Update"));
+          "Update");
+
+      next->Finish();
+      std::swap(curr, next);
 
-    } while (changed.reduce());
+      if (internal::EndRound(curr->size())) {
+        break;
+      }
+    }
 
     galois::ReportStatSingle("SSSP-Topo", "rounds", rounds);
   }
@@ -389,11 +731,13 @@ struct SsspImplementation : public galois::analytics::BfsSsspImplementationBase<
         galois::steal(), galois::loopname("MakeTiles"));
 
     galois::GReduceLogicalOr changed;
+    galois::GAccumulator<uint64_t> updated;
     size_t rounds = 0;
 
     do {
       ++rounds;
       changed.reset();
+      updated.reset();
 
       galois::do_all(
           galois::iterate(tiles),
@@ -403,11 +747,11 @@ struct SsspImplementation : public galois::analytics::BfsSsspImplementationBase<
             if (t.dist > sdata) {
               t.dist = sdata;
               changed.update(true);
+              updated += 1;
 
               for (auto e = t.beg; e != t.end; ++e) {
-                const Weight new_dist =
-                    sdata + graph->template GetEdgeData<EdgeWeight>(e);
-                auto dest = graph->GetEdgeDest(e);
+                auto [dest, weight] = ReadEdge(*graph, e);
+                const Weight new_dist = sdata + weight;
                 auto& ddata = graph->template GetData<NodeDistance>(dest);
                 galois::atomicMin(ddata, new_dist);
               }
@@ -415,13 +759,16 @@ struct SsspImplementation : public galois::analytics::BfsSsspImplementationBase<
           },
           galois::steal(), galois::loopname("Update"));
 
-    } while (changed.reduce());
+    } while (changed.reduce() && !internal::EndRound(updated.reduce()));
 
     galois::ReportStatSingle("SSSP-Topo", "rounds", rounds);
   }
 
 public:
   galois::Result<void> SSSP(Graph& graph, size_t start_node, SsspPlan plan) {
+    if (plan.architecture() != kCPU) {
+      return galois::ErrorCode::NotImplemented;
+    }
     if (start_node >= graph.size()) {
       return galois::ErrorCode::InvalidArgument;
     }
@@ -446,25 +793,30 @@ public:
     if (plan.algorithm() == SsspPlan::kAutomatic) {
       plan = SsspPlan::Automatic(&graph.GetPropertyFileGraph());
     }
+    unsigned delta = plan.delta();
+    if (delta == SsspPlan::kAdaptiveDelta) {
+      delta = EstimateDeltaShift(graph);
+      galois::ReportStatSingle("SSSP", "DeltaShift", delta);
+    }
 
     switch (plan.algorithm()) {
     case SsspPlan::kDeltaTile:
       DeltaStepAlgo<SrcEdgeTile>(
           &graph, source, SrcEdgeTilePushWrap{&graph, *this}, TileRangeFn(),
-          plan.delta());
+          delta);
       break;
     case SsspPlan::kDeltaStep:
       DeltaStepAlgo<UpdateRequest>(
-          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph}, plan.delta());
+          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph}, delta);
       break;
     case SsspPlan::kSerialDeltaTile:
       SerDeltaAlgo<SrcEdgeTile>(
           &graph, source, SrcEdgeTilePushWrap{&graph, *this}, TileRangeFn(),
-          plan.delta());
+          delta);
       break;
     case SsspPlan::kSerialDelta:
       SerDeltaAlgo<UpdateRequest>(
-          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph}, plan.delta());
+          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph}, delta);
       break;
     case SsspPlan::kDijkstraTile:
       DijkstraAlgo<SrcEdgeTile>(
@@ -475,14 +827,29 @@ public:
           &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph});
       break;
     case SsspPlan::kTopo:
-      TopoAlgo(&graph, source);
+      TopoAlgo(&graph, source, plan.dense_frontier_divisor());
       break;
     case SsspPlan::kTopoTile:
       TopoTileAlgo(&graph, source);
       break;
+    case SsspPlan::kDeltaStepFusion:
+      DeltaStepFusionAlgo(&graph, source, delta);
+      break;
     case SsspPlan::kDeltaStepBarrier:
       DeltaStepAlgo<UpdateRequest, OBIMBarrier>(
-          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph}, plan.delta());
+          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph}, delta);
+      break;
+    case SsspPlan::kDeltaStepPmod:
+      // the indexer keeps every distance apart; the worklist rounds them
+      PriorityAlgo<UpdateRequest>(
+          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph},
+          galois::wl<PMOD>(UpdateRequestIndexer{0}, delta));
+      break;
+    case SsspPlan::kMultiQueue:
+      PriorityAlgo<UpdateRequest>(
+          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph},
+          galois::wl<MultiQueue>(
+              std::less<UpdateRequest>(), plan.relaxation()));
       break;
     default:
       return galois::ErrorCode::InvalidArgument;
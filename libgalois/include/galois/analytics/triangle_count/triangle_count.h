@@ -0,0 +1,130 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_ANALYTICS_TRIANGLECOUNT_TRIANGLECOUNT_H_
+#define GALOIS_LIBGALOIS_GALOIS_ANALYTICS_TRIANGLECOUNT_TRIANGLECOUNT_H_
+
+#include "galois/analytics/Plan.h"
+#include "galois/analytics/Utils.h"
+
+namespace galois::analytics {
+
+/// A computational plan to for triangle counting, specifying the algorithm and
+/// any parameters associated with it.
+class TriangleCountPlan : Plan {
+public:
+  enum Algorithm {
+    kNodeIteration,
+    kEdgeIteration,
+    kOrderedCount,
+    kDegreeOrderedDag
+  };
+
+private:
+  Algorithm algorithm_;
+
+  TriangleCountPlan(Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  TriangleCountPlan() : TriangleCountPlan{kCPU, kDegreeOrderedDag} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Node Iterator: for each node v and each pair of neighbors a < v < b,
+  /// look for b among the neighbors of a with binary search (Schank, PhD
+  /// Thesis, Universitat Karlsruhe, 2007)
+  static TriangleCountPlan NodeIteration() { return {kCPU, kNodeIteration}; }
+
+  /// Edge Iterator: for each edge (a, b) with a < b, intersect the neighbors
+  /// of a and b between a and b (Schank, PhD Thesis, Universitat Karlsruhe,
+  /// 2007)
+  static TriangleCountPlan EdgeIteration() { return {kCPU, kEdgeIteration}; }
+
+  /// Like EdgeIteration, but merges the neighbors smaller than a and b in a
+  /// simple loop instead of searching them. Works best after relabeling nodes
+  /// by degree (\see SortNodesByDegree).
+  static TriangleCountPlan OrderedCount() { return {kCPU, kOrderedCount}; }
+
+  /// Orient each edge from the endpoint of smaller degree to the one of larger
+  /// degree, ties broken by node id, into a private sorted graph, then count
+  /// the common out-neighbors of the endpoints of each oriented edge with SIMD
+  /// intersections (\see CountSortedIntersection). Each node keeps at most
+  /// sqrt(2 * |E|) out-neighbors, which bounds the cost of the hubs of
+  /// power-law graphs without relabeling pfg. Takes about 4 bytes per edge.
+  static TriangleCountPlan DegreeOrderedDag() {
+    return {kCPU, kDegreeOrderedDag};
+  }
+
+  static TriangleCountPlan Automatic() { return {}; }
+};
+
+/// The tag for the per-node output property of triangle counting in
+/// PropertyGraphs.
+using TriangleCountNodeCount = galois::DensePODProperty<uint64_t>;
+
+/// The tag for the output property of the local clustering coefficient in
+/// PropertyGraphs.
+using LocalClusteringCoefficientNodeValue = galois::DensePODProperty<double>;
+
+/// Count the triangles of pfg, viewed as an undirected graph.
+///
+/// kDegreeOrderedDag accepts any graph: an edge in either direction is an
+/// undirected edge, and self loops and multi-edges are ignored. The other
+/// algorithms require that pfg be symmetric, without self loops or
+/// multi-edges, and that its edges be sorted by destination (\see
+/// SortAllEdgesByDest); they return InvalidArgument if the edges are not.
+/// pfg is not modified.
+GALOIS_EXPORT Result<uint64_t> TriangleCount(
+    graphs::PropertyFileGraph* pfg,
+    TriangleCountPlan plan = TriangleCountPlan::Automatic());
+
+/// Like TriangleCount, but also stores the number of triangles each node is
+/// part of in a property named by output_property_name. The counts come from
+/// the same pass as the total, which is a third of their sum.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call.
+GALOIS_EXPORT Result<uint64_t> TriangleCount(
+    graphs::PropertyFileGraph* pfg, const std::string& output_property_name,
+    TriangleCountPlan plan = TriangleCountPlan::Automatic());
+
+/// Compute the local clustering coefficient of each node of pfg, the number of
+/// triangles it is part of divided by the number of pairs of its neighbors,
+/// from one triangle counting pass with plan. Nodes with fewer than two
+/// neighbors have a coefficient of 0. The requirements on pfg are those of
+/// TriangleCount; the degree of a node in the undirected graph is its number
+/// of distinct neighbors other than itself. The result is stored in a property
+/// named by output_property_name.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call.
+GALOIS_EXPORT Result<void> LocalClusteringCoefficient(
+    graphs::PropertyFileGraph* pfg, const std::string& output_property_name,
+    TriangleCountPlan plan = TriangleCountPlan::Automatic());
+
+/// An estimate of the number of triangles of a graph and a confidence interval
+/// around it.
+struct TriangleCountEstimate {
+  double estimate;
+  double lower_bound;
+  double upper_bound;
+};
+
+/// Estimate the number of triangles of pfg by wedge sampling (Seshadhri et al.,
+/// SDM '13): draw num_samples paths of length two, each with probability
+/// proportional to the number of such paths centered at its middle node, and
+/// scale the fraction of them closed by an edge to the number of paths in
+/// pfg. The cost is one pass over the nodes plus a neighbor lookup per
+/// sample, independent of the number of triangles. The true count lies in
+/// [lower_bound, upper_bound] with probability at least confidence, by the
+/// Hoeffding bound on the closed fraction. The estimate, its bounds and the
+/// number of samples are also reported as statistics of the
+/// "TriangleCountEstimate" region.
+///
+/// pfg must be symmetric, without self loops or multi-edges. Lookups use
+/// binary search if its edges are sorted by destination (\see
+/// SortAllEdgesByDest) and a scan otherwise. Samples are drawn from seed in
+/// blocks, so the estimate does not depend on the number of threads.
+GALOIS_EXPORT Result<TriangleCountEstimate> EstimateTriangleCount(
+    graphs::PropertyFileGraph* pfg, uint64_t num_samples,
+    double confidence = 0.95, uint64_t seed = 0);
+
+}  // namespace galois::analytics
+
+#endif
@@ -26,8 +26,16 @@
 #ifndef GALOIS_LIBGALOIS_GALOIS_GRAPHS_BUFFEREDGRAPH_H_
 #define GALOIS_LIBGALOIS_GALOIS_GRAPHS_BUFFEREDGRAPH_H_
 
-#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "galois/Loops.h"
 #include "galois/Reduction.h"
 #include "galois/config.h"
 #include "galois/gIO.h"
@@ -81,16 +89,83 @@ private:
   //! number of bytes read related to the edge data buffer
   galois::GAccumulator<uint64_t> numBytesReadEdgeData;
 
+  //! A range of the graph file to read into a buffer
+  struct ReadRequest {
+    char* buffer;
+    uint64_t offset;
+    uint64_t size;
+  };
+
+  //! Largest single pread issued; bigger ranges are split so that their
+  //! parts are read concurrently
+  static constexpr uint64_t kMaxReadSize = UINT64_C(8) << 20;
+
+  //! Reads queued by the load functions until readAll issues them
+  std::vector<ReadRequest> readRequests;
+
+  /**
+   * Queue a read of size bytes of the file at offset into buffer.
+   */
+  void addRead(void* buffer, uint64_t offset, uint64_t size) {
+    char* dst = static_cast<char*>(buffer);
+    for (uint64_t done = 0; done < size; done += kMaxReadSize) {
+      readRequests.emplace_back(ReadRequest{
+          dst + done, offset + done, std::min(kMaxReadSize, size - done)});
+    }
+  }
+
+  /**
+   * Read a whole request, retrying on partial reads.
+   */
+  static void readFully(int fd, const ReadRequest& request) {
+    uint64_t done = 0;
+    while (done < request.size) {
+      ssize_t ret = pread(
+          fd, request.buffer + done, request.size - done,
+          request.offset + done);
+      if (ret < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        GALOIS_DIE("failed to read graph: ", std::strerror(errno));
+      }
+      if (ret == 0) {
+        GALOIS_DIE("graph file is shorter than its header says");
+      }
+      done += ret;
+    }
+  }
+
+  /**
+   * Issue the queued reads of all buffers concurrently, one pread per
+   * request, so that the reads of the three buffers and of the parts of each
+   * overlap. Each buffer page is first touched by the thread that reads it.
+   */
+  void readAll(int fd) {
+    galois::do_all(
+        galois::iterate(readRequests),
+        [&](const ReadRequest& request) { readFully(fd, request); },
+        galois::steal(), galois::no_stats(),
+        galois::loopname("BufferedGraphRead"));
+    readRequests.clear();
+  }
+
+  static int openGraph(const std::string& filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+      GALOIS_DIE("failed to open ", filename, ": ", std::strerror(errno));
+    }
+    return fd;
+  }
+
   /**
-   * Load the out indices (i.e. where a particular node's edges begin in the
-   * array of edges) from the file.
+   * Queue the read of the out indices (i.e. where a particular node's edges
+   * begin in the array of edges).
    *
-   * @param graphFile loaded file for the graph
    * @param nodeStart the first node to load
    * @param numNodesToLoad number of nodes to load
    */
-  void loadOutIndex(
-      std::ifstream& graphFile, uint64_t nodeStart, uint64_t numNodesToLoad) {
+  void loadOutIndex(uint64_t nodeStart, uint64_t numNodesToLoad) {
     if (numNodesToLoad == 0) {
       return;
     }
@@ -103,35 +178,21 @@ private:
 
     // position to start of contiguous chunk of nodes to read
     uint64_t readPosition = (4 + nodeStart) * sizeof(uint64_t);
-    graphFile.seekg(readPosition);
-
-    uint64_t numBytesToLoad = numNodesToLoad * sizeof(uint64_t);
-    uint64_t bytesRead = 0;
-
-    while (numBytesToLoad > 0) {
-      graphFile.read(((char*)this->outIndexBuffer) + bytesRead, numBytesToLoad);
-      size_t numRead = graphFile.gcount();
-      numBytesToLoad -= numRead;
-      bytesRead += numRead;
-    }
-
-    assert(numBytesToLoad == 0);
+    addRead(outIndexBuffer, readPosition, numNodesToLoad * sizeof(uint64_t));
 
     nodeOffset = nodeStart;
   }
 
   /**
-   * Load the edge destination information from the file.
+   * Queue the read of the edge destination information.
    *
-   * @param graphFile loaded file for the graph
    * @param edgeStart the first edge to load
    * @param numEdgesToLoad number of edges to load
    * @param numGlobalNodes total number of nodes in the graph file; needed
    * to determine offset into the file
    */
   void loadEdgeDest(
-      std::ifstream& graphFile, uint64_t edgeStart, uint64_t numEdgesToLoad,
-      uint64_t numGlobalNodes) {
+      uint64_t edgeStart, uint64_t numEdgesToLoad, uint64_t numGlobalNodes) {
     if (numEdgesToLoad == 0) {
       return;
     }
@@ -146,24 +207,14 @@ private:
     // position to start of contiguous chunk of edges to read
     uint64_t readPosition = (4 + numGlobalNodes) * sizeof(uint64_t) +
                             (sizeof(uint32_t) * edgeStart);
-    graphFile.seekg(readPosition);
-
-    uint64_t numBytesToLoad = numEdgesToLoad * sizeof(uint32_t);
-    uint64_t bytesRead = 0;
-    while (numBytesToLoad > 0) {
-      graphFile.read(((char*)this->edgeDestBuffer) + bytesRead, numBytesToLoad);
-      size_t numRead = graphFile.gcount();
-      numBytesToLoad -= numRead;
-      bytesRead += numRead;
-    }
+    addRead(edgeDestBuffer, readPosition, numEdgesToLoad * sizeof(uint32_t));
 
-    assert(numBytesToLoad == 0);
     // save edge offset of this graph for later use
     edgeOffset = edgeStart;
   }
 
   /**
-   * Load the edge data information from the file.
+   * Queue the read of the edge data information.
    *
    * @tparam EdgeType must be non-void in order to call this function
    *
@@ -178,8 +229,8 @@ private:
       typename EdgeType,
       typename std::enable_if<!std::is_void<EdgeType>::value>::type* = nullptr>
   void loadEdgeData(
-      std::ifstream& graphFile, uint64_t edgeStart, uint64_t numEdgesToLoad,
-      uint64_t numGlobalNodes, uint64_t numGlobalEdges) {
+      uint64_t edgeStart, uint64_t numEdgesToLoad, uint64_t numGlobalNodes,
+      uint64_t numGlobalEdges) {
     galois::gDebug("Loading edge data");
 
     if (numEdgesToLoad == 0) {
@@ -206,18 +257,8 @@ private:
     // jump to first byte of edge data
     uint64_t readPosition =
         baseReadPosition + (sizeof(EdgeDataType) * edgeStart);
-    graphFile.seekg(readPosition);
-    uint64_t numBytesToLoad = numEdgesToLoad * sizeof(EdgeDataType);
-    uint64_t bytesRead = 0;
-
-    while (numBytesToLoad > 0) {
-      graphFile.read(((char*)this->edgeDataBuffer) + bytesRead, numBytesToLoad);
-      size_t numRead = graphFile.gcount();
-      numBytesToLoad -= numRead;
-      bytesRead += numRead;
-    }
-
-    assert(numBytesToLoad == 0);
+    addRead(
+        edgeDataBuffer, readPosition, numEdgesToLoad * sizeof(EdgeDataType));
   }
 
   /**
@@ -231,7 +272,7 @@ private:
   template <
       typename EdgeType,
       typename std::enable_if<std::is_void<EdgeType>::value>::type* = nullptr>
-  void loadEdgeData(std::ifstream&, uint64_t, uint64_t, uint64_t, uint64_t) {
+  void loadEdgeData(uint64_t, uint64_t, uint64_t, uint64_t) {
     galois::gDebug("Not loading edge data");
     // do nothing (edge data is void, i.e. no edge data)
   }
@@ -316,26 +357,27 @@ public:
       GALOIS_DIE("Cannot load an buffered graph more than once.");
     }
 
-    std::ifstream graphFile(filename.c_str());
+    int fd = openGraph(filename);
     uint64_t header[4];
-    graphFile.read(((char*)header), sizeof(uint64_t) * 4);
+    readFully(
+        fd, ReadRequest{reinterpret_cast<char*>(header), 0, sizeof(header)});
 
     numLocalNodes = globalSize = header[2];
     numLocalEdges = globalEdgeSize = header[3];
 
-    loadOutIndex(graphFile, 0, globalSize);
-    loadEdgeDest(graphFile, 0, globalEdgeSize, globalSize);
+    loadOutIndex(0, globalSize);
+    loadEdgeDest(0, globalEdgeSize, globalSize);
     // may or may not do something depending on EdgeDataType
-    loadEdgeData<EdgeDataType>(
-        graphFile, 0, globalEdgeSize, globalSize, globalEdgeSize);
+    loadEdgeData<EdgeDataType>(0, globalEdgeSize, globalSize, globalEdgeSize);
+    readAll(fd);
     graphLoaded = true;
 
-    graphFile.close();
+    close(fd);
   }
 
   /**
    * Given a node/edge range to load, loads the specified portion of the graph
-   * into memory buffers using read.
+   * into memory buffers using concurrent preads.
    *
    * @param filename name of graph to load; should be in Galois binary graph
    * format
@@ -355,25 +397,26 @@ public:
       GALOIS_DIE("Cannot load an buffered graph more than once.");
     }
 
-    std::ifstream graphFile(filename.c_str());
+    int fd = openGraph(filename);
 
     globalSize = numGlobalNodes;
     globalEdgeSize = numGlobalEdges;
 
     assert(nodeEnd >= nodeStart);
     numLocalNodes = nodeEnd - nodeStart;
-    loadOutIndex(graphFile, nodeStart, numLocalNodes);
+    loadOutIndex(nodeStart, numLocalNodes);
 
     assert(edgeEnd >= edgeStart);
     numLocalEdges = edgeEnd - edgeStart;
-    loadEdgeDest(graphFile, edgeStart, numLocalEdges, numGlobalNodes);
+    loadEdgeDest(edgeStart, numLocalEdges, numGlobalNodes);
 
     // may or may not do something depending on EdgeDataType
     loadEdgeData<EdgeDataType>(
-        graphFile, edgeStart, numLocalEdges, numGlobalNodes, numGlobalEdges);
+        edgeStart, numLocalEdges, numGlobalNodes, numGlobalEdges);
+    readAll(fd);
     graphLoaded = true;
 
-    graphFile.close();
+    close(fd);
   }
 
   /**
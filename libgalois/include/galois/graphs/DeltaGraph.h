@@ -0,0 +1,208 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_GRAPHS_DELTAGRAPH_H_
+#define GALOIS_LIBGALOIS_GALOIS_GRAPHS_DELTAGRAPH_H_
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+
+#include "galois/DynamicBitset.h"
+#include "galois/NoDerefIterator.h"
+#include "galois/OpLog.h"
+#include "galois/Result.h"
+#include "galois/config.h"
+#include "galois/graphs/Details.h"
+#include "galois/graphs/PropertyFileGraph.h"
+
+namespace galois::graphs {
+
+/// A DeltaGraph is a graph that takes node and edge inserts and deletes on
+/// top of the immutable topology of a PropertyFileGraph, the base, so that
+/// analytics can run on an updated graph between rebuilds of its CSR.
+///
+/// Each node has the edges of the base that were not deleted, which are
+/// marked in a bitset, followed by a list of the edges inserted since. Edge
+/// ids below base_num_edges() are the ids of base edges and the others
+/// number the inserted edges; ids are stable until Compact and deleted ids
+/// are not reused. Deleted nodes keep their ids but lose all their edges;
+/// inserted nodes get the ids that follow.
+///
+/// A DeltaGraph has the iteration interface of PropertyGraph (begin, end,
+/// edges, GetEdgeDest, ...), and galois::iterate accepts it. It may be read
+/// in parallel but not while Apply runs. The base must outlive it.
+class GALOIS_EXPORT DeltaGraph {
+public:
+  /// The base_edge of an inserted edge
+  static constexpr uint64_t kNoBaseEdge = std::numeric_limits<uint64_t>::max();
+
+  class EdgeIterator;
+
+  using node_iterator = boost::counting_iterator<uint32_t>;
+  using edge_iterator = EdgeIterator;
+  using edges_iterator = StandardRange<NoDerefIterator<edge_iterator>>;
+  using iterator = node_iterator;
+  using Node = uint32_t;
+
+  /// EdgeIterator visits the live edges of a node: *it is an edge id
+  class EdgeIterator
+      : public boost::iterator_facade<
+            EdgeIterator, uint64_t, boost::forward_traversal_tag, uint64_t> {
+  public:
+    EdgeIterator() = default;
+
+  private:
+    friend class boost::iterator_core_access;
+    friend class DeltaGraph;
+
+    // Positions below base_end are base edge ids; position base_end + i is
+    // the i-th inserted edge of the node
+    EdgeIterator(
+        const DeltaGraph* graph, Node node, uint64_t position,
+        uint64_t base_end)
+        : graph_(graph), node_(node), position_(position), base_end_(base_end) {
+      SkipDeleted();
+    }
+
+    void SkipDeleted() {
+      while (position_ < base_end_ && graph_->deleted_edges_.test(position_)) {
+        ++position_;
+      }
+    }
+
+    void increment() {
+      ++position_;
+      SkipDeleted();
+    }
+
+    bool equal(const EdgeIterator& other) const {
+      return position_ == other.position_;
+    }
+
+    uint64_t dereference() const {
+      if (position_ < base_end_) {
+        return position_;
+      }
+      return graph_->inserted_[node_][position_ - base_end_];
+    }
+
+    const DeltaGraph* graph_{nullptr};
+    Node node_{0};
+    uint64_t position_{0};
+    uint64_t base_end_{0};
+  };
+
+  /// Make returns an overlay of base without changes
+  static Result<std::unique_ptr<DeltaGraph>> Make(
+      const PropertyFileGraph* base);
+
+  // Standard container concepts
+
+  node_iterator begin() const { return node_iterator(0); }
+
+  node_iterator end() const { return node_iterator(num_nodes()); }
+
+  size_t size() const { return num_nodes(); }
+
+  bool empty() const { return num_nodes() == 0; }
+
+  // Graph accessors
+
+  /// The number of nodes, including the deleted ones
+  uint64_t num_nodes() const { return inserted_.size(); }
+
+  /// The number of live edges
+  uint64_t num_edges() const { return num_edges_; }
+
+  uint64_t base_num_edges() const { return base_->topology().num_edges(); }
+
+  /// The number of edges inserted since Make, including the deleted ones
+  uint64_t num_inserted_edges() const { return inserted_dests_.size(); }
+
+  /// The number of base edges deleted since Make
+  uint64_t num_deleted_base_edges() const { return num_deleted_base_edges_; }
+
+  bool IsDeleted(Node node) const { return deleted_nodes_[node] != 0; }
+
+  edges_iterator edges(const node_iterator& node) const {
+    uint64_t base_end = 0;
+    uint64_t position = 0;
+    if (*node < base_->topology().num_nodes()) {
+      std::tie(position, base_end) = base_->topology().edge_range(*node);
+    } else {
+      position = base_end = base_num_edges();
+    }
+    return internal::make_no_deref_range(
+        EdgeIterator(this, *node, position, base_end),
+        EdgeIterator(
+            this, *node, base_end + inserted_[*node].size(), base_end));
+  }
+
+  edge_iterator edge_begin(Node node) const { return *edges(node).begin(); }
+
+  edge_iterator edge_end(Node node) const { return *edges(node).end(); }
+
+  node_iterator GetEdgeDest(const edge_iterator& edge) const {
+    uint64_t id = *edge;
+    if (id < base_num_edges()) {
+      return node_iterator(base_->topology().out_dests->Value(id));
+    }
+    return node_iterator(inserted_dests_[id - base_num_edges()]);
+  }
+
+  /// The id in the base of edge, to read its base properties, or kNoBaseEdge
+  /// if it was inserted
+  uint64_t base_edge(const edge_iterator& edge) const {
+    return *edge < base_num_edges() ? *edge : kNoBaseEdge;
+  }
+
+  const PropertyFileGraph& base() const { return *base_; }
+
+  /// Apply plays the topology operations of log from index begin on, in
+  /// order. kOpNodeAdd inserts a node; kOpNodeDel deletes the node whose id
+  /// is the id of its key. kOpEdgeAdd inserts an edge and kOpEdgeDel deletes
+  /// every live edge between the nodes named by the id of its key, written
+  /// "src:dst" (\see EdgeOpId). Operations on deleted or unknown nodes are
+  /// ignored, as are property operations, which GraphUpdate merges into a
+  /// PropertyFileGraph.
+  ///
+  /// Edge operations are applied in parallel, grouped by source.
+  ///
+  /// \returns InvalidArgument if an edge id is not of the form "src:dst" or
+  /// if there would be more nodes than fit in a Node
+  Result<void> Apply(const OpLog& log, uint64_t begin = 0);
+
+  /// Compact builds a new PropertyFileGraph of the live nodes and edges in
+  /// parallel. The nodes that were not deleted keep their order and are
+  /// numbered from 0, and the edges of each node keep their order. The
+  /// properties of base are carried over; inserted nodes and edges have
+  /// nulls.
+  Result<std::unique_ptr<PropertyFileGraph>> Compact() const;
+
+private:
+  explicit DeltaGraph(const PropertyFileGraph* base);
+
+  const PropertyFileGraph* base_;
+  /// The base edges deleted since Make
+  galois::DynamicBitset deleted_edges_;
+  /// deleted_nodes_[n] is nonzero if node n was deleted
+  std::vector<uint8_t> deleted_nodes_;
+  /// The live inserted edges of each node, in insertion order
+  std::vector<std::vector<uint64_t>> inserted_;
+  /// The destination of each inserted edge
+  std::vector<uint32_t> inserted_dests_;
+  uint64_t num_edges_{0};
+  uint64_t num_deleted_base_edges_{0};
+};
+
+/// EdgeOpId returns the key id that names the edges from src to dst in the
+/// kOpEdgeAdd and kOpEdgeDel operations of an OpLog
+GALOIS_EXPORT std::string EdgeOpId(uint32_t src, uint32_t dst);
+
+}  // namespace galois::graphs
+
+#endif
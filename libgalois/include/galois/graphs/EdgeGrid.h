@@ -0,0 +1,112 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_GRAPHS_EDGEGRID_H_
+#define GALOIS_LIBGALOIS_GALOIS_GRAPHS_EDGEGRID_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "galois/Galois.h"
+#include "galois/Result.h"
+#include "galois/Uri.h"
+#include "galois/config.h"
+#include "galois/graphs/PropertyFileGraph.h"
+
+namespace galois::graphs {
+
+/// An EdgeGrid is the edges of a graph stored for out-of-core, edge-centric
+/// processing in the manner of GridGraph: the nodes are split into
+/// num_intervals() intervals of consecutive ids and block (i, j) holds the
+/// edges from interval i to interval j as (src, dst) pairs, in one file per
+/// block. Only the node values of an algorithm and two blocks need fit in
+/// memory.
+///
+/// StreamEdges reads the blocks one after another with tsuba, fetching the
+/// next block while the edges of the current one are processed in parallel,
+/// so that I/O overlaps computation.
+class GALOIS_EXPORT EdgeGrid {
+public:
+  struct Edge {
+    uint32_t src;
+    uint32_t dst;
+  };
+
+  /// Called with the edges of one block; a BlockFn must not keep them
+  using BlockFn = std::function<void(
+      uint32_t src_interval, uint32_t dst_interval, const Edge* edges,
+      uint64_t num_edges)>;
+
+  /// Write stores the edges of topology under dir as a grid of num_intervals
+  /// by num_intervals blocks, building the blocks of each source interval in
+  /// parallel
+  ///
+  /// \returns InvalidArgument if num_intervals is 0
+  static Result<void> Write(
+      const GraphTopology& topology, uint32_t num_intervals,
+      const galois::Uri& dir);
+
+  /// Open reads the description of the grid stored under dir by Write; the
+  /// blocks are read by StreamBlocks and StreamEdges
+  ///
+  /// \returns InvalidArgument if dir does not hold a grid
+  static Result<EdgeGrid> Open(const galois::Uri& dir);
+
+  uint64_t num_nodes() const { return num_nodes_; }
+  uint64_t num_edges() const { return num_edges_; }
+  uint32_t num_intervals() const { return num_intervals_; }
+
+  /// The first node of interval i; interval i ends where i + 1 begins
+  uint64_t interval_begin(uint32_t i) const {
+    return std::min<uint64_t>(
+        static_cast<uint64_t>(i) * interval_size_, num_nodes_);
+  }
+
+  /// The interval that node is in
+  uint32_t interval(uint32_t node) const { return node / interval_size_; }
+
+  /// The number of edges in block (i, j)
+  uint64_t block_size(uint32_t i, uint32_t j) const {
+    return block_sizes_[static_cast<uint64_t>(i) * num_intervals_ + j];
+  }
+
+  /// StreamBlocks calls fn with the edges of every nonempty block whose
+  /// source interval is active, column by column so that updates to the
+  /// values of the destinations of one interval are done together. The read
+  /// of the next block is started before fn is called on the current one.
+  ///
+  /// \param active_intervals if not empty, active_intervals[i] is nonzero if
+  /// the edges from interval i are to be read
+  Result<void> StreamBlocks(
+      const BlockFn& fn,
+      const std::vector<uint8_t>& active_intervals = {}) const;
+
+  /// StreamEdges calls fn(src, dst) for every edge of the blocks that
+  /// StreamBlocks reads, in parallel within each block
+  template <typename EdgeFn>
+  Result<void> StreamEdges(
+      const EdgeFn& fn,
+      const std::vector<uint8_t>& active_intervals = {}) const {
+    return StreamBlocks(
+        [&](uint32_t, uint32_t, const Edge* edges, uint64_t num_edges) {
+          galois::do_all(
+              galois::iterate(uint64_t{0}, num_edges),
+              [&](uint64_t e) { fn(edges[e].src, edges[e].dst); },
+              galois::no_stats(), galois::loopname("EdgeGridStreamEdges"));
+        },
+        active_intervals);
+  }
+
+private:
+  EdgeGrid() = default;
+
+  galois::Uri dir_;
+  uint64_t num_nodes_{0};
+  uint64_t num_edges_{0};
+  uint32_t num_intervals_{0};
+  uint64_t interval_size_{1};
+  std::vector<uint64_t> block_sizes_;
+};
+
+}  // namespace galois::graphs
+
+#endif
@@ -0,0 +1,234 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_GRAPHS_EDGELOOKUPINDEX_H_
+#define GALOIS_LIBGALOIS_GALOIS_GRAPHS_EDGELOOKUPINDEX_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/ParallelSTL.h"
+
+namespace galois::graphs {
+
+/**
+ * An index over the out-edges of a CSR graph that finds the edge from one
+ * node to another without scanning the edges of the source. Each node gets
+ * the cheapest lookup that is valid for it:
+ *
+ * - kHashed: nodes of at least hash_threshold edges get an open-addressing
+ *   table from destination to edge, so that lookups on hubs take constant
+ *   time whatever the order of their edges;
+ * - kSorted: other nodes whose edges turn out to be sorted by destination at
+ *   build time are searched by binary search;
+ * - kScan: the rest are scanned, which for few edges is as fast as either.
+ *
+ * The index refers to the arrays it was built from, which must outlive it,
+ * instead of copying them. It is only valid until the edges of the graph
+ * change; build it again after sorting or relabeling them.
+ *
+ * @tparam NodeId type of the edge destinations
+ */
+template <typename NodeId>
+class EdgeLookupIndex {
+public:
+  enum class Kind : uint8_t { kScan, kSorted, kHashed };
+
+  //! The default degree from which nodes get a hash table
+  static constexpr uint64_t kDefaultHashThreshold = 64;
+
+private:
+  //! A table slot: an edge as its destination and its offset from the first
+  //! edge of its source, or empty
+  struct Slot {
+    NodeId dest;
+    uint32_t offset;
+  };
+
+  static constexpr uint32_t kEmpty = std::numeric_limits<uint32_t>::max();
+
+  const uint64_t* out_indices_{nullptr};
+  const NodeId* dests_{nullptr};
+  uint64_t num_nodes_{0};
+  uint64_t hash_threshold_{kDefaultHashThreshold};
+  bool built_{false};
+
+  LargeArray<Kind> kinds_;
+  //! the first slot of the table of each node and, at num_nodes_, the end
+  LargeArray<uint64_t> table_offsets_;
+  LargeArray<Slot> slots_;
+
+  uint64_t first_edge(NodeId node) const {
+    return node == 0 ? 0 : out_indices_[node - 1];
+  }
+
+  //! Fibonacci hashing: the high bits of the product land in [0, capacity)
+  static uint64_t Hash(NodeId dest, uint64_t capacity) {
+    unsigned shift = 64 - __builtin_ctzll(capacity);
+    return (static_cast<uint64_t>(dest) * 0x9E3779B97F4A7C15ULL) >> shift;
+  }
+
+  //! Twice the degree rounded up to a power of two, so that tables are at
+  //! most half full
+  static uint64_t Capacity(uint64_t degree) {
+    uint64_t capacity = 2;
+    while (capacity < 2 * degree) {
+      capacity *= 2;
+    }
+    return capacity;
+  }
+
+  void Insert(NodeId node) {
+    uint64_t begin = first_edge(node);
+    uint64_t end = out_indices_[node];
+    Slot* table = slots_.data() + table_offsets_[node];
+    uint64_t capacity = table_offsets_[node + 1] - table_offsets_[node];
+    uint64_t mask = capacity - 1;
+
+    for (uint64_t i = 0; i < capacity; ++i) {
+      table[i].offset = kEmpty;
+    }
+    for (uint64_t e = begin; e < end; ++e) {
+      NodeId dest = dests_[e];
+      uint64_t i = Hash(dest, capacity);
+      // of multi-edges, the first one is found, as by a scan
+      while (table[i].offset != kEmpty && table[i].dest != dest) {
+        i = (i + 1) & mask;
+      }
+      if (table[i].offset == kEmpty) {
+        table[i] = Slot{dest, static_cast<uint32_t>(e - begin)};
+      }
+    }
+  }
+
+public:
+  /**
+   * Builds the index, in parallel, for the out-edges of num_nodes nodes in
+   * CSR format.
+   *
+   * @param out_indices the end of the edges of each node
+   * @param dests the destination of each edge
+   * @param hash_threshold the degree from which nodes get a hash table
+   */
+  void Build(
+      uint64_t num_nodes, const uint64_t* out_indices, const NodeId* dests,
+      uint64_t hash_threshold = kDefaultHashThreshold) {
+    clear();
+    out_indices_ = out_indices;
+    dests_ = dests;
+    num_nodes_ = num_nodes;
+    hash_threshold_ = std::max<uint64_t>(hash_threshold, 1);
+
+    kinds_.allocateInterleaved(num_nodes);
+    table_offsets_.allocateInterleaved(num_nodes + 1);
+    galois::do_all(
+        galois::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          uint64_t begin = first_edge(n);
+          uint64_t end = out_indices_[n];
+          uint64_t degree = end - begin;
+          uint64_t capacity = 0;
+          // offsets must fit a slot, and kEmpty is not one
+          if (degree >= hash_threshold_ && degree < kEmpty) {
+            kinds_[n] = Kind::kHashed;
+            capacity = Capacity(degree);
+          } else if (std::is_sorted(dests_ + begin, dests_ + end)) {
+            kinds_[n] = Kind::kSorted;
+          } else {
+            kinds_[n] = Kind::kScan;
+          }
+          table_offsets_[n] = capacity;
+        },
+        galois::steal(), galois::no_stats(),
+        galois::loopname("BuildEdgeLookup"));
+
+    uint64_t last = num_nodes == 0 ? 0 : table_offsets_[num_nodes - 1];
+    galois::ParallelSTL::exclusive_scan(
+        table_offsets_.begin(), table_offsets_.begin() + num_nodes,
+        table_offsets_.begin(), uint64_t{0});
+    table_offsets_[num_nodes] =
+        num_nodes == 0 ? 0 : table_offsets_[num_nodes - 1] + last;
+
+    slots_.allocateInterleaved(table_offsets_[num_nodes]);
+    galois::do_all(
+        galois::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          if (kinds_[n] == Kind::kHashed) {
+            Insert(n);
+          }
+        },
+        galois::steal(), galois::no_stats(),
+        galois::loopname("BuildEdgeLookupTables"));
+    built_ = true;
+  }
+
+  //! Drops the index
+  void clear() {
+    kinds_.destroy();
+    kinds_.deallocate();
+    table_offsets_.destroy();
+    table_offsets_.deallocate();
+    slots_.destroy();
+    slots_.deallocate();
+    out_indices_ = nullptr;
+    dests_ = nullptr;
+    num_nodes_ = 0;
+    built_ = false;
+  }
+
+  bool built() const { return built_; }
+
+  uint64_t hash_threshold() const { return hash_threshold_; }
+
+  Kind kind(NodeId node) const { return kinds_[node]; }
+
+  //! The number of nodes with each kind of lookup
+  uint64_t NumNodes(Kind kind) const {
+    return std::count(kinds_.begin(), kinds_.end(), kind);
+  }
+
+  /**
+   * Finds an edge from src to dst: the first one in edge order if src has
+   * several, except for sorted nodes, where it is the first one by binary
+   * search, which is also the first in edge order.
+   *
+   * @returns the id of the edge, or the end of the edges of src if there is
+   *     none
+   */
+  uint64_t Find(NodeId src, NodeId dst) const {
+    assert(built() && src < num_nodes_);
+    uint64_t begin = first_edge(src);
+    uint64_t end = out_indices_[src];
+
+    switch (kinds_[src]) {
+    case Kind::kHashed: {
+      const Slot* table = slots_.data() + table_offsets_[src];
+      uint64_t capacity = table_offsets_[src + 1] - table_offsets_[src];
+      uint64_t mask = capacity - 1;
+      for (uint64_t i = Hash(dst, capacity);; i = (i + 1) & mask) {
+        if (table[i].offset == kEmpty) {
+          return end;
+        }
+        if (table[i].dest == dst) {
+          return begin + table[i].offset;
+        }
+      }
+    }
+    case Kind::kSorted: {
+      const NodeId* found =
+          std::lower_bound(dests_ + begin, dests_ + end, dst);
+      if (found != dests_ + end && *found == dst) {
+        return found - dests_;
+      }
+      return end;
+    }
+    default:
+      return std::find(dests_ + begin, dests_ + end, dst) - dests_;
+    }
+  }
+};
+
+}  // namespace galois::graphs
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_GRAPHS_EDGETRANSFORMS_H_
+#define GALOIS_LIBGALOIS_GALOIS_GRAPHS_EDGETRANSFORMS_H_
+
+#include <memory>
+
+#include "galois/Result.h"
+#include "galois/config.h"
+#include "galois/graphs/PropertyFileGraph.h"
+
+namespace galois::graphs {
+
+/// The edges that Transpose, Symmetrize and SimplifyEdges leave out of the
+/// graphs they make
+struct EdgeFilter {
+  /// Leave out edges from a node to itself
+  bool remove_self_loops{false};
+  /// Keep only the first of the edges with the same source and destination:
+  /// the one that comes from the edge of least index in pfg, and an edge
+  /// before its reverse
+  bool remove_duplicates{false};
+};
+
+/// The transforms below make new graphs with the nodes and node properties of
+/// pfg whose edges come from the edges of pfg. Each new edge has the edge
+/// properties of the edge it comes from. The edges of each node are sorted
+/// by destination, ties broken by the edge they come from, so the result
+/// does not depend on the number of threads; the topology is marked sorted
+/// by destination. All the properties of the new graph are persistent, so
+/// Write stores it as a new RDG.
+///
+/// The edges are placed with a parallel counting sort by source and the edge
+/// properties gathered with a BlockedPermutation (\see GatherRows).
+
+/// Transpose returns pfg with every edge reversed
+GALOIS_EXPORT Result<std::unique_ptr<PropertyFileGraph>> Transpose(
+    const PropertyFileGraph& pfg, const EdgeFilter& filter = EdgeFilter());
+
+/// Symmetrize returns pfg with the reverse of every edge added; most often
+/// with remove_duplicates, since an edge whose reverse is in pfg appears
+/// twice otherwise
+GALOIS_EXPORT Result<std::unique_ptr<PropertyFileGraph>> Symmetrize(
+    const PropertyFileGraph& pfg, const EdgeFilter& filter = EdgeFilter());
+
+/// SimplifyEdges returns pfg with only the edges that filter keeps
+GALOIS_EXPORT Result<std::unique_ptr<PropertyFileGraph>> SimplifyEdges(
+    const PropertyFileGraph& pfg,
+    const EdgeFilter& filter = EdgeFilter{true, true});
+
+}  // namespace galois::graphs
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_GRAPHS_EDGETYPEINDEX_H_
+#define GALOIS_LIBGALOIS_GALOIS_GRAPHS_EDGETYPEINDEX_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "galois/Result.h"
+#include "galois/config.h"
+#include "galois/graphs/PropertyFileGraph.h"
+#include "tsuba/FileFrame.h"
+#include "tsuba/FileView.h"
+
+namespace galois::graphs {
+
+/// EdgeTypeIndex groups the out-edges of each node of a graph by type, so
+/// that a traversal of some types only touches the edges of those types.
+/// Types are boolean edge properties, which is how PropertyGraphBuilder
+/// records edge types: an edge has type t if property types()[t] is true for
+/// it; nulls are false.
+///
+/// The index is a type-sorted copy of the destinations of the graph, with
+/// the id of each edge so that edge properties can be shared: the edges of
+/// each node stay in the edge range of the node but come in groups, first one
+/// group per type of the edges with only that type, then the edges with
+/// several types, then the edges with none, each group in edge order. Each
+/// group is thus the CSR of the node for one type. The index is only valid
+/// for the topology and the properties it was built from.
+///
+/// PropertyFileGraph::EdgeTypes caches an index and can store it with the
+/// graph.
+class GALOIS_EXPORT EdgeTypeIndex {
+  std::vector<std::string> types_;
+  std::vector<std::shared_ptr<arrow::BooleanArray>> type_arrays_;
+  /// offsets_[n * num_groups() + g] is where group g of node n begins
+  std::shared_ptr<arrow::UInt64Array> offsets_;
+  std::shared_ptr<arrow::UInt64Array> edge_ids_;
+  std::shared_ptr<arrow::UInt32Array> dests_;
+
+  EdgeTypeIndex() = default;
+
+  size_t num_groups() const { return types_.size() + 2; }
+
+  std::pair<uint64_t, uint64_t> group_range(uint32_t node, size_t g) const {
+    const uint64_t* offsets =
+        offsets_->raw_values() + static_cast<uint64_t>(node) * num_groups();
+    return std::make_pair(offsets[g], offsets[g + 1]);
+  }
+
+  Result<void> LoadTypeArrays(const PropertyFileGraph& pfg);
+
+public:
+  /// Make builds the index of pfg for the edge properties named by types, in
+  /// parallel.
+  ///
+  /// \returns PropertyNotFound if a type is not an edge property of pfg and
+  /// TypeError if it is not boolean
+  static Result<std::unique_ptr<EdgeTypeIndex>> Make(
+      const PropertyFileGraph& pfg, const std::vector<std::string>& types);
+
+  /// Map returns the index of pfg stored in the buffer of file_view by Write,
+  /// without copying it; file_view must outlive the index.
+  ///
+  /// \returns InvalidArgument if the stored index does not match the
+  /// topology of pfg
+  static Result<std::unique_ptr<EdgeTypeIndex>> Map(
+      const PropertyFileGraph& pfg, const tsuba::FileView& file_view);
+
+  /// Write serializes the index in the format read by Map
+  Result<std::unique_ptr<tsuba::FileFrame>> Write() const;
+
+  const std::vector<std::string>& types() const { return types_; }
+
+  /// The index of the type called name in types(), or -1
+  int TypeIndex(const std::string& name) const;
+
+  /// Whether every one of names is in types()
+  bool HasTypes(const std::vector<std::string>& names) const;
+
+  /// The positions of the edges of node that have type t and no other type
+  std::pair<uint64_t, uint64_t> type_range(uint32_t node, size_t t) const {
+    return group_range(node, t);
+  }
+
+  /// The positions of the edges of node that have more than one type; use
+  /// HasType to check each of them
+  std::pair<uint64_t, uint64_t> mixed_range(uint32_t node) const {
+    return group_range(node, types_.size());
+  }
+
+  /// The positions of the edges of node that have no type
+  std::pair<uint64_t, uint64_t> untyped_range(uint32_t node) const {
+    return group_range(node, types_.size() + 1);
+  }
+
+  /// The id of the edge at position
+  uint64_t edge_id(uint64_t position) const {
+    return edge_ids_->Value(position);
+  }
+
+  /// The destination of the edge at position
+  uint32_t edge_dest(uint64_t position) const {
+    return dests_->Value(position);
+  }
+
+  /// The bytes of the arrays of the index, not counting the type properties
+  /// it refers to
+  uint64_t memory_bytes() const {
+    return (offsets_->length() + edge_ids_->length()) * sizeof(uint64_t) +
+           dests_->length() * sizeof(uint32_t);
+  }
+
+  bool HasType(uint64_t edge_id, size_t t) const {
+    return type_arrays_[t]->IsValid(edge_id) &&
+           type_arrays_[t]->Value(edge_id);
+  }
+};
+
+}  // namespace galois::graphs
+
+#endif
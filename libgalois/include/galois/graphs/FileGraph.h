@@ -678,7 +678,7 @@ public:
  *  <li>finish(), use as FileGraph</li>
  * </ol>
  */
-class FileGraphWriter : public FileGraph {
+class GALOIS_EXPORT FileGraphWriter : public FileGraph {
   std::vector<uint64_t> outIdx;
   std::vector<uint32_t> starts;
   std::vector<uint32_t> outs;
@@ -756,6 +756,20 @@ public:
     }
   }
 
+  /**
+   * Adds all the edges of the graph in parallel instead of with phase1(),
+   * incrementDegree(), phase2() and addNeighbor(). setNumNodes() and
+   * setSizeofEdgeData() should be called before and finish() after.
+   *
+   * The neighbors of each node are in the order of their edges in srcs. On
+   * return, (*edgeIds)[i] is the index in srcs of the edge at position i of
+   * the graph, which is also the position of its data in the memory returned
+   * by finish().
+   */
+  void addEdgesParallel(
+      const uint64_t* srcs, const uint64_t* dsts, size_t num_edges,
+      std::vector<uint64_t>* edgeIds);
+
   /**
    * Finish making graph. Returns pointer to block of memory that should be
    * used to store edge data.
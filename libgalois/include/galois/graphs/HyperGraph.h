@@ -21,6 +21,8 @@
 #define GALOIS_LIBGALOIS_GALOIS_GRAPHS_HYPERGRAPH_H_
 
 #include "galois/DynamicBitset.h"
+#include "galois/LargeArray.h"
+#include "galois/ParallelSTL.h"
 #include "galois/graphs/LC_CSR_Graph.h"
 
 namespace galois::graphs {
@@ -28,6 +30,100 @@ template <typename NodeTy, bool HasNoLockable = true, bool UseNumaAlloc = true>
 class HyperGraph : public galois::graphs::LC_CSR_Graph<
                        NodeTy, void, HasNoLockable, UseNumaAlloc> {
 public:
+  /**
+   * Constructs the hypergraph, in parallel, from a bipartite graph in CSR
+   * format whose nodes are the hyperedges, those for which is_hedge(n) is
+   * true, and the vertices. The pins of a hyperedge are the vertices among
+   * the destinations of its out-edges, in order; edges out of vertices and
+   * between hyperedges are ignored, so graphs that store each pin in both
+   * directions work as well.
+   *
+   * As when reading hMetis files, the hyperedges become the nodes
+   * [0, GetHedges()) and the vertices the nodes [GetHedges(), size()), each
+   * in their order in the input, and only hyperedges have edges.
+   *
+   * @param out_indices the end of the out-edges of each node
+   * @param out_dests the destination of each edge
+   * @param is_hedge whether a node of the input is a hyperedge
+   * @param skip_lone_hedges leave out hyperedges with fewer than two pins
+   */
+  template <typename IsHedgeFn>
+  void ConstructFromBipartite(
+      uint64_t num_nodes, const uint64_t* out_indices,
+      const uint32_t* out_dests, const IsHedgeFn& is_hedge,
+      bool skip_lone_hedges = false) {
+    // the pins of each hyperedge that is kept and then the first of them;
+    // the rank of each kept hyperedge and of each vertex among their kind
+    LargeArray<uint64_t> pins;
+    LargeArray<uint32_t> hedge_ids;
+    LargeArray<uint32_t> vertex_ids;
+    pins.allocateInterleaved(num_nodes);
+    hedge_ids.allocateInterleaved(num_nodes);
+    vertex_ids.allocateInterleaved(num_nodes);
+
+    galois::do_all(
+        galois::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          uint64_t num_pins = 0;
+          bool hedge = is_hedge(n);
+          if (hedge) {
+            uint64_t begin = n == 0 ? 0 : out_indices[n - 1];
+            for (uint64_t e = begin; e < out_indices[n]; ++e) {
+              num_pins += !is_hedge(out_dests[e]);
+            }
+          }
+          bool kept = hedge && (!skip_lone_hedges || num_pins >= 2);
+          pins[n] = kept ? num_pins : 0;
+          hedge_ids[n] = kept;
+          vertex_ids[n] = !hedge;
+        },
+        galois::steal(), galois::loopname("HyperGraph-CountPins"));
+
+    auto rank = [&](LargeArray<uint32_t>* ids) {
+      uint32_t last = num_nodes == 0 ? 0 : (*ids)[num_nodes - 1];
+      galois::ParallelSTL::exclusive_scan(
+          ids->begin(), ids->end(), ids->begin(), uint32_t{0});
+      return num_nodes == 0 ? 0 : (*ids)[num_nodes - 1] + last;
+    };
+    uint64_t last_pins = num_nodes == 0 ? 0 : pins[num_nodes - 1];
+    galois::ParallelSTL::exclusive_scan(
+        pins.begin(), pins.end(), pins.begin(), uint64_t{0});
+    uint64_t num_pins = num_nodes == 0 ? 0 : pins[num_nodes - 1] + last_pins;
+    uint32_t num_hedges = rank(&hedge_ids);
+    uint32_t num_hnodes = rank(&vertex_ids);
+
+    this->allocateFrom(num_hedges + num_hnodes, num_pins);
+    this->constructNodes();
+    SetHedges(num_hedges);
+    SetHnodes(num_hnodes);
+
+    galois::do_all(
+        galois::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          if (!is_hedge(n)) {
+            this->fixEndEdge(num_hedges + vertex_ids[n], num_pins);
+            return;
+          }
+          // the ranks only advance past kept hyperedges
+          uint32_t next = n + 1 == num_nodes ? num_hedges : hedge_ids[n + 1];
+          if (next == hedge_ids[n]) {
+            return;
+          }
+          uint64_t pin = pins[n];
+          uint64_t begin = n == 0 ? 0 : out_indices[n - 1];
+          for (uint64_t e = begin; e < out_indices[n]; ++e) {
+            uint32_t dst = out_dests[e];
+            if (!is_hedge(dst)) {
+              this->constructEdge(pin++, num_hedges + vertex_ids[dst]);
+            }
+          }
+          this->fixEndEdge(hedge_ids[n], pin);
+        },
+        galois::steal(), galois::loopname("HyperGraph-PlacePins"));
+
+    this->initializeLocalRanges();
+  }
+
   uint32_t GetHedges() const { return hedges_; }
   void SetHedges(uint32_t hedges) { hedges_ = hedges; }
 
@@ -0,0 +1,70 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_GRAPHS_INLINEEDGEINDEX_H_
+#define GALOIS_LIBGALOIS_GALOIS_GRAPHS_INLINEEDGEINDEX_H_
+
+#include <memory>
+#include <string>
+
+#include <arrow/api.h>
+
+#include "galois/Result.h"
+#include "galois/config.h"
+#include "galois/graphs/PropertyFileGraph.h"
+
+namespace galois::graphs {
+
+/// InlineEdgeIndex is a copy of the destinations of the out-edges of a graph
+/// interleaved with the values of one fixed-width edge property, the layout
+/// of LC_InlineEdge_Graph. A traversal that reads the destination and the
+/// weight of each edge then touches one array instead of two, so a run of
+/// edges costs one stream of cache lines rather than two. The index is
+/// indexed by edge id and is only valid for the topology and property values
+/// it was built from.
+///
+/// PropertyFileGraph::InlineEdges caches an index.
+class GALOIS_EXPORT InlineEdgeIndex {
+  std::string property_;
+  std::shared_ptr<arrow::DataType> type_;
+  uint64_t num_edges_{0};
+  std::shared_ptr<arrow::Buffer> data_;
+
+  InlineEdgeIndex() = default;
+
+public:
+  /// An edge of the index for a property of C type T. The value follows the
+  /// destination at the alignment of T, so an edge takes 8 bytes for values
+  /// of up to 4 bytes and 16 bytes for 8-byte values.
+  template <typename T>
+  struct Edge {
+    uint32_t dest;
+    T value;
+  };
+
+  /// Make builds the index of pfg for the edge property called property, in
+  /// parallel. Null values are copied as whatever their slots hold.
+  ///
+  /// \returns PropertyNotFound if property is not an edge property of pfg
+  /// and TypeError if its values are not 1, 2, 4 or 8 bytes wide
+  static Result<std::unique_ptr<InlineEdgeIndex>> Make(
+      const PropertyFileGraph& pfg, const std::string& property);
+
+  const std::string& property() const { return property_; }
+  const std::shared_ptr<arrow::DataType>& type() const { return type_; }
+  uint64_t num_edges() const { return num_edges_; }
+
+  /// The bytes of the edges of the index
+  uint64_t memory_bytes() const { return data_ ? data_->size() : 0; }
+
+  /// The edges of the index, or null if T is not the C type of type()
+  template <typename T>
+  const Edge<T>* edges() const {
+    using ArrowType = typename arrow::CTypeTraits<T>::ArrowType;
+    if (type_->id() != ArrowType::type_id) {
+      return nullptr;
+    }
+    return reinterpret_cast<const Edge<T>*>(data_->data());
+  }
+};
+
+}  // namespace galois::graphs
+
+#endif
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <optional>
+
 #include "galois/graphs/LC_CSR_CSC_Graph.h"
 
 namespace galois {
@@ -329,7 +331,8 @@ public:
   /**
    * Returns an edge iterator to an edge with some node and key by
    * searching for the key via the node's outgoing or incoming edges.
-   * If not found, returns nothing.
+   * If not found, returns nothing. Searches of the outgoing edges use the
+   * index of buildEdgeLookup if there is one instead of each label.
    */
   template <bool in_edges>
   std::optional<edge_iterator> FindEdge(GraphNode node, GraphNode key) const {
@@ -344,6 +347,14 @@ public:
       }
     }
 
+    if (!in_edges && this->edgeLookup.built()) {
+      edge_iterator e(this->edgeLookup.Find(node, key));
+      if (e == BaseGraph::edge_end(node)) {
+        return std::nullopt;
+      }
+      return e;
+    }
+
     // loop through all data labels
     for (const EdgeTy& label : DistinctEdgeLabels()) {
       // always use out edges (we want an id to the out edge returned)
@@ -392,6 +403,9 @@ public:
     if (degrees_[src] == 0 || in_degrees_[dst] == 0) {
       return false;
     }
+    if (this->edgeLookup.built()) {
+      return FindEdge<false>(src, dst).has_value();
+    }
     for (auto data : DistinctEdgeLabels()) {
       if (IsConnectedWithEdgeLabel(src, dst, data)) {
         return true;
@@ -444,6 +458,7 @@ public:
   }
 
   void ConstructAndSortIndex() {
+    this->dropEdgeLookup();
     // sort outgoing edges
     SortAllEdgesByDataThenDst();
 
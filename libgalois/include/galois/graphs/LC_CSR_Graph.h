@@ -27,6 +27,7 @@
 #include "galois/PODResizeableArray.h"
 #include "galois/config.h"
 #include "galois/graphs/Details.h"
+#include "galois/graphs/EdgeLookupIndex.h"
 #include "galois/graphs/FileGraph.h"
 #include "galois/graphs/GraphHelpers.h"
 
@@ -166,6 +167,9 @@ protected:
   uint64_t numNodes;
   uint64_t numEdges;
 
+  //! Built by buildEdgeLookup; empty otherwise
+  EdgeLookupIndex<GraphNode> edgeLookup;
+
   typedef internal::EdgeSortIterator<
       GraphNode, typename EdgeIndData::value_type, EdgeDst, EdgeData>
       edge_sort_iterator;
@@ -348,7 +352,16 @@ public:
     return std::distance(raw_begin(N), raw_end(N));
   }
 
+  /**
+   * Finds an edge from N1 to N2, or returns edge_end(N1) if there is none.
+   * Scans the edges of N1 unless buildEdgeLookup built an index.
+   */
   edge_iterator findEdge(GraphNode N1, GraphNode N2) {
+    if (edgeLookup.built()) {
+      // acquires N1 and its neighbors as the scan does
+      edge_begin(N1);
+      return edge_iterator(edgeLookup.Find(N1, N2));
+    }
     return std::find_if(edge_begin(N1), edge_end(N1), [=](edge_iterator e) {
       return getEdgeDst(e) == N2;
     });
@@ -361,6 +374,24 @@ public:
     return (getEdgeDst(e) == N2) ? e : edge_end(N1);
   }
 
+  /**
+   * Builds an index of the current edges for findEdge (\see EdgeLookupIndex):
+   * lookups on nodes of at least hashThreshold edges then take constant time
+   * and on nodes whose edges are sorted by destination logarithmic time.
+   * Reallocating the graph or sorting all edges drops the index; call
+   * dropEdgeLookup after changing the edges otherwise.
+   */
+  void buildEdgeLookup(
+      uint64_t hashThreshold =
+          EdgeLookupIndex<GraphNode>::kDefaultHashThreshold) {
+    edgeLookup.Build(
+        numNodes, edgeIndData.data(), edgeDst.data(), hashThreshold);
+  }
+
+  void dropEdgeLookup() { edgeLookup.clear(); }
+
+  bool hasEdgeLookup() const { return edgeLookup.built(); }
+
   edges_iterator edges(GraphNode N, MethodFlag mflag = MethodFlag::WRITE) {
     return internal::make_no_deref_range(
         edge_begin(N, mflag), edge_end(N, mflag));
@@ -413,6 +444,7 @@ public:
    * getEdgeDst(e).
    */
   void sortAllEdgesByDst(MethodFlag mflag = MethodFlag::WRITE) {
+    edgeLookup.clear();
     galois::do_all(
         galois::iterate(size_t{0}, this->size()),
         [=](GraphNode N) { this->sortEdgesByDst(N, mflag); },
@@ -422,6 +454,7 @@ public:
   void allocateFrom(const FileGraph& graph) {
     numNodes = graph.size();
     numEdges = graph.sizeEdges();
+    edgeLookup.clear();
     if (UseNumaAlloc) {
       nodeData.allocateBlocked(numNodes);
       edgeIndData.allocateBlocked(numNodes);
@@ -440,6 +473,7 @@ public:
   void allocateFrom(uint32_t nNodes, uint64_t nEdges) {
     numNodes = nNodes;
     numEdges = nEdges;
+    edgeLookup.clear();
 
     if (UseNumaAlloc) {
       nodeData.allocateBlocked(numNodes);
@@ -494,6 +528,7 @@ public:
   }
 
   void deallocate() {
+    edgeLookup.clear();
     nodeData.destroy();
     nodeData.deallocate();
 
@@ -524,6 +559,7 @@ public:
   void transpose(const char* regionName = NULL) {
     galois::StatTimer timer("TIMER_GRAPH_TRANSPOSE", regionName);
     timer.start();
+    edgeLookup.clear();
 
     EdgeDst edgeDst_old;
     EdgeData edgeData_new;
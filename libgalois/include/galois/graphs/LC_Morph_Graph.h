@@ -26,12 +26,17 @@
 #ifndef GALOIS_LIBGALOIS_GALOIS_GRAPHS_LCMORPHGRAPH_H_
 #define GALOIS_LIBGALOIS_GALOIS_GRAPHS_LCMORPHGRAPH_H_
 
+#include <iterator>
+#include <tuple>
 #include <type_traits>
+#include <vector>
 
 #include <boost/mpl/if.hpp>
 
 #include "galois/Bag.h"
+#include "galois/Galois.h"
 #include "galois/LargeArray.h"
+#include "galois/ParallelSTL.h"
 #include "galois/config.h"
 #include "galois/graphs/Details.h"
 #include "galois/graphs/FileGraph.h"
@@ -236,6 +241,8 @@ protected:
   Nodes nodes;
   //! Memory for edges in this graph (memory held in EdgeHolders)
   galois::substrate::PerThreadStorage<EdgeHolder*> edgesL;
+  //! Memory for edges added by addEdgeBatch, one block per batch
+  std::vector<substrate::LAptr> batchEdges;
 
   /**
    * Acquire a node for the scope in which the function is called.
@@ -520,6 +527,105 @@ public:
     return it;
   }
 
+  /**
+   * Adds a batch of edges in parallel. Unlike addMultiEdge, the edges need not
+   * fit in the space reserved by createNode: the batch is degree-counted per
+   * source in parallel, one contiguous block is allocated for all its
+   * sources, and the edges each source already had are moved to its part of
+   * the block, followed by its edges of the batch in order. Duplicates are
+   * kept, as with addMultiEdge.
+   *
+   * Not thread-safe: call it from serial code, e.g., between the parallel
+   * phases that build a graph.
+   *
+   * @param batch random access range of tuples (src, dst) or (src, dst, edge
+   * data) in which the edges of each source are contiguous, e.g., sorted by
+   * source
+   * @param spare number of edges reserved at the end of each source's part
+   * for later calls to addEdge and addMultiEdge
+   */
+  template <typename EdgeRange>
+  void addEdgeBatch(const EdgeRange& batch, size_t spare = 0) {
+    auto first = std::begin(batch);
+    size_t size = std::distance(first, std::end(batch));
+    if (size == 0) {
+      return;
+    }
+
+    // groups[i] is one more than the index of the source of edge i
+    std::vector<size_t> groups(size);
+    galois::do_all(
+        galois::iterate(size_t{0}, size),
+        [&](size_t i) {
+          groups[i] =
+              i == 0 || std::get<0>(first[i]) != std::get<0>(first[i - 1]);
+        },
+        galois::no_stats());
+    galois::ParallelSTL::partial_sum(
+        groups.begin(), groups.end(), groups.begin());
+    size_t num_groups = groups.back();
+
+    std::vector<size_t> group_begins(num_groups + 1);
+    group_begins[num_groups] = size;
+    galois::do_all(
+        galois::iterate(size_t{0}, size),
+        [&](size_t i) {
+          if (i == 0 || groups[i] != groups[i - 1]) {
+            group_begins[groups[i] - 1] = i;
+          }
+        },
+        galois::no_stats());
+
+    std::vector<size_t> offsets(num_groups);
+    galois::do_all(
+        galois::iterate(size_t{0}, num_groups),
+        [&](size_t g) {
+          GraphNode src = std::get<0>(first[group_begins[g]]);
+          offsets[g] = std::distance(src->edgeBegin, src->edgeEnd) +
+                       (group_begins[g + 1] - group_begins[g]) + spare;
+        },
+        galois::no_stats());
+    galois::ParallelSTL::partial_sum(
+        offsets.begin(), offsets.end(), offsets.begin());
+
+    batchEdges.emplace_back(substrate::largeMallocInterleaved(
+        offsets.back() * sizeof(EdgeInfo), galois::getActiveThreads()));
+    EdgeInfo* block = reinterpret_cast<EdgeInfo*>(batchEdges.back().get());
+
+    galois::do_all(
+        galois::iterate(size_t{0}, num_groups),
+        [&](size_t g) {
+          GraphNode src = std::get<0>(first[group_begins[g]]);
+          EdgeInfo* out = block + (g == 0 ? 0 : offsets[g - 1]);
+          EdgeInfo* end = out;
+          for (EdgeInfo* ii = src->edgeBegin; ii != src->edgeEnd; ++ii, ++end) {
+            end->dst = ii->dst;
+            if constexpr (EdgeInfo::has_value) {
+              end->construct(std::move(ii->get()));
+              ii->destroy();
+            }
+          }
+          for (size_t i = group_begins[g]; i < group_begins[g + 1]; ++i) {
+            const auto& edge = first[i];
+            end->dst = std::get<1>(edge);
+            if constexpr (
+                std::tuple_size_v<std::decay_t<decltype(edge)>> > 2) {
+              end->construct(std::get<2>(edge));
+            } else {
+              end->construct();
+            }
+            ++end;
+          }
+          src->edgeBegin = out;
+          src->edgeEnd = end;
+#ifndef NDEBUG
+          src->trueEdgeEnd = end + spare;
+#endif
+        },
+        galois::steal(), galois::no_stats(),
+        galois::loopname("LC_Morph_Graph::addEdgeBatch"));
+  }
+
   /**
    * Remove an edge from the graph.
    *
@@ -43,7 +43,9 @@
 #include "galois/graphs/Details.h"
 #include "galois/graphs/FileGraph.h"
 #include "galois/gstl.h"
+#include "galois/runtime/EpochLimbo.h"
 #include "galois/substrate/CacheLineStorage.h"
+#include "galois/substrate/PerThreadStorage.h"
 #include "galois/substrate/SimpleLock.h"
 
 namespace galois::graphs {
@@ -144,17 +146,37 @@ struct UEdgeInfoBase<NTy, void, false> {
 /*
  * Only graphs w/ in-out/symmetric edges and non-void edge data,
  * i.e. ETy != void and DirectedNotInOut = false,
- * need to allocate memory for edge data
+ * need to allocate memory for edge data.
+ *
+ * The data of removed edges is retired until no thread can read it and then
+ * reused by the thread that removed it; it stays constructed in between, so
+ * mem destroys every object it holds exactly once.
  */
 template <typename ETy, bool DirectedNotInOut>
 struct EdgeFactory {
   galois::InsertBag<ETy> mem;
+  galois::runtime::EpochLimbo<ETy> retired;
+  galois::substrate::PerThreadStorage<galois::gstl::Vector<ETy*>> reusable;
+
   template <typename... Args>
   ETy* mkEdge(Args&&... args) {
-    return &mem.emplace(std::forward<Args>(args)...);
+    auto& local = *reusable.getLocal();
+    if (local.empty()) {
+      retired.Collect([&](ETy* e) { local.push_back(e); });
+    }
+    if (local.empty()) {
+      return &mem.emplace(std::forward<Args>(args)...);
+    }
+    ETy* e = local.back();
+    local.pop_back();
+    e->~ETy();
+    return new (e) ETy(std::forward<Args>(args)...);
   }
-  void delEdge(ETy*) {}
-  bool mustDel() const { return false; }
+  void delEdge(ETy* e) {
+    auto& local = *reusable.getLocal();
+    retired.Retire(e, [&](ETy* r) { local.push_back(r); });
+  }
+  bool mustDel() const { return true; }
 };
 
 template <typename ETy>
@@ -406,6 +428,21 @@ private
         edges.erase(ii);
     }
 
+    /**
+     * Erase the edge to N with edge data e, i.e., the other half of an edge
+     * whose data is shared by two entries. Unlike erase(N), this finds the
+     * right one of several edges to N.
+     */
+    template <typename EdgeData>
+    void eraseMirror(gNode* N, bool inEdge, EdgeData* e) {
+      iterator ii = std::find_if(begin(), end(), [=](EdgeInfo& edge) {
+        return edge.first() == N && edge.isInEdge() == inEdge &&
+               edge.second() == e;
+      });
+      if (ii != end())
+        erase(ii);
+    }
+
     /**
      * Find an edge with a particular destination node.
      */
@@ -511,6 +548,14 @@ private
 
   internal::EdgeFactory<EdgeTy, Directional && !InOut> edgesF;
 
+  //! whether createNode reuses removed nodes; see setReuseRemovedNodes
+  bool reuseNodes = false;
+  //! removed nodes, until no thread can read them
+  galois::runtime::EpochLimbo<gNode> retiredNodes;
+  //! removed nodes that createNode may reuse, per thread
+  galois::substrate::PerThreadStorage<galois::gstl::Vector<gNode*>>
+      reusableNodes;
+
   // Helpers for iterator classes
   struct is_node {
     bool operator()(const gNode& g) const { return g.active; }
@@ -719,11 +764,45 @@ public
    */
   template <typename... Args>
   GraphNode createNode(Args&&... args) {
-    gNode* N = &(nodes.emplace(std::forward<Args>(args)...));
+    gNode* N = nullptr;
+    if (reuseNodes) {
+      auto& local = *reusableNodes.getLocal();
+      if (local.empty()) {
+        retiredNodes.Collect([&](gNode* r) { local.push_back(r); });
+      }
+      if (!local.empty()) {
+        N = local.back();
+        local.pop_back();
+        // also releases the memory of the edges of the removed node
+        N->~gNode();
+        new (N) gNode(std::forward<Args>(args)...);
+      }
+    }
+    if (!N) {
+      N = &(nodes.emplace(std::forward<Args>(args)...));
+    }
     N->active = false;
     return GraphNode(N);
   }
 
+  /**
+   * Lets createNode reuse the memory of removed nodes once no thread can read
+   * them anymore, i.e., two epochs after their removal (see
+   * galois::substrate::EpochManager), which for_each loops advance between
+   * iterations and every parallel loop at its end. Off by default, because
+   * a reused node has a new identity under its old handle: with reuse, a
+   * handle to a removed node, e.g., a stale worklist item, must not be used
+   * after the iteration that saw it removed, not even for containsNode.
+   * Removing a node then also erases its edges at its neighbors, so only
+   * undirected graphs and graphs with in-edges support it. Serial only.
+   */
+  void setReuseRemovedNodes(bool reuse) {
+    static_assert(
+        !DirectedNotInOut,
+        "nodes are not reusable if in-edges are untracked");
+    reuseNodes = reuse;
+  }
+
   /**
    * Adds a node to the graph.
    */
@@ -756,7 +835,10 @@ public
    * Removes a node from the graph along with all its outgoing/incoming edges
    * for undirected graphs or outgoing edges for directed graphs.
    *
-   * @todo handle edge memory
+   * If the graph allocates edge data, or reuses removed nodes, their other
+   * halves at the neighbors are erased too, and the edge data is retired
+   * for reuse by later edges. Otherwise, the neighbors keep entries to
+   * the removed node, which their edge iterators skip.
    */
   void removeNode(GraphNode n, galois::MethodFlag mflag = MethodFlag::WRITE) {
     assert(n);
@@ -765,7 +847,28 @@ public
     gNode* N = n;
     if (N->active) {
       N->active = false;
+      if (edgesF.mustDel() || reuseNodes) {
+        for (auto ii = N->begin(), ei = N->end(); ii != ei; ++ii) {
+          gNode* dst = ii->first();
+          if (dst != N) {
+            dst->acquire(mflag);
+            dst->eraseMirror(N, Directional && !ii->isInEdge(), ii->second());
+          } else if (std::any_of(N->begin(), ii, [&](auto& edge) {
+                       return edge.second() == ii->second();
+                     })) {
+            // the data of a self loop is shared by two entries of N
+            continue;
+          }
+          if (edgesF.mustDel()) {
+            edgesF.delEdge(ii->second());
+          }
+        }
+      }
       N->edges.clear();
+      if (reuseNodes) {
+        auto& local = *reusableNodes.getLocal();
+        retiredNodes.Retire(N, [&](gNode* r) { local.push_back(r); });
+      }
     }
   }
 
@@ -813,11 +916,16 @@ public
     if (Directional && !InOut) {
       src->erase(dst.base());
     } else {
-      dst->first()->acquire(mflag);
-      // EdgeTy* e = dst->second();
-      dst->first()->erase(
-          src, Directional ? true : false);  // erase incoming/symmetric edge
+      gNode* other = dst->first();
+      auto* e = dst->second();
+      other->acquire(mflag);
       src->erase(dst.base());
+      // erase incoming/symmetric edge, which is the other entry for e at src
+      // itself for undirected self loops
+      other->eraseMirror(src, Directional ? true : false, e);
+      if (edgesF.mustDel()) {
+        edgesF.delEdge(e);
+      }
     }
   }
 
@@ -1,7 +1,10 @@
 #ifndef GALOIS_LIBGALOIS_GALOIS_GRAPHS_PROPERTYFILEGRAPH_H_
 #define GALOIS_LIBGALOIS_GALOIS_GRAPHS_PROPERTYFILEGRAPH_H_
 
+#include <memory>
 #include <string>
+#include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -13,30 +16,121 @@
 #include "galois/config.h"
 #include "tsuba/RDG.h"
 
+namespace galois {
+class BlockedPermutation;
+}  // namespace galois
+
 namespace galois::graphs {
 
+class EdgeTypeIndex;
+class InlineEdgeIndex;
+
 /// A graph topology represents the adjacency information for a graph in CSR
-/// format.
-struct GraphTopology {
+/// format. NodeId is the type of the destinations: uint32_t for most graphs
+/// and uint64_t for graphs with 2^32 or more nodes, which cost twice the
+/// memory per edge (\see GraphTopology64).
+template <typename NodeId>
+struct BasicGraphTopology {
+  using node_id_type = NodeId;
+  using DestArray =
+      arrow::NumericArray<typename arrow::CTypeTraits<NodeId>::ArrowType>;
+
   std::shared_ptr<arrow::UInt64Array> out_indices;
-  std::shared_ptr<arrow::UInt32Array> out_dests;
+  std::shared_ptr<DestArray> out_dests;
+
+  /// The edges of each node are known to be sorted by destination
+  /// (\see PropertyFileGraph::MarkEdgesSortedByDest)
+  bool edges_sorted_by_dest{false};
 
   uint64_t num_nodes() const { return out_indices ? out_indices->length() : 0; }
 
   uint64_t num_edges() const { return out_dests ? out_dests->length() : 0; }
 
-  bool Equals(const GraphTopology& other) const {
+  bool Equals(const BasicGraphTopology& other) const {
     return out_indices->Equals(*other.out_indices) &&
            out_dests->Equals(*other.out_dests);
   }
 
-  std::pair<uint64_t, uint64_t> edge_range(uint32_t node_id) const {
+  std::pair<uint64_t, uint64_t> edge_range(NodeId node_id) const {
     auto edge_start = node_id > 0 ? out_indices->Value(node_id - 1) : 0;
     auto edge_end = out_indices->Value(node_id);
     return std::make_pair(edge_start, edge_end);
   }
 };
 
+using GraphTopology = BasicGraphTopology<uint32_t>;
+
+/// The topology of graphs with 64-bit node ids (\see
+/// PropertyFileGraph::SetTopology)
+using GraphTopology64 = BasicGraphTopology<uint64_t>;
+
+/// The in-edges of a graph in CSR format, i.e., the topology of its
+/// transpose. out_edge_ids maps each in-edge to the index of the same edge in
+/// the GraphTopology so that edge properties can be shared between the two.
+struct InEdgeTopology {
+  std::shared_ptr<arrow::UInt64Array> in_indices;
+  std::shared_ptr<arrow::UInt32Array> in_sources;
+  std::shared_ptr<arrow::UInt64Array> out_edge_ids;
+
+  uint64_t num_nodes() const { return in_indices ? in_indices->length() : 0; }
+
+  uint64_t num_edges() const { return in_sources ? in_sources->length() : 0; }
+
+  std::pair<uint64_t, uint64_t> edge_range(uint32_t node_id) const {
+    auto edge_start = node_id > 0 ? in_indices->Value(node_id - 1) : 0;
+    auto edge_end = in_indices->Value(node_id);
+    return std::make_pair(edge_start, edge_end);
+  }
+};
+
+/// How PropertyFileGraph::DistributeToNumaNodes places the pages of the
+/// graph on the NUMA nodes of the active threads
+enum class NumaPolicy {
+  /// Each thread gets the block of nodes that on_each and do_all give it,
+  /// together with the edges of those nodes; for loops over the nodes that
+  /// mostly touch the nodes and edges of their block
+  kBlocked,
+  /// The pages of each array go round robin to the threads, so that every
+  /// NUMA node holds an equal share of it; for loops whose accesses are
+  /// spread over the whole graph, e.g., reads of the properties of the
+  /// destinations of edges, which then load every memory node evenly
+  kInterleaved,
+};
+
+/// The memory that a node or edge property of a PropertyFileGraph holds
+struct PropertyMemoryUsage {
+  std::string name;
+  /// The bytes of the buffers of its values; 0 if it is not loaded
+  uint64_t bytes{0};
+  bool loaded{false};
+  /// Whether it has an unmodified stored copy, so that unloading it to free
+  /// memory loses nothing
+  bool evictable{false};
+};
+
+/// The memory that a PropertyFileGraph holds, by part (\see
+/// PropertyFileGraph::GetMemoryUsage)
+struct GALOIS_EXPORT MemoryUsage {
+  uint64_t topology_bytes{0};
+  /// The cached in-edge (CSC) index
+  uint64_t in_edges_bytes{0};
+  /// The cached edge type index
+  uint64_t edge_types_bytes{0};
+  /// The cached inline edges
+  uint64_t inline_edges_bytes{0};
+  /// The bytes of the files of the RDG mapped for the topology and the
+  /// stored indexes. The arrays of a mapped topology or index point into
+  /// them, so they are not added to total_bytes.
+  uint64_t file_view_bytes{0};
+  std::vector<PropertyMemoryUsage> node_properties;
+  std::vector<PropertyMemoryUsage> edge_properties;
+
+  uint64_t property_bytes() const;
+
+  /// The topology, the cached indexes and the loaded properties
+  uint64_t total_bytes() const;
+};
+
 /// A property graph is a graph that has properties associated with its nodes
 /// and edges. A property has a name and value. Its value may be a primitive
 /// type, a list of values or a composition of properties.
@@ -66,6 +160,46 @@ class GALOIS_EXPORT PropertyFileGraph {
   // The topology is either backed by rdg_ or shared with the
   // caller of SetTopology.
   GraphTopology topology_;
+  // Set instead of topology_ for graphs with 64-bit node ids
+  GraphTopology64 topology64_;
+
+  bool compress_topology_{false};
+
+  // Built or mapped on first use by InEdges; empty otherwise
+  mutable InEdgeTopology in_topology_;
+  bool persist_in_edges_{false};
+
+  // Built or mapped by EdgeTypes; null otherwise. edge_types_mapped_ records
+  // whether it is the index stored in rdg_.
+  mutable std::shared_ptr<const EdgeTypeIndex> edge_types_;
+  mutable bool edge_types_mapped_{false};
+  bool persist_edge_types_{false};
+
+  // Built by InlineEdges; null otherwise
+  mutable std::shared_ptr<const InlineEdgeIndex> inline_edges_;
+
+  // Loaded from rdg_ or set by set_graph_statistics; empty otherwise
+  mutable std::string graph_statistics_;
+
+  // Built on first use by EdgeBalancedRanges for the number of active threads
+  // then; empty otherwise
+  mutable std::vector<uint32_t> edge_balanced_ranges_;
+
+  // The budget of set_memory_budget; 0 for none
+  uint64_t memory_budget_{0};
+  // When each node (edge) property was last accessed, by name, on the clock
+  // of property_clock_, for evicting the least recently used ones
+  mutable std::unordered_map<std::string, uint64_t> node_property_uses_;
+  mutable std::unordered_map<std::string, uint64_t> edge_property_uses_;
+  mutable uint64_t property_clock_{0};
+
+  /// Record an access to the node (edge) property i
+  void TouchNodeProperty(int i) const;
+  void TouchEdgeProperty(int i) const;
+
+  /// Unload the least recently used evictable properties, except the one
+  /// used last if keep_last, until the graph is within memory_budget_
+  Result<uint64_t> EvictColdProperties(bool keep_last) const;
 
 public:
   /// PropertyView provides a uniform interface when you don't need to
@@ -113,6 +247,16 @@ public:
   static Result<std::unique_ptr<PropertyFileGraph>> Make(
       const std::string& rdg_name);
 
+  /// Make a property graph from an RDG name but only read the schemas of its
+  /// properties. Property values are fetched on first access through
+  /// NodeProperty, EdgeProperty and their plural forms, and can be dropped
+  /// again with UnloadNodeProperty and UnloadEdgeProperty.
+  ///
+  /// node_table() and edge_table() return the tables as they are; columns of
+  /// properties that have not been loaded have no chunks.
+  static Result<std::unique_ptr<PropertyFileGraph>> MakeLazy(
+      const std::string& rdg_name);
+
   /// Make a property graph from an RDG but only load the named node and edge
   /// properties.
   ///
@@ -160,10 +304,37 @@ public:
   Result<void> Write(
       const std::string& rdg_name, const std::string& command_line);
 
+  /// Choose whether Write and Commit store the topology with delta and
+  /// varint encoded destinations. Loading accepts either format; compressed
+  /// topologies are decoded into memory when the graph is made. Topologies
+  /// with 64-bit node ids are always stored uncompressed.
+  void set_compress_topology(bool compress) { compress_topology_ = compress; }
+  bool compress_topology() const { return compress_topology_; }
+
+  /// Choose the number of rows of each row group of the property files that
+  /// Write and Commit store; hosts loading slices of the graph only read the
+  /// row groups that overlap their slice (\see tsuba::RDG::row_group_rows)
+  void set_property_row_group_rows(uint64_t rows) {
+    rdg_.set_row_group_rows(rows);
+  }
+  uint64_t property_row_group_rows() const { return rdg_.row_group_rows(); }
+
+  /// Choose how Write and Commit compress and encode the file of the node or
+  /// edge property named name; by default the codec and dictionary encoding
+  /// are chosen from a sample of the values (\see
+  /// tsuba::RDG::PropertyEncoding)
+  void set_property_encoding(
+      const std::string& name, const tsuba::RDG::PropertyEncoding& encoding) {
+    rdg_.set_property_encoding(name, encoding);
+  }
+
   /// Write updates to the property graph
   ///
   /// Like \ref Write(const std::string&, const std::string&) but update
-  /// the original read location of the graph
+  /// the original read location of the graph. The commit is incremental:
+  /// only properties that were added, replaced or marked modified (\see
+  /// MarkNodePropertyModified) since the graph was loaded or last committed
+  /// are written; the new version refers to the stored files of the others.
   Result<void> Commit(const std::string& command_line);
   /// Tell the RDG where it's data is coming from
   Result<void> InformPath(const std::string& input_path) {
@@ -181,8 +352,17 @@ public:
 
   /// Determine if two PropertyFileGraphss are Equal
   bool Equals(const PropertyFileGraph* other) const {
-    return topology().Equals(other->topology()) &&
-           rdg_.node_table()->Equals(*other->node_table()) &&
+    if (!rdg_.EnsureAllPropertiesLoaded() ||
+        !other->rdg_.EnsureAllPropertiesLoaded()) {
+      return false;
+    }
+    if (HasWideNodeIds() != other->HasWideNodeIds()) {
+      return false;
+    }
+    bool same_topology = HasWideNodeIds()
+                             ? topology64().Equals(other->topology64())
+                             : topology().Equals(other->topology());
+    return same_topology && rdg_.node_table()->Equals(*other->node_table()) &&
            rdg_.edge_table()->Equals(*other->edge_table());
   }
 
@@ -194,21 +374,57 @@ public:
     return rdg_.edge_table()->schema();
   }
 
-  std::shared_ptr<arrow::ChunkedArray> NodeProperty(int i) const {
-    return rdg_.node_table()->column(i);
-  }
-
-  std::shared_ptr<arrow::ChunkedArray> EdgeProperty(int i) const {
-    return rdg_.edge_table()->column(i);
-  }
-
-  std::shared_ptr<arrow::ChunkedArray> NodeProperty(std::string name) const {
-    return rdg_.node_table()->GetColumnByName(name);
-  }
-
-  std::shared_ptr<arrow::ChunkedArray> EdgeProperty(std::string name) const {
-    return rdg_.edge_table()->GetColumnByName(name);
-  }
+  /// NodeProperty returns property i, fetching it first if the graph was
+  /// made with MakeLazy and the property has not been loaded yet.
+  ///
+  /// \returns nullptr if the property could not be loaded
+  std::shared_ptr<arrow::ChunkedArray> NodeProperty(int i) const;
+
+  std::shared_ptr<arrow::ChunkedArray> EdgeProperty(int i) const;
+
+  std::shared_ptr<arrow::ChunkedArray> NodeProperty(std::string name) const;
+
+  std::shared_ptr<arrow::ChunkedArray> EdgeProperty(std::string name) const;
+
+  /// Fetch the named properties if they have not been loaded yet
+  Result<void> EnsureNodePropertiesLoaded(
+      const std::vector<std::string>& names) const;
+  Result<void> EnsureEdgePropertiesLoaded(
+      const std::vector<std::string>& names) const;
+
+  /// Drop the values of a property that has a stored copy to free memory; it
+  /// is fetched again on next use
+  Result<void> UnloadNodeProperty(int i) { return rdg_.UnloadNodeProperty(i); }
+  Result<void> UnloadEdgeProperty(int i) { return rdg_.UnloadEdgeProperty(i); }
+
+  /// GetMemoryUsage returns the bytes that the topology, the cached indexes
+  /// and each property of the graph hold, counting the buffers of their
+  /// arrays. Buffers shared with other graphs or with callers are counted
+  /// too, though unloading them frees nothing while those hold them.
+  MemoryUsage GetMemoryUsage() const;
+
+  /// Report GetMemoryUsage as statistics of the StatManager under region:
+  /// one per part of the graph, one per loaded property ("NodeProperty" or
+  /// "EdgeProperty" followed by its name) and the total
+  void ReportMemoryUsage(const std::string& region) const;
+
+  /// Limit the memory of the graph to about bytes, or 0 for no limit. When
+  /// NodeProperty or EdgeProperty fetch a property that is not loaded and
+  /// the graph is then over budget, the least recently used evictable
+  /// properties (\see PropertyMemoryUsage) are unloaded until it is within
+  /// it; they are fetched again on next use, as with MakeLazy. The topology,
+  /// the indexes and the property used last are never unloaded, so the
+  /// graph may stay over budget.
+  void set_memory_budget(uint64_t bytes) { memory_budget_ = bytes; }
+  uint64_t memory_budget() const { return memory_budget_; }
+
+  /// Unload evictable properties, least recently used first, until the
+  /// graph is within its budget, e.g., after lowering the budget or loading
+  /// properties with NodeProperties. Unlike set_memory_budget, it may unload
+  /// the property used last.
+  ///
+  /// \returns the bytes of the properties unloaded
+  Result<uint64_t> EnforceMemoryBudget() { return EvictColdProperties(false); }
 
   void MarkAllPropertiesPersistent() {
     return rdg_.MarkAllPropertiesPersistent();
@@ -229,18 +445,146 @@ public:
     return rdg_.MarkEdgePropertiesPersistent(persist_edge_props);
   }
 
+  /// The topology of a graph with 32-bit node ids; it is empty if
+  /// HasWideNodeIds. The in-edge and edge type indexes and the sorting,
+  /// reordering and NUMA functions work on this topology only.
   const GraphTopology& topology() const { return topology_; }
 
-  std::vector<std::shared_ptr<arrow::ChunkedArray>> NodeProperties() const {
-    return rdg_.node_table()->columns();
+  /// The topology of a graph with 64-bit node ids; it is empty unless
+  /// HasWideNodeIds
+  const GraphTopology64& topology64() const { return topology64_; }
+
+  /// Whether the graph was given or loaded with 64-bit node ids
+  bool HasWideNodeIds() const { return topology64_.out_indices != nullptr; }
+
+  /// topology() or topology64() by node id type, for code templated on it
+  template <typename NodeId>
+  const BasicGraphTopology<NodeId>& basic_topology() const {
+    static_assert(
+        std::is_same_v<NodeId, uint32_t> || std::is_same_v<NodeId, uint64_t>,
+        "node ids are uint32_t or uint64_t");
+    if constexpr (std::is_same_v<NodeId, uint64_t>) {
+      return topology64_;
+    } else {
+      return topology_;
+    }
+  }
+
+  /// Check in parallel that the edges of each node are sorted by destination
+  /// and, if so, record it in the topology. The flag is stored with the graph
+  /// by Write and Commit and checked again when the graph is made.
+  ///
+  /// \returns invalid_argument if the edges are not sorted
+  Result<void> MarkEdgesSortedByDest();
+
+  /// Forget that edges are sorted; call this after changing the destinations
+  /// of topology() in place
+  void UnmarkEdgesSortedByDest() {
+    topology_.edges_sorted_by_dest = false;
+    topology64_.edges_sorted_by_dest = false;
+  }
+
+  /// InEdges returns the in-edge index of the graph. It is mapped from the
+  /// RDG if one was stored with it and is otherwise built in parallel on
+  /// first use. Later calls return the cached index until the topology
+  /// changes.
+  ///
+  /// Not safe to call concurrently with itself or with topology updates.
+  Result<const InEdgeTopology*> InEdges() const;
+
+  /// Drop the cached in-edge index; call this after modifying the arrays of
+  /// topology() in place. SetTopology does so itself.
+  Result<void> DropInEdges();
+
+  /// Choose whether Write and Commit also store the in-edge index, building it
+  /// if needed, so that later loads need not rebuild it. Graphs made from an
+  /// RDG with a stored index keep storing it.
+  void set_persist_in_edges(bool persist) { persist_in_edges_ = persist; }
+  bool persist_in_edges() const { return persist_in_edges_; }
+
+  /// EdgeTypes returns an index of the out-edges of the graph by type, i.e.,
+  /// a CSR of the edges of each type (\see EdgeTypeIndex), whose types
+  /// include types. The cached index is returned if it has them; otherwise
+  /// the index stored with the RDG is mapped if it has them, and one is built
+  /// for types in parallel if not, replacing the cached one. A mapped index
+  /// must not be used once the graph is gone or has stored another index.
+  ///
+  /// Not safe to call concurrently with itself or with topology updates.
+  Result<std::shared_ptr<const EdgeTypeIndex>> EdgeTypes(
+      const std::vector<std::string>& types) const;
+
+  /// Drop the cached and the stored edge type index; call this after
+  /// modifying the arrays of topology() in place or the type properties.
+  /// SetTopology does so itself.
+  Result<void> DropEdgeTypes();
+
+  /// Choose whether Write and Commit also store the edge type index last
+  /// returned by EdgeTypes, so that later loads map it instead of building
+  /// it. Graphs made from an RDG with a stored index keep storing it.
+  void set_persist_edge_types(bool persist) { persist_edge_types_ = persist; }
+  bool persist_edge_types() const { return persist_edge_types_; }
+
+  /// InlineEdges returns the destinations of the out-edges of the graph
+  /// interleaved with the values of the fixed-width edge property called
+  /// property (\see InlineEdgeIndex), for traversals that read both for each
+  /// edge. The index is built in parallel on first use and cached; later
+  /// calls for the same property return it until the topology or the edge
+  /// properties are replaced. It is not stored with the graph.
+  ///
+  /// Not safe to call concurrently with itself or with topology updates.
+  Result<std::shared_ptr<const InlineEdgeIndex>> InlineEdges(
+      const std::string& property) const;
+
+  /// Drop the cached inline edges; call this after modifying the arrays of
+  /// topology() or the values of the inlined property in place. SetTopology
+  /// does so itself.
+  void DropInlineEdges() { inline_edges_.reset(); }
+
+  /// The statistics cached with the graph as JSON (\see
+  /// galois::analytics::GetGraphStatistics), or empty if there are none.
+  /// Write stores them with the graph and loads restore them. SetTopology
+  /// and replacing or removing edge properties clear them; callers that
+  /// modify the topology in place should clear them too.
+  const std::string& graph_statistics() const { return graph_statistics_; }
+  void set_graph_statistics(std::string statistics) const {
+    graph_statistics_ = std::move(statistics);
   }
+
+  /// EdgeBalancedRanges divides the nodes into one contiguous block per
+  /// active thread so that each block has about the same number of edges
+  /// plus nodes; block i is [ranges[i], ranges[i + 1]). The blocks are found
+  /// in parallel, one binary search of the out-indices per thread, on first
+  /// use. Later calls with the same number of active threads return the
+  /// cached blocks until SetTopology.
+  ///
+  /// Not safe to call concurrently with itself or with topology updates.
+  const std::vector<uint32_t>& EdgeBalancedRanges() const;
+
+  /// Copy the topology and the loaded fixed-width properties to memory that
+  /// the threads that use them touch first: each thread copies the nodes that
+  /// galois::on_each and the static partitioning of galois::do_all give it,
+  /// together with the edges of those nodes. On machines with several NUMA
+  /// nodes, parallel loops over the graph then mostly read memory local to
+  /// the threads running them.
+  ///
+  /// Call this after setting the number of active threads and before making
+  /// PropertyGraphs or views, which keep referring to the old copies.
+  /// Properties that are not loaded, have several chunks or are not
+  /// fixed-width, e.g., strings or booleans, are left where they are.
+  /// Nothing is written again by the next Write or Commit.
+  ///
+  /// With NumaPolicy::kInterleaved, the pages of every array are instead
+  /// spread round robin over the threads (\see NumaPolicy).
+  Result<void> DistributeToNumaNodes(NumaPolicy policy = NumaPolicy::kBlocked);
+
+  /// NodeProperties returns all node properties, fetching any that have not
+  /// been loaded yet
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> NodeProperties() const;
   std::vector<std::string> NodePropertyNames() const {
     return rdg_.node_table()->ColumnNames();
   }
 
-  std::vector<std::shared_ptr<arrow::ChunkedArray>> EdgeProperties() const {
-    return rdg_.edge_table()->columns();
-  }
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> EdgeProperties() const;
   std::vector<std::string> EdgePropertyNames() const {
     return rdg_.edge_table()->ColumnNames();
   }
@@ -248,6 +592,54 @@ public:
   Result<void> AddNodeProperties(const std::shared_ptr<arrow::Table>& table);
   Result<void> AddEdgeProperties(const std::shared_ptr<arrow::Table>& table);
 
+  /// Add a node (edge) property, name, of fixed-width type, e.g.,
+  /// arrow::uint32(), whose values are not initialized. Each thread of
+  /// galois::on_each faults in the pages of its block of nodes (edges), the
+  /// blocks of DistributeToNumaNodes, so a loop over the nodes that writes
+  /// every value before reading any finds them on its NUMA node. Unlike
+  /// properties built from a table, nothing is copied.
+  ///
+  /// Like other added properties, it is not written by Write or Commit until
+  /// marked with MarkNodePropertiesPersistent, so an iterative algorithm can
+  /// update it in place every round and persist it once at the end.
+  ///
+  /// \returns InvalidArgument if type is not fixed-width
+  Result<void> AddUninitializedNodeProperty(
+      const std::string& name, const std::shared_ptr<arrow::DataType>& type);
+  Result<void> AddUninitializedEdgeProperty(
+      const std::string& name, const std::shared_ptr<arrow::DataType>& type);
+
+  /// Replace the values of all node (edge) properties with those of table,
+  /// which must have the same schema, e.g., after relabeling nodes. The
+  /// properties keep their persistence and are written again on the next
+  /// Write or Commit.
+  Result<void> ReplaceNodeProperties(
+      const std::shared_ptr<arrow::Table>& table);
+  Result<void> ReplaceEdgeProperties(
+      const std::shared_ptr<arrow::Table>& table);
+
+  /// Record that the values of the named node (edge) property were changed
+  /// in place, e.g., through a PropertyGraph, so that it is written again on
+  /// the next Write or Commit
+  Result<void> MarkNodePropertyModified(const std::string& prop_name) {
+    auto col_names = NodePropertyNames();
+    auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
+    if (pos != col_names.cend()) {
+      return rdg_.MarkNodePropertyModified(
+          std::distance(col_names.cbegin(), pos));
+    }
+    return galois::ErrorCode::PropertyNotFound;
+  }
+  Result<void> MarkEdgePropertyModified(const std::string& prop_name) {
+    auto col_names = EdgePropertyNames();
+    auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
+    if (pos != col_names.cend()) {
+      return rdg_.MarkEdgePropertyModified(
+          std::distance(col_names.cbegin(), pos));
+    }
+    return galois::ErrorCode::PropertyNotFound;
+  }
+
   Result<void> RemoveNodeProperty(int i) { return rdg_.RemoveNodeProperty(i); }
   Result<void> RemoveNodeProperty(const std::string& prop_name) {
     auto col_names = NodePropertyNames();
@@ -257,12 +649,16 @@ public:
     }
     return galois::ErrorCode::PropertyNotFound;
   }
-  Result<void> RemoveEdgeProperty(int i) { return rdg_.RemoveEdgeProperty(i); }
+  Result<void> RemoveEdgeProperty(int i) {
+    DropInlineEdges();
+    graph_statistics_.clear();
+    return rdg_.RemoveEdgeProperty(i);
+  }
   Result<void> RemoveEdgeProperty(const std::string& prop_name) {
     auto col_names = EdgePropertyNames();
     auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
     if (pos != col_names.cend()) {
-      return rdg_.RemoveNodeProperty(std::distance(col_names.cbegin(), pos));
+      return RemoveEdgeProperty(std::distance(col_names.cbegin(), pos));
     }
     return galois::ErrorCode::PropertyNotFound;
   }
@@ -291,6 +687,11 @@ public:
 
   Result<void> SetTopology(const GraphTopology& topology);
 
+  /// Set a topology with 64-bit node ids, replacing topology(); like the
+  /// other overload it drops the in-edge and edge type indexes. Write and
+  /// Commit store it as such and Make loads it back into topology64().
+  Result<void> SetTopology(const GraphTopology64& topology);
+
   const std::shared_ptr<arrow::Table>& node_table() const {
     return rdg_.node_table();
   }
@@ -307,6 +708,9 @@ public:
 /// ascending order.
 /// This also returns the permutation vector (mapping from old
 /// indices to the new indices) which results due to the sorting.
+///
+/// If the topology is already marked as sorted, nothing is moved and the
+/// identity permutation is returned.
 GALOIS_EXPORT Result<std::vector<uint64_t>> SortAllEdgesByDest(
     PropertyFileGraph* pfg);
 
@@ -326,6 +730,66 @@ GALOIS_EXPORT uint64_t FindEdgeSortedByDest(
 /// descending order.
 GALOIS_EXPORT Result<void> SortNodesByDegree(PropertyFileGraph* pfg);
 
+/// NodeOrdering names the locality improving node orders that ReorderNodes can
+/// compute.
+enum class NodeOrdering {
+  /// Descending out-degree, ties broken by node id
+  kDegree,
+  /// Reverse Cuthill-McKee: a breadth-first order over out-edges that visits
+  /// the children of a node by increasing degree and is then reversed. It
+  /// keeps the neighbors of a node close to it in the id space.
+  kReverseCuthillMcKee,
+  /// Greedy Gorder: place next the node that shares the most edges and
+  /// in-neighbors with the last few placed nodes, so that nodes accessed
+  /// together end up in the same cache lines.
+  kGorder,
+};
+
+/// The node property in which ReorderNodes and PermuteNodes record the id a
+/// node had before the first relabeling
+constexpr char kOriginalNodeIdProperty[] = "original_node_id";
+
+/// ComputeNodeOrdering returns the permutation for the given ordering as a
+/// vector mapping each new node id to an old one.
+GALOIS_EXPORT Result<std::vector<uint32_t>> ComputeNodeOrdering(
+    const GraphTopology& topology, NodeOrdering ordering);
+
+/// GatherColumn returns the values of column at the sources of plan, which
+/// indices must hold too. A single chunk of byte-aligned fixed-width values
+/// without nulls is gathered by plan in parallel; other columns fall back to
+/// arrow Take with indices.
+GALOIS_EXPORT Result<std::shared_ptr<arrow::ChunkedArray>> GatherColumn(
+    const std::shared_ptr<arrow::ChunkedArray>& column,
+    const BlockedPermutation& plan,
+    const std::shared_ptr<arrow::Array>& indices);
+
+/// GatherRows returns the rows of table at the sources of plan, column by
+/// column (\see GatherColumn)
+GALOIS_EXPORT Result<std::shared_ptr<arrow::Table>> GatherRows(
+    const std::shared_ptr<arrow::Table>& table, const BlockedPermutation& plan,
+    const std::shared_ptr<arrow::Array>& indices);
+
+/// PermuteNodes relabels the nodes of pfg so that node new_to_old[i] becomes
+/// node i.
+///
+/// The topology, the node property table, the edge property table and the
+/// local to global vector are permuted consistently; the edges of each node
+/// keep their relative order. Properties are gathered with a cache-blocked
+/// BlockedPermutation where possible (\see GatherColumn). The original id of
+/// each node is stored in the persistent node property
+/// kOriginalNodeIdProperty, which is carried along if it already exists so
+/// repeated relabelings compose.
+///
+/// \returns invalid_argument if new_to_old is not a permutation of the nodes
+/// and not_implemented if pfg has master or mirror nodes
+GALOIS_EXPORT Result<void> PermuteNodes(
+    PropertyFileGraph* pfg, const std::vector<uint32_t>& new_to_old);
+
+/// ReorderNodes relabels the nodes of pfg with the given ordering
+/// \see ComputeNodeOrdering \see PermuteNodes
+GALOIS_EXPORT Result<void> ReorderNodes(
+    PropertyFileGraph* pfg, NodeOrdering ordering);
+
 }  // namespace galois::graphs
 
 #endif
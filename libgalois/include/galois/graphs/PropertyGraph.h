@@ -1,16 +1,24 @@
 #ifndef GALOIS_LIBGALOIS_GALOIS_GRAPHS_PROPERTYGRAPH_H_
 #define GALOIS_LIBGALOIS_GALOIS_GRAPHS_PROPERTYGRAPH_H_
 
+#include <algorithm>
+#include <cassert>
+#include <memory>
 #include <tuple>
+#include <type_traits>
 
 #include <arrow/type_fwd.h>
 #include <boost/iterator/counting_iterator.hpp>
 
+#include "galois/ErrorCode.h"
+#include "galois/Intersection.h"
+#include "galois/Logging.h"
 #include "galois/NoDerefIterator.h"
 #include "galois/Properties.h"
 #include "galois/Result.h"
 #include "galois/Traits.h"
 #include "galois/graphs/Details.h"
+#include "galois/graphs/EdgeLookupIndex.h"
 #include "galois/graphs/PropertyFileGraph.h"
 #include "galois/graphs/PropertyViews.h"
 
@@ -29,7 +37,9 @@ namespace galois::graphs {
 ///
 /// \tparam NodeProps A tuple of property types (\ref Properties.h) for nodes
 /// \tparam EdgeProps A tuple of property types for edges
-template <typename NodeProps, typename EdgeProps>
+/// \tparam NodeId The type of node ids: uint32_t, or uint64_t for graphs set
+/// or loaded with 64-bit node ids (\see PropertyFileGraph::topology64())
+template <typename NodeProps, typename EdgeProps, typename NodeId = uint32_t>
 class PropertyGraph {
   using NodeView = PropertyViewTuple<NodeProps>;
   using EdgeView = PropertyViewTuple<EdgeProps>;
@@ -39,6 +49,10 @@ class PropertyGraph {
   NodeView node_view_;
   EdgeView edge_view_;
 
+  // Built by BuildEdgeLookup and shared by copies of the graph; null
+  // otherwise
+  std::shared_ptr<const EdgeLookupIndex<NodeId>> edge_lookup_;
+
   PropertyGraph(PropertyFileGraph* pfg, NodeView node_view, EdgeView edge_view)
       : pfg_(pfg),
         node_view_(std::move(node_view)),
@@ -47,11 +61,11 @@ class PropertyGraph {
 public:
   using node_properties = NodeProps;
   using edge_properties = EdgeProps;
-  using node_iterator = boost::counting_iterator<uint32_t>;
+  using node_iterator = boost::counting_iterator<NodeId>;
   using edge_iterator = boost::counting_iterator<uint64_t>;
   using edges_iterator = StandardRange<NoDerefIterator<edge_iterator>>;
   using iterator = node_iterator;
-  using Node = uint32_t;
+  using Node = NodeId;
 
   // Standard container concepts
 
@@ -63,6 +77,20 @@ public:
 
   bool empty() const { return num_nodes() == 0; }
 
+  /**
+   * Gets the nodes as a range whose blocks for the active threads have about
+   * the same number of edges (\see PropertyFileGraph::EdgeBalancedRanges).
+   * galois::iterate(graph) splits the nodes evenly by count instead, which
+   * leaves the threads with the high-degree nodes working alone.
+   *
+   * The range is valid until the number of active threads changes.
+   *
+   * @returns range of all nodes to pass to galois::iterate
+   */
+  SpecificRange<node_iterator> EdgeBalancedNodes() const {
+    return MakeSpecificRange(begin(), end(), pfg_->EdgeBalancedRanges());
+  }
+
   // Graph accessors
 
   /**
@@ -123,6 +151,36 @@ public:
     return std::get<prop_index>(edge_view_).GetValue(*edge);
   }
 
+  /**
+   * Gets the view of a node property, e.g., for the data() of a
+   * PODPropertyView in a loop over all nodes that the compiler can
+   * vectorize.
+   *
+   * @returns reference to the view of the property
+   */
+  template <typename NodeIndex>
+  PropertyViewType<NodeIndex>& GetNodePropertyView() {
+    return std::get<find_trait<NodeIndex, NodeProps>()>(node_view_);
+  }
+  template <typename NodeIndex>
+  const PropertyViewType<NodeIndex>& GetNodePropertyView() const {
+    return std::get<find_trait<NodeIndex, NodeProps>()>(node_view_);
+  }
+
+  /**
+   * Gets the view of an edge property (\see GetNodePropertyView).
+   *
+   * @returns reference to the view of the property
+   */
+  template <typename EdgeIndex>
+  PropertyViewType<EdgeIndex>& GetEdgePropertyView() {
+    return std::get<find_trait<EdgeIndex, EdgeProps>()>(edge_view_);
+  }
+  template <typename EdgeIndex>
+  const PropertyViewType<EdgeIndex>& GetEdgePropertyView() const {
+    return std::get<find_trait<EdgeIndex, EdgeProps>()>(edge_view_);
+  }
+
   /**
    * Gets the destination for an edge.
    *
@@ -130,12 +188,12 @@ public:
    * @returns node iterator to the edge destination
    */
   node_iterator GetEdgeDest(const edge_iterator& edge) const {
-    auto node_id = pfg_->topology().out_dests->Value(*edge);
+    auto node_id = topology().out_dests->Value(*edge);
     return node_iterator(node_id);
   }
 
-  uint64_t num_nodes() const { return pfg_->topology().num_nodes(); }
-  uint64_t num_edges() const { return pfg_->topology().num_edges(); }
+  uint64_t num_nodes() const { return topology().num_nodes(); }
+  uint64_t num_edges() const { return topology().num_edges(); }
 
   /**
    * Gets the edge range of some node.
@@ -144,7 +202,7 @@ public:
    * @returns iterator to edges of node
    */
   edges_iterator edges(const node_iterator& node) const {
-    auto [begin_edge, end_edge] = pfg_->topology().edge_range(*node);
+    auto [begin_edge, end_edge] = topology().edge_range(*node);
     return internal::make_no_deref_range(
         edge_iterator(begin_edge), edge_iterator(end_edge));
   }
@@ -166,6 +224,99 @@ public:
    */
   edge_iterator edge_end(Node node) const { return *edges(node).end(); }
 
+  /**
+   * Builds an index of the topology for FindEdge (\see EdgeLookupIndex):
+   * lookups on nodes of at least hash_threshold edges then take constant
+   * time and on other nodes whose edges are sorted by destination
+   * logarithmic time. Copies of the graph made afterwards share the index.
+   * Build it again after changing the topology of the underlying
+   * PropertyFileGraph, e.g., by SortAllEdgesByDest.
+   */
+  void BuildEdgeLookup(
+      uint64_t hash_threshold =
+          EdgeLookupIndex<NodeId>::kDefaultHashThreshold) {
+    auto index = std::make_shared<EdgeLookupIndex<NodeId>>();
+    const uint64_t* out_indices =
+        num_nodes() == 0 ? nullptr : topology().out_indices->raw_values();
+    const NodeId* dests =
+        num_edges() == 0 ? nullptr : topology().out_dests->raw_values();
+    index->Build(num_nodes(), out_indices, dests, hash_threshold);
+    edge_lookup_ = std::move(index);
+  }
+
+  void DropEdgeLookup() { edge_lookup_.reset(); }
+
+  bool HasEdgeLookup() const { return edge_lookup_ != nullptr; }
+
+  /**
+   * Finds an edge from src to dst with the index of BuildEdgeLookup if there
+   * is one, by binary search if the edges are sorted by destination (\see
+   * PropertyFileGraph::topology()), and by a scan otherwise.
+   *
+   * @returns iterator to the edge, or edge_end(src) if there is none
+   */
+  edge_iterator FindEdge(Node src, Node dst) const {
+    if (edge_lookup_) {
+      return edge_iterator(edge_lookup_->Find(src, dst));
+    }
+    auto [begin_edge, end_edge] = topology().edge_range(src);
+    const NodeId* dests = topology().out_dests->raw_values();
+    const NodeId* found =
+        topology().edges_sorted_by_dest
+            ? std::lower_bound(dests + begin_edge, dests + end_edge, dst)
+            : std::find(dests + begin_edge, dests + end_edge, dst);
+    if (found == dests + end_edge || *found != dst) {
+      return edge_iterator(end_edge);
+    }
+    return edge_iterator(found - dests);
+  }
+
+  /**
+   * Counts the destinations common to two ranges of edges whose destinations
+   * are strictly increasing, e.g., subranges of the edges of nodes after
+   * SortAllEdgesByDest on a graph without multi-edges.
+   *
+   * @returns number of destinations in both [a_begin, a_end) and
+   *     [b_begin, b_end)
+   */
+  size_t CountCommonDests(
+      const edge_iterator& a_begin, const edge_iterator& a_end,
+      const edge_iterator& b_begin, const edge_iterator& b_end) const {
+    const NodeId* dests = topology().out_dests->raw_values();
+    if constexpr (std::is_same_v<NodeId, uint32_t>) {
+      return CountSortedIntersection(
+          dests + *a_begin, *a_end - *a_begin, dests + *b_begin,
+          *b_end - *b_begin);
+    } else {
+      size_t count = 0;
+      for (uint64_t a = *a_begin, b = *b_begin; a < *a_end && b < *b_end;) {
+        if (dests[a] < dests[b]) {
+          ++a;
+        } else if (dests[b] < dests[a]) {
+          ++b;
+        } else {
+          ++count;
+          ++a;
+          ++b;
+        }
+      }
+      return count;
+    }
+  }
+
+  /**
+   * Counts the neighbors common to two nodes; requires that the edges of each
+   * node be sorted by destination (\see PropertyFileGraph::topology()) and
+   * that there be no multi-edges.
+   *
+   * @returns number of nodes that are destinations of both a and b
+   */
+  size_t CountCommonNeighbors(Node a, Node b) const {
+    assert(topology().edges_sorted_by_dest);
+    return CountCommonDests(
+        edge_begin(a), edge_end(a), edge_begin(b), edge_end(b));
+  }
+
   /**
    * Accessor for the underlying PropertyFileGraph.
    *
@@ -173,12 +324,19 @@ public:
    */
   const PropertyFileGraph& GetPropertyFileGraph() const { return *pfg_; }
 
-  // Graph constructors
-  static Result<PropertyGraph<NodeProps, EdgeProps>> Make(
+  /**
+   * The topology of the underlying PropertyFileGraph for NodeId.
+   */
+  const BasicGraphTopology<NodeId>& topology() const {
+    return pfg_->template basic_topology<NodeId>();
+  }
+
+  // Graph constructors; they fail with invalid_argument if the width of the
+  // node ids of pfg is not that of NodeId
+  static Result<PropertyGraph> Make(
       PropertyFileGraph* pfg, const std::vector<std::string>& node_properties,
       const std::vector<std::string>& edge_properties);
-  static Result<PropertyGraph<NodeProps, EdgeProps>> Make(
-      PropertyFileGraph* pfg);
+  static Result<PropertyGraph> Make(PropertyFileGraph* pfg);
 };
 
 /**
@@ -194,16 +352,26 @@ GALOIS_EXPORT typename GraphTy::edge_iterator
 FindEdgeSortedByDest(
     const GraphTy& graph, typename GraphTy::Node node,
     typename GraphTy::Node node_to_find) {
+  static_assert(
+      std::is_same_v<typename GraphTy::Node, uint32_t>,
+      "only graphs with 32-bit node ids are supported");
   auto edge_matched = galois::graphs::FindEdgeSortedByDest(
       graph.GetPropertyFileGraph(), node, node_to_find);
   return typename GraphTy::edge_iterator(edge_matched);
 }
 
-template <typename NodeProps, typename EdgeProps>
-Result<PropertyGraph<NodeProps, EdgeProps>>
-PropertyGraph<NodeProps, EdgeProps>::Make(
+template <typename NodeProps, typename EdgeProps, typename NodeId>
+Result<PropertyGraph<NodeProps, EdgeProps, NodeId>>
+PropertyGraph<NodeProps, EdgeProps, NodeId>::Make(
     PropertyFileGraph* pfg, const std::vector<std::string>& node_properties,
     const std::vector<std::string>& edge_properties) {
+  if (pfg->HasWideNodeIds() != std::is_same_v<NodeId, uint64_t>) {
+    GALOIS_LOG_DEBUG(
+        "graph node ids are {} bits but the view expects {}",
+        pfg->HasWideNodeIds() ? 64 : 32, sizeof(NodeId) * 8);
+    return ErrorCode::InvalidArgument;
+  }
+
   auto node_view_result =
       internal::MakeNodePropertyViews<NodeProps>(pfg, node_properties);
   if (!node_view_result) {
@@ -221,10 +389,10 @@ PropertyGraph<NodeProps, EdgeProps>::Make(
       std::move(edge_view_result.value()));
 }
 
-template <typename NodeProps, typename EdgeProps>
-Result<PropertyGraph<NodeProps, EdgeProps>>
-PropertyGraph<NodeProps, EdgeProps>::Make(PropertyFileGraph* pfg) {
-  return PropertyGraph<NodeProps, EdgeProps>::Make(
+template <typename NodeProps, typename EdgeProps, typename NodeId>
+Result<PropertyGraph<NodeProps, EdgeProps, NodeId>>
+PropertyGraph<NodeProps, EdgeProps, NodeId>::Make(PropertyFileGraph* pfg) {
+  return PropertyGraph<NodeProps, EdgeProps, NodeId>::Make(
       pfg, pfg->node_schema()->field_names(),
       pfg->edge_schema()->field_names());
 }
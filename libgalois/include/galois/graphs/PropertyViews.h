@@ -44,6 +44,9 @@ template <typename PropTuple>
 static Result<PropertyViewTuple<PropTuple>>
 MakeNodePropertyViews(
     const PropertyFileGraph* pfg, const std::vector<std::string>& properties) {
+  if (auto res = pfg->EnsureNodePropertiesLoaded(properties); !res) {
+    return res.error();
+  }
   return MakePropertyViews<PropTuple>(pfg->node_table().get(), properties);
 }
 
@@ -68,6 +71,9 @@ template <typename PropTuple>
 static Result<PropertyViewTuple<PropTuple>>
 MakeEdgePropertyViews(
     const PropertyFileGraph* pfg, const std::vector<std::string>& properties) {
+  if (auto res = pfg->EnsureEdgePropertiesLoaded(properties); !res) {
+    return res.error();
+  }
   return MakePropertyViews<PropTuple>(pfg->edge_table().get(), properties);
 }
 
@@ -0,0 +1,46 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_GRAPHS_SHAREDMEMORYGRAPH_H_
+#define GALOIS_LIBGALOIS_GALOIS_GRAPHS_SHAREDMEMORYGRAPH_H_
+
+#include <memory>
+#include <string>
+
+#include "galois/Result.h"
+#include "galois/config.h"
+#include "galois/graphs/PropertyFileGraph.h"
+
+namespace galois::graphs {
+
+/// ExportToSharedMemory copies the topology and the properties of pfg into a
+/// new POSIX shared-memory object called name, e.g., "/my-graph", so that
+/// other processes on the same host can attach to the graph with
+/// AttachSharedMemory instead of loading a copy each. Properties that have not
+/// been loaded yet (\see PropertyFileGraph::MakeLazy) are loaded first.
+///
+/// The object outlives this process until RemoveSharedMemory(name) is called.
+/// Processes may only attach after ExportToSharedMemory returns.
+///
+/// \returns AlreadyExists if an object called name exists
+GALOIS_EXPORT Result<void> ExportToSharedMemory(
+    const PropertyFileGraph& pfg, const std::string& name);
+
+/// AttachSharedMemory maps the graph exported as name read-only and returns a
+/// PropertyFileGraph whose topology and properties point into the mapping;
+/// nothing is copied and the pages are shared by all attached processes.
+///
+/// Writing to the topology or to the properties, e.g., through
+/// PropertyGraph::GetData or SortAllEdgesByDest, faults. Properties added to
+/// the returned graph live in private memory of the process. The graph is not
+/// backed by an RDG, so it cannot be committed.
+///
+/// \returns NotFound if there is no object called name and InvalidArgument if
+/// the object does not hold a complete exported graph
+GALOIS_EXPORT Result<std::unique_ptr<PropertyFileGraph>> AttachSharedMemory(
+    const std::string& name);
+
+/// RemoveSharedMemory removes the name of an exported graph; its memory is
+/// freed once the last attached graph is destroyed
+GALOIS_EXPORT Result<void> RemoveSharedMemory(const std::string& name);
+
+}  // namespace galois::graphs
+
+#endif
@@ -20,6 +20,18 @@
 #ifndef GALOIS_LIBGALOIS_GALOIS_GRAPHS_SPATIALTREE_H_
 #define GALOIS_LIBGALOIS_GALOIS_GRAPHS_SPATIALTREE_H_
 
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "galois/LargeArray.h"
+#include "galois/Loops.h"
+#include "galois/ParallelSTL.h"
+#include "galois/Reduction.h"
 #include "galois/config.h"
 
 namespace galois {
@@ -188,6 +200,419 @@ public:
   }
 };
 
+//! Stores a fixed set of objects at specific spatial coordinates, bulk loaded
+//! in parallel. Unlike SpatialTree2d, lookups are exact, but objects cannot be
+//! added after the tree is built.
+//!
+//! build() sorts the points along a Hilbert curve over their bounding box and
+//! cuts them into leaves of kLeafSize consecutive points; each level above
+//! groups kFanout consecutive nodes of the level below, up to a single root.
+//! Consecutive points on a Hilbert curve are always close, so nodes have
+//! small boxes; a Z-order curve jumps and makes lookups visit several times
+//! as many leaves. The tree is implicit in this order: the children of a node
+//! and the points under it are contiguous, so a node is only its bounding
+//! box, the boxes of each level are stored contiguously, and the coordinates
+//! of the points are kept in separate arrays that lookups scan linearly.
+template <typename T>
+class PackedSpatialTree2d {
+public:
+  //! An axis-aligned rectangle, including its boundary
+  struct Rect {
+    double xmin;
+    double ymin;
+    double xmax;
+    double ymax;
+  };
+
+  //! An object found by a nearest neighbor lookup
+  struct Neighbor {
+    double distance;
+    const T* value;
+  };
+
+  static constexpr size_t kLeafBits = 4;
+  static constexpr size_t kFanoutBits = 3;
+  //! Points per leaf
+  static constexpr size_t kLeafSize = size_t{1} << kLeafBits;
+  //! Children per internal node
+  static constexpr size_t kFanout = size_t{1} << kFanoutBits;
+
+private:
+  //! Enough levels for 2^64 points
+  static constexpr size_t kMaxLevels =
+      (64 - kLeafBits + kFanoutBits - 1) / kFanoutBits + 1;
+
+  //! A node still to visit in a lookup
+  struct Pending {
+    double distance2;
+    size_t level;
+    size_t node;
+  };
+
+  //! A point with its position on the Hilbert curve
+  struct Keyed {
+    uint64_t code;
+    size_t index;
+  };
+
+  galois::LargeArray<double> xs_;
+  galois::LargeArray<double> ys_;
+  galois::LargeArray<T> values_;
+  size_t size_ = 0;
+  Rect bounds_{};
+  double xscale_ = 0;
+  double yscale_ = 0;
+
+  //! The bounding boxes of all nodes, level by level from the leaves up
+  std::vector<Rect> boxes_;
+  //! The index in boxes_ of the first node of each level, and the number of
+  //! nodes
+  std::vector<size_t> level_begin_;
+
+  static uint32_t quantize(double v, double min, double scale) {
+    double q = (v - min) * scale;
+    if (!(q > 0)) {
+      return 0;
+    }
+    if (q >= std::numeric_limits<uint32_t>::max()) {
+      return std::numeric_limits<uint32_t>::max();
+    }
+    return static_cast<uint32_t>(q);
+  }
+
+  //! The position of (x, y) on the Hilbert curve over bounds_; points
+  //! outside of bounds_ are clamped to it
+  uint64_t curveIndex(double x, double y) const {
+    uint32_t qx = quantize(x, bounds_.xmin, xscale_);
+    uint32_t qy = quantize(y, bounds_.ymin, yscale_);
+    uint64_t d = 0;
+    for (uint32_t s = uint32_t{1} << 31; s > 0; s >>= 1) {
+      uint32_t rx = (qx & s) != 0;
+      uint32_t ry = (qy & s) != 0;
+      d += uint64_t{s} * s * ((3 * rx) ^ ry);
+      // Turn the quadrant so the rest of the curve enters it at the origin
+      if (ry == 0) {
+        if (rx == 1) {
+          qx = ~qx;
+          qy = ~qy;
+        }
+        std::swap(qx, qy);
+      }
+    }
+    return d;
+  }
+
+  static double minDistance2(const Rect& r, double x, double y) {
+    double dx = std::max(std::max(r.xmin - x, x - r.xmax), 0.0);
+    double dy = std::max(std::max(r.ymin - y, y - r.ymax), 0.0);
+    return dx * dx + dy * dy;
+  }
+
+  static bool intersects(const Rect& a, const Rect& b) {
+    return a.xmin <= b.xmax && b.xmin <= a.xmax && a.ymin <= b.ymax &&
+           b.ymin <= a.ymax;
+  }
+
+  static bool contains(const Rect& outer, const Rect& inner) {
+    return outer.xmin <= inner.xmin && inner.xmax <= outer.xmax &&
+           outer.ymin <= inner.ymin && inner.ymax <= outer.ymax;
+  }
+
+  static bool contains(const Rect& r, double x, double y) {
+    return r.xmin <= x && x <= r.xmax && r.ymin <= y && y <= r.ymax;
+  }
+
+  size_t numLevels() const { return level_begin_.size() - 1; }
+
+  const Rect& box(size_t level, size_t node) const {
+    return boxes_[level_begin_[level] + node];
+  }
+
+  //! The children of node, which is not a leaf, in the level below
+  std::pair<size_t, size_t> children(size_t level, size_t node) const {
+    size_t below = level_begin_[level] - level_begin_[level - 1];
+    size_t begin = node << kFanoutBits;
+    return {begin, std::min(begin + kFanout, below)};
+  }
+
+  //! The indices of the points under node
+  std::pair<size_t, size_t> points(size_t level, size_t node) const {
+    size_t begin = node << (kLeafBits + level * kFanoutBits);
+    size_t end = (node + 1) << (kLeafBits + level * kFanoutBits);
+    return {begin, std::min(end, size_)};
+  }
+
+  //! Calls fn(i) for every i in [0, num) in parallel, in the order along the
+  //! Hilbert curve of point(i), so that the lookups each thread runs in a row
+  //! visit the same nodes
+  template <typename PointFn, typename F>
+  void inCurveOrder(size_t num, const PointFn& point, const F& fn) const {
+    galois::LargeArray<Keyed> order;
+    order.allocateBlocked(num);
+    galois::do_all(
+        galois::iterate(size_t{0}, num),
+        [&](size_t i) {
+          auto [x, y] = point(i);
+          order[i] = Keyed{curveIndex(x, y), i};
+        },
+        galois::no_stats());
+    galois::ParallelSTL::radix_sort(
+        order.begin(), order.end(), [](const Keyed& k) { return k.code; });
+    galois::do_all(
+        galois::iterate(size_t{0}, num), [&](size_t i) { fn(order[i].index); },
+        galois::steal(), galois::no_stats());
+  }
+
+public:
+  PackedSpatialTree2d() = default;
+
+  size_t size() const { return size_; }
+
+  bool empty() const { return size_ == 0; }
+
+  //! Replaces the contents of the tree with the objects values[i] at
+  //! (xs[i], ys[i]) for i in [0, size). The coordinates must be finite.
+  template <typename XIter, typename YIter, typename ValueIter>
+  void build(XIter xs, YIter ys, ValueIter values, size_t size) {
+    xs_.destroy();
+    xs_.deallocate();
+    ys_.destroy();
+    ys_.deallocate();
+    values_.destroy();
+    values_.deallocate();
+    boxes_.clear();
+    level_begin_.clear();
+    size_ = size;
+    if (size == 0) {
+      return;
+    }
+
+    galois::GReduceMin<double> xmin;
+    galois::GReduceMin<double> ymin;
+    galois::GReduceMax<double> xmax;
+    galois::GReduceMax<double> ymax;
+    galois::do_all(
+        galois::iterate(size_t{0}, size),
+        [&](size_t i) {
+          xmin.update(xs[i]);
+          ymin.update(ys[i]);
+          xmax.update(xs[i]);
+          ymax.update(ys[i]);
+        },
+        galois::no_stats());
+    bounds_ = Rect{xmin.reduce(), ymin.reduce(), xmax.reduce(), ymax.reduce()};
+    double extent_x = bounds_.xmax - bounds_.xmin;
+    double extent_y = bounds_.ymax - bounds_.ymin;
+    constexpr double kCells = std::numeric_limits<uint32_t>::max();
+    xscale_ = extent_x > 0 ? kCells / extent_x : 0;
+    yscale_ = extent_y > 0 ? kCells / extent_y : 0;
+
+    galois::LargeArray<Keyed> order;
+    order.allocateBlocked(size);
+    galois::do_all(
+        galois::iterate(size_t{0}, size),
+        [&](size_t i) { order[i] = Keyed{curveIndex(xs[i], ys[i]), i}; },
+        galois::no_stats());
+    galois::ParallelSTL::radix_sort(
+        order.begin(), order.end(), [](const Keyed& k) { return k.code; });
+
+    xs_.allocateBlocked(size);
+    ys_.allocateBlocked(size);
+    values_.allocateBlocked(size);
+    galois::do_all(
+        galois::iterate(size_t{0}, size),
+        [&](size_t i) {
+          size_t from = order[i].index;
+          xs_[i] = xs[from];
+          ys_[i] = ys[from];
+          values_.constructAt(i, values[from]);
+        },
+        galois::no_stats());
+
+    level_begin_.push_back(0);
+    for (size_t n = (size + kLeafSize - 1) >> kLeafBits;;
+         n = (n + kFanout - 1) >> kFanoutBits) {
+      level_begin_.push_back(level_begin_.back() + n);
+      if (n == 1) {
+        break;
+      }
+    }
+    assert(numLevels() <= kMaxLevels);
+    boxes_.resize(level_begin_.back());
+
+    galois::do_all(
+        galois::iterate(size_t{0}, level_begin_[1]),
+        [&](size_t leaf) {
+          auto [begin, end] = points(0, leaf);
+          Rect r{xs_[begin], ys_[begin], xs_[begin], ys_[begin]};
+          for (size_t i = begin + 1; i < end; ++i) {
+            r.xmin = std::min(r.xmin, xs_[i]);
+            r.ymin = std::min(r.ymin, ys_[i]);
+            r.xmax = std::max(r.xmax, xs_[i]);
+            r.ymax = std::max(r.ymax, ys_[i]);
+          }
+          boxes_[leaf] = r;
+        },
+        galois::no_stats());
+
+    for (size_t level = 1; level < numLevels(); ++level) {
+      galois::do_all(
+          galois::iterate(level_begin_[level], level_begin_[level + 1]),
+          [&](size_t index) {
+            auto [begin, end] = children(level, index - level_begin_[level]);
+            Rect r = box(level - 1, begin);
+            for (size_t c = begin + 1; c < end; ++c) {
+              const Rect& child = box(level - 1, c);
+              r.xmin = std::min(r.xmin, child.xmin);
+              r.ymin = std::min(r.ymin, child.ymin);
+              r.xmax = std::max(r.xmax, child.xmax);
+              r.ymax = std::max(r.ymax, child.ymax);
+            }
+            boxes_[index] = r;
+          },
+          galois::no_stats());
+    }
+  }
+
+  //! Finds the k objects nearest to (x, y) and stores them in out, nearest
+  //! first; objects at the same distance are in no particular order. Returns
+  //! the number of objects found, which is k unless the tree has fewer.
+  size_t nearest(double x, double y, size_t k, Neighbor* out) const {
+    if (size_ == 0 || k == 0) {
+      return 0;
+    }
+
+    // While searching, out[0, found) is a max-heap by squared distance
+    auto farther = [](const Neighbor& a, const Neighbor& b) {
+      return a.distance < b.distance;
+    };
+    size_t found = 0;
+    auto bound = [&]() {
+      return found < k ? std::numeric_limits<double>::infinity()
+                       : out[0].distance;
+    };
+
+    Pending stack[kMaxLevels * kFanout];
+    size_t top = 0;
+    stack[top++] = Pending{0, numLevels() - 1, 0};
+    double distance2[std::max(kLeafSize, kFanout)];
+
+    while (top > 0) {
+      Pending p = stack[--top];
+      if (p.distance2 >= bound()) {
+        continue;
+      }
+
+      if (p.level == 0) {
+        auto [begin, end] = points(0, p.node);
+        for (size_t i = begin; i < end; ++i) {
+          double dx = xs_[i] - x;
+          double dy = ys_[i] - y;
+          distance2[i - begin] = dx * dx + dy * dy;
+        }
+        for (size_t i = begin; i < end; ++i) {
+          double d = distance2[i - begin];
+          if (found < k) {
+            out[found++] = Neighbor{d, &values_[i]};
+            std::push_heap(out, out + found, farther);
+          } else if (d < out[0].distance) {
+            std::pop_heap(out, out + k, farther);
+            out[k - 1] = Neighbor{d, &values_[i]};
+            std::push_heap(out, out + k, farther);
+          }
+        }
+        continue;
+      }
+
+      auto [begin, end] = children(p.level, p.node);
+      const Rect* below = &boxes_[level_begin_[p.level - 1]];
+      for (size_t c = begin; c < end; ++c) {
+        distance2[c - begin] = minDistance2(below[c], x, y);
+      }
+      // Visit the nearest child first, so the bound shrinks early
+      size_t first = top;
+      for (size_t c = begin; c < end; ++c) {
+        if (distance2[c - begin] < bound()) {
+          stack[top++] = Pending{distance2[c - begin], p.level - 1, c};
+        }
+      }
+      std::sort(stack + first, stack + top, [](const auto& a, const auto& b) {
+        return a.distance2 > b.distance2;
+      });
+    }
+
+    std::sort_heap(out, out + found, farther);
+    for (size_t i = 0; i < found; ++i) {
+      out[i].distance = std::sqrt(out[i].distance);
+    }
+    return found;
+  }
+
+  //! Calls fn(value) for every object in r, in no particular order
+  template <typename F>
+  void range(const Rect& r, const F& fn) const {
+    if (size_ == 0) {
+      return;
+    }
+
+    Pending stack[kMaxLevels * kFanout];
+    size_t top = 0;
+    if (intersects(r, box(numLevels() - 1, 0))) {
+      stack[top++] = Pending{0, numLevels() - 1, 0};
+    }
+
+    while (top > 0) {
+      Pending p = stack[--top];
+      auto [begin, end] = points(p.level, p.node);
+      if (contains(r, box(p.level, p.node))) {
+        for (size_t i = begin; i < end; ++i) {
+          fn(values_[i]);
+        }
+      } else if (p.level == 0) {
+        for (size_t i = begin; i < end; ++i) {
+          if (contains(r, xs_[i], ys_[i])) {
+            fn(values_[i]);
+          }
+        }
+      } else {
+        auto [cbegin, cend] = children(p.level, p.node);
+        for (size_t c = cbegin; c < cend; ++c) {
+          if (intersects(r, box(p.level - 1, c))) {
+            stack[top++] = Pending{0, p.level - 1, c};
+          }
+        }
+      }
+    }
+  }
+
+  //! Runs nearest(xs[i], ys[i], k, out + i * k) for every i in [0, num) in
+  //! parallel and stores the number of objects it found in found[i]
+  template <typename XIter, typename YIter>
+  void nearestBatch(
+      XIter xs, YIter ys, size_t num, size_t k, Neighbor* out,
+      size_t* found) const {
+    inCurveOrder(
+        num, [&](size_t i) { return std::make_pair(xs[i], ys[i]); },
+        [&](size_t i) { found[i] = nearest(xs[i], ys[i], k, out + i * k); });
+  }
+
+  //! Runs range(rects[i], ...) for every i in [0, num) in parallel, calling
+  //! fn(i, value) for every object in rects[i]
+  template <typename RectIter, typename F>
+  void rangeBatch(RectIter rects, size_t num, const F& fn) const {
+    inCurveOrder(
+        num,
+        [&](size_t i) {
+          const Rect& r = rects[i];
+          return std::make_pair(
+              (r.xmin + r.xmax) / 2.0, (r.ymin + r.ymax) / 2.0);
+        },
+        [&](size_t i) {
+          range(rects[i], [&](const T& value) { fn(i, value); });
+        });
+  }
+};
+
 }  // namespace graphs
 }  // namespace galois
 
@@ -0,0 +1,86 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_GRAPHS_SUBGRAPH_H_
+#define GALOIS_LIBGALOIS_GALOIS_GRAPHS_SUBGRAPH_H_
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "galois/Result.h"
+#include "galois/config.h"
+#include "galois/graphs/PropertyFileGraph.h"
+
+namespace galois::graphs {
+
+/// The node property of an extracted subgraph that holds the id each node
+/// has in the graph it was extracted from
+constexpr char kParentNodeIdProperty[] = "parent_node_id";
+/// The edge property of an extracted subgraph that holds the index each edge
+/// has in the graph it was extracted from
+constexpr char kParentEdgeIdProperty[] = "parent_edge_id";
+
+/// The fanout that keeps every neighbor of a node in SampleNeighborhood
+constexpr uint32_t kAllNeighbors = std::numeric_limits<uint32_t>::max();
+
+/// The node that fills the rest of a random walk that reached a node without
+/// out-edges
+constexpr uint32_t kNoNode = std::numeric_limits<uint32_t>::max();
+
+/// The subgraphs below are new graphs made of compact copies of part of pfg:
+/// node i of a subgraph is node new_to_old[i] of pfg, the edges of each node
+/// keep their order in pfg and the named node and edge properties of pfg are
+/// copied for the nodes and edges kept. Whatever the names, the subgraph also
+/// gets the uint32 node property kParentNodeIdProperty and the uint64 edge
+/// property kParentEdgeIdProperty, which map it back to pfg, e.g., to gather
+/// features that were not copied. They are not persistent.
+///
+/// \returns PropertyNotFound if a property name is not in pfg and
+/// InvalidArgument if a node is not in pfg
+
+/// ExtractInducedSubgraph returns the subgraph of nodes, in that order, and of
+/// all the edges of pfg between them.
+///
+/// \returns InvalidArgument if a node appears more than once
+GALOIS_EXPORT Result<std::unique_ptr<PropertyFileGraph>> ExtractInducedSubgraph(
+    const PropertyFileGraph& pfg, const std::vector<uint32_t>& nodes,
+    const std::vector<std::string>& node_properties,
+    const std::vector<std::string>& edge_properties);
+
+/// SampleNeighborhood samples the k-hop out-neighborhood of seeds, where k is
+/// fanouts.size(): every node first reached at hop h < k keeps at most
+/// fanouts[h] of its out-edges, chosen uniformly at random without
+/// replacement, or all of them if fanouts[h] is kAllNeighbors. It returns the
+/// subgraph of the kept edges, whose nodes are the seeds followed by the
+/// nodes reached at each hop, in order. Nodes reached at the last hop have
+/// no edges.
+///
+/// Nodes are sampled in parallel, and the same random_seed gives the same
+/// subgraph for any number of threads.
+GALOIS_EXPORT Result<std::unique_ptr<PropertyFileGraph>> SampleNeighborhood(
+    const PropertyFileGraph& pfg, const std::vector<uint32_t>& seeds,
+    const std::vector<uint32_t>& fanouts, uint64_t random_seed,
+    const std::vector<std::string>& node_properties,
+    const std::vector<std::string>& edge_properties);
+
+/// RandomWalks runs one uniform random walk of walk_length out-edges from
+/// each of starts in parallel and returns the walks one after another, each
+/// walk_length + 1 nodes long beginning with its start. A walk that reaches a
+/// node without out-edges is filled up with kNoNode. The same random_seed
+/// gives the same walks for any number of threads.
+GALOIS_EXPORT Result<std::vector<uint32_t>> RandomWalks(
+    const GraphTopology& topology, const std::vector<uint32_t>& starts,
+    uint32_t walk_length, uint64_t random_seed);
+
+/// SampleRandomWalks returns the subgraph of the edges taken by the walks of
+/// RandomWalks, each once, whose nodes are the nodes visited in the order in
+/// which the walks first list them
+GALOIS_EXPORT Result<std::unique_ptr<PropertyFileGraph>> SampleRandomWalks(
+    const PropertyFileGraph& pfg, const std::vector<uint32_t>& starts,
+    uint32_t walk_length, uint64_t random_seed,
+    const std::vector<std::string>& node_properties,
+    const std::vector<std::string>& edge_properties);
+
+}  // namespace galois::graphs
+
+#endif
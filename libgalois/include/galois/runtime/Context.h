@@ -20,8 +20,11 @@
 #ifndef GALOIS_LIBGALOIS_GALOIS_RUNTIME_CONTEXT_H_
 #define GALOIS_LIBGALOIS_GALOIS_RUNTIME_CONTEXT_H_
 
+#include <atomic>
 #include <cassert>
 #include <cstdlib>
+#include <utility>
+#include <vector>
 
 #include <boost/utility.hpp>
 
@@ -85,11 +88,25 @@ class GALOIS_EXPORT Lockable {
   //! allocation overhead. Works for cases where a Lockable needs to be only in
   //! one context's neighborhood list
   Lockable* next;
+  //! Incremented each time an iteration that detects conflicts of reads
+  //! optimistically releases the lock, so that those reads can be validated
+  std::atomic<unsigned> version;
   friend class LockManagerBase;
   friend class SimpleRuntimeContext;
 
 public:
-  Lockable() : next(0) {}
+  Lockable() : next(0), version(0) {}
+  Lockable(const Lockable& l)
+      : owner(l.owner),
+        next(l.next),
+        version(l.version.load(std::memory_order_relaxed)) {}
+  Lockable& operator=(const Lockable& l) {
+    owner = l.owner;
+    next = l.next;
+    version.store(
+        l.version.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    return *this;
+  }
 };
 
 class GALOIS_EXPORT LockManagerBase : private boost::noncopyable {
@@ -131,10 +148,31 @@ protected:
   }
 };
 
+/**
+ * Conflict detection for an iteration: it locks each object that it acquires
+ * and aborts when another iteration holds the lock.
+ *
+ * With optimistic reads, objects acquired with MethodFlag::READ are not
+ * locked; the iteration records their versions instead and aborts if any of
+ * them changed or is locked by another iteration when it is validated. This
+ * happens when the iteration first acquires an object to write, after which
+ * its acquires lock as usual, or when it ends if it never does. Like locks,
+ * this requires operators that acquire everything they read before writing
+ * anything (i.e., cautious operators).
+ */
 class GALOIS_EXPORT SimpleRuntimeContext : public LockManagerBase {
   //! The locks we hold
   Lockable* locks;
   bool customAcquire;
+  bool optimisticReads;
+  //! Whether the iteration has locked anything since optimistic reads began
+  bool lockedAny;
+  //! Objects read optimistically and their versions when read
+  std::vector<std::pair<Lockable*, unsigned>> readSet;
+  size_t numValidationFailures;
+
+  void addToReadSet(Lockable* lockable);
+  void validateReads();
 
 protected:
   friend void doAcquire(Lockable*, galois::MethodFlag);
@@ -156,10 +194,18 @@ protected:
     AcquireStatus i;
     if (customAcquire) {
       subAcquire(lockable, m);
+    } else if (
+        optimisticReads && !lockedAny &&
+        (m & galois::MethodFlag::INTERNAL_MASK) == galois::MethodFlag::READ) {
+      addToReadSet(lockable);
     } else if ((i = tryAcquire(lockable)) != AcquireStatus::FAIL) {
       if (i == AcquireStatus::NEW_OWNER) {
         addToNhood(lockable);
       }
+      if (optimisticReads && !lockedAny) {
+        lockedAny = true;
+        validateReads();
+      }
     } else {
       signalConflict(lockable);
     }
@@ -168,10 +214,32 @@ protected:
   void release(Lockable* lockable);
 
 public:
-  SimpleRuntimeContext(bool child = false) : locks(0), customAcquire(child) {}
+  SimpleRuntimeContext(bool child = false)
+      : locks(0),
+        customAcquire(child),
+        optimisticReads(false),
+        lockedAny(false),
+        numValidationFailures(0) {}
   virtual ~SimpleRuntimeContext() {}
 
-  void startIteration() { assert(!locks); }
+  //! Detects conflicts of READ acquires by validation rather than locks
+  void setOptimisticReads(bool optimistic) {
+    assert(!customAcquire);
+    optimisticReads = optimistic;
+  }
+
+  void startIteration() { assert(!locks && readSet.empty()); }
+
+  //! Validates the optimistic reads of an iteration that has not locked
+  //! anything before it commits; signals a conflict if they are invalid
+  void validateIteration() {
+    if (!lockedAny && !readSet.empty()) {
+      validateReads();
+    }
+  }
+
+  //! Number of iterations aborted because their optimistic reads were invalid
+  size_t validationFailures() const { return numValidationFailures; }
 
   unsigned cancelIteration();
   unsigned commitIteration();
@@ -0,0 +1,234 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_RUNTIME_EDGETILEDEXECUTOR_H_
+#define GALOIS_LIBGALOIS_GALOIS_RUNTIME_EDGETILEDEXECUTOR_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/ParallelSTL.h"
+
+namespace galois::runtime {
+
+/**
+ * Runs sweeps over all the edges of a CSR graph, e.g., the topology of a
+ * PropertyGraph, tile by tile. Unlike Fixed2DGraphTiledExecutor, which is
+ * specialized to the bipartite graphs of matrix completion, it works for any
+ * graph. Unlike DoAllEdgeTiles (\see galois/EdgeTiles.h), which splits the
+ * edges of hubs for balance, it groups edges for locality.
+ *
+ * The nodes are split into blocks of consecutive ids whose data fits in
+ * half of an L2 cache, and tile (i, j) holds the edges from block i to
+ * block j, so that an edge sweep of a tile touches the data of two blocks
+ * only. The tiling is built once, in parallel, and reused by every sweep
+ * until the edges change.
+ *
+ * A sweep runs the tiles in rounds: round r runs tile (i, (i + r) mod B) of
+ * every source block i in parallel, so that tiles that run at the same time
+ * share neither their source nor their destination block. The operator can
+ * therefore update the data of both ends of an edge without locks or
+ * atomics, as PageRank, label propagation and SGD do.
+ *
+ * @tparam NodeId type of the edge destinations
+ */
+template <typename NodeId>
+class EdgeTiledExecutor {
+public:
+  //! The default cache budget of a tile, that of a typical L2 cache
+  static constexpr uint64_t kDefaultCacheBytes = 256 * 1024;
+
+  //! The default bytes of node data that an operator touches per node
+  static constexpr uint64_t kDefaultNodeBytes = 8;
+
+private:
+  uint64_t num_nodes_{0};
+  uint64_t block_nodes_{1};
+  uint64_t num_blocks_{0};
+
+  //! the end of tile (i, j), at i * num_blocks_ + j, in srcs_ and edges_
+  LargeArray<uint64_t> tile_offsets_;
+  //! the source and id of each edge, grouped by tile
+  LargeArray<NodeId> srcs_;
+  LargeArray<uint64_t> edges_;
+  const NodeId* dests_{nullptr};
+  bool built_{false};
+
+  uint64_t block(uint64_t node) const { return node / block_nodes_; }
+
+  uint64_t tile(uint64_t src_block, uint64_t dst_block) const {
+    return src_block * num_blocks_ + dst_block;
+  }
+
+  uint64_t tile_begin(uint64_t t) const {
+    return t == 0 ? 0 : tile_offsets_[t - 1];
+  }
+
+  uint64_t tile_end(uint64_t t) const { return tile_offsets_[t]; }
+
+  uint64_t block_begin(uint64_t b) const { return b * block_nodes_; }
+
+  uint64_t block_end(uint64_t b) const {
+    return std::min(num_nodes_, (b + 1) * block_nodes_);
+  }
+
+  template <typename EdgeFn>
+  void ForEachBlockEdge(
+      uint64_t b, const uint64_t* out_indices, EdgeFn fn) const {
+    for (uint64_t n = block_begin(b); n < block_end(b); ++n) {
+      for (uint64_t e = n == 0 ? 0 : out_indices[n - 1]; e < out_indices[n];
+           ++e) {
+        fn(n, e);
+      }
+    }
+  }
+
+public:
+  /**
+   * Builds the tiles of the out-edges of num_nodes nodes in CSR format.
+   *
+   * Blocks hold cache_bytes / (2 * node_bytes) nodes, fewer if that would
+   * leave fewer blocks than threads to run the tiles of a round and more if
+   * that would make more tiles than edges.
+   *
+   * @param out_indices the end of the edges of each node
+   * @param dests the destination of each edge, which must outlive the tiles
+   * @param node_bytes the bytes of node data that an operator touches per
+   *     node
+   * @param cache_bytes the cache budget of a tile
+   */
+  void Build(
+      uint64_t num_nodes, const uint64_t* out_indices, const NodeId* dests,
+      uint64_t node_bytes = kDefaultNodeBytes,
+      uint64_t cache_bytes = kDefaultCacheBytes) {
+    clear();
+    num_nodes_ = num_nodes;
+    dests_ = dests;
+    if (num_nodes == 0) {
+      built_ = true;
+      return;
+    }
+
+    uint64_t threads = galois::getActiveThreads();
+    block_nodes_ = std::max<uint64_t>(
+        1, cache_bytes / (2 * std::max<uint64_t>(node_bytes, 1)));
+    block_nodes_ = std::min(block_nodes_, (num_nodes + threads - 1) / threads);
+    // but no more tiles than edges, or than a round of tiles per thread
+    uint64_t max_blocks = std::max<uint64_t>(
+        std::sqrt(static_cast<double>(out_indices[num_nodes - 1])), threads);
+    block_nodes_ =
+        std::max(block_nodes_, (num_nodes + max_blocks - 1) / max_blocks);
+    num_blocks_ = (num_nodes + block_nodes_ - 1) / block_nodes_;
+
+    uint64_t num_tiles = num_blocks_ * num_blocks_;
+    tile_offsets_.allocateInterleaved(num_tiles + 1);
+    galois::do_all(
+        galois::iterate(uint64_t{0}, num_tiles + 1),
+        [&](uint64_t t) { tile_offsets_[t] = 0; }, galois::no_stats());
+
+    // each source block counts and then places its own row of tiles
+    galois::do_all(
+        galois::iterate(uint64_t{0}, num_blocks_),
+        [&](uint64_t b) {
+          ForEachBlockEdge(b, out_indices, [&](uint64_t, uint64_t e) {
+            tile_offsets_[tile(b, block(dests_[e]))] += 1;
+          });
+        },
+        galois::steal(), galois::no_stats(),
+        galois::loopname("EdgeTilesCount"));
+
+    galois::ParallelSTL::exclusive_scan(
+        tile_offsets_.begin(), tile_offsets_.end(), tile_offsets_.begin(),
+        uint64_t{0});
+
+    uint64_t num_edges = tile_offsets_[num_tiles];
+    srcs_.allocateInterleaved(num_edges);
+    edges_.allocateInterleaved(num_edges);
+    galois::do_all(
+        galois::iterate(uint64_t{0}, num_blocks_),
+        [&](uint64_t b) {
+          // placing moves the offset of each tile from its beginning to its
+          // end
+          ForEachBlockEdge(b, out_indices, [&](uint64_t n, uint64_t e) {
+            uint64_t& next = tile_offsets_[tile(b, block(dests_[e]))];
+            srcs_[next] = n;
+            edges_[next] = e;
+            ++next;
+          });
+        },
+        galois::steal(), galois::no_stats(),
+        galois::loopname("EdgeTilesPlace"));
+    built_ = true;
+  }
+
+  /**
+   * Builds the tiles of the topology of graph, e.g., a PropertyGraph or
+   * PropertyFileGraph.
+   */
+  template <typename Graph>
+  void BuildFromTopology(
+      const Graph& graph, uint64_t node_bytes = kDefaultNodeBytes,
+      uint64_t cache_bytes = kDefaultCacheBytes) {
+    const auto& topology = graph.topology();
+    const uint64_t* out_indices = graph.num_nodes() == 0
+                                      ? nullptr
+                                      : topology.out_indices->raw_values();
+    const NodeId* dests =
+        graph.num_edges() == 0 ? nullptr : topology.out_dests->raw_values();
+    Build(graph.num_nodes(), out_indices, dests, node_bytes, cache_bytes);
+  }
+
+  //! Drops the tiles
+  void clear() {
+    tile_offsets_.destroy();
+    tile_offsets_.deallocate();
+    srcs_.destroy();
+    srcs_.deallocate();
+    edges_.destroy();
+    edges_.deallocate();
+    num_nodes_ = 0;
+    block_nodes_ = 1;
+    num_blocks_ = 0;
+    dests_ = nullptr;
+    built_ = false;
+  }
+
+  bool built() const { return built_; }
+
+  uint64_t num_blocks() const { return num_blocks_; }
+
+  uint64_t block_nodes() const { return block_nodes_; }
+
+  //! The number of edges of tile (src_block, dst_block)
+  uint64_t tile_size(uint64_t src_block, uint64_t dst_block) const {
+    uint64_t t = tile(src_block, dst_block);
+    return tile_end(t) - tile_begin(t);
+  }
+
+  /**
+   * Calls fn(src, dst, edge) on every edge, in rounds of tiles that share
+   * neither source nor destination blocks. Within a tile, edges are in the
+   * order of their sources, and the edges of a source in edge order.
+   */
+  template <typename EdgeFn>
+  void ForEachEdge(EdgeFn fn, const char* loopname = "EdgeTiledSweep") const {
+    assert(built());
+    for (uint64_t round = 0; round < num_blocks_; ++round) {
+      galois::do_all(
+          galois::iterate(uint64_t{0}, num_blocks_),
+          [&](uint64_t b) {
+            uint64_t t = tile(b, (b + round) % num_blocks_);
+            for (uint64_t i = tile_begin(t), end = tile_end(t); i < end; ++i) {
+              uint64_t e = edges_[i];
+              fn(srcs_[i], dests_[e], e);
+            }
+          },
+          galois::steal(), galois::no_stats(), galois::loopname(loopname));
+    }
+  }
+};
+
+}  // namespace galois::runtime
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_RUNTIME_EPOCHLIMBO_H_
+#define GALOIS_LIBGALOIS_GALOIS_RUNTIME_EPOCHLIMBO_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "galois/substrate/EpochManager.h"
+#include "galois/substrate/PerThreadStorage.h"
+
+namespace galois::runtime {
+
+/**
+ * The retired objects of one container, until no thread can read them: each
+ * thread keeps what it retired in buckets by epoch, and hands the objects of
+ * a bucket two epochs old to a reclaim function, which e.g. puts them on a
+ * free list. Retiring and collecting only touch the calling thread's buckets,
+ * so neither takes a lock.
+ *
+ * Three buckets suffice: the bucket of the current epoch is the one of an
+ * epoch at least three older, whose objects are reclaimable, so when a
+ * thread retires into a bucket of an old epoch, it reclaims it first.
+ */
+template <typename T>
+class EpochLimbo {
+  static constexpr unsigned kBuckets = 3;
+
+  struct Bucket {
+    uint64_t epoch{substrate::EpochManager::kFirstEpoch};
+    std::vector<T*> items;
+  };
+
+  struct Local {
+    Bucket buckets[kBuckets];
+  };
+
+  substrate::PerThreadStorage<Local> locals_;
+
+  template <typename ReclaimFn>
+  static void Drain(Bucket* bucket, ReclaimFn& reclaim) {
+    for (T* item : bucket->items) {
+      reclaim(item);
+    }
+    bucket->items.clear();
+  }
+
+public:
+  //! Retires item, which the caller unlinked from the container; objects of
+  //! older epochs that this displaces go to reclaim
+  template <typename ReclaimFn>
+  void Retire(T* item, ReclaimFn&& reclaim) {
+    uint64_t epoch = substrate::GetEpochManager().RetireEpoch();
+    Bucket& bucket = locals_.getLocal()->buckets[epoch % kBuckets];
+    if (bucket.epoch != epoch) {
+      Drain(&bucket, reclaim);
+      bucket.epoch = epoch;
+    }
+    bucket.items.push_back(item);
+  }
+
+  //! Hands the reclaimable objects that this thread retired to reclaim
+  template <typename ReclaimFn>
+  void Collect(ReclaimFn&& reclaim) {
+    const substrate::EpochManager& epochs = substrate::GetEpochManager();
+    for (Bucket& bucket : locals_.getLocal()->buckets) {
+      if (!bucket.items.empty() && epochs.Reclaimable(bucket.epoch)) {
+        Drain(&bucket, reclaim);
+      }
+    }
+  }
+
+  //! Hands every retired object to reclaim regardless of epochs, e.g., when
+  //! the container is cleared. Serial only.
+  template <typename ReclaimFn>
+  void CollectAll(ReclaimFn&& reclaim) {
+    for (unsigned i = 0; i < locals_.size(); ++i) {
+      for (Bucket& bucket : locals_.getRemote(i)->buckets) {
+        Drain(&bucket, reclaim);
+      }
+    }
+  }
+
+  //! The number of retired objects that were not reclaimed yet. Serial only.
+  size_t size() const {
+    size_t size = 0;
+    for (unsigned i = 0; i < locals_.size(); ++i) {
+      for (const Bucket& bucket : locals_.getRemote(i)->buckets) {
+        size += bucket.items.size();
+      }
+    }
+    return size;
+  }
+};
+
+}  // namespace galois::runtime
+
+#endif
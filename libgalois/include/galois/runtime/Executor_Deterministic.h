@@ -808,10 +808,14 @@ public:
   class ThreadLocalData {
     template <typename, bool>
     friend class WindowManagerBase;
-    size_t window;
-    size_t delta;
-    size_t committed;
-    size_t iterations;
+    size_t window{0};
+    size_t delta{0};
+    size_t committed{0};
+    size_t iterations{0};
+    // Counts of the last two rounds (\see endRound)
+    size_t roundCommitted[2]{0, 0};
+    size_t roundIterations[2]{0, 0};
+    unsigned round{0};
 
   public:
     size_t nextWindow(bool first = false) {
@@ -819,7 +823,6 @@ public:
         window = delta;
       else
         window += delta;
-      committed = iterations = 0;
       return window;
     }
 
@@ -836,6 +839,23 @@ public:
 
   ThreadLocalData& getLocalWindowManager() { return *data.getLocal(); }
 
+  /**
+   * Publishes the counts of the round that this thread just committed and
+   * starts counting the next one. Called by every thread after each commit
+   * phase and before the barrier that precedes calculateWindow.
+   *
+   * The counts alternate between two slots, so a thread that is still reading
+   * the counts of a round in calculateWindow never sees them overwritten: the
+   * other threads can get at most one round ahead before the next barrier.
+   */
+  void endRound() {
+    ThreadLocalData& local = *data.getLocal();
+    local.round ^= 1;
+    local.roundCommitted[local.round] = local.committed;
+    local.roundIterations[local.round] = local.iterations;
+    local.committed = local.iterations = 0;
+  }
+
   size_t nextWindow(size_t dist, size_t atleast, size_t base = 0) {
     if (false) {
       // This, which tries to continue delta with new work, seems to result in
@@ -862,8 +882,8 @@ public:
     size_t alliterations = 0;
     for (unsigned i = 0; i < numActive; ++i) {
       ThreadLocalData& r = *data.getRemote(i);
-      allcommitted += r.committed;
-      alliterations += r.iterations;
+      allcommitted += r.roundCommitted[local.round];
+      alliterations += r.roundIterations[local.round];
     }
 
     float commitRatio =
@@ -917,6 +937,8 @@ private:
 public:
   ThreadLocalData& getLocalWindowManager() { return data; }
 
+  void endRound() {}
+
   size_t nextWindow(size_t, size_t, size_t = 0) { return data.nextWindow(); }
 
   size_t initialWindow(size_t, size_t, size_t = 0) {
@@ -985,12 +1007,13 @@ class NewWorkManager : public IdManager<OptionsTy> {
     IterAllocBaseTy heap;
     PerIterAllocTy alloc;
     NewItemsTy newItems;
+    NewItemsTy mergeBuf;
     ReserveTy reserve;
     size_t minId;
     size_t maxId;
     size_t size;
 
-    ThreadLocalData() : alloc(&heap), newItems(alloc) {}
+    ThreadLocalData() : alloc(&heap), newItems(alloc), mergeBuf(alloc) {}
   };
 
   IterAllocBaseTy heap;
@@ -1002,17 +1025,10 @@ class NewWorkManager : public IdManager<OptionsTy> {
   substrate::Barrier& barrier;
   unsigned numActive;
 
-  bool merge(int begin, int end) {
-    if (begin == end)
-      return false;
-    else if (begin + 1 == end)
-      return !data.getRemote(begin)->newItems.empty();
-
-    bool retval = false;
-    int mid = (end - begin) / 2 + begin;
-    retval |= merge(begin, mid);
-    retval |= merge(mid, end);
-
+  //! Merges the sorted runs of new items of threads [begin, mid) and [mid,
+  //! end) into one sorted run that fills the same vectors in order, using buf
+  //! as scratch space
+  void mergeRuns(int begin, int mid, int end, NewItemsTy& buf) {
     GetNewItem fn(this);
 
     MergeOuterIt bbegin(boost::make_counting_iterator(begin), fn);
@@ -1030,26 +1046,42 @@ class NewWorkManager : public IdManager<OptionsTy> {
 
     while (aa.first != aa.second && bb.first != bb.second) {
       if (*aa.first < *bb.first)
-        mergeBuf.push_back(*aa.first++);
+        buf.push_back(*aa.first++);
       else
-        mergeBuf.push_back(*bb.first++);
+        buf.push_back(*bb.first++);
     }
 
     for (; aa.first != aa.second; ++aa.first)
-      mergeBuf.push_back(*aa.first);
+      buf.push_back(*aa.first);
 
     for (; bb.first != bb.second; ++bb.first)
-      mergeBuf.push_back(*bb.first);
+      buf.push_back(*bb.first);
 
-    for (NewItemsIterator ii = mergeBuf.begin(), ei = mergeBuf.end(); ii != ei;
-         ++ii)
+    for (NewItemsIterator ii = buf.begin(), ei = buf.end(); ii != ei; ++ii)
       *cc.first++ = *ii;
 
-    mergeBuf.clear();
+    buf.clear();
 
     assert(cc.first == cc.second);
+  }
 
-    return retval;
+  /**
+   * Merges the sorted new items of all threads bottom up. At each level, the
+   * first thread of each pair of adjacent runs merges the pair, so all pairs
+   * of a level are merged at once rather than one after another by a single
+   * thread. Items have distinct (parent, count) pairs, so the result does not
+   * depend on the order of the merges.
+   */
+  void parallelMerge(unsigned tid) {
+    ThreadLocalData& local = *data.getLocal();
+    for (unsigned width = 1; width < numActive; width *= 2) {
+      if (tid % (2 * width) == 0 && tid + width < numActive) {
+        mergeRuns(
+            tid, tid + width, std::min(tid + 2 * width, numActive),
+            local.mergeBuf);
+      }
+      barrier.Wait();
+    }
   }
 
   /**
@@ -1161,10 +1193,9 @@ class NewWorkManager : public IdManager<OptionsTy> {
     if (tid == 0) {
       receiveLimits(local);
       broadcastLimits(local);
-      if (!OptionsTy::hasId) {
-        mergeBuf.reserve(local.size);
-        merge(0, numActive);
-      }
+    }
+    if (!OptionsTy::hasId) {
+      parallelMerge(tid);
     }
 
     barrier.Wait();
@@ -1674,6 +1705,7 @@ Executor<OptionsTy>::commitLoop(ThreadLocalData& tld) {
     tld.facing.resetAlloc();
 
   setThreadContext(0);
+  this->endRound();
 
   return retval;
 }
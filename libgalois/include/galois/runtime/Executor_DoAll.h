@@ -22,10 +22,12 @@
 
 #include "galois/Statistics.h"
 #include "galois/Timer.h"
+#include "galois/Trace.h"
 #include "galois/config.h"
 #include "galois/gIO.h"
 #include "galois/runtime/Executor_OnEach.h"
 #include "galois/runtime/OperatorReferenceTypes.h"
+#include "galois/runtime/PerfCounters.h"
 #include "galois/substrate/Barrier.h"
 #include "galois/substrate/CompilerSpecific.h"
 #include "galois/substrate/PaddedLock.h"
@@ -80,13 +82,19 @@ class DoAllStealingExec {
           m_size(std::distance(beg, end)),
           num_iter(0) {}
 
-    bool doWork(F func, const unsigned chunk_size) {
+    //! With guided_share, takes a 1 / guided_share share of what is left but
+    //! no fewer than chunk_size iterations at a time; takes no more once stop
+    //! holds
+    template <typename Stop>
+    bool doWork(
+        F func, const Diff_ty chunk_size, const Diff_ty guided_share,
+        const Stop& stop) {
       Iter beg(shared_beg);
       Iter end(shared_end);
 
       bool didwork = false;
 
-      while (getWork(beg, end, chunk_size)) {
+      while (!stop() && getWork(beg, end, chunk_size, guided_share)) {
         didwork = true;
 
         for (; beg != end; ++beg) {
@@ -102,6 +110,14 @@ class DoAllStealingExec {
 
     bool hasWorkWeak() const { return (m_size > 0); }
 
+    //! Drops the iterations left to a stopped loop
+    void discardWork() {
+      work_mutex.lock();
+      shared_beg = shared_end;
+      m_size = 0;
+      work_mutex.unlock();
+    }
+
     bool hasWork() const {
       bool ret = false;
 
@@ -119,7 +135,9 @@ class DoAllStealingExec {
     }
 
   private:
-    bool getWork(Iter& priv_beg, Iter& priv_end, const unsigned chunk_size) {
+    bool getWork(
+        Iter& priv_beg, Iter& priv_end, const Diff_ty chunk_size,
+        const Diff_ty guided_share) {
       bool succ = false;
 
       work_mutex.lock();
@@ -127,14 +145,19 @@ class DoAllStealingExec {
         if (hasWorkWeak()) {
           succ = true;
 
+          Diff_ty take = chunk_size;
+          if (guided_share) {
+            take = std::max(chunk_size, m_size / guided_share);
+          }
+
           Iter nbeg = shared_beg;
-          if (m_size <= chunk_size) {
+          if (m_size <= take) {
             nbeg = shared_end;
             m_size = 0;
 
           } else {
-            std::advance(nbeg, chunk_size);
-            m_size -= chunk_size;
+            std::advance(nbeg, take);
+            m_size -= take;
             assert(m_size > 0);
           }
 
@@ -351,11 +374,66 @@ private:
     return ret;
   }
 
+  static schedule getSchedule(const ArgsTuple& argsTuple) {
+    if constexpr (has_trait<schedule_tag, ArgsTuple>()) {
+      return get_trait_value<schedule_tag>(argsTuple);
+    } else {
+      return schedule::Dynamic(
+          get_trait_value<chunk_size_tag>(argsTuple).value);
+    }
+  }
+
+  //! The part of thread id of the range when its iterations are weighted by
+  //! the prefix sum of the schedule
+  std::pair<Iter, Iter> weightedPart(unsigned id) {
+    constexpr bool kRandomAccess =
+        std::is_same<Iter, typename R::iterator>::value &&
+        std::is_base_of<
+            std::random_access_iterator_tag,
+            typename std::iterator_traits<Iter>::iterator_category>::value;
+    if constexpr (kRandomAccess) {
+      const uint64_t* prefix_sum = sched.prefix_sum;
+      uint64_t n = std::distance(range.begin(), range.end());
+      if (n == 0) {
+        return std::make_pair(range.begin(), range.end());
+      }
+      // Weight of the first i iterations
+      auto weight = [&](uint64_t i) -> uint64_t {
+        return i == 0 ? 0 : prefix_sum[i - 1] + i;
+      };
+      unsigned num_threads = activeThreads;
+      uint64_t total = weight(n);
+      // First iteration whose prefix weighs at least the share of thread t
+      auto bound = [&](unsigned t) -> uint64_t {
+        uint64_t target = total / num_threads * t +
+                          total % num_threads * t / num_threads;
+        uint64_t lo = 0;
+        uint64_t hi = n;
+        while (lo < hi) {
+          uint64_t mid = lo + (hi - lo) / 2;
+          if (weight(mid) < target) {
+            lo = mid + 1;
+          } else {
+            hi = mid;
+          }
+        }
+        return lo;
+      };
+      Iter beg = range.begin();
+      return std::make_pair(beg + bound(id), beg + bound(id + 1));
+    } else {
+      GALOIS_DIE("weighted schedule needs a random access range");
+      return std::make_pair(range.local_begin(), range.local_end());
+    }
+  }
+
 private:
   R range;
   F func;
   const char* loopname;
+  schedule sched;
   Diff_ty chunk_size;
+  galois::internal::LoopStop<ArgsTuple> stop;
   substrate::PerThreadStorage<ThreadContext> workers;
 
   substrate::TerminationDetection& term;
@@ -372,7 +450,9 @@ public:
       : range(_range),
         func(_func),
         loopname(galois::internal::getLoopName(argsTuple)),
-        chunk_size(get_trait_value<chunk_size_tag>(argsTuple).value),
+        sched(getSchedule(argsTuple)),
+        chunk_size(sched.grain),
+        stop(argsTuple),
         term(substrate::GetTerminationDetection(activeThreads)),
         totalTime(loopname, "Total"),
         initTime(loopname, "Init"),
@@ -390,8 +470,13 @@ public:
 
     unsigned id = substrate::ThreadPool::getTID();
 
-    *workers.getLocal(id) =
-        ThreadContext(id, range.local_begin(), range.local_end());
+    if (sched.policy == schedule::kWeighted) {
+      auto [beg, end] = weightedPart(id);
+      *workers.getLocal(id) = ThreadContext(id, beg, end);
+    } else {
+      *workers.getLocal(id) =
+          ThreadContext(id, range.local_begin(), range.local_end());
+    }
 
     initTime.stop();
   }
@@ -410,6 +495,8 @@ public:
 
   void operator()(void) {
     ThreadContext& ctx = *workers.getLocal();
+    LoopPerfCounters<NEED_STATS> perfCounters(loopname);
+    TraceScope trace("loop", loopname);
     totalTime.start();
 
     while (true) {
@@ -417,16 +504,31 @@ public:
 
       execTime.start();
 
-      if (ctx.doWork(func, chunk_size)) {
+      Diff_ty guided_share =
+          sched.policy == schedule::kGuided ? Diff_ty(activeThreads) : 0;
+      if (ctx.doWork(func, chunk_size, guided_share, stop)) {
         workHappened = true;
       }
 
       execTime.stop();
 
+      // Every thread drops its own part once it sees stop, and none steals
+      // after that, so no part is left with work when the loop ends
+      if (stop()) {
+        ctx.discardWork();
+        break;
+      }
+
       assert(!ctx.hasWork());
 
       stealTime.start();
+      uint64_t steal_begin = TraceEnabled() ? TraceNow() : 0;
       bool stole = trySteal(ctx);
+      if (steal_begin != 0) {
+        TraceSpan(
+            "steal", stole ? "steal" : "steal failed", steal_begin,
+            TraceNow());
+      }
       stealTime.stop();
 
       if (stole) {
@@ -479,6 +581,7 @@ template <>
 struct ChooseDoAllImpl<false> {
   template <typename R, typename F, typename ArgsT>
   static void call(const R& range, F func, const ArgsT& argsTuple) {
+    galois::internal::LoopStop<ArgsT> stop(argsTuple);
     runtime::on_each_gen(
         [&](const unsigned int, const unsigned int) {
           static constexpr bool NEED_STATS =
@@ -491,6 +594,8 @@ struct ChooseDoAllImpl<false> {
           PerThreadTimer<MORE_STATS> totalTime(loopname, "Total");
           PerThreadTimer<MORE_STATS> initTime(loopname, "Init");
           PerThreadTimer<MORE_STATS> execTime(loopname, "Work");
+          LoopPerfCounters<NEED_STATS> perfCounters(loopname);
+          TraceScope trace("loop", loopname);
 
           totalTime.start();
           initTime.start();
@@ -504,10 +609,24 @@ struct ChooseDoAllImpl<false> {
 
           size_t iter = 0;
 
-          while (begin != end) {
-            func(*begin++);
-            if (NEED_STATS) {
-              ++iter;
+          if constexpr (galois::internal::LoopStop<ArgsT>::enabled) {
+            // check between chunks of iterations
+            const unsigned chunk =
+                get_trait_value<chunk_size_tag>(argsTuple).value;
+            while (begin != end && !stop()) {
+              for (unsigned i = 0; i < chunk && begin != end; ++i) {
+                func(*begin++);
+                if (NEED_STATS) {
+                  ++iter;
+                }
+              }
+            }
+          } else {
+            while (begin != end) {
+              func(*begin++);
+              if (NEED_STATS) {
+                ++iter;
+              }
             }
           }
           execTime.stop();
@@ -546,7 +665,15 @@ do_all_gen(const R& range, F&& func, const ArgsTuple& argsTuple) {
   constexpr bool STEAL = has_trait<steal_tag, ArgsT>();
 
   OperatorReferenceType<decltype(std::forward<F>(func))> func_ref = func;
-  internal::ChooseDoAllImpl<STEAL>::call(range, func_ref, argsT);
+  if constexpr (has_trait<schedule_tag, ArgsT>()) {
+    if (get_trait_value<schedule_tag>(argsT).policy == schedule::kStatic) {
+      internal::ChooseDoAllImpl<false>::call(range, func_ref, argsT);
+    } else {
+      internal::ChooseDoAllImpl<true>::call(range, func_ref, argsT);
+    }
+  } else {
+    internal::ChooseDoAllImpl<STEAL>::call(range, func_ref, argsT);
+  }
 
   timer.stop();
 }
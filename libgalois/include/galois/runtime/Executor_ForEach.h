@@ -30,14 +30,17 @@
 #include "galois/ThreadTimer.h"
 #include "galois/Threads.h"
 #include "galois/Timer.h"
+#include "galois/Trace.h"
 #include "galois/Traits.h"
 #include "galois/config.h"
 #include "galois/gIO.h"
 #include "galois/runtime/Context.h"
 #include "galois/runtime/LoopStatistics.h"
 #include "galois/runtime/OperatorReferenceTypes.h"
+#include "galois/runtime/PerfCounters.h"
 #include "galois/runtime/UserContextAccess.h"
 #include "galois/substrate/Barrier.h"
+#include "galois/substrate/EpochManager.h"
 #include "galois/substrate/TerminationDetection.h"
 #include "galois/substrate/ThreadPool.h"
 #include "galois/worklists/Chunk.h"
@@ -151,8 +154,12 @@ public:
   static constexpr bool needsPush = !has_trait<no_pushes_tag, ArgsTy>();
   static constexpr bool needsAborts =
       !has_trait<disable_conflict_detection_tag, ArgsTy>();
+  static constexpr bool needsOptimisticReads =
+      needsAborts && has_trait<optimistic_reads_tag, ArgsTy>();
   static constexpr bool needsPia = has_trait<per_iter_alloc_tag, ArgsTy>();
   static constexpr bool needsBreak = has_trait<parallel_break_tag, ArgsTy>();
+  static constexpr bool needsStop =
+      galois::internal::LoopStop<ArgsTy>::enabled;
   static constexpr bool MORE_STATS =
       needStats && has_trait<more_stats_tag, ArgsTy>();
 
@@ -163,8 +170,15 @@ protected:
     UserContextAccess<value_type> facing;
     FunctionTy function;
     SimpleRuntimeContext ctx;
-
-    explicit ThreadLocalBasics(FunctionTy fn) : facing(), function(fn), ctx() {}
+    substrate::EpochManager& epochs;
+    unsigned tid;
+
+    explicit ThreadLocalBasics(FunctionTy fn)
+        : facing(),
+          function(fn),
+          ctx(),
+          epochs(substrate::GetEpochManager()),
+          tid(substrate::ThreadPool::getTID()) {}
   };
 
   using LoopStat = LoopStatistics<needStats>;
@@ -193,6 +207,7 @@ protected:
   FunctionTy origFunction;
   const char* loopname;
   bool broke;
+  galois::internal::LoopStop<ArgsTy> stop;
 
   PerThreadTimer<MORE_STATS> initTime;
   PerThreadTimer<MORE_STATS> execTime;
@@ -237,7 +252,12 @@ protected:
 
     tld.inc_iterations();
     tld.function(val, tld.facing.data());
+    if (needsOptimisticReads)
+      tld.ctx.validateIteration();
     commitIteration(tld);
+    // between iterations, the operator holds no references to graph elements
+    // that other iterations removed
+    tld.epochs.Quiesce(tld.tid);
   }
 
   bool runQueueSimple(ThreadLocalData& tld) {
@@ -287,6 +307,17 @@ protected:
     return runQueue<0>(tld, *aborted.getQueue());
   }
 
+  //! Drops the work of a stopped loop; termination detection then ends the
+  //! loop as if the work had run out
+  template <typename WL>
+  GALOIS_ATTRIBUTE_NOINLINE bool discardQueue(WL& lwl) {
+    bool didWork = false;
+    while (lwl.pop()) {
+      didWork = true;
+    }
+    return didWork;
+  }
+
   void fastPushBack(typename UserContextAccess<value_type>::PushBufferTy& x) {
     wl.push(x.begin(), x.end());
     x.clear();
@@ -300,9 +331,21 @@ protected:
     return wl.empty();
   }
 
+  void reportWorkListStats(WorkListTy&, ...) {}
+
+  //! Lets a worklist report statistics of its own, such as the chunk sizes
+  //! chosen by AdaptiveChunk, from each thread at the end of the loop
+  template <typename WL>
+  auto reportWorkListStats(WL& wl, int)
+      -> decltype(wl.reportStats(loopname), void()) {
+    wl.reportStats(loopname);
+  }
+
   template <bool couldAbort, bool isLeader>
   void go() {
     execTime.start();
+    LoopPerfCounters<needStats> perfCounters(loopname);
+    TraceScope trace("loop", loopname);
 
     // Thread-local data goes on the local stack to be NUMA friendly
     ThreadLocalData tld(origFunction, loopname);
@@ -310,6 +353,8 @@ protected:
       tld.facing.setBreakFlag(&broke);
     if (couldAbort)
       setThreadContext(&tld.ctx);
+    if (couldAbort && needsOptimisticReads)
+      tld.ctx.setOptimisticReads(true);
     if (needsPush && !couldAbort)
       tld.facing.setFastPushBack(std::bind(
           &ForEachExecutor::fastPushBack, this, std::placeholders::_1));
@@ -319,8 +364,15 @@ protected:
         bool didWork = false;
 
         // Run some iterations
-        if (couldAbort || needsBreak) {
-          constexpr int __NUM = (needsBreak || isLeader) ? 64 : 0;
+        if (needsStop && stop()) {
+          bool b = discardQueue(wl);
+          didWork = b || didWork;
+          if (couldAbort) {
+            b = discardQueue(*aborted.getQueue());
+            didWork = b || didWork;
+          }
+        } else if (couldAbort || needsBreak || needsStop) {
+          constexpr int __NUM = (needsBreak || needsStop || isLeader) ? 64 : 0;
           bool b = runQueue<__NUM>(tld, wl);
           didWork = b || didWork;
           // Check for abort
@@ -335,6 +387,8 @@ protected:
 
         // Update node color and prop token
         term.SignalWorked(didWork);
+        // idle threads must not hold back the reclamation epoch
+        tld.epochs.Quiesce(tld.tid);
         substrate::asmPause();  // Let token propagate
       } while (term.Working() && (!needsBreak || !broke));
 
@@ -352,6 +406,12 @@ protected:
       barrier.Wait();
     }
 
+    if (needStats)
+      reportWorkListStats(wl, 0);
+    if (needStats && needsOptimisticReads)
+      galois::ReportStatSum(
+          loopname, "ValidationFailures", tld.ctx.validationFailures());
+
     if (couldAbort)
       setThreadContext(0);
   }
@@ -367,6 +427,7 @@ protected:
         origFunction(f),
         loopname(galois::internal::getLoopName(args)),
         broke(false),
+        stop(args),
         initTime(loopname, "Init"),
         execTime(loopname, "Execute") {}
 
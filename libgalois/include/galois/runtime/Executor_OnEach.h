@@ -23,10 +23,12 @@
 #include "galois/ThreadTimer.h"
 #include "galois/Threads.h"
 #include "galois/Timer.h"
+#include "galois/Trace.h"
 #include "galois/Traits.h"
 #include "galois/config.h"
 #include "galois/gIO.h"
 #include "galois/runtime/OperatorReferenceTypes.h"
+#include "galois/runtime/PerfCounters.h"
 #include "galois/substrate/ThreadPool.h"
 
 namespace galois {
@@ -55,6 +57,8 @@ on_each_impl(FunctionTy&& fn, const ArgsTy& argsTuple) {
   OperatorReferenceType<decltype(std::forward<FunctionTy>(fn))> fn_ref = fn;
 
   auto runFun = [&] {
+    LoopPerfCounters<NEEDS_STATS> perfCounters(loopname);
+    TraceScope trace("loop", loopname);
     execTime.start();
 
     fn_ref(substrate::ThreadPool::getTID(), numT);
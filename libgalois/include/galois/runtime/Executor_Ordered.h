@@ -20,21 +20,339 @@
 #ifndef GALOIS_LIBGALOIS_GALOIS_RUNTIME_EXECUTORORDERED_H_
 #define GALOIS_LIBGALOIS_GALOIS_RUNTIME_EXECUTORORDERED_H_
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <limits>
+#include <optional>
+
+#include "galois/Range.h"
+#include "galois/Reduction.h"
+#include "galois/Statistics.h"
 #include "galois/config.h"
+#include "galois/gstl.h"
+#include "galois/runtime/Context.h"
+#include "galois/runtime/Executor_DoAll.h"
+#include "galois/runtime/Executor_OnEach.h"
+#include "galois/runtime/UserContextAccess.h"
+#include "galois/substrate/PerThreadStorage.h"
 
 namespace galois {
 namespace runtime {
 
-// TODO(ddn): Pull in and integrate in executors from exp
+namespace ordered {
+
+/// A task: an item and the id that breaks ties between items that cmp does
+/// not order
+template <typename T>
+struct Task {
+  T item;
+  uint64_t id;
+};
+
+/// The conflict detection of a task of the current window. While the
+/// neighborhood functions of the window run, acquiring a lock claims it for
+/// the earliest task that wants it, taking it from later tasks, which are not
+/// safe sources then; afterwards, acquiring does nothing.
+template <typename T, typename Before>
+class WindowContext : public SimpleRuntimeContext {
+  const Before& before_;
+  std::atomic<bool> not_safe_{false};
+  bool marking_{true};
+
+public:
+  Task<T> task;
+
+  WindowContext(const Task<T>& t, const Before& before)
+      : SimpleRuntimeContext(true), before_(before), task(t) {}
+
+  bool safe() const { return !not_safe_.load(std::memory_order_relaxed); }
+
+  void stopMarking() { marking_ = false; }
+
+  void subAcquire(Lockable* lockable, galois::MethodFlag) override {
+    if (!marking_) {
+      return;
+    }
+    if (this->tryLock(lockable)) {
+      this->addToNhood(lockable);
+    }
+
+    WindowContext* other;
+    do {
+      other = static_cast<WindowContext*>(this->getOwner(lockable));
+      if (other == this) {
+        return;
+      }
+      if (other && before_(other->task, task)) {
+        not_safe_.store(true, std::memory_order_relaxed);
+        return;
+      }
+    } while (!this->stealByCAS(lockable, other));
+
+    if (other) {
+      other->not_safe_.store(true, std::memory_order_relaxed);
+    }
+  }
+};
+
+/// The test of the overload without a stability test: every safe source of
+/// a window is stable
+struct AlwaysStable {
+  template <typename T>
+  bool operator()(const T&) const {
+    return true;
+  }
+};
+
+/**
+ * Runs tasks in the order of cmp, as far as their neighborhoods overlap, in
+ * the manner of the implicit kinetic dependence graph (IKDG) executor of
+ * Hassaan et al.: in rounds, each of which takes a window of the earliest
+ * pending tasks, marks the neighborhood of each with nhFunc and runs the
+ * tasks that no earlier task of the window shares a lock with (the safe
+ * sources), in parallel.
+ *
+ *  - Pending tasks live in a heap per thread, in memory of the thread's
+ *    socket. A round takes an equal share of the window from each heap and
+ *    cuts it at the latest task that is earlier than what every heap kept,
+ *    so that the window is exactly the earliest tasks, without a global
+ *    priority queue.
+ *  - All the tasks of a window are marked, and their safety tested, in
+ *    parallel; the window then commits as one batch: tasks push their new
+ *    tasks and put back the ones that were not safe in their own heap.
+ *  - The window doubles while most of its tasks are safe and halves while
+ *    few are.
+ *
+ * New tasks must not be earlier than the task that creates them, as for
+ * Dijkstra's algorithm or discrete-event simulation. Without a stability
+ * test, a safe source must also stay safe whatever tasks are created later
+ * (stable sources); otherwise stabilityTest(item) tells whether it does.
+ * The earliest task of a window always runs, since no task can come before
+ * it, so every round makes progress.
+ */
+template <
+    typename T, typename Cmp, typename NhFunc, typename OpFunc,
+    typename StableTest>
+class OrderedExecutor {
+  struct Before {
+    const Cmp& cmp;
+    bool operator()(const Task<T>& a, const Task<T>& b) const {
+      if (cmp(a.item, b.item)) {
+        return true;
+      }
+      if (cmp(b.item, a.item)) {
+        return false;
+      }
+      return a.id < b.id;
+    }
+  };
+
+  //! Orders heaps so that the earliest task is on top
+  struct After {
+    Before before;
+    bool operator()(const Task<T>& a, const Task<T>& b) const {
+      return before(b, a);
+    }
+  };
+
+  using Context = WindowContext<T, Before>;
+  using Heap = gstl::Vector<Task<T>>;
+
+  static constexpr size_t kWindowPerThread = 64;
+  //! ids are unique per thread, in their low bits
+  static constexpr uint64_t kMaxThreads = 1 << 12;
+
+  struct ThreadState {
+    Heap heap;
+    std::deque<Context> window;
+    UserContextAccess<T> facing;
+    uint64_t next_id{0};
+    //! the last task this thread took for the window, if it kept any task
+    std::optional<Task<T>> boundary;
+  };
+
+  Before before_;
+  After after_;
+  const NhFunc& nh_func_;
+  const OpFunc& op_func_;
+  const StableTest& stable_test_;
+  const char* loopname_;
+  substrate::PerThreadStorage<ThreadState> states_;
+  size_t window_size_;
+  //! the earliest task of the current window
+  std::optional<Task<T>> earliest_;
+
+  void push(ThreadState& state, const T& item) {
+    uint64_t id =
+        state.next_id++ * kMaxThreads + substrate::ThreadPool::getTID();
+    state.heap.push_back(Task<T>{item, id});
+    std::push_heap(state.heap.begin(), state.heap.end(), after_);
+  }
+
+  //! Takes the earliest tasks of every heap into the windows of the threads
+  //! and returns the size of the window
+  size_t takeWindow() {
+    const size_t share =
+        std::max<size_t>(1, window_size_ / getActiveThreads());
+    on_each_gen(
+        [&](unsigned, unsigned) {
+          ThreadState& state = *states_.getLocal();
+          state.boundary.reset();
+          for (size_t i = 0; i < share && !state.heap.empty(); ++i) {
+            std::pop_heap(state.heap.begin(), state.heap.end(), after_);
+            state.window.emplace_back(state.heap.back(), before_);
+            state.heap.pop_back();
+          }
+          if (!state.heap.empty()) {
+            state.boundary = state.window.back().task;
+          }
+        },
+        std::make_tuple());
+
+    // Tasks after the earliest boundary could be later than tasks that
+    // stayed in another heap
+    std::optional<Task<T>> cut;
+    for (unsigned i = 0; i < getActiveThreads(); ++i) {
+      const auto& boundary = states_.getRemote(i)->boundary;
+      if (boundary && (!cut || before_(*boundary, *cut))) {
+        cut = boundary;
+      }
+    }
+
+    earliest_.reset();
+    for (unsigned i = 0; i < getActiveThreads(); ++i) {
+      const auto& window = states_.getRemote(i)->window;
+      if (!window.empty() &&
+          (!earliest_ || before_(window.front().task, *earliest_))) {
+        earliest_ = window.front().task;
+      }
+    }
+
+    GAccumulator<size_t> size;
+    on_each_gen(
+        [&](unsigned, unsigned) {
+          ThreadState& state = *states_.getLocal();
+          if (cut) {
+            while (!state.window.empty() &&
+                   before_(*cut, state.window.back().task)) {
+              state.heap.push_back(state.window.back().task);
+              std::push_heap(state.heap.begin(), state.heap.end(), after_);
+              state.window.pop_back();
+            }
+          }
+          size += state.window.size();
+        },
+        std::make_tuple());
+    return size.reduce();
+  }
+
+  //! Calls fn on the tasks of the window, each thread on those it took,
+  //! which are as many as the other threads took
+  template <typename Fn>
+  void forEachWindowTask(Fn fn) {
+    on_each_gen(
+        [&](unsigned, unsigned) {
+          for (Context& ctx : states_.getLocal()->window) {
+            fn(ctx);
+          }
+        },
+        std::make_tuple());
+  }
+
+public:
+  OrderedExecutor(
+      const Cmp& cmp, const NhFunc& nh_func, const OpFunc& op_func,
+      const StableTest& stable_test, const char* loopname)
+      : before_{cmp},
+        after_{before_},
+        nh_func_(nh_func),
+        op_func_(op_func),
+        stable_test_(stable_test),
+        loopname_(loopname ? loopname : "for_each_ordered"),
+        window_size_(kWindowPerThread * getActiveThreads()) {}
+
+  template <typename Iter>
+  void run(Iter beg, Iter end) {
+    do_all_gen(
+        MakeStandardRange(beg, end),
+        [&](const T& item) { push(*states_.getLocal(), item); },
+        std::make_tuple(galois::no_stats()));
+
+    size_t rounds = 0;
+    size_t committed = 0;
+    size_t not_safe = 0;
+    while (size_t window = takeWindow()) {
+      ++rounds;
+
+      // Mark the neighborhoods
+      forEachWindowTask(
+          [&](Context& ctx) {
+            setThreadContext(&ctx);
+            nh_func_(ctx.task.item);
+            setThreadContext(nullptr);
+          });
+
+      // Run the safe sources and commit the window
+      GAccumulator<size_t> executed;
+      forEachWindowTask(
+          [&](Context& ctx) {
+            ThreadState& state = *states_.getLocal();
+            ctx.stopMarking();
+            // no task can come before the earliest pending one, which is
+            // therefore always stable
+            bool stable = ctx.task.id == earliest_->id ||
+                          stable_test_(ctx.task.item);
+            if (ctx.safe() && stable) {
+              setThreadContext(&ctx);
+              op_func_(ctx.task.item, state.facing.data());
+              setThreadContext(nullptr);
+              for (const T& item : state.facing.getPushBuffer()) {
+                push(state, item);
+              }
+              state.facing.getPushBuffer().clear();
+              executed += 1;
+            } else {
+              state.heap.push_back(ctx.task);
+              std::push_heap(state.heap.begin(), state.heap.end(), after_);
+            }
+            ctx.commitIteration();
+          });
+      on_each_gen(
+          [&](unsigned, unsigned) { states_.getLocal()->window.clear(); },
+          std::make_tuple());
+
+      size_t done = executed.reduce();
+      committed += done;
+      not_safe += window - done;
+
+      if (done * 4 >= window * 3) {
+        window_size_ *= 2;
+      } else if (done * 4 < window) {
+        window_size_ = std::max<size_t>(getActiveThreads(), window_size_ / 2);
+      }
+    }
+
+    ReportStatSingle(loopname_, "Rounds", rounds);
+    ReportStatSingle(loopname_, "Commits", committed);
+    ReportStatSingle(loopname_, "NotSafe", not_safe);
+  }
+};
+
+}  // namespace ordered
 
 template <typename Iter, typename Cmp, typename NhFunc, typename OpFunc>
 void
 for_each_ordered_impl(
-    [[maybe_unused]] Iter beg, [[maybe_unused]] Iter end,
-    [[maybe_unused]] const Cmp& cmp, [[maybe_unused]] const NhFunc& nhFunc,
-    [[maybe_unused]] const OpFunc& opFunc,
-    [[maybe_unused]] const char* loopname) {
-  GALOIS_DIE("not yet implemented");
+    Iter beg, Iter end, const Cmp& cmp, const NhFunc& nhFunc,
+    const OpFunc& opFunc, const char* loopname) {
+  using T = typename std::iterator_traits<Iter>::value_type;
+  ordered::AlwaysStable stable;
+  ordered::OrderedExecutor<T, Cmp, NhFunc, OpFunc, ordered::AlwaysStable>
+      executor(cmp, nhFunc, opFunc, stable, loopname);
+  executor.run(beg, end);
 }
 
 template <
@@ -42,12 +360,13 @@ template <
     typename StableTest>
 void
 for_each_ordered_impl(
-    [[maybe_unused]] Iter beg, [[maybe_unused]] Iter end,
-    [[maybe_unused]] const Cmp& cmp, [[maybe_unused]] const NhFunc& nhFunc,
-    [[maybe_unused]] const OpFunc& opFunc,
-    [[maybe_unused]] const StableTest& stabilityTest,
-    [[maybe_unused]] const char* loopname) {
-  GALOIS_DIE("not yet implemented");
+    Iter beg, Iter end, const Cmp& cmp, const NhFunc& nhFunc,
+    const OpFunc& opFunc, const StableTest& stabilityTest,
+    const char* loopname) {
+  using T = typename std::iterator_traits<Iter>::value_type;
+  ordered::OrderedExecutor<T, Cmp, NhFunc, OpFunc, StableTest> executor(
+      cmp, nhFunc, opFunc, stabilityTest, loopname);
+  executor.run(beg, end);
 }
 
 }  // end namespace runtime
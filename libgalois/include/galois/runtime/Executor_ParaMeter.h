@@ -26,6 +26,7 @@
 #include <ctime>
 #include <deque>
 #include <random>
+#include <string>
 #include <vector>
 
 #include "galois/Mem.h"
@@ -47,19 +48,62 @@ namespace ParaMeter {
 struct StepStatsBase {
   static inline void printHeader(FILE* out) {
     fprintf(
-        out, "LOOPNAME, STEP, PARALLELISM, WORKLIST_SIZE, NEIGHBORHOOD_SIZE\n");
+        out,
+        "LOOPNAME, STEP, PARALLELISM, WORKLIST_SIZE, NEIGHBORHOOD_SIZE, "
+        "CONFLICTS\n");
   }
 
   static inline void dump(
       FILE* out, const char* loopname, size_t step, size_t parallelism,
-      size_t wlSize, size_t nhSize) {
+      size_t wlSize, size_t nhSize, size_t conflicts) {
     assert(out && "StepStatsBase::dump() file handle is null");
     fprintf(
-        out, "%s, %zu, %zu, %zu, %zu\n", loopname, step, parallelism, wlSize,
-        nhSize);
+        out, "%s, %zu, %zu, %zu, %zu, %zu\n", loopname, step, parallelism,
+        wlSize, nhSize, conflicts);
   }
 };
 
+/// The counts of one step (round) of a ParaMeter loop
+struct StepProfile {
+  size_t step;
+  //! iterations that committed
+  size_t parallelism;
+  //! iterations that ran, including the ones that conflicted
+  size_t wl_size;
+  //! locks acquired by the iterations that committed
+  size_t nh_size;
+  //! iterations that aborted on a conflict and go to the next step
+  size_t conflicts;
+};
+
+/// The parallelism profile of one run of a ParaMeter loop. Each step runs a
+/// maximal set of independent iterations, so that the number of steps
+/// estimates the critical path of the loop, in iterations, and the work per
+/// step the parallelism available along it.
+class GALOIS_EXPORT LoopProfile {
+  std::string loopname_;
+  std::string schedule_;
+  std::vector<StepProfile> steps_;
+
+public:
+  LoopProfile(const char* loopname, const char* schedule)
+      : loopname_(loopname ? loopname : "(NULL)"), schedule_(schedule) {}
+
+  void AddStep(const StepProfile& step) { steps_.emplace_back(step); }
+
+  const std::vector<StepProfile>& steps() const { return steps_; }
+
+  //! The number of steps
+  size_t CriticalPath() const { return steps_.size(); }
+
+  //! The number of iterations that committed
+  size_t Work() const;
+
+  //! Appends the profile to the JSON file of the run, named by
+  //! GALOIS_PARAMETER_JSON, or else after the CSV file
+  void Write() const;
+};
+
 struct OrderedStepStats : public StepStatsBase {
   using Base = StepStatsBase;
 
@@ -76,7 +120,7 @@ struct OrderedStepStats : public StepStatsBase {
   }
 
   void dump(FILE* out, const char* loopname) {
-    Base::dump(out, loopname, step, parallelism.reduce(), wlSize, 0ul);
+    Base::dump(out, loopname, step, parallelism.reduce(), wlSize, 0ul, 0ul);
   }
 };
 
@@ -87,6 +131,7 @@ struct UnorderedStepStats : public StepStatsBase {
   GAccumulator<size_t> parallelism;
   GAccumulator<size_t> wlSize;
   GAccumulator<size_t> nhSize;
+  GAccumulator<size_t> conflicts;
 
   UnorderedStepStats() : Base(), step(0) {}
 
@@ -95,12 +140,20 @@ struct UnorderedStepStats : public StepStatsBase {
     parallelism.reset();
     wlSize.reset();
     nhSize.reset();
+    conflicts.reset();
+  }
+
+  StepProfile profile() {
+    return StepProfile{
+        step, parallelism.reduce(), wlSize.reduce(), nhSize.reduce(),
+        conflicts.reduce()};
   }
 
   void dump(FILE* out, const char* loopname) {
+    StepProfile p = profile();
     Base::dump(
-        out, loopname, step, parallelism.reduce(), wlSize.reduce(),
-        nhSize.reduce());
+        out, loopname, p.step, p.parallelism, p.wl_size, p.nh_size,
+        p.conflicts);
   }
 };
 
@@ -181,6 +234,20 @@ public:
 
 enum class SchedType { FIFO, RAND, LIFO };
 
+inline const char*
+SchedName(SchedType sched) {
+  switch (sched) {
+  case SchedType::FIFO:
+    return "FIFO";
+  case SchedType::RAND:
+    return "RAND";
+  case SchedType::LIFO:
+    return "LIFO";
+  default:
+    return "UNKNOWN";
+  }
+}
+
 template <typename T, SchedType SCHED>
 struct ChooseWL {};
 
@@ -348,6 +415,7 @@ private:
         m_wl.iterateCurr(),
         [&, this](IterationContext* it) {
           if (it->doabort) {
+            stats.conflicts += 1;
             abortIteration(it);
 
           } else {
@@ -374,6 +442,7 @@ private:
         std::make_tuple());
 
     UnorderedStepStats stats;
+    LoopProfile profile(loopname, SchedName(WorkListTy::SCHEDULE));
 
     while (!m_wl.empty()) {
       m_wl.nextStep();
@@ -390,6 +459,7 @@ private:
       assert(stats.parallelism.reduce() && "ERROR: No Progress");
 
       stats.dump(m_statsFile, loopname);
+      profile.AddStep(stats.profile());
       stats.nextStep();
 
       if (needsBreak && m_broken.reduce()) {
@@ -399,6 +469,7 @@ private:
     }  // end while
 
     closeStatsFile();
+    profile.Write();
   }
 
 public:
@@ -0,0 +1,214 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_LIBGALOIS_GALOIS_RUNTIME_EXECUTORPHASES_H_
+#define GALOIS_LIBGALOIS_GALOIS_RUNTIME_EXECUTORPHASES_H_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "galois/Statistics.h"
+#include "galois/Traits.h"
+#include "galois/config.h"
+#include "galois/runtime/Executor_OnEach.h"
+#include "galois/substrate/Barrier.h"
+#include "galois/substrate/CacheLineStorage.h"
+#include "galois/substrate/CompilerSpecific.h"
+
+namespace galois {
+namespace runtime {
+
+namespace internal {
+
+/// The state shared by the threads of a run_phases region
+struct PhaseState {
+  struct alignas(substrate::GALOIS_CACHE_LINE_SIZE) Slot {
+    unsigned char bytes[substrate::GALOIS_CACHE_LINE_SIZE];
+  };
+
+  substrate::Barrier& barrier;
+  /// Next iteration of the dynamic phases, used in turn; see
+  /// PhaseContext::DoAll
+  std::array<substrate::CacheLineStorage<std::atomic<uint64_t>>, 3> next;
+  /// One slot per thread for each of two AllReduce calls in a row
+  std::vector<Slot> slots;
+
+  explicit PhaseState(unsigned num_threads)
+      : barrier(substrate::GetBarrier(num_threads)), slots(2 * num_threads) {
+    for (auto& n : next) {
+      n.get() = 0;
+    }
+  }
+};
+
+}  // namespace internal
+
+/**
+ * The view of a run_phases region from one of its threads.
+ *
+ * Every thread of the region must make the same sequence of calls to DoAll,
+ * Barrier and AllReduce, since each of them waits for all threads.
+ */
+class PhaseContext {
+  internal::PhaseState* state_;
+  unsigned tid_;
+  unsigned num_threads_;
+  uint64_t num_barriers_{0};
+  uint64_t num_dynamic_{0};
+  uint64_t num_reductions_{0};
+
+public:
+  PhaseContext(internal::PhaseState* state, unsigned tid, unsigned num_threads)
+      : state_(state), tid_(tid), num_threads_(num_threads) {}
+
+  unsigned tid() const { return tid_; }
+  unsigned num_threads() const { return num_threads_; }
+  uint64_t num_barriers() const { return num_barriers_; }
+
+  /// Waits for the other threads of the region
+  void Barrier() {
+    state_->barrier.Wait();
+    ++num_barriers_;
+  }
+
+  /**
+   * Applies fn to each item of range, then waits for the other threads, like
+   * a do_all in the region.
+   *
+   * By default each thread runs its local part of range (range.local_begin()
+   * to range.local_end()), as a do_all without steal. With galois::steal(),
+   * threads instead take galois::chunk_size iterations at a time from a
+   * shared counter until range is done, which needs random-access iterators.
+   *
+   * @param range an iterator range typically returned by @ref galois::iterate
+   * @param fn operator
+   * @param args optional galois::steal() and galois::chunk_size
+   */
+  template <typename RangeTy, typename FunctionTy, typename... Args>
+  void DoAll(const RangeTy& range, FunctionTy&& fn, Args&&... args) {
+    using ArgsTy = std::tuple<std::decay_t<Args>...>;
+
+    if constexpr (has_trait<steal_tag, ArgsTy>()) {
+      using Iter = decltype(range.begin());
+      static_assert(
+          std::is_base_of_v<
+              std::random_access_iterator_tag,
+              typename std::iterator_traits<Iter>::iterator_category>,
+          "steal in a phase needs random-access iterators");
+
+      uint64_t chunk = chunk_size<>::value;
+      if constexpr (has_trait<chunk_size_tag, ArgsTy>()) {
+        chunk = get_trait_value<chunk_size_tag>(ArgsTy(args...)).value;
+      }
+
+      Iter begin = range.begin();
+      uint64_t size = std::distance(begin, range.end());
+      std::atomic<uint64_t>& next = state_->next[num_dynamic_ % 3].get();
+      for (uint64_t i = next.fetch_add(chunk, std::memory_order_relaxed);
+           i < size; i = next.fetch_add(chunk, std::memory_order_relaxed)) {
+        Iter end = begin + std::min(i + chunk, size);
+        for (Iter it = begin + i; it != end; ++it) {
+          fn(*it);
+        }
+      }
+      // The counter of the next dynamic phase was last used two dynamic
+      // phases ago, which every thread has finished since it reached the
+      // barrier ending that phase
+      if (tid_ == 0) {
+        state_->next[(num_dynamic_ + 1) % 3].get().store(
+            0, std::memory_order_relaxed);
+      }
+      ++num_dynamic_;
+    } else {
+      for (auto it = range.local_begin(), end = range.local_end(); it != end;
+           ++it) {
+        fn(*it);
+      }
+    }
+
+    Barrier();
+  }
+
+  /**
+   * Combines the values of all threads with op and returns the result to
+   * each of them. Threads combine values in the same order, so they all
+   * get the same result.
+   *
+   * @param value the value of this thread; trivially copyable and at most a
+   * cache line in size
+   * @param op associative operator, called as op(a, b) for values a and b
+   */
+  template <typename T, typename ReduceOp>
+  T AllReduce(const T& value, ReduceOp op) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    static_assert(sizeof(T) <= sizeof(internal::PhaseState::Slot));
+
+    // A thread can only write slots again after the next AllReduce's
+    // barrier, by which time every thread has read this call's values
+    internal::PhaseState::Slot* slots =
+        state_->slots.data() + (num_reductions_ % 2) * num_threads_;
+    ++num_reductions_;
+
+    std::memcpy(slots[tid_].bytes, &value, sizeof(T));
+    Barrier();
+
+    T result = value;
+    std::memcpy(&result, slots[0].bytes, sizeof(T));
+    for (unsigned i = 1; i < num_threads_; ++i) {
+      T other = value;
+      std::memcpy(&other, slots[i].bytes, sizeof(T));
+      result = op(result, other);
+    }
+    return result;
+  }
+};
+
+/**
+ * Runs fn(ctx) once on each active thread with a PhaseContext ctx shared as
+ * in on_each; see galois::run_phases.
+ */
+template <typename FunctionTy, typename ArgsTy>
+void
+run_phases_gen(FunctionTy&& fn, const ArgsTy& argsTuple) {
+  static constexpr bool NEEDS_STATS = has_trait<loopname_tag, ArgsTy>();
+  const char* const loopname = galois::internal::getLoopName(argsTuple);
+
+  internal::PhaseState state(getActiveThreads());
+
+  on_each_gen(
+      [&](unsigned tid, unsigned num_threads) {
+        PhaseContext ctx(&state, tid, num_threads);
+        fn(ctx);
+        if (NEEDS_STATS && tid == 0) {
+          galois::ReportStatSingle(loopname, "Barriers", ctx.num_barriers());
+        }
+      },
+      argsTuple);
+}
+
+}  // end namespace runtime
+}  // end namespace galois
+
+#endif
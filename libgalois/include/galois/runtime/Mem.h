@@ -485,6 +485,112 @@ public:
   inline void deallocate(void*) {}
 };
 
+/**
+ * A bump pointer through chunks of SourceHeap that keeps its chunks when it
+ * is rewound, so that the memory allocated after a Rewind, e.g., by the next
+ * round of a bulk-synchronous algorithm, is the memory of the last round
+ * rather than new chunks from SourceHeap. Allocations that do not fit in a
+ * chunk fall back to malloc and are freed by Rewind. Deallocation does
+ * nothing; the memory comes back in bulk.
+ */
+template <typename SourceHeap>
+class RewindableBumpHeap : public SourceHeap {
+  struct Block {
+    union {
+      Block* next;
+      std::max_align_t dummy;  // for alignment
+    };
+  };
+
+  static constexpr size_t kAlign = alignof(std::max_align_t);
+
+  //! The chunks in the order they were first used
+  Block* first_{nullptr};
+  Block* current_{nullptr};
+  Block* fallback_{nullptr};
+  size_t offset_{0};
+  size_t num_blocks_{0};
+
+  void NextBlock() {
+    if (current_ && current_->next) {
+      current_ = current_->next;
+    } else {
+      auto* block = static_cast<Block*>(
+          SourceHeap::allocate(SourceHeap::AllocSize));
+      block->next = nullptr;
+      if (current_) {
+        current_->next = block;
+      } else {
+        first_ = block;
+      }
+      current_ = block;
+      ++num_blocks_;
+    }
+    offset_ = sizeof(Block);
+  }
+
+  void FreeFallback() {
+    while (fallback_) {
+      Block* block = fallback_;
+      fallback_ = block->next;
+      free(block);
+    }
+  }
+
+public:
+  enum { AllocSize = 0 };
+
+  RewindableBumpHeap() = default;
+  RewindableBumpHeap(const RewindableBumpHeap&) = delete;
+  RewindableBumpHeap& operator=(const RewindableBumpHeap&) = delete;
+
+  ~RewindableBumpHeap() { clear(); }
+
+  //! The number of chunks of SourceHeap the heap holds
+  size_t num_blocks() const { return num_blocks_; }
+
+  inline void* allocate(size_t size) {
+    size_t aligned_size = (size + kAlign - 1) & ~(kAlign - 1);
+    if (sizeof(Block) + aligned_size > SourceHeap::AllocSize) {
+      auto* block = static_cast<Block*>(malloc(sizeof(Block) + aligned_size));
+      if (!block) {
+        throw std::bad_alloc();
+      }
+      block->next = fallback_;
+      fallback_ = block;
+      return block + 1;
+    }
+    if (!current_ || offset_ + aligned_size > SourceHeap::AllocSize) {
+      NextBlock();
+    }
+    char* retval = reinterpret_cast<char*>(current_) + offset_;
+    offset_ += aligned_size;
+    return retval;
+  }
+
+  inline void deallocate(void*) {}
+
+  //! Release everything allocated, keeping the chunks for reuse
+  void Rewind() {
+    FreeFallback();
+    current_ = first_;
+    offset_ = first_ ? sizeof(Block) : 0;
+  }
+
+  //! Release everything allocated and return the chunks to SourceHeap
+  void clear() {
+    FreeFallback();
+    while (first_) {
+      Block* block = first_;
+      first_ = block->next;
+      SourceHeap::deallocate(block);
+    }
+    current_ = nullptr;
+    offset_ = 0;
+    num_blocks_ = 0;
+  }
+};
+
 //! This is the base source of memory for all allocators.
 //! It maintains a freelist of chunks acquired from the system
 class GALOIS_EXPORT SystemHeap {
@@ -0,0 +1,105 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_LIBGALOIS_GALOIS_RUNTIME_PERFCOUNTERS_H_
+#define GALOIS_LIBGALOIS_GALOIS_RUNTIME_PERFCOUNTERS_H_
+
+#include <array>
+#include <cstdint>
+
+#include "galois/config.h"
+
+namespace galois::runtime {
+
+/// The hardware events that loops count when GALOIS_PERF_EVENTS asks for
+/// them (\see LoopPerfCounters)
+enum class PerfEvent : unsigned {
+  kCycles,
+  kInstructions,
+  kLLCMisses,
+  kDTLBMisses,
+  /// Loads that missed the caches and were served by another NUMA node
+  kRemoteNodeAccesses,
+};
+
+constexpr unsigned kNumPerfEvents = 5;
+
+/// Counts of one thread per event; events that are not counted stay 0
+using PerfCounterValues = std::array<uint64_t, kNumPerfEvents>;
+
+/// Whether GALOIS_PERF_EVENTS asks for any event
+GALOIS_EXPORT bool PerfCountersEnabled();
+
+/// Whether event is counted on the calling thread, i.e., GALOIS_PERF_EVENTS
+/// asks for it and the kernel lets the thread open a counter for it
+GALOIS_EXPORT bool PerfEventCounted(PerfEvent event);
+
+/// The name of event in GALOIS_PERF_EVENTS, e.g., "llc-misses"
+GALOIS_EXPORT const char* PerfEventName(PerfEvent event);
+
+/// Reads the counters of the calling thread, opening them with
+/// perf_event_open the first time the thread reads them
+GALOIS_EXPORT PerfCounterValues ReadPerfCounters();
+
+/// Reports end - start of each counted event of the calling thread as the
+/// statistic region, "Perf<Event>" (e.g., "PerfLLCMisses")
+GALOIS_EXPORT void ReportPerfCounters(
+    const char* region, const PerfCounterValues& start,
+    const PerfCounterValues& end);
+
+/// Counts the events of the calling thread from construction to destruction
+/// and reports them for region. Loops with a loopname keep one on each thread
+/// while it runs the loop, so that the statistics of each event come per loop
+/// and thread.
+template <bool Enabled>
+class LoopPerfCounters {
+  const char* const region_;
+  const bool active_;
+  PerfCounterValues start_{};
+
+public:
+  explicit LoopPerfCounters(const char* region)
+      : region_(region), active_(PerfCountersEnabled()) {
+    if (active_) {
+      start_ = ReadPerfCounters();
+    }
+  }
+
+  ~LoopPerfCounters() {
+    if (active_) {
+      ReportPerfCounters(region_, start_, ReadPerfCounters());
+    }
+  }
+
+  LoopPerfCounters(const LoopPerfCounters&) = delete;
+  LoopPerfCounters& operator=(const LoopPerfCounters&) = delete;
+};
+
+template <>
+class LoopPerfCounters<false> {
+public:
+  explicit LoopPerfCounters(const char*) {}
+
+  LoopPerfCounters(const LoopPerfCounters&) = delete;
+  LoopPerfCounters& operator=(const LoopPerfCounters&) = delete;
+};
+
+}  // namespace galois::runtime
+
+#endif
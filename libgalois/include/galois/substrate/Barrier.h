@@ -58,6 +58,10 @@ public:
  * be in the barrier while the main thread reinitializes this
  * barrier to the new number of active threads. If that may
  * happen, use {@link CreateSimpleBarrier()} instead.
+ *
+ * The kind of barrier is chosen when the runtime starts, by
+ * default with {@link CreateFastestBarrier()} on the threads of the first
+ * loop that runs on more than one thread.
  */
 GALOIS_EXPORT Barrier& GetBarrier(unsigned active_threads);
 
@@ -70,6 +74,14 @@ GALOIS_EXPORT std::unique_ptr<Barrier> CreateTopoBarrier(unsigned);
 GALOIS_EXPORT std::unique_ptr<Barrier> CreateCountingBarrier(unsigned);
 GALOIS_EXPORT std::unique_ptr<Barrier> CreateDisseminationBarrier(unsigned);
 
+/**
+ * Times the Wait of each of the barriers above on active_threads threads of
+ * the thread pool and returns the fastest. This runs the thread pool, so it
+ * must not be called from a parallel loop.
+ */
+GALOIS_EXPORT std::unique_ptr<Barrier> CreateFastestBarrier(
+    unsigned active_threads);
+
 /**
  * Creates a new simple barrier. This barrier is not designed to be fast but
  * does guarantee that all threads have left the barrier before returning
@@ -0,0 +1,91 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_SUBSTRATE_EPOCHMANAGER_H_
+#define GALOIS_LIBGALOIS_GALOIS_SUBSTRATE_EPOCHMANAGER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "galois/config.h"
+#include "galois/substrate/CompilerSpecific.h"
+
+namespace galois::substrate {
+
+/**
+ * The clock of epoch-based reclamation, in its quiescent-state form: memory
+ * that threads may still read after it is unlinked, such as the nodes and
+ * edges removed from a morph graph, is retired in the current epoch and may
+ * be reused once the epoch is two past that.
+ *
+ * The epoch advances once every thread of the running parallel loop passed a
+ * quiescent point, where it holds no reference to unlinked memory, in the
+ * current epoch. The for_each executor declares one after each iteration,
+ * and the thread pool advances the epoch by two at the end of each loop,
+ * where all threads are quiescent. Threads outside of a loop, e.g., serial
+ * code on the master thread, do not hold back the epoch, and must not keep
+ * references to retired memory across loops.
+ */
+class GALOIS_EXPORT EpochManager {
+  struct alignas(GALOIS_CACHE_LINE_SIZE) Slot {
+    //! the last epoch this thread was quiescent in
+    std::atomic<uint64_t> seen{0};
+    //! whether this thread is running a loop
+    std::atomic<bool> online{false};
+    //! the quiescent points since the last try to advance the epoch
+    unsigned quiesces{0};
+  };
+
+  std::atomic<uint64_t> epoch_{kFirstEpoch};
+  std::unique_ptr<Slot[]> slots_;
+  unsigned num_slots_;
+
+  void TryAdvance(uint64_t epoch);
+
+public:
+  //! The first epoch; memory retired in it is reclaimable from epoch 2 on
+  static constexpr uint64_t kFirstEpoch = 0;
+  //! How often, in quiescent points, a thread tries to advance the epoch
+  static constexpr unsigned kQuiescesPerAdvance = 64;
+
+  explicit EpochManager(unsigned num_threads);
+
+  uint64_t epoch() const { return epoch_.load(std::memory_order_acquire); }
+
+  //! The epoch to retire memory in, read after the stores that unlinked it
+  uint64_t RetireEpoch() const {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return epoch_.load(std::memory_order_seq_cst);
+  }
+
+  //! Whether memory retired in epoch retired may be reused
+  bool Reclaimable(uint64_t retired) const { return retired + 2 <= epoch(); }
+
+  //! Thread tid starts running a loop
+  void Online(unsigned tid);
+  //! Thread tid stops running a loop; it must be quiescent
+  void Offline(unsigned tid);
+
+  //! Thread tid holds no references to retired memory
+  void Quiesce(unsigned tid) {
+    Slot& slot = slots_[tid];
+    uint64_t epoch = this->epoch();
+    if (slot.seen.load(std::memory_order_relaxed) != epoch) {
+      slot.seen.store(epoch, std::memory_order_seq_cst);
+    }
+    if (++slot.quiesces == kQuiescesPerAdvance) {
+      slot.quiesces = 0;
+      TryAdvance(epoch);
+    }
+  }
+
+  //! A loop ended; no thread is online. Called by the master thread only.
+  void EndRound() { epoch_.fetch_add(2, std::memory_order_seq_cst); }
+};
+
+/**
+ * return a reference to the epoch manager of the system thread pool
+ */
+GALOIS_EXPORT EpochManager& GetEpochManager();
+
+}  // namespace galois::substrate
+
+#endif
@@ -35,6 +35,29 @@ GALOIS_EXPORT void* allocPages(unsigned num, bool preFault);
 // free page range
 GALOIS_EXPORT void freePages(void* ptr, unsigned num);
 
+/// The pages of allocSize() bytes currently allocated by allocPages, by the
+/// kind of backing they got.
+///
+/// allocPages first tries hugetlbfs pages (MAP_HUGETLB), which need a pool
+/// reserved by the administrator, and then transparent huge pages: aligned
+/// anonymous memory advised with MADV_HUGEPAGE, which the kernel backs with
+/// huge pages when it can. The environment variable GALOIS_HUGE_PAGES
+/// restricts this to hugetlb (falling back to regular pages), thp or none.
+struct PageAllocStats {
+  /// Pages from the hugetlbfs pool
+  size_t hugetlb_pages{};
+  /// Pages advised to be transparent huge pages
+  size_t thp_pages{};
+  /// Of thp_pages, how many the kernel currently backs with huge pages
+  size_t thp_backed_pages{};
+  /// Pages without any huge page backing
+  size_t small_pages{};
+};
+
+/// Count the pages allocated by allocPages; finding thp_backed_pages reads
+/// /proc/self/smaps, so this is meant for reporting rather than hot paths
+GALOIS_EXPORT PageAllocStats getPageAllocStats();
+
 }  // namespace galois::substrate
 
 #endif
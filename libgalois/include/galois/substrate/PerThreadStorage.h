@@ -20,8 +20,10 @@
 #ifndef GALOIS_LIBGALOIS_GALOIS_SUBSTRATE_PERTHREADSTORAGE_H_
 #define GALOIS_LIBGALOIS_GALOIS_SUBSTRATE_PERTHREADSTORAGE_H_
 
+#include <atomic>
 #include <cassert>
 #include <cstddef>
+#include <map>
 #include <utility>
 #include <vector>
 
@@ -34,13 +36,36 @@
 
 namespace galois::substrate {
 
+/**
+ * The memory of per-thread or per-socket storage: every thread (or socket)
+ * has a region of the same layout, and an object is an offset into each
+ * region.
+ *
+ * Each region reserves address space for up to maxSize() bytes, so offsets
+ * and the addresses they stand for never move, and commits it in chunks of
+ * allocSize() as the offsets in use grow. Regions prefer the memory of the
+ * NUMA node of their thread. Freed offsets are coalesced with
+ * their free neighbors and reused first fit; when the top of the offsets in
+ * use drops, the chunks above it are returned to the system, so a
+ * long-running process that creates and destroys storage keeps only what is
+ * live.
+ */
 class GALOIS_EXPORT PerBackend {
   typedef substrate::SimpleLock Lock;
 
-  std::atomic<unsigned int> nextLoc{0};
   std::atomic<char*>* heads{nullptr};
-  Lock freeOffsetsLock;
-  std::vector<std::vector<unsigned>> freeOffsets;
+  //! Guards the fields below
+  Lock lock;
+  //! The distinct regions, which per-socket heads share
+  std::vector<char*> regions;
+  //! Free ranges of offsets below end, by offset
+  std::map<unsigned, unsigned> freeRanges;
+  //! The top of the offsets in use
+  unsigned end{0};
+  //! The bytes of each region that are committed
+  size_t committed{0};
+  //! The bytes of live storage
+  size_t allocated{0};
   /**
    * Guards access to non-POD objects that can be accessed after PerBackend
    * is destroyed. Access can occur through destroying PerThread/PerSocket
@@ -50,21 +75,28 @@ class GALOIS_EXPORT PerBackend {
    */
   bool invalid{false};
 
-  void initCommon(unsigned maxT);
-  static unsigned nextLog2(unsigned size);
+  //! create the regions of all maxT threads, shared by the threads of a
+  //! socket if perSocket
+  void initCommon(unsigned maxT, bool perSocket);
+  char* newRegion(unsigned node);
+  void commit(size_t size);
+  void release(size_t size);
 
 public:
-  PerBackend();
+  PerBackend() = default;
 
   PerBackend(const PerBackend&) = delete;
   PerBackend& operator=(const PerBackend&) = delete;
 
   ~PerBackend() {
-    // Intentionally leak heads so that other PerThread operations are
-    // still valid after we are gone
+    // Intentionally leak heads and the regions so that other PerThread
+    // operations are still valid after we are gone
     invalid = true;
   }
 
+  //! The most bytes of storage a region holds
+  static size_t maxSize();
+
   char* initPerThread(unsigned maxT);
   char* initPerSocket(unsigned maxT);
 
@@ -75,6 +107,11 @@ public:
   // faster when (1) you already know the id and (2) shared access to heads is
   // not to expensive; otherwise use getLocal(unsigned,char*)
   void* getLocal(unsigned offset, unsigned id) { return &heads[id][offset]; }
+
+  //! The bytes of each region in use by live storage
+  size_t allocatedBytes();
+  //! The bytes of each region that are committed
+  size_t committedBytes();
 };
 
 extern thread_local char* ptsBase;
@@ -85,6 +122,10 @@ GALOIS_EXPORT PerBackend& getPPSBackend();
 
 GALOIS_EXPORT void initPTS(unsigned maxT);
 
+//! point the per-thread and per-socket storage of the calling thread at those
+//! of thread tid, which must have called initPTS
+GALOIS_EXPORT void adoptPTS(unsigned tid);
+
 template <typename T>
 class PerThreadStorage {
   PerBackend* b;
@@ -22,13 +22,18 @@
 
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <cstdlib>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <thread>
 #include <vector>
 
 #include "galois/substrate/CacheLineStorage.h"
+#include "galois/substrate/EpochManager.h"
 #include "galois/substrate/HWTopo.h"
 
 namespace galois::substrate::internal {
@@ -50,6 +55,11 @@ struct ExecuteTupleImpl<tpl, s, 0> {
 
 namespace galois::substrate {
 
+/**
+ * The threads that run parallel sections. Only the creating thread, thread 0,
+ * runs at first; the others are started by the first run on that many
+ * threads, so processes that only use a few threads pay for only those.
+ */
 class GALOIS_EXPORT ThreadPool {
   friend class SharedMem;
 
@@ -71,28 +81,81 @@ protected:
     std::atomic<int> fastRelease;
     ThreadTopoInfo topo;
 
+    //! set by a thread that gave up spinning in wait, under m
+    std::atomic<bool> sleeping{false};
+    //! when the last wakeup was sent, from now()
+    std::atomic<uint64_t> wakeTime{0};
+    //! wakeup statistics of this thread, written only by it
+    std::atomic<uint64_t> spinWakeups{0};
+    std::atomic<uint64_t> sleepWakeups{0};
+    std::atomic<uint64_t> totalLatency{0};
+    std::atomic<uint64_t> maxLatency{0};
+
+    static uint64_t now() {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                 std::chrono::steady_clock::now().time_since_epoch())
+          .count();
+    }
+
     void wakeup(bool fastmode) {
       if (fastmode) {
         done = 0;
         fastRelease = 1;
-      } else {
+        return;
+      }
+      done = 0;
+      wakeTime.store(now(), std::memory_order_relaxed);
+      // Either the waiter sees fastRelease before it sleeps or we see
+      // sleeping and notify it; both are sequentially consistent
+      fastRelease = 1;
+      if (sleeping) {
         std::lock_guard<std::mutex> lg(m);
-        done = 0;
         cv.notify_one();
-        // start.release();
       }
     }
 
-    void wait(bool fastmode) {
+    //! spin for up to spinBudget nanoseconds; returns whether released
+    bool spin(uint64_t spinBudget) {
+      constexpr int kPausesPerCheck = 64;
+      uint64_t deadline = now() + spinBudget;
+      do {
+        for (int i = 0; i < kPausesPerCheck; ++i) {
+          if (fastRelease.load(std::memory_order_acquire)) {
+            return true;
+          }
+          asmPause();
+        }
+      } while (now() < deadline);
+      return false;
+    }
+
+    void wait(bool fastmode, uint64_t spinBudget) {
       if (fastmode) {
         while (!fastRelease.load(std::memory_order_relaxed)) {
           asmPause();
         }
         fastRelease = 0;
-      } else {
+        return;
+      }
+
+      bool slept = false;
+      if (!fastRelease.load(std::memory_order_acquire) &&
+          (spinBudget == 0 || !spin(spinBudget))) {
         std::unique_lock<std::mutex> lg(m);
-        cv.wait(lg, [=] { return !done; });
-        // start.acquire();
+        sleeping = true;
+        cv.wait(lg, [=] { return fastRelease.load() != 0; });
+        sleeping = false;
+        slept = true;
+      }
+      fastRelease = 0;
+
+      constexpr auto relaxed = std::memory_order_relaxed;
+      uint64_t latency = now() - wakeTime.load(relaxed);
+      auto& count = slept ? sleepWakeups : spinWakeups;
+      count.store(count.load(relaxed) + 1, relaxed);
+      totalLatency.store(totalLatency.load(relaxed) + latency, relaxed);
+      if (latency > maxLatency.load(relaxed)) {
+        maxLatency.store(latency, relaxed);
       }
     }
   };
@@ -100,12 +163,20 @@ protected:
   thread_local static per_signal my_box;
 
   MachineTopoInfo mi;
+  std::vector<ThreadTopoInfo> topo;
   std::vector<per_signal*> signals;
+  //! indexed by tid; threads that have not been started are not joinable
   std::vector<std::thread> threads;
+  //! threads [0, started) have been started
+  unsigned started;
   unsigned reserved;
   unsigned masterFastmode;
-  bool running;
+  //! set for the duration of a run; there is one run at a time per process
+  std::atomic<bool> running;
+  std::atomic<uint64_t> idleSpin;
   std::function<void(void)> work;
+  //! threads are online in it while they run work, and each run ends a round
+  std::unique_ptr<EpochManager> epochs;
 
   //! destroy all threads
   void destroyCommon();
@@ -113,6 +184,15 @@ protected:
   //! Initialize a thread
   void initThread(unsigned tid);
 
+  //! start thread tid, which will initialize itself
+  void startThread(unsigned tid);
+
+  //! wait for the threads [begin, end) to initialize
+  void waitForThreads(unsigned begin, unsigned end);
+
+  //! start the threads [started, num) that runs on num threads need
+  void startThreads(unsigned num);
+
   //! main thread loop
   void threadLoop(unsigned tid);
 
@@ -122,6 +202,9 @@ protected:
   //! spin down after run
   void decascade();
 
+  //! claim the pool for a run, which must not overlap another
+  void beginRun();
+
   //! execute work on num threads
   void runInternal(unsigned num);
 
@@ -151,6 +234,8 @@ public:
       }
       ExecuteTuple(Args&&... args) : cmds(std::forward<Args>(args)...) {}
     };
+    // claim the pool before work is replaced
+    beginRun();
     // paying for an indirection in work allows small-object optimization in
     // std::function to kick in and avoid a heap allocation
     ExecuteTuple lwork(std::forward<Args>(args)...);
@@ -164,13 +249,51 @@ public:
   //! run function in a dedicated thread until the threadpool exits
   void runDedicated(std::function<void(void)>& f);
 
+  //! make the calling thread, which is not a thread of the pool, stand in
+  //! for the thread that created it: its runs run as thread 0, with the
+  //! per-thread storage of thread 0. Its runs and those of the creating
+  //! thread must not overlap, which beginRun catches.
+  void adoptMaster();
+
   // experimental: busy wait for work
   void burnPower(unsigned num);
   // experimental: leave busy wait
   void beKind();
 
+  //! Wakeups of the threads of the pool outside of burnPower, since the pool
+  //! started or since resetWakeupStats
+  struct WakeupStats {
+    //! wakeups of threads that were still spinning
+    uint64_t spinning = 0;
+    //! wakeups of threads that had gone to sleep
+    uint64_t sleeping = 0;
+    //! total and largest time from a wakeup until its thread ran, in
+    //! nanoseconds
+    uint64_t totalLatency = 0;
+    uint64_t maxLatency = 0;
+  };
+
+  //! Threads idle outside of burnPower spin for up to budget waiting for the
+  //! next run before they sleep: a budget longer than the gaps between runs
+  //! saves the wakeup latency of sleeping, at the cost of burning cores for
+  //! up to budget after each run. Zero, the default unless the
+  //! GALOIS_IDLE_SPIN_US environment variable is set, sleeps at once.
+  void setIdleSpin(std::chrono::nanoseconds budget) {
+    idleSpin = budget.count() > 0 ? budget.count() : 0;
+  }
+  std::chrono::nanoseconds getIdleSpin() const {
+    return std::chrono::nanoseconds(idleSpin.load());
+  }
+
+  //! only consistent when the pool is not running
+  WakeupStats getWakeupStats() const;
+  void resetWakeupStats();
+
   bool isRunning() const { return running; }
 
+  //! the epochs of memory reclamation, which advance with the runs
+  EpochManager& getEpochManager() { return *epochs; }
+
   //! return the number of non-reserved threads in the pool
   unsigned getMaxUsableThreads() const { return mi.maxThreads - reserved; }
   //! return the number of threads supported by the thread pool on the current
@@ -188,18 +311,18 @@ public:
   }
 
   bool isLeader(unsigned tid) const {
-    return signals[tid]->topo.socketLeader == tid;
-  }
-  unsigned getSocket(unsigned tid) const { return signals[tid]->topo.socket; }
-  unsigned getLeader(unsigned tid) const {
-    return signals[tid]->topo.socketLeader;
+    return topo[tid].socketLeader == tid;
   }
+  unsigned getSocket(unsigned tid) const { return topo[tid].socket; }
+  unsigned getLeader(unsigned tid) const { return topo[tid].socketLeader; }
   unsigned getCumulativeMaxSocket(unsigned tid) const {
-    return signals[tid]->topo.cumulativeMaxSocket;
-  }
-  unsigned getNumaNode(unsigned tid) const {
-    return signals[tid]->topo.numaNode;
+    return topo[tid].cumulativeMaxSocket;
   }
+  unsigned getNumaNode(unsigned tid) const { return topo[tid].numaNode; }
+
+  //! the number of threads started so far; threads start on the first run
+  //! that needs them
+  unsigned getStartedThreads() const { return started; }
 
   static unsigned getTID() { return my_box.topo.tid; }
   static bool isLeader() { return my_box.topo.tid == my_box.topo.socketLeader; }
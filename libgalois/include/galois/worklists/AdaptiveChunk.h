@@ -0,0 +1,315 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_LIBGALOIS_GALOIS_WORKLISTS_ADAPTIVECHUNK_H_
+#define GALOIS_LIBGALOIS_GALOIS_WORKLISTS_ADAPTIVECHUNK_H_
+
+#include <algorithm>
+#include <cstdint>
+
+#include <boost/utility.hpp>
+
+#include "galois/FixedSizeRing.h"
+#include "galois/Statistics.h"
+#include "galois/config.h"
+#include "galois/optional.h"
+#include "galois/runtime/Mem.h"
+#include "galois/substrate/PerThreadStorage.h"
+#include "galois/substrate/SimpleLock.h"
+#include "galois/substrate/ThreadPool.h"
+#include "galois/worklists/WLCompileCheck.h"
+#include "galois/worklists/WorkListHelpers.h"
+
+namespace galois {
+namespace worklists {
+
+/**
+ * Chunked FIFO worklist whose chunk size adapts to the loop.
+ *
+ * Like dChunkedFIFO, each thread fills a private chunk and, when it is full,
+ * pushes it on the queue of its socket; a thread pops chunks from its own
+ * socket before those of other sockets. Unlike dChunkedFIFO, a chunk is full
+ * once it holds as many items as the current limit of its thread, which
+ * moves between MinChunkSize and MaxChunkSize:
+ *
+ * - When queue operations of a thread often find the queue lock held, the
+ *   chunks are too small to amortize it and the limit doubles.
+ * - When a thread often has to take chunks from other sockets or finds no
+ *   work at all, there are too few chunks to balance the load and the limit
+ *   halves.
+ *
+ * Each thread decides after every kWindow queue operations. The smallest,
+ * largest and average limits with which threads published chunks are
+ * reported as statistics of the loop, along with the number of resizes.
+ *
+ * @tparam MinChunkSize smallest number of items in a published chunk
+ * @tparam MaxChunkSize largest number of items in a published chunk, also
+ * the capacity of every chunk
+ */
+template <int MinChunkSize = 8, int MaxChunkSize = 256, typename T = int>
+class AdaptiveChunk : private boost::noncopyable {
+  static_assert(
+      0 < MinChunkSize && MinChunkSize <= MaxChunkSize,
+      "chunk sizes must be positive and ordered");
+
+public:
+  template <typename _T>
+  using retype = AdaptiveChunk<MinChunkSize, MaxChunkSize, _T>;
+
+  template <bool _concurrent>
+  using rethread = AdaptiveChunk<MinChunkSize, MaxChunkSize, T>;
+
+  //! The chunk size of other worklists sets the largest chunk
+  template <int _chunk_size>
+  using with_chunk_size =
+      AdaptiveChunk<std::min(MinChunkSize, _chunk_size), _chunk_size, T>;
+
+  typedef T value_type;
+
+  //! Number of queue operations between two decisions of a thread
+  static constexpr unsigned kWindow = 32;
+
+private:
+  class Chunk : public FixedSizeRing<T, MaxChunkSize>,
+                public ConExtListNode<Chunk> {};
+
+  //! FIFO of chunks whose lock reports whether it was contended
+  struct Queue {
+    substrate::SimpleLock lock;
+    Chunk* head{};
+    Chunk* tail{};
+
+    //! Returns true if another thread held the lock
+    bool acquire() {
+      if (lock.try_lock()) {
+        return false;
+      }
+      lock.lock();
+      return true;
+    }
+
+    bool push(Chunk* c) {
+      bool contended = acquire();
+      c->getNext() = nullptr;
+      if (tail) {
+        tail->getNext() = c;
+      } else {
+        head = c;
+      }
+      tail = c;
+      lock.unlock();
+      return contended;
+    }
+
+    Chunk* pop(bool* contended) {
+      // lock free fast path for the empty case
+      if (!head) {
+        return nullptr;
+      }
+      *contended = acquire();
+      Chunk* c = head;
+      if (c) {
+        head = c->getNext();
+        if (!head) {
+          tail = nullptr;
+        }
+        c->getNext() = nullptr;
+      }
+      lock.unlock();
+      return c;
+    }
+  };
+
+  struct PerThread {
+    //! Chunk being drained by pop
+    Chunk* cur{};
+    //! Chunk being filled by push
+    Chunk* next{};
+    unsigned limit{MinChunkSize};
+
+    // counts in the current window
+    unsigned ops{};
+    unsigned contended{};
+    unsigned starved{};
+    //! Set after a pop that found no work, so that idling counts once
+    bool idle{};
+
+    // totals reported at the end of the loop
+    uint64_t chunks{};
+    uint64_t items{};
+    unsigned min_limit{MaxChunkSize};
+    unsigned max_limit{0};
+    uint64_t resizes{};
+  };
+
+  runtime::FixedSizeAllocator<Chunk> alloc;
+  substrate::PerThreadStorage<PerThread> data;
+  substrate::PerSocketStorage<Queue> queues;
+
+  Chunk* mkChunk() {
+    Chunk* ptr = alloc.allocate(1);
+    alloc.construct(ptr);
+    return ptr;
+  }
+
+  void delChunk(Chunk* ptr) {
+    alloc.destroy(ptr);
+    alloc.deallocate(ptr, 1);
+  }
+
+  void adapt(PerThread& p) {
+    if (++p.ops < kWindow) {
+      return;
+    }
+    unsigned limit = p.limit;
+    if (p.starved * 4 >= p.ops) {
+      limit = std::max<unsigned>(MinChunkSize, limit / 2);
+    } else if (p.contended * 8 >= p.ops) {
+      limit = std::min<unsigned>(MaxChunkSize, limit * 2);
+    }
+    if (limit != p.limit) {
+      p.limit = limit;
+      ++p.resizes;
+    }
+    p.ops = p.contended = p.starved = 0;
+  }
+
+  void publish(PerThread& p) {
+    Chunk* c = p.next;
+    p.next = nullptr;
+    p.chunks += 1;
+    p.items += c->size();
+    p.min_limit = std::min(p.min_limit, p.limit);
+    p.max_limit = std::max(p.max_limit, p.limit);
+    p.contended += queues.getLocal()->push(c);
+    adapt(p);
+  }
+
+  Chunk* popChunk(PerThread& p) {
+    bool contended = false;
+    Chunk* c = queues.getLocal()->pop(&contended);
+    if (!c) {
+      unsigned id = substrate::ThreadPool::getSocket();
+      unsigned num = substrate::GetThreadPool().getMaxSockets();
+      for (unsigned i = 1; i < num && !c; ++i) {
+        c = queues.getRemoteByPkg((id + i) % num)->pop(&contended);
+      }
+      if (c || !p.idle) {
+        p.starved += 1;
+      }
+    }
+    p.contended += contended;
+    if (c || !p.idle) {
+      adapt(p);
+    }
+    return c;
+  }
+
+public:
+  AdaptiveChunk() = default;
+
+  ~AdaptiveChunk() {
+    for (unsigned i = 0; i < data.size(); ++i) {
+      PerThread& p = *data.getRemote(i);
+      if (p.cur) {
+        delChunk(p.cur);
+      }
+      if (p.next) {
+        delChunk(p.next);
+      }
+    }
+    for (unsigned i = 0; i < substrate::GetThreadPool().getMaxSockets(); ++i) {
+      bool contended;
+      while (Chunk* c = queues.getRemoteByPkg(i)->pop(&contended)) {
+        delChunk(c);
+      }
+    }
+  }
+
+  void push(const value_type& val) {
+    PerThread& p = *data.getLocal();
+    p.idle = false;
+    if (p.next && p.next->size() >= p.limit) {
+      publish(p);
+    }
+    if (!p.next) {
+      p.next = mkChunk();
+    }
+    p.next->push_back(val);
+  }
+
+  template <typename Iter>
+  void push(Iter b, Iter e) {
+    while (b != e) {
+      push(*b++);
+    }
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    push(range.local_begin(), range.local_end());
+    PerThread& p = *data.getLocal();
+    if (p.next) {
+      publish(p);
+    }
+  }
+
+  galois::optional<value_type> pop() {
+    PerThread& p = *data.getLocal();
+    if (p.cur && !p.cur->empty()) {
+      return p.cur->extract_front();
+    }
+    if (p.cur) {
+      delChunk(p.cur);
+    }
+    p.cur = popChunk(p);
+    if (!p.cur) {
+      // fall back to the chunk being filled rather than publishing it
+      p.cur = p.next;
+      p.next = nullptr;
+    }
+    if (p.cur && !p.cur->empty()) {
+      p.idle = false;
+      return p.cur->extract_front();
+    }
+    p.idle = true;
+    return galois::optional<value_type>();
+  }
+
+  /**
+   * Reports the chunk sizes chosen by this thread as statistics of loopname.
+   * Called by each thread of a for_each at the end of the loop.
+   */
+  void reportStats(const char* loopname) {
+    PerThread& p = *data.getLocal();
+    if (!p.chunks) {
+      return;
+    }
+    ReportStatMin(loopname, "ChunkSizeMin", p.min_limit);
+    ReportStatMax(loopname, "ChunkSizeMax", p.max_limit);
+    ReportStatAvg(loopname, "ChunkSizeAvg", double(p.items) / p.chunks);
+    ReportStatSum(loopname, "ChunkResizes", p.resizes);
+  }
+};
+GALOIS_WLCOMPILECHECK(AdaptiveChunk)
+
+}  // namespace worklists
+}  // namespace galois
+
+#endif
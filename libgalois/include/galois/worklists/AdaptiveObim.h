@@ -0,0 +1,235 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_LIBGALOIS_GALOIS_WORKLISTS_ADAPTIVEOBIM_H_
+#define GALOIS_LIBGALOIS_GALOIS_WORKLISTS_ADAPTIVEOBIM_H_
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include <boost/utility.hpp>
+
+#include "galois/Statistics.h"
+#include "galois/config.h"
+#include "galois/optional.h"
+#include "galois/substrate/PerThreadStorage.h"
+#include "galois/worklists/Chunk.h"
+#include "galois/worklists/Obim.h"
+#include "galois/worklists/WLCompileCheck.h"
+#include "galois/worklists/WorkListHelpers.h"
+
+namespace galois {
+namespace worklists {
+
+namespace internal {
+
+//! Rounds the index of Indexer down to a multiple of 2^shift, so that indices
+//! computed with different shifts stay comparable in the same order
+template <typename Indexer, typename Index>
+struct AdaptiveObimIndexer {
+  Indexer indexer;
+  const std::atomic<unsigned>* shift;
+
+  template <typename R>
+  Index operator()(const R& val) {
+    return Round(indexer(val), shift->load(std::memory_order_relaxed));
+  }
+
+  static Index Round(Index i, unsigned s) {
+    return i & ~static_cast<Index>((static_cast<Index>(1) << s) - 1);
+  }
+};
+
+}  // namespace internal
+
+/**
+ * Priority scheduling whose bucket width adapts to the loop (PMOD, Yesil et
+ * al., SC '19).
+ *
+ * Like OrderedByIntegerMetric, which it uses underneath, items are kept in
+ * buckets by index. The index of an item is that of Indexer rounded down to
+ * a multiple of 2^shift, where the shift, and so the number of priorities a
+ * bucket merges, changes at runtime:
+ *
+ * - When threads pop few items from a bucket before they move to another,
+ *   buckets are too small to keep threads busy and each bucket change costs
+ *   a scan of the bucket map; the shift grows, merging buckets.
+ * - When threads pop many items from the same bucket, buckets are so large
+ *   that items of very different priorities run together and much of the
+ *   work is wasted; the shift shrinks, splitting buckets.
+ *
+ * Each thread decides after every kWindow pops. Rounded indices keep the
+ * order of the unrounded ones, so the buckets created before a change stay
+ * ordered among those created after it. Indexer should therefore be as fine
+ * as possible, e.g., the distance itself rather than a delta-stepping bucket,
+ * and the initial shift plays the role of delta.
+ *
+ * The largest shift and the number of merges and splits are reported as
+ * statistics of the loop.
+ *
+ * @tparam Indexer   Indexer class, returning an integral Index
+ * @tparam Container Scheduler for each bucket
+ */
+template <
+    class Indexer = DummyIndexer<int>,
+    typename Container = PerSocketChunkFIFO<>, typename T = int,
+    typename Index = int, bool Concurrent = true>
+class AdaptiveOrderedByIntegerMetric : private boost::noncopyable {
+  static_assert(std::is_integral<Index>::value, "index must be integral");
+
+public:
+  template <typename _T>
+  using retype = AdaptiveOrderedByIntegerMetric<
+      Indexer, typename Container::template retype<_T>, _T,
+      typename std::result_of<Indexer(_T)>::type, Concurrent>;
+
+  template <bool _b>
+  using rethread =
+      AdaptiveOrderedByIntegerMetric<Indexer, Container, T, Index, _b>;
+
+  template <typename _container>
+  struct with_container {
+    typedef AdaptiveOrderedByIntegerMetric<
+        Indexer, _container, T, Index, Concurrent>
+        type;
+  };
+
+  typedef T value_type;
+  typedef Index index_type;
+
+  //! Pops of a thread between two decisions
+  static constexpr unsigned kWindow = 1024;
+  //! Merge when threads pop fewer items than this from a bucket on average
+  static constexpr unsigned kMergeRun = 16;
+  //! Split when threads pop more items than this from a bucket on average
+  static constexpr unsigned kSplitRun = 512;
+  static_assert(kMergeRun < kSplitRun && kSplitRun < kWindow);
+
+private:
+  using AdaptiveIndexer = internal::AdaptiveObimIndexer<Indexer, Index>;
+  using OBIM = OrderedByIntegerMetric<
+      AdaptiveIndexer, Container, 0, true, T, Index, false, false, false,
+      Concurrent>;
+
+  static constexpr unsigned kMaxShift = std::numeric_limits<Index>::digits - 1;
+
+  struct ThreadData {
+    Index last{};
+    unsigned shift_seen{};
+    unsigned pops{};
+    unsigned changes{};
+
+    unsigned max_shift{};
+    uint64_t merges{};
+    uint64_t splits{};
+  };
+
+  std::atomic<unsigned> shift;
+  Indexer indexer;
+  substrate::PerThreadStorage<ThreadData> data;
+  OBIM obim;
+
+  void Adapt(ThreadData& p) {
+    unsigned s = shift.load(std::memory_order_relaxed);
+    if (s != p.shift_seen) {
+      // the shift changed since this thread last decided, so the window
+      // mixes two bucket widths
+      p.shift_seen = s;
+    } else if (p.pops < kMergeRun * p.changes && s < kMaxShift) {
+      if (shift.compare_exchange_strong(s, s + 1)) {
+        p.shift_seen = s + 1;
+        p.merges += 1;
+      }
+    } else if (p.pops > kSplitRun * p.changes && s > 0) {
+      if (shift.compare_exchange_strong(s, s - 1)) {
+        p.shift_seen = s - 1;
+        p.splits += 1;
+      }
+    }
+    p.max_shift = std::max(p.max_shift, p.shift_seen);
+    p.pops = p.changes = 0;
+  }
+
+public:
+  /**
+   * @param x Indexer of items
+   * @param initial_shift log2 of the number of indices of a bucket at the start
+   */
+  AdaptiveOrderedByIntegerMetric(
+      const Indexer& x = Indexer(), unsigned initial_shift = 0)
+      : shift(std::min(initial_shift, kMaxShift)),
+        indexer(x),
+        obim(AdaptiveIndexer{x, &shift}) {}
+
+  //! log2 of the number of indices of a bucket
+  unsigned bucket_shift() const {
+    return shift.load(std::memory_order_relaxed);
+  }
+
+  void push(const value_type& val) { obim.push(val); }
+
+  template <typename Iter>
+  void push(Iter b, Iter e) {
+    obim.push(b, e);
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    obim.push_initial(range);
+  }
+
+  galois::optional<value_type> pop() {
+    galois::optional<value_type> item = obim.pop();
+    if (!item) {
+      return item;
+    }
+    ThreadData& p = *data.getLocal();
+    Index index = AdaptiveIndexer::Round(
+        indexer(*item), shift.load(std::memory_order_relaxed));
+    if (index != p.last) {
+      p.last = index;
+      p.changes += 1;
+    }
+    if (++p.pops == kWindow) {
+      Adapt(p);
+    }
+    return item;
+  }
+
+  /**
+   * Reports the bucket widths chosen by this thread as statistics of
+   * loopname. Called by each thread of a for_each at the end of the loop.
+   */
+  void reportStats(const char* loopname) {
+    ThreadData& p = *data.getLocal();
+    ReportStatMax(
+        loopname, "BucketShiftMax",
+        std::max(p.max_shift, shift.load(std::memory_order_relaxed)));
+    ReportStatSum(loopname, "BucketMerges", p.merges);
+    ReportStatSum(loopname, "BucketSplits", p.splits);
+  }
+};
+GALOIS_WLCOMPILECHECK(AdaptiveOrderedByIntegerMetric)
+
+}  // namespace worklists
+}  // namespace galois
+
+#endif
@@ -0,0 +1,219 @@
+#ifndef GALOIS_LIBGALOIS_GALOIS_WORKLISTS_BULKSYNCHRONOUSDENSE_H_
+#define GALOIS_LIBGALOIS_GALOIS_WORKLISTS_BULKSYNCHRONOUSDENSE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <type_traits>
+
+#include "galois/DynamicBitset.h"
+#include "galois/config.h"
+#include "galois/substrate/Barrier.h"
+#include "galois/worklists/Chunk.h"
+#include "galois/worklists/WLCompileCheck.h"
+
+namespace galois {
+namespace worklists {
+
+/**
+ * Bulk-synchronous scheduling of node ids in [0, num_items) that holds each
+ * round either in chunks, as BulkSynchronous does, or, when a round holds a
+ * large fraction of the nodes, in a bitset of the nodes. Pushing to a bitset
+ * sets a bit instead of filling chunks, and also drops the duplicates of a
+ * round.
+ *
+ * The bitsets are double-buffered like the containers. Threads pop the set
+ * bits of the current round in blocks of words, clearing the words as they
+ * take them, so that the bitset is clear for reuse when the round ends. The
+ * container of each round is chosen when the round before it starts: a
+ * round of at least dense_fraction * num_items items makes the next one
+ * dense, following the direction-switching heuristic of Beamer et al.
+ *
+ * Use it as wl<BulkSynchronousDense<>>(num_items).
+ */
+template <
+    class Container = PerSocketChunkFIFO<>, class T = uint32_t,
+    bool Concurrent = true>
+class BulkSynchronousDense : private boost::noncopyable {
+public:
+  template <bool _concurrent>
+  using rethread = BulkSynchronousDense<Container, T, _concurrent>;
+
+  template <typename _T>
+  using retype = BulkSynchronousDense<
+      typename Container::template retype<_T>, _T, Concurrent>;
+
+  template <typename _container>
+  using with_container = BulkSynchronousDense<_container, T, Concurrent>;
+
+  //! The default fraction of the nodes in a round from which the next
+  //! round is dense
+  static constexpr double kDefaultDenseFraction = 0.05;
+
+  static_assert(std::is_integral_v<T>, "items must be node ids");
+
+private:
+  typedef typename Container::template rethread<Concurrent> CTy;
+
+  //! Words of the bitset that a thread takes at a time
+  static constexpr size_t kBlockWords = 16;
+
+  struct TLD {
+    unsigned round{0};
+    //! pushes by this thread to each buffer
+    size_t pushed[2]{0, 0};
+    //! the set bits left of the word at word_index
+    uint64_t bits{0};
+    size_t word_index{0};
+    size_t next_word{0};
+    size_t block_end{0};
+  };
+
+  CTy wls[2];
+  DynamicBitset bitsets[2];
+  //! whether each buffer holds its round in the bitset; a round may also
+  //! turn dense while it is pushed, but never back
+  std::atomic<bool> dense[2]{false, false};
+  size_t dense_threshold;
+  substrate::PerThreadStorage<TLD> tlds;
+  substrate::Barrier& barrier;
+  substrate::CacheLineStorage<std::atomic<bool>> some;
+  substrate::CacheLineStorage<std::atomic<size_t>> cursor;
+  std::atomic<bool> isEmpty;
+
+  galois::optional<T> popBits(TLD& tld) {
+    auto& words = bitsets[tld.round].get_vec();
+    const size_t num_words = words.size();
+    while (true) {
+      if (tld.bits != 0) {
+        size_t index = tld.word_index * DynamicBitset::bits_uint64 +
+                       __builtin_ctzll(tld.bits);
+        tld.bits &= tld.bits - 1;
+        return static_cast<T>(index);
+      }
+      if (tld.next_word < tld.block_end) {
+        // only this thread reads the words of its block, and pushes go to
+        // the other bitset
+        auto& word = words[tld.next_word];
+        tld.bits = word.load(std::memory_order_relaxed);
+        if (tld.bits != 0) {
+          word.store(0, std::memory_order_relaxed);
+        }
+        tld.word_index = tld.next_word++;
+        continue;
+      }
+      size_t begin = cursor.get().fetch_add(kBlockWords);
+      if (begin >= num_words) {
+        return galois::optional<T>();
+      }
+      tld.next_word = begin;
+      tld.block_end = std::min(begin + kBlockWords, num_words);
+    }
+  }
+
+  galois::optional<T> popRound(TLD& tld) {
+    if (dense[tld.round]) {
+      if (auto r = popBits(tld)) {
+        return r;
+      }
+    }
+    return wls[tld.round].pop();
+  }
+
+public:
+  typedef T value_type;
+
+  explicit BulkSynchronousDense(
+      size_t num_items = 0, double dense_fraction = kDefaultDenseFraction)
+      : dense_threshold(std::max<size_t>(
+            1, static_cast<size_t>(dense_fraction * num_items))),
+        barrier(substrate::GetBarrier(runtime::activeThreads)),
+        some(false),
+        cursor(0),
+        isEmpty(false) {
+    for (auto& bitset : bitsets) {
+      bitset.resize(num_items);
+    }
+  }
+
+  void push(const value_type& val) {
+    TLD& tld = *tlds.getLocal();
+    unsigned next = (tld.round + 1) & 1;
+    tld.pushed[next] += 1;
+    if (dense[next]) {
+      assert(static_cast<size_t>(val) < bitsets[next].size());
+      bitsets[next].set(val);
+    } else {
+      wls[next].push(val);
+    }
+  }
+
+  template <typename ItTy>
+  void push(ItTy b, ItTy e) {
+    while (b != e)
+      push(*b++);
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    // No round sizes the second round; threads estimate the first from
+    // their part of it instead
+    size_t local = std::distance(range.local_begin(), range.local_end());
+    if (local * runtime::activeThreads >= dense_threshold) {
+      dense[0] = true;
+    }
+    push(range.local_begin(), range.local_end());
+    tlds.getLocal()->round = 1;
+    some.get() = true;
+  }
+
+  galois::optional<value_type> pop() {
+    TLD& tld = *tlds.getLocal();
+    galois::optional<value_type> r;
+
+    while (true) {
+      if (isEmpty)
+        return r;  // empty
+
+      r = popRound(tld);
+      if (r)
+        return r;
+
+      barrier.Wait();
+      if (substrate::ThreadPool::getTID() == 0) {
+        if (!some.get())
+          isEmpty = true;
+        some.get() = false;
+
+        // The round that starts holds what was pushed to the other buffer;
+        // its size decides how the round after it, which reuses the buffer
+        // of the round that ended, is held
+        unsigned starting = (tld.round + 1) & 1;
+        size_t size = 0;
+        for (unsigned i = 0; i < tlds.size(); ++i) {
+          TLD& other = *tlds.getRemote(i);
+          size += other.pushed[starting];
+          other.pushed[starting] = 0;
+        }
+        dense[tld.round] = size >= dense_threshold;
+        cursor.get() = 0;
+      }
+      tld.round = (tld.round + 1) & 1;
+      tld.next_word = 0;
+      tld.block_end = 0;
+      barrier.Wait();
+
+      r = popRound(tld);
+      if (r) {
+        some.get() = true;
+        return r;
+      }
+    }
+  }
+};
+GALOIS_WLCOMPILECHECK(BulkSynchronousDense)
+
+}  // end namespace worklists
+}  // end namespace galois
+
+#endif
@@ -0,0 +1,307 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_LIBGALOIS_GALOIS_WORKLISTS_CHASELEV_H_
+#define GALOIS_LIBGALOIS_GALOIS_WORKLISTS_CHASELEV_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <boost/utility.hpp>
+
+#include "galois/FixedSizeRing.h"
+#include "galois/Threads.h"
+#include "galois/config.h"
+#include "galois/optional.h"
+#include "galois/runtime/Mem.h"
+#include "galois/substrate/CacheLineStorage.h"
+#include "galois/substrate/CompilerSpecific.h"
+#include "galois/substrate/PerThreadStorage.h"
+#include "galois/substrate/ThreadPool.h"
+#include "galois/worklists/WLCompileCheck.h"
+
+namespace galois {
+namespace worklists {
+
+namespace internal {
+
+/**
+ * A lock-free work-stealing deque of pointers (Chase and Lev, SPAA '05) with
+ * the memory orders of Lê et al. (PPoPP '13). One thread, the owner, pushes
+ * and pops at the bottom; any other thread may steal from the top. The
+ * circular array doubles when it is full; replaced arrays are kept until the
+ * deque is destroyed because thieves may still be reading them.
+ */
+template <typename T>
+class ChaseLevDeque : private boost::noncopyable {
+  static constexpr int64_t kInitialSize = 64;
+
+  struct Array {
+    int64_t mask;
+    std::unique_ptr<std::atomic<T*>[]> slots;
+
+    explicit Array(int64_t size)
+        : mask(size - 1), slots(new std::atomic<T*>[size]) {}
+
+    int64_t size() const { return mask + 1; }
+    T* get(int64_t i) const {
+      return slots[i & mask].load(std::memory_order_relaxed);
+    }
+    void put(int64_t i, T* x) {
+      slots[i & mask].store(x, std::memory_order_relaxed);
+    }
+  };
+
+  substrate::CacheLineStorage<std::atomic<int64_t>> top_;
+  substrate::CacheLineStorage<std::atomic<int64_t>> bottom_;
+  std::atomic<Array*> array_;
+  //! Every array the deque has used, including the current one
+  std::vector<std::unique_ptr<Array>> arrays_;
+
+  GALOIS_ATTRIBUTE_NOINLINE
+  Array* Grow(Array* a, int64_t bottom, int64_t top) {
+    auto bigger = std::make_unique<Array>(2 * a->size());
+    for (int64_t i = top; i < bottom; ++i) {
+      bigger->put(i, a->get(i));
+    }
+    Array* r = bigger.get();
+    arrays_.emplace_back(std::move(bigger));
+    array_.store(r, std::memory_order_release);
+    return r;
+  }
+
+public:
+  ChaseLevDeque() {
+    arrays_.emplace_back(std::make_unique<Array>(kInitialSize));
+    array_.store(arrays_.back().get(), std::memory_order_relaxed);
+  }
+
+  //! Owner only
+  void push(T* x) {
+    int64_t b = bottom_.data.load(std::memory_order_relaxed);
+    int64_t t = top_.data.load(std::memory_order_acquire);
+    Array* a = array_.load(std::memory_order_relaxed);
+    if (b - t > a->size() - 1) {
+      a = Grow(a, b, t);
+    }
+    a->put(b, x);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.data.store(b + 1, std::memory_order_relaxed);
+  }
+
+  //! Owner only; returns the most recently pushed pointer or nullptr
+  T* pop() {
+    int64_t b = bottom_.data.load(std::memory_order_relaxed) - 1;
+    Array* a = array_.load(std::memory_order_relaxed);
+    bottom_.data.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top_.data.load(std::memory_order_relaxed);
+    if (t > b) {
+      bottom_.data.store(b + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    T* x = a->get(b);
+    if (t == b) {
+      // last element: race the thieves for it
+      if (!top_.data.compare_exchange_strong(
+              t, t + 1, std::memory_order_seq_cst,
+              std::memory_order_relaxed)) {
+        x = nullptr;
+      }
+      bottom_.data.store(b + 1, std::memory_order_relaxed);
+    }
+    return x;
+  }
+
+  //! Any thread; returns the least recently pushed pointer, or nullptr if
+  //! the deque is empty or another thread took it first
+  T* steal() {
+    int64_t t = top_.data.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom_.data.load(std::memory_order_acquire);
+    if (t >= b) {
+      return nullptr;
+    }
+    Array* a = array_.load(std::memory_order_acquire);
+    T* x = a->get(t);
+    if (!top_.data.compare_exchange_strong(
+            t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return x;
+  }
+
+  bool empty() const {
+    return top_.data.load(std::memory_order_relaxed) >=
+           bottom_.data.load(std::memory_order_relaxed);
+  }
+};
+
+}  // namespace internal
+
+/**
+ * Work-stealing worklist with a lock-free Chase-Lev deque per thread.
+ *
+ * Each thread fills a private chunk of ChunkSize items and, when it is full,
+ * pushes it on the bottom of its deque. A thread pops its own work in LIFO
+ * order: first from its chunk, then the most recently pushed chunk of its
+ * deque. When it runs out, it steals the oldest chunk of another thread,
+ * trying the threads of its own socket before those of other sockets, so
+ * steals move the least recently generated work and rarely cross sockets.
+ * Only the CAS on top of a deque is shared between a thread and its thieves,
+ * and only when they contend for the same chunk.
+ *
+ * Small chunks keep stealing fine-grained; larger ones amortize the deque
+ * operations over more items.
+ *
+ * @tparam ChunkSize number of items moved by a push on a deque or a steal
+ */
+template <int ChunkSize = 16, typename T = int>
+class ChaseLev : private boost::noncopyable {
+public:
+  template <typename _T>
+  using retype = ChaseLev<ChunkSize, _T>;
+
+  template <bool _concurrent>
+  using rethread = ChaseLev<ChunkSize, T>;
+
+  template <int _chunk_size>
+  using with_chunk_size = ChaseLev<_chunk_size, T>;
+
+  typedef T value_type;
+
+private:
+  class Chunk : public FixedSizeRing<T, ChunkSize> {};
+
+  struct PerThread {
+    //! Chunk being filled by push and drained by pop; not visible to thieves
+    Chunk* cur{};
+    internal::ChaseLevDeque<Chunk> deque;
+    //! Rotates the first victim on other sockets to spread their steals
+    unsigned remote_offset{};
+  };
+
+  runtime::FixedSizeAllocator<Chunk> alloc;
+  substrate::PerThreadStorage<PerThread> data;
+
+  Chunk* mkChunk() {
+    Chunk* ptr = alloc.allocate(1);
+    alloc.construct(ptr);
+    return ptr;
+  }
+
+  void delChunk(Chunk* ptr) {
+    alloc.destroy(ptr);
+    alloc.deallocate(ptr, 1);
+  }
+
+  GALOIS_ATTRIBUTE_NOINLINE
+  Chunk* steal(PerThread& me) {
+    auto& tp = substrate::GetThreadPool();
+    unsigned id = substrate::ThreadPool::getTID();
+    unsigned socket = substrate::ThreadPool::getSocket();
+    unsigned num = galois::getActiveThreads();
+
+    for (unsigned i = 1; i < num; ++i) {
+      unsigned victim = (id + i) % num;
+      if (tp.getSocket(victim) == socket) {
+        if (Chunk* c = data.getRemote(victim)->deque.steal()) {
+          return c;
+        }
+      }
+    }
+
+    unsigned offset = me.remote_offset++;
+    for (unsigned i = 0; i < num; ++i) {
+      unsigned victim = (id + offset + i) % num;
+      if (tp.getSocket(victim) != socket) {
+        if (Chunk* c = data.getRemote(victim)->deque.steal()) {
+          return c;
+        }
+      }
+    }
+    return nullptr;
+  }
+
+public:
+  ChaseLev() = default;
+
+  ~ChaseLev() {
+    for (unsigned i = 0; i < data.size(); ++i) {
+      PerThread& p = *data.getRemote(i);
+      if (p.cur) {
+        delChunk(p.cur);
+      }
+      while (Chunk* c = p.deque.pop()) {
+        delChunk(c);
+      }
+    }
+  }
+
+  void push(const value_type& val) {
+    PerThread& p = *data.getLocal();
+    if (p.cur && p.cur->push_back(val)) {
+      return;
+    }
+    if (p.cur) {
+      p.deque.push(p.cur);
+    }
+    p.cur = mkChunk();
+    p.cur->push_back(val);
+  }
+
+  template <typename Iter>
+  void push(Iter b, Iter e) {
+    while (b != e) {
+      push(*b++);
+    }
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    push(range.local_begin(), range.local_end());
+  }
+
+  galois::optional<value_type> pop() {
+    PerThread& p = *data.getLocal();
+    if (p.cur && !p.cur->empty()) {
+      return p.cur->extract_back();
+    }
+    Chunk* c = p.deque.pop();
+    if (!c) {
+      c = steal(p);
+    }
+    if (!c) {
+      return galois::optional<value_type>();
+    }
+    if (p.cur) {
+      delChunk(p.cur);
+    }
+    p.cur = c;
+    return p.cur->extract_back();
+  }
+};
+GALOIS_WLCOMPILECHECK(ChaseLev)
+
+}  // namespace worklists
+}  // namespace galois
+
+#endif
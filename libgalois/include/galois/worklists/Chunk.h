@@ -21,6 +21,7 @@
 #define GALOIS_LIBGALOIS_GALOIS_WORKLISTS_CHUNK_H_
 
 #include "galois/FixedSizeRing.h"
+#include "galois/Trace.h"
 #include "galois/config.h"
 #include "galois/runtime/Mem.h"
 #include "galois/substrate/PaddedLock.h"
@@ -112,19 +113,28 @@ private:
   Chunk* popChunk() {
     int id = Q.myEffectiveID();
     Chunk* r = popChunkByID(id);
-    if (r)
+    if (r) {
+      if (TraceEnabled())
+        TraceInstant("chunk", "pop chunk");
       return r;
+    }
 
     for (int i = id + 1; i < (int)Q.size(); ++i) {
       r = popChunkByID(i);
-      if (r)
+      if (r) {
+        if (TraceEnabled())
+          TraceInstant("steal", "steal chunk");
         return r;
+      }
     }
 
     for (int i = 0; i < id; ++i) {
       r = popChunkByID(i);
-      if (r)
+      if (r) {
+        if (TraceEnabled())
+          TraceInstant("steal", "steal chunk");
         return r;
+      }
     }
 
     return 0;
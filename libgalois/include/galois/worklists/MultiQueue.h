@@ -0,0 +1,218 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_LIBGALOIS_GALOIS_WORKLISTS_MULTIQUEUE_H_
+#define GALOIS_LIBGALOIS_GALOIS_WORKLISTS_MULTIQUEUE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <boost/utility.hpp>
+
+#include "galois/Threads.h"
+#include "galois/config.h"
+#include "galois/optional.h"
+#include "galois/substrate/CacheLineStorage.h"
+#include "galois/substrate/PerThreadStorage.h"
+#include "galois/substrate/SimpleLock.h"
+#include "galois/substrate/ThreadPool.h"
+#include "galois/worklists/WLCompileCheck.h"
+
+namespace galois {
+namespace worklists {
+
+/**
+ * Relaxed concurrent priority worklist (MultiQueue, Rihani et al., SPAA '15).
+ *
+ * Items live in c * p sequential binary heaps, each behind its own lock,
+ * where p is the number of active threads and c the relaxation. A push goes
+ * to a random heap. A pop samples two random heaps and takes the better of
+ * their tops, so it returns an item that is among the O(c * p) best with
+ * high probability. Unlike OrderedByIntegerMetric, priorities are compared
+ * directly rather than mapped to buckets, so the cost of the worklist does
+ * not depend on how large or sparse the priority space is, as with
+ * delta-stepping on floating point weights.
+ *
+ * A larger relaxation lowers contention on the heap locks at the cost of
+ * more items processed out of order.
+ *
+ * @tparam Comparator strict weak order on items; items that compare less
+ * are popped first
+ */
+template <typename Comparator = std::less<>, typename T = int>
+class MultiQueue : private boost::noncopyable {
+public:
+  template <typename _T>
+  using retype = MultiQueue<Comparator, _T>;
+
+  template <bool _concurrent>
+  using rethread = MultiQueue<Comparator, T>;
+
+  //! Items are not chunked
+  template <int _chunk_size>
+  using with_chunk_size = MultiQueue<Comparator, T>;
+
+  typedef T value_type;
+
+  //! Heaps per thread used when no relaxation is given
+  static constexpr unsigned kDefaultRelaxation = 2;
+
+private:
+  //! Random pairs sampled by pop before it looks at every heap
+  static constexpr unsigned kPopAttempts = 8;
+
+  struct Heap {
+    substrate::SimpleLock lock;
+    std::vector<T> items;
+    //! Copy of items.size() that may be read without the lock
+    std::atomic<size_t> size{0};
+  };
+
+  //! Orders a binary heap so that its front is the least item by Comparator
+  struct HeapOrder {
+    const Comparator* cmp;
+    bool operator()(const T& a, const T& b) const { return (*cmp)(b, a); }
+  };
+
+  Comparator cmp;
+  unsigned num_heaps;
+  std::unique_ptr<substrate::CacheLineStorage<Heap>[]> heaps;
+  substrate::PerThreadStorage<uint64_t> rng_state;
+
+  //! xorshift64*, seeded by thread id
+  unsigned RandomHeap() {
+    uint64_t& x = *rng_state.getLocal();
+    if (!x) {
+      x = 0x9E3779B97F4A7C15ULL * (substrate::ThreadPool::getTID() + 1);
+    }
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    return ((x * 0x2545F4914F6CDD1DULL) >> 32) % num_heaps;
+  }
+
+  Heap& heap(unsigned i) { return heaps[i].data; }
+
+  //! Pops the front of h, whose lock is held and which is not empty
+  T PopLocked(Heap& h) {
+    std::pop_heap(h.items.begin(), h.items.end(), HeapOrder{&cmp});
+    T val = std::move(h.items.back());
+    h.items.pop_back();
+    h.size.store(h.items.size(), std::memory_order_relaxed);
+    return val;
+  }
+
+  galois::optional<value_type> PopAny() {
+    unsigned start = RandomHeap();
+    for (unsigned k = 0; k < num_heaps; ++k) {
+      Heap& h = heap((start + k) % num_heaps);
+      if (!h.size.load(std::memory_order_relaxed)) {
+        continue;
+      }
+      h.lock.lock();
+      if (!h.items.empty()) {
+        T val = PopLocked(h);
+        h.lock.unlock();
+        return val;
+      }
+      h.lock.unlock();
+    }
+    return galois::optional<value_type>();
+  }
+
+public:
+  /**
+   * @param c Comparator of items
+   * @param relaxation Number of heaps per active thread
+   */
+  explicit MultiQueue(
+      const Comparator& c = Comparator(),
+      unsigned relaxation = kDefaultRelaxation)
+      : cmp(c),
+        num_heaps(std::max(2U, relaxation * galois::getActiveThreads())),
+        heaps(std::make_unique<substrate::CacheLineStorage<Heap>[]>(
+            num_heaps)) {}
+
+  void push(const value_type& val) {
+    Heap* h;
+    do {
+      h = &heap(RandomHeap());
+    } while (!h->lock.try_lock());
+    h->items.push_back(val);
+    std::push_heap(h->items.begin(), h->items.end(), HeapOrder{&cmp});
+    h->size.store(h->items.size(), std::memory_order_relaxed);
+    h->lock.unlock();
+  }
+
+  template <typename Iter>
+  void push(Iter b, Iter e) {
+    while (b != e) {
+      push(*b++);
+    }
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    push(range.local_begin(), range.local_end());
+  }
+
+  galois::optional<value_type> pop() {
+    for (unsigned attempt = 0; attempt < kPopAttempts; ++attempt) {
+      Heap* best = &heap(RandomHeap());
+      Heap* other = &heap(RandomHeap());
+      if (!best->size.load(std::memory_order_relaxed)) {
+        std::swap(best, other);
+      }
+      if (!best->size.load(std::memory_order_relaxed) ||
+          !best->lock.try_lock()) {
+        continue;
+      }
+      if (other != best && other->size.load(std::memory_order_relaxed) &&
+          other->lock.try_lock()) {
+        if (!other->items.empty() &&
+            (best->items.empty() ||
+             cmp(other->items.front(), best->items.front()))) {
+          std::swap(best, other);
+        }
+        other->lock.unlock();
+      }
+      if (best->items.empty()) {
+        best->lock.unlock();
+        continue;
+      }
+      T val = PopLocked(*best);
+      best->lock.unlock();
+      return val;
+    }
+
+    // Report empty only when no heap holds an item; otherwise for_each could
+    // terminate with items left in a heap that sampling kept missing
+    return PopAny();
+  }
+};
+GALOIS_WLCOMPILECHECK(MultiQueue)
+
+}  // namespace worklists
+}  // namespace galois
+
+#endif
@@ -20,12 +20,73 @@
 #ifndef GALOIS_LIBGALOIS_GALOIS_WORKLISTS_OWNERCOMPUTES_H_
 #define GALOIS_LIBGALOIS_GALOIS_WORKLISTS_OWNERCOMPUTES_H_
 
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "galois/Threads.h"
 #include "galois/config.h"
+#include "galois/gstl.h"
+#include "galois/substrate/PageAlloc.h"
+#include "galois/substrate/PerThreadStorage.h"
+#include "galois/substrate/ThreadPool.h"
+#include "galois/worklists/Chunk.h"
 #include "galois/worklists/WLCompileCheck.h"
+#include "galois/worklists/WorkListHelpers.h"
 
 namespace galois {
 namespace worklists {
 
+/**
+ * Maps the indices of an array allocated with blocked placement, i.e., by
+ * substrate::largeMallocBlocked as LargeArray::allocateBlocked does, to the
+ * thread that placed them: of the num_threads threads, the i-th faults in
+ * the pages that start in the i-th of equal sections of the allocation, so
+ * their elements are in the memory of that thread's socket.
+ *
+ * Built for the node data of a graph placed that way, e.g., LC_CSR_Graph
+ * with UseNumaAlloc, it is the owner function of OwnerComputes that sends
+ * the work on a node to the socket whose memory holds the node.
+ */
+class BlockedOwner {
+  uint64_t element_size_{1};
+  uint64_t page_size_{1};
+  uint64_t num_pages_{1};
+  uint64_t num_threads_{1};
+
+public:
+  BlockedOwner() = default;
+
+  /// The owners of num_elements elements of element_size bytes, which were
+  /// allocated when num_threads threads were active
+  BlockedOwner(
+      size_t num_elements, size_t element_size,
+      unsigned num_threads = galois::getActiveThreads())
+      : element_size_(element_size),
+        page_size_(substrate::allocSize()),
+        num_threads_(std::max(num_threads, 1U)) {
+    num_pages_ = std::max<uint64_t>(
+        (num_elements * element_size + page_size_ - 1) / page_size_, 1);
+  }
+
+  unsigned operator()(uint64_t index) const {
+    uint64_t page = index * element_size_ / page_size_;
+    return std::min(page * num_threads_ / num_pages_, num_threads_ - 1);
+  }
+};
+
+/**
+ * A worklist that runs each item on the socket of its owner thread, as
+ * given by OwnerFn, e.g., a BlockedOwner of the nodes of the items. The
+ * threads of a socket share a Container, a chunked worklist, of the items
+ * their socket owns. Items for another socket are buffered per thread and
+ * handed to that socket's worklist kBatchSize at a time, so the owners
+ * take them a chunk at a time rather than contending item by item.
+ *
+ * Threads only take work owned by their socket: locality comes before load
+ * balance, so the work should be spread over the sockets about evenly.
+ */
 template <
     typename OwnerFn = DummyIndexer<int>, typename Container = ChunkLIFO<>,
     typename T = int>
@@ -48,28 +109,68 @@ struct OwnerComputes : private boost::noncopyable {
     typedef OwnerComputes<_indexer, Container, T> type;
   };
 
+  //! how many items for another socket a thread buffers before handing
+  //! them off
+  static constexpr size_t kBatchSize = 64;
+
 private:
   typedef typename Container::template retype<T> lWLTy;
 
-  typedef lWLTy cWL;
-  typedef lWLTy pWL;
+  //! the items a thread buffered for other sockets
+  struct Outbox {
+    //! by socket
+    std::vector<gstl::Vector<T>> batches;
+    //! the number of non-empty batches
+    unsigned pending = 0;
+  };
 
   OwnerFn Fn;
-  substrate::PerSocketStorage<cWL> items;
-  substrate::PerSocketStorage<pWL> pushBuffer;
+  substrate::PerSocketStorage<lWLTy> items;
+  substrate::PerThreadStorage<Outbox> outboxes;
+
+  void handOff(unsigned socket, gstl::Vector<T>* batch) {
+    lWLTy& wl = *items.getRemoteByPkg(socket);
+    wl.push(batch->begin(), batch->end());
+    // otherwise the last chunk would stay in this thread's part of wl,
+    // where the threads of socket do not look
+    wl.flush();
+    batch->clear();
+  }
+
+  void handOffAll(Outbox* out) {
+    for (unsigned s = 0; s < out->batches.size(); ++s) {
+      if (!out->batches[s].empty()) {
+        handOff(s, &out->batches[s]);
+      }
+    }
+    out->pending = 0;
+  }
 
 public:
   typedef T value_type;
 
+  explicit OwnerComputes(OwnerFn fn = OwnerFn()) : Fn(std::move(fn)) {}
+
   void push(const value_type& val) {
-    unsigned int index = Fn(val);
     auto& tp = substrate::GetThreadPool();
-    unsigned int mindex = tp.getSocket(index);
-    // std::cerr << "[" << index << "," << index % active << "]\n";
-    if (mindex == substrate::ThreadPool::getSocket())
+    unsigned int socket = tp.getSocket(Fn(val));
+    if (socket == substrate::ThreadPool::getSocket()) {
       items.getLocal()->push(val);
-    else
-      pushBuffer.getRemote(mindex)->push(val);
+      return;
+    }
+    Outbox& out = *outboxes.getLocal();
+    if (out.batches.empty()) {
+      out.batches.resize(tp.getMaxSockets());
+    }
+    gstl::Vector<T>& batch = out.batches[socket];
+    if (batch.empty()) {
+      ++out.pending;
+    }
+    batch.push_back(val);
+    if (batch.size() == kBatchSize) {
+      handOff(socket, &batch);
+      --out.pending;
+    }
   }
 
   template <typename ItTy>
@@ -81,19 +182,27 @@ public:
   template <typename RangeTy>
   void push_initial(const RangeTy& range) {
     push(range.local_begin(), range.local_end());
-    for (unsigned int x = 0; x < pushBuffer.size(); ++x)
-      pushBuffer.getRemote(x)->flush();
+    handOffAll(outboxes.getLocal());
   }
 
   galois::optional<value_type> pop() {
-    cWL& wl = *items.getLocal();
-    galois::optional<value_type> retval = wl.pop();
-    if (retval)
+    galois::optional<value_type> retval = items.getLocal()->pop();
+    Outbox& out = *outboxes.getLocal();
+    if (retval || !out.pending) {
       return retval;
-    pWL& p = *pushBuffer.getLocal();
-    while ((retval = p.pop()))
-      wl.push(*retval);
-    return wl.pop();
+    }
+    // Out of work: hand off the buffered items, but keep one to run here.
+    // This thread then reports work to termination detection after the
+    // handoff, so the loop cannot end before the owners see the items.
+    for (gstl::Vector<T>& batch : out.batches) {
+      if (!batch.empty()) {
+        retval = batch.back();
+        batch.pop_back();
+        break;
+      }
+    }
+    handOffAll(&out);
+    return retval;
   }
 };
 GALOIS_WLCOMPILECHECK(OwnerComputes)
@@ -22,9 +22,13 @@
 
 #include "galois/config.h"
 #include "galois/optional.h"
+#include "galois/worklists/AdaptiveChunk.h"
+#include "galois/worklists/AdaptiveObim.h"
 #include "galois/worklists/BulkSynchronous.h"
+#include "galois/worklists/ChaseLev.h"
 #include "galois/worklists/Chunk.h"
 #include "galois/worklists/LocalQueue.h"
+#include "galois/worklists/MultiQueue.h"
 #include "galois/worklists/Obim.h"
 #include "galois/worklists/OrderedList.h"
 #include "galois/worklists/OwnerComputes.h"
@@ -19,6 +19,9 @@
 
 #include "galois/substrate/Barrier.h"
 
+#include <algorithm>
+#include <chrono>
+
 #include "galois/Logging.h"
 #include "galois/substrate/ThreadPool.h"
 
@@ -35,8 +38,10 @@ galois::substrate::internal::SetBarrier(galois::substrate::Barrier* barrier) {
 
   kBarrier = barrier;
 
+  // GetBarrier reinitializes the barrier for the threads of each loop, which
+  // are only the first one at the start
   if (barrier) {
-    kBarrierThreads = GetThreadPool().getMaxUsableThreads();
+    kBarrierThreads = 1;
     kBarrier->Reinit(kBarrierThreads);
   }
 }
@@ -55,3 +60,79 @@ galois::substrate::GetBarrier(unsigned active_threads) {
 
   return *kBarrier;
 }
+
+namespace {
+
+// CreateFastestBarrier times each barrier over up to kTimedRounds rounds, but
+// no longer than kTimeBudget, so that it stays quick when the threads share
+// cores and a wait takes a time slice
+constexpr unsigned kTimedRounds = 128;
+constexpr auto kTimeBudget = std::chrono::milliseconds(10);
+
+// Returns the time per wait of barrier on threads threads
+std::chrono::nanoseconds
+TimeBarrier(galois::substrate::Barrier& barrier, unsigned threads) {
+  std::chrono::steady_clock::time_point start;
+  std::chrono::steady_clock::duration elapsed{};
+  unsigned rounds = 0;
+  bool stop = false;
+
+  galois::substrate::GetThreadPool().run(threads, [&] {
+    bool master = galois::substrate::ThreadPool::getTID() == 0;
+    while (true) {
+      // Each round waits twice, and only the master writes stop and only
+      // between the rounds, so that all threads read the same stop and
+      // leave after the same round
+      barrier.Wait();
+      bool done = stop;
+      barrier.Wait();
+      if (done) {
+        break;
+      }
+      if (master) {
+        // the first round wakes the threads and is not timed
+        auto now = std::chrono::steady_clock::now();
+        if (rounds == 0) {
+          start = now;
+        }
+        elapsed = now - start;
+        stop = rounds == kTimedRounds || elapsed > kTimeBudget;
+        ++rounds;
+      }
+    }
+  });
+
+  // rounds - 1 rounds of two waits ended within elapsed
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed) /
+         std::max(2 * (rounds - 1), 1U);
+}
+
+}  // namespace
+
+std::unique_ptr<galois::substrate::Barrier>
+galois::substrate::CreateFastestBarrier(unsigned active_threads) {
+  unsigned threads =
+      std::min(active_threads, GetThreadPool().getMaxUsableThreads());
+  threads = std::max(threads, 1U);
+
+  std::unique_ptr<Barrier> candidates[] = {
+      CreateTopoBarrier(threads),
+      CreateMCSBarrier(threads),
+      CreateDisseminationBarrier(threads),
+      CreateCountingBarrier(threads),
+  };
+
+  std::unique_ptr<Barrier> fastest;
+  auto fastest_time = std::chrono::nanoseconds::max();
+  for (auto& barrier : candidates) {
+    auto time = TimeBarrier(*barrier, threads);
+    GALOIS_LOG_DEBUG(
+        "{} with {} threads: {} ns per wait", barrier->name(), threads,
+        time.count());
+    if (time < fastest_time) {
+      fastest_time = time;
+      fastest = std::move(barrier);
+    }
+  }
+  return fastest;
+}
@@ -1,13 +1,20 @@
 #include "galois/BuildGraph.h"
 
+#include <sys/mman.h>
+#include <unistd.h>
+
 #include <algorithm>
+#include <atomic>
+#include <cerrno>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <deque>
 #include <fstream>
 #include <iostream>
 #include <limits>
 #include <map>
+#include <mutex>
 #include <optional>
 #include <random>
 #include <sstream>
@@ -18,6 +25,7 @@
 #include <arrow/api.h>
 #include <arrow/array.h>
 #include <arrow/io/api.h>
+#include <arrow/ipc/api.h>
 #include <boost/algorithm/string.hpp>
 #include <boost/foreach.hpp>
 #include <boost/lexical_cast.hpp>
@@ -25,6 +33,7 @@
 #include <parquet/arrow/writer.h>
 
 #include "galois/ArrowInterchange.h"
+#include "galois/Env.h"
 #include "galois/ErrorCode.h"
 #include "galois/Galois.h"
 #include "galois/Logging.h"
@@ -52,6 +61,133 @@ using galois::PropertyKey;
 using galois::TopologyState;
 using galois::WriterProperties;
 
+/// ChunkSpiller moves completed arrow arrays out of the heap and into an
+/// unlinked temporary file that is mapped into memory. The arrays are used
+/// exactly as before, but their pages are backed by the file rather than by
+/// anonymous memory, so the kernel can write them back and drop them when the
+/// graph being built does not fit in RAM.
+///
+/// Arrays are serialized as IPC messages into large mapped segments and then
+/// read back zero-copy; each array keeps its segment mapped.
+class galois::ChunkSpiller {
+public:
+  static std::shared_ptr<ChunkSpiller> Make(const std::string& dir) {
+    std::string path = dir + "/galois-build-spill-XXXXXX";
+    int fd = mkstemp(path.data());
+    if (fd < 0) {
+      GALOIS_LOG_WARN(
+          "cannot create spill file in {}, building in memory: {}", dir,
+          std::strerror(errno));
+      return nullptr;
+    }
+    // space is reclaimed once the file is closed and unmapped
+    unlink(path.c_str());
+    return std::shared_ptr<ChunkSpiller>(new ChunkSpiller(fd));
+  }
+
+  ChunkSpiller(const ChunkSpiller& no_copy) = delete;
+  ChunkSpiller& operator=(const ChunkSpiller& no_copy) = delete;
+
+  ~ChunkSpiller() { close(fd_); }
+
+  /// Return a copy of array in file-backed memory, or array itself if it could
+  /// not be spilled
+  std::shared_ptr<arrow::Array> Spill(
+      const std::shared_ptr<arrow::Array>& array) {
+    auto batch = arrow::RecordBatch::Make(
+        arrow::schema({arrow::field("chunk", array->type())}), array->length(),
+        {array});
+    auto serialize_result = arrow::ipc::SerializeRecordBatch(
+        *batch, arrow::ipc::IpcWriteOptions::Defaults());
+    if (!serialize_result.ok()) {
+      GALOIS_LOG_WARN(
+          "cannot serialize chunk for spilling: {}",
+          serialize_result.status());
+      return array;
+    }
+    std::shared_ptr<arrow::Buffer> message = serialize_result.ValueOrDie();
+
+    auto [segment, data] = Allocate(message->size());
+    if (!segment) {
+      return array;
+    }
+    std::memcpy(data, message->data(), message->size());
+
+    arrow::io::BufferReader reader(
+        std::make_shared<SegmentBuffer>(segment, data, message->size()));
+    auto read_result = arrow::ipc::ReadRecordBatch(
+        batch->schema(), nullptr, arrow::ipc::IpcReadOptions::Defaults(),
+        &reader);
+    if (!read_result.ok()) {
+      GALOIS_LOG_WARN(
+          "cannot read back spilled chunk: {}", read_result.status());
+      return array;
+    }
+    return read_result.ValueOrDie()->column(0);
+  }
+
+private:
+  static constexpr uint64_t kSegmentSize = UINT64_C(256) << 20;
+  // IPC buffers need at least 8 byte alignment
+  static constexpr uint64_t kAlignment = 64;
+
+  struct Segment {
+    uint8_t* base;
+    uint64_t size;
+
+    ~Segment() { munmap(base, size); }
+  };
+
+  /// A buffer that keeps the segment it points into mapped
+  class SegmentBuffer : public arrow::Buffer {
+  public:
+    SegmentBuffer(std::shared_ptr<Segment> segment, uint8_t* data, int64_t size)
+        : arrow::Buffer(data, size), segment_(std::move(segment)) {}
+
+  private:
+    std::shared_ptr<Segment> segment_;
+  };
+
+  explicit ChunkSpiller(int fd) : fd_(fd) {}
+
+  std::pair<std::shared_ptr<Segment>, uint8_t*> Allocate(uint64_t size) {
+    uint64_t aligned = (size + kAlignment - 1) & ~(kAlignment - 1);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!current_ || used_ + aligned > current_->size) {
+      uint64_t page_size = sysconf(_SC_PAGESIZE);
+      uint64_t segment_size = std::max(kSegmentSize, aligned);
+      segment_size = (segment_size + page_size - 1) / page_size * page_size;
+
+      if (ftruncate(fd_, file_size_ + segment_size) != 0) {
+        GALOIS_LOG_WARN("cannot grow spill file: {}", std::strerror(errno));
+        return {nullptr, nullptr};
+      }
+      void* base = mmap(
+          nullptr, segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_,
+          file_size_);
+      if (base == MAP_FAILED) {
+        GALOIS_LOG_WARN("cannot map spill file: {}", std::strerror(errno));
+        return {nullptr, nullptr};
+      }
+      file_size_ += segment_size;
+      current_ = std::make_shared<Segment>(
+          Segment{static_cast<uint8_t*>(base), segment_size});
+      used_ = 0;
+    }
+
+    uint8_t* data = current_->base + used_;
+    used_ += aligned;
+    return {current_, data};
+  }
+
+  int fd_;
+  std::mutex mutex_;
+  uint64_t file_size_{0};
+  std::shared_ptr<Segment> current_;
+  uint64_t used_{0};
+};
+
 namespace {
 
 /************************************/
@@ -69,6 +205,18 @@ BuildArray(std::shared_ptr<T> builder) {
   return array;
 }
 
+// Build the array for a completed chunk, moving it to file-backed memory if
+// spilling is enabled
+template <typename T>
+std::shared_ptr<arrow::Array>
+FinishChunk(std::shared_ptr<T> builder, WriterProperties* properties) {
+  std::shared_ptr<arrow::Array> array = BuildArray(builder);
+  if (properties->spiller) {
+    return properties->spiller->Spill(array);
+  }
+  return array;
+}
+
 ChunkedArrays
 BuildChunks(std::vector<ArrowArrays>* chunks) {
   ChunkedArrays chunked_arrays;
@@ -178,8 +326,14 @@ GetFalseArray(size_t elts) {
 
 WriterProperties
 GetWriterProperties(size_t chunk_size) {
+  std::shared_ptr<galois::ChunkSpiller> spiller;
+  if (std::string spill_dir;
+      galois::GetEnv("GALOIS_BUILD_SPILL_DIR", &spill_dir)) {
+    spiller = galois::ChunkSpiller::Make(spill_dir);
+  }
   return WriterProperties{
-      GetNullArrays(chunk_size), GetFalseArray(chunk_size), chunk_size};
+      GetNullArrays(chunk_size), GetFalseArray(chunk_size), chunk_size,
+      std::move(spiller)};
 }
 
 /*************************************************************/
@@ -500,7 +654,7 @@ AddNulls(
 
     // if we filled up a chunk, flush it
     if (static_cast<size_t>(builder->length()) == chunk_size) {
-      chunks->emplace_back(BuildArray(builder));
+      chunks->emplace_back(FinishChunk(builder, properties));
     } else {
       // if we did not fill up the array we know it must need no more nulls
       return;
@@ -564,7 +718,7 @@ AddFalses(
 
     // if we filled up a chunk, flush it
     if (static_cast<size_t>(builder->length()) == chunk_size) {
-      chunks->emplace_back(BuildArray(builder));
+      chunks->emplace_back(FinishChunk(builder, properties));
     } else {
       // if we did not fill up the array we know it must need no more falses
       return;
@@ -606,7 +760,7 @@ AddTypedValue(
 
   // if we filled up a chunk, flush it
   if (static_cast<size_t>(builder->length()) == properties->chunk_size) {
-    chunks->emplace_back(BuildArray(builder));
+    chunks->emplace_back(FinishChunk(builder, properties));
   }
 }
 
@@ -635,7 +789,7 @@ AddArray(
   }
   // if we filled up a chunk, flush it
   if (static_cast<size_t>(list_builder->length()) == properties->chunk_size) {
-    chunks->emplace_back(BuildArray(list_builder));
+    chunks->emplace_back(FinishChunk(list_builder, properties));
   }
 }
 
@@ -664,7 +818,7 @@ AddArray(
   }
   // if we filled up a chunk, flush it
   if (static_cast<size_t>(list_builder->length()) == properties->chunk_size) {
-    chunks->emplace_back(BuildArray(list_builder));
+    chunks->emplace_back(FinishChunk(list_builder, properties));
   }
 }
 
@@ -680,7 +834,7 @@ AddValueInternal(
 
   // if we filled up a chunk, flush it
   if (static_cast<size_t>(builder->length()) == properties->chunk_size) {
-    chunks->emplace_back(BuildArray(builder));
+    chunks->emplace_back(FinishChunk(builder, properties));
   }
 }
 
@@ -699,7 +853,7 @@ AddLabelInternal(
 
   // if we filled up a chunk, flush it
   if (static_cast<size_t>(builder->length()) == properties->chunk_size) {
-    chunks->emplace_back(BuildArray(builder));
+    chunks->emplace_back(FinishChunk(builder, properties));
   }
 }
 
@@ -707,17 +861,83 @@ AddLabelInternal(
 /* Functions for handling topology */
 /***********************************/
 
-// Used to build the out_dests component of the CSR representation
-uint64_t
-SetEdgeId(
-    TopologyState* topology_builder, std::vector<uint64_t>* offsets,
-    size_t index) {
-  uint32_t src = topology_builder->sources[index];
-  uint64_t base = src ? topology_builder->out_indices[src - 1] : 0;
-  uint64_t i = base + offsets->at(src)++;
+// Resolve, in parallel, the entries of intermediate whose string IDs name
+// existing nodes and store their indexes in resolved. Returns the entries that
+// do not name a node yet, in the iteration order of intermediate.
+std::vector<std::pair<size_t, std::string>>
+ResolveExistingIDs(
+    const std::unordered_map<std::string, size_t>& node_indexes,
+    const std::unordered_map<size_t, std::string>& intermediate,
+    std::vector<uint32_t>* resolved) {
+  std::vector<std::pair<size_t, const std::string*>> entries;
+  entries.reserve(intermediate.size());
+  for (const auto& [index, str_id] : intermediate) {
+    entries.emplace_back(index, &str_id);
+  }
+
+  // node_indexes is only read here, so concurrent lookups are safe
+  std::vector<uint8_t> found(entries.size(), 0);
+  galois::do_all(
+      galois::iterate(static_cast<size_t>(0), entries.size()),
+      [&](const size_t& i) {
+        auto node_index = node_indexes.find(*entries[i].second);
+        if (node_index != node_indexes.end()) {
+          (*resolved)[entries[i].first] =
+              static_cast<uint32_t>(node_index->second);
+          found[i] = 1;
+        }
+      },
+      galois::no_stats());
 
-  topology_builder->out_dests[i] = topology_builder->destinations[index];
-  return i;
+  std::vector<std::pair<size_t, std::string>> missing;
+  for (size_t i = 0; i < entries.size(); ++i) {
+    if (!found[i]) {
+      missing.emplace_back(entries[i].first, *entries[i].second);
+    }
+  }
+  return missing;
+}
+
+// Used to build the out_dests component of the CSR representation. Returns
+// the mapping from CSR edge index to the index of the edge as it was added.
+//
+// Edges claim slots in their source's edge list in parallel and each edge list
+// is then sorted by insertion index, so the result is the same as placing
+// edges one at a time in the order they were added.
+std::vector<size_t>
+BuildOutDests(TopologyState* topology_builder, size_t num_nodes) {
+  const std::vector<uint64_t>& out_indices = topology_builder->out_indices;
+  const std::vector<uint32_t>& sources = topology_builder->sources;
+
+  std::vector<size_t> edge_mapping(
+      sources.size(), std::numeric_limits<uint64_t>::max());
+  std::vector<std::atomic<uint64_t>> offsets(num_nodes);
+
+  galois::do_all(
+      galois::iterate(static_cast<size_t>(0), sources.size()),
+      [&](const size_t& i) {
+        uint32_t src = sources[i];
+        uint64_t base = src ? out_indices[src - 1] : 0;
+        uint64_t slot =
+            base + offsets[src].fetch_add(1, std::memory_order_relaxed);
+        edge_mapping[slot] = i;
+      },
+      galois::no_stats());
+
+  galois::do_all(
+      galois::iterate(static_cast<size_t>(0), num_nodes),
+      [&](const size_t& n) {
+        uint64_t begin = n ? out_indices[n - 1] : 0;
+        uint64_t end = out_indices[n];
+        std::sort(edge_mapping.begin() + begin, edge_mapping.begin() + end);
+        for (uint64_t e = begin; e < end; ++e) {
+          topology_builder->out_dests[e] =
+              topology_builder->destinations[edge_mapping[e]];
+        }
+      },
+      galois::steal(), galois::no_stats());
+
+  return edge_mapping;
 }
 
 /******************************************************************************/
@@ -734,7 +954,7 @@ EvenOutArray(
   AddNulls(builder, chunks, null_array, properties, total);
 
   if (total % properties->chunk_size != 0) {
-    chunks->emplace_back(BuildArray(builder));
+    chunks->emplace_back(FinishChunk(builder, properties));
   }
 }
 
@@ -746,7 +966,7 @@ EvenOutArray(
   AddFalses(builder, chunks, properties, total);
 
   if (total % properties->chunk_size != 0) {
-    chunks->emplace_back(BuildArray(builder));
+    chunks->emplace_back(FinishChunk(builder, properties));
   }
 }
 
@@ -761,7 +981,7 @@ EvenOutChunkBuilders(
         AddNulls(builders->at(i), &chunks->at(i), properties, total);
 
         if (total % properties->chunk_size != 0) {
-          chunks->at(i).emplace_back(BuildArray(builders->at(i)));
+          chunks->at(i).emplace_back(FinishChunk(builders->at(i), properties));
         }
       });
 }
@@ -777,7 +997,7 @@ EvenOutChunkBuilders(
         AddFalses(builders->at(i), &chunks->at(i), properties, total);
 
         if (total % properties->chunk_size != 0) {
-          chunks->at(i).emplace_back(BuildArray(builders->at(i)));
+          chunks->at(i).emplace_back(FinishChunk(builders->at(i), properties));
         }
       });
 }
@@ -1595,11 +1815,17 @@ galois::PropertyGraphBuilder::AddLabel(const std::string& name) {
 
 // Resolve string node IDs to node indexes, if a node does not exist create an
 // empty node
+//
+// IDs of existing nodes are looked up in parallel; nodes are then created
+// serially for the IDs that remain
 void
 galois::PropertyGraphBuilder::ResolveIntermediateIDs() {
   TopologyState* topology = &topology_builder_;
 
-  for (auto [index, str_id] : topology->destinations_intermediate) {
+  auto missing_dests = ResolveExistingIDs(
+      topology->node_indexes, topology->destinations_intermediate,
+      &topology->destinations);
+  for (const auto& [index, str_id] : missing_dests) {
     auto dest_index = topology->node_indexes.find(str_id);
     uint32_t dest;
     // if node does not exist, create it
@@ -1612,7 +1838,10 @@ galois::PropertyGraphBuilder::ResolveIntermediateIDs() {
     topology->destinations[index] = dest;
   }
 
-  for (auto [index, str_id] : topology->sources_intermediate) {
+  auto missing_srcs = ResolveExistingIDs(
+      topology->node_indexes, topology->sources_intermediate,
+      &topology->sources);
+  for (const auto& [index, str_id] : missing_srcs) {
     auto src_index = topology->node_indexes.find(str_id);
     uint32_t src;
     if (src_index == topology->node_indexes.end()) {
@@ -1622,7 +1851,10 @@ galois::PropertyGraphBuilder::ResolveIntermediateIDs() {
       src = static_cast<uint32_t>(src_index->second);
     }
     topology->sources[index] = src;
-    topology->out_indices[src]++;
+  }
+
+  for (const auto& entry : topology->sources_intermediate) {
+    topology->out_indices[topology->sources[entry.first]]++;
   }
 }
 
@@ -1634,18 +1866,8 @@ galois::PropertyGraphBuilder::BuildFinalEdges(bool verbose) {
       topology_builder_.out_indices.end(),
       topology_builder_.out_indices.begin());
 
-  std::vector<size_t> edge_mapping;
-  edge_mapping.resize(edges_, std::numeric_limits<uint64_t>::max());
-
-  std::vector<uint64_t> offsets;
-  offsets.resize(nodes_, 0);
-
   // get edge indices
-  for (size_t i = 0; i < topology_builder_.sources.size(); i++) {
-    uint64_t edgeId = SetEdgeId(&topology_builder_, &offsets, i);
-    // edge_mapping[i] = edgeId;
-    edge_mapping[edgeId] = i;
-  }
+  std::vector<size_t> edge_mapping = BuildOutDests(&topology_builder_, nodes_);
 
   auto initial_edges = BuildChunks(&edge_properties_.chunks);
   auto initial_types = BuildChunks(&edge_types_.chunks);
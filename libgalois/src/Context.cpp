@@ -64,9 +64,39 @@ galois::runtime::SimpleRuntimeContext::release(
   // iterations
   assert(customAcquire || getOwner(lockable) == this);
   assert(!lockable->next);
+  if (optimisticReads) {
+    lockable->version.fetch_add(1, std::memory_order_release);
+  }
   lockable->owner.unlock_and_clear();
 }
 
+void
+galois::runtime::SimpleRuntimeContext::addToReadSet(
+    galois::runtime::Lockable* lockable) {
+  unsigned version = lockable->version.load(std::memory_order_acquire);
+  // another iteration may be writing it
+  if (lockable->owner.is_locked()) {
+    ++numValidationFailures;
+    signalConflict(lockable);
+  }
+  readSet.emplace_back(lockable, version);
+}
+
+void
+galois::runtime::SimpleRuntimeContext::validateReads() {
+  // order the reads of the objects before the reads of their versions
+  std::atomic_thread_fence(std::memory_order_acquire);
+  for (const auto& [lockable, version] : readSet) {
+    bool locked_by_other =
+        lockable->owner.is_locked() && getOwner(lockable) != this;
+    if (locked_by_other ||
+        lockable->version.load(std::memory_order_acquire) != version) {
+      ++numValidationFailures;
+      signalConflict(lockable);
+    }
+  }
+}
+
 unsigned
 galois::runtime::SimpleRuntimeContext::commitIteration() {
   unsigned numLocks = 0;
@@ -79,6 +109,8 @@ galois::runtime::SimpleRuntimeContext::commitIteration() {
     release(lockable);
     ++numLocks;
   }
+  readSet.clear();
+  lockedAny = false;
 
   return numLocks;
 }
@@ -0,0 +1,373 @@
+#include "galois/graphs/DeltaGraph.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+
+#include <arrow/api.h>
+#include <arrow/compute/api.h>
+
+#include "galois/ErrorCode.h"
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/ParallelSTL.h"
+#include "galois/Reduction.h"
+#include "tsuba/MemoryPool.h"
+
+namespace {
+
+using galois::graphs::DeltaGraph;
+
+/// An edge operation of a batch, in log order within its source
+struct EdgeOp {
+  uint32_t src;
+  uint32_t dst;
+  /// The id of the inserted edge, or kNoBaseEdge for a delete
+  uint64_t inserted;
+};
+
+bool
+ParseNode(const char* begin, char** end, uint32_t* node) {
+  errno = 0;
+  unsigned long long value = std::strtoull(begin, end, 0);
+  if (errno != 0 || *end == begin ||
+      value > std::numeric_limits<uint32_t>::max()) {
+    return false;
+  }
+  *node = static_cast<uint32_t>(value);
+  return true;
+}
+
+bool
+ParseEdgeOpId(const std::string& id, uint32_t* src, uint32_t* dst) {
+  char* end = nullptr;
+  if (!ParseNode(id.c_str(), &end, src) || *end != ':') {
+    return false;
+  }
+  const char* dst_begin = end + 1;
+  return ParseNode(dst_begin, &end, dst) && *end == '\0';
+}
+
+galois::Result<std::shared_ptr<arrow::Array>>
+BuildIndices(
+    const std::vector<uint64_t>& indices, const std::vector<uint8_t>& valid) {
+  arrow::UInt64Builder builder(tsuba::GetArrowMemoryPool());
+  if (auto status =
+          builder.AppendValues(indices.data(), indices.size(), valid.data());
+      !status.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", status);
+    return galois::ErrorCode::ArrowError;
+  }
+  std::shared_ptr<arrow::Array> array;
+  if (auto status = builder.Finish(&array); !status.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", status);
+    return galois::ErrorCode::ArrowError;
+  }
+  return array;
+}
+
+/// TakeRows returns the rows of table in indices, with nulls where an index
+/// is null
+galois::Result<std::shared_ptr<arrow::Table>>
+TakeRows(
+    const std::shared_ptr<arrow::Table>& table,
+    const std::shared_ptr<arrow::Array>& indices) {
+  auto take_result =
+      arrow::compute::Take(arrow::Datum(table), arrow::Datum(indices));
+  if (!take_result.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", take_result.status());
+    return galois::ErrorCode::ArrowError;
+  }
+  auto combine_result = take_result.ValueOrDie().table()->CombineChunks(
+      tsuba::GetArrowMemoryPool());
+  if (!combine_result.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", combine_result.status());
+    return galois::ErrorCode::ArrowError;
+  }
+  return std::move(combine_result.ValueOrDie());
+}
+
+}  // namespace
+
+galois::graphs::DeltaGraph::DeltaGraph(const PropertyFileGraph* base)
+    : base_(base),
+      deleted_nodes_(base->topology().num_nodes()),
+      inserted_(base->topology().num_nodes()),
+      num_edges_(base->topology().num_edges()) {
+  deleted_edges_.resize(base->topology().num_edges());
+}
+
+galois::Result<std::unique_ptr<DeltaGraph>>
+galois::graphs::DeltaGraph::Make(const PropertyFileGraph* base) {
+  return std::unique_ptr<DeltaGraph>(new DeltaGraph(base));
+}
+
+galois::Result<void>
+galois::graphs::DeltaGraph::Apply(const OpLog& log, uint64_t begin) {
+  // Node operations are played in order first, so that edge operations can
+  // be checked against the nodes that exist when they come
+  std::vector<EdgeOp> edge_ops;
+  bool any_deleted = false;
+  for (uint64_t i = begin; i < log.size(); ++i) {
+    Operation op = log.GetOp(i);
+    switch (op.opcode()) {
+    case OpTypes::kOpNodeAdd: {
+      if (num_nodes() >= std::numeric_limits<Node>::max()) {
+        GALOIS_LOG_DEBUG("too many nodes: {}", num_nodes());
+        return ErrorCode::InvalidArgument;
+      }
+      deleted_nodes_.emplace_back(0);
+      inserted_.emplace_back();
+      break;
+    }
+    case OpTypes::kOpNodeDel: {
+      char* end = nullptr;
+      uint32_t node = 0;
+      if (!ParseNode(op.key().id.c_str(), &end, &node) || *end != '\0') {
+        GALOIS_LOG_DEBUG("not a node id: {}", op.key().id);
+        return ErrorCode::InvalidArgument;
+      }
+      if (node >= num_nodes() || IsDeleted(node)) {
+        GALOIS_LOG_DEBUG("ignoring delete of node {}", node);
+        break;
+      }
+      deleted_nodes_[node] = 1;
+      any_deleted = true;
+      break;
+    }
+    case OpTypes::kOpEdgeAdd:
+    case OpTypes::kOpEdgeDel: {
+      uint32_t src = 0;
+      uint32_t dst = 0;
+      if (!ParseEdgeOpId(op.key().id, &src, &dst)) {
+        GALOIS_LOG_DEBUG("not an edge id: {}", op.key().id);
+        return ErrorCode::InvalidArgument;
+      }
+      if (src >= num_nodes() || dst >= num_nodes() || IsDeleted(src) ||
+          IsDeleted(dst)) {
+        GALOIS_LOG_DEBUG("ignoring edge {} -> {}", src, dst);
+        break;
+      }
+      uint64_t inserted = kNoBaseEdge;
+      if (op.opcode() == OpTypes::kOpEdgeAdd) {
+        inserted = base_num_edges() + inserted_dests_.size();
+        inserted_dests_.emplace_back(dst);
+      }
+      edge_ops.emplace_back(EdgeOp{src, dst, inserted});
+      break;
+    }
+    default:
+      break;
+    }
+  }
+
+  // edge_ops is in log order and radix_sort is stable, so the operations on
+  // each source stay in log order
+  galois::ParallelSTL::radix_sort(
+      edge_ops.begin(), edge_ops.end(),
+      [](const EdgeOp& op) { return op.src; });
+  std::vector<uint64_t> group_begins;
+  for (uint64_t i = 0; i < edge_ops.size(); ++i) {
+    if (i == 0 || edge_ops[i].src != edge_ops[i - 1].src) {
+      group_begins.emplace_back(i);
+    }
+  }
+  group_begins.emplace_back(edge_ops.size());
+
+  const GraphTopology& topology = base_->topology();
+  galois::GAccumulator<uint64_t> added;
+  galois::GAccumulator<uint64_t> removed_base;
+  galois::GAccumulator<uint64_t> removed_inserted;
+
+  galois::do_all(
+      galois::iterate(uint64_t{0}, uint64_t{group_begins.size() - 1}),
+      [&](uint64_t g) {
+        uint32_t src = edge_ops[group_begins[g]].src;
+        std::vector<uint64_t>& inserted = inserted_[src];
+        for (uint64_t i = group_begins[g]; i < group_begins[g + 1]; ++i) {
+          const EdgeOp& op = edge_ops[i];
+          if (op.inserted != kNoBaseEdge) {
+            inserted.emplace_back(op.inserted);
+            added += 1;
+            continue;
+          }
+          if (src < topology.num_nodes()) {
+            auto [edge_begin, edge_end] = topology.edge_range(src);
+            for (uint64_t e = edge_begin; e < edge_end; ++e) {
+              if (topology.out_dests->Value(e) == op.dst &&
+                  !deleted_edges_.set(e)) {
+                removed_base += 1;
+              }
+            }
+          }
+          auto last = std::remove_if(
+              inserted.begin(), inserted.end(), [&](uint64_t e) {
+                return inserted_dests_[e - base_num_edges()] == op.dst;
+              });
+          removed_inserted += inserted.end() - last;
+          inserted.erase(last, inserted.end());
+        }
+      },
+      galois::steal(), galois::no_stats(),
+      galois::loopname("DeltaGraphEdgeOps"));
+
+  // Deleted nodes lose their edges, in both directions
+  if (any_deleted) {
+    galois::do_all(
+        galois::iterate(uint64_t{0}, num_nodes()),
+        [&](uint64_t n) {
+          bool node_deleted = IsDeleted(n);
+          if (n < topology.num_nodes()) {
+            auto [edge_begin, edge_end] = topology.edge_range(n);
+            for (uint64_t e = edge_begin; e < edge_end; ++e) {
+              if ((node_deleted || IsDeleted(topology.out_dests->Value(e))) &&
+                  !deleted_edges_.set(e)) {
+                removed_base += 1;
+              }
+            }
+          }
+          std::vector<uint64_t>& inserted = inserted_[n];
+          auto last = std::remove_if(
+              inserted.begin(), inserted.end(), [&](uint64_t e) {
+                return node_deleted ||
+                       IsDeleted(inserted_dests_[e - base_num_edges()]);
+              });
+          removed_inserted += inserted.end() - last;
+          inserted.erase(last, inserted.end());
+        },
+        galois::steal(), galois::no_stats(),
+        galois::loopname("DeltaGraphNodeDels"));
+  }
+
+  num_deleted_base_edges_ += removed_base.reduce();
+  num_edges_ = num_edges_ + added.reduce() - removed_base.reduce() -
+               removed_inserted.reduce();
+  return ResultSuccess();
+}
+
+galois::Result<std::unique_ptr<galois::graphs::PropertyFileGraph>>
+galois::graphs::DeltaGraph::Compact() const {
+  uint64_t num_old_nodes = num_nodes();
+  uint64_t num_base_nodes = base_->topology().num_nodes();
+
+  // new_ids[n] - 1 is the new id of node n if it is live
+  std::vector<uint64_t> new_ids(num_old_nodes);
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_old_nodes),
+      [&](uint64_t n) { new_ids[n] = IsDeleted(n) ? 0 : 1; },
+      galois::no_stats());
+  galois::ParallelSTL::partial_sum(
+      new_ids.begin(), new_ids.end(), new_ids.begin());
+  uint64_t num_new_nodes = num_old_nodes > 0 ? new_ids.back() : 0;
+
+  // The take indices of the node properties: inserted nodes have nulls
+  std::vector<uint64_t> new_to_old(num_new_nodes);
+  std::vector<uint8_t> node_valid(num_new_nodes);
+  std::vector<uint64_t> out_indices(num_new_nodes);
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_old_nodes),
+      [&](uint64_t n) {
+        if (IsDeleted(n)) {
+          return;
+        }
+        uint64_t id = new_ids[n] - 1;
+        new_to_old[id] = n;
+        node_valid[id] = n < num_base_nodes;
+        auto range = edges(n);
+        out_indices[id] = std::distance(range.begin(), range.end());
+      },
+      galois::steal(), galois::no_stats());
+  galois::ParallelSTL::partial_sum(
+      out_indices.begin(), out_indices.end(), out_indices.begin());
+  uint64_t num_new_edges = num_new_nodes > 0 ? out_indices.back() : 0;
+
+  std::vector<uint32_t> dests(num_new_edges);
+  std::vector<uint64_t> base_edges(num_new_edges);
+  std::vector<uint8_t> edge_valid(num_new_edges);
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_new_nodes),
+      [&](uint64_t id) {
+        uint64_t out = id == 0 ? 0 : out_indices[id - 1];
+        for (auto e : edges(new_to_old[id])) {
+          dests[out] = new_ids[*GetEdgeDest(e)] - 1;
+          uint64_t base_id = base_edge(e);
+          base_edges[out] = base_id == kNoBaseEdge ? 0 : base_id;
+          edge_valid[out] = base_id != kNoBaseEdge;
+          ++out;
+        }
+      },
+      galois::steal(), galois::no_stats());
+
+  arrow::UInt64Builder indices_builder(tsuba::GetArrowMemoryPool());
+  arrow::UInt32Builder dests_builder(tsuba::GetArrowMemoryPool());
+  std::shared_ptr<arrow::UInt64Array> indices_array;
+  std::shared_ptr<arrow::UInt32Array> dests_array;
+  if (auto status = indices_builder.AppendValues(out_indices); !status.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", status);
+    return ErrorCode::ArrowError;
+  }
+  if (auto status = indices_builder.Finish(&indices_array); !status.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", status);
+    return ErrorCode::ArrowError;
+  }
+  if (auto status = dests_builder.AppendValues(dests); !status.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", status);
+    return ErrorCode::ArrowError;
+  }
+  if (auto status = dests_builder.Finish(&dests_array); !status.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", status);
+    return ErrorCode::ArrowError;
+  }
+
+  auto compacted = std::make_unique<PropertyFileGraph>();
+  if (auto res = compacted->SetTopology(GraphTopology{
+          .out_indices = indices_array,
+          .out_dests = dests_array,
+      });
+      !res) {
+    return res.error();
+  }
+
+  if (auto res = base_->EnsureNodePropertiesLoaded(base_->NodePropertyNames());
+      !res) {
+    return res.error();
+  }
+  if (auto res = base_->EnsureEdgePropertiesLoaded(base_->EdgePropertyNames());
+      !res) {
+    return res.error();
+  }
+
+  if (base_->node_table()->num_columns() > 0) {
+    auto node_indices = BuildIndices(new_to_old, node_valid);
+    if (!node_indices) {
+      return node_indices.error();
+    }
+    auto node_table = TakeRows(base_->node_table(), node_indices.value());
+    if (!node_table) {
+      return node_table.error();
+    }
+    if (auto res = compacted->AddNodeProperties(node_table.value()); !res) {
+      return res.error();
+    }
+  }
+  if (base_->edge_table()->num_columns() > 0) {
+    auto edge_indices = BuildIndices(base_edges, edge_valid);
+    if (!edge_indices) {
+      return edge_indices.error();
+    }
+    auto edge_table = TakeRows(base_->edge_table(), edge_indices.value());
+    if (!edge_table) {
+      return edge_table.error();
+    }
+    if (auto res = compacted->AddEdgeProperties(edge_table.value()); !res) {
+      return res.error();
+    }
+  }
+
+  return std::unique_ptr<PropertyFileGraph>(std::move(compacted));
+}
+
+std::string
+galois::graphs::EdgeOpId(uint32_t src, uint32_t dst) {
+  return std::to_string(src) + ":" + std::to_string(dst);
+}
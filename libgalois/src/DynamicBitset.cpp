@@ -23,26 +23,195 @@
 
 #include "galois/DynamicBitset.h"
 
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 #include "galois/Galois.h"
 
 GALOIS_EXPORT galois::DynamicBitset galois::EmptyBitset;
 
+namespace {
+
+// The bulk operations assume that no bits change while they run, so they
+// read and write the words of the bitsets as plain words, which lets them
+// use vector instructions
+static_assert(
+    sizeof(galois::CopyableAtomic<uint64_t>) == sizeof(uint64_t),
+    "bitset words must be laid out as plain words");
+
+uint64_t*
+Words(galois::DynamicBitset* bitset) {
+  return reinterpret_cast<uint64_t*>(bitset->get_vec().data());
+}
+
+const uint64_t*
+Words(const galois::DynamicBitset& bitset) {
+  return reinterpret_cast<const uint64_t*>(bitset.get_vec().data());
+}
+
+inline uint64_t
+Popcount(uint64_t n) {
+#ifdef __GNUC__
+  return __builtin_popcountll(n);
+#else
+  n = n - ((n >> 1) & 0x5555555555555555UL);
+  n = (n & 0x3333333333333333UL) + ((n >> 2) & 0x3333333333333333UL);
+  return (((n + (n >> 4)) & 0xF0F0F0F0F0F0F0FUL) * 0x101010101010101UL) >> 56;
+#endif
+}
+
+/// Index of the lowest set bit of n, which must not be 0
+inline unsigned
+LowestBit(uint64_t n) {
+#ifdef __GNUC__
+  return __builtin_ctzll(n);
+#else
+  unsigned bit = 0;
+  while ((n & 1) == 0) {
+    n >>= 1;
+    ++bit;
+  }
+  return bit;
+#endif
+}
+
+struct Or {
+  static uint64_t Apply(uint64_t a, uint64_t b) { return a | b; }
+#if defined(__AVX512F__)
+  static __m512i Apply(__m512i a, __m512i b) { return _mm512_or_si512(a, b); }
+#elif defined(__AVX2__)
+  static __m256i Apply(__m256i a, __m256i b) { return _mm256_or_si256(a, b); }
+#endif
+};
+
+struct And {
+  static uint64_t Apply(uint64_t a, uint64_t b) { return a & b; }
+#if defined(__AVX512F__)
+  static __m512i Apply(__m512i a, __m512i b) { return _mm512_and_si512(a, b); }
+#elif defined(__AVX2__)
+  static __m256i Apply(__m256i a, __m256i b) { return _mm256_and_si256(a, b); }
+#endif
+};
+
+struct AndNot {
+  static uint64_t Apply(uint64_t a, uint64_t b) { return a & ~b; }
+#if defined(__AVX512F__)
+  static __m512i Apply(__m512i a, __m512i b) {
+    return _mm512_andnot_si512(b, a);
+  }
+#elif defined(__AVX2__)
+  static __m256i Apply(__m256i a, __m256i b) {
+    return _mm256_andnot_si256(b, a);
+  }
+#endif
+};
+
+struct Xor {
+  static uint64_t Apply(uint64_t a, uint64_t b) { return a ^ b; }
+#if defined(__AVX512F__)
+  static __m512i Apply(__m512i a, __m512i b) { return _mm512_xor_si512(a, b); }
+#elif defined(__AVX2__)
+  static __m256i Apply(__m256i a, __m256i b) { return _mm256_xor_si256(a, b); }
+#endif
+};
+
+/// dst[i] = Op::Apply(a[i], b[i]) for i < n; dst may be a
+template <typename Op>
+void
+CombineWords(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t n) {
+  size_t i = 0;
+#if defined(__AVX512F__)
+  for (; i + 8 <= n; i += 8) {
+    __m512i va = _mm512_loadu_si512(a + i);
+    __m512i vb = _mm512_loadu_si512(b + i);
+    _mm512_storeu_si512(dst + i, Op::Apply(va, vb));
+  }
+#elif defined(__AVX2__)
+  for (; i + 4 <= n; i += 4) {
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(dst + i), Op::Apply(va, vb));
+  }
+#endif
+  for (; i < n; ++i) {
+    dst[i] = Op::Apply(a[i], b[i]);
+  }
+}
+
+uint64_t
+PopcountWords(const uint64_t* words, size_t n) {
+  uint64_t count = 0;
+  size_t i = 0;
+#if defined(__AVX512VPOPCNTDQ__)
+  __m512i acc = _mm512_setzero_si512();
+  for (; i + 8 <= n; i += 8) {
+    acc = _mm512_add_epi64(
+        acc, _mm512_popcnt_epi64(_mm512_loadu_si512(words + i)));
+  }
+  count = _mm512_reduce_add_epi64(acc);
+#elif defined(__AVX2__)
+  // count the bits of each nibble with a table lookup and sum the bytes
+  // (Mula et al., "Faster Population Counts Using AVX2 Instructions", 2018)
+  const __m256i table = _mm256_setr_epi8(
+      0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3,
+      1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low_nibbles = _mm256_set1_epi8(0x0f);
+  __m256i acc = _mm256_setzero_si256();
+  for (; i + 4 <= n; i += 4) {
+    __m256i v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+    __m256i lo = _mm256_and_si256(v, low_nibbles);
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_nibbles);
+    __m256i bytes = _mm256_add_epi8(
+        _mm256_shuffle_epi8(table, lo), _mm256_shuffle_epi8(table, hi));
+    acc = _mm256_add_epi64(acc, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+  }
+  count = _mm256_extract_epi64(acc, 0) + _mm256_extract_epi64(acc, 1) +
+          _mm256_extract_epi64(acc, 2) + _mm256_extract_epi64(acc, 3);
+#endif
+  for (; i < n; ++i) {
+    count += Popcount(words[i]);
+  }
+  return count;
+}
+
+/// Calls fn(begin, end) on each thread with its block of the n words
+template <typename Fn>
+void
+OnWordBlocks(size_t n, const Fn& fn) {
+  galois::on_each([&](unsigned tid, unsigned nthreads) {
+    auto [begin, end] = galois::block_range(size_t{0}, n, tid, nthreads);
+    fn(begin, end);
+  });
+}
+
+template <typename Op>
+void
+Combine(
+    galois::DynamicBitset* dst, const galois::DynamicBitset& a,
+    const galois::DynamicBitset& b) {
+  uint64_t* d = Words(dst);
+  const uint64_t* wa = Words(a);
+  const uint64_t* wb = Words(b);
+  OnWordBlocks(dst->get_vec().size(), [&](size_t begin, size_t end) {
+    CombineWords<Op>(d + begin, wa + begin, wb + begin, end - begin);
+  });
+}
+
+}  // namespace
+
 void
 galois::DynamicBitset::bitwise_or(const DynamicBitset& other) {
   assert(size() == other.size());
-  const auto& other_bitvec = other.get_vec();
-  galois::do_all(
-      galois::iterate(size_t{0}, bitvec.size()),
-      [&](size_t i) { bitvec[i] |= other_bitvec[i]; }, galois::no_stats());
+  Combine<Or>(this, *this, other);
 }
 
 void
 galois::DynamicBitset::bitwise_and(const DynamicBitset& other) {
   assert(size() == other.size());
-  const auto& other_bitvec = other.get_vec();
-  galois::do_all(
-      galois::iterate(size_t{0}, bitvec.size()),
-      [&](size_t i) { bitvec[i] &= other_bitvec[i]; }, galois::no_stats());
+  Combine<And>(this, *this, other);
 }
 
 void
@@ -50,22 +219,19 @@ galois::DynamicBitset::bitwise_and(
     const DynamicBitset& other1, const DynamicBitset& other2) {
   assert(size() == other1.size());
   assert(size() == other2.size());
-  const auto& other_bitvec1 = other1.get_vec();
-  const auto& other_bitvec2 = other2.get_vec();
+  Combine<And>(this, other1, other2);
+}
 
-  galois::do_all(
-      galois::iterate(size_t{0}, bitvec.size()),
-      [&](size_t i) { bitvec[i] = other_bitvec1[i] & other_bitvec2[i]; },
-      galois::no_stats());
+void
+galois::DynamicBitset::bitwise_andnot(const DynamicBitset& other) {
+  assert(size() == other.size());
+  Combine<AndNot>(this, *this, other);
 }
 
 void
 galois::DynamicBitset::bitwise_xor(const DynamicBitset& other) {
   assert(size() == other.size());
-  const auto& other_bitvec = other.get_vec();
-  galois::do_all(
-      galois::iterate(size_t{0}, bitvec.size()),
-      [&](size_t i) { bitvec[i] ^= other_bitvec[i]; }, galois::no_stats());
+  Combine<Xor>(this, *this, other);
 }
 
 void
@@ -73,31 +239,26 @@ galois::DynamicBitset::bitwise_xor(
     const DynamicBitset& other1, const DynamicBitset& other2) {
   assert(size() == other1.size());
   assert(size() == other2.size());
-  const auto& other_bitvec1 = other1.get_vec();
-  const auto& other_bitvec2 = other2.get_vec();
+  Combine<Xor>(this, other1, other2);
+}
 
-  galois::do_all(
-      galois::iterate(size_t{0}, bitvec.size()),
-      [&](size_t i) { bitvec[i] = other_bitvec1[i] ^ other_bitvec2[i]; },
-      galois::no_stats());
+void
+galois::DynamicBitset::swap_and_clear(DynamicBitset& next) {
+  assert(size() == next.size());
+  bitvec.swap(next.bitvec);
+  uint64_t* words = Words(&next);
+  OnWordBlocks(next.bitvec.size(), [&](size_t begin, size_t end) {
+    std::fill(words + begin, words + end, 0);
+  });
 }
 
 uint64_t
 galois::DynamicBitset::count() const {
+  const uint64_t* words = Words(*this);
   galois::GAccumulator<uint64_t> ret;
-  galois::do_all(
-      galois::iterate(bitvec.begin(), bitvec.end()),
-      [&](uint64_t n) {
-#ifdef __GNUC__
-        ret += __builtin_popcountll(n);
-#else
-        n = n - ((n >> 1) & 0x5555555555555555UL);
-        n = (n & 0x3333333333333333UL) + ((n >> 2) & 0x3333333333333333UL);
-        ret += (((n + (n >> 4)) & 0xF0F0F0F0F0F0F0FUL) * 0x101010101010101UL) >>
-               56;
-#endif
-      },
-      galois::no_stats());
+  OnWordBlocks(bitvec.size(), [&](size_t begin, size_t end) {
+    ret += PopcountWords(words + begin, end - begin);
+  });
   return ret.reduce();
 }
 
@@ -105,23 +266,16 @@ namespace {
 template <typename Integer>
 std::vector<Integer>
 GetOffsets(const galois::DynamicBitset& bitset) {
-  // TODO uint32_t is somewhat dangerous; change in the future
+  const uint64_t* words = Words(bitset);
+  size_t num_words = bitset.get_vec().size();
   uint32_t activeThreads = galois::getActiveThreads();
   std::vector<Integer> tPrefixBitCounts(activeThreads);
 
   // count how many bits are set on each thread
   galois::on_each([&](unsigned tid, unsigned nthreads) {
-    auto [start, end] =
-        galois::block_range(size_t{0}, bitset.size(), tid, nthreads);
-
-    Integer count = 0;
-    for (Integer i = start; i < end; ++i) {
-      if (bitset.test(i)) {
-        ++count;
-      }
-    }
-
-    tPrefixBitCounts[tid] = count;
+    auto [begin, end] =
+        galois::block_range(size_t{0}, num_words, tid, nthreads);
+    tPrefixBitCounts[tid] = PopcountWords(words + begin, end - begin);
   });
 
   // calculate prefix sum of bits per thread
@@ -134,24 +288,17 @@ GetOffsets(const galois::DynamicBitset& bitset) {
   std::vector<Integer> offsets;
 
   // calculate the indices of the set bits and save them to the offset
-  // vector
+  // vector, a word at a time
   if (bitsetCount > 0) {
     offsets.resize(bitsetCount);
     galois::on_each([&](unsigned tid, unsigned nthreads) {
-      auto [start, end] =
-          galois::block_range(size_t{0}, bitset.size(), tid, nthreads);
-      Integer count = 0;
-      Integer tPrefixBitCount;
-      if (tid == 0) {
-        tPrefixBitCount = 0;
-      } else {
-        tPrefixBitCount = tPrefixBitCounts[tid - 1];
-      }
-
-      for (Integer i = start; i < end; ++i) {
-        if (bitset.test(i)) {
-          offsets[tPrefixBitCount + count] = i;
-          ++count;
+      auto [begin, end] =
+          galois::block_range(size_t{0}, num_words, tid, nthreads);
+      Integer pos = tid == 0 ? 0 : tPrefixBitCounts[tid - 1];
+      for (size_t w = begin; w < end; ++w) {
+        for (uint64_t word = words[w]; word != 0; word &= word - 1) {
+          offsets[pos++] = w * galois::DynamicBitset::bits_uint64 +
+                           LowestBit(word);
         }
       }
     });
@@ -0,0 +1,182 @@
+#include "galois/graphs/EdgeGrid.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <future>
+
+#include <fmt/format.h>
+
+#include "galois/ErrorCode.h"
+#include "galois/Logging.h"
+#include "tsuba/file.h"
+
+namespace {
+
+using galois::graphs::EdgeGrid;
+
+constexpr char kGridFileName[] = "edge_grid";
+constexpr uint64_t kGridMagic = UINT64_C(0x4449524745474b);
+constexpr uint64_t kGridVersion = 1;
+/// magic, version, nodes, edges, intervals
+constexpr uint64_t kHeaderWords = 5;
+
+std::string
+BlockName(uint32_t i, uint32_t j) {
+  return fmt::format("edge_block_{:05}_{:05}", i, j);
+}
+
+uint64_t
+IntervalSize(uint64_t num_nodes, uint32_t num_intervals) {
+  return std::max<uint64_t>(
+      (num_nodes + num_intervals - 1) / num_intervals, 1);
+}
+
+}  // namespace
+
+galois::Result<void>
+galois::graphs::EdgeGrid::Write(
+    const GraphTopology& topology, uint32_t num_intervals,
+    const galois::Uri& dir) {
+  if (num_intervals == 0) {
+    GALOIS_LOG_DEBUG("a grid needs at least one interval");
+    return ErrorCode::InvalidArgument;
+  }
+  EdgeGrid grid;
+  grid.num_nodes_ = topology.num_nodes();
+  grid.num_edges_ = topology.num_edges();
+  grid.num_intervals_ = num_intervals;
+  grid.interval_size_ = IntervalSize(grid.num_nodes_, num_intervals);
+  grid.block_sizes_.resize(
+      static_cast<uint64_t>(num_intervals) * num_intervals);
+
+  // The blocks of one source interval are built and stored by one task
+  std::vector<Result<void>> results(num_intervals, ResultSuccess());
+  galois::do_all(
+      galois::iterate(uint32_t{0}, num_intervals),
+      [&](uint32_t i) {
+        std::vector<std::vector<Edge>> blocks(num_intervals);
+        for (uint64_t n = grid.interval_begin(i);
+             n < grid.interval_begin(i + 1); ++n) {
+          auto [begin, end] = topology.edge_range(n);
+          for (uint64_t e = begin; e < end; ++e) {
+            uint32_t dst = topology.out_dests->Value(e);
+            blocks[grid.interval(dst)].emplace_back(
+                Edge{static_cast<uint32_t>(n), dst});
+          }
+        }
+        for (uint32_t j = 0; j < num_intervals; ++j) {
+          const std::vector<Edge>& block = blocks[j];
+          grid.block_sizes_[static_cast<uint64_t>(i) * num_intervals + j] =
+              block.size();
+          if (block.empty()) {
+            continue;
+          }
+          if (auto res = tsuba::FileStore(
+                  dir.Join(BlockName(i, j)).string(),
+                  reinterpret_cast<const uint8_t*>(block.data()),
+                  block.size() * sizeof(Edge));
+              !res) {
+            results[i] = res.error();
+            return;
+          }
+        }
+      },
+      galois::steal(), galois::no_stats(),
+      galois::loopname("EdgeGridWrite"));
+  for (const Result<void>& res : results) {
+    if (!res) {
+      return res.error();
+    }
+  }
+
+  std::vector<uint64_t> header{
+      kGridMagic, kGridVersion, grid.num_nodes_, grid.num_edges_,
+      grid.num_intervals_};
+  header.insert(
+      header.end(), grid.block_sizes_.begin(), grid.block_sizes_.end());
+  return tsuba::FileStore(
+      dir.Join(kGridFileName).string(),
+      reinterpret_cast<const uint8_t*>(header.data()),
+      header.size() * sizeof(uint64_t));
+}
+
+galois::Result<EdgeGrid>
+galois::graphs::EdgeGrid::Open(const galois::Uri& dir) {
+  std::string name = dir.Join(kGridFileName).string();
+  tsuba::StatBuf stat;
+  if (auto res = tsuba::FileStat(name, &stat); !res) {
+    return res.error();
+  }
+  if (stat.size < kHeaderWords * sizeof(uint64_t) ||
+      stat.size % sizeof(uint64_t) != 0) {
+    GALOIS_LOG_DEBUG("{} is not an edge grid", name);
+    return ErrorCode::InvalidArgument;
+  }
+  std::vector<uint64_t> header(stat.size / sizeof(uint64_t));
+  if (auto res = tsuba::FileGet(
+          name, reinterpret_cast<uint8_t*>(header.data()), 0, stat.size);
+      !res) {
+    return res.error();
+  }
+  uint64_t num_intervals = header[4];
+  if (header[0] != kGridMagic || header[1] != kGridVersion ||
+      num_intervals == 0 || num_intervals > UINT32_MAX ||
+      header.size() != kHeaderWords + num_intervals * num_intervals) {
+    GALOIS_LOG_DEBUG("{} is not an edge grid", name);
+    return ErrorCode::InvalidArgument;
+  }
+
+  EdgeGrid grid;
+  grid.dir_ = dir;
+  grid.num_nodes_ = header[2];
+  grid.num_edges_ = header[3];
+  grid.num_intervals_ = num_intervals;
+  grid.interval_size_ = IntervalSize(grid.num_nodes_, num_intervals);
+  grid.block_sizes_.assign(header.begin() + kHeaderWords, header.end());
+  return grid;
+}
+
+galois::Result<void>
+galois::graphs::EdgeGrid::StreamBlocks(
+    const BlockFn& fn, const std::vector<uint8_t>& active_intervals) const {
+  std::vector<std::pair<uint32_t, uint32_t>> blocks;
+  for (uint32_t j = 0; j < num_intervals_; ++j) {
+    for (uint32_t i = 0; i < num_intervals_; ++i) {
+      if (block_size(i, j) > 0 &&
+          (active_intervals.empty() || active_intervals[i] != 0)) {
+        blocks.emplace_back(i, j);
+      }
+    }
+  }
+  if (blocks.empty()) {
+    return ResultSuccess();
+  }
+
+  // Two buffers: one for the block being processed and one for the block
+  // being read
+  std::array<std::vector<Edge>, 2> buffers;
+  auto fetch = [&](size_t k) {
+    auto [i, j] = blocks[k];
+    std::vector<Edge>& buffer = buffers[k % 2];
+    buffer.resize(block_size(i, j));
+    return tsuba::FileGetAsync(
+        dir_.Join(BlockName(i, j)).string(),
+        reinterpret_cast<uint8_t*>(buffer.data()), 0,
+        buffer.size() * sizeof(Edge));
+  };
+
+  std::future<Result<void>> pending = fetch(0);
+  for (size_t k = 0; k < blocks.size(); ++k) {
+    if (auto res = pending.get(); !res) {
+      return res.error();
+    }
+    if (k + 1 < blocks.size()) {
+      pending = fetch(k + 1);
+    }
+    auto [i, j] = blocks[k];
+    const std::vector<Edge>& buffer = buffers[k % 2];
+    fn(i, j, buffer.data(), buffer.size());
+  }
+  return ResultSuccess();
+}
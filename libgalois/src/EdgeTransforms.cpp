@@ -0,0 +1,226 @@
+#include "galois/graphs/EdgeTransforms.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "galois/ErrorCode.h"
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/ParallelSTL.h"
+#include "galois/Permutation.h"
+#include "tsuba/MemoryPool.h"
+
+namespace {
+
+using galois::graphs::EdgeFilter;
+using galois::graphs::GraphTopology;
+using galois::graphs::PropertyFileGraph;
+
+/// An edge of the graph being made: its destination and a key that orders the
+/// edges of a node with the same destination, the index of the edge of the
+/// parent graph it comes from times two, plus one if it is the reverse
+struct Candidate {
+  uint32_t dest;
+  uint64_t key;
+
+  bool operator<(const Candidate& other) const {
+    return dest != other.dest ? dest < other.dest : key < other.key;
+  }
+};
+
+galois::Result<std::shared_ptr<arrow::Buffer>>
+Allocate(uint64_t size) {
+  auto alloc_result = arrow::AllocateBuffer(size, tsuba::GetArrowMemoryPool());
+  if (!alloc_result.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", alloc_result.status());
+    return galois::ErrorCode::ArrowError;
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(alloc_result.ValueOrDie()));
+}
+
+/// TransformEdges makes the graph of the edges of pfg (forward), their
+/// reverses (reverse) or both that filter keeps
+galois::Result<std::unique_ptr<PropertyFileGraph>>
+TransformEdges(
+    const PropertyFileGraph& pfg, bool forward, bool reverse,
+    const EdgeFilter& filter) {
+  const GraphTopology& topology = pfg.topology();
+  uint64_t num_nodes = topology.num_nodes();
+  uint64_t num_edges = topology.num_edges();
+  const uint32_t* dests = topology.out_dests->raw_values();
+
+  // the number of candidate edges of each node, then the end of them
+  std::vector<uint64_t> ends(num_nodes);
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        auto [begin, end] = topology.edge_range(n);
+        ends[n] = forward ? end - begin : 0;
+      },
+      galois::no_stats());
+  if (reverse) {
+    galois::do_all(
+        galois::iterate(uint64_t{0}, num_edges),
+        [&](uint64_t e) { __sync_fetch_and_add(&ends[dests[e]], 1); },
+        galois::no_stats());
+  }
+  galois::ParallelSTL::partial_sum(ends.begin(), ends.end(), ends.begin());
+  uint64_t num_candidates = num_nodes > 0 ? ends.back() : 0;
+
+  std::vector<Candidate> candidates(num_candidates);
+  std::vector<uint64_t> cursors(num_nodes);
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t out = n == 0 ? 0 : ends[n - 1];
+        if (forward) {
+          auto [e, e_end] = topology.edge_range(n);
+          for (; e != e_end; ++e) {
+            candidates[out++] = Candidate{dests[e], 2 * e};
+          }
+        }
+        cursors[n] = out;
+      },
+      galois::no_stats(), galois::steal(),
+      galois::loopname("TransformEdgesForward"));
+  if (reverse) {
+    galois::do_all(
+        galois::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          auto [e, e_end] = topology.edge_range(n);
+          for (; e != e_end; ++e) {
+            uint64_t out = __sync_fetch_and_add(&cursors[dests[e]], 1);
+            candidates[out] = Candidate{static_cast<uint32_t>(n), 2 * e + 1};
+          }
+        },
+        galois::no_stats(), galois::steal(),
+        galois::loopname("TransformEdgesReverse"));
+  }
+
+  auto indices_result = Allocate(num_nodes * sizeof(uint64_t));
+  if (!indices_result) {
+    return indices_result.error();
+  }
+  std::shared_ptr<arrow::Buffer> indices_buffer = indices_result.value();
+  auto* indices = reinterpret_cast<uint64_t*>(indices_buffer->mutable_data());
+
+  // sort the candidates of each node and compact the ones filter keeps to
+  // the front of them
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        Candidate* begin = candidates.data() + (n == 0 ? 0 : ends[n - 1]);
+        Candidate* end = candidates.data() + ends[n];
+        std::sort(begin, end);
+        Candidate* out = begin;
+        for (Candidate* c = begin; c != end; ++c) {
+          if (filter.remove_self_loops && c->dest == n) {
+            continue;
+          }
+          if (filter.remove_duplicates && out != begin &&
+              (out - 1)->dest == c->dest) {
+            continue;
+          }
+          *out++ = *c;
+        }
+        indices[n] = out - begin;
+      },
+      galois::no_stats(), galois::steal(),
+      galois::loopname("TransformEdgesSort"));
+  galois::ParallelSTL::partial_sum(indices, indices + num_nodes, indices);
+  uint64_t new_num_edges = num_nodes > 0 ? indices[num_nodes - 1] : 0;
+
+  auto dests_result = Allocate(new_num_edges * sizeof(uint32_t));
+  if (!dests_result) {
+    return dests_result.error();
+  }
+  std::shared_ptr<arrow::Buffer> dests_buffer = dests_result.value();
+  auto* new_dests = reinterpret_cast<uint32_t*>(dests_buffer->mutable_data());
+  auto parents_result = Allocate(new_num_edges * sizeof(uint64_t));
+  if (!parents_result) {
+    return parents_result.error();
+  }
+  std::shared_ptr<arrow::Buffer> parents_buffer = parents_result.value();
+  auto* parents = reinterpret_cast<uint64_t*>(parents_buffer->mutable_data());
+
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        const Candidate* in = candidates.data() + (n == 0 ? 0 : ends[n - 1]);
+        uint64_t begin = n == 0 ? 0 : indices[n - 1];
+        for (uint64_t e = begin; e < indices[n]; ++e, ++in) {
+          new_dests[e] = in->dest;
+          parents[e] = in->key / 2;
+        }
+      },
+      galois::no_stats(), galois::steal(),
+      galois::loopname("TransformEdgesPlace"));
+  candidates = std::vector<Candidate>();
+
+  auto graph = std::make_unique<PropertyFileGraph>();
+  if (auto res = graph->SetTopology(GraphTopology{
+          .out_indices =
+              std::make_shared<arrow::UInt64Array>(num_nodes, indices_buffer),
+          .out_dests =
+              std::make_shared<arrow::UInt32Array>(new_num_edges, dests_buffer),
+          .edges_sorted_by_dest = true,
+      });
+      !res) {
+    return res.error();
+  }
+
+  if (auto res = pfg.EnsureNodePropertiesLoaded(pfg.NodePropertyNames());
+      !res) {
+    return res.error();
+  }
+  if (auto res = pfg.EnsureEdgePropertiesLoaded(pfg.EdgePropertyNames());
+      !res) {
+    return res.error();
+  }
+
+  // the nodes are the same, so the node properties are shared
+  if (pfg.node_table()->num_columns() > 0) {
+    if (auto res = graph->AddNodeProperties(pfg.node_table()); !res) {
+      return res.error();
+    }
+  }
+
+  const std::shared_ptr<arrow::Table>& edge_table = pfg.edge_table();
+  if (edge_table->num_columns() > 0) {
+    galois::BlockedPermutation plan(parents, new_num_edges);
+    auto gather_result = galois::graphs::GatherRows(
+        edge_table, plan,
+        std::make_shared<arrow::UInt64Array>(new_num_edges, parents_buffer));
+    if (!gather_result) {
+      return gather_result.error();
+    }
+    if (auto res = graph->AddEdgeProperties(gather_result.value()); !res) {
+      return res.error();
+    }
+  }
+
+  graph->MarkAllPropertiesPersistent();
+  return std::unique_ptr<PropertyFileGraph>(std::move(graph));
+}
+
+}  // namespace
+
+galois::Result<std::unique_ptr<galois::graphs::PropertyFileGraph>>
+galois::graphs::Transpose(
+    const PropertyFileGraph& pfg, const EdgeFilter& filter) {
+  return TransformEdges(pfg, false, true, filter);
+}
+
+galois::Result<std::unique_ptr<galois::graphs::PropertyFileGraph>>
+galois::graphs::Symmetrize(
+    const PropertyFileGraph& pfg, const EdgeFilter& filter) {
+  return TransformEdges(pfg, true, true, filter);
+}
+
+galois::Result<std::unique_ptr<galois::graphs::PropertyFileGraph>>
+galois::graphs::SimplifyEdges(
+    const PropertyFileGraph& pfg, const EdgeFilter& filter) {
+  return TransformEdges(pfg, true, false, filter);
+}
@@ -0,0 +1,311 @@
+#include "galois/graphs/EdgeTypeIndex.h"
+
+#include <algorithm>
+
+#include <arrow/api.h>
+
+#include "galois/ErrorCode.h"
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/substrate/PerThreadStorage.h"
+#include "tsuba/Errors.h"
+#include "tsuba/MemoryPool.h"
+
+namespace {
+
+constexpr uint64_t kEdgeTypeIndexVersion = 1;
+
+galois::Result<std::shared_ptr<arrow::BooleanArray>>
+GetTypeArray(
+    const galois::graphs::PropertyFileGraph& pfg, const std::string& name) {
+  if (auto res = pfg.EnsureEdgePropertiesLoaded({name}); !res) {
+    return res.error();
+  }
+  std::shared_ptr<arrow::ChunkedArray> property = pfg.EdgeProperty(name);
+  if (!property) {
+    return galois::ErrorCode::PropertyNotFound;
+  }
+  if (property->type()->id() != arrow::Type::BOOL) {
+    return galois::ErrorCode::TypeError;
+  }
+  if (property->num_chunks() == 1) {
+    return std::static_pointer_cast<arrow::BooleanArray>(property->chunk(0));
+  }
+  auto concat_result =
+      arrow::Concatenate(property->chunks(), tsuba::GetArrowMemoryPool());
+  if (!concat_result.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", concat_result.status());
+    return galois::ErrorCode::ArrowError;
+  }
+  return std::static_pointer_cast<arrow::BooleanArray>(
+      concat_result.ValueOrDie());
+}
+
+galois::Result<std::shared_ptr<arrow::Buffer>>
+Allocate(uint64_t size) {
+  auto alloc_result = arrow::AllocateBuffer(size, tsuba::GetArrowMemoryPool());
+  if (!alloc_result.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", alloc_result.status());
+    return galois::ErrorCode::ArrowError;
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(alloc_result.ValueOrDie()));
+}
+
+/// The size of the zero-terminated names, padded to whole words
+uint64_t
+GetNamesSize(const std::vector<std::string>& names) {
+  uint64_t size = 0;
+  for (const std::string& name : names) {
+    size += name.size() + 1;
+  }
+  return (size + 7) / 8 * 8;
+}
+
+/// The size of a stored edge type index in bytes
+uint64_t
+GetIndexSize(uint64_t names_size, uint64_t num_offsets, uint64_t num_edges) {
+  uint64_t dests_words = (num_edges * sizeof(uint32_t) + 7) / 8;
+  return 5 * sizeof(uint64_t) + names_size +
+         (num_offsets + num_edges + dests_words) * sizeof(uint64_t);
+}
+
+galois::Result<void>
+WriteBytes(tsuba::FileFrame* ff, const void* data, uint64_t size) {
+  if (size == 0) {
+    return galois::ResultSuccess();
+  }
+  arrow::Status aro_sts = ff->Write(data, size);
+  if (!aro_sts.ok()) {
+    return tsuba::ArrowToTsuba(aro_sts.code());
+  }
+  return galois::ResultSuccess();
+}
+
+}  // namespace
+
+galois::Result<void>
+galois::graphs::EdgeTypeIndex::LoadTypeArrays(const PropertyFileGraph& pfg) {
+  for (const std::string& name : types_) {
+    auto array_result = GetTypeArray(pfg, name);
+    if (!array_result) {
+      return array_result.error();
+    }
+    type_arrays_.emplace_back(std::move(array_result.value()));
+  }
+  return galois::ResultSuccess();
+}
+
+galois::Result<std::unique_ptr<galois::graphs::EdgeTypeIndex>>
+galois::graphs::EdgeTypeIndex::Make(
+    const PropertyFileGraph& pfg, const std::vector<std::string>& types) {
+  std::unique_ptr<EdgeTypeIndex> index(new EdgeTypeIndex());
+  index->types_ = types;
+  if (auto res = index->LoadTypeArrays(pfg); !res) {
+    return res.error();
+  }
+
+  const GraphTopology& topology = pfg.topology();
+  uint64_t num_nodes = topology.num_nodes();
+  uint64_t num_edges = topology.num_edges();
+  size_t num_groups = index->num_groups();
+  size_t mixed_group = types.size();
+  size_t untyped_group = types.size() + 1;
+  uint64_t num_offsets = num_nodes * num_groups + 1;
+
+  auto offsets_result = Allocate(num_offsets * sizeof(uint64_t));
+  if (!offsets_result) {
+    return offsets_result.error();
+  }
+  auto ids_result = Allocate(num_edges * sizeof(uint64_t));
+  if (!ids_result) {
+    return ids_result.error();
+  }
+  auto dests_result = Allocate(num_edges * sizeof(uint32_t));
+  if (!dests_result) {
+    return dests_result.error();
+  }
+  auto* offsets =
+      reinterpret_cast<uint64_t*>(offsets_result.value()->mutable_data());
+  auto* edge_ids =
+      reinterpret_cast<uint64_t*>(ids_result.value()->mutable_data());
+  auto* dests =
+      reinterpret_cast<uint32_t*>(dests_result.value()->mutable_data());
+  offsets[num_nodes * num_groups] = num_edges;
+
+  // the group of each edge of a node, kept to place the edges once counted
+  galois::substrate::PerThreadStorage<std::vector<size_t>> edge_groups;
+  galois::substrate::PerThreadStorage<std::vector<uint64_t>> cursors;
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        auto [begin, end] = topology.edge_range(n);
+        std::vector<size_t>& groups = *edge_groups.getLocal();
+        std::vector<uint64_t>& cursor = *cursors.getLocal();
+        groups.resize(end - begin);
+        cursor.assign(num_groups, 0);
+
+        for (uint64_t e = begin; e < end; ++e) {
+          size_t group = untyped_group;
+          for (size_t t = 0; t < types.size(); ++t) {
+            if (index->HasType(e, t)) {
+              group = group == untyped_group ? t : mixed_group;
+            }
+          }
+          groups[e - begin] = group;
+          ++cursor[group];
+        }
+
+        uint64_t* node_offsets = &offsets[n * num_groups];
+        uint64_t position = begin;
+        for (size_t g = 0; g < num_groups; ++g) {
+          node_offsets[g] = position;
+          position += cursor[g];
+          cursor[g] = node_offsets[g];
+        }
+        for (uint64_t e = begin; e < end; ++e) {
+          uint64_t p = cursor[groups[e - begin]]++;
+          edge_ids[p] = e;
+          dests[p] = topology.out_dests->Value(e);
+        }
+      },
+      galois::steal(), galois::no_stats(),
+      galois::loopname("EdgeTypeIndex"));
+
+  index->offsets_ =
+      std::make_shared<arrow::UInt64Array>(num_offsets, offsets_result.value());
+  index->edge_ids_ =
+      std::make_shared<arrow::UInt64Array>(num_edges, ids_result.value());
+  index->dests_ =
+      std::make_shared<arrow::UInt32Array>(num_edges, dests_result.value());
+  return std::unique_ptr<EdgeTypeIndex>(std::move(index));
+}
+
+/// Format of an edge type index file:
+///
+///   uint64_t version: 1
+///   uint64_t num_types: number of types
+///   uint64_t num_nodes: number of nodes
+///   uint64_t num_edges: number of edges
+///   uint64_t names_size: size of names
+///   char[names_size] names: each type name followed by a zero byte, then
+///     zeros up to a whole word
+///   uint64_t[num_nodes * (num_types + 2) + 1] offsets: start of each group
+///   uint64_t[num_edges] edge_ids: edge id of each position
+///   uint32_t[num_edges] dests: destination of each position
+///   uint32_t padding if num_edges is odd
+galois::Result<std::unique_ptr<galois::graphs::EdgeTypeIndex>>
+galois::graphs::EdgeTypeIndex::Map(
+    const PropertyFileGraph& pfg, const tsuba::FileView& file_view) {
+  if (file_view.size() < 5 * sizeof(uint64_t)) {
+    return ErrorCode::InvalidArgument;
+  }
+  const auto* header = file_view.ptr<uint64_t>();
+  uint64_t num_types = header[1];
+  uint64_t num_nodes = header[2];
+  uint64_t num_edges = header[3];
+  uint64_t names_size = header[4];
+  if (header[0] != kEdgeTypeIndexVersion || names_size % 8 != 0 ||
+      num_nodes != pfg.topology().num_nodes() ||
+      num_edges != pfg.topology().num_edges()) {
+    GALOIS_LOG_DEBUG("stored edge type index does not match the topology");
+    return ErrorCode::InvalidArgument;
+  }
+  uint64_t num_offsets = num_nodes * (num_types + 2) + 1;
+  if (file_view.size() < GetIndexSize(names_size, num_offsets, num_edges)) {
+    GALOIS_LOG_DEBUG("stored edge type index is truncated");
+    return ErrorCode::InvalidArgument;
+  }
+
+  std::unique_ptr<EdgeTypeIndex> index(new EdgeTypeIndex());
+  const char* names = reinterpret_cast<const char*>(&header[5]);
+  const char* names_end = names + names_size;
+  for (uint64_t t = 0; t < num_types; ++t) {
+    const char* name_end = std::find(names, names_end, '\0');
+    if (name_end == names_end) {
+      return ErrorCode::InvalidArgument;
+    }
+    index->types_.emplace_back(names, name_end);
+    names = name_end + 1;
+  }
+  if (auto res = index->LoadTypeArrays(pfg); !res) {
+    return res.error();
+  }
+
+  auto* offsets = const_cast<uint64_t*>(&header[5] + names_size / 8);
+  auto* edge_ids = offsets + num_offsets;
+  auto* dests = reinterpret_cast<uint32_t*>(edge_ids + num_edges);
+  index->offsets_ = std::make_shared<arrow::UInt64Array>(
+      num_offsets, std::make_shared<arrow::MutableBuffer>(
+                       reinterpret_cast<uint8_t*>(offsets),
+                       num_offsets * sizeof(uint64_t)));
+  index->edge_ids_ = std::make_shared<arrow::UInt64Array>(
+      num_edges, std::make_shared<arrow::MutableBuffer>(
+                     reinterpret_cast<uint8_t*>(edge_ids),
+                     num_edges * sizeof(uint64_t)));
+  index->dests_ = std::make_shared<arrow::UInt32Array>(
+      num_edges, std::make_shared<arrow::MutableBuffer>(
+                     reinterpret_cast<uint8_t*>(dests),
+                     num_edges * sizeof(uint32_t)));
+  return std::unique_ptr<EdgeTypeIndex>(std::move(index));
+}
+
+galois::Result<std::unique_ptr<tsuba::FileFrame>>
+galois::graphs::EdgeTypeIndex::Write() const {
+  auto ff = std::make_unique<tsuba::FileFrame>();
+  if (auto res = ff->Init(); !res) {
+    return res.error();
+  }
+  uint64_t num_edges = edge_ids_->length();
+  std::vector<char> names(GetNamesSize(types_));
+  auto names_it = names.begin();
+  for (const std::string& name : types_) {
+    names_it = std::copy(name.begin(), name.end(), names_it) + 1;
+  }
+
+  uint64_t header[5] = {
+      kEdgeTypeIndexVersion, types_.size(),
+      (offsets_->length() - 1) / num_groups(), num_edges, names.size()};
+  uint32_t padding = 0;
+  if (auto res = WriteBytes(ff.get(), header, sizeof(header)); !res) {
+    return res.error();
+  }
+  if (auto res = WriteBytes(ff.get(), names.data(), names.size()); !res) {
+    return res.error();
+  }
+  if (auto res = WriteBytes(
+          ff.get(), offsets_->raw_values(),
+          offsets_->length() * sizeof(uint64_t));
+      !res) {
+    return res.error();
+  }
+  if (auto res = WriteBytes(
+          ff.get(), edge_ids_->raw_values(), num_edges * sizeof(uint64_t));
+      !res) {
+    return res.error();
+  }
+  if (auto res = WriteBytes(
+          ff.get(), dests_->raw_values(), num_edges * sizeof(uint32_t));
+      !res) {
+    return res.error();
+  }
+  if (auto res =
+          WriteBytes(ff.get(), &padding, num_edges % 2 * sizeof(padding));
+      !res) {
+    return res.error();
+  }
+  return std::unique_ptr<tsuba::FileFrame>(std::move(ff));
+}
+
+int
+galois::graphs::EdgeTypeIndex::TypeIndex(const std::string& name) const {
+  auto it = std::find(types_.begin(), types_.end(), name);
+  return it == types_.end() ? -1 : static_cast<int>(it - types_.begin());
+}
+
+bool
+galois::graphs::EdgeTypeIndex::HasTypes(
+    const std::vector<std::string>& names) const {
+  return std::all_of(names.begin(), names.end(), [&](const std::string& name) {
+    return TypeIndex(name) >= 0;
+  });
+}
@@ -0,0 +1,39 @@
+#include "galois/substrate/EpochManager.h"
+
+#include "galois/substrate/ThreadPool.h"
+
+using galois::substrate::EpochManager;
+
+EpochManager::EpochManager(unsigned num_threads)
+    : slots_(std::make_unique<Slot[]>(num_threads)), num_slots_(num_threads) {}
+
+void
+EpochManager::Online(unsigned tid) {
+  Slot& slot = slots_[tid];
+  // A thread that comes online quiesced in the current epoch: it holds no
+  // references yet, and any it takes are to memory that is still linked
+  slot.seen.store(epoch_.load(std::memory_order_seq_cst));
+  slot.online.store(true);
+}
+
+void
+EpochManager::Offline(unsigned tid) {
+  slots_[tid].online.store(false);
+}
+
+void
+EpochManager::TryAdvance(uint64_t epoch) {
+  for (unsigned i = 0; i < num_slots_; ++i) {
+    const Slot& slot = slots_[i];
+    if (slot.online.load() && slot.seen.load() != epoch) {
+      return;
+    }
+  }
+  // fails harmlessly if another thread advanced the epoch first
+  epoch_.compare_exchange_strong(epoch, epoch + 1);
+}
+
+EpochManager&
+galois::substrate::GetEpochManager() {
+  return GetThreadPool().getEpochManager();
+}
@@ -26,10 +26,12 @@
 
 #include "galois/graphs/FileGraph.h"
 
+#include <algorithm>
 #include <cassert>
 #include <fstream>
 
 #include "galois/Logging.h"
+#include "galois/ParallelSTL.h"
 #include "galois/gIO.h"
 #include "galois/substrate/PageAlloc.h"
 #include "tsuba/file.h"
@@ -794,5 +796,62 @@ FileGraph::getDegree(uint32_t node_id) const {
   return this->node_degrees[node_id];
 }
 
+void
+FileGraphWriter::addEdgesParallel(
+    const uint64_t* srcs, const uint64_t* dsts, size_t num_edges,
+    std::vector<uint64_t>* edgeIds) {
+  numEdges = num_edges;
+  phase1();
+
+  // degree count
+  galois::do_all(
+      galois::iterate(size_t{0}, num_edges),
+      [&](size_t i) {
+        assert(srcs[i] < numNodes);
+        __sync_fetch_and_add(&outIdx[srcs[i]], 1);
+      },
+      galois::loopname("FileGraphWriterDegrees"), galois::no_stats());
+
+  galois::ParallelSTL::partial_sum(
+      outIdx.begin(), outIdx.end(), outIdx.begin());
+
+  // fill each node with the indexes of its edges and then restore their input
+  // order, which concurrent filling loses
+  edgeIds->resize(num_edges);
+  std::vector<uint64_t> cursors(numNodes);
+  galois::do_all(
+      galois::iterate(size_t{0}, num_edges),
+      [&](size_t i) {
+        uint64_t src = srcs[i];
+        uint64_t base = src ? outIdx[src - 1] : 0;
+        (*edgeIds)[base + __sync_fetch_and_add(&cursors[src], 1)] = i;
+      },
+      galois::loopname("FileGraphWriterFill"), galois::no_stats());
+  galois::do_all(
+      galois::iterate(size_t{0}, numNodes),
+      [&](size_t n) {
+        uint64_t begin = n ? outIdx[n - 1] : 0;
+        std::sort(edgeIds->begin() + begin, edgeIds->begin() + outIdx[n]);
+      },
+      galois::loopname("FileGraphWriterSort"), galois::no_stats(),
+      galois::steal());
+
+  if (numNodes <= std::numeric_limits<uint32_t>::max()) {
+    // version 1
+    outs.resize(numEdges);
+    galois::do_all(
+        galois::iterate(size_t{0}, num_edges),
+        [&](size_t i) { outs[i] = static_cast<uint32_t>(dsts[(*edgeIds)[i]]); },
+        galois::loopname("FileGraphWriterDests"), galois::no_stats());
+  } else {
+    // version 2
+    outs64.resize(numEdges);
+    galois::do_all(
+        galois::iterate(size_t{0}, num_edges),
+        [&](size_t i) { outs64[i] = dsts[(*edgeIds)[i]]; },
+        galois::loopname("FileGraphWriterDests"), galois::no_stats());
+  }
+}
+
 }  // namespace graphs
 }  // namespace galois
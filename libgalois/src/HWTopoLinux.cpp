@@ -17,17 +17,25 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <algorithm>
 #include <array>
 #include <cassert>
 #include <cerrno>
+#include <cstdio>
 #include <cstring>
 #include <fstream>
 #include <functional>
+#include <iterator>
 #include <memory>
 #include <mutex>
 #include <set>
+#include <sstream>
+#include <string>
 
+#include "galois/Env.h"
 #include "galois/gIO.h"
 #include "galois/substrate/HWTopo.h"
 #include "galois/substrate/SimpleLock.h"
@@ -175,43 +183,32 @@ markSMT(std::vector<cpuinfo>& info) {
       info[i].smt = false;
 }
 
-std::vector<int>
-parseCPUSet() {
-  std::vector<int> vals;
-
+//! The cpus this process may run on, in list format, or empty if unknown
+std::string
+readCPUSet() {
   std::ifstream data("/proc/self/status");
 
   if (!data) {
-    return vals;
+    return "";
   }
 
   std::string line;
   std::string prefix("Cpus_allowed_list:");
-  bool found = false;
   while (true) {
     std::getline(data, line);
     if (!data) {
-      return vals;
+      return "";
     }
 
     if (line.compare(0, prefix.size(), prefix) == 0) {
-      found = true;
-      break;
+      return line.substr(prefix.size());
     }
   }
-
-  if (!found) {
-    return vals;
-  }
-
-  line = line.substr(prefix.size());
-
-  return galois::substrate::parseCPUList(line);
 }
 
 void
-markValid(std::vector<cpuinfo>& info) {
-  auto v = parseCPUSet();
+markValid(std::vector<cpuinfo>& info, const std::string& cpuset) {
+  auto v = galois::substrate::parseCPUList(cpuset);
   if (v.empty()) {
     for (auto& c : info)
       c.valid = true;
@@ -223,13 +220,13 @@ markValid(std::vector<cpuinfo>& info) {
 }
 
 galois::substrate::HWTopoInfo
-makeHWTopo() {
+makeHWTopo(const std::string& cpuset) {
   galois::substrate::MachineTopoInfo retMTI;
 
   auto info = parseCPUInfo();
   std::sort(info.begin(), info.end());
   markSMT(info);
-  markValid(info);
+  markValid(info, cpuset);
 
   info.erase(
       std::partition(
@@ -276,6 +273,134 @@ makeHWTopo() {
   };
 }
 
+// The topology cache: parsing /proc/cpuinfo and asking libnuma about every
+// cpu dominates the startup of short-lived processes, so the topology is kept
+// in a file in memory (/dev/shm by default, or GALOIS_HWTOPO_CACHE; empty
+// disables the cache). The topology only changes with the hardware, so the
+// cache is keyed by the boot of the machine and by what else the topology
+// depends on: the cpus this process may run on and whether libnuma is used.
+
+constexpr const char* kCacheVersion = "galois-hwtopo 1";
+// bounds what a corrupt cache can make us allocate
+constexpr unsigned kMaxCachedThreads = 1 << 16;
+
+std::string
+cachePath() {
+  std::string dir = "/dev/shm";
+  galois::GetEnv("GALOIS_HWTOPO_CACHE", &dir);
+  if (dir.empty()) {
+    return "";
+  }
+  return dir + "/galois-hwtopo-" + std::to_string(getuid());
+}
+
+std::string
+cacheKey(const std::string& cpuset) {
+  std::ifstream in("/proc/sys/kernel/random/boot_id");
+  std::string boot_id;
+  if (!in || !std::getline(in, boot_id) || boot_id.empty()) {
+    return "";
+  }
+#ifdef GALOIS_USE_NUMA
+  const char* numa = "numa";
+#else
+  const char* numa = "nonuma";
+#endif
+  return std::string(kCacheVersion) + "\n" + boot_id + "\n" + numa + "\n" +
+         cpuset + "\n";
+}
+
+bool
+readCache(
+    const std::string& path, const std::string& key,
+    galois::substrate::HWTopoInfo* topo) {
+  // the directory may be shared, so only trust caches we wrote
+  struct stat stat_buf;
+  if (stat(path.c_str(), &stat_buf) != 0 || stat_buf.st_uid != getuid()) {
+    return false;
+  }
+  std::ifstream in(path);
+  if (!in) {
+    return false;
+  }
+  std::string contents(
+      (std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  if (contents.compare(0, key.size(), key) != 0) {
+    return false;
+  }
+
+  std::istringstream fields(contents.substr(key.size()));
+  galois::substrate::MachineTopoInfo& mti = topo->machineTopoInfo;
+  if (!(fields >> mti.maxThreads >> mti.maxCores >> mti.maxSockets >>
+        mti.maxNumaNodes)) {
+    return false;
+  }
+  if (mti.maxThreads == 0 || mti.maxThreads > kMaxCachedThreads) {
+    return false;
+  }
+  topo->threadTopoInfo.resize(mti.maxThreads);
+  for (unsigned i = 0; i < mti.maxThreads; ++i) {
+    auto& t = topo->threadTopoInfo[i];
+    if (!(fields >> t.tid >> t.socketLeader >> t.socket >> t.numaNode >>
+          t.cumulativeMaxSocket >> t.osContext >> t.osNumaNode)) {
+      return false;
+    }
+    if (t.tid != i || t.socketLeader > i || t.socket >= mti.maxSockets ||
+        t.numaNode >= mti.maxNumaNodes) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void
+writeCache(
+    const std::string& path, const std::string& key,
+    const galois::substrate::HWTopoInfo& topo) {
+  // processes starting together may write at once, so write aside and
+  // rename into place
+  std::string temp = path + "." + std::to_string(getpid());
+  {
+    std::ofstream out(temp);
+    if (!out) {
+      return;
+    }
+    const galois::substrate::MachineTopoInfo& mti = topo.machineTopoInfo;
+    out << key << mti.maxThreads << " " << mti.maxCores << " "
+        << mti.maxSockets << " " << mti.maxNumaNodes << "\n";
+    for (const auto& t : topo.threadTopoInfo) {
+      out << t.tid << " " << t.socketLeader << " " << t.socket << " "
+          << t.numaNode << " " << t.cumulativeMaxSocket << " " << t.osContext
+          << " " << t.osNumaNode << "\n";
+    }
+    if (!out.flush()) {
+      (void)std::remove(temp.c_str());
+      return;
+    }
+  }
+  if (std::rename(temp.c_str(), path.c_str()) != 0) {
+    (void)std::remove(temp.c_str());
+  }
+}
+
+galois::substrate::HWTopoInfo
+loadHWTopo() {
+  std::string cpuset = readCPUSet();
+  std::string path = cachePath();
+  std::string key = path.empty() ? "" : cacheKey(cpuset);
+  if (key.empty()) {
+    return makeHWTopo(cpuset);
+  }
+
+  galois::substrate::HWTopoInfo topo;
+  if (readCache(path, key, &topo)) {
+    return topo;
+  }
+  topo = makeHWTopo(cpuset);
+  writeCache(path, key, topo);
+  return topo;
+}
+
 }  // namespace
 
 galois::substrate::HWTopoInfo
@@ -285,7 +410,7 @@ galois::substrate::getHWTopo() {
 
   std::lock_guard<SimpleLock> guard(lock);
   if (!data) {
-    data = std::make_unique<HWTopoInfo>(makeHWTopo());
+    data = std::make_unique<HWTopoInfo>(loadHWTopo());
   }
   return *data;
 }
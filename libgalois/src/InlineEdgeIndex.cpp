@@ -0,0 +1,95 @@
+#include "galois/graphs/InlineEdgeIndex.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <arrow/api.h>
+
+#include "galois/ErrorCode.h"
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "tsuba/MemoryPool.h"
+
+namespace {
+
+galois::Result<std::shared_ptr<arrow::Buffer>>
+Allocate(uint64_t size) {
+  auto alloc_result = arrow::AllocateBuffer(size, tsuba::GetArrowMemoryPool());
+  if (!alloc_result.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", alloc_result.status());
+    return galois::ErrorCode::ArrowError;
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(alloc_result.ValueOrDie()));
+}
+
+}  // namespace
+
+galois::Result<std::unique_ptr<galois::graphs::InlineEdgeIndex>>
+galois::graphs::InlineEdgeIndex::Make(
+    const PropertyFileGraph& pfg, const std::string& property) {
+  if (pfg.HasWideNodeIds()) {
+    GALOIS_LOG_DEBUG("inline edges need 32-bit node ids");
+    return ErrorCode::InvalidArgument;
+  }
+  if (auto res = pfg.EnsureEdgePropertiesLoaded({property}); !res) {
+    return res.error();
+  }
+  std::shared_ptr<arrow::ChunkedArray> values = pfg.EdgeProperty(property);
+  if (!values) {
+    return ErrorCode::PropertyNotFound;
+  }
+  auto fixed_width =
+      std::dynamic_pointer_cast<arrow::FixedWidthType>(values->type());
+  int bit_width = fixed_width ? fixed_width->bit_width() : 0;
+  if (bit_width != 8 && bit_width != 16 && bit_width != 32 && bit_width != 64) {
+    GALOIS_LOG_DEBUG(
+        "cannot inline values of type {}", values->type()->ToString());
+    return ErrorCode::TypeError;
+  }
+
+  const GraphTopology& topology = pfg.topology();
+  uint64_t num_edges = topology.num_edges();
+  if (static_cast<uint64_t>(values->length()) != num_edges) {
+    GALOIS_LOG_DEBUG(
+        "expected {} values found {} instead", num_edges, values->length());
+    return ErrorCode::InvalidArgument;
+  }
+
+  // the layout of Edge<T>: the value at its alignment after the destination
+  uint64_t width = bit_width / 8;
+  uint64_t value_offset = std::max<uint64_t>(sizeof(uint32_t), width);
+  uint64_t stride = 2 * value_offset;
+
+  auto data_result = Allocate(num_edges * stride);
+  if (!data_result) {
+    return data_result.error();
+  }
+  std::unique_ptr<InlineEdgeIndex> index(new InlineEdgeIndex());
+  index->property_ = property;
+  index->type_ = values->type();
+  index->num_edges_ = num_edges;
+  index->data_ = std::move(data_result.value());
+
+  uint8_t* data = index->data_->mutable_data();
+  const uint32_t* dests = topology.out_dests->raw_values();
+  uint64_t chunk_begin = 0;
+  for (const std::shared_ptr<arrow::Array>& chunk : values->chunks()) {
+    uint64_t chunk_size = chunk->length();
+    if (chunk_size == 0) {
+      continue;
+    }
+    const uint8_t* raw =
+        chunk->data()->buffers[1]->data() + chunk->offset() * width;
+    galois::do_all(
+        galois::iterate(uint64_t{0}, chunk_size),
+        [&](uint64_t i) {
+          uint8_t* edge = data + (chunk_begin + i) * stride;
+          std::memcpy(edge, dests + chunk_begin + i, sizeof(uint32_t));
+          std::memcpy(edge + value_offset, raw + i * width, width);
+        },
+        galois::no_stats(), galois::loopname("InlineEdgeIndexMake"));
+    chunk_begin += chunk_size;
+  }
+
+  return std::unique_ptr<InlineEdgeIndex>(std::move(index));
+}
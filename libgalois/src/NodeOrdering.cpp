@@ -0,0 +1,522 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <queue>
+
+#include <arrow/compute/api.h>
+
+#include "galois/LargeArray.h"
+#include "galois/Logging.h"
+#include "galois/Loops.h"
+#include "galois/ParallelSTL.h"
+#include "galois/Permutation.h"
+#include "galois/Result.h"
+#include "galois/graphs/PropertyFileGraph.h"
+#include "tsuba/MemoryPool.h"
+
+namespace {
+
+using galois::graphs::GraphTopology;
+
+/// Nodes in the Gorder window; the original paper finds little benefit in
+/// windows larger than this
+constexpr uint64_t kGorderWindow = 5;
+
+uint64_t
+Degree(const GraphTopology& topology, uint32_t node) {
+  auto [begin, end] = topology.edge_range(node);
+  return end - begin;
+}
+
+/// Nodes sorted by ascending (ascend) or descending degree, ties broken by
+/// node id
+std::vector<uint32_t>
+NodesByDegree(const GraphTopology& topology, bool ascend) {
+  std::vector<uint32_t> nodes(topology.num_nodes());
+  std::iota(nodes.begin(), nodes.end(), uint32_t{0});
+  galois::ParallelSTL::sort(nodes.begin(), nodes.end(), [&](auto a, auto b) {
+    uint64_t da = Degree(topology, a);
+    uint64_t db = Degree(topology, b);
+    if (da != db) {
+      return ascend ? da < db : da > db;
+    }
+    return a < b;
+  });
+  return nodes;
+}
+
+/// Parallel Cuthill-McKee in the style of Karantasis et al., "Parallelization
+/// of Reordering Algorithms for Bandwidth and Wavefront Reduction".
+///
+/// The breadth-first search proceeds level by level. Every unvisited node in
+/// the next level is claimed by the earliest node of the current level that
+/// reaches it, which is what the serial algorithm would do, and each node of
+/// the current level then emits its children by increasing degree. This
+/// yields the serial order regardless of the number of threads.
+std::vector<uint32_t>
+ReverseCuthillMcKee(const GraphTopology& topology) {
+  uint64_t num_nodes = topology.num_nodes();
+  constexpr uint64_t kUnclaimed = std::numeric_limits<uint64_t>::max();
+
+  galois::LargeArray<uint64_t> claim;
+  claim.create(num_nodes, kUnclaimed);
+
+  auto by_degree = [&](uint32_t a, uint32_t b) {
+    uint64_t da = Degree(topology, a);
+    uint64_t db = Degree(topology, b);
+    return da != db ? da < db : a < b;
+  };
+
+  std::vector<uint32_t> order(num_nodes);
+  std::vector<uint32_t> starts = NodesByDegree(topology, true);
+  uint64_t next_start = 0;
+  uint64_t placed = 0;
+  std::vector<std::vector<uint32_t>> children;
+  std::vector<uint64_t> offsets;
+
+  while (placed < num_nodes) {
+    while (claim[starts[next_start]] != kUnclaimed) {
+      ++next_start;
+    }
+    uint32_t start = starts[next_start];
+    claim[start] = placed;
+    order[placed++] = start;
+
+    uint64_t begin = placed - 1;
+    uint64_t end = placed;
+    while (begin != end) {
+      galois::do_all(
+          galois::iterate(begin, end),
+          [&](uint64_t i) {
+            auto [e, e_end] = topology.edge_range(order[i]);
+            for (; e != e_end; ++e) {
+              uint32_t dest = topology.out_dests->Value(e);
+              uint64_t cur = claim[dest];
+              while (cur > i &&
+                     !__sync_bool_compare_and_swap(&claim[dest], cur, i)) {
+                cur = claim[dest];
+              }
+            }
+          },
+          galois::no_stats(), galois::steal());
+
+      children.resize(end - begin);
+      offsets.resize(end - begin);
+      galois::do_all(
+          galois::iterate(begin, end),
+          [&](uint64_t i) {
+            uint32_t node = order[i];
+            std::vector<uint32_t>& mine = children[i - begin];
+            mine.clear();
+            auto [e, e_end] = topology.edge_range(node);
+            for (; e != e_end; ++e) {
+              uint32_t dest = topology.out_dests->Value(e);
+              if (dest != node && claim[dest] == i) {
+                mine.emplace_back(dest);
+              }
+            }
+            std::sort(mine.begin(), mine.end(), by_degree);
+            mine.erase(std::unique(mine.begin(), mine.end()), mine.end());
+            offsets[i - begin] = mine.size();
+          },
+          galois::no_stats(), galois::steal());
+
+      galois::ParallelSTL::partial_sum(
+          offsets.begin(), offsets.end(), offsets.begin());
+
+      galois::do_all(
+          galois::iterate(uint64_t{0}, end - begin),
+          [&](uint64_t i) {
+            uint64_t out = end + (i == 0 ? 0 : offsets[i - 1]);
+            std::copy(children[i].begin(), children[i].end(), &order[out]);
+          },
+          galois::no_stats());
+
+      begin = end;
+      end += offsets.back();
+    }
+    placed = end;
+  }
+
+  std::reverse(order.begin(), order.end());
+  return order;
+}
+
+/// Greedy node ordering from Wei et al., "Speedup Graph Processing by Graph
+/// Ordering".
+///
+/// The score of an unplaced node is the number of edges between it and the
+/// last kGorderWindow placed nodes plus the number of in-neighbors it has in
+/// common with them; the node with the highest score is placed next. Scores
+/// are kept in a max-heap with lazy deletion: an entry is used only if it
+/// still matches the score of its node. Like the original, in-neighbors of
+/// more than sqrt(num_nodes) out-edges are ignored when counting common
+/// in-neighbors since they relate too many nodes to be informative.
+///
+/// The greedy placement itself is sequential; the transpose it needs is built
+/// in parallel.
+std::vector<uint32_t>
+Gorder(const GraphTopology& topology) {
+  uint64_t num_nodes = topology.num_nodes();
+  uint64_t num_edges = topology.num_edges();
+  const uint32_t* dests = topology.out_dests->raw_values();
+
+  // transpose: in_indices[n] is the end of the in-edges of n
+  galois::LargeArray<uint64_t> in_indices;
+  in_indices.create(num_nodes, 0);
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) { __sync_fetch_and_add(&in_indices[dests[e]], 1); },
+      galois::no_stats());
+  galois::ParallelSTL::partial_sum(
+      in_indices.begin(), in_indices.end(), in_indices.begin());
+
+  galois::LargeArray<uint64_t> in_cursor;
+  in_cursor.allocateBlocked(num_nodes);
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { in_cursor[n] = n == 0 ? 0 : in_indices[n - 1]; },
+      galois::no_stats());
+
+  galois::LargeArray<uint32_t> in_sources;
+  in_sources.allocateBlocked(num_edges);
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        auto [e, e_end] = topology.edge_range(n);
+        for (; e != e_end; ++e) {
+          in_sources[__sync_fetch_and_add(&in_cursor[dests[e]], 1)] = n;
+        }
+      },
+      galois::no_stats(), galois::steal());
+
+  auto in_range = [&](uint32_t n) {
+    return std::make_pair(n == 0 ? 0 : in_indices[n - 1], in_indices[n]);
+  };
+
+  uint64_t hub_degree = std::max<uint64_t>(
+      1, static_cast<uint64_t>(std::sqrt(static_cast<double>(num_nodes))));
+
+  std::vector<int64_t> score(num_nodes, 0);
+  std::vector<uint8_t> placed(num_nodes, 0);
+  using Entry = std::pair<int64_t, uint32_t>;
+  std::priority_queue<Entry> heap;
+
+  auto bump = [&](uint32_t n, int64_t delta) {
+    if (placed[n]) {
+      return;
+    }
+    score[n] += delta;
+    if (delta > 0) {
+      heap.emplace(score[n], n);
+    }
+  };
+
+  auto update = [&](uint32_t node, int64_t delta) {
+    auto [e, e_end] = topology.edge_range(node);
+    for (; e != e_end; ++e) {
+      bump(dests[e], delta);
+    }
+    auto [in, in_end] = in_range(node);
+    for (; in != in_end; ++in) {
+      uint32_t parent = in_sources[in];
+      bump(parent, delta);
+      if (Degree(topology, parent) > hub_degree) {
+        continue;
+      }
+      auto [s, s_end] = topology.edge_range(parent);
+      for (; s != s_end; ++s) {
+        if (dests[s] != node) {
+          bump(dests[s], delta);
+        }
+      }
+    }
+  };
+
+  // when no unplaced node has a positive score, continue from the unplaced
+  // node with the most in-edges
+  std::vector<uint32_t> fallback(num_nodes);
+  std::iota(fallback.begin(), fallback.end(), uint32_t{0});
+  std::stable_sort(fallback.begin(), fallback.end(), [&](auto a, auto b) {
+    auto [a_begin, a_end] = in_range(a);
+    auto [b_begin, b_end] = in_range(b);
+    return a_end - a_begin > b_end - b_begin;
+  });
+  uint64_t next_fallback = 0;
+
+  std::vector<uint32_t> order;
+  order.reserve(num_nodes);
+  while (order.size() < num_nodes) {
+    uint32_t next = 0;
+    bool found = false;
+    while (!heap.empty() && !found) {
+      auto [s, n] = heap.top();
+      heap.pop();
+      if (placed[n] || score[n] > s) {
+        continue;
+      }
+      if (score[n] < s) {
+        if (score[n] > 0) {
+          heap.emplace(score[n], n);
+        }
+        continue;
+      }
+      next = n;
+      found = true;
+    }
+    if (!found) {
+      while (placed[fallback[next_fallback]]) {
+        ++next_fallback;
+      }
+      next = fallback[next_fallback];
+    }
+
+    placed[next] = 1;
+    order.emplace_back(next);
+    update(next, 1);
+    if (order.size() > kGorderWindow) {
+      update(order[order.size() - kGorderWindow - 1], -1);
+    }
+  }
+
+  return order;
+}
+
+/// Return a UInt32Array or UInt64Array over the values of v; v must outlive
+/// the result
+template <typename ArrayType, typename T>
+std::shared_ptr<arrow::Array>
+WrapIndices(const std::vector<T>& v) {
+  return std::make_shared<ArrayType>(v.size(), arrow::Buffer::Wrap(v));
+}
+
+}  // namespace
+
+galois::Result<std::shared_ptr<arrow::ChunkedArray>>
+galois::graphs::GatherColumn(
+    const std::shared_ptr<arrow::ChunkedArray>& column,
+    const BlockedPermutation& plan,
+    const std::shared_ptr<arrow::Array>& indices) {
+  if (column->num_chunks() == 1) {
+    const std::shared_ptr<arrow::ArrayData>& data = column->chunk(0)->data();
+    const auto* type =
+        dynamic_cast<const arrow::FixedWidthType*>(data->type.get());
+    if (type && type->id() != arrow::Type::DICTIONARY &&
+        type->id() != arrow::Type::EXTENSION && type->bit_width() % 8 == 0 &&
+        data->offset == 0 && data->buffers.size() == 2 && data->buffers[1] &&
+        data->GetNullCount() == 0) {
+      uint64_t width = type->bit_width() / 8;
+      auto alloc_result = arrow::AllocateBuffer(
+          plan.size() * width, tsuba::GetArrowMemoryPool());
+      if (!alloc_result.ok()) {
+        GALOIS_LOG_DEBUG("arrow error: {}", alloc_result.status());
+        return ErrorCode::ArrowError;
+      }
+      std::shared_ptr<arrow::Buffer> buffer =
+          std::move(alloc_result.ValueOrDie());
+      plan.Apply(data->buffers[1]->data(), buffer->mutable_data(), width);
+      auto permuted =
+          arrow::ArrayData::Make(data->type, plan.size(), {nullptr, buffer}, 0);
+      return std::make_shared<arrow::ChunkedArray>(arrow::MakeArray(permuted));
+    }
+  }
+
+  auto take_result =
+      arrow::compute::Take(arrow::Datum(column), arrow::Datum(indices));
+  if (!take_result.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", take_result.status());
+    return ErrorCode::ArrowError;
+  }
+  return take_result.ValueOrDie().chunked_array();
+}
+
+galois::Result<std::shared_ptr<arrow::Table>>
+galois::graphs::GatherRows(
+    const std::shared_ptr<arrow::Table>& table, const BlockedPermutation& plan,
+    const std::shared_ptr<arrow::Array>& indices) {
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (const auto& column : table->columns()) {
+    auto res = GatherColumn(column, plan, indices);
+    if (!res) {
+      return res.error();
+    }
+    columns.emplace_back(std::move(res.value()));
+  }
+  return arrow::Table::Make(table->schema(), columns, plan.size());
+}
+
+galois::Result<std::vector<uint32_t>>
+galois::graphs::ComputeNodeOrdering(
+    const GraphTopology& topology, NodeOrdering ordering) {
+  switch (ordering) {
+  case NodeOrdering::kDegree:
+    return NodesByDegree(topology, false);
+  case NodeOrdering::kReverseCuthillMcKee:
+    return ReverseCuthillMcKee(topology);
+  case NodeOrdering::kGorder:
+    return Gorder(topology);
+  }
+  return ErrorCode::InvalidArgument;
+}
+
+galois::Result<void>
+galois::graphs::PermuteNodes(
+    PropertyFileGraph* pfg, const std::vector<uint32_t>& new_to_old) {
+  const GraphTopology& topology = pfg->topology();
+  uint64_t num_nodes = topology.num_nodes();
+  uint64_t num_edges = topology.num_edges();
+
+  if (new_to_old.size() != num_nodes) {
+    GALOIS_LOG_DEBUG(
+        "expected {} nodes found {} instead", num_nodes, new_to_old.size());
+    return ErrorCode::InvalidArgument;
+  }
+  if (!pfg->master_nodes().empty() || !pfg->mirror_nodes().empty()) {
+    return ErrorCode::NotImplemented;
+  }
+
+  constexpr uint32_t kUnmapped = std::numeric_limits<uint32_t>::max();
+  std::vector<uint32_t> old_to_new(num_nodes, kUnmapped);
+  std::atomic<bool> invalid{false};
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint32_t old = new_to_old[n];
+        if (old >= num_nodes ||
+            !__sync_bool_compare_and_swap(&old_to_new[old], kUnmapped, n)) {
+          invalid = true;
+        }
+      },
+      galois::no_stats());
+  if (invalid) {
+    return ErrorCode::InvalidArgument;
+  }
+
+  arrow::MemoryPool* pool = tsuba::GetArrowMemoryPool();
+  auto indices_result =
+      arrow::AllocateBuffer(num_nodes * sizeof(uint64_t), pool);
+  auto dests_result = arrow::AllocateBuffer(num_edges * sizeof(uint32_t), pool);
+  if (!indices_result.ok() || !dests_result.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: could not allocate topology");
+    return ErrorCode::ArrowError;
+  }
+  std::shared_ptr<arrow::Buffer> indices_buffer =
+      std::move(indices_result.ValueOrDie());
+  std::shared_ptr<arrow::Buffer> dests_buffer =
+      std::move(dests_result.ValueOrDie());
+  auto* indices = reinterpret_cast<uint64_t*>(indices_buffer->mutable_data());
+  auto* dests = reinterpret_cast<uint32_t*>(dests_buffer->mutable_data());
+
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { indices[n] = Degree(topology, new_to_old[n]); },
+      galois::no_stats());
+  galois::ParallelSTL::partial_sum(indices, indices + num_nodes, indices);
+
+  // new edge e was old edge edge_map[e]
+  std::vector<uint64_t> edge_map(num_edges);
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t out = n == 0 ? 0 : indices[n - 1];
+        auto [e, e_end] = topology.edge_range(new_to_old[n]);
+        for (; e != e_end; ++e, ++out) {
+          dests[out] = old_to_new[topology.out_dests->Value(e)];
+          edge_map[out] = e;
+        }
+      },
+      galois::no_stats(), galois::steal());
+
+  if (auto res = pfg->EnsureNodePropertiesLoaded(pfg->NodePropertyNames());
+      !res) {
+    return res.error();
+  }
+  if (auto res = pfg->EnsureEdgePropertiesLoaded(pfg->EdgePropertyNames());
+      !res) {
+    return res.error();
+  }
+
+  auto node_indices = WrapIndices<arrow::UInt32Array>(new_to_old);
+  BlockedPermutation node_plan(new_to_old.data(), num_nodes);
+
+  const auto& node_table = pfg->node_table();
+  bool has_original_ids =
+      node_table->schema()->GetFieldIndex(kOriginalNodeIdProperty) >= 0;
+  if (node_table->num_columns() > 0) {
+    auto permute_result = GatherRows(node_table, node_plan, node_indices);
+    if (!permute_result) {
+      return permute_result.error();
+    }
+    if (auto res = pfg->ReplaceNodeProperties(permute_result.value()); !res) {
+      return res.error();
+    }
+  }
+
+  const auto& edge_table = pfg->edge_table();
+  if (edge_table->num_columns() > 0) {
+    BlockedPermutation edge_plan(edge_map.data(), num_edges);
+    auto permute_result = GatherRows(
+        edge_table, edge_plan, WrapIndices<arrow::UInt64Array>(edge_map));
+    if (!permute_result) {
+      return permute_result.error();
+    }
+    if (auto res = pfg->ReplaceEdgeProperties(permute_result.value()); !res) {
+      return res.error();
+    }
+  }
+
+  if (const auto& l2g = pfg->local_to_global_vector();
+      l2g && static_cast<uint64_t>(l2g->length()) == num_nodes) {
+    auto permute_result = GatherColumn(l2g, node_plan, node_indices);
+    if (!permute_result) {
+      return permute_result.error();
+    }
+    pfg->set_local_to_global_vector(std::move(permute_result.value()));
+  }
+
+  if (auto res = pfg->SetTopology(GraphTopology{
+          .out_indices =
+              std::make_shared<arrow::UInt64Array>(num_nodes, indices_buffer),
+          .out_dests =
+              std::make_shared<arrow::UInt32Array>(num_edges, dests_buffer),
+      });
+      !res) {
+    return res.error();
+  }
+
+  if (has_original_ids) {
+    return ResultSuccess();
+  }
+
+  arrow::UInt32Builder builder(tsuba::GetArrowMemoryPool());
+  if (auto status = builder.AppendValues(new_to_old); !status.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", status);
+    return ErrorCode::ArrowError;
+  }
+  std::shared_ptr<arrow::Array> original_ids;
+  if (auto status = builder.Finish(&original_ids); !status.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", status);
+    return ErrorCode::ArrowError;
+  }
+  auto original_ids_table = arrow::Table::Make(
+      arrow::schema({arrow::field(kOriginalNodeIdProperty, arrow::uint32())}),
+      {original_ids});
+  if (auto res = pfg->AddNodeProperties(original_ids_table); !res) {
+    return res.error();
+  }
+
+  std::vector<std::string> persist(pfg->NodePropertyNames().size());
+  persist.back() = kOriginalNodeIdProperty;
+  return pfg->MarkNodePropertiesPersistent(persist);
+}
+
+galois::Result<void>
+galois::graphs::ReorderNodes(PropertyFileGraph* pfg, NodeOrdering ordering) {
+  auto order_result = ComputeNodeOrdering(pfg->topology(), ordering);
+  if (!order_result) {
+    return order_result.error();
+  }
+  return PermuteNodes(pfg, order_result.value());
+}
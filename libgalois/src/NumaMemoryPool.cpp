@@ -0,0 +1,139 @@
+#include "galois/NumaMemoryPool.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "galois/runtime/Mem.h"
+#include "galois/substrate/NumaMem.h"
+#include "galois/substrate/PageAlloc.h"
+#include "galois/substrate/ThreadPool.h"
+
+namespace {
+
+size_t
+RoundToPages(int64_t size) {
+  size_t page = galois::substrate::allocSize();
+  return (static_cast<size_t>(size) + page - 1) / page * page;
+}
+
+}  // namespace
+
+galois::NumaMemoryPool::NumaMemoryPool(Policy policy, int64_t min_bytes)
+    : policy_(policy),
+      min_bytes_(
+          min_bytes > 0 ? min_bytes
+                        : static_cast<int64_t>(substrate::allocSize())),
+      owner_(std::this_thread::get_id()) {}
+
+galois::NumaMemoryPool*
+galois::NumaMemoryPool::Get(Policy policy) {
+  // Leaked: arrow buffers keep a pointer to their pool and may be freed during
+  // static destruction
+  static NumaMemoryPool* pools[] = {
+      new NumaMemoryPool(kBlocked),
+      new NumaMemoryPool(kLocal),
+      new NumaMemoryPool(kInterleaved),
+      new NumaMemoryPool(kFloating),
+  };
+  return pools[policy];
+}
+
+void
+galois::NumaMemoryPool::AddBytes(int64_t delta) {
+  int64_t allocated = bytes_allocated_.fetch_add(delta) + delta;
+  int64_t max = max_memory_.load(std::memory_order_relaxed);
+  while (allocated > max &&
+         !max_memory_.compare_exchange_weak(max, allocated)) {
+  }
+}
+
+uint8_t*
+galois::NumaMemoryPool::AllocatePages(int64_t size) const {
+  Policy policy = policy_;
+  // Paging in with the thread pool is only safe from the thread that drives
+  // it and only when it is idle
+  if ((policy == kBlocked || policy == kInterleaved) &&
+      (std::this_thread::get_id() != owner_ ||
+       substrate::GetThreadPool().isRunning())) {
+    policy = kFloating;
+  }
+
+  substrate::LAptr ptr;
+  switch (policy) {
+  case kBlocked:
+    ptr = substrate::largeMallocBlocked(size, runtime::activeThreads);
+    break;
+  case kLocal:
+    ptr = substrate::largeMallocLocal(size);
+    break;
+  case kInterleaved:
+    ptr = substrate::largeMallocInterleaved(size, runtime::activeThreads);
+    break;
+  case kFloating:
+  default:
+    ptr = substrate::largeMallocFloating(size);
+    break;
+  }
+  return static_cast<uint8_t*>(ptr.release());
+}
+
+arrow::Status
+galois::NumaMemoryPool::Allocate(int64_t size, uint8_t** out) {
+  if (size < 0) {
+    return arrow::Status::Invalid("negative allocation size");
+  }
+  if (!IsLarge(size)) {
+    ARROW_RETURN_NOT_OK(arrow::default_memory_pool()->Allocate(size, out));
+    AddBytes(size);
+    return arrow::Status::OK();
+  }
+
+  uint8_t* pages = AllocatePages(size);
+  if (!pages) {
+    return arrow::Status::OutOfMemory(
+        "galois-numa: could not allocate ", size, " bytes");
+  }
+  *out = pages;
+  AddBytes(size);
+  return arrow::Status::OK();
+}
+
+arrow::Status
+galois::NumaMemoryPool::Reallocate(
+    int64_t old_size, int64_t new_size, uint8_t** ptr) {
+  if (new_size < 0) {
+    return arrow::Status::Invalid("negative allocation size");
+  }
+  bool old_large = IsLarge(old_size);
+  bool new_large = IsLarge(new_size);
+  if (!old_large && !new_large) {
+    ARROW_RETURN_NOT_OK(
+        arrow::default_memory_pool()->Reallocate(old_size, new_size, ptr));
+    AddBytes(new_size - old_size);
+    return arrow::Status::OK();
+  }
+  // Builders grow their buffers a little at a time; most steps stay within
+  // the pages that are already mapped
+  if (old_large && new_large &&
+      RoundToPages(old_size) == RoundToPages(new_size)) {
+    AddBytes(new_size - old_size);
+    return arrow::Status::OK();
+  }
+
+  uint8_t* out{};
+  ARROW_RETURN_NOT_OK(Allocate(new_size, &out));
+  std::memcpy(out, *ptr, std::min(old_size, new_size));
+  Free(*ptr, old_size);
+  *ptr = out;
+  return arrow::Status::OK();
+}
+
+void
+galois::NumaMemoryPool::Free(uint8_t* buffer, int64_t size) {
+  if (!IsLarge(size)) {
+    arrow::default_memory_pool()->Free(buffer, size);
+  } else {
+    substrate::internal::largeFreer{RoundToPages(size)}(buffer);
+  }
+  AddBytes(-size);
+}
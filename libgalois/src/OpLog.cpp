@@ -1,33 +1,835 @@
 #include "galois/OpLog.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <future>
+#include <optional>
+#include <string_view>
+#include <unordered_set>
+
+#include <arrow/compute/api.h>
+
+#include "galois/Galois.h"
 #include "galois/Logging.h"
+#include "galois/substrate/PerThreadStorage.h"
+#include "tsuba/MemoryPool.h"
+#include "tsuba/file.h"
+
+namespace {
+
+/// "KGOPLOG" and a format version start each segment
+constexpr uint64_t kSegmentMagic = UINT64_C(0x474f4c504f474b);
+constexpr uint64_t kSegmentVersion = 1;
+constexpr std::string_view kSegmentPrefix = "oplog-";
+
+/// Records are a kind byte followed by their fields. A key record defines
+/// the next property number: a flags byte (for node, for edge, is list), the
+/// type and the name. An operation record has the opcode, the property
+/// number, the id, either as a varint or, if it is not a plain decimal
+/// number, as a string, and for property values the value.
+enum RecordKind : uint8_t {
+  kKeyRecord = 0,
+  kOpRecord = 1,
+};
+
+using Value = decltype(galois::ImportData::value);
+
+void
+PutVarint(std::vector<uint8_t>* out, uint64_t v) {
+  while (v >= 0x80) {
+    out->emplace_back(static_cast<uint8_t>(v) | 0x80);
+    v >>= 7;
+  }
+  out->emplace_back(static_cast<uint8_t>(v));
+}
+
+void
+PutString(std::vector<uint8_t>* out, const std::string& s) {
+  PutVarint(out, s.size());
+  out->insert(out->end(), s.begin(), s.end());
+}
+
+template <typename T>
+void
+PutFixed(std::vector<uint8_t>* out, T v) {
+  const auto* bytes = reinterpret_cast<const uint8_t*>(&v);
+  out->insert(out->end(), bytes, bytes + sizeof(T));
+}
+
+/// Reader decodes fields from [in, end); ok() turns false for good once a
+/// field runs past the end
+class Reader {
+  const uint8_t* in_;
+  const uint8_t* end_;
+  bool ok_{true};
+
+public:
+  Reader(const uint8_t* in, const uint8_t* end) : in_(in), end_(end) {}
+
+  bool ok() const { return ok_; }
+  void Fail() { ok_ = false; }
+  bool done() const { return in_ == end_; }
+  const uint8_t* position() const { return in_; }
+  uint64_t remaining() const { return end_ - in_; }
+
+  uint8_t GetByte() {
+    if (in_ == end_) {
+      ok_ = false;
+      return 0;
+    }
+    return *in_++;
+  }
+
+  uint64_t GetVarint() {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      uint8_t byte = GetByte();
+      result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        return result;
+      }
+    }
+    ok_ = false;
+    return 0;
+  }
+
+  std::string GetString() {
+    uint64_t size = GetVarint();
+    if (size > remaining()) {
+      ok_ = false;
+      return "";
+    }
+    std::string s(reinterpret_cast<const char*>(in_), size);
+    in_ += size;
+    return s;
+  }
+
+  template <typename T>
+  T GetFixed() {
+    T v{};
+    if (remaining() < sizeof(T)) {
+      ok_ = false;
+      return v;
+    }
+    std::memcpy(&v, in_, sizeof(T));
+    in_ += sizeof(T);
+    return v;
+  }
+};
+
+uint64_t
+ZigZagEncode(int64_t v) {
+  return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+int64_t
+ZigZagDecode(uint64_t v) {
+  return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+/// Codec<T> encodes the values of one alternative of ImportData::value
+template <typename T>
+struct Codec;
+
+template <>
+struct Codec<uint8_t> {
+  static void Put(std::vector<uint8_t>* out, uint8_t v) {
+    out->emplace_back(v);
+  }
+  static uint8_t Get(Reader* r) { return r->GetByte(); }
+};
+
+template <>
+struct Codec<bool> {
+  static void Put(std::vector<uint8_t>* out, bool v) { out->emplace_back(v); }
+  static bool Get(Reader* r) { return r->GetByte() != 0; }
+};
+
+template <>
+struct Codec<std::string> {
+  static void Put(std::vector<uint8_t>* out, const std::string& v) {
+    PutString(out, v);
+  }
+  static std::string Get(Reader* r) { return r->GetString(); }
+};
+
+template <>
+struct Codec<int64_t> {
+  static void Put(std::vector<uint8_t>* out, int64_t v) {
+    PutVarint(out, ZigZagEncode(v));
+  }
+  static int64_t Get(Reader* r) { return ZigZagDecode(r->GetVarint()); }
+};
+
+template <>
+struct Codec<int32_t> {
+  static void Put(std::vector<uint8_t>* out, int32_t v) {
+    PutVarint(out, ZigZagEncode(v));
+  }
+  static int32_t Get(Reader* r) { return ZigZagDecode(r->GetVarint()); }
+};
+
+template <>
+struct Codec<double> {
+  static void Put(std::vector<uint8_t>* out, double v) { PutFixed(out, v); }
+  static double Get(Reader* r) { return r->GetFixed<double>(); }
+};
+
+template <>
+struct Codec<float> {
+  static void Put(std::vector<uint8_t>* out, float v) { PutFixed(out, v); }
+  static float Get(Reader* r) { return r->GetFixed<float>(); }
+};
+
+template <typename T>
+struct Codec<std::vector<T>> {
+  static void Put(std::vector<uint8_t>* out, const std::vector<T>& v) {
+    PutVarint(out, v.size());
+    for (auto&& x : v) {
+      Codec<T>::Put(out, x);
+    }
+  }
+  static std::vector<T> Get(Reader* r) {
+    uint64_t size = r->GetVarint();
+    std::vector<T> v;
+    // every element takes at least one byte
+    if (size > r->remaining()) {
+      r->Fail();
+      return v;
+    }
+    for (uint64_t i = 0; i < size && r->ok(); ++i) {
+      v.emplace_back(Codec<T>::Get(r));
+    }
+    return v;
+  }
+};
+
+template <size_t I = 0>
+void
+GetValue(Reader* r, size_t index, Value* value) {
+  if constexpr (I < std::variant_size_v<Value>) {
+    if (index == I) {
+      value->emplace<I>(Codec<std::variant_alternative_t<I, Value>>::Get(r));
+      return;
+    }
+    GetValue<I + 1>(r, index, value);
+  } else {
+    r->Fail();
+  }
+}
+
+bool
+IsValueOp(galois::OpTypes opcode) {
+  return opcode == galois::OpTypes::kOpNodePropVal ||
+         opcode == galois::OpTypes::kOpEdgePropVal;
+}
+
+/// Whether id is a decimal number that its varint gives back exactly
+bool
+IsPlainNumber(const std::string& id) {
+  return !id.empty() && id.size() < 20 && (id.size() == 1 || id[0] != '0') &&
+         std::all_of(id.begin(), id.end(), [](char c) {
+           return c >= '0' && c <= '9';
+         });
+}
+
+/// The interned part of a key: everything but its id
+std::string
+KeyName(const galois::PropertyKey& key) {
+  std::string name = key.name;
+  name += static_cast<char>(key.for_node);
+  name += static_cast<char>(key.for_edge);
+  name += static_cast<char>(key.is_list);
+  name += static_cast<char>(key.type);
+  return name;
+}
+
+std::optional<galois::Operation>
+GetOperation(Reader* r, const std::vector<galois::PropertyKey>& keys) {
+  auto opcode = static_cast<galois::OpTypes>(r->GetByte());
+  uint64_t key_number = r->GetVarint();
+  std::string id;
+  if (r->GetByte() == 0) {
+    id = std::to_string(r->GetVarint());
+  } else {
+    id = r->GetString();
+  }
+  if (!r->ok() || key_number >= keys.size()) {
+    return std::nullopt;
+  }
+  galois::PropertyKey key = keys[key_number];
+  key.id = std::move(id);
+  if (!IsValueOp(opcode)) {
+    return galois::Operation(opcode, std::move(key));
+  }
+
+  auto type = static_cast<galois::ImportDataType>(r->GetByte());
+  bool is_list = r->GetByte() != 0;
+  galois::ImportData data(type, is_list);
+  GetValue(r, r->GetByte(), &data.value);
+  if (!r->ok()) {
+    return std::nullopt;
+  }
+  return galois::Operation(opcode, std::move(key), std::move(data));
+}
+
+std::string
+SegmentName(uint64_t number) {
+  return fmt::format("{}{:020}", kSegmentPrefix, number);
+}
+
+}  // namespace
+
+uint32_t
+galois::OpLog::KeyNumber(const galois::PropertyKey& key) {
+  auto [it, inserted] = key_numbers_.emplace(KeyName(key), keys_.size());
+  if (inserted) {
+    records_.emplace_back(kKeyRecord);
+    records_.emplace_back(
+        key.for_node | (key.for_edge << 1) | (key.is_list << 2));
+    records_.emplace_back(static_cast<uint8_t>(key.type));
+    PutString(&records_, key.name);
+    keys_.emplace_back(
+        "", key.for_node, key.for_edge, key.name, key.type, key.is_list);
+  }
+  return it->second;
+}
+
+galois::Result<void>
+galois::OpLog::Decode(const uint8_t* begin, const uint8_t* end) {
+  Reader r(begin, end);
+  while (!r.done()) {
+    uint64_t offset = r.position() - records_.data();
+    switch (r.GetByte()) {
+    case kKeyRecord: {
+      uint8_t flags = r.GetByte();
+      auto type = static_cast<galois::ImportDataType>(r.GetByte());
+      std::string name = r.GetString();
+      PropertyKey key("", flags & 1, flags & 2, name, type, flags & 4);
+      key_numbers_.emplace(KeyName(key), keys_.size());
+      keys_.emplace_back(std::move(key));
+      break;
+    }
+    case kOpRecord: {
+      if (!GetOperation(&r, keys_)) {
+        return ErrorCode::InvalidArgument;
+      }
+      offsets_.emplace_back(offset);
+      break;
+    }
+    default:
+      return ErrorCode::InvalidArgument;
+    }
+    if (!r.ok()) {
+      return ErrorCode::InvalidArgument;
+    }
+  }
+  return galois::ResultSuccess();
+}
+
+galois::Result<galois::OpLog>
+galois::OpLog::Make(const galois::Uri& uri) {
+  std::vector<std::string> files;
+  std::vector<uint64_t> sizes;
+  if (auto res = tsuba::FileListAsync(uri.string(), &files, &sizes).get();
+      !res) {
+    return res.error();
+  }
+  std::vector<std::pair<std::string, uint64_t>> segments;
+  for (size_t i = 0; i < files.size(); ++i) {
+    if (files[i].rfind(kSegmentPrefix, 0) == 0) {
+      segments.emplace_back(files[i], sizes[i]);
+    }
+  }
+  // segment names sort in commit order
+  std::sort(segments.begin(), segments.end());
+
+  // fetch the segments concurrently and decode them in order
+  std::vector<std::vector<uint8_t>> buffers(segments.size());
+  std::vector<std::future<galois::Result<void>>> fetches;
+  for (size_t i = 0; i < segments.size(); ++i) {
+    buffers[i].resize(segments[i].second);
+    fetches.emplace_back(tsuba::FileGetAsync(
+        uri.Join(segments[i].first).string(), buffers[i].data(), 0,
+        buffers[i].size()));
+  }
+
+  OpLog log;
+  log.uri_ = uri;
+  constexpr uint64_t kHeaderSize = 2 * sizeof(uint64_t);
+  for (size_t i = 0; i < segments.size(); ++i) {
+    if (auto res = fetches[i].get(); !res) {
+      return res.error();
+    }
+    const std::vector<uint8_t>& buffer = buffers[i];
+    uint64_t header[2] = {0, 0};
+    if (buffer.size() >= kHeaderSize) {
+      std::memcpy(header, buffer.data(), kHeaderSize);
+    }
+    if (header[0] != kSegmentMagic || header[1] != kSegmentVersion) {
+      GALOIS_LOG_DEBUG(
+          "{} is not an operation log segment", segments[i].first);
+      return ErrorCode::InvalidArgument;
+    }
+    uint64_t begin = log.records_.size();
+    log.records_.insert(
+        log.records_.end(), buffer.begin() + kHeaderSize, buffer.end());
+    if (auto res = log.Decode(
+            log.records_.data() + begin,
+            log.records_.data() + log.records_.size());
+        !res) {
+      GALOIS_LOG_DEBUG("{} is corrupt", segments[i].first);
+      return res.error();
+    }
+  }
+  // later commits continue after the last segment
+  if (!segments.empty()) {
+    std::string last = segments.back().first.substr(kSegmentPrefix.size());
+    log.num_segments_ = std::stoull(last) + 1;
+  }
+  log.committed_size_ = log.records_.size();
+  return galois::Result<OpLog>(std::move(log));
+}
 
 galois::Operation
 galois::OpLog::GetOp(uint64_t index) const {
-  if (index >= log_.size()) {
+  if (index >= offsets_.size()) {
     GALOIS_LOG_WARN(
-        "Log index {} >= {}, which is log size", index, log_.size());
+        "Log index {} >= {}, which is log size", index, offsets_.size());
+    return Operation(OpTypes::kInvalid, PropertyKey("", kUnsupported, false));
   }
-  return log_[index];
+  // skip the kind byte
+  Reader r(
+      records_.data() + offsets_[index] + 1,
+      records_.data() + records_.size());
+  std::optional<Operation> op = GetOperation(&r, keys_);
+  GALOIS_LOG_ASSERT(op);
+  return std::move(op.value());
 }
 
 uint64_t
 galois::OpLog::AppendOp(const Operation& op) {
-  auto sz = log_.size();
-  log_.emplace_back(op);
+  PropertyKey key = op.key();
+  uint32_t key_number = KeyNumber(key);
+
+  auto sz = offsets_.size();
+  offsets_.emplace_back(records_.size());
+  records_.emplace_back(kOpRecord);
+  records_.emplace_back(static_cast<uint8_t>(op.opcode()));
+  PutVarint(&records_, key_number);
+  if (IsPlainNumber(key.id)) {
+    records_.emplace_back(0);
+    PutVarint(&records_, std::stoull(key.id));
+  } else {
+    records_.emplace_back(1);
+    PutString(&records_, key.id);
+  }
+  if (IsValueOp(op.opcode())) {
+    ImportData data = op.data();
+    records_.emplace_back(static_cast<uint8_t>(data.type));
+    records_.emplace_back(data.is_list);
+    records_.emplace_back(data.value.index());
+    std::visit(
+        [&](const auto& v) {
+          Codec<std::decay_t<decltype(v)>>::Put(&records_, v);
+        },
+        data.value);
+  }
   return sz;
 }
 
 uint64_t
 galois::OpLog::size() const {
-  return log_.size();
+  return offsets_.size();
 }
 
-void
+galois::Result<void>
 galois::OpLog::Clear() {
-  log_.clear();
+  if (!uri_.empty() && num_segments_ > 0) {
+    std::unordered_set<std::string> names;
+    for (uint64_t i = 0; i < num_segments_; ++i) {
+      names.emplace(SegmentName(i));
+    }
+    if (auto res = tsuba::FileDelete(uri_.string(), names); !res) {
+      return res.error();
+    }
+  }
+  records_.clear();
+  offsets_.clear();
+  keys_.clear();
+  key_numbers_.clear();
+  num_segments_ = 0;
+  committed_size_ = 0;
+  return galois::ResultSuccess();
+}
+
+galois::Result<void>
+galois::OpLog::Commit() {
+  if (uri_.empty()) {
+    GALOIS_LOG_DEBUG("log is not persistent");
+    return ErrorCode::InvalidArgument;
+  }
+  if (!HasUncommitted()) {
+    return galois::ResultSuccess();
+  }
+  std::vector<uint8_t> segment;
+  PutFixed(&segment, kSegmentMagic);
+  PutFixed(&segment, kSegmentVersion);
+  segment.insert(
+      segment.end(), records_.begin() + committed_size_, records_.end());
+  if (auto res = tsuba::FileStore(
+          uri_.Join(SegmentName(num_segments_)).string(), segment.data(),
+          segment.size());
+      !res) {
+    return res.error();
+  }
+  ++num_segments_;
+  committed_size_ = records_.size();
+  return galois::ResultSuccess();
+}
+
+namespace {
+
+using Updates = galois::GraphUpdate::Updates;
+using NamedUpdates = std::unordered_map<std::string, Updates>;
+
+/// Play the operation at index into updates, keeping the last operation on
+/// each node or edge
+void
+PlayOp(NamedUpdates* updates, const galois::Operation& op, uint64_t index) {
+  uint64_t& last = (*updates)[op.key().name][op.id()];
+  last = std::max(last, index);
+}
+
+/// Merge the updates of each thread into update, with property numbers in
+/// name order
+template <typename RegisterFn, typename UpdatesFn>
+void
+MergeThreadUpdates(
+    galois::substrate::PerThreadStorage<NamedUpdates>* thread_updates,
+    RegisterFn register_fn, UpdatesFn updates_fn) {
+  std::vector<std::string> names;
+  for (unsigned t = 0; t < thread_updates->size(); ++t) {
+    for (const auto& [name, _] : *thread_updates->getRemote(t)) {
+      names.emplace_back(name);
+    }
+  }
+  std::sort(names.begin(), names.end());
+  names.erase(std::unique(names.begin(), names.end()), names.end());
+  std::vector<uint32_t> pnums;
+  for (const std::string& name : names) {
+    pnums.emplace_back(register_fn(name));
+  }
+
+  galois::do_all(
+      galois::iterate(size_t{0}, names.size()),
+      [&](size_t i) {
+        Updates* merged = updates_fn(pnums[i]);
+        for (unsigned t = 0; t < thread_updates->size(); ++t) {
+          NamedUpdates& local = *thread_updates->getRemote(t);
+          auto it = local.find(names[i]);
+          if (it == local.end()) {
+            continue;
+          }
+          for (const auto& [index, op_log_index] : it->second) {
+            uint64_t& last = (*merged)[index];
+            last = std::max(last, op_log_index);
+          }
+        }
+      },
+      galois::steal(), galois::no_stats());
+}
+
+/// The type of an added property, as PropertyGraphBuilder makes it
+std::shared_ptr<arrow::DataType>
+ArrowType(const galois::ImportData& data) {
+  if (data.is_list) {
+    return nullptr;
+  }
+  switch (data.type) {
+  case galois::ImportDataType::kString:
+    return arrow::utf8();
+  case galois::ImportDataType::kInt64:
+    return arrow::int64();
+  case galois::ImportDataType::kInt32:
+    return arrow::int32();
+  case galois::ImportDataType::kDouble:
+    return arrow::float64();
+  case galois::ImportDataType::kFloat:
+    return arrow::float32();
+  case galois::ImportDataType::kBoolean:
+    return arrow::boolean();
+  case galois::ImportDataType::kTimestampMilli:
+    return arrow::timestamp(arrow::TimeUnit::MILLI, "UTC");
+  case galois::ImportDataType::kStruct:
+    return arrow::uint8();
+  default:
+    return nullptr;
+  }
+}
+
+template <typename Builder, typename T>
+arrow::Status
+AppendAs(arrow::ArrayBuilder* builder, const Value& value) {
+  const T* v = std::get_if<T>(&value);
+  if (!v) {
+    return arrow::Status::TypeError("value does not have the property type");
+  }
+  return static_cast<Builder*>(builder)->Append(*v);
 }
 
-galois::OpLog::OpLog(const galois::Uri& uri) {
-  GALOIS_LOG_FATAL("Persistent log not yet implemented: {}", uri);
+arrow::Status
+AppendValue(arrow::ArrayBuilder* builder, const Value& value) {
+  switch (builder->type()->id()) {
+  case arrow::Type::STRING:
+    return AppendAs<arrow::StringBuilder, std::string>(builder, value);
+  case arrow::Type::INT64:
+    return AppendAs<arrow::Int64Builder, int64_t>(builder, value);
+  case arrow::Type::INT32:
+    return AppendAs<arrow::Int32Builder, int32_t>(builder, value);
+  case arrow::Type::DOUBLE:
+    return AppendAs<arrow::DoubleBuilder, double>(builder, value);
+  case arrow::Type::FLOAT:
+    return AppendAs<arrow::FloatBuilder, float>(builder, value);
+  case arrow::Type::BOOL:
+    return AppendAs<arrow::BooleanBuilder, bool>(builder, value);
+  case arrow::Type::TIMESTAMP:
+    return AppendAs<arrow::TimestampBuilder, int64_t>(builder, value);
+  case arrow::Type::UINT8:
+    return AppendAs<arrow::UInt8Builder, uint8_t>(builder, value);
+  default:
+    return arrow::Status::NotImplemented("list values");
+  }
+}
+
+galois::ErrorCode
+FromArrowStatus(const arrow::Status& status) {
+  GALOIS_LOG_DEBUG("arrow error: {}", status);
+  if (status.IsTypeError()) {
+    return galois::ErrorCode::TypeError;
+  }
+  if (status.IsNotImplemented()) {
+    return galois::ErrorCode::NotImplemented;
+  }
+  return galois::ErrorCode::ArrowError;
+}
+
+/// MergeProperty returns the values of existing, or nulls of the type of
+/// the first value if it is null, with updates applied
+galois::Result<std::shared_ptr<arrow::ChunkedArray>>
+MergeProperty(
+    const galois::OpLog& log, const Updates& updates, uint64_t num,
+    std::shared_ptr<arrow::ChunkedArray> existing) {
+  // positions in order so that the result does not depend on hashing
+  std::vector<std::pair<uint64_t, uint64_t>> sorted(
+      updates.begin(), updates.end());
+  std::sort(sorted.begin(), sorted.end());
+
+  std::vector<galois::Operation> ops;
+  for (const auto& [index, op_log_index] : sorted) {
+    ops.emplace_back(log.GetOp(op_log_index));
+  }
+  std::shared_ptr<arrow::DataType> type;
+  if (existing) {
+    type = existing->type();
+  } else {
+    for (const galois::Operation& op : ops) {
+      if (IsValueOp(op.opcode())) {
+        type = ArrowType(op.data());
+        if (!type) {
+          return galois::ErrorCode::NotImplemented;
+        }
+        break;
+      }
+    }
+    if (!type) {
+      // only deletions of a property that is not there
+      return nullptr;
+    }
+  }
+
+  std::unique_ptr<arrow::ArrayBuilder> builder;
+  arrow::MemoryPool* pool = tsuba::GetArrowMemoryPool();
+  if (auto st = arrow::MakeBuilder(pool, type, &builder); !st.ok()) {
+    return FromArrowStatus(st);
+  }
+  for (const galois::Operation& op : ops) {
+    arrow::Status st = IsValueOp(op.opcode())
+                           ? AppendValue(builder.get(), op.data().value)
+                           : builder->AppendNull();
+    if (!st.ok()) {
+      return FromArrowStatus(st);
+    }
+  }
+  std::shared_ptr<arrow::Array> values;
+  if (auto st = builder->Finish(&values); !st.ok()) {
+    return FromArrowStatus(st);
+  }
+
+  arrow::ArrayVector chunks;
+  if (existing) {
+    chunks = existing->chunks();
+  } else {
+    auto nulls_result = arrow::MakeArrayOfNull(type, num);
+    if (!nulls_result.ok()) {
+      return FromArrowStatus(nulls_result.status());
+    }
+    chunks.emplace_back(nulls_result.ValueOrDie());
+  }
+  chunks.emplace_back(values);
+  auto concat_result = arrow::Concatenate(chunks, pool);
+  if (!concat_result.ok()) {
+    return FromArrowStatus(concat_result.status());
+  }
+
+  // take each value from where it is, or from values if it was updated
+  auto take_buffer_result = arrow::AllocateBuffer(num * sizeof(uint64_t), pool);
+  if (!take_buffer_result.ok()) {
+    return FromArrowStatus(take_buffer_result.status());
+  }
+  std::shared_ptr<arrow::Buffer> take_buffer =
+      std::move(take_buffer_result.ValueOrDie());
+  auto* take = reinterpret_cast<uint64_t*>(take_buffer->mutable_data());
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num), [&](uint64_t i) { take[i] = i; },
+      galois::no_stats());
+  galois::do_all(
+      galois::iterate(size_t{0}, sorted.size()),
+      [&](size_t k) { take[sorted[k].first] = num + k; }, galois::no_stats());
+  auto take_result = arrow::compute::Take(
+      arrow::Datum(concat_result.ValueOrDie()),
+      arrow::Datum(std::make_shared<arrow::UInt64Array>(num, take_buffer)));
+  if (!take_result.ok()) {
+    return FromArrowStatus(take_result.status());
+  }
+  return std::make_shared<arrow::ChunkedArray>(
+      take_result.ValueOrDie().make_array());
+}
+
+/// MergeProperties merges the updates of each property into the table of
+/// pfg that view refers to, replacing the columns of properties it has and
+/// adding the others
+template <typename Names, typename UpdatesOf>
+galois::Result<void>
+MergeProperties(
+    const galois::OpLog& log, uint32_t num_props, uint64_t num,
+    const galois::graphs::PropertyFileGraph::PropertyView& view,
+    Names names_fn, UpdatesOf updates_fn,
+    galois::Result<void> (galois::graphs::PropertyFileGraph::*replace_fn)(
+        const std::shared_ptr<arrow::Table>&)) {
+  std::shared_ptr<arrow::Schema> schema = view.schema();
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns =
+      view.Properties();
+  bool replaced = false;
+  std::vector<std::shared_ptr<arrow::Field>> new_fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> new_columns;
+
+  for (uint32_t pnum = 0; pnum < num_props; ++pnum) {
+    std::string name = names_fn(pnum);
+    int i = schema->GetFieldIndex(name);
+    auto merge_result = MergeProperty(
+        log, updates_fn(pnum), num, i < 0 ? nullptr : columns[i]);
+    if (!merge_result) {
+      return merge_result.error();
+    }
+    std::shared_ptr<arrow::ChunkedArray> merged = merge_result.value();
+    if (!merged) {
+      continue;
+    }
+    if (i < 0) {
+      new_fields.emplace_back(arrow::field(name, merged->type()));
+      new_columns.emplace_back(merged);
+    } else {
+      columns[i] = merged;
+      replaced = true;
+    }
+  }
+
+  if (replaced) {
+    if (auto res = (view.g->*replace_fn)(arrow::Table::Make(schema, columns));
+        !res) {
+      return res.error();
+    }
+  }
+  if (!new_fields.empty()) {
+    return view.AddProperties(
+        arrow::Table::Make(arrow::schema(new_fields), new_columns));
+  }
+  return galois::ResultSuccess();
+}
+
+}  // namespace
+
+galois::Result<galois::GraphUpdate>
+galois::GraphUpdate::Make(
+    const OpLog& log, uint64_t num_nodes, uint64_t num_edges) {
+  galois::substrate::PerThreadStorage<NamedUpdates> node_updates;
+  galois::substrate::PerThreadStorage<NamedUpdates> edge_updates;
+  std::atomic<bool> changes_topology{false};
+  galois::do_all(
+      galois::iterate(uint64_t{0}, log.size()),
+      [&](uint64_t i) {
+        Operation op = log.GetOp(i);
+        switch (op.opcode()) {
+        case OpTypes::kOpNodePropVal:
+        case OpTypes::kOpNodePropDel:
+          if (op.id() < num_nodes) {
+            PlayOp(node_updates.getLocal(), op, i);
+          }
+          break;
+        case OpTypes::kOpEdgePropVal:
+        case OpTypes::kOpEdgePropDel:
+          if (op.id() < num_edges) {
+            PlayOp(edge_updates.getLocal(), op, i);
+          }
+          break;
+        case OpTypes::kOpNodeAdd:
+        case OpTypes::kOpNodeDel:
+        case OpTypes::kOpEdgeAdd:
+        case OpTypes::kOpEdgeDel:
+          changes_topology = true;
+          break;
+        default:
+          break;
+        }
+      },
+      galois::steal(), galois::no_stats(), galois::loopname("PlayOpLog"));
+  if (changes_topology) {
+    GALOIS_LOG_DEBUG("playing topology operations is not implemented");
+    return ErrorCode::NotImplemented;
+  }
+
+  GraphUpdate update(num_nodes, num_edges);
+  MergeThreadUpdates(
+      &node_updates,
+      [&](const std::string& name) { return update.RegisterNodeProp(name); },
+      [&](uint32_t pnum) { return &update.nprop_[pnum]; });
+  MergeThreadUpdates(
+      &edge_updates,
+      [&](const std::string& name) { return update.RegisterEdgeProp(name); },
+      [&](uint32_t pnum) { return &update.eprop_[pnum]; });
+  return galois::Result<GraphUpdate>(std::move(update));
+}
+
+galois::Result<void>
+galois::GraphUpdate::MergeInto(
+    const OpLog& log, galois::graphs::PropertyFileGraph* pfg) const {
+  if (pfg->topology().num_nodes() != num_nodes_ ||
+      pfg->topology().num_edges() != num_edges_) {
+    return ErrorCode::InvalidArgument;
+  }
+  if (auto res = MergeProperties(
+          log, num_nprop(), num_nodes_, pfg->node_property_view(),
+          [&](uint32_t pnum) { return nprop_names_[pnum]; },
+          [&](uint32_t pnum) -> const Updates& { return nprop_[pnum]; },
+          &galois::graphs::PropertyFileGraph::ReplaceNodeProperties);
+      !res) {
+    return res.error();
+  }
+  return MergeProperties(
+      log, num_eprop(), num_edges_, pfg->edge_property_view(),
+      [&](uint32_t pnum) { return eprop_names_[pnum]; },
+      [&](uint32_t pnum) -> const Updates& { return eprop_[pnum]; },
+      &galois::graphs::PropertyFileGraph::ReplaceEdgeProperties);
 }
@@ -19,8 +19,16 @@
 
 #include "galois/substrate/PageAlloc.h"
 
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <map>
 #include <mutex>
+#include <string>
+#include <vector>
 
+#include "galois/Env.h"
 #include "galois/Logging.h"
 #include "galois/substrate/SimpleLock.h"
 
@@ -70,6 +78,121 @@ static const int _MAP_HUGE_POP = _MAP_POP;
 static const int _MAP_HUGE = _MAP;
 #endif
 
+namespace {
+
+/// Which kinds of huge pages allocPages tries, set by GALOIS_HUGE_PAGES
+enum class HugePageMode {
+  /// hugetlbfs pages, then transparent huge pages
+  kAuto,
+  /// hugetlbfs pages, then regular pages
+  kHugeTLB,
+  /// transparent huge pages only
+  kTHP,
+  /// regular pages only
+  kNone,
+};
+
+enum class Backing { kHugeTLB, kTHP, kSmall };
+
+struct Region {
+  unsigned num;
+  Backing backing;
+};
+
+HugePageMode
+GetHugePageMode() {
+  static HugePageMode mode = [] {
+    std::string value;
+    if (!galois::GetEnv("GALOIS_HUGE_PAGES", &value) || value == "auto") {
+      return HugePageMode::kAuto;
+    }
+    if (value == "hugetlb") {
+      return HugePageMode::kHugeTLB;
+    }
+    if (value == "thp") {
+      return HugePageMode::kTHP;
+    }
+    if (value == "none") {
+      return HugePageMode::kNone;
+    }
+    GALOIS_LOG_WARN("unknown GALOIS_HUGE_PAGES value {}, using auto", value);
+    return HugePageMode::kAuto;
+  }();
+  return mode;
+}
+
+/// The live allocations of allocPages by address, guarded by allocLock.
+/// Never destroyed, since pages may be freed during static destruction.
+std::map<uintptr_t, Region>&
+Regions() {
+  static auto* regions = new std::map<uintptr_t, Region>;
+  return *regions;
+}
+
+/// Maps size bytes aligned to hugePageSize and asks the kernel to back them
+/// with transparent huge pages. The mapping is not populated, since faulting
+/// it in before madvise would back it with regular pages.
+///
+/// \param[out] backing kTHP, or kSmall if the kernel refused the advice
+void*
+TryTHPMap(size_t size, Backing* backing) {
+  // the kernel only uses huge pages for aligned 2MB ranges, so map an extra
+  // page and trim an aligned range out of it
+  char* raw = static_cast<char*>(trymmap(size + hugePageSize, _MAP));
+  if (!raw) {
+    return nullptr;
+  }
+  uintptr_t addr = reinterpret_cast<uintptr_t>(raw);
+  uintptr_t aligned = (addr + hugePageSize - 1) & ~(hugePageSize - 1);
+  size_t head = aligned - addr;
+  size_t tail = hugePageSize - head;
+  char* ptr = reinterpret_cast<char*>(aligned);
+
+  std::lock_guard<galois::substrate::SimpleLock> lg(allocLock);
+  if ((head && munmap(raw, head) != 0) ||
+      (tail && munmap(ptr + size, tail) != 0)) {
+    GALOIS_LOG_FATAL("munmap failed: {}", errno);
+  }
+  *backing = Backing::kSmall;
+#ifdef MADV_HUGEPAGE
+  if (madvise(ptr, size, MADV_HUGEPAGE) == 0) {
+    *backing = Backing::kTHP;
+  }
+#endif
+  return ptr;
+}
+
+/// Bytes of the mappings containing ranges that the kernel backs with
+/// transparent huge pages, from the AnonHugePages of /proc/self/smaps
+size_t
+THPBackedBytes(const std::vector<std::pair<uintptr_t, uintptr_t>>& ranges) {
+  std::ifstream smaps("/proc/self/smaps");
+  size_t bytes = 0;
+  bool overlaps = false;
+  std::string line;
+  while (std::getline(smaps, line)) {
+    uintptr_t start;
+    uintptr_t end;
+    size_t kb;
+    if (sscanf(line.c_str(), "%" SCNxPTR "-%" SCNxPTR, &start, &end) == 2) {
+      // the header of a mapping
+      overlaps = false;
+      for (const auto& [range_start, range_end] : ranges) {
+        if (range_start < end && start < range_end) {
+          overlaps = true;
+          break;
+        }
+      }
+    } else if (
+        overlaps && sscanf(line.c_str(), "AnonHugePages: %zu kB", &kb) == 1) {
+      bytes += kb * 1024;
+    }
+  }
+  return bytes;
+}
+
+}  // namespace
+
 size_t
 galois::substrate::allocSize() {
   return hugePageSize;
@@ -81,24 +204,51 @@ galois::substrate::allocPages(unsigned num, bool preFault) {
     return nullptr;
   }
 
-  void* ptr = trymmap(num * hugePageSize, preFault ? _MAP_HUGE_POP : _MAP_HUGE);
+  HugePageMode mode = GetHugePageMode();
+  size_t size = num * hugePageSize;
+  void* ptr = nullptr;
+  Backing backing = Backing::kSmall;
+  // whether mmap faulted the pages in
+  bool populated = !doHandMap;
+
+  if (mode == HugePageMode::kAuto || mode == HugePageMode::kHugeTLB) {
+    ptr = trymmap(size, preFault ? _MAP_HUGE_POP : _MAP_HUGE);
+    backing = Backing::kHugeTLB;
+  }
+  if (!ptr && (mode == HugePageMode::kAuto || mode == HugePageMode::kTHP)) {
+#ifndef NDEBUG
+    if (mode == HugePageMode::kAuto) {
+      GALOIS_WARN_ONCE(
+          "huge page alloc failed, falling back to transparent huge pages");
+    }
+#endif
+    ptr = TryTHPMap(size, &backing);
+    populated = false;
+  }
   if (!ptr) {
 #ifndef NDEBUG
-    GALOIS_WARN_ONCE("huge page alloc failed, falling back to regular pages");
+    if (mode == HugePageMode::kHugeTLB) {
+      GALOIS_WARN_ONCE("huge page alloc failed, falling back to regular pages");
+    }
 #endif
-    ptr = trymmap(num * hugePageSize, preFault ? _MAP_POP : _MAP);
+    ptr = trymmap(size, preFault ? _MAP_POP : _MAP);
+    backing = Backing::kSmall;
+    populated = !doHandMap;
   }
 
   if (!ptr) {
     GALOIS_LOG_FATAL("failed to allocate: {}", errno);
   }
 
-  if (preFault && doHandMap) {
-    for (size_t x = 0; x < num * hugePageSize; x += 4096) {
+  if (preFault && !populated) {
+    for (size_t x = 0; x < size; x += 4096) {
       static_cast<char*>(ptr)[x] = 0;
     }
   }
 
+  std::lock_guard<SimpleLock> lg(allocLock);
+  Regions()[reinterpret_cast<uintptr_t>(ptr)] = Region{num, backing};
+
   return ptr;
 }
 
@@ -108,4 +258,34 @@ galois::substrate::freePages(void* ptr, unsigned num) {
   if (munmap(ptr, num * hugePageSize) != 0) {
     GALOIS_LOG_FATAL("munmap failed: {}", errno);
   }
+  Regions().erase(reinterpret_cast<uintptr_t>(ptr));
+}
+
+galois::substrate::PageAllocStats
+galois::substrate::getPageAllocStats() {
+  PageAllocStats stats;
+  std::vector<std::pair<uintptr_t, uintptr_t>> thp_ranges;
+  {
+    std::lock_guard<SimpleLock> lg(allocLock);
+    for (const auto& [addr, region] : Regions()) {
+      switch (region.backing) {
+      case Backing::kHugeTLB:
+        stats.hugetlb_pages += region.num;
+        break;
+      case Backing::kTHP:
+        stats.thp_pages += region.num;
+        thp_ranges.emplace_back(addr, addr + region.num * hugePageSize);
+        break;
+      case Backing::kSmall:
+        stats.small_pages += region.num;
+        break;
+      }
+    }
+  }
+  if (!thp_ranges.empty()) {
+    // mappings may extend past the ranges, so cap at what was advised
+    stats.thp_backed_pages = std::min(
+        THPBackedBytes(thp_ranges) / hugePageSize, stats.thp_pages);
+  }
+  return stats;
 }
@@ -17,9 +17,14 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <algorithm>
 #include <ctime>
+#include <fstream>
 
 #include "galois/Env.h"
+#include "galois/JSON.h"
+#include "galois/Logging.h"
+#include "galois/Threads.h"
 #include "galois/gIO.h"
 #include "galois/runtime/Executor_ParaMeter.h"
 
@@ -81,8 +86,32 @@ struct StatsFileManager {
       statsFH = nullptr;
     }
   }
+
+  /// GALOIS_PARAMETER_JSON, or the name of the CSV file with a .json
+  /// extension
+  std::string jsonFileName() {
+    std::string name;
+    if (galois::GetEnv("GALOIS_PARAMETER_JSON", &name)) {
+      return name;
+    }
+    name = statsFileName;
+    const std::string csv = ".csv";
+    if (name.size() >= csv.size() &&
+        name.compare(name.size() - csv.size(), csv.size(), csv) == 0) {
+      name.resize(name.size() - csv.size());
+    }
+    return name + ".json";
+  }
 };
 
+/// The profiles of all the ParaMeter loops of the run, rewritten to the JSON
+/// file after each loop so that the file is complete even if the run is not
+static nlohmann::json&
+getLoopProfiles() {
+  static nlohmann::json loops = nlohmann::json::array();
+  return loops;
+}
+
 static StatsFileManager&
 getStatsFileManager(void) {
   static StatsFileManager s;
@@ -98,3 +127,69 @@ void
 galois::runtime::ParaMeter::closeStatsFile(void) {
   getStatsFileManager().close();
 }
+
+size_t
+galois::runtime::ParaMeter::LoopProfile::Work() const {
+  size_t work = 0;
+  for (const StepProfile& step : steps_) {
+    work += step.parallelism;
+  }
+  return work;
+}
+
+void
+galois::runtime::ParaMeter::LoopProfile::Write() const {
+  size_t work = 0;
+  size_t ran = 0;
+  size_t neighborhood = 0;
+  size_t conflicts = 0;
+  size_t max_parallelism = 0;
+  nlohmann::json steps = nlohmann::json::array();
+  for (const StepProfile& step : steps_) {
+    work += step.parallelism;
+    ran += step.wl_size;
+    neighborhood += step.nh_size;
+    conflicts += step.conflicts;
+    max_parallelism = std::max(max_parallelism, step.parallelism);
+    steps.push_back({
+        {"step", step.step},
+        {"parallelism", step.parallelism},
+        {"worklist_size", step.wl_size},
+        {"neighborhood_size", step.nh_size},
+        {"conflicts", step.conflicts},
+    });
+  }
+
+  auto ratio = [](size_t num, size_t den) {
+    return den == 0 ? 0.0 : static_cast<double>(num) / den;
+  };
+
+  nlohmann::json loop = {
+      {"loopname", loopname_},
+      {"schedule", schedule_},
+      {"threads", galois::getActiveThreads()},
+      {"critical_path", CriticalPath()},
+      {"work", work},
+      {"average_parallelism", ratio(work, CriticalPath())},
+      {"max_parallelism", max_parallelism},
+      {"conflicts", conflicts},
+      {"conflict_rate", ratio(conflicts, ran)},
+      {"average_neighborhood_size", ratio(neighborhood, work)},
+      {"steps", std::move(steps)},
+  };
+  nlohmann::json& loops = getLoopProfiles();
+  loops.push_back(std::move(loop));
+
+  auto dumped = galois::JsonDump(nlohmann::json{{"loops", loops}});
+  if (!dumped) {
+    GALOIS_LOG_ERROR("ParaMeter profile: {}", dumped.error());
+    return;
+  }
+
+  std::string path = getStatsFileManager().jsonFileName();
+  std::ofstream out(path);
+  out << dumped.value() << "\n";
+  if (!out) {
+    GALOIS_LOG_ERROR("cannot write ParaMeter profile to {}", path);
+  }
+}
@@ -19,12 +19,22 @@
 
 #include "galois/substrate/PerThreadStorage.h"
 
+#include <sys/mman.h>
+
+#include <algorithm>
 #include <atomic>
+#include <iterator>
 #include <mutex>
+#include <vector>
 
 #include "galois/gIO.h"
+#include "galois/substrate/HWTopo.h"
 #include "galois/substrate/PageAlloc.h"
 
+#ifdef GALOIS_USE_NUMA
+#include <numaif.h>
+#endif
+
 GALOIS_EXPORT thread_local char* galois::substrate::ptsBase;
 
 galois::substrate::PerBackend&
@@ -41,114 +51,191 @@ galois::substrate::getPPSBackend() {
   return b;
 }
 
-const size_t ptAllocSize = galois::substrate::allocSize();
-inline void*
-alloc() {
-  // alloc a single page, don't prefault
-  void* toReturn = galois::substrate::allocPages(1, true);
-  if (toReturn == nullptr) {
-    GALOIS_DIE("per-thread storage out of memory");
-  }
-  return toReturn;
-}
+namespace {
+
+// Regions are committed and released in chunks of this many bytes
+const size_t kChunkSize = galois::substrate::allocSize();
+
+// The address space each region reserves
+constexpr size_t kMaxChunks = 512;
 
-constexpr unsigned MAX_SIZE = 30;
 // PerBackend storage is typically cache-aligned. Simplify bookkeeping at the
 // expense of fragmentation by restricting all allocations to be cache-aligned.
-constexpr unsigned MIN_SIZE = 7;
-
-static_assert((1 << MIN_SIZE) == galois::substrate::GALOIS_CACHE_LINE_SIZE);
+constexpr size_t kAlign = galois::substrate::GALOIS_CACHE_LINE_SIZE;
 
-galois::substrate::PerBackend::PerBackend() { freeOffsets.resize(MAX_SIZE); }
+size_t
+RoundUp(size_t size, size_t multiple) {
+  return (size + multiple - 1) / multiple * multiple;
+}
 
 unsigned
-galois::substrate::PerBackend::nextLog2(unsigned size) {
-  unsigned i = MIN_SIZE;
-  while ((1U << i) < size) {
-    ++i;
+AlignedSize(unsigned size) {
+  return RoundUp(std::max(size, 1U), kAlign);
+}
+
+// Regions are created before the threads that own them run, so rather than
+// having owners fault their regions in, ask for memory on their node
+void
+PreferNode([[maybe_unused]] char* base, [[maybe_unused]] unsigned node) {
+#ifdef GALOIS_USE_NUMA
+  unsigned long mask = 0;
+  if (node >= sizeof(mask) * 8) {
+    return;
+  }
+  mask = 1UL << node;
+  // placement is only a preference, so failing to set it is not an error
+  (void)mbind(
+      base, galois::substrate::PerBackend::maxSize(), MPOL_PREFERRED, &mask,
+      sizeof(mask) * 8, 0);
+#endif
+}
+
+}  // namespace
+
+size_t
+galois::substrate::PerBackend::maxSize() {
+  return kMaxChunks * kChunkSize;
+}
+
+char*
+galois::substrate::PerBackend::newRegion(unsigned node) {
+  // Reserve the address space of the region without committing it
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+  void* region = mmap(nullptr, maxSize(), PROT_NONE, flags, -1, 0);
+  if (region == MAP_FAILED) {
+    GALOIS_DIE("per-thread storage out of address space");
   }
-  if (i >= MAX_SIZE) {
-    abort();
+  auto* base = static_cast<char*>(region);
+  PreferNode(base, node);
+
+  std::lock_guard<Lock> llock(lock);
+  if (committed == 0) {
+    committed = kChunkSize;
+  }
+  if (mprotect(base, committed, PROT_READ | PROT_WRITE) != 0) {
+    GALOIS_DIE("per-thread storage out of memory");
   }
-  return i;
+  regions.push_back(base);
+  return base;
 }
 
-unsigned
-galois::substrate::PerBackend::allocOffset(const unsigned sz) {
-  unsigned ll = nextLog2(sz);
-  unsigned size = (1 << ll);
-
-  if (nextLoc.load(std::memory_order_relaxed) + size <= ptAllocSize) {
-    // simple path, where we allocate bump ptr style
-    unsigned offset = nextLoc.fetch_add(size);
-    if (offset + size <= ptAllocSize) {
-      return offset;
+void
+galois::substrate::PerBackend::commit(size_t size) {
+  size_t target = RoundUp(size, kChunkSize);
+  if (target > maxSize()) {
+    GALOIS_DIE("per-thread storage out of memory");
+  }
+  for (char* region : regions) {
+    if (mprotect(
+            region + committed, target - committed, PROT_READ | PROT_WRITE) !=
+        0) {
+      GALOIS_DIE("per-thread storage out of memory");
+    }
+  }
+  committed = target;
+}
+
+void
+galois::substrate::PerBackend::release(size_t size) {
+  // The first chunk of each region stays committed
+  size_t target = std::max(RoundUp(size, kChunkSize), kChunkSize);
+  if (target >= committed) {
+    return;
+  }
+  for (char* region : regions) {
+    // Dropping the pages keeps the placement of the range, and a later
+    // commit sees it zeroed again
+    if (madvise(region + target, committed - target, MADV_DONTNEED) != 0 ||
+        mprotect(region + target, committed - target, PROT_NONE) != 0) {
+      GALOIS_DIE("per-thread storage: releasing memory failed");
     }
   }
+  committed = target;
+}
 
+unsigned
+galois::substrate::PerBackend::allocOffset(const unsigned sz) {
   if (invalid) {
     GALOIS_DIE("allocating after delete");
-    return ptAllocSize;
   }
+  unsigned size = AlignedSize(sz);
 
-  // find a free offset
-  std::lock_guard<Lock> llock(freeOffsetsLock);
+  std::lock_guard<Lock> llock(lock);
+  allocated += size;
 
-  unsigned index = ll;
-  if (!freeOffsets[index].empty()) {
-    unsigned offset = freeOffsets[index].back();
-    freeOffsets[index].pop_back();
+  // first fit among the free ranges
+  for (auto it = freeRanges.begin(); it != freeRanges.end(); ++it) {
+    if (it->second < size) {
+      continue;
+    }
+    unsigned offset = it->first;
+    unsigned remaining = it->second - size;
+    freeRanges.erase(it);
+    if (remaining > 0) {
+      freeRanges.emplace(offset + size, remaining);
+    }
     return offset;
   }
 
-  // find a bigger size
-  for (; (index < MAX_SIZE) && (freeOffsets[index].empty()); ++index)
-    ;
-
-  if (index == MAX_SIZE) {
+  // otherwise bump the top of the offsets in use, growing the regions
+  if (end + size_t{size} > maxSize()) {
     GALOIS_DIE("per-thread storage out of memory");
-    return ptAllocSize;
   }
-
-  // Found a bigger free offset. Use the first piece equal to required
-  // size and produce vending machine change for the rest.
-  assert(!freeOffsets[index].empty());
-  unsigned offset = freeOffsets[index].back();
-  freeOffsets[index].pop_back();
-
-  // remaining chunk
-  unsigned end = offset + (1 << index);
-  unsigned start = offset + size;
-  for (unsigned i = index - 1; start < end; --i) {
-    freeOffsets[i].push_back(start);
-    start += (1 << i);
+  unsigned offset = end;
+  end += size;
+  if (end > committed) {
+    commit(end);
   }
-
-  assert(offset != ptAllocSize);
-
   return offset;
 }
 
 void
 galois::substrate::PerBackend::deallocOffset(
     const unsigned offset, const unsigned sz) {
-  unsigned ll = nextLog2(sz);
-  unsigned size = (1 << ll);
-  unsigned expected = offset + size;
-
-  if (nextLoc.compare_exchange_strong(expected, offset)) {
-    // allocation was at the end, so recovered some memory
+  if (invalid) {
+    // the process is exiting; the regions were leaked on purpose
     return;
   }
+  unsigned size = AlignedSize(sz);
+
+  std::lock_guard<Lock> llock(lock);
+  allocated -= size;
+
+  // coalesce with the free neighbors
+  unsigned begin = offset;
+  unsigned stop = offset + size;
+  auto next = freeRanges.lower_bound(offset);
+  if (next != freeRanges.end() && next->first == stop) {
+    stop += next->second;
+    next = freeRanges.erase(next);
+  }
+  if (next != freeRanges.begin()) {
+    auto prev = std::prev(next);
+    if (prev->first + prev->second == begin) {
+      begin = prev->first;
+      freeRanges.erase(prev);
+    }
+  }
 
-  if (invalid) {
-    GALOIS_DIE("deallocing after delete");
-    return;
+  if (stop == end) {
+    // the top of the offsets in use drops, and the memory above it goes
+    end = begin;
+    release(end);
+  } else {
+    freeRanges.emplace(begin, stop - begin);
   }
+}
+
+size_t
+galois::substrate::PerBackend::allocatedBytes() {
+  std::lock_guard<Lock> llock(lock);
+  return allocated;
+}
 
-  // allocation not at the end
-  std::lock_guard<Lock> llock(freeOffsetsLock);
-  freeOffsets[ll].push_back(offset);
+size_t
+galois::substrate::PerBackend::committedBytes() {
+  std::lock_guard<Lock> llock(lock);
+  return committed;
 }
 
 void*
@@ -159,48 +246,51 @@ galois::substrate::PerBackend::getRemote(unsigned thread, unsigned offset) {
 }
 
 void
-galois::substrate::PerBackend::initCommon(unsigned maxT) {
-  if (!heads) {
-    assert(ThreadPool::getTID() == 0);
-    heads = new std::atomic<char*>[maxT] {};
+galois::substrate::PerBackend::initCommon(unsigned maxT, bool perSocket) {
+  if (heads) {
+    return;
+  }
+  // Threads start lazily, so thread 0 creates the regions of every thread
+  // before any storage is allocated
+  assert(ThreadPool::getTID() == 0);
+  std::vector<ThreadTopoInfo> topo = getHWTopo().threadTopoInfo;
+  heads = new std::atomic<char*>[maxT] {};
+  for (unsigned i = 0; i < maxT; ++i) {
+    unsigned leader = topo[i].socketLeader;
+    if (perSocket && leader != i) {
+      heads[i] = heads[leader].load();
+    } else {
+      heads[i] = newRegion(topo[i].osNumaNode);
+    }
   }
 }
 
 char*
 galois::substrate::PerBackend::initPerThread(unsigned maxT) {
-  initCommon(maxT);
-  char* b = heads[ThreadPool::getTID()] = (char*)alloc();
-  memset(b, 0, ptAllocSize);
-  return b;
+  initCommon(maxT, false);
+  return heads[ThreadPool::getTID()];
 }
 
 char*
 galois::substrate::PerBackend::initPerSocket(unsigned maxT) {
-  initCommon(maxT);
-  unsigned id = ThreadPool::getTID();
-  unsigned leader = ThreadPool::getLeader();
-  if (id == leader) {
-    char* b = heads[id] = (char*)alloc();
-    memset(b, 0, ptAllocSize);
-    return b;
-  }
-  char* expected = nullptr;
-  // wait for leader to fix up socket
-  while (heads[leader].compare_exchange_weak(expected, nullptr)) {
-    substrate::asmPause();
-  }
-  heads[id] = heads[leader].load();
-  return heads[id];
+  initCommon(maxT, true);
+  return heads[ThreadPool::getTID()];
 }
 
 void
 galois::substrate::initPTS(unsigned maxT) {
   if (!ptsBase) {
     // unguarded initialization as initPTS will run in the master thread
-    // before any other threads are generated
+    // before any other threads are started
     ptsBase = getPTSBackend().initPerThread(maxT);
   }
   if (!pssBase) {
     pssBase = getPPSBackend().initPerSocket(maxT);
   }
 }
+
+void
+galois::substrate::adoptPTS(unsigned tid) {
+  ptsBase = static_cast<char*>(getPTSBackend().getRemote(tid, 0));
+  pssBase = static_cast<char*>(getPPSBackend().getRemote(tid, 0));
+}
@@ -0,0 +1,246 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/runtime/PerfCounters.h"
+
+#include <string>
+#include <string_view>
+
+#include "galois/Env.h"
+#include "galois/Logging.h"
+#include "galois/Statistics.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace {
+
+constexpr const char* kEventNames[galois::runtime::kNumPerfEvents] = {
+    "cycles", "instructions", "llc-misses", "dtlb-misses", "remote-node",
+};
+
+constexpr const char* kStatNames[galois::runtime::kNumPerfEvents] = {
+    "PerfCycles",    "PerfInstructions",        "PerfLLCMisses",
+    "PerfDTLBMisses", "PerfRemoteNodeAccesses",
+};
+
+/// The events that GALOIS_PERF_EVENTS asks for: "all" or a comma-separated
+/// list of event names
+std::array<bool, galois::runtime::kNumPerfEvents>
+ParseRequestedEvents() {
+  std::array<bool, galois::runtime::kNumPerfEvents> requested{};
+  std::string value;
+  if (!galois::GetEnv("GALOIS_PERF_EVENTS", &value) || value.empty()) {
+    return requested;
+  }
+  if (value == "all") {
+    requested.fill(true);
+    return requested;
+  }
+
+  std::string_view rest = value;
+  while (!rest.empty()) {
+    size_t comma = rest.find(',');
+    std::string_view name = rest.substr(0, comma);
+    rest = comma == std::string_view::npos ? std::string_view()
+                                           : rest.substr(comma + 1);
+    bool found = false;
+    for (unsigned i = 0; i < galois::runtime::kNumPerfEvents; ++i) {
+      if (name == kEventNames[i]) {
+        requested[i] = true;
+        found = true;
+      }
+    }
+    if (!found) {
+      GALOIS_LOG_WARN("unknown GALOIS_PERF_EVENTS event {}, ignoring", name);
+    }
+  }
+  return requested;
+}
+
+const std::array<bool, galois::runtime::kNumPerfEvents>&
+RequestedEvents() {
+  static const std::array<bool, galois::runtime::kNumPerfEvents> requested =
+      ParseRequestedEvents();
+  return requested;
+}
+
+#ifdef __linux__
+
+perf_event_attr
+MakeEventAttr(unsigned event) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  // Counting only user code lets threads count themselves under the default
+  // perf_event_paranoid setting
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+
+  auto cache_event = [](uint64_t cache, uint64_t op, uint64_t result) {
+    return cache | (op << 8) | (result << 16);
+  };
+
+  switch (static_cast<galois::runtime::PerfEvent>(event)) {
+  case galois::runtime::PerfEvent::kCycles:
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CPU_CYCLES;
+    break;
+  case galois::runtime::PerfEvent::kInstructions:
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    break;
+  case galois::runtime::PerfEvent::kLLCMisses:
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    break;
+  case galois::runtime::PerfEvent::kDTLBMisses:
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = cache_event(
+        PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ,
+        PERF_COUNT_HW_CACHE_RESULT_MISS);
+    break;
+  case galois::runtime::PerfEvent::kRemoteNodeAccesses:
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = cache_event(
+        PERF_COUNT_HW_CACHE_NODE, PERF_COUNT_HW_CACHE_OP_READ,
+        PERF_COUNT_HW_CACHE_RESULT_MISS);
+    break;
+  }
+  return attr;
+}
+
+/// The counters of one thread. Each event has its own counter rather than
+/// one group, so that events the machine cannot count together are still
+/// counted (multiplexed by the kernel) and a missing event leaves the others.
+class ThreadCounters {
+  std::array<int, galois::runtime::kNumPerfEvents> fds_;
+
+public:
+  ThreadCounters() {
+    fds_.fill(-1);
+    const auto& requested = RequestedEvents();
+    for (unsigned i = 0; i < galois::runtime::kNumPerfEvents; ++i) {
+      if (!requested[i]) {
+        continue;
+      }
+      perf_event_attr attr = MakeEventAttr(i);
+      // pid 0 and cpu -1: the calling thread on whichever CPU it runs
+      int fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+      if (fd < 0) {
+        GALOIS_LOG_DEBUG(
+            "cannot count {}: {}", kEventNames[i], std::strerror(errno));
+        continue;
+      }
+      fds_[i] = fd;
+    }
+  }
+
+  ~ThreadCounters() {
+    for (int fd : fds_) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  }
+
+  ThreadCounters(const ThreadCounters&) = delete;
+  ThreadCounters& operator=(const ThreadCounters&) = delete;
+
+  bool counted(unsigned event) const { return fds_[event] >= 0; }
+
+  galois::runtime::PerfCounterValues Read() const {
+    galois::runtime::PerfCounterValues values{};
+    for (unsigned i = 0; i < galois::runtime::kNumPerfEvents; ++i) {
+      if (fds_[i] < 0) {
+        continue;
+      }
+      uint64_t value = 0;
+      if (read(fds_[i], &value, sizeof(value)) == sizeof(value)) {
+        values[i] = value;
+      }
+    }
+    return values;
+  }
+};
+
+const ThreadCounters&
+LocalCounters() {
+  thread_local ThreadCounters counters;
+  return counters;
+}
+
+#endif
+
+}  // namespace
+
+bool
+galois::runtime::PerfCountersEnabled() {
+  static const bool enabled = [] {
+    for (bool r : RequestedEvents()) {
+      if (r) {
+        return true;
+      }
+    }
+    return false;
+  }();
+  return enabled;
+}
+
+bool
+galois::runtime::PerfEventCounted([[maybe_unused]] PerfEvent event) {
+#ifdef __linux__
+  return RequestedEvents()[static_cast<unsigned>(event)] &&
+         LocalCounters().counted(static_cast<unsigned>(event));
+#else
+  return false;
+#endif
+}
+
+const char*
+galois::runtime::PerfEventName(PerfEvent event) {
+  return kEventNames[static_cast<unsigned>(event)];
+}
+
+galois::runtime::PerfCounterValues
+galois::runtime::ReadPerfCounters() {
+#ifdef __linux__
+  if (PerfCountersEnabled()) {
+    return LocalCounters().Read();
+  }
+#endif
+  return PerfCounterValues{};
+}
+
+void
+galois::runtime::ReportPerfCounters(
+    const char* region, const PerfCounterValues& start,
+    const PerfCounterValues& end) {
+  for (unsigned i = 0; i < kNumPerfEvents; ++i) {
+    if (PerfEventCounted(static_cast<PerfEvent>(i))) {
+      galois::ReportStatSum(region, kStatNames[i], end[i] - start[i]);
+    }
+  }
+}
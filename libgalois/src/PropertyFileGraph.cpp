@@ -1,26 +1,52 @@
 #include "galois/graphs/PropertyFileGraph.h"
 
 #include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
 
 #include "galois/Logging.h"
 #include "galois/Loops.h"
+#include "galois/NumaMemoryPool.h"
+#include "galois/ParallelSTL.h"
 #include "galois/Platform.h"
 #include "galois/Properties.h"
 #include "galois/Result.h"
+#include "galois/Statistics.h"
+#include "galois/Threads.h"
+#include "galois/graphs/EdgeTypeIndex.h"
+#include "galois/graphs/InlineEdgeIndex.h"
+#include "galois/graphs/GraphHelpers.h"
+#include "galois/gstl.h"
+#include "galois/substrate/PageAlloc.h"
 #include "tsuba/Errors.h"
 #include "tsuba/FileFrame.h"
+#include "tsuba/MemoryPool.h"
 #include "tsuba/RDG.h"
 #include "tsuba/tsuba.h"
 
 namespace {
 
+constexpr uint64_t kTopologyVersion = 1;
+constexpr uint64_t kCompressedTopologyVersion = 2;
+/// Like kTopologyVersion but with uint64_t destinations
+constexpr uint64_t kWideTopologyVersion = 3;
+constexpr uint64_t kTransposeVersion = 1;
+/// Number of nodes whose edges are encoded together in the compressed format;
+/// each block can be decoded independently
+constexpr uint64_t kNodesPerBlock = 64;
+
 constexpr uint64_t
-GetGraphSize(uint64_t num_nodes, uint64_t num_edges) {
+GetGraphSize(
+    uint64_t num_nodes, uint64_t num_edges,
+    uint64_t sizeof_dest = sizeof(uint32_t)) {
   /// version, sizeof_edge_data, num_nodes, num_edges
   constexpr int mandatory_fields = 4;
 
   return (mandatory_fields + num_nodes) * sizeof(uint64_t) +
-         (num_edges * sizeof(uint32_t));
+         (num_edges * sizeof_dest);
 }
 
 /// MapTopology takes a file buffer of a topology file and extracts the
@@ -39,6 +65,173 @@ GetGraphSize(uint64_t num_nodes, uint64_t num_edges) {
 ///
 /// Since property graphs store their edge data separately, we will consider
 /// any topology file with non-zero sizeof_edge_data invalid.
+uint64_t
+ZigZagEncode(int64_t v) {
+  return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+int64_t
+ZigZagDecode(uint64_t v) {
+  return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+/// Write v as a LEB128 varint to out, unless out is null, and return the
+/// number of bytes it takes
+uint64_t
+PutVarint(uint64_t v, uint8_t* out) {
+  uint64_t n = 0;
+  while (v >= 0x80) {
+    if (out) {
+      out[n] = static_cast<uint8_t>(v) | 0x80;
+    }
+    v >>= 7;
+    ++n;
+  }
+  if (out) {
+    out[n] = static_cast<uint8_t>(v);
+  }
+  return n + 1;
+}
+
+/// Read a varint from [*in, end) and advance *in past it
+bool
+GetVarint(const uint8_t** in, const uint8_t* end, uint64_t* v) {
+  uint64_t result = 0;
+  for (int shift = 0; *in < end && shift < 64; shift += 7) {
+    uint8_t byte = *(*in)++;
+    result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      *v = result;
+      return true;
+    }
+  }
+  return false;
+}
+
+/// Encode the edges of the nodes in block, returning the number of bytes
+/// used. If out is null, only compute the size.
+///
+/// Each destination is stored as the zigzag varint of its difference from the
+/// previous destination of the same node, or from the node itself for the
+/// first edge, so sorted and local edge lists compress well.
+uint64_t
+EncodeBlock(
+    const galois::graphs::GraphTopology& topology, uint64_t block,
+    uint8_t* out) {
+  uint64_t bytes = 0;
+  uint64_t end = std::min((block + 1) * kNodesPerBlock, topology.num_nodes());
+  for (uint64_t n = block * kNodesPerBlock; n < end; ++n) {
+    auto [edge_begin, edge_end] = topology.edge_range(n);
+    int64_t prev = n;
+    for (uint64_t e = edge_begin; e < edge_end; ++e) {
+      int64_t dest = topology.out_dests->Value(e);
+      bytes += PutVarint(ZigZagEncode(dest - prev), out ? out + bytes : out);
+      prev = dest;
+    }
+  }
+  return bytes;
+}
+
+/// Decode one block produced by EncodeBlock into dests
+bool
+DecodeBlock(
+    const uint8_t* in, const uint8_t* in_end, const uint64_t* out_indices,
+    uint64_t num_nodes, uint64_t block, uint32_t* dests) {
+  uint64_t end = std::min((block + 1) * kNodesPerBlock, num_nodes);
+  for (uint64_t n = block * kNodesPerBlock; n < end; ++n) {
+    uint64_t edge_begin = n > 0 ? out_indices[n - 1] : 0;
+    int64_t prev = n;
+    for (uint64_t e = edge_begin; e < out_indices[n]; ++e) {
+      uint64_t v = 0;
+      if (!GetVarint(&in, in_end, &v)) {
+        return false;
+      }
+      prev += ZigZagDecode(v);
+      if (prev < 0 || prev >= static_cast<int64_t>(num_nodes)) {
+        return false;
+      }
+      dests[e] = prev;
+    }
+  }
+  return in == in_end;
+}
+
+/// DecodeCompressedTopology reads a topology file in the compressed format:
+///
+///   uint64_t version: 2
+///   uint64_t sizeof_edge_data: 0
+///   uint64_t num_nodes: number of nodes
+///   uint64_t num_edges: number of edges
+///   uint64_t[num_nodes] out_indices: as in the uncompressed format
+///   uint64_t[num_blocks + 1] block_offsets: start of each block of
+///     kNodesPerBlock nodes in the encoded destinations, plus the end
+///   uint8_t[] encoded destinations (\see EncodeBlock)
+///
+/// Since out_indices is at the same offset in either format, readers of the
+/// topology prefix need not know which format is used. Destinations are
+/// decoded in parallel, one block per task.
+galois::Result<galois::graphs::GraphTopology>
+DecodeCompressedTopology(const tsuba::FileView& file_view) {
+  if (file_view.size() < 4 * sizeof(uint64_t)) {
+    return galois::ErrorCode::InvalidArgument;
+  }
+  const auto* data = file_view.ptr<uint64_t>();
+  uint64_t num_nodes = data[2];
+  uint64_t num_edges = data[3];
+  uint64_t num_blocks = (num_nodes + kNodesPerBlock - 1) / kNodesPerBlock;
+
+  uint64_t header_size = (4 + num_nodes + num_blocks + 1) * sizeof(uint64_t);
+  if (file_view.size() < header_size) {
+    return galois::ErrorCode::InvalidArgument;
+  }
+
+  uint64_t* out_indices = const_cast<uint64_t*>(&data[4]);
+  const uint64_t* block_offsets = out_indices + num_nodes;
+  const uint8_t* encoded = file_view.ptr<uint8_t>() + header_size;
+  if (block_offsets[num_blocks] > file_view.size() - header_size ||
+      (num_nodes > 0 && out_indices[num_nodes - 1] != num_edges)) {
+    return galois::ErrorCode::InvalidArgument;
+  }
+
+  auto alloc_result = arrow::AllocateBuffer(
+      num_edges * sizeof(uint32_t), tsuba::GetArrowMemoryPool());
+  if (!alloc_result.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", alloc_result.status());
+    return galois::ErrorCode::ArrowError;
+  }
+  std::shared_ptr<arrow::Buffer> dests_buffer =
+      std::move(alloc_result.ValueOrDie());
+  auto* dests = reinterpret_cast<uint32_t*>(dests_buffer->mutable_data());
+
+  std::atomic<bool> corrupt{false};
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t block) {
+        uint64_t begin = block_offsets[block];
+        uint64_t end = block_offsets[block + 1];
+        if (begin > end || end > block_offsets[num_blocks] ||
+            !DecodeBlock(
+                encoded + begin, encoded + end, out_indices, num_nodes, block,
+                dests)) {
+          corrupt = true;
+        }
+      },
+      galois::no_stats(), galois::steal());
+  if (corrupt) {
+    return galois::ErrorCode::InvalidArgument;
+  }
+
+  auto indices_buffer = std::make_shared<arrow::MutableBuffer>(
+      reinterpret_cast<uint8_t*>(out_indices), num_nodes * sizeof(uint64_t));
+
+  return galois::graphs::GraphTopology{
+      .out_indices =
+          std::make_shared<arrow::UInt64Array>(num_nodes, indices_buffer),
+      .out_dests =
+          std::make_shared<arrow::UInt32Array>(num_edges, dests_buffer),
+  };
+}
+
 galois::Result<galois::graphs::GraphTopology>
 MapTopology(const tsuba::FileView& file_view) {
   const auto* data = file_view.ptr<uint64_t>();
@@ -46,7 +239,11 @@ MapTopology(const tsuba::FileView& file_view) {
     return galois::ErrorCode::InvalidArgument;
   }
 
-  if (data[0] != 1) {
+  if (data[0] == kCompressedTopologyVersion && data[1] == 0) {
+    return DecodeCompressedTopology(file_view);
+  }
+
+  if (data[0] != kTopologyVersion) {
     return galois::ErrorCode::InvalidArgument;
   }
 
@@ -81,10 +278,75 @@ MapTopology(const tsuba::FileView& file_view) {
   };
 }
 
+/// MapWideTopology is like MapTopology for topology files of version
+/// kWideTopologyVersion, whose destinations are uint64_t:
+///
+///   uint64_t version: 3
+///   uint64_t sizeof_edge_data: 0
+///   uint64_t num_nodes: number of nodes
+///   uint64_t num_edges: number of edges
+///   uint64_t[num_nodes] out_indices: end of the edges of each node
+///   uint64_t[num_edges] out_dests: destinations (node indexes) of each edge
+galois::Result<galois::graphs::GraphTopology64>
+MapWideTopology(const tsuba::FileView& file_view) {
+  const auto* data = file_view.ptr<uint64_t>();
+  if (file_view.size() < 4 * sizeof(uint64_t)) {
+    return galois::ErrorCode::InvalidArgument;
+  }
+  if (data[0] != kWideTopologyVersion || data[1] != 0) {
+    return galois::ErrorCode::InvalidArgument;
+  }
+
+  uint64_t num_nodes = data[2];
+  uint64_t num_edges = data[3];
+  if (file_view.size() < GetGraphSize(num_nodes, num_edges, sizeof(uint64_t))) {
+    return galois::ErrorCode::InvalidArgument;
+  }
+
+  auto* out_indices = const_cast<uint64_t*>(&data[4]);
+  uint64_t* out_dests = out_indices + num_nodes;
+
+  auto indices_buffer = std::make_shared<arrow::MutableBuffer>(
+      reinterpret_cast<uint8_t*>(out_indices), num_nodes * sizeof(uint64_t));
+  auto dests_buffer = std::make_shared<arrow::MutableBuffer>(
+      reinterpret_cast<uint8_t*>(out_dests), num_edges * sizeof(uint64_t));
+
+  return galois::graphs::GraphTopology64{
+      .out_indices =
+          std::make_shared<arrow::UInt64Array>(num_nodes, indices_buffer),
+      .out_dests =
+          std::make_shared<arrow::UInt64Array>(num_edges, dests_buffer),
+  };
+}
+
+bool
+IsCompressedTopology(const tsuba::FileView& file_view) {
+  return file_view.Valid() && file_view.size() >= sizeof(uint64_t) &&
+         file_view.ptr<uint64_t>()[0] == kCompressedTopologyVersion;
+}
+
+bool
+IsWideTopology(const tsuba::FileView& file_view) {
+  return file_view.Valid() && file_view.size() >= sizeof(uint64_t) &&
+         file_view.ptr<uint64_t>()[0] == kWideTopologyVersion;
+}
+
+/// LoadTopology maps topology_file_storage into topology, or into
+/// wide_topology if it has 64-bit node ids
 galois::Result<void>
 LoadTopology(
     galois::graphs::GraphTopology* topology,
+    galois::graphs::GraphTopology64* wide_topology,
     const tsuba::FileView& topology_file_storage) {
+  if (IsWideTopology(topology_file_storage)) {
+    auto map_result = MapWideTopology(topology_file_storage);
+    if (!map_result) {
+      return map_result.error();
+    }
+    *wide_topology = std::move(map_result.value());
+    return galois::ResultSuccess();
+  }
+
   auto map_result = MapTopology(topology_file_storage);
   if (!map_result) {
     return map_result.error();
@@ -94,16 +356,86 @@ LoadTopology(
   return galois::ResultSuccess();
 }
 
+/// WriteCompressedTopology is like WriteTopology but uses the compressed
+/// format (\see DecodeCompressedTopology). Blocks are sized and then encoded
+/// in parallel.
 galois::Result<std::unique_ptr<tsuba::FileFrame>>
-WriteTopology(const galois::graphs::GraphTopology& topology) {
+WriteCompressedTopology(const galois::graphs::GraphTopology& topology) {
   auto ff = std::make_unique<tsuba::FileFrame>();
   if (auto res = ff->Init(); !res) {
     return res.error();
   }
   uint64_t num_nodes = topology.num_nodes();
   uint64_t num_edges = topology.num_edges();
+  uint64_t num_blocks = (num_nodes + kNodesPerBlock - 1) / kNodesPerBlock;
+
+  std::vector<uint64_t> block_offsets(num_blocks + 1, 0);
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t block) {
+        block_offsets[block + 1] = EncodeBlock(topology, block, nullptr);
+      },
+      galois::no_stats(), galois::steal());
+  galois::ParallelSTL::partial_sum(
+      block_offsets.begin(), block_offsets.end(), block_offsets.begin());
+
+  std::vector<uint8_t> encoded(block_offsets[num_blocks]);
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t block) {
+        EncodeBlock(topology, block, encoded.data() + block_offsets[block]);
+      },
+      galois::no_stats(), galois::steal());
 
-  uint64_t data[4] = {1, 0, num_nodes, num_edges};
+  uint64_t data[4] = {kCompressedTopologyVersion, 0, num_nodes, num_edges};
+  arrow::Status aro_sts = ff->Write(&data, 4 * sizeof(uint64_t));
+  if (!aro_sts.ok()) {
+    return tsuba::ArrowToTsuba(aro_sts.code());
+  }
+
+  if (num_nodes) {
+    aro_sts = ff->Write(
+        topology.out_indices->raw_values(), num_nodes * sizeof(uint64_t));
+    if (!aro_sts.ok()) {
+      return tsuba::ArrowToTsuba(aro_sts.code());
+    }
+  }
+
+  aro_sts = ff->Write(
+      block_offsets.data(), block_offsets.size() * sizeof(uint64_t));
+  if (!aro_sts.ok()) {
+    return tsuba::ArrowToTsuba(aro_sts.code());
+  }
+
+  if (!encoded.empty()) {
+    aro_sts = ff->Write(encoded.data(), encoded.size());
+    if (!aro_sts.ok()) {
+      return tsuba::ArrowToTsuba(aro_sts.code());
+    }
+  }
+
+  GALOIS_LOG_DEBUG(
+      "compressed topology destinations from {} to {} bytes",
+      num_edges * sizeof(uint32_t), encoded.size());
+
+  return std::unique_ptr<tsuba::FileFrame>(std::move(ff));
+}
+
+/// WriteTopology stores topology in the format of MapTopology or, for 64-bit
+/// node ids, of MapWideTopology
+template <typename NodeId>
+galois::Result<std::unique_ptr<tsuba::FileFrame>>
+WriteTopology(const galois::graphs::BasicGraphTopology<NodeId>& topology) {
+  auto ff = std::make_unique<tsuba::FileFrame>();
+  if (auto res = ff->Init(); !res) {
+    return res.error();
+  }
+  uint64_t num_nodes = topology.num_nodes();
+  uint64_t num_edges = topology.num_edges();
+
+  uint64_t version = std::is_same_v<NodeId, uint64_t> ? kWideTopologyVersion
+                                                      : kTopologyVersion;
+  uint64_t data[4] = {version, 0, num_nodes, num_edges};
   arrow::Status aro_sts = ff->Write(&data, 4 * sizeof(uint64_t));
   if (!aro_sts.ok()) {
     return tsuba::ArrowToTsuba(aro_sts.code());
@@ -122,9 +454,9 @@ WriteTopology(const galois::graphs::GraphTopology& topology) {
 
   if (num_edges) {
     const auto* raw = topology.out_dests->raw_values();
-    static_assert(std::is_same_v<std::decay_t<decltype(*raw)>, uint32_t>);
+    static_assert(std::is_same_v<std::decay_t<decltype(*raw)>, NodeId>);
     auto buf = std::make_shared<arrow::Buffer>(
-        reinterpret_cast<const uint8_t*>(raw), num_edges * sizeof(uint32_t));
+        reinterpret_cast<const uint8_t*>(raw), num_edges * sizeof(NodeId));
     aro_sts = ff->Write(buf);
     if (!aro_sts.ok()) {
       return tsuba::ArrowToTsuba(aro_sts.code());
@@ -133,6 +465,223 @@ WriteTopology(const galois::graphs::GraphTopology& topology) {
   return std::unique_ptr<tsuba::FileFrame>(std::move(ff));
 }
 
+uint64_t
+GetTransposeSize(uint64_t num_nodes, uint64_t num_edges) {
+  // version, reserved, num_nodes, num_edges
+  constexpr int mandatory_fields = 4;
+  uint64_t sources_words = (num_edges * sizeof(uint32_t) + 7) / 8;
+
+  return (mandatory_fields + num_nodes + sources_words + num_edges) *
+         sizeof(uint64_t);
+}
+
+/// BuildInEdges computes the in-edge index of topology.
+///
+/// In-degrees are counted and placed with atomics and each in-edge range is
+/// then sorted by out-edge id, which also sorts it by source, so that the
+/// result does not depend on the number of threads. Sources are recovered
+/// from the out-edge ids by binary search on out_indices.
+galois::Result<galois::graphs::InEdgeTopology>
+BuildInEdges(const galois::graphs::GraphTopology& topology) {
+  uint64_t num_nodes = topology.num_nodes();
+  uint64_t num_edges = topology.num_edges();
+
+  arrow::MemoryPool* pool = tsuba::GetArrowMemoryPool();
+  auto indices_result =
+      arrow::AllocateBuffer(num_nodes * sizeof(uint64_t), pool);
+  auto sources_result =
+      arrow::AllocateBuffer(num_edges * sizeof(uint32_t), pool);
+  auto ids_result = arrow::AllocateBuffer(num_edges * sizeof(uint64_t), pool);
+  if (!indices_result.ok() || !sources_result.ok() || !ids_result.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: could not allocate in-edges");
+    return galois::ErrorCode::ArrowError;
+  }
+  std::shared_ptr<arrow::Buffer> indices_buffer =
+      std::move(indices_result.ValueOrDie());
+  std::shared_ptr<arrow::Buffer> sources_buffer =
+      std::move(sources_result.ValueOrDie());
+  std::shared_ptr<arrow::Buffer> ids_buffer =
+      std::move(ids_result.ValueOrDie());
+  auto* in_indices =
+      reinterpret_cast<uint64_t*>(indices_buffer->mutable_data());
+  auto* in_sources =
+      reinterpret_cast<uint32_t*>(sources_buffer->mutable_data());
+  auto* out_edge_ids = reinterpret_cast<uint64_t*>(ids_buffer->mutable_data());
+
+  const uint64_t* out_indices = topology.out_indices->raw_values();
+  const uint32_t* out_dests = topology.out_dests->raw_values();
+
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { in_indices[n] = 0; }, galois::no_stats());
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) { __sync_fetch_and_add(&in_indices[out_dests[e]], 1); },
+      galois::no_stats());
+  galois::ParallelSTL::partial_sum(
+      in_indices, in_indices + num_nodes, in_indices);
+
+  // in_cursor[n] counts down from the end of the in-edges of n
+  galois::LargeArray<uint64_t> in_cursor;
+  in_cursor.allocateBlocked(num_nodes);
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { in_cursor[n] = in_indices[n]; }, galois::no_stats());
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) {
+        out_edge_ids[__sync_sub_and_fetch(&in_cursor[out_dests[e]], 1)] = e;
+      },
+      galois::no_stats());
+
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t begin = n == 0 ? 0 : in_indices[n - 1];
+        uint64_t end = in_indices[n];
+        std::sort(out_edge_ids + begin, out_edge_ids + end);
+        for (uint64_t i = begin; i != end; ++i) {
+          in_sources[i] = std::upper_bound(
+                              out_indices, out_indices + num_nodes,
+                              out_edge_ids[i]) -
+                          out_indices;
+        }
+      },
+      galois::no_stats(), galois::steal());
+
+  return galois::graphs::InEdgeTopology{
+      .in_indices =
+          std::make_shared<arrow::UInt64Array>(num_nodes, indices_buffer),
+      .in_sources =
+          std::make_shared<arrow::UInt32Array>(num_edges, sources_buffer),
+      .out_edge_ids =
+          std::make_shared<arrow::UInt64Array>(num_edges, ids_buffer),
+  };
+}
+
+/// MapInEdges takes the file buffer of a stored in-edge index and extracts
+/// its arrays.
+///
+/// Format of an in-edge index file:
+///
+///   uint64_t version: 1
+///   uint64_t reserved: 0
+///   uint64_t num_nodes: number of nodes
+///   uint64_t num_edges: number of edges
+///   uint64_t[num_nodes] in_indices: end of the in-edges of each node
+///   uint32_t[num_edges] in_sources: source of each in-edge
+///   uint32_t padding if num_edges is odd
+///   uint64_t[num_edges] out_edge_ids: out-edge index of each in-edge
+galois::Result<galois::graphs::InEdgeTopology>
+MapInEdges(
+    const tsuba::FileView& file_view,
+    const galois::graphs::GraphTopology& topology) {
+  if (file_view.size() < 4 * sizeof(uint64_t)) {
+    return galois::ErrorCode::InvalidArgument;
+  }
+  const auto* data = file_view.ptr<uint64_t>();
+  uint64_t num_nodes = data[2];
+  uint64_t num_edges = data[3];
+  if (data[0] != kTransposeVersion || data[1] != 0 ||
+      num_nodes != topology.num_nodes() || num_edges != topology.num_edges() ||
+      file_view.size() < GetTransposeSize(num_nodes, num_edges)) {
+    GALOIS_LOG_DEBUG("stored in-edges do not match the topology");
+    return galois::ErrorCode::InvalidArgument;
+  }
+
+  auto* in_indices = const_cast<uint64_t*>(&data[4]);
+  auto* in_sources = reinterpret_cast<uint32_t*>(in_indices + num_nodes);
+  auto* out_edge_ids =
+      in_indices + num_nodes + (num_edges * sizeof(uint32_t) + 7) / 8;
+
+  auto indices_buffer = std::make_shared<arrow::MutableBuffer>(
+      reinterpret_cast<uint8_t*>(in_indices), num_nodes * sizeof(uint64_t));
+  auto sources_buffer = std::make_shared<arrow::MutableBuffer>(
+      reinterpret_cast<uint8_t*>(in_sources), num_edges * sizeof(uint32_t));
+  auto ids_buffer = std::make_shared<arrow::MutableBuffer>(
+      reinterpret_cast<uint8_t*>(out_edge_ids), num_edges * sizeof(uint64_t));
+
+  return galois::graphs::InEdgeTopology{
+      .in_indices =
+          std::make_shared<arrow::UInt64Array>(num_nodes, indices_buffer),
+      .in_sources =
+          std::make_shared<arrow::UInt32Array>(num_edges, sources_buffer),
+      .out_edge_ids =
+          std::make_shared<arrow::UInt64Array>(num_edges, ids_buffer),
+  };
+}
+
+/// WriteInEdges serializes an in-edge index in the format read by MapInEdges
+galois::Result<std::unique_ptr<tsuba::FileFrame>>
+WriteInEdges(const galois::graphs::InEdgeTopology& in_edges) {
+  auto ff = std::make_unique<tsuba::FileFrame>();
+  if (auto res = ff->Init(); !res) {
+    return res.error();
+  }
+  uint64_t num_nodes = in_edges.num_nodes();
+  uint64_t num_edges = in_edges.num_edges();
+
+  uint64_t data[4] = {kTransposeVersion, 0, num_nodes, num_edges};
+  arrow::Status aro_sts = ff->Write(&data, 4 * sizeof(uint64_t));
+  if (!aro_sts.ok()) {
+    return tsuba::ArrowToTsuba(aro_sts.code());
+  }
+
+  if (num_nodes) {
+    aro_sts = ff->Write(
+        in_edges.in_indices->raw_values(), num_nodes * sizeof(uint64_t));
+    if (!aro_sts.ok()) {
+      return tsuba::ArrowToTsuba(aro_sts.code());
+    }
+  }
+
+  if (num_edges) {
+    aro_sts = ff->Write(
+        in_edges.in_sources->raw_values(), num_edges * sizeof(uint32_t));
+    if (!aro_sts.ok()) {
+      return tsuba::ArrowToTsuba(aro_sts.code());
+    }
+    if (num_edges % 2) {
+      uint32_t padding = 0;
+      aro_sts = ff->Write(&padding, sizeof(padding));
+      if (!aro_sts.ok()) {
+        return tsuba::ArrowToTsuba(aro_sts.code());
+      }
+    }
+    aro_sts = ff->Write(
+        in_edges.out_edge_ids->raw_values(), num_edges * sizeof(uint64_t));
+    if (!aro_sts.ok()) {
+      return tsuba::ArrowToTsuba(aro_sts.code());
+    }
+  }
+  return std::unique_ptr<tsuba::FileFrame>(std::move(ff));
+}
+
+/// EdgesSortedByDest checks in parallel whether the edges of every node of
+/// topology are in ascending order of destination
+template <typename NodeId>
+bool
+EdgesSortedByDest(const galois::graphs::BasicGraphTopology<NodeId>& topology) {
+  if (!topology.out_dests) {
+    return true;
+  }
+  const NodeId* dests = topology.out_dests->raw_values();
+  std::atomic<bool> sorted{true};
+  galois::do_all(
+      galois::iterate(uint64_t{0}, topology.num_nodes()),
+      [&](uint64_t n) {
+        if (!sorted.load(std::memory_order_relaxed)) {
+          return;
+        }
+        auto [begin, end] = topology.edge_range(n);
+        if (!std::is_sorted(dests + begin, dests + end)) {
+          sorted.store(false, std::memory_order_relaxed);
+        }
+      },
+      galois::no_stats(), galois::steal());
+  return sorted;
+}
+
 galois::Result<std::unique_ptr<galois::graphs::PropertyFileGraph>>
 MakePropertyFileGraph(
     std::unique_ptr<tsuba::RDGFile> rdg_file,
@@ -148,6 +697,93 @@ MakePropertyFileGraph(
       std::move(rdg_file), std::move(rdg_result.value()));
 }
 
+galois::Result<std::unique_ptr<galois::graphs::PropertyFileGraph>>
+MakeLazyPropertyFileGraph(std::unique_ptr<tsuba::RDGFile> rdg_file) {
+  auto rdg_result = tsuba::RDG::MakeLazy(*rdg_file);
+  if (!rdg_result) {
+    return rdg_result.error();
+  }
+
+  return galois::graphs::PropertyFileGraph::Make(
+      std::move(rdg_file), std::move(rdg_result.value()));
+}
+
+/// Ensure that the columns of table named by names are loaded using
+/// ensure_fn(i)
+template <typename EnsureFn>
+galois::Result<void>
+EnsureNamedLoaded(
+    const arrow::Table& table, const std::vector<std::string>& names,
+    EnsureFn ensure_fn) {
+  for (const std::string& name : names) {
+    int i = table.schema()->GetFieldIndex(name);
+    if (i < 0) {
+      return galois::ErrorCode::PropertyNotFound;
+    }
+    if (auto res = ensure_fn(i); !res) {
+      return res.error();
+    }
+  }
+  return galois::ResultSuccess();
+}
+
+/// The bytes of the buffers of array and its children and dictionaries
+uint64_t
+ArrayBytes(const arrow::ArrayData& array) {
+  uint64_t bytes = 0;
+  std::vector<const arrow::ArrayData*> pending{&array};
+  while (!pending.empty()) {
+    const arrow::ArrayData* data = pending.back();
+    pending.pop_back();
+    for (const auto& buffer : data->buffers) {
+      if (buffer) {
+        bytes += buffer->size();
+      }
+    }
+    for (const auto& child : data->child_data) {
+      pending.emplace_back(child.get());
+    }
+    if (data->dictionary) {
+      pending.emplace_back(data->dictionary.get());
+    }
+  }
+  return bytes;
+}
+
+uint64_t
+ArrayBytes(const std::shared_ptr<arrow::Array>& array) {
+  return array ? ArrayBytes(*array->data()) : 0;
+}
+
+uint64_t
+ChunkedArrayBytes(const arrow::ChunkedArray& array) {
+  uint64_t bytes = 0;
+  for (const auto& chunk : array.chunks()) {
+    bytes += ArrayBytes(*chunk->data());
+  }
+  return bytes;
+}
+
+/// The memory of the properties of table, of which is_loaded(i) and
+/// has_stored(i) tell whether property i is loaded and has a stored copy
+template <typename IsLoadedFn, typename HasStoredFn>
+std::vector<galois::graphs::PropertyMemoryUsage>
+PropertiesMemoryUsage(
+    const arrow::Table& table, IsLoadedFn is_loaded, HasStoredFn has_stored) {
+  std::vector<galois::graphs::PropertyMemoryUsage> usage;
+  for (int i = 0, n = table.num_columns(); i < n; ++i) {
+    galois::graphs::PropertyMemoryUsage property;
+    property.name = table.field(i)->name();
+    property.loaded = is_loaded(i);
+    if (property.loaded) {
+      property.bytes = ChunkedArrayBytes(*table.column(i));
+    }
+    property.evictable = property.loaded && has_stored(i);
+    usage.emplace_back(std::move(property));
+  }
+  return usage;
+}
+
 galois::Result<std::unique_ptr<galois::graphs::PropertyFileGraph>>
 MakePropertyFileGraph(std::unique_ptr<tsuba::RDGFile> rdg_file) {
   auto rdg_result = tsuba::RDG::Make(*rdg_file);
@@ -184,15 +820,59 @@ galois::graphs::PropertyFileGraph::Validate() {
 galois::Result<void>
 galois::graphs::PropertyFileGraph::DoWrite(
     tsuba::RDGHandle handle, const std::string& command_line) {
-  if (!rdg_.topology_file_storage().Valid()) {
-    auto result = WriteTopology(topology_);
+  rdg_.set_edges_sorted_by_dest(
+      HasWideNodeIds() ? topology64_.edges_sorted_by_dest
+                       : topology_.edges_sorted_by_dest);
+  rdg_.set_graph_statistics(graph_statistics_);
+
+  // the indexes are only built for 32-bit node ids
+  std::unique_ptr<tsuba::FileFrame> transpose_ff;
+  if (!persist_in_edges_ || HasWideNodeIds()) {
+    if (auto res = rdg_.DropTranspose(); !res) {
+      return res.error();
+    }
+  } else if (!rdg_.HasTranspose()) {
+    auto in_edges_result = InEdges();
+    if (!in_edges_result) {
+      return in_edges_result.error();
+    }
+    auto result = WriteInEdges(*in_edges_result.value());
+    if (!result) {
+      return result.error();
+    }
+    transpose_ff = std::move(result.value());
+  }
+
+  std::unique_ptr<tsuba::FileFrame> edge_types_ff;
+  if (!persist_edge_types_ || HasWideNodeIds()) {
+    if (auto res = rdg_.DropEdgeTypeIndex(); !res) {
+      return res.error();
+    }
+  } else if (edge_types_ && !edge_types_mapped_) {
+    auto result = edge_types_->Write();
+    if (!result) {
+      return result.error();
+    }
+    edge_types_ff = std::move(result.value());
+  }
+
+  const tsuba::FileView& storage = rdg_.topology_file_storage();
+  bool compress = compress_topology_ && !HasWideNodeIds();
+  if (!storage.Valid() || IsCompressedTopology(storage) != compress) {
+    auto result = HasWideNodeIds() ? WriteTopology(topology64_)
+                  : compress       ? WriteCompressedTopology(topology_)
+                                   : WriteTopology(topology_);
     if (!result) {
       return result.error();
     }
-    return rdg_.Store(handle, command_line, std::move(result.value()));
+    return rdg_.Store(
+        handle, command_line, std::move(result.value()),
+        std::move(transpose_ff), std::move(edge_types_ff));
   }
 
-  return rdg_.Store(handle, command_line);
+  return rdg_.Store(
+      handle, command_line, nullptr, std::move(transpose_ff),
+      std::move(edge_types_ff));
 }
 
 galois::Result<std::unique_ptr<galois::graphs::PropertyFileGraph>>
@@ -201,11 +881,28 @@ galois::graphs::PropertyFileGraph::Make(
   auto g = std::unique_ptr<PropertyFileGraph>(
       new PropertyFileGraph(std::move(rdg_file), std::move(rdg)));
 
-  auto load_result =
-      LoadTopology(&g->topology_, g->rdg_.topology_file_storage());
+  auto load_result = LoadTopology(
+      &g->topology_, &g->topology64_, g->rdg_.topology_file_storage());
   if (!load_result) {
     return load_result.error();
   }
+  // keep the stored format unless the caller asks otherwise
+  g->compress_topology_ = IsCompressedTopology(g->rdg_.topology_file_storage());
+  g->persist_in_edges_ = g->rdg_.HasTranspose();
+  g->persist_edge_types_ = g->rdg_.HasEdgeTypeIndex();
+  g->graph_statistics_ = g->rdg_.graph_statistics();
+  if (g->rdg_.edges_sorted_by_dest()) {
+    // cheap compared to loading the topology, and a stale flag would make
+    // intersections silently wrong
+    bool sorted = g->HasWideNodeIds() ? EdgesSortedByDest(g->topology64_)
+                                      : EdgesSortedByDest(g->topology_);
+    if (sorted) {
+      g->topology_.edges_sorted_by_dest = !g->HasWideNodeIds();
+      g->topology64_.edges_sorted_by_dest = g->HasWideNodeIds();
+    } else {
+      GALOIS_LOG_WARN("edges marked as sorted by destination are not sorted");
+    }
+  }
 
   if (auto good = g->Validate(); !good) {
     return good.error();
@@ -224,6 +921,17 @@ galois::graphs::PropertyFileGraph::Make(const std::string& rdg_name) {
       std::make_unique<tsuba::RDGFile>(handle.value()));
 }
 
+galois::Result<std::unique_ptr<galois::graphs::PropertyFileGraph>>
+galois::graphs::PropertyFileGraph::MakeLazy(const std::string& rdg_name) {
+  auto handle = tsuba::Open(rdg_name, tsuba::kReadWrite);
+  if (!handle) {
+    return handle.error();
+  }
+
+  return MakeLazyPropertyFileGraph(
+      std::make_unique<tsuba::RDGFile>(handle.value()));
+}
+
 galois::Result<std::unique_ptr<galois::graphs::PropertyFileGraph>>
 galois::graphs::PropertyFileGraph::Make(
     const std::string& rdg_name,
@@ -278,13 +986,255 @@ galois::graphs::PropertyFileGraph::Write(
   return WriteGraph(rdg_name, command_line);
 }
 
+std::shared_ptr<arrow::ChunkedArray>
+galois::graphs::PropertyFileGraph::NodeProperty(int i) const {
+  bool loaded = rdg_.IsNodePropertyLoaded(i);
+  if (auto res = rdg_.EnsureNodePropertyLoaded(i); !res) {
+    GALOIS_LOG_ERROR("loading node property {}: {}", i, res.error());
+    return nullptr;
+  }
+  TouchNodeProperty(i);
+  std::shared_ptr<arrow::ChunkedArray> property = rdg_.node_table()->column(i);
+  if (!loaded && memory_budget_ != 0) {
+    if (auto res = EvictColdProperties(true); !res) {
+      GALOIS_LOG_WARN("evicting properties: {}", res.error());
+    }
+  }
+  return property;
+}
+
+std::shared_ptr<arrow::ChunkedArray>
+galois::graphs::PropertyFileGraph::EdgeProperty(int i) const {
+  bool loaded = rdg_.IsEdgePropertyLoaded(i);
+  if (auto res = rdg_.EnsureEdgePropertyLoaded(i); !res) {
+    GALOIS_LOG_ERROR("loading edge property {}: {}", i, res.error());
+    return nullptr;
+  }
+  TouchEdgeProperty(i);
+  std::shared_ptr<arrow::ChunkedArray> property = rdg_.edge_table()->column(i);
+  if (!loaded && memory_budget_ != 0) {
+    if (auto res = EvictColdProperties(true); !res) {
+      GALOIS_LOG_WARN("evicting properties: {}", res.error());
+    }
+  }
+  return property;
+}
+
+std::shared_ptr<arrow::ChunkedArray>
+galois::graphs::PropertyFileGraph::NodeProperty(std::string name) const {
+  int i = rdg_.node_table()->schema()->GetFieldIndex(name);
+  if (i < 0) {
+    return nullptr;
+  }
+  return NodeProperty(i);
+}
+
+std::shared_ptr<arrow::ChunkedArray>
+galois::graphs::PropertyFileGraph::EdgeProperty(std::string name) const {
+  int i = rdg_.edge_table()->schema()->GetFieldIndex(name);
+  if (i < 0) {
+    return nullptr;
+  }
+  return EdgeProperty(i);
+}
+
+std::vector<std::shared_ptr<arrow::ChunkedArray>>
+galois::graphs::PropertyFileGraph::NodeProperties() const {
+  for (int i = 0, n = rdg_.node_table()->num_columns(); i < n; ++i) {
+    if (auto res = rdg_.EnsureNodePropertyLoaded(i); !res) {
+      GALOIS_LOG_ERROR("loading node property {}: {}", i, res.error());
+    }
+  }
+  return rdg_.node_table()->columns();
+}
+
+std::vector<std::shared_ptr<arrow::ChunkedArray>>
+galois::graphs::PropertyFileGraph::EdgeProperties() const {
+  for (int i = 0, n = rdg_.edge_table()->num_columns(); i < n; ++i) {
+    if (auto res = rdg_.EnsureEdgePropertyLoaded(i); !res) {
+      GALOIS_LOG_ERROR("loading edge property {}: {}", i, res.error());
+    }
+  }
+  return rdg_.edge_table()->columns();
+}
+
+galois::Result<void>
+galois::graphs::PropertyFileGraph::EnsureNodePropertiesLoaded(
+    const std::vector<std::string>& names) const {
+  return EnsureNamedLoaded(*rdg_.node_table(), names, [&](int i) {
+    return rdg_.EnsureNodePropertyLoaded(i);
+  });
+}
+
+galois::Result<void>
+galois::graphs::PropertyFileGraph::EnsureEdgePropertiesLoaded(
+    const std::vector<std::string>& names) const {
+  return EnsureNamedLoaded(*rdg_.edge_table(), names, [&](int i) {
+    return rdg_.EnsureEdgePropertyLoaded(i);
+  });
+}
+
+void
+galois::graphs::PropertyFileGraph::TouchNodeProperty(int i) const {
+  node_property_uses_[rdg_.node_table()->field(i)->name()] = ++property_clock_;
+}
+
+void
+galois::graphs::PropertyFileGraph::TouchEdgeProperty(int i) const {
+  edge_property_uses_[rdg_.edge_table()->field(i)->name()] = ++property_clock_;
+}
+
+uint64_t
+galois::graphs::MemoryUsage::property_bytes() const {
+  uint64_t bytes = 0;
+  for (const auto& property : node_properties) {
+    bytes += property.bytes;
+  }
+  for (const auto& property : edge_properties) {
+    bytes += property.bytes;
+  }
+  return bytes;
+}
+
+uint64_t
+galois::graphs::MemoryUsage::total_bytes() const {
+  return topology_bytes + in_edges_bytes + edge_types_bytes +
+         inline_edges_bytes + property_bytes();
+}
+
+galois::graphs::MemoryUsage
+galois::graphs::PropertyFileGraph::GetMemoryUsage() const {
+  MemoryUsage usage;
+  usage.topology_bytes = ArrayBytes(topology_.out_indices) +
+                         ArrayBytes(topology_.out_dests) +
+                         ArrayBytes(topology64_.out_indices) +
+                         ArrayBytes(topology64_.out_dests);
+  usage.in_edges_bytes = ArrayBytes(in_topology_.in_indices) +
+                         ArrayBytes(in_topology_.in_sources) +
+                         ArrayBytes(in_topology_.out_edge_ids);
+  if (edge_types_) {
+    usage.edge_types_bytes = edge_types_->memory_bytes();
+  }
+  if (inline_edges_) {
+    usage.inline_edges_bytes = inline_edges_->memory_bytes();
+  }
+  for (const tsuba::FileView* view :
+       {&rdg_.topology_file_storage(), &rdg_.transpose_file_storage(),
+        &rdg_.edge_type_index_file_storage()}) {
+    if (view->Valid()) {
+      usage.file_view_bytes += view->size();
+    }
+  }
+
+  usage.node_properties = PropertiesMemoryUsage(
+      *rdg_.node_table(), [&](int i) { return rdg_.IsNodePropertyLoaded(i); },
+      [&](int i) { return rdg_.HasStoredNodeProperty(i); });
+  usage.edge_properties = PropertiesMemoryUsage(
+      *rdg_.edge_table(), [&](int i) { return rdg_.IsEdgePropertyLoaded(i); },
+      [&](int i) { return rdg_.HasStoredEdgeProperty(i); });
+  return usage;
+}
+
+void
+galois::graphs::PropertyFileGraph::ReportMemoryUsage(
+    const std::string& region) const {
+  MemoryUsage usage = GetMemoryUsage();
+  galois::ReportStatSingle(region, "TopologyBytes", usage.topology_bytes);
+  galois::ReportStatSingle(region, "InEdgesBytes", usage.in_edges_bytes);
+  galois::ReportStatSingle(region, "EdgeTypesBytes", usage.edge_types_bytes);
+  galois::ReportStatSingle(
+      region, "InlineEdgesBytes", usage.inline_edges_bytes);
+  galois::ReportStatSingle(region, "FileViewBytes", usage.file_view_bytes);
+  for (const auto& property : usage.node_properties) {
+    if (property.loaded) {
+      galois::ReportStatSingle(
+          region, "NodeProperty" + property.name + "Bytes", property.bytes);
+    }
+  }
+  for (const auto& property : usage.edge_properties) {
+    if (property.loaded) {
+      galois::ReportStatSingle(
+          region, "EdgeProperty" + property.name + "Bytes", property.bytes);
+    }
+  }
+  galois::ReportStatSingle(region, "TotalBytes", usage.total_bytes());
+}
+
+galois::Result<uint64_t>
+galois::graphs::PropertyFileGraph::EvictColdProperties(
+    bool keep_last) const {
+  MemoryUsage usage = GetMemoryUsage();
+  uint64_t total = usage.total_bytes();
+  if (memory_budget_ == 0 || total <= memory_budget_) {
+    return 0;
+  }
+
+  struct Candidate {
+    uint64_t last_use;
+    bool node;
+    int index;
+    uint64_t bytes;
+  };
+  std::vector<Candidate> candidates;
+  auto add_candidates = [&](const std::vector<PropertyMemoryUsage>& properties,
+                            const auto& uses, bool node) {
+    for (size_t i = 0; i < properties.size(); ++i) {
+      if (!properties[i].evictable) {
+        continue;
+      }
+      auto it = uses.find(properties[i].name);
+      // properties loaded eagerly and never accessed since are the coldest
+      uint64_t last_use = it == uses.end() ? 0 : it->second;
+      if (keep_last && last_use == property_clock_ && last_use != 0) {
+        continue;
+      }
+      candidates.emplace_back(Candidate{
+          last_use, node, static_cast<int>(i), properties[i].bytes});
+    }
+  };
+  add_candidates(usage.node_properties, node_property_uses_, true);
+  add_candidates(usage.edge_properties, edge_property_uses_, false);
+  std::sort(
+      candidates.begin(), candidates.end(),
+      [](const Candidate& a, const Candidate& b) {
+        return a.last_use < b.last_use;
+      });
+
+  uint64_t evicted = 0;
+  for (const Candidate& candidate : candidates) {
+    if (total - evicted <= memory_budget_) {
+      break;
+    }
+    auto res = candidate.node ? rdg_.UnloadNodeProperty(candidate.index)
+                              : rdg_.UnloadEdgeProperty(candidate.index);
+    if (!res) {
+      return res.error();
+    }
+    GALOIS_LOG_DEBUG(
+        "unloaded {} property {} ({} bytes) to stay within the memory budget",
+        candidate.node ? "node" : "edge",
+        candidate.node ? usage.node_properties[candidate.index].name
+                       : usage.edge_properties[candidate.index].name,
+        candidate.bytes);
+    evicted += candidate.bytes;
+  }
+  if (total - evicted > memory_budget_) {
+    GALOIS_LOG_VERBOSE(
+        "graph holds {} bytes, over its budget of {}, after evicting all "
+        "cold properties",
+        total - evicted, memory_budget_);
+  }
+  return evicted;
+}
+
 galois::Result<void>
 galois::graphs::PropertyFileGraph::AddNodeProperties(
     const std::shared_ptr<arrow::Table>& table) {
-  if (topology_.out_indices &&
-      topology_.out_indices->length() != table->num_rows()) {
+  const std::shared_ptr<arrow::UInt64Array>& indices =
+      HasWideNodeIds() ? topology64_.out_indices : topology_.out_indices;
+  if (indices && indices->length() != table->num_rows()) {
     GALOIS_LOG_DEBUG(
-        "expected {} rows found {} instead", topology_.out_indices->length(),
+        "expected {} rows found {} instead", indices->length(),
         table->num_rows());
     return ErrorCode::InvalidArgument;
   }
@@ -294,29 +1244,448 @@ galois::graphs::PropertyFileGraph::AddNodeProperties(
 galois::Result<void>
 galois::graphs::PropertyFileGraph::AddEdgeProperties(
     const std::shared_ptr<arrow::Table>& table) {
-  if (topology_.out_dests &&
-      topology_.out_dests->length() != table->num_rows()) {
+  bool has_dests = topology_.out_dests || topology64_.out_dests;
+  int64_t num_edges =
+      HasWideNodeIds() ? topology64_.num_edges() : topology_.num_edges();
+  if (has_dests && num_edges != table->num_rows()) {
     GALOIS_LOG_DEBUG(
-        "expected {} rows found {} instead", topology_.out_dests->length(),
-        table->num_rows());
+        "expected {} rows found {} instead", num_edges, table->num_rows());
     return ErrorCode::InvalidArgument;
   }
   return rdg_.AddEdgeProperties(table);
 }
 
+galois::Result<void>
+galois::graphs::PropertyFileGraph::ReplaceNodeProperties(
+    const std::shared_ptr<arrow::Table>& table) {
+  if (table->num_rows() != rdg_.node_table()->num_rows()) {
+    GALOIS_LOG_DEBUG(
+        "expected {} rows found {} instead", rdg_.node_table()->num_rows(),
+        table->num_rows());
+    return ErrorCode::InvalidArgument;
+  }
+  return rdg_.ReplaceNodeProperties(table);
+}
+
+galois::Result<void>
+galois::graphs::PropertyFileGraph::ReplaceEdgeProperties(
+    const std::shared_ptr<arrow::Table>& table) {
+  if (table->num_rows() != rdg_.edge_table()->num_rows()) {
+    GALOIS_LOG_DEBUG(
+        "expected {} rows found {} instead", rdg_.edge_table()->num_rows(),
+        table->num_rows());
+    return ErrorCode::InvalidArgument;
+  }
+  DropInlineEdges();
+  graph_statistics_.clear();
+  return rdg_.ReplaceEdgeProperties(table);
+}
+
 galois::Result<void>
 galois::graphs::PropertyFileGraph::SetTopology(
     const galois::graphs::GraphTopology& topology) {
+  if (topology.edges_sorted_by_dest && !EdgesSortedByDest(topology)) {
+    GALOIS_LOG_DEBUG("topology marked as sorted by destination is not sorted");
+    return ErrorCode::InvalidArgument;
+  }
   if (auto res = rdg_.UnbindTopologyFileStorage(); !res) {
     return res.error();
   }
   topology_ = topology;
+  topology64_ = GraphTopology64{};
+  edge_balanced_ranges_.clear();
+  DropInlineEdges();
+  graph_statistics_.clear();
+
+  if (auto res = DropEdgeTypes(); !res) {
+    return res.error();
+  }
+  return DropInEdges();
+}
 
+galois::Result<void>
+galois::graphs::PropertyFileGraph::SetTopology(
+    const galois::graphs::GraphTopology64& topology) {
+  if (!topology.out_indices) {
+    GALOIS_LOG_DEBUG("topology with 64-bit node ids has no indices");
+    return ErrorCode::InvalidArgument;
+  }
+  if (topology.edges_sorted_by_dest && !EdgesSortedByDest(topology)) {
+    GALOIS_LOG_DEBUG("topology marked as sorted by destination is not sorted");
+    return ErrorCode::InvalidArgument;
+  }
+  if (auto res = rdg_.UnbindTopologyFileStorage(); !res) {
+    return res.error();
+  }
+  topology_ = GraphTopology{};
+  topology64_ = topology;
+  edge_balanced_ranges_.clear();
+  DropInlineEdges();
+  graph_statistics_.clear();
+
+  if (auto res = DropEdgeTypes(); !res) {
+    return res.error();
+  }
+  return DropInEdges();
+}
+
+namespace {
+
+/// The first node of each thread under galois::on_each, then the number of
+/// nodes, and the first edge of each of those nodes
+struct ThreadRanges {
+  std::vector<uint64_t> nodes;
+  std::vector<uint64_t> edges;
+};
+
+ThreadRanges
+MakeThreadRanges(const galois::graphs::GraphTopology& topology) {
+  uint64_t num_nodes = topology.num_nodes();
+  unsigned num_threads = galois::getActiveThreads();
+  ThreadRanges ranges;
+  for (unsigned tid = 0; tid < num_threads; ++tid) {
+    ranges.nodes.emplace_back(
+        galois::block_range(uint64_t{0}, num_nodes, tid, num_threads).first);
+  }
+  ranges.nodes.emplace_back(num_nodes);
+  for (uint64_t n : ranges.nodes) {
+    ranges.edges.emplace_back(n > 0 ? topology.out_indices->Value(n - 1) : 0);
+  }
+  return ranges;
+}
+
+/// Copy the elements of width bytes at data to a new buffer so that their
+/// pages are faulted in on the NUMA nodes that policy gives them: with
+/// kBlocked, thread i copies the elements in [ranges[i], ranges[i + 1]) to
+/// its node; with kInterleaved, the threads copy every num_threads-th page of
+/// substrate::allocSize() bytes in turn
+galois::Result<std::shared_ptr<arrow::Buffer>>
+CopyByThread(
+    const uint8_t* data, uint64_t width, const std::vector<uint64_t>& ranges,
+    galois::graphs::NumaPolicy policy) {
+  // floating memory is not faulted in until it is copied to
+  auto alloc_result = arrow::AllocateBuffer(
+      ranges.back() * width,
+      galois::NumaMemoryPool::Get(galois::NumaMemoryPool::kFloating));
+  if (!alloc_result.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", alloc_result.status());
+    return galois::ErrorCode::ArrowError;
+  }
+  std::shared_ptr<arrow::Buffer> buffer = std::move(alloc_result.ValueOrDie());
+  uint8_t* out = buffer->mutable_data();
+
+  if (policy == galois::graphs::NumaPolicy::kInterleaved) {
+    uint64_t size = ranges.back() * width;
+    uint64_t page_size = galois::substrate::allocSize();
+    galois::on_each([&](unsigned tid, unsigned num_threads) {
+      for (uint64_t begin = tid * page_size; begin < size;
+           begin += num_threads * page_size) {
+        uint64_t end = std::min(begin + page_size, size);
+        std::copy(data + begin, data + end, out + begin);
+      }
+    });
+    return buffer;
+  }
+
+  galois::on_each([&](unsigned tid, unsigned) {
+    uint64_t begin = ranges[tid] * width;
+    uint64_t end = ranges[tid + 1] * width;
+    std::copy(data + begin, data + end, out + begin);
+  });
+  return buffer;
+}
+
+/// Copy the values of column by thread if it is a single chunk of a
+/// fixed-width type (\see CopyByThread); otherwise return it as it is
+galois::Result<std::shared_ptr<arrow::ChunkedArray>>
+DistributeColumn(
+    const std::shared_ptr<arrow::ChunkedArray>& column,
+    const std::vector<uint64_t>& ranges, galois::graphs::NumaPolicy policy) {
+  if (column->num_chunks() != 1) {
+    return column;
+  }
+  const std::shared_ptr<arrow::ArrayData>& data = column->chunk(0)->data();
+  const auto* type =
+      dynamic_cast<const arrow::FixedWidthType*>(data->type.get());
+  if (!type || type->id() == arrow::Type::DICTIONARY ||
+      type->id() == arrow::Type::EXTENSION || type->bit_width() % 8 != 0 ||
+      data->offset != 0 || data->buffers.size() != 2 || !data->buffers[1] ||
+      static_cast<uint64_t>(data->length) != ranges.back()) {
+    return column;
+  }
+
+  auto copy_result = CopyByThread(
+      data->buffers[1]->data(), type->bit_width() / 8, ranges, policy);
+  if (!copy_result) {
+    return copy_result.error();
+  }
+  // the validity bitmap is an eighth of the size of the smallest values, so
+  // it is shared rather than copied
+  auto copy = arrow::ArrayData::Make(
+      data->type, data->length, {data->buffers[0], copy_result.value()},
+      data->null_count);
+  return std::make_shared<arrow::ChunkedArray>(arrow::MakeArray(copy));
+}
+
+galois::Result<std::shared_ptr<arrow::Table>>
+DistributeTable(
+    const std::shared_ptr<arrow::Table>& table,
+    const std::vector<uint64_t>& ranges, galois::graphs::NumaPolicy policy) {
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (const auto& column : table->columns()) {
+    auto res = DistributeColumn(column, ranges, policy);
+    if (!res) {
+      return res.error();
+    }
+    columns.emplace_back(std::move(res.value()));
+  }
+  return arrow::Table::Make(table->schema(), columns, table->num_rows());
+}
+
+/// Make a table with one column, name, of ranges.back() values of
+/// fixed-width type that are not initialized. Thread i faults in the pages
+/// of the values in [ranges[i], ranges[i + 1]) so that they are on its NUMA
+/// node (\see CopyByThread).
+galois::Result<std::shared_ptr<arrow::Table>>
+MakeUninitializedTable(
+    const std::string& name, const std::shared_ptr<arrow::DataType>& type,
+    const std::vector<uint64_t>& ranges) {
+  const auto* fixed = dynamic_cast<const arrow::FixedWidthType*>(type.get());
+  if (!fixed || type->id() == arrow::Type::DICTIONARY ||
+      type->id() == arrow::Type::EXTENSION || fixed->bit_width() % 8 != 0) {
+    GALOIS_LOG_DEBUG("not a fixed-width type: {}", type->ToString());
+    return galois::ErrorCode::InvalidArgument;
+  }
+  uint64_t width = fixed->bit_width() / 8;
+
+  auto alloc_result = arrow::AllocateBuffer(
+      ranges.back() * width,
+      galois::NumaMemoryPool::Get(galois::NumaMemoryPool::kFloating));
+  if (!alloc_result.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", alloc_result.status());
+    return galois::ErrorCode::ArrowError;
+  }
+  std::shared_ptr<arrow::Buffer> buffer = std::move(alloc_result.ValueOrDie());
+  uint8_t* out = buffer->mutable_data();
+
+  // one write per page faults it in
+  uint64_t page_size = sysconf(_SC_PAGESIZE);
+  galois::on_each([&](unsigned tid, unsigned) {
+    uint64_t end = ranges[tid + 1] * width;
+    for (uint64_t b = ranges[tid] * width; b < end; b += page_size) {
+      out[b] = 0;
+    }
+  });
+
+  auto data =
+      arrow::ArrayData::Make(type, ranges.back(), {nullptr, buffer}, 0);
+  return arrow::Table::Make(
+      arrow::schema({arrow::field(name, type)}), {arrow::MakeArray(data)});
+}
+
+}  // namespace
+
+galois::Result<void>
+galois::graphs::PropertyFileGraph::DistributeToNumaNodes(NumaPolicy policy) {
+  if (topology_.num_nodes() == 0) {
+    return galois::ResultSuccess();
+  }
+  ThreadRanges ranges = MakeThreadRanges(topology_);
+
+  auto indices_result = CopyByThread(
+      reinterpret_cast<const uint8_t*>(topology_.out_indices->raw_values()),
+      sizeof(uint64_t), ranges.nodes, policy);
+  if (!indices_result) {
+    return indices_result.error();
+  }
+  auto dests_result = CopyByThread(
+      reinterpret_cast<const uint8_t*>(topology_.out_dests->raw_values()),
+      sizeof(uint32_t), ranges.edges, policy);
+  if (!dests_result) {
+    return dests_result.error();
+  }
+
+  auto node_result = DistributeTable(rdg_.node_table(), ranges.nodes, policy);
+  if (!node_result) {
+    return node_result.error();
+  }
+  auto edge_result = DistributeTable(rdg_.edge_table(), ranges.edges, policy);
+  if (!edge_result) {
+    return edge_result.error();
+  }
+  if (auto res = rdg_.RelocateNodeProperties(node_result.value()); !res) {
+    return res.error();
+  }
+  if (auto res = rdg_.RelocateEdgeProperties(edge_result.value()); !res) {
+    return res.error();
+  }
+
+  // The copies hold the same values, so the topology file, if any, stays
+  // bound and is not written again, and the in-edge index stays valid
+  topology_.out_indices = std::make_shared<arrow::UInt64Array>(
+      topology_.num_nodes(), indices_result.value());
+  topology_.out_dests = std::make_shared<arrow::UInt32Array>(
+      topology_.num_edges(), dests_result.value());
+
+  return galois::ResultSuccess();
+}
+
+galois::Result<void>
+galois::graphs::PropertyFileGraph::AddUninitializedNodeProperty(
+    const std::string& name, const std::shared_ptr<arrow::DataType>& type) {
+  auto table_result =
+      MakeUninitializedTable(name, type, MakeThreadRanges(topology_).nodes);
+  if (!table_result) {
+    return table_result.error();
+  }
+  return AddNodeProperties(table_result.value());
+}
+
+galois::Result<void>
+galois::graphs::PropertyFileGraph::AddUninitializedEdgeProperty(
+    const std::string& name, const std::shared_ptr<arrow::DataType>& type) {
+  auto table_result =
+      MakeUninitializedTable(name, type, MakeThreadRanges(topology_).edges);
+  if (!table_result) {
+    return table_result.error();
+  }
+  return AddEdgeProperties(table_result.value());
+}
+
+galois::Result<void>
+galois::graphs::PropertyFileGraph::MarkEdgesSortedByDest() {
+  if (HasWideNodeIds()) {
+    if (!EdgesSortedByDest(topology64_)) {
+      return ErrorCode::InvalidArgument;
+    }
+    topology64_.edges_sorted_by_dest = true;
+    return galois::ResultSuccess();
+  }
+  if (!EdgesSortedByDest(topology_)) {
+    return ErrorCode::InvalidArgument;
+  }
+  topology_.edges_sorted_by_dest = true;
   return galois::ResultSuccess();
 }
 
+galois::Result<const galois::graphs::InEdgeTopology*>
+galois::graphs::PropertyFileGraph::InEdges() const {
+  if (in_topology_.in_indices) {
+    return &in_topology_;
+  }
+
+  if (rdg_.HasTranspose()) {
+    if (auto res = rdg_.EnsureTransposeLoaded(); !res) {
+      return res.error();
+    }
+    auto map_result = MapInEdges(rdg_.transpose_file_storage(), topology_);
+    if (!map_result) {
+      return map_result.error();
+    }
+    in_topology_ = std::move(map_result.value());
+    return &in_topology_;
+  }
+
+  auto build_result = BuildInEdges(topology_);
+  if (!build_result) {
+    return build_result.error();
+  }
+  in_topology_ = std::move(build_result.value());
+  return &in_topology_;
+}
+
+galois::Result<void>
+galois::graphs::PropertyFileGraph::DropInEdges() {
+  in_topology_ = InEdgeTopology{};
+  return rdg_.DropTranspose();
+}
+
+galois::Result<std::shared_ptr<const galois::graphs::EdgeTypeIndex>>
+galois::graphs::PropertyFileGraph::EdgeTypes(
+    const std::vector<std::string>& types) const {
+  if (edge_types_ && edge_types_->HasTypes(types)) {
+    return edge_types_;
+  }
+
+  if (rdg_.HasEdgeTypeIndex() && !edge_types_mapped_) {
+    if (auto res = rdg_.EnsureEdgeTypeIndexLoaded(); !res) {
+      return res.error();
+    }
+    auto map_result =
+        EdgeTypeIndex::Map(*this, rdg_.edge_type_index_file_storage());
+    if (!map_result) {
+      return map_result.error();
+    }
+    if (map_result.value()->HasTypes(types)) {
+      edge_types_ = std::move(map_result.value());
+      edge_types_mapped_ = true;
+      return edge_types_;
+    }
+  }
+
+  auto build_result = EdgeTypeIndex::Make(*this, types);
+  if (!build_result) {
+    return build_result.error();
+  }
+  edge_types_ = std::move(build_result.value());
+  edge_types_mapped_ = false;
+  return edge_types_;
+}
+
+galois::Result<std::shared_ptr<const galois::graphs::InlineEdgeIndex>>
+galois::graphs::PropertyFileGraph::InlineEdges(
+    const std::string& property) const {
+  if (inline_edges_ && inline_edges_->property() == property) {
+    return inline_edges_;
+  }
+  auto build_result = InlineEdgeIndex::Make(*this, property);
+  if (!build_result) {
+    return build_result.error();
+  }
+  inline_edges_ = std::move(build_result.value());
+  return inline_edges_;
+}
+
+galois::Result<void>
+galois::graphs::PropertyFileGraph::DropEdgeTypes() {
+  edge_types_.reset();
+  edge_types_mapped_ = false;
+  return rdg_.DropEdgeTypeIndex();
+}
+
+const std::vector<uint32_t>&
+galois::graphs::PropertyFileGraph::EdgeBalancedRanges() const {
+  unsigned num_threads = galois::getActiveThreads();
+  if (edge_balanced_ranges_.size() == num_threads + 1) {
+    return edge_balanced_ranges_;
+  }
+
+  uint64_t num_nodes = topology_.num_nodes();
+  edge_balanced_ranges_.assign(num_threads + 1, num_nodes);
+  if (num_nodes == 0) {
+    return edge_balanced_ranges_;
+  }
+
+  // The first n nodes weigh out_indices[n - 1] + n. Thread tid starts at the
+  // first node where that prefix reaches tid / num_threads of the total.
+  const uint64_t* indices = topology_.out_indices->raw_values();
+  uint64_t total_weight = topology_.num_edges() + num_nodes;
+  galois::on_each([&](unsigned tid, unsigned) {
+    uint64_t target = total_weight * tid / num_threads;
+    edge_balanced_ranges_[tid] = internal::findIndexPrefixSum(
+        1, 1, target, 0, num_nodes, indices, 0, 0);
+  });
+  return edge_balanced_ranges_;
+}
+
 galois::Result<std::vector<uint64_t>>
 galois::graphs::SortAllEdgesByDest(galois::graphs::PropertyFileGraph* pfg) {
+  std::vector<uint64_t> permutation_vec(pfg->topology().num_edges());
+  std::iota(permutation_vec.begin(), permutation_vec.end(), uint64_t{0});
+  if (pfg->topology().edges_sorted_by_dest) {
+    return permutation_vec;
+  }
+
   auto view_result_dests =
       galois::ConstructPropertyView<galois::UInt32Property>(
           pfg->topology().out_dests.get());
@@ -326,8 +1695,6 @@ galois::graphs::SortAllEdgesByDest(galois::graphs::PropertyFileGraph* pfg) {
 
   auto out_dests_view = std::move(view_result_dests.value());
 
-  std::vector<uint64_t> permutation_vec(pfg->topology().num_edges());
-  std::iota(permutation_vec.begin(), permutation_vec.end(), uint64_t{0});
   auto comparator = [&](uint64_t a, uint64_t b) {
     return out_dests_view[a] < out_dests_view[b];
   };
@@ -345,6 +1712,18 @@ galois::graphs::SortAllEdgesByDest(galois::graphs::PropertyFileGraph* pfg) {
       },
       galois::steal());
 
+  // out-edge ids changed under the in-edge, edge type and inline indices
+  pfg->DropInlineEdges();
+  if (auto res = pfg->DropInEdges(); !res) {
+    return res.error();
+  }
+  if (auto res = pfg->DropEdgeTypes(); !res) {
+    return res.error();
+  }
+  if (auto res = pfg->MarkEdgesSortedByDest(); !res) {
+    return res.error();
+  }
+
   return permutation_vec;
 }
 
@@ -462,5 +1841,12 @@ galois::graphs::SortNodesByDegree(galois::graphs::PropertyFileGraph* pfg) {
         out_dests_view[edge_id] = new_out_dest[edge_id];
       });
 
-  return galois::ResultSuccess();
+  // relabeling destinations breaks their order within each node
+  pfg->UnmarkEdgesSortedByDest();
+  pfg->DropInlineEdges();
+
+  if (auto res = pfg->DropEdgeTypes(); !res) {
+    return res.error();
+  }
+  return pfg->DropInEdges();
 }
@@ -20,7 +20,13 @@
 #include "galois/substrate/SharedMem.h"
 
 #include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
 
+#include "galois/Env.h"
+#include "galois/Logging.h"
+#include "galois/Trace.h"
 #include "galois/substrate/Barrier.h"
 #include "galois/substrate/PagePool.h"
 #include "galois/substrate/TerminationDetection.h"
@@ -96,10 +102,17 @@ public:
   }
 };
 
-// Dijkstra style 2-pass tree termination detection
+// Dijkstra style 2-pass tree termination detection. Tokens go down from the
+// master to every thread and back up, so a pass takes time logarithmic in the
+// number of threads rather than linear as with the ring. By default the tree
+// is a binary tree over thread ids; when it follows the topology, the threads
+// of each socket form a binary tree under the first of them and those roots a
+// binary tree under the master, so that only the edges between the roots cross
+// sockets.
 class TreeTerminationDetection
     : public galois::substrate::TerminationDetection {
-  static constexpr int kNumChildren = 2;
+  // two children within a socket and two on other sockets
+  static constexpr int kNumChildren = 4;
 
   struct TokenHolder {
     // incoming from above
@@ -115,9 +128,64 @@ class TreeTerminationDetection
     TokenHolder* child[kNumChildren];
   };
 
+  // Position of a thread in the tree
+  struct Node {
+    int parent{0};
+    int parent_offset{0};
+    int child[kNumChildren]{-1, -1, -1, -1};
+  };
+
   galois::substrate::PerThreadStorage<TokenHolder> data_;
 
-  unsigned active_threads_;
+  bool follow_topology_;
+  unsigned active_threads_{0};
+  std::vector<Node> tree_;
+
+  // Makes the threads in group a binary tree under group[0], using children
+  // first_child and first_child + 1 of each parent
+  void LinkBinaryTree(const std::vector<unsigned>& group, int first_child) {
+    for (size_t i = 1; i < group.size(); ++i) {
+      size_t parent = (i - 1) / 2;
+      int offset = first_child + (i - 1) % 2;
+      tree_[group[i]].parent = group[parent];
+      tree_[group[i]].parent_offset = offset;
+      tree_[group[parent]].child[offset] = group[i];
+    }
+  }
+
+  void BuildTree() {
+    tree_.assign(active_threads_, Node{});
+    std::vector<unsigned> all(active_threads_);
+    std::iota(all.begin(), all.end(), 0);
+    if (!follow_topology_) {
+      LinkBinaryTree(all, 0);
+      return;
+    }
+
+    // threads grouped by socket in order of their first thread, which is the
+    // root of the group; so the group of the master comes first
+    auto& pool = galois::substrate::GetThreadPool();
+    std::vector<std::vector<unsigned>> groups;
+    std::vector<int> group_of_socket;
+    for (unsigned tid : all) {
+      unsigned socket = pool.getSocket(tid);
+      if (socket >= group_of_socket.size()) {
+        group_of_socket.resize(socket + 1, -1);
+      }
+      if (group_of_socket[socket] < 0) {
+        group_of_socket[socket] = groups.size();
+        groups.emplace_back();
+      }
+      groups[group_of_socket[socket]].push_back(tid);
+    }
+
+    std::vector<unsigned> roots;
+    for (const auto& group : groups) {
+      LinkBinaryTree(group, 0);
+      roots.push_back(group[0]);
+    }
+    LinkBinaryTree(roots, 2);
+  }
 
   void ProcessToken() {
     TokenHolder& th = *data_.getLocal();
@@ -169,10 +237,16 @@ class TreeTerminationDetection
 
 protected:
   void Init(unsigned active_threads) override {
-    active_threads_ = active_threads;
+    if (active_threads != active_threads_) {
+      active_threads_ = active_threads;
+      BuildTree();
+    }
   }
 
 public:
+  explicit TreeTerminationDetection(bool follow_topology)
+      : follow_topology_(follow_topology) {}
+
   void InitializeThread() override {
     TokenHolder& th = *data_.getLocal();
     th.down_token = false;
@@ -184,15 +258,12 @@ public:
     th.last_was_white = false;
     ResetTerminated();
     auto tid = galois::substrate::ThreadPool::getTID();
-    th.parent = (tid - 1) / kNumChildren;
-    th.parent_offset = (tid - 1) % kNumChildren;
-    for (unsigned i = 0; i < kNumChildren; ++i) {
-      unsigned cn = tid * kNumChildren + i + 1;
-      if (cn < active_threads_) {
-        th.child[i] = data_.getRemote(cn);
-      } else {
-        th.child[i] = 0;
-      }
+    const Node& node = tree_[tid];
+    th.parent = node.parent;
+    th.parent_offset = node.parent_offset;
+    for (int i = 0; i < kNumChildren; ++i) {
+      th.child[i] =
+          node.child[i] < 0 ? nullptr : data_.getRemote(node.child[i]);
     }
     if (IsSysMaster()) {
       th.down_token = true;
@@ -207,11 +278,113 @@ public:
   }
 };
 
+// Chooses the termination detection by GALOIS_TERMINATION
+std::unique_ptr<galois::substrate::TerminationDetection>
+MakeTerminationDetection() {
+  std::string kind;
+  if (!galois::GetEnv("GALOIS_TERMINATION", &kind) || kind == "ring") {
+    return std::make_unique<LocalTerminationDetection>();
+  }
+  if (kind == "tree") {
+    return std::make_unique<TreeTerminationDetection>(false);
+  }
+  if (kind == "topo") {
+    return std::make_unique<TreeTerminationDetection>(true);
+  }
+  GALOIS_LOG_WARN("unknown GALOIS_TERMINATION value {}, using ring", kind);
+  return std::make_unique<LocalTerminationDetection>();
+}
+
+/// Records the waits at another barrier in the trace
+class TracedBarrier : public galois::substrate::Barrier {
+  std::unique_ptr<galois::substrate::Barrier> inner_;
+
+public:
+  explicit TracedBarrier(std::unique_ptr<galois::substrate::Barrier> inner)
+      : inner_(std::move(inner)) {}
+
+  void Reinit(unsigned val) override { inner_->Reinit(val); }
+
+  void Wait() override {
+    galois::TraceScope trace("barrier", inner_->name());
+    inner_->Wait();
+  }
+
+  const char* name() const override { return inner_->name(); }
+};
+
+/// Chooses the fastest barrier (\see CreateFastestBarrier) when a loop first
+/// needs one on more than one thread rather than when the runtime starts,
+/// since timing the barriers starts the threads they run on
+class AutoBarrier : public galois::substrate::Barrier {
+  std::unique_ptr<galois::substrate::Barrier> inner_;
+
+public:
+  void Reinit(unsigned val) override {
+    if (!inner_ && val > 1) {
+      // timing runs the thread pool, which a running loop holds
+      if (galois::substrate::GetThreadPool().isRunning()) {
+        inner_ = galois::substrate::CreateTopoBarrier(val);
+      } else {
+        inner_ = galois::substrate::CreateFastestBarrier(val);
+      }
+    }
+    if (inner_) {
+      inner_->Reinit(val);
+    }
+  }
+
+  // before a barrier is chosen there is one thread, which need not wait
+  void Wait() override {
+    if (inner_) {
+      inner_->Wait();
+    }
+  }
+
+  const char* name() const override {
+    return inner_ ? inner_->name() : "AutoBarrier";
+  }
+};
+
+// Chooses the barrier by GALOIS_BARRIER
+std::unique_ptr<galois::substrate::Barrier>
+MakeUntracedBarrier(unsigned active_threads) {
+  std::string kind;
+  if (!galois::GetEnv("GALOIS_BARRIER", &kind) || kind == "auto") {
+    return std::make_unique<AutoBarrier>();
+  }
+  if (kind == "topo") {
+    return galois::substrate::CreateTopoBarrier(active_threads);
+  }
+  if (kind == "mcs") {
+    return galois::substrate::CreateMCSBarrier(active_threads);
+  }
+  if (kind == "dissemination") {
+    return galois::substrate::CreateDisseminationBarrier(active_threads);
+  }
+  if (kind == "counting") {
+    return galois::substrate::CreateCountingBarrier(active_threads);
+  }
+  GALOIS_LOG_WARN("unknown GALOIS_BARRIER value {}, using auto", kind);
+  return std::make_unique<AutoBarrier>();
+}
+
+// Waits only go through TracedBarrier if tracing is on from the start, so
+// that untraced runs do not pay for the extra call
+std::unique_ptr<galois::substrate::Barrier>
+MakeBarrier(unsigned active_threads) {
+  auto barrier = MakeUntracedBarrier(active_threads);
+  if (galois::TraceEnabled()) {
+    return std::make_unique<TracedBarrier>(std::move(barrier));
+  }
+  return barrier;
+}
+
 }  // namespace
 
 struct galois::substrate::SharedMem::Impl {
   struct Dependents {
-    LocalTerminationDetection term;
+    std::unique_ptr<TerminationDetection> term;
     std::unique_ptr<Barrier> barrier;
     internal::PageAllocState<> page_pool;
   };
@@ -226,11 +399,12 @@ galois::substrate::SharedMem::SharedMem() : impl_(std::make_unique<Impl>()) {
   // The thread pool must be initialized first because other substrate classes
   // may call GetThreadPool() in their constructors
   impl_->deps = std::make_unique<Impl::Dependents>();
-  impl_->deps->barrier = galois::substrate::CreateTopoBarrier(
-      impl_->thread_pool.getMaxUsableThreads());
+  impl_->deps->term = MakeTerminationDetection();
+  impl_->deps->barrier =
+      MakeBarrier(impl_->thread_pool.getMaxUsableThreads());
 
   internal::SetBarrier(impl_->deps->barrier.get());
-  internal::SetTerminationDetection(&impl_->deps->term);
+  internal::SetTerminationDetection(impl_->deps->term.get());
   internal::setPagePoolState(&impl_->deps->page_pool);
 }
 
@@ -20,32 +20,144 @@
 #include "galois/SharedMemSys.h"
 
 #include "galois/CommBackend.h"
+#include "galois/Env.h"
 #include "galois/Logging.h"
+#include "galois/NumaMemoryPool.h"
 #include "galois/Statistics.h"
+#include "galois/StatsServer.h"
+#include "galois/Tsc.h"
 #include "galois/substrate/SharedMem.h"
 #include "tsuba/FileStorage.h"
+#include "tsuba/IOStats.h"
+#include "tsuba/MemoryPool.h"
+#include "tsuba/WriteGroup.h"
+#include "tsuba/file.h"
 #include "tsuba/tsuba.h"
 
 namespace {
 
 galois::NullCommBackend comm_backend;
 
+/// Report the counters of each backend, class and operation of tsuba I/O
+/// as statistics of the region TsubaIO named, e.g., s3.topology.get.Bytes
+void
+ReportTsubaIOStats() {
+  for (const tsuba::IOStatsEntry& entry : tsuba::GetIOStats()) {
+    std::string prefix = entry.backend + "." +
+                         tsuba::IOClassName(entry.io_class) + "." +
+                         tsuba::IOOpName(entry.op);
+    const tsuba::IOOpStats& stats = entry.stats;
+    galois::ReportStatSingle("TsubaIO", prefix + ".Ops", stats.ops);
+    galois::ReportStatSingle("TsubaIO", prefix + ".Bytes", stats.bytes);
+    galois::ReportStatSingle("TsubaIO", prefix + ".Errors", stats.errors);
+    galois::ReportStatSingle(
+        "TsubaIO", prefix + ".LatencyUsec", stats.latency_sum_usec);
+    // per operation, so concurrent operations add up to more than this
+    if (stats.latency_sum_usec > 0) {
+      galois::ReportStatSingle(
+          "TsubaIO", prefix + ".MBPerSec",
+          static_cast<double>(stats.bytes) / stats.latency_sum_usec);
+    }
+    galois::internal::sysStatManager()->AddTimings(
+        "TsubaIO", prefix, stats.latency_buckets.data(),
+        stats.latency_buckets.size(), stats.latency_sum_usec);
+  }
+}
+
+void
+ReportTsubaStats() {
+  ReportTsubaIOStats();
+
+  if (uint64_t peak = tsuba::WriteGroup::MaxPeakInflightBytes(); peak > 0) {
+    galois::ReportStatSingle("Tsuba", "WritePeakInflightBytes", peak);
+  }
+
+  tsuba::BlockCacheStats cache_stats = tsuba::GetBlockCacheStats();
+  if (cache_stats.hits != 0 || cache_stats.misses != 0) {
+    galois::ReportStatSingle("Tsuba", "BlockCacheHits", cache_stats.hits);
+    galois::ReportStatSingle("Tsuba", "BlockCacheMisses", cache_stats.misses);
+    galois::ReportStatSingle(
+        "Tsuba", "BlockCacheEvictions", cache_stats.evictions);
+  }
+
+  tsuba::DiskCacheStats disk_stats = tsuba::GetDiskCacheStats();
+  if (disk_stats.hits != 0 || disk_stats.misses != 0) {
+    galois::ReportStatSingle("Tsuba", "DiskCacheHits", disk_stats.hits);
+    galois::ReportStatSingle("Tsuba", "DiskCacheMisses", disk_stats.misses);
+    galois::ReportStatSingle(
+        "Tsuba", "DiskCacheEvictions", disk_stats.evictions);
+  }
+}
+
+/// The pool named by GALOIS_ARROW_MEMORY_POOL, or nullptr to keep arrow's
+/// default pool
+galois::NumaMemoryPool*
+ArrowMemoryPoolFromEnv() {
+  std::string value;
+  if (!galois::GetEnv("GALOIS_ARROW_MEMORY_POOL", &value) ||
+      value == "default") {
+    return nullptr;
+  }
+  if (value == "blocked") {
+    return galois::NumaMemoryPool::Get(galois::NumaMemoryPool::kBlocked);
+  }
+  if (value == "local") {
+    return galois::NumaMemoryPool::Get(galois::NumaMemoryPool::kLocal);
+  }
+  if (value == "interleaved") {
+    return galois::NumaMemoryPool::Get(galois::NumaMemoryPool::kInterleaved);
+  }
+  if (value == "floating") {
+    return galois::NumaMemoryPool::Get(galois::NumaMemoryPool::kFloating);
+  }
+  GALOIS_LOG_WARN(
+      "unknown GALOIS_ARROW_MEMORY_POOL value {}, using default", value);
+  return nullptr;
+}
+
 }  // namespace
 
 struct galois::SharedMemSys::Impl {
   galois::substrate::SharedMem shared_mem;
   galois::StatManager stat_manager;
+  galois::NumaMemoryPool* arrow_pool{};
+  std::unique_ptr<galois::StatsServer> stats_server;
 };
 
 galois::SharedMemSys::SharedMemSys() : impl_(std::make_unique<Impl>()) {
+  galois::CalibrateTsc();
+
   if (auto init_good = tsuba::Init(&comm_backend); !init_good) {
     GALOIS_LOG_FATAL("tsuba::Init: {}", init_good.error());
   }
 
   galois::internal::setSysStatManager(&impl_->stat_manager);
+
+  if (int port = 0; galois::GetEnv("GALOIS_STATS_PROMETHEUS_PORT", &port)) {
+    auto server = galois::StatsServer::Make(port);
+    if (server) {
+      impl_->stats_server = std::move(server.value());
+    } else {
+      GALOIS_LOG_ERROR(
+          "cannot serve stats on port {}: {}", port, server.error());
+    }
+  }
+
+  // After shared_mem, so that the pool can page in with the thread pool
+  impl_->arrow_pool = ArrowMemoryPoolFromEnv();
+  if (impl_->arrow_pool) {
+    tsuba::SetArrowMemoryPool(impl_->arrow_pool);
+  }
 }
 
 galois::SharedMemSys::~SharedMemSys() {
+  impl_->stats_server.reset();
+  ReportTsubaStats();
+  if (impl_->arrow_pool) {
+    galois::ReportStatSingle(
+        "ArrowMemoryPool", "PeakBytes", impl_->arrow_pool->max_memory());
+    tsuba::SetArrowMemoryPool(nullptr);
+  }
   galois::PrintStats();
   galois::internal::setSysStatManager(nullptr);
 
@@ -0,0 +1,363 @@
+#include "galois/graphs/SharedMemoryGraph.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <arrow/api.h>
+#include <arrow/io/api.h>
+#include <arrow/ipc/api.h>
+
+#include "galois/ErrorCode.h"
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+
+namespace {
+
+/// "KGSM" followed by the format version
+constexpr uint64_t kMagic = UINT64_C(0x4b47534d00000001);
+// IPC buffers need at least 8 byte alignment
+constexpr uint64_t kAlignment = 64;
+constexpr uint64_t kCopyBlockSize = UINT64_C(16) << 20;
+
+/// The start of an exported graph. The topology arrays follow it; then the
+/// node and the edge property tables are stored as IPC streams. Offsets are
+/// from the start of the object.
+struct Header {
+  uint64_t magic;
+  uint64_t size;
+  uint64_t num_nodes;
+  uint64_t num_edges;
+  uint64_t edges_sorted_by_dest;
+  uint64_t out_indices_offset;
+  uint64_t out_dests_offset;
+  uint64_t node_table_offset;
+  uint64_t node_table_size;
+  uint64_t edge_table_offset;
+  uint64_t edge_table_size;
+};
+
+/// A buffer over the whole mapped object; arrays point into slices of it,
+/// which keep it mapped
+class MappedBuffer : public arrow::Buffer {
+public:
+  MappedBuffer(void* base, int64_t size)
+      : arrow::Buffer(static_cast<const uint8_t*>(base), size), base_(base) {}
+
+  MappedBuffer(const MappedBuffer& no_copy) = delete;
+  MappedBuffer& operator=(const MappedBuffer& no_copy) = delete;
+
+  ~MappedBuffer() override { munmap(base_, size_); }
+
+private:
+  void* base_;
+};
+
+uint64_t
+Align(uint64_t offset) {
+  return (offset + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+std::string
+ObjectName(const std::string& name) {
+  // shm_open expects a name with exactly one leading slash
+  if (!name.empty() && name[0] == '/') {
+    return name;
+  }
+  return "/" + name;
+}
+
+void
+ParallelCopy(uint8_t* dest, const void* src, uint64_t size) {
+  const auto* from = static_cast<const uint8_t*>(src);
+  uint64_t num_blocks = (size + kCopyBlockSize - 1) / kCopyBlockSize;
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t block) {
+        uint64_t begin = block * kCopyBlockSize;
+        std::memcpy(
+            dest + begin, from + begin, std::min(kCopyBlockSize, size - begin));
+      },
+      galois::no_stats());
+}
+
+galois::Result<void>
+WriteIpc(
+    const arrow::Table& table,
+    const std::shared_ptr<arrow::io::OutputStream>& sink) {
+  auto writer_result = arrow::ipc::MakeStreamWriter(sink, table.schema());
+  if (!writer_result.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", writer_result.status());
+    return galois::ErrorCode::ArrowError;
+  }
+  std::shared_ptr<arrow::ipc::RecordBatchWriter> writer =
+      writer_result.ValueOrDie();
+  if (auto status = writer->WriteTable(table); !status.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", status);
+    return galois::ErrorCode::ArrowError;
+  }
+  if (auto status = writer->Close(); !status.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", status);
+    return galois::ErrorCode::ArrowError;
+  }
+  return galois::ResultSuccess();
+}
+
+/// IpcSize returns the number of bytes that WriteIpc writes for table without
+/// copying any values
+galois::Result<uint64_t>
+IpcSize(const arrow::Table& table) {
+  auto sink = std::make_shared<arrow::io::MockOutputStream>();
+  if (auto res = WriteIpc(table, sink); !res) {
+    return res.error();
+  }
+  return sink->GetExtentBytesWritten();
+}
+
+galois::Result<void>
+WriteIpcAt(const arrow::Table& table, uint8_t* dest, uint64_t size) {
+  auto sink = std::make_shared<arrow::io::FixedSizeBufferWriter>(
+      std::make_shared<arrow::MutableBuffer>(dest, size));
+  sink->set_memcopy_threads(galois::getActiveThreads());
+  return WriteIpc(table, sink);
+}
+
+galois::Result<std::shared_ptr<arrow::Table>>
+ReadIpc(const std::shared_ptr<arrow::Buffer>& buffer) {
+  // BufferReader returns slices of buffer, so the arrays are not copied
+  auto reader_result = arrow::ipc::RecordBatchStreamReader::Open(
+      std::make_shared<arrow::io::BufferReader>(buffer));
+  if (!reader_result.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", reader_result.status());
+    return galois::ErrorCode::ArrowError;
+  }
+  std::shared_ptr<arrow::RecordBatchReader> reader =
+      reader_result.ValueOrDie();
+
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  while (true) {
+    std::shared_ptr<arrow::RecordBatch> batch;
+    if (auto status = reader->ReadNext(&batch); !status.ok()) {
+      GALOIS_LOG_DEBUG("arrow error: {}", status);
+      return galois::ErrorCode::ArrowError;
+    }
+    if (!batch) {
+      break;
+    }
+    batches.emplace_back(std::move(batch));
+  }
+
+  auto table_result =
+      arrow::Table::FromRecordBatches(reader->schema(), batches);
+  if (!table_result.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", table_result.status());
+    return galois::ErrorCode::ArrowError;
+  }
+  return table_result.ValueOrDie();
+}
+
+galois::Result<void>
+Fill(
+    int fd, Header header, const galois::graphs::GraphTopology& topology,
+    const arrow::Table& node_table, const arrow::Table& edge_table) {
+  // Reserve the pages now so that running out of shared memory is an error
+  // rather than a SIGBUS while copying
+  if (int err = posix_fallocate(fd, 0, header.size); err != 0) {
+    GALOIS_LOG_DEBUG("posix_fallocate: {}", std::strerror(err));
+    return std::error_code(err, std::system_category());
+  }
+  void* ptr =
+      mmap(nullptr, header.size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (ptr == MAP_FAILED) {
+    GALOIS_LOG_DEBUG("mmap: {}", std::strerror(errno));
+    return galois::ResultErrno();
+  }
+  auto* base = static_cast<uint8_t*>(ptr);
+
+  if (header.num_nodes > 0) {
+    ParallelCopy(
+        base + header.out_indices_offset, topology.out_indices->raw_values(),
+        header.num_nodes * sizeof(uint64_t));
+  }
+  if (header.num_edges > 0) {
+    ParallelCopy(
+        base + header.out_dests_offset, topology.out_dests->raw_values(),
+        header.num_edges * sizeof(uint32_t));
+  }
+
+  auto res = WriteIpcAt(
+      node_table, base + header.node_table_offset, header.node_table_size);
+  if (res) {
+    res = WriteIpcAt(
+        edge_table, base + header.edge_table_offset, header.edge_table_size);
+  }
+  if (res) {
+    // The magic goes in last: attaching fails until the graph is complete
+    header.magic = kMagic;
+    std::memcpy(base, &header, sizeof(header));
+  }
+
+  munmap(ptr, header.size);
+  return res;
+}
+
+}  // namespace
+
+galois::Result<void>
+galois::graphs::ExportToSharedMemory(
+    const PropertyFileGraph& pfg, const std::string& name) {
+  if (auto res = pfg.EnsureNodePropertiesLoaded(pfg.NodePropertyNames());
+      !res) {
+    return res.error();
+  }
+  if (auto res = pfg.EnsureEdgePropertiesLoaded(pfg.EdgePropertyNames());
+      !res) {
+    return res.error();
+  }
+  const GraphTopology& topology = pfg.topology();
+
+  auto node_size = IpcSize(*pfg.node_table());
+  if (!node_size) {
+    return node_size.error();
+  }
+  auto edge_size = IpcSize(*pfg.edge_table());
+  if (!edge_size) {
+    return edge_size.error();
+  }
+
+  Header header{};
+  header.num_nodes = topology.num_nodes();
+  header.num_edges = topology.num_edges();
+  header.edges_sorted_by_dest = topology.edges_sorted_by_dest;
+  header.out_indices_offset = Align(sizeof(Header));
+  header.out_dests_offset =
+      Align(header.out_indices_offset + header.num_nodes * sizeof(uint64_t));
+  header.node_table_offset =
+      Align(header.out_dests_offset + header.num_edges * sizeof(uint32_t));
+  header.node_table_size = node_size.value();
+  header.edge_table_offset =
+      Align(header.node_table_offset + header.node_table_size);
+  header.edge_table_size = edge_size.value();
+  header.size = header.edge_table_offset + header.edge_table_size;
+
+  std::string object_name = ObjectName(name);
+  int fd = shm_open(object_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) {
+    if (errno == EEXIST) {
+      return ErrorCode::AlreadyExists;
+    }
+    GALOIS_LOG_DEBUG("shm_open {}: {}", object_name, std::strerror(errno));
+    return ResultErrno();
+  }
+
+  auto res =
+      Fill(fd, header, topology, *pfg.node_table(), *pfg.edge_table());
+  close(fd);
+  if (!res) {
+    shm_unlink(object_name.c_str());
+    return res.error();
+  }
+  return ResultSuccess();
+}
+
+galois::Result<std::unique_ptr<galois::graphs::PropertyFileGraph>>
+galois::graphs::AttachSharedMemory(const std::string& name) {
+  std::string object_name = ObjectName(name);
+  int fd = shm_open(object_name.c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    if (errno == ENOENT) {
+      return ErrorCode::NotFound;
+    }
+    GALOIS_LOG_DEBUG("shm_open {}: {}", object_name, std::strerror(errno));
+    return ResultErrno();
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    GALOIS_LOG_DEBUG("fstat {}: {}", object_name, std::strerror(errno));
+    auto err = ResultErrno();
+    close(fd);
+    return err;
+  }
+  uint64_t size = st.st_size;
+  if (size < sizeof(Header)) {
+    close(fd);
+    GALOIS_LOG_DEBUG("{} is too small to hold a graph", object_name);
+    return ErrorCode::InvalidArgument;
+  }
+
+  void* ptr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (ptr == MAP_FAILED) {
+    GALOIS_LOG_DEBUG("mmap: {}", std::strerror(errno));
+    return ResultErrno();
+  }
+  auto buffer = std::make_shared<MappedBuffer>(ptr, size);
+
+  Header header;
+  std::memcpy(&header, buffer->data(), sizeof(header));
+  if (header.magic != kMagic || header.size != size) {
+    GALOIS_LOG_DEBUG("{} does not hold a complete graph", object_name);
+    return ErrorCode::InvalidArgument;
+  }
+
+  GraphTopology topology;
+  topology.out_indices = std::make_shared<arrow::UInt64Array>(
+      header.num_nodes,
+      arrow::SliceBuffer(
+          buffer, header.out_indices_offset,
+          header.num_nodes * sizeof(uint64_t)));
+  topology.out_dests = std::make_shared<arrow::UInt32Array>(
+      header.num_edges,
+      arrow::SliceBuffer(
+          buffer, header.out_dests_offset,
+          header.num_edges * sizeof(uint32_t)));
+  topology.edges_sorted_by_dest = header.edges_sorted_by_dest != 0;
+
+  auto pfg = std::make_unique<PropertyFileGraph>();
+  if (auto res = pfg->SetTopology(topology); !res) {
+    return res.error();
+  }
+
+  auto node_table = ReadIpc(arrow::SliceBuffer(
+      buffer, header.node_table_offset, header.node_table_size));
+  if (!node_table) {
+    return node_table.error();
+  }
+  if (node_table.value()->num_columns() > 0) {
+    if (auto res = pfg->AddNodeProperties(node_table.value()); !res) {
+      return res.error();
+    }
+  }
+
+  auto edge_table = ReadIpc(arrow::SliceBuffer(
+      buffer, header.edge_table_offset, header.edge_table_size));
+  if (!edge_table) {
+    return edge_table.error();
+  }
+  if (edge_table.value()->num_columns() > 0) {
+    if (auto res = pfg->AddEdgeProperties(edge_table.value()); !res) {
+      return res.error();
+    }
+  }
+
+  return std::unique_ptr<PropertyFileGraph>(std::move(pfg));
+}
+
+galois::Result<void>
+galois::graphs::RemoveSharedMemory(const std::string& name) {
+  std::string object_name = ObjectName(name);
+  if (shm_unlink(object_name.c_str()) != 0) {
+    if (errno == ENOENT) {
+      return ErrorCode::NotFound;
+    }
+    GALOIS_LOG_DEBUG("shm_unlink {}: {}", object_name, std::strerror(errno));
+    return ResultErrno();
+  }
+  return ResultSuccess();
+}
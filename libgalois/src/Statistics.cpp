@@ -22,13 +22,24 @@
 #include <sys/resource.h>
 #include <sys/time.h>
 
+#include <algorithm>
+#include <array>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
 
 #include "galois/Env.h"
+#include "galois/JSON.h"
 #include "galois/Logging.h"
+#include "galois/Trace.h"
 #include "galois/runtime/Executor_OnEach.h"
+#include "galois/substrate/PageAlloc.h"
 #include "galois/substrate/PerThreadStorage.h"
+#include "galois/substrate/SimpleLock.h"
 
 namespace {
 
@@ -44,6 +55,80 @@ PrintHeader(std::ostream& out, const char* sep) {
   out << "\n";
 }
 
+galois::StatManager::Format
+FormatFromEnv() {
+  std::string value;
+  if (!galois::GetEnv("GALOIS_STATS_FORMAT", &value) || value == "csv") {
+    return galois::StatManager::Format::kCSV;
+  }
+  if (value == "json") {
+    return galois::StatManager::Format::kJSON;
+  }
+  GALOIS_LOG_WARN("unknown GALOIS_STATS_FORMAT value {}, using csv", value);
+  return galois::StatManager::Format::kCSV;
+}
+
+std::string
+ToString(const galois::gstl::Str& s) {
+  return std::string(s.data(), s.size());
+}
+
+template <typename T>
+nlohmann::json
+ToJSON(const T& value) {
+  return value;
+}
+
+nlohmann::json
+ToJSON(const galois::gstl::Str& value) {
+  return ToString(value);
+}
+
+/// The values that the threads reported for one statistic so far
+template <typename T>
+struct SnapshotStat {
+  galois::StatTotal::Type type{};
+  std::vector<std::pair<unsigned, T>> thread_values;
+
+  T total() const {
+    if constexpr (std::is_same_v<T, galois::gstl::Str>) {
+      return thread_values.empty() ? T() : thread_values[0].second;
+    } else {
+      if (thread_values.empty() || type == galois::StatTotal::SINGLE) {
+        return thread_values.empty() ? T() : thread_values[0].second;
+      }
+      T min = thread_values[0].second;
+      T max = min;
+      T sum{};
+      for (const auto& [tid, v] : thread_values) {
+        min = std::min(min, v);
+        max = std::max(max, v);
+        sum += v;
+      }
+      switch (type) {
+      case galois::StatTotal::TMIN:
+        return min;
+      case galois::StatTotal::TMAX:
+        return max;
+      case galois::StatTotal::TAVG:
+        return sum / T(thread_values.size());
+      default:
+        return sum;
+      }
+    }
+  }
+};
+
+template <typename T>
+using Snapshot =
+    std::map<std::pair<std::string, std::string>, SnapshotStat<T>>;
+
+/// The live StatHandles of a StatManager
+struct HandleRegistry {
+  mutable std::mutex mutex;
+  std::set<galois::StatHandle*> handles;
+};
+
 template <typename T>
 struct StatImpl {
   using MergedStats = galois::internal::VecStatManager<T>;
@@ -54,36 +139,101 @@ struct StatImpl {
     return std::is_same<T, galois::gstl::Str>::value ? "PARAM" : "STAT";
   }
 
-  galois::substrate::PerThreadStorage<galois::internal::ScalarStatManager<T>>
-      perThreadManagers_;
+  // The lock lets Snapshot read the statistics of a thread while it adds to
+  // them; it is only contended while a snapshot is being taken
+  struct ThreadStats {
+    mutable galois::substrate::SimpleLock lock;
+    galois::internal::ScalarStatManager<T> stats;
+  };
+
+  using Key = std::pair<galois::gstl::Str, galois::gstl::Str>;
+  using ThreadValues = std::map<Key, galois::internal::ScalarStat<T>>;
+
+  galois::substrate::PerThreadStorage<ThreadStats> perThreadManagers_;
   MergedStats result_;
   bool merged_{};
 
   void Add(
       const galois::gstl::Str& region, const galois::gstl::Str& category,
       const T& val, const galois::StatTotal::Type& type) {
-    perThreadManagers_.getLocal()->addToStat(region, category, val, type);
+    ThreadStats& local = *perThreadManagers_.getLocal();
+    std::lock_guard<galois::substrate::SimpleLock> guard(local.lock);
+    local.stats.addToStat(region, category, val, type);
+  }
+
+  /// Adds val to the statistics of thread t
+  void AddTo(
+      unsigned t, const galois::gstl::Str& region,
+      const galois::gstl::Str& category, const T& val,
+      const galois::StatTotal::Type& type) {
+    ThreadStats& thread = *perThreadManagers_.getRemote(t);
+    std::lock_guard<galois::substrate::SimpleLock> guard(thread.lock);
+    thread.stats.addToStat(region, category, val, type);
+  }
+
+  /// The values thread t reported so far, including those counted by the
+  /// live handles of registry for integer statistics
+  ThreadValues Collect(unsigned t, const HandleRegistry& registry) const {
+    ThreadValues values;
+    auto add = [&values](
+                   const galois::gstl::Str& region,
+                   const galois::gstl::Str& category, const T& val,
+                   const galois::StatTotal::Type& type) {
+      values.emplace(std::make_pair(region, category), type)
+          .first->second.add(val);
+    };
+
+    std::lock_guard<std::mutex> registry_guard(registry.mutex);
+    {
+      const ThreadStats& thread = *perThreadManagers_.getRemote(t);
+      std::lock_guard<galois::substrate::SimpleLock> guard(thread.lock);
+      const auto& manager = thread.stats;
+      for (auto i = manager.cbegin(), end_i = manager.cend(); i != end_i;
+           ++i) {
+        add(manager.region(i), manager.category(i), T(manager.stat(i)),
+            manager.stat(i).totalTy());
+      }
+    }
+
+    if constexpr (std::is_same_v<T, int64_t>) {
+      for (const galois::StatHandle* handle : registry.handles) {
+        if (int64_t val; handle->Read(t, &val)) {
+          add(handle->region(), handle->category(), val, handle->type());
+        }
+      }
+    }
+    return values;
   }
 
-  void Merge() {
+  void Merge(const HandleRegistry& registry) {
     if (merged_) {
       return;
     }
 
     for (unsigned t = 0; t < perThreadManagers_.size(); ++t) {
-      const auto* manager = perThreadManagers_.getRemote(t);
-
-      for (auto i = manager->cbegin(), end_i = manager->cend(); i != end_i;
-           ++i) {
-        result_.addToStat(
-            manager->region(i), manager->category(i), T(manager->stat(i)),
-            manager->stat(i).totalTy());
+      for (const auto& [key, stat] : Collect(t, registry)) {
+        result_.addToStat(key.first, key.second, T(stat), stat.totalTy());
       }
     }
 
     merged_ = true;
   }
 
+  /// Copies the values reported so far by each thread; unlike Merge, this
+  /// may run while threads add statistics
+  Snapshot<T> Take(const HandleRegistry& registry) const {
+    Snapshot<T> snapshot;
+    for (unsigned t = 0; t < perThreadManagers_.size(); ++t) {
+      for (const auto& [key, value] : Collect(t, registry)) {
+        SnapshotStat<T>& stat = snapshot[std::make_pair(
+            ToString(key.first), ToString(key.second))];
+        stat.type = value.totalTy();
+        stat.thread_values.emplace_back(t, T(value));
+      }
+    }
+    return snapshot;
+  }
+
   void Read(
       const_iterator i, galois::gstl::Str& region, galois::gstl::Str& category,
       T& total, galois::StatTotal::Type& type,
@@ -125,6 +275,84 @@ struct StatImpl {
   }
 };
 
+/// Timings in buckets of up to 1, 2, 4, ... microseconds; the last bucket
+/// holds the timings longer than the others
+constexpr unsigned kNumTimingBuckets = 32;
+
+struct TimingHistogram {
+  std::array<uint64_t, kNumTimingBuckets> counts{};
+  uint64_t count{};
+  uint64_t sum{};
+
+  static uint64_t BucketBound(unsigned bucket) { return uint64_t{1} << bucket; }
+
+  void Add(uint64_t usec) {
+    unsigned bucket = 0;
+    while (bucket + 1 < kNumTimingBuckets && usec > BucketBound(bucket)) {
+      ++bucket;
+    }
+    ++counts[bucket];
+    ++count;
+    sum += usec;
+  }
+
+  TimingHistogram& operator+=(const TimingHistogram& other) {
+    for (unsigned b = 0; b < kNumTimingBuckets; ++b) {
+      counts[b] += other.counts[b];
+    }
+    count += other.count;
+    sum += other.sum;
+    return *this;
+  }
+};
+
+using TimingMap =
+    std::map<std::pair<std::string, std::string>, TimingHistogram>;
+
+struct ThreadTimings {
+  mutable galois::substrate::SimpleLock lock;
+  TimingMap histograms;
+};
+
+/// Escapes a Prometheus label value
+std::string
+PrometheusLabel(const std::string& value) {
+  std::string escaped;
+  escaped.reserve(value.size());
+  for (char c : value) {
+    if (c == '\\' || c == '"') {
+      escaped += '\\';
+      escaped += c;
+    } else if (c == '\n') {
+      escaped += "\\n";
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+std::string
+PrometheusLabels(const std::pair<std::string, std::string>& key) {
+  return "region=\"" + PrometheusLabel(key.first) + "\",category=\"" +
+         PrometheusLabel(key.second) + "\"";
+}
+
+template <typename T>
+void
+PrintPrometheusStats(std::ostream& out, const Snapshot<T>& snapshot) {
+  for (const auto& [key, stat] : snapshot) {
+    std::string labels = PrometheusLabels(key);
+    out << "galois_stat{" << labels << ",total=\""
+        << galois::StatTotal::str(stat.type) << "\"} " << stat.total()
+        << "\n";
+    for (const auto& [tid, v] : stat.thread_values) {
+      out << "galois_stat_thread{" << labels << ",thread=\"" << tid << "\"} "
+          << v << "\n";
+    }
+  }
+}
+
 }  // end unnamed namespace
 
 class galois::StatManager::Impl {
@@ -132,18 +360,44 @@ public:
   StatImpl<int64_t> int_stats_;
   StatImpl<double> fp_stats_;
   StatImpl<Str> str_stats_;
+  galois::substrate::PerThreadStorage<ThreadTimings> timings_;
+  HandleRegistry handles_;
   std::string outfile_;
+  Format format_{FormatFromEnv()};
+
+  TimingMap TakeTimings() const {
+    TimingMap merged;
+    for (unsigned t = 0; t < timings_.size(); ++t) {
+      const ThreadTimings& thread = *timings_.getRemote(t);
+      std::lock_guard<galois::substrate::SimpleLock> guard(thread.lock);
+      for (const auto& [key, histogram] : thread.histograms) {
+        merged[key] += histogram;
+      }
+    }
+    return merged;
+  }
 };
 
 galois::StatManager::StatManager() { impl_ = std::make_unique<Impl>(); }
 
-galois::StatManager::~StatManager() = default;
+galois::StatManager::~StatManager() {
+  // handles that outlive the manager count for nobody
+  std::lock_guard<std::mutex> guard(impl_->handles_.mutex);
+  for (StatHandle* handle : impl_->handles_.handles) {
+    handle->manager_ = nullptr;
+  }
+}
 
 void
 galois::StatManager::SetStatFile(const std::string& outfile) {
   impl_->outfile_ = outfile;
 }
 
+void
+galois::StatManager::SetStatFormat(Format format) {
+  impl_->format_ = format;
+}
+
 bool
 galois::StatManager::IsPrintingThreadVals() const {
   return CheckPrintingThreadVals();
@@ -196,9 +450,9 @@ galois::StatManager::param_cend() const -> param_const_iterator {
 
 void
 galois::StatManager::MergeStats() {
-  impl_->int_stats_.Merge();
-  impl_->fp_stats_.Merge();
-  impl_->str_stats_.Merge();
+  impl_->int_stats_.Merge(impl_->handles_);
+  impl_->fp_stats_.Merge(impl_->handles_);
+  impl_->str_stats_.Merge(impl_->handles_);
 }
 
 void
@@ -245,19 +499,168 @@ galois::StatManager::AddParam(
       gstl::makeStr(region), gstl::makeStr(category), val, StatTotal::SINGLE);
 }
 
+void
+galois::StatManager::AddTiming(
+    const std::string& region, const std::string& category, uint64_t usec) {
+  ThreadTimings& local = *impl_->timings_.getLocal();
+  std::lock_guard<galois::substrate::SimpleLock> guard(local.lock);
+  local.histograms[std::make_pair(region, category)].Add(usec);
+}
+
+void
+galois::StatManager::AddTimings(
+    const std::string& region, const std::string& category,
+    const uint64_t* bucket_counts, size_t num_buckets, uint64_t sum_usec) {
+  ThreadTimings& local = *impl_->timings_.getLocal();
+  std::lock_guard<galois::substrate::SimpleLock> guard(local.lock);
+  TimingHistogram& histogram =
+      local.histograms[std::make_pair(region, category)];
+  for (size_t b = 0; b < num_buckets; ++b) {
+    histogram.counts[std::min<size_t>(b, kNumTimingBuckets - 1)] +=
+        bucket_counts[b];
+    histogram.count += bucket_counts[b];
+  }
+  histogram.sum += sum_usec;
+}
+
+void
+galois::StatManager::Register(StatHandle* handle) {
+  std::lock_guard<std::mutex> guard(impl_->handles_.mutex);
+  impl_->handles_.handles.emplace(handle);
+}
+
+void
+galois::StatManager::Unregister(StatHandle* handle) {
+  std::lock_guard<std::mutex> guard(impl_->handles_.mutex);
+  for (unsigned t = 0; t < handle->num_threads(); ++t) {
+    if (int64_t val; handle->Read(t, &val)) {
+      impl_->int_stats_.AddTo(
+          t, handle->region(), handle->category(), val, handle->type());
+    }
+  }
+  impl_->handles_.handles.erase(handle);
+}
+
+galois::StatHandle::StatHandle(
+    const std::string& region, const std::string& category,
+    const StatTotal::Type& type)
+    : region_(gstl::makeStr(region)),
+      category_(gstl::makeStr(category)),
+      type_(type),
+      manager_(internal::sysStatManager()) {
+  if (manager_) {
+    manager_->Register(this);
+  }
+}
+
+galois::StatHandle::~StatHandle() {
+  if (manager_) {
+    manager_->Unregister(this);
+  }
+}
+
 void
 galois::StatManager::Print() {
+  auto print = [this](std::ostream& out) {
+    if (impl_->format_ == Format::kJSON) {
+      PrintJSON(out);
+    } else {
+      PrintStats(out);
+    }
+  };
+
   if (impl_->outfile_.empty()) {
-    return PrintStats(std::cout);
+    return print(std::cout);
   }
 
   std::ofstream out(impl_->outfile_.c_str());
   if (!out) {
     GALOIS_LOG_ERROR("could not print stats to {} ", impl_->outfile_);
-    return PrintStats(std::cerr);
+    return print(std::cerr);
+  }
+
+  print(out);
+}
+
+void
+galois::StatManager::PrintJSON(std::ostream& out) const {
+  nlohmann::json regions = nlohmann::json::object();
+
+  auto add_stats = [&regions](const auto& snapshot) {
+    for (const auto& [key, stat] : snapshot) {
+      nlohmann::json& entry = regions[key.first][key.second];
+      entry["total_type"] = StatTotal::str(stat.type);
+      entry["total"] = ToJSON(stat.total());
+      nlohmann::json& threads = entry["threads"];
+      threads = nlohmann::json::object();
+      for (const auto& [tid, v] : stat.thread_values) {
+        threads[std::to_string(tid)] = ToJSON(v);
+      }
+    }
+  };
+  add_stats(impl_->int_stats_.Take(impl_->handles_));
+  add_stats(impl_->fp_stats_.Take(impl_->handles_));
+  add_stats(impl_->str_stats_.Take(impl_->handles_));
+
+  for (const auto& [key, histogram] : impl_->TakeTimings()) {
+    nlohmann::json& timings = regions[key.first][key.second]["timings"];
+    timings["count"] = histogram.count;
+    timings["sum_usec"] = histogram.sum;
+    nlohmann::json& buckets = timings["buckets"];
+    buckets = nlohmann::json::array();
+    for (unsigned b = 0; b < kNumTimingBuckets; ++b) {
+      if (histogram.counts[b] == 0) {
+        continue;
+      }
+      nlohmann::json bucket;
+      // the last bucket has no bound
+      if (b + 1 < kNumTimingBuckets) {
+        bucket["le_usec"] = TimingHistogram::BucketBound(b);
+      } else {
+        bucket["le_usec"] = nullptr;
+      }
+      bucket["count"] = histogram.counts[b];
+      buckets.push_back(std::move(bucket));
+    }
   }
 
-  PrintStats(out);
+  auto dumped = galois::JsonDump(regions);
+  if (!dumped) {
+    GALOIS_LOG_ERROR("could not print stats as json: {}", dumped.error());
+    return;
+  }
+  out << dumped.value() << "\n";
+}
+
+void
+galois::StatManager::PrintPrometheus(std::ostream& out) const {
+  out << "# TYPE galois_stat gauge\n";
+  PrintPrometheusStats(out, impl_->int_stats_.Take(impl_->handles_));
+  PrintPrometheusStats(out, impl_->fp_stats_.Take(impl_->handles_));
+
+  out << "# TYPE galois_param gauge\n";
+  Snapshot<Str> params = impl_->str_stats_.Take(impl_->handles_);
+  for (const auto& [key, stat] : params) {
+    out << "galois_param{" << PrometheusLabels(key) << ",value=\""
+        << PrometheusLabel(ToString(stat.total())) << "\"} 1\n";
+  }
+
+  out << "# TYPE galois_timing_usec histogram\n";
+  for (const auto& [key, histogram] : impl_->TakeTimings()) {
+    std::string labels = PrometheusLabels(key);
+    uint64_t cumulative = 0;
+    for (unsigned b = 0; b + 1 < kNumTimingBuckets; ++b) {
+      cumulative += histogram.counts[b];
+      out << "galois_timing_usec_bucket{" << labels << ",le=\""
+          << TimingHistogram::BucketBound(b) << "\"} " << cumulative << "\n";
+    }
+    out << "galois_timing_usec_bucket{" << labels << ",le=\"+Inf\"} "
+        << histogram.count << "\n";
+    out << "galois_timing_usec_sum{" << labels << "} " << histogram.sum
+        << "\n";
+    out << "galois_timing_usec_count{" << labels << "} " << histogram.count
+        << "\n";
+  }
 }
 
 static galois::StatManager* stat_manager_singleton;
@@ -275,14 +678,30 @@ galois::internal::sysStatManager() {
   return stat_manager_singleton;
 }
 
+void
+galois::internal::ReportTiming(
+    const std::string& region, const std::string& category, uint64_t usec) {
+  if (stat_manager_singleton) {
+    stat_manager_singleton->AddTiming(region, category, usec);
+  }
+}
+
 void
 galois::SetStatFile(const std::string& f) {
   internal::sysStatManager()->SetStatFile(f);
 }
 
+void
+galois::SetStatFormat(StatManager::Format format) {
+  internal::sysStatManager()->SetStatFormat(format);
+}
+
 void
 galois::PrintStats() {
   internal::sysStatManager()->Print();
+  if (auto res = WriteTraceFile(); !res) {
+    GALOIS_LOG_ERROR("cannot write trace: {}", res.error());
+  }
 }
 
 void
@@ -293,6 +712,14 @@ galois::reportPageAlloc(const char* category) {
             "PageAlloc", category, substrate::numPagePoolAllocForThread(tid));
       },
       std::make_tuple());
+
+  substrate::PageAllocStats stats = substrate::getPageAllocStats();
+  std::string prefix(category);
+  ReportStatSingle("PageAlloc", prefix + "HugeTLBPages", stats.hugetlb_pages);
+  ReportStatSingle("PageAlloc", prefix + "THPPages", stats.thp_pages);
+  ReportStatSingle(
+      "PageAlloc", prefix + "THPBackedPages", stats.thp_backed_pages);
+  ReportStatSingle("PageAlloc", prefix + "SmallPages", stats.small_pages);
 }
 
 void
@@ -0,0 +1,216 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/StatsServer.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "galois/Statistics.h"
+#include "tsuba/IOStats.h"
+#include "tsuba/WriteGroup.h"
+#include "tsuba/file.h"
+
+namespace {
+
+/// How often the server checks whether it should stop
+constexpr int kPollIntervalMs = 100;
+
+// a client that goes away must not kill the process with SIGPIPE
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+/// Reads the request up to the end of its headers; the request itself does
+/// not matter
+void
+ReadRequest(int fd) {
+  std::string request;
+  char buf[1024];
+  while (request.find("\r\n\r\n") == std::string::npos &&
+         request.size() < 16 * sizeof(buf)) {
+    pollfd pfd{fd, POLLIN, 0};
+    if (poll(&pfd, 1, kPollIntervalMs * 10) <= 0) {
+      return;
+    }
+    ssize_t n = read(fd, buf, sizeof(buf));
+    if (n <= 0) {
+      return;
+    }
+    request.append(buf, n);
+  }
+}
+
+/// The I/O counters of tsuba, which SharedMemSys only reports as statistics
+/// when it ends
+void
+PrintTsubaMetrics(std::ostream& out) {
+  tsuba::BlockCacheStats cache = tsuba::GetBlockCacheStats();
+  out << "# TYPE galois_tsuba_block_cache_hits counter\n"
+      << "galois_tsuba_block_cache_hits " << cache.hits << "\n"
+      << "# TYPE galois_tsuba_block_cache_misses counter\n"
+      << "galois_tsuba_block_cache_misses " << cache.misses << "\n"
+      << "# TYPE galois_tsuba_block_cache_evictions counter\n"
+      << "galois_tsuba_block_cache_evictions " << cache.evictions << "\n"
+      << "# TYPE galois_tsuba_block_cache_bytes gauge\n"
+      << "galois_tsuba_block_cache_bytes " << cache.bytes << "\n";
+
+  tsuba::DiskCacheStats disk = tsuba::GetDiskCacheStats();
+  out << "# TYPE galois_tsuba_disk_cache_hits counter\n"
+      << "galois_tsuba_disk_cache_hits " << disk.hits << "\n"
+      << "# TYPE galois_tsuba_disk_cache_misses counter\n"
+      << "galois_tsuba_disk_cache_misses " << disk.misses << "\n"
+      << "# TYPE galois_tsuba_disk_cache_evictions counter\n"
+      << "galois_tsuba_disk_cache_evictions " << disk.evictions << "\n"
+      << "# TYPE galois_tsuba_disk_cache_bytes gauge\n"
+      << "galois_tsuba_disk_cache_bytes " << disk.bytes << "\n"
+      << "# TYPE galois_tsuba_write_peak_inflight_bytes gauge\n"
+      << "galois_tsuba_write_peak_inflight_bytes "
+      << tsuba::WriteGroup::MaxPeakInflightBytes() << "\n";
+
+  std::vector<tsuba::IOStatsEntry> io_stats = tsuba::GetIOStats();
+  if (io_stats.empty()) {
+    return;
+  }
+  out << "# TYPE galois_tsuba_io_ops counter\n"
+      << "# TYPE galois_tsuba_io_bytes counter\n"
+      << "# TYPE galois_tsuba_io_errors counter\n"
+      << "# TYPE galois_tsuba_io_latency_usec histogram\n";
+  for (const tsuba::IOStatsEntry& entry : io_stats) {
+    std::string labels = "backend=\"" + entry.backend + "\",class=\"" +
+                         tsuba::IOClassName(entry.io_class) + "\",op=\"" +
+                         tsuba::IOOpName(entry.op) + "\"";
+    const tsuba::IOOpStats& stats = entry.stats;
+    out << "galois_tsuba_io_ops{" << labels << "} " << stats.ops << "\n"
+        << "galois_tsuba_io_bytes{" << labels << "} " << stats.bytes << "\n"
+        << "galois_tsuba_io_errors{" << labels << "} " << stats.errors
+        << "\n";
+    uint64_t cumulative = 0;
+    for (unsigned b = 0; b + 1 < tsuba::kNumIOLatencyBuckets; ++b) {
+      cumulative += stats.latency_buckets[b];
+      out << "galois_tsuba_io_latency_usec_bucket{" << labels << ",le=\""
+          << (uint64_t{1} << b) << "\"} " << cumulative << "\n";
+    }
+    out << "galois_tsuba_io_latency_usec_bucket{" << labels
+        << ",le=\"+Inf\"} " << stats.ops << "\n"
+        << "galois_tsuba_io_latency_usec_sum{" << labels << "} "
+        << stats.latency_sum_usec << "\n"
+        << "galois_tsuba_io_latency_usec_count{" << labels << "} "
+        << stats.ops << "\n";
+  }
+}
+
+void
+WriteAll(int fd, const std::string& data) {
+  size_t written = 0;
+  while (written < data.size()) {
+    ssize_t n =
+        send(fd, data.data() + written, data.size() - written, kSendFlags);
+    if (n <= 0) {
+      return;
+    }
+    written += n;
+  }
+}
+
+}  // namespace
+
+galois::StatsServer::StatsServer(int listen_fd, uint16_t port)
+    : listen_fd_(listen_fd), port_(port) {
+  thread_ = std::thread([this] { Serve(); });
+}
+
+galois::StatsServer::~StatsServer() {
+  stop_ = true;
+  thread_.join();
+  close(listen_fd_);
+}
+
+galois::Result<std::unique_ptr<galois::StatsServer>>
+galois::StatsServer::Make(uint16_t port) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return galois::ResultErrno();
+  }
+
+  int one = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(port);
+  if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+      listen(fd, SOMAXCONN) != 0) {
+    auto err = galois::ResultErrno();
+    close(fd);
+    return err;
+  }
+
+  socklen_t len = sizeof(addr);
+  if (getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+    auto err = galois::ResultErrno();
+    close(fd);
+    return err;
+  }
+
+  return std::unique_ptr<StatsServer>(
+      new StatsServer(fd, ntohs(addr.sin_port)));
+}
+
+void
+galois::StatsServer::Serve() {
+  while (!stop_) {
+    pollfd pfd{listen_fd_, POLLIN, 0};
+    if (poll(&pfd, 1, kPollIntervalMs) <= 0) {
+      continue;
+    }
+    int fd = accept(listen_fd_, nullptr, nullptr);
+    if (fd < 0) {
+      continue;
+    }
+
+    ReadRequest(fd);
+
+    std::ostringstream body;
+    if (StatManager* sm = internal::sysStatManager(); sm) {
+      sm->PrintPrometheus(body);
+    }
+    PrintTsubaMetrics(body);
+    std::string metrics = body.str();
+
+    std::ostringstream response;
+    response << "HTTP/1.0 200 OK\r\n"
+             << "Content-Type: text/plain; version=0.0.4\r\n"
+             << "Content-Length: " << metrics.size() << "\r\n"
+             << "Connection: close\r\n\r\n"
+             << metrics;
+    WriteAll(fd, response.str());
+    close(fd);
+  }
+}
@@ -0,0 +1,454 @@
+#include "galois/graphs/Subgraph.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+
+#include <arrow/api.h>
+#include <arrow/compute/api.h>
+
+#include "galois/ErrorCode.h"
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/ParallelSTL.h"
+#include "tsuba/MemoryPool.h"
+
+namespace {
+
+using galois::graphs::GraphTopology;
+using galois::graphs::kNoNode;
+
+constexpr uint64_t kNoEdge = std::numeric_limits<uint64_t>::max();
+
+/// NodeMap numbers the parent nodes of a subgraph in the order they are
+/// inserted. It is an array over all parent nodes when the subgraph is
+/// expected to hold a good part of them and a hash table otherwise, so that
+/// small samples of large graphs stay cheap.
+class NodeMap {
+public:
+  NodeMap(uint64_t num_parent_nodes, uint64_t expected_nodes) {
+    if (expected_nodes >= num_parent_nodes / kDenseFraction) {
+      dense_.resize(num_parent_nodes, kNoNode);
+    } else {
+      sparse_.reserve(expected_nodes);
+    }
+  }
+
+  /// Returns the id of node and whether it was inserted by this call
+  std::pair<uint32_t, bool> Insert(uint32_t node) {
+    uint32_t next = new_to_old_.size();
+    bool inserted;
+    uint32_t id;
+    if (!dense_.empty()) {
+      inserted = dense_[node] == kNoNode;
+      if (inserted) {
+        dense_[node] = next;
+      }
+      id = dense_[node];
+    } else {
+      auto [it, sparse_inserted] = sparse_.emplace(node, next);
+      inserted = sparse_inserted;
+      id = it->second;
+    }
+    if (inserted) {
+      new_to_old_.emplace_back(node);
+    }
+    return std::make_pair(id, inserted);
+  }
+
+  /// Returns the id of node or kNoNode; safe to call concurrently
+  uint32_t Find(uint32_t node) const {
+    if (!dense_.empty()) {
+      return dense_[node];
+    }
+    auto it = sparse_.find(node);
+    return it == sparse_.end() ? kNoNode : it->second;
+  }
+
+  const std::vector<uint32_t>& new_to_old() const { return new_to_old_; }
+  uint32_t size() const { return new_to_old_.size(); }
+
+private:
+  static constexpr uint64_t kDenseFraction = 16;
+
+  std::vector<uint32_t> dense_;
+  std::unordered_map<uint32_t, uint32_t> sparse_;
+  std::vector<uint32_t> new_to_old_;
+};
+
+/// The parent edges that each node of a subgraph keeps, in order
+using EdgeLists = std::vector<std::vector<uint64_t>>;
+
+std::mt19937_64
+MakeGenerator(uint64_t random_seed, uint64_t stream, uint64_t item) {
+  std::seed_seq seq{
+      static_cast<uint32_t>(random_seed),
+      static_cast<uint32_t>(random_seed >> 32), static_cast<uint32_t>(stream),
+      static_cast<uint32_t>(item), static_cast<uint32_t>(item >> 32)};
+  return std::mt19937_64(seq);
+}
+
+galois::Result<void>
+CheckNodes(const GraphTopology& topology, const std::vector<uint32_t>& nodes) {
+  uint64_t num_nodes = topology.num_nodes();
+  if (std::any_of(nodes.begin(), nodes.end(), [&](uint32_t n) {
+        return n >= num_nodes;
+      })) {
+    GALOIS_LOG_DEBUG("node out of range of {} nodes", num_nodes);
+    return galois::ErrorCode::InvalidArgument;
+  }
+  return galois::ResultSuccess();
+}
+
+template <typename Builder, typename T>
+galois::Result<std::shared_ptr<arrow::Array>>
+BuildArray(const std::vector<T>& values) {
+  Builder builder(tsuba::GetArrowMemoryPool());
+  if (auto status = builder.AppendValues(values); !status.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", status);
+    return galois::ErrorCode::ArrowError;
+  }
+  std::shared_ptr<arrow::Array> array;
+  if (auto status = builder.Finish(&array); !status.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", status);
+    return galois::ErrorCode::ArrowError;
+  }
+  return array;
+}
+
+/// Project returns the named columns of table, taking the rows in indices,
+/// followed by the column id_name holding indices itself
+galois::Result<std::shared_ptr<arrow::Table>>
+Project(
+    const std::shared_ptr<arrow::Table>& table,
+    const std::vector<std::string>& names, const std::string& id_name,
+    const std::shared_ptr<arrow::Array>& indices) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (const std::string& name : names) {
+    int i = table->schema()->GetFieldIndex(name);
+    if (i < 0) {
+      return galois::ErrorCode::PropertyNotFound;
+    }
+    auto take_result = arrow::compute::Take(
+        arrow::Datum(table->column(i)), arrow::Datum(indices));
+    if (!take_result.ok()) {
+      GALOIS_LOG_DEBUG("arrow error: {}", take_result.status());
+      return galois::ErrorCode::ArrowError;
+    }
+    fields.emplace_back(table->schema()->field(i));
+    columns.emplace_back(take_result.ValueOrDie().chunked_array());
+  }
+  fields.emplace_back(arrow::field(id_name, indices->type()));
+  columns.emplace_back(std::make_shared<arrow::ChunkedArray>(indices));
+
+  auto combine_result =
+      arrow::Table::Make(arrow::schema(fields), columns, indices->length())
+          ->CombineChunks(tsuba::GetArrowMemoryPool());
+  if (!combine_result.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", combine_result.status());
+    return galois::ErrorCode::ArrowError;
+  }
+  return std::move(combine_result.ValueOrDie());
+}
+
+/// MakeSubgraph returns the subgraph whose node n is node_map.new_to_old()[n]
+/// of pfg with the out-edges edges[n] of pfg if n < edges.size() and none
+/// otherwise; the destinations of those edges must be in node_map
+galois::Result<std::unique_ptr<galois::graphs::PropertyFileGraph>>
+MakeSubgraph(
+    const galois::graphs::PropertyFileGraph& pfg, const NodeMap& node_map,
+    const EdgeLists& edges, const std::vector<std::string>& node_properties,
+    const std::vector<std::string>& edge_properties) {
+  const GraphTopology& topology = pfg.topology();
+  uint64_t num_nodes = node_map.size();
+
+  std::vector<uint64_t> out_indices(num_nodes);
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        out_indices[n] = n < edges.size() ? edges[n].size() : 0;
+      },
+      galois::no_stats());
+  galois::ParallelSTL::partial_sum(
+      out_indices.begin(), out_indices.end(), out_indices.begin());
+  uint64_t num_edges = num_nodes > 0 ? out_indices.back() : 0;
+
+  std::vector<uint32_t> dests(num_edges);
+  std::vector<uint64_t> parent_edges(num_edges);
+  galois::do_all(
+      galois::iterate(uint64_t{0}, static_cast<uint64_t>(edges.size())),
+      [&](uint64_t n) {
+        uint64_t out = n == 0 ? 0 : out_indices[n - 1];
+        for (uint64_t e : edges[n]) {
+          dests[out] = node_map.Find(topology.out_dests->Value(e));
+          parent_edges[out] = e;
+          ++out;
+        }
+      },
+      galois::no_stats(), galois::steal());
+
+  auto indices_result = BuildArray<arrow::UInt64Builder>(out_indices);
+  if (!indices_result) {
+    return indices_result.error();
+  }
+  auto dests_result = BuildArray<arrow::UInt32Builder>(dests);
+  if (!dests_result) {
+    return dests_result.error();
+  }
+  GraphTopology sub_topology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          indices_result.value()),
+      .out_dests =
+          std::static_pointer_cast<arrow::UInt32Array>(dests_result.value()),
+  };
+
+  auto sub = std::make_unique<galois::graphs::PropertyFileGraph>();
+  if (auto res = sub->SetTopology(sub_topology); !res) {
+    return res.error();
+  }
+
+  if (auto res = pfg.EnsureNodePropertiesLoaded(node_properties); !res) {
+    return res.error();
+  }
+  if (auto res = pfg.EnsureEdgePropertiesLoaded(edge_properties); !res) {
+    return res.error();
+  }
+
+  auto node_ids = BuildArray<arrow::UInt32Builder>(node_map.new_to_old());
+  if (!node_ids) {
+    return node_ids.error();
+  }
+  auto node_table = Project(
+      pfg.node_table(), node_properties,
+      galois::graphs::kParentNodeIdProperty, node_ids.value());
+  if (!node_table) {
+    return node_table.error();
+  }
+  if (auto res = sub->AddNodeProperties(node_table.value()); !res) {
+    return res.error();
+  }
+
+  auto edge_ids = BuildArray<arrow::UInt64Builder>(parent_edges);
+  if (!edge_ids) {
+    return edge_ids.error();
+  }
+  auto edge_table = Project(
+      pfg.edge_table(), edge_properties,
+      galois::graphs::kParentEdgeIdProperty, edge_ids.value());
+  if (!edge_table) {
+    return edge_table.error();
+  }
+  if (auto res = sub->AddEdgeProperties(edge_table.value()); !res) {
+    return res.error();
+  }
+
+  return std::unique_ptr<galois::graphs::PropertyFileGraph>(std::move(sub));
+}
+
+/// Sample returns the indices of k of the edges [begin, end), chosen
+/// uniformly without replacement with Floyd's algorithm, in increasing order
+std::vector<uint64_t>
+Sample(uint64_t begin, uint64_t end, uint64_t k, std::mt19937_64* gen) {
+  std::vector<uint64_t> chosen;
+  uint64_t d = end - begin;
+  if (k >= d) {
+    chosen.resize(d);
+    std::iota(chosen.begin(), chosen.end(), begin);
+    return chosen;
+  }
+  chosen.reserve(k);
+  for (uint64_t j = d - k; j < d; ++j) {
+    uint64_t t = std::uniform_int_distribution<uint64_t>(0, j)(*gen) + begin;
+    if (std::find(chosen.begin(), chosen.end(), t) != chosen.end()) {
+      t = j + begin;
+    }
+    chosen.emplace_back(t);
+  }
+  std::sort(chosen.begin(), chosen.end());
+  return chosen;
+}
+
+/// Walk runs the walks of RandomWalks and, if edges is not null, records the
+/// edge of each step in it, or kNoEdge for steps that were not taken
+void
+Walk(
+    const GraphTopology& topology, const std::vector<uint32_t>& starts,
+    uint32_t walk_length, uint64_t random_seed, std::vector<uint32_t>* walks,
+    std::vector<uint64_t>* edges) {
+  uint64_t stride = uint64_t{walk_length} + 1;
+  walks->assign(starts.size() * stride, kNoNode);
+  if (edges) {
+    edges->assign(starts.size() * walk_length, kNoEdge);
+  }
+
+  galois::do_all(
+      galois::iterate(uint64_t{0}, static_cast<uint64_t>(starts.size())),
+      [&](uint64_t w) {
+        std::mt19937_64 gen = MakeGenerator(random_seed, 0, w);
+        uint32_t* walk = walks->data() + w * stride;
+        walk[0] = starts[w];
+        for (uint32_t step = 0; step < walk_length; ++step) {
+          auto [begin, end] = topology.edge_range(walk[step]);
+          if (begin == end) {
+            break;
+          }
+          uint64_t e =
+              std::uniform_int_distribution<uint64_t>(begin, end - 1)(gen);
+          walk[step + 1] = topology.out_dests->Value(e);
+          if (edges) {
+            (*edges)[w * walk_length + step] = e;
+          }
+        }
+      },
+      galois::no_stats(), galois::steal());
+}
+
+}  // namespace
+
+galois::Result<std::unique_ptr<galois::graphs::PropertyFileGraph>>
+galois::graphs::ExtractInducedSubgraph(
+    const PropertyFileGraph& pfg, const std::vector<uint32_t>& nodes,
+    const std::vector<std::string>& node_properties,
+    const std::vector<std::string>& edge_properties) {
+  const GraphTopology& topology = pfg.topology();
+  if (auto res = CheckNodes(topology, nodes); !res) {
+    return res.error();
+  }
+
+  NodeMap node_map(topology.num_nodes(), nodes.size());
+  for (uint32_t n : nodes) {
+    if (!node_map.Insert(n).second) {
+      GALOIS_LOG_DEBUG("node {} appears more than once", n);
+      return ErrorCode::InvalidArgument;
+    }
+  }
+
+  EdgeLists edges(nodes.size());
+  galois::do_all(
+      galois::iterate(uint64_t{0}, static_cast<uint64_t>(nodes.size())),
+      [&](uint64_t n) {
+        auto [e, end] = topology.edge_range(nodes[n]);
+        for (; e != end; ++e) {
+          if (node_map.Find(topology.out_dests->Value(e)) != kNoNode) {
+            edges[n].emplace_back(e);
+          }
+        }
+      },
+      galois::no_stats(), galois::steal());
+
+  return MakeSubgraph(pfg, node_map, edges, node_properties, edge_properties);
+}
+
+galois::Result<std::unique_ptr<galois::graphs::PropertyFileGraph>>
+galois::graphs::SampleNeighborhood(
+    const PropertyFileGraph& pfg, const std::vector<uint32_t>& seeds,
+    const std::vector<uint32_t>& fanouts, uint64_t random_seed,
+    const std::vector<std::string>& node_properties,
+    const std::vector<std::string>& edge_properties) {
+  const GraphTopology& topology = pfg.topology();
+  if (auto res = CheckNodes(topology, seeds); !res) {
+    return res.error();
+  }
+
+  // a guess: every hop multiplies the nodes by the fanout
+  uint64_t expected = seeds.size();
+  for (uint32_t fanout : fanouts) {
+    expected = std::min(
+        topology.num_nodes(),
+        expected * std::min<uint64_t>(fanout, topology.num_nodes()));
+  }
+  NodeMap node_map(topology.num_nodes(), expected);
+  for (uint32_t n : seeds) {
+    if (!node_map.Insert(n).second) {
+      GALOIS_LOG_DEBUG("seed {} appears more than once", n);
+      return ErrorCode::InvalidArgument;
+    }
+  }
+
+  EdgeLists edges;
+  uint64_t hop_begin = 0;
+  for (uint32_t hop = 0; hop < fanouts.size(); ++hop) {
+    uint64_t hop_end = node_map.size();
+    edges.resize(hop_end);
+    uint64_t fanout = fanouts[hop];
+    galois::do_all(
+        galois::iterate(hop_begin, hop_end),
+        [&](uint64_t n) {
+          uint32_t node = node_map.new_to_old()[n];
+          auto [begin, end] = topology.edge_range(node);
+          // seeding by node makes the sample independent of the schedule
+          std::mt19937_64 gen = MakeGenerator(random_seed, hop, node);
+          edges[n] = Sample(begin, end, fanout, &gen);
+        },
+        galois::no_stats(), galois::steal());
+
+    for (uint64_t n = hop_begin; n < hop_end; ++n) {
+      for (uint64_t e : edges[n]) {
+        node_map.Insert(topology.out_dests->Value(e));
+      }
+    }
+    hop_begin = hop_end;
+  }
+
+  return MakeSubgraph(pfg, node_map, edges, node_properties, edge_properties);
+}
+
+galois::Result<std::vector<uint32_t>>
+galois::graphs::RandomWalks(
+    const GraphTopology& topology, const std::vector<uint32_t>& starts,
+    uint32_t walk_length, uint64_t random_seed) {
+  if (auto res = CheckNodes(topology, starts); !res) {
+    return res.error();
+  }
+  std::vector<uint32_t> walks;
+  Walk(topology, starts, walk_length, random_seed, &walks, nullptr);
+  return walks;
+}
+
+galois::Result<std::unique_ptr<galois::graphs::PropertyFileGraph>>
+galois::graphs::SampleRandomWalks(
+    const PropertyFileGraph& pfg, const std::vector<uint32_t>& starts,
+    uint32_t walk_length, uint64_t random_seed,
+    const std::vector<std::string>& node_properties,
+    const std::vector<std::string>& edge_properties) {
+  const GraphTopology& topology = pfg.topology();
+  if (auto res = CheckNodes(topology, starts); !res) {
+    return res.error();
+  }
+  std::vector<uint32_t> walks;
+  std::vector<uint64_t> steps;
+  Walk(topology, starts, walk_length, random_seed, &walks, &steps);
+
+  NodeMap node_map(topology.num_nodes(), walks.size());
+  EdgeLists edges;
+  uint64_t stride = uint64_t{walk_length} + 1;
+  for (uint64_t w = 0; w < starts.size(); ++w) {
+    node_map.Insert(walks[w * stride]);
+    for (uint32_t step = 0; step < walk_length; ++step) {
+      uint64_t e = steps[w * walk_length + step];
+      if (e == kNoEdge) {
+        break;
+      }
+      uint32_t source = node_map.Find(walks[w * stride + step]);
+      node_map.Insert(walks[w * stride + step + 1]);
+      if (edges.size() <= source) {
+        edges.resize(node_map.size());
+      }
+      edges[source].emplace_back(e);
+    }
+  }
+
+  // each edge once, in the order of the parent
+  galois::do_all(
+      galois::iterate(uint64_t{0}, static_cast<uint64_t>(edges.size())),
+      [&](uint64_t n) {
+        std::sort(edges[n].begin(), edges[n].end());
+        edges[n].erase(
+            std::unique(edges[n].begin(), edges[n].end()), edges[n].end());
+      },
+      galois::no_stats(), galois::steal());
+
+  return MakeSubgraph(pfg, node_map, edges, node_properties, edge_properties);
+}
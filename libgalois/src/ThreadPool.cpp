@@ -24,6 +24,7 @@
 
 #include "galois/Env.h"
 #include "galois/Logging.h"
+#include "galois/Trace.h"
 #include "galois/substrate/HWTopo.h"
 
 // Forward declare this to avoid including PerThreadStorage.
@@ -31,6 +32,7 @@
 namespace galois::substrate {
 
 extern void initPTS(unsigned);
+extern void adoptPTS(unsigned);
 
 }
 
@@ -39,37 +41,68 @@ using galois::substrate::ThreadPool;
 thread_local ThreadPool::per_signal ThreadPool::my_box;
 
 ThreadPool::ThreadPool()
-    : mi(getHWTopo().machineTopoInfo),
+    : started(1),
       reserved(0),
       masterFastmode(false),
-      running(false) {
-  signals.resize(mi.maxThreads);
-  initThread(0);
-
-  for (unsigned i = 1; i < mi.maxThreads; ++i) {
-    std::thread t(&ThreadPool::threadLoop, this, i);
-    threads.emplace_back(std::move(t));
+      running(false),
+      idleSpin(0) {
+  int spin_us = 0;
+  if (GetEnv("GALOIS_IDLE_SPIN_US", &spin_us)) {
+    setIdleSpin(std::chrono::microseconds(spin_us));
   }
 
-  // we don't want signals to have to contain atomics, since they are set once
-  while (std::any_of(signals.begin(), signals.end(), [](per_signal* p) {
-    return !p || !p->done;
-  })) {
-    std::atomic_thread_fence(std::memory_order_seq_cst);
-  }
+  HWTopoInfo info = getHWTopo();
+  mi = info.machineTopoInfo;
+  topo = std::move(info.threadTopoInfo);
+
+  signals.resize(mi.maxThreads);
+  threads.resize(mi.maxThreads);
+  epochs = std::make_unique<EpochManager>(mi.maxThreads);
+  initThread(0);
 }
 
 ThreadPool::~ThreadPool() {
   destroyCommon();
   for (auto& t : threads) {
-    t.join();
+    if (t.joinable()) {
+      t.join();
+    }
   }
 }
 
 void
 ThreadPool::destroyCommon() {
   beKind();  // reset fastmode
-  run(mi.maxThreads, []() { throw shutdown_ty(); });
+  // only the threads started so far
+  run(started, []() { throw shutdown_ty(); });
+}
+
+void
+ThreadPool::startThread(unsigned tid) {
+  assert(!threads[tid].joinable());
+  threads[tid] = std::thread(&ThreadPool::threadLoop, this, tid);
+}
+
+void
+ThreadPool::waitForThreads(unsigned begin, unsigned end) {
+  // we don't want signals to have to contain atomics, since they are set once
+  while (std::any_of(
+      signals.begin() + begin, signals.begin() + end,
+      [](per_signal* p) { return !p || !p->done; })) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+}
+
+void
+ThreadPool::startThreads(unsigned num) {
+  if (num <= started) {
+    return;
+  }
+  for (unsigned i = started; i < num; ++i) {
+    startThread(i);
+  }
+  waitForThreads(started, num);
+  started = num;
 }
 
 void
@@ -94,6 +127,33 @@ ThreadPool::beKind() {
   }
 }
 
+ThreadPool::WakeupStats
+ThreadPool::getWakeupStats() const {
+  constexpr auto relaxed = std::memory_order_relaxed;
+  WakeupStats stats;
+  // dedicated threads may have exited along with their mailboxes
+  for (unsigned i = 0; i < std::min(started, getMaxUsableThreads()); ++i) {
+    const per_signal* p = signals[i];
+    stats.spinning += p->spinWakeups.load(relaxed);
+    stats.sleeping += p->sleepWakeups.load(relaxed);
+    stats.totalLatency += p->totalLatency.load(relaxed);
+    stats.maxLatency = std::max(stats.maxLatency, p->maxLatency.load(relaxed));
+  }
+  return stats;
+}
+
+void
+ThreadPool::resetWakeupStats() {
+  GALOIS_LOG_VASSERT(!running, "Can't reset wakeup stats while running");
+  for (unsigned i = 0; i < std::min(started, getMaxUsableThreads()); ++i) {
+    per_signal* p = signals[i];
+    p->spinWakeups = 0;
+    p->sleepWakeups = 0;
+    p->totalLatency = 0;
+    p->maxLatency = 0;
+  }
+}
+
 // inefficient append
 template <typename T>
 static void
@@ -129,7 +189,8 @@ getNth(std::atomic<T*>& headptr, unsigned off) {
 void
 ThreadPool::initThread(unsigned tid) {
   signals[tid] = &my_box;
-  my_box.topo = getHWTopo().threadTopoInfo[tid];
+  my_box.topo = topo[tid];
+  SetTraceThreadName("galois " + std::to_string(tid));
   // Initialize
   substrate::initPTS(mi.maxThreads);
 
@@ -158,8 +219,9 @@ ThreadPool::threadLoop(unsigned tid) {
   bool fastmode = false;
   auto& me = my_box;
   do {
-    me.wait(fastmode);
+    me.wait(fastmode, idleSpin.load(std::memory_order_relaxed));
     cascade(fastmode);
+    epochs->Online(tid);
     try {
       work();
     } catch (const shutdown_ty&) {
@@ -167,6 +229,8 @@ ThreadPool::threadLoop(unsigned tid) {
     } catch (const fastmode_ty& fm) {
       fastmode = fm.mode;
     } catch (const dedicated_ty dt) {
+      // dedicated threads never run loops again
+      epochs->Offline(tid);
       me.done = 1;
       dt.fn();
       return;
@@ -177,6 +241,7 @@ ThreadPool::threadLoop(unsigned tid) {
     } catch (...) {
       abort();
     }
+    epochs->Offline(tid);
     decascade();
   } while (true);
 }
@@ -226,13 +291,23 @@ ThreadPool::cascade(bool fastmode) {
   }
 }
 
+void
+ThreadPool::beginRun() {
+  // Loops index per-thread storage by thread id and assume that they run on
+  // threads 0 to activeThreads - 1, so loops from different client threads
+  // cannot share the pool; partition the machine between processes instead
+  GALOIS_LOG_VASSERT(
+      !running.exchange(true),
+      "Recursive or concurrent thread pool execution not supported");
+}
+
 void
 ThreadPool::runInternal(unsigned num) {
   // sanitize num
   // seq write to starting should make work safe
-  GALOIS_LOG_VASSERT(!running, "Recursive thread pool execution not supported");
-  running = true;
+  assert(running);
   num = std::min(std::max(1U, num), getMaxUsableThreads());
+  startThreads(num);
   // my_box is tid 0
   auto& me = my_box;
   me.wbegin = 1;
@@ -242,19 +317,31 @@ ThreadPool::runInternal(unsigned num) {
   // launch threads
   cascade(masterFastmode);
   // Do master thread work
+  epochs->Online(0);
   try {
     work();
   } catch (const shutdown_ty&) {
     return;
   } catch (const fastmode_ty& fm) {
   }
+  epochs->Offline(0);
   // wait for children
   decascade();
+  // every thread is quiescent between runs
+  epochs->EndRound();
   // Clean up
   work = nullptr;
   running = false;
 }
 
+void
+ThreadPool::adoptMaster() {
+  GALOIS_LOG_VASSERT(
+      !running, "Can't adopt the master thread during parallel section");
+  my_box.topo = topo[0];
+  substrate::adoptPTS(0);
+}
+
 void
 ThreadPool::runDedicated(std::function<void(void)>& f) {
   // TODO(ddn): update galois::runtime::activeThreads to reflect the dedicated
@@ -266,7 +353,12 @@ ThreadPool::runDedicated(std::function<void(void)>& f) {
 
   GALOIS_LOG_VASSERT(reserved < mi.maxThreads, "Too many dedicated threads");
   work = [&f]() { throw dedicated_ty{f}; };
-  auto* child = signals[mi.maxThreads - reserved];
+  unsigned tid = mi.maxThreads - reserved;
+  if (!threads[tid].joinable()) {
+    startThread(tid);
+    waitForThreads(tid, tid + 1);
+  }
+  auto* child = signals[tid];
   child->wbegin = 0;
   child->wend = 0;
   child->done = 0;
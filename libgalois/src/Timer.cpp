@@ -109,8 +109,15 @@ StatTimer::start() {
 
 void
 StatTimer::stop() {
+  bool timed = valid_;
   valid_ = false;
+  uint64_t before = TimeAccumulator::get_usec();
   TimeAccumulator::stop();
+  // each run also goes into the histogram of timings of the timer
+  if (timed) {
+    galois::internal::ReportTiming(
+        region_.c_str(), name_.c_str(), TimeAccumulator::get_usec() - before);
+  }
 }
 
 uint64_t
@@ -17,45 +17,29 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
-#ifndef GALOIS_UNION_FIND
-#define GALOIS_UNION_FIND
-
-#include <cstddef>
-
-template <typename ElTy, ElTy initializer>
-struct UnionFind {
-  ElTy* parents;
-  const size_t size;
-
-  explicit UnionFind(size_t sz) : size(sz) {
-    parents = new ElTy[size];
-    for (size_t s = 0; s < sz; s++)
-      parents[s] = initializer;
-  }
-
-  ElTy uf_find(ElTy e) {
-    if (parents[e] == initializer)
-      return e;
-    ElTy tmp = e;
-    ElTy rep = initializer;
-    while (parents[tmp] != initializer)
-      tmp = parents[tmp];
-    rep = tmp;
-    tmp = e;
-    while (parents[tmp] != initializer) {
-      parents[tmp] = rep;
-      tmp = parents[tmp];
-    }
-    return rep;
-  }
-
-  void uf_union(ElTy e1, ElTy e2) { parents[e1] = e2; }
-
-  ~UnionFind() { delete parents; }
-};
-
-void
-test_uf() {
-  UnionFind<int, -1> sample(10000);
+#include "galois/analytics/Async.h"
+
+#include "galois/substrate/ThreadPool.h"
+
+namespace {
+
+std::mutex async_mutex;
+
+thread_local galois::analytics::AsyncControl* current_control = nullptr;
+
+}  // namespace
+
+galois::analytics::internal::AsyncScope::AsyncScope(AsyncControl* control)
+    : lock_(async_mutex) {
+  galois::substrate::GetThreadPool().adoptMaster();
+  current_control = control;
+}
+
+galois::analytics::internal::AsyncScope::~AsyncScope() {
+  current_control = nullptr;
+}
+
+bool
+galois::analytics::internal::EndRound(uint64_t work_items) {
+  return current_control && current_control->EndRound(work_items);
 }
-#endif  // def GALOIS_UNION_FIND
@@ -0,0 +1,320 @@
+#include "galois/analytics/GraphStatistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "galois/Bag.h"
+#include "galois/ErrorCode.h"
+#include "galois/Galois.h"
+#include "galois/JSON.h"
+#include "galois/Logging.h"
+#include "galois/Reduction.h"
+
+namespace galois::analytics {
+
+void
+to_json(nlohmann::json& j, const GraphStatistics& stats) {
+  j = nlohmann::json{
+      {"num_nodes", stats.num_nodes},
+      {"num_edges", stats.num_edges},
+      {"mean_degree", stats.mean_degree},
+      {"max_degree", stats.max_degree},
+      {"degree_skew", stats.degree_skew},
+      {"estimated_diameter", stats.estimated_diameter},
+  };
+  if (!stats.weight_property.empty()) {
+    j["weight_property"] = stats.weight_property;
+    j["mean_weight"] = stats.mean_weight;
+    j["min_weight"] = stats.min_weight;
+    j["max_weight"] = stats.max_weight;
+  }
+}
+
+void
+from_json(const nlohmann::json& j, GraphStatistics& stats) {
+  j.at("num_nodes").get_to(stats.num_nodes);
+  j.at("num_edges").get_to(stats.num_edges);
+  j.at("mean_degree").get_to(stats.mean_degree);
+  j.at("max_degree").get_to(stats.max_degree);
+  j.at("degree_skew").get_to(stats.degree_skew);
+  j.at("estimated_diameter").get_to(stats.estimated_diameter);
+  if (auto it = j.find("weight_property"); it != j.end()) {
+    it->get_to(stats.weight_property);
+    j.at("mean_weight").get_to(stats.mean_weight);
+    j.at("min_weight").get_to(stats.min_weight);
+    j.at("max_weight").get_to(stats.max_weight);
+  }
+}
+
+}  // namespace galois::analytics
+
+namespace {
+
+using galois::analytics::GraphStatistics;
+using galois::graphs::GraphTopology;
+
+constexpr uint32_t kUnvisited = std::numeric_limits<uint32_t>::max();
+
+/// Sample the degrees of evenly spaced nodes; returns the sampled node of
+/// greatest degree, the first probe of the diameter estimate
+uint32_t
+SampleDegrees(const GraphTopology& topology, GraphStatistics* stats) {
+  uint64_t num_nodes = topology.num_nodes();
+  uint64_t num_samples =
+      std::min<uint64_t>(num_nodes, GraphStatistics::kDegreeSamples);
+  uint64_t stride = num_nodes / num_samples;
+
+  std::vector<uint64_t> degrees(num_samples);
+  uint64_t sample_total = 0;
+  uint32_t hub = 0;
+  uint64_t hub_degree = 0;
+  for (uint64_t i = 0; i < num_samples; ++i) {
+    auto [begin, end] = topology.edge_range(i * stride);
+    degrees[i] = end - begin;
+    sample_total += degrees[i];
+    if (degrees[i] > hub_degree) {
+      hub = i * stride;
+      hub_degree = degrees[i];
+    }
+  }
+  std::nth_element(
+      degrees.begin(), degrees.begin() + num_samples / 2, degrees.end());
+  double median = std::max<double>(1, degrees[num_samples / 2]);
+  stats->degree_skew = static_cast<double>(sample_total) / num_samples / median;
+
+  galois::GReduceMax<uint64_t> max_degree;
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        auto [begin, end] = topology.edge_range(n);
+        max_degree.update(end - begin);
+      },
+      galois::no_stats());
+  stats->max_degree = max_degree.reduce();
+  return hub;
+}
+
+/// Sweep a level-synchronous BFS along out-edges from source; returns the
+/// number of levels past the first and sets farthest to the least node of
+/// the last level
+uint32_t
+Sweep(
+    const GraphTopology& topology, uint32_t source,
+    std::vector<uint32_t>* levels, uint32_t* farthest) {
+  const uint32_t* dests = topology.out_dests->raw_values();
+  galois::do_all(
+      galois::iterate(uint64_t{0}, topology.num_nodes()),
+      [&](uint64_t n) { (*levels)[n] = kUnvisited; }, galois::no_stats());
+
+  galois::InsertBag<uint32_t> current;
+  galois::InsertBag<uint32_t> next;
+  (*levels)[source] = 0;
+  current.push(source);
+  uint32_t level = 0;
+  while (true) {
+    galois::do_all(
+        galois::iterate(current),
+        [&](uint32_t n) {
+          auto [e, e_end] = topology.edge_range(n);
+          for (; e != e_end; ++e) {
+            uint32_t dest = dests[e];
+            if ((*levels)[dest] == kUnvisited &&
+                __sync_bool_compare_and_swap(
+                    &(*levels)[dest], kUnvisited, level + 1)) {
+              next.push(dest);
+            }
+          }
+        },
+        galois::steal(), galois::no_stats(),
+        galois::loopname("GraphStatisticsSweep"));
+    if (next.empty()) {
+      break;
+    }
+    ++level;
+    current.swap(next);
+    next.clear();
+  }
+
+  galois::GReduceMin<uint32_t> least;
+  galois::do_all(
+      galois::iterate(current), [&](uint32_t n) { least.update(n); },
+      galois::no_stats());
+  *farthest = least.reduce();
+  return level;
+}
+
+template <typename ArrowType>
+void
+SampleWeights(
+    const arrow::ChunkedArray& values, uint64_t stride,
+    GraphStatistics* stats) {
+  using ArrayType = arrow::NumericArray<ArrowType>;
+
+  galois::GAccumulator<double> sum;
+  galois::GAccumulator<uint64_t> num_samples;
+  galois::GReduceMin<double> min_weight;
+  galois::GReduceMax<double> max_weight;
+  uint64_t chunk_begin = 0;
+  for (const std::shared_ptr<arrow::Array>& chunk : values.chunks()) {
+    uint64_t chunk_end = chunk_begin + chunk->length();
+    // the first sampled edge at or after chunk_begin
+    uint64_t first = (chunk_begin + stride - 1) / stride;
+    uint64_t last = (chunk_end + stride - 1) / stride;
+    const auto& array = static_cast<const ArrayType&>(*chunk);
+    galois::do_all(
+        galois::iterate(first, std::max(first, last)),
+        [&](uint64_t k) {
+          uint64_t i = k * stride - chunk_begin;
+          if (array.IsNull(i)) {
+            return;
+          }
+          double w = std::abs(static_cast<double>(array.Value(i)));
+          sum += w;
+          num_samples += 1;
+          min_weight.update(w);
+          max_weight.update(w);
+        },
+        galois::no_stats());
+    chunk_begin = chunk_end;
+  }
+
+  uint64_t n = num_samples.reduce();
+  if (n > 0) {
+    stats->mean_weight = sum.reduce() / n;
+    stats->min_weight = min_weight.reduce();
+    stats->max_weight = max_weight.reduce();
+  }
+}
+
+galois::Result<void>
+SampleWeights(
+    const galois::graphs::PropertyFileGraph& pfg, const std::string& property,
+    GraphStatistics* stats) {
+  if (auto res = pfg.EnsureEdgePropertiesLoaded({property}); !res) {
+    return res.error();
+  }
+  std::shared_ptr<arrow::ChunkedArray> values = pfg.EdgeProperty(property);
+  if (!values) {
+    return galois::ErrorCode::PropertyNotFound;
+  }
+  uint64_t stride = std::max<uint64_t>(
+      1, values->length() / GraphStatistics::kWeightSamples);
+
+  switch (values->type()->id()) {
+  case arrow::Type::INT8:
+    SampleWeights<arrow::Int8Type>(*values, stride, stats);
+    break;
+  case arrow::Type::UINT8:
+    SampleWeights<arrow::UInt8Type>(*values, stride, stats);
+    break;
+  case arrow::Type::INT16:
+    SampleWeights<arrow::Int16Type>(*values, stride, stats);
+    break;
+  case arrow::Type::UINT16:
+    SampleWeights<arrow::UInt16Type>(*values, stride, stats);
+    break;
+  case arrow::Type::INT32:
+    SampleWeights<arrow::Int32Type>(*values, stride, stats);
+    break;
+  case arrow::Type::UINT32:
+    SampleWeights<arrow::UInt32Type>(*values, stride, stats);
+    break;
+  case arrow::Type::INT64:
+    SampleWeights<arrow::Int64Type>(*values, stride, stats);
+    break;
+  case arrow::Type::UINT64:
+    SampleWeights<arrow::UInt64Type>(*values, stride, stats);
+    break;
+  case arrow::Type::FLOAT:
+    SampleWeights<arrow::FloatType>(*values, stride, stats);
+    break;
+  case arrow::Type::DOUBLE:
+    SampleWeights<arrow::DoubleType>(*values, stride, stats);
+    break;
+  default:
+    GALOIS_LOG_DEBUG("weights of type {}", values->type()->ToString());
+    return galois::ErrorCode::TypeError;
+  }
+  stats->weight_property = property;
+  return galois::ResultSuccess();
+}
+
+}  // namespace
+
+galois::Result<galois::analytics::GraphStatistics>
+galois::analytics::ComputeGraphStatistics(
+    const graphs::PropertyFileGraph& pfg, const std::string& weight_property) {
+  if (pfg.HasWideNodeIds()) {
+    GALOIS_LOG_DEBUG("graph statistics need 32-bit node ids");
+    return ErrorCode::InvalidArgument;
+  }
+  const GraphTopology& topology = pfg.topology();
+  GraphStatistics stats;
+  stats.num_nodes = topology.num_nodes();
+  stats.num_edges = topology.num_edges();
+
+  if (!weight_property.empty()) {
+    if (auto res = SampleWeights(pfg, weight_property, &stats); !res) {
+      return res.error();
+    }
+  }
+  if (stats.num_nodes == 0) {
+    return stats;
+  }
+  stats.mean_degree = static_cast<double>(stats.num_edges) / stats.num_nodes;
+
+  uint32_t probe = SampleDegrees(topology, &stats);
+  std::vector<uint32_t> levels(stats.num_nodes);
+  for (uint32_t i = 0; i < GraphStatistics::kDiameterProbes; ++i) {
+    uint32_t farthest = probe;
+    uint32_t eccentricity = Sweep(topology, probe, &levels, &farthest);
+    stats.estimated_diameter = std::max(stats.estimated_diameter, eccentricity);
+    probe = farthest;
+  }
+  return stats;
+}
+
+galois::Result<galois::analytics::GraphStatistics>
+galois::analytics::GetGraphStatistics(
+    const graphs::PropertyFileGraph& pfg, const std::string& weight_property) {
+  if (!pfg.graph_statistics().empty()) {
+    auto parse_result = ParseGraphStatistics(pfg.graph_statistics());
+    if (parse_result) {
+      const GraphStatistics& cached = parse_result.value();
+      if (cached.num_nodes == pfg.topology().num_nodes() &&
+          cached.num_edges == pfg.topology().num_edges() &&
+          (weight_property.empty() ||
+           cached.weight_property == weight_property)) {
+        return parse_result;
+      }
+    } else {
+      GALOIS_LOG_WARN(
+          "ignoring unreadable graph statistics: {}", parse_result.error());
+    }
+  }
+
+  auto stats_result = ComputeGraphStatistics(pfg, weight_property);
+  if (!stats_result) {
+    return stats_result.error();
+  }
+  auto dump_result = DumpGraphStatistics(stats_result.value());
+  if (!dump_result) {
+    return dump_result.error();
+  }
+  pfg.set_graph_statistics(std::move(dump_result.value()));
+  return stats_result;
+}
+
+galois::Result<std::string>
+galois::analytics::DumpGraphStatistics(const GraphStatistics& stats) {
+  return JsonDump(stats);
+}
+
+galois::Result<galois::analytics::GraphStatistics>
+galois::analytics::ParseGraphStatistics(const std::string& text) {
+  return JsonParse<GraphStatistics>(text);
+}
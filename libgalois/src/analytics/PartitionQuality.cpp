@@ -0,0 +1,277 @@
+#include "galois/analytics/PartitionQuality.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <arrow/api.h>
+#include <arrow/compute/api.h>
+
+#include "galois/AtomicHelpers.h"
+#include "galois/ErrorCode.h"
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/Logging.h"
+#include "galois/Reduction.h"
+#include "galois/VectorReduction.h"
+#include "galois/substrate/PerThreadStorage.h"
+#include "tsuba/MemoryPool.h"
+
+namespace {
+
+using galois::analytics::kMaxHistogramParts;
+using galois::analytics::PartitionQuality;
+using galois::graphs::GraphTopology;
+
+/// The values of property cast to type, in one array
+template <typename ArrayType>
+galois::Result<std::shared_ptr<ArrayType>>
+CastProperty(
+    const std::shared_ptr<arrow::ChunkedArray>& property,
+    const std::shared_ptr<arrow::DataType>& type) {
+  auto cast_result = arrow::compute::Cast(arrow::Datum(property), type);
+  if (!cast_result.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", cast_result.status());
+    // values that do not fit, e.g., negative part ids
+    if (cast_result.status().IsInvalid()) {
+      return galois::ErrorCode::InvalidArgument;
+    }
+    return galois::ErrorCode::ArrowError;
+  }
+  std::shared_ptr<arrow::ChunkedArray> values =
+      cast_result.ValueOrDie().chunked_array();
+  if (values->num_chunks() == 1) {
+    return std::static_pointer_cast<ArrayType>(values->chunk(0));
+  }
+  auto concat_result =
+      values->num_chunks() == 0
+          ? arrow::MakeArrayOfNull(type, 0, tsuba::GetArrowMemoryPool())
+          : arrow::Concatenate(values->chunks(), tsuba::GetArrowMemoryPool());
+  if (!concat_result.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", concat_result.status());
+    return galois::ErrorCode::ArrowError;
+  }
+  return std::static_pointer_cast<ArrayType>(concat_result.ValueOrDie());
+}
+
+/// The per part sums of ComputePartitionQuality: per thread histograms up to
+/// kMaxHistogramParts parts, and shared atomic sums beyond
+class PartSums {
+  bool shared_;
+  galois::GHistogram<uint64_t> sizes_;
+  galois::GVectorAccumulator<double> volumes_;
+  galois::GVectorAccumulator<double> cuts_;
+  galois::LargeArray<std::atomic<uint64_t>> shared_sizes_;
+  galois::LargeArray<std::atomic<double>> shared_volumes_;
+  galois::LargeArray<std::atomic<double>> shared_cuts_;
+
+public:
+  explicit PartSums(uint64_t num_parts)
+      : shared_(num_parts > kMaxHistogramParts) {
+    if (!shared_) {
+      sizes_.resize(num_parts);
+      volumes_.resize(num_parts);
+      cuts_.resize(num_parts);
+      return;
+    }
+    shared_sizes_.allocateBlocked(num_parts);
+    shared_volumes_.allocateBlocked(num_parts);
+    shared_cuts_.allocateBlocked(num_parts);
+    galois::do_all(
+        galois::iterate(uint64_t{0}, num_parts),
+        [&](uint64_t p) {
+          shared_sizes_.constructAt(p, 0);
+          shared_volumes_.constructAt(p, 0);
+          shared_cuts_.constructAt(p, 0);
+        },
+        galois::no_stats());
+  }
+
+  void Add(uint64_t part, double volume, double cut) {
+    if (!shared_) {
+      sizes_.update(part, 1);
+      volumes_.update(part, volume);
+      cuts_.update(part, cut);
+      return;
+    }
+    galois::atomicAdd(shared_sizes_[part], uint64_t{1});
+    galois::atomicAdd(shared_volumes_[part], volume);
+    galois::atomicAdd(shared_cuts_[part], cut);
+  }
+
+  void Reduce(PartitionQuality* quality) const {
+    if (!shared_) {
+      quality->part_sizes = sizes_.reduce();
+      quality->part_volumes = volumes_.reduce();
+      quality->part_cuts = cuts_.reduce();
+      return;
+    }
+    uint64_t num_parts = shared_sizes_.size();
+    quality->part_sizes.resize(num_parts);
+    quality->part_volumes.resize(num_parts);
+    quality->part_cuts.resize(num_parts);
+    galois::do_all(
+        galois::iterate(uint64_t{0}, num_parts),
+        [&](uint64_t p) {
+          quality->part_sizes[p] = shared_sizes_[p].load();
+          quality->part_volumes[p] = shared_volumes_[p].load();
+          quality->part_cuts[p] = shared_cuts_[p].load();
+        },
+        galois::no_stats());
+  }
+};
+
+galois::Result<std::shared_ptr<arrow::UInt64Array>>
+GetParts(
+    const galois::graphs::PropertyFileGraph& pfg, const std::string& property) {
+  if (auto res = pfg.EnsureNodePropertiesLoaded({property}); !res) {
+    return res.error();
+  }
+  std::shared_ptr<arrow::ChunkedArray> values = pfg.NodeProperty(property);
+  if (!values) {
+    return galois::ErrorCode::PropertyNotFound;
+  }
+  if (!arrow::is_integer(values->type()->id())) {
+    return galois::ErrorCode::TypeError;
+  }
+  if (values->null_count() > 0) {
+    GALOIS_LOG_DEBUG("{} nodes have no part", values->null_count());
+    return galois::ErrorCode::InvalidArgument;
+  }
+  return CastProperty<arrow::UInt64Array>(values, arrow::uint64());
+}
+
+galois::Result<std::shared_ptr<arrow::DoubleArray>>
+GetWeights(
+    const galois::graphs::PropertyFileGraph& pfg, const std::string& property) {
+  if (auto res = pfg.EnsureEdgePropertiesLoaded({property}); !res) {
+    return res.error();
+  }
+  std::shared_ptr<arrow::ChunkedArray> values = pfg.EdgeProperty(property);
+  if (!values) {
+    return galois::ErrorCode::PropertyNotFound;
+  }
+  if (!arrow::is_integer(values->type()->id()) &&
+      !arrow::is_floating(values->type()->id())) {
+    return galois::ErrorCode::TypeError;
+  }
+  return CastProperty<arrow::DoubleArray>(values, arrow::float64());
+}
+
+}  // namespace
+
+galois::Result<PartitionQuality>
+galois::analytics::ComputePartitionQuality(
+    const graphs::PropertyFileGraph& pfg, const std::string& part_property,
+    const std::string& weight_property) {
+  if (pfg.HasWideNodeIds()) {
+    return ErrorCode::InvalidArgument;
+  }
+  const GraphTopology& topology = pfg.topology();
+  const uint64_t num_nodes = topology.num_nodes();
+
+  auto parts_result = GetParts(pfg, part_property);
+  if (!parts_result) {
+    return parts_result.error();
+  }
+  std::shared_ptr<arrow::UInt64Array> parts = std::move(parts_result.value());
+  std::shared_ptr<arrow::DoubleArray> weights;
+  if (!weight_property.empty()) {
+    auto weights_result = GetWeights(pfg, weight_property);
+    if (!weights_result) {
+      return weights_result.error();
+    }
+    weights = std::move(weights_result.value());
+  }
+
+  PartitionQuality quality;
+  if (num_nodes == 0) {
+    return quality;
+  }
+
+  const uint64_t* part = parts->raw_values();
+  const uint32_t* dests = topology.out_dests->raw_values();
+  const double* weight = weights ? weights->raw_values() : nullptr;
+  const bool weight_nulls = weights && weights->null_count() > 0;
+
+  galois::GReduceMax<uint64_t> max_part;
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { max_part.update(part[n]); }, galois::no_stats());
+  const uint64_t num_parts = max_part.reduce() + 1;
+  if (num_parts > std::max(num_nodes, kMaxHistogramParts)) {
+    GALOIS_LOG_DEBUG("part id {} is out of range", num_parts - 1);
+    return ErrorCode::InvalidArgument;
+  }
+
+  galois::StatTimer execTime("PartitionQuality");
+  execTime.start();
+
+  PartSums sums(num_parts);
+  galois::GAccumulator<uint64_t> communication_volume;
+  // the distinct other parts of the out-neighbors of a node
+  galois::substrate::PerThreadStorage<std::vector<uint64_t>> neighbor_parts;
+
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        const uint64_t p = part[n];
+        std::vector<uint64_t>& others = *neighbor_parts.getLocal();
+        others.clear();
+        double volume = 0;
+        double cut = 0;
+        auto [e, e_end] = topology.edge_range(n);
+        for (; e != e_end; ++e) {
+          double w = 1;
+          if (weight) {
+            w = weight_nulls && weights->IsNull(e) ? 0 : weight[e];
+          }
+          volume += w;
+          const uint64_t q = part[dests[e]];
+          if (q != p) {
+            cut += w;
+            others.emplace_back(q);
+          }
+        }
+        std::sort(others.begin(), others.end());
+        communication_volume +=
+            std::unique(others.begin(), others.end()) - others.begin();
+        sums.Add(p, volume, cut);
+      },
+      galois::steal(), galois::loopname("PartitionQuality"));
+
+  sums.Reduce(&quality);
+  quality.communication_volume = communication_volume.reduce();
+
+  // the rest is per part, which is no more work than per node
+  double total = 0;
+  uint64_t max_size = 0;
+  for (uint64_t p = 0; p < num_parts; ++p) {
+    total += quality.part_volumes[p];
+    quality.edge_cut += quality.part_cuts[p];
+    max_size = std::max(max_size, quality.part_sizes[p]);
+  }
+  quality.part_conductances.resize(num_parts);
+  for (uint64_t p = 0; p < num_parts; ++p) {
+    const double volume = quality.part_volumes[p];
+    const double cut = quality.part_cuts[p];
+    const double smaller = std::min(volume, total - volume);
+    if (smaller > 0) {
+      quality.part_conductances[p] = cut / smaller;
+    }
+    if (quality.part_sizes[p] > 0) {
+      quality.max_conductance =
+          std::max(quality.max_conductance, quality.part_conductances[p]);
+    }
+    if (total > 0) {
+      quality.modularity +=
+          (volume - cut) / total - (volume / total) * (volume / total);
+    }
+  }
+  quality.balance = static_cast<double>(max_size) * num_parts / num_nodes;
+
+  execTime.stop();
+
+  return quality;
+}
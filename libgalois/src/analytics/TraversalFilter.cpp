@@ -0,0 +1,261 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/analytics/TraversalFilter.h"
+
+#include <arrow/compute/api.h>
+
+#include "galois/DynamicBitset.h"
+#include "galois/ErrorCode.h"
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/ParallelSTL.h"
+#include "tsuba/MemoryPool.h"
+
+namespace {
+
+using galois::graphs::EdgeTypeIndex;
+using galois::graphs::GraphTopology;
+
+/// The nodes with at least one of labels
+galois::Result<void>
+MarkLabeledNodes(
+    const galois::graphs::PropertyFileGraph& pfg,
+    const std::vector<std::string>& labels, galois::DynamicBitset* nodes) {
+  if (auto res = pfg.EnsureNodePropertiesLoaded(labels); !res) {
+    return res.error();
+  }
+  nodes->resize(pfg.topology().num_nodes());
+  for (const std::string& label : labels) {
+    std::shared_ptr<arrow::ChunkedArray> property = pfg.NodeProperty(label);
+    if (!property) {
+      return galois::ErrorCode::PropertyNotFound;
+    }
+    if (property->type()->id() != arrow::Type::BOOL) {
+      return galois::ErrorCode::TypeError;
+    }
+    int64_t chunk_begin = 0;
+    for (const auto& chunk : property->chunks()) {
+      auto values = std::static_pointer_cast<arrow::BooleanArray>(chunk);
+      galois::do_all(
+          galois::iterate(int64_t{0}, values->length()),
+          [&](int64_t i) {
+            if (values->IsValid(i) && values->Value(i)) {
+              nodes->set(chunk_begin + i);
+            }
+          },
+          galois::no_stats());
+      chunk_begin += values->length();
+    }
+  }
+  return galois::ResultSuccess();
+}
+
+/// EdgeSelector visits the edges of a node that pass a filter, calling
+/// fn(edge id, destination) for each of them
+class EdgeSelector {
+  const GraphTopology& topology_;
+  const galois::DynamicBitset* nodes_;
+  const EdgeTypeIndex* index_;
+  std::vector<size_t> types_;
+
+  bool Keep(uint32_t dest) const { return !nodes_ || nodes_->test(dest); }
+
+public:
+  EdgeSelector(
+      const GraphTopology& topology, const galois::DynamicBitset* nodes,
+      const EdgeTypeIndex* index, std::vector<size_t> types)
+      : topology_(topology),
+        nodes_(nodes),
+        index_(index),
+        types_(std::move(types)) {}
+
+  template <typename F>
+  void ForEach(uint32_t node, const F& fn) const {
+    if (nodes_ && !nodes_->test(node)) {
+      return;
+    }
+    if (!index_) {
+      auto [begin, end] = topology_.edge_range(node);
+      for (uint64_t e = begin; e < end; ++e) {
+        uint32_t dest = topology_.out_dests->Value(e);
+        if (Keep(dest)) {
+          fn(e, dest);
+        }
+      }
+      return;
+    }
+
+    // edges of a single type come grouped by type; the few with several
+    // types are checked one by one
+    for (size_t t : types_) {
+      auto [begin, end] = index_->type_range(node, t);
+      for (uint64_t p = begin; p < end; ++p) {
+        if (Keep(index_->edge_dest(p))) {
+          fn(index_->edge_id(p), index_->edge_dest(p));
+        }
+      }
+    }
+    auto [begin, end] = index_->mixed_range(node);
+    for (uint64_t p = begin; p < end; ++p) {
+      uint64_t e = index_->edge_id(p);
+      bool typed = false;
+      for (size_t t : types_) {
+        typed = typed || index_->HasType(e, t);
+      }
+      if (typed && Keep(index_->edge_dest(p))) {
+        fn(e, index_->edge_dest(p));
+      }
+    }
+  }
+};
+
+galois::Result<std::shared_ptr<arrow::Buffer>>
+Allocate(uint64_t size) {
+  auto alloc_result = arrow::AllocateBuffer(size, tsuba::GetArrowMemoryPool());
+  if (!alloc_result.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", alloc_result.status());
+    return galois::ErrorCode::ArrowError;
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(alloc_result.ValueOrDie()));
+}
+
+}  // namespace
+
+galois::Result<std::unique_ptr<galois::graphs::PropertyFileGraph>>
+galois::analytics::internal::FilterGraph(
+    graphs::PropertyFileGraph* pfg, const TraversalFilter& filter,
+    const std::vector<std::string>& edge_properties) {
+  const GraphTopology& topology = pfg->topology();
+  uint64_t num_nodes = topology.num_nodes();
+
+  galois::DynamicBitset nodes;
+  if (!filter.node_labels.empty()) {
+    if (auto res = MarkLabeledNodes(*pfg, filter.node_labels, &nodes); !res) {
+      return res.error();
+    }
+  }
+
+  std::shared_ptr<const graphs::EdgeTypeIndex> index =
+      filter.edge_type_index;
+  std::vector<size_t> types;
+  if (!filter.edge_types.empty()) {
+    if (!index) {
+      auto index_result = pfg->EdgeTypes(filter.edge_types);
+      if (!index_result) {
+        return index_result.error();
+      }
+      index = std::move(index_result.value());
+    }
+    for (const std::string& name : filter.edge_types) {
+      int t = index->TypeIndex(name);
+      if (t < 0) {
+        return ErrorCode::InvalidArgument;
+      }
+      types.emplace_back(t);
+    }
+  }
+  EdgeSelector selector(
+      topology, filter.node_labels.empty() ? nullptr : &nodes,
+      filter.edge_types.empty() ? nullptr : index.get(), std::move(types));
+
+  auto indices_result = Allocate(num_nodes * sizeof(uint64_t));
+  if (!indices_result) {
+    return indices_result.error();
+  }
+  std::shared_ptr<arrow::Buffer> indices_buffer = indices_result.value();
+  auto* indices = reinterpret_cast<uint64_t*>(indices_buffer->mutable_data());
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t degree = 0;
+        selector.ForEach(n, [&](uint64_t, uint32_t) { ++degree; });
+        indices[n] = degree;
+      },
+      galois::steal(), galois::no_stats(),
+      galois::loopname("FilterGraph-Degrees"));
+  galois::ParallelSTL::partial_sum(indices, indices + num_nodes, indices);
+  uint64_t num_edges = num_nodes > 0 ? indices[num_nodes - 1] : 0;
+
+  auto dests_result = Allocate(num_edges * sizeof(uint32_t));
+  if (!dests_result) {
+    return dests_result.error();
+  }
+  auto ids_result = Allocate(num_edges * sizeof(uint64_t));
+  if (!ids_result) {
+    return ids_result.error();
+  }
+  std::shared_ptr<arrow::Buffer> dests_buffer = dests_result.value();
+  std::shared_ptr<arrow::Buffer> ids_buffer = ids_result.value();
+  auto* dests = reinterpret_cast<uint32_t*>(dests_buffer->mutable_data());
+  auto* ids = reinterpret_cast<uint64_t*>(ids_buffer->mutable_data());
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t out = n == 0 ? 0 : indices[n - 1];
+        selector.ForEach(n, [&](uint64_t e, uint32_t dest) {
+          dests[out] = dest;
+          ids[out] = e;
+          ++out;
+        });
+      },
+      galois::steal(), galois::no_stats(),
+      galois::loopname("FilterGraph-Edges"));
+
+  auto filtered = std::make_unique<graphs::PropertyFileGraph>();
+  if (auto res = filtered->SetTopology(graphs::GraphTopology{
+          .out_indices =
+              std::make_shared<arrow::UInt64Array>(num_nodes, indices_buffer),
+          .out_dests =
+              std::make_shared<arrow::UInt32Array>(num_edges, dests_buffer),
+      });
+      !res) {
+    return res.error();
+  }
+
+  if (edge_properties.empty()) {
+    return std::unique_ptr<graphs::PropertyFileGraph>(std::move(filtered));
+  }
+  if (auto res = pfg->EnsureEdgePropertiesLoaded(edge_properties); !res) {
+    return res.error();
+  }
+  auto edge_ids = std::make_shared<arrow::UInt64Array>(num_edges, ids_buffer);
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (const std::string& name : edge_properties) {
+    int i = pfg->edge_schema()->GetFieldIndex(name);
+    if (i < 0) {
+      return ErrorCode::PropertyNotFound;
+    }
+    auto take_result = arrow::compute::Take(
+        arrow::Datum(pfg->EdgeProperty(i)), arrow::Datum(edge_ids));
+    if (!take_result.ok()) {
+      GALOIS_LOG_DEBUG("arrow error: {}", take_result.status());
+      return ErrorCode::ArrowError;
+    }
+    fields.emplace_back(pfg->edge_schema()->field(i));
+    columns.emplace_back(take_result.ValueOrDie().chunked_array());
+  }
+  if (auto res = filtered->AddEdgeProperties(
+          arrow::Table::Make(arrow::schema(fields), columns, num_edges));
+      !res) {
+    return res.error();
+  }
+  return std::unique_ptr<graphs::PropertyFileGraph>(std::move(filtered));
+}
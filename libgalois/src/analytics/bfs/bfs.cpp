@@ -19,7 +19,10 @@
 
 #include <deque>
 #include <type_traits>
+#include <vector>
 
+#include "galois/DynamicBitset.h"
+#include "galois/LargeArray.h"
 #include "galois/analytics/bfs/bfs_internal.h"
 
 using namespace galois::analytics;
@@ -51,18 +54,6 @@ struct EdgeTileMaker {
   }
 };
 
-struct NodePushWrap {
-  template <typename C>
-  void operator()(C& cont, const Graph::Node& n, const char* const) const {
-    (*this)(cont, n);
-  }
-
-  template <typename C>
-  void operator()(C& cont, const Graph::Node& n) const {
-    cont.push(n);
-  }
-};
-
 struct EdgeTilePushWrap {
   Graph* graph;
   BfsImplementation& impl;
@@ -202,10 +193,13 @@ SyncAlgo(
 
   assert(!next->empty());
 
+  galois::GAccumulator<uint64_t> reached;
+
   while (!next->empty()) {
     std::swap(curr, next);
     next->clear();
     ++next_level;
+    reached.reset();
 
     loop(
         galois::iterate(*curr),
@@ -217,17 +211,192 @@ SyncAlgo(
             if (dest_data == BfsImplementation::kDistanceInfinity) {
               dest_data = next_level;
               pushWrap(*next, *dest);
+              reached += 1;
             }
           }
         },
         galois::steal(), galois::chunk_size<kChunkSize>(),
         galois::loopname("Sync"));
+
+    if (galois::analytics::internal::EndRound(reached.reduce())) {
+      break;
+    }
+  }
+}
+
+/// Level-synchronous BFS over a frontier that switches between sparse and
+/// dense representations
+void
+SyncFrontierAlgo(
+    Graph* graph, Graph::Node source, uint32_t dense_frontier_divisor) {
+  using Frontier = BfsImplementation::Frontier;
+
+  Frontier frontier_a{graph};
+  Frontier frontier_b{graph};
+  Frontier* curr = &frontier_a;
+  Frontier* next = &frontier_b;
+
+  Dist next_level = 0U;
+  graph->GetData<BfsNodeDistance>(source) = 0U;
+  curr->Push(source);
+  curr->Finish();
+
+  while (!curr->empty()) {
+    next->Reset(curr->NextIsDense(dense_frontier_divisor));
+    ++next_level;
+
+    curr->ForEach(
+        [&](const Graph::Node& src) {
+          for (auto e : graph->edges(src)) {
+            auto dest = graph->GetEdgeDest(e);
+            auto& dest_data = graph->GetData<BfsNodeDistance>(dest);
+
+            if (dest_data == BfsImplementation::kDistanceInfinity) {
+              dest_data = next_level;
+              next->Push(*dest);
+            }
+          }
+        },
+        "Sync");
+
+    next->Finish();
+    std::swap(curr, next);
+
+    if (galois::analytics::internal::EndRound(curr->size())) {
+      break;
+    }
+  }
+}
+
+/// Direction-optimizing BFS: top-down steps push from a sparse frontier along
+/// out-edges while the frontier is small; once its edges outnumber 1/alpha of
+/// the unexplored edges, bottom-up steps have every unvisited node look for a
+/// parent in a dense (bitset) frontier along its in-edges, stopping at the
+/// first one found, until the frontier shrinks below 1/beta of the nodes.
+void
+SyncDirectionOptAlgo(
+    Graph* graph, const galois::graphs::InEdgeTopology& in_edges,
+    Graph::Node source, uint32_t alpha, uint32_t beta) {
+  using Cont = galois::InsertBag<Graph::Node>;
+
+  const uint64_t num_nodes = graph->num_nodes();
+  const uint32_t* in_sources = in_edges.in_sources->raw_values();
+
+  auto curr = std::make_unique<Cont>();
+  auto next = std::make_unique<Cont>();
+  galois::DynamicBitset front;
+  galois::DynamicBitset next_front;
+  front.resize(num_nodes);
+  next_front.resize(num_nodes);
+
+  galois::GAccumulator<uint64_t> work_items;
+
+  Dist next_level = 0U;
+  graph->GetData<BfsNodeDistance>(source) = 0U;
+  next->push(source);
+
+  // edges_to_check: out-edges of nodes not yet visited; scout_count: out-edges
+  // of the current frontier
+  int64_t edges_to_check = graph->num_edges();
+  int64_t scout_count = graph->edge_end(source) - graph->edge_begin(source);
+
+  galois::GAccumulator<uint64_t> reached;
+  bool stop = false;
+
+  while (!stop && !next->empty()) {
+    std::swap(curr, next);
+    next->clear_keep_blocks();
+
+    if (scout_count > edges_to_check / alpha) {
+      front.reset();
+      work_items.reset();
+      galois::do_all(
+          galois::iterate(*curr),
+          [&](Graph::Node n) {
+            front.set(n);
+            work_items += 1;
+          },
+          galois::steal(), galois::chunk_size<kChunkSize>(),
+          galois::loopname("SyncDirectionOpt-ToBitset"));
+
+      uint64_t old_work_items = 0;
+      do {
+        ++next_level;
+        old_work_items = work_items.reduce();
+        work_items.reset();
+
+        galois::do_all(
+            galois::iterate(graph->begin(), graph->end()),
+            [&](Graph::Node dst) {
+              auto& ddata = graph->GetData<BfsNodeDistance>(dst);
+              if (ddata != BfsImplementation::kDistanceInfinity) {
+                return;
+              }
+              auto [begin, end] = in_edges.edge_range(dst);
+              for (uint64_t e = begin; e != end; ++e) {
+                if (front.test(in_sources[e])) {
+                  ddata = next_level;
+                  next_front.set(dst);
+                  work_items += 1;
+                  break;
+                }
+              }
+            },
+            galois::steal(), galois::chunk_size<kChunkSize>(),
+            galois::loopname("SyncDirectionOpt-Pull"));
+
+        // next_front is empty for the next level once swapped
+        front.swap_and_clear(next_front);
+        stop = galois::analytics::internal::EndRound(work_items.reduce());
+      } while (!stop && (work_items.reduce() >= old_work_items ||
+                         work_items.reduce() > num_nodes / beta));
+
+      galois::do_all(
+          galois::iterate(graph->begin(), graph->end()),
+          [&](Graph::Node n) {
+            if (front.test(n)) {
+              next->push(n);
+            }
+          },
+          galois::steal(), galois::chunk_size<kChunkSize>(),
+          galois::loopname("SyncDirectionOpt-ToBag"));
+      scout_count = 1;
+    } else {
+      ++next_level;
+      edges_to_check -= scout_count;
+      work_items.reset();
+      reached.reset();
+
+      galois::do_all(
+          galois::iterate(*curr),
+          [&](Graph::Node src) {
+            for (auto e : graph->edges(src)) {
+              auto dst = graph->GetEdgeDest(e);
+              auto& ddata = graph->GetData<BfsNodeDistance>(dst);
+              if (ddata == BfsImplementation::kDistanceInfinity &&
+                  __sync_bool_compare_and_swap(
+                      &ddata, BfsImplementation::kDistanceInfinity,
+                      next_level)) {
+                next->push(*dst);
+                work_items += graph->edge_end(*dst) - graph->edge_begin(*dst);
+                reached += 1;
+              }
+            }
+          },
+          galois::steal(), galois::chunk_size<kChunkSize>(),
+          galois::loopname("SyncDirectionOpt-Push"));
+
+      scout_count = work_items.reduce();
+      stop = galois::analytics::internal::EndRound(reached.reduce());
+    }
   }
 }
 
 template <bool CONCURRENT>
 void
-RunAlgo(BfsPlan algo, Graph* graph, const Graph::Node& source) {
+RunAlgo(
+    BfsPlan algo, Graph* graph, const Graph::Node& source,
+    const galois::graphs::InEdgeTopology* in_edges) {
   BfsImplementation impl{algo.edge_tile_size()};
   switch (algo.algorithm()) {
   case BfsPlan::kAsyncTile:
@@ -243,18 +412,114 @@ RunAlgo(BfsPlan algo, Graph* graph, const Graph::Node& source) {
         graph, source, EdgeTilePushWrap{graph, impl}, TileRangeFn());
     break;
   case BfsPlan::kSync:
-    SyncAlgo<CONCURRENT, Graph::Node>(
-        graph, source, NodePushWrap(), OutEdgeRangeFn{graph});
+    SyncFrontierAlgo(graph, source, algo.dense_frontier_divisor());
+    break;
+  case BfsPlan::kSyncDirectionOpt:
+    SyncDirectionOptAlgo(graph, *in_edges, source, algo.alpha(), algo.beta());
     break;
   default:
     std::cerr << "ERROR: unkown algo type\n";
   }
 }
 
+/// MultiSourceBfsBatch runs one MS-BFS from up to kMultiSourceBfsBatchSize
+/// sources. Bit i of seen[n] is set once n is reached from sources[i]; each
+/// level step pushes, for every node in the frontier of any source, the mask
+/// of sources with n in their frontier along its out-edges. visit(n, level,
+/// mask) is called once for each node and level at which n is first reached
+/// by the sources in mask.
+template <typename VisitFn>
+void
+MultiSourceBfsBatch(
+    const galois::graphs::GraphTopology& topology, const uint32_t* sources,
+    size_t num_sources, galois::LargeArray<uint64_t>* seen,
+    const VisitFn& visit) {
+  assert(num_sources <= kMultiSourceBfsBatchSize);
+  const uint64_t num_nodes = topology.num_nodes();
+  const uint32_t* out_dests = topology.out_dests->raw_values();
+
+  galois::LargeArray<uint64_t> frontier;
+  galois::LargeArray<uint64_t> next;
+  frontier.allocateBlocked(num_nodes);
+  next.allocateBlocked(num_nodes);
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        (*seen)[n] = 0;
+        frontier[n] = 0;
+        next[n] = 0;
+      },
+      galois::no_stats());
+
+  for (size_t i = 0; i < num_sources; ++i) {
+    uint64_t bit = uint64_t{1} << i;
+    (*seen)[sources[i]] |= bit;
+    frontier[sources[i]] |= bit;
+    visit(sources[i], 0U, bit);
+  }
+
+  galois::GReduceLogicalOr active;
+  uint32_t level = 0;
+  do {
+    ++level;
+
+    galois::do_all(
+        galois::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t src) {
+          uint64_t mask = frontier[src];
+          if (!mask) {
+            return;
+          }
+          auto [begin, end] = topology.edge_range(src);
+          for (uint64_t e = begin; e != end; ++e) {
+            uint32_t dst = out_dests[e];
+            uint64_t reached = mask & ~(*seen)[dst];
+            // skip the atomic when every bit is already there
+            if (reached && (next[dst] & reached) != reached) {
+              __sync_fetch_and_or(&next[dst], reached);
+            }
+          }
+        },
+        galois::steal(), galois::chunk_size<kChunkSize>(),
+        galois::loopname("MultiSourceBfs-Push"));
+
+    active.reset();
+    galois::do_all(
+        galois::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          uint64_t reached = next[n] & ~(*seen)[n];
+          next[n] = 0;
+          frontier[n] = reached;
+          if (reached) {
+            (*seen)[n] |= reached;
+            visit(n, level, reached);
+            active.update(true);
+          }
+        },
+        galois::steal(), galois::chunk_size<kChunkSize>(),
+        galois::loopname("MultiSourceBfs-Update"));
+  } while (active.reduce());
+}
+
+galois::Result<void>
+ValidateSources(
+    const galois::graphs::PropertyFileGraph& pfg,
+    const std::vector<uint32_t>& sources) {
+  for (uint32_t source : sources) {
+    if (source >= pfg.topology().num_nodes()) {
+      return galois::ErrorCode::InvalidArgument;
+    }
+  }
+  return galois::ResultSuccess();
+}
+
 galois::Result<void>
 galois::analytics::Bfs(
     graphs::PropertyGraph<std::tuple<BfsNodeDistance>, std::tuple<>>& graph,
     size_t start_node, BfsPlan algo) {
+  if (algo.architecture() != kCPU) {
+    return galois::ErrorCode::NotImplemented;
+  }
   if (start_node >= graph.size()) {
     return galois::ErrorCode::InvalidArgument;
   }
@@ -263,6 +528,18 @@ galois::analytics::Bfs(
   std::advance(it, start_node);
   Graph::Node source = *it;
 
+  const galois::graphs::InEdgeTopology* in_edges = nullptr;
+  if (algo.algorithm() == BfsPlan::kSyncDirectionOpt) {
+    if (algo.alpha() == 0 || algo.beta() == 0) {
+      return galois::ErrorCode::InvalidArgument;
+    }
+    auto in_edges_result = graph.GetPropertyFileGraph().InEdges();
+    if (!in_edges_result) {
+      return in_edges_result.error();
+    }
+    in_edges = in_edges_result.value();
+  }
+
   size_t approxNodeData = 4 * (graph.num_nodes() + graph.num_edges());
   galois::Prealloc(8, approxNodeData);
 
@@ -273,7 +550,7 @@ galois::analytics::Bfs(
   galois::StatTimer execTime("BFS");
   execTime.start();
 
-  RunAlgo<true>(algo, &graph, source);
+  RunAlgo<true>(algo, &graph, source, in_edges);
 
   execTime.stop();
 
@@ -284,8 +561,19 @@ galois::Result<void>
 galois::analytics::Bfs(
     galois::graphs::PropertyFileGraph* pfg, size_t start_node,
     const std::string& output_property_name, BfsPlan algo) {
-  if (auto result = ConstructNodeProperties<std::tuple<BfsNodeDistance>>(
-          pfg, {output_property_name});
+  if (!algo.filter().empty()) {
+    return internal::RunFiltered(
+        pfg, algo.filter(), {}, output_property_name,
+        [&](graphs::PropertyFileGraph* filtered) {
+          return Bfs(
+              filtered, start_node, output_property_name,
+              algo.WithFilter({}));
+        });
+  }
+
+  // Bfs sets the distance of every node first
+  if (auto result = ConstructUninitializedNodeProperty<BfsNodeDistance>(
+          pfg, output_property_name);
       !result) {
     return result.error();
   }
@@ -297,3 +585,130 @@ galois::analytics::Bfs(
 
   return Bfs(pg_result.value(), start_node, algo);
 }
+
+galois::analytics::AsyncResult<void>
+galois::analytics::BfsAsync(
+    galois::graphs::PropertyFileGraph* pfg, size_t start_node,
+    const std::string& output_property_name, BfsPlan algo) {
+  return RunAsync<void>([=]() {
+    return Bfs(pfg, start_node, output_property_name, algo);
+  });
+}
+
+galois::Result<void>
+galois::analytics::MultiSourceBfs(
+    galois::graphs::PropertyFileGraph* pfg,
+    const std::vector<uint32_t>& sources,
+    const std::vector<std::string>& output_property_names) {
+  if (sources.size() != output_property_names.size()) {
+    return galois::ErrorCode::InvalidArgument;
+  }
+  if (auto result = ValidateSources(*pfg, sources); !result) {
+    return result.error();
+  }
+
+  std::vector<Graph> levels;
+  levels.reserve(sources.size());
+  for (const std::string& name : output_property_names) {
+    if (auto result =
+            ConstructNodeProperties<std::tuple<BfsNodeDistance>>(pfg, {name});
+        !result) {
+      return result.error();
+    }
+    auto pg_result = Graph::Make(pfg, {name}, {});
+    if (!pg_result) {
+      return pg_result.error();
+    }
+    levels.emplace_back(std::move(pg_result.value()));
+  }
+
+  galois::StatTimer execTime("MultiSourceBfs");
+  execTime.start();
+
+  galois::LargeArray<uint64_t> seen;
+  seen.allocateBlocked(pfg->topology().num_nodes());
+
+  for (size_t first = 0; first < sources.size();
+       first += kMultiSourceBfsBatchSize) {
+    size_t num_sources =
+        std::min(kMultiSourceBfsBatchSize, sources.size() - first);
+    Graph* batch_levels = &levels[first];
+
+    galois::do_all(
+        galois::iterate(uint64_t{0}, pfg->topology().num_nodes()),
+        [&](uint64_t n) {
+          for (size_t i = 0; i < num_sources; ++i) {
+            batch_levels[i].GetData<BfsNodeDistance>(n) =
+                BfsImplementation::kDistanceInfinity;
+          }
+        },
+        galois::no_stats());
+
+    MultiSourceBfsBatch(
+        pfg->topology(), &sources[first], num_sources, &seen,
+        [&](uint32_t n, uint32_t level, uint64_t mask) {
+          for (; mask; mask &= mask - 1) {
+            batch_levels[__builtin_ctzll(mask)].GetData<BfsNodeDistance>(n) =
+                level;
+          }
+        });
+  }
+
+  execTime.stop();
+
+  return galois::ResultSuccess();
+}
+
+galois::Result<void>
+galois::analytics::MultiSourceReachability(
+    galois::graphs::PropertyFileGraph* pfg,
+    const std::vector<uint32_t>& sources,
+    const std::vector<std::string>& output_property_names) {
+  size_t num_batches = (sources.size() + kMultiSourceBfsBatchSize - 1) /
+                       kMultiSourceBfsBatchSize;
+  if (num_batches != output_property_names.size()) {
+    return galois::ErrorCode::InvalidArgument;
+  }
+  if (auto result = ValidateSources(*pfg, sources); !result) {
+    return result.error();
+  }
+
+  using ReachabilityGraph =
+      galois::graphs::PropertyGraph<std::tuple<BfsReachability>, std::tuple<>>;
+
+  galois::StatTimer execTime("MultiSourceReachability");
+  execTime.start();
+
+  galois::LargeArray<uint64_t> seen;
+  seen.allocateBlocked(pfg->topology().num_nodes());
+
+  for (size_t b = 0; b < num_batches; ++b) {
+    const std::string& name = output_property_names[b];
+    if (auto result =
+            ConstructNodeProperties<std::tuple<BfsReachability>>(pfg, {name});
+        !result) {
+      return result.error();
+    }
+    auto pg_result = ReachabilityGraph::Make(pfg, {name}, {});
+    if (!pg_result) {
+      return pg_result.error();
+    }
+    ReachabilityGraph graph = std::move(pg_result.value());
+
+    size_t first = b * kMultiSourceBfsBatchSize;
+    size_t num_sources =
+        std::min(kMultiSourceBfsBatchSize, sources.size() - first);
+    MultiSourceBfsBatch(
+        pfg->topology(), &sources[first], num_sources, &seen,
+        [](uint32_t, uint32_t, uint64_t) {});
+
+    galois::do_all(
+        galois::iterate(graph.begin(), graph.end()),
+        [&](uint32_t n) { graph.GetData<BfsReachability>(n) = seen[n]; },
+        galois::no_stats());
+  }
+
+  execTime.stop();
+
+  return galois::ResultSuccess();
+}
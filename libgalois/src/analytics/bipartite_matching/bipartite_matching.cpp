@@ -0,0 +1,528 @@
+#include "galois/analytics/bipartite_matching/bipartite_matching.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/Reduction.h"
+#include "galois/substrate/PerThreadStorage.h"
+
+using namespace galois::analytics;
+
+namespace {
+
+using Graph = galois::graphs::PropertyGraph<
+    std::tuple<>, std::tuple<BipartiteMatchingEdgeFlag>>;
+using GNode = Graph::Node;
+
+constexpr GNode kNoNode = std::numeric_limits<GNode>::max();
+constexpr uint64_t kNoEdge = std::numeric_limits<uint64_t>::max();
+/// The level of a left node not reached by the search, or the label of a
+/// right node from which no unmatched right node is reachable
+constexpr uint32_t kUnreached = std::numeric_limits<uint32_t>::max();
+
+/// A matching of graph: the matched edge of each left node and the matched
+/// left node of each right node. The edge of a left node is only current
+/// while its right node still names it, so evicting a left node takes one
+/// write, to the right node.
+class Matching {
+public:
+  explicit Matching(const Graph& graph) : graph_(graph) {
+    mate_edge_.allocateBlocked(graph.num_nodes());
+    mate_.allocateBlocked(graph.num_nodes());
+    galois::do_all(
+        galois::iterate(graph),
+        [&](GNode node) {
+          mate_edge_[node] = kNoEdge;
+          mate_.constructAt(node, kNoNode);
+        },
+        galois::no_stats());
+  }
+
+  /// The left node matched to right, or kNoNode
+  GNode Mate(GNode right) const {
+    return mate_[right].load(std::memory_order_relaxed);
+  }
+
+  /// The edge matched to left, or kNoEdge
+  uint64_t MatchedEdge(GNode left) const {
+    uint64_t edge = mate_edge_[left];
+    if (edge == kNoEdge || Mate(Dest(edge)) != left) {
+      return kNoEdge;
+    }
+    return edge;
+  }
+
+  /// Match left along edge to right, which must be claimed by the caller
+  void Match(GNode left, uint64_t edge, GNode right) {
+    mate_edge_[left] = edge;
+    mate_[right].store(left, std::memory_order_relaxed);
+  }
+
+  /// Match left along edge to right if right is unmatched
+  bool TryMatchUnmatched(GNode left, uint64_t edge, GNode right) {
+    GNode expected = kNoNode;
+    if (Mate(right) != kNoNode ||
+        !mate_[right].compare_exchange_strong(
+            expected, left, std::memory_order_relaxed)) {
+      return false;
+    }
+    mate_edge_[left] = edge;
+    return true;
+  }
+
+  /// Match left along edge to right, evicting and returning the left node
+  /// right was matched to, or kNoNode
+  GNode Take(GNode left, uint64_t edge, GNode right) {
+    mate_edge_[left] = edge;
+    return mate_[right].exchange(left, std::memory_order_relaxed);
+  }
+
+  GNode Dest(uint64_t edge) const {
+    return *graph_.GetEdgeDest(Graph::edge_iterator(edge));
+  }
+
+private:
+  const Graph& graph_;
+  galois::LargeArray<uint64_t> mate_edge_;
+  galois::LargeArray<std::atomic<GNode>> mate_;
+};
+
+/// Match every left node that can be matched to an unmatched neighbor
+/// directly, in parallel
+void
+GreedyMatch(const Graph& graph, Matching* matching) {
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode left) {
+        for (auto e : graph.edges(left)) {
+          auto right = *graph.GetEdgeDest(e);
+          if (right != left && matching->TryMatchUnmatched(left, *e, right)) {
+            return;
+          }
+        }
+      },
+      galois::steal(), galois::loopname("BipartiteMatching-Greedy"));
+}
+
+/// Level the left nodes reached by alternating paths from roots, the
+/// unmatched left nodes at level 0, in parallel, up to the first level with
+/// an edge to an unmatched right node. Returns that level, or kUnreached if
+/// there is none and the matching is maximum.
+uint32_t
+LevelLeftNodes(
+    const Graph& graph, const Matching& matching,
+    const galois::InsertBag<GNode>& roots,
+    galois::LargeArray<std::atomic<uint32_t>>* levels) {
+  galois::InsertBag<GNode> bags[2];
+  const galois::InsertBag<GNode>* frontier = &roots;
+
+  for (uint32_t level = 0; !frontier->empty(); ++level) {
+    galois::InsertBag<GNode>* next = &bags[level % 2];
+    next->clear();
+    galois::GReduceLogicalOr found_unmatched;
+
+    galois::do_all(
+        galois::iterate(*frontier),
+        [&](GNode left) {
+          for (auto e : graph.edges(left)) {
+            auto right = *graph.GetEdgeDest(e);
+            if (right == left) {
+              continue;
+            }
+            GNode mate = matching.Mate(right);
+            if (mate == kNoNode) {
+              found_unmatched.update(true);
+              continue;
+            }
+            uint32_t unreached = kUnreached;
+            std::atomic<uint32_t>& mate_level = (*levels)[mate];
+            if (mate_level.load(std::memory_order_relaxed) == kUnreached &&
+                mate_level.compare_exchange_strong(
+                    unreached, level + 1, std::memory_order_relaxed)) {
+              next->push(mate);
+            }
+          }
+        },
+        galois::steal(), galois::loopname("HopcroftKarp-Level"));
+
+    if (found_unmatched.reduce()) {
+      return level;
+    }
+    frontier = next;
+  }
+
+  return kUnreached;
+}
+
+struct SearchFrame {
+  GNode left;
+  Graph::edge_iterator next_edge;
+};
+
+/// Depth-first search from root, an unmatched left node, along the levels
+/// up to last_level for an augmenting path, and augment along it. Each right
+/// node is claimed by the first search of the phase to visit it, so the
+/// searches of a phase augment along disjoint paths.
+bool
+AugmentFrom(
+    const Graph& graph, Matching* matching,
+    const galois::LargeArray<std::atomic<uint32_t>>& levels,
+    uint32_t last_level, galois::LargeArray<std::atomic<uint32_t>>* visited,
+    uint32_t phase, GNode root, std::vector<SearchFrame>* stack) {
+  stack->clear();
+  stack->push_back(SearchFrame{root, graph.edge_begin(root)});
+
+  while (!stack->empty()) {
+    SearchFrame& top = stack->back();
+    if (top.next_edge == graph.edge_end(top.left)) {
+      stack->pop_back();
+      continue;
+    }
+    auto e = top.next_edge++;
+    auto right = *graph.GetEdgeDest(e);
+    if (right == top.left) {
+      continue;
+    }
+    // Only claim right nodes on shortest paths, so the first search to claim
+    // a node can use it
+    uint32_t level = levels[top.left].load(std::memory_order_relaxed);
+    GNode mate = matching->Mate(right);
+    bool on_shortest_path =
+        mate == kNoNode
+            ? level == last_level
+            : level < last_level &&
+                  levels[mate].load(std::memory_order_relaxed) == level + 1;
+    if (!on_shortest_path ||
+        (*visited)[right].exchange(phase, std::memory_order_relaxed) ==
+            phase) {
+      continue;
+    }
+    if (mate != kNoNode) {
+      stack->push_back(SearchFrame{mate, graph.edge_begin(mate)});
+      continue;
+    }
+
+    for (const SearchFrame& frame : *stack) {
+      auto used = frame.next_edge;
+      --used;
+      matching->Match(frame.left, *used, *graph.GetEdgeDest(used));
+    }
+    return true;
+  }
+
+  return false;
+}
+
+void
+HopcroftKarpAlgo(const Graph& graph, Matching* matching) {
+  galois::LargeArray<std::atomic<uint32_t>> levels;
+  galois::LargeArray<std::atomic<uint32_t>> visited;
+  levels.allocateBlocked(graph.num_nodes());
+  visited.allocateBlocked(graph.num_nodes());
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode node) {
+        levels.constructAt(node, kUnreached);
+        visited.constructAt(node, 0);
+      },
+      galois::no_stats());
+
+  galois::substrate::PerThreadStorage<std::vector<SearchFrame>> stacks;
+
+  uint32_t phase = 1;
+  for (;; ++phase) {
+    galois::InsertBag<GNode> roots;
+    galois::do_all(
+        galois::iterate(graph),
+        [&](GNode left) {
+          if (matching->MatchedEdge(left) == kNoEdge) {
+            levels[left].store(0, std::memory_order_relaxed);
+            roots.push(left);
+          } else {
+            levels[left].store(kUnreached, std::memory_order_relaxed);
+          }
+        },
+        galois::no_stats());
+
+    uint32_t last_level = LevelLeftNodes(graph, *matching, roots, &levels);
+    if (last_level == kUnreached) {
+      break;
+    }
+
+    galois::do_all(
+        galois::iterate(roots),
+        [&](GNode root) {
+          AugmentFrom(
+              graph, matching, levels, last_level, &visited, phase, root,
+              stacks.getLocal());
+        },
+        galois::steal(), galois::loopname("HopcroftKarp-Augment"));
+  }
+
+  galois::ReportStatSingle(
+      "BipartiteMatching-HopcroftKarp", "phases", phase - 1);
+}
+
+/// Set the label of every right node to its distance along alternating
+/// paths to an unmatched right node, and collect the unmatched left nodes
+/// with a neighbor from which an unmatched right node is reachable. The
+/// search pulls: the matched right node of a left node is labeled at the
+/// first level at which one of the neighbors of the left node is.
+void
+GlobalRelabel(
+    const Graph& graph, const Matching& matching,
+    galois::LargeArray<std::atomic<uint32_t>>* labels,
+    galois::InsertBag<GNode>* active) {
+  galois::InsertBag<GNode> bags[2];
+  galois::InsertBag<GNode>* unlabeled = &bags[0];
+  galois::InsertBag<GNode>* still_unlabeled = &bags[1];
+
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode node) {
+        (*labels)[node].store(
+            matching.Mate(node) == kNoNode ? 0 : kUnreached,
+            std::memory_order_relaxed);
+        if (matching.MatchedEdge(node) != kNoEdge) {
+          unlabeled->push(node);
+        }
+      },
+      galois::no_stats());
+
+  for (uint32_t label = 0; !unlabeled->empty(); label += 2) {
+    galois::GAccumulator<size_t> num_labeled;
+    still_unlabeled->clear();
+    galois::do_all(
+        galois::iterate(*unlabeled),
+        [&](GNode left) {
+          for (auto e : graph.edges(left)) {
+            auto right = *graph.GetEdgeDest(e);
+            if (right != left &&
+                (*labels)[right].load(std::memory_order_relaxed) == label) {
+              GNode mate_right = matching.Dest(matching.MatchedEdge(left));
+              (*labels)[mate_right].store(
+                  label + 2, std::memory_order_relaxed);
+              num_labeled += 1;
+              return;
+            }
+          }
+          still_unlabeled->push(left);
+        },
+        galois::steal(), galois::loopname("PushRelabel-GlobalRelabel"));
+    if (num_labeled.reduce() == 0) {
+      break;
+    }
+    std::swap(unlabeled, still_unlabeled);
+  }
+
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode left) {
+        if (matching.MatchedEdge(left) != kNoEdge) {
+          return;
+        }
+        for (auto e : graph.edges(left)) {
+          auto right = *graph.GetEdgeDest(e);
+          if (right != left && (*labels)[right].load(
+                                   std::memory_order_relaxed) != kUnreached) {
+            active->push(left);
+            return;
+          }
+        }
+      },
+      galois::steal(), galois::no_stats());
+}
+
+/// Match left, which is unmatched, to its neighbor with the lowest label, if
+/// that label is below max_label, and raise the label of the neighbor to its
+/// distance through the next best neighbor of left. Labels of at least
+/// max_label, which no alternating path is as long as, mean unreachable:
+/// without the cap, left nodes that cannot all be matched would trade their
+/// right nodes back and forth, raising the labels by 2 each time. Returns
+/// the left node evicted by left, or kNoNode if left was matched to an
+/// unmatched right node or not at all.
+GNode
+Push(
+    const Graph& graph, Matching* matching,
+    galois::LargeArray<std::atomic<uint32_t>>* labels, uint32_t max_label,
+    GNode left, bool* augmented) {
+  uint32_t best = kUnreached;
+  uint32_t second_best = kUnreached;
+  Graph::edge_iterator best_edge{};
+  for (auto e : graph.edges(left)) {
+    auto right = *graph.GetEdgeDest(e);
+    if (right == left) {
+      continue;
+    }
+    uint32_t label = (*labels)[right].load(std::memory_order_relaxed);
+    if (label < best) {
+      second_best = best;
+      best = label;
+      best_edge = e;
+    } else if (label < second_best) {
+      second_best = label;
+    }
+  }
+  if (best >= max_label) {
+    return kNoNode;
+  }
+
+  auto right = *graph.GetEdgeDest(best_edge);
+  uint32_t raised =
+      second_best >= max_label - 2 ? kUnreached : second_best + 2;
+  std::atomic<uint32_t>& label = (*labels)[right];
+  uint32_t old_label = label.load(std::memory_order_relaxed);
+  while (old_label < raised && !label.compare_exchange_weak(
+                                   old_label, raised,
+                                   std::memory_order_relaxed)) {
+  }
+
+  GNode evicted = matching->Take(left, *best_edge, right);
+  *augmented = evicted == kNoNode;
+  return evicted;
+}
+
+void
+PushRelabelAlgo(const Graph& graph, Matching* matching) {
+  galois::LargeArray<std::atomic<uint32_t>> labels;
+  labels.allocateBlocked(graph.num_nodes());
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode node) { labels.constructAt(node, kUnreached); },
+      galois::no_stats());
+  auto max_label = static_cast<uint32_t>(
+      std::min<uint64_t>(2 * graph.num_nodes(), kUnreached));
+  // Local relabeling only raises labels by 2 per push, so the labels of
+  // right nodes that left nodes compete for lag far behind their distances
+  // without global relabelings
+  size_t relabel_period = std::max<size_t>(graph.num_nodes(), 1);
+
+  galois::InsertBag<GNode> bags[2];
+  galois::InsertBag<GNode>* active = &bags[0];
+  galois::InsertBag<GNode>* next = &bags[1];
+
+  size_t relabels = 0;
+  // Concurrent pushes to one right node may leave it with the raised label
+  // of the left node evicted from it, which overestimates its distance. If
+  // no push between two global relabelings augments for that reason, the
+  // pushes until the next one are serial and last in, first out: the
+  // evictions from the first unmatched left node then follow a shortest
+  // augmenting path, so they augment before the next global relabeling.
+  bool serial = false;
+  for (;; ++relabels) {
+    active->clear();
+    GlobalRelabel(graph, *matching, &labels, active);
+    if (active->empty()) {
+      break;
+    }
+
+    size_t num_pushes = 0;
+    size_t num_augmented = 0;
+    if (!serial) {
+      while (!active->empty() && num_pushes < relabel_period) {
+        next->clear();
+        galois::GAccumulator<size_t> round_pushes;
+        galois::GAccumulator<size_t> round_augmented;
+        galois::do_all(
+            galois::iterate(*active),
+            [&](GNode left) {
+              bool augmented = false;
+              GNode evicted =
+                  Push(graph, matching, &labels, max_label, left, &augmented);
+              round_pushes += 1;
+              if (evicted != kNoNode) {
+                next->push(evicted);
+              }
+              if (augmented) {
+                round_augmented += 1;
+              }
+            },
+            galois::steal(), galois::loopname("PushRelabel-Push"));
+        num_pushes += round_pushes.reduce();
+        num_augmented += round_augmented.reduce();
+        std::swap(active, next);
+      }
+    } else {
+      std::vector<GNode> worklist(active->begin(), active->end());
+      while (!worklist.empty() && num_pushes < relabel_period) {
+        GNode left = worklist.back();
+        worklist.pop_back();
+        bool augmented = false;
+        GNode evicted =
+            Push(graph, matching, &labels, max_label, left, &augmented);
+        ++num_pushes;
+        if (evicted != kNoNode) {
+          worklist.push_back(evicted);
+        }
+        if (augmented) {
+          ++num_augmented;
+        }
+      }
+    }
+    serial = num_augmented == 0;
+  }
+
+  galois::ReportStatSingle(
+      "BipartiteMatching-PushRelabel", "relabels", relabels);
+}
+
+}  // namespace
+
+galois::Result<void>
+galois::analytics::BipartiteMatching(
+    graphs::PropertyFileGraph* pfg, const std::string& output_property_name,
+    BipartiteMatchingPlan plan) {
+  if (auto result =
+          ConstructEdgeProperties<std::tuple<BipartiteMatchingEdgeFlag>>(
+              pfg, {output_property_name});
+      !result) {
+    return result.error();
+  }
+
+  auto pg_result = Graph::Make(pfg, {}, {output_property_name});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  Graph graph = pg_result.value();
+
+  galois::StatTimer execTime("BipartiteMatching");
+  execTime.start();
+  Matching matching(graph);
+  GreedyMatch(graph, &matching);
+  switch (plan.algorithm()) {
+  case BipartiteMatchingPlan::kHopcroftKarp:
+    HopcroftKarpAlgo(graph, &matching);
+    break;
+  case BipartiteMatchingPlan::kPushRelabel:
+    PushRelabelAlgo(graph, &matching);
+    break;
+  default:
+    return galois::ErrorCode::InvalidArgument;
+  }
+
+  galois::GAccumulator<size_t> num_matched;
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode left) {
+        uint64_t matched_edge = matching.MatchedEdge(left);
+        if (matched_edge != kNoEdge) {
+          num_matched += 1;
+        }
+        for (auto e : graph.edges(left)) {
+          graph.GetEdgeData<BipartiteMatchingEdgeFlag>(e) = *e == matched_edge;
+        }
+      },
+      galois::steal(), galois::loopname("BipartiteMatching-Output"));
+  execTime.stop();
+
+  galois::ReportStatSingle(
+      "BipartiteMatching", "matched", num_matched.reduce());
+
+  return galois::ResultSuccess();
+}
@@ -0,0 +1,683 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/analytics/connected_components/connected_components.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <random>
+#include <unordered_map>
+#include <utility>
+
+#include "galois/AtomicHelpers.h"
+#include "galois/Bag.h"
+#include "galois/ConcurrentUnionFind.h"
+#include "galois/EdgeTiles.h"
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/Reduction.h"
+
+using namespace galois::analytics;
+
+namespace {
+
+using Graph = galois::graphs::PropertyGraph<
+    std::tuple<ConnectedComponentsNodeComponent>, std::tuple<>>;
+using GNode = Graph::Node;
+
+using ComponentForest = galois::ConcurrentUnionFind<GNode>;
+
+/// Store the root of each node in graph; requires CompressAll
+void
+WriteComponents(Graph* graph, const ComponentForest& forest) {
+  galois::do_all(
+      galois::iterate(*graph),
+      [&](const GNode& n) {
+        graph->GetData<ConnectedComponentsNodeComponent>(n) = forest.parent(n);
+      },
+      galois::no_stats());
+}
+
+void
+Serial(Graph* graph, ComponentForest* forest) {
+  for (const GNode& src : *graph) {
+    for (const auto& ii : graph->edges(src)) {
+      auto dest = graph->GetEdgeDest(ii);
+      forest->Unite(src, *dest);
+    }
+  }
+
+  for (const GNode& src : *graph) {
+    forest->Find(src);
+  }
+}
+
+void
+LabelProp(Graph* graph) {
+  galois::LargeArray<std::atomic<GNode>> current;
+  galois::LargeArray<GNode> old;
+  current.allocateBlocked(graph->num_nodes());
+  old.allocateBlocked(graph->num_nodes());
+
+  galois::do_all(
+      galois::iterate(*graph),
+      [&](const GNode& node) {
+        current[node].store(node);
+        old[node] = std::numeric_limits<GNode>::max();
+      },
+      galois::no_stats());
+
+  galois::GReduceLogicalOr changed;
+  do {
+    changed.reset();
+    galois::do_all(
+        galois::iterate(*graph),
+        [&](const GNode& src) {
+          GNode label = current[src];
+          if (old[src] > label) {
+            old[src] = label;
+
+            changed.update(true);
+
+            for (auto e : graph->edges(src)) {
+              auto dest = graph->GetEdgeDest(e);
+              galois::atomicMin(current[*dest], label);
+            }
+          }
+        },
+        galois::disable_conflict_detection(), galois::steal(),
+        galois::loopname("LabelPropAlgo"));
+  } while (changed.reduce());
+
+  galois::do_all(
+      galois::iterate(*graph),
+      [&](const GNode& n) {
+        graph->GetData<ConnectedComponentsNodeComponent>(n) = current[n];
+      },
+      galois::no_stats());
+}
+
+/// Initially all nodes are in their own component. Then, we merge endpoints
+/// of edges to form the spanning tree. Merging is done in two phases to
+/// simplify concurrent updates: (1) find components and (2) union components.
+/// Since the merge phase does not do any finds, we only process a fraction of
+/// edges at a time; otherwise, the union phase may unnecessarily merge two
+/// endpoints in the same component.
+void
+Synchronous(Graph* graph, ComponentForest* forest) {
+  struct Edge {
+    GNode src;
+    GNode dest;
+    int count;
+    Edge(GNode src, GNode dest, int count)
+        : src(src), dest(dest), count(count) {}
+  };
+
+  size_t rounds = 0;
+  galois::GAccumulator<size_t> empty_merges;
+
+  galois::InsertBag<Edge> wls[2];
+  galois::InsertBag<Edge>* current_bag = &wls[0];
+  galois::InsertBag<Edge>* next_bag = &wls[1];
+
+  galois::do_all(galois::iterate(*graph), [&](const GNode& src) {
+    for (auto ii : graph->edges(src)) {
+      auto dest = graph->GetEdgeDest(ii);
+      if (src >= *dest)
+        continue;
+      current_bag->push(Edge(src, *dest, 0));
+      break;
+    }
+  });
+
+  while (!current_bag->empty()) {
+    galois::do_all(
+        galois::iterate(*current_bag),
+        [&](const Edge& edge) {
+          if (!forest->Unite(edge.src, edge.dest))
+            empty_merges += 1;
+        },
+        galois::loopname("Merge"));
+
+    galois::do_all(
+        galois::iterate(*current_bag),
+        [&](const Edge& edge) {
+          GNode src = edge.src;
+          GNode src_component = forest->Find(src);
+          Graph::edge_iterator ii = graph->edge_begin(src);
+          Graph::edge_iterator ei = graph->edge_end(src);
+          int count = edge.count + 1;
+          std::advance(ii, count);
+          for (; ii != ei; ++ii, ++count) {
+            auto dest = graph->GetEdgeDest(ii);
+            if (src >= *dest)
+              continue;
+            GNode dest_component = forest->Find(*dest);
+            if (src_component != dest_component) {
+              next_bag->push(Edge(src, dest_component, count));
+              break;
+            }
+          }
+        },
+        galois::loopname("Find"));
+
+    current_bag->clear();
+    std::swap(current_bag, next_bag);
+    rounds += 1;
+  }
+
+  forest->CompressAll("Compress");
+
+  galois::ReportStatSingle("CC-Sync", "rounds", rounds);
+  galois::ReportStatSingle("CC-Sync", "empty_merges", empty_merges.reduce());
+}
+
+/// Like Synchronous, but with unions and finds performed concurrently (\see
+/// galois::ConcurrentUnionFind)
+void
+Asynchronous(Graph* graph, ComponentForest* forest) {
+  galois::GAccumulator<size_t> empty_merges;
+
+  galois::do_all(
+      galois::iterate(*graph),
+      [&](const GNode& src) {
+        for (const auto& ii : graph->edges(src)) {
+          auto dest = graph->GetEdgeDest(ii);
+          if (src >= *dest)
+            continue;
+
+          if (!forest->Unite(src, *dest))
+            empty_merges += 1;
+        }
+      },
+      galois::loopname("CC-Async"));
+
+  forest->CompressAll("CC-Async-Compress");
+
+  galois::ReportStatSingle("CC-Async", "empty_merges", empty_merges.reduce());
+}
+
+void
+EdgeAsynchronous(Graph* graph, ComponentForest* forest) {
+  using Edge = std::pair<GNode, Graph::edge_iterator>;
+
+  galois::GAccumulator<size_t> empty_merges;
+
+  galois::InsertBag<Edge> works;
+
+  galois::do_all(
+      galois::iterate(*graph),
+      [&](const GNode& src) {
+        for (const auto& ii : graph->edges(src)) {
+          if (src < *(graph->GetEdgeDest(ii))) {
+            works.push_back(std::make_pair(src, ii));
+          }
+        }
+      },
+      galois::loopname("CC-EdgeAsyncInit"), galois::steal());
+
+  galois::do_all(
+      galois::iterate(works),
+      [&](Edge& e) {
+        auto dest = graph->GetEdgeDest(e.second);
+        if (!forest->Unite(e.first, *dest)) {
+          empty_merges += 1;
+        }
+      },
+      galois::loopname("CC-EdgeAsync"), galois::steal());
+
+  forest->CompressAll("CC-Async-Compress");
+
+  galois::ReportStatSingle("CC-Async", "empty_merges", empty_merges.reduce());
+}
+
+void
+EdgeTiledAsynchronous(
+    Graph* graph, ComponentForest* forest, ptrdiff_t edge_tile_size) {
+  uint64_t empty_merges =
+      forest->UniteEdges(*graph, edge_tile_size, true, "CC-edgetiledAsync");
+
+  forest->CompressAll("CC-Async-Compress");
+
+  galois::ReportStatSingle("CC-edgeTiledAsync", "empty_merges", empty_merges);
+}
+
+struct BlockedWorkItem {
+  GNode src;
+  Graph::edge_iterator start;
+};
+
+/// Add the next edge between components to the worklist
+template <bool MakeContinuation, int Limit, typename Pusher>
+void
+ProcessBlocked(
+    Graph* graph, ComponentForest* forest, const GNode& src,
+    const Graph::edge_iterator& start, Pusher& pusher) {
+  int count = 1;
+  for (Graph::edge_iterator ii = start, ei = graph->edge_end(src); ii != ei;
+       ++ii, ++count) {
+    auto dest = graph->GetEdgeDest(ii);
+    if (src >= *dest)
+      continue;
+
+    if (forest->Unite(src, *dest)) {
+      if (Limit == 0 || count != Limit)
+        continue;
+    }
+
+    if (MakeContinuation || (Limit != 0 && count == Limit)) {
+      BlockedWorkItem item = {src, ii + 1};
+      pusher.push(item);
+      break;
+    }
+  }
+}
+
+/// Improve performance of Asynchronous by following machine topology.
+void
+BlockedAsynchronous(Graph* graph, ComponentForest* forest) {
+  galois::InsertBag<BlockedWorkItem> items;
+
+  galois::do_all(
+      galois::iterate(*graph),
+      [&](const GNode& src) {
+        auto start = graph->edge_begin(src);
+        if (galois::substrate::ThreadPool::getSocket() == 0) {
+          ProcessBlocked<true, 0>(graph, forest, src, start, items);
+        } else {
+          ProcessBlocked<true, 1>(graph, forest, src, start, items);
+        }
+      },
+      galois::loopname("Initialize"));
+
+  galois::for_each(
+      galois::iterate(items),
+      [&](const BlockedWorkItem& item, auto& ctx) {
+        ProcessBlocked<true, 0>(graph, forest, item.src, item.start, ctx);
+      },
+      galois::loopname("Merge"),
+      galois::wl<galois::worklists::PerSocketChunkFIFO<128>>());
+
+  forest->CompressAll("CC-Async-Compress");
+}
+
+/// What ApproxLargestComponent returns when it has nothing to skip; no node
+/// is in it
+constexpr GNode kNoComponent = std::numeric_limits<GNode>::max();
+
+/// Estimate the largest intermediate component from the components of
+/// sample_frequency random nodes; returns kNoComponent if sample_frequency is
+/// 0, in which case no component is skipped
+GNode
+ApproxLargestComponent(
+    const Graph& graph, const ComponentForest& forest,
+    uint32_t sample_frequency) {
+  std::unordered_map<GNode, int> comp_freq(sample_frequency);
+  std::random_device rd;
+  std::mt19937 rng(rd());
+  std::uniform_int_distribution<uint32_t> dist(0, graph.size() - 1);
+  for (uint32_t i = 0; i < sample_frequency; i++) {
+    comp_freq[forest.parent(dist(rng))]++;
+  }
+
+  if (comp_freq.empty()) {
+    return kNoComponent;
+  }
+  auto most_frequent = std::max_element(
+      comp_freq.begin(), comp_freq.end(),
+      [](const auto& a, const auto& b) { return a.second < b.second; });
+
+  galois::gDebug(
+      "Approximate largest intermediate component: ", most_frequent->first,
+      " (hit rate ",
+      100.0 * (most_frequent->second) / sample_frequency, "%)");
+
+  return most_frequent->first;
+}
+
+/// Union-find with Afforest sampling.
+///
+/// [1] M. Sutton, T. Ben-Nun and A. Barak, "Optimizing Parallel Graph
+/// Connectivity Computation via Subgraph Sampling," 2018 IEEE International
+/// Parallel and Distributed Processing Symposium (IPDPS), Vancouver, BC, 2018,
+/// pp. 12-21.
+void
+Afforest(
+    Graph* graph, ComponentForest* forest,
+    const ConnectedComponentsPlan& plan) {
+  // (bozhi) should NOT go through single direction in sampling step: nodes
+  // with edges less than neighbor_sample_size will fail
+  for (uint32_t r = 0; r < plan.neighbor_sample_size(); ++r) {
+    galois::do_all(
+        galois::iterate(*graph),
+        [&](const GNode& src) {
+          Graph::edge_iterator ii = graph->edge_begin(src);
+          Graph::edge_iterator ei = graph->edge_end(src);
+          std::advance(ii, r);
+          if (ii < ei) {
+            auto dest = graph->GetEdgeDest(ii);
+            forest->Unite(src, *dest);
+          }
+        },
+        galois::steal(), galois::loopname("Afforest-VNS-Link"));
+
+    forest->CompressAll("Afforest-VNS-Compress");
+  }
+
+  galois::StatTimer StatTimer_Sampling("Afforest-LCS-Sampling");
+  StatTimer_Sampling.start();
+  GNode c = ApproxLargestComponent(
+      *graph, *forest, plan.component_sample_frequency());
+  StatTimer_Sampling.stop();
+
+  galois::do_all(
+      galois::iterate(*graph),
+      [&](const GNode& src) {
+        if (forest->parent(src) == c)
+          return;
+        Graph::edge_iterator ii = graph->edge_begin(src);
+        Graph::edge_iterator ei = graph->edge_end(src);
+        for (std::advance(ii, plan.neighbor_sample_size()); ii < ei; ++ii) {
+          auto dest = graph->GetEdgeDest(ii);
+          forest->Unite(src, *dest);
+        }
+      },
+      galois::steal(), galois::loopname("Afforest-LCS-Link"));
+
+  forest->CompressAll("Afforest-LCS-Compress");
+}
+
+/// Like Afforest, but each remaining edge is a work item; when a root is
+/// hooked under the largest component, the edges of that root are revisited
+void
+EdgeAfforest(
+    Graph* graph, ComponentForest* forest,
+    const ConnectedComponentsPlan& plan) {
+  using Edge = std::pair<GNode, GNode>;
+
+  for (uint32_t r = 0; r < plan.neighbor_sample_size(); ++r) {
+    galois::do_all(
+        galois::iterate(*graph),
+        [&](const GNode& src) {
+          Graph::edge_iterator ii = graph->edge_begin(src);
+          Graph::edge_iterator ei = graph->edge_end(src);
+          std::advance(ii, r);
+          if (ii < ei) {
+            auto dest = graph->GetEdgeDest(ii);
+            forest->Unite(src, *dest);
+          }
+        },
+        galois::steal(), galois::loopname("EdgeAfforest-VNS-Link"));
+  }
+  forest->CompressAll("EdgeAfforest-VNS-Compress");
+
+  galois::StatTimer StatTimer_Sampling("EdgeAfforest-LCS-Sampling");
+  StatTimer_Sampling.start();
+  GNode c = ApproxLargestComponent(
+      *graph, *forest, plan.component_sample_frequency());
+  StatTimer_Sampling.stop();
+
+  galois::InsertBag<Edge> works;
+
+  galois::do_all(
+      galois::iterate(*graph),
+      [&](const GNode& src) {
+        if (forest->parent(src) == c)
+          return;
+        auto beg = graph->edge_begin(src);
+        const auto end = graph->edge_end(src);
+
+        for (std::advance(beg, plan.neighbor_sample_size()); beg < end;
+             beg++) {
+          auto dest = graph->GetEdgeDest(beg);
+          if (src < *dest || c == forest->parent(*dest)) {
+            works.push_back(std::make_pair(src, *dest));
+          }
+        }
+      },
+      galois::loopname("EdgeAfforest-LCS-Assembling"), galois::steal());
+
+  galois::for_each(
+      galois::iterate(works),
+      [&](const Edge& e, auto& ctx) {
+        if (forest->parent(e.first) == c)
+          return;
+        GNode victim;
+        GNode onto;
+        if (forest->Unite(e.first, e.second, &victim, &onto) && onto == c) {
+          GNode src = victim;
+          for (auto ii : graph->edges(src)) {
+            auto dest = graph->GetEdgeDest(ii);
+            ctx.push_back(std::make_pair(*dest, src));
+          }
+        }
+      },
+      galois::disable_conflict_detection(),
+      galois::loopname("EdgeAfforest-LCS-Link"));
+
+  forest->CompressAll("EdgeAfforest-LCS-Compress");
+}
+
+void
+EdgeTiledAfforest(
+    Graph* graph, ComponentForest* forest,
+    const ConnectedComponentsPlan& plan) {
+  // (bozhi) should NOT go through single direction in sampling step: nodes
+  // with edges less than neighbor_sample_size will fail
+  galois::do_all(
+      galois::iterate(*graph),
+      [&](const GNode& src) {
+        auto ii = graph->edge_begin(src);
+        const auto end = graph->edge_end(src);
+        for (uint32_t r = 0; r < plan.neighbor_sample_size() && ii < end;
+             ++r, ++ii) {
+          auto dest = graph->GetEdgeDest(ii);
+          forest->Unite(src, *dest);
+        }
+      },
+      galois::steal(), galois::loopname("EdgetiledAfforest-VNS-Link"));
+
+  forest->CompressAll("EdgetiledAfforest-VNS-Compress");
+
+  galois::StatTimer StatTimer_Sampling("EdgetiledAfforest-LCS-Sampling");
+  StatTimer_Sampling.start();
+  GNode c = ApproxLargestComponent(
+      *graph, *forest, plan.component_sample_frequency());
+  StatTimer_Sampling.stop();
+
+  // the edges left after sampling of the nodes outside of c; empty for the
+  // nodes in it
+  auto remaining_edges = [&](const GNode& src) {
+    auto beg = graph->edge_begin(src);
+    auto end = graph->edge_end(src);
+    if (forest->parent(src) == c) {
+      return std::make_pair(end, end);
+    }
+    std::advance(
+        beg, std::min<ptrdiff_t>(plan.neighbor_sample_size(), end - beg));
+    return std::make_pair(beg, end);
+  };
+  galois::DoAllEdgeTiles(
+      *graph, remaining_edges,
+      galois::AdaptiveEdgeTileSize(graph->num_edges(), plan.edge_tile_size()),
+      [&](const GNode& src, Graph::edge_iterator beg,
+          Graph::edge_iterator end) {
+        if (forest->parent(src) == c)
+          return;
+        for (auto ii = beg; ii < end; ++ii) {
+          auto dest = graph->GetEdgeDest(ii);
+          forest->Unite(src, *dest);
+        }
+      },
+      "EdgetiledAfforest-LCS-Link");
+
+  forest->CompressAll("EdgetiledAfforest-LCS-Compress");
+}
+
+}  // namespace
+
+galois::Result<void>
+galois::analytics::ConnectedComponents(
+    graphs::PropertyGraph<
+        std::tuple<ConnectedComponentsNodeComponent>, std::tuple<>>& pg,
+    ConnectedComponentsPlan plan) {
+  if (plan.algorithm() == ConnectedComponentsPlan::kAutomatic) {
+    plan = ConnectedComponentsPlan::Afforest();
+  }
+  if (plan.edge_tile_size() <= 0) {
+    return galois::ErrorCode::InvalidArgument;
+  }
+  if (pg.num_nodes() == 0) {
+    return galois::ResultSuccess();
+  }
+
+  galois::StatTimer execTime("ConnectedComponents");
+
+  if (plan.algorithm() == ConnectedComponentsPlan::kLabelProp) {
+    execTime.start();
+    LabelProp(&pg);
+    execTime.stop();
+    return galois::ResultSuccess();
+  }
+
+  ComponentForest forest(pg.num_nodes());
+
+  execTime.start();
+  switch (plan.algorithm()) {
+  case ConnectedComponentsPlan::kSerial:
+    Serial(&pg, &forest);
+    break;
+  case ConnectedComponentsPlan::kSynchronous:
+    Synchronous(&pg, &forest);
+    break;
+  case ConnectedComponentsPlan::kAsynchronous:
+    Asynchronous(&pg, &forest);
+    break;
+  case ConnectedComponentsPlan::kEdgeAsynchronous:
+    EdgeAsynchronous(&pg, &forest);
+    break;
+  case ConnectedComponentsPlan::kEdgeTiledAsynchronous:
+    EdgeTiledAsynchronous(&pg, &forest, plan.edge_tile_size());
+    break;
+  case ConnectedComponentsPlan::kBlockedAsynchronous:
+    BlockedAsynchronous(&pg, &forest);
+    break;
+  case ConnectedComponentsPlan::kAfforest:
+    Afforest(&pg, &forest, plan);
+    break;
+  case ConnectedComponentsPlan::kEdgeAfforest:
+    EdgeAfforest(&pg, &forest, plan);
+    break;
+  case ConnectedComponentsPlan::kEdgeTiledAfforest:
+    EdgeTiledAfforest(&pg, &forest, plan);
+    break;
+  default:
+    return galois::ErrorCode::InvalidArgument;
+  }
+  execTime.stop();
+
+  WriteComponents(&pg, forest);
+
+  return galois::ResultSuccess();
+}
+
+galois::Result<void>
+galois::analytics::ConnectedComponents(
+    graphs::PropertyFileGraph* pfg, const std::string& output_property_name,
+    ConnectedComponentsPlan plan) {
+  if (!plan.filter().empty()) {
+    return internal::RunFiltered(
+        pfg, plan.filter(), {}, output_property_name,
+        [&](graphs::PropertyFileGraph* filtered) {
+          return ConnectedComponents(
+              filtered, output_property_name, plan.WithFilter({}));
+        });
+  }
+
+  if (plan.algorithm() == ConnectedComponentsPlan::kAutomatic) {
+    plan = ConnectedComponentsPlan::Automatic(pfg);
+  }
+
+  if (auto result =
+          ConstructNodeProperties<std::tuple<ConnectedComponentsNodeComponent>>(
+              pfg, {output_property_name});
+      !result) {
+    return result.error();
+  }
+
+  auto pg_result = Graph::Make(pfg, {output_property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+
+  return ConnectedComponents(pg_result.value(), plan);
+}
+
+namespace {
+
+/// The component property viewed as the parent array of a union-find forest
+struct ComponentParent {
+  using ArrowType = arrow::CTypeTraits<uint64_t>::ArrowType;
+  using ViewType = galois::DensePODPropertyView<std::atomic<uint64_t>>;
+};
+
+using ForestGraph = galois::graphs::PropertyGraph<
+    std::tuple<ComponentParent>, std::tuple<>>;
+
+}  // namespace
+
+galois::Result<void>
+galois::analytics::ConnectedComponentsIncremental(
+    graphs::PropertyFileGraph* pfg, const std::string& component_property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& new_edges,
+    bool compress) {
+  if (auto result = pfg->EnsureNodePropertiesLoaded({component_property_name});
+      !result) {
+    return result.error();
+  }
+
+  auto pg_result = ForestGraph::Make(pfg, {component_property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  ForestGraph graph = pg_result.value();
+
+  for (const auto& [src, dest] : new_edges) {
+    if (src >= graph.num_nodes() || dest >= graph.num_nodes()) {
+      return galois::ErrorCode::InvalidArgument;
+    }
+  }
+
+  galois::StatTimer execTime("ConnectedComponentsIncremental");
+  execTime.start();
+
+  // the components are a forest whose roots are their smallest nodes, the
+  // order ConcurrentUnionFind keeps
+  galois::ConcurrentUnionFind<uint64_t> forest(
+      &graph.GetData<ComponentParent>(0), graph.num_nodes());
+  forest.UniteAll(new_edges, "CC-Incremental-Link");
+  if (compress) {
+    forest.CompressAll("CC-Incremental-Compress");
+  }
+
+  execTime.stop();
+
+  return pfg->MarkNodePropertyModified(component_property_name);
+}
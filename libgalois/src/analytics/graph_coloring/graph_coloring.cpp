@@ -0,0 +1,59 @@
+#include "galois/analytics/graph_coloring/graph_coloring.h"
+
+#include <atomic>
+
+#include "galois/Galois.h"
+#include "galois/analytics/graph_coloring/graph_coloring_internal.h"
+
+using namespace galois::analytics;
+
+namespace {
+
+/// The color output viewed atomically, as neighbors read the colors of the
+/// nodes colored before them
+struct NodeColor {
+  using ArrowType = arrow::CTypeTraits<uint32_t>::ArrowType;
+  using ViewType = galois::DensePODPropertyView<std::atomic<uint32_t>>;
+};
+
+using Graph =
+    galois::graphs::PropertyGraph<std::tuple<NodeColor>, std::tuple<>>;
+using GNode = Graph::Node;
+
+}  // namespace
+
+galois::Result<void>
+galois::analytics::GraphColoring(
+    graphs::PropertyFileGraph* pfg, const std::string& output_property_name,
+    GraphColoringPlan plan) {
+  if (auto result = ConstructNodeProperties<std::tuple<GraphColoringNodeColor>>(
+          pfg, {output_property_name});
+      !result) {
+    return result.error();
+  }
+
+  auto pg_result = Graph::Make(pfg, {output_property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  Graph graph = pg_result.value();
+
+  galois::StatTimer execTime("GraphColoring");
+  execTime.start();
+  switch (plan.algorithm()) {
+  case GraphColoringPlan::kJonesPlassmann: {
+    uint32_t num_colors = JonesPlassmannColoring(
+        graph, plan.edge_tile_size(),
+        [&](GNode node) -> std::atomic<uint32_t>& {
+          return graph.GetData<NodeColor>(node);
+        });
+    galois::ReportStatSingle("GraphColoring", "colors", num_colors);
+    break;
+  }
+  default:
+    return galois::ErrorCode::InvalidArgument;
+  }
+  execTime.stop();
+
+  return galois::ResultSuccess();
+}
@@ -0,0 +1,92 @@
+#include "galois/analytics/independent_set/independent_set.h"
+
+#include "galois/Galois.h"
+#include "galois/Reduction.h"
+#include "galois/analytics/independent_set/independent_set_internal.h"
+
+using namespace galois::analytics;
+
+namespace {
+
+using Graph = galois::graphs::PropertyGraph<
+    std::tuple<IndependentSetNodeFlag>, std::tuple<>>;
+using GNode = Graph::Node;
+
+/// Put node in the set and leave its undecided neighbors out
+void
+Take(const Graph& graph, PackedNodeStates* states, GNode node) {
+  if (!states->Decide(node, PackedNodeStates::kIn)) {
+    return;
+  }
+  for (auto e : graph.edges(node)) {
+    auto dest = *graph.GetEdgeDest(e);
+    if (dest != node) {
+      states->Decide(dest, PackedNodeStates::kOut);
+    }
+  }
+}
+
+void
+SerialAlgo(const Graph& graph, PackedNodeStates* states) {
+  for (GNode node : graph) {
+    if (PackedNodeStates::IsUndecided(states->Get(node))) {
+      Take(graph, states, node);
+    }
+  }
+}
+
+void
+PriorityAlgo(
+    const Graph& graph, PackedNodeStates* states, ptrdiff_t edge_tile_size) {
+  size_t rounds = PriorityRounds(
+      graph, states, edge_tile_size,
+      [&](GNode node) { Take(graph, states, node); }, "IndependentSet");
+
+  galois::ReportStatSingle("IndependentSet-Priority", "rounds", rounds);
+}
+
+}  // namespace
+
+galois::Result<void>
+galois::analytics::IndependentSet(
+    graphs::PropertyFileGraph* pfg, const std::string& output_property_name,
+    IndependentSetPlan plan) {
+  if (auto result =
+          ConstructNodeProperties<std::tuple<IndependentSetNodeFlag>>(
+              pfg, {output_property_name});
+      !result) {
+    return result.error();
+  }
+
+  auto pg_result = Graph::Make(pfg, {output_property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  Graph graph = pg_result.value();
+
+  PackedNodeStates states(graph.num_nodes());
+
+  galois::StatTimer execTime("IndependentSet");
+  execTime.start();
+  switch (plan.algorithm()) {
+  case IndependentSetPlan::kSerial:
+    SerialAlgo(graph, &states);
+    break;
+  case IndependentSetPlan::kPriority:
+    PriorityAlgo(graph, &states, plan.edge_tile_size());
+    break;
+  default:
+    return galois::ErrorCode::InvalidArgument;
+  }
+  execTime.stop();
+
+  galois::do_all(
+      galois::iterate(graph),
+      [&](const GNode& node) {
+        graph.GetData<IndependentSetNodeFlag>(node) =
+            states.Get(node) == PackedNodeStates::kIn;
+      },
+      galois::loopname("IndependentSet-Output"), galois::no_stats());
+
+  return galois::ResultSuccess();
+}
@@ -0,0 +1,297 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2019, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/analytics/jaccard/jaccard.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "galois/DynamicBitset.h"
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/ParallelSTL.h"
+#include "galois/substrate/PerThreadStorage.h"
+
+using namespace galois::analytics;
+
+namespace {
+
+using Graph =
+    galois::graphs::PropertyGraph<std::tuple<JaccardSimilarity>, std::tuple<>>;
+using GNode = Graph::Node;
+
+using TopologyGraph =
+    galois::graphs::PropertyGraph<std::tuple<>, std::tuple<>>;
+
+uint64_t
+Degree(const TopologyGraph& graph, GNode n) {
+  return *graph.edge_end(n) - *graph.edge_begin(n);
+}
+
+double
+Similarity(
+    uint64_t intersection_size, uint64_t a_size, uint64_t b_size,
+    SimilarityMeasure measure) {
+  double intersection = intersection_size;
+  switch (measure) {
+  case kCosineSimilarity:
+    return intersection / std::sqrt(static_cast<double>(a_size) * b_size);
+  case kOverlapSimilarity:
+    return intersection / std::min(a_size, b_size);
+  case kJaccardSimilarity:
+  default:
+    return intersection / (a_size + b_size - intersection_size);
+  }
+}
+
+void
+JaccardSorted(Graph* graph, GNode base) {
+  uint64_t base_size = *graph->edge_end(base) - *graph->edge_begin(base);
+
+  galois::do_all(
+      galois::iterate(*graph),
+      [&](const GNode& n2) {
+        uint64_t n2_size = *graph->edge_end(n2) - *graph->edge_begin(n2);
+        uint64_t intersection_size = graph->CountCommonNeighbors(base, n2);
+        uint64_t union_size = base_size + n2_size - intersection_size;
+        graph->GetData<JaccardSimilarity>(n2) =
+            union_size > 0
+                ? static_cast<double>(intersection_size) / union_size
+                : 1;
+      },
+      galois::steal(), galois::loopname("Jaccard-Sorted"));
+}
+
+void
+JaccardUnsorted(Graph* graph, GNode base) {
+  galois::DynamicBitset base_neighbors;
+  base_neighbors.resize(graph->num_nodes());
+  uint64_t base_size = 0;
+
+  // Collect all the neighbors of the base node into a bitset.
+  for (const auto& e : graph->edges(base)) {
+    base_neighbors.set(*graph->GetEdgeDest(e));
+    ++base_size;
+  }
+
+  galois::do_all(
+      galois::iterate(*graph),
+      [&](const GNode& n2) {
+        uint64_t n2_size = 0;
+        uint64_t intersection_size = 0;
+        for (const auto& e : graph->edges(n2)) {
+          intersection_size += base_neighbors.test(*graph->GetEdgeDest(e));
+          ++n2_size;
+        }
+        uint64_t union_size = base_size + n2_size - intersection_size;
+        graph->GetData<JaccardSimilarity>(n2) =
+            union_size > 0
+                ? static_cast<double>(intersection_size) / union_size
+                : 1;
+      },
+      galois::steal(), galois::loopname("Jaccard-Unsorted"));
+}
+
+}  // namespace
+
+galois::Result<void>
+galois::analytics::Jaccard(
+    graphs::PropertyFileGraph* pfg, uint32_t compare_node,
+    const std::string& output_property_name, JaccardPlan plan) {
+  if (compare_node >= pfg->topology().num_nodes()) {
+    return galois::ErrorCode::InvalidArgument;
+  }
+
+  bool sorted = pfg->topology().edges_sorted_by_dest;
+  JaccardPlan::EdgeSorting edge_sorting = plan.edge_sorting();
+  if (edge_sorting == JaccardPlan::kUnknown) {
+    edge_sorting = sorted ? JaccardPlan::kSorted : JaccardPlan::kUnsorted;
+  }
+  if (edge_sorting == JaccardPlan::kSorted && !sorted) {
+    GALOIS_LOG_DEBUG("sorted Jaccard requires edges sorted by destination");
+    return galois::ErrorCode::InvalidArgument;
+  }
+
+  if (auto result = ConstructNodeProperties<std::tuple<JaccardSimilarity>>(
+          pfg, {output_property_name});
+      !result) {
+    return result.error();
+  }
+
+  auto pg_result = Graph::Make(pfg, {output_property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  Graph graph = pg_result.value();
+
+  galois::StatTimer execTime("Jaccard");
+  execTime.start();
+  if (edge_sorting == JaccardPlan::kSorted) {
+    JaccardSorted(&graph, compare_node);
+  } else {
+    JaccardUnsorted(&graph, compare_node);
+  }
+  execTime.stop();
+
+  return galois::ResultSuccess();
+}
+
+namespace {
+
+struct Candidate {
+  double similarity;
+  GNode node;
+};
+
+/// Orders candidates from most to least similar, ties broken by node id;
+/// as the comparison of a heap, it keeps the least similar at the front
+bool
+MoreSimilar(const Candidate& a, const Candidate& b) {
+  return a.similarity > b.similarity ||
+         (a.similarity == b.similarity && a.node < b.node);
+}
+
+/// Reused by a thread across the queries it runs
+struct QueryScratch {
+  /// The ends of the paths of length two from the query, sorted so that each
+  /// node appears once per neighbor it shares with the query
+  std::vector<GNode> two_hop;
+  /// The best candidates so far, at most k
+  std::vector<Candidate> heap;
+};
+
+void
+FindTopK(
+    const TopologyGraph& graph, GNode query, uint32_t k,
+    SimilarityMeasure measure, QueryScratch* scratch, Candidate* out,
+    uint64_t* num_out) {
+  *num_out = 0;
+  if (k == 0) {
+    return;
+  }
+  const uint32_t* dests =
+      graph.GetPropertyFileGraph().topology().out_dests->raw_values();
+
+  std::vector<GNode>& two_hop = scratch->two_hop;
+  two_hop.clear();
+  for (auto e : graph.edges(query)) {
+    GNode middle = dests[*e];
+    for (auto f : graph.edges(middle)) {
+      GNode end = dests[*f];
+      if (end != query) {
+        two_hop.push_back(end);
+      }
+    }
+  }
+  std::sort(two_hop.begin(), two_hop.end());
+
+  std::vector<Candidate>& heap = scratch->heap;
+  heap.clear();
+  uint64_t query_size = Degree(graph, query);
+  for (auto it = two_hop.begin(); it != two_hop.end();) {
+    GNode node = *it;
+    auto run_end = std::find_if(
+        it, two_hop.end(), [node](GNode other) { return other != node; });
+    Candidate candidate{
+        Similarity(run_end - it, query_size, Degree(graph, node), measure),
+        node};
+    it = run_end;
+
+    if (heap.size() < k) {
+      heap.push_back(candidate);
+      std::push_heap(heap.begin(), heap.end(), MoreSimilar);
+    } else if (MoreSimilar(candidate, heap.front())) {
+      std::pop_heap(heap.begin(), heap.end(), MoreSimilar);
+      heap.back() = candidate;
+      std::push_heap(heap.begin(), heap.end(), MoreSimilar);
+    }
+  }
+
+  std::sort_heap(heap.begin(), heap.end(), MoreSimilar);
+  std::copy(heap.begin(), heap.end(), out);
+  *num_out = heap.size();
+}
+
+}  // namespace
+
+galois::Result<TopKSimilarity>
+galois::analytics::TopKSimilarNodes(
+    graphs::PropertyFileGraph* pfg, const std::vector<uint32_t>& query_nodes,
+    uint32_t k, SimilarityMeasure measure) {
+  auto pg_result = TopologyGraph::Make(pfg, {}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  const TopologyGraph& graph = pg_result.value();
+  uint64_t num_nodes = graph.num_nodes();
+
+  for (uint32_t query : query_nodes) {
+    if (query >= num_nodes) {
+      return galois::ErrorCode::InvalidArgument;
+    }
+  }
+  // No query has more than num_nodes - 1 results
+  k = std::min<uint64_t>(k, num_nodes == 0 ? 0 : num_nodes - 1);
+
+  uint64_t num_queries = query_nodes.size();
+  TopKSimilarity result;
+  result.offsets.resize(num_queries + 1);
+  result.offsets[0] = 0;
+
+  galois::StatTimer execTime("TopKSimilarNodes");
+  execTime.start();
+
+  // Each query writes its results to its own k slots, then they are compacted
+  galois::LargeArray<Candidate> slots;
+  slots.allocateBlocked(num_queries * k);
+  galois::substrate::PerThreadStorage<QueryScratch> scratch;
+
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_queries),
+      [&](uint64_t i) {
+        FindTopK(
+            graph, query_nodes[i], k, measure, scratch.getLocal(),
+            slots.data() + i * k, &result.offsets[i + 1]);
+      },
+      galois::steal(), galois::loopname("TopKSimilarNodes"));
+
+  galois::ParallelSTL::partial_sum(
+      result.offsets.begin(), result.offsets.end(), result.offsets.begin());
+
+  uint64_t num_results = result.offsets[num_queries];
+  result.nodes.resize(num_results);
+  result.similarities.resize(num_results);
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_queries),
+      [&](uint64_t i) {
+        const Candidate* first = slots.data() + i * k;
+        for (uint64_t j = result.offsets[i]; j < result.offsets[i + 1]; ++j) {
+          result.nodes[j] = first->node;
+          result.similarities[j] = first->similarity;
+          ++first;
+        }
+      },
+      galois::no_stats());
+
+  execTime.stop();
+
+  galois::ReportStatSingle("TopKSimilarNodes", "Results", num_results);
+
+  return result;
+}
@@ -0,0 +1,269 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/analytics/k_core/k_core.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+#include "galois/Bag.h"
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/Reduction.h"
+
+using namespace galois::analytics;
+
+namespace {
+
+/// The coreness output viewed atomically; kAlive until a node is removed
+struct NodeCoreness {
+  using ArrowType = arrow::CTypeTraits<uint32_t>::ArrowType;
+  using ViewType = galois::DensePODPropertyView<std::atomic<uint32_t>>;
+};
+
+using Graph =
+    galois::graphs::PropertyGraph<std::tuple<NodeCoreness>, std::tuple<>>;
+using GNode = Graph::Node;
+
+constexpr uint32_t kAlive = std::numeric_limits<uint32_t>::max();
+
+constexpr unsigned kChunkSize = 64U;
+
+/// Remaining degrees; signed so that decrements past zero on inputs that are
+/// not symmetric cannot wrap around
+using Degrees = galois::LargeArray<std::atomic<int64_t>>;
+
+void
+InitializeDegrees(Graph* graph, Degrees* degrees) {
+  degrees->allocateBlocked(graph->num_nodes());
+  galois::do_all(
+      galois::iterate(*graph),
+      [&](const GNode& node) {
+        degrees->constructAt(
+            node,
+            std::distance(graph->edge_begin(node), graph->edge_end(node)));
+        graph->GetData<NodeCoreness>(node).store(
+            kAlive, std::memory_order_relaxed);
+      },
+      galois::loopname("KCore-DegreeCounting"), galois::no_stats());
+}
+
+bool
+IsAlive(Graph* graph, GNode node) {
+  return graph->GetData<NodeCoreness>(node).load(std::memory_order_relaxed) ==
+         kAlive;
+}
+
+/**
+ * Each level k first drops the removed nodes from the remaining ones and
+ * raises k to their smallest degree. The nodes with degree at most k then
+ * form the first frontier; removing a frontier decrements the degree of its
+ * neighbors, and the neighbors it takes from k + 1 to k form the next one.
+ *
+ * @param graph Graph to operate on
+ * @param degrees Remaining degree of each node
+ */
+void
+SynchronousAlgo(Graph* graph, Degrees* degrees) {
+  galois::InsertBag<GNode> bags[4];
+  galois::InsertBag<GNode>* remaining = &bags[0];
+  galois::InsertBag<GNode>* survivors = &bags[1];
+  galois::InsertBag<GNode>* current = &bags[2];
+  galois::InsertBag<GNode>* next = &bags[3];
+
+  galois::do_all(
+      galois::iterate(*graph),
+      [&](const GNode& node) { remaining->push(node); }, galois::no_stats());
+
+  int64_t k = -1;
+  size_t levels = 0;
+  while (!remaining->empty()) {
+    galois::GReduceMin<int64_t> min_degree;
+    survivors->clear();
+    galois::do_all(
+        galois::iterate(*remaining),
+        [&](const GNode& node) {
+          if (IsAlive(graph, node)) {
+            survivors->push(node);
+            min_degree.update(
+                (*degrees)[node].load(std::memory_order_relaxed));
+          }
+        },
+        galois::steal(), galois::loopname("KCore-Sync-Remaining"));
+    std::swap(remaining, survivors);
+    if (remaining->empty()) {
+      break;
+    }
+
+    // k starts at -1, so levels are never negative
+    k = std::max(k + 1, min_degree.reduce());
+    uint32_t level = k;
+    ++levels;
+
+    next->clear();
+    galois::do_all(
+        galois::iterate(*remaining),
+        [&](const GNode& node) {
+          if ((*degrees)[node].load(std::memory_order_relaxed) <= k) {
+            next->push(node);
+          }
+        },
+        galois::steal(), galois::loopname("KCore-Sync-Frontier"));
+
+    while (!next->empty()) {
+      std::swap(current, next);
+      next->clear();
+
+      galois::do_all(
+          galois::iterate(*current),
+          [&](const GNode& dead_node) {
+            graph->GetData<NodeCoreness>(dead_node).store(
+                level, std::memory_order_relaxed);
+            //! Decrement degree of all neighbors.
+            for (auto e : graph->edges(dead_node)) {
+              auto dest = *graph->GetEdgeDest(e);
+              if (!IsAlive(graph, dest)) {
+                continue;
+              }
+              int64_t old_degree = (*degrees)[dest].fetch_sub(1);
+              if (old_degree == k + 1) {
+                //! This thread was responsible for putting degree of
+                //! destination at k; add to worklist.
+                next->push(dest);
+              }
+            }
+          },
+          galois::steal(), galois::chunk_size<kChunkSize>(),
+          galois::loopname("KCore-Sync-Cascade"));
+    }
+  }
+
+  galois::ReportStatSingle("KCore-Sync", "levels", levels);
+}
+
+/// A node waiting in the bucket of level
+struct PeelItem {
+  GNode node;
+  uint32_t level;
+};
+
+struct PeelItemIndexer {
+  uint32_t operator()(const PeelItem& item) const { return item.level; }
+};
+
+/**
+ * Peeling with buckets: every node starts in the bucket of its degree, and a
+ * node whose degree drops while it is above the current level k moves to the
+ * bucket of its new degree, or of k if that is lower. The barrier between
+ * priority levels of the worklist makes level k finish, including the nodes
+ * it moves into bucket k, before level k + 1 starts. An item is never in a
+ * bucket below the degree of its node, so the first item of a node to be
+ * processed removes it at the level at which peeling reaches it; the later
+ * ones are stale.
+ *
+ * @param graph Graph to operate on
+ * @param degrees Remaining degree of each node
+ */
+void
+BucketedAlgo(Graph* graph, Degrees* degrees) {
+  using PSchunk = galois::worklists::PerSocketChunkFIFO<kChunkSize>;
+  using OBIM = typename galois::worklists::OrderedByIntegerMetric<
+      PeelItemIndexer, PSchunk>::template with_barrier<true>::type;
+
+  galois::InsertBag<PeelItem> initial;
+  galois::do_all(
+      galois::iterate(*graph),
+      [&](const GNode& node) {
+        initial.push(PeelItem{
+            node, static_cast<uint32_t>(
+                      (*degrees)[node].load(std::memory_order_relaxed))});
+      },
+      galois::no_stats());
+
+  galois::GAccumulator<size_t> stale_items;
+
+  galois::for_each(
+      galois::iterate(initial),
+      [&](const PeelItem& item, auto& ctx) {
+        uint32_t k = item.level;
+        uint32_t alive = kAlive;
+        // Several neighbors may have moved the node into bucket k
+        if (!graph->GetData<NodeCoreness>(item.node).compare_exchange_strong(
+                alive, k, std::memory_order_relaxed)) {
+          stale_items += 1;
+          return;
+        }
+        for (auto e : graph->edges(item.node)) {
+          auto dest = *graph->GetEdgeDest(e);
+          if (!IsAlive(graph, dest)) {
+            continue;
+          }
+          int64_t old_degree = (*degrees)[dest].fetch_sub(1);
+          if (old_degree > k) {
+            ctx.push(PeelItem{
+                dest, static_cast<uint32_t>(std::max<int64_t>(
+                          old_degree - 1, k))});
+          }
+        }
+      },
+      galois::wl<OBIM>(), galois::disable_conflict_detection(),
+      galois::loopname("KCore-Bucketed"));
+
+  galois::ReportStatSingle(
+      "KCore-Bucketed", "stale_items", stale_items.reduce());
+}
+
+}  // namespace
+
+galois::Result<void>
+galois::analytics::KCore(
+    graphs::PropertyFileGraph* pfg, const std::string& output_property_name,
+    KCorePlan plan) {
+  if (auto result = ConstructNodeProperties<std::tuple<KCoreNodeCoreness>>(
+          pfg, {output_property_name});
+      !result) {
+    return result.error();
+  }
+
+  auto pg_result = Graph::Make(pfg, {output_property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  Graph graph = pg_result.value();
+
+  Degrees degrees;
+  InitializeDegrees(&graph, &degrees);
+
+  galois::StatTimer execTime("KCore");
+  execTime.start();
+  switch (plan.algorithm()) {
+  case KCorePlan::kSynchronous:
+    SynchronousAlgo(&graph, &degrees);
+    break;
+  case KCorePlan::kBucketed:
+    BucketedAlgo(&graph, &degrees);
+    break;
+  default:
+    return galois::ErrorCode::InvalidArgument;
+  }
+  execTime.stop();
+
+  return galois::ResultSuccess();
+}
@@ -0,0 +1,395 @@
+#include "galois/analytics/k_truss/k_truss.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <utility>
+
+#include "galois/Bag.h"
+#include "galois/EdgeTiles.h"
+#include "galois/Galois.h"
+#include "galois/Intersection.h"
+#include "galois/LargeArray.h"
+#include "galois/ParallelSTL.h"
+#include "galois/Reduction.h"
+
+using namespace galois::analytics;
+
+namespace {
+
+using Graph = galois::graphs::PropertyGraph<
+    std::tuple<>, std::tuple<KTrussEdgeTrussness>>;
+using GNode = Graph::Node;
+
+constexpr uint32_t kAlive = std::numeric_limits<uint32_t>::max();
+
+constexpr unsigned kChunkSize = 64U;
+
+/// Support counting intersects the neighbors of both endpoints of every edge,
+/// so the edges of a hub are split into tiles of at most this many edges
+constexpr ptrdiff_t kEdgeTileSize = 512;
+
+/// The undirected edges of a graph in both directions, without self loops or
+/// multi-edges. The neighbors of node n are dests[begin[n], end[n]), strictly
+/// increasing. Per-edge state is indexed by the position of an edge in dests,
+/// and an undirected edge {u, v} with u < v keeps its state at the position
+/// of v among the neighbors of u, its canonical position.
+struct SymmetricGraph {
+  galois::LargeArray<uint64_t> begin;
+  galois::LargeArray<uint64_t> end;
+  galois::LargeArray<uint32_t> dests;
+  //! the canonical position of the undirected edge at each position
+  galois::LargeArray<uint64_t> canonical;
+
+  const uint32_t* neighbors(GNode n) const { return dests.data() + begin[n]; }
+  size_t degree(GNode n) const { return end[n] - begin[n]; }
+};
+
+void
+BuildSymmetricGraph(const Graph& graph, SymmetricGraph* sym) {
+  uint64_t num_nodes = graph.num_nodes();
+
+  // Every edge lands in the lists of both of its endpoints, so both
+  // directions of a symmetric edge land there twice; the duplicates are
+  // dropped after sorting
+  galois::LargeArray<std::atomic<uint64_t>> cursor;
+  cursor.allocateBlocked(num_nodes);
+  galois::do_all(
+      galois::iterate(graph), [&](GNode n) { cursor.constructAt(n, 0); },
+      galois::no_stats());
+
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) {
+        for (auto e : graph.edges(n)) {
+          GNode dest = *graph.GetEdgeDest(e);
+          if (dest == n) {
+            continue;
+          }
+          cursor[n].fetch_add(1, std::memory_order_relaxed);
+          cursor[dest].fetch_add(1, std::memory_order_relaxed);
+        }
+      },
+      galois::steal(), galois::loopname("KTruss-Symmetric-Degrees"));
+
+  sym->begin.allocateBlocked(num_nodes + 1);
+  sym->end.allocateBlocked(num_nodes);
+  sym->begin[0] = 0;
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) {
+        sym->begin[n + 1] = cursor[n].load(std::memory_order_relaxed);
+      },
+      galois::no_stats());
+  galois::ParallelSTL::partial_sum(
+      sym->begin.begin(), sym->begin.end(), sym->begin.begin());
+
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) {
+        cursor[n].store(sym->begin[n], std::memory_order_relaxed);
+      },
+      galois::no_stats());
+
+  uint64_t num_positions = sym->begin[num_nodes];
+  sym->dests.allocateBlocked(num_positions);
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) {
+        for (auto e : graph.edges(n)) {
+          GNode dest = *graph.GetEdgeDest(e);
+          if (dest == n) {
+            continue;
+          }
+          sym->dests[cursor[n].fetch_add(1, std::memory_order_relaxed)] = dest;
+          sym->dests[cursor[dest].fetch_add(1, std::memory_order_relaxed)] = n;
+        }
+      },
+      galois::steal(), galois::loopname("KTruss-Symmetric-Fill"));
+
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) {
+        uint32_t* first = sym->dests.data() + sym->begin[n];
+        uint32_t* last = sym->dests.data() + sym->begin[n + 1];
+        std::sort(first, last);
+        sym->end[n] = std::unique(first, last) - sym->dests.data();
+      },
+      galois::steal(), galois::loopname("KTruss-Symmetric-Sort"));
+
+  sym->canonical.allocateBlocked(num_positions);
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode u) {
+        for (uint64_t p = sym->begin[u]; p < sym->end[u]; ++p) {
+          GNode v = sym->dests[p];
+          if (u < v) {
+            sym->canonical[p] = p;
+            continue;
+          }
+          const uint32_t* v_neighbors = sym->neighbors(v);
+          sym->canonical[p] =
+              std::lower_bound(v_neighbors, v_neighbors + sym->degree(v), u) -
+              sym->dests.data();
+        }
+      },
+      galois::steal(), galois::loopname("KTruss-Symmetric-Canonical"));
+}
+
+/// Remaining supports, by canonical position
+using Supports = galois::LargeArray<std::atomic<uint32_t>>;
+
+/// Count the triangles of every undirected edge of sym into supports
+void
+CountSupports(
+    const Graph& graph, const SymmetricGraph& sym, Supports* supports) {
+  uint64_t num_positions = sym.dests.size();
+  supports->allocateBlocked(num_positions);
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_positions),
+      [&](uint64_t p) { supports->constructAt(p, 0); }, galois::no_stats());
+
+  galois::DoAllEdgeTiles(
+      graph,
+      [&](GNode n) {
+        const uint32_t* neighbors = sym.neighbors(n);
+        return std::make_pair(neighbors, neighbors + sym.degree(n));
+      },
+      galois::AdaptiveEdgeTileSize(num_positions, kEdgeTileSize),
+      [&](GNode u, const uint32_t* beg, const uint32_t* end) {
+        for (const uint32_t* p = beg; p != end; ++p) {
+          GNode v = *p;
+          if (v < u) {
+            continue;
+          }
+          (*supports)[p - sym.dests.data()].store(
+              galois::CountSortedIntersection(
+                  sym.neighbors(u), sym.degree(u), sym.neighbors(v),
+                  sym.degree(v)),
+              std::memory_order_relaxed);
+        }
+      },
+      "KTruss-Support");
+}
+
+/// An undirected edge {src, dest} with src < dest, at canonical position pos
+struct TrussEdge {
+  GNode src;
+  uint64_t pos;
+};
+
+/**
+ * Edges of support at most level k wait in a bucket, the frontier, and are
+ * removed in bulk-synchronous rounds. Removing the frontier lowers the support
+ * of the other two edges of each of its triangles that were not removed
+ * before, and the edges it takes from k + 1 to k form the next frontier. If
+ * two edges of a triangle are removed in the same round, only the one at the
+ * smaller position lowers the third edge, and if all three are, none are
+ * lowered. Once the frontier runs out, the next level starts at the smallest
+ * remaining support.
+ *
+ * @param sym Graph to operate on
+ * @param supports Support of each edge, lowered as edges are removed
+ * @param trussness Output: trussness of each edge, by canonical position
+ */
+void
+BucketedAlgo(
+    const SymmetricGraph& sym, Supports* supports,
+    galois::LargeArray<uint32_t>* trussness) {
+  uint64_t num_nodes = sym.end.size();
+  uint64_t num_positions = sym.dests.size();
+
+  galois::LargeArray<uint8_t> in_frontier;
+  in_frontier.allocateBlocked(num_positions);
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_positions),
+      [&](uint64_t p) { in_frontier.constructAt(p, 0); }, galois::no_stats());
+
+  galois::InsertBag<TrussEdge> bags[4];
+  galois::InsertBag<TrussEdge>* remaining = &bags[0];
+  galois::InsertBag<TrussEdge>* survivors = &bags[1];
+  galois::InsertBag<TrussEdge>* current = &bags[2];
+  galois::InsertBag<TrussEdge>* next = &bags[3];
+
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t u) {
+        for (uint64_t p = sym.begin[u]; p < sym.end[u]; ++p) {
+          if (u < sym.dests[p]) {
+            (*trussness)[p] = kAlive;
+            remaining->push(TrussEdge{static_cast<GNode>(u), p});
+          }
+        }
+      },
+      galois::steal(), galois::no_stats());
+
+  auto support = [&](uint64_t pos) {
+    return (*supports)[pos].load(std::memory_order_relaxed);
+  };
+
+  int64_t k = -1;
+  size_t levels = 0;
+  size_t rounds = 0;
+  while (!remaining->empty()) {
+    galois::GReduceMin<uint32_t> min_support;
+    survivors->clear();
+    galois::do_all(
+        galois::iterate(*remaining),
+        [&](const TrussEdge& edge) {
+          if ((*trussness)[edge.pos] == kAlive) {
+            survivors->push(edge);
+            min_support.update(support(edge.pos));
+          }
+        },
+        galois::steal(), galois::loopname("KTruss-Bucketed-Remaining"));
+    std::swap(remaining, survivors);
+    if (remaining->empty()) {
+      break;
+    }
+
+    // k starts at -1, so levels are never negative
+    k = std::max<int64_t>(k + 1, min_support.reduce());
+    uint32_t level = k;
+    ++levels;
+
+    next->clear();
+    galois::do_all(
+        galois::iterate(*remaining),
+        [&](const TrussEdge& edge) {
+          if (support(edge.pos) <= level) {
+            next->push(edge);
+          }
+        },
+        galois::steal(), galois::loopname("KTruss-Bucketed-Frontier"));
+
+    // Lowers the support of edge unless it is already in a frontier; only
+    // the thread that takes it from level + 1 to level adds it to next
+    auto lower = [&](const TrussEdge& edge) {
+      std::atomic<uint32_t>& s = (*supports)[edge.pos];
+      if (s.load(std::memory_order_relaxed) <= level) {
+        return;
+      }
+      uint32_t old_support = s.fetch_sub(1, std::memory_order_relaxed);
+      if (old_support == level + 1) {
+        next->push(edge);
+      } else if (old_support <= level) {
+        s.fetch_add(1, std::memory_order_relaxed);
+      }
+    };
+
+    while (!next->empty()) {
+      std::swap(current, next);
+      next->clear();
+      ++rounds;
+
+      galois::do_all(
+          galois::iterate(*current),
+          [&](const TrussEdge& edge) { in_frontier[edge.pos] = 1; },
+          galois::no_stats());
+
+      galois::do_all(
+          galois::iterate(*current),
+          [&](const TrussEdge& edge) {
+            GNode u = edge.src;
+            GNode v = sym.dests[edge.pos];
+            galois::ForEachSortedIntersection(
+                sym.neighbors(u), sym.degree(u), sym.neighbors(v),
+                sym.degree(v), [&](size_t i, size_t j) {
+                  GNode w = sym.neighbors(u)[i];
+                  TrussEdge uw{std::min(u, w), sym.canonical[sym.begin[u] + i]};
+                  TrussEdge vw{std::min(v, w), sym.canonical[sym.begin[v] + j]};
+                  if ((*trussness)[uw.pos] != kAlive ||
+                      (*trussness)[vw.pos] != kAlive) {
+                    return;
+                  }
+                  bool uw_removed = in_frontier[uw.pos];
+                  bool vw_removed = in_frontier[vw.pos];
+                  if (!uw_removed && !vw_removed) {
+                    lower(uw);
+                    lower(vw);
+                  } else if (uw_removed && !vw_removed) {
+                    if (edge.pos < uw.pos) {
+                      lower(vw);
+                    }
+                  } else if (!uw_removed && vw_removed) {
+                    if (edge.pos < vw.pos) {
+                      lower(uw);
+                    }
+                  }
+                });
+          },
+          galois::steal(), galois::chunk_size<kChunkSize>(),
+          galois::loopname("KTruss-Bucketed-Peel"));
+
+      galois::do_all(
+          galois::iterate(*current),
+          [&](const TrussEdge& edge) {
+            (*trussness)[edge.pos] = level + 2;
+            in_frontier[edge.pos] = 0;
+          },
+          galois::no_stats());
+    }
+  }
+
+  galois::ReportStatSingle("KTruss-Bucketed", "levels", levels);
+  galois::ReportStatSingle("KTruss-Bucketed", "rounds", rounds);
+}
+
+}  // namespace
+
+galois::Result<void>
+galois::analytics::KTruss(
+    graphs::PropertyFileGraph* pfg, const std::string& output_property_name,
+    KTrussPlan plan) {
+  if (auto result = ConstructEdgeProperties<std::tuple<KTrussEdgeTrussness>>(
+          pfg, {output_property_name});
+      !result) {
+    return result.error();
+  }
+
+  auto pg_result = Graph::Make(pfg, {}, {output_property_name});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  Graph graph = pg_result.value();
+
+  galois::StatTimer execTime("KTruss");
+  execTime.start();
+
+  SymmetricGraph sym;
+  BuildSymmetricGraph(graph, &sym);
+
+  Supports supports;
+  CountSupports(graph, sym, &supports);
+
+  galois::LargeArray<uint32_t> trussness;
+  trussness.allocateBlocked(sym.dests.size());
+  switch (plan.algorithm()) {
+  case KTrussPlan::kBucketed:
+    BucketedAlgo(sym, &supports, &trussness);
+    break;
+  default:
+    return galois::ErrorCode::InvalidArgument;
+  }
+
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) {
+        const uint32_t* neighbors = sym.neighbors(n);
+        const uint32_t* neighbors_end = neighbors + sym.degree(n);
+        for (auto e : graph.edges(n)) {
+          GNode dest = *graph.GetEdgeDest(e);
+          uint32_t value = 0;
+          if (dest != n) {
+            uint64_t pos = std::lower_bound(neighbors, neighbors_end, dest) -
+                           sym.dests.data();
+            value = trussness[sym.canonical[pos]];
+          }
+          graph.GetEdgeData<KTrussEdgeTrussness>(e) = value;
+        }
+      },
+      galois::steal(), galois::loopname("KTruss-Output"));
+  execTime.stop();
+
+  return galois::ResultSuccess();
+}
@@ -0,0 +1,313 @@
+#include "galois/analytics/minimum_spanning_forest/minimum_spanning_forest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <utility>
+
+#include "galois/ConcurrentUnionFind.h"
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/ParallelSTL.h"
+
+using namespace galois::analytics;
+
+namespace {
+
+template <typename Weight>
+using EdgeWeight = galois::PODProperty<Weight>;
+
+template <typename Weight>
+using Graph = galois::graphs::PropertyGraph<
+    std::tuple<>,
+    std::tuple<EdgeWeight<Weight>, MinimumSpanningForestEdgeFlag>>;
+
+using Flags = galois::PropertyViewType<MinimumSpanningForestEdgeFlag>;
+
+using Forest = galois::ConcurrentUnionFind<uint32_t>;
+
+/// Filter-Kruskal sorts ranges of at most this many edges instead of
+/// partitioning them further
+constexpr size_t kKruskalBaseSize = 1 << 14;
+
+/// An edge that may join two trees, with its weight inline so that comparing
+/// edges does not touch the graph
+template <typename Weight>
+struct Candidate {
+  Weight weight;
+  uint64_t edge;
+  uint32_t src;
+  uint32_t dest;
+
+  /// The order of the edges: by weight and then by edge index, so no two
+  /// edges are equal
+  bool operator<(const Candidate& other) const {
+    return weight < other.weight ||
+           (weight == other.weight && edge < other.edge);
+  }
+};
+
+/// Copy every edge of graph, including self loops, into candidates, at its
+/// edge index, and clear its output flag
+template <typename Weight>
+void
+CollectCandidates(
+    Graph<Weight>* graph, galois::LargeArray<Candidate<Weight>>* candidates) {
+  candidates->allocateBlocked(graph->num_edges());
+  galois::do_all(
+      galois::iterate(*graph),
+      [&](uint32_t src) {
+        for (auto e : graph->edges(src)) {
+          (*candidates)[*e] = Candidate<Weight>{
+              graph->template GetEdgeData<EdgeWeight<Weight>>(e), *e, src,
+              *graph->GetEdgeDest(e)};
+          graph->template GetEdgeData<MinimumSpanningForestEdgeFlag>(e) = 0;
+        }
+      },
+      galois::steal(), galois::loopname("MinimumSpanningForest-Collect"));
+}
+
+/**
+ * Each round, every tree, named by the root of its nodes in forest, keeps
+ * the index of its lightest candidate in lightest, and the trees are joined
+ * along their picks. Unique edge weights make the picks a forest of the
+ * trees, but for the pick of both trees of one edge, so exactly one Unite
+ * per distinct pick succeeds. The candidates within a tree are dropped after
+ * each round.
+ *
+ * @param graph Graph to operate on
+ * @param candidates All edges of graph; overwritten
+ * @param flags Output flags of the edges of graph
+ */
+template <typename Weight>
+void
+BoruvkaAlgo(
+    const Graph<Weight>& graph,
+    galois::LargeArray<Candidate<Weight>>* candidates, Flags* flags) {
+  constexpr uint64_t kNoCandidate = std::numeric_limits<uint64_t>::max();
+
+  Forest forest(graph.num_nodes());
+  galois::LargeArray<std::atomic<uint64_t>> lightest;
+  lightest.allocateBlocked(graph.num_nodes());
+  galois::do_all(
+      galois::iterate(graph),
+      [&](uint32_t node) { lightest.constructAt(node, kNoCandidate); },
+      galois::no_stats());
+
+  galois::LargeArray<Candidate<Weight>> spare;
+  spare.allocateBlocked(candidates->size());
+  Candidate<Weight>* current = candidates->data();
+  Candidate<Weight>* next = spare.data();
+
+  auto crosses = [&](const Candidate<Weight>& c) {
+    return forest.parent(c.src) != forest.parent(c.dest);
+  };
+
+  size_t num_candidates =
+      galois::ParallelSTL::copy_if(
+          current, current + candidates->size(), next, crosses) -
+      next;
+  std::swap(current, next);
+
+  size_t rounds = 0;
+  while (num_candidates > 0) {
+    ++rounds;
+
+    galois::do_all(
+        galois::iterate(size_t{0}, num_candidates),
+        [&](size_t i) {
+          const Candidate<Weight>& c = current[i];
+          for (uint32_t tree : {forest.parent(c.src), forest.parent(c.dest)}) {
+            std::atomic<uint64_t>& pick = lightest[tree];
+            uint64_t old_pick = pick.load(std::memory_order_relaxed);
+            while ((old_pick == kNoCandidate || c < current[old_pick]) &&
+                   !pick.compare_exchange_weak(
+                       old_pick, i, std::memory_order_relaxed)) {
+            }
+          }
+        },
+        galois::steal(), galois::loopname("MinimumSpanningForest-Pick"));
+
+    galois::do_all(
+        galois::iterate(graph),
+        [&](uint32_t tree) {
+          uint64_t pick = lightest[tree].load(std::memory_order_relaxed);
+          if (pick == kNoCandidate) {
+            return;
+          }
+          lightest[tree].store(kNoCandidate, std::memory_order_relaxed);
+          const Candidate<Weight>& c = current[pick];
+          if (forest.Unite(c.src, c.dest)) {
+            flags->GetValue(c.edge) = 1;
+          }
+        },
+        galois::steal(), galois::loopname("MinimumSpanningForest-Join"));
+
+    forest.CompressAll("MinimumSpanningForest-Compress");
+
+    num_candidates =
+        galois::ParallelSTL::copy_if(
+            current, current + num_candidates, next, crosses) -
+        next;
+    std::swap(current, next);
+  }
+
+  galois::ReportStatSingle("MinimumSpanningForest-Boruvka", "rounds", rounds);
+}
+
+/// Kruskal's algorithm on [first, last): sort the edges and add each one
+/// that joins two trees of forest
+template <typename Weight>
+void
+KruskalBase(
+    Candidate<Weight>* first, Candidate<Weight>* last, Forest* forest,
+    Flags* flags) {
+  galois::ParallelSTL::sort(first, last, std::less<Candidate<Weight>>());
+  for (Candidate<Weight>* c = first; c != last; ++c) {
+    if (forest->Unite(c->src, c->dest)) {
+      flags->GetValue(c->edge) = 1;
+    }
+  }
+}
+
+/**
+ * Filter-Kruskal on [first, last), which are heavier than the edges already
+ * processed: ranges longer than kKruskalBaseSize are partitioned around the
+ * median of three of their edges, the light part first recursively and the
+ * heavy part then filtered and processed in the same loop, so the recursion
+ * only goes as deep as the light parts nest.
+ */
+template <typename Weight>
+void
+FilterKruskalRange(
+    Candidate<Weight>* first, Candidate<Weight>* last, Forest* forest,
+    Flags* flags) {
+  auto crosses = [&](const Candidate<Weight>& c) {
+    return forest->Find(c.src) != forest->Find(c.dest);
+  };
+
+  while (static_cast<size_t>(last - first) > kKruskalBaseSize) {
+    size_t size = last - first;
+    Candidate<Weight> a = first[size / 4];
+    Candidate<Weight> b = first[size / 2];
+    Candidate<Weight> c = first[size / 4 * 3];
+    // The largest of the three is heavier than the pivot, so neither part is
+    // empty
+    Candidate<Weight> pivot =
+        std::max(std::min(a, b), std::min(std::max(a, b), c));
+
+    Candidate<Weight>* middle = galois::ParallelSTL::partition(
+        first, last,
+        [&](const Candidate<Weight>& e) { return !(pivot < e); });
+    FilterKruskalRange(first, middle, forest, flags);
+
+    last = galois::ParallelSTL::partition(middle, last, crosses);
+    first = middle;
+  }
+
+  KruskalBase(first, last, forest, flags);
+}
+
+/**
+ * @param graph Graph to operate on
+ * @param candidates All edges of graph; overwritten
+ * @param flags Output flags of the edges of graph
+ */
+template <typename Weight>
+void
+FilterKruskalAlgo(
+    const Graph<Weight>& graph,
+    galois::LargeArray<Candidate<Weight>>* candidates, Flags* flags) {
+  Forest forest(graph.num_nodes());
+  Candidate<Weight>* first = candidates->data();
+  // Drop the self loops
+  Candidate<Weight>* last = galois::ParallelSTL::partition(
+      first, first + candidates->size(),
+      [](const Candidate<Weight>& c) { return c.src != c.dest; });
+
+  FilterKruskalRange(first, last, &forest, flags);
+}
+
+template <typename Weight>
+galois::Result<void>
+MinimumSpanningForestWithWrap(
+    galois::graphs::PropertyFileGraph* pfg,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name, MinimumSpanningForestPlan plan) {
+  if (auto result =
+          ConstructEdgeProperties<std::tuple<MinimumSpanningForestEdgeFlag>>(
+              pfg, {output_property_name});
+      !result) {
+    return result.error();
+  }
+
+  auto pg_result = Graph<Weight>::Make(
+      pfg, {}, {edge_weight_property_name, output_property_name});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  Graph<Weight> graph = pg_result.value();
+  Flags* flags =
+      &graph.template GetEdgePropertyView<MinimumSpanningForestEdgeFlag>();
+
+  galois::StatTimer execTime("MinimumSpanningForest");
+  execTime.start();
+  galois::LargeArray<Candidate<Weight>> candidates;
+  CollectCandidates(&graph, &candidates);
+  switch (plan.algorithm()) {
+  case MinimumSpanningForestPlan::kBoruvka:
+    BoruvkaAlgo(graph, &candidates, flags);
+    break;
+  case MinimumSpanningForestPlan::kFilterKruskal:
+    FilterKruskalAlgo(graph, &candidates, flags);
+    break;
+  default:
+    return galois::ErrorCode::InvalidArgument;
+  }
+  execTime.stop();
+
+  return galois::ResultSuccess();
+}
+
+}  // namespace
+
+galois::Result<void>
+galois::analytics::MinimumSpanningForest(
+    graphs::PropertyFileGraph* pfg,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name, MinimumSpanningForestPlan plan) {
+  if (auto res = pfg->EnsureEdgePropertiesLoaded({edge_weight_property_name});
+      !res) {
+    return res.error();
+  }
+  std::shared_ptr<arrow::ChunkedArray> weights =
+      pfg->EdgeProperty(edge_weight_property_name);
+  if (!weights) {
+    return galois::ErrorCode::PropertyNotFound;
+  }
+
+  switch (weights->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return MinimumSpanningForestWithWrap<uint32_t>(
+        pfg, edge_weight_property_name, output_property_name, plan);
+  case arrow::Int32Type::type_id:
+    return MinimumSpanningForestWithWrap<int32_t>(
+        pfg, edge_weight_property_name, output_property_name, plan);
+  case arrow::UInt64Type::type_id:
+    return MinimumSpanningForestWithWrap<uint64_t>(
+        pfg, edge_weight_property_name, output_property_name, plan);
+  case arrow::Int64Type::type_id:
+    return MinimumSpanningForestWithWrap<int64_t>(
+        pfg, edge_weight_property_name, output_property_name, plan);
+  case arrow::FloatType::type_id:
+    return MinimumSpanningForestWithWrap<float>(
+        pfg, edge_weight_property_name, output_property_name, plan);
+  case arrow::DoubleType::type_id:
+    return MinimumSpanningForestWithWrap<double>(
+        pfg, edge_weight_property_name, output_property_name, plan);
+  default:
+    return galois::ErrorCode::TypeError;
+  }
+}
@@ -0,0 +1,681 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/analytics/pagerank/pagerank.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "galois/AtomicHelpers.h"
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/Mem.h"
+#include "galois/ParallelSTL.h"
+#include "galois/Reduction.h"
+#include "galois/substrate/PerThreadStorage.h"
+
+using namespace galois::analytics;
+
+namespace {
+
+using Graph =
+    galois::graphs::PropertyGraph<std::tuple<PagerankNodeValue>, std::tuple<>>;
+using GNode = Graph::Node;
+using PRTy = float;
+
+constexpr static unsigned kChunkSize = 32U;
+constexpr static unsigned kPushChunkSize = 16U;
+/// Out-edges of high degree nodes are pushed in tiles of this many edges
+constexpr static ptrdiff_t kEdgeTileSize = 128;
+
+uint64_t
+OutDegree(const Graph& graph, GNode n) {
+  return graph.edge_end(n) - graph.edge_begin(n);
+}
+
+void
+ReportRounds(const char* loopname, uint32_t rounds, bool converged) {
+  galois::ReportStatSingle(loopname, "Rounds", rounds);
+  if (!converged) {
+    GALOIS_LOG_WARN("failed to converge in {} iterations", rounds);
+  }
+}
+
+/// Jacobi iteration over the in-edges: each round every node recomputes its
+/// rank from the contributions (rank / out-degree) of its in-neighbors in the
+/// previous round.
+void
+PullTopological(
+    Graph* graph, const galois::graphs::InEdgeTopology& in_edges,
+    const PagerankPlan& plan) {
+  const uint32_t* in_sources = in_edges.in_sources->raw_values();
+  const PRTy base_score = 1 - plan.alpha();
+
+  galois::LargeArray<PRTy> contrib;
+  contrib.allocateInterleaved(graph->size());
+
+  galois::do_all(
+      galois::iterate(*graph),
+      [&](const GNode& n) { graph->GetData<PagerankNodeValue>(n) = 1; },
+      galois::no_stats(), galois::loopname("InitNodeData"));
+
+  uint32_t rounds = 0;
+  bool converged = false;
+
+  // The rounds are short, so they run in one parallel region rather than as
+  // two do_alls each
+  galois::run_phases(
+      [&](galois::PhaseContext& ctx) {
+        uint32_t round = 0;
+        bool done = false;
+        while (!done && round < plan.max_iterations()) {
+          ctx.DoAll(galois::iterate(*graph), [&](const GNode& n) {
+            uint64_t degree = OutDegree(*graph, n);
+            contrib[n] =
+                degree > 0 ? graph->GetData<PagerankNodeValue>(n) / degree : 0;
+          });
+
+          PRTy max_delta = 0;
+          ctx.DoAll(
+              galois::iterate(*graph),
+              [&](const GNode& n) {
+                auto [begin, end] = in_edges.edge_range(n);
+                PRTy sum = 0;
+                for (uint64_t e = begin; e < end; ++e) {
+                  sum += contrib[in_sources[e]];
+                }
+
+                PRTy value = base_score + plan.alpha() * sum;
+                auto& rank = graph->GetData<PagerankNodeValue>(n);
+                max_delta = std::max(max_delta, std::fabs(value - rank));
+                rank = value;
+              },
+              galois::steal(), galois::chunk_size<kChunkSize>());
+
+          ++round;
+          PRTy round_max_delta = ctx.AllReduce(
+              max_delta, [](PRTy a, PRTy b) { return std::max(a, b); });
+          done = round_max_delta <= plan.tolerance();
+        }
+        if (ctx.tid() == 0) {
+          rounds = round;
+          converged = done;
+        }
+      },
+      galois::loopname("PageRank"));
+
+  ReportRounds("PageRank-PullTopological", rounds, converged);
+}
+
+/// PullTopological with propagation blocking. Thread t owns a fixed range of
+/// sources, balanced by edges, and a bin per range of 1 << bin_shift
+/// destinations. Each round, thread t writes the contribution of each out-edge
+/// of its sources to the bin of the destination (the destinations themselves
+/// are binned once, up front); then each bin is summed into its destinations
+/// across all threads. Both phases stream through memory except for the
+/// accumulation, whose random accesses stay within one bin.
+void
+PropagationBlocking(Graph* graph, const PagerankPlan& plan) {
+  struct Bins {
+    std::vector<std::vector<GNode>> dests;
+    std::vector<std::vector<PRTy>> contribs;
+    std::vector<size_t> cursors;
+  };
+
+  const uint32_t bin_shift = plan.bin_shift();
+  const size_t num_nodes = graph->size();
+  const size_t num_bins = ((num_nodes - 1) >> bin_shift) + 1;
+  const PRTy base_score = 1 - plan.alpha();
+
+  const unsigned num_threads = galois::getActiveThreads();
+  std::vector<GNode> thread_begin(num_threads + 1);
+  thread_begin[num_threads] = num_nodes;
+  for (unsigned t = 1; t < num_threads; ++t) {
+    uint64_t target = graph->num_edges() * t / num_threads;
+    thread_begin[t] = *std::partition_point(
+        graph->begin(), graph->end(),
+        [&](GNode n) { return *graph->edge_end(n) <= target; });
+  }
+
+  galois::substrate::PerThreadStorage<Bins> thread_bins;
+  galois::on_each([&](unsigned tid, unsigned) {
+    Bins& bins = *thread_bins.getLocal();
+    bins.dests.resize(num_bins);
+    bins.contribs.resize(num_bins);
+    bins.cursors.resize(num_bins);
+    for (GNode src = thread_begin[tid]; src < thread_begin[tid + 1]; ++src) {
+      for (auto e : graph->edges(src)) {
+        GNode dest = *graph->GetEdgeDest(e);
+        bins.dests[dest >> bin_shift].push_back(dest);
+      }
+    }
+    for (size_t b = 0; b < num_bins; ++b) {
+      bins.contribs[b].resize(bins.dests[b].size());
+    }
+  });
+
+  galois::substrate::PerThreadStorage<std::vector<PRTy>> thread_sums;
+
+  galois::do_all(
+      galois::iterate(*graph),
+      [&](const GNode& n) { graph->GetData<PagerankNodeValue>(n) = 1; },
+      galois::no_stats(), galois::loopname("InitNodeData"));
+
+  galois::GReduceMax<PRTy> max_delta;
+  uint32_t rounds = 0;
+  bool converged = false;
+
+  while (!converged && rounds < plan.max_iterations()) {
+    max_delta.reset();
+
+    galois::on_each([&](unsigned tid, unsigned) {
+      Bins& bins = *thread_bins.getLocal();
+      std::fill(bins.cursors.begin(), bins.cursors.end(), 0);
+      for (GNode src = thread_begin[tid]; src < thread_begin[tid + 1]; ++src) {
+        uint64_t degree = OutDegree(*graph, src);
+        if (degree == 0) {
+          continue;
+        }
+        PRTy contrib = graph->GetData<PagerankNodeValue>(src) / degree;
+        for (auto e : graph->edges(src)) {
+          size_t b = *graph->GetEdgeDest(e) >> bin_shift;
+          bins.contribs[b][bins.cursors[b]++] = contrib;
+        }
+      }
+    });
+
+    galois::do_all(
+        galois::iterate(size_t{0}, num_bins),
+        [&](size_t b) {
+          GNode begin = b << bin_shift;
+          GNode end = std::min<size_t>(num_nodes, (b + 1) << bin_shift);
+
+          std::vector<PRTy>& sums = *thread_sums.getLocal();
+          sums.assign(end - begin, 0);
+          for (unsigned t = 0; t < num_threads; ++t) {
+            const Bins& bins = *thread_bins.getRemote(t);
+            const std::vector<GNode>& dests = bins.dests[b];
+            const std::vector<PRTy>& contribs = bins.contribs[b];
+            for (size_t i = 0; i < dests.size(); ++i) {
+              sums[dests[i] - begin] += contribs[i];
+            }
+          }
+
+          for (GNode n = begin; n < end; ++n) {
+            PRTy value = base_score + plan.alpha() * sums[n - begin];
+            auto& rank = graph->GetData<PagerankNodeValue>(n);
+            max_delta.update(std::fabs(value - rank));
+            rank = value;
+          }
+        },
+        galois::steal(), galois::no_stats(),
+        galois::loopname("PageRank-Accumulate"));
+
+    ++rounds;
+    converged = max_delta.reduce() <= plan.tolerance();
+  }
+
+  ReportRounds("PageRank-PropagationBlocking", rounds, converged);
+}
+
+/// Each round, nodes whose residual exceeds the tolerance fold it into their
+/// rank and spread it over their out-degree, and every node pulls the
+/// residual from its in-neighbors.
+void
+PullResidual(
+    Graph* graph, const galois::graphs::InEdgeTopology& in_edges,
+    const PagerankPlan& plan) {
+  const uint32_t* in_sources = in_edges.in_sources->raw_values();
+
+  galois::LargeArray<PRTy> delta;
+  delta.allocateInterleaved(graph->size());
+  galois::LargeArray<PRTy> residual;
+  residual.allocateInterleaved(graph->size());
+
+  galois::do_all(
+      galois::iterate(*graph),
+      [&](const GNode& n) {
+        graph->GetData<PagerankNodeValue>(n) = 0;
+        delta[n] = 0;
+        residual[n] = 1 - plan.alpha();
+      },
+      galois::no_stats(), galois::loopname("InitNodeData"));
+
+  galois::GReduceLogicalOr changed;
+  uint32_t rounds = 0;
+  bool converged = false;
+
+  while (!converged && rounds < plan.max_iterations()) {
+    changed.reset();
+
+    galois::do_all(
+        galois::iterate(*graph),
+        [&](const GNode& n) {
+          delta[n] = 0;
+          if (residual[n] > plan.tolerance()) {
+            PRTy old_residual = residual[n];
+            residual[n] = 0;
+            graph->GetData<PagerankNodeValue>(n) += old_residual;
+            uint64_t degree = OutDegree(*graph, n);
+            if (degree > 0) {
+              delta[n] = old_residual * plan.alpha() / degree;
+              changed.update(true);
+            }
+          }
+        },
+        galois::no_stats(), galois::loopname("PageRank-Delta"));
+
+    converged = !changed.reduce();
+    if (converged) {
+      break;
+    }
+
+    galois::do_all(
+        galois::iterate(*graph),
+        [&](const GNode& n) {
+          auto [begin, end] = in_edges.edge_range(n);
+          PRTy sum = 0;
+          for (uint64_t e = begin; e < end; ++e) {
+            sum += delta[in_sources[e]];
+          }
+          residual[n] += sum;
+        },
+        galois::steal(), galois::chunk_size<kChunkSize>(), galois::no_stats(),
+        galois::loopname("PageRank"));
+
+    ++rounds;
+  }
+
+  ReportRounds("PageRank-PullResidual", rounds, converged);
+}
+
+void
+InitPush(
+    Graph* graph, galois::LargeArray<std::atomic<PRTy>>* residual,
+    const PagerankPlan& plan) {
+  residual->allocateInterleaved(graph->size());
+  galois::do_all(
+      galois::iterate(*graph),
+      [&](const GNode& n) {
+        graph->GetData<PagerankNodeValue>(n) = 0;
+        residual->constructAt(n, 1 - plan.alpha());
+      },
+      galois::no_stats(), galois::loopname("InitNodeData"));
+}
+
+/// Whang et al., Euro-Par '15, Algorithm 4: a node is scheduled when its
+/// residual crosses the tolerance.
+void
+PushAsynchronous(Graph* graph, const PagerankPlan& plan) {
+  using WL = galois::worklists::PerSocketChunkFIFO<kPushChunkSize>;
+
+  galois::LargeArray<std::atomic<PRTy>> residual;
+  InitPush(graph, &residual, plan);
+
+  galois::for_each(
+      galois::iterate(*graph),
+      [&](const GNode& src, auto& ctx) {
+        if (residual[src] <= plan.tolerance()) {
+          return;
+        }
+        PRTy old_residual = residual[src].exchange(0);
+        graph->GetData<PagerankNodeValue>(src) += old_residual;
+
+        uint64_t degree = OutDegree(*graph, src);
+        if (degree == 0) {
+          return;
+        }
+        PRTy delta = old_residual * plan.alpha() / degree;
+        if (!(delta > 0)) {
+          return;
+        }
+        for (auto e : graph->edges(src)) {
+          auto dest = graph->GetEdgeDest(e);
+          PRTy old = galois::atomicAdd(residual[*dest], delta);
+          if (old <= plan.tolerance() && old + delta > plan.tolerance()) {
+            ctx.push(*dest);
+          }
+        }
+      },
+      galois::disable_conflict_detection(), galois::no_stats(),
+      galois::wl<WL>(), galois::loopname("PageRank-PushAsynchronous"));
+}
+
+/// Delta-based PageRank: each round the active nodes fold their residual into
+/// their rank and push the change along their out-edges, split into tiles so
+/// that high degree nodes do not serialize a round. Nodes whose residual
+/// crosses the tolerance form the next round.
+void
+PushSynchronous(Graph* graph, const PagerankPlan& plan) {
+  struct Update {
+    PRTy delta;
+    Graph::edge_iterator beg;
+    Graph::edge_iterator end;
+  };
+
+  galois::LargeArray<std::atomic<PRTy>> residual;
+  InitPush(graph, &residual, plan);
+
+  galois::InsertBag<Update> updates;
+  galois::InsertBag<GNode> active_nodes;
+
+  galois::do_all(
+      galois::iterate(*graph),
+      [&](const GNode& n) { active_nodes.push(n); }, galois::no_stats());
+
+  uint32_t rounds = 0;
+  for (; !active_nodes.empty() && rounds < plan.max_iterations(); ++rounds) {
+    galois::do_all(
+        galois::iterate(active_nodes),
+        [&](const GNode& src) {
+          if (residual[src] <= plan.tolerance()) {
+            return;
+          }
+          PRTy old_residual = residual[src].exchange(0);
+          graph->GetData<PagerankNodeValue>(src) += old_residual;
+
+          auto beg = graph->edge_begin(src);
+          const auto end = graph->edge_end(src);
+          if (beg == end) {
+            return;
+          }
+          PRTy delta = old_residual * plan.alpha() / (end - beg);
+          for (; beg + kEdgeTileSize < end; beg += kEdgeTileSize) {
+            updates.push(Update{delta, beg, beg + kEdgeTileSize});
+          }
+          updates.push(Update{delta, beg, end});
+        },
+        galois::steal(), galois::chunk_size<kPushChunkSize>(),
+        galois::no_stats(), galois::loopname("PageRank-CreateEdgeTiles"));
+
+    active_nodes.clear();
+
+    galois::do_all(
+        galois::iterate(updates),
+        [&](const Update& up) {
+          for (auto e = up.beg; e != up.end; ++e) {
+            auto dest = graph->GetEdgeDest(e);
+            PRTy old = galois::atomicAdd(residual[*dest], up.delta);
+            // if old was above the tolerance, dest is already active
+            if (old <= plan.tolerance() && old + up.delta > plan.tolerance()) {
+              active_nodes.push(*dest);
+            }
+          }
+        },
+        galois::steal(), galois::chunk_size<kPushChunkSize>(),
+        galois::no_stats(), galois::loopname("PageRank-PushSynchronous"));
+
+    updates.clear();
+  }
+
+  ReportRounds("PageRank-PushSynchronous", rounds, active_nodes.empty());
+}
+
+}  // namespace
+
+galois::Result<void>
+galois::analytics::Pagerank(
+    graphs::PropertyGraph<std::tuple<PagerankNodeValue>, std::tuple<>>& pg,
+    PagerankPlan plan) {
+  if (!(plan.alpha() >= 0 && plan.alpha() < 1) || !(plan.tolerance() >= 0)) {
+    return galois::ErrorCode::InvalidArgument;
+  }
+  if (plan.algorithm() == PagerankPlan::kPropagationBlocking &&
+      plan.bin_shift() >= 32) {
+    return galois::ErrorCode::InvalidArgument;
+  }
+  if (pg.num_nodes() == 0) {
+    return galois::ResultSuccess();
+  }
+
+  const galois::graphs::InEdgeTopology* in_edges = nullptr;
+  if (plan.algorithm() == PagerankPlan::kPullTopological ||
+      plan.algorithm() == PagerankPlan::kPullResidual) {
+    auto in_edges_result = pg.GetPropertyFileGraph().InEdges();
+    if (!in_edges_result) {
+      return in_edges_result.error();
+    }
+    in_edges = in_edges_result.value();
+  }
+
+  galois::StatTimer execTime("PageRank");
+  execTime.start();
+
+  switch (plan.algorithm()) {
+  case PagerankPlan::kPullTopological:
+    PullTopological(&pg, *in_edges, plan);
+    break;
+  case PagerankPlan::kPullResidual:
+    PullResidual(&pg, *in_edges, plan);
+    break;
+  case PagerankPlan::kPushAsynchronous:
+    PushAsynchronous(&pg, plan);
+    break;
+  case PagerankPlan::kPushSynchronous:
+    PushSynchronous(&pg, plan);
+    break;
+  case PagerankPlan::kPropagationBlocking:
+    PropagationBlocking(&pg, plan);
+    break;
+  default:
+    return galois::ErrorCode::InvalidArgument;
+  }
+
+  execTime.stop();
+
+  return galois::ResultSuccess();
+}
+
+galois::Result<void>
+galois::analytics::Pagerank(
+    graphs::PropertyFileGraph* pfg, const std::string& output_property_name,
+    PagerankPlan plan) {
+  if (auto result = ConstructNodeProperties<std::tuple<PagerankNodeValue>>(
+          pfg, {output_property_name});
+      !result) {
+    return result.error();
+  }
+
+  auto pg_result = Graph::Make(pfg, {output_property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+
+  return Pagerank(pg_result.value(), plan);
+}
+
+namespace {
+
+struct RankedNode {
+  double rank;
+  GNode node;
+};
+
+/// Orders nodes from highest to lowest rank, ties broken by node id; as the
+/// comparison of a heap, it keeps the lowest rank at the front
+bool
+HigherRank(const RankedNode& a, const RankedNode& b) {
+  return a.rank > b.rank || (a.rank == b.rank && a.node < b.node);
+}
+
+/// The rank found so far and the residual probability still to push of a
+/// node touched by the push from a seed
+struct PushState {
+  double rank = 0;
+  double residual = 0;
+  bool queued = false;
+};
+
+using PushStates = std::unordered_map<
+    GNode, PushState, std::hash<GNode>, std::equal_to<GNode>,
+    galois::ArenaAllocator<std::pair<const GNode, PushState>>>;
+
+/// Buckets reserved up front so that a small push does not rehash; they come
+/// from the arena, which keeps the memory of rehashes until the seed is done
+constexpr size_t kPushBuckets = 1024;
+
+/// Forward push from seed until every residual is below epsilon times the
+/// out-degree, then write the k highest ranks to out and their number to
+/// num_out. Returns the number of pushes.
+uint64_t
+PushFromSeed(
+    const galois::graphs::GraphTopology& topology, GNode seed, uint32_t k,
+    double epsilon, double alpha, galois::PerThreadArena* arena,
+    RankedNode* out, uint64_t* num_out) {
+  const uint32_t* dests = topology.out_dests->raw_values();
+  auto degree = [&](GNode n) -> uint64_t {
+    auto [begin, end] = topology.edge_range(n);
+    return end - begin;
+  };
+
+  PushStates states(
+      kPushBuckets, std::hash<GNode>(), std::equal_to<GNode>(),
+      arena->allocator<std::pair<const GNode, PushState>>());
+  std::deque<GNode, galois::ArenaAllocator<GNode>> queue(
+      arena->allocator<GNode>());
+
+  auto add = [&](GNode n, double mass) {
+    PushState& state = states[n];
+    state.residual += mass;
+    if (!state.queued &&
+        state.residual >= epsilon * std::max<uint64_t>(1, degree(n))) {
+      state.queued = true;
+      queue.emplace_back(n);
+    }
+  };
+
+  uint64_t pushes = 0;
+  add(seed, 1);
+  while (!queue.empty()) {
+    GNode n = queue.front();
+    queue.pop_front();
+    // references to the elements of an unordered_map survive rehashes
+    PushState& state = states[n];
+    const double residual = state.residual;
+    state.residual = 0;
+    state.queued = false;
+    state.rank += (1 - alpha) * residual;
+    ++pushes;
+
+    auto [begin, end] = topology.edge_range(n);
+    if (begin == end) {
+      add(seed, alpha * residual);
+      continue;
+    }
+    const double share = alpha * residual / (end - begin);
+    for (uint64_t e = begin; e < end; ++e) {
+      add(dests[e], share);
+    }
+  }
+
+  galois::ArenaVector<RankedNode> heap = arena->MakeVector<RankedNode>();
+  heap.reserve(k);
+  for (const auto& [node, state] : states) {
+    RankedNode ranked{state.rank, node};
+    if (!(ranked.rank > 0) || k == 0) {
+      continue;
+    }
+    if (heap.size() < k) {
+      heap.push_back(ranked);
+      std::push_heap(heap.begin(), heap.end(), HigherRank);
+    } else if (HigherRank(ranked, heap.front())) {
+      std::pop_heap(heap.begin(), heap.end(), HigherRank);
+      heap.back() = ranked;
+      std::push_heap(heap.begin(), heap.end(), HigherRank);
+    }
+  }
+
+  std::sort_heap(heap.begin(), heap.end(), HigherRank);
+  std::copy(heap.begin(), heap.end(), out);
+  *num_out = heap.size();
+  return pushes;
+}
+
+}  // namespace
+
+galois::Result<galois::analytics::TopKPersonalizedPagerank>
+galois::analytics::PersonalizedPagerank(
+    graphs::PropertyFileGraph* pfg, const std::vector<uint32_t>& seeds,
+    uint32_t k, double epsilon, float alpha) {
+  if (!(epsilon > 0) || !(alpha >= 0 && alpha < 1)) {
+    return galois::ErrorCode::InvalidArgument;
+  }
+  const galois::graphs::GraphTopology& topology = pfg->topology();
+  uint64_t num_nodes = topology.num_nodes();
+  for (uint32_t seed : seeds) {
+    if (seed >= num_nodes) {
+      return galois::ErrorCode::InvalidArgument;
+    }
+  }
+  k = std::min<uint64_t>(k, num_nodes);
+
+  uint64_t num_seeds = seeds.size();
+  TopKPersonalizedPagerank result;
+  result.offsets.resize(num_seeds + 1);
+  result.offsets[0] = 0;
+
+  galois::StatTimer execTime("PersonalizedPagerank");
+  execTime.start();
+
+  // Each seed writes its results to its own k slots, then they are compacted
+  galois::LargeArray<RankedNode> slots;
+  slots.allocateBlocked(num_seeds * k);
+  galois::PerThreadArena arena;
+  galois::GAccumulator<uint64_t> pushes;
+
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_seeds),
+      [&](uint64_t i) {
+        pushes += PushFromSeed(
+            topology, seeds[i], k, epsilon, alpha, &arena,
+            slots.data() + i * k, &result.offsets[i + 1]);
+        // nothing of the push outlives PushFromSeed
+        arena.RewindLocal();
+      },
+      galois::steal(), galois::loopname("PersonalizedPagerank"));
+
+  galois::ParallelSTL::partial_sum(
+      result.offsets.begin(), result.offsets.end(), result.offsets.begin());
+
+  uint64_t num_results = result.offsets[num_seeds];
+  result.nodes.resize(num_results);
+  result.ranks.resize(num_results);
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_seeds),
+      [&](uint64_t i) {
+        const RankedNode* first = slots.data() + i * k;
+        for (uint64_t j = result.offsets[i]; j < result.offsets[i + 1]; ++j) {
+          result.nodes[j] = first->node;
+          result.ranks[j] = first->rank;
+          ++first;
+        }
+      },
+      galois::no_stats());
+
+  execTime.stop();
+
+  galois::ReportStatSingle("PersonalizedPagerank", "Pushes", pushes.reduce());
+
+  return result;
+}
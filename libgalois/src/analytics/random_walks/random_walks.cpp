@@ -0,0 +1,426 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/analytics/random_walks/random_walks.h"
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <vector>
+
+#include <arrow/compute/api.h>
+#include <parquet/arrow/writer.h>
+
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/Logging.h"
+#include "galois/ParallelSTL.h"
+#include "galois/substrate/PerThreadStorage.h"
+#include "tsuba/FileFrame.h"
+#include "tsuba/MemoryPool.h"
+
+using namespace galois::analytics;
+
+namespace {
+
+using galois::graphs::GraphTopology;
+
+/// Walks of a block advance together one step at a time, so that the edge
+/// lookups of different walks overlap instead of waiting on each other
+constexpr uint64_t kWalksPerBlock = 64;
+
+/// Walks per parquet row group in WriteRandomWalks
+constexpr int64_t kWalksPerRowGroup = int64_t{1} << 16;
+
+std::mt19937_64
+MakeGenerator(uint64_t random_seed, uint64_t block) {
+  std::seed_seq seq{
+      static_cast<uint32_t>(random_seed),
+      static_cast<uint32_t>(random_seed >> 32), static_cast<uint32_t>(block),
+      static_cast<uint32_t>(block >> 32)};
+  return std::mt19937_64(seq);
+}
+
+/// The alias tables (Vose, IEEE TSE '91) of the out-edges of every node: to
+/// draw an edge of node n, pick an edge e of n uniformly and keep it with
+/// probability[e], or take edge edge_begin(n) + alias[e] otherwise. Nodes
+/// whose out-edges all have weight zero are marked by a negative probability
+/// on their first edge.
+struct AliasTables {
+  galois::LargeArray<float> probability;
+  galois::LargeArray<uint32_t> alias;
+};
+
+/// The scratch space of BuildAliasTables for one node
+struct AliasScratch {
+  std::vector<double> scaled;
+  std::vector<uint32_t> small;
+  std::vector<uint32_t> large;
+};
+
+galois::Result<std::shared_ptr<arrow::DoubleArray>>
+GetWeights(
+    galois::graphs::PropertyFileGraph* pfg, const std::string& property_name) {
+  if (auto res = pfg->EnsureEdgePropertiesLoaded({property_name}); !res) {
+    return res.error();
+  }
+  std::shared_ptr<arrow::ChunkedArray> property =
+      pfg->EdgeProperty(property_name);
+  if (!property) {
+    return galois::ErrorCode::PropertyNotFound;
+  }
+  if (!arrow::is_integer(property->type()->id()) &&
+      !arrow::is_floating(property->type()->id())) {
+    return galois::ErrorCode::TypeError;
+  }
+
+  auto cast_result =
+      arrow::compute::Cast(arrow::Datum(property), arrow::float64());
+  if (!cast_result.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", cast_result.status());
+    return galois::ErrorCode::ArrowError;
+  }
+  std::shared_ptr<arrow::ChunkedArray> weights =
+      cast_result.ValueOrDie().chunked_array();
+  if (weights->num_chunks() == 1) {
+    return std::static_pointer_cast<arrow::DoubleArray>(weights->chunk(0));
+  }
+  auto concat_result =
+      arrow::Concatenate(weights->chunks(), tsuba::GetArrowMemoryPool());
+  if (!concat_result.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", concat_result.status());
+    return galois::ErrorCode::ArrowError;
+  }
+  return std::static_pointer_cast<arrow::DoubleArray>(
+      concat_result.ValueOrDie());
+}
+
+galois::Result<void>
+BuildAliasTables(
+    const GraphTopology& topology, const arrow::DoubleArray& weights,
+    AliasTables* tables) {
+  uint64_t num_edges = topology.num_edges();
+  tables->probability.allocateBlocked(num_edges);
+  tables->alias.allocateBlocked(num_edges);
+
+  galois::substrate::PerThreadStorage<AliasScratch> scratch;
+  std::atomic<bool> negative{false};
+  galois::do_all(
+      galois::iterate(uint64_t{0}, topology.num_nodes()),
+      [&](uint64_t n) {
+        auto [begin, end] = topology.edge_range(n);
+        if (begin == end) {
+          return;
+        }
+        uint32_t degree = end - begin;
+        double total = 0;
+        for (uint64_t e = begin; e < end; ++e) {
+          double w = weights.IsNull(e) ? 0 : weights.Value(e);
+          if (!(w >= 0)) {
+            negative.store(true, std::memory_order_relaxed);
+            return;
+          }
+          total += w;
+        }
+        if (total == 0) {
+          tables->probability[begin] = -1;
+          return;
+        }
+
+        AliasScratch& s = *scratch.getLocal();
+        s.scaled.resize(degree);
+        s.small.clear();
+        s.large.clear();
+        for (uint32_t i = 0; i < degree; ++i) {
+          s.scaled[i] = weights.IsNull(begin + i)
+                            ? 0
+                            : weights.Value(begin + i) * degree / total;
+          (s.scaled[i] < 1 ? s.small : s.large).push_back(i);
+        }
+        while (!s.small.empty() && !s.large.empty()) {
+          uint32_t l = s.small.back();
+          s.small.pop_back();
+          uint32_t g = s.large.back();
+          tables->probability[begin + l] = s.scaled[l];
+          tables->alias[begin + l] = g;
+          s.scaled[g] += s.scaled[l] - 1;
+          if (s.scaled[g] < 1) {
+            s.large.pop_back();
+            s.small.push_back(g);
+          }
+        }
+        // what is left is 1 up to rounding
+        for (uint32_t i : s.large) {
+          tables->probability[begin + i] = 1;
+          tables->alias[begin + i] = i;
+        }
+        for (uint32_t i : s.small) {
+          tables->probability[begin + i] = 1;
+          tables->alias[begin + i] = i;
+        }
+      },
+      galois::steal(), galois::no_stats(),
+      galois::loopname("RandomWalks-AliasTables"));
+
+  if (negative) {
+    return galois::ErrorCode::InvalidArgument;
+  }
+  return galois::ResultSuccess();
+}
+
+/// Sampler draws the steps of walks; tables is null for unweighted walks
+class Sampler {
+  const GraphTopology& topology_;
+  const AliasTables* tables_;
+  const uint32_t* dests_;
+  bool second_order_;
+  /// The node2vec weight factors divided by the largest of them, i.e., the
+  /// probability of accepting a step back, to a neighbor of the previous
+  /// node or further away
+  double return_acceptance_;
+  double neighbor_acceptance_;
+  double out_acceptance_;
+
+  /// DrawEdge draws an out-edge of node into e and returns false if node has
+  /// none to draw
+  bool DrawEdge(uint32_t node, std::mt19937_64* gen, uint64_t* e) const {
+    auto [begin, end] = topology_.edge_range(node);
+    if (begin == end) {
+      return false;
+    }
+    uint64_t i = std::uniform_int_distribution<uint64_t>(begin, end - 1)(*gen);
+    if (tables_) {
+      if (tables_->probability[begin] < 0) {
+        return false;
+      }
+      if (std::uniform_real_distribution<float>(0, 1)(*gen) >=
+          tables_->probability[i]) {
+        i = begin + tables_->alias[i];
+      }
+    }
+    *e = i;
+    return true;
+  }
+
+  bool IsNeighbor(uint32_t node, uint32_t other) const {
+    auto [begin, end] = topology_.edge_range(node);
+    if (topology_.edges_sorted_by_dest) {
+      return std::binary_search(dests_ + begin, dests_ + end, other);
+    }
+    return std::find(dests_ + begin, dests_ + end, other) != dests_ + end;
+  }
+
+public:
+  Sampler(
+      const GraphTopology& topology, const AliasTables* tables,
+      const RandomWalksPlan& plan)
+      : topology_(topology),
+        tables_(tables),
+        dests_(topology.out_dests ? topology.out_dests->raw_values() : nullptr),
+        second_order_(plan.algorithm() == RandomWalksPlan::kNode2vec) {
+    double return_factor = 1 / plan.return_parameter();
+    double out_factor = 1 / plan.in_out_parameter();
+    double max_factor = std::max({return_factor, 1.0, out_factor});
+    return_acceptance_ = return_factor / max_factor;
+    neighbor_acceptance_ = 1 / max_factor;
+    out_acceptance_ = out_factor / max_factor;
+  }
+
+  /// Next draws the node after walk[0..step) into next and returns false if
+  /// the walk stops at walk[step - 1] instead
+  bool Next(
+      const uint32_t* walk, uint32_t step, std::mt19937_64* gen,
+      uint32_t* next) const {
+    uint32_t node = walk[step - 1];
+    uint64_t e;
+    if (!second_order_ || step == 1) {
+      if (!DrawEdge(node, gen, &e)) {
+        return false;
+      }
+      *next = dests_[e];
+      return true;
+    }
+
+    uint32_t previous = walk[step - 2];
+    for (;;) {
+      if (!DrawEdge(node, gen, &e)) {
+        return false;
+      }
+      uint32_t candidate = dests_[e];
+      double acceptance = candidate == previous
+                              ? return_acceptance_
+                              : IsNeighbor(previous, candidate)
+                                    ? neighbor_acceptance_
+                                    : out_acceptance_;
+      if (acceptance >= 1 ||
+          std::uniform_real_distribution<double>(0, 1)(*gen) < acceptance) {
+        *next = candidate;
+        return true;
+      }
+    }
+  }
+};
+
+galois::Result<std::shared_ptr<arrow::Buffer>>
+Allocate(uint64_t size) {
+  auto alloc_result = arrow::AllocateBuffer(size, tsuba::GetArrowMemoryPool());
+  if (!alloc_result.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", alloc_result.status());
+    return galois::ErrorCode::ArrowError;
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(alloc_result.ValueOrDie()));
+}
+
+/// Walk writes walk w to values + w * (walk_length + 1) and its length to
+/// offsets[w + 1]
+void
+Walk(
+    const GraphTopology& topology, const Sampler& sampler,
+    uint64_t num_walks, uint32_t walk_length, uint64_t random_seed,
+    uint32_t* values, int64_t* offsets) {
+  uint64_t num_nodes = topology.num_nodes();
+  uint64_t stride = uint64_t{walk_length} + 1;
+  uint64_t num_blocks = (num_walks + kWalksPerBlock - 1) / kWalksPerBlock;
+
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t block) {
+        std::mt19937_64 gen = MakeGenerator(random_seed, block);
+        uint64_t active[kWalksPerBlock];
+        uint64_t num_active = 0;
+        uint64_t block_end = std::min(num_walks, (block + 1) * kWalksPerBlock);
+        for (uint64_t w = block * kWalksPerBlock; w < block_end; ++w) {
+          values[w * stride] = w % num_nodes;
+          offsets[w + 1] = 1;
+          active[num_active++] = w;
+        }
+
+        for (uint32_t step = 1; step <= walk_length && num_active; ++step) {
+          uint64_t kept = 0;
+          for (uint64_t i = 0; i < num_active; ++i) {
+            uint64_t w = active[i];
+            uint32_t* walk = values + w * stride;
+            if (sampler.Next(walk, step, &gen, &walk[step])) {
+              offsets[w + 1] = step + 1;
+              active[kept++] = w;
+            }
+          }
+          num_active = kept;
+        }
+      },
+      galois::steal(), galois::no_stats(), galois::loopname("RandomWalks"));
+}
+
+}  // namespace
+
+galois::Result<std::shared_ptr<arrow::Table>>
+galois::analytics::RandomWalks(
+    graphs::PropertyFileGraph* pfg,
+    const std::string& edge_weight_property_name, uint64_t random_seed,
+    RandomWalksPlan plan) {
+  if (!(plan.return_parameter() > 0) || !(plan.in_out_parameter() > 0)) {
+    return ErrorCode::InvalidArgument;
+  }
+  const GraphTopology& topology = pfg->topology();
+
+  AliasTables tables;
+  bool weighted = plan.algorithm() == RandomWalksPlan::kWeighted ||
+                  (plan.algorithm() == RandomWalksPlan::kNode2vec &&
+                   !edge_weight_property_name.empty());
+  if (weighted) {
+    auto weights = GetWeights(pfg, edge_weight_property_name);
+    if (!weights) {
+      return weights.error();
+    }
+    if (auto res = BuildAliasTables(topology, *weights.value(), &tables);
+        !res) {
+      return res.error();
+    }
+  }
+  Sampler sampler(topology, weighted ? &tables : nullptr, plan);
+
+  uint64_t num_walks = topology.num_nodes() * plan.walks_per_node();
+  uint64_t stride = uint64_t{plan.walk_length()} + 1;
+  auto offsets_result = Allocate((num_walks + 1) * sizeof(int64_t));
+  if (!offsets_result) {
+    return offsets_result.error();
+  }
+  auto values_result = Allocate(num_walks * stride * sizeof(uint32_t));
+  if (!values_result) {
+    return values_result.error();
+  }
+  std::shared_ptr<arrow::Buffer> offsets_buffer = offsets_result.value();
+  std::shared_ptr<arrow::Buffer> values_buffer = values_result.value();
+  auto* offsets = reinterpret_cast<int64_t*>(offsets_buffer->mutable_data());
+  auto* values = reinterpret_cast<uint32_t*>(values_buffer->mutable_data());
+
+  offsets[0] = 0;
+  Walk(
+      topology, sampler, num_walks, plan.walk_length(), random_seed, values,
+      offsets);
+  galois::ParallelSTL::partial_sum(
+      offsets, offsets + num_walks + 1, offsets);
+
+  // walks that stopped early leave gaps to squeeze out
+  uint64_t num_values = offsets[num_walks];
+  if (num_values != num_walks * stride) {
+    auto compact_result = Allocate(num_values * sizeof(uint32_t));
+    if (!compact_result) {
+      return compact_result.error();
+    }
+    std::shared_ptr<arrow::Buffer> compact_buffer = compact_result.value();
+    auto* compact = reinterpret_cast<uint32_t*>(compact_buffer->mutable_data());
+    galois::do_all(
+        galois::iterate(uint64_t{0}, num_walks),
+        [&](uint64_t w) {
+          std::copy(
+              values + w * stride,
+              values + w * stride + (offsets[w + 1] - offsets[w]),
+              compact + offsets[w]);
+        },
+        galois::no_stats());
+    values_buffer = std::move(compact_buffer);
+  }
+
+  std::shared_ptr<arrow::Array> walks = std::make_shared<arrow::LargeListArray>(
+      arrow::large_list(arrow::uint32()), num_walks, offsets_buffer,
+      std::make_shared<arrow::UInt32Array>(num_values, values_buffer));
+  return arrow::Table::Make(
+      arrow::schema({arrow::field(kRandomWalksColumn, walks->type())}),
+      {walks});
+}
+
+galois::Result<void>
+galois::analytics::WriteRandomWalks(
+    const std::shared_ptr<arrow::Table>& walks, const std::string& uri) {
+  auto ff = std::make_shared<tsuba::FileFrame>();
+  if (auto res = ff->Init(); !res) {
+    return res.error();
+  }
+
+  auto write_result = parquet::arrow::WriteTable(
+      *walks, tsuba::GetArrowMemoryPool(), ff, kWalksPerRowGroup);
+  if (!write_result.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", write_result);
+    return ErrorCode::ArrowError;
+  }
+
+  ff->Bind(uri);
+  return ff->Persist();
+}
@@ -19,6 +19,15 @@
 
 #include "galois/analytics/sssp/sssp.h"
 
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <queue>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
 using namespace galois::analytics;
 
 // Explicit instantiations for extern templates
@@ -85,7 +94,23 @@ SSSPWithWrap(
     return graph.error();
   }
 
-  return galois::analytics::Sssp(graph.value(), start_node, plan);
+  // here the weights are known, so their statistics can choose the delta
+  if (plan.algorithm() == SsspPlan::kAutomatic) {
+    plan = SsspPlan::Automatic(pfg, edge_weight_property_name)
+               .WithInlineEdges(plan.inline_edges());
+  }
+  if (!plan.inline_edges()) {
+    return galois::analytics::Sssp(graph.value(), start_node, plan);
+  }
+  auto inline_result = pfg->InlineEdges(edge_weight_property_name);
+  if (!inline_result) {
+    return inline_result.error();
+  }
+  std::shared_ptr<const galois::graphs::InlineEdgeIndex> inline_edges =
+      std::move(inline_result.value());
+  galois::analytics::SsspImplementation<Weight> impl{{plan.edge_tile_size()}};
+  impl.inline_edges = inline_edges->edges<Weight>();
+  return impl.SSSP(graph.value(), start_node, plan);
 }
 
 galois::Result<void>
@@ -93,6 +118,16 @@ galois::analytics::Sssp(
     graphs::PropertyFileGraph* pfg, size_t start_node,
     std::string edge_weight_property_name, std::string output_property_name,
     SsspPlan plan) {
+  if (!plan.filter().empty()) {
+    return internal::RunFiltered(
+        pfg, plan.filter(), {edge_weight_property_name}, output_property_name,
+        [&](graphs::PropertyFileGraph* filtered) {
+          return Sssp(
+              filtered, start_node, edge_weight_property_name,
+              output_property_name, plan.WithFilter({}));
+        });
+  }
+
   switch (pfg->EdgeProperty(edge_weight_property_name)->type()->id()) {
   // TODO: Consider lifting these repetitive clauses into a macro or template
   //  function. For each type we get something like:
@@ -120,3 +155,574 @@ galois::analytics::Sssp(
     return galois::ErrorCode::TypeError;
   }
 }
+
+galois::analytics::AsyncResult<void>
+galois::analytics::SsspAsync(
+    graphs::PropertyFileGraph* pfg, size_t start_node,
+    std::string edge_weight_property_name, std::string output_property_name,
+    SsspPlan plan) {
+  return RunAsync<void>([=]() {
+    return Sssp(
+        pfg, start_node, edge_weight_property_name, output_property_name,
+        plan);
+  });
+}
+
+namespace {
+
+template <typename Weight>
+using PointToPointGraph = galois::graphs::PropertyGraph<
+    std::tuple<>, std::tuple<SsspEdgeWeight<Weight>>>;
+
+template <typename Weight>
+struct PointToPointSearch {
+  using Graph = PointToPointGraph<Weight>;
+  using Node = typename Graph::Node;
+  using Item = std::pair<Weight, Node>;
+  using Heap = std::priority_queue<Item, std::vector<Item>, std::greater<Item>>;
+  using Distances = std::unordered_map<Node, Weight>;
+
+  static constexpr Weight kInfinity = std::numeric_limits<Weight>::max();
+
+  /// Dijkstra from source that stops once target is settled. Distances live in
+  /// a hash map so that the cost depends on the ball of nodes closer to source
+  /// than target rather than on the size of the graph.
+  static Weight Unidirectional(const Graph& graph, Node source, Node target) {
+    Distances dist{{source, 0}};
+    Heap heap;
+    heap.emplace(0, source);
+
+    while (!heap.empty()) {
+      auto [d, n] = heap.top();
+      heap.pop();
+      if (n == target) {
+        return d;
+      }
+      if (d > dist[n]) {
+        // empty work
+        continue;
+      }
+
+      for (auto e : graph.edges(n)) {
+        const Weight new_dist =
+            d + graph.template GetEdgeData<SsspEdgeWeight<Weight>>(e);
+        auto [it, inserted] = dist.try_emplace(*graph.GetEdgeDest(e), new_dist);
+        if (!inserted) {
+          if (new_dist >= it->second) {
+            continue;
+          }
+          it->second = new_dist;
+        }
+        heap.emplace(new_dist, it->first);
+      }
+    }
+    return kInfinity;
+  }
+
+  /// Bidirectional Dijkstra: one search from source over the out-edges and
+  /// one from target over in_edges, always advancing the one with the smaller
+  /// queue. best is the shortest path seen through a node labeled by both
+  /// searches; it is final once the two queue minima add up to at least it.
+  static Weight Bidirectional(
+      const Graph& graph, const galois::graphs::InEdgeTopology& in_edges,
+      Node source, Node target) {
+    const uint32_t* in_sources = in_edges.in_sources->raw_values();
+    const uint64_t* out_edge_ids = in_edges.out_edge_ids->raw_values();
+
+    Distances dist[2] = {{{source, 0}}, {{target, 0}}};
+    Heap heap[2];
+    heap[0].emplace(0, source);
+    heap[1].emplace(0, target);
+    Weight best = source == target ? 0 : kInfinity;
+
+    while (!heap[0].empty() && !heap[1].empty()) {
+      if (heap[0].top().first + heap[1].top().first >= best) {
+        break;
+      }
+      int side = heap[0].size() <= heap[1].size() ? 0 : 1;
+      auto [d, n] = heap[side].top();
+      heap[side].pop();
+      if (d > dist[side][n]) {
+        // empty work
+        continue;
+      }
+
+      auto relax = [&](Node m, Weight w) {
+        const Weight new_dist = d + w;
+        auto [it, inserted] = dist[side].try_emplace(m, new_dist);
+        if (!inserted) {
+          if (new_dist >= it->second) {
+            return;
+          }
+          it->second = new_dist;
+        }
+        heap[side].emplace(new_dist, m);
+        const Distances& other = dist[1 - side];
+        if (auto found = other.find(m); found != other.end()) {
+          best = std::min<Weight>(best, new_dist + found->second);
+        }
+      };
+
+      if (side == 0) {
+        for (auto e : graph.edges(n)) {
+          relax(
+              *graph.GetEdgeDest(e),
+              graph.template GetEdgeData<SsspEdgeWeight<Weight>>(e));
+        }
+      } else {
+        auto [begin, end] = in_edges.edge_range(n);
+        for (uint64_t i = begin; i < end; ++i) {
+          typename Graph::edge_iterator e(out_edge_ids[i]);
+          relax(
+              in_sources[i],
+              graph.template GetEdgeData<SsspEdgeWeight<Weight>>(e));
+        }
+      }
+    }
+    return best;
+  }
+};
+
+template <typename Weight>
+galois::Result<double>
+SsspPointToPointWithWrap(
+    galois::graphs::PropertyFileGraph* pfg, size_t source, size_t target,
+    const std::string& edge_weight_property_name, bool bidirectional) {
+  using Search = PointToPointSearch<Weight>;
+
+  auto graph =
+      PointToPointGraph<Weight>::Make(pfg, {}, {edge_weight_property_name});
+  if (!graph) {
+    return graph.error();
+  }
+
+  galois::StatTimer execTime("SSSP-PointToPoint");
+  execTime.start();
+  Weight dist;
+  if (bidirectional) {
+    auto in_edges = pfg->InEdges();
+    if (!in_edges) {
+      return in_edges.error();
+    }
+    dist = Search::Bidirectional(
+        graph.value(), *in_edges.value(), source, target);
+  } else {
+    dist = Search::Unidirectional(graph.value(), source, target);
+  }
+  execTime.stop();
+
+  if (dist == Search::kInfinity) {
+    return std::numeric_limits<double>::infinity();
+  }
+  return static_cast<double>(dist);
+}
+
+}  // namespace
+
+galois::Result<double>
+galois::analytics::SsspPointToPoint(
+    graphs::PropertyFileGraph* pfg, size_t source, size_t target,
+    const std::string& edge_weight_property_name, bool bidirectional) {
+  if (source >= pfg->topology().num_nodes() ||
+      target >= pfg->topology().num_nodes()) {
+    return galois::ErrorCode::InvalidArgument;
+  }
+
+  switch (pfg->EdgeProperty(edge_weight_property_name)->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return SsspPointToPointWithWrap<uint32_t>(
+        pfg, source, target, edge_weight_property_name, bidirectional);
+  case arrow::Int32Type::type_id:
+    return SsspPointToPointWithWrap<int32_t>(
+        pfg, source, target, edge_weight_property_name, bidirectional);
+  case arrow::UInt64Type::type_id:
+    return SsspPointToPointWithWrap<uint64_t>(
+        pfg, source, target, edge_weight_property_name, bidirectional);
+  case arrow::Int64Type::type_id:
+    return SsspPointToPointWithWrap<int64_t>(
+        pfg, source, target, edge_weight_property_name, bidirectional);
+  case arrow::FloatType::type_id:
+    return SsspPointToPointWithWrap<float>(
+        pfg, source, target, edge_weight_property_name, bidirectional);
+  case arrow::DoubleType::type_id:
+    return SsspPointToPointWithWrap<double>(
+        pfg, source, target, edge_weight_property_name, bidirectional);
+  default:
+    return galois::ErrorCode::TypeError;
+  }
+}
+
+namespace {
+
+template <typename Weight>
+using LandmarkGraph = galois::graphs::PropertyGraph<
+    std::tuple<SsspNodeDistance<Weight>>, std::tuple<>>;
+
+/// Distances in a landmark property at or above this are nodes that Sssp did
+/// not reach from the landmark
+template <typename Weight>
+constexpr Weight kLandmarkUnreached = std::numeric_limits<Weight>::max() / 4;
+
+std::string
+LandmarkPropertyName(const std::string& prefix, uint32_t i) {
+  return prefix + std::to_string(i);
+}
+
+template <typename Weight>
+galois::Result<std::vector<uint32_t>>
+SsspLandmarksWithWrap(
+    galois::graphs::PropertyFileGraph* pfg,
+    const std::string& edge_weight_property_name, uint32_t num_landmarks,
+    const std::string& output_property_prefix, LandmarkSelection selection,
+    SsspPlan plan) {
+  using Node = uint32_t;
+  // ranks nodes for the next landmark: distance to the nearest landmark,
+  // then degree, then id
+  using Candidate = std::tuple<Weight, uint64_t, Node>;
+
+  const galois::graphs::GraphTopology& topology = pfg->topology();
+  const uint64_t num_nodes = topology.num_nodes();
+  num_landmarks = std::min<uint64_t>(num_landmarks, num_nodes);
+  auto degree = [&](Node n) -> uint64_t {
+    auto [begin, end] = topology.edge_range(n);
+    return end - begin;
+  };
+
+  galois::StatTimer execTime("SSSP-Landmarks");
+  execTime.start();
+
+  std::vector<Node> by_degree;
+  if (selection == LandmarkSelection::kDegree) {
+    by_degree.resize(num_nodes);
+    std::iota(by_degree.begin(), by_degree.end(), Node{0});
+    std::partial_sort(
+        by_degree.begin(), by_degree.begin() + num_landmarks, by_degree.end(),
+        [&](Node a, Node b) {
+          return std::make_pair(degree(a), b) > std::make_pair(degree(b), a);
+        });
+  }
+
+  galois::LargeArray<Weight> nearest;
+  galois::LargeArray<uint8_t> chosen;
+  if (selection == LandmarkSelection::kFarthest) {
+    nearest.allocateBlocked(num_nodes);
+    chosen.allocateBlocked(num_nodes);
+    galois::do_all(galois::iterate(uint64_t{0}, num_nodes), [&](uint64_t n) {
+      nearest[n] = std::numeric_limits<Weight>::max();
+      chosen[n] = 0;
+    });
+  }
+
+  // folds the distances in property name into nearest and returns the node
+  // that is not a landmark yet and is farthest from all the landmarks so far
+  auto farthest = [&](const std::string& name) -> galois::Result<Node> {
+    auto graph = LandmarkGraph<Weight>::Make(pfg, {name}, {});
+    if (!graph) {
+      return graph.error();
+    }
+    auto best = galois::make_reducible(
+        [](const Candidate& a, const Candidate& b) { return std::max(a, b); },
+        []() {
+          return Candidate{std::numeric_limits<Weight>::lowest(), 0, 0};
+        });
+    galois::do_all(
+        galois::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          const Node node = n;
+          const Weight d =
+              graph.value().template GetData<SsspNodeDistance<Weight>>(node);
+          nearest[n] = std::min(nearest[n], d);
+          if (!chosen[n]) {
+            best.update(Candidate{nearest[n], degree(node), node});
+          }
+        },
+        galois::loopname("SSSP-Landmarks-Farthest"));
+    return std::get<2>(best.reduce());
+  };
+
+  std::vector<Node> landmarks;
+  auto remove_landmarks = [&]() {
+    for (uint32_t i = 0; i < landmarks.size(); ++i) {
+      if (auto r = pfg->RemoveNodeProperty(
+              LandmarkPropertyName(output_property_prefix, i));
+          !r) {
+        GALOIS_LOG_DEBUG("removing landmark {}: {}", i, r.error());
+      }
+    }
+  };
+
+  Node next = 0;
+  if (num_landmarks > 0 && selection == LandmarkSelection::kFarthest) {
+    // the farthest node from a hub is a good first landmark; its distances
+    // go in the property of landmark 0 until landmark 0 is known
+    Node hub = 0;
+    for (Node n = 1; n < num_nodes; ++n) {
+      if (degree(n) > degree(hub)) {
+        hub = n;
+      }
+    }
+    const std::string name = LandmarkPropertyName(output_property_prefix, 0);
+    if (auto r = Sssp(pfg, hub, edge_weight_property_name, name, plan); !r) {
+      return r.error();
+    }
+    auto first = farthest(name);
+    if (auto r = pfg->RemoveNodeProperty(name); !r) {
+      return r.error();
+    }
+    if (!first) {
+      return first.error();
+    }
+    next = first.value();
+    galois::do_all(galois::iterate(uint64_t{0}, num_nodes), [&](uint64_t n) {
+      nearest[n] = std::numeric_limits<Weight>::max();
+    });
+  } else if (num_landmarks > 0) {
+    next = by_degree[0];
+  }
+
+  for (uint32_t i = 0; i < num_landmarks; ++i) {
+    const std::string name = LandmarkPropertyName(output_property_prefix, i);
+    if (auto r = Sssp(pfg, next, edge_weight_property_name, name, plan); !r) {
+      remove_landmarks();
+      return r.error();
+    }
+    landmarks.emplace_back(next);
+    if (i + 1 == num_landmarks) {
+      break;
+    }
+    if (selection == LandmarkSelection::kDegree) {
+      next = by_degree[i + 1];
+      continue;
+    }
+    chosen[next] = 1;
+    auto found = farthest(name);
+    if (!found) {
+      remove_landmarks();
+      return found.error();
+    }
+    next = found.value();
+  }
+
+  execTime.stop();
+  return landmarks;
+}
+
+template <typename Weight>
+struct LandmarkSearch {
+  using Graph = PointToPointGraph<Weight>;
+  using Node = typename Graph::Node;
+  using Item = std::pair<Weight, Node>;
+  using Heap = std::priority_queue<Item, std::vector<Item>, std::greater<Item>>;
+
+  struct Label {
+    Weight dist;
+    Weight bound;
+  };
+
+  static constexpr Weight kInfinity = PointToPointSearch<Weight>::kInfinity;
+
+  const Graph& graph;
+  const std::vector<LandmarkGraph<Weight>>& landmarks;
+  Node target;
+  /// the distance from each landmark to target
+  std::vector<Weight> to_target;
+
+  LandmarkSearch(
+      const Graph& graph_, const std::vector<LandmarkGraph<Weight>>& landmarks_,
+      Node target_)
+      : graph(graph_), landmarks(landmarks_), target(target_) {
+    for (const auto& landmark : landmarks) {
+      to_target.emplace_back(
+          landmark.template GetData<SsspNodeDistance<Weight>>(target));
+    }
+  }
+
+  /// A lower bound on the distance from n to target, or kInfinity if a
+  /// landmark reaches n but not target, so target is not reachable from n
+  /// either. Landmarks that do not reach n give no bound.
+  Weight Bound(Node n) const {
+    Weight bound = 0;
+    for (size_t i = 0; i < landmarks.size(); ++i) {
+      const Weight to_n =
+          landmarks[i].template GetData<SsspNodeDistance<Weight>>(n);
+      if (to_n >= kLandmarkUnreached<Weight>) {
+        continue;
+      }
+      if (to_target[i] >= kLandmarkUnreached<Weight>) {
+        return kInfinity;
+      }
+      if (to_target[i] > to_n) {
+        bound = std::max<Weight>(bound, to_target[i] - to_n);
+      }
+    }
+    return bound;
+  }
+
+  /// A* from source: Dijkstra ordered by distance plus Bound. The bounds
+  /// are consistent, so target has its final distance when it is first
+  /// popped, as in PointToPointSearch::Unidirectional.
+  Weight Search(Node source) const {
+    std::unordered_map<Node, Label> labels;
+    Heap heap;
+    const Weight source_bound = Bound(source);
+    if (source_bound == kInfinity) {
+      return kInfinity;
+    }
+    labels.try_emplace(source, Label{0, source_bound});
+    heap.emplace(source_bound, source);
+
+    while (!heap.empty()) {
+      auto [key, n] = heap.top();
+      heap.pop();
+      const Label label = labels[n];
+      if (key > label.dist + label.bound) {
+        // empty work
+        continue;
+      }
+      if (n == target) {
+        return label.dist;
+      }
+
+      for (auto e : graph.edges(n)) {
+        const Weight new_dist =
+            label.dist + graph.template GetEdgeData<SsspEdgeWeight<Weight>>(e);
+        auto [it, inserted] =
+            labels.try_emplace(*graph.GetEdgeDest(e), Label{new_dist, 0});
+        Label& dest = it->second;
+        if (inserted) {
+          dest.bound = Bound(it->first);
+        } else {
+          if (new_dist >= dest.dist) {
+            continue;
+          }
+          dest.dist = new_dist;
+        }
+        if (dest.bound == kInfinity) {
+          continue;
+        }
+        heap.emplace(new_dist + dest.bound, it->first);
+      }
+    }
+    return kInfinity;
+  }
+};
+
+template <typename Weight>
+galois::Result<double>
+SsspPointToPointLandmarksWithWrap(
+    galois::graphs::PropertyFileGraph* pfg, size_t source, size_t target,
+    const std::string& edge_weight_property_name,
+    const std::string& landmark_property_prefix) {
+  using Search = LandmarkSearch<Weight>;
+
+  auto graph =
+      PointToPointGraph<Weight>::Make(pfg, {}, {edge_weight_property_name});
+  if (!graph) {
+    return graph.error();
+  }
+
+  std::vector<LandmarkGraph<Weight>> landmarks;
+  for (uint32_t i = 0;; ++i) {
+    const std::string name = LandmarkPropertyName(landmark_property_prefix, i);
+    if (pfg->node_schema()->GetFieldIndex(name) < 0) {
+      break;
+    }
+    auto landmark = LandmarkGraph<Weight>::Make(pfg, {name}, {});
+    if (!landmark) {
+      return landmark.error();
+    }
+    landmarks.emplace_back(std::move(landmark.value()));
+  }
+  if (landmarks.empty()) {
+    GALOIS_LOG_DEBUG("no landmark properties {}0...", landmark_property_prefix);
+    return galois::ErrorCode::PropertyNotFound;
+  }
+
+  galois::StatTimer execTime("SSSP-PointToPoint-Landmarks");
+  execTime.start();
+  Weight dist = Search(graph.value(), landmarks, target).Search(source);
+  execTime.stop();
+
+  if (dist == Search::kInfinity) {
+    return std::numeric_limits<double>::infinity();
+  }
+  return static_cast<double>(dist);
+}
+
+}  // namespace
+
+galois::Result<std::vector<uint32_t>>
+galois::analytics::SsspLandmarks(
+    graphs::PropertyFileGraph* pfg,
+    const std::string& edge_weight_property_name, uint32_t num_landmarks,
+    const std::string& output_property_prefix, LandmarkSelection selection,
+    SsspPlan plan) {
+  switch (pfg->EdgeProperty(edge_weight_property_name)->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return SsspLandmarksWithWrap<uint32_t>(
+        pfg, edge_weight_property_name, num_landmarks, output_property_prefix,
+        selection, plan);
+  case arrow::Int32Type::type_id:
+    return SsspLandmarksWithWrap<int32_t>(
+        pfg, edge_weight_property_name, num_landmarks, output_property_prefix,
+        selection, plan);
+  case arrow::UInt64Type::type_id:
+    return SsspLandmarksWithWrap<uint64_t>(
+        pfg, edge_weight_property_name, num_landmarks, output_property_prefix,
+        selection, plan);
+  case arrow::Int64Type::type_id:
+    return SsspLandmarksWithWrap<int64_t>(
+        pfg, edge_weight_property_name, num_landmarks, output_property_prefix,
+        selection, plan);
+  case arrow::FloatType::type_id:
+    return SsspLandmarksWithWrap<float>(
+        pfg, edge_weight_property_name, num_landmarks, output_property_prefix,
+        selection, plan);
+  case arrow::DoubleType::type_id:
+    return SsspLandmarksWithWrap<double>(
+        pfg, edge_weight_property_name, num_landmarks, output_property_prefix,
+        selection, plan);
+  default:
+    return galois::ErrorCode::TypeError;
+  }
+}
+
+galois::Result<double>
+galois::analytics::SsspPointToPointLandmarks(
+    graphs::PropertyFileGraph* pfg, size_t source, size_t target,
+    const std::string& edge_weight_property_name,
+    const std::string& landmark_property_prefix) {
+  if (source >= pfg->topology().num_nodes() ||
+      target >= pfg->topology().num_nodes()) {
+    return galois::ErrorCode::InvalidArgument;
+  }
+
+  switch (pfg->EdgeProperty(edge_weight_property_name)->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return SsspPointToPointLandmarksWithWrap<uint32_t>(
+        pfg, source, target, edge_weight_property_name,
+        landmark_property_prefix);
+  case arrow::Int32Type::type_id:
+    return SsspPointToPointLandmarksWithWrap<int32_t>(
+        pfg, source, target, edge_weight_property_name,
+        landmark_property_prefix);
+  case arrow::UInt64Type::type_id:
+    return SsspPointToPointLandmarksWithWrap<uint64_t>(
+        pfg, source, target, edge_weight_property_name,
+        landmark_property_prefix);
+  case arrow::Int64Type::type_id:
+    return SsspPointToPointLandmarksWithWrap<int64_t>(
+        pfg, source, target, edge_weight_property_name,
+        landmark_property_prefix);
+  case arrow::FloatType::type_id:
+    return SsspPointToPointLandmarksWithWrap<float>(
+        pfg, source, target, edge_weight_property_name,
+        landmark_property_prefix);
+  case arrow::DoubleType::type_id:
+    return SsspPointToPointLandmarksWithWrap<double>(
+        pfg, source, target, edge_weight_property_name,
+        landmark_property_prefix);
+  default:
+    return galois::ErrorCode::TypeError;
+  }
+}
@@ -0,0 +1,724 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/analytics/triangle_count/triangle_count.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iterator>
+#include <random>
+
+#include "galois/Bag.h"
+#include "galois/Galois.h"
+#include "galois/Intersection.h"
+#include "galois/LargeArray.h"
+#include "galois/ParallelSTL.h"
+#include "galois/Reduction.h"
+#include "galois/runtime/Profile.h"
+
+using namespace galois::analytics;
+
+namespace {
+
+using Graph = galois::graphs::PropertyGraph<std::tuple<>, std::tuple<>>;
+using GNode = Graph::Node;
+
+constexpr unsigned kChunkSize = 64U;
+
+/// Per-node triangle counts; algorithms take nullptr when only the total is
+/// needed
+using NodeCounts = galois::LargeArray<std::atomic<uint64_t>>;
+
+void
+AddTriangle(NodeCounts* counts, GNode a, GNode b, GNode c) {
+  (*counts)[a].fetch_add(1, std::memory_order_relaxed);
+  (*counts)[b].fetch_add(1, std::memory_order_relaxed);
+  (*counts)[c].fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * Like std::lower_bound but doesn't dereference iterators. Returns the first
+ * element for which comp is not true.
+ */
+template <typename Iterator, typename Compare>
+Iterator
+LowerBound(Iterator first, Iterator last, Compare comp) {
+  using difference_type =
+      typename std::iterator_traits<Iterator>::difference_type;
+
+  Iterator it;
+  difference_type count;
+  difference_type half;
+
+  count = std::distance(first, last);
+  while (count > 0) {
+    it = first;
+    half = count / 2;
+    std::advance(it, half);
+    if (comp(it)) {
+      first = ++it;
+      count -= half + 1;
+    } else {
+      count = half;
+    }
+  }
+  return first;
+}
+
+struct LessThan {
+  const Graph& g;
+  GNode n;
+  LessThan(const Graph& g, GNode n) : g(g), n(n) {}
+  bool operator()(Graph::edge_iterator it) { return *g.GetEdgeDest(it) < n; }
+};
+
+struct GreaterThanOrEqual {
+  const Graph& g;
+  GNode n;
+  GreaterThanOrEqual(const Graph& g, GNode n) : g(g), n(n) {}
+  bool operator()(Graph::edge_iterator it) {
+    return !(n < *g.GetEdgeDest(it));
+  }
+};
+
+/**
+ * Node Iterator algorithm for counting triangles.
+ * <code>
+ * for (v in G)
+ *   for (all pairs of neighbors (a, b) of v)
+ *     if ((a,b) in G and a < v < b)
+ *       triangle += 1
+ * </code>
+ *
+ * Thomas Schank. Algorithmic Aspects of Triangle-Based Network Analysis. PhD
+ * Thesis. Universitat Karlsruhe. 2007.
+ */
+uint64_t
+NodeIteratingAlgo(const Graph& graph, NodeCounts* counts) {
+  galois::GAccumulator<uint64_t> numTriangles;
+
+  //! [profile w/ vtune]
+  galois::runtime::profileVtune(
+      [&]() {
+        galois::do_all(
+            galois::iterate(graph),
+            [&](const GNode& n) {
+              // Partition neighbors
+              // [first, ea) [n] [bb, last)
+              Graph::edge_iterator first = graph.edge_begin(n);
+              Graph::edge_iterator last = graph.edge_end(n);
+              Graph::edge_iterator ea =
+                  LowerBound(first, last, LessThan(graph, n));
+              Graph::edge_iterator bb =
+                  LowerBound(first, last, GreaterThanOrEqual(graph, n));
+
+              for (; bb != last; ++bb) {
+                GNode B = *graph.GetEdgeDest(bb);
+                for (auto aa = first; aa != ea; ++aa) {
+                  GNode A = *graph.GetEdgeDest(aa);
+                  Graph::edge_iterator vv = graph.edge_begin(A);
+                  Graph::edge_iterator ev = graph.edge_end(A);
+                  Graph::edge_iterator it =
+                      LowerBound(vv, ev, LessThan(graph, B));
+                  if (it != ev && *graph.GetEdgeDest(it) == B) {
+                    numTriangles += 1;
+                    if (counts) {
+                      AddTriangle(counts, A, n, B);
+                    }
+                  }
+                }
+              }
+            },
+            galois::chunk_size<kChunkSize>(), galois::steal(),
+            galois::loopname("NodeIteratingAlgo"));
+      },
+      "nodeIteratorAlgo");
+  //! [profile w/ vtune]
+
+  return numTriangles.reduce();
+}
+
+/*
+ * Simple counting loop, instead of binary searching.
+ */
+uint64_t
+OrderedCountAlgo(const Graph& graph, NodeCounts* counts) {
+  galois::GAccumulator<uint64_t> numTriangles;
+  galois::do_all(
+      galois::iterate(graph),
+      [&](const GNode& n) {
+        uint64_t numTriangles_local = 0;
+        for (auto it_v : graph.edges(n)) {
+          auto v = *graph.GetEdgeDest(it_v);
+          if (v > n)
+            break;
+          Graph::edge_iterator it_n = graph.edge_begin(n);
+
+          for (auto it_vv : graph.edges(v)) {
+            auto vv = *graph.GetEdgeDest(it_vv);
+            if (vv > v)
+              break;
+            while (*graph.GetEdgeDest(it_n) < vv)
+              it_n++;
+            if (vv == *graph.GetEdgeDest(it_n)) {
+              numTriangles_local += 1;
+              if (counts) {
+                AddTriangle(counts, vv, v, n);
+              }
+            }
+          }
+        }
+        numTriangles += numTriangles_local;
+      },
+      galois::chunk_size<kChunkSize>(), galois::steal(),
+      galois::loopname("OrderedCountAlgo"));
+
+  return numTriangles.reduce();
+}
+
+/**
+ * Edge Iterator algorithm for counting triangles.
+ * <code>
+ * for ((a, b) in E)
+ *   if (a < b)
+ *     for (v in intersect(neighbors(a), neighbors(b)))
+ *       if (a < v < b)
+ *         triangle += 1
+ * </code>
+ *
+ * Thomas Schank. Algorithmic Aspects of Triangle-Based Network Analysis. PhD
+ * Thesis. Universitat Karlsruhe. 2007.
+ */
+uint64_t
+EdgeIteratingAlgo(const Graph& graph, NodeCounts* counts) {
+  struct WorkItem {
+    GNode src;
+    GNode dst;
+    WorkItem(const GNode& a1, const GNode& a2) : src(a1), dst(a2) {}
+  };
+
+  galois::InsertBag<WorkItem> items;
+  galois::GAccumulator<uint64_t> numTriangles;
+  const uint32_t* dests =
+      graph.GetPropertyFileGraph().topology().out_dests->raw_values();
+
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) {
+        for (auto edge : graph.edges(n)) {
+          auto dest = graph.GetEdgeDest(edge);
+          if (n < *dest)
+            items.push(WorkItem(n, *dest));
+        }
+      },
+      galois::loopname("Initialize"));
+
+  //! [profile w/ papi]
+  galois::runtime::profilePapi(
+      [&]() {
+        galois::do_all(
+            galois::iterate(items),
+            [&](const WorkItem& w) {
+              // Compute intersection of range (w.src, w.dst) in neighbors of
+              // w.src and w.dst
+              Graph::edge_iterator abegin = graph.edge_begin(w.src);
+              Graph::edge_iterator aend = graph.edge_end(w.src);
+              Graph::edge_iterator bbegin = graph.edge_begin(w.dst);
+              Graph::edge_iterator bend = graph.edge_end(w.dst);
+
+              Graph::edge_iterator aa =
+                  LowerBound(abegin, aend, GreaterThanOrEqual(graph, w.src));
+              Graph::edge_iterator ea =
+                  LowerBound(abegin, aend, LessThan(graph, w.dst));
+              Graph::edge_iterator bb =
+                  LowerBound(bbegin, bend, GreaterThanOrEqual(graph, w.src));
+              Graph::edge_iterator eb =
+                  LowerBound(bbegin, bend, LessThan(graph, w.dst));
+
+              if (!counts) {
+                numTriangles += graph.CountCommonDests(aa, ea, bb, eb);
+                return;
+              }
+              galois::ForEachSortedIntersection(
+                  dests + *aa, *ea - *aa, dests + *bb, *eb - *bb,
+                  [&](size_t i, size_t) {
+                    numTriangles += 1;
+                    AddTriangle(counts, w.src, dests[*aa + i], w.dst);
+                  });
+            },
+            galois::loopname("EdgeIteratingAlgo"),
+            galois::chunk_size<kChunkSize>(), galois::steal());
+      },
+      "edgeIteratorAlgo");
+  //! [profile w/ papi]
+
+  return numTriangles.reduce();
+}
+
+/// The undirected edges of a graph, each oriented from its endpoint of
+/// smaller degree to the one of larger degree, ties broken by node id. The
+/// out-neighbors of node n are dests[begin[n], end[n]), strictly increasing.
+struct DegreeOrderedDag {
+  galois::LargeArray<uint64_t> begin;
+  galois::LargeArray<uint64_t> end;
+  galois::LargeArray<uint32_t> dests;
+
+  const uint32_t* out_neighbors(GNode n) const {
+    return dests.data() + begin[n];
+  }
+  size_t out_degree(GNode n) const { return end[n] - begin[n]; }
+};
+
+void
+BuildDegreeOrderedDag(const Graph& graph, DegreeOrderedDag* dag) {
+  uint64_t num_nodes = graph.num_nodes();
+  auto degree = [&](GNode n) {
+    return std::distance(graph.edge_begin(n), graph.edge_end(n));
+  };
+  auto precedes = [&](GNode a, GNode b) {
+    auto a_degree = degree(a);
+    auto b_degree = degree(b);
+    return a_degree < b_degree || (a_degree == b_degree && a < b);
+  };
+
+  // Both directions of a symmetric edge land in the list of its smaller
+  // endpoint; the duplicates are dropped after sorting
+  galois::LargeArray<std::atomic<uint64_t>> cursor;
+  cursor.allocateBlocked(num_nodes);
+  galois::do_all(
+      galois::iterate(graph), [&](GNode n) { cursor.constructAt(n, 0); },
+      galois::no_stats());
+
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) {
+        for (auto e : graph.edges(n)) {
+          GNode dest = *graph.GetEdgeDest(e);
+          if (dest == n) {
+            continue;
+          }
+          GNode lower = precedes(n, dest) ? n : dest;
+          cursor[lower].fetch_add(1, std::memory_order_relaxed);
+        }
+      },
+      galois::steal(), galois::loopname("TriangleCount-DAG-Degrees"));
+
+  dag->begin.allocateBlocked(num_nodes + 1);
+  dag->end.allocateBlocked(num_nodes);
+  dag->begin[0] = 0;
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) {
+        dag->begin[n + 1] = cursor[n].load(std::memory_order_relaxed);
+      },
+      galois::no_stats());
+  galois::ParallelSTL::partial_sum(
+      dag->begin.begin(), dag->begin.end(), dag->begin.begin());
+
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) {
+        cursor[n].store(dag->begin[n], std::memory_order_relaxed);
+      },
+      galois::no_stats());
+
+  dag->dests.allocateBlocked(dag->begin[num_nodes]);
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) {
+        for (auto e : graph.edges(n)) {
+          GNode dest = *graph.GetEdgeDest(e);
+          if (dest == n) {
+            continue;
+          }
+          GNode lower = n;
+          GNode upper = dest;
+          if (!precedes(n, dest)) {
+            std::swap(lower, upper);
+          }
+          dag->dests[cursor[lower].fetch_add(1, std::memory_order_relaxed)] =
+              upper;
+        }
+      },
+      galois::steal(), galois::loopname("TriangleCount-DAG-Fill"));
+
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) {
+        uint32_t* first = dag->dests.data() + dag->begin[n];
+        uint32_t* last = dag->dests.data() + dag->begin[n + 1];
+        std::sort(first, last);
+        dag->end[n] = std::unique(first, last) - dag->dests.data();
+      },
+      galois::steal(), galois::loopname("TriangleCount-DAG-Sort"));
+}
+
+/// Each triangle u < v < w in the order of the DAG is counted once, at the
+/// edge (u, v), as the common out-neighbor w of u and v
+uint64_t
+DegreeOrderedDagAlgo(const DegreeOrderedDag& dag, NodeCounts* counts) {
+  galois::GAccumulator<uint64_t> numTriangles;
+  uint64_t num_nodes = dag.end.size();
+
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_nodes),
+      [&](GNode u) {
+        const uint32_t* u_out = dag.out_neighbors(u);
+        size_t u_degree = dag.out_degree(u);
+        uint64_t numTriangles_local = 0;
+        for (size_t i = 0; i < u_degree; ++i) {
+          GNode v = u_out[i];
+          const uint32_t* v_out = dag.out_neighbors(v);
+          size_t v_degree = dag.out_degree(v);
+          if (!counts) {
+            numTriangles_local += galois::CountSortedIntersection(
+                u_out, u_degree, v_out, v_degree);
+            continue;
+          }
+          galois::ForEachSortedIntersection(
+              u_out, u_degree, v_out, v_degree, [&](size_t j, size_t) {
+                numTriangles_local += 1;
+                AddTriangle(counts, u, v, u_out[j]);
+              });
+        }
+        numTriangles += numTriangles_local;
+      },
+      galois::chunk_size<kChunkSize>(), galois::steal(),
+      galois::loopname("DegreeOrderedDagAlgo"));
+
+  return numTriangles.reduce();
+}
+
+/// Count the triangles of graph with plan, per node into counts unless it is
+/// nullptr. Unless degrees is nullptr, also store the number of distinct
+/// neighbors of each node other than itself in it.
+galois::Result<uint64_t>
+CountTriangles(
+    const Graph& graph, TriangleCountPlan plan, NodeCounts* counts,
+    galois::LargeArray<uint64_t>* degrees) {
+  uint64_t num_nodes = graph.num_nodes();
+  if (plan.algorithm() != TriangleCountPlan::kDegreeOrderedDag &&
+      !graph.GetPropertyFileGraph().topology().edges_sorted_by_dest) {
+    GALOIS_LOG_DEBUG("triangle counting requires edges sorted by destination");
+    return galois::ErrorCode::InvalidArgument;
+  }
+
+  if (counts) {
+    counts->allocateBlocked(num_nodes);
+    galois::do_all(
+        galois::iterate(graph), [&](GNode n) { counts->constructAt(n, 0); },
+        galois::no_stats());
+  }
+  if (degrees) {
+    degrees->allocateBlocked(num_nodes);
+  }
+  if (num_nodes == 0) {
+    return uint64_t{0};
+  }
+
+  galois::StatTimer execTime("TriangleCount");
+
+  uint64_t total = 0;
+  switch (plan.algorithm()) {
+  case TriangleCountPlan::kNodeIteration:
+    execTime.start();
+    total = NodeIteratingAlgo(graph, counts);
+    execTime.stop();
+    break;
+  case TriangleCountPlan::kEdgeIteration:
+    execTime.start();
+    total = EdgeIteratingAlgo(graph, counts);
+    execTime.stop();
+    break;
+  case TriangleCountPlan::kOrderedCount:
+    execTime.start();
+    total = OrderedCountAlgo(graph, counts);
+    execTime.stop();
+    break;
+  case TriangleCountPlan::kDegreeOrderedDag: {
+    DegreeOrderedDag dag;
+    execTime.start();
+    BuildDegreeOrderedDag(graph, &dag);
+    total = DegreeOrderedDagAlgo(dag, counts);
+    execTime.stop();
+
+    if (degrees) {
+      // Every undirected edge is out of exactly one of its endpoints
+      galois::LargeArray<std::atomic<uint64_t>> in_degrees;
+      in_degrees.allocateBlocked(num_nodes);
+      galois::do_all(
+          galois::iterate(graph),
+          [&](GNode n) { in_degrees.constructAt(n, 0); }, galois::no_stats());
+      galois::do_all(
+          galois::iterate(graph),
+          [&](GNode n) {
+            const uint32_t* out = dag.out_neighbors(n);
+            for (size_t i = 0, end = dag.out_degree(n); i < end; ++i) {
+              in_degrees[out[i]].fetch_add(1, std::memory_order_relaxed);
+            }
+          },
+          galois::steal(), galois::no_stats());
+      galois::do_all(
+          galois::iterate(graph),
+          [&](GNode n) {
+            (*degrees)[n] = dag.out_degree(n) +
+                            in_degrees[n].load(std::memory_order_relaxed);
+          },
+          galois::no_stats());
+    }
+    return total;
+  }
+  default:
+    return galois::ErrorCode::InvalidArgument;
+  }
+
+  if (degrees) {
+    galois::do_all(
+        galois::iterate(graph),
+        [&](GNode n) {
+          (*degrees)[n] =
+              std::distance(graph.edge_begin(n), graph.edge_end(n));
+        },
+        galois::no_stats());
+  }
+  return total;
+}
+
+}  // namespace
+
+galois::Result<uint64_t>
+galois::analytics::TriangleCount(
+    graphs::PropertyFileGraph* pfg, TriangleCountPlan plan) {
+  auto pg_result = Graph::Make(pfg, {}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+
+  return CountTriangles(pg_result.value(), plan, nullptr, nullptr);
+}
+
+galois::Result<uint64_t>
+galois::analytics::TriangleCount(
+    graphs::PropertyFileGraph* pfg, const std::string& output_property_name,
+    TriangleCountPlan plan) {
+  auto pg_result = Graph::Make(pfg, {}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+
+  NodeCounts counts;
+  auto count_result =
+      CountTriangles(pg_result.value(), plan, &counts, nullptr);
+  if (!count_result) {
+    return count_result.error();
+  }
+
+  if (auto result =
+          ConstructNodeProperties<std::tuple<TriangleCountNodeCount>>(
+              pfg, {output_property_name});
+      !result) {
+    return result.error();
+  }
+
+  using OutputGraph = galois::graphs::PropertyGraph<
+      std::tuple<TriangleCountNodeCount>, std::tuple<>>;
+  auto output_result = OutputGraph::Make(pfg, {output_property_name}, {});
+  if (!output_result) {
+    return output_result.error();
+  }
+  OutputGraph output = output_result.value();
+
+  galois::do_all(
+      galois::iterate(output),
+      [&](const OutputGraph::Node& n) {
+        output.GetData<TriangleCountNodeCount>(n) =
+            counts[n].load(std::memory_order_relaxed);
+      },
+      galois::loopname("TriangleCount-WriteCounts"));
+
+  return count_result.value();
+}
+
+galois::Result<void>
+galois::analytics::LocalClusteringCoefficient(
+    graphs::PropertyFileGraph* pfg, const std::string& output_property_name,
+    TriangleCountPlan plan) {
+  auto pg_result = Graph::Make(pfg, {}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+
+  NodeCounts counts;
+  galois::LargeArray<uint64_t> degrees;
+  if (auto result = CountTriangles(pg_result.value(), plan, &counts, &degrees);
+      !result) {
+    return result.error();
+  }
+
+  if (auto result = ConstructNodeProperties<
+          std::tuple<LocalClusteringCoefficientNodeValue>>(
+          pfg, {output_property_name});
+      !result) {
+    return result.error();
+  }
+
+  using OutputGraph = galois::graphs::PropertyGraph<
+      std::tuple<LocalClusteringCoefficientNodeValue>, std::tuple<>>;
+  auto output_result = OutputGraph::Make(pfg, {output_property_name}, {});
+  if (!output_result) {
+    return output_result.error();
+  }
+  OutputGraph output = output_result.value();
+
+  galois::do_all(
+      galois::iterate(output),
+      [&](const OutputGraph::Node& n) {
+        double degree = degrees[n];
+        double pairs = degree * (degree - 1) / 2;
+        output.GetData<LocalClusteringCoefficientNodeValue>(n) =
+            pairs > 0 ? counts[n].load(std::memory_order_relaxed) / pairs : 0;
+      },
+      galois::loopname("LocalClusteringCoefficient"));
+
+  return galois::ResultSuccess();
+}
+
+namespace {
+
+/// Samples are drawn in blocks with a generator seeded by the block index
+constexpr uint64_t kSampleBlockSize = 1024;
+
+void
+ReportEstimate(const TriangleCountEstimate& estimate, uint64_t num_samples) {
+  galois::ReportStatSingle(
+      "TriangleCountEstimate", "Estimate", estimate.estimate);
+  galois::ReportStatSingle(
+      "TriangleCountEstimate", "LowerBound", estimate.lower_bound);
+  galois::ReportStatSingle(
+      "TriangleCountEstimate", "UpperBound", estimate.upper_bound);
+  galois::ReportStatSingle("TriangleCountEstimate", "Samples", num_samples);
+}
+
+}  // namespace
+
+galois::Result<TriangleCountEstimate>
+galois::analytics::EstimateTriangleCount(
+    graphs::PropertyFileGraph* pfg, uint64_t num_samples, double confidence,
+    uint64_t seed) {
+  if (num_samples == 0 || !(confidence > 0 && confidence < 1)) {
+    return galois::ErrorCode::InvalidArgument;
+  }
+
+  auto pg_result = Graph::Make(pfg, {}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  const Graph& graph = pg_result.value();
+  uint64_t num_nodes = graph.num_nodes();
+
+  galois::StatTimer execTime("TriangleCountEstimate");
+  execTime.start();
+
+  auto degree = [&](GNode n) -> uint64_t {
+    return *graph.edge_end(n) - *graph.edge_begin(n);
+  };
+
+  // wedges[n] is the number of wedges centered at nodes up to n
+  galois::LargeArray<uint64_t> wedges;
+  wedges.allocateBlocked(num_nodes);
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) {
+        uint64_t d = degree(n);
+        wedges[n] = d < 2 ? 0 : d * (d - 1) / 2;
+      },
+      galois::no_stats());
+  galois::ParallelSTL::partial_sum(
+      wedges.begin(), wedges.end(), wedges.begin());
+
+  uint64_t num_wedges = num_nodes == 0 ? 0 : wedges[num_nodes - 1];
+  if (num_wedges == 0) {
+    execTime.stop();
+    TriangleCountEstimate estimate{0, 0, 0};
+    ReportEstimate(estimate, num_samples);
+    return estimate;
+  }
+
+  const uint32_t* dests = pfg->topology().out_dests->raw_values();
+  bool sorted = pfg->topology().edges_sorted_by_dest;
+  auto adjacent = [&](GNode a, GNode b) {
+    // pfg is symmetric, so the shorter list suffices
+    if (degree(a) > degree(b)) {
+      std::swap(a, b);
+    }
+    const uint32_t* first = dests + *graph.edge_begin(a);
+    const uint32_t* last = dests + *graph.edge_end(a);
+    if (sorted) {
+      return std::binary_search(first, last, b);
+    }
+    return std::find(first, last, b) != last;
+  };
+
+  galois::GAccumulator<uint64_t> closed;
+  uint64_t num_blocks = (num_samples + kSampleBlockSize - 1) / kSampleBlockSize;
+
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t block) {
+        std::seed_seq seq{
+            static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32),
+            static_cast<uint32_t>(block), static_cast<uint32_t>(block >> 32)};
+        std::mt19937_64 gen(seq);
+        std::uniform_int_distribution<uint64_t> pick_wedge(0, num_wedges - 1);
+
+        uint64_t end = std::min(num_samples, (block + 1) * kSampleBlockSize);
+        uint64_t closed_local = 0;
+        for (uint64_t i = block * kSampleBlockSize; i < end; ++i) {
+          // the first node whose prefix exceeds the wedge is its center
+          GNode center =
+              std::upper_bound(wedges.begin(), wedges.end(), pick_wedge(gen)) -
+              wedges.begin();
+          uint64_t first_edge = *graph.edge_begin(center);
+          uint64_t d = degree(center);
+          uint64_t x = std::uniform_int_distribution<uint64_t>(0, d - 1)(gen);
+          uint64_t y = std::uniform_int_distribution<uint64_t>(0, d - 2)(gen);
+          y += y >= x;
+          closed_local +=
+              adjacent(dests[first_edge + x], dests[first_edge + y]);
+        }
+        closed += closed_local;
+      },
+      galois::steal(), galois::loopname("TriangleCountEstimate-Sample"));
+
+  execTime.stop();
+
+  // Each triangle closes three wedges
+  double scale = static_cast<double>(num_wedges) / 3;
+  double closed_fraction = static_cast<double>(closed.reduce()) / num_samples;
+  double error =
+      std::sqrt(std::log(2 / (1 - confidence)) / (2.0 * num_samples));
+
+  TriangleCountEstimate estimate{
+      closed_fraction * scale,
+      std::max(closed_fraction - error, 0.0) * scale,
+      std::min(closed_fraction + error, 1.0) * scale};
+  ReportEstimate(estimate, num_samples);
+  return estimate;
+}
@@ -0,0 +1,65 @@
+#include <atomic>
+#include <vector>
+
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/Reduction.h"
+#include "galois/worklists/AdaptiveChunk.h"
+
+namespace {
+
+/// Expand every item below depth into two children, so that the threads push
+/// and pop chunks concurrently and the chunk size has a reason to change
+template <typename WL>
+void
+TestBinaryTree(uint32_t depth) {
+  galois::GAccumulator<uint64_t> visited;
+  std::vector<uint32_t> roots{0};
+
+  galois::for_each(
+      galois::iterate(roots),
+      [&](uint32_t level, auto& ctx) {
+        visited += 1;
+        if (level < depth) {
+          ctx.push(level + 1);
+          ctx.push(level + 1);
+        }
+      },
+      galois::wl<WL>(), galois::loopname("AdaptiveChunkBinaryTree"));
+
+  GALOIS_LOG_ASSERT(visited.reduce() == (uint64_t{2} << depth) - 1);
+}
+
+/// Every initial item is popped exactly once
+template <typename WL>
+void
+TestInitialRange(uint32_t num_items) {
+  std::vector<std::atomic<uint32_t>> counts(num_items);
+
+  galois::for_each(
+      galois::iterate(uint32_t{0}, num_items),
+      [&](uint32_t i, auto&) { counts[i] += 1; }, galois::wl<WL>(),
+      galois::no_stats());
+
+  for (const auto& count : counts) {
+    GALOIS_LOG_ASSERT(count == 1);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(
+      galois::substrate::GetThreadPool().getMaxUsableThreads());
+
+  using WL = galois::worklists::AdaptiveChunk<>;
+  TestBinaryTree<WL>(16);
+  TestInitialRange<WL>(100000);
+  // a fixed size of one item per chunk maximizes queue operations
+  TestBinaryTree<WL::with_chunk_size<1>>(16);
+  TestInitialRange<WL::with_chunk_size<1>>(100000);
+
+  return 0;
+}
@@ -0,0 +1,103 @@
+#include <atomic>
+#include <vector>
+
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/Reduction.h"
+#include "galois/worklists/AdaptiveObim.h"
+
+namespace {
+
+struct Identity {
+  uint32_t operator()(uint32_t x) const { return x; }
+};
+
+struct Zero {
+  uint32_t operator()(uint32_t) const { return 0; }
+};
+
+/// Expand every item below depth into two children of the next priority
+void
+TestBinaryTree(uint32_t depth) {
+  using WL = galois::worklists::AdaptiveOrderedByIntegerMetric<Identity>;
+  galois::GAccumulator<uint64_t> visited;
+  std::vector<uint32_t> roots{0};
+
+  galois::for_each(
+      galois::iterate(roots),
+      [&](uint32_t level, auto& ctx) {
+        visited += 1;
+        if (level < depth) {
+          ctx.push(level + 1);
+          ctx.push(level + 1);
+        }
+      },
+      galois::wl<WL>(), galois::loopname("AdaptiveObimBinaryTree"));
+
+  GALOIS_LOG_ASSERT(visited.reduce() == (uint64_t{2} << depth) - 1);
+}
+
+/// Every initial item is popped exactly once
+void
+TestInitialRange(uint32_t num_items) {
+  using WL = galois::worklists::AdaptiveOrderedByIntegerMetric<Identity>;
+  std::vector<std::atomic<uint32_t>> counts(num_items);
+
+  galois::for_each(
+      galois::iterate(uint32_t{0}, num_items),
+      [&](uint32_t i, auto&) { counts[i] += 1; }, galois::wl<WL>(Identity{}, 4),
+      galois::no_stats());
+
+  for (const auto& count : counts) {
+    GALOIS_LOG_ASSERT(count == 1);
+  }
+}
+
+/// Pops all the items of wl from the calling thread
+template <typename WL>
+uint32_t
+Drain(WL* wl) {
+  uint32_t num_popped = 0;
+  while (wl->pop()) {
+    ++num_popped;
+  }
+  return num_popped;
+}
+
+/// Buckets of one item merge, and a single large bucket splits
+void
+TestAdapt(uint32_t num_items) {
+  using WL = galois::worklists::AdaptiveOrderedByIntegerMetric<
+      Identity>::retype<uint32_t>;
+  WL merging;
+  for (uint32_t i = 0; i < num_items; ++i) {
+    merging.push(i);
+  }
+  GALOIS_LOG_ASSERT(Drain(&merging) == num_items);
+  GALOIS_LOG_ASSERT(merging.bucket_shift() > 0);
+
+  using SplitWL =
+      galois::worklists::AdaptiveOrderedByIntegerMetric<Zero>::retype<uint32_t>;
+  SplitWL splitting(Zero{}, 8);
+  for (uint32_t i = 0; i < num_items; ++i) {
+    splitting.push(i);
+  }
+  GALOIS_LOG_ASSERT(Drain(&splitting) == num_items);
+  GALOIS_LOG_ASSERT(splitting.bucket_shift() < 8);
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+
+  TestAdapt(1 << 16);
+
+  galois::setActiveThreads(
+      galois::substrate::GetThreadPool().getMaxUsableThreads());
+  TestBinaryTree(16);
+  TestInitialRange(100000);
+
+  return 0;
+}
@@ -0,0 +1,67 @@
+#include <arrow/api.h>
+
+#include "galois/ArrowRandomAccessBuilder.h"
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+
+namespace {
+
+constexpr size_t kLength = 100003;
+
+/// Sets values at the indices that are not multiples of 3 from a parallel
+/// loop; the others stay null
+template <typename ArrowType, typename ValueFn>
+void
+TestConcurrentBuilder(const ValueFn& value_of) {
+  using Builder = galois::ConcurrentArrowRandomAccessBuilder<ArrowType>;
+  using ArrayType = typename arrow::TypeTraits<ArrowType>::ArrayType;
+
+  auto make_result = Builder::Make(kLength);
+  GALOIS_LOG_VASSERT(make_result, "{}", make_result.error());
+  std::unique_ptr<Builder> builder = std::move(make_result.value());
+  GALOIS_LOG_ASSERT(builder->size() == kLength);
+
+  galois::do_all(
+      galois::iterate(size_t{0}, kLength),
+      [&](size_t i) {
+        if (i % 3 != 0) {
+          builder->SetValue(i, value_of(i));
+        }
+      },
+      galois::steal());
+  GALOIS_LOG_ASSERT(builder->IsValid(1) && !builder->IsValid(3));
+
+  auto finalize_result = builder->Finalize();
+  GALOIS_LOG_VASSERT(finalize_result, "{}", finalize_result.error());
+  auto array = std::static_pointer_cast<ArrayType>(finalize_result.value());
+  GALOIS_LOG_ASSERT(array->ValidateFull().ok());
+  GALOIS_LOG_ASSERT(static_cast<size_t>(array->length()) == kLength);
+  GALOIS_LOG_ASSERT(
+      static_cast<size_t>(array->null_count()) == (kLength + 2) / 3);
+  for (size_t i = 0; i < kLength; ++i) {
+    if (i % 3 == 0) {
+      GALOIS_LOG_ASSERT(array->IsNull(i));
+    } else {
+      GALOIS_LOG_ASSERT(array->IsValid(i) && array->Value(i) == value_of(i));
+    }
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(
+      galois::substrate::GetThreadPool().getMaxUsableThreads());
+
+  TestConcurrentBuilder<arrow::UInt32Type>(
+      [](size_t i) { return static_cast<uint32_t>(i * 7); });
+  TestConcurrentBuilder<arrow::DoubleType>(
+      [](size_t i) { return static_cast<double>(i) / 2; });
+  // neighboring values share the bytes of a boolean array
+  TestConcurrentBuilder<arrow::BooleanType>(
+      [](size_t i) { return i % 5 < 2; });
+
+  return 0;
+}
@@ -0,0 +1,94 @@
+#include <chrono>
+#include <thread>
+
+#include <arrow/api.h>
+
+#include "TestPropertyGraph.h"
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/analytics/Async.h"
+#include "galois/analytics/bfs/bfs.h"
+#include "galois/analytics/sssp/sssp.h"
+
+namespace {
+
+constexpr uint64_t kItems = 1000;
+
+/// A call that runs rounds of parallel loops until it is cancelled
+void
+TestCancel() {
+  auto handle = galois::analytics::RunAsync<uint64_t>(
+      []() -> galois::Result<uint64_t> {
+        uint64_t rounds = 0;
+        do {
+          galois::GAccumulator<uint64_t> sum;
+          galois::do_all(
+              galois::iterate(uint64_t{0}, kItems),
+              [&](uint64_t i) { sum += i; });
+          GALOIS_LOG_ASSERT(sum.reduce() == kItems * (kItems - 1) / 2);
+          ++rounds;
+        } while (!galois::analytics::internal::EndRound(kItems));
+        return rounds;
+      });
+
+  while (handle.rounds() < 3) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  handle.Cancel();
+
+  auto result = handle.Wait();
+  GALOIS_LOG_ASSERT(!result);
+  GALOIS_LOG_ASSERT(result.error() == galois::ErrorCode::Cancelled);
+  GALOIS_LOG_ASSERT(handle.rounds() >= 3);
+  GALOIS_LOG_ASSERT(handle.work_items() == handle.rounds() * kItems);
+}
+
+/// BFS and SSSP on a cycle run to the end and report every level
+void
+TestBfsSssp() {
+  constexpr uint32_t kNumNodes = 100;
+  LinePolicy policy{1};
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g =
+      MakeFileGraph<uint32_t>(kNumNodes, 1, &policy);
+
+  auto bfs = galois::analytics::BfsAsync(
+      g.get(), 0, "level", galois::analytics::BfsPlan::Sync());
+  auto bfs_result = bfs.Wait();
+  GALOIS_LOG_VASSERT(bfs_result, "{}", bfs_result.error());
+  GALOIS_LOG_ASSERT(bfs.Ready());
+  // one level per node, then one that reaches nothing
+  GALOIS_LOG_ASSERT(bfs.rounds() == kNumNodes);
+  GALOIS_LOG_ASSERT(bfs.work_items() == kNumNodes - 1);
+
+  auto levels = std::static_pointer_cast<arrow::UInt32Array>(
+      g->NodeProperty("level")->chunk(0));
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    GALOIS_LOG_ASSERT(levels->Value(n) == n);
+  }
+
+  auto sssp = galois::analytics::SsspAsync(
+      g.get(), 0, g->edge_schema()->field(0)->name(), "distance",
+      galois::analytics::SsspPlan::Topo());
+  auto sssp_result = sssp.Wait();
+  GALOIS_LOG_VASSERT(sssp_result, "{}", sssp_result.error());
+  GALOIS_LOG_ASSERT(sssp.rounds() > 0);
+
+  // the loops of the caller run again once the calls are done
+  galois::GAccumulator<uint32_t> count;
+  galois::do_all(
+      galois::iterate(uint32_t{0}, kNumNodes), [&](uint32_t) { count += 1; });
+  GALOIS_LOG_ASSERT(count.reduce() == kNumNodes);
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(4);
+
+  TestCancel();
+  TestBfsSssp();
+
+  return 0;
+}
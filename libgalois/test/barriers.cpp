@@ -93,5 +93,6 @@ main(int argc, char** argv) {
   test(CreateMCSBarrier(1));
   test(CreateTopoBarrier(1));
   test(CreateDisseminationBarrier(1));
+  test(CreateFastestBarrier(numThreads));
   return 0;
 }
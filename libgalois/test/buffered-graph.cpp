@@ -0,0 +1,118 @@
+#include <boost/filesystem.hpp>
+
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/graphs/BufferedGraph.h"
+#include "galois/graphs/FileGraph.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+constexpr uint64_t kNumNodes = 1000;
+
+uint64_t
+Degree(uint64_t node) {
+  // odd total number of edges, so that the edge data is after padding
+  return node == 0 ? 1 : node % 4;
+}
+
+uint64_t
+Dest(uint64_t node, uint64_t k) {
+  return (node * 7 + k) % kNumNodes;
+}
+
+uint32_t
+Data(uint64_t node, uint64_t k) {
+  return node * 10 + k;
+}
+
+void
+WriteGraph(const std::string& filename, uint64_t* num_edges) {
+  *num_edges = 0;
+  for (uint64_t n = 0; n < kNumNodes; ++n) {
+    *num_edges += Degree(n);
+  }
+  GALOIS_LOG_ASSERT(*num_edges % 2 == 1);
+
+  galois::graphs::FileGraphWriter writer;
+  writer.setNumNodes(kNumNodes);
+  writer.setNumEdges(*num_edges);
+  writer.setSizeofEdgeData(sizeof(uint32_t));
+  writer.phase1();
+  for (uint64_t n = 0; n < kNumNodes; ++n) {
+    writer.incrementDegree(n, Degree(n));
+  }
+  writer.phase2();
+  std::vector<std::pair<uint64_t, uint32_t>> data;
+  for (uint64_t n = 0; n < kNumNodes; ++n) {
+    for (uint64_t k = 0; k < Degree(n); ++k) {
+      data.emplace_back(writer.addNeighbor(n, Dest(n, k)), Data(n, k));
+    }
+  }
+  uint32_t* edge_data = writer.finish<uint32_t>();
+  for (const auto& [edge, value] : data) {
+    edge_data[edge] = value;
+  }
+  writer.toFile(filename);
+}
+
+void
+CheckNodes(
+    galois::graphs::BufferedGraph<uint32_t>& graph, uint64_t begin,
+    uint64_t end) {
+  for (uint64_t n = begin; n < end; ++n) {
+    auto edge = graph.edgeBegin(n);
+    GALOIS_LOG_ASSERT(
+        static_cast<uint64_t>(graph.edgeEnd(n) - edge) == Degree(n));
+    for (uint64_t k = 0; k < Degree(n); ++k, ++edge) {
+      GALOIS_LOG_ASSERT(graph.edgeDestination(*edge) == Dest(n, k));
+      GALOIS_LOG_ASSERT(graph.edgeData(*edge) == Data(n, k));
+    }
+  }
+}
+
+void
+TestLoad(const std::string& filename, uint64_t num_edges) {
+  galois::graphs::BufferedGraph<uint32_t> graph;
+  graph.loadGraph(filename);
+  GALOIS_LOG_ASSERT(graph.size() == kNumNodes);
+  GALOIS_LOG_ASSERT(graph.sizeEdges() == num_edges);
+  CheckNodes(graph, 0, kNumNodes);
+}
+
+void
+TestLoadPartial(const std::string& filename, uint64_t num_edges) {
+  galois::graphs::FileGraph file_graph;
+  file_graph.fromFile(filename);
+  uint64_t node_begin = 100;
+  uint64_t node_end = 600;
+  uint64_t edge_begin = *file_graph.edge_begin(node_begin);
+  uint64_t edge_end = *file_graph.edge_end(node_end - 1);
+
+  galois::graphs::BufferedGraph<uint32_t> graph;
+  graph.loadPartialGraph(
+      filename, node_begin, node_end, edge_begin, edge_end, kNumNodes,
+      num_edges);
+  GALOIS_LOG_ASSERT(graph.getNodeOffset() == node_begin);
+  CheckNodes(graph, node_begin, node_end);
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(4);
+
+  fs::path path = fs::temp_directory_path() /
+                  fs::unique_path("buffered-graph-%%%%-%%%%.gr");
+  uint64_t num_edges = 0;
+  WriteGraph(path.string(), &num_edges);
+
+  TestLoad(path.string(), num_edges);
+  TestLoadPartial(path.string(), num_edges);
+
+  fs::remove(path);
+  return 0;
+}
@@ -0,0 +1,109 @@
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/Reduction.h"
+#include "galois/worklists/BulkSynchronousDense.h"
+
+namespace {
+
+using WL = galois::worklists::BulkSynchronousDense<>;
+
+/// A breadth-first traversal of a ring with chords, in which node n links to
+/// n + 1 and 2n: each node is settled in the round of its distance, whether
+/// the round is held in chunks or in a bitset
+void
+TestTraversal(uint32_t num_nodes, double dense_fraction) {
+  std::vector<std::atomic<uint32_t>> dist(num_nodes);
+  for (auto& d : dist) {
+    d = UINT32_MAX;
+  }
+  dist[0] = 0;
+
+  galois::GAccumulator<uint64_t> iterations;
+  galois::for_each(
+      galois::iterate({uint32_t{0}}),
+      [&](uint32_t n, auto& ctx) {
+        iterations += 1;
+        for (uint32_t dst : {(n + 1) % num_nodes, (2 * n) % num_nodes}) {
+          uint32_t old = dist[dst];
+          uint32_t next = dist[n] + 1;
+          while (next < old) {
+            if (dist[dst].compare_exchange_weak(old, next)) {
+              ctx.push(dst);
+              break;
+            }
+          }
+        }
+      },
+      galois::wl<WL>(num_nodes, dense_fraction),
+      galois::disable_conflict_detection(), galois::no_stats(),
+      galois::loopname("BulkSynchronousDense"));
+
+  // a serial breadth-first search for the answer
+  std::vector<uint32_t> expected(num_nodes, UINT32_MAX);
+  std::vector<uint32_t> frontier{0};
+  expected[0] = 0;
+  for (uint32_t level = 1; !frontier.empty(); ++level) {
+    std::vector<uint32_t> next;
+    for (uint32_t n : frontier) {
+      for (uint32_t dst : {(n + 1) % num_nodes, (2 * n) % num_nodes}) {
+        if (expected[dst] == UINT32_MAX) {
+          expected[dst] = level;
+          next.emplace_back(dst);
+        }
+      }
+    }
+    frontier.swap(next);
+  }
+
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    GALOIS_LOG_VASSERT(
+        dist[n] == expected[n], "{}: {} != {}", n, dist[n].load(),
+        expected[n]);
+  }
+  // rounds in order settle every node on its first visit
+  GALOIS_LOG_ASSERT(iterations.reduce() == num_nodes);
+}
+
+/// Every node of a dense round is popped once, however often it is pushed
+void
+TestDuplicates(uint32_t num_nodes) {
+  std::vector<std::atomic<uint32_t>> visits(num_nodes);
+  galois::for_each(
+      galois::iterate(uint32_t{0}, num_nodes),
+      [&](uint32_t n, auto& ctx) {
+        uint32_t old = visits[n]++;
+        if (old == 0) {
+          // each node pushes its successors twice
+          for (int i = 0; i < 2; ++i) {
+            ctx.push((n + 1) % num_nodes);
+          }
+        }
+      },
+      galois::wl<WL>(num_nodes, 0.0), galois::disable_conflict_detection(),
+      galois::no_stats(), galois::loopname("BulkSynchronousDense"));
+
+  // the first round, pushed by iterate, is in chunks; the second is dense
+  for (const auto& v : visits) {
+    GALOIS_LOG_ASSERT(v == 2);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys G;
+  galois::setActiveThreads(galois::substrate::GetThreadPool().getMaxThreads());
+
+  // only chunks, only bitsets after the first round, and a mix
+  TestTraversal(10000, 2.0);
+  TestTraversal(10000, 0.0);
+  TestTraversal(100000, WL::kDefaultDenseFraction);
+  TestDuplicates(5000);
+
+  return 0;
+}
@@ -0,0 +1,115 @@
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "galois/ConcurrentHashMap.h"
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+
+namespace {
+
+constexpr uint64_t kNumKeys = 100000;
+
+/// Bulk inserts keep the first value of a key, and bulk lookups find every
+/// inserted key and none of the others
+void
+TestInsertAll() {
+  galois::ConcurrentHashMap<uint64_t, uint64_t> map(kNumKeys);
+  std::vector<uint64_t> keys;
+  std::vector<uint64_t> values;
+  for (uint64_t i = 0; i < kNumKeys; ++i) {
+    keys.emplace_back(i * 7);
+    values.emplace_back(i);
+  }
+  size_t inserted = map.InsertAll(keys, values, "TestInsertAll");
+  GALOIS_LOG_VASSERT(inserted == kNumKeys, "{}", inserted);
+  GALOIS_LOG_ASSERT(map.size() == kNumKeys);
+  GALOIS_LOG_ASSERT(map.InsertAll(keys, keys, "TestInsertAll") == 0);
+
+  std::vector<uint64_t> lookups;
+  for (uint64_t i = 0; i < 2 * kNumKeys; ++i) {
+    lookups.emplace_back(i * 7 + (i % 2));
+  }
+  std::vector<uint64_t> found(lookups.size());
+  map.FindAll(lookups, found.data(), UINT64_MAX, "TestFindAll");
+  // the odd lookups are not multiples of 7
+  for (uint64_t i = 0; i < lookups.size(); ++i) {
+    uint64_t expected = i % 2 == 0 && i < kNumKeys ? i : UINT64_MAX;
+    GALOIS_LOG_VASSERT(found[i] == expected, "{}: {}", i, found[i]);
+  }
+
+  std::atomic<uint64_t> sum{0};
+  map.ForEach(
+      [&](uint64_t key, uint64_t value) {
+        GALOIS_LOG_ASSERT(key == value * 7);
+        sum += value;
+      },
+      "TestForEach");
+  GALOIS_LOG_ASSERT(sum == kNumKeys * (kNumKeys - 1) / 2);
+}
+
+/// Racing threads that resolve the same strings hand out one dense id per
+/// distinct string
+void
+TestDenseIds() {
+  constexpr uint64_t kNumDistinct = 1000;
+  galois::ConcurrentHashMap<std::string, uint64_t> map(kNumDistinct);
+  std::atomic<uint64_t> next_id{0};
+  std::vector<uint64_t> ids(kNumKeys);
+  galois::do_all(
+      galois::iterate(uint64_t{0}, kNumKeys), [&](uint64_t i) {
+        std::string name = "node" + std::to_string(i % kNumDistinct);
+        ids[i] = *map.TryEmplace(name, [&]() { return next_id++; }).first;
+      });
+
+  GALOIS_LOG_ASSERT(next_id == kNumDistinct);
+  std::vector<bool> seen(kNumDistinct, false);
+  for (uint64_t i = 0; i < kNumKeys; ++i) {
+    GALOIS_LOG_ASSERT(ids[i] == ids[i % kNumDistinct]);
+    seen[ids[i]] = true;
+  }
+  for (uint64_t i = 0; i < kNumDistinct; ++i) {
+    GALOIS_LOG_VASSERT(seen[i], "{}", i);
+    const uint64_t* id = map.Find("node" + std::to_string(i));
+    GALOIS_LOG_ASSERT(id != nullptr && *id == ids[i]);
+  }
+  GALOIS_LOG_ASSERT(map.Find("node") == nullptr);
+}
+
+/// Merging the per-thread maps sums the values of each key across threads
+void
+TestPerThreadMerge() {
+  constexpr uint64_t kNumDistinct = 5000;
+  galois::PerThreadHashMap<uint64_t, uint64_t> counts;
+  auto add = [](uint64_t a, uint64_t b) { return a + b; };
+  galois::do_all(galois::iterate(uint64_t{0}, kNumKeys), [&](uint64_t i) {
+    counts.Update(i % kNumDistinct, 1, add);
+  });
+
+  galois::ConcurrentHashMap<uint64_t, uint64_t> merged =
+      counts.Merge(add, "TestPerThreadMerge");
+  GALOIS_LOG_ASSERT(merged.size() == kNumDistinct);
+  for (uint64_t key = 0; key < kNumDistinct; ++key) {
+    const uint64_t* count = merged.Find(key);
+    GALOIS_LOG_VASSERT(
+        count != nullptr && *count == kNumKeys / kNumDistinct, "{}", key);
+  }
+
+  // merging clears the per-thread maps
+  GALOIS_LOG_ASSERT(counts.Merge(add, "TestPerThreadMerge").size() == 0);
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(4);
+
+  TestInsertAll();
+  TestDenseIds();
+  TestPerThreadMerge();
+
+  return 0;
+}
@@ -0,0 +1,67 @@
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include "galois/ConcurrentUnionFind.h"
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+
+namespace {
+
+constexpr uint32_t kSize = 10000;
+
+/// Joining i with i + k for every i links the even and the odd indices into
+/// one set each when k is even
+void
+TestUniteAll() {
+  galois::ConcurrentUnionFind<uint32_t> forest(kSize);
+  std::vector<std::pair<uint32_t, uint32_t>> edges;
+  for (uint32_t i = 0; i + 2 < kSize; ++i) {
+    edges.emplace_back(kSize - 1 - i, kSize - 3 - i);
+  }
+  uint64_t redundant = forest.UniteAll(edges, "TestUniteAll");
+  GALOIS_LOG_VASSERT(redundant == 0, "{}", redundant);
+  GALOIS_LOG_ASSERT(forest.UniteAll(edges, "TestUniteAll") == edges.size());
+
+  forest.CompressAll("TestCompressAll");
+  for (uint32_t i = 0; i < kSize; ++i) {
+    GALOIS_LOG_VASSERT(forest.parent(i) == i % 2, "{}", i);
+    GALOIS_LOG_ASSERT(forest.FindConst(i) == i % 2);
+  }
+  GALOIS_LOG_ASSERT(forest.IsRoot(0) && forest.IsRoot(1) && !forest.IsRoot(2));
+
+  uint32_t hooked = 0;
+  uint32_t onto = 0;
+  GALOIS_LOG_ASSERT(forest.Unite(kSize - 1, kSize - 2, &hooked, &onto));
+  GALOIS_LOG_ASSERT(hooked == 1 && onto == 0);
+  GALOIS_LOG_ASSERT(forest.Find(kSize - 1) == 0);
+}
+
+/// A view continues the forest stored in the caller's array
+void
+TestView() {
+  std::vector<std::atomic<uint64_t>> parents(kSize);
+  for (uint64_t i = 0; i < kSize; ++i) {
+    parents[i] = i;
+  }
+  galois::ConcurrentUnionFind<uint64_t> forest(parents.data(), kSize);
+  GALOIS_LOG_ASSERT(forest.Unite(5, 7));
+  GALOIS_LOG_ASSERT(forest.Unite(7, 3));
+  GALOIS_LOG_ASSERT(!forest.Unite(3, 5));
+  forest.CompressAll("TestView");
+  GALOIS_LOG_ASSERT(parents[5] == 3 && parents[7] == 3 && parents[3] == 3);
+  GALOIS_LOG_ASSERT(parents[4] == 4);
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(2);
+
+  TestUniteAll();
+  TestView();
+
+  return 0;
+}
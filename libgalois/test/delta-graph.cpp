@@ -0,0 +1,136 @@
+#include <arrow/api.h>
+
+#include "TestPropertyGraph.h"
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/OpLog.h"
+#include "galois/Reduction.h"
+#include "galois/graphs/DeltaGraph.h"
+
+namespace {
+
+using galois::Operation;
+using galois::OpTypes;
+using galois::PropertyKey;
+using galois::graphs::DeltaGraph;
+using galois::graphs::EdgeOpId;
+
+constexpr uint32_t kNumNodes = 10;
+
+PropertyKey
+TopologyKey(const std::string& id) {
+  return PropertyKey(
+      id, false, false, "", galois::ImportDataType::kUnsupported, false);
+}
+
+std::vector<uint32_t>
+Dests(const DeltaGraph& g, uint32_t node) {
+  std::vector<uint32_t> dests;
+  for (auto e : g.edges(node)) {
+    dests.emplace_back(*g.GetEdgeDest(e));
+  }
+  return dests;
+}
+
+std::vector<uint32_t>
+Dests(const galois::graphs::GraphTopology& topology, uint32_t node) {
+  auto [begin, end] = topology.edge_range(node);
+  std::vector<uint32_t> dests;
+  for (uint64_t e = begin; e < end; ++e) {
+    dests.emplace_back(topology.out_dests->Value(e));
+  }
+  return dests;
+}
+
+void
+TestDeltaGraph() {
+  // A ring: node n has one edge, to n + 1
+  LinePolicy policy{1};
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g =
+      MakeFileGraph<int64_t>(kNumNodes, 1, &policy);
+
+  auto make_result = DeltaGraph::Make(g.get());
+  GALOIS_LOG_VASSERT(make_result, "{}", make_result.error());
+  std::unique_ptr<DeltaGraph> delta = std::move(make_result.value());
+  GALOIS_LOG_ASSERT(delta->num_nodes() == kNumNodes);
+  GALOIS_LOG_ASSERT(delta->num_edges() == kNumNodes);
+  GALOIS_LOG_ASSERT(Dests(*delta, 3) == std::vector<uint32_t>({4}));
+
+  galois::OpLog log;
+  log.AppendOp(Operation(OpTypes::kOpEdgeAdd, TopologyKey(EdgeOpId(0, 5))));
+  log.AppendOp(Operation(OpTypes::kOpEdgeDel, TopologyKey(EdgeOpId(1, 2))));
+  log.AppendOp(Operation(OpTypes::kOpNodeAdd, TopologyKey("")));
+  log.AppendOp(Operation(OpTypes::kOpEdgeAdd, TopologyKey(EdgeOpId(10, 0))));
+  log.AppendOp(Operation(OpTypes::kOpEdgeAdd, TopologyKey(EdgeOpId(3, 10))));
+  log.AppendOp(Operation(OpTypes::kOpEdgeAdd, TopologyKey(EdgeOpId(4, 4))));
+  log.AppendOp(Operation(OpTypes::kOpEdgeDel, TopologyKey(EdgeOpId(4, 4))));
+  log.AppendOp(Operation(OpTypes::kOpNodeDel, TopologyKey("7")));
+  // ignored: node 7 is gone
+  log.AppendOp(Operation(OpTypes::kOpEdgeAdd, TopologyKey(EdgeOpId(7, 1))));
+
+  auto apply_result = delta->Apply(log);
+  GALOIS_LOG_VASSERT(apply_result, "{}", apply_result.error());
+  GALOIS_LOG_ASSERT(delta->num_nodes() == kNumNodes + 1);
+  GALOIS_LOG_ASSERT(delta->IsDeleted(7) && !delta->IsDeleted(10));
+  GALOIS_LOG_ASSERT(delta->num_deleted_base_edges() == 3);
+  GALOIS_LOG_ASSERT(delta->num_edges() == kNumNodes);
+  GALOIS_LOG_ASSERT(Dests(*delta, 0) == std::vector<uint32_t>({1, 5}));
+  GALOIS_LOG_ASSERT(Dests(*delta, 1).empty());
+  GALOIS_LOG_ASSERT(Dests(*delta, 3) == std::vector<uint32_t>({4, 10}));
+  GALOIS_LOG_ASSERT(Dests(*delta, 4) == std::vector<uint32_t>({5}));
+  GALOIS_LOG_ASSERT(Dests(*delta, 6).empty() && Dests(*delta, 7).empty());
+  GALOIS_LOG_ASSERT(Dests(*delta, 10) == std::vector<uint32_t>({0}));
+  GALOIS_LOG_ASSERT(
+      delta->base_edge(delta->edge_begin(10)) == DeltaGraph::kNoBaseEdge);
+
+  galois::GAccumulator<uint64_t> num_edges;
+  galois::do_all(galois::iterate(*delta), [&](uint32_t n) {
+    for (auto e : delta->edges(n)) {
+      (void)e;
+      num_edges += 1;
+    }
+  });
+  GALOIS_LOG_ASSERT(num_edges.reduce() == delta->num_edges());
+
+  galois::OpLog bad;
+  bad.AppendOp(Operation(OpTypes::kOpEdgeAdd, TopologyKey("1-2")));
+  auto bad_result = delta->Apply(bad);
+  GALOIS_LOG_ASSERT(
+      !bad_result && bad_result.error() == galois::ErrorCode::InvalidArgument);
+
+  // Node 7 is dropped, so nodes 8, 9 and 10 become 7, 8 and 9
+  auto compact_result = delta->Compact();
+  GALOIS_LOG_VASSERT(compact_result, "{}", compact_result.error());
+  std::unique_ptr<galois::graphs::PropertyFileGraph> compacted =
+      std::move(compact_result.value());
+  const galois::graphs::GraphTopology& topology = compacted->topology();
+  GALOIS_LOG_ASSERT(topology.num_nodes() == kNumNodes);
+  GALOIS_LOG_ASSERT(topology.num_edges() == delta->num_edges());
+  GALOIS_LOG_ASSERT(Dests(topology, 0) == std::vector<uint32_t>({1, 5}));
+  GALOIS_LOG_ASSERT(Dests(topology, 3) == std::vector<uint32_t>({4, 9}));
+  GALOIS_LOG_ASSERT(Dests(topology, 7) == std::vector<uint32_t>({8}));
+  GALOIS_LOG_ASSERT(Dests(topology, 9) == std::vector<uint32_t>({0}));
+
+  auto node_prop = std::static_pointer_cast<arrow::Int64Array>(
+      compacted->NodeProperty(g->node_schema()->field(0)->name())->chunk(0));
+  GALOIS_LOG_ASSERT(node_prop->length() == kNumNodes);
+  GALOIS_LOG_ASSERT(node_prop->null_count() == 1 && node_prop->IsNull(9));
+  GALOIS_LOG_ASSERT(node_prop->Value(8) == 1);
+  auto edge_prop = std::static_pointer_cast<arrow::Int64Array>(
+      compacted->EdgeProperty(g->edge_schema()->field(0)->name())->chunk(0));
+  // the edges 0 -> 5, 3 -> 10 and 10 -> 0 were inserted
+  GALOIS_LOG_ASSERT(edge_prop->null_count() == 3);
+  GALOIS_LOG_ASSERT(edge_prop->IsValid(0) && edge_prop->IsNull(1));
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(2);
+
+  TestDeltaGraph();
+
+  return 0;
+}
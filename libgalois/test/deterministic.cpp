@@ -0,0 +1,84 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include <vector>
+
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/runtime/Context.h"
+
+namespace {
+
+struct Cell : public galois::runtime::Lockable {
+  uint64_t history = 0;
+};
+
+constexpr int kNumCells = 257;
+constexpr int kNumItems = 5000;
+
+/// Each item folds its id into the histories of two cells, so the histories
+/// record the order in which items that share a cell ran. Half the items
+/// push another item, so later rounds get new work to merge and distribute.
+std::vector<uint64_t>
+Run(unsigned threads) {
+  galois::setActiveThreads(threads);
+  std::vector<Cell> cells(kNumCells);
+
+  galois::for_each(
+      galois::iterate(0, kNumItems),
+      [&](int i, auto& ctx) {
+        Cell& a = cells[i % kNumCells];
+        Cell& b = cells[(i * 7 + 3) % kNumCells];
+        galois::runtime::acquire(&a, galois::MethodFlag::WRITE);
+        galois::runtime::acquire(&b, galois::MethodFlag::WRITE);
+        ctx.cautiousPoint();
+
+        a.history = a.history * 31 + i;
+        b.history = b.history * 17 + i;
+        if (i < kNumItems / 2) {
+          ctx.push(i + kNumItems);
+        }
+      },
+      galois::wl<galois::worklists::Deterministic<>>(), galois::no_stats());
+
+  std::vector<uint64_t> histories;
+  for (const auto& c : cells) {
+    histories.push_back(c.history);
+  }
+  return histories;
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  unsigned max_threads =
+      galois::substrate::GetThreadPool().getMaxUsableThreads();
+
+  std::vector<uint64_t> expected = Run(1);
+  for (unsigned threads = 2; threads <= max_threads; ++threads) {
+    GALOIS_LOG_VASSERT(
+        Run(threads) == expected, "different result with {} threads", threads);
+  }
+  // and the same again
+  GALOIS_LOG_ASSERT(Run(max_threads) == expected);
+
+  return 0;
+}
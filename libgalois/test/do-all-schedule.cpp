@@ -0,0 +1,76 @@
+#include <atomic>
+#include <vector>
+
+#include "galois/Bag.h"
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+
+namespace {
+
+/// Every iteration of the loop runs exactly once under schedule
+void
+TestSchedule(uint32_t num_items, const galois::schedule& schedule) {
+  std::vector<std::atomic<uint32_t>> counts(num_items);
+
+  galois::do_all(
+      galois::iterate(uint32_t{0}, num_items),
+      [&](uint32_t i) { counts[i] += 1; }, schedule, galois::no_stats());
+
+  for (const auto& count : counts) {
+    GALOIS_LOG_ASSERT(count == 1);
+  }
+}
+
+/// Non-random access ranges work with every policy but Weighted
+void
+TestBag(uint32_t num_items, const galois::schedule& schedule) {
+  galois::InsertBag<uint32_t> bag;
+  galois::do_all(
+      galois::iterate(uint32_t{0}, num_items), [&](uint32_t i) { bag.push(i); },
+      galois::no_stats());
+
+  std::vector<std::atomic<uint32_t>> counts(num_items);
+  galois::do_all(
+      galois::iterate(bag), [&](uint32_t i) { counts[i] += 1; }, schedule,
+      galois::no_stats());
+
+  for (const auto& count : counts) {
+    GALOIS_LOG_ASSERT(count == 1);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(
+      galois::substrate::GetThreadPool().getMaxUsableThreads());
+
+  constexpr uint32_t kNumItems = 100000;
+
+  // A power-law-like prefix sum: the first items weigh the most
+  std::vector<uint64_t> prefix_sum(kNumItems);
+  uint64_t sum = 0;
+  for (uint32_t i = 0; i < kNumItems; ++i) {
+    sum += kNumItems / (i + 1);
+    prefix_sum[i] = sum;
+  }
+  std::vector<uint64_t> zero_weights(kNumItems, 0);
+
+  for (uint32_t n : {0U, 1U, 7U, kNumItems}) {
+    TestSchedule(n, galois::schedule::Static());
+    TestSchedule(n, galois::schedule::Dynamic());
+    TestSchedule(n, galois::schedule::Dynamic(1));
+    TestSchedule(n, galois::schedule::Guided());
+    TestSchedule(n, galois::schedule::Guided(64));
+    TestSchedule(n, galois::schedule::Weighted(prefix_sum.data()));
+    TestSchedule(n, galois::schedule::Weighted(zero_weights.data(), 1));
+  }
+
+  TestBag(kNumItems, galois::schedule::Static());
+  TestBag(kNumItems, galois::schedule::Dynamic());
+  TestBag(kNumItems, galois::schedule::Guided());
+
+  return 0;
+}
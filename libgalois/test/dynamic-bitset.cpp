@@ -0,0 +1,129 @@
+#include <random>
+#include <vector>
+
+#include "galois/DynamicBitset.h"
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+
+namespace {
+
+/// Fills a bitset and its reference with random bits
+void
+Fill(
+    std::mt19937* gen, galois::DynamicBitset* bitset,
+    std::vector<bool>* reference) {
+  std::bernoulli_distribution coin(0.3);
+  for (size_t i = 0; i < bitset->size(); ++i) {
+    (*reference)[i] = coin(*gen);
+    if ((*reference)[i]) {
+      bitset->set(i);
+    }
+  }
+}
+
+void
+CheckEqual(
+    const galois::DynamicBitset& bitset, const std::vector<bool>& reference) {
+  uint64_t count = 0;
+  std::vector<uint64_t> offsets;
+  for (size_t i = 0; i < reference.size(); ++i) {
+    GALOIS_LOG_VASSERT(bitset.test(i) == reference[i], "bit {} differs", i);
+    if (reference[i]) {
+      ++count;
+      offsets.emplace_back(i);
+    }
+  }
+  GALOIS_LOG_VASSERT(
+      bitset.count() == count, "count {} != {}", bitset.count(), count);
+  GALOIS_LOG_ASSERT(bitset.getOffsets<uint64_t>() == offsets);
+}
+
+/// Each bulk operation matches the same operation on a vector of bools, on
+/// sizes that do not fill whole vectors or whole words
+void
+TestOps(size_t size) {
+  std::mt19937 gen(size);
+  std::vector<bool> ref_a(size);
+  std::vector<bool> ref_b(size);
+  galois::DynamicBitset a;
+  galois::DynamicBitset b;
+  a.resize(size);
+  b.resize(size);
+  Fill(&gen, &a, &ref_a);
+  Fill(&gen, &b, &ref_b);
+  CheckEqual(a, ref_a);
+
+  galois::DynamicBitset c;
+  c.resize(size);
+  std::vector<bool> ref_c(size);
+
+  c.bitwise_and(a, b);
+  for (size_t i = 0; i < size; ++i) {
+    ref_c[i] = ref_a[i] && ref_b[i];
+  }
+  CheckEqual(c, ref_c);
+
+  c.bitwise_xor(a, b);
+  for (size_t i = 0; i < size; ++i) {
+    ref_c[i] = ref_a[i] != ref_b[i];
+  }
+  CheckEqual(c, ref_c);
+
+  c.bitwise_or(a);
+  for (size_t i = 0; i < size; ++i) {
+    ref_c[i] = ref_c[i] || ref_a[i];
+  }
+  CheckEqual(c, ref_c);
+
+  c.bitwise_andnot(b);
+  for (size_t i = 0; i < size; ++i) {
+    ref_c[i] = ref_c[i] && !ref_b[i];
+  }
+  CheckEqual(c, ref_c);
+
+  c.bitwise_and(a);
+  for (size_t i = 0; i < size; ++i) {
+    ref_c[i] = ref_c[i] && ref_a[i];
+  }
+  CheckEqual(c, ref_c);
+
+  c.bitwise_xor(b);
+  for (size_t i = 0; i < size; ++i) {
+    ref_c[i] = ref_c[i] != ref_b[i];
+  }
+  CheckEqual(c, ref_c);
+
+  // a takes the bits of c and c is left empty
+  a.swap_and_clear(c);
+  CheckEqual(a, ref_c);
+  CheckEqual(c, std::vector<bool>(size));
+}
+
+/// set and reset report whether the bit was set before
+void
+TestSetReset() {
+  galois::DynamicBitset bitset;
+  bitset.resize(100);
+  GALOIS_LOG_ASSERT(!bitset.set(70));
+  GALOIS_LOG_ASSERT(bitset.set(70));
+  GALOIS_LOG_ASSERT(bitset.test(70));
+  GALOIS_LOG_ASSERT(bitset.reset(70));
+  GALOIS_LOG_ASSERT(!bitset.reset(70));
+  GALOIS_LOG_ASSERT(!bitset.test(70));
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(
+      galois::substrate::GetThreadPool().getMaxUsableThreads());
+
+  for (size_t size : {0, 1, 63, 64, 65, 250, 511, 513, 4099, 100003}) {
+    TestOps(size);
+  }
+  TestSetReset();
+
+  return 0;
+}
@@ -0,0 +1,117 @@
+#include <atomic>
+
+#include <boost/filesystem.hpp>
+
+#include "TestPropertyGraph.h"
+#include "galois/AtomicHelpers.h"
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/Reduction.h"
+#include "galois/Uri.h"
+#include "galois/graphs/EdgeGrid.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+using galois::graphs::EdgeGrid;
+
+constexpr uint32_t kNumNodes = 100;
+constexpr uint32_t kNumIntervals = 3;
+
+void
+TestStream(const galois::Uri& dir) {
+  LinePolicy policy{2};
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g =
+      MakeFileGraph<int64_t>(kNumNodes, 1, &policy);
+  auto write_result = EdgeGrid::Write(g->topology(), kNumIntervals, dir);
+  GALOIS_LOG_VASSERT(write_result, "{}", write_result.error());
+
+  auto open_result = EdgeGrid::Open(dir);
+  GALOIS_LOG_VASSERT(open_result, "{}", open_result.error());
+  const EdgeGrid& grid = open_result.value();
+  GALOIS_LOG_ASSERT(grid.num_nodes() == kNumNodes);
+  GALOIS_LOG_ASSERT(grid.num_edges() == g->topology().num_edges());
+  GALOIS_LOG_ASSERT(grid.num_intervals() == kNumIntervals);
+  GALOIS_LOG_ASSERT(grid.interval_begin(kNumIntervals) == kNumNodes);
+
+  // Every edge is streamed once, from the block of its endpoints
+  uint64_t num_blocks = 0;
+  std::vector<std::atomic<uint32_t>> degrees(kNumNodes);
+  auto stream_result = grid.StreamBlocks(
+      [&](uint32_t i, uint32_t j, const EdgeGrid::Edge* edges, uint64_t n) {
+        ++num_blocks;
+        GALOIS_LOG_ASSERT(n == grid.block_size(i, j));
+        for (uint64_t e = 0; e < n; ++e) {
+          GALOIS_LOG_ASSERT(grid.interval(edges[e].src) == i);
+          GALOIS_LOG_ASSERT(grid.interval(edges[e].dst) == j);
+          GALOIS_LOG_ASSERT(
+              edges[e].dst == (edges[e].src + 1) % kNumNodes ||
+              edges[e].dst == (edges[e].src + 2) % kNumNodes);
+          degrees[edges[e].src] += 1;
+        }
+      });
+  GALOIS_LOG_VASSERT(stream_result, "{}", stream_result.error());
+  GALOIS_LOG_ASSERT(num_blocks > 1);
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    GALOIS_LOG_ASSERT(degrees[n] == 2);
+  }
+
+  // Only the edges from active intervals are read
+  galois::GAccumulator<uint64_t> num_active;
+  std::vector<uint8_t> active(kNumIntervals);
+  active[1] = 1;
+  auto active_result = grid.StreamEdges(
+      [&](uint32_t src, uint32_t) {
+        GALOIS_LOG_ASSERT(grid.interval(src) == 1);
+        num_active += 1;
+      },
+      active);
+  GALOIS_LOG_VASSERT(active_result, "{}", active_result.error());
+  uint64_t interval_nodes = grid.interval_begin(2) - grid.interval_begin(1);
+  GALOIS_LOG_ASSERT(num_active.reduce() == 2 * interval_nodes);
+
+  // Connected components by label propagation, one stream per round
+  std::vector<std::atomic<uint32_t>> labels(kNumNodes);
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    labels[n] = n;
+  }
+  bool changed = true;
+  while (changed) {
+    galois::GReduceLogicalOr round_changed;
+    auto cc_result = grid.StreamEdges([&](uint32_t src, uint32_t dst) {
+      uint32_t label = labels[src];
+      if (galois::atomicMin(labels[dst], label) > label) {
+        round_changed.update(true);
+      }
+      label = labels[dst];
+      if (galois::atomicMin(labels[src], label) > label) {
+        round_changed.update(true);
+      }
+    });
+    GALOIS_LOG_VASSERT(cc_result, "{}", cc_result.error());
+    changed = round_changed.reduce();
+  }
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    GALOIS_LOG_ASSERT(labels[n] == 0);
+  }
+
+  auto bad_result = EdgeGrid::Write(g->topology(), 0, dir);
+  GALOIS_LOG_ASSERT(
+      !bad_result && bad_result.error() == galois::ErrorCode::InvalidArgument);
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(2);
+
+  auto uri_res = galois::Uri::MakeRand("/tmp/edgegrid");
+  GALOIS_LOG_ASSERT(uri_res);
+  TestStream(uri_res.value());
+  fs::remove_all(uri_res.value().path());
+
+  return 0;
+}
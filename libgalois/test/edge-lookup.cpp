@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/graphs/EdgeLookupIndex.h"
+#include "galois/graphs/LC_CSR_Graph.h"
+
+namespace {
+
+using Index = galois::graphs::EdgeLookupIndex<uint32_t>;
+using Graph = galois::graphs::LC_CSR_Graph<uint32_t, uint32_t>::
+    with_no_lockable<true>::type;
+
+constexpr uint64_t kThreshold = 8;
+
+/// A graph with a node of each kind: 0 sorted, 1 unsorted, 2 a hub with
+/// multi-edges, 3 without edges and 4 with a self loop
+struct Topology {
+  std::vector<uint64_t> out_indices;
+  std::vector<uint32_t> dests;
+
+  Topology() {
+    std::vector<std::vector<uint32_t>> adjacency{
+        {1, 2, 4}, {4, 0, 2}, {}, {}, {4, 1}};
+    for (uint32_t i = 0; i < 40; ++i) {
+      adjacency[2].emplace_back((i * 7) % 5);
+    }
+    for (const auto& edges : adjacency) {
+      dests.insert(dests.end(), edges.begin(), edges.end());
+      out_indices.emplace_back(dests.size());
+    }
+  }
+
+  uint64_t num_nodes() const { return out_indices.size(); }
+
+  uint64_t begin(uint32_t n) const { return n == 0 ? 0 : out_indices[n - 1]; }
+
+  /// The first edge from src to dst in edge order, or the end of src
+  uint64_t Scan(uint32_t src, uint32_t dst) const {
+    auto first = dests.begin() + begin(src);
+    auto last = dests.begin() + out_indices[src];
+    return std::find(first, last, dst) - dests.begin();
+  }
+};
+
+void
+TestIndex() {
+  Topology t;
+  Index index;
+  GALOIS_LOG_ASSERT(!index.built());
+  index.Build(t.num_nodes(), t.out_indices.data(), t.dests.data(), kThreshold);
+  GALOIS_LOG_ASSERT(index.built());
+
+  GALOIS_LOG_ASSERT(index.kind(0) == Index::Kind::kSorted);
+  GALOIS_LOG_ASSERT(index.kind(1) == Index::Kind::kScan);
+  GALOIS_LOG_ASSERT(index.kind(2) == Index::Kind::kHashed);
+  GALOIS_LOG_ASSERT(index.kind(3) == Index::Kind::kSorted);
+  GALOIS_LOG_ASSERT(index.NumNodes(Index::Kind::kHashed) == 1);
+
+  for (uint32_t src = 0; src < t.num_nodes(); ++src) {
+    for (uint32_t dst = 0; dst < t.num_nodes() + 2; ++dst) {
+      uint64_t found = index.Find(src, dst);
+      GALOIS_LOG_VASSERT(
+          found == t.Scan(src, dst), "{} -> {}: {} != {}", src, dst, found,
+          t.Scan(src, dst));
+    }
+  }
+
+  index.clear();
+  GALOIS_LOG_ASSERT(!index.built());
+}
+
+/// Every kind of lookup agrees with a scan on a random graph with hubs
+void
+TestRandom() {
+  constexpr uint32_t kNumNodes = 200;
+  std::vector<uint64_t> out_indices;
+  std::vector<uint32_t> dests;
+  uint64_t state = 1;
+  auto next = [&]() {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return static_cast<uint32_t>(state >> 33);
+  };
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    uint32_t degree = n % 10 == 0 ? 100 + next() % 100 : next() % 12;
+    size_t first = dests.size();
+    for (uint32_t i = 0; i < degree; ++i) {
+      dests.emplace_back(next() % kNumNodes);
+    }
+    if (n % 2 == 0) {
+      std::sort(dests.begin() + first, dests.end());
+    }
+    out_indices.emplace_back(dests.size());
+  }
+
+  Index index;
+  index.Build(kNumNodes, out_indices.data(), dests.data(), 32);
+  GALOIS_LOG_ASSERT(index.NumNodes(Index::Kind::kHashed) >= kNumNodes / 10);
+  for (uint32_t src = 0; src < kNumNodes; ++src) {
+    uint64_t begin = src == 0 ? 0 : out_indices[src - 1];
+    for (uint32_t dst = 0; dst < kNumNodes; ++dst) {
+      uint64_t expected =
+          std::find(
+              dests.begin() + begin, dests.begin() + out_indices[src], dst) -
+          dests.begin();
+      GALOIS_LOG_ASSERT(index.Find(src, dst) == expected);
+    }
+  }
+}
+
+void
+TestGraph() {
+  Topology t;
+  Graph g;
+  g.allocateFrom(t.num_nodes(), t.dests.size());
+  g.constructNodes();
+  for (uint32_t n = 0; n < t.num_nodes(); ++n) {
+    for (uint64_t e = t.begin(n); e < t.out_indices[n]; ++e) {
+      g.constructEdge(e, t.dests[e], 0);
+    }
+    g.fixEndEdge(n, t.out_indices[n]);
+  }
+
+  std::vector<uint64_t> scanned;
+  for (uint32_t src = 0; src < t.num_nodes(); ++src) {
+    for (uint32_t dst = 0; dst < t.num_nodes(); ++dst) {
+      scanned.emplace_back(*g.findEdge(src, dst));
+    }
+  }
+
+  GALOIS_LOG_ASSERT(!g.hasEdgeLookup());
+  g.buildEdgeLookup(kThreshold);
+  GALOIS_LOG_ASSERT(g.hasEdgeLookup());
+  size_t i = 0;
+  for (uint32_t src = 0; src < t.num_nodes(); ++src) {
+    for (uint32_t dst = 0; dst < t.num_nodes(); ++dst) {
+      GALOIS_LOG_ASSERT(*g.findEdge(src, dst) == scanned[i++]);
+    }
+  }
+
+  // sorting moves the edges, so it drops the index
+  g.sortAllEdgesByDst();
+  GALOIS_LOG_ASSERT(!g.hasEdgeLookup());
+  g.buildEdgeLookup(kThreshold);
+  for (uint32_t src = 0; src < t.num_nodes(); ++src) {
+    for (uint32_t dst = 0; dst < t.num_nodes(); ++dst) {
+      auto e = g.findEdge(src, dst);
+      if (e != g.edge_end(src)) {
+        GALOIS_LOG_ASSERT(g.getEdgeDst(e) == dst);
+      } else {
+        GALOIS_LOG_ASSERT(t.Scan(src, dst) == t.out_indices[src]);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys G;
+  galois::setActiveThreads(galois::substrate::GetThreadPool().getMaxThreads());
+
+  TestIndex();
+  TestRandom();
+  TestGraph();
+
+  return 0;
+}
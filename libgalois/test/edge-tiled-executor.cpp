@@ -0,0 +1,110 @@
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/runtime/EdgeTiledExecutor.h"
+
+namespace {
+
+using Executor = galois::runtime::EdgeTiledExecutor<uint32_t>;
+
+struct Graph {
+  std::vector<uint64_t> out_indices;
+  std::vector<uint32_t> dests;
+
+  /// Random edges with a hub at node 0
+  explicit Graph(uint32_t num_nodes) {
+    uint64_t state = 1;
+    auto next = [&]() {
+      state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+      return static_cast<uint32_t>(state >> 33);
+    };
+    for (uint32_t n = 0; n < num_nodes; ++n) {
+      uint32_t degree = n == 0 ? num_nodes : next() % 16;
+      for (uint32_t i = 0; i < degree; ++i) {
+        dests.emplace_back(next() % num_nodes);
+      }
+      out_indices.emplace_back(dests.size());
+    }
+  }
+
+  uint64_t begin(uint32_t n) const { return n == 0 ? 0 : out_indices[n - 1]; }
+};
+
+/// Every edge is visited once per sweep, with its own source, and tiles of
+/// the same round never share a block
+void
+TestSweep(uint32_t num_nodes, uint64_t cache_bytes) {
+  Graph g(num_nodes);
+  Executor executor;
+  executor.Build(
+      num_nodes, g.out_indices.data(), g.dests.data(),
+      Executor::kDefaultNodeBytes, cache_bytes);
+  GALOIS_LOG_ASSERT(executor.built());
+  GALOIS_LOG_ASSERT(
+      executor.num_blocks() * executor.block_nodes() >= num_nodes);
+
+  uint64_t tiled = 0;
+  for (uint64_t i = 0; i < executor.num_blocks(); ++i) {
+    for (uint64_t j = 0; j < executor.num_blocks(); ++j) {
+      tiled += executor.tile_size(i, j);
+    }
+  }
+  GALOIS_LOG_ASSERT(tiled == g.dests.size());
+
+  std::vector<std::atomic<uint32_t>> visits(g.dests.size());
+  // without atomics, which the schedule makes safe
+  std::vector<uint64_t> in_degree(num_nodes);
+  std::vector<uint64_t> out_degree(num_nodes);
+  for (int sweep = 0; sweep < 2; ++sweep) {
+    executor.ForEachEdge([&](uint32_t src, uint32_t dst, uint64_t e) {
+      GALOIS_LOG_ASSERT(e >= g.begin(src) && e < g.out_indices[src]);
+      GALOIS_LOG_ASSERT(g.dests[e] == dst);
+      visits[e] += 1;
+      in_degree[dst] += 1;
+      out_degree[src] += 1;
+    });
+  }
+
+  for (const auto& v : visits) {
+    GALOIS_LOG_ASSERT(v == 2);
+  }
+  std::vector<uint64_t> expected(num_nodes);
+  for (uint32_t dst : g.dests) {
+    expected[dst] += 2;
+  }
+  GALOIS_LOG_ASSERT(in_degree == expected);
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    GALOIS_LOG_ASSERT(out_degree[n] == 2 * (g.out_indices[n] - g.begin(n)));
+  }
+}
+
+void
+TestEmpty() {
+  Executor executor;
+  executor.Build(0, nullptr, nullptr);
+  GALOIS_LOG_ASSERT(executor.built());
+  executor.ForEachEdge([](uint32_t, uint32_t, uint64_t) {
+    GALOIS_LOG_FATAL("no edges to visit");
+  });
+  executor.clear();
+  GALOIS_LOG_ASSERT(!executor.built());
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys G;
+  galois::setActiveThreads(galois::substrate::GetThreadPool().getMaxThreads());
+
+  // many small blocks, then blocks as the cache allows
+  TestSweep(5000, 256);
+  TestSweep(5000, Executor::kDefaultCacheBytes);
+  TestSweep(7, 256);
+  TestEmpty();
+
+  return 0;
+}
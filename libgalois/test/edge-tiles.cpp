@@ -0,0 +1,91 @@
+#include <atomic>
+#include <vector>
+
+#include "TestPropertyGraph.h"
+#include "galois/EdgeTiles.h"
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+
+namespace {
+
+/// Node 0 links to every node; the others link to their successor
+class StarPolicy : public Policy {
+public:
+  std::vector<uint32_t> GenerateNeighbors(
+      size_t node_id, size_t num_nodes) override {
+    std::vector<uint32_t> r;
+    if (node_id == 0) {
+      for (size_t i = 0; i < num_nodes; ++i) {
+        r.emplace_back(i);
+      }
+    } else {
+      r.emplace_back((node_id + 1) % num_nodes);
+    }
+    return r;
+  }
+};
+
+void
+TestForEachEdgeTile() {
+  for (int size : {0, 1, 63, 64, 65, 128, 1000}) {
+    std::vector<std::pair<int, int>> tiles;
+    galois::ForEachEdgeTile(
+        0, size, 64, [&](int beg, int end) { tiles.emplace_back(beg, end); });
+    int expected_beg = 0;
+    for (const auto& [beg, end] : tiles) {
+      GALOIS_LOG_ASSERT(beg == expected_beg);
+      GALOIS_LOG_ASSERT(end > beg && end - beg <= 64);
+      expected_beg = end;
+    }
+    GALOIS_LOG_ASSERT(expected_beg == size);
+    GALOIS_LOG_ASSERT(tiles.size() == static_cast<size_t>((size + 63) / 64));
+  }
+}
+
+void
+TestDoAllEdgeTiles() {
+  constexpr size_t kNumNodes = 10000;
+  StarPolicy policy;
+  std::unique_ptr<galois::graphs::PropertyFileGraph> pfg =
+      MakeFileGraph<int32_t>(kNumNodes, 1, &policy);
+  using Graph = galois::graphs::PropertyGraph<std::tuple<>, std::tuple<>>;
+  auto graph_result = Graph::Make(pfg.get(), {}, {});
+  GALOIS_LOG_ASSERT(graph_result);
+  const Graph& graph = graph_result.value();
+
+  // every edge is visited once, by a tile of its own source
+  std::vector<std::atomic<uint32_t>> visits(graph.num_edges());
+  galois::DoAllEdgeTiles(
+      graph, 256,
+      [&](const Graph::Node& src, Graph::edge_iterator beg,
+          Graph::edge_iterator end) {
+        GALOIS_LOG_ASSERT(end - beg <= 256);
+        GALOIS_LOG_ASSERT(graph.edge_begin(src) <= beg);
+        GALOIS_LOG_ASSERT(end <= graph.edge_end(src));
+        for (auto e = beg; e != end; ++e) {
+          visits[*e] += 1;
+        }
+      },
+      "TestDoAllEdgeTiles");
+  for (const auto& v : visits) {
+    GALOIS_LOG_ASSERT(v == 1);
+  }
+
+  // too few edges for kEdgeTilesPerThread tiles of 4096 edges per thread
+  ptrdiff_t size = galois::AdaptiveEdgeTileSize(graph.num_edges(), 4096);
+  GALOIS_LOG_ASSERT(size >= galois::kMinEdgeTileSize && size < 4096);
+  GALOIS_LOG_ASSERT(galois::AdaptiveEdgeTileSize(1, 16) == 16);
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(2);
+
+  TestForEachEdgeTile();
+  TestDoAllEdgeTiles();
+
+  return 0;
+}
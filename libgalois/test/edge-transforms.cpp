@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "TestPropertyGraph.h"
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/graphs/EdgeTransforms.h"
+
+namespace {
+
+using galois::graphs::EdgeFilter;
+using galois::graphs::PropertyFileGraph;
+using Edge = std::pair<uint32_t, uint32_t>;
+
+constexpr uint32_t kNumNodes = 200;
+
+std::shared_ptr<arrow::Table>
+MakeIdTable(const std::string& name, size_t size) {
+  galois::TableBuilder builder{size};
+  galois::ColumnOptions options;
+  options.name = name;
+  options.ascending_values = true;
+  builder.AddColumn<uint64_t>(options);
+  return builder.Finish();
+}
+
+/// The edges of g as (source, destination) in order of index
+std::vector<Edge>
+Edges(const PropertyFileGraph& g) {
+  std::vector<Edge> edges;
+  const galois::graphs::GraphTopology& topology = g.topology();
+  for (uint32_t n = 0; n < topology.num_nodes(); ++n) {
+    auto [e, e_end] = topology.edge_range(n);
+    for (; e != e_end; ++e) {
+      edges.emplace_back(n, topology.out_dests->Value(e));
+    }
+  }
+  return edges;
+}
+
+/// Checks that every edge of t comes from the edge of g its edge-id names,
+/// reversed if it is in reversed and not in forward, and that the edges of
+/// each node are sorted by destination and then by edge-id
+void
+CheckOrigins(
+    const PropertyFileGraph& g, const PropertyFileGraph& t, bool forward,
+    bool reversed) {
+  std::vector<Edge> parent_edges = Edges(g);
+  std::vector<Edge> edges = Edges(t);
+  GALOIS_LOG_ASSERT(t.topology().edges_sorted_by_dest);
+  GALOIS_LOG_ASSERT(t.topology().num_nodes() == kNumNodes);
+
+  auto ids = std::static_pointer_cast<arrow::UInt64Array>(
+      t.EdgeProperty("edge-id")->chunk(0));
+  GALOIS_LOG_ASSERT(static_cast<size_t>(ids->length()) == edges.size());
+  for (size_t e = 0; e < edges.size(); ++e) {
+    const Edge& parent = parent_edges.at(ids->Value(e));
+    Edge reverse(parent.second, parent.first);
+    GALOIS_LOG_ASSERT(
+        (forward && edges[e] == parent) || (reversed && edges[e] == reverse));
+    if (e > 0 && edges[e - 1].first == edges[e].first) {
+      GALOIS_LOG_ASSERT(
+          edges[e - 1].second < edges[e].second ||
+          (edges[e - 1].second == edges[e].second &&
+           ids->Value(e - 1) <= ids->Value(e)));
+    }
+  }
+
+  // the node properties are those of g
+  GALOIS_LOG_ASSERT(
+      t.NodeProperty("node-id")->Equals(g.NodeProperty("node-id")));
+}
+
+void
+TestTransforms() {
+  RandomPolicy policy{4};
+  std::unique_ptr<PropertyFileGraph> g =
+      MakeFileGraph<int32_t>(kNumNodes, 1, &policy);
+  uint64_t num_edges = g->topology().num_edges();
+  GALOIS_LOG_ASSERT(g->AddNodeProperties(MakeIdTable("node-id", kNumNodes)));
+  GALOIS_LOG_ASSERT(g->AddEdgeProperties(MakeIdTable("edge-id", num_edges)));
+  std::vector<Edge> edges = Edges(*g);
+
+  auto transpose_result = galois::graphs::Transpose(*g);
+  GALOIS_LOG_VASSERT(transpose_result, "{}", transpose_result.error());
+  std::unique_ptr<PropertyFileGraph> t = std::move(transpose_result.value());
+  GALOIS_LOG_ASSERT(t->topology().num_edges() == num_edges);
+  CheckOrigins(*g, *t, false, true);
+
+  auto symmetrize_result = galois::graphs::Symmetrize(*g);
+  GALOIS_LOG_VASSERT(symmetrize_result, "{}", symmetrize_result.error());
+  std::unique_ptr<PropertyFileGraph> s = std::move(symmetrize_result.value());
+  GALOIS_LOG_ASSERT(s->topology().num_edges() == 2 * num_edges);
+  CheckOrigins(*g, *s, true, true);
+
+  // symmetric and simple: every pair of distinct nodes with an edge between
+  // them in either direction, once in each direction
+  EdgeFilter simple{true, true};
+  symmetrize_result = galois::graphs::Symmetrize(*g, simple);
+  GALOIS_LOG_VASSERT(symmetrize_result, "{}", symmetrize_result.error());
+  s = std::move(symmetrize_result.value());
+  CheckOrigins(*g, *s, true, true);
+  std::set<Edge> expected;
+  for (const Edge& e : edges) {
+    if (e.first != e.second) {
+      expected.emplace(e);
+      expected.emplace(e.second, e.first);
+    }
+  }
+  std::vector<Edge> symmetric = Edges(*s);
+  GALOIS_LOG_ASSERT(
+      symmetric == std::vector<Edge>(expected.begin(), expected.end()));
+
+  auto simplify_result = galois::graphs::SimplifyEdges(*g);
+  GALOIS_LOG_VASSERT(simplify_result, "{}", simplify_result.error());
+  std::unique_ptr<PropertyFileGraph> simplified =
+      std::move(simplify_result.value());
+  CheckOrigins(*g, *simplified, true, false);
+  expected.clear();
+  for (const Edge& e : edges) {
+    if (e.first != e.second) {
+      expected.emplace(e);
+    }
+  }
+  std::vector<Edge> simple_edges = Edges(*simplified);
+  GALOIS_LOG_ASSERT(
+      simple_edges == std::vector<Edge>(expected.begin(), expected.end()));
+  // the first of duplicate edges is kept
+  auto ids = std::static_pointer_cast<arrow::UInt64Array>(
+      simplified->EdgeProperty("edge-id")->chunk(0));
+  for (int64_t e = 0; e < ids->length(); ++e) {
+    uint64_t id = ids->Value(e);
+    auto first = std::find(edges.begin(), edges.end(), edges[id]);
+    GALOIS_LOG_ASSERT(static_cast<uint64_t>(first - edges.begin()) == id);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(2);
+
+  TestTransforms();
+
+  return 0;
+}
@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "galois/ExternalSort.h"
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/Uri.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+using Edge = std::pair<uint64_t, uint64_t>;
+
+constexpr uint64_t kNumEdges = 100000;
+
+std::vector<Edge>
+RandomEdges() {
+  std::mt19937_64 gen(7);
+  std::uniform_int_distribution<uint64_t> node(0, 999);
+  std::vector<Edge> edges;
+  for (uint64_t i = 0; i < kNumEdges; ++i) {
+    edges.emplace_back(node(gen), node(gen));
+  }
+  return edges;
+}
+
+template <typename Compare>
+void
+TestSort(
+    const galois::Uri& dir, const galois::ExternalSortOptions& options,
+    uint64_t expected_runs, Compare comp) {
+  std::vector<Edge> edges = RandomEdges();
+  galois::ExternalSort<Edge, Compare> sorter(dir, options, comp);
+  // append in uneven pieces so that appends cross run boundaries
+  for (uint64_t i = 0; i < edges.size(); i += 777) {
+    uint64_t n = std::min<uint64_t>(777, edges.size() - i);
+    auto res = sorter.Append(edges.data() + i, n);
+    GALOIS_LOG_VASSERT(res, "{}", res.error());
+  }
+  GALOIS_LOG_ASSERT(sorter.size() == kNumEdges);
+  GALOIS_LOG_ASSERT(sorter.num_runs() == expected_runs);
+
+  std::vector<Edge> sorted;
+  auto res = sorter.Merge([&](const Edge* values, uint64_t n) {
+    GALOIS_LOG_ASSERT(n > 0 && n <= options.merge_block_size);
+    sorted.insert(sorted.end(), values, values + n);
+  });
+  GALOIS_LOG_VASSERT(res, "{}", res.error());
+  GALOIS_LOG_ASSERT(sorter.size() == 0 && sorter.num_runs() == 0);
+
+  std::sort(edges.begin(), edges.end(), comp);
+  GALOIS_LOG_ASSERT(std::is_sorted(sorted.begin(), sorted.end(), comp));
+  std::sort(sorted.begin(), sorted.end());
+  std::sort(edges.begin(), edges.end());
+  GALOIS_LOG_ASSERT(sorted == edges);
+
+  // the runs are deleted by Merge
+  GALOIS_LOG_ASSERT(!fs::exists(dir.path()) || fs::is_empty(dir.path()));
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(2);
+
+  auto uri_res = galois::Uri::MakeRand("/tmp/external-sort");
+  GALOIS_LOG_ASSERT(uri_res);
+  const galois::Uri& dir = uri_res.value();
+
+  // everything fits in memory
+  galois::ExternalSortOptions in_memory;
+  in_memory.merge_block_size = 1000;
+  TestSort(dir, in_memory, 0, std::less<Edge>());
+
+  // runs of 10000 edges merged 333 edges at a time
+  galois::ExternalSortOptions runs;
+  runs.run_size = 10000;
+  runs.merge_block_size = 333;
+  TestSort(dir, runs, 9, std::less<Edge>());
+
+  // the memory budget bounds the runs, sorted by destination
+  galois::ExternalSortOptions budget;
+  budget.memory_budget = 2 * 4096 * sizeof(Edge);
+  budget.merge_block_size = 100;
+  TestSort(dir, budget, kNumEdges / 4096, [](const Edge& a, const Edge& b) {
+    return std::make_pair(a.second, a.first) <
+           std::make_pair(b.second, b.first);
+  });
+
+  fs::remove_all(dir.path());
+  return 0;
+}
@@ -0,0 +1,134 @@
+#include <boost/filesystem.hpp>
+
+#include "TestPropertyGraph.h"
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/Uri.h"
+#include "galois/analytics/GraphStatistics.h"
+#include "galois/analytics/bfs/bfs.h"
+#include "galois/analytics/sssp/sssp.h"
+
+namespace {
+
+namespace fs = boost::filesystem;
+using galois::analytics::GraphStatistics;
+using galois::graphs::PropertyFileGraph;
+
+constexpr uint32_t kNumNodes = 1000;
+
+std::shared_ptr<arrow::Table>
+MakeWeights(size_t size) {
+  galois::TableBuilder builder{size};
+  galois::ColumnOptions options;
+  options.name = "weight";
+  options.ascending_values = true;
+  builder.AddColumn<uint32_t>(options);
+  return builder.Finish();
+}
+
+/// A directed ring: every BFS sweep finds the whole ring, so the estimated
+/// diameter is exact
+void
+TestRing() {
+  LinePolicy policy{1};
+  std::unique_ptr<PropertyFileGraph> g =
+      MakeFileGraph<int32_t>(kNumNodes, 1, &policy);
+  GALOIS_LOG_ASSERT(g->AddEdgeProperties(MakeWeights(kNumNodes)));
+
+  auto stats_result = galois::analytics::ComputeGraphStatistics(*g, "weight");
+  GALOIS_LOG_VASSERT(stats_result, "{}", stats_result.error());
+  const GraphStatistics& stats = stats_result.value();
+  GALOIS_LOG_ASSERT(stats.num_nodes == kNumNodes);
+  GALOIS_LOG_ASSERT(stats.num_edges == kNumNodes);
+  GALOIS_LOG_ASSERT(stats.max_degree == 1);
+  GALOIS_LOG_ASSERT(stats.degree_skew == 1);
+  GALOIS_LOG_VASSERT(
+      stats.estimated_diameter == kNumNodes - 1, "{}",
+      stats.estimated_diameter);
+  GALOIS_LOG_ASSERT(stats.weight_property == "weight");
+  GALOIS_LOG_ASSERT(stats.min_weight == 0);
+  GALOIS_LOG_ASSERT(stats.max_weight == kNumNodes - 1);
+  GALOIS_LOG_ASSERT(stats.mean_weight == (kNumNodes - 1) / 2.0);
+  GALOIS_LOG_ASSERT(!stats.power_law() && stats.high_diameter());
+
+  GALOIS_LOG_ASSERT(
+      galois::analytics::BfsPlan::Automatic(stats).algorithm() ==
+      galois::analytics::BfsPlan::kAsyncTile);
+  galois::analytics::SsspPlan sssp =
+      galois::analytics::SsspPlan::Automatic(stats);
+  GALOIS_LOG_ASSERT(
+      sssp.algorithm() == galois::analytics::SsspPlan::kDeltaStepFusion);
+  // 2 * 499.5 / 1 rounds to 2^10
+  GALOIS_LOG_VASSERT(sssp.delta() == 10, "{}", sssp.delta());
+
+  auto dump_result = galois::analytics::DumpGraphStatistics(stats);
+  GALOIS_LOG_ASSERT(dump_result);
+  auto parse_result =
+      galois::analytics::ParseGraphStatistics(dump_result.value());
+  GALOIS_LOG_ASSERT(parse_result);
+  GALOIS_LOG_ASSERT(
+      parse_result.value().estimated_diameter == stats.estimated_diameter);
+  GALOIS_LOG_ASSERT(parse_result.value().mean_weight == stats.mean_weight);
+}
+
+/// GetGraphStatistics caches the statistics with the graph and Write stores
+/// them
+void
+TestCache() {
+  RandomPolicy policy{8};
+  std::unique_ptr<PropertyFileGraph> g =
+      MakeFileGraph<int32_t>(kNumNodes, 1, &policy);
+  GALOIS_LOG_ASSERT(g->graph_statistics().empty());
+
+  auto stats_result = galois::analytics::GetGraphStatistics(*g);
+  GALOIS_LOG_VASSERT(stats_result, "{}", stats_result.error());
+  GALOIS_LOG_ASSERT(stats_result.value().weight_property.empty());
+  GALOIS_LOG_ASSERT(!g->graph_statistics().empty());
+  std::string cached = g->graph_statistics();
+
+  // asking for weights recomputes them, and they serve later calls without
+  // weights too
+  GALOIS_LOG_ASSERT(g->AddEdgeProperties(MakeWeights(8 * kNumNodes)));
+  stats_result = galois::analytics::GetGraphStatistics(*g, "weight");
+  GALOIS_LOG_ASSERT(stats_result);
+  GALOIS_LOG_ASSERT(stats_result.value().weight_property == "weight");
+  cached = g->graph_statistics();
+  stats_result = galois::analytics::GetGraphStatistics(*g);
+  GALOIS_LOG_ASSERT(stats_result);
+  GALOIS_LOG_ASSERT(g->graph_statistics() == cached);
+
+  GALOIS_LOG_ASSERT(!galois::analytics::GetGraphStatistics(*g, "none"));
+
+  g->MarkAllPropertiesPersistent();
+  auto uri_res = galois::Uri::MakeRand("/tmp/graphstatistics");
+  GALOIS_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  auto write_result = g->Write(rdg_dir, "graph-statistics");
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    GALOIS_LOG_FATAL("writing result: {}", write_result.error());
+  }
+  auto make_result = PropertyFileGraph::Make(rdg_dir);
+  fs::remove_all(rdg_dir);
+  if (!make_result) {
+    GALOIS_LOG_FATAL("making result: {}", make_result.error());
+  }
+  GALOIS_LOG_ASSERT(make_result.value()->graph_statistics() == cached);
+
+  // replacing the topology drops them
+  GALOIS_LOG_ASSERT(g->SetTopology(g->topology()));
+  GALOIS_LOG_ASSERT(g->graph_statistics().empty());
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(2);
+
+  TestRing();
+  TestCache();
+
+  return 0;
+}
@@ -0,0 +1,119 @@
+#include <cstdint>
+#include <vector>
+
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/graphs/HyperGraph.h"
+
+namespace {
+
+using Graph = galois::graphs::HyperGraph<uint32_t>;
+
+/// Nodes 0, 4 and 5 are hyperedges, 4 with one pin; 5 also has an edge to a
+/// hyperedge and vertex 6 an edge back to 5
+struct Bipartite {
+  std::vector<uint64_t> out_indices;
+  std::vector<uint32_t> out_dests;
+  std::vector<bool> hedges{true, false, false, false, true, true, false};
+
+  Bipartite() {
+    std::vector<std::vector<uint32_t>> adjacency{{1, 2, 3}, {}, {}, {},
+                                                 {1},       {2, 0, 3}, {5}};
+    for (const auto& edges : adjacency) {
+      out_dests.insert(out_dests.end(), edges.begin(), edges.end());
+      out_indices.emplace_back(out_dests.size());
+    }
+  }
+
+  void Construct(Graph* graph, bool skip_lone_hedges) const {
+    graph->ConstructFromBipartite(
+        out_indices.size(), out_indices.data(), out_dests.data(),
+        [&](uint32_t n) { return hedges[n]; }, skip_lone_hedges);
+  }
+};
+
+std::vector<uint32_t>
+Pins(const Graph& graph, uint32_t hedge) {
+  std::vector<uint32_t> pins;
+  for (auto e = graph.edge_begin(hedge); e != graph.edge_end(hedge); ++e) {
+    pins.emplace_back(graph.getEdgeDst(e));
+  }
+  return pins;
+}
+
+void
+TestConstruct() {
+  Bipartite input;
+  Graph graph;
+  input.Construct(&graph, false);
+
+  GALOIS_LOG_ASSERT(graph.GetHedges() == 3);
+  GALOIS_LOG_ASSERT(graph.GetHnodes() == 4);
+  GALOIS_LOG_ASSERT(graph.size() == 7);
+  GALOIS_LOG_ASSERT(graph.sizeEdges() == 6);
+  GALOIS_LOG_ASSERT((Pins(graph, 0) == std::vector<uint32_t>{3, 4, 5}));
+  GALOIS_LOG_ASSERT((Pins(graph, 1) == std::vector<uint32_t>{3}));
+  GALOIS_LOG_ASSERT((Pins(graph, 2) == std::vector<uint32_t>{4, 5}));
+  for (uint32_t n = 3; n < 7; ++n) {
+    GALOIS_LOG_ASSERT(Pins(graph, n).empty());
+  }
+}
+
+void
+TestSkipLoneHedges() {
+  Bipartite input;
+  Graph graph;
+  input.Construct(&graph, true);
+
+  GALOIS_LOG_ASSERT(graph.GetHedges() == 2);
+  GALOIS_LOG_ASSERT(graph.GetHnodes() == 4);
+  GALOIS_LOG_ASSERT(graph.sizeEdges() == 5);
+  GALOIS_LOG_ASSERT((Pins(graph, 0) == std::vector<uint32_t>{2, 3, 4}));
+  GALOIS_LOG_ASSERT((Pins(graph, 1) == std::vector<uint32_t>{3, 4}));
+  for (uint32_t n = 2; n < 6; ++n) {
+    GALOIS_LOG_ASSERT(Pins(graph, n).empty());
+  }
+}
+
+/// Larger than the cutoff of the parallel scans, with every third node a
+/// hyperedge of the next two vertices
+void
+TestLarge() {
+  constexpr uint32_t kNumNodes = 3 * 20000;
+  std::vector<uint64_t> out_indices;
+  std::vector<uint32_t> out_dests;
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    if (n % 3 == 0) {
+      out_dests.emplace_back(n + 1);
+      out_dests.emplace_back(n + 2);
+    }
+    out_indices.emplace_back(out_dests.size());
+  }
+
+  Graph graph;
+  graph.ConstructFromBipartite(
+      kNumNodes, out_indices.data(), out_dests.data(),
+      [](uint32_t n) { return n % 3 == 0; });
+  const uint32_t num_hedges = kNumNodes / 3;
+  GALOIS_LOG_ASSERT(graph.GetHedges() == num_hedges);
+  GALOIS_LOG_ASSERT(graph.GetHnodes() == 2 * num_hedges);
+  for (uint32_t h = 0; h < num_hedges; ++h) {
+    GALOIS_LOG_ASSERT(
+        (Pins(graph, h) ==
+         std::vector<uint32_t>{num_hedges + 2 * h, num_hedges + 2 * h + 1}));
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys G;
+  galois::setActiveThreads(galois::substrate::GetThreadPool().getMaxThreads());
+
+  TestConstruct();
+  TestSkipLoneHedges();
+  TestLarge();
+
+  return 0;
+}
@@ -0,0 +1,46 @@
+#include <atomic>
+#include <chrono>
+
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/substrate/ThreadPool.h"
+
+namespace {
+
+/// Every thread runs every one of rounds back-to-back on_each loops, and
+/// every wakeup of a worker is counted once, spinning or sleeping
+void
+RunRounds(std::chrono::nanoseconds spin, unsigned rounds) {
+  auto& pool = galois::substrate::GetThreadPool();
+  pool.setIdleSpin(spin);
+  GALOIS_LOG_ASSERT(pool.getIdleSpin() == spin);
+  pool.resetWakeupStats();
+
+  unsigned num_threads = galois::getActiveThreads();
+  std::atomic<uint64_t> calls{0};
+  for (unsigned r = 0; r < rounds; ++r) {
+    galois::on_each([&](unsigned, unsigned) { calls += 1; });
+  }
+  GALOIS_LOG_ASSERT(calls == uint64_t{rounds} * num_threads);
+
+  galois::substrate::ThreadPool::WakeupStats stats = pool.getWakeupStats();
+  GALOIS_LOG_VASSERT(
+      stats.spinning + stats.sleeping == uint64_t{rounds} * (num_threads - 1),
+      "{} + {} wakeups", stats.spinning, stats.sleeping);
+  GALOIS_LOG_ASSERT(stats.maxLatency <= stats.totalLatency);
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(
+      galois::substrate::GetThreadPool().getMaxUsableThreads());
+
+  RunRounds(std::chrono::nanoseconds(0), 100);
+  RunRounds(std::chrono::milliseconds(10), 100);
+
+  galois::substrate::GetThreadPool().setIdleSpin(std::chrono::nanoseconds(0));
+  return 0;
+}
@@ -0,0 +1,77 @@
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include "galois/Bag.h"
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+
+namespace {
+
+constexpr uint64_t kNumItems = 1000000;
+
+/// Items pushed one at a time and in bulk from every thread are all in the
+/// flattened bag, each thread's in the order pushed
+void
+TestPushFlatten(galois::InsertBag<uint64_t>* bag) {
+  galois::on_each([&](unsigned tid, unsigned nthreads) {
+    auto [begin, end] =
+        galois::block_range(uint64_t{0}, kNumItems, tid, nthreads);
+    uint64_t mid = begin + (end - begin) / 2;
+    for (uint64_t i = begin; i < mid; ++i) {
+      bag->push(i);
+    }
+    std::vector<uint64_t> rest(end - mid);
+    std::iota(rest.begin(), rest.end(), mid);
+    bag->push_bulk(rest.begin(), rest.end());
+  });
+
+  std::vector<uint64_t> flat;
+  bag->flatten_parallel(&flat);
+  GALOIS_LOG_VASSERT(flat.size() == kNumItems, "{} items", flat.size());
+  GALOIS_LOG_ASSERT(std::equal(bag->begin(), bag->end(), flat.begin()));
+  // block_range hands out increasing ranges by thread
+  for (uint64_t i = 0; i < kNumItems; ++i) {
+    GALOIS_LOG_VASSERT(flat[i] == i, "item {} is {}", i, flat[i]);
+  }
+
+  GALOIS_LOG_ASSERT(bag->size() == kNumItems);
+  std::vector<uint64_t> copied(kNumItems);
+  bag->copy_parallel(copied.data());
+  GALOIS_LOG_ASSERT(copied == flat);
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(
+      galois::substrate::GetThreadPool().getMaxUsableThreads());
+
+  galois::InsertBag<uint64_t> bag;
+  TestPushFlatten(&bag);
+
+  // rounds that reuse the blocks of the last one
+  for (int round = 0; round < 3; ++round) {
+    bag.clear_keep_blocks();
+    GALOIS_LOG_ASSERT(bag.empty());
+    TestPushFlatten(&bag);
+  }
+
+  bag.clear();
+  GALOIS_LOG_ASSERT(bag.empty());
+  std::vector<uint64_t> flat{1, 2, 3};
+  bag.flatten_parallel(&flat);
+  GALOIS_LOG_ASSERT(flat.empty());
+  GALOIS_LOG_ASSERT(bag.size() == 0);
+
+  // a bulk push larger than a block
+  std::vector<uint64_t> items(kNumItems);
+  std::iota(items.begin(), items.end(), 0);
+  bag.push_bulk(items.begin(), items.end());
+  bag.flatten_parallel(&flat);
+  GALOIS_LOG_ASSERT(flat == items);
+
+  return 0;
+}
@@ -0,0 +1,66 @@
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include "galois/Intersection.h"
+#include "galois/Logging.h"
+
+namespace {
+
+std::vector<uint32_t>
+MakeSortedSet(std::mt19937* gen, size_t size, uint32_t max_value) {
+  std::uniform_int_distribution<uint32_t> dist(0, max_value);
+  std::vector<uint32_t> values(size);
+  for (auto& v : values) {
+    v = dist(*gen);
+  }
+  std::sort(values.begin(), values.end());
+  values.erase(std::unique(values.begin(), values.end()), values.end());
+  return values;
+}
+
+void
+TestIntersection(std::mt19937* gen, size_t a_size, size_t b_size) {
+  // a small value range makes matches common
+  uint32_t max_value = 2 * std::max(a_size, b_size) + 1;
+  std::vector<uint32_t> a = MakeSortedSet(gen, a_size, max_value);
+  std::vector<uint32_t> b = MakeSortedSet(gen, b_size, max_value);
+
+  std::vector<uint32_t> expected;
+  std::set_intersection(
+      a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+
+  size_t count =
+      galois::CountSortedIntersection(a.data(), a.size(), b.data(), b.size());
+  GALOIS_LOG_VASSERT(
+      count == expected.size(), "sizes {} and {}: expected {} found {}",
+      a.size(), b.size(), expected.size(), count);
+
+  std::vector<uint32_t> found;
+  galois::ForEachSortedIntersection(
+      a.data(), a.size(), b.data(), b.size(), [&](size_t i, size_t j) {
+        GALOIS_LOG_ASSERT(a[i] == b[j]);
+        found.emplace_back(a[i]);
+      });
+  GALOIS_LOG_ASSERT(found == expected);
+}
+
+}  // namespace
+
+int
+main() {
+  std::mt19937 gen(0);
+
+  const std::vector<size_t> sizes{
+      0, 1, 3, 4, 7, 8, 9, 15, 16, 17, 31, 100, 1000, 10000};
+  for (size_t a_size : sizes) {
+    for (size_t b_size : sizes) {
+      for (int trial = 0; trial < 4; ++trial) {
+        TestIntersection(&gen, a_size, b_size);
+      }
+    }
+  }
+
+  return 0;
+}
@@ -97,6 +97,22 @@ t_doall(
   return t.get();
 }
 
+unsigned
+t_phases(bool burn, std::vector<unsigned>& V, unsigned num, unsigned th) {
+  galois::setActiveThreads(th);
+  if (burn)
+    galois::substrate::GetThreadPool().burnPower(th);
+
+  galois::Timer t;
+  t.start();
+  galois::run_phases([&](galois::PhaseContext& ctx) {
+    for (unsigned x = 0; x < iter; ++x)
+      ctx.DoAll(galois::iterate(V.begin(), V.begin() + num), emp());
+  });
+  t.stop();
+  return t.get();
+}
+
 unsigned
 t_foreach(bool burn, std::vector<unsigned>& V, unsigned num, unsigned th) {
   galois::setActiveThreads(th);
@@ -169,6 +185,7 @@ main(int argc, char** argv) {
       "doall N S", M, 16, maxVector,
       std::bind(t_doall, false, true, _1, _2, _3));
   test("foreach N", M, 16, maxVector, std::bind(t_foreach, false, _1, _2, _3));
+  test("phases N", M, 16, maxVector, std::bind(t_phases, false, _1, _2, _3));
   test(
       "doall B W", M, 16, maxVector,
       std::bind(t_doall, true, false, _1, _2, _3));
@@ -176,5 +193,6 @@ main(int argc, char** argv) {
       "doall B S", M, 16, maxVector,
       std::bind(t_doall, true, true, _1, _2, _3));
   test("foreach B", M, 16, maxVector, std::bind(t_foreach, true, _1, _2, _3));
+  test("phases B", M, 16, maxVector, std::bind(t_phases, true, _1, _2, _3));
   return 0;
 }
@@ -0,0 +1,112 @@
+#include <atomic>
+#include <chrono>
+
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+
+namespace {
+
+constexpr uint64_t kNumItems = 10000000;
+
+/// An operator that cancels the loop partway stops it well short of the end,
+/// under each way of running do_all
+template <typename... Args>
+void
+TestDoAllCancel(Args... args) {
+  galois::CancellationToken token;
+  std::atomic<uint64_t> count{0};
+
+  galois::do_all(
+      galois::iterate(uint64_t{0}, kNumItems),
+      [&](uint64_t) {
+        if (++count == 1000) {
+          token.Cancel();
+        }
+      },
+      galois::cancel_token(token), galois::no_stats(), args...);
+
+  GALOIS_LOG_ASSERT(token.cancelled());
+  GALOIS_LOG_VASSERT(count < kNumItems / 2, "ran {} iterations", count);
+}
+
+/// A deadline that has passed runs nothing
+template <typename... Args>
+void
+TestDoAllDeadline(Args... args) {
+  std::atomic<uint64_t> count{0};
+
+  galois::do_all(
+      galois::iterate(uint64_t{0}, kNumItems), [&](uint64_t) { ++count; },
+      galois::deadline(std::chrono::steady_clock::now()), galois::no_stats(),
+      args...);
+
+  GALOIS_LOG_ASSERT(count == 0);
+}
+
+/// A token that is never cancelled changes nothing
+void
+TestDoAllUncancelled() {
+  galois::CancellationToken token;
+  std::atomic<uint64_t> count{0};
+
+  galois::do_all(
+      galois::iterate(uint64_t{0}, kNumItems), [&](uint64_t) { ++count; },
+      galois::cancel_token(token), galois::steal(), galois::no_stats());
+
+  GALOIS_LOG_ASSERT(count == kNumItems);
+}
+
+/// A for_each whose work never runs out ends at its deadline, and a cancelled
+/// one drops its worklist
+void
+TestForEach() {
+  std::atomic<uint64_t> count{0};
+  galois::for_each(
+      galois::iterate({uint64_t{0}}),
+      [&](uint64_t i, auto& ctx) {
+        ++count;
+        ctx.push(i + 1);
+      },
+      galois::deadline(std::chrono::milliseconds(20)),
+      galois::disable_conflict_detection(), galois::no_stats());
+
+  galois::CancellationToken token;
+  count = 0;
+  galois::for_each(
+      galois::iterate(uint64_t{0}, kNumItems),
+      [&](uint64_t, auto&) {
+        if (++count == 1000) {
+          token.Cancel();
+        }
+      },
+      galois::cancel_token(token), galois::no_pushes(), galois::no_stats());
+  GALOIS_LOG_VASSERT(count < kNumItems / 2, "ran {} iterations", count);
+
+  // the token can end another loop once reset
+  token.Reset();
+  count = 0;
+  galois::for_each(
+      galois::iterate(uint64_t{0}, uint64_t{1000}),
+      [&](uint64_t, auto&) { ++count; }, galois::cancel_token(token),
+      galois::no_pushes(), galois::no_stats());
+  GALOIS_LOG_ASSERT(count == 1000);
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(
+      galois::substrate::GetThreadPool().getMaxUsableThreads());
+
+  TestDoAllCancel();
+  TestDoAllCancel(galois::steal());
+  TestDoAllCancel(galois::schedule::Dynamic(1));
+  TestDoAllDeadline();
+  TestDoAllDeadline(galois::steal());
+  TestDoAllUncancelled();
+  TestForEach();
+
+  return 0;
+}
@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/graphs/LC_Morph_Graph.h"
+
+namespace {
+
+constexpr size_t kNumNodes = 1000;
+constexpr size_t kDegree = 5;
+
+using Graph = galois::graphs::LC_Morph_Graph<size_t, size_t>;
+using Topology = galois::graphs::LC_Morph_Graph<size_t, void>;
+
+void
+TestBatch() {
+  Graph g;
+  std::vector<Graph::GraphNode> nodes;
+  for (size_t i = 0; i < kNumNodes; ++i) {
+    nodes.emplace_back(g.createNode(1, i));
+  }
+  // every node starts with an edge to itself, which fills its space
+  for (size_t i = 0; i < kNumNodes; ++i) {
+    g.getEdgeData(g.addMultiEdge(
+        nodes[i], nodes[i], galois::MethodFlag::UNPROTECTED)) = i;
+  }
+
+  std::vector<std::tuple<Graph::GraphNode, Graph::GraphNode, size_t>> batch;
+  for (size_t i = 0; i < kNumNodes; i += 2) {
+    for (size_t k = 1; k <= kDegree; ++k) {
+      size_t dst = (i + k) % kNumNodes;
+      batch.emplace_back(nodes[i], nodes[dst], i * kNumNodes + dst);
+    }
+  }
+  g.addEdgeBatch(batch, 1);
+
+  for (size_t i = 0; i < kNumNodes; ++i) {
+    auto edges = g.edges(nodes[i], galois::MethodFlag::UNPROTECTED);
+    size_t degree = std::distance(edges.begin(), edges.end());
+    GALOIS_LOG_ASSERT(degree == (i % 2 == 0 ? kDegree + 1 : 1));
+
+    auto ii = g.edge_begin(nodes[i], galois::MethodFlag::UNPROTECTED);
+    GALOIS_LOG_ASSERT(g.getEdgeDst(ii) == nodes[i] && g.getEdgeData(ii) == i);
+    for (size_t k = 1; k < degree; ++k) {
+      ++ii;
+      size_t dst = (i + k) % kNumNodes;
+      GALOIS_LOG_ASSERT(g.getEdgeDst(ii) == nodes[dst]);
+      GALOIS_LOG_ASSERT(g.getEdgeData(ii) == i * kNumNodes + dst);
+    }
+  }
+
+  // the spare edge of the batch takes one more edge
+  g.addMultiEdge(nodes[0], nodes[1], galois::MethodFlag::UNPROTECTED);
+  auto edges = g.edges(nodes[0], galois::MethodFlag::UNPROTECTED);
+  GALOIS_LOG_ASSERT(
+      static_cast<size_t>(std::distance(edges.begin(), edges.end())) ==
+      kDegree + 2);
+}
+
+void
+TestBatchWithoutData() {
+  Topology g;
+  std::vector<Topology::GraphNode> nodes;
+  for (size_t i = 0; i < kNumNodes; ++i) {
+    nodes.emplace_back(g.createNode(0, i));
+  }
+  std::vector<std::pair<Topology::GraphNode, Topology::GraphNode>> batch;
+  for (size_t i = 0; i < kNumNodes; ++i) {
+    batch.emplace_back(nodes[i], nodes[(i + 1) % kNumNodes]);
+  }
+  g.addEdgeBatch(batch);
+  // a second batch moves the edges of the first
+  g.addEdgeBatch(batch);
+
+  for (size_t i = 0; i < kNumNodes; ++i) {
+    auto edges = g.edges(nodes[i], galois::MethodFlag::UNPROTECTED);
+    GALOIS_LOG_ASSERT(std::distance(edges.begin(), edges.end()) == 2);
+    for (auto ii : edges) {
+      GALOIS_LOG_ASSERT(g.getEdgeDst(ii) == nodes[(i + 1) % kNumNodes]);
+    }
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(2);
+
+  TestBatch();
+  TestBatchWithoutData();
+
+  return 0;
+}
@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <iterator>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "galois/Bag.h"
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/graphs/MorphGraph.h"
+#include "galois/substrate/EpochManager.h"
+
+namespace {
+
+constexpr unsigned kNumPairs = 300;
+constexpr unsigned kNumRounds = 4;
+
+using SymGraph = galois::graphs::MorphGraph<unsigned, unsigned, false>;
+using InOutGraph = galois::graphs::MorphGraph<unsigned, unsigned, true, true>;
+
+// a parallel loop ends a round, after which everything retired is reclaimable
+void
+EndRound() {
+  galois::on_each([](unsigned, unsigned) {});
+}
+
+template <typename G>
+size_t
+Degree(G& g, typename G::GraphNode n) {
+  auto edges = g.edges(n);
+  return std::distance(edges.begin(), edges.end());
+}
+
+void
+TestEdgeReuse() {
+  SymGraph g;
+  SymGraph::GraphNode a = g.createNode(0);
+  SymGraph::GraphNode b = g.createNode(1);
+  g.addNode(a);
+  g.addNode(b);
+
+  unsigned* first = &g.getEdgeData(g.addEdge(a, b));
+  g.removeEdge(a, g.findEdge(a, b));
+  GALOIS_LOG_ASSERT(g.findEdge(b, a) == g.edge_end(b));
+  // readers of this epoch may still see the removed edge
+  unsigned* second = &g.getEdgeData(g.addEdge(a, b));
+  GALOIS_LOG_ASSERT(second != first);
+  g.removeEdge(b, g.findEdge(b, a));
+
+  EndRound();
+  auto edge = g.addEdge(a, b);
+  unsigned* third = &g.getEdgeData(edge);
+  GALOIS_LOG_ASSERT(third == first || third == second);
+  GALOIS_LOG_ASSERT(*third == 0);
+  GALOIS_LOG_ASSERT(&g.getEdgeData(g.findEdge(b, a)) == third);
+}
+
+void
+TestNodeReuse() {
+  SymGraph g;
+  g.setReuseRemovedNodes(true);
+  std::vector<SymGraph::GraphNode> v;
+  for (unsigned i = 0; i < 4; ++i) {
+    v.emplace_back(g.createNode(i));
+    g.addNode(v.back());
+  }
+  for (unsigned i = 0; i < 4; ++i) {
+    for (unsigned j = i + 1; j < 4; ++j) {
+      g.getEdgeData(g.addEdge(v[i], v[j])) = i + j;
+    }
+  }
+
+  g.removeNode(v[0]);
+  GALOIS_LOG_ASSERT(g.createNode(4) != v[0]);
+
+  EndRound();
+  SymGraph::GraphNode n = g.createNode(5);
+  GALOIS_LOG_ASSERT(n == v[0]);
+  GALOIS_LOG_ASSERT(g.getData(n) == 5);
+  g.addNode(n);
+  // removing the node also erased its edges at the neighbors
+  GALOIS_LOG_ASSERT(Degree(g, n) == 0);
+  for (unsigned i = 1; i < 4; ++i) {
+    GALOIS_LOG_ASSERT(Degree(g, v[i]) == 2);
+  }
+}
+
+void
+TestEpochAdvances() {
+  galois::substrate::EpochManager& epochs =
+      galois::substrate::GetEpochManager();
+  uint64_t before = epochs.epoch();
+  galois::for_each(
+      galois::iterate(0U, 10000U), [](unsigned, auto&) {},
+      galois::disable_conflict_detection());
+  // the end of the loop adds 2, and the iterations at least once more
+  GALOIS_LOG_ASSERT(epochs.epoch() > before + 2);
+}
+
+// Each iteration replaces one end of its own pair of nodes and the edges
+// between them, while other threads do the same to theirs
+void
+TestConcurrentReuse() {
+  InOutGraph g;
+  g.setReuseRemovedNodes(true);
+  std::vector<std::pair<InOutGraph::GraphNode, InOutGraph::GraphNode>> pairs;
+  for (unsigned i = 0; i < kNumPairs; ++i) {
+    InOutGraph::GraphNode u = g.createNode(i);
+    InOutGraph::GraphNode w = g.createNode(i);
+    g.addNode(u);
+    g.addNode(w);
+    g.getEdgeData(g.addEdge(u, w)) = i;
+    pairs.emplace_back(u, w);
+  }
+
+  galois::InsertBag<InOutGraph::GraphNode> created;
+  for (unsigned round = 0; round < kNumRounds; ++round) {
+    galois::for_each(
+        galois::iterate(0U, kNumPairs),
+        [&](unsigned i, auto&) {
+          auto [u, w] = pairs[i];
+          g.removeNode(u);
+          InOutGraph::GraphNode n = g.createNode(i);
+          g.addNode(n);
+          g.getEdgeData(g.addEdge(n, w)) = i;
+          g.getEdgeData(g.addEdge(w, n)) = round;
+          g.removeEdge(w, g.findEdge(w, n));
+          g.getEdgeData(g.addEdge(w, n)) = i;
+          pairs[i].first = n;
+          created.push(n);
+        },
+        galois::loopname("Reclaim"));
+  }
+
+  std::set<InOutGraph::GraphNode> distinct(created.begin(), created.end());
+  GALOIS_LOG_ASSERT(distinct.size() < kNumPairs * kNumRounds);
+
+  size_t num_nodes = 0;
+  for (InOutGraph::GraphNode n : g) {
+    ++num_nodes;
+    GALOIS_LOG_ASSERT(Degree(g, n) == 1);
+    for (auto e : g.edges(n)) {
+      InOutGraph::GraphNode dst = g.getEdgeDst(e);
+      GALOIS_LOG_ASSERT(g.getEdgeData(e) == g.getData(n));
+      auto in = g.findInEdge(dst, n);
+      GALOIS_LOG_ASSERT(in != g.in_edge_end(dst));
+      GALOIS_LOG_ASSERT(&g.getEdgeData(in) == &g.getEdgeData(e));
+    }
+  }
+  GALOIS_LOG_ASSERT(num_nodes == 2 * kNumPairs);
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys G;
+  galois::setActiveThreads(galois::substrate::GetThreadPool().getMaxThreads());
+
+  TestEdgeReuse();
+  TestNodeReuse();
+  TestEpochAdvances();
+  TestConcurrentReuse();
+
+  return 0;
+}
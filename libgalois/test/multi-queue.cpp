@@ -0,0 +1,89 @@
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/Reduction.h"
+#include "galois/worklists/MultiQueue.h"
+
+namespace {
+
+using WL = galois::worklists::MultiQueue<>;
+
+/// Expand every item below depth into two children
+void
+TestBinaryTree(uint32_t depth) {
+  galois::GAccumulator<uint64_t> visited;
+  std::vector<uint32_t> roots{0};
+
+  galois::for_each(
+      galois::iterate(roots),
+      [&](uint32_t level, auto& ctx) {
+        visited += 1;
+        if (level < depth) {
+          ctx.push(level + 1);
+          ctx.push(level + 1);
+        }
+      },
+      galois::wl<WL>(), galois::no_stats());
+
+  GALOIS_LOG_ASSERT(visited.reduce() == (uint64_t{2} << depth) - 1);
+}
+
+/// Every initial item is popped exactly once
+void
+TestInitialRange(uint32_t num_items, unsigned relaxation) {
+  std::vector<std::atomic<uint32_t>> counts(num_items);
+
+  galois::for_each(
+      galois::iterate(uint32_t{0}, num_items),
+      [&](uint32_t i, auto&) { counts[i] += 1; },
+      galois::wl<WL>(std::less<>(), relaxation), galois::no_stats());
+
+  for (const auto& count : counts) {
+    GALOIS_LOG_ASSERT(count == 1);
+  }
+}
+
+/// With one thread and two heaps, items pushed in reverse come out nearly
+/// sorted
+void
+TestOrder(uint32_t num_items) {
+  std::vector<uint32_t> items;
+  for (uint32_t i = num_items; i-- > 0;) {
+    items.push_back(i);
+  }
+
+  std::vector<uint32_t> order;
+  galois::for_each(
+      galois::iterate(items), [&](uint32_t i, auto&) { order.push_back(i); },
+      galois::wl<WL>(std::less<>(), 1), galois::no_stats());
+
+  GALOIS_LOG_ASSERT(order.size() == num_items);
+  // Each pop takes the better top of two randomly sampled heaps, so items
+  // leave on average about one place from their rank
+  uint64_t displacement = 0;
+  for (uint32_t i = 0; i < num_items; ++i) {
+    displacement += order[i] > i ? order[i] - i : i - order[i];
+  }
+  GALOIS_LOG_ASSERT(displacement < uint64_t{16} * num_items);
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+
+  galois::setActiveThreads(1);
+  TestOrder(10000);
+
+  galois::setActiveThreads(
+      galois::substrate::GetThreadPool().getMaxUsableThreads());
+  TestBinaryTree(16);
+  TestInitialRange(100000, WL::kDefaultRelaxation);
+  TestInitialRange(100000, 8);
+
+  return 0;
+}
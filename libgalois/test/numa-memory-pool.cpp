@@ -0,0 +1,120 @@
+#include <cstring>
+
+#include <arrow/api.h>
+
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/NumaMemoryPool.h"
+#include "galois/SharedMemSys.h"
+#include "galois/substrate/PageAlloc.h"
+#include "tsuba/MemoryPool.h"
+
+namespace {
+
+void
+TestAllocateAndFree(galois::NumaMemoryPool* pool) {
+  int64_t page = galois::substrate::allocSize();
+  int64_t before = pool->bytes_allocated();
+
+  for (int64_t size : {int64_t{0}, int64_t{64}, page - 1, page, 3 * page + 5}) {
+    uint8_t* ptr{};
+    GALOIS_LOG_ASSERT(pool->Allocate(size, &ptr).ok());
+    GALOIS_LOG_ASSERT(reinterpret_cast<uintptr_t>(ptr) % 64 == 0);
+    std::memset(ptr, 1, size);
+    GALOIS_LOG_ASSERT(pool->bytes_allocated() == before + size);
+    pool->Free(ptr, size);
+    GALOIS_LOG_ASSERT(pool->bytes_allocated() == before);
+  }
+}
+
+void
+TestReallocate(galois::NumaMemoryPool* pool) {
+  int64_t page = galois::substrate::allocSize();
+  int64_t before = pool->bytes_allocated();
+
+  // grow from the default pool to pages, within the pages and past them, then
+  // shrink back
+  int64_t sizes[] = {100, page + 1, 2 * page, 2 * page + 1, 16};
+  uint8_t* ptr{};
+  int64_t size = 10;
+  GALOIS_LOG_ASSERT(pool->Allocate(size, &ptr).ok());
+  for (int64_t i = 0; i < size; ++i) {
+    ptr[i] = i;
+  }
+  for (int64_t new_size : sizes) {
+    GALOIS_LOG_ASSERT(pool->Reallocate(size, new_size, &ptr).ok());
+    for (int64_t i = 0; i < 10; ++i) {
+      GALOIS_LOG_ASSERT(ptr[i] == i);
+    }
+    std::memset(ptr + 10, 2, new_size - 10);
+    size = new_size;
+    GALOIS_LOG_ASSERT(pool->bytes_allocated() == before + size);
+  }
+  pool->Free(ptr, size);
+  GALOIS_LOG_ASSERT(pool->bytes_allocated() == before);
+  GALOIS_LOG_ASSERT(pool->max_memory() >= before + 2 * page + 1);
+}
+
+void
+TestInstall(galois::NumaMemoryPool* pool) {
+  arrow::MemoryPool* original = tsuba::GetArrowMemoryPool();
+  {
+    tsuba::ScopedArrowMemoryPool scope(pool);
+    GALOIS_LOG_ASSERT(tsuba::GetArrowMemoryPool() == pool);
+
+    // a builder large enough to move onto pages
+    int64_t before = pool->bytes_allocated();
+    arrow::UInt64Builder builder(tsuba::GetArrowMemoryPool());
+    uint64_t num = galois::substrate::allocSize();
+    for (uint64_t i = 0; i < num; ++i) {
+      GALOIS_LOG_ASSERT(builder.Append(i).ok());
+    }
+    std::shared_ptr<arrow::Array> array;
+    GALOIS_LOG_ASSERT(builder.Finish(&array).ok());
+    GALOIS_LOG_ASSERT(pool->bytes_allocated() > before);
+
+    auto values = std::static_pointer_cast<arrow::UInt64Array>(array);
+    for (uint64_t i = 0; i < num; ++i) {
+      GALOIS_LOG_ASSERT(values->Value(i) == i);
+    }
+    array.reset();
+    values.reset();
+    GALOIS_LOG_ASSERT(pool->bytes_allocated() == before);
+  }
+  GALOIS_LOG_ASSERT(tsuba::GetArrowMemoryPool() == original);
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(
+      galois::substrate::GetThreadPool().getMaxUsableThreads());
+
+  for (auto policy :
+       {galois::NumaMemoryPool::kBlocked, galois::NumaMemoryPool::kLocal,
+        galois::NumaMemoryPool::kInterleaved,
+        galois::NumaMemoryPool::kFloating}) {
+    galois::NumaMemoryPool* pool = galois::NumaMemoryPool::Get(policy);
+    GALOIS_LOG_ASSERT(pool->policy() == policy);
+    TestAllocateAndFree(pool);
+    TestReallocate(pool);
+    TestInstall(pool);
+  }
+
+  // allocations from inside parallel loops do not use the thread pool
+  galois::NumaMemoryPool* pool =
+      galois::NumaMemoryPool::Get(galois::NumaMemoryPool::kInterleaved);
+  int64_t before = pool->bytes_allocated();
+  galois::on_each([&](unsigned, unsigned) {
+    int64_t size = 2 * galois::substrate::allocSize();
+    uint8_t* ptr{};
+    GALOIS_LOG_ASSERT(pool->Allocate(size, &ptr).ok());
+    std::memset(ptr, 1, size);
+    pool->Free(ptr, size);
+  });
+  GALOIS_LOG_ASSERT(pool->bytes_allocated() == before);
+
+  return 0;
+}
@@ -1,3 +1,5 @@
+#include <arrow/builder.h>
+
 #include "galois/Properties.h"
 
 template <typename ViewType, typename T, typename U>
@@ -77,6 +79,83 @@ TestString() {
   TestSliced<ViewType>(vec, array, 1, vec.size() - 6);
 }
 
+/// The unchecked view reads the same values where there are no nulls
+template <typename ViewType, typename T, typename U>
+void
+CompareUnchecked(
+    const std::vector<std::optional<T>>& vec, const std::shared_ptr<U>& array) {
+  auto res = ViewType::Unchecked::Make(*array);
+  GALOIS_LOG_ASSERT(res);
+  auto view = std::move(res.value());
+  for (size_t i = 0, n = vec.size(); i < n; ++i) {
+    GALOIS_LOG_ASSERT(view.IsValid(i) == vec[i].has_value());
+    if (vec[i]) {
+      GALOIS_LOG_ASSERT(*vec[i] == view[i]);
+    }
+  }
+}
+
+void
+TestUnchecked() {
+  std::vector<std::optional<std::string>> strings{
+      "a", std::nullopt, "bc", "", "def"};
+  CompareUnchecked<galois::StringReadOnlyProperty::ViewType>(
+      strings, MakeArray(strings));
+  std::vector<std::optional<bool>> bools{true, std::nullopt, false, true};
+  CompareUnchecked<galois::BooleanReadOnlyProperty::ViewType>(
+      bools, MakeArray(bools));
+
+  static_assert(std::is_same_v<
+                galois::PropertyViewType<
+                    galois::Unchecked<galois::LargeStringReadOnlyProperty>>,
+                galois::StringPropertyReadOnlyView<
+                    arrow::LargeStringArray, false>>);
+}
+
+void
+TestList() {
+  using ListType = std::vector<uint32_t>;
+  std::vector<std::optional<ListType>> vec{
+      ListType{1, 2},    std::nullopt, ListType{}, ListType{3},
+      std::nullopt,      ListType{4, 5, 6},        ListType{7}};
+
+  arrow::ListBuilder builder(
+      arrow::default_memory_pool(), std::make_shared<arrow::UInt32Builder>());
+  auto* values = static_cast<arrow::UInt32Builder*>(builder.value_builder());
+  for (const auto& v : vec) {
+    if (v) {
+      GALOIS_LOG_ASSERT(builder.Append().ok());
+      for (uint32_t x : *v) {
+        GALOIS_LOG_ASSERT(values->Append(x).ok());
+      }
+    } else {
+      GALOIS_LOG_ASSERT(builder.AppendNull().ok());
+    }
+  }
+  std::shared_ptr<arrow::ListArray> array;
+  GALOIS_LOG_ASSERT(builder.Finish(&array).ok());
+
+  using ViewType = galois::ListReadOnlyProperty<uint32_t>::ViewType;
+  for (size_t offset : {0, 1, 3}) {
+    auto slice = std::static_pointer_cast<arrow::ListArray>(
+        array->Slice(offset, vec.size() - offset));
+    auto res = ViewType::Make(*slice);
+    GALOIS_LOG_ASSERT(res);
+    auto view = std::move(res.value());
+    for (size_t i = 0; i + offset < vec.size(); ++i) {
+      const auto& expected = vec[i + offset];
+      GALOIS_LOG_ASSERT(view.IsValid(i) == expected.has_value());
+      galois::Span<const uint32_t> span = view[i];
+      ListType actual(span.begin(), span.end());
+      GALOIS_LOG_ASSERT(actual == expected.value_or(ListType{}));
+    }
+  }
+
+  // a list of another type is a type error
+  GALOIS_LOG_ASSERT(!galois::ListReadOnlyProperty<uint64_t>::ViewType::Make(
+      *array));
+}
+
 void
 TestBool() {
   using VecType = std::vector<std::optional<bool>>;
@@ -103,6 +182,8 @@ main() {
   TestPOD<double>();
   TestString();
   TestBool();
+  TestUnchecked();
+  TestList();
   GALOIS_LOG_VERBOSE("success");
   return 0;
 }
@@ -0,0 +1,221 @@
+#include <boost/filesystem.hpp>
+
+#include "TestPropertyGraph.h"
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/OpLog.h"
+#include "galois/Uri.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+using galois::ImportData;
+using galois::ImportDataType;
+using galois::Operation;
+using galois::OpTypes;
+using galois::PropertyKey;
+
+constexpr uint64_t kNumNodes = 100;
+
+Operation
+NodeValue(uint64_t node, const std::string& name, int64_t v) {
+  ImportData data(ImportDataType::kInt64, false);
+  data.value = v;
+  return Operation(
+      OpTypes::kOpNodePropVal,
+      PropertyKey(
+          std::to_string(node), true, false, name, ImportDataType::kInt64,
+          false),
+      data);
+}
+
+Operation
+EdgeValue(uint64_t edge, const std::string& v) {
+  ImportData data(ImportDataType::kString, false);
+  data.value = v;
+  return Operation(
+      OpTypes::kOpEdgePropVal,
+      PropertyKey(
+          std::to_string(edge), false, true, "label", ImportDataType::kString,
+          false),
+      data);
+}
+
+Operation
+NodeDelete(uint64_t node, const std::string& name) {
+  return Operation(
+      OpTypes::kOpNodePropDel,
+      PropertyKey(
+          std::to_string(node), true, false, name, ImportDataType::kInt64,
+          false));
+}
+
+void
+TestEncoding() {
+  galois::OpLog log;
+  for (uint64_t n = 0; n < kNumNodes; ++n) {
+    GALOIS_LOG_ASSERT(log.AppendOp(NodeValue(n, "age", -int64_t(n))) == n);
+  }
+  ImportData list(ImportDataType::kDouble, true);
+  list.value = std::vector<double>{0.5, 1.5};
+  log.AppendOp(Operation(
+      OpTypes::kOpNodePropVal,
+      PropertyKey("0x10", true, false, "scores", ImportDataType::kDouble, true),
+      list));
+  GALOIS_LOG_ASSERT(log.size() == kNumNodes + 1);
+  // the key is stored once, so each value takes a few bytes
+  GALOIS_LOG_ASSERT(log.num_bytes() < 16 * kNumNodes);
+
+  Operation op = log.GetOp(7);
+  GALOIS_LOG_ASSERT(op.opcode() == OpTypes::kOpNodePropVal);
+  GALOIS_LOG_ASSERT(op.id() == 7 && op.key().name == "age");
+  GALOIS_LOG_ASSERT(op.key().for_node && !op.key().for_edge);
+  GALOIS_LOG_ASSERT(std::get<int64_t>(op.data().value) == -7);
+
+  Operation list_op = log.GetOp(kNumNodes);
+  GALOIS_LOG_ASSERT(list_op.key().id == "0x10" && list_op.id() == 16);
+  GALOIS_LOG_ASSERT(list_op.data().is_list);
+  GALOIS_LOG_ASSERT(
+      std::get<std::vector<double>>(list_op.data().value) ==
+      std::vector<double>({0.5, 1.5}));
+}
+
+void
+TestCommit() {
+  auto uri_res = galois::Uri::MakeRand("/tmp/oplog");
+  GALOIS_LOG_ASSERT(uri_res);
+  galois::Uri uri = uri_res.value();
+
+  auto make_result = galois::OpLog::Make(uri);
+  GALOIS_LOG_VASSERT(make_result, "{}", make_result.error());
+  galois::OpLog log = std::move(make_result.value());
+  GALOIS_LOG_ASSERT(log.size() == 0);
+  for (uint64_t n = 0; n < 10; ++n) {
+    log.AppendOp(NodeValue(n, "age", n));
+  }
+  GALOIS_LOG_ASSERT(log.HasUncommitted());
+  GALOIS_LOG_ASSERT(log.Commit());
+  GALOIS_LOG_ASSERT(!log.HasUncommitted());
+  log.AppendOp(EdgeValue(3, "knows"));
+  log.AppendOp(NodeValue(4, "age", 40));
+  GALOIS_LOG_ASSERT(log.Commit());
+  // not committed
+  log.AppendOp(NodeValue(5, "age", 50));
+
+  auto reload_result = galois::OpLog::Make(uri);
+  GALOIS_LOG_VASSERT(reload_result, "{}", reload_result.error());
+  galois::OpLog reloaded = std::move(reload_result.value());
+  GALOIS_LOG_ASSERT(reloaded.size() == 12);
+  GALOIS_LOG_ASSERT(std::get<int64_t>(reloaded.GetOp(11).data().value) == 40);
+  GALOIS_LOG_ASSERT(
+      std::get<std::string>(reloaded.GetOp(10).data().value) == "knows");
+
+  // appends after a reload go to a new segment
+  reloaded.AppendOp(NodeValue(5, "age", 50));
+  GALOIS_LOG_ASSERT(reloaded.Commit());
+  auto again_result = galois::OpLog::Make(uri);
+  GALOIS_LOG_ASSERT(again_result && again_result.value().size() == 13);
+
+  GALOIS_LOG_ASSERT(reloaded.Clear());
+  auto cleared_result = galois::OpLog::Make(uri);
+  GALOIS_LOG_ASSERT(cleared_result && cleared_result.value().size() == 0);
+  fs::remove_all(uri.path());
+
+  galois::OpLog in_memory;
+  in_memory.AppendOp(NodeValue(0, "age", 0));
+  auto res = in_memory.Commit();
+  GALOIS_LOG_ASSERT(
+      !res && res.error() == galois::ErrorCode::InvalidArgument);
+}
+
+void
+TestMerge() {
+  LinePolicy policy{1};
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g =
+      MakeFileGraph<int64_t>(kNumNodes, 1, &policy);
+  std::vector<int64_t> ages(kNumNodes, 1);
+  GALOIS_LOG_ASSERT(g->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("age", arrow::int64())}),
+      {galois::BuildArray(ages)})));
+
+  galois::OpLog log;
+  for (uint64_t n = 0; n < kNumNodes; n += 2) {
+    log.AppendOp(NodeValue(n, "age", n));
+  }
+  // later operations win and out of bounds ones are ignored
+  log.AppendOp(NodeValue(4, "age", 400));
+  log.AppendOp(NodeDelete(6, "age"));
+  log.AppendOp(NodeValue(kNumNodes, "age", 0));
+  log.AppendOp(NodeValue(1, "rank", 10));
+  log.AppendOp(EdgeValue(2, "knows"));
+
+  auto update_result = galois::GraphUpdate::Make(
+      log, g->topology().num_nodes(), g->topology().num_edges());
+  GALOIS_LOG_VASSERT(update_result, "{}", update_result.error());
+  const galois::GraphUpdate& update = update_result.value();
+  GALOIS_LOG_ASSERT(update.num_nprop() == 2 && update.num_eprop() == 1);
+  GALOIS_LOG_ASSERT(update.GetNUpdates(0).size() == kNumNodes / 2);
+  GALOIS_LOG_ASSERT(update.GetNUpdates(0).at(4) == kNumNodes / 2);
+
+  auto merge_result = update.MergeInto(log, g.get());
+  GALOIS_LOG_VASSERT(merge_result, "{}", merge_result.error());
+  auto age = std::static_pointer_cast<arrow::Int64Array>(
+      g->NodeProperty("age")->chunk(0));
+  for (uint64_t n = 0; n < kNumNodes; ++n) {
+    if (n == 6) {
+      GALOIS_LOG_ASSERT(age->IsNull(n));
+    } else if (n == 4) {
+      GALOIS_LOG_ASSERT(age->Value(n) == 400);
+    } else {
+      GALOIS_LOG_ASSERT(age->Value(n) == (n % 2 == 0 ? int64_t(n) : 1));
+    }
+  }
+  auto rank = std::static_pointer_cast<arrow::Int64Array>(
+      g->NodeProperty("rank")->chunk(0));
+  GALOIS_LOG_ASSERT(rank->null_count() == kNumNodes - 1);
+  GALOIS_LOG_ASSERT(rank->Value(1) == 10);
+  auto label = std::static_pointer_cast<arrow::StringArray>(
+      g->EdgeProperty("label")->chunk(0));
+  GALOIS_LOG_ASSERT(label->GetString(2) == "knows");
+
+  // a value that does not fit the existing property
+  galois::OpLog mistyped;
+  mistyped.AppendOp(EdgeValue(0, "x"));
+  ImportData text(ImportDataType::kString, false);
+  text.value = std::string("old");
+  mistyped.AppendOp(Operation(
+      OpTypes::kOpNodePropVal,
+      PropertyKey("0", true, false, "age", ImportDataType::kString, false),
+      text));
+  auto mistyped_update =
+      galois::GraphUpdate::Make(mistyped, kNumNodes, g->topology().num_edges());
+  GALOIS_LOG_ASSERT(mistyped_update);
+  auto mistyped_result = mistyped_update.value().MergeInto(mistyped, g.get());
+  GALOIS_LOG_ASSERT(
+      !mistyped_result &&
+      mistyped_result.error() == galois::ErrorCode::TypeError);
+
+  galois::OpLog topology;
+  topology.AppendOp(Operation(
+      OpTypes::kOpNodeAdd,
+      PropertyKey("1", ImportDataType::kUnsupported, false)));
+  auto topology_result = galois::GraphUpdate::Make(topology, kNumNodes, 0);
+  GALOIS_LOG_ASSERT(
+      !topology_result &&
+      topology_result.error() == galois::ErrorCode::NotImplemented);
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(2);
+
+  TestEncoding();
+  TestCommit();
+  TestMerge();
+
+  return 0;
+}
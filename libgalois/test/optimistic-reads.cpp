@@ -0,0 +1,113 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include <vector>
+
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/runtime/Context.h"
+
+namespace {
+
+struct Account : public galois::runtime::Lockable {
+  int balance = 0;
+};
+
+constexpr int kNumAccounts = 16;
+constexpr int kNumItems = 20000;
+constexpr int kTotal = 1000 * kNumAccounts;
+
+/// Odd items move money between two accounts and even ones read two accounts
+/// and check that they hold what no transfer has touched. Readers that see a
+/// transfer halfway must be aborted, so every check that commits holds.
+template <typename... Args>
+void
+TestTransfers(Args... args) {
+  std::vector<Account> accounts(kNumAccounts);
+  for (auto& a : accounts) {
+    a.balance = kTotal / kNumAccounts;
+  }
+  // transfers move one unit from account 2k to account 2k+1 and back, so
+  // each such pair always holds twice the initial balance
+  std::vector<int> observed(kNumItems, 0);
+
+  galois::for_each(
+      galois::iterate(0, kNumItems),
+      [&](int i, auto&) {
+        int pair = (i / 2) % (kNumAccounts / 2);
+        Account& a = accounts[2 * pair];
+        Account& b = accounts[2 * pair + 1];
+        if (i % 2) {
+          galois::runtime::acquire(&a, galois::MethodFlag::WRITE);
+          galois::runtime::acquire(&b, galois::MethodFlag::WRITE);
+          int amount = (i / 2) % 3 == 0 ? -1 : 1;
+          a.balance -= amount;
+          b.balance += amount;
+        } else {
+          galois::runtime::acquire(&a, galois::MethodFlag::READ);
+          galois::runtime::acquire(&b, galois::MethodFlag::READ);
+          observed[i] = a.balance + b.balance;
+        }
+      },
+      galois::no_pushes(), args...);
+
+  int total = 0;
+  for (const auto& a : accounts) {
+    total += a.balance;
+  }
+  GALOIS_LOG_ASSERT(total == kTotal);
+  for (int i = 0; i < kNumItems; i += 2) {
+    GALOIS_LOG_VASSERT(
+        observed[i] == 2 * kTotal / kNumAccounts, "item {} saw {}", i,
+        observed[i]);
+  }
+}
+
+/// Reads followed by a write of what was read lose no updates
+void
+TestReadThenWrite() {
+  Account counter;
+  galois::for_each(
+      galois::iterate(0, kNumItems),
+      [&](int, auto&) {
+        galois::runtime::acquire(&counter, galois::MethodFlag::READ);
+        int value = counter.balance;
+        galois::runtime::acquire(&counter, galois::MethodFlag::WRITE);
+        counter.balance = value + 1;
+      },
+      galois::no_pushes(), galois::optimistic_reads(),
+      galois::loopname("ReadThenWrite"));
+  GALOIS_LOG_VASSERT(
+      counter.balance == kNumItems, "counted {}", counter.balance);
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(
+      galois::substrate::GetThreadPool().getMaxUsableThreads());
+
+  TestTransfers();
+  TestTransfers(galois::optimistic_reads());
+  TestReadThenWrite();
+
+  return 0;
+}
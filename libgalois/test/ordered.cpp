@@ -0,0 +1,160 @@
+#include <atomic>
+#include <cstdint>
+#include <queue>
+#include <vector>
+
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/runtime/Context.h"
+
+namespace {
+
+constexpr uint32_t kNumStations = 64;
+
+/// An event of a discrete-event simulation: at time, station and the next
+/// one both record it
+struct Event {
+  uint32_t time;
+  uint32_t station;
+};
+
+struct EventBefore {
+  bool operator()(const Event& a, const Event& b) const {
+    return a.time < b.time || (a.time == b.time && a.station < b.station);
+  }
+};
+
+struct EventAfter {
+  bool operator()(const Event& a, const Event& b) const {
+    return EventBefore()(b, a);
+  }
+};
+
+uint32_t
+Next(uint32_t station) {
+  return (station + 1) % kNumStations;
+}
+
+/// The event that an event creates before horizon, if any; never earlier
+/// than it
+bool
+Successor(const Event& e, uint32_t horizon, Event* next) {
+  uint32_t time = e.time + 1 + (e.station * 7 + e.time) % 5;
+  if (time >= horizon) {
+    return false;
+  }
+  *next = Event{time, (e.station * 13 + e.time) % kNumStations};
+  return true;
+}
+
+std::vector<Event>
+MakeEvents(uint32_t num_events, uint32_t max_time) {
+  std::vector<Event> events;
+  for (uint32_t i = 0; i < num_events; ++i) {
+    events.emplace_back(Event{(i * 37) % max_time, (i * 11) % kNumStations});
+  }
+  return events;
+}
+
+struct Station {
+  galois::runtime::Lockable lock;
+  std::vector<Event> log;
+};
+
+std::vector<std::vector<Event>>
+SerialLogs(const std::vector<Event>& initial, uint32_t horizon) {
+  std::vector<std::vector<Event>> logs(kNumStations);
+  std::priority_queue<Event, std::vector<Event>, EventAfter> queue;
+  for (const Event& e : initial) {
+    queue.push(e);
+  }
+  while (!queue.empty()) {
+    Event e = queue.top();
+    queue.pop();
+    logs[e.station].emplace_back(e);
+    logs[Next(e.station)].emplace_back(e);
+    if (Event next; Successor(e, horizon, &next)) {
+      queue.push(next);
+    }
+  }
+  return logs;
+}
+
+template <typename RunFn>
+void
+TestEvents(std::vector<Event> initial, uint32_t horizon, RunFn run) {
+  std::vector<Station> stations(kNumStations);
+  auto nh_func = [&](const Event& e) {
+    galois::runtime::acquire(
+        &stations[e.station].lock, galois::MethodFlag::WRITE);
+    galois::runtime::acquire(
+        &stations[Next(e.station)].lock, galois::MethodFlag::WRITE);
+  };
+  auto op_func = [&](const Event& e, galois::UserContext<Event>& ctx) {
+    stations[e.station].log.emplace_back(e);
+    stations[Next(e.station)].log.emplace_back(e);
+    if (Event next; Successor(e, horizon, &next)) {
+      ctx.push(next);
+    }
+  };
+
+  run(initial.begin(), initial.end(), nh_func, op_func);
+
+  // events of the same time and station may run in either order, but they
+  // are indistinguishable
+  std::vector<std::vector<Event>> expected = SerialLogs(initial, horizon);
+  for (uint32_t s = 0; s < kNumStations; ++s) {
+    const auto& log = stations[s].log;
+    GALOIS_LOG_ASSERT(log.size() == expected[s].size());
+    for (size_t i = 0; i < log.size(); ++i) {
+      GALOIS_LOG_ASSERT(log[i].time == expected[s][i].time);
+      GALOIS_LOG_ASSERT(log[i].station == expected[s][i].station);
+    }
+  }
+}
+
+/// Without new events, every safe source is stable
+void
+TestStableSource() {
+  TestEvents(
+      MakeEvents(20000, 1000), 0,
+      [](auto beg, auto end, auto& nh_func, auto& op_func) {
+        galois::for_each_ordered(
+            beg, end, EventBefore(), nh_func, op_func, "ordered-stable");
+      });
+}
+
+/// New events may come before any event but the earliest, which the
+/// executor runs whatever the stability test says
+void
+TestStabilityTest() {
+  std::atomic<uint64_t> tested{0};
+  auto stable = [&](const Event&) {
+    tested.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  };
+  TestEvents(
+      MakeEvents(16, 4), 200,
+      [&](auto beg, auto end, auto& nh_func, auto& op_func) {
+        galois::for_each_ordered(
+            beg, end, EventBefore(), nh_func, op_func, stable,
+            "ordered-unstable");
+      });
+  GALOIS_LOG_ASSERT(tested.load() > 0);
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys G;
+  galois::setActiveThreads(galois::substrate::GetThreadPool().getMaxThreads());
+
+  TestStableSource();
+  TestStabilityTest();
+
+  galois::setActiveThreads(1);
+  TestStableSource();
+
+  return 0;
+}
@@ -0,0 +1,81 @@
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/Reduction.h"
+#include "galois/substrate/PageAlloc.h"
+#include "galois/worklists/OwnerComputes.h"
+
+namespace {
+
+using galois::substrate::ThreadPool;
+using galois::worklists::BlockedOwner;
+using WL = galois::worklists::OwnerComputes<BlockedOwner>;
+
+/// Equal sections of whole pages go to the threads in order
+void
+TestBlockedOwner(unsigned num_threads) {
+  const size_t page = galois::substrate::allocSize();
+  // 8 pages of 64 elements
+  const size_t elements_per_page = 64;
+  const size_t num_elements = 8 * elements_per_page;
+  BlockedOwner owner(num_elements, page / elements_per_page, num_threads);
+
+  for (size_t i = 0; i < num_elements; ++i) {
+    size_t page_index = i / elements_per_page;
+    GALOIS_LOG_ASSERT(owner(i) == page_index * num_threads / 8);
+  }
+
+  // what does not fill a page is all on the first thread's
+  BlockedOwner small(100, sizeof(uint32_t), num_threads);
+  for (size_t i = 0; i < 100; ++i) {
+    GALOIS_LOG_ASSERT(small(i) == 0);
+  }
+}
+
+/// Every item runs once, and nearly all of them on the socket of their owner
+void
+TestRouting(uint32_t num_items) {
+  auto& tp = galois::substrate::GetThreadPool();
+  BlockedOwner owner(
+      num_items, galois::substrate::allocSize(), galois::getActiveThreads());
+  std::vector<std::atomic<uint32_t>> counts(num_items);
+  galois::GAccumulator<uint32_t> remote;
+
+  // the first half pushes the second
+  galois::for_each(
+      galois::iterate(uint32_t{0}, num_items / 2),
+      [&](uint32_t i, auto& ctx) {
+        counts[i] += 1;
+        if (tp.getSocket(owner(i)) != ThreadPool::getSocket()) {
+          remote += 1;
+        }
+        if (i < num_items / 2) {
+          ctx.push(num_items - 1 - i);
+        }
+      },
+      galois::wl<WL>(owner), galois::no_stats());
+
+  for (const auto& count : counts) {
+    GALOIS_LOG_ASSERT(count == 1);
+  }
+  // a thread only keeps an item of another socket when it runs out of work
+  GALOIS_LOG_ASSERT(remote.reduce() <= num_items / 16);
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys G;
+  galois::setActiveThreads(galois::substrate::GetThreadPool().getMaxThreads());
+
+  TestBlockedOwner(1);
+  TestBlockedOwner(4);
+  TestBlockedOwner(galois::getActiveThreads());
+  TestRouting(1 << 12);
+
+  return 0;
+}
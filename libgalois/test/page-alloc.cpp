@@ -0,0 +1,56 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/substrate/PageAlloc.h"
+
+#include <cstdint>
+
+#include "galois/Logging.h"
+
+using namespace galois::substrate;
+
+size_t
+TotalPages(const PageAllocStats& stats) {
+  return stats.hugetlb_pages + stats.thp_pages + stats.small_pages;
+}
+
+int
+main() {
+  const unsigned num = 4;
+  PageAllocStats before = getPageAllocStats();
+
+  void* ptr = allocPages(num, true);
+  GALOIS_LOG_ASSERT(ptr);
+  // every kind of backing is aligned to a huge page
+  GALOIS_LOG_ASSERT(reinterpret_cast<uintptr_t>(ptr) % allocSize() == 0);
+  for (size_t i = 0; i < num * allocSize(); i += 4096) {
+    GALOIS_LOG_ASSERT(static_cast<char*>(ptr)[i] == 0);
+  }
+
+  PageAllocStats during = getPageAllocStats();
+  GALOIS_LOG_ASSERT(TotalPages(during) == TotalPages(before) + num);
+  GALOIS_LOG_ASSERT(during.thp_backed_pages <= during.thp_pages);
+
+  freePages(ptr, num);
+
+  PageAllocStats after = getPageAllocStats();
+  GALOIS_LOG_ASSERT(TotalPages(after) == TotalPages(before));
+
+  return 0;
+}
@@ -0,0 +1,75 @@
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "galois/Env.h"
+#include "galois/Galois.h"
+#include "galois/JSON.h"
+#include "galois/Logging.h"
+#include "galois/runtime/Executor_ParaMeter.h"
+
+namespace {
+
+constexpr int kNumItems = 1000;
+constexpr int kNumBuckets = 10;
+
+/// Items of the same bucket conflict, so that each step commits at most one
+/// item per bucket
+void
+RunLoop(const char* loopname) {
+  std::vector<galois::runtime::Lockable> buckets(kNumBuckets);
+  galois::for_each(
+      galois::iterate(0, kNumItems),
+      [&](int i, auto&) {
+        galois::runtime::acquire(
+            &buckets[i % kNumBuckets], galois::MethodFlag::WRITE);
+      },
+      galois::wl<galois::worklists::ParaMeter<>>(), galois::loopname(loopname));
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys G;
+  galois::setActiveThreads(galois::substrate::GetThreadPool().getMaxThreads());
+
+  const std::string csv = "parameter-test.csv";
+  const std::string json = "parameter-test.json";
+  GALOIS_LOG_ASSERT(galois::SetEnv("GALOIS_PARAMETER_OUTFILE", csv, true));
+
+  RunLoop("first");
+  RunLoop("second");
+
+  std::ifstream in(json);
+  GALOIS_LOG_ASSERT(in);
+  nlohmann::json profile = nlohmann::json::parse(in);
+  const nlohmann::json& loops = profile["loops"];
+  GALOIS_LOG_ASSERT(loops.size() == 2);
+  GALOIS_LOG_ASSERT(loops[1]["loopname"] == "second");
+
+  for (const nlohmann::json& loop : loops) {
+    GALOIS_LOG_ASSERT(loop["schedule"] == "FIFO");
+    GALOIS_LOG_ASSERT(loop["work"] == kNumItems);
+    size_t critical_path = loop["critical_path"];
+    GALOIS_LOG_ASSERT(critical_path >= kNumItems / kNumBuckets);
+    GALOIS_LOG_ASSERT(loop["steps"].size() == critical_path);
+    GALOIS_LOG_ASSERT(loop["max_parallelism"] <= kNumBuckets);
+
+    size_t conflicts = 0;
+    for (const nlohmann::json& step : loop["steps"]) {
+      size_t ran = step["worklist_size"];
+      size_t committed = step["parallelism"];
+      GALOIS_LOG_ASSERT(step["conflicts"] == ran - committed);
+      conflicts += static_cast<size_t>(step["conflicts"]);
+    }
+    GALOIS_LOG_ASSERT(loop["conflicts"] == conflicts);
+    GALOIS_LOG_ASSERT(conflicts > 0);
+  }
+
+  std::remove(csv.c_str());
+  std::remove(json.c_str());
+
+  return 0;
+}
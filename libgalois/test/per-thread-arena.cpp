@@ -0,0 +1,112 @@
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/Mem.h"
+
+namespace {
+
+constexpr uint64_t kNumItems = 10000;
+constexpr uint32_t kNumRounds = 5;
+
+/// Every round fills scratch vectors from the arenas, and rewinding between
+/// rounds reuses the chunks of the first round rather than taking new ones
+void
+TestRounds() {
+  galois::PerThreadArena arena;
+  std::vector<size_t> blocks;
+  for (uint32_t round = 0; round < kNumRounds; ++round) {
+    std::atomic<uint64_t> sum{0};
+    galois::do_all(
+        galois::iterate(uint64_t{0}, kNumItems),
+        [&](uint64_t i) {
+          galois::ArenaVector<uint64_t> scratch = arena.MakeVector<uint64_t>();
+          scratch.reserve(i % 64 + 1);
+          for (uint64_t j = 0; j <= i % 64; ++j) {
+            scratch.emplace_back(j);
+          }
+          uint64_t local = 0;
+          for (uint64_t v : scratch) {
+            local += v;
+          }
+          sum += local;
+        },
+        galois::no_stats());
+
+    uint64_t expected = 0;
+    for (uint64_t i = 0; i < kNumItems; ++i) {
+      expected += (i % 64) * (i % 64 + 1) / 2;
+    }
+    GALOIS_LOG_VASSERT(sum == expected, "round {}: {}", round, sum.load());
+
+    galois::on_each([&](unsigned tid, unsigned) {
+      if (round == 0) {
+        blocks.resize(galois::getActiveThreads());
+        blocks[tid] = arena.local().num_blocks();
+      } else {
+        GALOIS_LOG_VASSERT(
+            arena.local().num_blocks() == blocks[tid], "round {} thread {}",
+            round, tid);
+      }
+    });
+    arena.Rewind();
+  }
+}
+
+/// Allocations are aligned for any type, and ones larger than a chunk are
+/// served from malloc
+void
+TestAllocate() {
+  galois::ArenaHeap heap;
+  for (size_t size : {1, 3, 16, 17, 1000}) {
+    auto address = reinterpret_cast<uintptr_t>(heap.allocate(size));
+    GALOIS_LOG_VASSERT(address % alignof(std::max_align_t) == 0, "{}", size);
+  }
+  GALOIS_LOG_ASSERT(heap.num_blocks() == 1);
+
+  auto* large = static_cast<char*>(
+      heap.allocate(galois::runtime::SystemHeap::AllocSize * 2));
+  large[galois::runtime::SystemHeap::AllocSize * 2 - 1] = 1;
+  GALOIS_LOG_ASSERT(heap.num_blocks() == 1);
+
+  heap.Rewind();
+  GALOIS_LOG_ASSERT(heap.num_blocks() == 1);
+  heap.clear();
+  GALOIS_LOG_ASSERT(heap.num_blocks() == 0);
+}
+
+/// Threads of a phased loop rewind their own arenas after the barrier that
+/// ends each round
+void
+TestPhases() {
+  galois::PerThreadArena arena;
+  std::atomic<uint64_t> total{0};
+  galois::run_phases([&](galois::PhaseContext& ctx) {
+    for (uint32_t round = 0; round < kNumRounds; ++round) {
+      ctx.DoAll(galois::iterate(uint64_t{0}, kNumItems), [&](uint64_t i) {
+        auto* value = static_cast<uint64_t*>(
+            arena.local().allocate(sizeof(uint64_t)));
+        *value = i;
+        total += *value;
+      });
+      arena.RewindLocal();
+    }
+  });
+  GALOIS_LOG_ASSERT(total == kNumRounds * kNumItems * (kNumItems - 1) / 2);
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(4);
+
+  TestRounds();
+  TestAllocate();
+  TestPhases();
+
+  return 0;
+}
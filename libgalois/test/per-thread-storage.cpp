@@ -0,0 +1,107 @@
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/substrate/PerThreadStorage.h"
+
+namespace {
+
+/// Larger than the first chunk of a region on its own
+using Large = std::array<uint64_t, (3 << 20) / sizeof(uint64_t)>;
+
+/// Values written by each thread are read back from every thread
+void
+TestRoundTrip() {
+  galois::substrate::PerThreadStorage<uint64_t> small;
+  galois::substrate::PerThreadStorage<Large> large;
+  galois::on_each([&](unsigned tid, unsigned) {
+    *small.getLocal() = tid;
+    large.getLocal()->back() = tid + 1;
+  });
+
+  for (unsigned i = 0; i < galois::getActiveThreads(); ++i) {
+    GALOIS_LOG_VASSERT(*small.getRemote(i) == i, "{}", *small.getRemote(i));
+    GALOIS_LOG_ASSERT(large.getRemote(i)->front() == 0);
+    GALOIS_LOG_ASSERT(large.getRemote(i)->back() == i + 1);
+  }
+}
+
+/// Storage grows past the first chunk of each region, and destroying it
+/// returns the bytes and chunks it took
+void
+TestGrowAndRelease() {
+  galois::substrate::PerBackend& backend = galois::substrate::getPTSBackend();
+  size_t allocated = backend.allocatedBytes();
+  size_t committed = backend.committedBytes();
+
+  {
+    std::vector<std::unique_ptr<galois::substrate::PerThreadStorage<Large>>>
+        many;
+    for (int i = 0; i < 4; ++i) {
+      many.emplace_back(
+          std::make_unique<galois::substrate::PerThreadStorage<Large>>());
+    }
+    GALOIS_LOG_ASSERT(
+        backend.allocatedBytes() >= allocated + 4 * sizeof(Large));
+    GALOIS_LOG_ASSERT(backend.committedBytes() > committed);
+
+    std::atomic<uint64_t> sum{0};
+    galois::on_each([&](unsigned, unsigned) {
+      for (auto& pts : many) {
+        pts->getLocal()->front() = 1;
+      }
+      for (auto& pts : many) {
+        sum += pts->getLocal()->front();
+      }
+    });
+    GALOIS_LOG_ASSERT(sum == 4 * galois::getActiveThreads());
+
+    // destroying out of order leaves free ranges that coalesce
+    many[1].reset();
+    many[2].reset();
+    many[0].reset();
+  }
+
+  GALOIS_LOG_VASSERT(
+      backend.allocatedBytes() == allocated, "{} != {}",
+      backend.allocatedBytes(), allocated);
+  GALOIS_LOG_VASSERT(
+      backend.committedBytes() == committed, "{} != {}",
+      backend.committedBytes(), committed);
+}
+
+/// Repeatedly creating and destroying storage reuses the same offsets
+void
+TestReuse() {
+  galois::substrate::PerBackend& backend = galois::substrate::getPTSBackend();
+  galois::substrate::PerThreadStorage<uint64_t> pinned;
+  size_t allocated = backend.allocatedBytes();
+
+  uint64_t* first = nullptr;
+  for (int i = 0; i < 10000; ++i) {
+    galois::substrate::PerThreadStorage<std::array<uint64_t, 100>> pts;
+    if (first == nullptr) {
+      first = pts.getLocal()->data();
+    }
+    GALOIS_LOG_ASSERT(pts.getLocal()->data() == first);
+  }
+  GALOIS_LOG_ASSERT(backend.allocatedBytes() == allocated);
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(4);
+
+  TestRoundTrip();
+  TestGrowAndRelease();
+  TestReuse();
+
+  return 0;
+}
@@ -0,0 +1,80 @@
+#include <cstdlib>
+
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/runtime/PerfCounters.h"
+
+namespace {
+
+constexpr uint64_t kNumItems = 1 << 20;
+
+using galois::runtime::PerfEvent;
+
+/// Loops with a loopname count their events on every thread; events that the
+/// kernel does not let a thread count are left out rather than failing
+void
+TestLoops() {
+  GALOIS_LOG_ASSERT(galois::runtime::PerfCountersEnabled());
+
+  galois::GAccumulator<uint64_t> sum;
+  galois::do_all(
+      galois::iterate(uint64_t{0}, kNumItems), [&](uint64_t i) { sum += i; },
+      galois::loopname("PerfDoAll"));
+  galois::do_all(
+      galois::iterate(uint64_t{0}, kNumItems), [&](uint64_t i) { sum += i; },
+      galois::steal(), galois::loopname("PerfDoAllSteal"));
+  galois::for_each(
+      galois::iterate(uint64_t{0}, kNumItems),
+      [&](uint64_t i, auto&) { sum += i; }, galois::no_pushes(),
+      galois::disable_conflict_detection(), galois::loopname("PerfForEach"));
+  galois::on_each(
+      [&](unsigned tid, unsigned) { sum += tid; },
+      galois::loopname("PerfOnEach"));
+
+  GALOIS_LOG_ASSERT(sum.reduce() > 0);
+}
+
+/// The counters of a thread only grow
+void
+TestRead() {
+  galois::runtime::PerfCounterValues start =
+      galois::runtime::ReadPerfCounters();
+  volatile uint64_t x = 0;
+  for (uint64_t i = 0; i < kNumItems; ++i) {
+    x = x + i;
+  }
+  galois::runtime::PerfCounterValues end = galois::runtime::ReadPerfCounters();
+
+  for (unsigned i = 0; i < galois::runtime::kNumPerfEvents; ++i) {
+    auto event = static_cast<PerfEvent>(i);
+    if (!galois::runtime::PerfEventCounted(event)) {
+      GALOIS_LOG_ASSERT(start[i] == 0 && end[i] == 0);
+      continue;
+    }
+    GALOIS_LOG_VASSERT(
+        end[i] >= start[i], "{} went back",
+        galois::runtime::PerfEventName(event));
+  }
+  if (galois::runtime::PerfEventCounted(PerfEvent::kInstructions)) {
+    GALOIS_LOG_ASSERT(
+        end[static_cast<unsigned>(PerfEvent::kInstructions)] -
+            start[static_cast<unsigned>(PerfEvent::kInstructions)] >=
+        kNumItems);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  setenv("GALOIS_PERF_EVENTS", "all", 1);
+
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(
+      galois::substrate::GetThreadPool().getMaxUsableThreads());
+
+  TestLoops();
+  TestRead();
+
+  return 0;
+}
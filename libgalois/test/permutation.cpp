@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/Permutation.h"
+
+namespace {
+
+constexpr uint64_t kSize = 100000;
+
+std::vector<uint32_t>
+RandomPermutation() {
+  std::vector<uint32_t> sources(kSize);
+  std::iota(sources.begin(), sources.end(), uint32_t{0});
+  std::mt19937 gen(11);
+  std::shuffle(sources.begin(), sources.end(), gen);
+  return sources;
+}
+
+void
+TestApply(const std::vector<uint32_t>& sources, uint64_t block_size) {
+  galois::BlockedPermutation plan(sources.data(), sources.size(), block_size);
+  GALOIS_LOG_ASSERT(plan.size() == sources.size());
+  GALOIS_LOG_ASSERT(
+      plan.num_blocks() == (sources.size() + block_size - 1) / block_size);
+
+  std::vector<uint64_t> in(kSize);
+  for (uint64_t i = 0; i < kSize; ++i) {
+    in[i] = i * 3 + 1;
+  }
+  std::vector<uint64_t> out(sources.size());
+  plan.Apply(in.data(), out.data());
+  for (uint64_t i = 0; i < sources.size(); ++i) {
+    GALOIS_LOG_ASSERT(out[i] == in[sources[i]]);
+  }
+
+  // values of a width without a native type
+  constexpr uint64_t kWidth = 12;
+  std::vector<uint8_t> wide_in(kSize * kWidth);
+  for (uint64_t i = 0; i < wide_in.size(); ++i) {
+    wide_in[i] = static_cast<uint8_t>(i * 7);
+  }
+  std::vector<uint8_t> wide_out(sources.size() * kWidth);
+  plan.Apply(wide_in.data(), wide_out.data(), kWidth);
+  for (uint64_t i = 0; i < sources.size(); ++i) {
+    GALOIS_LOG_ASSERT(
+        std::memcmp(
+            &wide_out[i * kWidth], &wide_in[sources[i] * kWidth], kWidth) ==
+        0);
+  }
+
+  std::vector<uint16_t> narrow_in(kSize);
+  std::iota(narrow_in.begin(), narrow_in.end(), uint16_t{0});
+  std::vector<uint16_t> narrow_out(sources.size());
+  plan.Apply(
+      reinterpret_cast<const uint8_t*>(narrow_in.data()),
+      reinterpret_cast<uint8_t*>(narrow_out.data()), sizeof(uint16_t));
+  for (uint64_t i = 0; i < sources.size(); ++i) {
+    GALOIS_LOG_ASSERT(narrow_out[i] == narrow_in[sources[i]]);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(
+      galois::substrate::GetThreadPool().getMaxUsableThreads());
+
+  std::vector<uint32_t> permutation = RandomPermutation();
+  TestApply(permutation, galois::BlockedPermutation::kDefaultBlockSize);
+  TestApply(permutation, 1000);
+  TestApply(permutation, 1);
+  TestApply(permutation, 2 * kSize);
+
+  // sources may repeat and need not cover the input
+  std::vector<uint32_t> repeated(kSize / 2);
+  for (uint64_t i = 0; i < repeated.size(); ++i) {
+    repeated[i] = permutation[i] / 4;
+  }
+  TestApply(repeated, 1000);
+
+  galois::BlockedPermutation empty(repeated.data(), 0);
+  GALOIS_LOG_ASSERT(empty.size() == 0 && empty.num_blocks() == 0);
+
+  return 0;
+}
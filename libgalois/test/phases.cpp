@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "galois/Bag.h"
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+
+namespace {
+
+/// Rounds of a static and a dynamic phase over a vector, each reading what
+/// the previous phase wrote, with the rounds counted by AllReduce
+void
+TestRounds(uint32_t num_items, uint32_t num_rounds) {
+  std::vector<uint32_t> a(num_items, 0);
+  std::vector<uint32_t> b(num_items, 0);
+  std::vector<uint32_t> rounds_seen(galois::getActiveThreads(), 0);
+
+  galois::run_phases([&](galois::PhaseContext& ctx) {
+    uint32_t round = 0;
+    bool done = num_rounds == 0;
+    while (!done) {
+      ctx.DoAll(
+          galois::iterate(uint32_t{0}, num_items),
+          [&](uint32_t i) { a[i] = b[i] + 1; });
+      uint32_t mismatches = 0;
+      ctx.DoAll(
+          galois::iterate(uint32_t{0}, num_items),
+          [&](uint32_t i) {
+            mismatches += a[i] != 2 * round + 1;
+            b[i] = a[i] + 1;
+          },
+          galois::steal(), galois::chunk_size<16>());
+      ++round;
+      GALOIS_LOG_ASSERT(
+          ctx.AllReduce(mismatches, [](uint32_t x, uint32_t y) {
+            return x + y;
+          }) == 0);
+      // every thread decides alike to stop
+      unsigned last_tid = ctx.AllReduce(
+          ctx.tid(), [](unsigned x, unsigned y) { return std::max(x, y); });
+      GALOIS_LOG_ASSERT(last_tid == ctx.num_threads() - 1);
+      done = round == num_rounds;
+    }
+    rounds_seen[ctx.tid()] = round;
+  });
+
+  for (uint32_t i = 0; i < num_items; ++i) {
+    GALOIS_LOG_ASSERT(b[i] == 2 * num_rounds);
+  }
+  for (uint32_t r : rounds_seen) {
+    GALOIS_LOG_ASSERT(r == num_rounds);
+  }
+}
+
+/// Phases over a range with local iterators
+void
+TestBag(uint32_t num_items) {
+  galois::InsertBag<uint32_t> bag;
+  galois::do_all(
+      galois::iterate(uint32_t{0}, num_items), [&](uint32_t i) { bag.push(i); },
+      galois::no_stats());
+
+  std::vector<std::atomic<uint32_t>> counts(num_items);
+  galois::run_phases([&](galois::PhaseContext& ctx) {
+    ctx.DoAll(galois::iterate(bag), [&](uint32_t i) { counts[i] += 1; });
+    ctx.DoAll(galois::iterate(bag), [&](uint32_t i) { counts[i] += 1; });
+  });
+
+  for (const auto& count : counts) {
+    GALOIS_LOG_ASSERT(count == 2);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(
+      galois::substrate::GetThreadPool().getMaxUsableThreads());
+
+  for (uint32_t n : {0U, 1U, 7U, 100000U}) {
+    TestRounds(n, 0);
+    TestRounds(n, 1);
+    TestRounds(n, 50);
+  }
+  TestBag(100000);
+
+  return 0;
+}
@@ -1,11 +1,22 @@
+#include <unistd.h>
+
+#include <algorithm>
+#include <set>
+
 #include <arrow/api.h>
 #include <boost/filesystem.hpp>
 
 #include "TestPropertyGraph.h"
 #include "galois/Logging.h"
+#include "galois/Loops.h"
+#include "galois/Reduction.h"
 #include "galois/SharedMemSys.h"
+#include "galois/Threads.h"
 #include "galois/Uri.h"
+#include "galois/graphs/EdgeTypeIndex.h"
+#include "galois/graphs/InlineEdgeIndex.h"
 #include "galois/graphs/PropertyFileGraph.h"
+#include "galois/graphs/SharedMemoryGraph.h"
 
 namespace fs = boost::filesystem;
 std::string command_line;
@@ -209,6 +220,689 @@ TestSimplePGs() {
   GALOIS_LOG_ASSERT(make_result);
 }
 
+void
+TestLazyLoad() {
+  auto rdg_file = MakePFGFile("n1");
+  GALOIS_LOG_ASSERT(!rdg_file.empty());
+
+  galois::Result<std::unique_ptr<galois::graphs::PropertyFileGraph>>
+      make_result = galois::graphs::PropertyFileGraph::MakeLazy(rdg_file);
+  if (!make_result) {
+    fs::remove_all(rdg_file);
+    GALOIS_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g =
+      std::move(make_result.value());
+
+  // schemas are available before anything is loaded
+  GALOIS_LOG_ASSERT(g->node_schema()->num_fields() == 2);
+  GALOIS_LOG_ASSERT(g->node_schema()->field(1)->name() == "n1");
+  GALOIS_LOG_ASSERT(
+      g->node_schema()->field(1)->type()->Equals(arrow::uint64()));
+  GALOIS_LOG_ASSERT(g->node_table()->column(1)->num_chunks() == 0);
+
+  std::shared_ptr<arrow::ChunkedArray> n1 = g->NodeProperty("n1");
+  GALOIS_LOG_ASSERT(n1 && n1->length() == 10);
+  GALOIS_LOG_ASSERT(g->node_table()->column(0)->num_chunks() == 0);
+
+  auto unload_result = g->UnloadNodeProperty(1);
+  GALOIS_LOG_ASSERT(unload_result);
+  GALOIS_LOG_ASSERT(g->node_table()->column(1)->num_chunks() == 0);
+
+  // refetched on next access
+  auto n1_again = g->NodeProperty(1);
+  GALOIS_LOG_ASSERT(n1_again && n1_again->Equals(*n1));
+
+  auto eager_result = galois::graphs::PropertyFileGraph::Make(rdg_file);
+  fs::remove_all(rdg_file);
+  GALOIS_LOG_ASSERT(eager_result);
+  GALOIS_LOG_ASSERT(g->Equals(eager_result.value().get()));
+}
+
+void
+TestCompressedTopology() {
+  RandomPolicy policy{3};
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g =
+      MakeFileGraph<int32_t>(1000, 1, &policy);
+  g->MarkAllPropertiesPersistent();
+  g->set_compress_topology(true);
+
+  auto uri_res = galois::Uri::MakeRand("/tmp/propertyfilegraph");
+  GALOIS_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    GALOIS_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  auto make_result = galois::graphs::PropertyFileGraph::Make(rdg_dir);
+  fs::remove_all(rdg_dir);
+  if (!make_result) {
+    GALOIS_LOG_FATAL("making result: {}", make_result.error());
+  }
+
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g2 =
+      std::move(make_result.value());
+  GALOIS_LOG_ASSERT(g2->compress_topology());
+  GALOIS_LOG_ASSERT(g2->topology().Equals(g->topology()));
+}
+
+void
+TestWideNodeIds() {
+  constexpr uint64_t num_nodes = 100;
+  constexpr uint64_t degree = 3;
+  arrow::UInt64Builder indices_builder;
+  arrow::UInt64Builder dests_builder;
+  for (uint64_t n = 0; n < num_nodes; ++n) {
+    for (uint64_t i = 1; i <= degree; ++i) {
+      GALOIS_LOG_ASSERT(dests_builder.Append((n + i) % num_nodes).ok());
+    }
+    GALOIS_LOG_ASSERT(indices_builder.Append((n + 1) * degree).ok());
+  }
+  std::shared_ptr<arrow::UInt64Array> indices;
+  std::shared_ptr<arrow::UInt64Array> dests;
+  GALOIS_LOG_ASSERT(indices_builder.Finish(&indices).ok());
+  GALOIS_LOG_ASSERT(dests_builder.Finish(&dests).ok());
+
+  auto g = std::make_unique<galois::graphs::PropertyFileGraph>();
+  GALOIS_LOG_ASSERT(g->SetTopology(galois::graphs::GraphTopology64{
+      .out_indices = indices,
+      .out_dests = dests,
+  }));
+  GALOIS_LOG_ASSERT(g->HasWideNodeIds());
+  GALOIS_LOG_ASSERT(g->topology().num_nodes() == 0);
+  GALOIS_LOG_ASSERT(
+      g->AddNodeProperties(MakeTable<int32_t>("node-id", num_nodes)));
+  GALOIS_LOG_ASSERT(
+      g->AddEdgeProperties(MakeTable<int32_t>("edge-id", num_nodes * degree)));
+  g->MarkAllPropertiesPersistent();
+  // wide topologies are stored uncompressed regardless
+  g->set_compress_topology(true);
+
+  auto uri_res = galois::Uri::MakeRand("/tmp/propertyfilegraph");
+  GALOIS_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    GALOIS_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  auto make_result = galois::graphs::PropertyFileGraph::Make(rdg_dir);
+  fs::remove_all(rdg_dir);
+  if (!make_result) {
+    GALOIS_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g2 =
+      std::move(make_result.value());
+  GALOIS_LOG_ASSERT(g2->HasWideNodeIds());
+  GALOIS_LOG_ASSERT(!g2->compress_topology());
+  GALOIS_LOG_ASSERT(g2->topology64().Equals(g->topology64()));
+  GALOIS_LOG_ASSERT(g2->Equals(g.get()));
+
+  using NarrowGraph = galois::graphs::PropertyGraph<std::tuple<>, std::tuple<>>;
+  using WideGraph =
+      galois::graphs::PropertyGraph<std::tuple<>, std::tuple<>, uint64_t>;
+  GALOIS_LOG_ASSERT(!NarrowGraph::Make(g2.get(), {}, {}));
+  auto wide_result = WideGraph::Make(g2.get(), {}, {});
+  GALOIS_LOG_ASSERT(wide_result);
+  const WideGraph& wide = wide_result.value();
+  GALOIS_LOG_ASSERT(wide.num_nodes() == num_nodes);
+  GALOIS_LOG_ASSERT(wide.num_edges() == num_nodes * degree);
+  for (uint64_t n : wide) {
+    uint64_t i = 1;
+    for (auto e : wide.edges(n)) {
+      GALOIS_LOG_ASSERT(*wide.GetEdgeDest(e) == (n + i++) % num_nodes);
+    }
+  }
+}
+
+void
+TestInEdges() {
+  RandomPolicy policy{3};
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g =
+      MakeFileGraph<int32_t>(1000, 1, &policy);
+  g->MarkAllPropertiesPersistent();
+  const galois::graphs::GraphTopology& topology = g->topology();
+
+  auto in_edges_result = g->InEdges();
+  GALOIS_LOG_ASSERT(in_edges_result);
+  const galois::graphs::InEdgeTopology* in_edges = in_edges_result.value();
+  GALOIS_LOG_ASSERT(in_edges->num_nodes() == topology.num_nodes());
+  GALOIS_LOG_ASSERT(in_edges->num_edges() == topology.num_edges());
+
+  std::vector<bool> seen(topology.num_edges());
+  for (uint32_t n = 0; n < in_edges->num_nodes(); ++n) {
+    auto [begin, end] = in_edges->edge_range(n);
+    for (uint64_t i = begin; i != end; ++i) {
+      uint64_t e = in_edges->out_edge_ids->Value(i);
+      auto [src_begin, src_end] =
+          topology.edge_range(in_edges->in_sources->Value(i));
+      GALOIS_LOG_ASSERT(e >= src_begin && e < src_end);
+      GALOIS_LOG_ASSERT(topology.out_dests->Value(e) == n);
+      GALOIS_LOG_ASSERT(!seen[e]);
+      seen[e] = true;
+    }
+  }
+
+  // cached until the topology changes
+  auto again_result = g->InEdges();
+  GALOIS_LOG_ASSERT(again_result && again_result.value() == in_edges);
+
+  g->set_persist_in_edges(true);
+
+  auto uri_res = galois::Uri::MakeRand("/tmp/propertyfilegraph");
+  GALOIS_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    GALOIS_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  auto make_result = galois::graphs::PropertyFileGraph::Make(rdg_dir);
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    GALOIS_LOG_FATAL("making result: {}", make_result.error());
+  }
+
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g2 =
+      std::move(make_result.value());
+  GALOIS_LOG_ASSERT(g2->persist_in_edges());
+  // the stored index is mapped on first use
+  auto stored_result = g2->InEdges();
+  fs::remove_all(rdg_dir);
+  GALOIS_LOG_ASSERT(stored_result);
+  const galois::graphs::InEdgeTopology* stored = stored_result.value();
+  GALOIS_LOG_ASSERT(stored->in_indices->Equals(*in_edges->in_indices));
+  GALOIS_LOG_ASSERT(stored->in_sources->Equals(*in_edges->in_sources));
+  GALOIS_LOG_ASSERT(stored->out_edge_ids->Equals(*in_edges->out_edge_ids));
+}
+
+void
+TestEdgeTypes() {
+  RandomPolicy policy{3};
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g =
+      MakeFileGraph<int32_t>(1000, 1, &policy);
+  const galois::graphs::GraphTopology& topology = g->topology();
+  std::vector<bool> a;
+  std::vector<bool> b;
+  for (uint64_t e = 0; e < topology.num_edges(); ++e) {
+    a.emplace_back(e % 3 == 0);
+    b.emplace_back(e % 2 == 0);
+  }
+  auto add_result = g->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("A", arrow::boolean()),
+           arrow::field("B", arrow::boolean())}),
+      {galois::BuildArray(a), galois::BuildArray(b)}));
+  GALOIS_LOG_ASSERT(add_result);
+  g->MarkAllPropertiesPersistent();
+
+  auto index_result = g->EdgeTypes({"B", "A"});
+  GALOIS_LOG_VASSERT(index_result, "{}", index_result.error());
+  std::shared_ptr<const galois::graphs::EdgeTypeIndex> index =
+      index_result.value();
+  for (uint32_t n = 0; n < topology.num_nodes(); ++n) {
+    auto [begin, end] = topology.edge_range(n);
+    GALOIS_LOG_ASSERT(index->type_range(n, 0).first == begin);
+    GALOIS_LOG_ASSERT(index->untyped_range(n).second == end);
+    for (size_t t = 0; t < 2; ++t) {
+      const std::vector<bool>& type = t == 0 ? b : a;
+      auto [type_begin, type_end] = index->type_range(n, t);
+      for (uint64_t p = type_begin; p < type_end; ++p) {
+        uint64_t e = index->edge_id(p);
+        GALOIS_LOG_ASSERT(e >= begin && e < end && type[e]);
+        GALOIS_LOG_ASSERT(index->edge_dest(p) == topology.out_dests->Value(e));
+      }
+    }
+    auto [mixed_begin, mixed_end] = index->mixed_range(n);
+    for (uint64_t p = mixed_begin; p < mixed_end; ++p) {
+      GALOIS_LOG_ASSERT(index->edge_id(p) % 6 == 0);
+    }
+  }
+
+  // cached for any of its types
+  auto again_result = g->EdgeTypes({"A"});
+  GALOIS_LOG_ASSERT(again_result && again_result.value() == index);
+
+  g->set_persist_edge_types(true);
+
+  auto uri_res = galois::Uri::MakeRand("/tmp/propertyfilegraph");
+  GALOIS_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    GALOIS_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  auto make_result = galois::graphs::PropertyFileGraph::Make(rdg_dir);
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    GALOIS_LOG_FATAL("making result: {}", make_result.error());
+  }
+
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g2 =
+      std::move(make_result.value());
+  GALOIS_LOG_ASSERT(g2->persist_edge_types());
+  // the stored index is mapped on first use
+  auto stored_result = g2->EdgeTypes({"A", "B"});
+  fs::remove_all(rdg_dir);
+  GALOIS_LOG_ASSERT(stored_result);
+  std::shared_ptr<const galois::graphs::EdgeTypeIndex> stored =
+      stored_result.value();
+  GALOIS_LOG_ASSERT(stored->types() == index->types());
+  for (uint32_t n = 0; n < topology.num_nodes(); ++n) {
+    GALOIS_LOG_ASSERT(stored->mixed_range(n) == index->mixed_range(n));
+  }
+  for (uint64_t p = 0; p < topology.num_edges(); ++p) {
+    GALOIS_LOG_ASSERT(stored->edge_id(p) == index->edge_id(p));
+    GALOIS_LOG_ASSERT(stored->edge_dest(p) == index->edge_dest(p));
+  }
+
+  // a new topology drops the index
+  GALOIS_LOG_ASSERT(g2->SetTopology(g->topology()));
+  auto rebuilt_result = g2->EdgeTypes({"A"});
+  GALOIS_LOG_ASSERT(rebuilt_result);
+  GALOIS_LOG_ASSERT(rebuilt_result.value()->types().size() == 1);
+}
+
+template <typename T>
+void
+CheckInlineEdges(
+    const galois::graphs::PropertyFileGraph& g, const std::string& property) {
+  auto inline_result = g.InlineEdges(property);
+  GALOIS_LOG_VASSERT(inline_result, "{}", inline_result.error());
+  std::shared_ptr<const galois::graphs::InlineEdgeIndex> index =
+      inline_result.value();
+  GALOIS_LOG_ASSERT(index->property() == property);
+  GALOIS_LOG_ASSERT(index->edges<double>() == nullptr);
+  const auto* edges = index->edges<T>();
+  GALOIS_LOG_ASSERT(edges != nullptr);
+
+  auto values = std::static_pointer_cast<arrow::NumericArray<
+      typename arrow::CTypeTraits<T>::ArrowType>>(
+      g.EdgeProperty(property)->chunk(0));
+  const galois::graphs::GraphTopology& topology = g.topology();
+  GALOIS_LOG_ASSERT(index->num_edges() == topology.num_edges());
+  for (uint64_t e = 0; e < topology.num_edges(); ++e) {
+    GALOIS_LOG_ASSERT(edges[e].dest == topology.out_dests->Value(e));
+    GALOIS_LOG_ASSERT(edges[e].value == values->Value(e));
+  }
+
+  // cached until the topology changes
+  auto again_result = g.InlineEdges(property);
+  GALOIS_LOG_ASSERT(again_result && again_result.value() == index);
+}
+
+void
+TestInlineEdges() {
+  RandomPolicy policy{3};
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g =
+      MakeFileGraph<int32_t>(1000, 0, &policy);
+  uint64_t num_edges = g->topology().num_edges();
+  GALOIS_LOG_ASSERT(g->AddEdgeProperties(MakeTable<int32_t>("w32", num_edges)));
+  GALOIS_LOG_ASSERT(g->AddEdgeProperties(MakeTable<int64_t>("w64", num_edges)));
+
+  CheckInlineEdges<int32_t>(*g, "w32");
+  CheckInlineEdges<int64_t>(*g, "w64");
+  auto missing_result = g->InlineEdges("missing");
+  GALOIS_LOG_ASSERT(
+      !missing_result &&
+      missing_result.error() == galois::ErrorCode::PropertyNotFound);
+
+  std::shared_ptr<const galois::graphs::InlineEdgeIndex> before =
+      g->InlineEdges("w64").value();
+  GALOIS_LOG_ASSERT(galois::graphs::SortNodesByDegree(g.get()));
+  auto after_result = g->InlineEdges("w64");
+  GALOIS_LOG_ASSERT(after_result && after_result.value() != before);
+  CheckInlineEdges<int64_t>(*g, "w64");
+}
+
+void
+TestEdgesSortedByDest() {
+  RandomPolicy policy{3};
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g =
+      MakeFileGraph<int32_t>(1000, 1, &policy);
+  g->MarkAllPropertiesPersistent();
+  GALOIS_LOG_ASSERT(!g->topology().edges_sorted_by_dest);
+
+  auto sort_result = galois::graphs::SortAllEdgesByDest(g.get());
+  GALOIS_LOG_ASSERT(sort_result);
+  GALOIS_LOG_ASSERT(g->topology().edges_sorted_by_dest);
+
+  // already sorted, so nothing moves
+  auto again_result = galois::graphs::SortAllEdgesByDest(g.get());
+  GALOIS_LOG_ASSERT(again_result);
+  for (size_t i = 0; i < again_result.value().size(); ++i) {
+    GALOIS_LOG_ASSERT(again_result.value()[i] == i);
+  }
+
+  auto uri_res = galois::Uri::MakeRand("/tmp/propertyfilegraph");
+  GALOIS_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    GALOIS_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  auto make_result = galois::graphs::PropertyFileGraph::Make(rdg_dir);
+  fs::remove_all(rdg_dir);
+  if (!make_result) {
+    GALOIS_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g2 =
+      std::move(make_result.value());
+  GALOIS_LOG_ASSERT(g2->topology().edges_sorted_by_dest);
+
+  GALOIS_LOG_ASSERT(galois::graphs::SortNodesByDegree(g2.get()));
+  GALOIS_LOG_ASSERT(!g2->topology().edges_sorted_by_dest);
+
+  // a claim is only accepted if it holds
+  galois::graphs::GraphTopology claimed = g2->topology();
+  const uint32_t* dests = claimed.out_dests->raw_values();
+  bool sorted = true;
+  for (uint32_t n = 0; n < claimed.num_nodes(); ++n) {
+    auto [begin, end] = claimed.edge_range(n);
+    sorted = sorted && std::is_sorted(dests + begin, dests + end);
+  }
+  claimed.edges_sorted_by_dest = true;
+  auto set_result = g2->SetTopology(claimed);
+  GALOIS_LOG_ASSERT(static_cast<bool>(set_result) == sorted);
+}
+
+void
+TestReorderNodes(galois::graphs::NodeOrdering ordering) {
+  constexpr size_t num_nodes = 1000;
+  RandomPolicy policy{3};
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g =
+      MakeFileGraph<int32_t>(num_nodes, 1, &policy);
+  galois::graphs::GraphTopology old_topology = g->topology();
+  size_t num_edges = old_topology.num_edges();
+
+  GALOIS_LOG_ASSERT(
+      g->AddNodeProperties(MakeTable<uint32_t>("node-id", num_nodes)));
+  GALOIS_LOG_ASSERT(
+      g->AddEdgeProperties(MakeTable<uint64_t>("edge-id", num_edges)));
+
+  auto reorder_result = galois::graphs::ReorderNodes(g.get(), ordering);
+  if (!reorder_result) {
+    GALOIS_LOG_FATAL("reordering: {}", reorder_result.error());
+  }
+
+  const galois::graphs::GraphTopology& topology = g->topology();
+  GALOIS_LOG_ASSERT(topology.num_nodes() == num_nodes);
+  GALOIS_LOG_ASSERT(topology.num_edges() == num_edges);
+
+  auto node_ids = std::static_pointer_cast<arrow::UInt32Array>(
+      g->NodeProperty("node-id")->chunk(0));
+  auto original_ids = std::static_pointer_cast<arrow::UInt32Array>(
+      g->NodeProperty(galois::graphs::kOriginalNodeIdProperty)->chunk(0));
+  auto edge_ids = std::static_pointer_cast<arrow::UInt64Array>(
+      g->EdgeProperty("edge-id")->chunk(0));
+
+  std::vector<bool> seen(num_nodes);
+  for (size_t n = 0; n < num_nodes; ++n) {
+    uint32_t old = node_ids->Value(n);
+    GALOIS_LOG_ASSERT(original_ids->Value(n) == old);
+    GALOIS_LOG_ASSERT(!seen[old]);
+    seen[old] = true;
+
+    auto [begin, end] = topology.edge_range(n);
+    auto [old_begin, old_end] = old_topology.edge_range(old);
+    GALOIS_LOG_ASSERT(end - begin == old_end - old_begin);
+    for (uint64_t e = begin; e != end; ++e) {
+      uint64_t old_e = edge_ids->Value(e);
+      GALOIS_LOG_ASSERT(old_e == old_begin + (e - begin));
+      GALOIS_LOG_ASSERT(
+          node_ids->Value(topology.out_dests->Value(e)) ==
+          old_topology.out_dests->Value(old_e));
+    }
+  }
+}
+
+void
+TestDistributeToNumaNodes(galois::graphs::NumaPolicy numa_policy) {
+  constexpr size_t num_nodes = 1000;
+  RandomPolicy policy{3};
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g =
+      MakeFileGraph<int32_t>(num_nodes, 1, &policy);
+  GALOIS_LOG_ASSERT(
+      g->AddNodeProperties(MakeTable<uint64_t>("node-id", num_nodes)));
+  GALOIS_LOG_ASSERT(g->AddEdgeProperties(
+      MakeTable<double>("edge-weight", g->topology().num_edges())));
+
+  galois::graphs::GraphTopology old_topology = g->topology();
+  std::shared_ptr<arrow::Table> old_nodes = g->node_table();
+  std::shared_ptr<arrow::Table> old_edges = g->edge_table();
+
+  unsigned old_threads = galois::getActiveThreads();
+  galois::setActiveThreads(4);
+  auto distribute_result = g->DistributeToNumaNodes(numa_policy);
+  galois::setActiveThreads(old_threads);
+  if (!distribute_result) {
+    GALOIS_LOG_FATAL("distributing: {}", distribute_result.error());
+  }
+
+  GALOIS_LOG_ASSERT(g->topology().Equals(old_topology));
+  GALOIS_LOG_ASSERT(
+      g->topology().out_dests->raw_values() !=
+      old_topology.out_dests->raw_values());
+  GALOIS_LOG_ASSERT(g->node_table()->Equals(*old_nodes));
+  GALOIS_LOG_ASSERT(g->edge_table()->Equals(*old_edges));
+  GALOIS_LOG_ASSERT(
+      g->NodeProperty("node-id")->chunk(0)->data()->buffers[1] !=
+      old_nodes->GetColumnByName("node-id")->chunk(0)->data()->buffers[1]);
+}
+
+/// Uninitialized properties have one value per node or edge, can be written
+/// in place and are only persistent once marked
+void
+TestUninitializedProperties() {
+  constexpr size_t num_nodes = 1000;
+  RandomPolicy policy{3};
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g =
+      MakeFileGraph<int32_t>(num_nodes, 1, &policy);
+
+  GALOIS_LOG_ASSERT(g->AddUninitializedNodeProperty("level", arrow::uint32()));
+  GALOIS_LOG_ASSERT(
+      g->AddUninitializedEdgeProperty("weight", arrow::float64()));
+  GALOIS_LOG_ASSERT(!g->AddUninitializedNodeProperty("name", arrow::utf8()));
+  GALOIS_LOG_ASSERT(!g->AddUninitializedNodeProperty("flag", arrow::boolean()));
+
+  auto level = std::static_pointer_cast<arrow::UInt32Array>(
+      g->NodeProperty("level")->chunk(0));
+  GALOIS_LOG_ASSERT(static_cast<size_t>(level->length()) == num_nodes);
+  GALOIS_LOG_ASSERT(level->null_count() == 0);
+  GALOIS_LOG_ASSERT(
+      static_cast<uint64_t>(g->EdgeProperty("weight")->length()) ==
+      g->topology().num_edges());
+
+  auto* values = const_cast<uint32_t*>(level->raw_values());
+  for (int round = 0; round < 3; ++round) {
+    galois::do_all(
+        galois::iterate(uint32_t{0}, uint32_t{num_nodes}),
+        [&](uint32_t n) { values[n] = n + round; });
+  }
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    GALOIS_LOG_ASSERT(level->Value(n) == n + 2);
+  }
+
+  GALOIS_LOG_ASSERT(g->MarkNodePropertiesPersistent({"", "level"}));
+}
+
+std::set<std::string>
+ListFiles(const std::string& dir) {
+  std::set<std::string> files;
+  for (const auto& entry : fs::directory_iterator(dir)) {
+    files.emplace(entry.path().filename().string());
+  }
+  return files;
+}
+
+/// Committing a loaded graph writes only the properties added since it was
+/// loaded; the new version refers to the files of the others
+void
+TestIncrementalCommit() {
+  constexpr size_t num_nodes = 100;
+  RandomPolicy policy{3};
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g =
+      MakeFileGraph<int32_t>(num_nodes, 2, &policy);
+  g->MarkAllPropertiesPersistent();
+
+  auto uri_res = galois::Uri::MakeRand("/tmp/propertyfilegraph");
+  GALOIS_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  if (auto res = g->Write(rdg_dir, command_line); !res) {
+    fs::remove_all(rdg_dir);
+    GALOIS_LOG_FATAL("writing result: {}", res.error());
+  }
+
+  auto make_result = galois::graphs::PropertyFileGraph::Make(rdg_dir);
+  GALOIS_LOG_ASSERT(make_result);
+  std::unique_ptr<galois::graphs::PropertyFileGraph> loaded =
+      std::move(make_result.value());
+  int num_old_props = loaded->node_schema()->num_fields();
+  GALOIS_LOG_ASSERT(
+      loaded->AddNodeProperties(MakeTable<uint64_t>("added", num_nodes)));
+  std::vector<std::string> persist(num_old_props, "");
+  persist.emplace_back("added");
+  GALOIS_LOG_ASSERT(loaded->MarkNodePropertiesPersistent(persist));
+
+  std::set<std::string> before = ListFiles(rdg_dir);
+  if (auto res = loaded->Commit(command_line); !res) {
+    fs::remove_all(rdg_dir);
+    GALOIS_LOG_FATAL("committing result: {}", res.error());
+  }
+  std::set<std::string> after = ListFiles(rdg_dir);
+
+  // the new property, the part header and the meta file
+  std::vector<std::string> written;
+  std::set_difference(
+      after.begin(), after.end(), before.begin(), before.end(),
+      std::back_inserter(written));
+  GALOIS_LOG_VASSERT(written.size() == 3, "wrote {}", written.size());
+  GALOIS_LOG_ASSERT(std::any_of(
+      written.begin(), written.end(),
+      [](const std::string& f) { return f.find("added") == 0; }));
+
+  auto reload_result = galois::graphs::PropertyFileGraph::Make(rdg_dir);
+  fs::remove_all(rdg_dir);
+  GALOIS_LOG_ASSERT(reload_result);
+  std::unique_ptr<galois::graphs::PropertyFileGraph> reloaded =
+      std::move(reload_result.value());
+  GALOIS_LOG_ASSERT(
+      reloaded->node_schema()->num_fields() == num_old_props + 1);
+  GALOIS_LOG_ASSERT(reloaded->node_table()->Equals(*loaded->node_table()));
+  GALOIS_LOG_ASSERT(reloaded->edge_table()->Equals(*g->edge_table()));
+}
+
+void
+TestEdgeBalancedRanges() {
+  constexpr uint32_t num_nodes = 1000;
+  RandomPolicy policy{3};
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g =
+      MakeFileGraph<int32_t>(num_nodes, 1, &policy);
+
+  // a star: node 0 has an edge to every other node and they have one back
+  arrow::UInt64Builder indices_builder;
+  arrow::UInt32Builder dests_builder;
+  for (uint32_t n = 1; n < num_nodes; ++n) {
+    GALOIS_LOG_ASSERT(dests_builder.Append(n).ok());
+  }
+  GALOIS_LOG_ASSERT(indices_builder.Append(num_nodes - 1).ok());
+  for (uint32_t n = 1; n < num_nodes; ++n) {
+    GALOIS_LOG_ASSERT(dests_builder.Append(0).ok());
+    GALOIS_LOG_ASSERT(indices_builder.Append(num_nodes - 1 + n).ok());
+  }
+  galois::graphs::GraphTopology star;
+  GALOIS_LOG_ASSERT(indices_builder.Finish(&star.out_indices).ok());
+  GALOIS_LOG_ASSERT(dests_builder.Finish(&star.out_dests).ok());
+  GALOIS_LOG_ASSERT(g->SetTopology(star));
+  const galois::graphs::GraphTopology& topology = g->topology();
+
+  unsigned old_threads = galois::getActiveThreads();
+  unsigned num_threads = galois::setActiveThreads(4);
+  const std::vector<uint32_t>& ranges = g->EdgeBalancedRanges();
+  GALOIS_LOG_ASSERT(ranges.size() == num_threads + 1);
+  GALOIS_LOG_ASSERT(ranges.front() == 0 && ranges.back() == num_nodes);
+
+  // no block is heavier than its share by more than the heaviest node
+  uint64_t total = topology.num_edges() + num_nodes;
+  uint64_t max_weight = num_nodes;
+  for (unsigned i = 0; i < num_threads; ++i) {
+    GALOIS_LOG_ASSERT(ranges[i] <= ranges[i + 1]);
+    if (ranges[i] == ranges[i + 1]) {
+      continue;
+    }
+    uint64_t weight = topology.edge_range(ranges[i + 1] - 1).second -
+                      topology.edge_range(ranges[i]).first + ranges[i + 1] -
+                      ranges[i];
+    GALOIS_LOG_VASSERT(
+        weight <= total / num_threads + max_weight, "block {} weighs {}", i,
+        weight);
+  }
+
+  // cached for this number of threads
+  GALOIS_LOG_ASSERT(&g->EdgeBalancedRanges() == &ranges);
+
+  using Graph = galois::graphs::PropertyGraph<std::tuple<>, std::tuple<>>;
+  auto pg_result = Graph::Make(g.get(), {}, {});
+  GALOIS_LOG_ASSERT(pg_result);
+  const Graph& graph = pg_result.value();
+  auto nodes = graph.EdgeBalancedNodes();
+  galois::GAccumulator<uint64_t> visited;
+  galois::GAccumulator<uint64_t> degrees;
+  galois::do_all(galois::iterate(nodes), [&](uint32_t n) {
+    visited += 1;
+    degrees += *graph.edge_end(n) - *graph.edge_begin(n);
+  });
+  GALOIS_LOG_ASSERT(visited.reduce() == num_nodes);
+  GALOIS_LOG_ASSERT(degrees.reduce() == topology.num_edges());
+  galois::setActiveThreads(old_threads);
+
+  GALOIS_LOG_ASSERT(
+      g->EdgeBalancedRanges().size() == galois::getActiveThreads() + 1);
+}
+
+void
+TestSharedMemory() {
+  RandomPolicy policy{3};
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g =
+      MakeFileGraph<int32_t>(1000, 2, &policy);
+  std::string name = fmt::format("/property-file-graph-test-{}", getpid());
+
+  GALOIS_LOG_ASSERT(galois::graphs::ExportToSharedMemory(*g, name));
+  auto again = galois::graphs::ExportToSharedMemory(*g, name);
+  GALOIS_LOG_ASSERT(
+      !again && again.error() == galois::ErrorCode::AlreadyExists);
+
+  auto attached_result = galois::graphs::AttachSharedMemory(name);
+  GALOIS_LOG_ASSERT(attached_result);
+  std::unique_ptr<galois::graphs::PropertyFileGraph> attached =
+      std::move(attached_result.value());
+  GALOIS_LOG_ASSERT(attached->Equals(g.get()));
+
+  // attached graphs stay usable once the name is gone
+  GALOIS_LOG_ASSERT(galois::graphs::RemoveSharedMemory(name));
+  GALOIS_LOG_ASSERT(attached->topology().Equals(g->topology()));
+  auto missing = galois::graphs::AttachSharedMemory(name);
+  GALOIS_LOG_ASSERT(!missing && missing.error() == galois::ErrorCode::NotFound);
+
+  // added properties live in the memory of the process
+  GALOIS_LOG_ASSERT(attached->AddNodeProperties(
+      MakeTable<int64_t>("added", attached->topology().num_nodes())));
+  GALOIS_LOG_ASSERT(attached->node_schema()->num_fields() == 3);
+}
+
 int
 main(int argc, char** argv) {
   galois::SharedMemSys sys;
@@ -224,6 +918,22 @@ main(int argc, char** argv) {
   TestRoundTrip();
   TestGarbageMetadata();
   TestSimplePGs();
+  TestLazyLoad();
+  TestCompressedTopology();
+  TestWideNodeIds();
+  TestInEdges();
+  TestEdgeTypes();
+  TestInlineEdges();
+  TestEdgesSortedByDest();
+  TestReorderNodes(galois::graphs::NodeOrdering::kDegree);
+  TestReorderNodes(galois::graphs::NodeOrdering::kReverseCuthillMcKee);
+  TestReorderNodes(galois::graphs::NodeOrdering::kGorder);
+  TestDistributeToNumaNodes(galois::graphs::NumaPolicy::kBlocked);
+  TestDistributeToNumaNodes(galois::graphs::NumaPolicy::kInterleaved);
+  TestUninitializedProperties();
+  TestIncrementalCommit();
+  TestEdgeBalancedRanges();
+  TestSharedMemory();
 
   return 0;
 }
@@ -104,6 +104,41 @@ TestIterate4(size_t num_nodes, size_t line_width) {
   GALOIS_LOG_VASSERT(expected == r_iterate, "{} != {}", expected, r_iterate);
 }
 
+struct DenseField0 {
+  using ViewType = galois::DensePODPropertyView<int64_t>;
+  using ArrowType = arrow::CTypeTraits<int64_t>::ArrowType;
+};
+
+/// The dense view reads the same values as the POD view, and its data()
+/// covers every node
+void
+TestDense(size_t num_nodes, size_t line_width) {
+  using NodeType = std::tuple<Field0, DenseField0>;
+  using EdgeType = std::tuple<DenseField0>;
+
+  LinePolicy policy{line_width};
+
+  std::unique_ptr<gg::PropertyFileGraph> g =
+      MakeFileGraph<DataType>(num_nodes, 1, &policy);
+
+  auto r = gg::PropertyGraph<NodeType, EdgeType>::Make(
+      g.get(), {"0", "0"}, {"0"});
+  if (!r) {
+    GALOIS_LOG_FATAL("could not make property graph: {}", r.error());
+  }
+  auto& pg = r.value();
+
+  const int64_t* dense = pg.GetNodePropertyView<DenseField0>().data();
+  GALOIS_LOG_ASSERT(pg.GetNodePropertyView<DenseField0>().size() == num_nodes);
+  for (auto node : pg) {
+    GALOIS_LOG_ASSERT(
+        pg.GetData<Field0>(node) == pg.GetData<DenseField0>(node));
+    GALOIS_LOG_ASSERT(dense[node] == pg.GetData<Field0>(node));
+  }
+  GALOIS_LOG_ASSERT(
+      pg.GetEdgePropertyView<DenseField0>().size() == pg.num_edges());
+}
+
 /// Test non-existent property error
 void
 TestError1(size_t num_nodes, size_t line_width) {
@@ -133,6 +168,7 @@ main() {
   TestIterate1(10, 3);
   TestIterate3(10, 3);
   TestIterate4(10, 3);
+  TestDense(10, 3);
   TestError1(10, 3);
 
   return 0;
@@ -0,0 +1,210 @@
+#include <filesystem>
+
+#include <arrow/api.h>
+#include <parquet/file_reader.h>
+
+#include "TestPropertyGraph.h"
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/Uri.h"
+#include "galois/analytics/random_walks/random_walks.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+using galois::analytics::RandomWalksPlan;
+
+constexpr uint32_t kNumNodes = 100;
+constexpr uint32_t kWalkLength = 6;
+constexpr uint32_t kWalksPerNode = 3;
+
+/// MakeGraph makes a line where node n has edges to n + 1, weighing zero, and
+/// to n + 2 (mod kNumNodes), weighing weight
+std::unique_ptr<galois::graphs::PropertyFileGraph>
+MakeGraph(int64_t weight) {
+  LinePolicy policy{2};
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g =
+      MakeFileGraph<int64_t>(kNumNodes, 1, &policy);
+  std::vector<int64_t> weights;
+  for (uint64_t e = 0; e < g->topology().num_edges(); ++e) {
+    weights.emplace_back(e % 2 == 0 ? 0 : weight);
+  }
+  auto add_result = g->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("weight", arrow::int64())}),
+      {galois::BuildArray(weights)}));
+  GALOIS_LOG_ASSERT(add_result);
+  return g;
+}
+
+std::shared_ptr<arrow::LargeListArray>
+Walks(const std::shared_ptr<arrow::Table>& table) {
+  GALOIS_LOG_ASSERT(table->num_columns() == 1);
+  GALOIS_LOG_ASSERT(
+      table->field(0)->name() == galois::analytics::kRandomWalksColumn);
+  GALOIS_LOG_ASSERT(table->column(0)->num_chunks() == 1);
+  return std::static_pointer_cast<arrow::LargeListArray>(
+      table->column(0)->chunk(0));
+}
+
+/// Hops returns the distance along the line covered by each step of walk w
+std::vector<uint32_t>
+Hops(const arrow::LargeListArray& walks, int64_t w) {
+  auto nodes = std::static_pointer_cast<arrow::UInt32Array>(walks.values());
+  std::vector<uint32_t> hops;
+  for (int64_t i = walks.value_offset(w) + 1; i < walks.value_offset(w + 1);
+       ++i) {
+    hops.emplace_back(
+        (nodes->Value(i) + kNumNodes - nodes->Value(i - 1)) % kNumNodes);
+  }
+  return hops;
+}
+
+void
+CheckWalks(const arrow::LargeListArray& walks, uint32_t length) {
+  GALOIS_LOG_ASSERT(walks.length() == kNumNodes * kWalksPerNode);
+  auto nodes = std::static_pointer_cast<arrow::UInt32Array>(walks.values());
+  for (int64_t w = 0; w < walks.length(); ++w) {
+    GALOIS_LOG_ASSERT(walks.value_length(w) == length);
+    GALOIS_LOG_ASSERT(nodes->Value(walks.value_offset(w)) == w % kNumNodes);
+  }
+}
+
+void
+TestUniform() {
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g = MakeGraph(1);
+  auto walks_result = galois::analytics::RandomWalks(
+      g.get(), "", 3, RandomWalksPlan::Uniform(kWalkLength, kWalksPerNode));
+  GALOIS_LOG_VASSERT(walks_result, "{}", walks_result.error());
+  std::shared_ptr<arrow::LargeListArray> walks = Walks(walks_result.value());
+  CheckWalks(*walks, kWalkLength + 1);
+  for (int64_t w = 0; w < walks->length(); ++w) {
+    for (uint32_t hop : Hops(*walks, w)) {
+      GALOIS_LOG_ASSERT(hop == 1 || hop == 2);
+    }
+  }
+
+  // the walks depend on the seed only
+  unsigned old_threads = galois::getActiveThreads();
+  for (unsigned threads : {1, 4}) {
+    galois::setActiveThreads(threads);
+    auto again = galois::analytics::RandomWalks(
+        g.get(), "", 3, RandomWalksPlan::Uniform(kWalkLength, kWalksPerNode));
+    GALOIS_LOG_ASSERT(again);
+    GALOIS_LOG_ASSERT(again.value()->Equals(*walks_result.value()));
+  }
+  galois::setActiveThreads(old_threads);
+
+  // walks stop at nodes without edges
+  LinePolicy no_edges{0};
+  std::unique_ptr<galois::graphs::PropertyFileGraph> empty =
+      MakeFileGraph<int64_t>(kNumNodes, 1, &no_edges);
+  auto stuck = galois::analytics::RandomWalks(
+      empty.get(), "", 3,
+      RandomWalksPlan::Uniform(kWalkLength, kWalksPerNode));
+  GALOIS_LOG_ASSERT(stuck);
+  CheckWalks(*Walks(stuck.value()), 1);
+}
+
+void
+TestWeighted() {
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g = MakeGraph(5);
+  auto walks_result = galois::analytics::RandomWalks(
+      g.get(), "weight", 3,
+      RandomWalksPlan::Weighted(kWalkLength, kWalksPerNode));
+  GALOIS_LOG_VASSERT(walks_result, "{}", walks_result.error());
+  std::shared_ptr<arrow::LargeListArray> walks = Walks(walks_result.value());
+  CheckWalks(*walks, kWalkLength + 1);
+  for (int64_t w = 0; w < walks->length(); ++w) {
+    for (uint32_t hop : Hops(*walks, w)) {
+      GALOIS_LOG_ASSERT(hop == 2);
+    }
+  }
+
+  // every edge weighs zero, so walks stop at once
+  std::unique_ptr<galois::graphs::PropertyFileGraph> zero = MakeGraph(0);
+  auto stuck = galois::analytics::RandomWalks(
+      zero.get(), "weight", 3,
+      RandomWalksPlan::Weighted(kWalkLength, kWalksPerNode));
+  GALOIS_LOG_ASSERT(stuck);
+  CheckWalks(*Walks(stuck.value()), 1);
+
+  std::unique_ptr<galois::graphs::PropertyFileGraph> negative = MakeGraph(-1);
+  auto invalid = galois::analytics::RandomWalks(
+      negative.get(), "weight", 3, RandomWalksPlan::Weighted());
+  GALOIS_LOG_ASSERT(
+      !invalid && invalid.error() == galois::ErrorCode::InvalidArgument);
+  auto missing = galois::analytics::RandomWalks(
+      g.get(), "no-such-prop", 3, RandomWalksPlan::Weighted());
+  GALOIS_LOG_ASSERT(
+      !missing && missing.error() == galois::ErrorCode::PropertyNotFound);
+}
+
+void
+TestNode2vec() {
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g = MakeGraph(1);
+
+  // After a hop of 1 from t to v, the hop of 1 from v reaches a neighbor of t
+  // and the hop of 2 does not. A huge in-out parameter rejects the latter, so
+  // the rest of the walk only hops 1.
+  for (bool sorted : {false, true}) {
+    if (sorted) {
+      GALOIS_LOG_ASSERT(g->MarkEdgesSortedByDest());
+    }
+    auto walks_result = galois::analytics::RandomWalks(
+        g.get(), "", 3,
+        RandomWalksPlan::Node2vec(kWalkLength, kWalksPerNode, 1, 1e12));
+    GALOIS_LOG_VASSERT(walks_result, "{}", walks_result.error());
+    std::shared_ptr<arrow::LargeListArray> walks =
+        Walks(walks_result.value());
+    CheckWalks(*walks, kWalkLength + 1);
+    for (int64_t w = 0; w < walks->length(); ++w) {
+      bool hopped_one = false;
+      for (uint32_t hop : Hops(*walks, w)) {
+        GALOIS_LOG_ASSERT(hop == 1 || (hop == 2 && !hopped_one));
+        hopped_one |= hop == 1;
+      }
+    }
+  }
+
+  auto invalid = galois::analytics::RandomWalks(
+      g.get(), "", 3, RandomWalksPlan::Node2vec(kWalkLength, 1, 0, 1));
+  GALOIS_LOG_ASSERT(
+      !invalid && invalid.error() == galois::ErrorCode::InvalidArgument);
+}
+
+void
+TestWrite() {
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g = MakeGraph(1);
+  auto walks_result = galois::analytics::RandomWalks(
+      g.get(), "", 3, RandomWalksPlan::Uniform(kWalkLength, kWalksPerNode));
+  GALOIS_LOG_ASSERT(walks_result);
+
+  auto uri_res = galois::Uri::MakeRand("/tmp/randomwalks");
+  GALOIS_LOG_ASSERT(uri_res);
+  std::string path(uri_res.value().path());
+  auto write_result =
+      galois::analytics::WriteRandomWalks(walks_result.value(), path);
+  GALOIS_LOG_VASSERT(write_result, "{}", write_result.error());
+
+  std::unique_ptr<parquet::ParquetFileReader> reader =
+      parquet::ParquetFileReader::OpenFile(path);
+  GALOIS_LOG_ASSERT(
+      reader->metadata()->num_rows() == kNumNodes * kWalksPerNode);
+  fs::remove(path);
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(2);
+
+  TestUniform();
+  TestWeighted();
+  TestNode2vec();
+  TestWrite();
+
+  return 0;
+}
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/ParallelSTL.h"
+
+namespace {
+
+void
+TestScans(size_t size) {
+  std::mt19937_64 gen(size);
+  std::vector<uint64_t> values(size);
+  for (uint64_t& v : values) {
+    v = gen() % 100;
+  }
+
+  std::vector<uint64_t> expected(size);
+  std::partial_sum(values.begin(), values.end(), expected.begin());
+  std::vector<uint64_t> out(size);
+  auto end = galois::ParallelSTL::inclusive_scan(
+      values.begin(), values.end(), out.begin());
+  GALOIS_LOG_ASSERT(end == out.end());
+  GALOIS_LOG_ASSERT(out == expected);
+
+  // in place, with an operator without an identity of 0
+  std::vector<int64_t> signed_values(size);
+  for (int64_t& v : signed_values) {
+    v = static_cast<int64_t>(gen() % 1000) - 2000;
+  }
+  std::vector<int64_t> expected_max(size);
+  auto max = [](int64_t a, int64_t b) { return std::max(a, b); };
+  std::partial_sum(
+      signed_values.begin(), signed_values.end(), expected_max.begin(), max);
+  galois::ParallelSTL::inclusive_scan(
+      signed_values.begin(), signed_values.end(), signed_values.begin(), max);
+  GALOIS_LOG_ASSERT(signed_values == expected_max);
+
+  // in place, starting from init
+  uint64_t sum = 5;
+  for (size_t i = 0; i < size; ++i) {
+    expected[i] = sum;
+    sum += values[i];
+  }
+  end = galois::ParallelSTL::exclusive_scan(
+      values.begin(), values.end(), values.begin(), uint64_t{5});
+  GALOIS_LOG_ASSERT(end == values.end());
+  GALOIS_LOG_ASSERT(values == expected);
+}
+
+void
+TestPacks(size_t size) {
+  std::mt19937_64 gen(size);
+  std::vector<uint32_t> values(size);
+  for (uint32_t& v : values) {
+    v = gen() % 10;
+  }
+  auto is_small = [](uint32_t v) { return v < 3; };
+
+  std::vector<uint32_t> expected;
+  std::copy_if(
+      values.begin(), values.end(), std::back_inserter(expected), is_small);
+  std::vector<uint32_t> out(size);
+  auto end = galois::ParallelSTL::copy_if(
+      values.begin(), values.end(), out.begin(), is_small);
+  out.resize(end - out.begin());
+  GALOIS_LOG_ASSERT(out == expected);
+
+  std::vector<uint32_t> expected_indices;
+  for (size_t i = 0; i < size; ++i) {
+    if (values[i] == 0) {
+      expected_indices.emplace_back(i);
+    }
+  }
+  std::vector<uint32_t> indices(size);
+  end = galois::ParallelSTL::pack_index(
+      values.begin(), values.end(), indices.begin(),
+      [](uint32_t v) { return v == 0; });
+  indices.resize(end - indices.begin());
+  GALOIS_LOG_ASSERT(indices == expected_indices);
+
+  // flags that convert to bool
+  std::vector<uint8_t> flags(size);
+  for (size_t i = 0; i < size; ++i) {
+    flags[i] = values[i] == 0;
+  }
+  std::vector<uint64_t> flag_indices(size);
+  auto flag_end = galois::ParallelSTL::pack_index(
+      flags.begin(), flags.end(), flag_indices.begin());
+  flag_indices.resize(flag_end - flag_indices.begin());
+  GALOIS_LOG_ASSERT(std::equal(
+      flag_indices.begin(), flag_indices.end(), expected_indices.begin(),
+      expected_indices.end()));
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  unsigned max_threads =
+      galois::substrate::GetThreadPool().getMaxUsableThreads();
+
+  for (unsigned threads : {1U, 2U, max_threads}) {
+    galois::setActiveThreads(threads);
+    // serial, parallel with a short last block and with many elements
+    for (size_t size : {0UL, 1000UL, 16385UL, 1000000UL}) {
+      TestScans(size);
+      TestPacks(size);
+    }
+  }
+
+  return 0;
+}
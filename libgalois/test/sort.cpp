@@ -20,6 +20,10 @@
 #include <cstdlib>
 #include <iostream>
 #include <numeric>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "galois/Galois.h"
 #include "galois/ParallelSTL.h"
@@ -92,6 +96,119 @@ do_sort() {
   return 0;
 }
 
+//! Sorts copies of V with sort_fn and std::stable_sort by comp and reports
+//! whether they are equal
+template <typename T, typename SortFn, typename Compare>
+bool
+check_sort(
+    const char* name, const std::vector<T>& V, SortFn sort_fn, Compare comp) {
+  std::vector<T> A = V;
+  std::vector<T> C = V;
+
+  galois::Timer t;
+  t.start();
+  sort_fn(A);
+  t.stop();
+
+  galois::Timer t2;
+  t2.start();
+  std::stable_sort(C.begin(), C.end(), comp);
+  t2.stop();
+
+  bool eq = A == C;
+  std::cout << name << ": Galois: " << t.get() << " STL: " << t2.get()
+            << " Equal: " << eq << "\n";
+  return eq;
+}
+
+int
+do_parallel_sorts() {
+  unsigned M = galois::substrate::GetThreadPool().getMaxThreads();
+  std::cout << "radix_sort, sort_by_key and sample_sort:\n";
+
+  const size_t size = std::min(vectorSize, 1 << 20);
+  std::mt19937_64 gen(7);
+  std::vector<int64_t> signed_values(size);
+  for (int64_t& v : signed_values) {
+    v = static_cast<int64_t>(gen());
+  }
+  // few distinct values, so that some digits are all equal
+  std::vector<std::pair<uint32_t, uint16_t>> pairs(size);
+  for (auto& p : pairs) {
+    p = std::make_pair(gen() % 1000, gen() % 3);
+  }
+  std::vector<std::string> strings(size);
+  for (std::string& s : strings) {
+    s = std::to_string(gen() % 10000);
+  }
+
+  int ret = 0;
+  while (M) {
+    galois::setActiveThreads(M);
+    std::cout << "Using " << M << " threads\n";
+
+    auto less = [](const auto& a, const auto& b) { return a < b; };
+    if (!check_sort(
+            "signed", signed_values,
+            [](auto& A) { galois::ParallelSTL::sort(A.begin(), A.end()); },
+            less)) {
+      ret = 1;
+    }
+    if (!check_sort(
+            "pairs", pairs,
+            [](auto& A) { galois::ParallelSTL::sort(A.begin(), A.end()); },
+            less)) {
+      ret = 1;
+    }
+
+    // radix_sort and sort_by_key are stable
+    auto by_first = [](const auto& a, const auto& b) {
+      return a.first < b.first;
+    };
+    if (!check_sort(
+            "stable", pairs,
+            [](auto& A) {
+              galois::ParallelSTL::radix_sort(
+                  A.begin(), A.end(), [](const auto& p) { return p.first; });
+            },
+            by_first)) {
+      ret = 1;
+    }
+    if (!check_sort(
+            "by key", pairs,
+            [](auto& A) {
+              std::vector<uint32_t> keys(A.size());
+              std::vector<uint16_t> values(A.size());
+              for (size_t i = 0; i < A.size(); ++i) {
+                keys[i] = A[i].first;
+                values[i] = A[i].second;
+              }
+              galois::ParallelSTL::sort_by_key(
+                  keys.begin(), keys.end(), values.begin());
+              for (size_t i = 0; i < A.size(); ++i) {
+                A[i] = std::make_pair(keys[i], values[i]);
+              }
+            },
+            by_first)) {
+      ret = 1;
+    }
+
+    if (!check_sort(
+            "strings", strings,
+            [](auto& A) {
+              galois::ParallelSTL::sort(
+                  A.begin(), A.end(), std::greater<std::string>());
+            },
+            std::greater<std::string>())) {
+      ret = 1;
+    }
+
+    M >>= 1;
+  }
+
+  return ret;
+}
+
 int
 do_count_if() {
   unsigned M = galois::substrate::GetThreadPool().getMaxThreads();
@@ -176,5 +293,6 @@ main(int argc, char** argv) {
   //  ret |= do_sort();
   //  ret |= do_count_if();
   ret |= do_accumulate();
+  ret |= do_parallel_sorts();
   return ret;
 }
@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/graphs/SpatialTree.h"
+
+namespace {
+
+using Tree = galois::graphs::PackedSpatialTree2d<uint32_t>;
+
+struct Points {
+  std::vector<double> xs;
+  std::vector<double> ys;
+  std::vector<uint32_t> ids;
+};
+
+/// Clustered points, with duplicates, so that leaves overlap
+Points
+MakePoints(size_t size, uint32_t seed) {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<double> center(-1000.0, 1000.0);
+  std::normal_distribution<double> offset(0.0, 5.0);
+  Points p;
+  double cx = 0;
+  double cy = 0;
+  for (size_t i = 0; i < size; ++i) {
+    if (i % 100 == 0) {
+      cx = center(gen);
+      cy = center(gen);
+    }
+    if (i % 7 == 3) {
+      p.xs.push_back(p.xs.back());
+      p.ys.push_back(p.ys.back());
+    } else {
+      p.xs.push_back(cx + offset(gen));
+      p.ys.push_back(cy + offset(gen));
+    }
+    p.ids.push_back(i);
+  }
+  return p;
+}
+
+double
+Distance(const Points& p, uint32_t id, double x, double y) {
+  double dx = p.xs[id] - x;
+  double dy = p.ys[id] - y;
+  return std::sqrt(dx * dx + dy * dy);
+}
+
+/// The k nearest distances and the points in a rectangle match a scan of all
+/// the points
+void
+TestLookups(size_t size, size_t k) {
+  Points p = MakePoints(size, size);
+  Tree tree;
+  tree.build(p.xs.begin(), p.ys.begin(), p.ids.begin(), size);
+  GALOIS_LOG_ASSERT(tree.size() == size);
+
+  constexpr size_t kQueries = 200;
+  Points q = MakePoints(kQueries, size + 1);
+  std::vector<Tree::Neighbor> out(kQueries * k);
+  std::vector<size_t> found(kQueries);
+  tree.nearestBatch(
+      q.xs.begin(), q.ys.begin(), kQueries, k, out.data(), found.data());
+
+  std::vector<Tree::Rect> rects;
+  for (size_t i = 0; i < kQueries; ++i) {
+    double w = (i % 10) * 10.0;
+    rects.push_back(
+        Tree::Rect{q.xs[i] - w, q.ys[i] - w, q.xs[i] + w, q.ys[i] + w / 2});
+  }
+  std::vector<std::vector<uint32_t>> in_rect(kQueries);
+  galois::substrate::PerThreadStorage<std::vector<std::pair<size_t, uint32_t>>>
+      reported;
+  tree.rangeBatch(rects.begin(), kQueries, [&](size_t i, uint32_t id) {
+    reported.getLocal()->emplace_back(i, id);
+  });
+  for (unsigned t = 0; t < reported.size(); ++t) {
+    for (auto [i, id] : *reported.getRemote(t)) {
+      in_rect[i].push_back(id);
+    }
+  }
+
+  for (size_t i = 0; i < kQueries; ++i) {
+    std::vector<double> expected;
+    std::vector<uint32_t> expected_in_rect;
+    for (uint32_t id = 0; id < size; ++id) {
+      expected.push_back(Distance(p, id, q.xs[i], q.ys[i]));
+      const Tree::Rect& r = rects[i];
+      if (r.xmin <= p.xs[id] && p.xs[id] <= r.xmax && r.ymin <= p.ys[id] &&
+          p.ys[id] <= r.ymax) {
+        expected_in_rect.push_back(id);
+      }
+    }
+    std::sort(expected.begin(), expected.end());
+
+    size_t expected_found = std::min(k, size);
+    GALOIS_LOG_VASSERT(found[i] == expected_found, "{} {}", i, found[i]);
+    for (size_t j = 0; j < expected_found; ++j) {
+      const Tree::Neighbor& n = out[i * k + j];
+      GALOIS_LOG_VASSERT(n.distance == expected[j], "{} {}", i, j);
+      GALOIS_LOG_ASSERT(
+          Distance(p, *n.value, q.xs[i], q.ys[i]) == n.distance);
+    }
+
+    std::sort(in_rect[i].begin(), in_rect[i].end());
+    GALOIS_LOG_VASSERT(in_rect[i] == expected_in_rect, "{}", i);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(2);
+
+  Tree empty;
+  GALOIS_LOG_ASSERT(empty.empty());
+  Tree::Neighbor n;
+  GALOIS_LOG_ASSERT(empty.nearest(0, 0, 1, &n) == 0);
+
+  TestLookups(1, 3);
+  TestLookups(17, 5);
+  TestLookups(1000, 1);
+  TestLookups(20000, 10);
+
+  return 0;
+}
@@ -0,0 +1,87 @@
+#include <sstream>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/Statistics.h"
+
+namespace {
+
+constexpr uint64_t kNumItems = 1000;
+constexpr uint64_t kNumRounds = 5;
+
+nlohmann::json
+Export() {
+  std::ostringstream out;
+  galois::internal::sysStatManager()->PrintJSON(out);
+  return nlohmann::json::parse(out.str());
+}
+
+uint64_t
+SumThreads(const nlohmann::json& stat) {
+  uint64_t sum = 0;
+  for (const auto& [tid, v] : stat.at("threads").items()) {
+    sum += v.get<uint64_t>();
+  }
+  return sum;
+}
+
+/// Live handles show up in exports, and destroyed ones leave their values
+/// with the statistics of the threads that counted them
+void
+TestRounds() {
+  {
+    galois::StatHandle visited("Rounds", "Visited");
+    galois::StatHandle rounds("Rounds", "Rounds", galois::StatTotal::TMAX);
+    for (uint64_t round = 0; round < kNumRounds; ++round) {
+      galois::do_all(
+          galois::iterate(uint64_t{0}, kNumItems),
+          [&](uint64_t) { visited.Add(1); }, galois::no_stats());
+      rounds.Add(1);
+    }
+
+    nlohmann::json j = Export();
+    const nlohmann::json& stat = j.at("Rounds").at("Visited");
+    GALOIS_LOG_ASSERT(stat.at("total_type") == "TSUM");
+    GALOIS_LOG_VASSERT(
+        stat.at("total") == kNumRounds * kNumItems, "{}", stat.dump());
+    GALOIS_LOG_ASSERT(SumThreads(stat) == kNumRounds * kNumItems);
+    // only the main thread counted rounds
+    GALOIS_LOG_ASSERT(j.at("Rounds").at("Rounds").at("threads").size() == 1);
+    GALOIS_LOG_ASSERT(j.at("Rounds").at("Rounds").at("total") == kNumRounds);
+  }
+
+  nlohmann::json j = Export();
+  GALOIS_LOG_ASSERT(
+      j.at("Rounds").at("Visited").at("total") == kNumRounds * kNumItems);
+  GALOIS_LOG_ASSERT(j.at("Rounds").at("Rounds").at("total") == kNumRounds);
+}
+
+/// A handle and ReportStat of the same statistic add to one value per
+/// thread
+void
+TestMixed() {
+  galois::StatHandle handle("Mixed", "Count");
+  handle.Add(3);
+  galois::ReportStatSum("Mixed", "Count", 4);
+
+  nlohmann::json j = Export();
+  const nlohmann::json& stat = j.at("Mixed").at("Count");
+  GALOIS_LOG_ASSERT(stat.at("threads").size() == 1);
+  GALOIS_LOG_VASSERT(stat.at("total") == 7, "{}", stat.dump());
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(4);
+
+  TestRounds();
+  TestMixed();
+
+  return 0;
+}
@@ -0,0 +1,162 @@
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/Statistics.h"
+#include "galois/StatsServer.h"
+
+namespace {
+
+constexpr uint64_t kNumItems = 1000;
+
+galois::StatManager&
+Stats() {
+  return *galois::internal::sysStatManager();
+}
+
+void
+RunLoops() {
+  for (int i = 0; i < 3; ++i) {
+    galois::do_all(
+        galois::iterate(uint64_t{0}, kNumItems), [](uint64_t) {},
+        galois::loopname("Export"));
+  }
+  galois::ReportStatSingle("Export", "Ratio", 0.5);
+  galois::ReportParam("Export", "Input", "a \"quoted\" name");
+
+  // as tsuba reports the latencies of its I/O
+  std::vector<uint64_t> buckets(40);
+  buckets[0] = 1;
+  buckets[2] = 2;
+  buckets[39] = 4;
+  Stats().AddTimings("Export", "Imported", buckets.data(), buckets.size(), 9);
+}
+
+/// The JSON maps each loop to its statistics, with the values of each thread
+/// and the timings of each run of the loop
+void
+TestJSON() {
+  std::ostringstream out;
+  Stats().PrintJSON(out);
+  nlohmann::json j = nlohmann::json::parse(out.str());
+
+  const nlohmann::json& iterations = j.at("Export").at("Iterations");
+  GALOIS_LOG_ASSERT(iterations.at("total_type") == "TSUM");
+  GALOIS_LOG_ASSERT(iterations.at("total") == 3 * kNumItems);
+  uint64_t sum = 0;
+  for (const auto& [tid, v] : iterations.at("threads").items()) {
+    sum += v.get<uint64_t>();
+  }
+  GALOIS_LOG_ASSERT(sum == 3 * kNumItems);
+
+  const nlohmann::json& timings = j.at("Export").at("Time").at("timings");
+  GALOIS_LOG_ASSERT(timings.at("count") == 3);
+  uint64_t runs = 0;
+  for (const auto& bucket : timings.at("buckets")) {
+    runs += bucket.at("count").get<uint64_t>();
+  }
+  GALOIS_LOG_ASSERT(runs == 3);
+
+  const nlohmann::json& imported =
+      j.at("Export").at("Imported").at("timings");
+  GALOIS_LOG_ASSERT(imported.at("count") == 7);
+  GALOIS_LOG_ASSERT(imported.at("sum_usec") == 9);
+  // empty buckets are left out and the last one has no bound
+  const nlohmann::json& imported_buckets = imported.at("buckets");
+  GALOIS_LOG_ASSERT(imported_buckets.size() == 3);
+  GALOIS_LOG_ASSERT(imported_buckets.at(1).at("le_usec") == 4);
+  GALOIS_LOG_ASSERT(imported_buckets.at(1).at("count") == 2);
+  GALOIS_LOG_ASSERT(imported_buckets.at(2).at("le_usec").is_null());
+  GALOIS_LOG_ASSERT(imported_buckets.at(2).at("count") == 4);
+
+  GALOIS_LOG_ASSERT(j.at("Export").at("Ratio").at("total") == 0.5);
+  GALOIS_LOG_ASSERT(
+      j.at("Export").at("Input").at("total") == "a \"quoted\" name");
+}
+
+void
+TestPrometheus(const std::string& metrics) {
+  GALOIS_LOG_VASSERT(
+      metrics.find("galois_stat{region=\"Export\",category=\"Iterations\","
+                   "total=\"TSUM\"} 3000\n") != std::string::npos,
+      "{}", metrics);
+  GALOIS_LOG_ASSERT(
+      metrics.find("galois_timing_usec_count{region=\"Export\","
+                   "category=\"Time\"} 3\n") != std::string::npos);
+  GALOIS_LOG_ASSERT(
+      metrics.find("value=\"a \\\"quoted\\\" name\"} 1\n") !=
+      std::string::npos);
+}
+
+/// Fetches the metrics from a StatsServer as a client would
+std::string
+Fetch(uint16_t port) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  GALOIS_LOG_ASSERT(fd >= 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(port);
+  GALOIS_LOG_ASSERT(
+      connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+
+  std::string request = "GET /metrics HTTP/1.0\r\n\r\n";
+  GALOIS_LOG_ASSERT(
+      write(fd, request.data(), request.size()) == ssize_t(request.size()));
+
+  std::string response;
+  char buf[4096];
+  ssize_t n;
+  while ((n = read(fd, buf, sizeof(buf))) > 0) {
+    response.append(buf, n);
+  }
+  close(fd);
+  return response;
+}
+
+void
+TestServer() {
+  auto server = galois::StatsServer::Make(0);
+  GALOIS_LOG_VASSERT(server, "{}", server.error());
+  GALOIS_LOG_ASSERT(server.value()->port() != 0);
+
+  std::string response = Fetch(server.value()->port());
+  GALOIS_LOG_VASSERT(response.rfind("HTTP/1.0 200 OK", 0) == 0, "{}", response);
+  TestPrometheus(response);
+
+  // later statistics show up in the next request
+  galois::ReportStatSingle("Export", "Late", 7);
+  response = Fetch(server.value()->port());
+  GALOIS_LOG_ASSERT(
+      response.find("category=\"Late\",total=\"SINGLE\"} 7\n") !=
+      std::string::npos);
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(
+      galois::substrate::GetThreadPool().getMaxUsableThreads());
+
+  RunLoops();
+  TestJSON();
+
+  std::ostringstream out;
+  Stats().PrintPrometheus(out);
+  TestPrometheus(out.str());
+
+  TestServer();
+
+  return 0;
+}
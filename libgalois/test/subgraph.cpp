@@ -0,0 +1,189 @@
+#include <arrow/api.h>
+
+#include "TestPropertyGraph.h"
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/graphs/Subgraph.h"
+
+namespace {
+
+constexpr uint32_t kNumNodes = 100;
+
+std::shared_ptr<arrow::UInt32Array>
+ParentNodeIds(const galois::graphs::PropertyFileGraph& sub) {
+  return std::static_pointer_cast<arrow::UInt32Array>(
+      sub.NodeProperty(galois::graphs::kParentNodeIdProperty)->chunk(0));
+}
+
+std::shared_ptr<arrow::UInt64Array>
+ParentEdgeIds(const galois::graphs::PropertyFileGraph& sub) {
+  return std::static_pointer_cast<arrow::UInt64Array>(
+      sub.EdgeProperty(galois::graphs::kParentEdgeIdProperty)->chunk(0));
+}
+
+/// Every edge of sub is an edge of g between the parents of its endpoints
+void
+CheckEdges(
+    const galois::graphs::PropertyFileGraph& g,
+    const galois::graphs::PropertyFileGraph& sub) {
+  auto node_ids = ParentNodeIds(sub);
+  auto edge_ids = ParentEdgeIds(sub);
+  const galois::graphs::GraphTopology& topology = sub.topology();
+  for (uint32_t n = 0; n < topology.num_nodes(); ++n) {
+    auto [begin, end] = topology.edge_range(n);
+    for (uint64_t e = begin; e < end; ++e) {
+      uint64_t parent_edge = edge_ids->Value(e);
+      auto [parent_begin, parent_end] =
+          g.topology().edge_range(node_ids->Value(n));
+      GALOIS_LOG_ASSERT(
+          parent_begin <= parent_edge && parent_edge < parent_end);
+      GALOIS_LOG_ASSERT(
+          g.topology().out_dests->Value(parent_edge) ==
+          node_ids->Value(topology.out_dests->Value(e)));
+    }
+  }
+}
+
+void
+TestInducedSubgraph() {
+  LinePolicy policy{2};
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g =
+      MakeFileGraph<int64_t>(kNumNodes, 1, &policy);
+  std::string node_prop = g->node_schema()->field(0)->name();
+  std::string edge_prop = g->edge_schema()->field(0)->name();
+
+  auto sub_result = galois::graphs::ExtractInducedSubgraph(
+      *g, {12, 10, 11, 50}, {node_prop}, {edge_prop});
+  GALOIS_LOG_VASSERT(sub_result, "{}", sub_result.error());
+  std::unique_ptr<galois::graphs::PropertyFileGraph> sub =
+      std::move(sub_result.value());
+
+  // 10 -> 11, 10 -> 12 and 11 -> 12
+  GALOIS_LOG_ASSERT(sub->topology().num_nodes() == 4);
+  GALOIS_LOG_ASSERT(sub->topology().num_edges() == 3);
+  GALOIS_LOG_ASSERT(sub->topology().edge_range(0).second == 0);
+  GALOIS_LOG_ASSERT(sub->topology().edge_range(1).second == 2);
+  GALOIS_LOG_ASSERT(sub->topology().edge_range(3).second == 3);
+  CheckEdges(*g, *sub);
+
+  GALOIS_LOG_ASSERT(sub->node_schema()->num_fields() == 2);
+  auto values = std::static_pointer_cast<arrow::Int64Array>(
+      g->NodeProperty(0)->chunk(0));
+  auto sub_values = std::static_pointer_cast<arrow::Int64Array>(
+      sub->NodeProperty(0)->chunk(0));
+  auto node_ids = ParentNodeIds(*sub);
+  for (uint32_t n = 0; n < 4; ++n) {
+    GALOIS_LOG_ASSERT(
+        sub_values->Value(n) == values->Value(node_ids->Value(n)));
+  }
+
+  auto duplicate =
+      galois::graphs::ExtractInducedSubgraph(*g, {1, 2, 1}, {}, {});
+  GALOIS_LOG_ASSERT(
+      !duplicate && duplicate.error() == galois::ErrorCode::InvalidArgument);
+  auto out_of_range =
+      galois::graphs::ExtractInducedSubgraph(*g, {kNumNodes}, {}, {});
+  GALOIS_LOG_ASSERT(
+      !out_of_range &&
+      out_of_range.error() == galois::ErrorCode::InvalidArgument);
+  auto missing =
+      galois::graphs::ExtractInducedSubgraph(*g, {1}, {"no-such-prop"}, {});
+  GALOIS_LOG_ASSERT(
+      !missing && missing.error() == galois::ErrorCode::PropertyNotFound);
+}
+
+void
+TestSampleNeighborhood() {
+  LinePolicy policy{2};
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g =
+      MakeFileGraph<int64_t>(kNumNodes, 1, &policy);
+
+  // node 0 keeps one of 1 and 2, which keeps both of its edges
+  auto sub_result = galois::graphs::SampleNeighborhood(
+      *g, {0}, {1, galois::graphs::kAllNeighbors}, 7, {}, {});
+  GALOIS_LOG_VASSERT(sub_result, "{}", sub_result.error());
+  std::unique_ptr<galois::graphs::PropertyFileGraph> sub =
+      std::move(sub_result.value());
+  GALOIS_LOG_ASSERT(sub->topology().num_nodes() == 4);
+  GALOIS_LOG_ASSERT(sub->topology().num_edges() == 3);
+  GALOIS_LOG_ASSERT(ParentNodeIds(*sub)->Value(0) == 0);
+  CheckEdges(*g, *sub);
+
+  // the sample depends on the seed only
+  auto reference = galois::graphs::SampleNeighborhood(
+      *g, {0, 30, 60}, {2, 1, 1}, 7, {}, {});
+  GALOIS_LOG_ASSERT(reference);
+  CheckEdges(*g, *reference.value());
+  unsigned old_threads = galois::getActiveThreads();
+  for (unsigned threads : {1, 4}) {
+    galois::setActiveThreads(threads);
+    auto again = galois::graphs::SampleNeighborhood(
+        *g, {0, 30, 60}, {2, 1, 1}, 7, {}, {});
+    GALOIS_LOG_ASSERT(again);
+    GALOIS_LOG_ASSERT(again.value()->Equals(reference.value().get()));
+  }
+  galois::setActiveThreads(old_threads);
+}
+
+void
+TestRandomWalks() {
+  LinePolicy policy{2};
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g =
+      MakeFileGraph<int64_t>(kNumNodes, 1, &policy);
+  constexpr uint32_t kWalkLength = 5;
+
+  std::vector<uint32_t> starts{0, 40, 98, 40};
+  auto walks_result =
+      galois::graphs::RandomWalks(g->topology(), starts, kWalkLength, 3);
+  GALOIS_LOG_ASSERT(walks_result);
+  const std::vector<uint32_t>& walks = walks_result.value();
+  GALOIS_LOG_ASSERT(walks.size() == starts.size() * (kWalkLength + 1));
+  for (size_t w = 0; w < starts.size(); ++w) {
+    const uint32_t* walk = &walks[w * (kWalkLength + 1)];
+    GALOIS_LOG_ASSERT(walk[0] == starts[w]);
+    for (uint32_t step = 0; step < kWalkLength; ++step) {
+      uint32_t hop = (walk[step + 1] + kNumNodes - walk[step]) % kNumNodes;
+      GALOIS_LOG_ASSERT(hop == 1 || hop == 2);
+    }
+  }
+
+  auto sub_result = galois::graphs::SampleRandomWalks(
+      *g, starts, kWalkLength, 3, {}, {});
+  GALOIS_LOG_ASSERT(sub_result);
+  std::unique_ptr<galois::graphs::PropertyFileGraph> sub =
+      std::move(sub_result.value());
+  GALOIS_LOG_ASSERT(sub->topology().num_edges() <= starts.size() * kWalkLength);
+  CheckEdges(*g, *sub);
+  auto node_ids = ParentNodeIds(*sub);
+  for (uint32_t node : walks) {
+    bool found = false;
+    for (int64_t n = 0; n < node_ids->length(); ++n) {
+      found |= node_ids->Value(n) == node;
+    }
+    GALOIS_LOG_ASSERT(found);
+  }
+
+  // walks stop at nodes without edges
+  LinePolicy no_edges{0};
+  std::unique_ptr<galois::graphs::PropertyFileGraph> empty =
+      MakeFileGraph<int64_t>(kNumNodes, 1, &no_edges);
+  auto stuck = galois::graphs::RandomWalks(empty->topology(), {5}, 2, 3);
+  GALOIS_LOG_ASSERT(stuck);
+  using galois::graphs::kNoNode;
+  GALOIS_LOG_ASSERT(
+      stuck.value() == std::vector<uint32_t>({5, kNoNode, kNoNode}));
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(2);
+
+  TestInducedSubgraph();
+  TestSampleNeighborhood();
+  TestRandomWalks();
+
+  return 0;
+}
@@ -0,0 +1,81 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include <cstdlib>
+
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+
+namespace {
+
+constexpr uint64_t kNumItems = 100000;
+
+/// Each item pushes the next one until kNumItems, so the loop only ends when
+/// termination detection notices that all threads ran out of work
+void
+TestForEach() {
+  galois::GAccumulator<uint64_t> count;
+  galois::for_each(
+      galois::iterate({uint64_t{0}}),
+      [&](uint64_t i, auto& ctx) {
+        count += 1;
+        if (i + 1 < kNumItems) {
+          ctx.push(i + 1);
+        }
+      },
+      galois::disable_conflict_detection(), galois::no_stats());
+  GALOIS_LOG_VASSERT(
+      count.reduce() == kNumItems, "ran {} iterations", count.reduce());
+}
+
+/// Work stealing do_all uses termination detection to end too
+void
+TestDoAll() {
+  galois::GAccumulator<uint64_t> count;
+  galois::do_all(
+      galois::iterate(uint64_t{0}, kNumItems), [&](uint64_t) { count += 1; },
+      galois::steal(), galois::no_stats());
+  GALOIS_LOG_ASSERT(count.reduce() == kNumItems);
+}
+
+void
+Test(const char* kind) {
+  setenv("GALOIS_TERMINATION", kind, 1);
+  galois::SharedMemSys sys;
+
+  unsigned max_threads =
+      galois::substrate::GetThreadPool().getMaxUsableThreads();
+  // every shape of tree, including ones where sockets are partly active
+  for (unsigned threads = 1; threads <= max_threads; ++threads) {
+    galois::setActiveThreads(threads);
+    TestForEach();
+    TestDoAll();
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  Test("ring");
+  Test("tree");
+  Test("topo");
+
+  return 0;
+}
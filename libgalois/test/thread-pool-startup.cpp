@@ -0,0 +1,47 @@
+#include <algorithm>
+#include <atomic>
+
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/substrate/PerThreadStorage.h"
+#include "galois/substrate/ThreadPool.h"
+
+int
+main() {
+  galois::SharedMemSys sys;
+  auto& pool = galois::substrate::GetThreadPool();
+  unsigned max_threads = pool.getMaxUsableThreads();
+  GALOIS_LOG_ASSERT(pool.getStartedThreads() == 1);
+
+  // storage of threads that have not started yet is usable
+  galois::substrate::PerThreadStorage<unsigned> values;
+  for (unsigned i = 0; i < values.size(); ++i) {
+    *values.getRemote(i) = i + 1;
+  }
+
+  unsigned num = std::min(max_threads, 3U);
+  galois::setActiveThreads(num);
+  std::atomic<unsigned> ran{0};
+  galois::on_each([&](unsigned tid, unsigned) {
+    GALOIS_LOG_ASSERT(*values.getLocal() == tid + 1);
+    ++ran;
+  });
+  GALOIS_LOG_ASSERT(ran == num);
+  GALOIS_LOG_ASSERT(pool.getStartedThreads() == num);
+
+  // fewer threads start no more, and more threads start the rest
+  galois::setActiveThreads(1);
+  galois::do_all(galois::iterate(0, 100), [](int) {});
+  GALOIS_LOG_ASSERT(pool.getStartedThreads() == num);
+
+  galois::setActiveThreads(max_threads);
+  ran = 0;
+  galois::on_each([&](unsigned tid, unsigned) {
+    GALOIS_LOG_ASSERT(*values.getLocal() == tid + 1);
+    ++ran;
+  });
+  GALOIS_LOG_ASSERT(ran == max_threads);
+  GALOIS_LOG_ASSERT(pool.getStartedThreads() == max_threads);
+
+  return 0;
+}
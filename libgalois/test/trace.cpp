@@ -0,0 +1,97 @@
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/Trace.h"
+
+namespace {
+
+constexpr uint64_t kNumItems = 10000;
+
+/// Events of the trace by category and name
+std::map<std::pair<std::string, std::string>, uint64_t>
+CountEvents(const nlohmann::json& trace) {
+  std::map<std::pair<std::string, std::string>, uint64_t> counts;
+  for (const auto& event : trace.at("traceEvents")) {
+    if (event.at("ph") == "M") {
+      continue;
+    }
+    GALOIS_LOG_ASSERT(event.at("ts").get<double>() >= 0);
+    if (event.at("ph") == "X") {
+      GALOIS_LOG_ASSERT(event.at("dur").get<double>() >= 0);
+    }
+    ++counts[std::make_pair(event.at("cat"), event.at("name"))];
+  }
+  return counts;
+}
+
+void
+TestLoops(unsigned num_threads) {
+  galois::do_all(
+      galois::iterate(uint64_t{0}, kNumItems), [](uint64_t) {},
+      galois::steal(), galois::loopname("TraceDoAll"));
+  galois::for_each(
+      galois::iterate(uint64_t{0}, kNumItems), [](uint64_t, auto&) {},
+      galois::no_pushes(), galois::disable_conflict_detection(),
+      galois::wl<galois::worklists::PerSocketChunkFIFO<16>>(),
+      galois::loopname("TraceForEach"));
+
+  std::ostringstream out;
+  galois::WriteTrace(out);
+  nlohmann::json trace = nlohmann::json::parse(out.str());
+  auto counts = CountEvents(trace);
+
+  // every thread takes part in each loop
+  GALOIS_LOG_ASSERT(
+      (counts[std::make_pair("loop", "TraceDoAll")] == num_threads));
+  GALOIS_LOG_ASSERT(
+      (counts[std::make_pair("loop", "TraceForEach")] == num_threads));
+
+  // the for_each pops its kNumItems / 16 chunks, some of them maybe from
+  // other threads, except the chunk each thread is still filling when it
+  // starts to pop
+  uint64_t chunks = counts[std::make_pair("chunk", "pop chunk")] +
+                    counts[std::make_pair("steal", "steal chunk")];
+  GALOIS_LOG_VASSERT(
+      chunks + num_threads >= kNumItems / 16, "{} chunks", chunks);
+
+  // for_each waits at the barrier before it starts
+  uint64_t waits = 0;
+  for (const auto& [key, count] : counts) {
+    if (key.first == "barrier") {
+      waits += count;
+    }
+  }
+  GALOIS_LOG_ASSERT(waits >= num_threads);
+
+  std::set<std::string> names;
+  for (const auto& event : trace.at("traceEvents")) {
+    if (event.at("ph") == "M") {
+      names.insert(event.at("args").at("name").get<std::string>());
+    }
+  }
+  GALOIS_LOG_ASSERT(names.count("galois 0") == 1);
+}
+
+}  // namespace
+
+int
+main() {
+  // before SharedMemSys so that barrier waits are traced too
+  galois::SetTraceEnabled(true);
+
+  galois::SharedMemSys sys;
+  unsigned num_threads =
+      galois::substrate::GetThreadPool().getMaxUsableThreads();
+  galois::setActiveThreads(num_threads);
+
+  TestLoops(num_threads);
+
+  galois::SetTraceEnabled(false);
+  return 0;
+}
@@ -0,0 +1,194 @@
+#include <limits>
+
+#include <arrow/api.h>
+
+#include "TestPropertyGraph.h"
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/analytics/TraversalFilter.h"
+#include "galois/analytics/bfs/bfs.h"
+#include "galois/analytics/sssp/sssp.h"
+#include "galois/graphs/EdgeTypeIndex.h"
+
+namespace {
+
+using galois::analytics::BfsPlan;
+using galois::analytics::TraversalFilter;
+
+constexpr uint32_t kNumNodes = 100;
+constexpr uint32_t kUnreached = std::numeric_limits<uint32_t>::max();
+
+/// MakeGraph makes a line where node n has a STEP edge to n + 1 and a JUMP
+/// edge to n + 2 (mod kNumNodes); the edge from 0 to 1 is both. Even nodes
+/// are labeled Even.
+std::unique_ptr<galois::graphs::PropertyFileGraph>
+MakeGraph() {
+  LinePolicy policy{2};
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g =
+      MakeFileGraph<int64_t>(kNumNodes, 1, &policy);
+
+  std::vector<bool> step;
+  std::vector<bool> jump;
+  std::vector<int64_t> weight;
+  for (uint64_t e = 0; e < g->topology().num_edges(); ++e) {
+    step.emplace_back(e % 2 == 0);
+    jump.emplace_back(e % 2 == 1 || e == 0);
+    weight.emplace_back(1);
+  }
+  auto add_edges = g->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("STEP", arrow::boolean()),
+           arrow::field("JUMP", arrow::boolean()),
+           arrow::field("weight", arrow::int64())}),
+      {galois::BuildArray(step), galois::BuildArray(jump),
+       galois::BuildArray(weight)}));
+  GALOIS_LOG_ASSERT(add_edges);
+
+  std::vector<bool> even;
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    even.emplace_back(n % 2 == 0);
+  }
+  auto add_nodes = g->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("Even", arrow::boolean())}),
+      {galois::BuildArray(even)}));
+  GALOIS_LOG_ASSERT(add_nodes);
+  return g;
+}
+
+template <typename T>
+std::shared_ptr<arrow::NumericArray<T>>
+Values(const galois::graphs::PropertyFileGraph& g, const std::string& name) {
+  auto property = g.NodeProperty(name);
+  GALOIS_LOG_ASSERT(property && property->num_chunks() == 1);
+  return std::static_pointer_cast<arrow::NumericArray<T>>(property->chunk(0));
+}
+
+void
+TestEdgeTypeIndex() {
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g = MakeGraph();
+  auto index_result =
+      galois::graphs::EdgeTypeIndex::Make(*g, {"STEP", "JUMP"});
+  GALOIS_LOG_VASSERT(index_result, "{}", index_result.error());
+  const galois::graphs::EdgeTypeIndex& index = *index_result.value();
+  GALOIS_LOG_ASSERT(index.TypeIndex("JUMP") == 1);
+  GALOIS_LOG_ASSERT(index.TypeIndex("FOLLOWS") == -1);
+
+  // node 0 has a single edge of both types
+  GALOIS_LOG_ASSERT(
+      index.type_range(0, 0).first == index.type_range(0, 0).second);
+  GALOIS_LOG_ASSERT(index.type_range(0, 1) == std::make_pair(0UL, 1UL));
+  GALOIS_LOG_ASSERT(index.mixed_range(0) == std::make_pair(1UL, 2UL));
+  GALOIS_LOG_ASSERT(index.edge_id(0) == 1 && index.edge_id(1) == 0);
+  GALOIS_LOG_ASSERT(index.HasType(0, 0) && index.HasType(0, 1));
+  for (uint32_t n = 1; n < kNumNodes; ++n) {
+    auto [step_begin, step_end] = index.type_range(n, 0);
+    auto [jump_begin, jump_end] = index.type_range(n, 1);
+    GALOIS_LOG_ASSERT(step_end == step_begin + 1 && jump_end == jump_begin + 1);
+    GALOIS_LOG_ASSERT(
+        g->topology().out_dests->Value(index.edge_id(step_begin)) ==
+        (n + 1) % kNumNodes);
+    GALOIS_LOG_ASSERT(index.edge_dest(jump_begin) == (n + 2) % kNumNodes);
+    GALOIS_LOG_ASSERT(
+        index.untyped_range(n).first == index.untyped_range(n).second);
+  }
+
+  auto missing = galois::graphs::EdgeTypeIndex::Make(*g, {"FOLLOWS"});
+  GALOIS_LOG_ASSERT(
+      !missing && missing.error() == galois::ErrorCode::PropertyNotFound);
+  auto not_boolean = galois::graphs::EdgeTypeIndex::Make(*g, {"weight"});
+  GALOIS_LOG_ASSERT(
+      !not_boolean && not_boolean.error() == galois::ErrorCode::TypeError);
+}
+
+void
+TestBfs() {
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g;
+  for (BfsPlan plan : {BfsPlan::SyncTile(), BfsPlan::Sync()}) {
+    g = MakeGraph();
+    auto step_result = galois::analytics::Bfs(
+        g.get(), 0, "step", plan.WithFilter({{"STEP"}, {}}));
+    GALOIS_LOG_VASSERT(step_result, "{}", step_result.error());
+    auto step = Values<arrow::UInt32Type>(*g, "step");
+    for (uint32_t n = 0; n < kNumNodes; ++n) {
+      GALOIS_LOG_ASSERT(step->Value(n) == n);
+    }
+
+    // 0 -> 1 is a JUMP edge too, so odd nodes are reached from 1
+    auto jump_result = galois::analytics::Bfs(
+        g.get(), 0, "jump", plan.WithFilter({{"JUMP"}, {}}));
+    GALOIS_LOG_VASSERT(jump_result, "{}", jump_result.error());
+    auto jump = Values<arrow::UInt32Type>(*g, "jump");
+    for (uint32_t n = 0; n < kNumNodes; ++n) {
+      GALOIS_LOG_ASSERT(jump->Value(n) == (n % 2 == 0 ? n / 2 : n / 2 + 1));
+    }
+
+    auto even_result = galois::analytics::Bfs(
+        g.get(), 0, "even", plan.WithFilter({{}, {"Even"}}));
+    GALOIS_LOG_VASSERT(even_result, "{}", even_result.error());
+    auto even = Values<arrow::UInt32Type>(*g, "even");
+    for (uint32_t n = 0; n < kNumNodes; ++n) {
+      GALOIS_LOG_ASSERT(even->Value(n) == (n % 2 == 0 ? n / 2 : kUnreached));
+    }
+  }
+
+  // an index built once serves several calls
+  auto index_result = galois::graphs::EdgeTypeIndex::Make(*g, {"STEP"});
+  GALOIS_LOG_ASSERT(index_result);
+  TraversalFilter filter{
+      {"STEP"}, {"Even"}, std::move(index_result.value())};
+  auto both_result = galois::analytics::Bfs(
+      g.get(), 0, "both", BfsPlan::Sync().WithFilter(filter));
+  GALOIS_LOG_VASSERT(both_result, "{}", both_result.error());
+  auto both = Values<arrow::UInt32Type>(*g, "both");
+  GALOIS_LOG_ASSERT(both->Value(0) == 0);
+  for (uint32_t n = 1; n < kNumNodes; ++n) {
+    GALOIS_LOG_ASSERT(both->Value(n) == kUnreached);
+  }
+
+  filter.edge_types = {"JUMP"};
+  auto not_indexed = galois::analytics::Bfs(
+      g.get(), 0, "not-indexed", BfsPlan::Sync().WithFilter(filter));
+  GALOIS_LOG_ASSERT(
+      !not_indexed &&
+      not_indexed.error() == galois::ErrorCode::InvalidArgument);
+}
+
+void
+TestSssp() {
+  std::unique_ptr<galois::graphs::PropertyFileGraph> g = MakeGraph();
+  auto result = galois::analytics::Sssp(
+      g.get(), 0, "weight", "distance",
+      galois::analytics::SsspPlan::DeltaStep().WithFilter(
+          {{"STEP"}, {}}));
+  GALOIS_LOG_VASSERT(result, "{}", result.error());
+  auto distance = Values<arrow::Int64Type>(*g, "distance");
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    GALOIS_LOG_ASSERT(distance->Value(n) == n);
+  }
+  // the filtered weights are not left behind
+  GALOIS_LOG_ASSERT(g->edge_schema()->num_fields() == 4);
+
+  // the same distances reading the edges inline
+  result = galois::analytics::Sssp(
+      g.get(), 0, "weight", "inline-distance",
+      galois::analytics::SsspPlan::DeltaStep()
+          .WithFilter({{"STEP"}, {}})
+          .WithInlineEdges());
+  GALOIS_LOG_VASSERT(result, "{}", result.error());
+  auto inline_distance = Values<arrow::Int64Type>(*g, "inline-distance");
+  GALOIS_LOG_ASSERT(inline_distance->Equals(*distance));
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(2);
+
+  TestEdgeTypeIndex();
+  TestBfs();
+  TestSssp();
+
+  return 0;
+}
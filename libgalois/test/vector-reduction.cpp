@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <vector>
+
+#include "galois/Galois.h"
+#include "galois/Logging.h"
+#include "galois/VectorReduction.h"
+
+namespace {
+
+constexpr uint64_t kNumItems = 1000000;
+constexpr size_t kNumBuckets = 37;
+
+void
+TestHistogram() {
+  galois::GHistogram<> hist(kNumBuckets);
+  for (int round = 0; round < 2; ++round) {
+    galois::do_all(
+        galois::iterate(uint64_t{0}, kNumItems),
+        [&](uint64_t i) { hist.update(i % kNumBuckets, 1); });
+
+    std::vector<uint64_t> counts = hist.reduce();
+    GALOIS_LOG_ASSERT(counts.size() == kNumBuckets);
+    for (size_t b = 0; b < kNumBuckets; ++b) {
+      uint64_t expected = kNumItems / kNumBuckets +
+                          (b < kNumItems % kNumBuckets ? 1 : 0);
+      GALOIS_LOG_VASSERT(
+          counts[b] == expected, "bucket {}: {} != {}", b, counts[b],
+          expected);
+    }
+    hist.reset();
+    counts = hist.reduce();
+    GALOIS_LOG_ASSERT(std::all_of(
+        counts.begin(), counts.end(), [](uint64_t c) { return c == 0; }));
+  }
+
+  galois::GVectorAccumulator<double> sums;
+  sums.resize(2);
+  galois::do_all(
+      galois::iterate(uint64_t{0}, kNumItems),
+      [&](uint64_t i) { sums.update(i % 2, 0.5); });
+  std::vector<double> result = sums.reduce();
+  GALOIS_LOG_ASSERT(result[0] == kNumItems / 4.0);
+  GALOIS_LOG_ASSERT(result[1] == kNumItems / 4.0);
+
+  std::vector<double> into{7.0, 7.0};
+  sums.reduce_into(into.data());
+  GALOIS_LOG_ASSERT(into == result);
+}
+
+void
+TestTopK() {
+  galois::GTopK<uint64_t> top(10);
+  galois::do_all(
+      galois::iterate(uint64_t{0}, kNumItems),
+      [&](uint64_t i) { top.update((i * 7919) % kNumItems); });
+  std::vector<uint64_t> result = top.reduce();
+  GALOIS_LOG_ASSERT(result.size() == 10);
+  for (uint64_t i = 0; i < 10; ++i) {
+    GALOIS_LOG_VASSERT(
+        result[i] == kNumItems - 1 - i, "rank {} is {}", i, result[i]);
+  }
+
+  // the least with greater
+  galois::GTopK<uint64_t, std::greater<uint64_t>> bottom(3);
+  galois::do_all(
+      galois::iterate(uint64_t{0}, kNumItems),
+      [&](uint64_t i) { bottom.update(kNumItems - i); });
+  GALOIS_LOG_ASSERT((bottom.reduce() == std::vector<uint64_t>{1, 2, 3}));
+
+  // fewer values than k
+  galois::GTopK<uint64_t> few(100);
+  few.update(5);
+  few.update(9);
+  GALOIS_LOG_ASSERT((few.reduce() == std::vector<uint64_t>{9, 5}));
+  few.reset();
+  GALOIS_LOG_ASSERT(few.reduce().empty());
+}
+
+void
+TestSparseHistogram() {
+  galois::GSparseHistogram<> hist;
+  // value v is seen v times for the multiples of 1000
+  galois::do_all(galois::iterate(uint64_t{0}, kNumItems), [&](uint64_t i) {
+    uint64_t v = i / 1000 * 1000;
+    if (i % 1000 < v / 1000) {
+      hist.update(v);
+    }
+  });
+  std::map<uint64_t, uint64_t> counts = hist.reduce();
+  GALOIS_LOG_ASSERT(counts.size() == 999);
+  for (const auto& [value, count] : counts) {
+    GALOIS_LOG_VASSERT(
+        value % 1000 == 0 && count == value / 1000, "{}: {}", value, count);
+  }
+  hist.reset();
+  GALOIS_LOG_ASSERT(hist.reduce().empty());
+}
+
+void
+TestApproxDistinct() {
+  galois::GApproxDistinct distinct;
+  GALOIS_LOG_ASSERT(distinct.reduce() == 0);
+  // every value twice
+  galois::do_all(
+      galois::iterate(uint64_t{0}, kNumItems),
+      [&](uint64_t i) { distinct.update(i / 2); });
+  double estimate = distinct.reduce();
+  double expected = kNumItems / 2;
+  GALOIS_LOG_VASSERT(
+      std::abs(estimate - expected) < 0.05 * expected, "{} != {}", estimate,
+      expected);
+
+  distinct.reset();
+  for (uint64_t i = 0; i < 100; ++i) {
+    distinct.update(i * 12345);
+  }
+  estimate = distinct.reduce();
+  GALOIS_LOG_VASSERT(std::abs(estimate - 100) < 5, "{} != 100", estimate);
+}
+
+}  // namespace
+
+int
+main() {
+  galois::SharedMemSys sys;
+  galois::setActiveThreads(
+      galois::substrate::GetThreadPool().getMaxUsableThreads());
+
+  TestHistogram();
+  TestTopK();
+  TestSparseHistogram();
+  TestApproxDistinct();
+
+  return 0;
+}
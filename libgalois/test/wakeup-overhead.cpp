@@ -41,6 +41,10 @@ static cll::opt<int> trials(
     "trials", cll::desc("number of trials"), cll::init(1));
 static cll::opt<unsigned> threads(
     "threads", cll::desc("number of threads"), cll::init(2));
+static cll::opt<int> idleSpin(
+    "idleSpin",
+    cll::desc("microseconds idle threads spin before sleeping in DoAllSpin"),
+    cll::init(100));
 
 void
 runDoAllBurn(int num) {
@@ -64,6 +68,17 @@ runDoAll(int num) {
   }
 }
 
+void
+runDoAllSpin(int num) {
+  auto& pool = galois::substrate::GetThreadPool();
+  auto old_spin = pool.getIdleSpin();
+  pool.setIdleSpin(std::chrono::microseconds(idleSpin));
+
+  runDoAll(num);
+
+  pool.setIdleSpin(old_spin);
+}
+
 void
 runExplicitThread(int num) {
   galois::substrate::Barrier& barrier =
@@ -84,11 +99,21 @@ runExplicitThread(int num) {
 
 void
 run(std::function<void(int)> fn, std::string name) {
+  auto& pool = galois::substrate::GetThreadPool();
+  pool.resetWakeupStats();
+
   galois::Timer t;
   t.start();
   fn(size);
   t.stop();
-  std::cout << name << " time: " << t.get() << "\n";
+
+  galois::substrate::ThreadPool::WakeupStats stats = pool.getWakeupStats();
+  uint64_t wakeups = stats.spinning + stats.sleeping;
+  std::cout << name << " time: " << t.get() << " wakeups spinning: "
+            << stats.spinning << " sleeping: " << stats.sleeping
+            << " mean latency ns: "
+            << (wakeups ? stats.totalLatency / wakeups : 0)
+            << " max latency ns: " << stats.maxLatency << "\n";
 }
 
 std::atomic<int> EXIT;
@@ -111,6 +136,7 @@ main(int argc, char* argv[]) {
 
   for (int t = 0; t < trials; ++t) {
     run(runDoAll, "DoAll");
+    run(runDoAllSpin, "DoAllSpin");
     run(runDoAllBurn, "DoAllBurn");
     run(runExplicitThread, "ExplicitThread");
   }
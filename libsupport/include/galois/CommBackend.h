@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "galois/Logging.h"
 #include "galois/Result.h"
@@ -29,6 +30,28 @@ public:
   /// Notify other tasks that there was a failure; e.g., with MPI_Abort
   virtual void NotifyFailure() = 0;
 
+  // The collectives below have default implementations in terms of
+  // Broadcast, which take Num rounds; backends should override them with
+  // their native collectives, e.g., MPI_Allgatherv.
+
+  /// Gather val of every task on every task; the value of task i is at
+  /// index i
+  virtual std::vector<std::string> Allgatherv(const std::string& val);
+  /// Like Allgatherv for values of the same size on every task; returns the
+  /// values concatenated in task order
+  virtual std::string Allgather(const std::string& val);
+  /// Send vals[i], one value per task, to task i; the value sent by task i
+  /// is at index i. The default implementation sends every task all of the
+  /// values.
+  virtual std::vector<std::string> Alltoallv(
+      const std::vector<std::string>& vals);
+
+  enum class ReduceOp { kSum, kMin, kMax };
+  /// Reduce vals element-wise over all tasks with op; vals must have the
+  /// same length on every task
+  virtual std::vector<uint64_t> Allreduce(
+      const std::vector<uint64_t>& vals, ReduceOp op);
+
   // TODO(thunt): Num and ID were chosen because of NetworkInterface. Changing
   // them is very disruptive so I'll defer for a time in the future where we're
   // not worried about upstream and can global replace.
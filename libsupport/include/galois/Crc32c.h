@@ -0,0 +1,19 @@
+#ifndef GALOIS_LIBSUPPORT_GALOIS_CRC32C_H_
+#define GALOIS_LIBSUPPORT_GALOIS_CRC32C_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "galois/config.h"
+
+namespace galois {
+
+/// Return the CRC32C (Castagnoli) checksum of [data, data + size), as used
+/// by iSCSI and cloud object stores, continuing from crc, the checksum of
+/// the bytes before data; 0 starts a new checksum. Uses the CRC instructions
+/// of SSE4.2, when the CPU has them, or of ARMv8, when built for them.
+GALOIS_EXPORT uint32_t Crc32c(const void* data, size_t size, uint32_t crc = 0);
+
+}  // namespace galois
+
+#endif
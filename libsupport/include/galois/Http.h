@@ -1,6 +1,10 @@
 #ifndef GALOIS_LIBSUPPORT_GALOIS_HTTP_H_
 #define GALOIS_LIBSUPPORT_GALOIS_HTTP_H_
 
+#include <future>
+#include <string>
+#include <vector>
+
 #include "galois/JSON.h"
 #include "galois/Result.h"
 
@@ -8,6 +12,10 @@ namespace galois {
 
 GALOIS_EXPORT Result<void> HttpInit();
 
+// The requests below are thread safe. They reuse the connections of earlier
+// requests to the same server (keep-alive), and speak HTTP/2 over TLS when
+// libcurl and the server support it.
+
 /// Perform an HTTP get request on url and fill buffer with the result on success
 GALOIS_EXPORT Result<void> HttpGet(
     const std::string& url, std::vector<char>* response);
@@ -26,6 +34,21 @@ GALOIS_EXPORT Result<void> HttpPut(
 GALOIS_EXPORT Result<void> HttpDelete(
     const std::string& url, std::vector<char>* response);
 
+// Asynchronous versions of the requests above; each runs on its own thread
+// and the future holds the response on success
+
+GALOIS_EXPORT std::future<Result<std::vector<char>>> HttpGetAsync(
+    const std::string& url);
+
+GALOIS_EXPORT std::future<Result<std::vector<char>>> HttpPostAsync(
+    const std::string& url, const std::string& data);
+
+GALOIS_EXPORT std::future<Result<std::vector<char>>> HttpPutAsync(
+    const std::string& url, const std::string& data);
+
+GALOIS_EXPORT std::future<Result<std::vector<char>>> HttpDeleteAsync(
+    const std::string& url);
+
 template <typename T, typename Callable, typename... Args>
 Result<T>
 HttpOpJson(Callable func, Args&&... args) {
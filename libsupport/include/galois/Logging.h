@@ -1,6 +1,7 @@
 #ifndef GALOIS_LIBSUPPORT_GALOIS_LOGGING_H_
 #define GALOIS_LIBSUPPORT_GALOIS_LOGGING_H_
 
+#include <cstdint>
 #include <mutex>
 #include <sstream>
 #include <string>
@@ -28,6 +29,19 @@ struct fmt::formatter<std::error_code> : formatter<string_view> {
 };
 #endif
 
+/// The lowest level of messages that GALOIS_LOG_DEBUG, GALOIS_LOG_VERBOSE and
+/// GALOIS_LOG_WARN compile in, as an integer LogLevel; calls below it expand
+/// to nothing and do not evaluate their arguments. Errors are always logged.
+/// By default, debug messages are only compiled into builds without NDEBUG;
+/// define it to 0 to keep them in release builds.
+#ifndef GALOIS_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define GALOIS_LOG_MIN_LEVEL 1
+#else
+#define GALOIS_LOG_MIN_LEVEL 0
+#endif
+#endif
+
 namespace galois {
 
 enum class LogLevel {
@@ -44,6 +58,22 @@ GALOIS_EXPORT void LogString(LogLevel level, const std::string& s);
 
 }
 
+/// Choose whether log messages below LogLevel::Error go to a queue of the
+/// logging thread, which a background thread prints, instead of being printed
+/// by it under a lock shared by all threads. Each thread has a lock-free queue
+/// of a fixed number of messages (GALOIS_LOG_QUEUE_SIZE, 4096 by default);
+/// messages logged while it is full are dropped and counted. Errors first
+/// flush all queues and are then printed synchronously. The environment
+/// variable GALOIS_LOG_ASYNC sets the initial choice; by default, logging is
+/// synchronous.
+GALOIS_EXPORT void SetAsyncLogging(bool enabled);
+
+/// Print the messages queued by all threads so far
+GALOIS_EXPORT void FlushLogs();
+
+/// The number of messages dropped because the queue of their thread was full
+GALOIS_EXPORT uint64_t DroppedLogMessages();
+
 /// Log at a specific LogLevel.
 ///
 /// \tparam F         string-like type
@@ -90,20 +120,30 @@ LogLine(
         ::galois::LogLevel::Error, __FILE__, __LINE__, FMT_STRING(fmt_string), \
         ##__VA_ARGS__);                                                        \
   } while (0)
+
+#if GALOIS_LOG_MIN_LEVEL <= 3
 #define GALOIS_LOG_WARN(fmt_string, ...)                                       \
   do {                                                                         \
     ::galois::LogLine(                                                         \
         ::galois::LogLevel::Warning, __FILE__, __LINE__,                       \
         FMT_STRING(fmt_string), ##__VA_ARGS__);                                \
   } while (0)
+#else
+#define GALOIS_LOG_WARN(...)
+#endif
+
+#if GALOIS_LOG_MIN_LEVEL <= 1
 #define GALOIS_LOG_VERBOSE(fmt_string, ...)                                    \
   do {                                                                         \
     ::galois::LogLine(                                                         \
         ::galois::LogLevel::Verbose, __FILE__, __LINE__,                       \
         FMT_STRING(fmt_string), ##__VA_ARGS__);                                \
   } while (0)
+#else
+#define GALOIS_LOG_VERBOSE(...)
+#endif
 
-#ifndef NDEBUG
+#if GALOIS_LOG_MIN_LEVEL <= 0
 #define GALOIS_LOG_DEBUG(fmt_string, ...)                                      \
   do {                                                                         \
     ::galois::LogLine(                                                         \
@@ -134,6 +174,7 @@ LogLine(
     }                                                                          \
   } while (0)
 
+#if GALOIS_LOG_MIN_LEVEL <= 3
 #define GALOIS_WARN_ONCE(fmt_string, ...)                                      \
   do {                                                                         \
     static std::once_flag __galois_warn_once_flag;                             \
@@ -143,5 +184,8 @@ LogLine(
           FMT_STRING(fmt_string), ##__VA_ARGS__);                              \
     });                                                                        \
   } while (0)
+#else
+#define GALOIS_WARN_ONCE(...)
+#endif
 
 #endif
@@ -0,0 +1,90 @@
+#ifndef GALOIS_LIBSUPPORT_GALOIS_TRACE_H_
+#define GALOIS_LIBSUPPORT_GALOIS_TRACE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#include "galois/Result.h"
+#include "galois/config.h"
+
+/// A per-thread timeline of what the runtime does, written in the Chrome
+/// trace event format that chrome://tracing and Perfetto open.
+///
+/// Tracing is off unless GALOIS_TRACE names the file to write the trace to
+/// (or SetTraceEnabled turns it on). Each thread then records its events in
+/// a ring buffer of its own, so that threads never contend and only the last
+/// GALOIS_TRACE_EVENTS events (65536 by default) of each thread are kept.
+/// The runtime records
+///  - "loop": each thread's part of a parallel loop, named by its loopname,
+///  - "chunk": each chunk that a thread pops from a chunked worklist and
+///    "steal", each one it pops from another thread or steals in do_all,
+///  - "barrier": waits at the barrier of the loops, if tracing is on when
+///    SharedMemSys starts,
+///  - "io": tsuba reads and writes.
+/// When tracing is off, recording an event costs one load and branch.
+namespace galois {
+
+namespace internal {
+
+GALOIS_EXPORT extern std::atomic<bool> trace_enabled;
+
+}  // namespace internal
+
+inline bool
+TraceEnabled() {
+  return internal::trace_enabled.load(std::memory_order_relaxed);
+}
+
+/// Turns tracing on or off, e.g., for a test; GALOIS_TRACE sets the initial
+/// value
+GALOIS_EXPORT void SetTraceEnabled(bool enabled);
+
+/// Nanoseconds on the clock of trace events
+GALOIS_EXPORT uint64_t TraceNow();
+
+/// Records that the calling thread spent [begin, end) on name. category and
+/// name must outlive the call; names longer than an event holds are cut.
+GALOIS_EXPORT void TraceSpan(
+    const char* category, const char* name, uint64_t begin, uint64_t end);
+
+/// Records that something happened on the calling thread now
+GALOIS_EXPORT void TraceInstant(const char* category, const char* name);
+
+/// Names the calling thread in the trace, e.g., "worker 3"
+GALOIS_EXPORT void SetTraceThreadName(const std::string& name);
+
+/// Writes the events recorded so far as one Chrome trace JSON object
+GALOIS_EXPORT void WriteTrace(std::ostream& out);
+
+/// If tracing is on and GALOIS_TRACE is set, writes the trace to that file.
+/// galois::PrintStats calls this.
+GALOIS_EXPORT Result<void> WriteTraceFile();
+
+/// Records the lifetime of a scope as a span if tracing is on when the scope
+/// begins
+class TraceScope {
+  const char* category_;
+  const char* name_;
+  uint64_t begin_;
+
+public:
+  TraceScope(const char* category, const char* name)
+      : category_(category),
+        name_(name),
+        begin_(TraceEnabled() ? TraceNow() : 0) {}
+
+  ~TraceScope() {
+    if (begin_ != 0) {
+      TraceSpan(category_, name_, begin_, TraceNow());
+    }
+  }
+
+  TraceScope(const TraceScope&) = delete;
+  TraceScope& operator=(const TraceScope&) = delete;
+};
+
+}  // namespace galois
+
+#endif
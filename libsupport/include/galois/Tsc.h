@@ -0,0 +1,101 @@
+#ifndef GALOIS_LIBSUPPORT_GALOIS_TSC_H_
+#define GALOIS_LIBSUPPORT_GALOIS_TSC_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "galois/config.h"
+
+/// Timestamps from the cycle counter of the processor (rdtsc on x86,
+/// cntvct_el0 on aarch64), which take a few nanoseconds to read instead of
+/// the tens that steady_clock takes, for timing per chunk or per round.
+///
+/// The counter is only used once CalibrateTsc has measured its frequency
+/// against steady_clock and found that it is invariant, i.e., that it ticks
+/// at the same rate in every core and power state. SharedMemSys calibrates
+/// when it starts. Until then, without an invariant counter or with
+/// GALOIS_TSC=0, timestamps come from steady_clock.
+namespace galois {
+
+namespace internal {
+
+GALOIS_EXPORT extern std::atomic<bool> tsc_enabled;
+
+}  // namespace internal
+
+/// The raw value of the cycle counter, or 0 where there is none
+inline uint64_t
+ReadCycleCounter() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#elif defined(__aarch64__)
+  uint64_t ticks;
+  asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+  return ticks;
+#else
+  return 0;
+#endif
+}
+
+/// Ticks on the clock of TscNow: of the cycle counter once it is calibrated,
+/// otherwise steady_clock nanoseconds
+inline uint64_t
+TscNow() {
+  if (internal::tsc_enabled.load(std::memory_order_relaxed)) {
+    return ReadCycleCounter();
+  }
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/// Measures the frequency of the cycle counter and, if it is invariant,
+/// switches TscNow to it. Only the first call does anything. Call it before
+/// taking the timestamps to compare, since ticks from before and after the
+/// switch are in different units.
+GALOIS_EXPORT void CalibrateTsc();
+
+/// Whether TscNow reads the cycle counter
+inline bool
+TscEnabled() {
+  return internal::tsc_enabled.load(std::memory_order_relaxed);
+}
+
+/// The number of ticks of TscNow per nanosecond
+GALOIS_EXPORT double TscTicksPerNsec();
+
+/// Converts a number of ticks of TscNow to nanoseconds
+GALOIS_EXPORT uint64_t TscToNsec(uint64_t ticks);
+
+/// Nanoseconds on the epoch of steady_clock, from the cycle counter once it
+/// is calibrated
+GALOIS_EXPORT uint64_t TscNowNsec();
+
+/// A timer on TscNow, for intervals too short for galois::Timer
+class TscTimer {
+  uint64_t start_{0};
+  uint64_t ticks_{0};
+
+public:
+  void start() { start_ = TscNow(); }
+
+  //! adds the current interval to the total
+  void stop() { ticks_ += TscNow() - start_; }
+
+  void reset() { ticks_ = 0; }
+
+  uint64_t get_ticks() const { return ticks_; }
+
+  uint64_t get_nsec() const { return TscToNsec(ticks_); }
+
+  uint64_t get_usec() const { return get_nsec() / 1000; }
+};
+
+}  // namespace galois
+
+#endif
@@ -0,0 +1,101 @@
+#include "galois/CommBackend.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+void
+AppendSize(std::string* s, uint64_t size) {
+  s->append(reinterpret_cast<const char*>(&size), sizeof(size));
+}
+
+uint64_t
+ReadSize(const std::string& s, uint64_t offset) {
+  GALOIS_LOG_ASSERT(offset + sizeof(uint64_t) <= s.size());
+  uint64_t size;
+  std::memcpy(&size, s.data() + offset, sizeof(size));
+  return size;
+}
+
+}  // namespace
+
+std::vector<std::string>
+galois::CommBackend::Allgatherv(const std::string& val) {
+  std::vector<std::string> vals(Num);
+  for (uint32_t root = 0; root < Num; ++root) {
+    std::string size_s;
+    AppendSize(&size_s, val.size());
+    uint64_t size = ReadSize(Broadcast(root, size_s, sizeof(uint64_t)), 0);
+    vals[root] = Broadcast(root, val, size);
+  }
+  return vals;
+}
+
+std::string
+galois::CommBackend::Allgather(const std::string& val) {
+  std::string all;
+  all.reserve(val.size() * Num);
+  for (const auto& v : Allgatherv(val)) {
+    GALOIS_LOG_ASSERT(v.size() == val.size());
+    all += v;
+  }
+  return all;
+}
+
+std::vector<std::string>
+galois::CommBackend::Alltoallv(const std::vector<std::string>& vals) {
+  GALOIS_LOG_ASSERT(vals.size() == Num);
+  std::string packed;
+  for (const auto& v : vals) {
+    AppendSize(&packed, v.size());
+    packed += v;
+  }
+
+  std::vector<std::string> received = Allgatherv(packed);
+  for (auto& r : received) {
+    // skip to the value for this task
+    uint64_t offset = 0;
+    for (uint32_t i = 0; i < ID; ++i) {
+      offset += sizeof(uint64_t) + ReadSize(r, offset);
+    }
+    uint64_t size = ReadSize(r, offset);
+    GALOIS_LOG_ASSERT(offset + sizeof(uint64_t) + size <= r.size());
+    r = r.substr(offset + sizeof(uint64_t), size);
+  }
+  return received;
+}
+
+std::vector<uint64_t>
+galois::CommBackend::Allreduce(
+    const std::vector<uint64_t>& vals, ReduceOp op) {
+  std::string packed(
+      reinterpret_cast<const char*>(vals.data()),
+      vals.size() * sizeof(uint64_t));
+  std::string all = Allgather(packed);
+
+  std::vector<uint64_t> result = vals;
+  for (uint32_t task = 0; task < Num; ++task) {
+    const char* task_vals = all.data() + task * packed.size();
+    for (size_t i = 0; i < result.size(); ++i) {
+      uint64_t v;
+      std::memcpy(&v, task_vals + i * sizeof(v), sizeof(v));
+      if (task == 0) {
+        result[i] = v;
+        continue;
+      }
+      switch (op) {
+      case ReduceOp::kSum:
+        result[i] += v;
+        break;
+      case ReduceOp::kMin:
+        result[i] = std::min(result[i], v);
+        break;
+      case ReduceOp::kMax:
+        result[i] = std::max(result[i], v);
+        break;
+      }
+    }
+  }
+  return result;
+}
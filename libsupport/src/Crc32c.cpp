@@ -0,0 +1,133 @@
+#include "galois/Crc32c.h"
+
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#elif defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+namespace {
+
+/// The reflected CRC32C polynomial
+constexpr uint32_t kPolynomial = 0x82F63B78;
+
+using Tables = std::array<std::array<uint32_t, 256>, 8>;
+
+/// Tables for slicing-by-8: tables[k][b] is the checksum of byte b followed
+/// by k zero bytes
+constexpr Tables
+MakeTables() {
+  Tables tables{};
+  for (uint32_t b = 0; b < 256; ++b) {
+    uint32_t crc = b;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ ((crc & 1) != 0 ? kPolynomial : 0);
+    }
+    tables[0][b] = crc;
+  }
+  for (uint32_t b = 0; b < 256; ++b) {
+    for (size_t k = 1; k < tables.size(); ++k) {
+      uint32_t prev = tables[k - 1][b];
+      tables[k][b] = (prev >> 8) ^ tables[0][prev & 0xFF];
+    }
+  }
+  return tables;
+}
+
+constexpr Tables kTables = MakeTables();
+
+uint32_t
+Crc32cSoftware(const uint8_t* data, size_t size, uint32_t crc) {
+  while (size >= 8) {
+    uint64_t word = 0;
+    std::memcpy(&word, data, sizeof(word));
+    // little endian, like the CRC instructions
+    word ^= crc;
+    crc = kTables[7][word & 0xFF] ^ kTables[6][(word >> 8) & 0xFF] ^
+          kTables[5][(word >> 16) & 0xFF] ^ kTables[4][(word >> 24) & 0xFF] ^
+          kTables[3][(word >> 32) & 0xFF] ^ kTables[2][(word >> 40) & 0xFF] ^
+          kTables[1][(word >> 48) & 0xFF] ^ kTables[0][word >> 56];
+    data += 8;
+    size -= 8;
+  }
+  for (; size > 0; --size, ++data) {
+    crc = (crc >> 8) ^ kTables[0][(crc ^ *data) & 0xFF];
+  }
+  return crc;
+}
+
+#if defined(__x86_64__)
+
+__attribute__((target("sse4.2"))) uint32_t
+Crc32cHardware(const uint8_t* data, size_t size, uint32_t crc) {
+  uint64_t crc64 = crc;
+  while (size >= 8) {
+    uint64_t word = 0;
+    std::memcpy(&word, data, sizeof(word));
+    crc64 = _mm_crc32_u64(crc64, word);
+    data += 8;
+    size -= 8;
+  }
+  crc = static_cast<uint32_t>(crc64);
+  for (; size > 0; --size, ++data) {
+    crc = _mm_crc32_u8(crc, *data);
+  }
+  return crc;
+}
+
+bool
+HaveHardware() {
+  static const bool have = __builtin_cpu_supports("sse4.2");
+  return have;
+}
+
+#elif defined(__ARM_FEATURE_CRC32)
+
+uint32_t
+Crc32cHardware(const uint8_t* data, size_t size, uint32_t crc) {
+  while (size >= 8) {
+    uint64_t word = 0;
+    std::memcpy(&word, data, sizeof(word));
+    crc = __crc32cd(crc, word);
+    data += 8;
+    size -= 8;
+  }
+  for (; size > 0; --size, ++data) {
+    crc = __crc32cb(crc, *data);
+  }
+  return crc;
+}
+
+bool
+HaveHardware() {
+  return true;
+}
+
+#else
+
+uint32_t
+Crc32cHardware(const uint8_t* data, size_t size, uint32_t crc) {
+  return Crc32cSoftware(data, size, crc);
+}
+
+bool
+HaveHardware() {
+  return false;
+}
+
+#endif
+
+}  // namespace
+
+uint32_t
+galois::Crc32c(const void* data, size_t size, uint32_t crc) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  // the checksum is of the bits inverted before and after
+  crc = ~crc;
+  crc = HaveHardware() ? Crc32cHardware(bytes, size, crc)
+                       : Crc32cSoftware(bytes, size, crc);
+  return ~crc;
+}
@@ -1,5 +1,9 @@
 #include "galois/Http.h"
 
+#include <future>
+#include <mutex>
+#include <vector>
+
 #include <curl/curl.h>
 
 #include "galois/ErrorCode.h"
@@ -8,6 +12,81 @@
 
 namespace {
 
+/// Idle easy handles and the caches they share. A request takes a handle
+/// from the pool and gives it back when it is done, so the handle keeps its
+/// connections open for the next request; the share handle lets every
+/// handle reuse the connections, DNS entries and TLS sessions of the others.
+class CurlPool {
+  /// Idle handles beyond this many are closed
+  static constexpr size_t kMaxIdle = 64;
+
+  std::mutex mutex_;
+  std::vector<CURL*> idle_;
+  CURLSH* share_{};
+  std::mutex share_locks_[CURL_LOCK_DATA_LAST];
+
+  static void LockCB(
+      CURL*, curl_lock_data data, curl_lock_access, void* user_data) {
+    static_cast<CurlPool*>(user_data)->share_locks_[data].lock();
+  }
+
+  static void UnlockCB(CURL*, curl_lock_data data, void* user_data) {
+    static_cast<CurlPool*>(user_data)->share_locks_[data].unlock();
+  }
+
+  CurlPool() {
+    share_ = curl_share_init();
+    if (share_ == nullptr) {
+      return;
+    }
+    curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, LockCB);
+    curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, UnlockCB);
+    curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+  }
+
+public:
+  /// The pool is never destroyed so that requests made while other static
+  /// objects are destroyed still find it
+  static CurlPool& Get() {
+    static CurlPool* pool = new CurlPool();
+    return *pool;
+  }
+
+  CURL* Acquire() {
+    CURL* handle = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!idle_.empty()) {
+        handle = idle_.back();
+        idle_.pop_back();
+      }
+    }
+    if (handle == nullptr) {
+      handle = curl_easy_init();
+    }
+    return handle;
+  }
+
+  /// Clears the options of handle, which keeps its connections, and makes
+  /// it available to the next request
+  void Release(CURL* handle) {
+    curl_easy_reset(handle);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (idle_.size() < kMaxIdle) {
+        idle_.push_back(handle);
+        return;
+      }
+    }
+    curl_easy_cleanup(handle);
+  }
+
+  CURLSH* share() const { return share_; }
+};
+
 class CurlHandle {
   CURL* handle_{};
   struct curl_slist* headers_{};
@@ -38,11 +117,27 @@ public:
 
   static galois::Result<CurlHandle> Make(
       const std::string& url, std::vector<char>* response) {
-    CURL* curl = curl_easy_init();
+    CurlPool& pool = CurlPool::Get();
+    CURL* curl = pool.Acquire();
     if (!curl) {
       return galois::ErrorCode::HttpError;
     }
     CurlHandle handle(curl);
+    if (pool.share() != nullptr) {
+      if (auto res = handle.SetOpt(CURLOPT_SHARE, pool.share()); !res) {
+        return res.error();
+      }
+    }
+    // handles may be used from many threads
+    if (auto res = handle.SetOpt(CURLOPT_NOSIGNAL, 1L); !res) {
+      return res.error();
+    }
+    if (auto res = handle.SetOpt(CURLOPT_TCP_KEEPALIVE, 1L); !res) {
+      return res.error();
+    }
+    // HTTP/2 over TLS where both ends support it; not every libcurl is
+    // built with it, so failing to ask for it is not an error
+    curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
     if (auto res = handle.SetOpt(CURLOPT_URL, url.c_str()); !res) {
       return res.error();
     }
@@ -58,12 +153,12 @@ public:
 
   CURL* handle() { return handle_; }
   ~CurlHandle() {
+    if (handle_ != nullptr) {
+      CurlPool::Get().Release(handle_);
+    }
     if (headers_ != nullptr) {
       curl_slist_free_all(headers_);
     }
-    if (handle_ != nullptr) {
-      curl_easy_cleanup(handle_);
-    }
   }
 
   void SetHeader(const std::string& header) {
@@ -123,6 +218,21 @@ HttpUploadCommon(CurlHandle&& holder, const std::string& data) {
   return holder.Perform();
 }
 
+/// Runs op on another thread with a response buffer of its own
+template <typename Op>
+std::future<galois::Result<std::vector<char>>>
+HttpAsync(Op op) {
+  return std::async(
+      std::launch::async,
+      [op = std::move(op)]() -> galois::Result<std::vector<char>> {
+        std::vector<char> response;
+        if (auto res = op(&response); !res) {
+          return res.error();
+        }
+        return galois::Result<std::vector<char>>(std::move(response));
+      });
+}
+
 }  // namespace
 
 galois::Result<void>
@@ -199,6 +309,33 @@ galois::HttpPut(
   return galois::ResultSuccess();
 }
 
+std::future<galois::Result<std::vector<char>>>
+galois::HttpGetAsync(const std::string& url) {
+  return HttpAsync(
+      [url](std::vector<char>* response) { return HttpGet(url, response); });
+}
+
+std::future<galois::Result<std::vector<char>>>
+galois::HttpPostAsync(const std::string& url, const std::string& data) {
+  return HttpAsync([url, data](std::vector<char>* response) {
+    return HttpPost(url, data, response);
+  });
+}
+
+std::future<galois::Result<std::vector<char>>>
+galois::HttpPutAsync(const std::string& url, const std::string& data) {
+  return HttpAsync([url, data](std::vector<char>* response) {
+    return HttpPut(url, data, response);
+  });
+}
+
+std::future<galois::Result<std::vector<char>>>
+galois::HttpDeleteAsync(const std::string& url) {
+  return HttpAsync([url](std::vector<char>* response) {
+    return HttpDelete(url, response);
+  });
+}
+
 galois::Result<void>
 galois::HttpInit() {
   auto init_ret = curl_global_init(CURL_GLOBAL_ALL);
@@ -1,12 +1,25 @@
 #include "galois/Logging.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
 #include <iostream>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 #include "galois/Env.h"
 
 namespace {
 
+constexpr size_t kDefaultQueueSize = 4096;
+
+/// How long the printing thread sleeps when there is nothing to print
+constexpr auto kDrainInterval = std::chrono::milliseconds(5);
+
 void
 PrintString(
     bool error, bool flush, const std::string& prefix, const std::string& s) {
@@ -23,27 +36,243 @@ PrintString(
   }
 }
 
-}  // end unnamed namespace
-
 void
-galois::internal::LogString(galois::LogLevel level, const std::string& s) {
-  int env_log_level = static_cast<int32_t>(LogLevel::Debug);
-  GetEnv("GALOIS_LOG_LEVEL", &env_log_level);
-  // Only log GALOIS_LOG_LEVEL and above (default, log everything)
-  if (static_cast<int32_t>(level) < env_log_level) {
-    return;
-  }
-
+Print(galois::LogLevel level, const std::string& s) {
   switch (level) {
-  case LogLevel::Debug:
+  case galois::LogLevel::Debug:
     return PrintString(true, false, "DEBUG", s);
-  case LogLevel::Verbose:
+  case galois::LogLevel::Verbose:
     return PrintString(true, false, "VERBOSE", s);
-  case LogLevel::Warning:
+  case galois::LogLevel::Warning:
     return PrintString(true, false, "WARNING", s);
-  case LogLevel::Error:
+  case galois::LogLevel::Error:
     return PrintString(true, false, "ERROR", s);
   default:
     std::abort();
   }
 }
+
+struct Message {
+  galois::LogLevel level;
+  std::string text;
+};
+
+/// The messages of one thread: a single-producer single-consumer ring in
+/// which the thread appends at head and the printing thread, under the lock
+/// of the registry, removes at tail
+struct Queue {
+  explicit Queue(size_t size) : messages(size), mask(size - 1) {}
+
+  std::vector<Message> messages;
+  size_t mask;
+  alignas(64) std::atomic<uint64_t> head{0};
+  alignas(64) std::atomic<uint64_t> tail{0};
+  /// Whether a live thread owns the queue; the queues of exited threads are
+  /// handed to new ones
+  std::atomic<bool> owned{true};
+
+  bool Push(galois::LogLevel level, const std::string& s) {
+    uint64_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) == messages.size()) {
+      return false;
+    }
+    Message& message = messages[h & mask];
+    message.level = level;
+    message.text = s;
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  void Drain() {
+    uint64_t t = tail.load(std::memory_order_relaxed);
+    for (uint64_t h = head.load(std::memory_order_acquire); t != h; ++t) {
+      Message& message = messages[t & mask];
+      Print(message.level, message.text);
+      message.text.clear();
+      tail.store(t + 1, std::memory_order_release);
+    }
+  }
+};
+
+struct Registry {
+  /// Serializes registering and draining queues
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::vector<std::unique_ptr<Queue>> queues;
+  size_t queue_size{kDefaultQueueSize};
+
+  std::atomic<bool> async{false};
+  /// Set at exit, after which everything is printed synchronously again
+  std::atomic<bool> stopped{false};
+  std::thread printer;
+  std::atomic<uint64_t> dropped{0};
+  uint64_t reported_dropped{0};
+
+  int min_level{static_cast<int>(galois::LogLevel::Debug)};
+
+  void DrainAll() {
+    for (const auto& queue : queues) {
+      queue->Drain();
+    }
+    uint64_t now_dropped = dropped.load(std::memory_order_relaxed);
+    if (now_dropped != reported_dropped) {
+      Print(
+          galois::LogLevel::Warning,
+          "log queues full, dropped " +
+              std::to_string(now_dropped - reported_dropped) + " messages");
+      reported_dropped = now_dropped;
+    }
+  }
+};
+
+Registry&
+GetRegistry() {
+  // never destroyed, so that threads that outlive main can still log
+  static Registry* registry = new Registry;
+  return *registry;
+}
+
+/// Returns the queue of a thread that exited
+struct QueueOwner {
+  Queue* queue{nullptr};
+
+  ~QueueOwner() {
+    if (queue != nullptr) {
+      queue->owned.store(false, std::memory_order_release);
+    }
+  }
+};
+
+thread_local QueueOwner local_queue;
+
+Queue&
+LocalQueue() {
+  if (local_queue.queue == nullptr) {
+    Registry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const auto& queue : registry.queues) {
+      if (!queue->owned.load(std::memory_order_acquire)) {
+        queue->owned.store(true, std::memory_order_relaxed);
+        local_queue.queue = queue.get();
+        return *local_queue.queue;
+      }
+    }
+    registry.queues.emplace_back(
+        std::make_unique<Queue>(registry.queue_size));
+    local_queue.queue = registry.queues.back().get();
+  }
+  return *local_queue.queue;
+}
+
+void
+StopPrinter() {
+  Registry& registry = GetRegistry();
+  {
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    if (!registry.printer.joinable()) {
+      return;
+    }
+    registry.stopped = true;
+  }
+  registry.wake.notify_one();
+  registry.printer.join();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.DrainAll();
+}
+
+void
+RunPrinter() {
+  Registry& registry = GetRegistry();
+  std::unique_lock<std::mutex> lock(registry.mutex);
+  while (!registry.stopped) {
+    registry.DrainAll();
+    registry.wake.wait_for(lock, kDrainInterval);
+  }
+}
+
+void
+StartPrinter() {
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  if (registry.printer.joinable() || registry.stopped) {
+    return;
+  }
+  registry.printer = std::thread(RunPrinter);
+  std::atexit(StopPrinter);
+}
+
+/// Reads the environment once, on the first message
+bool
+InitFromEnv() {
+  Registry& registry = GetRegistry();
+  galois::GetEnv("GALOIS_LOG_LEVEL", &registry.min_level);
+  if (int size = 0; galois::GetEnv("GALOIS_LOG_QUEUE_SIZE", &size)) {
+    // the rings index by mask
+    size_t rounded = 1;
+    while (rounded < static_cast<size_t>(std::max(size, 1))) {
+      rounded *= 2;
+    }
+    registry.queue_size = rounded;
+  }
+  bool async = false;
+  if (galois::GetEnv("GALOIS_LOG_ASYNC", &async) && async) {
+    StartPrinter();
+    registry.async = true;
+  }
+  return true;
+}
+
+Registry&
+GetInitializedRegistry() {
+  static bool initialized = InitFromEnv();
+  (void)initialized;
+  return GetRegistry();
+}
+
+}  // end unnamed namespace
+
+void
+galois::SetAsyncLogging(bool enabled) {
+  Registry& registry = GetInitializedRegistry();
+  if (enabled) {
+    StartPrinter();
+  } else {
+    FlushLogs();
+  }
+  registry.async = enabled;
+}
+
+void
+galois::FlushLogs() {
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.DrainAll();
+}
+
+uint64_t
+galois::DroppedLogMessages() {
+  return GetRegistry().dropped.load(std::memory_order_relaxed);
+}
+
+void
+galois::internal::LogString(galois::LogLevel level, const std::string& s) {
+  Registry& registry = GetInitializedRegistry();
+  // Only log GALOIS_LOG_LEVEL and above (default, log everything)
+  if (static_cast<int32_t>(level) < registry.min_level) {
+    return;
+  }
+
+  if (!registry.async.load(std::memory_order_relaxed) ||
+      registry.stopped.load(std::memory_order_relaxed)) {
+    return Print(level, s);
+  }
+  if (level == LogLevel::Error) {
+    // errors often precede an abort, so they must not wait in a queue, nor
+    // appear before the messages that led to them
+    FlushLogs();
+    return Print(level, s);
+  }
+  if (!LocalQueue().Push(level, s)) {
+    registry.dropped.fetch_add(1, std::memory_order_relaxed);
+  }
+}
@@ -0,0 +1,213 @@
+#include "galois/Trace.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "galois/Env.h"
+#include "galois/Tsc.h"
+
+namespace {
+
+constexpr size_t kDefaultCapacity = 65536;
+
+/// Name bytes in an event, with the terminating zero
+constexpr size_t kNameSize = 40;
+
+struct Event {
+  uint64_t begin;
+  uint64_t end;
+  const char* category;
+  bool instant;
+  char name[kNameSize];
+};
+
+/// The events of one thread; only that thread adds to it
+struct ThreadBuffer {
+  uint32_t id;
+  std::string name;
+  std::vector<Event> events;
+  /// Once events is full, the slot that the next event overwrites
+  size_t next{0};
+};
+
+struct Registry {
+  std::mutex mutex;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+  size_t capacity{kDefaultCapacity};
+  std::string path;
+};
+
+Registry&
+GetRegistry() {
+  // never destroyed, so that threads that outlive main can still trace
+  static Registry* registry = new Registry;
+  return *registry;
+}
+
+thread_local ThreadBuffer* local_buffer = nullptr;
+thread_local std::string local_name;
+
+ThreadBuffer&
+LocalBuffer() {
+  if (local_buffer == nullptr) {
+    Registry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto buffer = std::make_unique<ThreadBuffer>();
+    buffer->id = registry.buffers.size();
+    buffer->name = local_name.empty() ? "thread " + std::to_string(buffer->id)
+                                      : local_name;
+    local_buffer = buffer.get();
+    registry.buffers.emplace_back(std::move(buffer));
+  }
+  return *local_buffer;
+}
+
+void
+AddEvent(const Event& event) {
+  ThreadBuffer& buffer = LocalBuffer();
+  size_t capacity = GetRegistry().capacity;
+  if (buffer.events.size() < capacity) {
+    buffer.events.push_back(event);
+    return;
+  }
+  buffer.events[buffer.next] = event;
+  buffer.next = (buffer.next + 1) % capacity;
+}
+
+Event
+MakeEvent(const char* category, const char* name, uint64_t begin) {
+  Event event;
+  event.begin = begin;
+  event.end = begin;
+  event.category = category;
+  event.instant = false;
+  std::strncpy(event.name, name, kNameSize - 1);
+  event.name[kNameSize - 1] = '\0';
+  return event;
+}
+
+void
+WriteJSONString(std::ostream& out, const char* s) {
+  out << '"';
+  for (; *s != '\0'; ++s) {
+    char c = *s;
+    if (c == '"' || c == '\\') {
+      out << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      out << ' ';
+    } else {
+      out << c;
+    }
+  }
+  out << '"';
+}
+
+bool
+InitFromEnv() {
+  Registry& registry = GetRegistry();
+  if (int capacity = 0; galois::GetEnv("GALOIS_TRACE_EVENTS", &capacity)) {
+    registry.capacity = std::max(capacity, 1);
+  }
+  return galois::GetEnv("GALOIS_TRACE", &registry.path) &&
+         !registry.path.empty();
+}
+
+}  // namespace
+
+std::atomic<bool> galois::internal::trace_enabled{InitFromEnv()};
+
+void
+galois::SetTraceEnabled(bool enabled) {
+  internal::trace_enabled = enabled;
+}
+
+uint64_t
+galois::TraceNow() {
+  return TscNowNsec();
+}
+
+void
+galois::TraceSpan(
+    const char* category, const char* name, uint64_t begin, uint64_t end) {
+  Event event = MakeEvent(category, name, begin);
+  event.end = end;
+  AddEvent(event);
+}
+
+void
+galois::TraceInstant(const char* category, const char* name) {
+  Event event = MakeEvent(category, name, TraceNow());
+  event.instant = true;
+  AddEvent(event);
+}
+
+void
+galois::SetTraceThreadName(const std::string& name) {
+  local_name = name;
+  if (local_buffer != nullptr) {
+    std::lock_guard<std::mutex> lock(GetRegistry().mutex);
+    local_buffer->name = name;
+  }
+}
+
+void
+galois::WriteTrace(std::ostream& out) {
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  uint64_t origin = UINT64_MAX;
+  for (const auto& buffer : registry.buffers) {
+    for (const Event& event : buffer->events) {
+      origin = std::min(origin, event.begin);
+    }
+  }
+
+  // timestamps and durations are in microseconds
+  auto micros = [](uint64_t ns) { return double(ns) / 1000; };
+
+  out << "{\"traceEvents\":[";
+  const char* sep = "\n";
+  for (const auto& buffer : registry.buffers) {
+    out << sep << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+        << buffer->id << ",\"args\":{\"name\":";
+    WriteJSONString(out, buffer->name.c_str());
+    out << "}}";
+    sep = ",\n";
+
+    for (const Event& event : buffer->events) {
+      out << sep << "{\"name\":";
+      WriteJSONString(out, event.name);
+      out << ",\"cat\":";
+      WriteJSONString(out, event.category);
+      if (event.instant) {
+        out << ",\"ph\":\"i\",\"s\":\"t\"";
+      } else {
+        out << ",\"ph\":\"X\",\"dur\":" << micros(event.end - event.begin);
+      }
+      out << ",\"ts\":" << micros(event.begin - origin) << ",\"pid\":1,\"tid\":"
+          << buffer->id << "}";
+    }
+  }
+  out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+galois::Result<void>
+galois::WriteTraceFile() {
+  const std::string& path = GetRegistry().path;
+  if (!TraceEnabled() || path.empty()) {
+    return ResultSuccess();
+  }
+  std::ofstream out(path);
+  if (!out) {
+    return ResultErrno();
+  }
+  WriteTrace(out);
+  if (!out) {
+    return ResultErrno();
+  }
+  return ResultSuccess();
+}
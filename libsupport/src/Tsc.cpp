@@ -0,0 +1,133 @@
+#include "galois/Tsc.h"
+
+#include <mutex>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+#include "galois/Env.h"
+#include "galois/Logging.h"
+
+namespace {
+
+/// How long calibration compares the counter to steady_clock
+constexpr auto kCalibrationInterval = std::chrono::milliseconds(10);
+
+struct Calibration {
+  double ticks_per_nsec{1.0};
+  /// A counter value and the steady_clock time at which it was read
+  uint64_t base_ticks{0};
+  uint64_t base_nsec{0};
+};
+
+Calibration calibration;
+
+/// Whether calibration is done, and its results visible
+bool
+Calibrated() {
+  return galois::internal::tsc_enabled.load(std::memory_order_acquire);
+}
+
+uint64_t
+SteadyNsec() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/// Whether the counter ticks at a constant rate on every core, whatever
+/// the frequency and sleep state of the core
+bool
+CounterIsInvariant() {
+#if defined(__x86_64__) || defined(__i386__)
+  unsigned eax = 0;
+  unsigned ebx = 0;
+  unsigned ecx = 0;
+  unsigned edx = 0;
+  if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+    return false;
+  }
+  // the invariant TSC bit of the advanced power management leaf
+  return (edx & (1u << 8)) != 0;
+#elif defined(__aarch64__)
+  // the generic timer of ARMv8 runs at a fixed frequency
+  return true;
+#else
+  return false;
+#endif
+}
+
+/// Reads the counter and steady_clock as close together as possible
+void
+ReadPair(uint64_t* ticks, uint64_t* nsec) {
+  uint64_t before = galois::ReadCycleCounter();
+  *nsec = SteadyNsec();
+  uint64_t after = galois::ReadCycleCounter();
+  *ticks = before + (after - before) / 2;
+}
+
+void
+Calibrate() {
+  bool enabled = true;
+  galois::GetEnv("GALOIS_TSC", &enabled);
+  if (!enabled || !CounterIsInvariant()) {
+    return;
+  }
+
+  uint64_t begin_ticks = 0;
+  uint64_t begin_nsec = 0;
+  uint64_t end_ticks = 0;
+  uint64_t end_nsec = 0;
+  ReadPair(&begin_ticks, &begin_nsec);
+  std::this_thread::sleep_for(kCalibrationInterval);
+  ReadPair(&end_ticks, &end_nsec);
+
+  if (end_ticks <= begin_ticks || end_nsec <= begin_nsec) {
+    GALOIS_LOG_WARN("cycle counter is not monotonic, using steady_clock");
+    return;
+  }
+
+  calibration.ticks_per_nsec = static_cast<double>(end_ticks - begin_ticks) /
+                               static_cast<double>(end_nsec - begin_nsec);
+  calibration.base_ticks = end_ticks;
+  calibration.base_nsec = end_nsec;
+  galois::internal::tsc_enabled.store(true, std::memory_order_release);
+}
+
+}  // namespace
+
+std::atomic<bool> galois::internal::tsc_enabled{false};
+
+void
+galois::CalibrateTsc() {
+  static std::once_flag once;
+  std::call_once(once, Calibrate);
+}
+
+double
+galois::TscTicksPerNsec() {
+  return Calibrated() ? calibration.ticks_per_nsec : 1.0;
+}
+
+uint64_t
+galois::TscToNsec(uint64_t ticks) {
+  if (!Calibrated()) {
+    return ticks;
+  }
+  return static_cast<uint64_t>(
+      static_cast<double>(ticks) / calibration.ticks_per_nsec);
+}
+
+uint64_t
+galois::TscNowNsec() {
+  if (!Calibrated()) {
+    return SteadyNsec();
+  }
+  // signed, for counters read on another core slightly before the base
+  auto delta =
+      static_cast<int64_t>(ReadCycleCounter() - calibration.base_ticks);
+  return calibration.base_nsec +
+         static_cast<int64_t>(delta / calibration.ticks_per_nsec);
+}
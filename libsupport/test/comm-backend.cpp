@@ -0,0 +1,129 @@
+#include "galois/CommBackend.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "galois/Logging.h"
+
+namespace {
+
+constexpr uint32_t kNumTasks = 4;
+
+/// The state that the tasks of a ThreadCommBackend share
+struct Shared {
+  std::mutex mutex;
+  std::condition_variable cv;
+  uint32_t arrived{0};
+  uint64_t generation{0};
+  std::string slot;
+};
+
+/// A backend whose tasks are threads, to test the default collectives
+class ThreadCommBackend : public galois::CommBackend {
+  Shared* shared_;
+
+public:
+  ThreadCommBackend(Shared* shared, uint32_t id) : shared_(shared) {
+    Num = kNumTasks;
+    ID = id;
+  }
+
+  void Barrier() override {
+    std::unique_lock<std::mutex> lock(shared_->mutex);
+    uint64_t generation = shared_->generation;
+    if (++shared_->arrived == Num) {
+      shared_->arrived = 0;
+      shared_->generation++;
+      shared_->cv.notify_all();
+      return;
+    }
+    shared_->cv.wait(lock, [&] { return shared_->generation != generation; });
+  }
+
+  bool Broadcast(uint32_t root, bool val) override {
+    return Broadcast(root, std::string(val ? "1" : "0"), 1) == "1";
+  }
+
+  std::string Broadcast(
+      uint32_t root, const std::string& val, uint64_t max_size) override {
+    if (ID == root) {
+      std::lock_guard<std::mutex> lock(shared_->mutex);
+      shared_->slot = val.substr(0, max_size);
+    }
+    Barrier();
+    std::string ret;
+    {
+      std::lock_guard<std::mutex> lock(shared_->mutex);
+      ret = shared_->slot;
+    }
+    Barrier();
+    return ret;
+  }
+
+  void NotifyFailure() override { GALOIS_LOG_FATAL("task {} failed", ID); }
+};
+
+void
+TestTask(galois::CommBackend* comm) {
+  std::string mine(comm->ID + 1, static_cast<char>('a' + comm->ID));
+  std::vector<std::string> gathered = comm->Allgatherv(mine);
+  GALOIS_LOG_ASSERT(gathered.size() == kNumTasks);
+  for (uint32_t i = 0; i < kNumTasks; ++i) {
+    GALOIS_LOG_ASSERT(
+        gathered[i] == std::string(i + 1, static_cast<char>('a' + i)));
+  }
+
+  std::string id(1, static_cast<char>('0' + comm->ID));
+  GALOIS_LOG_ASSERT(comm->Allgather(id) == "0123");
+
+  // task i sends task j the string "i->j"
+  std::vector<std::string> to_send;
+  for (uint32_t j = 0; j < kNumTasks; ++j) {
+    to_send.emplace_back(fmt::format("{}->{}", comm->ID, j));
+  }
+  std::vector<std::string> received = comm->Alltoallv(to_send);
+  GALOIS_LOG_ASSERT(received.size() == kNumTasks);
+  for (uint32_t i = 0; i < kNumTasks; ++i) {
+    GALOIS_LOG_VASSERT(
+        received[i] == fmt::format("{}->{}", i, comm->ID), "{}", received[i]);
+  }
+
+  std::vector<uint64_t> vals{comm->ID, 10 - comm->ID};
+  using ReduceOp = galois::CommBackend::ReduceOp;
+  GALOIS_LOG_ASSERT(
+      comm->Allreduce(vals, ReduceOp::kSum) ==
+      std::vector<uint64_t>({6, 34}));
+  GALOIS_LOG_ASSERT(
+      comm->Allreduce(vals, ReduceOp::kMin) == std::vector<uint64_t>({0, 7}));
+  GALOIS_LOG_ASSERT(
+      comm->Allreduce(vals, ReduceOp::kMax) == std::vector<uint64_t>({3, 10}));
+}
+
+}  // namespace
+
+int
+main() {
+  galois::NullCommBackend null_comm;
+  GALOIS_LOG_ASSERT(
+      null_comm.Allgatherv("only") == std::vector<std::string>{"only"});
+  GALOIS_LOG_ASSERT(
+      null_comm.Alltoallv({"self"}) == std::vector<std::string>{"self"});
+  GALOIS_LOG_ASSERT(
+      null_comm.Allreduce({1, 2}, galois::CommBackend::ReduceOp::kSum) ==
+      std::vector<uint64_t>({1, 2}));
+
+  Shared shared;
+  std::vector<std::thread> tasks;
+  for (uint32_t i = 0; i < kNumTasks; ++i) {
+    tasks.emplace_back([&shared, i]() {
+      ThreadCommBackend comm(&shared, i);
+      TestTask(&comm);
+    });
+  }
+  for (auto& t : tasks) {
+    t.join();
+  }
+
+  return 0;
+}
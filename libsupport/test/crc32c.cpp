@@ -0,0 +1,60 @@
+#include "galois/Crc32c.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "galois/Logging.h"
+#include "galois/Random.h"
+
+namespace {
+
+/// One bit at a time, as in RFC 3720
+uint32_t
+Reference(const uint8_t* data, size_t size) {
+  uint32_t crc = ~UINT32_C(0);
+  for (size_t i = 0; i < size; ++i) {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ ((crc & 1) != 0 ? UINT32_C(0x82F63B78) : 0);
+    }
+  }
+  return ~crc;
+}
+
+}  // namespace
+
+int
+main() {
+  std::string_view check = "123456789";
+  GALOIS_LOG_ASSERT(galois::Crc32c(check.data(), check.size()) == 0xE3069283);
+  GALOIS_LOG_ASSERT(galois::Crc32c(nullptr, 0) == 0);
+
+  // test vectors of RFC 3720, B.4
+  std::vector<uint8_t> zeros(32, 0);
+  GALOIS_LOG_ASSERT(galois::Crc32c(zeros.data(), zeros.size()) == 0x8A9136AA);
+  std::vector<uint8_t> ones(32, 0xFF);
+  GALOIS_LOG_ASSERT(galois::Crc32c(ones.data(), ones.size()) == 0x62A8AB43);
+
+  std::vector<uint8_t> data(4099);
+  for (auto& b : data) {
+    b = galois::RandomUniformInt(256);
+  }
+  // every length and alignment around the 8 byte words
+  for (size_t begin = 0; begin < 9; ++begin) {
+    for (size_t size = 0; size + begin <= data.size(); size += 37) {
+      uint32_t expected = Reference(data.data() + begin, size);
+      GALOIS_LOG_ASSERT(galois::Crc32c(data.data() + begin, size) == expected);
+
+      // in two pieces
+      size_t half = size / 2 + begin % 3;
+      half = std::min(half, size);
+      uint32_t crc = galois::Crc32c(data.data() + begin, half);
+      crc = galois::Crc32c(data.data() + begin + half, size - half, crc);
+      GALOIS_LOG_ASSERT(crc == expected);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,34 @@
+#include <thread>
+#include <vector>
+
+#include "galois/Logging.h"
+
+int
+main() {
+  galois::SetAsyncLogging(true);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([t]() {
+      for (int i = 0; i < 100; ++i) {
+        GALOIS_LOG_WARN("thread {} message {}", t, i);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  galois::FlushLogs();
+
+  // errors flush what is queued before them
+  GALOIS_LOG_WARN("queued before the error");
+  GALOIS_LOG_ERROR("printed after the warning");
+
+  // far below the default queue size, so nothing is dropped
+  GALOIS_LOG_ASSERT(galois::DroppedLogMessages() == 0);
+
+  galois::SetAsyncLogging(false);
+  GALOIS_LOG_WARN("printed synchronously");
+
+  return 0;
+}
@@ -0,0 +1,66 @@
+#include <chrono>
+#include <thread>
+
+#include "galois/Logging.h"
+#include "galois/Tsc.h"
+
+namespace {
+
+uint64_t
+SteadyNsec() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/// A timer agrees with steady_clock on an interval of 20ms, within the
+/// slack of sleeping
+void
+TestTimer() {
+  galois::TscTimer timer;
+  uint64_t begin = SteadyNsec();
+  timer.start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  timer.stop();
+  uint64_t elapsed = SteadyNsec() - begin;
+
+  uint64_t nsec = timer.get_nsec();
+  GALOIS_LOG_VASSERT(
+      nsec >= 19000000 && nsec <= elapsed + 1000000, "{} ns for {} ns", nsec,
+      elapsed);
+  GALOIS_LOG_ASSERT(timer.get_usec() == nsec / 1000);
+
+  timer.reset();
+  GALOIS_LOG_ASSERT(timer.get_ticks() == 0);
+}
+
+/// Timestamps stay on the epoch of steady_clock
+void
+TestNow() {
+  uint64_t before = SteadyNsec();
+  uint64_t now = galois::TscNowNsec();
+  uint64_t after = SteadyNsec();
+  GALOIS_LOG_VASSERT(
+      now + 1000000 >= before && now <= after + 1000000, "{} not in [{}, {}]",
+      now, before, after);
+}
+
+}  // namespace
+
+int
+main() {
+  // before calibration, on steady_clock
+  TestTimer();
+  TestNow();
+
+  galois::CalibrateTsc();
+  if (galois::TscEnabled()) {
+    GALOIS_LOG_ASSERT(galois::TscTicksPerNsec() > 0);
+  } else {
+    GALOIS_LOG_ASSERT(galois::TscTicksPerNsec() == 1.0);
+  }
+  TestTimer();
+  TestNow();
+
+  return 0;
+}
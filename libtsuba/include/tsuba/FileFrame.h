@@ -1,14 +1,21 @@
 #ifndef GALOIS_LIBTSUBA_TSUBA_FILEFRAME_H_
 #define GALOIS_LIBTSUBA_TSUBA_FILEFRAME_H_
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <future>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include <parquet/arrow/writer.h>
 
 #include "galois/Logging.h"
 #include "galois/Result.h"
+#include "tsuba/Errors.h"
+#include "tsuba/FileStorage.h"
 
 namespace tsuba {
 
@@ -20,7 +27,20 @@ class GALOIS_EXPORT FileFrame : public arrow::io::OutputStream {
   uint64_t cursor_;
   bool valid_ = false;
   bool synced_ = false;
+  /// Set while the frame streams its bytes to storage rather than holding
+  /// them; only the part being filled is held then
+  std::unique_ptr<StreamingPut> stream_;
+  std::vector<uint8_t> part_;
+  uint64_t part_size_{0};
+  /// The last bytes written, which a streaming frame no longer holds
+  std::array<uint8_t, 8> tail_{};
+  /// The checksums of the blocks written and of the block being written
+  std::vector<uint32_t> block_checksums_;
+  uint32_t block_checksum_{0};
   galois::Result<void> GrowBuffer(int64_t accommodate);
+  arrow::Status WriteToStream(const uint8_t* data, int64_t nbytes);
+  void KeepTail(const uint8_t* data, uint64_t nbytes);
+  void AddToChecksums(const uint8_t* data, uint64_t nbytes);
 
 public:
   FileFrame() = default;
@@ -34,7 +54,13 @@ public:
         region_size_(other.region_size_),
         cursor_(other.cursor_),
         valid_(other.valid_),
-        synced_(other.synced_) {
+        synced_(other.synced_),
+        stream_(std::move(other.stream_)),
+        part_(std::move(other.part_)),
+        part_size_(other.part_size_),
+        tail_(other.tail_),
+        block_checksums_(std::move(other.block_checksums_)),
+        block_checksum_(other.block_checksum_) {
     other.valid_ = false;
   }
 
@@ -50,6 +76,12 @@ public:
       cursor_ = other.cursor_;
       synced_ = other.synced_;
       valid_ = other.valid_;
+      stream_ = std::move(other.stream_);
+      part_ = std::move(other.part_);
+      part_size_ = other.part_size_;
+      tail_ = other.tail_;
+      block_checksums_ = std::move(other.block_checksums_);
+      block_checksum_ = other.block_checksum_;
       other.valid_ = false;
     }
     return *this;
@@ -61,18 +93,46 @@ public:
   galois::Result<void> Init() { return Init(1); }
   void Bind(std::string_view filename);
 
+  /// Like Init(estimated_size) and Bind(path), but a file estimated to be
+  /// stored in parts is handed to storage part by part as it is written when
+  /// the storage of path allows it (\see FileStreamingStore). Persist or
+  /// PersistAsync then only store the last part and wait for the others.
+  galois::Result<void> InitStreaming(
+      const std::string& path, uint64_t estimated_size);
+
   galois::Result<void> Destroy();
 
   galois::Result<void> Persist();
   std::future<galois::Result<void>> PersistAsync();
 
+  /// The bytes written so far; not available for a streaming frame
   template <typename T>
   galois::Result<T*> ptr() const {
+    if (stream_) {
+      return ErrorCode::InvalidArgument;
+    }
     return reinterpret_cast<T*>(map_start_); /* NOLINT */
   }
 
   const std::string& path() const { return path_; }
 
+  /// The number of bytes written to this frame
+  uint64_t size() const { return cursor_; }
+
+  /// The last bytes written to this frame, up to 8 of them, e.g., the
+  /// trailer of a parquet file, which holds the length of its footer. Unlike
+  /// ptr, this is also available for a streaming frame.
+  std::string_view tail() const {
+    size_t n = std::min<uint64_t>(cursor_, tail_.size());
+    return std::string_view(
+        reinterpret_cast<const char*>(tail_.data() + tail_.size() - n), n);
+  }
+
+  /// The CRC32C of each 1 MB block of the bytes written to this frame, the
+  /// last one possibly shorter, computed as they are written, which readers
+  /// verify the stored file against (\see FileView::BindKnownSize)
+  std::vector<uint32_t> block_checksums() const;
+
   ///// Begin arrow::io::BufferOutputStream methods ///////
 
   arrow::Status Close() override;
@@ -3,6 +3,8 @@
 
 #include <cstdint>
 #include <future>
+#include <memory>
+#include <string>
 #include <string_view>
 #include <unordered_set>
 #include <vector>
@@ -14,6 +16,28 @@ namespace tsuba {
 
 struct StatBuf;
 
+/// A store of a file that is handed to the storage backend in parts, in
+/// order, while the rest of the file is still being produced
+class GALOIS_EXPORT StreamingPut {
+public:
+  StreamingPut() = default;
+  StreamingPut(const StreamingPut& no_copy) = delete;
+  StreamingPut& operator=(const StreamingPut& no_copy) = delete;
+  /// Waits for the parts in flight; if Finish was not called the file is
+  /// left incomplete
+  virtual ~StreamingPut() = default;
+
+  /// Start storing part as the next bytes of the file. Blocks while the
+  /// backend already has as many parts in flight as it allows.
+  virtual galois::Result<void> PutPart(std::vector<uint8_t>&& part) = 0;
+
+  /// Store last, which may be empty, as the final bytes of the file. The
+  /// future resolves once the whole file is stored; this object must outlive
+  /// it.
+  virtual std::future<galois::Result<void>> Finish(
+      std::vector<uint8_t>&& last) = 0;
+};
+
 class GALOIS_EXPORT FileStorage {
   std::string uri_scheme_;
 
@@ -39,6 +63,11 @@ public:
   virtual galois::Result<void> PutMultiSync(
       const std::string& uri, const uint8_t* data, uint64_t size) = 0;
 
+  /// If uri names a file on a local file system, return the path that can be
+  /// passed to open(2), otherwise return an empty string. Local files can be
+  /// mapped directly into memory rather than copied.
+  virtual std::string LocalPath(const std::string&) const { return ""; }
+
   /// Storage classes with higher priority will be tried by GlobalState earlier
   /// currently only used to enforce local fs default; GlobalState defaults
   /// to the LocalStorage when no protocol on the URI is provided
@@ -47,15 +76,47 @@ public:
   // get on future can potentially block (bulk synchronous parallel)
   virtual std::future<galois::Result<void>> PutAsync(
       const std::string& uri, const uint8_t* data, uint64_t size) = 0;
+
+  /// Store data at uri as parts of part_size bytes, with up to concurrency
+  /// parts in flight at once. Backends without a native multipart upload
+  /// store the data in one piece.
+  virtual std::future<galois::Result<void>> PutMultipartAsync(
+      const std::string& uri, const uint8_t* data, uint64_t size,
+      uint64_t part_size, uint32_t concurrency) {
+    (void)part_size;
+    (void)concurrency;
+    return PutAsync(uri, data, size);
+  }
+
+  /// Start storing a file at uri whose bytes are not all known yet. Every
+  /// part but the last is part_size bytes long, and up to concurrency parts
+  /// are in flight at once. Backends that need the whole file at once return
+  /// null, and callers then buffer the file and use PutAsync.
+  virtual std::unique_ptr<StreamingPut> StartStreamingPut(
+      const std::string& uri, uint64_t part_size, uint32_t concurrency) {
+    (void)uri;
+    (void)part_size;
+    (void)concurrency;
+    return nullptr;
+  }
+
   virtual std::future<galois::Result<void>> GetAsync(
       const std::string& uri, uint64_t start, uint64_t size,
       uint8_t* result_buf) = 0;
+  /// Backends whose listings come in pages should keep several page
+  /// requests in flight where the protocol allows it, e.g., one per key
+  /// prefix
   virtual std::future<galois::Result<void>> ListAsync(
       const std::string& directory, std::vector<std::string>* list,
       std::vector<uint64_t>* size) = 0;
   virtual galois::Result<void> Delete(
       const std::string& directory,
       const std::unordered_set<std::string>& files) = 0;
+
+  /// The most files that tsuba::FileDelete passes to one Delete call; it
+  /// splits larger sets into batches and deletes several batches at once.
+  /// The default matches the most keys that S3 deletes in one request.
+  virtual uint64_t DeleteBatchSize() const { return 1000; }
 };
 
 /// RegisterFileStorage adds a file storage backend to the tsuba library. File
@@ -3,7 +3,9 @@
 
 #include <cstdint>
 #include <future>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <parquet/arrow/reader.h>
 
@@ -29,6 +31,12 @@ class GALOIS_EXPORT FileView : public arrow::io::RandomAccessFile {
   bool valid_ = false;
   std::vector<uint64_t> filling_;
   std::unique_ptr<std::vector<FillingRange>> fetches_;
+  uint64_t read_ahead_ = 0;
+  bool release_consumed_ = false;
+  uint64_t released_pages_ = 0;
+  // the checksums of the blocks of the file, which fetched pages are
+  // verified against; null if unknown. Shared with fetches in flight.
+  std::shared_ptr<const std::vector<uint32_t>> checksums_;
 
 public:
   FileView() = default;
@@ -44,7 +52,11 @@ public:
         filename_(std::move(other.filename_)),
         valid_(other.valid_),
         filling_(std::move(other.filling_)),
-        fetches_(std::move(other.fetches_)) {
+        fetches_(std::move(other.fetches_)),
+        read_ahead_(other.read_ahead_),
+        release_consumed_(other.release_consumed_),
+        released_pages_(other.released_pages_),
+        checksums_(std::move(other.checksums_)) {
     other.valid_ = false;
   }
 
@@ -63,6 +75,10 @@ public:
       filling_ = std::move(other.filling_);
       fetches_ =
           std::unique_ptr<std::vector<FillingRange>>(std::move(other.fetches_));
+      read_ahead_ = other.read_ahead_;
+      release_consumed_ = other.release_consumed_;
+      released_pages_ = other.released_pages_;
+      checksums_ = std::move(other.checksums_);
       other.valid_ = false;
     }
     return *this;
@@ -90,8 +106,52 @@ public:
     return Bind(filename, 0, std::numeric_limits<uint64_t>::max(), resolve);
   }
 
+  /// Like Bind, when the size of filename, file_size, is already known,
+  /// e.g., from a part header. This saves the round trip to storage that
+  /// Bind spends asking for the size.
+  ///
+  /// \param block_checksums the CRC32C of each block of the file as it was
+  /// stored, if known, e.g., from a part header; pages fetched from storage
+  /// are verified against them as they arrive, and a fetch of corrupt data
+  /// fails with ChecksumMismatch
+  galois::Result<void> BindKnownSize(
+      std::string_view filename, uint64_t file_size, uint64_t begin,
+      uint64_t end, bool resolve, std::vector<uint32_t> block_checksums = {});
+
+  /// Bind the whole file. If the file is on a local file system, map it
+  /// directly instead of copying it through the storage backend, so that
+  /// processes reading the same file share one copy of it in the page cache.
+  /// Otherwise, this is the same as Bind(filename, true).
+  ///
+  /// \param populate prefault the mapping of a local file rather than
+  /// faulting it in on first access
+  galois::Result<void> BindMapped(std::string_view filename, bool populate);
+
+  /// Like BindMapped, when the size of filename, file_size, is already known
+  /// (\see BindKnownSize). Local files are mapped unverified; remote files
+  /// are verified as copied, or once populated from the disk cache.
+  galois::Result<void> BindMappedKnownSize(
+      std::string_view filename, uint64_t file_size, bool populate,
+      std::vector<uint32_t> block_checksums = {});
+
   galois::Result<void> Fill(uint64_t begin, uint64_t end, bool resolve);
 
+  /// Configure the view for a single sequential pass over the file, e.g., by
+  /// a parquet reader.
+  ///
+  /// \param read_ahead number of bytes past the end of each Read to keep in
+  /// flight from storage; 0 restores the default prefetch heuristic
+  /// \param release_consumed if true, each Read releases the memory of pages
+  /// that lie entirely before its starting offset, which bounds resident
+  /// memory to roughly the size of a read plus read_ahead. Released pages
+  /// are fetched again if they are read later. Buffers returned by earlier
+  /// Reads, and pointers from ptr(), must not be used after a later Read in
+  /// this mode.
+  void SetStreaming(uint64_t read_ahead, bool release_consumed) {
+    read_ahead_ = read_ahead;
+    release_consumed_ = release_consumed;
+  }
+
   bool Valid() const { return valid_; }
 
   galois::Result<void> Unbind();
@@ -143,6 +203,26 @@ public:
   ///// End arrow::io::RandomAccessFile methods ///////
 
 private:
+  // Bind [begin, end) of filename_, which is file_size bytes long, by copying
+  // it from storage into anonymous memory
+  galois::Result<void> BindCopied(
+      uint64_t file_size, uint64_t begin, uint64_t end, bool resolve);
+
+  // Bind the whole of path, which is size bytes long, by mapping it (\see
+  // FileMmapWhole); NotImplemented if it cannot be mapped
+  galois::Result<void> MapWhole(
+      const std::string& path, uint64_t size, bool populate);
+
+  // Set checksums_ for a file of file_size bytes
+  galois::Result<void> SetChecksums(
+      uint64_t file_size, std::vector<uint32_t> block_checksums);
+
+  // Start fetching the map_size bytes at file_off, which cover pages
+  // [first_page, last_page], into memory
+  void StartFetch(
+      uint64_t first_page, uint64_t last_page, uint64_t file_off,
+      uint64_t map_size);
+
   // Given the size of some region, how many pages does it take up?
   uint64_t page_number(uint64_t size);
 
@@ -163,6 +243,12 @@ private:
   galois::Result<void> MarkFilled(
       uint64_t* bitmap, uint64_t begin, uint64_t end);
 
+  galois::Result<void> MarkEmpty(
+      uint64_t* bitmap, uint64_t begin, uint64_t end);
+
+  // Release the memory backing pages that lie entirely before offset
+  galois::Result<void> ReleaseBefore(int64_t offset);
+
   // Resolve all outstanding reads that overlap with the range [cursor_, nbytes]
   galois::Result<void> Resolve(int64_t start, int64_t size);
 
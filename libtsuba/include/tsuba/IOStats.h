@@ -0,0 +1,85 @@
+#ifndef GALOIS_LIBTSUBA_TSUBA_IOSTATS_H_
+#define GALOIS_LIBTSUBA_TSUBA_IOSTATS_H_
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "galois/config.h"
+
+namespace tsuba {
+
+/// The part of an RDG that an I/O operation reads or writes
+enum class IOClass {
+  kOther,
+  kTopology,
+  kNodeProperty,
+  kEdgeProperty,
+  kPartHeader,
+};
+
+/// The entry points of file.h that are counted
+enum class IOOp {
+  /// FileGet and FileGetAsync, which FileView::Fill uses
+  kGet,
+  /// FileStore, FileStoreAsync and FileStoreMultipartAsync
+  kStore,
+  kList,
+  kMmap,
+  /// One FileDelete batch (\see FileStorage::DeleteBatchSize)
+  kDelete,
+};
+
+GALOIS_EXPORT const char* IOClassName(IOClass io_class);
+GALOIS_EXPORT const char* IOOpName(IOOp op);
+
+/// Latencies are counted in buckets of microseconds: bucket b holds the
+/// operations that took at most 2^b us and more than the bound of bucket
+/// b - 1; the last one holds everything slower. This is the layout of the
+/// timing histograms of galois::StatManager.
+constexpr unsigned kNumIOLatencyBuckets = 32;
+
+struct IOOpStats {
+  uint64_t ops{UINT64_C(0)};
+  /// bytes moved by the operations that succeeded; 0 for listings
+  uint64_t bytes{UINT64_C(0)};
+  uint64_t errors{UINT64_C(0)};
+  uint64_t latency_sum_usec{UINT64_C(0)};
+  std::array<uint64_t, kNumIOLatencyBuckets> latency_buckets{};
+};
+
+/// The counters of one kind of operation on one storage backend
+struct IOStatsEntry {
+  /// uri scheme of the backend without "://", e.g., "s3" or "file"
+  std::string backend;
+  IOClass io_class{IOClass::kOther};
+  IOOp op{IOOp::kGet};
+  IOOpStats stats;
+};
+
+/// Return the I/O counters accumulated since the process started, one entry
+/// per backend, class and operation that has been used. The latency of an
+/// asynchronous operation runs from its start until its result is ready.
+GALOIS_EXPORT std::vector<IOStatsEntry> GetIOStats();
+
+/// Counts the I/O started by this thread while it lives as io_class. The
+/// RDG code sets it around what it loads and stores; WriteGroup carries it
+/// over to the stores it runs on other threads.
+class GALOIS_EXPORT IOClassScope {
+  IOClass prev_;
+
+public:
+  explicit IOClassScope(IOClass io_class);
+  ~IOClassScope();
+
+  IOClassScope(const IOClassScope&) = delete;
+  IOClassScope& operator=(const IOClassScope&) = delete;
+};
+
+/// The class of the I/O started by this thread right now
+GALOIS_EXPORT IOClass CurrentIOClass();
+
+}  // namespace tsuba
+
+#endif
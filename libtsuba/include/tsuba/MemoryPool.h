@@ -0,0 +1,41 @@
+#ifndef GALOIS_LIBTSUBA_TSUBA_MEMORYPOOL_H_
+#define GALOIS_LIBTSUBA_TSUBA_MEMORYPOOL_H_
+
+#include <arrow/memory_pool.h>
+
+#include "galois/config.h"
+
+namespace tsuba {
+
+/// The pool that arrow buffers created by tsuba and the graph library are
+/// allocated from: the columns of loaded property tables, the tables built by
+/// AddTables and the property arrays that analytics create. Unless another
+/// pool was installed, this is arrow::default_memory_pool().
+GALOIS_EXPORT arrow::MemoryPool* GetArrowMemoryPool();
+
+/// Install pool as the pool returned by GetArrowMemoryPool; nullptr restores
+/// arrow::default_memory_pool(). Buffers keep a pointer to the pool that
+/// allocated them, so pool must outlive every buffer allocated from it.
+GALOIS_EXPORT void SetArrowMemoryPool(arrow::MemoryPool* pool);
+
+/// ScopedArrowMemoryPool installs a pool for its lifetime, e.g., around loading
+/// one graph and constructing its properties, and restores the previous pool
+/// when it is destroyed.
+class GALOIS_EXPORT ScopedArrowMemoryPool {
+  arrow::MemoryPool* previous_;
+
+public:
+  explicit ScopedArrowMemoryPool(arrow::MemoryPool* pool)
+      : previous_(GetArrowMemoryPool()) {
+    SetArrowMemoryPool(pool);
+  }
+
+  ScopedArrowMemoryPool(const ScopedArrowMemoryPool&) = delete;
+  ScopedArrowMemoryPool& operator=(const ScopedArrowMemoryPool&) = delete;
+
+  ~ScopedArrowMemoryPool() { SetArrowMemoryPool(previous_); }
+};
+
+}  // namespace tsuba
+
+#endif
@@ -1,9 +1,12 @@
 #ifndef GALOIS_LIBTSUBA_TSUBA_RDG_H_
 #define GALOIS_LIBTSUBA_TSUBA_RDG_H_
 
+#include <cassert>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
+#include <unordered_map>
 
 #include <arrow/api.h>
 #include <arrow/chunked_array.h>
@@ -28,6 +31,27 @@ struct PropStorageInfo;
 
 class GALOIS_EXPORT RDG {
 public:
+  /// Row groups small enough that the hosts loading slices of an RDG
+  /// (\see RDGSlice) skip most of each property file
+  static constexpr uint64_t kDefaultRowGroupRows = uint64_t{1} << 20;
+  /// The default data page size of parquet
+  static constexpr int64_t kDefaultDataPageSize = int64_t{1} << 20;
+
+  /// The compression of the file of a property
+  enum class Codec { kAutomatic, kUncompressed, kSnappy, kLz4, kZstd };
+
+  /// How the file of a property is encoded
+  struct PropertyEncoding {
+    /// kAutomatic compresses a sample of the values with zstd, or snappy if
+    /// arrow was built without zstd, and uses that codec if it shrinks the
+    /// sample by at least a fifth and no compression otherwise
+    Codec codec{Codec::kAutomatic};
+    /// Whether to dictionary encode the values; if unset, they are if a
+    /// sample of them has at most a quarter as many distinct values as
+    /// values, e.g., labels
+    std::optional<bool> dictionary;
+  };
+
   RDG(const RDG& no_copy) = delete;
   RDG& operator=(const RDG& no_dopy) = delete;
 
@@ -43,10 +67,14 @@ public:
   bool Equals(const RDG& other) const;
 
   /// Store this RDG at `handle`, if `ff` is not null, it is assumed to contain
-  /// an updated topology and persisted as such
+  /// an updated topology and persisted as such. Likewise, a non-null
+  /// `transpose_ff` is persisted as the in-edges of the topology and a
+  /// non-null `edge_type_index_ff` as its index of edges by type.
   galois::Result<void> Store(
       RDGHandle handle, const std::string& command_line,
-      std::unique_ptr<FileFrame> ff = nullptr);
+      std::unique_ptr<FileFrame> ff = nullptr,
+      std::unique_ptr<FileFrame> transpose_ff = nullptr,
+      std::unique_ptr<FileFrame> edge_type_index_ff = nullptr);
 
   galois::Result<void> AddNodeProperties(
       const std::shared_ptr<arrow::Table>& table);
@@ -57,6 +85,23 @@ public:
   galois::Result<void> RemoveNodeProperty(uint32_t i);
   galois::Result<void> RemoveEdgeProperty(uint32_t i);
 
+  /// Replace all node (edge) property values with those of table, which must
+  /// have the same schema. Replaced properties keep their persistence; those
+  /// whose column is not the same array as before are written again on the
+  /// next store.
+  galois::Result<void> ReplaceNodeProperties(
+      const std::shared_ptr<arrow::Table>& table);
+  galois::Result<void> ReplaceEdgeProperties(
+      const std::shared_ptr<arrow::Table>& table);
+
+  /// Replace the node (edge) table with table, which must hold the same
+  /// values, e.g., copied to other memory. Unlike ReplaceNodeProperties, the
+  /// stored properties are not written again.
+  galois::Result<void> RelocateNodeProperties(
+      const std::shared_ptr<arrow::Table>& table);
+  galois::Result<void> RelocateEdgeProperties(
+      const std::shared_ptr<arrow::Table>& table);
+
   void MarkAllPropertiesPersistent();
 
   galois::Result<void> MarkNodePropertiesPersistent(
@@ -72,14 +117,53 @@ public:
       RDGHandle handle, const std::vector<std::string>* node_props = nullptr,
       const std::vector<std::string>* edge_props = nullptr);
 
+  /// Like Make but only read the schemas of node and edge properties. The
+  /// columns of node_table() and edge_table() have the right names, types and
+  /// lengths, but no chunks until they are fetched with
+  /// EnsureNodePropertyLoaded or EnsureEdgePropertyLoaded.
+  static galois::Result<RDG> MakeLazy(
+      RDGHandle handle, const std::vector<std::string>* node_props = nullptr,
+      const std::vector<std::string>* edge_props = nullptr);
+
+  bool IsNodePropertyLoaded(uint32_t i) const;
+  bool IsEdgePropertyLoaded(uint32_t i) const;
+
+  /// Fetch the values of property i if they have not been loaded yet.
+  ///
+  /// Loading does not change the logical contents of the RDG so these are
+  /// const, but they are not thread safe.
+  galois::Result<void> EnsureNodePropertyLoaded(uint32_t i) const;
+  galois::Result<void> EnsureEdgePropertyLoaded(uint32_t i) const;
+  galois::Result<void> EnsureAllPropertiesLoaded() const;
+
+  /// Drop the values of property i; they are fetched again on next use. Only
+  /// properties that have a stored copy (e.g., ones that were loaded and not
+  /// added since the last Store) can be unloaded. Like loading, unloading
+  /// does not change the logical contents of the RDG.
+  galois::Result<void> UnloadNodeProperty(uint32_t i) const;
+  galois::Result<void> UnloadEdgeProperty(uint32_t i) const;
+
+  /// Whether property i has an up to date stored copy, i.e., it can be
+  /// unloaded and fetched again; added, replaced and modified properties
+  /// have none until the next Store
+  bool HasStoredNodeProperty(uint32_t i) const;
+  bool HasStoredEdgeProperty(uint32_t i) const;
+
+  /// Record that the values of property i were changed in place, so that it
+  /// is written again on the next store instead of keeping its stored copy
+  galois::Result<void> MarkNodePropertyModified(uint32_t i);
+  galois::Result<void> MarkEdgePropertyModified(uint32_t i);
+
   galois::Result<void> UnbindTopologyFileStorage();
 
   void AddMirrorNodes(std::shared_ptr<arrow::ChunkedArray>&& a) {
     mirror_nodes_.emplace_back(std::move(a));
+    part_arrays_modified_ = true;
   }
 
   void AddMasterNodes(std::shared_ptr<arrow::ChunkedArray>&& a) {
     master_nodes_.emplace_back(std::move(a));
+    part_arrays_modified_ = true;
   }
 
   //
@@ -89,6 +173,39 @@ public:
   const galois::Uri& rdg_dir() const { return rdg_dir_; }
   void set_rdg_dir(const galois::Uri& rdg_dir) { rdg_dir_ = rdg_dir; }
 
+  /// The number of rows of each row group of the property files written by
+  /// the next Store. Slices only read the row groups that overlap their
+  /// range, and the row groups of a file are decoded in parallel.
+  uint64_t row_group_rows() const { return row_group_rows_; }
+  void set_row_group_rows(uint64_t rows) {
+    assert(rows > 0);
+    row_group_rows_ = rows;
+  }
+
+  /// The target size in bytes of the data pages of the property files
+  /// written by the next Store
+  int64_t data_page_size() const { return data_page_size_; }
+  void set_data_page_size(int64_t size) {
+    assert(size > 0);
+    data_page_size_ = size;
+  }
+
+  /// The encoding of the files of the node, edge and partition properties
+  /// named name written by the next Store; properties without an encoding of
+  /// their own use the default one
+  const PropertyEncoding& property_encoding(const std::string& name) const;
+  void set_property_encoding(
+      const std::string& name, const PropertyEncoding& encoding) {
+    property_encodings_[name] = encoding;
+  }
+
+  const PropertyEncoding& default_property_encoding() const {
+    return default_property_encoding_;
+  }
+  void set_default_property_encoding(const PropertyEncoding& encoding) {
+    default_property_encoding_ = encoding;
+  }
+
   /// The table of node properties
   const std::shared_ptr<arrow::Table>& node_table() const;
 
@@ -101,6 +218,7 @@ public:
   }
   void set_master_nodes(std::vector<std::shared_ptr<arrow::ChunkedArray>>&& a) {
     master_nodes_ = std::move(a);
+    part_arrays_modified_ = true;
   }
 
   const std::vector<std::shared_ptr<arrow::ChunkedArray>>& mirror_nodes()
@@ -109,6 +227,7 @@ public:
   }
   void set_mirror_nodes(std::vector<std::shared_ptr<arrow::ChunkedArray>>&& a) {
     mirror_nodes_ = std::move(a);
+    part_arrays_modified_ = true;
   }
 
   const std::shared_ptr<arrow::ChunkedArray>& local_to_global_vector() const {
@@ -116,6 +235,7 @@ public:
   }
   void set_local_to_global_vector(std::shared_ptr<arrow::ChunkedArray>&& a) {
     local_to_global_vector_ = std::move(a);
+    part_arrays_modified_ = true;
   }
 
   const PartitionMetadata& part_metadata() const;
@@ -123,16 +243,53 @@ public:
 
   const FileView& topology_file_storage() const;
 
+  /// Whether the stored topology has the edges of each node sorted by
+  /// destination; recorded in the partition metadata
+  bool edges_sorted_by_dest() const;
+  void set_edges_sorted_by_dest(bool sorted);
+
+  /// Statistics of the graph serialized by libgalois, recorded in the
+  /// partition metadata; empty if none were stored
+  const std::string& graph_statistics() const;
+  void set_graph_statistics(std::string statistics);
+
+  /// Whether a stored in-edge index was loaded with this RDG or bound by a
+  /// previous Store
+  bool HasTranspose() const;
+
+  /// Map the stored in-edge index, if any, into transpose_file_storage()
+  galois::Result<void> EnsureTransposeLoaded() const;
+
+  const FileView& transpose_file_storage() const;
+
+  /// Forget the stored in-edge index, e.g., because the topology changed; it
+  /// is not part of the next Store unless given again
+  galois::Result<void> DropTranspose();
+
+  /// Whether a stored edge type index was loaded with this RDG or bound by a
+  /// previous Store
+  bool HasEdgeTypeIndex() const;
+
+  /// Map the stored edge type index, if any, into
+  /// edge_type_index_file_storage()
+  galois::Result<void> EnsureEdgeTypeIndexLoaded() const;
+
+  const FileView& edge_type_index_file_storage() const;
+
+  /// Forget the stored edge type index; it is not part of the next Store
+  /// unless given again
+  galois::Result<void> DropEdgeTypeIndex();
+
 private:
   RDG(std::unique_ptr<RDGCore>&& core);
 
   void InitEmptyTables();
 
-  galois::Result<void> DoMake(const galois::Uri& metadata_dir);
+  galois::Result<void> DoMake(const galois::Uri& metadata_dir, bool lazy);
 
   static galois::Result<RDG> Make(
       const RDGMeta& meta, const std::vector<std::string>* node_props,
-      const std::vector<std::string>* edge_props);
+      const std::vector<std::string>* edge_props, bool lazy);
 
   galois::Result<void> AddPartitionMetadataArray(
       const std::shared_ptr<arrow::Table>& table);
@@ -153,6 +310,14 @@ private:
   std::vector<std::shared_ptr<arrow::ChunkedArray>> mirror_nodes_;
   std::vector<std::shared_ptr<arrow::ChunkedArray>> master_nodes_;
   std::shared_ptr<arrow::ChunkedArray> local_to_global_vector_;
+  /// Whether the partition arrays changed since they were loaded or stored,
+  /// so that the next store has to write them
+  bool part_arrays_modified_{true};
+
+  uint64_t row_group_rows_{kDefaultRowGroupRows};
+  int64_t data_page_size_{kDefaultDataPageSize};
+  std::unordered_map<std::string, PropertyEncoding> property_encodings_;
+  PropertyEncoding default_property_encoding_;
 
   /// name of the graph that was used to load this RDG
   galois::Uri rdg_dir_;
@@ -31,6 +31,9 @@ class GALOIS_EXPORT RDGPrefix {
 public:
   static galois::Result<RDGPrefix> Make(RDGHandle handle);
 
+  /// Whether there is a prefix, i.e., the RDG has a topology
+  bool Valid() const { return prefix_ != nullptr; }
+
   uint64_t num_nodes() const { return prefix_->header.num_nodes; }
   uint64_t num_edges() const { return prefix_->header.num_edges; }
   uint64_t version() const { return prefix_->header.version; }
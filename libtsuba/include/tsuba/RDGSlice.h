@@ -16,6 +16,7 @@ namespace tsuba {
 
 class RDGMeta;
 class RDGCore;
+class RDGPrefix;
 
 /// A contiguous piece of an RDG
 class GALOIS_EXPORT RDGSlice {
@@ -44,6 +45,25 @@ public:
       const std::vector<std::string>* node_props = nullptr,
       const std::vector<std::string>* edge_props = nullptr);
 
+  /// Cut the nodes of an RDG into num_slices contiguous ranges with about
+  /// the same number of edges each. The topology range of each slice is the
+  /// out_indexes of its nodes.
+  static std::vector<SliceArg> EdgeBalancedSlices(
+      const RDGPrefix& prefix, uint32_t num_slices);
+
+  /// Load the slice of this host when the nodes of an unpartitioned RDG are
+  /// cut into Comm()->Num edge-balanced slices (\see EdgeBalancedSlices).
+  /// Only host 0 reads the RDGPrefix; it broadcasts the cuts, so every host
+  /// reads no more than its own slice, and the hosts load their slices in
+  /// parallel. The topology file storage of the slice holds the out_indexes
+  /// of its nodes and the destinations of its edges at their offsets in the
+  /// topology file.
+  ///
+  /// This is a collective operation.
+  static galois::Result<RDGSlice> MakeEdgeBalanced(
+      RDGHandle handle, const std::vector<std::string>* node_props = nullptr,
+      const std::vector<std::string>* edge_props = nullptr);
+
   const std::shared_ptr<arrow::Table>& node_table() const;
   const std::shared_ptr<arrow::Table>& edge_table() const;
   const FileView& topology_file_storage() const;
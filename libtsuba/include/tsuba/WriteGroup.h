@@ -4,6 +4,7 @@
 #include <future>
 #include <list>
 #include <memory>
+#include <mutex>
 
 #include "galois/Result.h"
 #include "tsuba/FileFrame.h"
@@ -13,20 +14,51 @@ namespace tsuba {
 
 /// Track multiple, outstanding async writes and provide a mechanism to ensure
 /// that they have all completed
-class WriteGroup {
+///
+/// The number of bytes in flight is bounded by a budget (set in MB with
+/// GALOIS_TSUBA_WRITE_BUDGET_MB, 0 for unlimited). When starting a store would
+/// exceed the budget, StartStore first reclaims completed ops and then waits
+/// for the oldest outstanding ops until the new store fits.
+///
+/// Stores may be started from several threads at once. Threads that produce
+/// files concurrently should Reserve the memory of a file before producing
+/// it, so that the budget also bounds the files not yet stored.
+class GALOIS_EXPORT WriteGroup {
   struct AsyncOp {
     std::future<galois::Result<void>> result;
     std::string location;
+    uint64_t size;
   };
 
   std::string tag_;
   std::list<AsyncOp> pending_ops_;
+  /// Guards everything below and pending_ops_
+  mutable std::mutex mutex_;
 
-  WriteGroup(std::string tag) : tag_(std::move(tag)){};
+  uint64_t budget_;
+  uint64_t inflight_bytes_{0};
+  uint64_t peak_inflight_bytes_{0};
+
+  uint64_t total_ops_{0};
+  uint64_t errors_{0};
+  galois::Result<void> first_error_{galois::ResultSuccess()};
+
+  WriteGroup(std::string tag);
 
   /// Add future to the list of futures this descriptor will wait for, note
   /// the file name for debugging
-  void AddOp(std::future<galois::Result<void>> future, std::string file);
+  void AddOp(
+      std::future<galois::Result<void>> future, std::string file,
+      uint64_t size);
+
+  /// Wait for op and record its result
+  void Complete(AsyncOp* op);
+
+  /// Make room for size more bytes in flight
+  void ReserveBudget(uint64_t size);
+
+  /// Count size more bytes in flight
+  void AddInflight(uint64_t size);
 
 public:
   /// Build a descriptor with a tag. If running with multiple hosts, Make should
@@ -42,10 +74,30 @@ public:
   /// Start async store op, we hold onto the data until op finishes
   void StartStore(std::shared_ptr<FileFrame> ff);
 
+  /// Hold size bytes of the budget for a file that is about to be produced,
+  /// waiting for earlier stores to make room as StartStore does. The bytes
+  /// pass to the store of the file with StartStore(ff, size) or are given
+  /// back with Release(size).
+  void Reserve(uint64_t size);
+
+  /// Give back bytes held with Reserve
+  void Release(uint64_t size);
+
+  /// Start async store op of a file whose memory was held with
+  /// Reserve(reserved); the bytes stay in flight until the op finishes
+  void StartStore(std::shared_ptr<FileFrame> ff, uint64_t reserved);
+
   /// Start async store op, caller responsible for keeping buffer live
-  void StartStore(const std::string& file, const uint8_t* buf, uint64_t size) {
-    AddOp(FileStoreAsync(file, buf, size), file);
+  void StartStore(const std::string& file, const uint8_t* buf, uint64_t size);
+
+  /// The largest number of bytes that were in flight at once
+  uint64_t peak_inflight_bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return peak_inflight_bytes_;
   }
+
+  /// The largest peak_inflight_bytes of any WriteGroup in this process
+  static uint64_t MaxPeakInflightBytes();
 };
 
 }  // namespace tsuba
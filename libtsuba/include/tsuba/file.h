@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <future>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <unordered_set>
@@ -12,6 +13,8 @@
 
 namespace tsuba {
 
+class StreamingPut;
+
 constexpr uint64_t kBlockSize = UINT64_C(4) << 10; /* 4K */
 constexpr uint64_t kBlockOffsetMask = kBlockSize - 1;
 constexpr uint64_t kBlockMask = ~kBlockOffsetMask;
@@ -31,6 +34,36 @@ struct StatBuf {
   uint64_t size{UINT64_C(0)};
 };
 
+/// Counters for the process-wide cache of blocks read from remote storage
+struct BlockCacheStats {
+  uint64_t hits{UINT64_C(0)};
+  uint64_t misses{UINT64_C(0)};
+  uint64_t evictions{UINT64_C(0)};
+  /// bytes currently held by the cache
+  uint64_t bytes{UINT64_C(0)};
+};
+
+/// Return the block cache counters accumulated since tsuba::Init. The cache
+/// only serves files that are not on a local file system; its capacity is
+/// set in MB by GALOIS_TSUBA_BLOCK_CACHE_MB (0 disables it).
+GALOIS_EXPORT BlockCacheStats GetBlockCacheStats();
+
+/// Counters for the cache of whole remote files on a local disk
+struct DiskCacheStats {
+  uint64_t hits{UINT64_C(0)};
+  uint64_t misses{UINT64_C(0)};
+  uint64_t evictions{UINT64_C(0)};
+  /// bytes of the copies this process knows of
+  uint64_t bytes{UINT64_C(0)};
+};
+
+/// Return the disk cache counters accumulated since tsuba::Init. The cache
+/// is enabled by naming its directory in GALOIS_TSUBA_DISK_CACHE_DIR; its
+/// capacity is set in MB by GALOIS_TSUBA_DISK_CACHE_MB. Files mapped with
+/// FileMmap, or bound whole by FileView, are copied to it, and later reads
+/// of them, also by later processes, are served from the copies.
+GALOIS_EXPORT DiskCacheStats GetDiskCacheStats();
+
 // Returns an error file filename does not exist
 GALOIS_EXPORT galois::Result<void> FileStat(
     const std::string& filename, StatBuf* s_buf);
@@ -39,10 +72,37 @@ GALOIS_EXPORT galois::Result<void> FileStat(
 GALOIS_EXPORT galois::Result<void> FileStore(
     const std::string& uri, const uint8_t* data, uint64_t size);
 
-// Take whatever is in @data and start putting it a the file called @uri
+/// Parameters for storing large files as several concurrently uploaded parts
+struct MultipartConfig {
+  /// FileStoreAsync stores files at least this large in parts
+  uint64_t threshold{UINT64_C(0)};
+  uint64_t part_size{UINT64_C(0)};
+  uint32_t concurrency{0};
+};
+
+/// Return the multipart configuration. The defaults may be overridden with
+/// the environment variables GALOIS_TSUBA_MULTIPART_THRESHOLD_MB,
+/// GALOIS_TSUBA_MULTIPART_PART_SIZE_MB and
+/// GALOIS_TSUBA_MULTIPART_CONCURRENCY.
+GALOIS_EXPORT const MultipartConfig& GetMultipartConfig();
+
+// Take whatever is in @data and start putting it a the file called @uri. Data
+// at least GetMultipartConfig().threshold bytes long is stored in parts.
 GALOIS_EXPORT std::future<galois::Result<void>> FileStoreAsync(
     const std::string& uri, const uint8_t* data, uint64_t size);
 
+/// Start storing @data at @uri as parts of @part_size bytes with up to
+/// @concurrency parts in flight
+GALOIS_EXPORT std::future<galois::Result<void>> FileStoreMultipartAsync(
+    const std::string& uri, const uint8_t* data, uint64_t size,
+    uint64_t part_size, uint32_t concurrency);
+
+/// Start storing a file at @uri that is handed over in parts of
+/// GetMultipartConfig().part_size bytes while it is produced. Returns null
+/// if the storage of @uri needs the whole file at once.
+GALOIS_EXPORT std::unique_ptr<StreamingPut> FileStreamingStore(
+    const std::string& uri);
+
 // read a part of the file into a caller defined buffer
 GALOIS_EXPORT galois::Result<void> FileGet(
     const std::string& filename, uint8_t* result_buffer, uint64_t begin,
@@ -61,6 +121,26 @@ GALOIS_EXPORT std::future<galois::Result<void>> FileGetAsync(
     const std::string& filename, uint8_t* result_buffer, uint64_t begin,
     uint64_t size);
 
+/// Map the first size bytes of the file at uri directly into memory. This is
+/// only possible when uri is on a local file system, or when the disk cache
+/// is enabled, which copies a remote file to local disk first (\see
+/// GetDiskCacheStats). The mapping is private
+/// (copy-on-write), so physical pages are shared with the page cache, and with
+/// other processes mapping the same file, until they are modified.
+///
+/// \param populate if true, prefault the whole mapping; otherwise only advise
+/// the kernel that the range will be needed soon
+/// \returns NotImplemented if the file is not on a local file system and
+/// the disk cache cannot hold it
+GALOIS_EXPORT galois::Result<uint8_t*> FileMmap(
+    const std::string& uri, uint64_t size, bool populate);
+
+/// Like FileMmap of the whole file at uri, when its size, file_size, is
+/// already known, e.g., from a part header; this saves asking storage for
+/// the size before using the disk cache
+GALOIS_EXPORT galois::Result<uint8_t*> FileMmapWhole(
+    const std::string& uri, uint64_t file_size, bool populate);
+
 /// List the set of files in a directory
 /// \param directory is URI whose contents are listed. It can be
 /// Async return type allows this function to be called repeatedly (and
@@ -1,7 +1,9 @@
 #ifndef GALOIS_LIBTSUBA_TSUBA_TSUBA_H_
 #define GALOIS_LIBTSUBA_TSUBA_TSUBA_H_
 
+#include <cstdint>
 #include <memory>
+#include <string>
 
 #include "galois/CommBackend.h"
 #include "galois/Result.h"
@@ -45,15 +47,28 @@ OpenFlagsValid(uint32_t flags) {
   return (flags & ~(kReadOnly | kReadWrite)) == 0;
 }
 
+/// Open the latest version of an RDG. The handle stays on that version, so
+/// reads through it see a consistent snapshot while other processes commit
+/// new versions; commits publish a version only once all of its files are
+/// stored, so opening never waits for a commit in progress. Committing
+/// through the handle fails if another commit published a version since.
+///
+/// The files of the version can be deleted by GarbageCollect while the
+/// handle is open.
 GALOIS_EXPORT galois::Result<RDGHandle> Open(
     const std::string& rdg_name, uint32_t flags);
 
+/// Open a particular version of an RDG (\see Open)
 GALOIS_EXPORT galois::Result<RDGHandle> Open(
     const std::string& rdg_name, uint64_t version, uint32_t flags);
 
 /// Close an RDGHandle object
 GALOIS_EXPORT galois::Result<void> Close(RDGHandle handle);
 
+/// The version of the RDG that handle is on, for opening the same snapshot
+/// again (\see Open)
+GALOIS_EXPORT uint64_t Version(RDGHandle handle);
+
 /// Create an RDG storage location
 /// \param name is storage location prefix that will be used to store the RDG
 GALOIS_EXPORT galois::Result<void> Create(const std::string& name);
@@ -78,6 +93,34 @@ struct GALOIS_EXPORT RDGStat {
 /// Get Information about the graph
 GALOIS_EXPORT galois::Result<RDGStat> Stat(const std::string& rdg_name);
 
+struct GALOIS_EXPORT GarbageCollectStats {
+  /// Versions whose files were kept
+  uint64_t versions_kept{0};
+  /// Files of older versions that were (or, for a dry run, would be) deleted
+  uint64_t files_deleted{0};
+  /// Bytes of the deleted files
+  uint64_t bytes_deleted{0};
+};
+
+/// Delete the files of old versions of an RDG to bound the size of its
+/// directory. It walks the version history back from the latest version:
+/// the files of the latest num_versions_to_keep versions are kept, and the
+/// files that only older versions refer to are deleted, data files before
+/// the meta files that refer to them, so that an interrupted collection can
+/// be run again. Files that no version refers to, e.g., of a commit in
+/// progress, are left alone, so it is safe to run while the RDG is being
+/// committed to. Older versions can no longer be opened afterwards.
+///
+/// This is a collective operation; host 0 does the work and only its stats
+/// are filled in.
+///
+/// \param rdg_name is storage location prefix that the RDG is stored in
+/// \param num_versions_to_keep is at least 1
+/// \param dry_run if true, only count the files that would be deleted
+GALOIS_EXPORT galois::Result<GarbageCollectStats> GarbageCollect(
+    const std::string& rdg_name, uint32_t num_versions_to_keep = 1,
+    bool dry_run = false);
+
 // Setup and tear down
 GALOIS_EXPORT galois::Result<void> Init(galois::CommBackend* comm);
 GALOIS_EXPORT galois::Result<void> Init();
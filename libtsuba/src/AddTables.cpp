@@ -1,48 +1,238 @@
 #include "AddTables.h"
 
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <limits>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include <parquet/arrow/reader.h>
+#include <parquet/file_reader.h>
+#include <parquet/metadata.h>
+
 #include "tsuba/Errors.h"
 #include "tsuba/FileView.h"
+#include "tsuba/MemoryPool.h"
 
 template <typename T>
 using Result = galois::Result<T>;
 
 namespace {
 
+uint32_t
+HardwareThreads() {
+  return std::max(std::thread::hardware_concurrency(), 1U);
+}
+
+/// Call fn(i) for i in [0, n) using up to num_threads threads. Returns the
+/// first error encountered; remaining work is abandoned after an error.
+template <typename Fn>
+Result<void>
+ParallelFor(uint64_t n, uint32_t num_threads, Fn fn) {
+  std::atomic<uint64_t> next{0};
+  auto worker = [&]() -> Result<void> {
+    for (uint64_t i = next++; i < n; i = next++) {
+      if (auto res = fn(i); !res) {
+        next = n;
+        return res.error();
+      }
+    }
+    return galois::ResultSuccess();
+  };
+
+  uint64_t num_workers = std::min<uint64_t>(n, num_threads);
+  std::vector<std::future<Result<void>>> workers;
+  for (uint64_t i = 1; i < num_workers; ++i) {
+    workers.emplace_back(std::async(std::launch::async, worker));
+  }
+
+  Result<void> ret = worker();
+  for (auto& w : workers) {
+    if (auto res = w.get(); !res && ret) {
+      ret = res.error();
+    }
+  }
+  return ret;
+}
+
+/// Read row_groups from reader into one table with (at least) one chunk per
+/// row group, decoding row groups on up to num_threads threads
 Result<std::shared_ptr<arrow::Table>>
-DoLoadTable(const std::string& expected_name, const galois::Uri& file_path) {
-  auto fv = std::make_shared<tsuba::FileView>(tsuba::FileView());
-  if (auto res = fv->Bind(file_path.string(), false); !res) {
+ReadRowGroupsParallel(
+    parquet::arrow::FileReader* reader, const std::vector<int>& row_groups,
+    uint32_t num_threads) {
+  std::shared_ptr<arrow::Table> out;
+  if (num_threads <= 1 || row_groups.size() <= 1) {
+    auto read_result = reader->ReadRowGroups(row_groups, &out);
+    if (!read_result.ok()) {
+      GALOIS_LOG_DEBUG("arrow error: {}", read_result);
+      return tsuba::ErrorCode::ArrowError;
+    }
+    return out;
+  }
+
+  // Concurrent readers on one parquet::arrow::FileReader are safe; the
+  // underlying FileView serializes ReadAt calls.
+  std::vector<std::shared_ptr<arrow::Table>> pieces(row_groups.size());
+  auto res = ParallelFor(
+      row_groups.size(), num_threads, [&](uint64_t i) -> Result<void> {
+        auto read_result = reader->ReadRowGroup(row_groups[i], &pieces[i]);
+        if (!read_result.ok()) {
+          GALOIS_LOG_DEBUG("arrow error: {}", read_result);
+          return tsuba::ErrorCode::ArrowError;
+        }
+        return galois::ResultSuccess();
+      });
+  if (!res) {
     return res.error();
   }
 
-  std::unique_ptr<parquet::arrow::FileReader> reader;
+  auto concat_result = arrow::ConcatenateTables(pieces);
+  if (!concat_result.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", concat_result.status());
+    return tsuba::ErrorCode::ArrowError;
+  }
+  return std::move(concat_result.ValueOrDie());
+}
+
+/// A parquet file ends with the length of its metadata and this magic
+constexpr uint64_t kParquetTrailerSize = 8;
+
+/// What the part header recorded of a property file (\see
+/// PropStorageInfo); 0 or empty if unknown
+struct StoredFile {
+  uint64_t file_size{0};
+  uint64_t footer_size{0};
+  std::vector<uint32_t> block_checksums;
+};
+
+StoredFile
+StoredFileOf(const tsuba::PropStorageInfo& prop) {
+  return StoredFile{prop.file_size, prop.footer_size, prop.block_checksums};
+}
+
+/// Bind fv to file_path, fetching [begin, end) asynchronously, and open it
+/// as a parquet file. A known file size saves asking storage for it, and a
+/// known footer size lets the footer be fetched in one read of exactly its
+/// bytes instead of being found by reading the end of the file first. Known
+/// checksums verify the bytes fetched.
+Result<std::unique_ptr<parquet::arrow::FileReader>>
+OpenParquet(
+    const std::shared_ptr<tsuba::FileView>& fv, const galois::Uri& file_path,
+    const StoredFile& stored, uint64_t begin, uint64_t end) {
+  if (auto res = stored.file_size == 0
+                     ? fv->Bind(file_path.string(), begin, end, false)
+                     : fv->BindKnownSize(
+                           file_path.string(), stored.file_size, begin, end,
+                           false, stored.block_checksums);
+      !res) {
+    return res.error();
+  }
 
-  auto open_file_result =
-      parquet::arrow::OpenFile(fv, arrow::default_memory_pool(), &reader);
+  std::shared_ptr<parquet::FileMetaData> metadata;
+  if (stored.footer_size > kParquetTrailerSize &&
+      stored.footer_size <= stored.file_size) {
+    auto footer_size = static_cast<int64_t>(stored.footer_size);
+    auto footer_result =
+        fv->ReadAt(stored.file_size - stored.footer_size, footer_size);
+    if (!footer_result.ok()) {
+      GALOIS_LOG_DEBUG("arrow error: {}", footer_result.status());
+      return tsuba::ErrorCode::ArrowError;
+    }
+    std::shared_ptr<arrow::Buffer> footer = footer_result.ValueOrDie();
+    if (footer->size() != footer_size) {
+      GALOIS_LOG_DEBUG(
+          "expected a footer of {} bytes found {} instead", footer_size,
+          footer->size());
+      return tsuba::ErrorCode::InvalidArgument;
+    }
+    auto metadata_len =
+        static_cast<uint32_t>(stored.footer_size - kParquetTrailerSize);
+    metadata = parquet::FileMetaData::Make(footer->data(), &metadata_len);
+  }
+
+  std::unique_ptr<parquet::arrow::FileReader> reader;
+  auto open_file_result = parquet::arrow::FileReader::Make(
+      tsuba::GetArrowMemoryPool(),
+      parquet::ParquetFileReader::Open(
+          fv, parquet::default_reader_properties(), metadata),
+      &reader);
   if (!open_file_result.ok()) {
     GALOIS_LOG_DEBUG("arrow error: {}", open_file_result);
     return tsuba::ErrorCode::ArrowError;
   }
+  return reader;
+}
 
-  std::shared_ptr<arrow::Table> out;
-  auto read_result = reader->ReadTable(&out);
-  if (!read_result.ok()) {
-    GALOIS_LOG_DEBUG("arrow error: {}", read_result);
-    return tsuba::ErrorCode::ArrowError;
+/// Return the [begin, end) file offsets spanned by the column chunks of a row
+/// group
+std::pair<uint64_t, uint64_t>
+ColumnChunksRange(const parquet::RowGroupMetaData& rg_md) {
+  uint64_t begin = std::numeric_limits<uint64_t>::max();
+  uint64_t end = 0;
+  for (int c = 0; c < rg_md.num_columns(); ++c) {
+    auto col_md = rg_md.ColumnChunk(c);
+    int64_t col_start = col_md->data_page_offset();
+    if (col_md->has_dictionary_page() && col_md->dictionary_page_offset() > 0) {
+      col_start = std::min(col_start, col_md->dictionary_page_offset());
+    }
+    begin = std::min<uint64_t>(begin, col_start);
+    end = std::max<uint64_t>(end, col_start + col_md->total_compressed_size());
+  }
+  if (begin > end) {
+    return {0, 0};
   }
+  return {begin, end};
+}
 
-  // Combine multiple chunks into one. Binary and string columns (c.f. large
-  // binary and large string columns) are a special case. They may not be
-  // combined into a single chunk due to the fact the offset type for these
-  // columns is int32_t and thus the maximum size of an arrow::Array for these
-  // types is 2^31.
-  auto combine_result = out->CombineChunks(arrow::default_memory_pool());
-  if (!combine_result.ok()) {
-    GALOIS_LOG_DEBUG("arrow error: {}", combine_result.status());
-    return tsuba::ErrorCode::ArrowError;
+Result<std::shared_ptr<arrow::Table>>
+DoLoadTable(
+    const std::string& expected_name, const galois::Uri& file_path,
+    const StoredFile& stored, bool combine_chunks, uint32_t num_threads) {
+  auto fv = std::make_shared<tsuba::FileView>(tsuba::FileView());
+  auto reader_res = OpenParquet(
+      fv, file_path, stored, 0, std::numeric_limits<uint64_t>::max());
+  if (!reader_res) {
+    return reader_res.error();
   }
+  std::unique_ptr<parquet::arrow::FileReader> reader =
+      std::move(reader_res.value());
 
-  out = std::move(combine_result.ValueOrDie());
+  std::shared_ptr<arrow::Table> out;
+  if (int rg_count = reader->num_row_groups(); rg_count <= 1) {
+    auto read_result = reader->ReadTable(&out);
+    if (!read_result.ok()) {
+      GALOIS_LOG_DEBUG("arrow error: {}", read_result);
+      return tsuba::ErrorCode::ArrowError;
+    }
+  } else {
+    std::vector<int> row_groups(rg_count);
+    std::iota(row_groups.begin(), row_groups.end(), 0);
+
+    auto read_result =
+        ReadRowGroupsParallel(reader.get(), row_groups, num_threads);
+    if (!read_result) {
+      return read_result.error();
+    }
+    out = std::move(read_result.value());
+  }
+
+  if (combine_chunks) {
+    // Combine multiple chunks into one. Binary and string columns (c.f. large
+    // binary and large string columns) are a special case. They may not be
+    // combined into a single chunk due to the fact the offset type for these
+    // columns is int32_t and thus the maximum size of an arrow::Array for
+    // these types is 2^31.
+    auto combine_result = out->CombineChunks(tsuba::GetArrowMemoryPool());
+    if (!combine_result.ok()) {
+      GALOIS_LOG_DEBUG("arrow error: {}", combine_result.status());
+      return tsuba::ErrorCode::ArrowError;
+    }
+
+    out = std::move(combine_result.ValueOrDie());
+  }
 
   std::shared_ptr<arrow::Schema> schema = out->schema();
   if (schema->num_fields() != 1) {
@@ -63,57 +253,68 @@ DoLoadTable(const std::string& expected_name, const galois::Uri& file_path) {
 Result<std::shared_ptr<arrow::Table>>
 DoLoadTableSlice(
     const std::string& expected_name, const galois::Uri& file_path,
-    int64_t offset, int64_t length) {
+    const StoredFile& stored, uint64_t row_group_rows, int64_t offset,
+    int64_t length, uint32_t num_threads) {
   if (offset < 0 || length < 0) {
     return tsuba::ErrorCode::InvalidArgument;
   }
   auto fv = std::make_shared<tsuba::FileView>(tsuba::FileView());
-  if (auto res = fv->Bind(file_path.string(), 0, 0, false); !res) {
-    return res.error();
-  }
-
-  std::unique_ptr<parquet::arrow::FileReader> reader;
-
-  auto open_file_result =
-      parquet::arrow::OpenFile(fv, arrow::default_memory_pool(), &reader);
-  if (!open_file_result.ok()) {
-    GALOIS_LOG_DEBUG("arrow error: {}", open_file_result);
-    return tsuba::ErrorCode::ArrowError;
+  auto reader_res = OpenParquet(fv, file_path, stored, 0, 0);
+  if (!reader_res) {
+    return reader_res.error();
   }
+  std::unique_ptr<parquet::arrow::FileReader> reader =
+      std::move(reader_res.value());
 
+  // Select only the row groups that overlap [offset, offset + length), and
+  // prefetch only the bytes of their column chunks
+  std::shared_ptr<parquet::FileMetaData> md =
+      reader->parquet_reader()->metadata();
   std::vector<int> row_groups;
-  int rg_count = reader->num_row_groups();
   int64_t row_offset = 0;
-  int64_t cumulative_rows = 0;
-  int64_t file_offset = 0;
-  int64_t cumulative_bytes = 0;
-  for (int i = 0; cumulative_rows < offset + length && i < rg_count; ++i) {
-    auto rg_md = reader->parquet_reader()->metadata()->RowGroup(i);
-    int64_t new_rows = rg_md->num_rows();
-    int64_t new_bytes = rg_md->total_byte_size();
-    if (offset < cumulative_rows + new_rows) {
-      if (row_groups.empty()) {
-        row_offset = offset - cumulative_rows;
-        file_offset = cumulative_bytes;
-      }
+  int64_t rows = row_group_rows;
+  if (rows > 0 && md->num_row_groups() == (md->num_rows() + rows - 1) / rows) {
+    // row groups of the size recorded in the part header
+    int64_t first = offset / rows;
+    int64_t last = std::min<int64_t>(
+        (offset + length + rows - 1) / rows, md->num_row_groups());
+    for (int64_t i = first; i < last; ++i) {
       row_groups.push_back(i);
     }
-    cumulative_rows += new_rows;
-    cumulative_bytes += new_bytes;
+    row_offset = offset - first * rows;
+  } else {
+    // otherwise go by the row counts in the footer
+    int64_t cumulative_rows = 0;
+    for (int i = 0;
+         cumulative_rows < offset + length && i < md->num_row_groups(); ++i) {
+      int64_t new_rows = md->RowGroup(i)->num_rows();
+      if (offset < cumulative_rows + new_rows) {
+        if (row_groups.empty()) {
+          row_offset = offset - cumulative_rows;
+        }
+        row_groups.push_back(i);
+      }
+      cumulative_rows += new_rows;
+    }
   }
 
-  if (auto res = fv->Fill(file_offset, cumulative_bytes, false); !res) {
-    return res.error();
+  // selected row groups are consecutive so their column chunks are too
+  if (!row_groups.empty()) {
+    uint64_t begin = ColumnChunksRange(*md->RowGroup(row_groups.front())).first;
+    uint64_t end = ColumnChunksRange(*md->RowGroup(row_groups.back())).second;
+    if (auto res = fv->Fill(begin, end, false); !res) {
+      return res.error();
+    }
   }
 
-  std::shared_ptr<arrow::Table> out;
-  auto read_result = reader->ReadRowGroups(row_groups, &out);
-  if (!read_result.ok()) {
-    GALOIS_LOG_DEBUG("arrow error: {}", read_result);
-    return tsuba::ErrorCode::ArrowError;
+  auto read_result =
+      ReadRowGroupsParallel(reader.get(), row_groups, num_threads);
+  if (!read_result) {
+    return read_result.error();
   }
+  std::shared_ptr<arrow::Table> out = std::move(read_result.value());
 
-  auto combine_result = out->CombineChunks(arrow::default_memory_pool());
+  auto combine_result = out->CombineChunks(tsuba::GetArrowMemoryPool());
   if (!combine_result.ok()) {
     GALOIS_LOG_DEBUG("arrow error: {}", combine_result.status());
     return tsuba::ErrorCode::ArrowError;
@@ -137,27 +338,192 @@ DoLoadTableSlice(
   return out->Slice(row_offset, length);
 }
 
-}  // namespace
+/// Read only the footer of a single column parquet file and return a table
+/// with its schema and row count but no data
+Result<std::shared_ptr<arrow::Table>>
+DoLoadPlaceholderTable(
+    const std::string& expected_name, const galois::Uri& file_path,
+    const StoredFile& stored) {
+  auto fv = std::make_shared<tsuba::FileView>(tsuba::FileView());
+  auto reader_res = OpenParquet(fv, file_path, stored, 0, 0);
+  if (!reader_res) {
+    return reader_res.error();
+  }
+  std::unique_ptr<parquet::arrow::FileReader> reader =
+      std::move(reader_res.value());
+
+  std::shared_ptr<arrow::Schema> schema;
+  if (auto status = reader->GetSchema(&schema); !status.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", status);
+    return tsuba::ErrorCode::ArrowError;
+  }
+
+  if (schema->num_fields() != 1) {
+    GALOIS_LOG_DEBUG("expected 1 field found {} instead", schema->num_fields());
+    return tsuba::ErrorCode::InvalidArgument;
+  }
+
+  if (schema->field(0)->name() != expected_name) {
+    GALOIS_LOG_DEBUG(
+        "expected {} found {} instead", expected_name,
+        schema->field(0)->name());
+    return tsuba::ErrorCode::InvalidArgument;
+  }
+
+  return arrow::Table::Make(
+      schema,
+      {std::make_shared<arrow::ChunkedArray>(
+          arrow::ArrayVector{}, schema->field(0)->type())},
+      reader->parquet_reader()->metadata()->num_rows());
+}
 
 Result<std::shared_ptr<arrow::Table>>
-tsuba::LoadTable(
-    const std::string& expected_name, const galois::Uri& file_path) {
+LoadPlaceholderTable(
+    const std::string& expected_name, const galois::Uri& file_path,
+    const StoredFile& stored) {
   try {
-    return DoLoadTable(expected_name, file_path);
+    return DoLoadPlaceholderTable(expected_name, file_path, stored);
   } catch (const std::exception& exp) {
     GALOIS_LOG_DEBUG("arrow exception: {}", exp.what());
     return tsuba::ErrorCode::ArrowError;
   }
 }
 
-galois::Result<std::shared_ptr<arrow::Table>>
-tsuba::LoadTableSlice(
+Result<std::shared_ptr<arrow::Table>>
+LoadTableWithThreads(
     const std::string& expected_name, const galois::Uri& file_path,
-    int64_t offset, int64_t length) {
+    const StoredFile& stored, bool combine_chunks, uint32_t num_threads) {
   try {
-    return DoLoadTableSlice(expected_name, file_path, offset, length);
+    return DoLoadTable(
+        expected_name, file_path, stored, combine_chunks, num_threads);
   } catch (const std::exception& exp) {
     GALOIS_LOG_DEBUG("arrow exception: {}", exp.what());
-    return ErrorCode::ArrowError;
+    return tsuba::ErrorCode::ArrowError;
   }
 }
+
+Result<std::shared_ptr<arrow::Table>>
+LoadTableSliceWithThreads(
+    const std::string& expected_name, const galois::Uri& file_path,
+    const StoredFile& stored, uint64_t row_group_rows, int64_t offset,
+    int64_t length, uint32_t num_threads) {
+  try {
+    return DoLoadTableSlice(
+        expected_name, file_path, stored, row_group_rows, offset, length,
+        num_threads);
+  } catch (const std::exception& exp) {
+    GALOIS_LOG_DEBUG("arrow exception: {}", exp.what());
+    return tsuba::ErrorCode::ArrowError;
+  }
+}
+
+/// Run load_fn(property, threads_per_table) for every property concurrently,
+/// splitting the available hardware threads between properties and the row
+/// groups within each property
+template <typename LoadFn>
+Result<std::vector<std::shared_ptr<arrow::Table>>>
+LoadAll(
+    const std::vector<tsuba::PropStorageInfo>& properties, LoadFn load_fn) {
+  std::vector<std::shared_ptr<arrow::Table>> tables(properties.size());
+  if (properties.empty()) {
+    return tables;
+  }
+
+  uint32_t hw_threads = HardwareThreads();
+  uint32_t concurrent_tables =
+      std::min<uint64_t>(properties.size(), hw_threads);
+  uint32_t threads_per_table = std::max(hw_threads / concurrent_tables, 1U);
+
+  auto res = ParallelFor(
+      properties.size(), concurrent_tables, [&](uint64_t i) -> Result<void> {
+        auto load_result = load_fn(properties[i], threads_per_table);
+        if (!load_result) {
+          return load_result.error();
+        }
+        tables[i] = std::move(load_result.value());
+        return galois::ResultSuccess();
+      });
+  if (!res) {
+    return res.error();
+  }
+  return tables;
+}
+
+}  // namespace
+
+Result<std::shared_ptr<arrow::Table>>
+tsuba::LoadTable(
+    const std::string& expected_name, const galois::Uri& file_path,
+    bool combine_chunks) {
+  return LoadTableWithThreads(
+      expected_name, file_path, StoredFile{}, combine_chunks,
+      HardwareThreads());
+}
+
+galois::Result<std::shared_ptr<arrow::Table>>
+tsuba::LoadTableSlice(
+    const std::string& expected_name, const galois::Uri& file_path,
+    int64_t offset, int64_t length) {
+  return LoadTableSliceWithThreads(
+      expected_name, file_path, StoredFile{}, 0, offset, length,
+      HardwareThreads());
+}
+
+Result<std::vector<std::shared_ptr<arrow::Table>>>
+tsuba::LoadTables(
+    const galois::Uri& dir,
+    const std::vector<tsuba::PropStorageInfo>& properties,
+    bool combine_chunks) {
+  return LoadAll(
+      properties,
+      [&](const tsuba::PropStorageInfo& prop, uint32_t num_threads) {
+        return LoadTableWithThreads(
+            prop.name, dir.Join(prop.path), StoredFileOf(prop),
+            combine_chunks, num_threads);
+      });
+}
+
+Result<std::vector<std::shared_ptr<arrow::Table>>>
+tsuba::LoadTablesSlice(
+    const galois::Uri& dir,
+    const std::vector<tsuba::PropStorageInfo>& properties,
+    std::pair<uint64_t, uint64_t> range) {
+  return LoadAll(
+      properties,
+      [&](const tsuba::PropStorageInfo& prop, uint32_t num_threads) {
+        return LoadTableSliceWithThreads(
+            prop.name, dir.Join(prop.path), StoredFileOf(prop),
+            prop.row_group_rows, range.first, range.second - range.first,
+            num_threads);
+      });
+}
+
+Result<std::shared_ptr<arrow::Table>>
+tsuba::LoadPlaceholderTables(
+    const galois::Uri& dir,
+    const std::vector<tsuba::PropStorageInfo>& properties) {
+  auto load_result = LoadAll(
+      properties, [&](const tsuba::PropStorageInfo& prop, uint32_t) {
+        return LoadPlaceholderTable(
+            prop.name, dir.Join(prop.path), StoredFileOf(prop));
+      });
+  if (!load_result) {
+    return load_result.error();
+  }
+
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  int64_t num_rows = 0;
+  for (const std::shared_ptr<arrow::Table>& table : load_result.value()) {
+    if (!columns.empty() && table->num_rows() != num_rows) {
+      GALOIS_LOG_DEBUG(
+          "expected {} rows found {} instead", num_rows, table->num_rows());
+      return tsuba::ErrorCode::InvalidArgument;
+    }
+    num_rows = table->num_rows();
+    fields.emplace_back(table->schema()->field(0));
+    columns.emplace_back(table->column(0));
+  }
+
+  return arrow::Table::Make(arrow::schema(fields), columns, num_rows);
+}
@@ -9,28 +9,56 @@
 
 namespace tsuba {
 
+/// Load the single column parquet file at file_path. Row groups are decoded
+/// in parallel. If combine_chunks is false, the returned column has one chunk
+/// per row group, which avoids a copy when the caller can take an
+/// arrow::ChunkedArray.
 GALOIS_EXPORT galois::Result<std::shared_ptr<arrow::Table>> LoadTable(
-    const std::string& expected_name, const galois::Uri& file_path);
+    const std::string& expected_name, const galois::Uri& file_path,
+    bool combine_chunks = true);
 
 GALOIS_EXPORT galois::Result<std::shared_ptr<arrow::Table>> LoadTableSlice(
     const std::string& expected_name, const galois::Uri& file_path,
     int64_t offset, int64_t length);
 
+/// Load the tables for all of properties concurrently; the returned tables are
+/// in the same order as properties
+GALOIS_EXPORT galois::Result<std::vector<std::shared_ptr<arrow::Table>>>
+LoadTables(
+    const galois::Uri& dir,
+    const std::vector<tsuba::PropStorageInfo>& properties,
+    bool combine_chunks = true);
+
+/// Load slices of the tables for all of properties concurrently; the returned
+/// tables are in the same order as properties
+GALOIS_EXPORT galois::Result<std::vector<std::shared_ptr<arrow::Table>>>
+LoadTablesSlice(
+    const galois::Uri& dir,
+    const std::vector<tsuba::PropStorageInfo>& properties,
+    std::pair<uint64_t, uint64_t> range);
+
+/// Read only the schemas and row counts of properties and return them as one
+/// table whose columns have the right types but no chunks. Fetching the
+/// values of a column is left to the caller (\see RDG::MakeLazy).
+GALOIS_EXPORT galois::Result<std::shared_ptr<arrow::Table>>
+LoadPlaceholderTables(
+    const galois::Uri& dir,
+    const std::vector<tsuba::PropStorageInfo>& properties);
+
 template <typename AddFn>
 galois::Result<void>
 AddTables(
     const galois::Uri& uri,
-    const std::vector<tsuba::PropStorageInfo>& properties, AddFn add_fn) {
-  for (const tsuba::PropStorageInfo& properties : properties) {
-    auto p_path = uri.Join(properties.path);
-
-    auto load_result = LoadTable(properties.name, p_path);
-    if (!load_result) {
-      return load_result.error();
-    }
-
-    std::shared_ptr<arrow::Table> table = load_result.value();
+    const std::vector<tsuba::PropStorageInfo>& properties, AddFn add_fn,
+    bool combine_chunks = true) {
+  auto load_result = LoadTables(uri, properties, combine_chunks);
+  if (!load_result) {
+    return load_result.error();
+  }
 
+  // add_fn is applied serially and in order so that callers may update
+  // shared state
+  for (const std::shared_ptr<arrow::Table>& table : load_result.value()) {
     auto add_result = add_fn(table);
     if (!add_result) {
       return add_result.error();
@@ -46,17 +74,12 @@ AddTablesSlice(
     const galois::Uri& dir,
     const std::vector<tsuba::PropStorageInfo>& properties,
     std::pair<uint64_t, uint64_t> range, AddFn add_fn) {
-  for (const tsuba::PropStorageInfo& properties : properties) {
-    galois::Uri p_path = dir.Join(properties.path);
-
-    auto load_result = LoadTableSlice(
-        properties.name, p_path, range.first, range.second - range.first);
-    if (!load_result) {
-      return load_result.error();
-    }
-
-    std::shared_ptr<arrow::Table> table = load_result.value();
+  auto load_result = LoadTablesSlice(dir, properties, range);
+  if (!load_result) {
+    return load_result.error();
+  }
 
+  for (const std::shared_ptr<arrow::Table>& table : load_result.value()) {
     auto add_result = add_fn(table);
     if (!add_result) {
       return add_result.error();
@@ -0,0 +1,155 @@
+#include "BlockCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <future>
+
+#include "galois/Logging.h"
+
+namespace tsuba {
+
+bool
+BlockCache::Lookup(
+    const std::string& uri, uint64_t block, uint64_t lo, uint64_t hi,
+    uint8_t* dst) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.find(Key{uri, block});
+  if (it == index_.end() || it->second->data.size() < hi) {
+    misses_++;
+    return false;
+  }
+  hits_++;
+  lru_.splice(lru_.begin(), lru_, it->second);
+  std::memcpy(dst, it->second->data.data() + lo, hi - lo);
+  return true;
+}
+
+void
+BlockCache::Insert(
+    const std::string& uri, uint64_t block, const uint8_t* data,
+    uint64_t size) {
+  if (size > capacity_) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  Key key{uri, block};
+  if (auto it = index_.find(key); it != index_.end()) {
+    if (it->second->data.size() >= size) {
+      return;
+    }
+    Erase(it->second);
+  }
+  lru_.push_front(Entry{key, std::vector<uint8_t>(data, data + size)});
+  index_.emplace(std::move(key), lru_.begin());
+  bytes_ += size;
+  EvictIfNeeded();
+}
+
+void
+BlockCache::Erase(EntryList::iterator it) {
+  bytes_ -= it->data.size();
+  index_.erase(it->key);
+  lru_.erase(it);
+}
+
+void
+BlockCache::EvictIfNeeded() {
+  while (bytes_ > capacity_ && !lru_.empty()) {
+    Erase(std::prev(lru_.end()));
+    evictions_++;
+  }
+}
+
+void
+BlockCache::Invalidate(const std::string& uri) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto it = lru_.begin(); it != lru_.end();) {
+    auto curr = it++;
+    if (curr->key.uri == uri) {
+      Erase(curr);
+    }
+  }
+}
+
+BlockCacheStats
+BlockCache::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return BlockCacheStats{
+      .hits = hits_,
+      .misses = misses_,
+      .evictions = evictions_,
+      .bytes = bytes_,
+  };
+}
+
+galois::Result<void>
+BlockCache::Get(
+    FileStorage* fs, const std::string& uri, uint64_t begin, uint64_t size,
+    uint8_t* result_buf) {
+  if (size == 0) {
+    return galois::ResultSuccess();
+  }
+
+  struct Run {
+    uint64_t first_block;
+    uint64_t last_block;
+    std::vector<uint8_t> data;
+    std::future<galois::Result<void>> work;
+  };
+
+  uint64_t end = begin + size;
+  uint64_t first_block = begin / kCacheBlockSize;
+  uint64_t last_block = (end - 1) / kCacheBlockSize;
+
+  // Copy out cached blocks and group the missing ones into contiguous runs
+  std::vector<Run> runs;
+  for (uint64_t b = first_block; b <= last_block; ++b) {
+    uint64_t block_start = b * kCacheBlockSize;
+    uint64_t lo = std::max(begin, block_start) - block_start;
+    uint64_t hi = std::min(end, block_start + kCacheBlockSize) - block_start;
+    if (Lookup(uri, b, lo, hi, result_buf + (block_start + lo - begin))) {
+      continue;
+    }
+    if (!runs.empty() && runs.back().last_block + 1 == b) {
+      runs.back().last_block = b;
+    } else {
+      runs.emplace_back(Run{b, b, {}, {}});
+    }
+  }
+
+  // Fetch runs from the start of their first block so the whole block can be
+  // cached, but never read past the end of the request
+  for (Run& run : runs) {
+    uint64_t run_start = run.first_block * kCacheBlockSize;
+    uint64_t run_end = std::min(end, (run.last_block + 1) * kCacheBlockSize);
+    run.data.resize(run_end - run_start);
+    run.work = fs->GetAsync(uri, run_start, run.data.size(), run.data.data());
+  }
+
+  galois::Result<void> ret = galois::ResultSuccess();
+  for (Run& run : runs) {
+    if (auto res = run.work.get(); !res) {
+      GALOIS_LOG_DEBUG("block cache fetch of {} failed: {}", uri, res.error());
+      if (ret) {
+        ret = res.error();
+      }
+      continue;
+    }
+    uint64_t run_start = run.first_block * kCacheBlockSize;
+    uint64_t run_end = run_start + run.data.size();
+    uint64_t copy_start = std::max(begin, run_start);
+    std::memcpy(
+        result_buf + (copy_start - begin),
+        run.data.data() + (copy_start - run_start), run_end - copy_start);
+
+    for (uint64_t b = run.first_block; b <= run.last_block; ++b) {
+      uint64_t block_start = b * kCacheBlockSize;
+      Insert(
+          uri, b, run.data.data() + (block_start - run_start),
+          std::min(kCacheBlockSize, run_end - block_start));
+    }
+  }
+  return ret;
+}
+
+}  // namespace tsuba
@@ -0,0 +1,99 @@
+#ifndef GALOIS_LIBTSUBA_BLOCKCACHE_H_
+#define GALOIS_LIBTSUBA_BLOCKCACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "galois/Result.h"
+#include "tsuba/FileStorage.h"
+#include "tsuba/file.h"
+
+namespace tsuba {
+
+/// A process-wide, size-bounded LRU cache of file contents read from
+/// (remote) storage, keyed by (uri, block).
+///
+/// Entries always start at a block boundary but may be shorter than a block,
+/// e.g., the last block of a file. The cache never reads past the end of a
+/// requested range; to fill a block that a request only partially covers it
+/// extends the read backward to the start of the block.
+///
+/// Files in storage are assumed to be immutable; writes and deletes through
+/// tsuba invalidate their entries.
+class BlockCache {
+public:
+  static constexpr uint64_t kCacheBlockSize = UINT64_C(1) << 20; /* 1M */
+
+  explicit BlockCache(uint64_t capacity) : capacity_(capacity) {}
+
+  BlockCache(const BlockCache& no_copy) = delete;
+  BlockCache& operator=(const BlockCache& no_copy) = delete;
+
+  /// Read [begin, begin + size) of uri into result_buf, satisfying what it
+  /// can from the cache and fetching the rest from fs
+  galois::Result<void> Get(
+      FileStorage* fs, const std::string& uri, uint64_t begin, uint64_t size,
+      uint8_t* result_buf);
+
+  /// Drop all cached blocks for uri
+  void Invalidate(const std::string& uri);
+
+  BlockCacheStats stats() const;
+
+  uint64_t capacity() const { return capacity_; }
+
+private:
+  struct Key {
+    std::string uri;
+    uint64_t block;
+
+    bool operator==(const Key& other) const {
+      return block == other.block && uri == other.uri;
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const {
+      return std::hash<std::string>()(key.uri) ^
+             std::hash<uint64_t>()(key.block * UINT64_C(0x9e3779b97f4a7c15));
+    }
+  };
+
+  struct Entry {
+    Key key;
+    std::vector<uint8_t> data;
+  };
+
+  using EntryList = std::list<Entry>;
+
+  /// Copy [lo, hi) of the block into dst if the cache has it
+  bool Lookup(
+      const std::string& uri, uint64_t block, uint64_t lo, uint64_t hi,
+      uint8_t* dst);
+
+  void Insert(
+      const std::string& uri, uint64_t block, const uint8_t* data,
+      uint64_t size);
+
+  void EvictIfNeeded();
+
+  void Erase(EntryList::iterator it);
+
+  uint64_t capacity_;
+
+  mutable std::mutex mutex_;
+  EntryList lru_;
+  std::unordered_map<Key, EntryList::iterator, KeyHash> index_;
+  uint64_t bytes_{0};
+  uint64_t hits_{0};
+  uint64_t misses_{0};
+  uint64_t evictions_{0};
+};
+
+}  // namespace tsuba
+
+#endif
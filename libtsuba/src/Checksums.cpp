@@ -0,0 +1,91 @@
+#include "Checksums.h"
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "galois/Crc32c.h"
+#include "galois/Logging.h"
+#include "tsuba/Errors.h"
+
+namespace {
+
+/// Each thread checksums at least this many blocks
+constexpr uint64_t kMinBlocksPerThread = 16;
+
+/// Call fn(i) for each block i of [0, num_blocks), on as many threads as
+/// the hardware has, but no more than kMinBlocksPerThread blocks allow.
+/// Returns the first error; the remaining blocks are skipped after it.
+template <typename Fn>
+galois::Result<void>
+ForEachBlock(uint64_t num_blocks, Fn fn) {
+  std::atomic<uint64_t> next{0};
+  auto worker = [&]() -> galois::Result<void> {
+    for (uint64_t i = next++; i < num_blocks; i = next++) {
+      if (auto res = fn(i); !res) {
+        next = num_blocks;
+        return res.error();
+      }
+    }
+    return galois::ResultSuccess();
+  };
+
+  uint64_t num_workers = std::min<uint64_t>(
+      std::max(std::thread::hardware_concurrency(), 1U),
+      std::max<uint64_t>(num_blocks / kMinBlocksPerThread, 1));
+  std::vector<std::future<galois::Result<void>>> workers;
+  for (uint64_t i = 1; i < num_workers; ++i) {
+    workers.emplace_back(std::async(std::launch::async, worker));
+  }
+
+  galois::Result<void> ret = worker();
+  for (auto& w : workers) {
+    if (auto res = w.get(); !res && ret) {
+      ret = res.error();
+    }
+  }
+  return ret;
+}
+
+}  // namespace
+
+std::vector<uint32_t>
+tsuba::BlockChecksums(const uint8_t* data, uint64_t size) {
+  std::vector<uint32_t> checksums(NumChecksumBlocks(size));
+  auto res = ForEachBlock(
+      checksums.size(), [&](uint64_t i) -> galois::Result<void> {
+        uint64_t begin = i * kChecksumBlockSize;
+        checksums[i] = galois::Crc32c(
+            data + begin, std::min(kChecksumBlockSize, size - begin));
+        return galois::ResultSuccess();
+      });
+  GALOIS_LOG_ASSERT(res);
+  return checksums;
+}
+
+galois::Result<void>
+tsuba::VerifyBlockChecksums(
+    const std::vector<uint32_t>& checksums, uint64_t first_block,
+    const uint8_t* data, uint64_t size, const std::string& filename) {
+  uint64_t num_blocks = NumChecksumBlocks(size);
+  if (first_block + num_blocks > checksums.size()) {
+    GALOIS_LOG_DEBUG(
+        "{}: blocks [{}, {}) past the {} checksums", filename, first_block,
+        first_block + num_blocks, checksums.size());
+    return ErrorCode::InvalidArgument;
+  }
+  return ForEachBlock(num_blocks, [&](uint64_t i) -> galois::Result<void> {
+    uint64_t begin = i * kChecksumBlockSize;
+    uint32_t crc = galois::Crc32c(
+        data + begin, std::min(kChecksumBlockSize, size - begin));
+    if (crc != checksums[first_block + i]) {
+      GALOIS_LOG_ERROR(
+          "{}: block {} is corrupt: checksum {:08x}, expected {:08x}",
+          filename, first_block + i, crc, checksums[first_block + i]);
+      return ErrorCode::ChecksumMismatch;
+    }
+    return galois::ResultSuccess();
+  });
+}
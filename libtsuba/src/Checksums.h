@@ -0,0 +1,38 @@
+#ifndef GALOIS_LIBTSUBA_CHECKSUMS_H_
+#define GALOIS_LIBTSUBA_CHECKSUMS_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "galois/Result.h"
+
+namespace tsuba {
+
+/// Stored files are checksummed in blocks of this many bytes, the pages of
+/// FileView, so that every fetch of a FileView covers whole blocks
+constexpr uint64_t kChecksumBlockSize = UINT64_C(1) << 20;
+
+/// The number of blocks of a file of size bytes
+inline uint64_t
+NumChecksumBlocks(uint64_t size) {
+  return (size + kChecksumBlockSize - 1) / kChecksumBlockSize;
+}
+
+/// Return the CRC32C of each block of [data, data + size), the last one
+/// possibly shorter. Large ranges are checksummed in parallel.
+std::vector<uint32_t> BlockChecksums(const uint8_t* data, uint64_t size);
+
+/// Check [data, data + size), which starts at block first_block of filename
+/// and ends at a block boundary or the end of the file, against checksums,
+/// the checksums of all the blocks of the file. Large ranges are checked in
+/// parallel.
+///
+/// \returns ChecksumMismatch if a block does not match
+galois::Result<void> VerifyBlockChecksums(
+    const std::vector<uint32_t>& checksums, uint64_t first_block,
+    const uint8_t* data, uint64_t size, const std::string& filename);
+
+}  // namespace tsuba
+
+#endif
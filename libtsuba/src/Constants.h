@@ -1,14 +1,19 @@
 #ifndef GALOIS_LIBTSUBA_CONSTANTS_H_
 #define GALOIS_LIBTSUBA_CONSTANTS_H_
 
+#include <cstdint>
 #include <string_view>
 
 namespace tsuba {
 
-constexpr uint32_t kPartitionMagicNo = 0x4B808284;  // KPRT
-constexpr uint32_t kRDGMagicNo = 0x4B524447;        // KRDG
+constexpr uint32_t kPartitionMagicNo = 0x4B808284;   // KPRT
+constexpr uint32_t kRDGMagicNo = 0x4B524447;         // KRDG
+constexpr uint32_t kPartHeaderMagicNo = 0x4B504844;  // KPHD
 // constexpr uint32_t kPropertyMagicNo  = 0x4B808280; // KPRP
 
+/// Version of the binary part header format; readers reject later versions
+constexpr uint32_t kPartHeaderFormatVersion = 6;
+
 };  // namespace tsuba
 
 #endif
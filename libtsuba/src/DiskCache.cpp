@@ -0,0 +1,247 @@
+#include "DiskCache.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <fmt/format.h>
+
+#include "galois/Logging.h"
+#include "galois/Random.h"
+#include "galois/Uri.h"
+#include "tsuba/Errors.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+/// Copies being written are named by their final name with this suffix and a
+/// random tag
+constexpr std::string_view kTempSuffix = ".tmp.";
+constexpr uint32_t kTempTagLen = 8;
+
+}  // namespace
+
+namespace tsuba {
+
+std::string
+DiskCache::NameOf(const std::string& uri) {
+  // FNV-1a: stable across processes and builds, unlike std::hash
+  uint64_t hash = UINT64_C(0xcbf29ce484222325);
+  for (char c : uri) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= UINT64_C(0x100000001b3);
+  }
+  return fmt::format("{:016x}", hash);
+}
+
+std::string
+DiskCache::PathOf(const std::string& name) const {
+  return galois::Uri::JoinPath(dir_, name);
+}
+
+galois::Result<void>
+DiskCache::Init() {
+  if (boost::system::error_code err; !fs::create_directories(dir_, err)) {
+    if (err) {
+      return err;
+    }
+  }
+
+  DIR* dirp = opendir(dir_.c_str());
+  if (dirp == nullptr) {
+    GALOIS_LOG_DEBUG("failed to open {}: {}", dir_, std::strerror(errno));
+    return ErrorCode::LocalStorageError;
+  }
+
+  struct Found {
+    struct timespec mtime;
+    std::string name;
+    uint64_t size;
+  };
+  std::vector<Found> found;
+  int dfd = dirfd(dirp);
+  struct stat stat_buf;
+  for (struct dirent* dp = readdir(dirp); dp != nullptr; dp = readdir(dirp)) {
+    std::string_view name(dp->d_name);
+    // copies being written by other processes are not indexed
+    if (name.find(kTempSuffix) != std::string_view::npos ||
+        fstatat(dfd, dp->d_name, &stat_buf, 0) != 0 ||
+        !S_ISREG(stat_buf.st_mode)) {
+      continue;
+    }
+    found.emplace_back(Found{
+        .mtime = stat_buf.st_mtim,
+        .name = std::string(name),
+        .size = static_cast<uint64_t>(stat_buf.st_size),
+    });
+  }
+  (void)closedir(dirp);
+
+  std::sort(found.begin(), found.end(), [](const Found& a, const Found& b) {
+    return a.mtime.tv_sec != b.mtime.tv_sec ? a.mtime.tv_sec > b.mtime.tv_sec
+                                            : a.mtime.tv_nsec > b.mtime.tv_nsec;
+  });
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const Found& f : found) {
+    lru_.push_back(Entry{f.name, f.size});
+    index_.emplace(f.name, std::prev(lru_.end()));
+    bytes_ += f.size;
+  }
+  EvictIfNeeded();
+  return galois::ResultSuccess();
+}
+
+std::optional<DiskCache::Copy>
+DiskCache::Lookup(const std::string& uri) {
+  std::string name = NameOf(uri);
+  std::string path = PathOf(name);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Touching the copy records its recency for later processes and checks
+  // that no other process evicted it
+  struct stat stat_buf;
+  if (utimensat(AT_FDCWD, path.c_str(), nullptr, 0) != 0 ||
+      stat(path.c_str(), &stat_buf) != 0) {
+    if (auto it = index_.find(name); it != index_.end()) {
+      EntryList::iterator entry = it->second;
+      index_.erase(it);
+      bytes_ -= entry->size;
+      lru_.erase(entry);
+    }
+    misses_++;
+    return std::nullopt;
+  }
+
+  // the copy may have been added by another process
+  auto size = static_cast<uint64_t>(stat_buf.st_size);
+  Insert(name, size);
+  EvictIfNeeded();
+  if (index_.find(name) == index_.end()) {
+    misses_++;
+    return std::nullopt;
+  }
+  hits_++;
+  return Copy{std::move(path), size};
+}
+
+galois::Result<std::optional<DiskCache::Copy>>
+DiskCache::Fill(FileStorage* fs, const std::string& uri, uint64_t size) {
+  if (size == 0 || size > capacity_) {
+    return std::nullopt;
+  }
+
+  std::string name = NameOf(uri);
+  std::string path = PathOf(name);
+  std::string temp_path = path + std::string(kTempSuffix) +
+                          galois::RandomAlphanumericString(kTempTagLen);
+
+  int fd = open(temp_path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+  if (fd < 0) {
+    GALOIS_LOG_DEBUG(
+        "failed to open {}: {}", temp_path, std::strerror(errno));
+    return ErrorCode::LocalStorageError;
+  }
+
+  // Storage reads straight into the page cache of the copy
+  galois::Result<void> ret = galois::ResultSuccess();
+  void* ptr = MAP_FAILED;
+  if (ftruncate(fd, size) == 0) {
+    ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  if (ptr == MAP_FAILED) {
+    GALOIS_LOG_DEBUG(
+        "failed to map {}: {}", temp_path, std::strerror(errno));
+    ret = ErrorCode::LocalStorageError;
+  } else {
+    ret = fs->GetMultiSync(uri, 0, size, static_cast<uint8_t*>(ptr));
+    if (munmap(ptr, size) != 0 && ret) {
+      ret = galois::ResultErrno();
+    }
+  }
+  if (close(fd) != 0 && ret) {
+    ret = ErrorCode::LocalStorageError;
+  }
+  if (ret && rename(temp_path.c_str(), path.c_str()) != 0) {
+    GALOIS_LOG_DEBUG("failed to rename {}: {}", path, std::strerror(errno));
+    ret = ErrorCode::LocalStorageError;
+  }
+  if (!ret) {
+    (void)unlink(temp_path.c_str());
+    return ret.error();
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  Insert(name, size);
+  EvictIfNeeded();
+  if (index_.find(name) == index_.end()) {
+    return std::nullopt;
+  }
+  return Copy{std::move(path), size};
+}
+
+void
+DiskCache::Insert(const std::string& name, uint64_t size) {
+  if (auto it = index_.find(name); it != index_.end()) {
+    bytes_ -= it->second->size;
+    lru_.erase(it->second);
+    index_.erase(it);
+  }
+  lru_.push_front(Entry{name, size});
+  index_.emplace(name, lru_.begin());
+  bytes_ += size;
+}
+
+void
+DiskCache::Erase(EntryList::iterator it) {
+  // mappings of the copy keep it readable until they are unmapped
+  if (unlink(PathOf(it->name).c_str()) != 0 && errno != ENOENT) {
+    GALOIS_LOG_DEBUG(
+        "failed to unlink {}: {}", PathOf(it->name), std::strerror(errno));
+  }
+  bytes_ -= it->size;
+  index_.erase(it->name);
+  lru_.erase(it);
+}
+
+void
+DiskCache::EvictIfNeeded() {
+  while (bytes_ > capacity_ && !lru_.empty()) {
+    Erase(std::prev(lru_.end()));
+    evictions_++;
+  }
+}
+
+void
+DiskCache::Invalidate(const std::string& uri) {
+  std::string name = NameOf(uri);
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (auto it = index_.find(name); it != index_.end()) {
+    Erase(it->second);
+  } else if (unlink(PathOf(name).c_str()) != 0 && errno != ENOENT) {
+    // another process may have added a copy
+    GALOIS_LOG_DEBUG(
+        "failed to unlink {}: {}", PathOf(name), std::strerror(errno));
+  }
+}
+
+DiskCacheStats
+DiskCache::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return DiskCacheStats{
+      .hits = hits_,
+      .misses = misses_,
+      .evictions = evictions_,
+      .bytes = bytes_,
+  };
+}
+
+}  // namespace tsuba
@@ -0,0 +1,99 @@
+#ifndef GALOIS_LIBTSUBA_DISKCACHE_H_
+#define GALOIS_LIBTSUBA_DISKCACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "galois/Result.h"
+#include "tsuba/FileStorage.h"
+#include "tsuba/file.h"
+
+namespace tsuba {
+
+/// A size-bounded LRU cache of whole remote files, kept as files in a
+/// directory on a local disk, so that later reads of them, also by later
+/// processes, run at local disk speed and can map the copies rather than
+/// copy them into memory.
+///
+/// A copy is named by a hash of the uri of its file. Files in storage are
+/// assumed to be immutable, and RDG files have names unique to the version
+/// that wrote them, so a copy of the expected size is current; writes and
+/// deletes through tsuba drop the copy. Copies are written under a temporary
+/// name and renamed into place, so processes that share the directory only
+/// see complete copies, and a copy evicted while mapped stays readable
+/// through the mapping. The recency of a copy is its modification time,
+/// which hits update, so the order of eviction survives restarts. Each
+/// process bounds the copies it knows of: those in the directory when it
+/// started and those it added.
+class DiskCache {
+public:
+  /// A copy of a remote file
+  struct Copy {
+    std::string path;
+    uint64_t size;
+  };
+
+  DiskCache(std::string dir, uint64_t capacity)
+      : dir_(std::move(dir)), capacity_(capacity) {}
+
+  DiskCache(const DiskCache& no_copy) = delete;
+  DiskCache& operator=(const DiskCache& no_copy) = delete;
+
+  /// Create the directory and index the copies already in it
+  galois::Result<void> Init();
+
+  /// The copy of uri, if the cache has one
+  std::optional<Copy> Lookup(const std::string& uri);
+
+  /// Copy uri, which is size bytes long, from fs into the cache. Returns
+  /// no copy if uri does not fit in the cache.
+  galois::Result<std::optional<Copy>> Fill(
+      FileStorage* fs, const std::string& uri, uint64_t size);
+
+  /// Drop the copy of uri
+  void Invalidate(const std::string& uri);
+
+  DiskCacheStats stats() const;
+
+  const std::string& dir() const { return dir_; }
+  uint64_t capacity() const { return capacity_; }
+
+private:
+  struct Entry {
+    std::string name;
+    uint64_t size;
+  };
+
+  using EntryList = std::list<Entry>;
+
+  static std::string NameOf(const std::string& uri);
+
+  std::string PathOf(const std::string& name) const;
+
+  /// Index a copy that is in place as the most recently used one
+  void Insert(const std::string& name, uint64_t size);
+
+  /// Drop the copy of it from the index and the directory
+  void Erase(EntryList::iterator it);
+
+  void EvictIfNeeded();
+
+  std::string dir_;
+  uint64_t capacity_;
+
+  mutable std::mutex mutex_;
+  EntryList lru_;
+  std::unordered_map<std::string, EntryList::iterator> index_;
+  uint64_t bytes_{0};
+  uint64_t hits_{0};
+  uint64_t misses_{0};
+  uint64_t evictions_{0};
+};
+
+}  // namespace tsuba
+
+#endif
@@ -3,6 +3,8 @@
 
 #include "tsuba/FaultTest.h"
 
+#include <atomic>
+
 #include "galois/Logging.h"
 #include "galois/Random.h"
 
@@ -10,7 +12,8 @@ static tsuba::internal::FaultMode mode_{tsuba::internal::FaultMode::None};
 static float independent_prob_{0.0f};
 static uint64_t run_length_{UINT64_C(0)};
 static uint64_t fault_run_length_{UINT64_C(0)};
-static uint64_t ptp_count_{UINT64_C(0)};
+// atomic: properties are stored from several threads at once
+static std::atomic<uint64_t> ptp_count_{UINT64_C(0)};
 static const std::unordered_map<tsuba::internal::FaultMode, std::string>
     fault_mode_label{
         {tsuba::internal::FaultMode::None, "No faults"},
@@ -21,7 +24,7 @@ static const std::unordered_map<tsuba::internal::FaultMode, std::string>
 
 void
 tsuba::internal::FaultTestReport() {
-  fmt::print("PtP count: {:d}\n", ptp_count_);
+  fmt::print("PtP count: {:d}\n", ptp_count_.load());
 }
 
 void
@@ -71,7 +74,7 @@ die_now(const char* file, int line) {
 void
 tsuba::internal::PtP(
     const char* file, int line, tsuba::internal::FaultSensitivity sensitivity) {
-  ptp_count_++;
+  uint64_t count = ++ptp_count_;
   switch (mode_) {
   case tsuba::internal::FaultMode::None:
     return;
@@ -87,13 +90,13 @@ tsuba::internal::PtP(
       break;
     }
     if (galois::RandomUniformFloat(1.0f) < threshold) {
-      fmt::print("  PtP count {:d}\n", ptp_count_);
+      fmt::print("  PtP count {:d}\n", count);
       die_now(file, line);
     }
   } break;
   case tsuba::internal::FaultMode::RunLength:
   case tsuba::internal::FaultMode::UniformOverRun: {
-    if (ptp_count_ == fault_run_length_) {
+    if (count == fault_run_length_) {
       die_now(file, line);
     }
   }
@@ -2,6 +2,11 @@
 
 #include <sys/mman.h>
 
+#include <algorithm>
+#include <cstring>
+
+#include "Checksums.h"
+#include "galois/Crc32c.h"
 #include "galois/Logging.h"
 #include "galois/Platform.h"
 #include "galois/Result.h"
@@ -18,7 +23,11 @@ FileFrame::~FileFrame() {
 
 galois::Result<void>
 FileFrame::Destroy() {
-  if (valid_) {
+  if (valid_ && stream_) {
+    stream_.reset();
+    part_ = std::vector<uint8_t>();
+    valid_ = false;
+  } else if (valid_) {
     int err = munmap(map_start_, map_size_);
     valid_ = false;
     if (err) {
@@ -32,7 +41,9 @@ galois::Result<void>
 FileFrame::Init(uint64_t reserved_size) {
   size_t size_to_reserve = reserved_size <= 0 ? 1 : reserved_size;
   uint64_t map_size = tsuba::RoundUpToBlock(size_to_reserve);
-  void* ptr = galois::MmapPopulate(
+  // Not populated: reservations are estimates, and pages past the end of
+  // what is written are never touched
+  void* ptr = mmap(
       nullptr, map_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE,
       -1, 0);
   if (ptr == MAP_FAILED) {
@@ -47,6 +58,8 @@ FileFrame::Init(uint64_t reserved_size) {
   synced_ = false;
   valid_ = true;
   cursor_ = 0;
+  block_checksums_.clear();
+  block_checksum_ = 0;
   return galois::ResultSuccess();
 }
 
@@ -55,6 +68,38 @@ FileFrame::Bind(std::string_view filename) {
   path_ = filename;
 }
 
+galois::Result<void>
+FileFrame::InitStreaming(const std::string& path, uint64_t estimated_size) {
+  const MultipartConfig& config = GetMultipartConfig();
+  if (estimated_size >= config.threshold &&
+      estimated_size > config.part_size) {
+    if (std::unique_ptr<StreamingPut> stream = FileStreamingStore(path);
+        stream) {
+      if (auto res = Destroy(); !res) {
+        GALOIS_LOG_ERROR("Destroy: {}", res.error());
+      }
+      path_ = path;
+      map_start_ = nullptr;
+      map_size_ = 0;
+      stream_ = std::move(stream);
+      part_size_ = config.part_size;
+      part_.reserve(part_size_);
+      synced_ = false;
+      valid_ = true;
+      cursor_ = 0;
+      block_checksums_.clear();
+      block_checksum_ = 0;
+      return galois::ResultSuccess();
+    }
+  }
+
+  if (auto res = Init(estimated_size); !res) {
+    return res.error();
+  }
+  Bind(path);
+  return galois::ResultSuccess();
+}
+
 galois::Result<void>
 FileFrame::GrowBuffer(int64_t accomodate) {
   // We need a bigger buffer
@@ -103,6 +148,9 @@ FileFrame::Persist() {
     GALOIS_LOG_DEBUG("No path provided to FileFrame");
     return tsuba::ErrorCode::InvalidArgument;
   }
+  if (stream_) {
+    return PersistAsync().get();
+  }
   if (auto res = tsuba::FileStore(path_, map_start_, cursor_); !res) {
     return res.error();
   }
@@ -118,6 +166,14 @@ FileFrame::PersistAsync() {
     GALOIS_LOG_DEBUG("No path provided to FileFrame");
     return galois::AsyncError<void>(tsuba::ErrorCode::InvalidArgument);
   }
+  if (stream_) {
+    if (synced_) {
+      GALOIS_LOG_DEBUG("streaming FileFrame {} already persisted", path_);
+      return galois::AsyncError<void>(tsuba::ErrorCode::InvalidArgument);
+    }
+    synced_ = true;
+    return stream_->Finish(std::move(part_));
+  }
   return tsuba::FileStoreAsync(path_, map_start_, cursor_);
 }
 
@@ -153,18 +209,85 @@ FileFrame::Write(const void* data, int64_t nbytes) {
     return arrow::Status(
         arrow::StatusCode::Invalid, "Cannot Write negative bytes");
   }
-  if (cursor_ + nbytes > map_size_) {
+  if (!stream_ && cursor_ + nbytes > map_size_) {
     if (auto res = GrowBuffer(nbytes); !res) {
       return arrow::Status(
           arrow::StatusCode::OutOfMemory,
           "FileFrame could not grow buffer to hold incoming write");
     }
   }
+  KeepTail(static_cast<const uint8_t*>(data), nbytes);
+  AddToChecksums(static_cast<const uint8_t*>(data), nbytes);
+  if (stream_) {
+    return WriteToStream(static_cast<const uint8_t*>(data), nbytes);
+  }
   memcpy(map_start_ + cursor_, data, nbytes);
   cursor_ += nbytes;
   return arrow::Status::OK();
 }
 
+arrow::Status
+FileFrame::WriteToStream(const uint8_t* data, int64_t nbytes) {
+  if (synced_) {
+    return arrow::Status(
+        arrow::StatusCode::Invalid, "Write to persisted FileFrame");
+  }
+  cursor_ += nbytes;
+  while (nbytes > 0) {
+    uint64_t take = std::min<uint64_t>(nbytes, part_size_ - part_.size());
+    part_.insert(part_.end(), data, data + take);
+    data += take;
+    nbytes -= take;
+    if (part_.size() == part_size_) {
+      std::vector<uint8_t> full;
+      full.reserve(part_size_);
+      std::swap(full, part_);
+      if (auto res = stream_->PutPart(std::move(full)); !res) {
+        return arrow::Status::IOError(
+            "FileFrame could not store part: ", res.error());
+      }
+    }
+  }
+  return arrow::Status::OK();
+}
+
+void
+FileFrame::KeepTail(const uint8_t* data, uint64_t nbytes) {
+  if (nbytes == 0) {
+    return;
+  }
+  uint64_t keep = std::min<uint64_t>(nbytes, tail_.size());
+  std::memmove(tail_.data(), tail_.data() + keep, tail_.size() - keep);
+  std::memcpy(tail_.data() + tail_.size() - keep, data + nbytes - keep, keep);
+}
+
+void
+FileFrame::AddToChecksums(const uint8_t* data, uint64_t nbytes) {
+  // cursor_ does not count data yet
+  uint64_t filled = cursor_ % kChecksumBlockSize;
+  while (nbytes > 0) {
+    uint64_t take = std::min(nbytes, kChecksumBlockSize - filled);
+    block_checksum_ = galois::Crc32c(data, take, block_checksum_);
+    data += take;
+    nbytes -= take;
+    filled += take;
+    if (filled == kChecksumBlockSize) {
+      block_checksums_.emplace_back(block_checksum_);
+      block_checksum_ = 0;
+      filled = 0;
+    }
+  }
+}
+
+std::vector<uint32_t>
+FileFrame::block_checksums() const {
+  std::vector<uint32_t> checksums = block_checksums_;
+  if (cursor_ % kChecksumBlockSize != 0) {
+    checksums.emplace_back(block_checksum_);
+  }
+  return checksums;
+}
+
 arrow::Status
 FileFrame::Write(const std::shared_ptr<arrow::Buffer>& data) {
   return Write(data->data(), data->size());
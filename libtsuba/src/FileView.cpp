@@ -3,10 +3,14 @@
 #include <sys/mman.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 #include <string>
 
+#include "Checksums.h"
+#include "DiskCache.h"
+#include "GlobalState.h"
 #include "galois/Logging.h"
 #include "galois/Result.h"
 #include "tsuba/Errors.h"
@@ -30,6 +34,15 @@
  * somehow and also tell users to not modify our files?
  */
 
+namespace {
+
+/// A verified fill is fetched in at most this many chunks of at least this
+/// many pages each
+constexpr uint64_t kMaxVerifiedFetches = 16;
+constexpr uint64_t kMinPagesPerVerifiedFetch = 8;
+
+}  // namespace
+
 namespace tsuba {
 
 FileView::~FileView() {
@@ -61,15 +74,46 @@ galois::Result<void>
 FileView::Bind(
     std::string_view filename, uint64_t begin, uint64_t end, bool resolve) {
   StatBuf buf;
-  filename_ = filename;
-  if (auto res = FileStat(filename_, &buf); !res) {
+  if (auto res = FileStat(std::string(filename), &buf); !res) {
     return res.error();
   }
-  uint64_t in_end = std::min<uint64_t>(end, static_cast<uint64_t>(buf.size));
+  return BindKnownSize(filename, buf.size, begin, end, resolve);
+}
+
+galois::Result<void>
+FileView::BindKnownSize(
+    std::string_view filename, uint64_t file_size, uint64_t begin,
+    uint64_t end, bool resolve, std::vector<uint32_t> block_checksums) {
+  filename_ = filename;
+  uint64_t in_end = std::min<uint64_t>(end, file_size);
   if (in_end < begin) {
     return ErrorCode::InvalidArgument;
   }
+  if (auto res = SetChecksums(file_size, std::move(block_checksums)); !res) {
+    return res.error();
+  }
+
+  // A whole remote file is mapped from its copy in the disk cache, which
+  // makes the copy for the next bind if there is none yet
+  if (begin == 0 && in_end == file_size && file_size > 0 &&
+      Disk() != nullptr && FS(filename_)->LocalPath(filename_).empty()) {
+    auto map_res = MapWhole(filename_, file_size, resolve);
+    if (map_res) {
+      return galois::ResultSuccess();
+    }
+    if (map_res.error() != ErrorCode::NotImplemented) {
+      GALOIS_LOG_DEBUG(
+          "mapping {} failed, copying instead: {}", filename_,
+          map_res.error());
+    }
+  }
+
+  return BindCopied(file_size, begin, in_end, resolve);
+}
 
+galois::Result<void>
+FileView::BindCopied(
+    uint64_t file_size, uint64_t begin, uint64_t end, bool resolve) {
   // SCB 2020-07-23: Given that page_shift_ is treated as a compile-time
   // constant, it seems silly to have it be a member of this class. But I can
   // imagine one day wanting to set it dynamically based on file type, file
@@ -79,7 +123,8 @@ FileView::Bind(
   void* tmp = nullptr;
 
   // Map enough virtual memory to hold entire file, but do not populate it
-  tmp = mmap(nullptr, buf.size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  tmp =
+      mmap(nullptr, file_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
   if (tmp == MAP_FAILED) {
     GALOIS_LOG_ERROR("mmap: {}", std::strerror(errno));
     return galois::ResultErrno();
@@ -91,10 +136,89 @@ FileView::Bind(
 
   map_start_ = static_cast<uint8_t*>(tmp);
   mem_start_ = -1;
-  filling_.resize(page_number(buf.size) / 64 + 1, 0);
-  file_size_ = buf.size;
+  released_pages_ = 0;
+  filling_.resize(page_number(file_size) / 64 + 1, 0);
+  file_size_ = file_size;
+  fetches_ = std::make_unique<std::vector<FillingRange>>();
+  if (auto res = Fill(begin, end, resolve); !res) {
+    return res.error();
+  }
+
+  cursor_ = 0;
+  valid_ = true;
+  return galois::ResultSuccess();
+}
+
+galois::Result<void>
+FileView::BindMapped(std::string_view filename, bool populate) {
+  StatBuf buf;
+  if (auto res = FileStat(std::string(filename), &buf); !res) {
+    return res.error();
+  }
+  return BindMappedKnownSize(filename, buf.size, populate);
+}
+
+galois::Result<void>
+FileView::BindMappedKnownSize(
+    std::string_view filename, uint64_t file_size, bool populate,
+    std::vector<uint32_t> block_checksums) {
+  std::string path(filename);
+  if (file_size == 0) {
+    return BindKnownSize(filename, 0, 0, 0, true);
+  }
+  if (auto res = SetChecksums(file_size, std::move(block_checksums)); !res) {
+    return res.error();
+  }
+
+  if (auto res = MapWhole(path, file_size, populate); !res) {
+    if (res.error() != ErrorCode::NotImplemented) {
+      GALOIS_LOG_DEBUG(
+          "mapping {} failed, copying instead: {}", path, res.error());
+    }
+    filename_ = std::move(path);
+    return BindCopied(file_size, 0, file_size, true);
+  }
+  return galois::ResultSuccess();
+}
+
+galois::Result<void>
+FileView::MapWhole(const std::string& path, uint64_t size, bool populate) {
+  auto map_res = FileMmapWhole(path, size, populate);
+  if (!map_res) {
+    return map_res.error();
+  }
+
+  // A remote file is mapped from its copy in the disk cache, which is
+  // verified once populated rather than trusted; a corrupt copy is dropped,
+  // so the caller copies the file from storage instead
+  if (checksums_ && populate && FS(path)->LocalPath(path).empty()) {
+    if (auto res = VerifyBlockChecksums(
+            *checksums_, 0, map_res.value(), size, path);
+        !res) {
+      if (munmap(map_res.value(), size) != 0) {
+        GALOIS_LOG_ERROR("munmap: {}", std::strerror(errno));
+      }
+      if (DiskCache* disk = Disk(); disk != nullptr) {
+        disk->Invalidate(path);
+      }
+      return res.error();
+    }
+  }
+
+  if (auto res = Unbind(); !res) {
+    return res.error();
+  }
+
+  filename_ = path;
+  page_shift_ = 20; /* 1M */
+  map_start_ = map_res.value();
+  mem_start_ = 0;
+  released_pages_ = 0;
+  file_size_ = size;
+  filling_.assign(page_number(size) / 64 + 1, 0);
   fetches_ = std::make_unique<std::vector<FillingRange>>();
-  if (auto res = Fill(begin, in_end, resolve); !res) {
+  // every page is backed by the file, so there is never anything to fetch
+  if (auto res = MarkFilled(&filling_[0], 0, page_number(size)); !res) {
     return res.error();
   }
 
@@ -139,11 +263,7 @@ FileView::Fill(uint64_t begin, uint64_t end, bool resolve) {
         return galois::ResultErrno();
       }
 
-      auto peek_fut =
-          FileGetAsync(filename_, map_start_ + file_off, file_off, map_size);
-      GALOIS_LOG_ASSERT(peek_fut.valid());
-      FillingRange fetch = {first_page, last_page, std::move(peek_fut)};
-      fetches_->push_back(std::move(fetch));
+      StartFetch(first_page, last_page, file_off, map_size);
       if (auto res = MarkFilled(&filling_[0], first_page, last_page); !res) {
         return res.error();
       }
@@ -161,6 +281,68 @@ FileView::Fill(uint64_t begin, uint64_t end, bool resolve) {
   return galois::ResultSuccess();
 }
 
+galois::Result<void>
+FileView::SetChecksums(
+    uint64_t file_size, std::vector<uint32_t> block_checksums) {
+  if (block_checksums.empty()) {
+    checksums_.reset();
+    return galois::ResultSuccess();
+  }
+  if (block_checksums.size() != NumChecksumBlocks(file_size)) {
+    GALOIS_LOG_DEBUG(
+        "{} has {} block checksums but {} blocks", filename_,
+        block_checksums.size(), NumChecksumBlocks(file_size));
+    return ErrorCode::InvalidArgument;
+  }
+  checksums_ = std::make_shared<const std::vector<uint32_t>>(
+      std::move(block_checksums));
+  return galois::ResultSuccess();
+}
+
+void
+FileView::StartFetch(
+    uint64_t first_page, uint64_t last_page, uint64_t file_off,
+    uint64_t map_size) {
+  if (!checksums_) {
+    auto fetch =
+        FileGetAsync(filename_, map_start_ + file_off, file_off, map_size);
+    GALOIS_LOG_ASSERT(fetch.valid());
+    fetches_->push_back(
+        FillingRange{first_page, last_page, std::move(fetch)});
+    return;
+  }
+
+  // Pages are blocks, so every chunk is verified on its own as soon as it
+  // arrives, overlapping verification with the rest of the download, and a
+  // read waits only for the chunks it overlaps
+  GALOIS_LOG_ASSERT((UINT64_C(1) << page_shift_) == kChecksumBlockSize);
+  uint64_t num_pages = last_page - first_page + 1;
+  uint64_t num_chunks = std::clamp<uint64_t>(
+      num_pages / kMinPagesPerVerifiedFetch, 1, kMaxVerifiedFetches);
+  uint64_t chunk_pages = (num_pages + num_chunks - 1) / num_chunks;
+  for (uint64_t first = first_page; first <= last_page; first += chunk_pages) {
+    uint64_t last = std::min(first + chunk_pages - 1, last_page);
+    uint64_t off = first << page_shift_;
+    uint64_t size =
+        std::min((last + 1) << page_shift_, file_off + map_size) - off;
+    uint8_t* data = map_start_ + off;
+    auto fetch = FileGetAsync(filename_, data, off, size);
+    GALOIS_LOG_ASSERT(fetch.valid());
+    // the check captures what it needs rather than this, which may move
+    // while it runs; Unbind resolves it before the memory goes away
+    auto check = std::async(
+        std::launch::async,
+        [fetch = std::move(fetch), data, size, first, checksums = checksums_,
+         filename = filename_]() mutable -> galois::Result<void> {
+          if (auto res = fetch.get(); !res) {
+            return res.error();
+          }
+          return VerifyBlockChecksums(*checksums, first, data, size, filename);
+        });
+    fetches_->push_back(FillingRange{first, last, std::move(check)});
+  }
+}
+
 bool
 FileView::Equals(const FileView& other) const {
   if (!valid_ || !other.valid_) {
@@ -230,6 +412,11 @@ FileView::Read(int64_t nbytes) {
   if (cursor_ + nbytes > file_size_) {
     nbytes_internal = file_size_ - cursor_;
   }
+  if (release_consumed_) {
+    if (auto res = ReleaseBefore(cursor_); !res) {
+      return arrow::Status(arrow::StatusCode::IOError, "releasing pages");
+    }
+  }
   // fetch data from storage if necessary
   if (auto res = Fill(cursor_, cursor_ + nbytes_internal, true); !res) {
     return arrow::Status(arrow::StatusCode::IOError, "FileView::Fill");
@@ -265,6 +452,11 @@ FileView::Read(int64_t nbytes, void* out) {
   if (cursor_ + nbytes > file_size_) {
     nbytes_internal = file_size_ - cursor_;
   }
+  if (release_consumed_) {
+    if (auto res = ReleaseBefore(cursor_); !res) {
+      return arrow::Status(arrow::StatusCode::IOError, "releasing pages");
+    }
+  }
   // fetch data from storage if necessary
   if (auto res = Fill(cursor_, cursor_ + nbytes_internal, true); !res) {
     return arrow::Status(arrow::StatusCode::IOError, "FileView::Fill");
@@ -451,6 +643,70 @@ FileView::MarkFilled(uint64_t* bitmap, uint64_t begin, uint64_t end) {
   return galois::ResultSuccess();
 }
 
+galois::Result<void>
+FileView::MarkEmpty(uint64_t* bitmap, uint64_t begin, uint64_t end) {
+  uint64_t begin_mask;
+  if (begin % 64) {
+    begin_mask = (UINT64_C(1) << (64 - begin % 64)) - UINT64_C(1);
+  } else {
+    begin_mask = ~UINT64_C(0);
+  }
+  uint64_t end_mask = ~((UINT64_C(1) << (63 - end % 64)) - UINT64_C(1));
+
+  uint64_t begin_block = begin / 64;
+  uint64_t end_block = end / 64;
+
+  if (begin_block == end_block) {
+    bitmap[begin_block] &= ~(begin_mask & end_mask);
+  } else {
+    bitmap[begin_block] &= ~begin_mask;
+    for (uint64_t i = begin_block + 1; i < end_block; ++i) {
+      bitmap[i] = 0;
+    }
+    bitmap[end_block] &= ~end_mask;
+  }
+
+  return galois::ResultSuccess();
+}
+
+galois::Result<void>
+FileView::ReleaseBefore(int64_t offset) {
+  // the page containing offset is (partially) still needed
+  uint64_t end_page = page_number(offset);
+  if (end_page <= released_pages_) {
+    return galois::ResultSuccess();
+  }
+
+  uint64_t release_off = released_pages_ << page_shift_;
+  uint64_t release_size = (end_page << page_shift_) - release_off;
+
+  // Make sure no outstanding fetch writes into memory we are releasing
+  if (auto res = Resolve(release_off, release_size - 1); !res) {
+    return res.error();
+  }
+
+  // Replacing the range with a fresh inaccessible mapping frees its physical
+  // pages but keeps the virtual address range reserved for later fills
+  void* ptr = mmap(
+      map_start_ + release_off, release_size, PROT_NONE,
+      MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+  if (ptr == MAP_FAILED) {
+    GALOIS_LOG_ERROR("mmap: {}", std::strerror(errno));
+    return galois::ResultErrno();
+  }
+
+  if (auto res = MarkEmpty(&filling_[0], released_pages_, end_page - 1);
+      !res) {
+    return res.error();
+  }
+  released_pages_ = end_page;
+  int64_t first_kept = static_cast<int64_t>(release_off + release_size);
+  if (mem_start_ >= 0 && mem_start_ < first_kept) {
+    mem_start_ = first_kept;
+  }
+  return galois::ResultSuccess();
+}
+
 galois::Result<void>
 FileView::Resolve(int64_t start, int64_t size) {
   // This loop could do less work by sorting the vector or storing an
@@ -458,11 +714,15 @@ FileView::Resolve(int64_t start, int64_t size) {
   // bottleneck
   for (auto it = fetches_->begin(); it != fetches_->end();) {
     auto fetch = it;
-    if (fetch->first_page <= page_number(start + size) ||
+    if (fetch->first_page <= page_number(start + size) &&
         fetch->last_page >= page_number(start)) {
       // Complete the remaining work if there is some
       if (fetch->work.valid()) {
         if (auto res = fetch->work.get(); !res) {
+          // the pages are fetched again by the next read of them rather
+          // than served as they are
+          (void)MarkEmpty(&filling_[0], fetch->first_page, fetch->last_page);
+          fetches_->erase(fetch);
           return res.error();
         }
       } else {
@@ -481,8 +741,10 @@ FileView::PreFetch(int64_t start, int64_t size) {
   // Our highly sophisticated prefetching algorithm is to crudely approximate
   // the size of the last read plus 10%. This is largely motivated by parquet
   // files, which consecutively read row groups that are (in theory)
-  // approximately the same size.
-  int64_t fetch_size = (size / 10) * 11;
+  // approximately the same size. In streaming mode, the caller tells us how
+  // far ahead to read instead.
+  int64_t fetch_size = read_ahead_ > 0 ? static_cast<int64_t>(read_ahead_)
+                                       : (size / 10) * 11;
   // Make sure we haven't overflown
   assert(fetch_size >= 0);
   uint64_t begin = static_cast<uint64_t>(start + size);
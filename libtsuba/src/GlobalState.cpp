@@ -5,12 +5,20 @@
 
 #include "FileStorage_internal.h"
 #include "MemoryNameServerClient.h"
+#include "galois/Env.h"
 #include "galois/Logging.h"
 #include "galois/Result.h"
 #include "tsuba/Errors.h"
 
 namespace {
 
+constexpr int kDefaultBlockCacheMB = 256;
+constexpr int kDefaultDiskCacheMB = 64 << 10; /* 64G */
+// RDGMetas are checked with the name server on every open by default, since
+// other processes may commit new versions
+constexpr int kDefaultMetaCacheTtlMs = 0;
+constexpr int kDefaultPartHeaderCacheEntries = 1024;
+
 galois::Result<std::unique_ptr<tsuba::NameServerClient>>
 GetMemoryClient() {
   return std::make_unique<tsuba::MemoryNameServerClient>();
@@ -18,6 +26,38 @@ GetMemoryClient() {
 
 }  // namespace
 
+tsuba::GlobalState::GlobalState(
+    galois::CommBackend* comm, tsuba::NameServerClient* ns)
+    : comm_(comm), name_server_client_(ns) {
+  file_stores_.emplace_back(&local_storage_);
+
+  int cache_mb = kDefaultBlockCacheMB;
+  galois::GetEnv("GALOIS_TSUBA_BLOCK_CACHE_MB", &cache_mb);
+  if (cache_mb > 0) {
+    block_cache_ =
+        std::make_unique<BlockCache>(static_cast<uint64_t>(cache_mb) << 20);
+  }
+
+  if (std::string disk_dir;
+      galois::GetEnv("GALOIS_TSUBA_DISK_CACHE_DIR", &disk_dir) &&
+      !disk_dir.empty()) {
+    int disk_mb = kDefaultDiskCacheMB;
+    galois::GetEnv("GALOIS_TSUBA_DISK_CACHE_MB", &disk_mb);
+    if (disk_mb > 0) {
+      disk_cache_ = std::make_unique<DiskCache>(
+          std::move(disk_dir), static_cast<uint64_t>(disk_mb) << 20);
+    }
+  }
+
+  int meta_ttl_ms = kDefaultMetaCacheTtlMs;
+  galois::GetEnv("GALOIS_TSUBA_META_CACHE_TTL_MS", &meta_ttl_ms);
+  int header_entries = kDefaultPartHeaderCacheEntries;
+  galois::GetEnv("GALOIS_TSUBA_PART_HEADER_CACHE_ENTRIES", &header_entries);
+  meta_cache_ = std::make_unique<MetaCache>(
+      std::chrono::milliseconds(std::max(meta_ttl_ms, 0)),
+      static_cast<size_t>(std::max(header_entries, 0)));
+}
+
 std::unique_ptr<tsuba::GlobalState> tsuba::GlobalState::ref_ = nullptr;
 
 std::function<galois::Result<std::unique_ptr<tsuba::NameServerClient>>()>
@@ -81,6 +121,15 @@ tsuba::GlobalState::Init(
     }
   }
 
+  // a cache that cannot be set up only costs speed
+  if (DiskCache* disk = global_state->disk_cache_.get(); disk != nullptr) {
+    if (auto res = disk->Init(); !res) {
+      GALOIS_LOG_WARN(
+          "disabling disk cache at {}: {}", disk->dir(), res.error());
+      global_state->disk_cache_.reset();
+    }
+  }
+
   ref_ = std::move(global_state);
   return galois::ResultSuccess();
 }
@@ -117,6 +166,21 @@ tsuba::NS() {
   return GlobalState::Get().NS();
 }
 
+tsuba::BlockCache*
+tsuba::Cache() {
+  return GlobalState::Get().Cache();
+}
+
+tsuba::DiskCache*
+tsuba::Disk() {
+  return GlobalState::Get().Disk();
+}
+
+tsuba::MetaCache*
+tsuba::Metas() {
+  return GlobalState::Get().Metas();
+}
+
 galois::Result<void>
 tsuba::OneHostOnly(const std::function<galois::Result<void>()>& cb) {
   // Prevent a race when the callback affects a condition guarding the
@@ -4,7 +4,10 @@
 #include <memory>
 #include <vector>
 
+#include "BlockCache.h"
+#include "DiskCache.h"
 #include "LocalStorage.h"
+#include "MetaCache.h"
 #include "galois/CommBackend.h"
 #include "galois/Logging.h"
 #include "galois/Result.h"
@@ -24,11 +27,11 @@ class GlobalState {
   tsuba::NameServerClient* name_server_client_;
 
   tsuba::LocalStorage local_storage_;
+  std::unique_ptr<BlockCache> block_cache_;
+  std::unique_ptr<DiskCache> disk_cache_;
+  std::unique_ptr<MetaCache> meta_cache_;
 
-  GlobalState(galois::CommBackend* comm, tsuba::NameServerClient* ns)
-      : comm_(comm), name_server_client_(ns) {
-    file_stores_.emplace_back(&local_storage_);
-  }
+  GlobalState(galois::CommBackend* comm, tsuba::NameServerClient* ns);
 
   FileStorage* GetDefaultFS() const;
 
@@ -43,6 +46,15 @@ public:
   galois::CommBackend* Comm() const;
   NameServerClient* NS() const;
 
+  /// The cache for remote reads; nullptr if caching is disabled
+  BlockCache* Cache() const { return block_cache_.get(); }
+
+  /// The cache of remote files on local disk; nullptr if it is disabled
+  DiskCache* Disk() const { return disk_cache_.get(); }
+
+  /// The cache of RDGMetas and part headers; never nullptr
+  MetaCache* Metas() const { return meta_cache_.get(); }
+
   /// Get the correct FileStorage based on the URI
   ///
   /// store object is selected based on scheme:
@@ -72,6 +84,9 @@ public:
 galois::CommBackend* Comm();
 FileStorage* FS(std::string_view uri);
 NameServerClient* NS();
+BlockCache* Cache();
+DiskCache* Disk();
+MetaCache* Metas();
 
 /// Execute cb on one host, if it succeeds return success if not print
 /// the error and return MpiError
@@ -0,0 +1,149 @@
+#include "tsuba/IOStats.h"
+
+#include <map>
+#include <mutex>
+#include <tuple>
+
+#include "IOStats_internal.h"
+
+namespace {
+
+thread_local tsuba::IOClass current_io_class = tsuba::IOClass::kOther;
+
+using Key = std::tuple<std::string, tsuba::IOClass, tsuba::IOOp>;
+
+struct Registry {
+  std::mutex mutex;
+  std::map<Key, tsuba::IOOpStats> stats;
+};
+
+Registry&
+GetRegistry() {
+  // leaked so that I/O of static destructors can still be counted
+  static Registry* registry = new Registry;
+  return *registry;
+}
+
+std::string
+BackendName(std::string_view uri_scheme) {
+  std::string_view name = uri_scheme.substr(0, uri_scheme.find(':'));
+  return std::string(name.empty() ? "file" : name);
+}
+
+unsigned
+LatencyBucket(uint64_t usec) {
+  unsigned bucket = 0;
+  while (bucket + 1 < tsuba::kNumIOLatencyBuckets &&
+         usec > (uint64_t{1} << bucket)) {
+    ++bucket;
+  }
+  return bucket;
+}
+
+}  // namespace
+
+const char*
+tsuba::IOClassName(IOClass io_class) {
+  switch (io_class) {
+  case IOClass::kTopology:
+    return "topology";
+  case IOClass::kNodeProperty:
+    return "node_property";
+  case IOClass::kEdgeProperty:
+    return "edge_property";
+  case IOClass::kPartHeader:
+    return "part_header";
+  case IOClass::kOther:
+    break;
+  }
+  return "other";
+}
+
+const char*
+tsuba::IOOpName(IOOp op) {
+  switch (op) {
+  case IOOp::kGet:
+    return "get";
+  case IOOp::kStore:
+    return "store";
+  case IOOp::kList:
+    return "list";
+  case IOOp::kMmap:
+    return "mmap";
+  case IOOp::kDelete:
+    return "delete";
+  }
+  return "unknown";
+}
+
+tsuba::IOClassScope::IOClassScope(IOClass io_class)
+    : prev_(current_io_class) {
+  current_io_class = io_class;
+}
+
+tsuba::IOClassScope::~IOClassScope() { current_io_class = prev_; }
+
+tsuba::IOClass
+tsuba::CurrentIOClass() {
+  return current_io_class;
+}
+
+std::vector<tsuba::IOStatsEntry>
+tsuba::GetIOStats() {
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  std::vector<IOStatsEntry> entries;
+  entries.reserve(registry.stats.size());
+  for (const auto& [key, stats] : registry.stats) {
+    entries.emplace_back(IOStatsEntry{
+        .backend = std::get<0>(key),
+        .io_class = std::get<1>(key),
+        .op = std::get<2>(key),
+        .stats = stats,
+    });
+  }
+  return entries;
+}
+
+void
+tsuba::internal::RecordIO(
+    std::string_view backend, IOClass io_class, IOOp op, uint64_t bytes,
+    IOClock::time_point start, bool ok) {
+  uint64_t usec = std::chrono::duration_cast<std::chrono::microseconds>(
+                      IOClock::now() - start)
+                      .count();
+
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  IOOpStats& stats = registry.stats[Key{BackendName(backend), io_class, op}];
+  stats.ops++;
+  if (ok) {
+    stats.bytes += bytes;
+  } else {
+    stats.errors++;
+  }
+  stats.latency_sum_usec += usec;
+  stats.latency_buckets[LatencyBucket(usec)]++;
+}
+
+void
+tsuba::internal::RecordIO(
+    FileStorage* fs, IOOp op, uint64_t bytes, IOClock::time_point start,
+    bool ok) {
+  RecordIO(fs->uri_scheme(), current_io_class, op, bytes, start, ok);
+}
+
+std::future<galois::Result<void>>
+tsuba::internal::TrackIO(
+    std::future<galois::Result<void>> future, FileStorage* fs, IOOp op,
+    uint64_t bytes) {
+  return std::async(
+      std::launch::async,
+      [future = std::move(future), backend = std::string(fs->uri_scheme()),
+       io_class = current_io_class, op, bytes,
+       start = IOClock::now()]() mutable -> galois::Result<void> {
+        galois::Result<void> res = future.get();
+        RecordIO(backend, io_class, op, bytes, start, res.has_value());
+        return res;
+      });
+}
@@ -0,0 +1,37 @@
+#ifndef GALOIS_LIBTSUBA_IOSTATSINTERNAL_H_
+#define GALOIS_LIBTSUBA_IOSTATSINTERNAL_H_
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <string>
+#include <string_view>
+
+#include "galois/Result.h"
+#include "tsuba/FileStorage.h"
+#include "tsuba/IOStats.h"
+
+namespace tsuba::internal {
+
+using IOClock = std::chrono::steady_clock;
+
+/// Counts one operation of this thread's IOClass on fs that started at start
+/// and has just finished
+void RecordIO(
+    FileStorage* fs, IOOp op, uint64_t bytes, IOClock::time_point start,
+    bool ok);
+
+/// Like RecordIO but for an operation of io_class counted on another thread
+void RecordIO(
+    std::string_view backend, IOClass io_class, IOOp op, uint64_t bytes,
+    IOClock::time_point start, bool ok);
+
+/// Return a future that counts the operation of future once it is ready.
+/// Waiting for it takes a thread.
+std::future<galois::Result<void>> TrackIO(
+    std::future<galois::Result<void>> future, FileStorage* fs, IOOp op,
+    uint64_t bytes);
+
+}  // namespace tsuba::internal
+
+#endif
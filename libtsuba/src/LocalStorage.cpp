@@ -6,19 +6,199 @@
 #include <sys/types.h>
 #include <unistd.h>
 
-#include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <deque>
+#include <vector>
 
 #include <boost/filesystem.hpp>
 
 #include "GlobalState.h"
+#include "galois/Env.h"
 #include "galois/Logging.h"
 #include "galois/Result.h"
+#include "galois/Trace.h"
 #include "galois/Uri.h"
 #include "tsuba/Errors.h"
 #include "tsuba/file.h"
 
 namespace fs = boost::filesystem;
 
+namespace {
+
+/// Largest single pread/pwrite issued; bigger ranges are split
+constexpr uint64_t kMaxRequestSize = UINT64_C(8) << 20; /* 8M */
+constexpr int kDefaultQueueDepth = 8;
+/// Files that one worker stats or unlinks at a time
+constexpr uint64_t kFilesPerRequest = 64;
+
+uint32_t
+QueueDepth() {
+  static uint32_t depth = [] {
+    int env_depth = kDefaultQueueDepth;
+    galois::GetEnv("GALOIS_LOCAL_STORAGE_QUEUE_DEPTH", &env_depth);
+    return static_cast<uint32_t>(std::max(env_depth, 1));
+  }();
+  return depth;
+}
+
+/// Read up to size bytes at offset, retrying on partial reads; returns the
+/// number of bytes read, which will be short only at end of file
+galois::Result<uint64_t>
+PreadFully(int fd, uint8_t* data, uint64_t size, uint64_t offset) {
+  galois::TraceScope trace("io", "pread");
+  uint64_t done = 0;
+  while (done < size) {
+    ssize_t ret = pread(fd, data + done, size - done, offset + done);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return galois::ResultErrno();
+    }
+    if (ret == 0) {
+      break;
+    }
+    done += ret;
+  }
+  return done;
+}
+
+galois::Result<void>
+PwriteFully(int fd, const uint8_t* data, uint64_t size, uint64_t offset) {
+  galois::TraceScope trace("io", "pwrite");
+  uint64_t done = 0;
+  while (done < size) {
+    ssize_t ret = pwrite(fd, data + done, size - done, offset + done);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return galois::ResultErrno();
+    }
+    done += ret;
+  }
+  return galois::ResultSuccess();
+}
+
+/// Split [0, size) into requests of at most request_size bytes and call
+/// request_fn(offset, length) on each, keeping up to queue_depth requests in
+/// flight. Returns the first error encountered.
+template <typename RequestFn>
+galois::Result<void>
+ForEachRequest(
+    uint64_t size, uint64_t request_size, uint32_t queue_depth,
+    RequestFn request_fn) {
+  request_size = std::max<uint64_t>(request_size, 1);
+  uint64_t num_requests = (size + request_size - 1) / request_size;
+  if (num_requests <= 1) {
+    return request_fn(0, size);
+  }
+
+  std::atomic<uint64_t> next{0};
+  auto worker = [&]() -> galois::Result<void> {
+    for (uint64_t i = next++; i < num_requests; i = next++) {
+      uint64_t offset = i * request_size;
+      uint64_t length = std::min(request_size, size - offset);
+      if (auto res = request_fn(offset, length); !res) {
+        // stop handing out requests to the other workers
+        next = num_requests;
+        return res.error();
+      }
+    }
+    return galois::ResultSuccess();
+  };
+
+  uint64_t num_workers =
+      std::min<uint64_t>(num_requests, std::max<uint32_t>(queue_depth, 1));
+  std::vector<std::future<galois::Result<void>>> workers;
+  for (uint64_t i = 1; i < num_workers; ++i) {
+    workers.emplace_back(std::async(std::launch::async, worker));
+  }
+
+  galois::Result<void> ret = worker();
+  for (auto& w : workers) {
+    if (auto res = w.get(); !res && ret) {
+      ret = res.error();
+    }
+  }
+  return ret;
+}
+
+/// A streaming put to an open local file: parts are written at their offset
+/// by their own workers, with up to concurrency of them in flight
+class LocalStreamingPut : public tsuba::StreamingPut {
+  int fd_;
+  std::string path_;
+  uint32_t concurrency_;
+  uint64_t offset_{0};
+  std::deque<std::future<galois::Result<void>>> in_flight_;
+  /// The first error of any part
+  galois::Result<void> status_ = galois::ResultSuccess();
+
+  void WaitOldest() {
+    if (auto res = in_flight_.front().get(); !res && status_) {
+      GALOIS_LOG_DEBUG("failed to write {}: {}", path_, res.error());
+      status_ = tsuba::ErrorCode::LocalStorageError;
+    }
+    in_flight_.pop_front();
+  }
+
+  galois::Result<void> WaitAll() {
+    while (!in_flight_.empty()) {
+      WaitOldest();
+    }
+    if (fd_ >= 0) {
+      if (close(fd_) != 0 && status_) {
+        status_ = tsuba::ErrorCode::LocalStorageError;
+      }
+      fd_ = -1;
+    }
+    return status_;
+  }
+
+public:
+  LocalStreamingPut(int fd, std::string path, uint32_t concurrency)
+      : fd_(fd),
+        path_(std::move(path)),
+        concurrency_(std::max<uint32_t>(concurrency, 1)) {}
+
+  ~LocalStreamingPut() override { (void)WaitAll(); }
+
+  galois::Result<void> PutPart(std::vector<uint8_t>&& part) override {
+    while (status_ && in_flight_.size() >= concurrency_) {
+      WaitOldest();
+    }
+    if (!status_) {
+      return status_.error();
+    }
+    uint64_t offset = offset_;
+    offset_ += part.size();
+    in_flight_.emplace_back(std::async(
+        std::launch::async,
+        [fd = fd_, part = std::move(part), offset]() -> galois::Result<void> {
+          return PwriteFully(fd, part.data(), part.size(), offset);
+        }));
+    return galois::ResultSuccess();
+  }
+
+  std::future<galois::Result<void>> Finish(
+      std::vector<uint8_t>&& last) override {
+    return std::async(
+        std::launch::async,
+        [this, last = std::move(last)]() mutable -> galois::Result<void> {
+          if (!last.empty()) {
+            // a failure here is also recorded in status_
+            (void)PutPart(std::move(last));
+          }
+          return WaitAll();
+        });
+  }
+};
+
+}  // namespace
+
 void
 tsuba::LocalStorage::CleanUri(std::string* uri) {
   if (uri->find(uri_scheme()) != 0) {
@@ -27,9 +207,24 @@ tsuba::LocalStorage::CleanUri(std::string* uri) {
   *uri = std::string(uri->begin() + uri_scheme().size(), uri->end());
 }
 
+std::string
+tsuba::LocalStorage::LocalPath(const std::string& uri) const {
+  if (uri.find(uri_scheme()) != 0) {
+    return uri;
+  }
+  return std::string(uri.begin() + uri_scheme().size(), uri.end());
+}
+
 galois::Result<void>
 tsuba::LocalStorage::WriteFile(
     std::string uri, const uint8_t* data, uint64_t size) {
+  return WriteFile(std::move(uri), data, size, kMaxRequestSize, QueueDepth());
+}
+
+galois::Result<void>
+tsuba::LocalStorage::WriteFile(
+    std::string uri, const uint8_t* data, uint64_t size, uint64_t request_size,
+    uint32_t queue_depth) {
   CleanUri(&uri);
   fs::path m_path{uri};
   fs::path dir = m_path.parent_path();
@@ -39,43 +234,128 @@ tsuba::LocalStorage::WriteFile(
     }
   }
 
-  std::ofstream ofile(uri);
-  if (!ofile.good()) {
+  int fd = open(uri.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    GALOIS_LOG_DEBUG("failed to open {}: {}", uri, std::strerror(errno));
     return ErrorCode::LocalStorageError;
   }
-  ofile.write(reinterpret_cast<const char*>(data), size); /* NOLINT */
-  if (!ofile.good()) {
-    return ErrorCode::LocalStorageError;
+
+  // Size the file up front so that requests can land in any order
+  galois::Result<void> ret = galois::ResultSuccess();
+  if (ftruncate(fd, size) != 0) {
+    GALOIS_LOG_DEBUG("failed to truncate {}: {}", uri, std::strerror(errno));
+    ret = ErrorCode::LocalStorageError;
+  } else {
+    ret = ForEachRequest(
+        size, request_size, queue_depth,
+        [&](uint64_t offset, uint64_t length) -> galois::Result<void> {
+          return PwriteFully(fd, data + offset, length, offset);
+        });
+    if (!ret) {
+      GALOIS_LOG_DEBUG("failed to write {}: {}", uri, ret.error());
+      ret = ErrorCode::LocalStorageError;
+    }
   }
-  return galois::ResultSuccess();
+
+  if (close(fd) != 0 && ret) {
+    ret = ErrorCode::LocalStorageError;
+  }
+  return ret;
 }
 
 galois::Result<void>
 tsuba::LocalStorage::ReadFile(
     std::string uri, uint64_t start, uint64_t size, uint8_t* data) {
   CleanUri(&uri);
-  std::ifstream ifile(uri);
-
-  ifile.seekg(start);
-  if (!ifile) {
-    GALOIS_LOG_DEBUG("failed to seek");
+  int fd = open(uri.c_str(), O_RDONLY);
+  if (fd < 0) {
+    GALOIS_LOG_DEBUG("failed to open {}: {}", uri, std::strerror(errno));
     return ErrorCode::LocalStorageError;
   }
 
-  ifile.read(reinterpret_cast<char*>(data), size); /* NOLINT */
-  if (!ifile) {
-    GALOIS_LOG_DEBUG("failed to read");
+  std::atomic<uint64_t> total_read{0};
+  galois::Result<void> ret = ForEachRequest(
+      size, kMaxRequestSize, QueueDepth(),
+      [&](uint64_t offset, uint64_t length) -> galois::Result<void> {
+        auto res = PreadFully(fd, data + offset, length, start + offset);
+        if (!res) {
+          return res.error();
+        }
+        total_read += res.value();
+        return galois::ResultSuccess();
+      });
+  (void)close(fd);
+
+  if (!ret) {
+    GALOIS_LOG_DEBUG("failed to read: {}", ret.error());
     return ErrorCode::LocalStorageError;
   }
 
   // if the difference in what was read from what we wanted is less  than a
   // block it's because the file size isn't well aligned so don't complain.
-  if (size - ifile.gcount() > kBlockSize) {
+  if (size - total_read > kBlockSize) {
     return ErrorCode::LocalStorageError;
   }
   return galois::ResultSuccess();
 }
 
+std::future<galois::Result<void>>
+tsuba::LocalStorage::PutAsync(
+    const std::string& uri, const uint8_t* data, uint64_t size) {
+  // caller keeps data live until the future resolves
+  return std::async(
+      std::launch::async, [this, uri, data, size]() -> galois::Result<void> {
+        return WriteFile(uri, data, size);
+      });
+}
+
+std::future<galois::Result<void>>
+tsuba::LocalStorage::PutMultipartAsync(
+    const std::string& uri, const uint8_t* data, uint64_t size,
+    uint64_t part_size, uint32_t concurrency) {
+  return std::async(
+      std::launch::async,
+      [this, uri, data, size, part_size,
+       concurrency]() -> galois::Result<void> {
+        return WriteFile(uri, data, size, part_size, concurrency);
+      });
+}
+
+std::unique_ptr<tsuba::StreamingPut>
+tsuba::LocalStorage::StartStreamingPut(
+    const std::string& uri, uint64_t part_size, uint32_t concurrency) {
+  (void)part_size;
+  std::string path = uri;
+  CleanUri(&path);
+  fs::path m_path{path};
+  fs::path dir = m_path.parent_path();
+  if (boost::system::error_code err; !fs::create_directories(dir, err)) {
+    if (err) {
+      // PutAsync reports the error once the frame falls back to it
+      return nullptr;
+    }
+  }
+
+  // Parts land in order, so unlike WriteFile nothing is sized up front
+  int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    GALOIS_LOG_DEBUG("failed to open {}: {}", path, std::strerror(errno));
+    return nullptr;
+  }
+  return std::make_unique<LocalStreamingPut>(fd, std::move(path), concurrency);
+}
+
+std::future<galois::Result<void>>
+tsuba::LocalStorage::GetAsync(
+    const std::string& uri, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  return std::async(
+      std::launch::async,
+      [this, uri, start, size, result_buf]() -> galois::Result<void> {
+        return ReadFile(uri, start, size, result_buf);
+      });
+}
+
 galois::Result<void>
 tsuba::LocalStorage::Stat(const std::string& uri, StatBuf* s_buf) {
   std::string filename = uri;
@@ -113,8 +393,7 @@ tsuba::LocalStorage::ListAsync(
         []() -> galois::Result<void> { return ErrorCode::LocalStorageError; });
   }
 
-  int dfd = dirfd(dirp);
-  struct stat stat_buf;
+  uint64_t first = list->size();
   do {
     errno = 0;
     if ((dp = readdir(dirp)) != nullptr) {
@@ -122,16 +401,6 @@ tsuba::LocalStorage::ListAsync(
       // to filter in clients in a reasonable way.
       if (strcmp(".", dp->d_name) && strcmp("..", dp->d_name)) {
         list->emplace_back(dp->d_name);
-        if (size) {
-          if (fstatat(dfd, dp->d_name, &stat_buf, 0) == 0) {
-            size->emplace_back(stat_buf.st_size);
-          } else {
-            size->emplace_back(0UL);
-            GALOIS_LOG_DEBUG(
-                "dir file stat failed dir: {} file: {} : {}", dirname,
-                dp->d_name, galois::ResultErrno().message());
-          }
-        }
       }
     }
   } while (dp != nullptr);
@@ -139,9 +408,36 @@ tsuba::LocalStorage::ListAsync(
   if (errno != 0) {
     GALOIS_LOG_ERROR(
         "\n  readdir failed: {}: {}", dirname, galois::ResultErrno().message());
+    (void)closedir(dirp);
     return std::async(
         []() -> galois::Result<void> { return ErrorCode::LocalStorageError; });
   }
+
+  if (size) {
+    // stats are the slow part of listing large directories on network file
+    // systems, so spread them over the workers
+    int dfd = dirfd(dirp);
+    uint64_t num_files = list->size() - first;
+    size->resize(size->size() + num_files);
+    uint64_t* sizes = size->data() + size->size() - num_files;
+    const std::string* names = list->data() + first;
+    (void)ForEachRequest(
+        num_files, kFilesPerRequest, QueueDepth(),
+        [&](uint64_t begin, uint64_t count) -> galois::Result<void> {
+          struct stat stat_buf;
+          for (uint64_t i = begin; i < begin + count; ++i) {
+            if (fstatat(dfd, names[i].c_str(), &stat_buf, 0) == 0) {
+              sizes[i] = stat_buf.st_size;
+            } else {
+              sizes[i] = 0;
+              GALOIS_LOG_DEBUG(
+                  "dir file stat failed dir: {} file: {} : {}", dirname,
+                  names[i], galois::ResultErrno().message());
+            }
+          }
+          return galois::ResultSuccess();
+        });
+  }
   (void)closedir(dirp);
 
   return std::async(
@@ -157,11 +453,26 @@ tsuba::LocalStorage::Delete(
 
   if (files.empty()) {
     rmdir(dir.c_str());
-  } else {
-    for (const auto& file : files) {
-      auto path = galois::Uri::JoinPath(dir, file);
-      unlink(path.c_str());
-    }
+    return galois::ResultSuccess();
   }
-  return galois::ResultSuccess();
+
+  std::vector<const std::string*> names;
+  names.reserve(files.size());
+  for (const auto& file : files) {
+    names.emplace_back(&file);
+  }
+  return ForEachRequest(
+      names.size(), kFilesPerRequest, QueueDepth(),
+      [&](uint64_t begin, uint64_t count) -> galois::Result<void> {
+        for (uint64_t i = begin; i < begin + count; ++i) {
+          auto path = galois::Uri::JoinPath(dir, *names[i]);
+          // deleting a file that is already gone is not an error
+          if (unlink(path.c_str()) != 0 && errno != ENOENT) {
+            GALOIS_LOG_DEBUG(
+                "failed to unlink {}: {}", path, std::strerror(errno));
+            return ErrorCode::LocalStorageError;
+          }
+        }
+        return galois::ResultSuccess();
+      });
 }
@@ -5,6 +5,7 @@
 
 #include <cstdint>
 #include <future>
+#include <limits>
 #include <string>
 #include <thread>
 
@@ -13,12 +14,20 @@
 
 namespace tsuba {
 
-/// Store byte arrays to the local file system; Provided as a convenience for
-/// testing only (un-optimized)
+/// Store byte arrays to the local file system
+///
+/// Large reads and writes are split into fixed-size requests that are issued
+/// with pread/pwrite by a small number of concurrent workers so that local
+/// NVMe devices see enough outstanding I/O to reach their bandwidth. The
+/// number of workers can be set with the GALOIS_LOCAL_STORAGE_QUEUE_DEPTH
+/// environment variable.
 class LocalStorage : public FileStorage {
   void CleanUri(std::string* uri);
   galois::Result<void> WriteFile(
-      std::string, const uint8_t* data, uint64_t size);
+      std::string uri, const uint8_t* data, uint64_t size,
+      uint64_t request_size, uint32_t queue_depth);
+  galois::Result<void> WriteFile(
+      std::string uri, const uint8_t* data, uint64_t size);
   galois::Result<void> ReadFile(
       std::string uri, uint64_t start, uint64_t size, uint8_t* data);
 
@@ -29,6 +38,8 @@ public:
   galois::Result<void> Fini() override { return galois::ResultSuccess(); }
   galois::Result<void> Stat(const std::string& uri, StatBuf* size) override;
 
+  std::string LocalPath(const std::string& uri) const override;
+
   uint32_t Priority() const override { return 1; }
 
   galois::Result<void> GetMultiSync(
@@ -44,33 +55,30 @@ public:
 
   // get on future can potentially block (bulk synchronous parallel)
   std::future<galois::Result<void>> PutAsync(
-      const std::string& uri, const uint8_t* data, uint64_t size) override {
-    // No need for AsyncPut to local storage right now
-    if (auto write_res = WriteFile(uri, data, size); !write_res) {
-      return std::async(
-          [=]() -> galois::Result<void> { return write_res.error(); });
-    }
-    return std::async(
-        []() -> galois::Result<void> { return galois::ResultSuccess(); });
-  }
+      const std::string& uri, const uint8_t* data, uint64_t size) override;
+  std::future<galois::Result<void>> PutMultipartAsync(
+      const std::string& uri, const uint8_t* data, uint64_t size,
+      uint64_t part_size, uint32_t concurrency) override;
+  /// Writes each part with pwrite as soon as it is handed over
+  std::unique_ptr<StreamingPut> StartStreamingPut(
+      const std::string& uri, uint64_t part_size,
+      uint32_t concurrency) override;
   std::future<galois::Result<void>> GetAsync(
       const std::string& uri, uint64_t start, uint64_t size,
-      uint8_t* result_buf) override {
-    // I suppose there is no need for AsyncGet to local storage either
-    if (auto read_res = ReadFile(uri, start, size, result_buf); !read_res) {
-      return std::async(
-          [=]() -> galois::Result<void> { return read_res.error(); });
-    }
-    return std::async(
-        []() -> galois::Result<void> { return galois::ResultSuccess(); });
-  }
+      uint8_t* result_buf) override;
   std::future<galois::Result<void>> ListAsync(
       const std::string& uri, std::vector<std::string>* list,
       std::vector<uint64_t>* size) override;
 
+  /// Unlinks the files with up to GALOIS_LOCAL_STORAGE_QUEUE_DEPTH workers
   galois::Result<void> Delete(
       const std::string& directory,
       const std::unordered_set<std::string>& files) override;
+
+  /// Delete already spreads the files over its workers
+  uint64_t DeleteBatchSize() const override {
+    return std::numeric_limits<uint64_t>::max();
+  }
 };
 
 }  // namespace tsuba
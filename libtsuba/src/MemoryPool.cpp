@@ -0,0 +1,25 @@
+#include "tsuba/MemoryPool.h"
+
+#include <atomic>
+
+namespace {
+
+std::atomic<arrow::MemoryPool*> installed_pool{nullptr};
+
+}  // namespace
+
+arrow::MemoryPool*
+tsuba::GetArrowMemoryPool() {
+  arrow::MemoryPool* pool = installed_pool.load(std::memory_order_acquire);
+  return pool ? pool : arrow::default_memory_pool();
+}
+
+void
+tsuba::SetArrowMemoryPool(arrow::MemoryPool* pool) {
+  // Storing the default pool itself keeps GetArrowMemoryPool consistent when
+  // a scoped pool restores it
+  if (pool == arrow::default_memory_pool()) {
+    pool = nullptr;
+  }
+  installed_pool.store(pool, std::memory_order_release);
+}
@@ -0,0 +1,71 @@
+#include "MetaCache.h"
+
+namespace tsuba {
+
+std::optional<RDGMeta>
+MetaCache::GetFreshMeta(const galois::Uri& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = metas_.find(name.string());
+  if (it == metas_.end() || Clock::now() - it->second.fetched >= ttl_) {
+    return std::nullopt;
+  }
+  return it->second.meta;
+}
+
+bool
+MetaCache::IsKnownName(const galois::Uri& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return metas_.count(name.string()) != 0;
+}
+
+void
+MetaCache::PutMeta(const galois::Uri& name, const RDGMeta& meta) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  metas_.insert_or_assign(name.string(), MetaEntry{meta, Clock::now()});
+}
+
+void
+MetaCache::InvalidateMeta(const galois::Uri& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  metas_.erase(name.string());
+}
+
+std::optional<RDGPartHeader>
+MetaCache::GetPartHeader(const std::string& uri) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = headers_.find(uri);
+  if (it == headers_.end()) {
+    return std::nullopt;
+  }
+  header_lru_.splice(header_lru_.begin(), header_lru_, it->second);
+  return it->second->header;
+}
+
+void
+MetaCache::PutPartHeader(const std::string& uri, const RDGPartHeader& header) {
+  if (max_headers_ == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (auto it = headers_.find(uri); it != headers_.end()) {
+    header_lru_.erase(it->second);
+    headers_.erase(it);
+  }
+  header_lru_.push_front(HeaderEntry{uri, header});
+  headers_.emplace(uri, header_lru_.begin());
+  while (headers_.size() > max_headers_) {
+    headers_.erase(header_lru_.back().uri);
+    header_lru_.pop_back();
+  }
+}
+
+void
+MetaCache::InvalidatePartHeader(const std::string& uri) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (auto it = headers_.find(uri); it != headers_.end()) {
+    header_lru_.erase(it->second);
+    headers_.erase(it);
+  }
+}
+
+}  // namespace tsuba
@@ -0,0 +1,83 @@
+#ifndef GALOIS_LIBTSUBA_METACACHE_H_
+#define GALOIS_LIBTSUBA_METACACHE_H_
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "RDGMeta.h"
+#include "RDGPartHeader.h"
+#include "galois/Uri.h"
+
+namespace tsuba {
+
+/// A process-wide cache of the metadata that opening an RDG reads before its
+/// data: the RDGMeta that the name server holds for each name and the parsed
+/// part headers.
+///
+/// Part headers are named by host and version, so a header read for one
+/// version stays valid when the name moves to another version; like other
+/// files they are assumed to be immutable, writes and deletes through tsuba
+/// invalidate them, and the least recently used headers beyond max_headers
+/// are dropped.
+///
+/// The RDGMeta of a name may change in other processes, so an entry is only
+/// returned as fresh for ttl after it was fetched; after that it only says
+/// that the name is registered. Changes to names through this process
+/// invalidate their entries.
+class MetaCache {
+public:
+  MetaCache(std::chrono::milliseconds ttl, size_t max_headers)
+      : ttl_(ttl), max_headers_(max_headers) {}
+
+  MetaCache(const MetaCache& no_copy) = delete;
+  MetaCache& operator=(const MetaCache& no_copy) = delete;
+
+  /// The RDGMeta of name if it was fetched less than ttl ago
+  std::optional<RDGMeta> GetFreshMeta(const galois::Uri& name);
+
+  /// Whether name was registered with the name server when it was last
+  /// fetched, however long ago
+  bool IsKnownName(const galois::Uri& name);
+
+  void PutMeta(const galois::Uri& name, const RDGMeta& meta);
+
+  void InvalidateMeta(const galois::Uri& name);
+
+  std::optional<RDGPartHeader> GetPartHeader(const std::string& uri);
+
+  void PutPartHeader(const std::string& uri, const RDGPartHeader& header);
+
+  void InvalidatePartHeader(const std::string& uri);
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct MetaEntry {
+    RDGMeta meta;
+    Clock::time_point fetched;
+  };
+
+  struct HeaderEntry {
+    std::string uri;
+    RDGPartHeader header;
+  };
+
+  using HeaderList = std::list<HeaderEntry>;
+
+  std::chrono::milliseconds ttl_;
+  size_t max_headers_;
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, MetaEntry> metas_;
+  HeaderList header_lru_;
+  std::unordered_map<std::string, HeaderList::iterator> headers_;
+};
+
+}  // namespace tsuba
+
+#endif
@@ -1,13 +1,23 @@
 #include "tsuba/RDG.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstring>
 #include <exception>
 #include <fstream>
+#include <future>
 #include <memory>
+#include <optional>
 #include <regex>
+#include <string_view>
+#include <thread>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <arrow/filesystem/api.h>
+#include <arrow/util/compression.h>
 #include <parquet/arrow/reader.h>
 #include <parquet/arrow/schema.h>
 #include <parquet/arrow/writer.h>
@@ -16,16 +26,19 @@
 #include <parquet/properties.h>
 
 #include "AddTables.h"
+#include "Checksums.h"
 #include "GlobalState.h"
 #include "RDGCore.h"
 #include "RDGHandleImpl.h"
 #include "galois/Backtrace.h"
+#include "galois/Env.h"
 #include "galois/JSON.h"
 #include "galois/Logging.h"
 #include "galois/Result.h"
 #include "galois/Uri.h"
 #include "tsuba/Errors.h"
 #include "tsuba/FaultTest.h"
+#include "tsuba/IOStats.h"
 #include "tsuba/file.h"
 #include "tsuba/tsuba.h"
 
@@ -38,15 +51,188 @@ const char* kMirrorNodesPropName = "mirror_nodes";
 const char* kMasterNodesPropName = "master_nodes";
 const char* kLocalToTGlobalPropName = "local_to_global_vector";
 
-std::shared_ptr<parquet::WriterProperties>
-StandardWriterProperties() {
+/// At most this many values of a property are sampled to choose its
+/// encoding
+constexpr int64_t kEncodingSampleSize = 1 << 16;
+/// Samples smaller than this are not worth compressing to find out whether
+/// compression pays; a file this small takes a single request either way
+constexpr size_t kMinCompressionSample = 4096;
+
+/// A sample of the first values of a property, if they are stored
+/// contiguously
+struct Sample {
+  std::string_view bytes;
+  int64_t num_values{0};
+  int64_t num_distinct{0};
+};
+
+template <typename ArrayType>
+Sample
+SampleBinary(const ArrayType& values) {
+  int64_t n = std::min(values.length(), kEncodingSampleSize);
+  std::unordered_set<std::string_view> distinct;
+  for (int64_t i = 0; i < n; ++i) {
+    auto view = values.GetView(i);
+    distinct.emplace(view.data(), view.size());
+  }
+  const uint8_t* begin = values.value_data()->data() + values.value_offset(0);
+  const uint8_t* end = values.value_data()->data() + values.value_offset(n);
+  return Sample{
+      std::string_view(reinterpret_cast<const char*>(begin), end - begin), n,
+      static_cast<int64_t>(distinct.size())};
+}
+
+Sample
+SampleFixedWidth(const arrow::ArrayData& data, int64_t width) {
+  int64_t n = std::min(data.length, kEncodingSampleSize);
+  const char* begin =
+      reinterpret_cast<const char*>(data.buffers[1]->data()) +
+      data.offset * width;
+  std::unordered_set<std::string_view> distinct;
+  for (int64_t i = 0; i < n; ++i) {
+    distinct.emplace(begin + i * width, width);
+  }
+  return Sample{
+      std::string_view(begin, n * width), n,
+      static_cast<int64_t>(distinct.size())};
+}
+
+/// Sample the first chunk of array with values; the sample is empty if they
+/// are not of a fixed width of whole bytes, strings or binaries
+Sample
+TakeSample(const arrow::ChunkedArray& array) {
+  for (const auto& chunk : array.chunks()) {
+    if (chunk->length() == 0) {
+      continue;
+    }
+    switch (chunk->type_id()) {
+    case arrow::Type::STRING:
+    case arrow::Type::BINARY:
+      return SampleBinary(static_cast<const arrow::BinaryArray&>(*chunk));
+    case arrow::Type::LARGE_STRING:
+    case arrow::Type::LARGE_BINARY:
+      return SampleBinary(static_cast<const arrow::LargeBinaryArray&>(*chunk));
+    default:
+      break;
+    }
+    const arrow::ArrayData& data = *chunk->data();
+    const auto* type =
+        dynamic_cast<const arrow::FixedWidthType*>(data.type.get());
+    if (!type || type->id() == arrow::Type::DICTIONARY ||
+        type->id() == arrow::Type::EXTENSION || type->bit_width() % 8 != 0 ||
+        data.buffers.size() != 2 || !data.buffers[1]) {
+      return Sample{};
+    }
+    return SampleFixedWidth(data, type->bit_width() / 8);
+  }
+  return Sample{};
+}
+
+arrow::Compression::type
+ToArrowCompression(tsuba::RDG::Codec codec) {
+  switch (codec) {
+  case tsuba::RDG::Codec::kSnappy:
+    return arrow::Compression::SNAPPY;
+  case tsuba::RDG::Codec::kLz4:
+    return arrow::Compression::LZ4;
+  case tsuba::RDG::Codec::kZstd:
+    return arrow::Compression::ZSTD;
+  default:
+    return arrow::Compression::UNCOMPRESSED;
+  }
+}
+
+/// The codec that automatic encodings try: zstd, or snappy if this build of
+/// arrow has no zstd
+arrow::Compression::type
+PreferredCompression() {
+  for (auto codec : {arrow::Compression::ZSTD, arrow::Compression::SNAPPY}) {
+    if (arrow::util::Codec::IsAvailable(codec)) {
+      return codec;
+    }
+  }
+  return arrow::Compression::UNCOMPRESSED;
+}
+
+/// Whether compressing sample with codec shrinks it by at least a fifth
+galois::Result<bool>
+CompressionPays(const Sample& sample, arrow::Compression::type codec) {
+  auto codec_result = arrow::util::Codec::Create(codec);
+  if (!codec_result.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", codec_result.status());
+    return tsuba::ErrorCode::ArrowError;
+  }
+  std::unique_ptr<arrow::util::Codec> compressor =
+      std::move(codec_result.ValueOrDie());
+
+  const auto* input = reinterpret_cast<const uint8_t*>(sample.bytes.data());
+  int64_t input_size = sample.bytes.size();
+  std::vector<uint8_t> output(
+      compressor->MaxCompressedLen(input_size, input));
+  auto compress_result =
+      compressor->Compress(input_size, input, output.size(), output.data());
+  if (!compress_result.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", compress_result.status());
+    return tsuba::ErrorCode::ArrowError;
+  }
+  return compress_result.ValueOrDie() * 5 <= input_size * 4;
+}
+
+/// The parquet properties of the file of a property with the values array
+galois::Result<std::shared_ptr<parquet::WriterProperties>>
+StandardWriterProperties(
+    const tsuba::RDG& rdg, const std::string& name,
+    const arrow::ChunkedArray& array) {
+  const tsuba::RDG::PropertyEncoding& encoding = rdg.property_encoding(name);
+  Sample sample;
+  if (encoding.codec == tsuba::RDG::Codec::kAutomatic ||
+      !encoding.dictionary.has_value()) {
+    sample = TakeSample(array);
+  }
+
+  arrow::Compression::type codec = ToArrowCompression(encoding.codec);
+  if (encoding.codec == tsuba::RDG::Codec::kAutomatic) {
+    codec = PreferredCompression();
+    if (codec != arrow::Compression::UNCOMPRESSED &&
+        sample.bytes.size() >= kMinCompressionSample) {
+      auto pays_result = CompressionPays(sample, codec);
+      if (!pays_result) {
+        return pays_result.error();
+      }
+      if (!pays_result.value()) {
+        codec = arrow::Compression::UNCOMPRESSED;
+      }
+    }
+  } else if (!arrow::util::Codec::IsAvailable(codec)) {
+    GALOIS_LOG_DEBUG(
+        "codec {} of property {} is not available in this build of arrow",
+        arrow::util::Codec::GetCodecAsString(codec), name);
+    return tsuba::ErrorCode::InvalidArgument;
+  }
+
+  // Parquet falls back to plain encoding once a dictionary grows too large,
+  // so the default only saves the attempt on values that are mostly distinct
+  bool dictionary = true;
+  if (encoding.dictionary.has_value()) {
+    dictionary = *encoding.dictionary;
+  } else if (sample.num_values > 0) {
+    dictionary = sample.num_distinct * 4 <= sample.num_values;
+  }
+
   // int64 timestamps with nanosecond resolution requires Parquet version 2.0.
   // In Arrow to Parquet version 1.0, nanosecond timestamps will get truncated
   // to milliseconds.
-  return parquet::WriterProperties::Builder()
-      .version(parquet::ParquetVersion::PARQUET_2_0)
+  parquet::WriterProperties::Builder builder;
+  builder.version(parquet::ParquetVersion::PARQUET_2_0)
       ->data_page_version(parquet::ParquetDataPageVersion::V2)
-      ->build();
+      ->data_pagesize(rdg.data_page_size())
+      ->compression(codec);
+  if (dictionary) {
+    builder.enable_dictionary();
+  } else {
+    builder.disable_dictionary();
+  }
+  return builder.build();
 }
 
 std::shared_ptr<parquet::ArrowWriterProperties>
@@ -54,49 +240,198 @@ StandardArrowProperties() {
   return parquet::ArrowWriterProperties::Builder().build();
 }
 
+/// The size of the arrow buffers of array, which the parquet file of array
+/// rarely exceeds by more than its footer and page headers
+uint64_t
+EstimateFileSize(const arrow::ChunkedArray& array) {
+  uint64_t size = tsuba::kBlockSize;
+  std::vector<const arrow::ArrayData*> pending;
+  for (const auto& chunk : array.chunks()) {
+    pending.emplace_back(chunk->data().get());
+  }
+  while (!pending.empty()) {
+    const arrow::ArrayData* data = pending.back();
+    pending.pop_back();
+    for (const auto& buffer : data->buffers) {
+      if (buffer) {
+        size += buffer->size();
+      }
+    }
+    for (const auto& child : data->child_data) {
+      pending.emplace_back(child.get());
+    }
+    if (data->dictionary) {
+      pending.emplace_back(data->dictionary.get());
+    }
+  }
+  return size;
+}
+
+/// The most memory the frame of a file of estimated_size bytes holds: the
+/// whole file, or the parts in flight if the file is streamed
+uint64_t
+FrameMemory(uint64_t estimated_size) {
+  const tsuba::MultipartConfig& config = tsuba::GetMultipartConfig();
+  if (estimated_size < config.threshold) {
+    return estimated_size;
+  }
+  return std::min(
+      estimated_size, config.part_size * (config.concurrency + 1));
+}
+
+/// The number of property files that are encoded at once. The default is
+/// one per hardware thread; it may be overridden with the environment
+/// variable GALOIS_TSUBA_ENCODE_CONCURRENCY.
+uint32_t
+EncodeConcurrency() {
+  static uint32_t concurrency = [] {
+    int env_concurrency =
+        std::max<int>(std::thread::hardware_concurrency(), 1);
+    galois::GetEnv("GALOIS_TSUBA_ENCODE_CONCURRENCY", &env_concurrency);
+    return static_cast<uint32_t>(std::max(env_concurrency, 1));
+  }();
+  return concurrency;
+}
+
+/// The size of the parquet footer of a file that ends with tail: the
+/// metadata, whose length the trailer holds, and the trailer itself; 0 if
+/// tail is not a parquet trailer
+uint64_t
+ParquetFooterSize(std::string_view tail) {
+  constexpr std::string_view kParquetMagic = "PAR1";
+  constexpr size_t kTrailerSize = sizeof(uint32_t) + kParquetMagic.size();
+  if (tail.size() < kTrailerSize ||
+      tail.substr(tail.size() - kParquetMagic.size()) != kParquetMagic) {
+    return 0;
+  }
+  uint32_t metadata_len = 0;
+  std::memcpy(
+      &metadata_len, tail.data() + tail.size() - kTrailerSize,
+      sizeof(metadata_len));
+  return uint64_t{metadata_len} + kTrailerSize;
+}
+
 /// Store the arrow array as a table in a unique file, return
-/// the final name of that file
-galois::Result<std::string>
+/// where it was stored: the final name of that file and its sizes. The
+/// reserved bytes of the budget of desc pass to the store.
+galois::Result<tsuba::PropStorageInfo>
 DoStoreArrowArrayAtName(
     const std::shared_ptr<arrow::ChunkedArray>& array, const galois::Uri& dir,
-    const std::string& name, tsuba::WriteGroup* desc) {
+    const std::string& name, const tsuba::RDG& rdg, uint64_t estimated_size,
+    uint64_t reserved, tsuba::WriteGroup* desc) {
   galois::Uri next_path = dir.RandFile(name);
 
   // Metadata paths should relative to dir
   std::shared_ptr<arrow::Table> column = arrow::Table::Make(
       arrow::schema({arrow::field(name, array->type())}), {array});
 
+  // Reserving the estimate saves growing the frame while parquet writes,
+  // and large files go to storage as they are written
   auto ff = std::make_shared<tsuba::FileFrame>();
-  if (auto res = ff->Init(); !res) {
+  if (auto res = ff->InitStreaming(next_path.string(), estimated_size);
+      !res) {
     return res.error();
   }
 
+  auto properties_result = StandardWriterProperties(rdg, name, *array);
+  if (!properties_result) {
+    return properties_result.error();
+  }
+
   auto write_result = parquet::arrow::WriteTable(
-      *column, arrow::default_memory_pool(), ff,
-      std::numeric_limits<int64_t>::max(), StandardWriterProperties(),
-      StandardArrowProperties());
+      *column, arrow::default_memory_pool(), ff, rdg.row_group_rows(),
+      properties_result.value(), StandardArrowProperties());
 
   if (!write_result.ok()) {
     GALOIS_LOG_DEBUG("arrow error: {}", write_result);
     return tsuba::ErrorCode::ArrowError;
   }
 
-  ff->Bind(next_path.string());
+  // the sizes are recorded in the part header, so readers need not ask
+  // storage for them, with the checksums readers verify the file against
+  tsuba::PropStorageInfo stored{
+      .name = name,
+      .path = next_path.BaseName(),
+      .persist = true,
+      .row_group_rows = rdg.row_group_rows(),
+      .file_size = ff->size(),
+      .footer_size = ParquetFooterSize(ff->tail()),
+      .block_checksums = ff->block_checksums(),
+  };
+
   TSUBA_PTP(tsuba::internal::FaultSensitivity::Normal);
-  desc->StartStore(std::move(ff));
-  return next_path.BaseName();
+  desc->StartStore(std::move(ff), reserved);
+  return stored;
 }
 
-galois::Result<std::string>
+/// Store the arrow array as DoStoreArrowArrayAtName does, first holding the
+/// memory of its file in the budget of desc
+galois::Result<tsuba::PropStorageInfo>
 StoreArrowArrayAtName(
     const std::shared_ptr<arrow::ChunkedArray>& array, const galois::Uri& dir,
-    const std::string& name, tsuba::WriteGroup* desc) {
+    const std::string& name, const tsuba::RDG& rdg, tsuba::WriteGroup* desc) {
+  uint64_t estimated_size = EstimateFileSize(*array);
+  uint64_t reserved = FrameMemory(estimated_size);
+  desc->Reserve(reserved);
+
+  galois::Result<tsuba::PropStorageInfo> res = galois::ResultSuccess();
   try {
-    return DoStoreArrowArrayAtName(array, dir, name, desc);
+    res = DoStoreArrowArrayAtName(
+        array, dir, name, rdg, estimated_size, reserved, desc);
   } catch (const std::exception& exp) {
     GALOIS_LOG_DEBUG("arrow exception: {}", exp.what());
-    return tsuba::ErrorCode::ArrowError;
+    res = tsuba::ErrorCode::ArrowError;
+  }
+  if (!res) {
+    desc->Release(reserved);
+  }
+  return res;
+}
+
+using NamedArray = std::pair<std::shared_ptr<arrow::ChunkedArray>, std::string>;
+
+/// Store each array under its name with StoreArrowArrayAtName, encoding up
+/// to EncodeConcurrency() of them at once while the stores of the ones
+/// already encoded are in flight. Return where the arrays were stored in
+/// the order of arrays.
+galois::Result<std::vector<tsuba::PropStorageInfo>>
+StoreArrowArraysAtNames(
+    const std::vector<NamedArray>& arrays, const galois::Uri& dir,
+    const tsuba::RDG& rdg, tsuba::WriteGroup* desc) {
+  std::vector<tsuba::PropStorageInfo> stored(arrays.size());
+  std::atomic<size_t> next{0};
+  auto worker = [&, io_class = tsuba::CurrentIOClass()]()
+      -> galois::Result<void> {
+    tsuba::IOClassScope scope(io_class);
+    for (size_t i = next++; i < arrays.size(); i = next++) {
+      auto res = StoreArrowArrayAtName(
+          arrays[i].first, dir, arrays[i].second, rdg, desc);
+      if (!res) {
+        // stop handing out arrays to the other workers
+        next = arrays.size();
+        return res.error();
+      }
+      stored[i] = std::move(res.value());
+    }
+    return galois::ResultSuccess();
+  };
+
+  size_t num_workers = std::min<size_t>(arrays.size(), EncodeConcurrency());
+  std::vector<std::future<galois::Result<void>>> workers;
+  for (size_t i = 1; i < num_workers; ++i) {
+    workers.emplace_back(std::async(std::launch::async, worker));
   }
+
+  galois::Result<void> ret = worker();
+  for (auto& w : workers) {
+    if (auto res = w.get(); !res && ret) {
+      ret = res.error();
+    }
+  }
+  if (!ret) {
+    return ret.error();
+  }
+  return stored;
 }
 
 std::string
@@ -113,33 +448,39 @@ galois::Result<std::vector<tsuba::PropStorageInfo>>
 WriteTable(
     const arrow::Table& table,
     const std::vector<tsuba::PropStorageInfo>& properties,
-    const galois::Uri& dir, tsuba::WriteGroup* desc) {
+    const galois::Uri& dir, const tsuba::RDG& rdg, tsuba::WriteGroup* desc) {
   const auto& schema = table.schema();
 
-  std::vector<std::string> next_paths;
+  std::vector<NamedArray> arrays;
   for (size_t i = 0, n = properties.size(); i < n; ++i) {
     if (!properties[i].persist || !properties[i].path.empty()) {
       continue;
     }
     auto name = properties[i].name.empty() ? schema->field(i)->name()
                                            : properties[i].name;
-    auto name_res = StoreArrowArrayAtName(table.column(i), dir, name, desc);
-    if (!name_res) {
-      return name_res.error();
-    }
-    next_paths.emplace_back(name_res.value());
+    arrays.emplace_back(table.column(i), std::move(name));
   }
+  auto stored_res = StoreArrowArraysAtNames(arrays, dir, rdg, desc);
+  if (!stored_res) {
+    return stored_res.error();
+  }
+  std::vector<tsuba::PropStorageInfo> stored = std::move(stored_res.value());
   TSUBA_PTP(tsuba::internal::FaultSensitivity::Normal);
 
-  if (next_paths.empty()) {
+  if (stored.empty()) {
     return properties;
   }
 
   std::vector<tsuba::PropStorageInfo> next_properties = properties;
-  auto it = next_paths.begin();
+  auto it = stored.begin();
   for (auto& v : next_properties) {
     if (v.persist && v.path.empty()) {
-      v.path = *it++;
+      v.path = std::move(it->path);
+      v.row_group_rows = it->row_group_rows;
+      v.file_size = it->file_size;
+      v.footer_size = it->footer_size;
+      v.block_checksums = std::move(it->block_checksums);
+      ++it;
     }
   }
 
@@ -154,16 +495,43 @@ CommitRDG(
   tsuba::RDGMeta new_meta = handle.impl_->rdg_meta().NextVersion(
       comm->Num, policy_id, transposed, lineage);
 
+  // Host 0 stores the meta file along with the writes of every host instead
+  // of after them: readers only see a version once the name server has it,
+  // so nothing refers to the file before the update below, and by then
+  // everything the file refers to is in place
+  std::string curr_s = new_meta.ToJsonString();
+  galois::Uri meta_path = tsuba::RDGMeta::FileName(
+      handle.impl_->rdg_meta().dir(), new_meta.version());
+  if (comm->ID == 0) {
+    TSUBA_PTP(tsuba::internal::FaultSensitivity::High);
+    desc->StartStore(
+        meta_path.string(), reinterpret_cast<const uint8_t*>(curr_s.data()),
+        curr_s.size());
+  }
+
   // wait for all the work we queued to finish
   TSUBA_PTP(tsuba::internal::FaultSensitivity::High);
-  if (auto res = desc->Finish(); !res) {
-    GALOIS_LOG_ERROR("at least one async write failed: {}", res.error());
-    return res.error();
+  galois::Result<void> ret = desc->Finish();
+  if (!ret) {
+    GALOIS_LOG_ERROR(
+        "at least one async write failed (meta file {}): {}", meta_path,
+        ret.error());
   }
   TSUBA_PTP(tsuba::internal::FaultSensitivity::High);
-  comm->Barrier();
 
-  // NS handles MPI coordination
+  // the only point where the hosts wait for each other before the update
+  uint64_t failed = ret ? 0 : 1;
+  if (comm->Allreduce({failed}, galois::CommBackend::ReduceOp::kMax)[0] != 0) {
+    if (!ret) {
+      return ret.error();
+    }
+    GALOIS_LOG_DEBUG("writes of another host failed");
+    return tsuba::ErrorCode::MpiError;
+  }
+
+  // NS handles MPI coordination; the update fails if another commit
+  // published a version after the one this handle has open
+  TSUBA_PTP(tsuba::internal::FaultSensitivity::High);
   if (auto res = tsuba::NS()->Update(
           handle.impl_->rdg_meta().dir(), handle.impl_->rdg_meta().version(),
           new_meta);
@@ -171,32 +539,125 @@ CommitRDG(
     GALOIS_LOG_ERROR(
         "unable to update rdg at {}: {}", handle.impl_->rdg_meta().dir(),
         res.error());
+    tsuba::Metas()->InvalidateMeta(handle.impl_->rdg_meta().dir());
+    return res.error();
   }
+  tsuba::Metas()->PutMeta(handle.impl_->rdg_meta().dir(), new_meta);
 
-  TSUBA_PTP(tsuba::internal::FaultSensitivity::High);
-  galois::Result<void> ret = tsuba::OneHostOnly([&]() -> galois::Result<void> {
-    TSUBA_PTP(tsuba::internal::FaultSensitivity::High);
+  handle.impl_->set_rdg_meta(std::move(new_meta));
+  return galois::ResultSuccess();
+}
 
-    std::string curr_s = new_meta.ToJsonString();
-    auto res = tsuba::FileStore(
-        tsuba::RDGMeta::FileName(
-            handle.impl_->rdg_meta().dir(), new_meta.version())
-            .string(),
-        reinterpret_cast<const uint8_t*>(curr_s.data()), curr_s.size());
-    if (!res) {
-      GALOIS_LOG_ERROR(
-          "CommitRDG future failed {}: {}",
-          tsuba::RDGMeta::FileName(
-              handle.impl_->rdg_meta().dir(), new_meta.version()),
-          res.error());
-      return res.error();
+bool
+IsLoaded(const arrow::Table& table, uint32_t i) {
+  return static_cast<int>(i) < table.num_columns() &&
+         table.column(i)->length() == table.num_rows();
+}
+
+/// Return table with column i replaced by the stored values of properties[i]
+galois::Result<std::shared_ptr<arrow::Table>>
+LoadColumn(
+    const std::shared_ptr<arrow::Table>& table,
+    const std::vector<tsuba::PropStorageInfo>& properties, uint32_t i,
+    const galois::Uri& dir) {
+  if (static_cast<int>(i) >= table->num_columns()) {
+    return tsuba::ErrorCode::InvalidArgument;
+  }
+  const tsuba::PropStorageInfo& prop = properties[i];
+  if (prop.path.empty()) {
+    GALOIS_LOG_DEBUG("property {} has no stored copy to load", prop.name);
+    return tsuba::ErrorCode::InvalidArgument;
+  }
+
+  // LoadTables uses the file sizes recorded for prop
+  auto load_result = tsuba::LoadTables(dir, {prop});
+  if (!load_result) {
+    return load_result.error();
+  }
+  std::shared_ptr<arrow::ChunkedArray> column =
+      load_result.value()[0]->column(0);
+  if (column->length() != table->num_rows()) {
+    GALOIS_LOG_DEBUG(
+        "expected {} rows found {} instead", table->num_rows(),
+        column->length());
+    return tsuba::ErrorCode::InvalidArgument;
+  }
+
+  auto set_result = table->SetColumn(i, table->field(i), column);
+  if (!set_result.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", set_result.status());
+    return tsuba::ErrorCode::ArrowError;
+  }
+  return std::move(set_result.ValueOrDie());
+}
+
+/// Return table with the values of column i dropped
+galois::Result<std::shared_ptr<arrow::Table>>
+UnloadColumn(
+    const std::shared_ptr<arrow::Table>& table,
+    const std::vector<tsuba::PropStorageInfo>& properties, uint32_t i) {
+  if (static_cast<int>(i) >= table->num_columns()) {
+    return tsuba::ErrorCode::InvalidArgument;
+  }
+  if (properties[i].path.empty()) {
+    GALOIS_LOG_DEBUG(
+        "property {} has no stored copy, cannot unload", properties[i].name);
+    return tsuba::ErrorCode::InvalidArgument;
+  }
+
+  // arrow::Table::SetColumn checks lengths, so build the table directly
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns = table->columns();
+  columns[i] = std::make_shared<arrow::ChunkedArray>(
+      arrow::ArrayVector{}, table->field(i)->type());
+  return arrow::Table::Make(table->schema(), columns, table->num_rows());
+}
+
+/// Return properties with their stored paths dropped so that the columns of
+/// replacement, which must have the same schema as table, are written again
+galois::Result<std::vector<tsuba::PropStorageInfo>>
+ReplacedProperties(
+    const arrow::Table& table, const arrow::Table& replacement,
+    const std::vector<tsuba::PropStorageInfo>& properties) {
+  if (!table.schema()->Equals(*replacement.schema())) {
+    GALOIS_LOG_DEBUG(
+        "expected schema {} found {} instead", table.schema()->ToString(),
+        replacement.schema()->ToString());
+    return tsuba::ErrorCode::InvalidArgument;
+  }
+
+  // columns that are the same arrays as before keep their stored copies
+  std::vector<tsuba::PropStorageInfo> next_properties = properties;
+  for (size_t i = 0, n = next_properties.size(); i < n; ++i) {
+    if (table.column(i) != replacement.column(i)) {
+      next_properties[i].path.clear();
     }
-    return galois::ResultSuccess();
-  });
-  if (ret) {
-    handle.impl_->set_rdg_meta(std::move(new_meta));
   }
-  return ret;
+  return next_properties;
+}
+
+/// Return properties with the stored path of property i dropped
+galois::Result<std::vector<tsuba::PropStorageInfo>>
+ModifiedProperties(
+    const std::vector<tsuba::PropStorageInfo>& properties, uint32_t i) {
+  if (i >= properties.size()) {
+    return tsuba::ErrorCode::InvalidArgument;
+  }
+  std::vector<tsuba::PropStorageInfo> next_properties = properties;
+  next_properties[i].path.clear();
+  return next_properties;
+}
+
+/// Bind fv to the whole of path with FileView::BindMapped, skipping the
+/// request for the size of path when the part header recorded it as size,
+/// and verifying the file against checksums if there are any
+galois::Result<void>
+BindMappedSized(
+    tsuba::FileView* fv, const galois::Uri& path, uint64_t size,
+    const std::vector<uint32_t>& checksums) {
+  if (size == 0) {
+    return fv->BindMapped(path.string(), true);
+  }
+  return fv->BindMappedKnownSize(path.string(), size, true, checksums);
 }
 
 }  // namespace
@@ -233,6 +694,17 @@ tsuba::RDGFile::~RDGFile() {
 
 galois::Result<std::vector<tsuba::PropStorageInfo>>
 tsuba::RDG::WritePartArrays(const galois::Uri& dir, tsuba::WriteGroup* desc) {
+  // unchanged since they were loaded or stored, so keep referring to the
+  // stored copies
+  const std::vector<tsuba::PropStorageInfo>& stored =
+      core_->part_header().part_prop_info_list();
+  if (!part_arrays_modified_ &&
+      std::all_of(stored.begin(), stored.end(), [](const auto& prop) {
+        return !prop.path.empty();
+      })) {
+    return stored;
+  }
+
   std::vector<tsuba::PropStorageInfo> next_properties;
 
   GALOIS_LOG_DEBUG(
@@ -241,43 +713,25 @@ tsuba::RDG::WritePartArrays(const galois::Uri& dir, tsuba::WriteGroup* desc) {
       local_to_global_vector_ == nullptr ? 0
                                          : local_to_global_vector_->length());
 
+  IOClassScope io_class(IOClass::kPartHeader);
+
+  std::vector<NamedArray> arrays;
   for (unsigned i = 0; i < mirror_nodes_.size(); ++i) {
-    auto name = MirrorPropName(i);
-    auto mirr_res = StoreArrowArrayAtName(mirror_nodes_[i], dir, name, desc);
-    if (!mirr_res) {
-      return mirr_res.error();
-    }
-    next_properties.emplace_back(tsuba::PropStorageInfo{
-        .name = name,
-        .path = std::move(mirr_res.value()),
-        .persist = true,
-    });
+    arrays.emplace_back(mirror_nodes_[i], MirrorPropName(i));
   }
-
   for (unsigned i = 0; i < master_nodes_.size(); ++i) {
-    auto name = MasterPropName(i);
-    auto mast_res = StoreArrowArrayAtName(master_nodes_[i], dir, name, desc);
-    if (!mast_res) {
-      return mast_res.error();
-    }
-    next_properties.emplace_back(tsuba::PropStorageInfo{
-        .name = name,
-        .path = std::move(mast_res.value()),
-        .persist = true,
-    });
+    arrays.emplace_back(master_nodes_[i], MasterPropName(i));
   }
-
   if (local_to_global_vector_ != nullptr) {
-    auto l2g_res = StoreArrowArrayAtName(
-        local_to_global_vector_, dir, kLocalToTGlobalPropName, desc);
-    if (!l2g_res) {
-      return l2g_res.error();
-    }
-    next_properties.emplace_back(tsuba::PropStorageInfo{
-        .name = kLocalToTGlobalPropName,
-        .path = std::move(l2g_res.value()),
-        .persist = true,
-    });
+    arrays.emplace_back(local_to_global_vector_, kLocalToTGlobalPropName);
+  }
+
+  auto stored_res = StoreArrowArraysAtNames(arrays, dir, *this, desc);
+  if (!stored_res) {
+    return stored_res.error();
+  }
+  for (tsuba::PropStorageInfo& prop : stored_res.value()) {
+    next_properties.emplace_back(std::move(prop));
   }
 
   return next_properties;
@@ -287,6 +741,9 @@ galois::Result<void>
 tsuba::RDG::DoStore(
     RDGHandle handle, const std::string& command_line,
     std::unique_ptr<WriteGroup> write_group) {
+  // count each write by the part of the graph that it stores
+  std::optional<IOClassScope> io_class;
+  io_class.emplace(IOClass::kTopology);
   if (core_->part_header().topology_path().empty()) {
     // No topology file; create one
     galois::Uri t_path = handle.impl_->rdg_meta().dir().RandFile("topology");
@@ -298,12 +755,49 @@ tsuba::RDG::DoStore(
         t_path.string(), core_->topology_file_storage().ptr<uint8_t>(),
         core_->topology_file_storage().size());
     TSUBA_PTP(internal::FaultSensitivity::Normal);
-    core_->part_header().set_topology_path(t_path.BaseName());
+    // checksummed while the store runs
+    core_->part_header().set_topology_path(
+        t_path.BaseName(), core_->topology_file_storage().size(),
+        BlockChecksums(
+            core_->topology_file_storage().ptr<uint8_t>(),
+            core_->topology_file_storage().size()));
   }
 
+  if (core_->part_header().transpose_path().empty() &&
+      core_->transpose_file_storage().Valid()) {
+    galois::Uri t_path = handle.impl_->rdg_meta().dir().RandFile("transpose");
+
+    // depends on `transpose_file_storage_` outliving writes
+    write_group->StartStore(
+        t_path.string(), core_->transpose_file_storage().ptr<uint8_t>(),
+        core_->transpose_file_storage().size());
+    core_->part_header().set_transpose_path(
+        t_path.BaseName(), core_->transpose_file_storage().size(),
+        BlockChecksums(
+            core_->transpose_file_storage().ptr<uint8_t>(),
+            core_->transpose_file_storage().size()));
+  }
+
+  if (core_->part_header().edge_type_index_path().empty() &&
+      core_->edge_type_index_file_storage().Valid()) {
+    galois::Uri t_path =
+        handle.impl_->rdg_meta().dir().RandFile("edge_type_index");
+
+    // depends on `edge_type_index_file_storage_` outliving writes
+    write_group->StartStore(
+        t_path.string(), core_->edge_type_index_file_storage().ptr<uint8_t>(),
+        core_->edge_type_index_file_storage().size());
+    core_->part_header().set_edge_type_index_path(
+        t_path.BaseName(), core_->edge_type_index_file_storage().size(),
+        BlockChecksums(
+            core_->edge_type_index_file_storage().ptr<uint8_t>(),
+            core_->edge_type_index_file_storage().size()));
+  }
+
+  io_class.emplace(IOClass::kNodeProperty);
   auto node_write_result = WriteTable(
       *core_->node_table(), core_->part_header().node_prop_info_list(),
-      handle.impl_->rdg_meta().dir(), write_group.get());
+      handle.impl_->rdg_meta().dir(), *this, write_group.get());
   if (!node_write_result) {
     GALOIS_LOG_DEBUG("failed to write node properties");
     return node_write_result.error();
@@ -313,9 +807,10 @@ tsuba::RDG::DoStore(
   core_->part_header().set_node_prop_info_list(
       std::move(node_write_result.value()));
 
+  io_class.emplace(IOClass::kEdgeProperty);
   auto edge_write_result = WriteTable(
       *core_->edge_table(), core_->part_header().edge_prop_info_list(),
-      handle.impl_->rdg_meta().dir(), write_group.get());
+      handle.impl_->rdg_meta().dir(), *this, write_group.get());
   if (!edge_write_result) {
     GALOIS_LOG_DEBUG("failed to write edge properties");
     return edge_write_result.error();
@@ -324,6 +819,7 @@ tsuba::RDG::DoStore(
   // update edge properties with newly written locations
   core_->part_header().set_edge_prop_info_list(
       std::move(edge_write_result.value()));
+  io_class.reset();
 
   auto part_write_result =
       WritePartArrays(handle.impl_->rdg_meta().dir(), write_group.get());
@@ -334,6 +830,7 @@ tsuba::RDG::DoStore(
   }
   core_->part_header().set_part_properties(
       std::move(part_write_result.value()));
+  part_arrays_modified_ = false;
 
   if (auto write_result = core_->part_header().Write(handle, write_group.get());
       !write_result) {
@@ -354,41 +851,77 @@ tsuba::RDG::DoStore(
 }
 
 galois::Result<void>
-tsuba::RDG::DoMake(const galois::Uri& metadata_dir) {
-  auto node_result = AddTables(
-      metadata_dir, core_->part_header().node_prop_info_list(),
-      [rdg = this](const std::shared_ptr<arrow::Table>& table) {
-        return rdg->core_->AddNodeProperties(table);
+tsuba::RDG::DoMake(const galois::Uri& metadata_dir, bool lazy) {
+  // The topology is mapped while the properties load instead of after them;
+  // it is read from storage whole, often the largest file of the partition
+  galois::Uri t_path = metadata_dir.Join(core_->part_header().topology_path());
+  std::future<galois::Result<void>> topology_future = std::async(
+      std::launch::async, [this, t_path]() -> galois::Result<void> {
+        IOClassScope scope(IOClass::kTopology);
+        return BindMappedSized(
+            &core_->topology_file_storage(), t_path,
+            core_->part_header().topology_size(),
+            core_->part_header().topology_checksums());
       });
-  if (!node_result) {
-    return node_result.error();
-  }
 
-  auto edge_result = AddTables(
-      metadata_dir, core_->part_header().edge_prop_info_list(),
-      [rdg = this](const std::shared_ptr<arrow::Table>& table) {
-        return rdg->core_->AddEdgeProperties(table);
-      });
-  if (!edge_result) {
-    return edge_result.error();
+  std::optional<IOClassScope> io_class;
+  if (lazy) {
+    io_class.emplace(IOClass::kNodeProperty);
+    auto node_result = LoadPlaceholderTables(
+        metadata_dir, core_->part_header().node_prop_info_list());
+    if (!node_result) {
+      return node_result.error();
+    }
+    core_->set_node_table(std::move(node_result.value()));
+
+    io_class.emplace(IOClass::kEdgeProperty);
+    auto edge_result = LoadPlaceholderTables(
+        metadata_dir, core_->part_header().edge_prop_info_list());
+    if (!edge_result) {
+      return edge_result.error();
+    }
+    core_->set_edge_table(std::move(edge_result.value()));
+  } else {
+    io_class.emplace(IOClass::kNodeProperty);
+    auto node_result = AddTables(
+        metadata_dir, core_->part_header().node_prop_info_list(),
+        [rdg = this](const std::shared_ptr<arrow::Table>& table) {
+          return rdg->core_->AddNodeProperties(table);
+        });
+    if (!node_result) {
+      return node_result.error();
+    }
+
+    io_class.emplace(IOClass::kEdgeProperty);
+    auto edge_result = AddTables(
+        metadata_dir, core_->part_header().edge_prop_info_list(),
+        [rdg = this](const std::shared_ptr<arrow::Table>& table) {
+          return rdg->core_->AddEdgeProperties(table);
+        });
+    if (!edge_result) {
+      return edge_result.error();
+    }
   }
 
   const std::vector<PropStorageInfo>& part_prop_info_list =
       core_->part_header().part_prop_info_list();
   if (!part_prop_info_list.empty()) {
+    io_class.emplace(IOClass::kPartHeader);
+    // partition metadata arrays are exposed as ChunkedArrays, so there is no
+    // need to combine their chunks
     auto part_result = AddTables(
         metadata_dir, part_prop_info_list,
         [rdg = this](const std::shared_ptr<arrow::Table>& table) {
           return rdg->AddPartitionMetadataArray(table);
-        });
+        },
+        false);
     if (!part_result) {
-      return edge_result.error();
+      return part_result.error();
     }
   }
+  part_arrays_modified_ = false;
 
-  galois::Uri t_path = metadata_dir.Join(core_->part_header().topology_path());
-  if (auto res = core_->topology_file_storage().Bind(t_path.string(), true);
-      !res) {
+  if (auto res = topology_future.get(); !res) {
     return res.error();
   }
 
@@ -399,7 +932,7 @@ tsuba::RDG::DoMake(const galois::Uri& metadata_dir) {
 galois::Result<tsuba::RDG>
 tsuba::RDG::Make(
     const RDGMeta& meta, const std::vector<std::string>* node_props,
-    const std::vector<std::string>* edge_props) {
+    const std::vector<std::string>* edge_props, bool lazy) {
   if (!meta.IsEmptyRDG() && meta.num_hosts() != Comm()->Num) {
     GALOIS_LOG_ERROR(
         "number of hosts for partitioned graph does not current number of "
@@ -433,7 +966,7 @@ tsuba::RDG::Make(
     return res.error();
   }
 
-  if (auto res = rdg.DoMake(meta.dir()); !res) {
+  if (auto res = rdg.DoMake(meta.dir(), lazy); !res) {
     return res.error();
   }
 
@@ -461,13 +994,25 @@ tsuba::RDG::Make(
     GALOIS_LOG_DEBUG("failed: handle does not allow full read");
     return ErrorCode::InvalidArgument;
   }
-  return RDG::Make(handle.impl_->rdg_meta(), node_props, edge_props);
+  return RDG::Make(handle.impl_->rdg_meta(), node_props, edge_props, false);
+}
+
+galois::Result<tsuba::RDG>
+tsuba::RDG::MakeLazy(
+    RDGHandle handle, const std::vector<std::string>* node_props,
+    const std::vector<std::string>* edge_props) {
+  if (!handle.impl_->AllowsRead()) {
+    GALOIS_LOG_DEBUG("failed: handle does not allow full read");
+    return ErrorCode::InvalidArgument;
+  }
+  return RDG::Make(handle.impl_->rdg_meta(), node_props, edge_props, true);
 }
 
 galois::Result<void>
 tsuba::RDG::Store(
     RDGHandle handle, const std::string& command_line,
-    std::unique_ptr<FileFrame> ff) {
+    std::unique_ptr<FileFrame> ff, std::unique_ptr<FileFrame> transpose_ff,
+    std::unique_ptr<FileFrame> edge_type_index_ff) {
   if (!handle.impl_->AllowsWrite()) {
     GALOIS_LOG_DEBUG("failed: handle does not allow write");
     return ErrorCode::InvalidArgument;
@@ -480,7 +1025,22 @@ tsuba::RDG::Store(
       handle.impl_->rdg_meta().num_hosts(),
       handle.impl_->rdg_meta().policy_id(), tsuba::Comm()->Num,
       core_->part_header().metadata().policy_id_);
-  if (handle.impl_->rdg_meta().dir() != rdg_dir_) {
+  bool new_dir = handle.impl_->rdg_meta().dir() != rdg_dir_;
+  if (new_dir) {
+    // every property is rewritten, so fetch any that were not loaded yet
+    if (auto res = EnsureAllPropertiesLoaded(); !res) {
+      return res.error();
+    }
+    if (!transpose_ff) {
+      if (auto res = EnsureTransposeLoaded(); !res) {
+        return res.error();
+      }
+    }
+    if (!edge_type_index_ff) {
+      if (auto res = EnsureEdgeTypeIndexLoaded(); !res) {
+        return res.error();
+      }
+    }
     core_->part_header().UnbindFromStorage();
   }
 
@@ -491,17 +1051,65 @@ tsuba::RDG::Store(
   // All write buffers must outlive desc
   std::unique_ptr<WriteGroup> desc = std::move(desc_res.value());
 
+  std::optional<IOClassScope> io_class;
+  io_class.emplace(IOClass::kTopology);
   if (ff) {
     galois::Uri t_path = handle.impl_->rdg_meta().dir().RandFile("topology");
 
     ff->Bind(t_path.string());
+    uint64_t size = ff->size();
+    std::vector<uint32_t> checksums = ff->block_checksums();
     TSUBA_PTP(internal::FaultSensitivity::Normal);
     desc->StartStore(std::move(ff));
     TSUBA_PTP(internal::FaultSensitivity::Normal);
-    core_->part_header().set_topology_path(t_path.BaseName());
+    core_->part_header().set_topology_path(
+        t_path.BaseName(), size, std::move(checksums));
   }
 
-  return DoStore(handle, command_line, std::move(desc));
+  if (transpose_ff) {
+    // a previously stored index is stale
+    if (auto res = DropTranspose(); !res) {
+      return res.error();
+    }
+    galois::Uri t_path = handle.impl_->rdg_meta().dir().RandFile("transpose");
+
+    transpose_ff->Bind(t_path.string());
+    uint64_t size = transpose_ff->size();
+    std::vector<uint32_t> checksums = transpose_ff->block_checksums();
+    TSUBA_PTP(internal::FaultSensitivity::Normal);
+    desc->StartStore(std::move(transpose_ff));
+    TSUBA_PTP(internal::FaultSensitivity::Normal);
+    core_->part_header().set_transpose_path(
+        t_path.BaseName(), size, std::move(checksums));
+  }
+
+  if (edge_type_index_ff) {
+    if (auto res = DropEdgeTypeIndex(); !res) {
+      return res.error();
+    }
+    galois::Uri t_path =
+        handle.impl_->rdg_meta().dir().RandFile("edge_type_index");
+
+    edge_type_index_ff->Bind(t_path.string());
+    uint64_t size = edge_type_index_ff->size();
+    std::vector<uint32_t> checksums = edge_type_index_ff->block_checksums();
+    TSUBA_PTP(internal::FaultSensitivity::Normal);
+    desc->StartStore(std::move(edge_type_index_ff));
+    TSUBA_PTP(internal::FaultSensitivity::Normal);
+    core_->part_header().set_edge_type_index_path(
+        t_path.BaseName(), size, std::move(checksums));
+  }
+  io_class.reset();
+
+  if (auto res = DoStore(handle, command_line, std::move(desc)); !res) {
+    return res.error();
+  }
+
+  // stored property paths are now relative to the new location
+  if (new_dir) {
+    rdg_dir_ = handle.impl_->rdg_meta().dir();
+  }
+  return galois::ResultSuccess();
 }
 
 galois::Result<void>
@@ -546,6 +1154,52 @@ tsuba::RDG::AddEdgeProperties(const std::shared_ptr<arrow::Table>& table) {
   return galois::ResultSuccess();
 }
 
+galois::Result<void>
+tsuba::RDG::ReplaceNodeProperties(const std::shared_ptr<arrow::Table>& table) {
+  auto props_result = ReplacedProperties(
+      *core_->node_table(), *table,
+      core_->part_header().node_prop_info_list());
+  if (!props_result) {
+    return props_result.error();
+  }
+  core_->part_header().set_node_prop_info_list(
+      std::move(props_result.value()));
+  core_->set_node_table(std::shared_ptr<arrow::Table>(table));
+  return galois::ResultSuccess();
+}
+
+galois::Result<void>
+tsuba::RDG::ReplaceEdgeProperties(const std::shared_ptr<arrow::Table>& table) {
+  auto props_result = ReplacedProperties(
+      *core_->edge_table(), *table,
+      core_->part_header().edge_prop_info_list());
+  if (!props_result) {
+    return props_result.error();
+  }
+  core_->part_header().set_edge_prop_info_list(
+      std::move(props_result.value()));
+  core_->set_edge_table(std::shared_ptr<arrow::Table>(table));
+  return galois::ResultSuccess();
+}
+
+galois::Result<void>
+tsuba::RDG::RelocateNodeProperties(const std::shared_ptr<arrow::Table>& table) {
+  if (!core_->node_table()->schema()->Equals(*table->schema())) {
+    return ErrorCode::InvalidArgument;
+  }
+  core_->set_node_table(std::shared_ptr<arrow::Table>(table));
+  return galois::ResultSuccess();
+}
+
+galois::Result<void>
+tsuba::RDG::RelocateEdgeProperties(const std::shared_ptr<arrow::Table>& table) {
+  if (!core_->edge_table()->schema()->Equals(*table->schema())) {
+    return ErrorCode::InvalidArgument;
+  }
+  core_->set_edge_table(std::shared_ptr<arrow::Table>(table));
+  return galois::ResultSuccess();
+}
+
 galois::Result<void>
 tsuba::RDG::RemoveNodeProperty(uint32_t i) {
   return core_->RemoveNodeProperty(i);
@@ -556,6 +1210,121 @@ tsuba::RDG::RemoveEdgeProperty(uint32_t i) {
   return core_->RemoveEdgeProperty(i);
 }
 
+bool
+tsuba::RDG::IsNodePropertyLoaded(uint32_t i) const {
+  return IsLoaded(*core_->node_table(), i);
+}
+
+bool
+tsuba::RDG::IsEdgePropertyLoaded(uint32_t i) const {
+  return IsLoaded(*core_->edge_table(), i);
+}
+
+galois::Result<void>
+tsuba::RDG::EnsureNodePropertyLoaded(uint32_t i) const {
+  if (IsNodePropertyLoaded(i)) {
+    return galois::ResultSuccess();
+  }
+  IOClassScope io_class(IOClass::kNodeProperty);
+  auto load_result = LoadColumn(
+      core_->node_table(), core_->part_header().node_prop_info_list(), i,
+      rdg_dir_);
+  if (!load_result) {
+    return load_result.error();
+  }
+  core_->set_node_table(std::move(load_result.value()));
+  return galois::ResultSuccess();
+}
+
+galois::Result<void>
+tsuba::RDG::EnsureEdgePropertyLoaded(uint32_t i) const {
+  if (IsEdgePropertyLoaded(i)) {
+    return galois::ResultSuccess();
+  }
+  IOClassScope io_class(IOClass::kEdgeProperty);
+  auto load_result = LoadColumn(
+      core_->edge_table(), core_->part_header().edge_prop_info_list(), i,
+      rdg_dir_);
+  if (!load_result) {
+    return load_result.error();
+  }
+  core_->set_edge_table(std::move(load_result.value()));
+  return galois::ResultSuccess();
+}
+
+galois::Result<void>
+tsuba::RDG::EnsureAllPropertiesLoaded() const {
+  for (int i = 0, n = core_->node_table()->num_columns(); i < n; ++i) {
+    if (auto res = EnsureNodePropertyLoaded(i); !res) {
+      return res.error();
+    }
+  }
+  for (int i = 0, n = core_->edge_table()->num_columns(); i < n; ++i) {
+    if (auto res = EnsureEdgePropertyLoaded(i); !res) {
+      return res.error();
+    }
+  }
+  return galois::ResultSuccess();
+}
+
+galois::Result<void>
+tsuba::RDG::UnloadNodeProperty(uint32_t i) const {
+  auto unload_result = UnloadColumn(
+      core_->node_table(), core_->part_header().node_prop_info_list(), i);
+  if (!unload_result) {
+    return unload_result.error();
+  }
+  core_->set_node_table(std::move(unload_result.value()));
+  return galois::ResultSuccess();
+}
+
+galois::Result<void>
+tsuba::RDG::UnloadEdgeProperty(uint32_t i) const {
+  auto unload_result = UnloadColumn(
+      core_->edge_table(), core_->part_header().edge_prop_info_list(), i);
+  if (!unload_result) {
+    return unload_result.error();
+  }
+  core_->set_edge_table(std::move(unload_result.value()));
+  return galois::ResultSuccess();
+}
+
+bool
+tsuba::RDG::HasStoredNodeProperty(uint32_t i) const {
+  const auto& properties = core_->part_header().node_prop_info_list();
+  return i < properties.size() && !properties[i].path.empty();
+}
+
+bool
+tsuba::RDG::HasStoredEdgeProperty(uint32_t i) const {
+  const auto& properties = core_->part_header().edge_prop_info_list();
+  return i < properties.size() && !properties[i].path.empty();
+}
+
+galois::Result<void>
+tsuba::RDG::MarkNodePropertyModified(uint32_t i) {
+  auto props_result =
+      ModifiedProperties(core_->part_header().node_prop_info_list(), i);
+  if (!props_result) {
+    return props_result.error();
+  }
+  core_->part_header().set_node_prop_info_list(
+      std::move(props_result.value()));
+  return galois::ResultSuccess();
+}
+
+galois::Result<void>
+tsuba::RDG::MarkEdgePropertyModified(uint32_t i) {
+  auto props_result =
+      ModifiedProperties(core_->part_header().edge_prop_info_list(), i);
+  if (!props_result) {
+    return props_result.error();
+  }
+  core_->part_header().set_edge_prop_info_list(
+      std::move(props_result.value()));
+  return galois::ResultSuccess();
+}
+
 void
 tsuba::RDG::MarkAllPropertiesPersistent() {
   core_->part_header().MarkAllPropertiesPersistent();
@@ -603,6 +1372,103 @@ tsuba::RDG::UnbindTopologyFileStorage() {
   return core_->topology_file_storage().Unbind();
 }
 
+bool
+tsuba::RDG::edges_sorted_by_dest() const {
+  return core_->part_header().edges_sorted_by_dest();
+}
+
+void
+tsuba::RDG::set_edges_sorted_by_dest(bool sorted) {
+  core_->part_header().set_edges_sorted_by_dest(sorted);
+}
+
+const std::string&
+tsuba::RDG::graph_statistics() const {
+  return core_->part_header().graph_statistics();
+}
+
+void
+tsuba::RDG::set_graph_statistics(std::string statistics) {
+  core_->part_header().set_graph_statistics(std::move(statistics));
+}
+
+bool
+tsuba::RDG::HasTranspose() const {
+  return !core_->part_header().transpose_path().empty() ||
+         core_->transpose_file_storage().Valid();
+}
+
+galois::Result<void>
+tsuba::RDG::EnsureTransposeLoaded() const {
+  const std::string& path = core_->part_header().transpose_path();
+  if (path.empty() || core_->transpose_file_storage().Valid()) {
+    return galois::ResultSuccess();
+  }
+  galois::Uri t_path = rdg_dir_.Join(path);
+  IOClassScope io_class(IOClass::kTopology);
+  return BindMappedSized(
+      &core_->transpose_file_storage(), t_path,
+      core_->part_header().transpose_size(),
+      core_->part_header().transpose_checksums());
+}
+
+const tsuba::FileView&
+tsuba::RDG::transpose_file_storage() const {
+  return core_->transpose_file_storage();
+}
+
+galois::Result<void>
+tsuba::RDG::DropTranspose() {
+  core_->part_header().set_transpose_path("");
+  if (!core_->transpose_file_storage().Valid()) {
+    return galois::ResultSuccess();
+  }
+  return core_->transpose_file_storage().Unbind();
+}
+
+bool
+tsuba::RDG::HasEdgeTypeIndex() const {
+  return !core_->part_header().edge_type_index_path().empty() ||
+         core_->edge_type_index_file_storage().Valid();
+}
+
+galois::Result<void>
+tsuba::RDG::EnsureEdgeTypeIndexLoaded() const {
+  const std::string& path = core_->part_header().edge_type_index_path();
+  if (path.empty() || core_->edge_type_index_file_storage().Valid()) {
+    return galois::ResultSuccess();
+  }
+  galois::Uri t_path = rdg_dir_.Join(path);
+  IOClassScope io_class(IOClass::kTopology);
+  return BindMappedSized(
+      &core_->edge_type_index_file_storage(), t_path,
+      core_->part_header().edge_type_index_size(),
+      core_->part_header().edge_type_index_checksums());
+}
+
+const tsuba::FileView&
+tsuba::RDG::edge_type_index_file_storage() const {
+  return core_->edge_type_index_file_storage();
+}
+
+galois::Result<void>
+tsuba::RDG::DropEdgeTypeIndex() {
+  core_->part_header().set_edge_type_index_path("");
+  if (!core_->edge_type_index_file_storage().Valid()) {
+    return galois::ResultSuccess();
+  }
+  return core_->edge_type_index_file_storage().Unbind();
+}
+
+const tsuba::RDG::PropertyEncoding&
+tsuba::RDG::property_encoding(const std::string& name) const {
+  if (auto it = property_encodings_.find(name);
+      it != property_encodings_.end()) {
+    return it->second;
+  }
+  return default_property_encoding_;
+}
+
 tsuba::RDG::RDG(std::unique_ptr<RDGCore>&& core) : core_(std::move(core)) {}
 
 tsuba::RDG::RDG() : core_(std::make_unique<RDGCore>()) {}
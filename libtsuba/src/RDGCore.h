@@ -57,6 +57,18 @@ public:
     topology_file_storage_ = std::move(topology_file_storage);
   }
 
+  const FileView& transpose_file_storage() const {
+    return transpose_file_storage_;
+  }
+  FileView& transpose_file_storage() { return transpose_file_storage_; }
+
+  const FileView& edge_type_index_file_storage() const {
+    return edge_type_index_file_storage_;
+  }
+  FileView& edge_type_index_file_storage() {
+    return edge_type_index_file_storage_;
+  }
+
   const RDGPartHeader& part_header() const { return part_header_; }
   RDGPartHeader& part_header() { return part_header_; }
   void set_part_header(RDGPartHeader&& part_header) {
@@ -74,6 +86,8 @@ private:
   std::shared_ptr<arrow::Table> edge_table_;
 
   FileView topology_file_storage_;
+  FileView transpose_file_storage_;
+  FileView edge_type_index_file_storage_;
 
   RDGPartHeader part_header_;
 };
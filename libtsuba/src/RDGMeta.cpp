@@ -64,14 +64,18 @@ RDGMeta::Make(RDGHandle handle) {
 Result<RDGMeta>
 RDGMeta::Make(const galois::Uri& uri) {
   if (!IsMetaUri(uri)) {
+    MetaCache* cache = Metas();
+    if (auto cached = cache->GetFreshMeta(uri); cached) {
+      return std::move(cached.value());
+    }
     auto ns_res = NS()->Get(uri);
     if (!ns_res) {
       GALOIS_LOG_DEBUG("NS->Get failed: {}", ns_res.error());
+      cache->InvalidateMeta(uri);
       return ns_res.error();
     }
-    if (ns_res) {
-      ns_res.value().dir_ = uri;
-    }
+    ns_res.value().dir_ = uri;
+    cache->PutMeta(uri, ns_res.value());
     return ns_res;
   }
   return MakeFromStorage(uri);
@@ -130,33 +134,42 @@ Result<std::set<std::string>>
 RDGMeta::FileNames() {
   std::set<std::string> fnames{};
   fnames.emplace(FileName().BaseName());
+  std::vector<galois::Uri> partition_paths;
   for (auto i = 0U; i < num_hosts(); ++i) {
     // All other file names are directory-local, so we pass an empty
     // directory instead of handle.impl_->rdg_meta.path for the partition files
     fnames.emplace(PartitionFileName(i, version()));
+    partition_paths.emplace_back(PartitionFileName(dir(), i, version()));
+  }
 
-    auto header_res =
-        RDGPartHeader::Make(PartitionFileName(dir(), i, version()));
-
-    if (!header_res) {
-      GALOIS_LOG_DEBUG(
-          "problem uri: {} host: {} ver: {} : {}", dir(), i, version(),
-          header_res.error());
-    } else {
-      auto header = std::move(header_res.value());
-      for (const auto& node_prop : header.node_prop_info_list()) {
-        fnames.emplace(node_prop.path);
-      }
-      for (const auto& edge_prop : header.edge_prop_info_list()) {
-        fnames.emplace(edge_prop.path);
-      }
-      for (const auto& part_prop : header.part_prop_info_list()) {
-        fnames.emplace(part_prop.path);
-      }
-      // Duplicates eliminated by set
-      fnames.emplace(header.topology_path());
+  auto headers_res = RDGPartHeader::MakeAll(partition_paths);
+  // a partial set would let a collector delete files that are in use
+  if (!headers_res) {
+    GALOIS_LOG_DEBUG(
+        "problem uri: {} ver: {} : {}", dir(), version(), headers_res.error());
+    return headers_res.error();
+  }
+  for (const RDGPartHeader& header : headers_res.value()) {
+    for (const auto& node_prop : header.node_prop_info_list()) {
+      fnames.emplace(node_prop.path);
+    }
+    for (const auto& edge_prop : header.edge_prop_info_list()) {
+      fnames.emplace(edge_prop.path);
+    }
+    for (const auto& part_prop : header.part_prop_info_list()) {
+      fnames.emplace(part_prop.path);
+    }
+    // Duplicates eliminated by set
+    fnames.emplace(header.topology_path());
+    if (!header.transpose_path().empty()) {
+      fnames.emplace(header.transpose_path());
+    }
+    if (!header.edge_type_index_path().empty()) {
+      fnames.emplace(header.edge_type_index_path());
     }
   }
+  // properties that were not stored have no path
+  fnames.erase("");
   return fnames;
 }
 
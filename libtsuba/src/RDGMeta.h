@@ -102,7 +102,8 @@ public:
   std::string ToJsonString() const;
 
   /// Return the set of file names that hold this RDG's data by reading partition files
-  /// Useful to garbage collect unused files
+  /// Useful to garbage collect unused files; fails if a partition file cannot
+  /// be read
   galois::Result<std::set<std::string>> FileNames();
 
   // Required by nlohmann
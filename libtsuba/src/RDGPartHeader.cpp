@@ -1,12 +1,20 @@
 #include "RDGPartHeader.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <future>
+#include <type_traits>
+
 #include "Constants.h"
 #include "GlobalState.h"
 #include "RDGHandleImpl.h"
+#include "galois/Env.h"
 #include "galois/Logging.h"
 #include "tsuba/Errors.h"
 #include "tsuba/FaultTest.h"
 #include "tsuba/FileView.h"
+#include "tsuba/IOStats.h"
 
 template <typename T>
 using Result = galois::Result<T>;
@@ -16,6 +24,16 @@ namespace {
 
 // TODO (witchel) these key are deprecated as part of parquet
 const char* kTopologyPathKey = "kg.v1.topology.path";
+const char* kTransposePathKey = "kg.v1.transpose.path";
+const char* kEdgeTypeIndexPathKey = "kg.v1.edge_type_index.path";
+const char* kTopologySizeKey = "kg.v1.topology.size";
+const char* kTransposeSizeKey = "kg.v1.transpose.size";
+const char* kEdgeTypeIndexSizeKey = "kg.v1.edge_type_index.size";
+const char* kTopologyChecksumsKey = "kg.v1.topology.checksums";
+const char* kTransposeChecksumsKey = "kg.v1.transpose.checksums";
+const char* kEdgeTypeIndexChecksumsKey = "kg.v1.edge_type_index.checksums";
+const char* kEdgesSortedByDestKey = "kg.v1.topology.edges_sorted_by_dest";
+const char* kGraphStatisticsKey = "kg.v1.graph_statistics";
 const char* kNodePropertyPathKey = "kg.v1.node_property.path";
 const char* kNodePropertyNameKey = "kg.v1.node_property.name";
 const char* kEdgePropertyPathKey = "kg.v1.edge_property.path";
@@ -66,6 +84,198 @@ MakeProperties(std::vector<std::string>&& values) {
   return prop_info_list;
 }
 
+/// Builds the binary form of a part header
+class BinaryWriter {
+  std::string out_;
+
+public:
+  template <typename T>
+  void Put(T val) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    out_.append(reinterpret_cast<const char*>(&val), sizeof(val));
+  }
+
+  void PutString(const std::string& str) {
+    Put<uint32_t>(str.size());
+    out_.append(str);
+  }
+
+  /// Writes the persistent properties of props
+  void PutProps(const std::vector<tsuba::PropStorageInfo>& props) {
+    uint32_t num_persistent = std::count_if(
+        props.begin(), props.end(), [](const auto& p) { return p.persist; });
+    Put(num_persistent);
+    for (const auto& prop : props) {
+      if (prop.persist) {
+        PutString(prop.name);
+        PutString(prop.path);
+      }
+    }
+  }
+
+  /// Writes the row group sizes of the persistent properties of props, in
+  /// the order of PutProps
+  void PutRowGroups(const std::vector<tsuba::PropStorageInfo>& props) {
+    for (const auto& prop : props) {
+      if (prop.persist) {
+        Put(prop.row_group_rows);
+      }
+    }
+  }
+
+  /// Writes the file and footer sizes of the persistent properties of props,
+  /// in the order of PutProps
+  void PutFileSizes(const std::vector<tsuba::PropStorageInfo>& props) {
+    for (const auto& prop : props) {
+      if (prop.persist) {
+        Put(prop.file_size);
+        Put(prop.footer_size);
+      }
+    }
+  }
+
+  void PutChecksums(const std::vector<uint32_t>& checksums) {
+    Put<uint64_t>(checksums.size());
+    out_.append(
+        reinterpret_cast<const char*>(checksums.data()),
+        checksums.size() * sizeof(uint32_t));
+  }
+
+  /// Writes the block checksums of the persistent properties of props, in
+  /// the order of PutProps
+  void PutChecksums(const std::vector<tsuba::PropStorageInfo>& props) {
+    for (const auto& prop : props) {
+      if (prop.persist) {
+        PutChecksums(prop.block_checksums);
+      }
+    }
+  }
+
+  std::string Finish() { return std::move(out_); }
+};
+
+/// Reads the binary form of a part header in place; every Get fails once
+/// the input runs out
+class BinaryReader {
+  const char* cur_;
+  const char* end_;
+
+public:
+  BinaryReader(const char* begin, const char* end) : cur_(begin), end_(end) {}
+
+  template <typename T>
+  bool Get(T* val) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    if (static_cast<size_t>(end_ - cur_) < sizeof(T)) {
+      return false;
+    }
+    std::memcpy(val, cur_, sizeof(T));
+    cur_ += sizeof(T);
+    return true;
+  }
+
+  bool GetString(std::string* str) {
+    uint32_t size = 0;
+    if (!Get(&size) || static_cast<size_t>(end_ - cur_) < size) {
+      return false;
+    }
+    str->assign(cur_, size);
+    cur_ += size;
+    return true;
+  }
+
+  bool GetProps(std::vector<tsuba::PropStorageInfo>* props) {
+    uint32_t num_props = 0;
+    // each property takes at least its two string sizes
+    if (!Get(&num_props) ||
+        static_cast<size_t>(end_ - cur_) / (2 * sizeof(uint32_t)) <
+            num_props) {
+      return false;
+    }
+    props->resize(num_props);
+    for (auto& prop : *props) {
+      if (!GetString(&prop.name) || !GetString(&prop.path)) {
+        return false;
+      }
+      prop.persist = true;
+    }
+    return true;
+  }
+
+  bool GetRowGroups(std::vector<tsuba::PropStorageInfo>* props) {
+    for (auto& prop : *props) {
+      if (!Get(&prop.row_group_rows)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool GetFileSizes(std::vector<tsuba::PropStorageInfo>* props) {
+    for (auto& prop : *props) {
+      if (!Get(&prop.file_size) || !Get(&prop.footer_size)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool GetChecksums(std::vector<uint32_t>* checksums) {
+    uint64_t num_checksums = 0;
+    if (!Get(&num_checksums) ||
+        static_cast<size_t>(end_ - cur_) / sizeof(uint32_t) < num_checksums) {
+      return false;
+    }
+    checksums->resize(num_checksums);
+    std::memcpy(checksums->data(), cur_, num_checksums * sizeof(uint32_t));
+    cur_ += num_checksums * sizeof(uint32_t);
+    return true;
+  }
+
+  bool GetChecksums(std::vector<tsuba::PropStorageInfo>* props) {
+    for (auto& prop : *props) {
+      if (!GetChecksums(&prop.block_checksums)) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+/// The most part headers that MakeAll fetches at once
+constexpr uint32_t kPartHeaderFetchConcurrency = 16;
+
+/// Parquet files start with these bytes
+constexpr std::string_view kParquetMagic = "PAR1";
+
+bool
+IsBinaryPartHeader(const tsuba::FileView& fv) {
+  uint32_t magic = 0;
+  if (fv.size() < sizeof(magic)) {
+    return false;
+  }
+  std::memcpy(&magic, fv.ptr<char>(), sizeof(magic));
+  return magic == tsuba::kPartHeaderMagicNo;
+}
+
+/// Whether fv holds a deprecated part header in the metadata of a parquet
+/// file, which is then not worth parsing as JSON first
+bool
+IsParquetPartHeader(const tsuba::FileView& fv) {
+  return fv.size() >= kParquetMagic.size() &&
+         std::string_view(fv.ptr<char>(), kParquetMagic.size()) ==
+             kParquetMagic;
+}
+
+/// Whether to write part headers in the JSON form that versions before the
+/// binary form can read
+bool
+WriteJsonPartHeaders() {
+  bool json = false;
+  galois::GetEnv("GALOIS_TSUBA_JSON_PART_HEADERS", &json);
+  return json;
+}
+
 }  // namespace
 
 namespace tsuba {
@@ -171,32 +381,171 @@ RDGPartHeader::MakeParquet(const galois::Uri& partition_path) {
 }
 
 galois::Result<RDGPartHeader>
-RDGPartHeader::MakeJson(const galois::Uri& partition_path) {
-  tsuba::FileView fv;
-  if (auto res = fv.Bind(partition_path.string(), true); !res) {
-    return res.error();
-  }
-  if (fv.size() == 0) {
-    return tsuba::RDGPartHeader();
-  }
-
+RDGPartHeader::MakeJson(FileView* fv) {
   tsuba::RDGPartHeader header;
-  auto json_res = galois::JsonParse<tsuba::RDGPartHeader>(fv, &header);
+  auto json_res = galois::JsonParse<tsuba::RDGPartHeader>(*fv, &header);
   if (!json_res) {
     return json_res.error();
   }
   return header;
 }
 
+galois::Result<RDGPartHeader>
+RDGPartHeader::MakeBinary(const FileView& fv) {
+  BinaryReader reader(fv.ptr<char>(), fv.ptr<char>() + fv.size());
+
+  uint32_t magic = 0;
+  uint32_t format_version = 0;
+  if (!reader.Get(&magic) || !reader.Get(&format_version) ||
+      magic != kPartHeaderMagicNo) {
+    return ErrorCode::InvalidArgument;
+  }
+  if (format_version > kPartHeaderFormatVersion) {
+    GALOIS_LOG_ERROR(
+        "part header format version {} is newer than this reader ({})",
+        format_version, kPartHeaderFormatVersion);
+    return ErrorCode::InvalidArgument;
+  }
+
+  RDGPartHeader header;
+  PartitionMetadata& md = header.metadata_;
+  uint8_t edges_sorted_by_dest = 0;
+  bool ok = reader.GetString(&header.topology_path_) &&
+            reader.GetString(&header.transpose_path_) &&
+            reader.Get(&edges_sorted_by_dest) &&
+            reader.GetProps(&header.node_prop_info_list_) &&
+            reader.GetProps(&header.edge_prop_info_list_) &&
+            reader.GetProps(&header.part_prop_info_list_) &&
+            reader.Get(&md.policy_id_) && reader.Get(&md.transposed_) &&
+            reader.Get(&md.is_outgoing_edge_cut_) &&
+            reader.Get(&md.is_incoming_edge_cut_) &&
+            reader.Get(&md.num_global_nodes_) &&
+            reader.Get(&md.num_global_edges_) && reader.Get(&md.num_edges_) &&
+            reader.Get(&md.num_nodes_) && reader.Get(&md.num_owned_) &&
+            reader.Get(&md.num_nodes_with_edges_) &&
+            reader.Get(&md.cartesian_grid_.first) &&
+            reader.Get(&md.cartesian_grid_.second);
+  // appended in version 2
+  if (ok && format_version >= 2) {
+    ok = reader.GetString(&header.edge_type_index_path_);
+  }
+  // appended in version 3
+  if (ok && format_version >= 3) {
+    ok = reader.GetString(&header.graph_statistics_);
+  }
+  // appended in version 4
+  if (ok && format_version >= 4) {
+    ok = reader.GetRowGroups(&header.node_prop_info_list_) &&
+         reader.GetRowGroups(&header.edge_prop_info_list_) &&
+         reader.GetRowGroups(&header.part_prop_info_list_);
+  }
+  // appended in version 5
+  if (ok && format_version >= 5) {
+    ok = reader.Get(&header.topology_size_) &&
+         reader.Get(&header.transpose_size_) &&
+         reader.Get(&header.edge_type_index_size_) &&
+         reader.GetFileSizes(&header.node_prop_info_list_) &&
+         reader.GetFileSizes(&header.edge_prop_info_list_) &&
+         reader.GetFileSizes(&header.part_prop_info_list_);
+  }
+  // appended in version 6
+  if (ok && format_version >= 6) {
+    ok = reader.GetChecksums(&header.topology_checksums_) &&
+         reader.GetChecksums(&header.transpose_checksums_) &&
+         reader.GetChecksums(&header.edge_type_index_checksums_) &&
+         reader.GetChecksums(&header.node_prop_info_list_) &&
+         reader.GetChecksums(&header.edge_prop_info_list_) &&
+         reader.GetChecksums(&header.part_prop_info_list_);
+  }
+  if (!ok) {
+    GALOIS_LOG_DEBUG("failed: binary part header is truncated");
+    return ErrorCode::InvalidArgument;
+  }
+  header.edges_sorted_by_dest_ = edges_sorted_by_dest != 0;
+  return header;
+}
+
+std::string
+RDGPartHeader::ToBinary() const {
+  BinaryWriter writer;
+  writer.Put(kPartHeaderMagicNo);
+  writer.Put(kPartHeaderFormatVersion);
+  writer.PutString(topology_path_);
+  writer.PutString(transpose_path_);
+  writer.Put<uint8_t>(edges_sorted_by_dest_);
+  writer.PutProps(node_prop_info_list_);
+  writer.PutProps(edge_prop_info_list_);
+  writer.PutProps(part_prop_info_list_);
+  writer.Put(metadata_.policy_id_);
+  writer.Put(metadata_.transposed_);
+  writer.Put(metadata_.is_outgoing_edge_cut_);
+  writer.Put(metadata_.is_incoming_edge_cut_);
+  writer.Put(metadata_.num_global_nodes_);
+  writer.Put(metadata_.num_global_edges_);
+  writer.Put(metadata_.num_edges_);
+  writer.Put(metadata_.num_nodes_);
+  writer.Put(metadata_.num_owned_);
+  writer.Put(metadata_.num_nodes_with_edges_);
+  writer.Put(metadata_.cartesian_grid_.first);
+  writer.Put(metadata_.cartesian_grid_.second);
+  writer.PutString(edge_type_index_path_);
+  writer.PutString(graph_statistics_);
+  writer.PutRowGroups(node_prop_info_list_);
+  writer.PutRowGroups(edge_prop_info_list_);
+  writer.PutRowGroups(part_prop_info_list_);
+  writer.Put(topology_size_);
+  writer.Put(transpose_size_);
+  writer.Put(edge_type_index_size_);
+  writer.PutFileSizes(node_prop_info_list_);
+  writer.PutFileSizes(edge_prop_info_list_);
+  writer.PutFileSizes(part_prop_info_list_);
+  writer.PutChecksums(topology_checksums_);
+  writer.PutChecksums(transpose_checksums_);
+  writer.PutChecksums(edge_type_index_checksums_);
+  writer.PutChecksums(node_prop_info_list_);
+  writer.PutChecksums(edge_prop_info_list_);
+  writer.PutChecksums(part_prop_info_list_);
+  return writer.Finish();
+}
+
 galois::Result<RDGPartHeader>
 RDGPartHeader::Make(const galois::Uri& partition_path) {
-  galois::Result<RDGPartHeader> res = MakeJson(partition_path);
-  if (res) {
-    return res;
+  MetaCache* cache = Metas();
+  if (auto cached = cache->GetPartHeader(partition_path.string()); cached) {
+    return std::move(cached.value());
+  }
+
+  IOClassScope io_class(IOClass::kPartHeader);
+  tsuba::FileView fv;
+  if (auto res = fv.Bind(partition_path.string(), true); !res) {
+    GALOIS_LOG_DEBUG(
+        "cannot open {}: {}", partition_path.string(), res.error());
+    return res.error();
+  }
+  if (fv.size() == 0) {
+    return tsuba::RDGPartHeader();
   }
 
-  GALOIS_LOG_ERROR("failed to parse JSON RDGPartHeader: {}", res.error());
-  GALOIS_LOG_ERROR("falling back on Parquet (deprecated)");
+  bool binary = IsBinaryPartHeader(fv);
+  if (!binary && IsParquetPartHeader(fv)) {
+    GALOIS_LOG_WARN(
+        "{} is a Parquet RDGPartHeader (deprecated)", partition_path.string());
+  } else {
+    galois::Result<RDGPartHeader> res =
+        binary ? MakeBinary(fv) : MakeJson(&fv);
+    if (res) {
+      cache->PutPartHeader(partition_path.string(), res.value());
+      return res;
+    }
+    if (binary) {
+      GALOIS_LOG_ERROR(
+          "failed to parse binary RDGPartHeader: {}", res.error());
+      return res.error();
+    }
+
+    GALOIS_LOG_ERROR("failed to parse JSON RDGPartHeader: {}", res.error());
+    GALOIS_LOG_ERROR("falling back on Parquet (deprecated)");
+  }
 
   try {
     return MakeParquet(partition_path);
@@ -206,17 +555,57 @@ RDGPartHeader::Make(const galois::Uri& partition_path) {
   }
 }
 
-Result<void>
-RDGPartHeader::Write(RDGHandle handle, WriteGroup* writes) const {
-  auto serialized_res = galois::JsonDump(*this);
-  if (!serialized_res) {
-    return serialized_res.error();
+Result<std::vector<RDGPartHeader>>
+RDGPartHeader::MakeAll(const std::vector<galois::Uri>& partition_paths) {
+  std::vector<RDGPartHeader> headers(partition_paths.size());
+  std::atomic<size_t> next{0};
+  // every fetch is one round trip, so they are spread over workers rather
+  // than issued one after another
+  auto worker = [&]() -> Result<void> {
+    for (size_t i = next++; i < partition_paths.size(); i = next++) {
+      auto res = Make(partition_paths[i]);
+      if (!res) {
+        next = partition_paths.size();
+        return res.error();
+      }
+      headers[i] = std::move(res.value());
+    }
+    return galois::ResultSuccess();
+  };
+
+  size_t num_workers =
+      std::min<size_t>(partition_paths.size(), kPartHeaderFetchConcurrency);
+  std::vector<std::future<Result<void>>> workers;
+  for (size_t i = 1; i < num_workers; ++i) {
+    workers.emplace_back(std::async(std::launch::async, worker));
   }
 
-  std::string serialized = std::move(serialized_res.value());
+  Result<void> ret = worker();
+  for (auto& w : workers) {
+    if (auto res = w.get(); !res && ret) {
+      ret = res.error();
+    }
+  }
+  if (!ret) {
+    return ret.error();
+  }
+  return headers;
+}
 
-  // POSIX files end with newlines
-  serialized = serialized + "\n";
+Result<void>
+RDGPartHeader::Write(RDGHandle handle, WriteGroup* writes) const {
+  IOClassScope io_class(IOClass::kPartHeader);
+  std::string serialized;
+  if (WriteJsonPartHeaders()) {
+    auto serialized_res = galois::JsonDump(*this);
+    if (!serialized_res) {
+      return serialized_res.error();
+    }
+    // POSIX files end with newlines
+    serialized = std::move(serialized_res.value()) + "\n";
+  } else {
+    serialized = ToBinary();
+  }
 
   TSUBA_PTP(internal::FaultSensitivity::Normal);
   auto ff = std::make_unique<FileFrame>();
@@ -311,6 +700,18 @@ RDGPartHeader::Validate() const {
         topology_path_);
     return ErrorCode::InvalidArgument;
   }
+  if (transpose_path_.find('/') != std::string::npos) {
+    GALOIS_LOG_DEBUG(
+        "failed: transpose_path doesn't contain a slash: \"{}\"",
+        transpose_path_);
+    return ErrorCode::InvalidArgument;
+  }
+  if (edge_type_index_path_.find('/') != std::string::npos) {
+    GALOIS_LOG_DEBUG(
+        "failed: edge_type_index_path doesn't contain a slash: \"{}\"",
+        edge_type_index_path_);
+    return ErrorCode::InvalidArgument;
+  }
   return galois::ResultSuccess();
 }
 
@@ -338,6 +739,9 @@ RDGPartHeader::MarkNodePropertiesPersistent(
     if (!persist_node_props[i].empty()) {
       node_prop_info_list_[i].name = persist_node_props[i];
       node_prop_info_list_[i].path = "";
+      node_prop_info_list_[i].file_size = 0;
+      node_prop_info_list_[i].footer_size = 0;
+      node_prop_info_list_[i].block_checksums.clear();
       node_prop_info_list_[i].persist = true;
       GALOIS_LOG_DEBUG("node persist {}", node_prop_info_list_[i].name);
     }
@@ -358,6 +762,9 @@ RDGPartHeader::MarkEdgePropertiesPersistent(
     if (!persist_edge_props[i].empty()) {
       edge_prop_info_list_[i].name = persist_edge_props[i];
       edge_prop_info_list_[i].path = "";
+      edge_prop_info_list_[i].file_size = 0;
+      edge_prop_info_list_[i].footer_size = 0;
+      edge_prop_info_list_[i].block_checksums.clear();
       edge_prop_info_list_[i].persist = true;
       GALOIS_LOG_DEBUG("edge persist {}", edge_prop_info_list_[i].name);
     }
@@ -369,14 +776,31 @@ void
 RDGPartHeader::UnbindFromStorage() {
   for (PropStorageInfo& prop : node_prop_info_list_) {
     prop.path = "";
+    prop.file_size = 0;
+    prop.footer_size = 0;
+    prop.block_checksums.clear();
   }
   for (PropStorageInfo& prop : edge_prop_info_list_) {
     prop.path = "";
+    prop.file_size = 0;
+    prop.footer_size = 0;
+    prop.block_checksums.clear();
   }
   for (PropStorageInfo& prop : part_prop_info_list_) {
     prop.path = "";
+    prop.file_size = 0;
+    prop.footer_size = 0;
+    prop.block_checksums.clear();
   }
   topology_path_ = "";
+  transpose_path_ = "";
+  edge_type_index_path_ = "";
+  topology_size_ = 0;
+  transpose_size_ = 0;
+  edge_type_index_size_ = 0;
+  topology_checksums_.clear();
+  transpose_checksums_.clear();
+  edge_type_index_checksums_.clear();
 }
 
 }  // namespace tsuba
@@ -401,6 +825,36 @@ tsuba::to_json(json& j, const tsuba::RDGPartHeader& header) {
       {kPartPropertyFilesKey, header.part_prop_info_list_},
       {kPartProperyMetaKey, header.metadata_},
   };
+  if (!header.transpose_path_.empty()) {
+    j[kTransposePathKey] = header.transpose_path_;
+  }
+  if (!header.edge_type_index_path_.empty()) {
+    j[kEdgeTypeIndexPathKey] = header.edge_type_index_path_;
+  }
+  if (header.topology_size_ != 0) {
+    j[kTopologySizeKey] = header.topology_size_;
+  }
+  if (header.transpose_size_ != 0) {
+    j[kTransposeSizeKey] = header.transpose_size_;
+  }
+  if (header.edge_type_index_size_ != 0) {
+    j[kEdgeTypeIndexSizeKey] = header.edge_type_index_size_;
+  }
+  if (!header.topology_checksums_.empty()) {
+    j[kTopologyChecksumsKey] = header.topology_checksums_;
+  }
+  if (!header.transpose_checksums_.empty()) {
+    j[kTransposeChecksumsKey] = header.transpose_checksums_;
+  }
+  if (!header.edge_type_index_checksums_.empty()) {
+    j[kEdgeTypeIndexChecksumsKey] = header.edge_type_index_checksums_;
+  }
+  if (header.edges_sorted_by_dest_) {
+    j[kEdgesSortedByDestKey] = true;
+  }
+  if (!header.graph_statistics_.empty()) {
+    j[kGraphStatisticsKey] = header.graph_statistics_;
+  }
 }
 
 void
@@ -410,6 +864,37 @@ tsuba::from_json(const json& j, tsuba::RDGPartHeader& header) {
   j.at(kEdgePropertyKey).get_to(header.edge_prop_info_list_);
   j.at(kPartPropertyFilesKey).get_to(header.part_prop_info_list_);
   j.at(kPartProperyMetaKey).get_to(header.metadata_);
+  // optional; absent in headers written by older versions
+  if (auto it = j.find(kTransposePathKey); it != j.end()) {
+    it->get_to(header.transpose_path_);
+  }
+  if (auto it = j.find(kEdgeTypeIndexPathKey); it != j.end()) {
+    it->get_to(header.edge_type_index_path_);
+  }
+  if (auto it = j.find(kTopologySizeKey); it != j.end()) {
+    it->get_to(header.topology_size_);
+  }
+  if (auto it = j.find(kTransposeSizeKey); it != j.end()) {
+    it->get_to(header.transpose_size_);
+  }
+  if (auto it = j.find(kEdgeTypeIndexSizeKey); it != j.end()) {
+    it->get_to(header.edge_type_index_size_);
+  }
+  if (auto it = j.find(kTopologyChecksumsKey); it != j.end()) {
+    it->get_to(header.topology_checksums_);
+  }
+  if (auto it = j.find(kTransposeChecksumsKey); it != j.end()) {
+    it->get_to(header.transpose_checksums_);
+  }
+  if (auto it = j.find(kEdgeTypeIndexChecksumsKey); it != j.end()) {
+    it->get_to(header.edge_type_index_checksums_);
+  }
+  if (auto it = j.find(kEdgesSortedByDestKey); it != j.end()) {
+    it->get_to(header.edges_sorted_by_dest_);
+  }
+  if (auto it = j.find(kGraphStatisticsKey); it != j.end()) {
+    it->get_to(header.graph_statistics_);
+  }
 }
 
 void
@@ -455,12 +940,40 @@ void
 tsuba::from_json(const nlohmann::json& j, tsuba::PropStorageInfo& propmd) {
   j.at(0).get_to(propmd.name);
   j.at(1).get_to(propmd.path);
+  // optional; absent in headers written by older versions
+  if (j.size() > 2) {
+    j.at(2).get_to(propmd.row_group_rows);
+  }
+  if (j.size() > 4) {
+    j.at(3).get_to(propmd.file_size);
+    j.at(4).get_to(propmd.footer_size);
+  }
+  if (j.size() > 5) {
+    j.at(5).get_to(propmd.block_checksums);
+  }
+  // stored properties stay in later versions, referred to by path until
+  // they are modified
+  propmd.persist = true;
 }
 
 void
 tsuba::to_json(json& j, const tsuba::PropStorageInfo& propmd) {
   if (propmd.persist) {
     j = json{propmd.name, propmd.path};
+    // optional elements are positional, so the ones before a present one
+    // are written too
+    bool checksums = !propmd.block_checksums.empty();
+    bool sizes = propmd.file_size != 0 || checksums;
+    if (propmd.row_group_rows != 0 || sizes) {
+      j.push_back(propmd.row_group_rows);
+    }
+    if (sizes) {
+      j.push_back(propmd.file_size);
+      j.push_back(propmd.footer_size);
+    }
+    if (checksums) {
+      j.push_back(propmd.block_checksums);
+    }
   }
   // creates a null value if property wasn't supposed to be persisted
 }
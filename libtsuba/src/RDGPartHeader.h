@@ -15,16 +15,37 @@
 
 namespace tsuba {
 
+class FileView;
+
 struct PropStorageInfo {
   std::string name;
   std::string path;
   bool persist{false};
+  /// The number of rows of each row group of the stored file but the last:
+  /// row group i holds rows [i * row_group_rows, (i + 1) * row_group_rows).
+  /// 0 if unknown, e.g., for files written by older versions, which have a
+  /// single row group.
+  uint64_t row_group_rows{0};
+  /// The size of the stored file and of its parquet footer, the metadata and
+  /// the 8 byte trailer that ends the file, which save asking storage for
+  /// them when the file is read. 0 if unknown, e.g., for files written by
+  /// older versions.
+  uint64_t file_size{0};
+  uint64_t footer_size{0};
+  /// The CRC32C of each block of the stored file, which its fetched bytes
+  /// are verified against; empty if unknown
+  std::vector<uint32_t> block_checksums;
 };
 
 class GALOIS_EXPORT RDGPartHeader {
 public:
   static galois::Result<RDGPartHeader> Make(const galois::Uri& partition_path);
 
+  /// Make the headers of partition_paths concurrently; the headers are in the
+  /// order of partition_paths
+  static galois::Result<std::vector<RDGPartHeader>> MakeAll(
+      const std::vector<galois::Uri>& partition_paths);
+
   galois::Result<void> Validate() const;
 
   galois::Result<void> PrunePropsTo(
@@ -75,8 +96,64 @@ public:
   // Accessors/Mutators
   //
 
+  /// The topology files are set with their sizes, which save asking storage
+  /// for them when the files are read, and the checksums of their blocks
+  /// (\see PropStorageInfo); a size of 0 or no checksums is unknown, e.g.,
+  /// for files written by older versions
   const std::string& topology_path() const { return topology_path_; }
-  void set_topology_path(std::string path) { topology_path_ = std::move(path); }
+  uint64_t topology_size() const { return topology_size_; }
+  const std::vector<uint32_t>& topology_checksums() const {
+    return topology_checksums_;
+  }
+  void set_topology_path(
+      std::string path, uint64_t size = 0,
+      std::vector<uint32_t> checksums = {}) {
+    topology_path_ = std::move(path);
+    topology_size_ = size;
+    topology_checksums_ = std::move(checksums);
+  }
+
+  /// The optional file holding the in-edges of the topology; empty if there
+  /// is none
+  const std::string& transpose_path() const { return transpose_path_; }
+  uint64_t transpose_size() const { return transpose_size_; }
+  const std::vector<uint32_t>& transpose_checksums() const {
+    return transpose_checksums_;
+  }
+  void set_transpose_path(
+      std::string path, uint64_t size = 0,
+      std::vector<uint32_t> checksums = {}) {
+    transpose_path_ = std::move(path);
+    transpose_size_ = size;
+    transpose_checksums_ = std::move(checksums);
+  }
+
+  /// The optional file holding an index of the edges of the topology by
+  /// type; empty if there is none
+  const std::string& edge_type_index_path() const {
+    return edge_type_index_path_;
+  }
+  uint64_t edge_type_index_size() const { return edge_type_index_size_; }
+  const std::vector<uint32_t>& edge_type_index_checksums() const {
+    return edge_type_index_checksums_;
+  }
+  void set_edge_type_index_path(
+      std::string path, uint64_t size = 0,
+      std::vector<uint32_t> checksums = {}) {
+    edge_type_index_path_ = std::move(path);
+    edge_type_index_size_ = size;
+    edge_type_index_checksums_ = std::move(checksums);
+  }
+
+  /// Whether the edges of each node in the topology are sorted by destination
+  bool edges_sorted_by_dest() const { return edges_sorted_by_dest_; }
+  void set_edges_sorted_by_dest(bool sorted) { edges_sorted_by_dest_ = sorted; }
+
+  /// Statistics of the graph serialized by their owner; empty if none
+  const std::string& graph_statistics() const { return graph_statistics_; }
+  void set_graph_statistics(std::string statistics) {
+    graph_statistics_ = std::move(statistics);
+  }
 
   const std::vector<PropStorageInfo>& node_prop_info_list() const {
     return node_prop_info_list_;
@@ -108,11 +185,18 @@ public:
   friend void from_json(const nlohmann::json& j, RDGPartHeader& header);
 
 private:
-  static galois::Result<RDGPartHeader> MakeJson(
-      const galois::Uri& partition_path);
+  static galois::Result<RDGPartHeader> MakeJson(FileView* fv);
+  /// Parses the binary form (\see ToBinary) straight from the bytes of fv
+  static galois::Result<RDGPartHeader> MakeBinary(const FileView& fv);
   static galois::Result<RDGPartHeader> MakeParquet(
       const galois::Uri& partition_path);
 
+  /// The binary form of the header: kPartHeaderMagicNo, the format
+  /// version, then the fields as fixed-width little-endian integers and
+  /// length-prefixed strings. Like the JSON form it only has the persistent
+  /// properties.
+  std::string ToBinary() const;
+
   std::vector<PropStorageInfo> part_prop_info_list_;
   std::vector<PropStorageInfo> node_prop_info_list_;
   std::vector<PropStorageInfo> edge_prop_info_list_;
@@ -121,6 +205,16 @@ private:
   PartitionMetadata metadata_;
 
   std::string topology_path_;
+  std::string transpose_path_;
+  std::string edge_type_index_path_;
+  uint64_t topology_size_{0};
+  uint64_t transpose_size_{0};
+  uint64_t edge_type_index_size_{0};
+  std::vector<uint32_t> topology_checksums_;
+  std::vector<uint32_t> transpose_checksums_;
+  std::vector<uint32_t> edge_type_index_checksums_;
+  bool edges_sorted_by_dest_{false};
+  std::string graph_statistics_;
 };
 
 void to_json(nlohmann::json& j, const RDGPartHeader& header);
@@ -4,6 +4,7 @@
 #include "RDGPartHeader.h"
 #include "galois/Result.h"
 #include "tsuba/Errors.h"
+#include "tsuba/IOStats.h"
 #include "tsuba/file.h"
 
 namespace tsuba {
@@ -21,6 +22,7 @@ RDGPrefix::DoMakePrefix(const tsuba::RDGMeta& meta) {
   }
 
   galois::Uri t_path = meta.dir().Join(part_header.topology_path());
+  IOClassScope io_class(IOClass::kTopology);
 
   RDGPrefix::GRHeader gr_header;
   if (auto res = FileGet(t_path.string(), &gr_header); !res) {
@@ -30,17 +32,21 @@ RDGPrefix::DoMakePrefix(const tsuba::RDGMeta& meta) {
     return res.error();
   }
   FileView fv;
-  if (auto res = fv.Bind(
-          t_path.string(),
-          sizeof(gr_header) + (gr_header.num_nodes * sizeof(uint64_t)), true);
+  uint64_t prefix_size =
+      sizeof(gr_header) + (gr_header.num_nodes * sizeof(uint64_t));
+  // the size recorded in the part header saves asking storage for it
+  uint64_t topology_size = part_header.topology_size();
+  if (auto res = topology_size == 0
+                     ? fv.Bind(t_path.string(), prefix_size, true)
+                     : fv.BindKnownSize(
+                           t_path.string(), topology_size, 0, prefix_size,
+                           true, part_header.topology_checksums());
       !res) {
     GALOIS_LOG_DEBUG("FileView bind failed: {}: {}", t_path, res.error());
     return res.error();
   }
 
-  return RDGPrefix(
-      std::move(fv),
-      sizeof(gr_header) + (gr_header.num_nodes * sizeof(uint64_t)));
+  return RDGPrefix(std::move(fv), prefix_size);
 }
 
 galois::Result<tsuba::RDGPrefix>
@@ -1,10 +1,52 @@
 #include "tsuba/RDGSlice.h"
 
+#include <algorithm>
+#include <cstring>
+#include <optional>
+
 #include "AddTables.h"
+#include "GlobalState.h"
 #include "RDGCore.h"
 #include "RDGHandleImpl.h"
 #include "galois/Logging.h"
 #include "tsuba/Errors.h"
+#include "tsuba/IOStats.h"
+#include "tsuba/RDGPrefix.h"
+
+namespace {
+
+/// version, edge_type_size, num_nodes, num_edges
+constexpr uint64_t kTopologyHeaderSize = 4 * sizeof(uint64_t);
+/// The only topology format whose destinations can be read by edge range
+constexpr uint64_t kSliceableTopologyVersion = 1;
+
+/// Returns the num_slices + 1 node boundaries of the slices: slice i has
+/// the nodes [cuts[i], cuts[i + 1])
+std::vector<uint64_t>
+EdgeBalancedCuts(const tsuba::RDGPrefix& prefix, uint32_t num_slices) {
+  uint64_t num_nodes = prefix.num_nodes();
+  uint64_t num_edges = prefix.num_edges();
+  const uint64_t* out_indexes = prefix.out_indexes();
+
+  std::vector<uint64_t> cuts(num_slices + 1, num_nodes);
+  cuts[0] = 0;
+  for (uint32_t i = 1; i < num_slices; ++i) {
+    // out_indexes[n] is one past the last edge of n, so the slice ends after
+    // the last node whose edges all come before the target
+    uint64_t target = (num_edges * i + num_slices - 1) / num_slices;
+    cuts[i] = std::upper_bound(out_indexes, out_indexes + num_nodes, target) -
+              out_indexes;
+    cuts[i] = std::max(cuts[i], cuts[i - 1]);
+  }
+  return cuts;
+}
+
+uint64_t
+FirstEdge(const tsuba::RDGPrefix& prefix, uint64_t node) {
+  return node == 0 ? 0 : prefix[node - 1];
+}
+
+}  // namespace
 
 namespace tsuba {
 
@@ -12,13 +54,25 @@ galois::Result<void>
 RDGSlice::DoMake(const galois::Uri& metadata_dir, const SliceArg& slice) {
   galois::Uri t_path = metadata_dir.Join(core_->part_header().topology_path());
 
-  if (auto res = core_->topology_file_storage().Bind(
-          t_path.string(), slice.topo_off, slice.topo_off + slice.topo_size,
-          true);
+  std::optional<IOClassScope> io_class;
+  io_class.emplace(IOClass::kTopology);
+  // the size recorded in the part header saves asking storage for it, and
+  // its checksums verify the slice
+  uint64_t topology_size = core_->part_header().topology_size();
+  FileView* fv = &core_->topology_file_storage();
+  if (auto res = topology_size == 0
+                     ? fv->Bind(
+                           t_path.string(), slice.topo_off,
+                           slice.topo_off + slice.topo_size, true)
+                     : fv->BindKnownSize(
+                           t_path.string(), topology_size, slice.topo_off,
+                           slice.topo_off + slice.topo_size, true,
+                           core_->part_header().topology_checksums());
       !res) {
     return res.error();
   }
 
+  io_class.emplace(IOClass::kNodeProperty);
   auto node_result = AddTablesSlice(
       metadata_dir, core_->part_header().node_prop_info_list(),
       slice.node_range,
@@ -29,6 +83,7 @@ RDGSlice::DoMake(const galois::Uri& metadata_dir, const SliceArg& slice) {
     return node_result.error();
   }
 
+  io_class.emplace(IOClass::kEdgeProperty);
   auto edge_result = AddTablesSlice(
       metadata_dir, core_->part_header().edge_prop_info_list(),
       slice.edge_range,
@@ -78,6 +133,100 @@ RDGSlice::Make(
   return RDGSlice(std::move(rdg_slice));
 }
 
+std::vector<RDGSlice::SliceArg>
+RDGSlice::EdgeBalancedSlices(const RDGPrefix& prefix, uint32_t num_slices) {
+  std::vector<SliceArg> slices;
+  if (!prefix.Valid() || num_slices == 0) {
+    return slices;
+  }
+  std::vector<uint64_t> cuts = EdgeBalancedCuts(prefix, num_slices);
+  for (uint32_t i = 0; i < num_slices; ++i) {
+    slices.emplace_back(SliceArg{
+        .node_range = {cuts[i], cuts[i + 1]},
+        .edge_range =
+            {FirstEdge(prefix, cuts[i]), FirstEdge(prefix, cuts[i + 1])},
+        .topo_off = kTopologyHeaderSize + cuts[i] * sizeof(uint64_t),
+        .topo_size = (cuts[i + 1] - cuts[i]) * sizeof(uint64_t),
+    });
+  }
+  return slices;
+}
+
+galois::Result<RDGSlice>
+RDGSlice::MakeEdgeBalanced(
+    RDGHandle handle, const std::vector<std::string>* node_props,
+    const std::vector<std::string>* edge_props) {
+  galois::CommBackend* comm = tsuba::Comm();
+
+  // num_nodes, then the node and the edge boundaries of every slice
+  std::vector<uint64_t> cuts(1 + 2 * (uint64_t{comm->Num} + 1));
+  uint64_t cuts_size = cuts.size() * sizeof(uint64_t);
+  std::string cuts_s;
+  galois::Result<void> ret = galois::ResultSuccess();
+  if (comm->ID == 0) {
+    ret = [&]() -> galois::Result<void> {
+      auto prefix_res = RDGPrefix::Make(handle);
+      if (!prefix_res) {
+        return prefix_res.error();
+      }
+      const RDGPrefix& prefix = prefix_res.value();
+      if (!prefix.Valid() || prefix.version() != kSliceableTopologyVersion) {
+        GALOIS_LOG_ERROR(
+            "cannot slice topology of {}", handle.impl_->rdg_meta().dir());
+        return ErrorCode::NotImplemented;
+      }
+      std::vector<uint64_t> node_cuts = EdgeBalancedCuts(prefix, comm->Num);
+      cuts[0] = prefix.num_nodes();
+      for (uint32_t i = 0; i <= comm->Num; ++i) {
+        cuts[1 + i] = node_cuts[i];
+        cuts[2 + comm->Num + i] = FirstEdge(prefix, node_cuts[i]);
+      }
+      cuts_s.assign(reinterpret_cast<const char*>(cuts.data()), cuts_size);
+      return galois::ResultSuccess();
+    }();
+  }
+
+  // an empty string tells the other hosts that host 0 failed
+  cuts_s = comm->Broadcast(0, cuts_s, cuts_size);
+  if (!ret) {
+    return ret.error();
+  }
+  if (cuts_s.size() != cuts_size) {
+    return ErrorCode::MpiError;
+  }
+  std::memcpy(cuts.data(), cuts_s.data(), cuts_size);
+
+  uint64_t num_nodes = cuts[0];
+  uint64_t node_begin = cuts[1 + comm->ID];
+  uint64_t node_end = cuts[2 + comm->ID];
+  uint64_t edge_begin = cuts[2 + comm->Num + comm->ID];
+  uint64_t edge_end = cuts[3 + comm->Num + comm->ID];
+  SliceArg slice{
+      .node_range = {node_begin, node_end},
+      .edge_range = {edge_begin, edge_end},
+      .topo_off = kTopologyHeaderSize + node_begin * sizeof(uint64_t),
+      .topo_size = (node_end - node_begin) * sizeof(uint64_t),
+  };
+
+  auto slice_res = Make(handle, slice, node_props, edge_props);
+  if (!slice_res) {
+    return slice_res.error();
+  }
+  RDGSlice rdg_slice = std::move(slice_res.value());
+
+  uint64_t dests_off = kTopologyHeaderSize + num_nodes * sizeof(uint64_t) +
+                       edge_begin * sizeof(uint32_t);
+  IOClassScope io_class(IOClass::kTopology);
+  if (auto res = rdg_slice.core_->topology_file_storage().Fill(
+          dests_off, dests_off + (edge_end - edge_begin) * sizeof(uint32_t),
+          true);
+      !res) {
+    GALOIS_LOG_DEBUG("failed to read destinations of slice: {}", res.error());
+    return res.error();
+  }
+  return RDGSlice(std::move(rdg_slice));
+}
+
 const std::shared_ptr<arrow::Table>&
 RDGSlice::node_table() const {
   return core_->node_table();
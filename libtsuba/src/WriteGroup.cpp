@@ -1,7 +1,13 @@
 #include "tsuba/WriteGroup.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
 #include "GlobalState.h"
+#include "galois/Env.h"
 #include "galois/Random.h"
+#include "tsuba/IOStats.h"
 
 template <typename T>
 using Result = galois::Result<T>;
@@ -9,11 +15,27 @@ using Result = galois::Result<T>;
 namespace {
 
 constexpr uint32_t kTagLen = 12;
+constexpr int kDefaultWriteBudgetMB = 1024;
+
+std::atomic<uint64_t> max_peak_inflight_bytes{0};
+
+uint64_t
+WriteBudget() {
+  static uint64_t budget = [] {
+    int budget_mb = kDefaultWriteBudgetMB;
+    galois::GetEnv("GALOIS_TSUBA_WRITE_BUDGET_MB", &budget_mb);
+    return static_cast<uint64_t>(std::max(budget_mb, 0)) << 20;
+  }();
+  return budget;
+}
 
 }  // namespace
 
 namespace tsuba {
 
+WriteGroup::WriteGroup(std::string tag)
+    : tag_(std::move(tag)), budget_(WriteBudget()) {}
+
 Result<std::unique_ptr<WriteGroup>>
 WriteGroup::Make() {
   // Don't use `OneHostOnly` because we can skip its broadcast
@@ -25,49 +47,140 @@ WriteGroup::Make() {
   return std::unique_ptr<WriteGroup>(new WriteGroup(tag));
 }
 
+uint64_t
+WriteGroup::MaxPeakInflightBytes() {
+  return max_peak_inflight_bytes;
+}
+
+void
+WriteGroup::Complete(AsyncOp* op) {
+  auto res = op->result.get();
+  if (!res) {
+    GALOIS_LOG_DEBUG(
+        "async write op for {} returned {}", op->location, res.error());
+    if (errors_++ == 0) {
+      first_error_ = res.error();
+    }
+  }
+  inflight_bytes_ -= op->size;
+}
+
 Result<void>
 WriteGroup::Finish() {
-  Result<void> return_val = galois::ResultSuccess();
-  uint32_t errors = 0;
-
+  std::lock_guard<std::mutex> lock(mutex_);
   for (AsyncOp& op : pending_ops_) {
-    auto res = op.result.get();
-    if (!res) {
-      GALOIS_LOG_DEBUG(
-          "async write op for {} returned {}", op.location, res.error());
-      errors++;
-      return_val = res.error();
-    }
+    Complete(&op);
   }
+  pending_ops_.clear();
 
-  if (errors > 0) {
+  GALOIS_LOG_DEBUG(
+      "write group {} peak in-flight bytes: {}", tag_, peak_inflight_bytes_);
+
+  if (errors_ > 0) {
     GALOIS_LOG_ERROR(
-        "{} of {} async write ops returned errors", errors,
-        pending_ops_.size());
+        "{} of {} async write ops returned errors", errors_, total_ops_);
   }
 
-  return return_val;
+  return first_error_;
 }
 
 void
-WriteGroup::AddOp(std::future<galois::Result<void>> future, std::string file) {
+WriteGroup::ReserveBudget(uint64_t size) {
+  if (budget_ == 0 || inflight_bytes_ + size <= budget_) {
+    return;
+  }
+
+  // First, reclaim whatever has already finished
+  for (auto it = pending_ops_.begin(); it != pending_ops_.end();) {
+    if (it->result.wait_for(std::chrono::seconds(0)) ==
+        std::future_status::ready) {
+      Complete(&*it);
+      it = pending_ops_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  // Then wait for the oldest ops; a single store larger than the budget is
+  // allowed once nothing else is in flight
+  while (inflight_bytes_ + size > budget_ && !pending_ops_.empty()) {
+    Complete(&pending_ops_.front());
+    pending_ops_.pop_front();
+  }
+}
+
+void
+WriteGroup::AddOp(
+    std::future<galois::Result<void>> future, std::string file,
+    uint64_t size) {
   pending_ops_.emplace_back(AsyncOp{
       .result = std::move(future),
       .location = std::move(file),
+      .size = size,
   });
+  total_ops_++;
+  AddInflight(size);
+}
+
+void
+WriteGroup::AddInflight(uint64_t size) {
+  inflight_bytes_ += size;
+  if (inflight_bytes_ > peak_inflight_bytes_) {
+    peak_inflight_bytes_ = inflight_bytes_;
+    uint64_t prev = max_peak_inflight_bytes;
+    while (prev < peak_inflight_bytes_ &&
+           !max_peak_inflight_bytes.compare_exchange_weak(
+               prev, peak_inflight_bytes_)) {
+    }
+  }
 }
 
 // shared pointer because FileFrames are often held that way due do the way
 // they're used with arrow
 void
 WriteGroup::StartStore(std::shared_ptr<FileFrame> ff) {
+  uint64_t size = ff->size();
+  Reserve(size);
+  StartStore(std::move(ff), size);
+}
+
+void
+WriteGroup::Reserve(uint64_t size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ReserveBudget(size);
+  AddInflight(size);
+}
+
+void
+WriteGroup::Release(uint64_t size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  inflight_bytes_ -= size;
+}
+
+void
+WriteGroup::StartStore(std::shared_ptr<FileFrame> ff, uint64_t reserved) {
   std::string file = ff->path();
 
   // wrap future to hold onto FileFrame, but free it as soon as possible
-  auto future = std::async(std::launch::async, [ff = std::move(ff)]() mutable {
-    return ff->PersistAsync().get();
-  });
-  AddOp(std::move(future), file);
+  auto future = std::async(
+      std::launch::async,
+      [ff = std::move(ff), io_class = CurrentIOClass()]() mutable {
+        IOClassScope scope(io_class);
+        return ff->PersistAsync().get();
+      });
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  // the reserved bytes are counted again by AddOp
+  inflight_bytes_ -= reserved;
+  AddOp(std::move(future), file, reserved);
+}
+
+void
+WriteGroup::StartStore(
+    const std::string& file, const uint8_t* buf, uint64_t size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ReserveBudget(size);
+  AddOp(FileStoreAsync(file, buf, size), file, size);
 }
 
 }  // namespace tsuba
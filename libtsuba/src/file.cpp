@@ -6,43 +6,251 @@
 //
 #include "tsuba/file.h"
 
+#include <fcntl.h>
 #include <sys/mman.h>
+#include <unistd.h>
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <deque>
 #include <fstream>
+#include <future>
 #include <iostream>
 #include <mutex>
+#include <optional>
 #include <unordered_map>
 
 #include "GlobalState.h"
+#include "IOStats_internal.h"
+#include "galois/Env.h"
 #include "galois/Logging.h"
 #include "galois/Platform.h"
 #include "galois/Result.h"
+#include "galois/Trace.h"
+#include "galois/Uri.h"
 #include "tsuba/Errors.h"
 
+namespace {
+
+constexpr int kDefaultMultipartThresholdMB = 64;
+constexpr int kDefaultMultipartPartSizeMB = 16;
+constexpr int kDefaultMultipartConcurrency = 8;
+constexpr int kDefaultDeleteConcurrency = 8;
+
+/// Return the block cache if reads of uri should go through it
+tsuba::BlockCache*
+CacheFor(tsuba::FileStorage* fs, const std::string& uri) {
+  tsuba::BlockCache* cache = tsuba::Cache();
+  if (cache == nullptr || !fs->LocalPath(uri).empty()) {
+    return nullptr;
+  }
+  return cache;
+}
+
+/// Return the disk cache if uri is remote and the cache is enabled
+tsuba::DiskCache*
+DiskFor(tsuba::FileStorage* fs, const std::string& uri) {
+  tsuba::DiskCache* disk = tsuba::Disk();
+  if (disk == nullptr || !fs->LocalPath(uri).empty()) {
+    return nullptr;
+  }
+  return disk;
+}
+
+/// Return the copy of uri in the disk cache that holds [begin, begin + size)
+std::optional<tsuba::DiskCache::Copy>
+DiskCopyFor(
+    tsuba::FileStorage* fs, const std::string& uri, uint64_t begin,
+    uint64_t size) {
+  tsuba::DiskCache* disk = DiskFor(fs, uri);
+  if (disk == nullptr) {
+    return std::nullopt;
+  }
+  std::optional<tsuba::DiskCache::Copy> copy = disk->Lookup(uri);
+  if (!copy || begin + size > copy->size) {
+    return std::nullopt;
+  }
+  return copy;
+}
+
+void
+InvalidateCached(const std::string& uri) {
+  if (tsuba::BlockCache* cache = tsuba::Cache(); cache != nullptr) {
+    cache->Invalidate(uri);
+  }
+  if (tsuba::DiskCache* disk = tsuba::Disk(); disk != nullptr) {
+    disk->Invalidate(uri);
+  }
+  tsuba::Metas()->InvalidatePartHeader(uri);
+}
+
+/// Counts a streaming put as one store, from its start until it is finished
+class TrackedStreamingPut : public tsuba::StreamingPut {
+  std::unique_ptr<tsuba::StreamingPut> put_;
+  std::string backend_;
+  tsuba::IOClass io_class_;
+  tsuba::internal::IOClock::time_point start_;
+  uint64_t size_{0};
+
+public:
+  TrackedStreamingPut(
+      std::unique_ptr<tsuba::StreamingPut> put, tsuba::FileStorage* fs)
+      : put_(std::move(put)),
+        backend_(fs->uri_scheme()),
+        io_class_(tsuba::CurrentIOClass()),
+        start_(tsuba::internal::IOClock::now()) {}
+
+  galois::Result<void> PutPart(std::vector<uint8_t>&& part) override {
+    size_ += part.size();
+    return put_->PutPart(std::move(part));
+  }
+
+  std::future<galois::Result<void>> Finish(
+      std::vector<uint8_t>&& last) override {
+    size_ += last.size();
+    return std::async(
+        std::launch::async,
+        [this, future = put_->Finish(std::move(last))]() mutable
+        -> galois::Result<void> {
+          galois::Result<void> res = future.get();
+          tsuba::internal::RecordIO(
+              backend_, io_class_, tsuba::IOOp::kStore, size_, start_,
+              res.has_value());
+          return res;
+        });
+  }
+};
+
+}  // namespace
+
 galois::Result<void>
 tsuba::FileStore(const std::string& uri, const uint8_t* data, uint64_t size) {
-  return FS(uri)->PutMultiSync(uri, data, size);
+  galois::TraceScope trace("io", "FileStore");
+  InvalidateCached(uri);
+  FileStorage* fs = FS(uri);
+  auto start = internal::IOClock::now();
+  auto res = fs->PutMultiSync(uri, data, size);
+  internal::RecordIO(fs, IOOp::kStore, size, start, res.has_value());
+  return res;
+}
+
+const tsuba::MultipartConfig&
+tsuba::GetMultipartConfig() {
+  static MultipartConfig config = [] {
+    int threshold_mb = kDefaultMultipartThresholdMB;
+    int part_size_mb = kDefaultMultipartPartSizeMB;
+    int concurrency = kDefaultMultipartConcurrency;
+    galois::GetEnv("GALOIS_TSUBA_MULTIPART_THRESHOLD_MB", &threshold_mb);
+    galois::GetEnv("GALOIS_TSUBA_MULTIPART_PART_SIZE_MB", &part_size_mb);
+    galois::GetEnv("GALOIS_TSUBA_MULTIPART_CONCURRENCY", &concurrency);
+    return MultipartConfig{
+        .threshold = static_cast<uint64_t>(std::max(threshold_mb, 0)) << 20,
+        .part_size = static_cast<uint64_t>(std::max(part_size_mb, 1)) << 20,
+        .concurrency = static_cast<uint32_t>(std::max(concurrency, 1)),
+    };
+  }();
+  return config;
 }
 
 std::future<galois::Result<void>>
 tsuba::FileStoreAsync(
     const std::string& uri, const uint8_t* data, uint64_t size) {
-  return FS(uri)->PutAsync(uri, data, size);
+  const MultipartConfig& config = GetMultipartConfig();
+  if (size >= config.threshold && size > config.part_size) {
+    return FileStoreMultipartAsync(
+        uri, data, size, config.part_size, config.concurrency);
+  }
+  InvalidateCached(uri);
+  FileStorage* fs = FS(uri);
+  return internal::TrackIO(
+      fs->PutAsync(uri, data, size), fs, IOOp::kStore, size);
+}
+
+std::future<galois::Result<void>>
+tsuba::FileStoreMultipartAsync(
+    const std::string& uri, const uint8_t* data, uint64_t size,
+    uint64_t part_size, uint32_t concurrency) {
+  InvalidateCached(uri);
+  FileStorage* fs = FS(uri);
+  return internal::TrackIO(
+      fs->PutMultipartAsync(uri, data, size, part_size, concurrency), fs,
+      IOOp::kStore, size);
+}
+
+std::unique_ptr<tsuba::StreamingPut>
+tsuba::FileStreamingStore(const std::string& uri) {
+  const MultipartConfig& config = GetMultipartConfig();
+  FileStorage* fs = FS(uri);
+  std::unique_ptr<StreamingPut> put =
+      fs->StartStreamingPut(uri, config.part_size, config.concurrency);
+  if (!put) {
+    return nullptr;
+  }
+  InvalidateCached(uri);
+  return std::make_unique<TrackedStreamingPut>(std::move(put), fs);
 }
 
 galois::Result<void>
 tsuba::FileGet(
     const std::string& uri, uint8_t* result_buffer, uint64_t begin,
     uint64_t size) {
-  return FS(uri)->GetMultiSync(uri, begin, size, result_buffer);
+  galois::TraceScope trace("io", "FileGet");
+  FileStorage* fs = FS(uri);
+  // ranges of a file copied to local disk are read from the copy
+  if (auto copy = DiskCopyFor(fs, uri, begin, size); copy) {
+    return FileGet(copy->path, result_buffer, begin, size);
+  }
+  auto start = internal::IOClock::now();
+  galois::Result<void> res = galois::ResultSuccess();
+  if (BlockCache* cache = CacheFor(fs, uri); cache != nullptr) {
+    res = cache->Get(fs, uri, begin, size, result_buffer);
+  } else {
+    res = fs->GetMultiSync(uri, begin, size, result_buffer);
+  }
+  internal::RecordIO(fs, IOOp::kGet, size, start, res.has_value());
+  return res;
 }
 
 std::future<galois::Result<void>>
 tsuba::FileGetAsync(
     const std::string& uri, uint8_t* result_buffer, uint64_t begin,
     uint64_t size) {
-  return FS(uri)->GetAsync(uri, begin, size, result_buffer);
+  FileStorage* fs = FS(uri);
+  if (auto copy = DiskCopyFor(fs, uri, begin, size); copy) {
+    return FileGetAsync(copy->path, result_buffer, begin, size);
+  }
+  if (BlockCache* cache = CacheFor(fs, uri); cache != nullptr) {
+    return std::async(
+        std::launch::async,
+        [cache, fs, uri, result_buffer, begin, size,
+         io_class = CurrentIOClass(),
+         start = internal::IOClock::now()]() -> galois::Result<void> {
+          auto res = cache->Get(fs, uri, begin, size, result_buffer);
+          internal::RecordIO(
+              fs->uri_scheme(), io_class, IOOp::kGet, size, start,
+              res.has_value());
+          return res;
+        });
+  }
+  return internal::TrackIO(
+      fs->GetAsync(uri, begin, size, result_buffer), fs, IOOp::kGet, size);
+}
+
+tsuba::BlockCacheStats
+tsuba::GetBlockCacheStats() {
+  if (BlockCache* cache = Cache(); cache != nullptr) {
+    return cache->stats();
+  }
+  return BlockCacheStats{};
+}
+
+tsuba::DiskCacheStats
+tsuba::GetDiskCacheStats() {
+  if (DiskCache* disk = Disk(); disk != nullptr) {
+    return disk->stats();
+  }
+  return DiskCacheStats{};
 }
 
 galois::Result<void>
@@ -54,12 +262,159 @@ std::future<galois::Result<void>>
 tsuba::FileListAsync(
     const std::string& directory, std::vector<std::string>* list,
     std::vector<uint64_t>* size) {
-  return FS(directory)->ListAsync(directory, list, size);
+  FileStorage* fs = FS(directory);
+  return internal::TrackIO(
+      fs->ListAsync(directory, list, size), fs, IOOp::kList, 0);
 }
 
 galois::Result<void>
 tsuba::FileDelete(
     const std::string& directory,
     const std::unordered_set<std::string>& files) {
-  return FS(directory)->Delete(directory, files);
+  static const uint32_t max_in_flight = [] {
+    int concurrency = kDefaultDeleteConcurrency;
+    galois::GetEnv("GALOIS_TSUBA_DELETE_CONCURRENCY", &concurrency);
+    return static_cast<uint32_t>(std::max(concurrency, 1));
+  }();
+
+  for (const auto& file : files) {
+    InvalidateCached(galois::Uri::JoinPath(directory, file));
+  }
+  FileStorage* fs = FS(directory);
+  uint64_t batch_size = std::max<uint64_t>(fs->DeleteBatchSize(), 1);
+  auto delete_batch = [fs, &directory](
+                          const std::unordered_set<std::string>& batch)
+      -> galois::Result<void> {
+    auto start = internal::IOClock::now();
+    auto res = fs->Delete(directory, batch);
+    internal::RecordIO(fs, IOOp::kDelete, 0, start, res.has_value());
+    return res;
+  };
+  // an empty set deletes the directory itself on some backends
+  if (files.size() <= batch_size) {
+    return delete_batch(files);
+  }
+
+  std::deque<std::future<galois::Result<void>>> in_flight;
+  galois::Result<void> ret = galois::ResultSuccess();
+  auto wait_oldest = [&]() {
+    if (auto res = in_flight.front().get(); !res && ret) {
+      ret = res.error();
+    }
+    in_flight.pop_front();
+  };
+  std::unordered_set<std::string> batch;
+  for (auto it = files.begin(); it != files.end();) {
+    batch.emplace(*it++);
+    if (batch.size() < batch_size && it != files.end()) {
+      continue;
+    }
+    if (in_flight.size() == max_in_flight) {
+      wait_oldest();
+    }
+    in_flight.emplace_back(std::async(
+        std::launch::async,
+        [&delete_batch, batch = std::move(batch)]() {
+          return delete_batch(batch);
+        }));
+    batch = std::unordered_set<std::string>();
+  }
+  while (!in_flight.empty()) {
+    wait_oldest();
+  }
+  return ret;
+}
+
+namespace {
+
+galois::Result<uint8_t*>
+MapLocal(const std::string& path, uint64_t size, bool populate) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return galois::ResultErrno();
+  }
+
+  void* ptr = nullptr;
+  if (populate) {
+    ptr = galois::MmapPopulate(
+        nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  } else {
+    ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  }
+  // the mapping keeps its own reference to the file
+  (void)close(fd);
+
+  if (ptr == MAP_FAILED) {
+    return galois::ResultErrno();
+  }
+
+  if (!populate) {
+    if (madvise(ptr, size, MADV_WILLNEED) != 0) {
+      GALOIS_LOG_DEBUG("madvise: {}", std::strerror(errno));
+    }
+  }
+  return static_cast<uint8_t*>(ptr);
+}
+
+/// Map the first size bytes of uri, as FileMmap does. The disk cache only
+/// holds whole files, so it needs the size of uri, file_size, which is asked
+/// of storage if it is not given.
+galois::Result<uint8_t*>
+MmapFile(
+    const std::string& uri, std::optional<uint64_t> file_size, uint64_t size,
+    bool populate) {
+  tsuba::FileStorage* fs = tsuba::FS(uri);
+  std::string path = fs->LocalPath(uri);
+  if (tsuba::DiskCache* disk = DiskFor(fs, uri); disk != nullptr) {
+    if (!file_size) {
+      tsuba::StatBuf stat_buf;
+      if (auto res = fs->Stat(uri, &stat_buf); !res) {
+        return res.error();
+      }
+      file_size = stat_buf.size;
+    }
+    std::optional<tsuba::DiskCache::Copy> copy = disk->Lookup(uri);
+    if (copy && copy->size != file_size.value()) {
+      // not the file that is in storage now
+      disk->Invalidate(uri);
+      copy.reset();
+    }
+    if (!copy) {
+      auto start = tsuba::internal::IOClock::now();
+      auto fill_res = disk->Fill(fs, uri, file_size.value());
+      tsuba::internal::RecordIO(
+          fs, tsuba::IOOp::kGet, file_size.value(), start,
+          fill_res.has_value());
+      if (!fill_res) {
+        return fill_res.error();
+      }
+      copy = std::move(fill_res.value());
+    }
+    if (copy && copy->size >= size) {
+      path = std::move(copy->path);
+      fs = tsuba::FS(path);
+    }
+  }
+  if (path.empty()) {
+    return tsuba::ErrorCode::NotImplemented;
+  }
+
+  auto start = tsuba::internal::IOClock::now();
+  auto res = MapLocal(path, size, populate);
+  tsuba::internal::RecordIO(
+      fs, tsuba::IOOp::kMmap, size, start, res.has_value());
+  return res;
+}
+
+}  // namespace
+
+galois::Result<uint8_t*>
+tsuba::FileMmap(const std::string& uri, uint64_t size, bool populate) {
+  return MmapFile(uri, std::nullopt, size, populate);
+}
+
+galois::Result<uint8_t*>
+tsuba::FileMmapWhole(
+    const std::string& uri, uint64_t file_size, bool populate) {
+  return MmapFile(uri, file_size, file_size, populate);
 }
@@ -1,5 +1,8 @@
 #include "tsuba/tsuba.h"
 
+#include <set>
+#include <unordered_set>
+
 #include "GlobalState.h"
 #include "RDGHandleImpl.h"
 #include "galois/Backtrace.h"
@@ -69,6 +72,106 @@ FindLatestMetaFile(const galois::Uri& name) {
   return name.Join(found_meta);
 }
 
+galois::Result<tsuba::GarbageCollectStats>
+CollectGarbage(
+    const galois::Uri& uri, uint32_t num_versions_to_keep, bool dry_run) {
+  // list before reading the history: files of commits that finish later are
+  // either not listed or referred to by a kept version
+  std::vector<std::string> listed;
+  std::vector<uint64_t> sizes;
+  if (auto res = tsuba::FileListAsync(uri.string(), &listed, &sizes).get();
+      !res) {
+    return res.error();
+  }
+
+  auto meta_res = tsuba::RDGMeta::Make(uri);
+  if (!meta_res) {
+    return meta_res.error();
+  }
+  tsuba::RDGMeta meta = std::move(meta_res.value());
+
+  tsuba::GarbageCollectStats stats;
+  std::set<std::string> live;
+  std::set<std::string> old;
+  for (uint64_t depth = 0;; ++depth) {
+    auto names_res = meta.FileNames();
+    if (depth < num_versions_to_keep) {
+      if (!names_res) {
+        return names_res.error();
+      }
+      live.insert(names_res.value().begin(), names_res.value().end());
+      stats.versions_kept++;
+    } else if (names_res) {
+      old.insert(names_res.value().begin(), names_res.value().end());
+    } else {
+      // leave the files of a version that cannot be read alone
+      GALOIS_LOG_WARN(
+          "skipping version {} of {}: {}", meta.version(), uri,
+          names_res.error());
+    }
+
+    if (meta.version() == 0 || meta.previous_version() >= meta.version()) {
+      break;
+    }
+    auto prev_res = tsuba::RDGMeta::Make(uri, meta.previous_version());
+    if (!prev_res) {
+      GALOIS_LOG_DEBUG(
+          "history of {} ends at version {}: {}", uri, meta.version(),
+          prev_res.error());
+      break;
+    }
+    meta = std::move(prev_res.value());
+  }
+
+  // data files first, so that the meta files of partly deleted versions are
+  // still there for the next collection to find them
+  std::unordered_set<std::string> data_files;
+  std::unordered_set<std::string> meta_files;
+  for (size_t i = 0; i < listed.size(); ++i) {
+    const std::string& file = listed[i];
+    if (old.count(file) == 0 || live.count(file) != 0) {
+      continue;
+    }
+    stats.files_deleted++;
+    stats.bytes_deleted += i < sizes.size() ? sizes[i] : 0;
+    if (file.rfind("meta_", 0) == 0) {
+      meta_files.emplace(file);
+    } else {
+      data_files.emplace(file);
+    }
+  }
+
+  // FileDelete splits the sets into batches; an empty set would delete the
+  // directory
+  for (const auto* files : {&data_files, &meta_files}) {
+    if (dry_run || files->empty()) {
+      continue;
+    }
+    if (auto res = tsuba::FileDelete(uri.string(), *files); !res) {
+      return res.error();
+    }
+  }
+  return stats;
+}
+
+/// Gets the RDGMeta of a name, first registering the name if this process
+/// has not seen it registered
+galois::Result<tsuba::RDGMeta>
+MakeNamedMeta(const galois::Uri& uri) {
+  if (tsuba::Metas()->IsKnownName(uri)) {
+    if (auto res = tsuba::RDGMeta::Make(uri); res) {
+      return res;
+    }
+    // the name may have been forgotten by another process since
+  }
+  // try to be helpful and look for RDGs that we don't know about
+  if (auto res = tsuba::RegisterIfAbsent(uri.string()); !res) {
+    GALOIS_LOG_DEBUG("failed to auto-register: {}", res.error());
+    return res.error();
+  }
+  return tsuba::RDGMeta::Make(uri);
+}
+
 }  // namespace
 
 galois::Result<tsuba::RDGHandle>
@@ -91,16 +194,39 @@ tsuba::Open(const std::string& rdg_name, uint32_t flags) {
     return ErrorCode::InvalidArgument;
   }
 
-  if (!RDGMeta::IsMetaUri(uri)) {
-    // try to be helpful and look for RDGs that we don't know about
-    if (auto res = RegisterIfAbsent(uri.string()); !res) {
-      GALOIS_LOG_DEBUG("failed to auto-register: {}", res.error());
-      return res.error();
-    }
+  auto meta_res = MakeNamedMeta(uri);
+  if (!meta_res) {
+    return meta_res.error();
   }
 
-  auto meta_res = tsuba::RDGMeta::Make(uri);
+  return RDGHandle{
+      .impl_ = new RDGHandleImpl(flags, std::move(meta_res.value()))};
+}
+
+galois::Result<tsuba::RDGHandle>
+tsuba::Open(const std::string& rdg_name, uint64_t version, uint32_t flags) {
+  if (!OpenFlagsValid(flags)) {
+    GALOIS_LOG_ERROR("invalid value for flags ({:#x})", flags);
+    return ErrorCode::InvalidArgument;
+  }
+
+  auto uri_res = galois::Uri::Make(rdg_name);
+  if (!uri_res) {
+    return uri_res.error();
+  }
+  galois::Uri uri = std::move(uri_res.value());
+
+  if (RDGMeta::IsMetaUri(uri)) {
+    GALOIS_LOG_DEBUG(
+        "failed: {} is probably a literal rdg file and not suited for open",
+        uri);
+    return ErrorCode::InvalidArgument;
+  }
+
+  auto meta_res = RDGMeta::Make(uri, version);
   if (!meta_res) {
+    GALOIS_LOG_DEBUG(
+        "failed to open version {} of {}: {}", version, uri, meta_res.error());
     return meta_res.error();
   }
 
@@ -114,6 +240,11 @@ tsuba::Close(RDGHandle handle) {
   return galois::ResultSuccess();
 }
 
+uint64_t
+tsuba::Version(RDGHandle handle) {
+  return handle.impl_->rdg_meta().version();
+}
+
 galois::Result<void>
 tsuba::Create(const std::string& name) {
   auto uri_res = galois::Uri::Make(name);
@@ -144,6 +275,8 @@ tsuba::Create(const std::string& name) {
     }
   }
 
+  Metas()->InvalidateMeta(uri);
+
   // NS handles MPI coordination
   if (auto res = tsuba::NS()->CreateIfAbsent(uri, meta); !res) {
     GALOIS_LOG_ERROR("failed to create RDG name");
@@ -191,6 +324,8 @@ tsuba::Forget(const std::string& name) {
     return ErrorCode::InvalidArgument;
   }
 
+  Metas()->InvalidateMeta(uri);
+
   // NS ensures only host 0 creates
   auto res = tsuba::NS()->Delete(uri);
   return res;
@@ -204,15 +339,8 @@ tsuba::Stat(const std::string& rdg_name) {
   }
   galois::Uri uri = std::move(uri_res.value());
 
-  if (!RDGMeta::IsMetaUri(uri)) {
-    // try to be helpful and look for RDGs that we don't know about
-    if (auto res = RegisterIfAbsent(uri.string()); !res) {
-      GALOIS_LOG_DEBUG("failed to auto-register: {}", res.error());
-      return res.error();
-    }
-  }
-
-  auto rdg_res = RDGMeta::Make(uri);
+  auto rdg_res =
+      RDGMeta::IsMetaUri(uri) ? RDGMeta::Make(uri) : MakeNamedMeta(uri);
   if (!rdg_res) {
     if (rdg_res.error() == galois::ErrorCode::JsonParseFailed) {
       return RDGStat{
@@ -232,6 +360,40 @@ tsuba::Stat(const std::string& rdg_name) {
   };
 }
 
+galois::Result<tsuba::GarbageCollectStats>
+tsuba::GarbageCollect(
+    const std::string& rdg_name, uint32_t num_versions_to_keep,
+    bool dry_run) {
+  if (num_versions_to_keep == 0) {
+    GALOIS_LOG_ERROR("garbage collection has to keep at least one version");
+    return ErrorCode::InvalidArgument;
+  }
+  auto uri_res = galois::Uri::Make(rdg_name);
+  if (!uri_res) {
+    return uri_res.error();
+  }
+  galois::Uri uri = std::move(uri_res.value());
+
+  if (RDGMeta::IsMetaUri(uri)) {
+    GALOIS_LOG_DEBUG("uri does not look like a graph name (ends in meta)");
+    return ErrorCode::InvalidArgument;
+  }
+
+  GarbageCollectStats stats;
+  if (auto res = OneHostOnly([&]() -> galois::Result<void> {
+        auto collect_res = CollectGarbage(uri, num_versions_to_keep, dry_run);
+        if (!collect_res) {
+          return collect_res.error();
+        }
+        stats = collect_res.value();
+        return galois::ResultSuccess();
+      });
+      !res) {
+    return res.error();
+  }
+  return stats;
+}
+
 galois::Result<void>
 tsuba::Init(galois::CommBackend* comm) {
   tsuba::Preload();
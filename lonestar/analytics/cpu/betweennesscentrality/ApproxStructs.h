@@ -0,0 +1,300 @@
+#ifndef GALOIS_BC_APPROX
+#define GALOIS_BC_APPROX
+
+#include <cmath>
+#include <memory>
+#include <random>
+
+#include "LevelBatchedStructs.h"
+#include "LevelStructs.h"
+#include "galois/LargeArray.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Approximate BC samples sources uniformly and runs the Level forward and
+// backward phases from each. The dependency of a source on a node, divided by
+// its largest possible value n - 2, is a sample in [0, 1] whose expectation is
+// the normalized BC of the node, BC / (n * (n - 2)).
+//
+// Sampling stops once every node's estimate is within epsilon of its
+// expectation with probability 1 - delta. Half of delta goes to a Hoeffding
+// bound that fixes the largest number of samples; the other half goes to
+// adaptive checks after each batch of sources. Each check uses the empirical
+// Bernstein bound (Maurer and Pontil, COLT '09), like KADABRA (Borassi and
+// Natale, ESA '16). Most nodes are on few shortest paths, so their samples
+// have a small variance. Their bound shrinks as 1 / r instead of
+// 1 / sqrt(r) in the number of samples r, and the adaptive checks usually
+// stop long before the Hoeffding limit.
+//
+// With -batchSize above 1, the sources of a batch run together in lanes of
+// batched Level BC (see LevelBatchedStructs.h).
+
+/**
+ * Per-node sums of the scaled dependencies of the sampled sources and of their
+ * squares.
+ */
+struct ApproxSums {
+  galois::LargeArray<double> sum;
+  galois::LargeArray<double> sum_squares;
+};
+
+/**
+ * Prepares the iteration data of the next source, assuming every other node
+ * was reset after the previous one.
+ *
+ * @param graph LevelGraph to prepare
+ */
+void
+ApproxInitializeSource(LevelGraph* graph) {
+  graph->GetData<NodeCurrentDist>(kLevelCurrentSrcNode) = 0;
+  graph->GetData<NodeNumShortestPaths>(kLevelCurrentSrcNode) = 1;
+}
+
+/**
+ * Adds the scaled dependencies of the current source to sums, then resets the
+ * iteration data of the nodes it reached, so the next source only touches the
+ * nodes it reaches instead of the whole graph.
+ *
+ * @param graph LevelGraph after LevelSSSP and LevelBackwardBrandes
+ * @param worklists Levels found by LevelSSSP
+ * @param scale Inverse of the largest possible dependency
+ * @param sums Sums to add to
+ */
+void
+ApproxAccumulateAndReset(
+    LevelGraph* graph, galois::gstl::Vector<LevelWorklistType>* worklists,
+    double scale, ApproxSums* sums) {
+  for (LevelWorklistType& worklist : *worklists) {
+    galois::do_all(
+        galois::iterate(worklist),
+        [&](LevelGNode n) {
+          // the dependency of the source on itself is left at 0
+          double x = graph->GetData<NodeDependency>(n) * scale;
+          sums->sum[n] += x;
+          sums->sum_squares[n] += x * x;
+
+          graph->GetData<NodeCurrentDist>(n) = kInfinity;
+          graph->GetData<NodeNumShortestPaths>(n) = 0;
+          graph->GetData<NodeDependency>(n) = 0;
+        },
+        galois::steal(), galois::chunk_size<LEVEL_CHUNK_SIZE>(),
+        galois::no_stats(), galois::loopname("ApproxAccumulate"));
+  }
+}
+
+/**
+ * Adds the scaled dependencies of sources to sums, running them in lanes of
+ * batch_state.
+ *
+ * @param batch_state Batched Level BC state to run sources with
+ * @param sources Sources to sample
+ * @param scale Inverse of the largest possible dependency
+ * @param sums Sums to add to
+ */
+void
+ApproxRunBatched(
+    LevelBatch* batch_state, const std::vector<uint64_t>& sources,
+    double scale, ApproxSums* sums) {
+  uint32_t num_lanes = batch_state->num_lanes();
+  std::vector<uint64_t> lanes;
+  for (size_t begin = 0; begin < sources.size(); begin += num_lanes) {
+    size_t end = std::min<size_t>(begin + num_lanes, sources.size());
+    lanes.assign(sources.begin() + begin, sources.begin() + end);
+    batch_state->Run(lanes);
+    batch_state->ForEachDependency([&](LevelGNode n, uint32_t, float dep) {
+      double x = dep * scale;
+      sums->sum[n] += x;
+      sums->sum_squares[n] += x * x;
+    });
+  }
+}
+
+/**
+ * Largest empirical Bernstein bound over the nodes on the deviation of the
+ * mean of their samples from its expectation.
+ *
+ * @param graph LevelGraph whose nodes to bound
+ * @param sums Sums of num_samples samples of each node
+ * @param num_samples Number of samples, at least 2
+ * @param log_term Logarithm of 2 over the failure probability allowed to each
+ * one-sided bound
+ */
+double
+ApproxMaxDeviation(
+    const LevelGraph& graph, const ApproxSums& sums, uint64_t num_samples,
+    double log_term) {
+  galois::GReduceMax<double> max_deviation;
+  double r = num_samples;
+
+  galois::do_all(
+      galois::iterate(graph),
+      [&](LevelGNode n) {
+        double mean = sums.sum[n] / r;
+        double variance =
+            std::max(sums.sum_squares[n] - r * mean * mean, 0.0) / (r - 1);
+        max_deviation.update(
+            std::sqrt(2 * variance * log_term / r) +
+            7 * log_term / (3 * (r - 1)));
+      },
+      galois::no_stats(), galois::loopname("ApproxDeviation"));
+
+  return max_deviation.reduce();
+}
+
+/******************************************************************************/
+/* Running */
+/******************************************************************************/
+
+void
+DoApproxBC() {
+  if (!(epsilon > 0 && epsilon < 1) || !(delta > 0 && delta < 1)) {
+    GALOIS_DIE("epsilon and delta must be in (0, 1)");
+  }
+  if (sampleBatchSize < 2) {
+    GALOIS_DIE("sampleBatchSize must be at least 2");
+  }
+  if (batchSize < 1 || batchSize > LevelBatch::kMaxLanes) {
+    GALOIS_DIE("batchSize must be between 1 and ", LevelBatch::kMaxLanes);
+  }
+
+  galois::reportPageAlloc("MemAllocPre");
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<galois::graphs::PropertyFileGraph> pfg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  auto result = ConstructNodeProperties<NodeDataLevel>(pfg.get());
+  if (!result) {
+    GALOIS_LOG_FATAL("failed to construct node properties: {}", result.error());
+  }
+
+  auto pg_result =
+      galois::graphs::PropertyGraph<NodeDataLevel, EdgeDataLevel>::Make(
+          pfg.get());
+  if (!pg_result) {
+    GALOIS_LOG_FATAL("could not make property graph: {}", pg_result.error());
+  }
+  LevelGraph graph = pg_result.value();
+
+  std::cout << "Read " << graph.num_nodes() << " nodes, " << graph.num_edges()
+            << " edges\n";
+
+  uint64_t num_nodes = graph.num_nodes();
+  LevelInitializeGraph(&graph);
+  if (num_nodes < 3) {
+    // no node is inside a shortest path
+    LevelSanity(graph);
+    if (output) {
+      std::vector<double> results = makeResults(graph);
+      writeOutput(outputLocation, results.data(), results.size());
+    }
+    return;
+  }
+
+  // Hoeffding with a union bound over the nodes, with delta / 2
+  double hoeffding_log_term =
+      std::log(4 * static_cast<double>(num_nodes) / delta);
+  uint64_t max_samples =
+      std::ceil(hoeffding_log_term / (2 * epsilon * epsilon));
+  max_samples = std::max<uint64_t>(max_samples, 2);
+  // Checks happen after batches that double in size, so there are at most
+  // about log2(max_samples / sampleBatchSize) of them
+  uint64_t num_checks = 1;
+  for (uint64_t s = sampleBatchSize; s < max_samples; s *= 2) {
+    ++num_checks;
+  }
+  // Empirical Bernstein with a union bound over two sides, the nodes and the
+  // checks, with delta / 2
+  double bernstein_log_term =
+      std::log(8 * static_cast<double>(num_nodes) * num_checks / delta);
+
+  ApproxSums sums;
+  sums.sum.allocateBlocked(num_nodes);
+  sums.sum_squares.allocateBlocked(num_nodes);
+  galois::do_all(
+      galois::iterate(graph),
+      [&](LevelGNode n) {
+        sums.sum[n] = 0;
+        sums.sum_squares[n] = 0;
+        graph.GetData<NodeCurrentDist>(n) = kInfinity;
+      },
+      galois::no_stats(), galois::loopname("ApproxInitialize"));
+
+  std::unique_ptr<LevelBatch> batch_state;
+  if (batchSize > 1) {
+    batch_state = std::make_unique<LevelBatch>(graph, batchSize);
+  }
+
+  std::mt19937_64 generator(seed);
+  std::uniform_int_distribution<uint64_t> pick_source(0, num_nodes - 1);
+  std::vector<uint64_t> batch;
+  double scale = 1.0 / (num_nodes - 2);
+
+  galois::gInfo(
+      "Sampling at most ", max_samples, " sources in batches from ",
+      sampleBatchSize.getValue());
+  galois::StatTimer execTime("Timer_0");
+  execTime.start();
+
+  uint64_t num_samples = 0;
+  uint64_t next_check = std::min<uint64_t>(sampleBatchSize, max_samples);
+  double deviation = 0;
+  while (true) {
+    // draw the sources of the batch up front so that they depend only on seed
+    batch.clear();
+    for (uint64_t i = num_samples; i < next_check; ++i) {
+      batch.push_back(pick_source(generator));
+    }
+    if (batch_state) {
+      ApproxRunBatched(batch_state.get(), batch, scale, &sums);
+    } else {
+      for (uint64_t source : batch) {
+        kLevelCurrentSrcNode = source;
+        ApproxInitializeSource(&graph);
+        galois::gstl::Vector<LevelWorklistType> worklists = LevelSSSP(&graph);
+        LevelBackwardBrandes(&graph, &worklists);
+        ApproxAccumulateAndReset(&graph, &worklists, scale, &sums);
+      }
+    }
+    num_samples = next_check;
+
+    if (num_samples >= max_samples) {
+      deviation = epsilon;
+      break;
+    }
+    deviation =
+        ApproxMaxDeviation(graph, sums, num_samples, bernstein_log_term);
+    if (deviation <= epsilon) {
+      break;
+    }
+    next_check = std::min(2 * next_check, max_samples);
+  }
+
+  // BC is the sum of the dependencies of all n sources
+  double bc_scale = static_cast<double>(num_nodes) / scale / num_samples;
+  galois::do_all(
+      galois::iterate(graph),
+      [&](LevelGNode n) { graph.GetData<NodeBC>(n) = sums.sum[n] * bc_scale; },
+      galois::no_stats(), galois::loopname("ApproxScale"));
+
+  execTime.stop();
+
+  galois::reportPageAlloc("MemAllocPost");
+
+  galois::gPrint(
+      "Sampled ", num_samples, " sources; normalized BC error at most ",
+      deviation, " with probability ", 1 - delta, "\n");
+  galois::ReportStatSingle(REGION_NAME, "ApproxSamples", num_samples);
+  galois::ReportStatSingle(REGION_NAME, "ApproxMaxDeviation", deviation);
+
+  // sanity checking numbers
+  LevelSanity(graph);
+
+  if (output) {
+    std::vector<double> results = makeResults(graph);
+    assert(results.size() == graph.size());
+
+    writeOutput(outputLocation, results.data(), results.size());
+  }
+}
+#endif
@@ -26,7 +26,7 @@
 
 constexpr static const char* const REGION_NAME = "BC";
 
-enum Algo { Level = 0, Async, Outer, AutoAlgo };
+enum Algo { Level = 0, LevelBatched, Async, Outer, Approx, AutoAlgo };
 
 //TODO (gill): Reintroduce AutoAlgo when porting to propertyGraph
 // const char* const ALGO_NAMES[] = {"Level", "Async", "Outer", "Auto"};
@@ -73,11 +73,42 @@ static cll::opt<uint64_t> startSource(
 static cll::opt<Algo> algo(
     "algo", cll::desc("Choose an algorithm (default value AutoAlgo):"),
     cll::values(
-        clEnumVal(Level, "Level"), clEnumVal(Async, "Async"),
+        clEnumVal(Level, "Level"),
+        clEnumVal(LevelBatched, "LevelBatched: Level on batches of sources"),
+        clEnumVal(Async, "Async"),
         clEnumVal(Outer, "Outer"),
+        clEnumVal(Approx, "Approx: sample sources of Level BC"),
         clEnumVal(AutoAlgo, "Auto: choose among the algorithms automatically")),
     cll::init(AutoAlgo));
 
+static cll::opt<unsigned int> batchSize(
+    "batchSize",
+    cll::desc("LevelBatched/Approx: number of sources traversed together, "
+              "at most 64; Approx with 1 uses Level (default 64)"),
+    cll::init(64));
+
+static cll::opt<double> epsilon(
+    "epsilon",
+    cll::desc("Approx: largest error of the normalized BC of any node "
+              "(default 0.01)"),
+    cll::init(0.01));
+
+static cll::opt<double> delta(
+    "delta",
+    cll::desc("Approx: probability that some node exceeds the error "
+              "(default 0.1)"),
+    cll::init(0.1));
+
+static cll::opt<unsigned int> sampleBatchSize(
+    "sampleBatchSize",
+    cll::desc("Approx: number of sources sampled before the first check of "
+              "the error; batches double after each check (default 256)"),
+    cll::init(256));
+
+static cll::opt<uint64_t> seed(
+    "seed", cll::desc("Approx: seed for sampling sources (default 0)"),
+    cll::init(0));
+
 ////////////////////////////////////////////////////////////////////////////////
 
 static const char* name = "Betweenness Centrality";
@@ -92,7 +123,9 @@ static const char* desc =
 // @todo not the best coding practice; passing cl in via argument might be
 // better
 
+#include "ApproxStructs.h"
 #include "AsyncStructs.h"
+#include "LevelBatchedStructs.h"
 #include "LevelStructs.h"
 #include "OuterStructs.h"
 
@@ -128,6 +161,11 @@ main(int argc, char** argv) {
     galois::gInfo("Running level BC");
     DoLevelBC();
     break;
+  case LevelBatched:
+    // see LevelBatchedStructs.h
+    galois::gInfo("Running batched level BC");
+    DoLevelBatchedBC();
+    break;
     //TODO (gill) Needs bidirectional graph (CSR_CSC)
     //   case Async:
     //     // see AsyncStructs.h
@@ -139,6 +177,11 @@ main(int argc, char** argv) {
     galois::gInfo("Running outer BC");
     DoOuterBC();
     break;
+  case Approx:
+    // see ApproxStructs.h
+    galois::gInfo("Running approximate BC");
+    DoApproxBC();
+    break;
   default:
     GALOIS_DIE("Unknown BC algorithm type");
   }
@@ -0,0 +1,349 @@
+#ifndef GALOIS_BC_LEVEL_BATCHED
+#define GALOIS_BC_LEVEL_BATCHED
+
+#include "LevelStructs.h"
+#include "galois/LargeArray.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Batched Level BC runs the forward and backward phases of Level BC from up to
+// 64 sources at once, one lane per source, in the style of MS-BFS (Then et
+// al., VLDB '14). Each node keeps one bit per lane in 64-bit masks: the
+// lanes that have reached it and the lanes that reach it in the next level.
+// A node is expanded once per level for all the lanes whose frontier it is
+// in, so the edges of a node are read once per level rather than once per
+// source, and the sources of a batch share their traversal of the parts of
+// the graph that they reach at the same depth.
+//
+// The number of shortest paths and the dependency of every lane are separate
+// arrays, each laid out node-major with the lanes of a node contiguous, so
+// that expanding a node touches one cache line per array per 8 or 16 lanes.
+// The arrays take 12 bytes per node and lane.
+
+/**
+ * A node in the frontier of the lanes in mask.
+ */
+struct LevelBatchItem {
+  LevelGNode node;
+  uint64_t mask;
+};
+
+using LevelBatchWorklistType = galois::InsertBag<LevelBatchItem, 4096>;
+
+class LevelBatch {
+public:
+  static constexpr uint32_t kMaxLanes = 64;
+
+private:
+  const LevelGraph& graph_;
+  uint32_t num_lanes_;
+
+  //! lanes that have reached each node, up to the current level
+  galois::LargeArray<uint64_t> seen_;
+  //! lanes that reach each node in the next level
+  galois::LargeArray<std::atomic<uint64_t>> next_;
+  //! lanes in which each node is in the level after the one being
+  //! back-propagated
+  galois::LargeArray<uint64_t> successors_;
+  //! number of shortest paths, node-major
+  galois::LargeArray<std::atomic<LevelShortPathType>> sigma_;
+  //! dependency, node-major
+  galois::LargeArray<float> delta_;
+
+  //! nodes of each level with the lanes they are in; the last one is empty
+  galois::gstl::Vector<LevelBatchWorklistType> levels_;
+
+  size_t Index(LevelGNode n, uint32_t lane) const {
+    return size_t{n} * num_lanes_ + lane;
+  }
+
+  template <typename Fn>
+  static void ForEachLane(uint64_t mask, Fn fn) {
+    while (mask) {
+      fn(static_cast<uint32_t>(__builtin_ctzll(mask)));
+      mask &= mask - 1;
+    }
+  }
+
+  void Forward(const std::vector<uint64_t>& sources) {
+    levels_.emplace_back();
+    for (uint32_t lane = 0; lane < sources.size(); ++lane) {
+      LevelGNode source = sources[lane];
+      if (!seen_[source]) {
+        levels_[0].push(LevelBatchItem{source, 0});
+      }
+      seen_[source] |= uint64_t{1} << lane;
+      sigma_[Index(source, lane)] = 1;
+    }
+    // sources may repeat, so the masks of level 0 are final only now
+    for (LevelBatchItem& item : levels_[0]) {
+      item.mask = seen_[item.node];
+    }
+
+    galois::InsertBag<LevelGNode> reached;
+    for (size_t level = 0; !levels_[level].empty(); ++level) {
+      reached.clear();
+
+      galois::do_all(
+          galois::iterate(levels_[level]),
+          [&](const LevelBatchItem& item) {
+            LevelGNode n = item.node;
+            for (auto e : graph_.edges(n)) {
+              LevelGNode dest = *graph_.GetEdgeDest(e);
+              // seen_ only changes between levels
+              uint64_t discovered = item.mask & ~seen_[dest];
+              if (!discovered) {
+                continue;
+              }
+              // only the first thread to reach dest adds it to the worklist
+              if (!next_[dest].fetch_or(discovered)) {
+                reached.push(dest);
+              }
+              ForEachLane(discovered, [&](uint32_t lane) {
+                galois::atomicAdd(
+                    sigma_[Index(dest, lane)],
+                    sigma_[Index(n, lane)].load(std::memory_order_relaxed));
+              });
+            }
+          },
+          galois::steal(), galois::chunk_size<LEVEL_CHUNK_SIZE>(),
+          galois::no_stats(), galois::loopname("BatchedSSSP"));
+
+      levels_.emplace_back();
+      LevelBatchWorklistType& next_level = levels_[level + 1];
+      galois::do_all(
+          galois::iterate(reached),
+          [&](LevelGNode n) {
+            uint64_t mask = next_[n].exchange(0, std::memory_order_relaxed);
+            seen_[n] |= mask;
+            next_level.push(LevelBatchItem{n, mask});
+          },
+          galois::steal(), galois::no_stats(),
+          galois::loopname("BatchedSSSPNextLevel"));
+    }
+  }
+
+  void Backward() {
+    if (levels_.size() < 3) {
+      return;
+    }
+    // levels_.size() - 2 is the last non-empty level, whose dependencies are 0
+    for (size_t level = levels_.size() - 2; level-- > 1;) {
+      LevelBatchWorklistType& successor_level = levels_[level + 1];
+      galois::do_all(
+          galois::iterate(successor_level),
+          [&](const LevelBatchItem& item) {
+            successors_[item.node] = item.mask;
+          },
+          galois::no_stats(), galois::loopname("BatchedBrandesSuccessors"));
+
+      galois::do_all(
+          galois::iterate(levels_[level]),
+          [&](const LevelBatchItem& item) {
+            LevelGNode n = item.node;
+            for (auto e : graph_.edges(n)) {
+              LevelGNode dest = *graph_.GetEdgeDest(e);
+              ForEachLane(item.mask & successors_[dest], [&](uint32_t lane) {
+                // grab dependency, add to self
+                delta_[Index(n, lane)] +=
+                    ((float)1 + delta_[Index(dest, lane)]) /
+                    sigma_[Index(dest, lane)].load(std::memory_order_relaxed);
+              });
+            }
+            // multiply at end to get final dependency value
+            ForEachLane(item.mask, [&](uint32_t lane) {
+              delta_[Index(n, lane)] *=
+                  sigma_[Index(n, lane)].load(std::memory_order_relaxed);
+            });
+          },
+          galois::steal(), galois::chunk_size<LEVEL_CHUNK_SIZE>(),
+          galois::no_stats(), galois::loopname("BatchedBrandes"));
+
+      galois::do_all(
+          galois::iterate(successor_level),
+          [&](const LevelBatchItem& item) { successors_[item.node] = 0; },
+          galois::no_stats(), galois::loopname("BatchedBrandesSuccessors"));
+    }
+  }
+
+public:
+  uint32_t num_lanes() const { return num_lanes_; }
+
+  /**
+   * Allocates the per-node state of num_lanes lanes.
+   *
+   * @param graph LevelGraph to run on
+   * @param num_lanes Largest number of sources of a batch, at most kMaxLanes
+   */
+  LevelBatch(const LevelGraph& graph, uint32_t num_lanes)
+      : graph_(graph), num_lanes_(num_lanes) {
+    GALOIS_ASSERT(num_lanes > 0 && num_lanes <= kMaxLanes);
+    size_t num_nodes = graph.num_nodes();
+    seen_.allocateBlocked(num_nodes);
+    next_.allocateBlocked(num_nodes);
+    successors_.allocateBlocked(num_nodes);
+    sigma_.allocateBlocked(num_nodes * num_lanes);
+    delta_.allocateBlocked(num_nodes * num_lanes);
+
+    galois::do_all(
+        galois::iterate(size_t{0}, num_nodes),
+        [&](size_t n) {
+          seen_[n] = 0;
+          next_.constructAt(n, 0);
+          successors_[n] = 0;
+          for (uint32_t lane = 0; lane < num_lanes_; ++lane) {
+            sigma_.constructAt(Index(n, lane), 0);
+            delta_[Index(n, lane)] = 0;
+          }
+        },
+        galois::no_stats(), galois::loopname("BatchedInitialize"));
+  }
+
+  /**
+   * Runs the forward and backward phases from sources, one lane per source,
+   * after which ForEachDependency visits their dependencies.
+   *
+   * @param sources At most num_lanes sources; repeats are allowed
+   */
+  void Run(const std::vector<uint64_t>& sources) {
+    GALOIS_ASSERT(sources.size() <= num_lanes_);
+    Reset();
+    Forward(sources);
+    Backward();
+  }
+
+  /**
+   * Calls fn(node, lane, dependency) for each node reached by a lane of the
+   * last run other than its source. Calls for the same node are never
+   * concurrent.
+   */
+  template <typename Fn>
+  void ForEachDependency(Fn fn) {
+    for (size_t level = 1; level < levels_.size(); ++level) {
+      galois::do_all(
+          galois::iterate(levels_[level]),
+          [&](const LevelBatchItem& item) {
+            ForEachLane(item.mask, [&](uint32_t lane) {
+              fn(item.node, lane, delta_[Index(item.node, lane)]);
+            });
+          },
+          galois::steal(), galois::no_stats(),
+          galois::loopname("BatchedDependencies"));
+    }
+  }
+
+private:
+  //! Clears the state of the nodes the last run reached
+  void Reset() {
+    for (LevelBatchWorklistType& level : levels_) {
+      galois::do_all(
+          galois::iterate(level),
+          [&](const LevelBatchItem& item) {
+            seen_[item.node] = 0;
+            ForEachLane(item.mask, [&](uint32_t lane) {
+              sigma_[Index(item.node, lane)] = 0;
+              delta_[Index(item.node, lane)] = 0;
+            });
+          },
+          galois::no_stats(), galois::loopname("BatchedReset"));
+    }
+    levels_.clear();
+  }
+};
+
+/******************************************************************************/
+/* Running */
+/******************************************************************************/
+
+void
+DoLevelBatchedBC() {
+  // reading in list of sources to operate on if provided
+  std::ifstream source_file;
+  std::vector<uint64_t> source_vector;
+
+  if (batchSize < 1 || batchSize > LevelBatch::kMaxLanes) {
+    GALOIS_DIE("batchSize must be between 1 and ", LevelBatch::kMaxLanes);
+  }
+
+  galois::ReportStatSingle(REGION_NAME, "BatchSize", batchSize);
+  galois::reportPageAlloc("MemAllocPre");
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<galois::graphs::PropertyFileGraph> pfg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  auto result = ConstructNodeProperties<NodeDataLevel>(pfg.get());
+  if (!result) {
+    GALOIS_LOG_FATAL("failed to construct node properties: {}", result.error());
+  }
+
+  auto pg_result =
+      galois::graphs::PropertyGraph<NodeDataLevel, EdgeDataLevel>::Make(
+          pfg.get());
+  if (!pg_result) {
+    GALOIS_LOG_FATAL("could not make property graph: {}", pg_result.error());
+  }
+  LevelGraph graph = pg_result.value();
+
+  std::cout << "Read " << graph.num_nodes() << " nodes, " << graph.num_edges()
+            << " edges\n";
+
+  // If particular set of sources was specified, use them
+  if (sourcesToUse != "") {
+    source_file.open(sourcesToUse);
+    std::vector<uint64_t> t(
+        std::istream_iterator<uint64_t>{source_file},
+        std::istream_iterator<uint64_t>{});
+    source_vector = t;
+    source_file.close();
+  }
+
+  // determine which sources to use based on command line args, as Level does
+  std::vector<uint64_t> sources;
+  if (singleSourceBC) {
+    sources.push_back(startSource);
+  } else {
+    uint64_t loop_end = numOfSources ? numOfSources : graph.size();
+    if (source_vector.size() != 0) {
+      loop_end = std::min<uint64_t>(loop_end, source_vector.size());
+      sources.assign(source_vector.begin(), source_vector.begin() + loop_end);
+    } else {
+      for (uint64_t i = 0; i < loop_end; ++i) {
+        sources.push_back(i);
+      }
+    }
+  }
+
+  LevelInitializeGraph(&graph);
+  LevelBatch batch_state(graph, batchSize);
+  galois::reportPageAlloc("MemAllocMid");
+
+  galois::gInfo("Beginning main computation");
+  galois::StatTimer execTime("Timer_0");
+  execTime.start();
+
+  std::vector<uint64_t> batch;
+  for (size_t begin = 0; begin < sources.size(); begin += batchSize) {
+    size_t end = std::min<size_t>(begin + batchSize, sources.size());
+    batch.assign(sources.begin() + begin, sources.begin() + end);
+    batch_state.Run(batch);
+    batch_state.ForEachDependency([&](LevelGNode n, uint32_t, float dep) {
+      graph.GetData<NodeBC>(n) += dep;
+    });
+  }
+
+  execTime.stop();
+
+  galois::reportPageAlloc("MemAllocPost");
+
+  // sanity checking numbers
+  LevelSanity(graph);
+
+  if (output) {
+    std::vector<double> results = makeResults(graph);
+    assert(results.size() == graph.size());
+
+    writeOutput(outputLocation, results.data(), results.size());
+  }
+}
+#endif
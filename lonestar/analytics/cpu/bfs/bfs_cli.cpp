@@ -49,9 +49,27 @@ static cll::opt<BfsPlan::Algorithm> algo(
         clEnumVal(BfsPlan::kAsyncTile, "AsyncTile"),
         clEnumVal(BfsPlan::kAsync, "Async"),
         clEnumVal(BfsPlan::kSyncTile, "SyncTile"),
-        clEnumVal(BfsPlan::kSync, "Sync")),
+        clEnumVal(BfsPlan::kSync, "Sync"),
+        clEnumVal(BfsPlan::kSyncDirectionOpt, "SyncDirectionOpt")),
     cll::init(BfsPlan::kSyncTile));
 
+static cll::opt<uint32_t> alpha(
+    "alpha",
+    cll::desc("alpha value to change direction in direction-optimization "
+              "(default value 15)"),
+    cll::init(15));
+static cll::opt<uint32_t> beta(
+    "beta",
+    cll::desc("beta value to change direction in direction-optimization "
+              "(default value 18)"),
+    cll::init(18));
+static cll::opt<uint32_t> denseFrontierDivisor(
+    "denseFrontierDivisor",
+    cll::desc("Use a dense frontier when the frontier has more than "
+              "1/denseFrontierDivisor of the edges; 0 disables (default "
+              "value 20)"),
+    cll::init(galois::analytics::kDefaultDenseFrontierDivisor));
+
 std::string
 AlgorithmName(BfsPlan::Algorithm algorithm) {
   switch (algorithm) {
@@ -63,6 +81,8 @@ AlgorithmName(BfsPlan::Algorithm algorithm) {
     return "SyncTile";
   case BfsPlan::kSync:
     return "Sync";
+  case BfsPlan::kSyncDirectionOpt:
+    return "SyncDirectionOpt";
   default:
     return "Unknown";
   }
@@ -111,12 +131,20 @@ main(int argc, char** argv) {
 
   galois::reportPageAlloc("MeminfoPre");
 
-  if (auto r = Bfs(pfg.get(), startNode, "level", BfsPlan::FromAlgorithm(algo));
-      !r) {
-    std::cerr << r.error().message() << "\n";
-    abort();
+  BfsPlan plan = BfsPlan::FromAlgorithm(algo);
+  if (algo == BfsPlan::kSyncDirectionOpt) {
+    plan = BfsPlan::SyncDirectionOpt(alpha, beta);
+  } else if (algo == BfsPlan::kSync) {
+    plan = BfsPlan::Sync(denseFrontierDivisor);
   }
 
+  LonestarRun(pfg.get(), {"level"}, {}, [&]() {
+    if (auto r = Bfs(pfg.get(), startNode, "level", plan); !r) {
+      std::cerr << r.error().message() << "\n";
+      abort();
+    }
+  });
+
   auto pg_result = BfsImplementation::Graph::Make(pfg.get(), {"level"}, {});
   if (!pg_result) {
     std::cerr << pg_result.error().message() << "\n";
@@ -179,6 +207,8 @@ main(int argc, char** argv) {
     writeOutput(outputLocation, results.data(), results.size());
   }
 
+  LonestarCommit(pfg.get());
+
   totalTime.stop();
 
   return 0;
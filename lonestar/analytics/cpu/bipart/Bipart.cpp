@@ -74,6 +74,12 @@ static cll::opt<bool> hyper_metis_graph(
         "(http://glaros.dtc.umn.edu/gkhome/fetch/sw/hmetis/manual.pdf)"),
     cll::init(false));
 
+static cll::opt<std::string> hedge_label(
+    "hedgeLabel",
+    cll::desc(
+        "Read the input as a bipartite property graph whose hyperedges are "
+        "the nodes with this boolean node property (label) set"));
+
 static cll::opt<bool> skip_lone_hedges(
     "skip_lone_hedges",
     cll::desc("Specify if degree 1 hyperedges should not be included"),
@@ -576,18 +582,24 @@ main(int argc, char** argv) {
   total_time.start();
   galois::StatTimer create_partition_time("Create-Partitions");
 
-  if (!hyper_metis_graph) {
+  if (!hyper_metis_graph && hedge_label.empty()) {
     GALOIS_LOG_FATAL(
         "This application requires a HyperGraph Metis input;"
         " please use the -hyperMetisGraph flag "
         " to indicate the input is a valid HyperGraph Metis format "
-        "(http://glaros.dtc.umn.edu/gkhome/fetch/sw/hmetis/manual.pdf).");
+        "(http://glaros.dtc.umn.edu/gkhome/fetch/sw/hmetis/manual.pdf),"
+        " or a bipartite property graph with the -hedgeLabel flag.");
   }
 
   MetisGraph metis_graph;
   HyperGraph* graph = &metis_graph.graph;
 
-  ConstructGraph(graph, input_file, skip_lone_hedges);
+  if (!hedge_label.empty()) {
+    ConstructGraphFromPropertyGraph(
+        graph, input_file, hedge_label, skip_lone_hedges);
+  } else {
+    ConstructGraph(graph, input_file, skip_lone_hedges);
+  }
 
   uint32_t total_num_nodes = graph->size();
   uint32_t num_hedges = graph->GetHedges();
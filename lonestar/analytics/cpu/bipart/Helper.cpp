@@ -1,5 +1,7 @@
 #include "Helper.h"
 
+#include "Lonestar/Utils.h"
+
 /**
  * Initialize the nodes in the graph
  *
@@ -140,6 +142,56 @@ ConstructGraph(
       " Time to construct Metis Graph ", timer_graph_construt.get(), "\n");
 }
 
+void
+ConstructGraphFromPropertyGraph(
+    HyperGraph* graph, const std::string& rdg_name,
+    const std::string& hedge_label, const bool skip_isolated_hedges) {
+  std::unique_ptr<galois::graphs::PropertyFileGraph> pfg =
+      MakeFileGraph(rdg_name, {hedge_label}, {});
+  if (pfg->HasWideNodeIds()) {
+    GALOIS_LOG_FATAL("ERROR: graphs with 64-bit node ids are not supported");
+  }
+  std::shared_ptr<arrow::ChunkedArray> labels = pfg->NodeProperty(hedge_label);
+  if (!labels) {
+    GALOIS_LOG_FATAL("ERROR: no node property {}", hedge_label);
+  }
+  if (labels->type()->id() != arrow::Type::BOOL) {
+    GALOIS_LOG_FATAL("ERROR: node property {} is not boolean", hedge_label);
+  }
+
+  galois::StatTimer timer_graph_construt("MetisGraphConstruct");
+  timer_graph_construt.start();
+
+  // Unpack the label bits once; null labels mark vertices.
+  const galois::graphs::GraphTopology& topology = pfg->topology();
+  uint64_t num_nodes = topology.num_nodes();
+  galois::LargeArray<uint8_t> is_hedge;
+  is_hedge.allocateInterleaved(num_nodes);
+  uint64_t chunk_begin = 0;
+  for (const std::shared_ptr<arrow::Array>& chunk : labels->chunks()) {
+    auto array = std::static_pointer_cast<arrow::BooleanArray>(chunk);
+    galois::do_all(
+        galois::iterate(int64_t{0}, array->length()),
+        [&](int64_t i) {
+          is_hedge[chunk_begin + i] = array->IsValid(i) && array->Value(i);
+        },
+        galois::no_stats());
+    chunk_begin += array->length();
+  }
+
+  graph->ConstructFromBipartite(
+      num_nodes, num_nodes == 0 ? nullptr : topology.out_indices->raw_values(),
+      topology.num_edges() == 0 ? nullptr : topology.out_dests->raw_values(),
+      [&](uint32_t n) { return is_hedge[n] != 0; }, skip_isolated_hedges);
+  InitNodes(graph, graph->GetHedges());
+
+  timer_graph_construt.stop();
+  galois::gPrint(" Number of hedges: ", graph->GetHedges(), "\n");
+  galois::gPrint(" Number of nodes: ", graph->GetHnodes(), "\n");
+  galois::gPrint(
+      " Time to construct Metis Graph ", timer_graph_construt.get(), "\n");
+}
+
 /**
  * Priority assinging functions.
  */
@@ -288,10 +340,16 @@ void
 InitGain(
     const std::vector<std::pair<uint32_t, uint32_t>>& combined_edgelist,
     const std::vector<std::pair<uint32_t, uint32_t>>& combined_nodelist,
-    const std::vector<HyperGraph*>& g) {
+    const std::vector<HyperGraph*>& g, galois::InsertBag<uint32_t>* boundary) {
   uint32_t total_nodes = combined_nodelist.size();
   uint32_t total_hedges = combined_edgelist.size();
 
+  // Set once a node is added to boundary
+  galois::DynamicBitset is_boundary;
+  if (boundary != nullptr) {
+    is_boundary.resize(total_nodes);
+  }
+
   galois::do_all(
       galois::iterate(uint32_t{0}, total_nodes),
       [&](uint32_t n) {
@@ -357,6 +415,10 @@ InitGain(
 
             if (nodep == 1) {
               positive_gain_vector[list_index] += 1;
+              // Only a node of a cut hyperedge gets a positive gain
+              if (boundary != nullptr && !is_boundary.set(list_index)) {
+                boundary->push(list_index);
+              }
             }
             if (nodep == (num_p0_nodes + num_p1_nodes)) {
               // it means that one of p1 or p2 is zero.
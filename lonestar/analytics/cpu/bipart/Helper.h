@@ -21,6 +21,20 @@ void InitNodes(HyperGraph* graph, uint32_t num_hedges);
 void ConstructGraph(
     HyperGraph* graph, const std::string filename,
     const bool skip_isolated_hedges);
+
+/**
+ * Constructs the hypergraph in parallel from a bipartite property graph
+ * whose hyperedges are the nodes with the boolean node property hedge_label
+ * set and whose vertices are the other nodes (\see
+ * HyperGraph::ConstructFromBipartite)
+ *
+ * @param graph Graph to be constructed
+ * @param rdg_name Input property graph
+ * @param hedge_label Node property marking the hyperedges
+ */
+void ConstructGraphFromPropertyGraph(
+    HyperGraph* graph, const std::string& rdg_name,
+    const std::string& hedge_label, const bool skip_isolated_hedges);
 /**
  * Priority assinging functions.
  */
@@ -32,8 +46,18 @@ void PrioritizeDegree(GNode node, HyperGraph* fine_graph);
 void SortNodesByGainAndWeight(
     HyperGraph* graph, std::vector<GNode>* nodes, uint32_t end_offset);
 void InitGain(HyperGraph* g);
+/**
+ * Computes the gains of the nodes of the graphs in g
+ *
+ * @param combined_edgelist Concatenated list of hyperedges of the graphs
+ * @param combined_nodelist Concatenated list of nodes of the graphs
+ * @param g Vector of graphs
+ * @param boundary If not null, the indices in combined_nodelist of the
+ * boundary nodes, the ones with a positive gain, are added to it once each
+ */
 void InitGain(
     const std::vector<std::pair<uint32_t, uint32_t>>& combined_edgelist,
     const std::vector<std::pair<uint32_t, uint32_t>>& combined_nodelist,
-    const std::vector<HyperGraph*>& g);
+    const std::vector<HyperGraph*>& g,
+    galois::InsertBag<uint32_t>* boundary = nullptr);
 #endif
@@ -43,135 +43,164 @@ ResetCounter(HyperGraph* g) {
       galois::loopname("Refining-Reset-Counter"));
 }
 
+/**
+ * Adds the num_selected nodes of candidates with the largest gains to
+ * selected, ties broken by smaller node id. Instead of sorting the candidates,
+ * their gains are counted in per-thread buckets to find the smallest selected
+ * gain, and only the candidates with that gain are compared by node id.
+ *
+ * @param g Graph of the candidates
+ * @param candidates Nodes with non-negative gains
+ * @param num_candidates Number of nodes in candidates
+ * @param num_selected Number of nodes to select, at most num_candidates
+ * @param selected Bag to add the selected nodes to
+ */
 void
-ParallelSwaps(
-    const std::vector<std::pair<uint32_t, uint32_t>>& combined_edgelist,
-    const std::vector<std::pair<uint32_t, uint32_t>>& combined_nodelist,
-    std::vector<HyperGraph*>* g, const uint32_t refine_max_levels) {
-  uint32_t num_partitions = g->size();
-  std::vector<galois::GAccumulator<WeightTy>> accum(num_partitions);
-  std::vector<galois::GAccumulator<WeightTy>> node_size(num_partitions);
-
-  uint32_t total_nodes = combined_nodelist.size();
+SelectMaxGainNodes(
+    HyperGraph* g, GNodeBag& candidates, uint32_t num_candidates,
+    uint32_t num_selected, GNodeBag* selected) {
+  if (num_selected == 0) {
+    return;
+  }
+  if (num_selected == num_candidates) {
+    galois::do_all(
+        galois::iterate(candidates), [&](GNode n) { selected->push(n); },
+        galois::loopname("Refining-Select-All"));
+    return;
+  }
 
+  galois::GReduceMax<GainTy> max_gain;
   galois::do_all(
-      galois::iterate(uint32_t{0}, total_nodes),
-      [&](uint32_t v) {
-        auto node_index_pair = combined_nodelist[v];
-        uint32_t index = node_index_pair.second;
-        GNode n = node_index_pair.first;
-        MetisNode& node_data = g->at(index)->getData(n);
-        WeightTy weight = node_data.weight;
+      galois::iterate(candidates),
+      [&](GNode n) { max_gain.update(g->getData(n).GetGain()); },
+      galois::loopname("Refining-Max-Gain"));
+  uint32_t num_buckets = max_gain.reduce() + 1;
+
+  galois::substrate::PerThreadStorage<std::vector<uint32_t>> bucket_sizes;
+  uint32_t num_threads = galois::getActiveThreads();
+  galois::on_each([&](uint32_t, uint32_t) {
+    bucket_sizes.getLocal()->assign(num_buckets, 0);
+  });
+  galois::do_all(
+      galois::iterate(candidates),
+      [&](GNode n) { (*bucket_sizes.getLocal())[g->getData(n).GetGain()]++; },
+      galois::loopname("Refining-Bucket-Gains"));
+
+  // Find the smallest selected gain and the number of candidates with a
+  // larger one
+  GainTy min_gain = num_buckets;
+  uint32_t num_larger{0};
+  while (true) {
+    --min_gain;
+    uint32_t bucket_size{0};
+    for (uint32_t i = 0; i < num_threads; i++) {
+      bucket_size += (*bucket_sizes.getRemote(i))[min_gain];
+    }
+    if (num_larger + bucket_size >= num_selected) {
+      break;
+    }
+    num_larger += bucket_size;
+  }
 
-        node_size[index] += weight;
-        if (node_data.partition > 0) {
-          accum[index] += weight;
+  GNodeBag ties;
+  galois::do_all(
+      galois::iterate(candidates),
+      [&](GNode n) {
+        GainTy gain = g->getData(n).GetGain();
+        if (gain > min_gain) {
+          selected->push(n);
+        } else if (gain == min_gain) {
+          ties.push(n);
         }
       },
-      galois::loopname("Refining-Make-Balance-Swap"));
+      galois::loopname("Refining-Select-Max-Gains"));
+
+  std::vector<GNode> tie_vec(ties.begin(), ties.end());
+  uint32_t num_ties = num_selected - num_larger;
+  std::nth_element(
+      tie_vec.begin(), tie_vec.begin() + num_ties, tie_vec.end(),
+      [&g](GNode l_opr, GNode r_opr) {
+        return g->getData(l_opr).node_id < g->getData(r_opr).node_id;
+      });
+  for (uint32_t i = 0; i < num_ties; i++) {
+    selected->push(tie_vec[i]);
+  }
+}
 
-  GNodeBag partition_zero_nodes;
-  GNodeBag partition_one_nodes;
+void
+ParallelSwaps(
+    const std::vector<std::pair<uint32_t, uint32_t>>& combined_edgelist,
+    const std::vector<std::pair<uint32_t, uint32_t>>& combined_nodelist,
+    std::vector<HyperGraph*>* g, const uint32_t refine_max_levels) {
+  uint32_t num_partitions = g->size();
+
+  // Boundary nodes as indices in combined_nodelist; only they can have a
+  // non-negative gain
+  galois::InsertBag<uint32_t> boundary;
+  // Boundary nodes with a non-negative gain of each graph and partition
+  std::vector<std::array<GNodeBag, 2>> candidates(num_partitions);
   GNodeBag swap_bag;
-  std::vector<GNode> partition_zero_nodes_bag;
-  std::vector<GNode> partition_one_nodes_bag;
-  uint32_t num_partition_zero_nodes{0};
-  uint32_t num_partition_one_nodes{0};
 
   galois::StatTimer init_gain_timer("Refining-Init-Gains");
-  galois::StatTimer sort_timer("Refining-Sort");
+  galois::StatTimer select_timer("Refining-Select");
 
   for (uint32_t pass = 0; pass < refine_max_levels; pass++) {
+    boundary.clear();
     init_gain_timer.start();
-    InitGain(combined_edgelist, combined_nodelist, *g);
+    InitGain(combined_edgelist, combined_nodelist, *g, &boundary);
     init_gain_timer.stop();
 
+    for (std::array<GNodeBag, 2>& graph_candidates : candidates) {
+      graph_candidates[0].clear();
+      graph_candidates[1].clear();
+    }
+
+    galois::do_all(
+        galois::iterate(boundary),
+        [&](uint32_t list_index) {
+          auto node_index_pair = combined_nodelist[list_index];
+          GNode n = node_index_pair.first;
+          uint32_t index = node_index_pair.second;
+          MetisNode& node_data = g->at(index)->getData(n);
+
+          if (node_data.GetGain() < 0) {
+            return;
+          }
+
+          uint32_t partition = node_data.partition;
+          candidates[index][partition == 0 ? 0 : 1].push(n);
+        },
+        galois::steal(), galois::loopname("Refining-Find-Partition-Nodes"));
+
     for (uint32_t i = 0; i < num_partitions; i++) {
       if (g->at(i) == nullptr) {
         continue;
       }
-      HyperGraph& cur_graph = *g->at(i);
-
-      partition_zero_nodes.clear();
-      partition_one_nodes.clear();
-      partition_zero_nodes_bag.clear();
-      partition_one_nodes_bag.clear();
-      swap_bag.clear();
-
-      galois::do_all(
-          galois::iterate(
-              cur_graph.GetHedges(), static_cast<uint32_t>(cur_graph.size())),
-          [&](uint32_t n) {
-            MetisNode& node_data = cur_graph.getData(n);
-
-            if (!node_data.positive_gain && !node_data.negative_gain) {
-              return;
-            }
-
-            GainTy gain = node_data.GetGain();
+      HyperGraph* cur_graph = g->at(i);
+      GNodeBag& partition_zero_nodes = candidates[i][0];
+      GNodeBag& partition_one_nodes = candidates[i][1];
 
-            if (gain < 0) {
-              return;
-            }
-
-            uint32_t partition = node_data.partition;
-
-            if (partition == 0) {
-              partition_zero_nodes.push(n);
-            } else {
-              partition_one_nodes.push(n);
-            }
-          },
-          galois::loopname("Refining-Find-Partition-Nodes"));
-
-      num_partition_zero_nodes = std::distance(
+      uint32_t num_partition_zero_nodes = std::distance(
           partition_zero_nodes.begin(), partition_zero_nodes.end());
-      num_partition_one_nodes =
+      uint32_t num_partition_one_nodes =
           std::distance(partition_one_nodes.begin(), partition_one_nodes.end());
+      uint32_t num_swap_nodes =
+          std::min(num_partition_zero_nodes, num_partition_one_nodes);
 
-      for (uint32_t n : partition_zero_nodes) {
-        partition_zero_nodes_bag.push_back(n);
-      }
-      for (uint32_t n : partition_one_nodes) {
-        partition_one_nodes_bag.push_back(n);
-      }
-
-      sort_timer.start();
-      for (uint32_t iter = 0; iter < 2; iter++) {
-        auto& cur_bag =
-            (iter == 0) ? partition_zero_nodes_bag : partition_one_nodes_bag;
-        std::sort(
-            cur_bag.begin(), cur_bag.end(),
-            [&cur_graph](GNode& l_opr, GNode& r_opr) {
-              MetisNode& l_data = cur_graph.getData(l_opr);
-              MetisNode& r_data = cur_graph.getData(r_opr);
-              GainTy l_gain = l_data.GetGain();
-              GainTy r_gain = r_data.GetGain();
-
-              if (l_gain == r_gain) {
-                uint32_t l_nid = l_data.node_id;
-                uint32_t r_nid = r_data.node_id;
-
-                return l_nid < r_nid;
-              }
-
-              return l_gain > r_gain;
-            });
-      }
-      sort_timer.stop();
+      swap_bag.clear();
+      select_timer.start();
+      SelectMaxGainNodes(
+          cur_graph, partition_zero_nodes, num_partition_zero_nodes,
+          num_swap_nodes, &swap_bag);
+      SelectMaxGainNodes(
+          cur_graph, partition_one_nodes, num_partition_one_nodes,
+          num_swap_nodes, &swap_bag);
+      select_timer.stop();
 
-      uint32_t num_swap_nodes =
-          (num_partition_zero_nodes <= num_partition_one_nodes)
-              ? num_partition_zero_nodes
-              : num_partition_one_nodes;
-      for (uint32_t i = 0; i < num_swap_nodes; i++) {
-        swap_bag.push(partition_one_nodes_bag[i]);
-        swap_bag.push(partition_zero_nodes_bag[i]);
-      }
       galois::do_all(
           galois::iterate(swap_bag),
           [&](GNode n) {
-            MetisNode& node_data = cur_graph.getData(n);
+            MetisNode& node_data = cur_graph->getData(n);
             uint32_t partition = node_data.partition;
             node_data.partition = 1 - partition;
             node_data.IncCounter();
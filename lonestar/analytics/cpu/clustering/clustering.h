@@ -20,21 +20,43 @@
 #ifndef CLUSTERING_H
 #define CLUSTERING_H
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <memory>
 #include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <llvm/Support/CommandLine.h>
 
+#include "Lonestar/Utils.h"
 #include "galois/AtomicHelpers.h"
+#include "galois/DynamicBitset.h"
 #include "galois/Galois.h"
 #include "galois/LargeArray.h"
+#include "galois/ParallelSTL.h"
+#include "galois/analytics/Utils.h"
+#include "galois/graphs/PropertyFileGraph.h"
+#include "galois/graphs/PropertyGraph.h"
+#include "galois/substrate/PerThreadStorage.h"
 
 namespace cll = llvm::cl;
 static cll::opt<bool> enable_VF(
     "enable_VF", cll::desc("Flag to enable vertex following optimization."),
     cll::init(false));
 
+static cll::opt<bool> enable_pruning(
+    "enable_pruning",
+    cll::desc(
+        "Flag to only revisit nodes whose neighbors changed community in "
+        "the previous iteration."),
+    cll::init(false));
+
 static cll::opt<double> c_threshold(
     "c_threshold", cll::desc("Threshold for modularity gain"), cll::init(0.01));
 
@@ -77,15 +99,142 @@ constexpr static const uint64_t UNASSIGNED =
 constexpr static const double DOUBLE_MAX =
     std::numeric_limits<double>::max() / 4;
 
-constexpr galois::MethodFlag flag_no_lock = galois::MethodFlag::UNPROTECTED;
-constexpr galois::MethodFlag flag_read_lock = galois::MethodFlag::READ;
-constexpr galois::MethodFlag flag_write_lock = galois::MethodFlag::WRITE;
-
 typedef galois::LargeArray<uint64_t> largeArray;
 typedef float EdgeTy;
 // typedef uint32_t EdgeTy;
 typedef galois::LargeArray<EdgeTy> largeArrayEdgeTy;
 
+/*
+ * Node properties; each algorithm uses the ones it needs
+ */
+struct PreviousCommunityId : public galois::PODProperty<uint64_t> {};
+struct CurrentCommunityId : public galois::PODProperty<uint64_t> {};
+struct DegreeWeight : public galois::PODProperty<EdgeTy> {};
+struct ColorId : public galois::PODProperty<int64_t> {};
+/** Only required for Leiden **/
+struct CurrentSubCommunityId : public galois::PODProperty<uint64_t> {};
+struct NodeWeight : public galois::PODProperty<uint64_t> {};
+
+/*
+ * Edge properties
+ */
+struct EdgeWeight : public galois::PODProperty<EdgeTy> {};
+using EdgeData = std::tuple<EdgeWeight>;
+
+/**
+ * Name of the edge weights of every level; the input weights, if any, are
+ * converted to EdgeTy into this property
+ */
+constexpr static const char* kEdgeWeightProperty = "clustering_edge_weight";
+
+template <typename InputWeightTy>
+void
+copyEdgeWeights(
+    galois::graphs::PropertyFileGraph* pfg,
+    const std::string& input_property_name) {
+  struct InputWeight : public galois::PODProperty<InputWeightTy> {};
+  using InputGraph =
+      galois::graphs::PropertyGraph<std::tuple<>, std::tuple<InputWeight>>;
+  using Graph = galois::graphs::PropertyGraph<std::tuple<>, EdgeData>;
+
+  auto input_result = InputGraph::Make(pfg, {}, {input_property_name});
+  if (!input_result) {
+    GALOIS_LOG_FATAL("could not make property graph: {}", input_result.error());
+  }
+  InputGraph input = input_result.value();
+
+  auto pg_result = Graph::Make(pfg, {}, {kEdgeWeightProperty});
+  if (!pg_result) {
+    GALOIS_LOG_FATAL("could not make property graph: {}", pg_result.error());
+  }
+  Graph graph = pg_result.value();
+
+  galois::do_all(
+      galois::iterate(uint64_t{0}, graph.num_edges()),
+      [&](uint64_t e) {
+        graph.GetEdgeData<EdgeWeight>(e) =
+            static_cast<EdgeTy>(input.template GetEdgeData<InputWeight>(e));
+      },
+      galois::no_stats());
+}
+
+/**
+ * Adds the kEdgeWeightProperty edge property to pfg: the weights of
+ * input_property_name, or 1 for every edge if it is empty.
+ */
+void
+constructEdgeWeights(
+    galois::graphs::PropertyFileGraph* pfg,
+    const std::string& input_property_name) {
+  if (auto r = ConstructEdgeProperties<EdgeData>(pfg, {kEdgeWeightProperty});
+      !r) {
+    GALOIS_LOG_FATAL("failed to construct edge properties: {}", r.error());
+  }
+
+  if (input_property_name.empty()) {
+    auto pg_result =
+        galois::graphs::PropertyGraph<std::tuple<>, EdgeData>::Make(
+            pfg, {}, {kEdgeWeightProperty});
+    if (!pg_result) {
+      GALOIS_LOG_FATAL("could not make property graph: {}", pg_result.error());
+    }
+    auto graph = pg_result.value();
+    galois::do_all(
+        galois::iterate(uint64_t{0}, graph.num_edges()),
+        [&](uint64_t e) { graph.GetEdgeData<EdgeWeight>(e) = 1; },
+        galois::no_stats());
+    return;
+  }
+
+  switch (pfg->EdgeProperty(input_property_name)->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    copyEdgeWeights<uint32_t>(pfg, input_property_name);
+    break;
+  case arrow::Int32Type::type_id:
+    copyEdgeWeights<int32_t>(pfg, input_property_name);
+    break;
+  case arrow::UInt64Type::type_id:
+    copyEdgeWeights<uint64_t>(pfg, input_property_name);
+    break;
+  case arrow::Int64Type::type_id:
+    copyEdgeWeights<int64_t>(pfg, input_property_name);
+    break;
+  case arrow::FloatType::type_id:
+    copyEdgeWeights<float>(pfg, input_property_name);
+    break;
+  case arrow::DoubleType::type_id:
+    copyEdgeWeights<double>(pfg, input_property_name);
+    break;
+  default:
+    GALOIS_LOG_FATAL(
+        "unsupported edge weight type: {}",
+        pfg->EdgeProperty(input_property_name)->type()->ToString());
+  }
+}
+
+/**
+ * Adds the node properties of GraphTy to pfg, which must have the
+ * kEdgeWeightProperty edge property, and returns the graph over them.
+ */
+template <typename GraphTy>
+GraphTy
+makeClusteringGraph(
+    galois::graphs::PropertyFileGraph* pfg,
+    const std::vector<std::string>& node_property_names) {
+  if (auto r = ConstructNodeProperties<typename GraphTy::node_properties>(
+          pfg, node_property_names);
+      !r) {
+    GALOIS_LOG_FATAL("failed to construct node properties: {}", r.error());
+  }
+
+  auto pg_result =
+      GraphTy::Make(pfg, node_property_names, {kEdgeWeightProperty});
+  if (!pg_result) {
+    GALOIS_LOG_FATAL("could not make property graph: {}", pg_result.error());
+  }
+  return pg_result.value();
+}
+
 template <typename GraphTy>
 void
 printGraphCharateristics(GraphTy& graph) {
@@ -93,7 +242,7 @@ printGraphCharateristics(GraphTy& graph) {
   galois::gPrint("/************ Graph Properties ************/\n");
   galois::gPrint("/******************************************/\n");
   galois::gPrint("Number of Nodes: ", graph.size(), "\n");
-  galois::gPrint("Number of Edges: ", graph.sizeEdges(), "\n");
+  galois::gPrint("Number of Edges: ", graph.num_edges(), "\n");
 }
 
 /**
@@ -103,75 +252,74 @@ printGraphCharateristics(GraphTy& graph) {
 template <typename GraphTy>
 void
 findNeighboringClusters(
-    GraphTy& graph, typename GraphTy::GraphNode& n,
+    GraphTy& graph, typename GraphTy::Node& n,
     std::map<uint64_t, uint64_t>& cluster_local_map,
     std::vector<EdgeTy>& counter, EdgeTy& self_loop_wt) {
-  using GNode = typename GraphTy::GraphNode;
-  for (auto ii = graph.edge_begin(n); ii != graph.edge_end(n); ++ii) {
-    graph.getData(graph.getEdgeDst(ii), flag_write_lock);
-  }
-
+  using GNode = typename GraphTy::Node;
   uint64_t num_unique_clusters = 0;
   /**
    * Add the node's current cluster to be considered
    * for movement as well
    */
-  cluster_local_map[graph.getData(n).curr_comm_ass] =
+  cluster_local_map[graph.template GetData<CurrentCommunityId>(n)] =
       0;                 // Add n's current cluster
   counter.push_back(0);  // Initialize the counter to zero (no edges incident
                          // yet)
   num_unique_clusters++;
 
-  // Assuming we have grabbed lock on all the neighbors
-  for (auto ii = graph.edge_begin(n); ii != graph.edge_end(n); ++ii) {
-    GNode dst = graph.getEdgeDst(ii);
+  for (auto e : graph.edges(n)) {
+    GNode dst = *graph.GetEdgeDest(e);
     auto edge_wt =
-        graph.getEdgeData(ii, flag_no_lock);  // Self loop weights is recorded
+        graph.template GetEdgeData<EdgeWeight>(e);  // Self loop weights is
+                                                    // recorded
     if (dst == n) {
       self_loop_wt += edge_wt;  // Self loop weights is recorded
     }
-    auto stored_already = cluster_local_map.find(
-        graph.getData(dst).curr_comm_ass);  // Check if it already exists
+    uint64_t dst_comm = graph.template GetData<CurrentCommunityId>(dst);
+    auto stored_already =
+        cluster_local_map.find(dst_comm);  // Check if it already exists
     if (stored_already != cluster_local_map.end()) {
       counter[stored_already->second] += edge_wt;
     } else {
-      cluster_local_map[graph.getData(dst).curr_comm_ass] = num_unique_clusters;
+      cluster_local_map[dst_comm] = num_unique_clusters;
       counter.push_back(edge_wt);
       num_unique_clusters++;
     }
   }  // End edge loop
   return;
 }
+
+template <typename GraphTy>
+uint64_t
+Degree(const GraphTy& graph, typename GraphTy::Node n) {
+  return *graph.edge_end(n) - *graph.edge_begin(n);
+}
+
 template <typename GraphTy>
 uint64_t
 vertexFollowing(GraphTy& graph) {
-  using GNode = typename GraphTy::GraphNode;
+  using GNode = typename GraphTy::Node;
   // Initialize each node to its own cluster
   galois::do_all(galois::iterate(graph), [&graph](GNode n) {
-    graph.getData(n).curr_comm_ass = n;
+    graph.template GetData<CurrentCommunityId>(n) = n;
   });
 
   // Remove isolated and degree-one nodes
   galois::GAccumulator<uint64_t> isolatedNodes;
   galois::do_all(galois::iterate(graph), [&](GNode n) {
-    auto& n_data = graph.getData(n);
-    uint64_t degree = std::distance(
-        graph.edge_begin(n, galois::MethodFlag::UNPROTECTED),
-        graph.edge_end(n, galois::MethodFlag::UNPROTECTED));
+    auto& n_comm = graph.template GetData<CurrentCommunityId>(n);
+    uint64_t degree = Degree(graph, n);
     if (degree == 0) {
       isolatedNodes += 1;
-      n_data.curr_comm_ass = UNASSIGNED;
+      n_comm = UNASSIGNED;
     } else {
       if (degree == 1) {
         // Check if the destination has degree greater than one
-        auto dst = graph.getEdgeDst(
-            graph.edge_end(n, galois::MethodFlag::UNPROTECTED));
-        uint64_t dst_degree = std::distance(
-            graph.edge_begin(dst, galois::MethodFlag::UNPROTECTED),
-            graph.edge_end(dst, galois::MethodFlag::UNPROTECTED));
+        GNode dst = *graph.GetEdgeDest(graph.edge_begin(n));
+        uint64_t dst_degree = Degree(graph, dst);
         if ((dst_degree > 1 || (n > dst))) {
           isolatedNodes += 1;
-          n_data.curr_comm_ass = graph.getData(dst).curr_comm_ass;
+          n_comm = dst;
         }
       }
     }
@@ -180,17 +328,65 @@ vertexFollowing(GraphTy& graph) {
   return isolatedNodes.reduce();
 }
 
+/**
+ * The nodes to visit in each iteration of the local moving phase. A node can
+ * only find a better community after the community of one of its neighbors
+ * changed, so with pruning an iteration visits only the neighbors of the
+ * nodes that moved in the previous one and converged regions of the graph are
+ * skipped. Every node is visited in the first iteration, and in every
+ * iteration without pruning.
+ */
+class ActiveNodes {
+  //! nodes to visit in the current and in the next iteration
+  std::array<galois::DynamicBitset, 2> active_;
+  uint32_t current_{0};
+  bool enabled_;
+  bool all_active_{true};
+
+public:
+  ActiveNodes(uint64_t num_nodes, bool enabled) : enabled_(enabled) {
+    if (enabled_) {
+      active_[0].resize(num_nodes);
+      active_[1].resize(num_nodes);
+    }
+  }
+
+  bool IsActive(uint64_t n) const {
+    return all_active_ || active_[current_].test(n);
+  }
+
+  //! Visits the neighbors of n in the next iteration; n changed community
+  template <typename GraphTy>
+  void ActivateNeighbors(const GraphTy& graph, typename GraphTy::Node n) {
+    if (!enabled_) {
+      return;
+    }
+    for (auto e : graph.edges(n)) {
+      active_[current_ ^ 1].set(*graph.GetEdgeDest(e));
+    }
+  }
+
+  //! Starts the next iteration
+  void Advance() {
+    if (!enabled_) {
+      return;
+    }
+    active_[current_].reset();
+    current_ ^= 1;
+    all_active_ = false;
+  }
+};
+
 template <typename GraphTy, typename CommArrayTy>
 void
 sumVertexDegreeWeight(GraphTy& graph, CommArrayTy& c_info) {
-  using GNode = typename GraphTy::GraphNode;
+  using GNode = typename GraphTy::Node;
   galois::do_all(galois::iterate(graph), [&](GNode n) {
     EdgeTy total_weight = 0;
-    auto& n_data = graph.getData(n);
-    for (auto ii = graph.edge_begin(n); ii != graph.edge_end(n); ++ii) {
-      total_weight += graph.getEdgeData(ii, flag_no_lock);
+    for (auto e : graph.edges(n)) {
+      total_weight += graph.template GetEdgeData<EdgeWeight>(e);
     }
-    n_data.degree_wt = total_weight;
+    graph.template GetData<DegreeWeight>(n) = total_weight;
     c_info[n].degree_wt = total_weight;
     c_info[n].size = 1;
   });
@@ -198,52 +394,50 @@ sumVertexDegreeWeight(GraphTy& graph, CommArrayTy& c_info) {
 template <typename GraphTy, typename CommArrayTy>
 void
 sumVertexDegreeWeightWithNodeWeight(GraphTy& graph, CommArrayTy& c_info) {
-  using GNode = typename GraphTy::GraphNode;
+  using GNode = typename GraphTy::Node;
   galois::do_all(galois::iterate(graph), [&](GNode n) {
     EdgeTy total_weight = 0;
-    auto& n_data = graph.getData(n);
-    for (auto ii = graph.edge_begin(n); ii != graph.edge_end(n); ++ii) {
-      total_weight += graph.getEdgeData(ii, flag_no_lock);
+    for (auto e : graph.edges(n)) {
+      total_weight += graph.template GetEdgeData<EdgeWeight>(e);
     }
-    n_data.degree_wt = total_weight;
+    graph.template GetData<DegreeWeight>(n) = total_weight;
     c_info[n].degree_wt = total_weight;
     c_info[n].size = 1;
-    c_info[n].node_wt.store(n_data.node_wt);
+    c_info[n].node_wt.store(graph.template GetData<NodeWeight>(n));
   });
 }
 
 template <typename GraphTy, typename CommArrayTy>
 void
 sumClusterWeight(GraphTy& graph, CommArrayTy& c_info) {
-  using GNode = typename GraphTy::GraphNode;
+  using GNode = typename GraphTy::Node;
   galois::do_all(galois::iterate(graph), [&](GNode n) {
     EdgeTy total_weight = 0;
-    auto& n_data = graph.getData(n);
-    for (auto ii = graph.edge_begin(n); ii != graph.edge_end(n); ++ii) {
-      total_weight += graph.getEdgeData(ii, flag_no_lock);
+    for (auto e : graph.edges(n)) {
+      total_weight += graph.template GetEdgeData<EdgeWeight>(e);
     }
-    n_data.degree_wt = total_weight;
+    graph.template GetData<DegreeWeight>(n) = total_weight;
     c_info[n].degree_wt = 0;
   });
 
   galois::do_all(galois::iterate(graph), [&](GNode n) {
-    auto& n_data = graph.getData(n);
-    if (n_data.curr_comm_ass != UNASSIGNED)
+    uint64_t n_comm = graph.template GetData<CurrentCommunityId>(n);
+    if (n_comm != UNASSIGNED)
       galois::atomicAdd(
-          c_info[n_data.curr_comm_ass].degree_wt, n_data.degree_wt);
+          c_info[n_comm].degree_wt, graph.template GetData<DegreeWeight>(n));
   });
 }
 
 template <typename GraphTy>
 double
 calConstantForSecondTerm(GraphTy& graph) {
-  using GNode = typename GraphTy::GraphNode;
+  using GNode = typename GraphTy::Node;
   /**
    * Using double to avoid overflow
    */
   galois::GAccumulator<double> local_weight;
   galois::do_all(galois::iterate(graph), [&graph, &local_weight](GNode n) {
-    local_weight += graph.getData(n).degree_wt;
+    local_weight += graph.template GetData<DegreeWeight>(n);
   });
   /* This is twice since graph is symmetric */
   double total_edge_weight_twice = local_weight.reduce();
@@ -289,12 +483,34 @@ maxCPMQuality(
   return max_index;
 }
 
+/**
+ * Sum of the weights of the edges of each node whose endpoints are in the same
+ * cluster, with clusters given by cluster_of(node)
+ */
+template <typename GraphTy, typename ClusterFn>
+void
+sumInternalEdgeWeight(
+    GraphTy& graph, largeArrayEdgeTy& cluster_wt_internal,
+    ClusterFn cluster_of) {
+  using GNode = typename GraphTy::Node;
+
+  galois::do_all(galois::iterate(graph), [&](GNode n) {
+    EdgeTy internal_wt = 0;
+    for (auto e : graph.edges(n)) {
+      if (cluster_of(*graph.GetEdgeDest(e)) == cluster_of(n)) {
+        internal_wt += graph.template GetEdgeData<EdgeWeight>(e);
+      }
+    }
+    cluster_wt_internal[n] = internal_wt;
+  });
+}
+
 template <typename GraphTy, typename CommArrayTy>
 double
 calCPMQuality(
     GraphTy& graph, CommArrayTy& c_info, double& e_xx, double& a2_x,
     double& constant_for_second_term) {
-  using GNode = typename GraphTy::GraphNode;
+  using GNode = typename GraphTy::Node;
   /* Variables needed for Modularity calculation */
   double mod = -1;
 
@@ -308,17 +524,8 @@ calCPMQuality(
   galois::GAccumulator<double> acc_e_xx;
   galois::GAccumulator<double> acc_a2_x;
 
-  galois::do_all(
-      galois::iterate(graph), [&](GNode n) { cluster_wt_internal[n] = 0; });
-
-  galois::do_all(galois::iterate(graph), [&](GNode n) {
-    auto n_data = graph.getData(n);
-    for (auto ii = graph.edge_begin(n); ii != graph.edge_end(n); ++ii) {
-      if (graph.getData(graph.getEdgeDst(ii)).curr_comm_ass ==
-          n_data.curr_comm_ass) {
-        cluster_wt_internal[n] += graph.getEdgeData(ii);
-      }
-    }
+  sumInternalEdgeWeight(graph, cluster_wt_internal, [&](GNode n) {
+    return graph.template GetData<CurrentCommunityId>(n);
   });
 
   galois::do_all(galois::iterate(graph), [&](GNode n) {
@@ -431,7 +638,7 @@ calModularityDelay(
     GraphTy& graph, CommArrayTy& c_info, CommArrayTy& c_update, double& e_xx,
     double& a2_x, double& constant_for_second_term,
     std::vector<uint64_t>& local_target) {
-  using GNode = typename GraphTy::GraphNode;
+  using GNode = typename GraphTy::Node;
   /* Variables needed for Modularity calculation */
   double mod = -1;
 
@@ -444,16 +651,8 @@ calModularityDelay(
   galois::GAccumulator<double> acc_e_xx;
   galois::GAccumulator<double> acc_a2_x;
 
-  galois::do_all(
-      galois::iterate(graph), [&](GNode n) { cluster_wt_internal[n] = 0; });
-
-  galois::do_all(galois::iterate(graph), [&](GNode n) {
-    for (auto ii = graph.edge_begin(n); ii != graph.edge_end(n); ++ii) {
-      if (local_target[graph.getEdgeDst(ii)] == local_target[n]) {
-        cluster_wt_internal[n] += graph.getEdgeData(ii);
-      }
-    }
-  });
+  sumInternalEdgeWeight(
+      graph, cluster_wt_internal, [&](GNode n) { return local_target[n]; });
 
   galois::do_all(galois::iterate(graph), [&](GNode n) {
     acc_e_xx += cluster_wt_internal[n];
@@ -475,7 +674,7 @@ double
 calModularity(
     GraphTy& graph, CommArrayTy& c_info, double& e_xx, double& a2_x,
     double& constant_for_second_term) {
-  using GNode = typename GraphTy::GraphNode;
+  using GNode = typename GraphTy::Node;
   /* Variables needed for Modularity calculation */
   double mod = -1;
 
@@ -488,17 +687,8 @@ calModularity(
   galois::GAccumulator<double> acc_e_xx;
   galois::GAccumulator<double> acc_a2_x;
 
-  galois::do_all(
-      galois::iterate(graph), [&](GNode n) { cluster_wt_internal[n] = 0; });
-
-  galois::do_all(galois::iterate(graph), [&](GNode n) {
-    auto n_data = graph.getData(n);
-    for (auto ii = graph.edge_begin(n); ii != graph.edge_end(n); ++ii) {
-      if (graph.getData(graph.getEdgeDst(ii)).curr_comm_ass ==
-          n_data.curr_comm_ass) {
-        cluster_wt_internal[n] += graph.getEdgeData(ii);
-      }
-    }
+  sumInternalEdgeWeight(graph, cluster_wt_internal, [&](GNode n) {
+    return graph.template GetData<CurrentCommunityId>(n);
   });
 
   galois::do_all(galois::iterate(graph), [&](GNode n) {
@@ -523,11 +713,10 @@ calModularity(
 template <typename GraphTy, typename CommArrayTy>
 double
 calModularityFinal(GraphTy& graph) {
-  using GNode = typename GraphTy::GraphNode;
+  using GNode = typename GraphTy::Node;
   using CommArray = CommArrayTy;
 
-  CommArray c_info;    // Community info
-  CommArray c_update;  // Used for updating community
+  CommArray c_info;  // Community info
 
   /* Variables needed for Modularity calculation */
   double constant_for_second_term;
@@ -537,7 +726,6 @@ calModularityFinal(GraphTy& graph) {
 
   /*** Initialization ***/
   c_info.allocateBlocked(graph.size());
-  c_update.allocateBlocked(graph.size());
   cluster_wt_internal.allocateBlocked(graph.size());
 
   /* Calculate the weighted degree sum for each vertex */
@@ -552,19 +740,8 @@ calModularityFinal(GraphTy& graph) {
   double a2_x = 0;
   galois::GAccumulator<double> acc_a2_x;
 
-  galois::do_all(
-      galois::iterate(graph), [&](GNode n) { cluster_wt_internal[n] = 0; });
-
-  galois::do_all(galois::iterate(graph), [&](GNode n) {
-    auto n_data = graph.getData(n);
-    for (auto ii = graph.edge_begin(n); ii != graph.edge_end(n); ++ii) {
-      if (graph.getData(graph.getEdgeDst(ii)).curr_comm_ass ==
-          n_data.curr_comm_ass) {
-        // if(graph.getData(graph.getEdgeDst(ii)).prev_comm_ass ==
-        // n_data.prev_comm_ass) {
-        cluster_wt_internal[n] += graph.getEdgeData(ii);
-      }
-    }
+  sumInternalEdgeWeight(graph, cluster_wt_internal, [&](GNode n) {
+    return graph.template GetData<CurrentCommunityId>(n);
   });
 
   galois::do_all(galois::iterate(graph), [&](GNode n) {
@@ -581,58 +758,69 @@ calModularityFinal(GraphTy& graph) {
         a2_x * (double)constant_for_second_term;
   return mod;
 }
+
+/**
+ * Renumbers the clusters in the CommunityIdTy property of the nodes of graph
+ * to 0 .. num_unique_clusters - 1, keeping their order, and returns
+ * num_unique_clusters. Cluster ids must be node ids of graph or UNASSIGNED,
+ * which is kept.
+ */
+template <typename CommunityIdTy, typename GraphTy>
+uint64_t
+renumberClusters(GraphTy& graph) {
+  using GNode = typename GraphTy::Node;
+  uint64_t num_nodes = graph.size();
+
+  // new_ids[c + 1] is set if cluster c is not empty; its prefix sum gives the
+  // number of nonempty clusters before each one
+  largeArray new_ids;
+  new_ids.allocateBlocked(num_nodes + 1);
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_nodes + 1),
+      [&](uint64_t c) { new_ids[c] = 0; }, galois::no_stats());
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) {
+        uint64_t c = graph.template GetData<CommunityIdTy>(n);
+        if (c != UNASSIGNED) {
+          assert(c < num_nodes);
+          new_ids[c + 1] = 1;
+        }
+      },
+      galois::no_stats());
+
+  galois::ParallelSTL::partial_sum(
+      new_ids.begin(), new_ids.end(), new_ids.begin());
+
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) {
+        auto& c = graph.template GetData<CommunityIdTy>(n);
+        if (c != UNASSIGNED) {
+          c = new_ids[c];
+        }
+      },
+      galois::no_stats());
+
+  return new_ids[num_nodes];
+}
+
 template <typename GraphTy>
 uint64_t
 renumberClustersContiguously(GraphTy& graph) {
-  using GNode = typename GraphTy::GraphNode;
-  std::map<uint64_t, uint64_t> cluster_local_map;
-  uint64_t num_unique_clusters = 0;
-
-  for (GNode n = 0; n < graph.size(); ++n) {
-    auto& n_data = graph.getData(n, flag_no_lock);
-    if (n_data.curr_comm_ass != UNASSIGNED) {
-      assert(n_data.curr_comm_ass < graph.size());
-      auto stored_already = cluster_local_map.find(n_data.curr_comm_ass);
-      if (stored_already != cluster_local_map.end()) {
-        n_data.curr_comm_ass = stored_already->second;
-      } else {
-        cluster_local_map[n_data.curr_comm_ass] = num_unique_clusters;
-        n_data.curr_comm_ass = num_unique_clusters;
-        num_unique_clusters++;
-      }
-    }
-  }
-  return num_unique_clusters;
+  return renumberClusters<CurrentCommunityId>(graph);
 }
 
 template <typename GraphTy>
 uint64_t
 renumberClustersContiguouslySubcomm(GraphTy& graph) {
-  using GNode = typename GraphTy::GraphNode;
-  std::map<uint64_t, uint64_t> cluster_local_map;
-  uint64_t num_unique_clusters = 0;
-
-  for (GNode n = 0; n < graph.size(); ++n) {
-    auto& n_data = graph.getData(n, flag_no_lock);
-    assert(n_data.curr_subcomm_ass != UNASSIGNED);
-    assert(n_data.curr_subcomm_ass < graph.size());
-    auto stored_already = cluster_local_map.find(n_data.curr_subcomm_ass);
-    if (stored_already != cluster_local_map.end()) {
-      n_data.curr_subcomm_ass = stored_already->second;
-    } else {
-      cluster_local_map[n_data.curr_subcomm_ass] = num_unique_clusters;
-      n_data.curr_subcomm_ass = num_unique_clusters;
-      num_unique_clusters++;
-    }
-  }
-
-  return num_unique_clusters;
+  return renumberClusters<CurrentSubCommunityId>(graph);
 }
 
 template <typename GraphTy>
 uint64_t
 renumberClustersContiguouslyArray(largeArray& arr) {
-  using GNode = typename GraphTy::GraphNode;
+  using GNode = typename GraphTy::Node;
   std::map<uint64_t, uint64_t> cluster_local_map;
   uint64_t num_unique_clusters = 0;
 
@@ -655,11 +843,12 @@ renumberClustersContiguouslyArray(largeArray& arr) {
 template <typename GraphTy>
 void
 printGraph(GraphTy& graph) {
-  using GNode = typename GraphTy::GraphNode;
+  using GNode = typename GraphTy::Node;
   for (GNode n = 0; n < graph.size(); ++n) {
-    for (auto ii = graph.edge_begin(n); ii != graph.edge_end(n); ++ii) {
+    for (auto e : graph.edges(n)) {
       galois::gPrint(
-          n, " --> ", graph.getEdgeDst(ii), " , ", graph.getEdgeData(ii), "\n");
+          n, " --> ", *graph.GetEdgeDest(e), " , ",
+          graph.template GetEdgeData<EdgeWeight>(e), "\n");
     }
   }
 }
@@ -667,22 +856,23 @@ printGraph(GraphTy& graph) {
 template <typename GraphTy>
 void
 printNodeClusterId(GraphTy& graph, std::string output_CID_filename) {
-  using GNode = typename GraphTy::GraphNode;
+  using GNode = typename GraphTy::Node;
   std::ofstream outputFile(output_CID_filename, std::ofstream::out);
   for (GNode n = 0; n < graph.size(); ++n) {
-    outputFile << n << "  " << graph.getData(n).curr_comm_ass << "\n";
-    // outputFile << graph.getData(n).curr_comm_ass << "\n";
+    outputFile << n << "  " << graph.template GetData<CurrentCommunityId>(n)
+               << "\n";
+    // outputFile << graph.template GetData<CurrentCommunityId>(n) << "\n";
   }
 }
 
 template <typename GraphTy, typename CommArrayTy>
 void
 checkModularity(GraphTy& graph, largeArray& clusters_orig) {
-  using GNode = typename GraphTy::GraphNode;
+  using GNode = typename GraphTy::Node;
   galois::gPrint("checkModularity\n");
 
   galois::do_all(galois::iterate(graph), [&](GNode n) {
-    graph.getData(n, flag_no_lock).curr_comm_ass = clusters_orig[n];
+    graph.template GetData<CurrentCommunityId>(n) = clusters_orig[n];
   });
 
   uint64_t num_unique_clusters = renumberClustersContiguously(graph);
@@ -738,8 +928,8 @@ uint64_t
 getRandomSubcommunity(
     GraphTy& graph, uint64_t n, CommArrayTy& subcomm_info,
     uint64_t total_degree_wt, double constant_for_second_term) {
-  using GNode = typename GraphTy::GraphNode;
-  uint64_t curr_subcomm = graph.getData(n).curr_subcomm_ass;
+  using GNode = typename GraphTy::Node;
+  uint64_t curr_subcomm = graph.template GetData<CurrentSubCommunityId>(n);
 
   std::map<uint64_t, uint64_t>
       cluster_local_map;  // Map each neighbor's subcommunity to local number:
@@ -753,21 +943,22 @@ getRandomSubcommunity(
 
   EdgeTy self_loop_wt = 0;
 
-  for (auto ii = graph.edge_begin(n); ii != graph.edge_end(n); ++ii) {
-    GNode dst = graph.getEdgeDst(ii);
+  for (auto e : graph.edges(n)) {
+    GNode dst = *graph.GetEdgeDest(e);
     EdgeTy edge_wt =
-        graph.getEdgeData(ii, flag_no_lock);  // Self loop weights is recorded
+        graph.template GetEdgeData<EdgeWeight>(e);  // Self loop weights is
+                                                    // recorded
 
     if (dst == n) {
       self_loop_wt += edge_wt;  // Self loop weights is recorded
     }
-    auto stored_already = cluster_local_map.find(
-        graph.getData(dst).curr_subcomm_ass);  // Check if it already exists
+    uint64_t dst_subcomm = graph.template GetData<CurrentSubCommunityId>(dst);
+    auto stored_already =
+        cluster_local_map.find(dst_subcomm);  // Check if it already exists
     if (stored_already != cluster_local_map.end()) {
       counter[stored_already->second] += edge_wt;
     } else {
-      cluster_local_map[graph.getData(dst).curr_subcomm_ass] =
-          num_unique_clusters;
+      cluster_local_map[dst_subcomm] = num_unique_clusters;
       counter.push_back(edge_wt);
       num_unique_clusters++;
     }
@@ -816,17 +1007,18 @@ getRandomSubcommunity(
 template <typename GraphTy, typename CommTy>
 uint64_t
 getRandomSubcommunity2(
-    GraphTy& graph, typename GraphTy::GraphNode n, CommTy& subcomm_info,
+    GraphTy& graph, typename GraphTy::Node n, CommTy& subcomm_info,
     uint64_t total_degree_wt, uint64_t comm_id,
     double constant_for_second_term) {
-  using GNode = typename GraphTy::GraphNode;
-  auto& n_data = graph.getData(n);
+  using GNode = typename GraphTy::Node;
+  uint64_t n_subcomm = graph.template GetData<CurrentSubCommunityId>(n);
+  uint64_t n_node_wt = graph.template GetData<NodeWeight>(n);
   /*
    * Remove the currently selected node from its current cluster.
    * This causes the cluster to be empty.
    */
-  subcomm_info[n_data.curr_subcomm_ass].node_wt = 0;
-  subcomm_info[n_data.curr_subcomm_ass].internal_edge_wt = 0;
+  subcomm_info[n_subcomm].node_wt = 0;
+  subcomm_info[n_subcomm].internal_edge_wt = 0;
 
   /*
    * Map each neighbor's subcommunity to local number: Subcommunity --> Index
@@ -848,38 +1040,38 @@ getRandomSubcommunity2(
    * currently selected node will be moved back to its old
    * cluster.
    */
-  cluster_local_map[n_data.curr_subcomm_ass] = 0;  // Add n's current
-                                                   // subcommunity
+  cluster_local_map[n_subcomm] = 0;  // Add n's current subcommunity
   counter.push_back(0);  // Initialize the counter to zero (no edges incident
                          // yet)
-  neighboring_cluster_ids.push_back(n_data.curr_subcomm_ass);
+  neighboring_cluster_ids.push_back(n_subcomm);
   uint64_t num_unique_clusters = 1;
 
   EdgeTy self_loop_wt = 0;
 
-  for (auto ii = graph.edge_begin(n); ii != graph.edge_end(n); ++ii) {
-    GNode dst = graph.getEdgeDst(ii);
+  for (auto e : graph.edges(n)) {
+    GNode dst = *graph.GetEdgeDest(e);
     EdgeTy edge_wt =
-        graph.getEdgeData(ii, flag_no_lock);  // Self loop weights is recorded
-    if (graph.getData(dst).curr_comm_ass == comm_id) {
+        graph.template GetEdgeData<EdgeWeight>(e);  // Self loop weights is
+                                                    // recorded
+    if (graph.template GetData<CurrentCommunityId>(dst) == comm_id) {
       if (dst == n) {
         self_loop_wt += edge_wt;  // Self loop weights is recorded
       }
-      auto stored_already = cluster_local_map.find(
-          graph.getData(dst).curr_subcomm_ass);  // Check if it already exists
+      uint64_t dst_subcomm = graph.template GetData<CurrentSubCommunityId>(dst);
+      auto stored_already =
+          cluster_local_map.find(dst_subcomm);  // Check if it already exists
       if (stored_already != cluster_local_map.end()) {
         counter[stored_already->second] += edge_wt;
       } else {
-        cluster_local_map[graph.getData(dst).curr_subcomm_ass] =
-            num_unique_clusters;
+        cluster_local_map[dst_subcomm] = num_unique_clusters;
         counter.push_back(edge_wt);
-        neighboring_cluster_ids.push_back(graph.getData(dst).curr_subcomm_ass);
+        neighboring_cluster_ids.push_back(dst_subcomm);
         num_unique_clusters++;
       }
     }
   }  // End edge loop
 
-  uint64_t best_cluster = n_data.curr_subcomm_ass;
+  uint64_t best_cluster = n_subcomm;
   double max_quality_value_increment = 0;
   double total_transformed_quality_value_increment = 0;
   double quality_value_increment = 0;
@@ -887,7 +1079,7 @@ getRandomSubcommunity2(
       num_unique_clusters);
   for (auto pair : cluster_local_map) {
     auto subcomm = pair.first;
-    if (n_data.curr_subcomm_ass == subcomm)
+    if (n_subcomm == subcomm)
       continue;
 
     uint64_t subcomm_node_wt = subcomm_info[subcomm].node_wt;
@@ -898,7 +1090,7 @@ getRandomSubcommunity2(
         constant_for_second_term * (double)subcomm_degree_wt *
             ((double)total_degree_wt - (double)subcomm_degree_wt)) {
       quality_value_increment =
-          counter[pair.second] - n_data.node_wt * subcomm_node_wt * resolution;
+          counter[pair.second] - n_node_wt * subcomm_node_wt * resolution;
 
       if (quality_value_increment > max_quality_value_increment) {
         best_cluster = subcomm;
@@ -968,34 +1160,34 @@ getRandomSubcommunity2(
 template <typename GraphTy, typename CommTy>
 void
 mergeNodesSubset(
-    GraphTy& graph, std::vector<typename GraphTy::GraphNode>& cluster_nodes,
+    GraphTy& graph, std::vector<typename GraphTy::Node>& cluster_nodes,
     uint64_t comm_id, uint64_t total_degree_wt, CommTy& subcomm_info,
     double constant_for_second_term) {
-  using GNode = typename GraphTy::GraphNode;
+  using GNode = typename GraphTy::Node;
 
   // select set R
   std::vector<GNode> cluster_nodes_to_move;
   for (uint64_t i = 0; i < cluster_nodes.size(); ++i) {
     GNode n = cluster_nodes[i];
-    auto& n_data = graph.getData(n);
     /*
      * Initialize with singleton sub-communities
      */
     EdgeTy nodeEdgeWeightWithinCluster = 0;
-    for (auto ii = graph.edge_begin(n); ii != graph.edge_end(n); ++ii) {
-      GNode dst = graph.getEdgeDst(ii);
-      EdgeTy edge_wt = graph.getEdgeData(ii, flag_no_lock);
+    for (auto e : graph.edges(n)) {
+      GNode dst = *graph.GetEdgeDest(e);
+      EdgeTy edge_wt = graph.template GetEdgeData<EdgeWeight>(e);
       /*
        * Must include the edge weight of all neighbors excluding self loops
        * belonging to the community comm_id
        */
-      if (dst != n && graph.getData(dst).curr_comm_ass == comm_id) {
+      if (dst != n &&
+          graph.template GetData<CurrentCommunityId>(dst) == comm_id) {
         nodeEdgeWeightWithinCluster += edge_wt;
       }
     }
 
-    uint64_t node_wt = n_data.node_wt;
-    uint64_t degree_wt = n_data.degree_wt;
+    uint64_t node_wt = graph.template GetData<NodeWeight>(n);
+    uint64_t degree_wt = graph.template GetData<DegreeWeight>(n);
     /*
      * Additionally, only nodes that are well connected with
      * the rest of the network are considered for moving.
@@ -1014,34 +1206,37 @@ mergeNodesSubset(
   }
 
   for (GNode n : cluster_nodes_to_move) {
-    auto& n_data = graph.getData(n);
+    auto& n_subcomm = graph.template GetData<CurrentSubCommunityId>(n);
     /*
      * Only consider singleton communities
      */
-    if (subcomm_info[n_data.curr_subcomm_ass].size == 1) {
+    if (subcomm_info[n_subcomm].size == 1) {
       uint64_t new_subcomm_ass = getRandomSubcommunity2(
           graph, n, subcomm_info, total_degree_wt, comm_id,
           constant_for_second_term);
 
-      if ((int64_t)new_subcomm_ass != -1 &&
-          new_subcomm_ass != graph.getData(n).curr_subcomm_ass) {
-        n_data.curr_subcomm_ass = new_subcomm_ass;
+      if ((int64_t)new_subcomm_ass != -1 && new_subcomm_ass != n_subcomm) {
+        n_subcomm = new_subcomm_ass;
 
         /*
          * Move the currently selected node to its new cluster and
          * update the clustering statistics.
          */
         galois::atomicAdd(
-            subcomm_info[new_subcomm_ass].node_wt, n_data.node_wt);
+            subcomm_info[new_subcomm_ass].node_wt,
+            graph.template GetData<NodeWeight>(n));
         galois::atomicAdd(subcomm_info[new_subcomm_ass].size, (uint64_t)1);
         galois::atomicAdd(
-            subcomm_info[new_subcomm_ass].degree_wt, n_data.degree_wt);
-
-        for (auto ii = graph.edge_begin(n); ii != graph.edge_end(n); ++ii) {
-          GNode dst = graph.getEdgeDst(ii);
-          auto edge_wt = graph.getEdgeData(ii, flag_no_lock);
-          if (dst != n && graph.getData(dst).curr_comm_ass == comm_id) {
-            if (graph.getData(dst).curr_subcomm_ass == new_subcomm_ass) {
+            subcomm_info[new_subcomm_ass].degree_wt,
+            graph.template GetData<DegreeWeight>(n));
+
+        for (auto e : graph.edges(n)) {
+          GNode dst = *graph.GetEdgeDest(e);
+          auto edge_wt = graph.template GetEdgeData<EdgeWeight>(e);
+          if (dst != n &&
+              graph.template GetData<CurrentCommunityId>(dst) == comm_id) {
+            if (graph.template GetData<CurrentSubCommunityId>(dst) ==
+                new_subcomm_ass) {
               subcomm_info[new_subcomm_ass].internal_edge_wt -= edge_wt;
             } else {
               subcomm_info[new_subcomm_ass].internal_edge_wt += edge_wt;
@@ -1060,7 +1255,7 @@ mergeNodesSubset(
 template <typename GraphTy, typename CommArrayTy>
 void
 refinePartition(GraphTy& graph, double constant_for_second_term) {
-  using GNode = typename GraphTy::GraphNode;
+  using GNode = typename GraphTy::Node;
   using CommArray = CommArrayTy;
 
   galois::gPrint("Refining\n");
@@ -1068,7 +1263,8 @@ refinePartition(GraphTy& graph, double constant_for_second_term) {
   // set singleton subcommunities
   galois::do_all(
       galois::iterate(graph),
-      [&](GNode n) { graph.getData(n).curr_subcomm_ass = n; }, galois::steal());
+      [&](GNode n) { graph.template GetData<CurrentSubCommunityId>(n) = n; },
+      galois::steal());
 
   // populate nodes into communities
   std::vector<std::vector<GNode>> cluster_bags(2 * graph.size() + 1);
@@ -1085,13 +1281,14 @@ refinePartition(GraphTy& graph, double constant_for_second_term) {
       galois::steal());
 
   for (GNode n : graph) {
-    auto& n_data = graph.getData(n, flag_no_lock);
-    if (n_data.curr_comm_ass != UNASSIGNED)
-      cluster_bags[n_data.curr_comm_ass].push_back(n);
+    uint64_t n_comm = graph.template GetData<CurrentCommunityId>(n);
+    if (n_comm != UNASSIGNED)
+      cluster_bags[n_comm].push_back(n);
 
-    galois::atomicAdd(comm_info[n_data.curr_comm_ass].node_wt, n_data.node_wt);
     galois::atomicAdd(
-        comm_info[n_data.curr_comm_ass].degree_wt, n_data.degree_wt);
+        comm_info[n_comm].node_wt, graph.template GetData<NodeWeight>(n));
+    galois::atomicAdd(
+        comm_info[n_comm].degree_wt, graph.template GetData<DegreeWeight>(n));
   }
 
   CommArray subcomm_info;
@@ -1124,180 +1321,260 @@ refinePartition(GraphTy& graph, double constant_for_second_term) {
  * coarser graphs.
  *
  */
-template <typename GraphTy>
-void
-buildNextLevelGraph(
-    GraphTy& graph, GraphTy& graph_next, uint64_t num_unique_clusters) {
-  using GNode = typename GraphTy::GraphNode;
-  std::cerr << "Inside buildNextLevelGraph\n";
+
+/**
+ * Per-thread state of the aggregation of clusters into the nodes of the next
+ * level graph.
+ */
+struct AggregationScratch {
+  //! Index in edges of the edge to each neighboring cluster of the cluster
+  //! being aggregated
+  std::unordered_map<uint32_t, uint64_t> edge_index;
+  //! Edges of the clusters aggregated by this thread, one cluster after the
+  //! other
+  std::vector<std::pair<uint32_t, EdgeTy>> edges;
+};
+
+/**
+ * Where the edges of a cluster are in the AggregationScratch of the thread
+ * that aggregated it
+ */
+struct AggregatedEdges {
+  uint32_t thread;
+  uint64_t begin;
+};
+
+/**
+ * Builds the graph whose nodes are the clusters in the CommunityIdTy property
+ * of the nodes of graph, which must be numbered 0 .. num_unique_clusters - 1
+ * or be UNASSIGNED; there is an edge between two clusters if there are edges
+ * between their nodes, with the sum of their weights. Nodes that are
+ * UNASSIGNED must not have edges to assigned ones; they are left out.
+ *
+ * fn(c, members_begin, members_end) is called for each cluster c with the
+ * range of its nodes, by the thread that aggregates it.
+ *
+ * The nodes of each cluster are grouped with a parallel counting sort. Each
+ * cluster is then aggregated by a single thread, which merges the edges of its
+ * nodes by the cluster of their destination in a hash map that it reuses
+ * across clusters and appends the merged edges to its own buffer, so no edge
+ * weight is updated by more than one thread. The CSR of the next level is
+ * built by a prefix sum over the numbers of merged edges of the clusters,
+ * followed by a parallel copy out of the per-thread buffers.
+ *
+ * @returns a graph with the kEdgeWeightProperty edge property and no node
+ * properties; its edges are sorted by destination
+ */
+template <typename CommunityIdTy, typename GraphTy, typename ClusterFn>
+std::unique_ptr<galois::graphs::PropertyFileGraph>
+aggregateClusters(GraphTy& graph, uint64_t num_unique_clusters, ClusterFn fn) {
+  using GNode = typename GraphTy::Node;
 
   galois::StatTimer TimerGraphBuild("Timer_Graph_build");
   TimerGraphBuild.start();
-  uint32_t num_nodes_next = num_unique_clusters;
-  uint64_t num_edges_next = 0;  // Unknown right now
+  uint64_t num_nodes_next = num_unique_clusters;
 
-  std::vector<std::vector<GNode>> cluster_bags(num_unique_clusters);
-  // Comment: Serial separation is better than do_all due to contention
-  for (GNode n = 0; n < graph.size(); ++n) {
-    auto n_data = graph.getData(n, flag_no_lock);
-    if (n_data.curr_comm_ass != UNASSIGNED)
-      cluster_bags[n_data.curr_comm_ass].push_back(n);
+  /* Group the nodes of each cluster */
+  galois::LargeArray<std::atomic<uint64_t>> cluster_fill;
+  largeArray cluster_begin;
+  cluster_fill.allocateBlocked(num_nodes_next);
+  cluster_begin.allocateBlocked(num_nodes_next + 1);
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_nodes_next),
+      [&](uint64_t c) { cluster_fill.constructAt(c, 0); }, galois::no_stats());
+
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) {
+        uint64_t c = graph.template GetData<CommunityIdTy>(n);
+        if (c != UNASSIGNED) {
+          assert(c < num_nodes_next);
+          cluster_fill[c].fetch_add(1, std::memory_order_relaxed);
+        }
+      },
+      galois::no_stats(), galois::loopname("BuildGraph: Count members"));
+
+  cluster_begin[0] = 0;
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_nodes_next),
+      [&](uint64_t c) { cluster_begin[c + 1] = cluster_fill[c]; },
+      galois::no_stats());
+  galois::ParallelSTL::partial_sum(
+      cluster_begin.begin(), cluster_begin.end(), cluster_begin.begin());
+
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_nodes_next),
+      [&](uint64_t c) { cluster_fill[c] = cluster_begin[c]; },
+      galois::no_stats());
+
+  galois::LargeArray<GNode> members;
+  members.allocateBlocked(cluster_begin[num_nodes_next]);
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) {
+        uint64_t c = graph.template GetData<CommunityIdTy>(n);
+        if (c != UNASSIGNED) {
+          members[cluster_fill[c].fetch_add(1, std::memory_order_relaxed)] = n;
+        }
+      },
+      galois::no_stats(), galois::loopname("BuildGraph: Group members"));
+
+  /* Merge the edges of each cluster by the cluster of their destination */
+  auto indices_result =
+      arrow::AllocateBuffer(num_nodes_next * sizeof(uint64_t));
+  if (!indices_result.ok()) {
+    GALOIS_LOG_FATAL(
+        "could not allocate topology: {}", indices_result.status());
   }
+  std::shared_ptr<arrow::Buffer> indices_buffer =
+      std::move(indices_result.ValueOrDie());
+  auto* indices = reinterpret_cast<uint64_t*>(indices_buffer->mutable_data());
 
-  std::vector<std::vector<uint32_t>> edges_id(num_unique_clusters);
-  std::vector<std::vector<EdgeTy>> edges_data(num_unique_clusters);
+  galois::substrate::PerThreadStorage<AggregationScratch> scratch;
+  galois::LargeArray<AggregatedEdges> cluster_edges;
+  cluster_edges.allocateBlocked(num_nodes_next);
 
-  /* First pass to find the number of edges */
   galois::do_all(
-      galois::iterate((uint64_t)0, num_unique_clusters),
+      galois::iterate(uint64_t{0}, num_nodes_next),
       [&](uint64_t c) {
-        std::map<uint64_t, uint64_t> cluster_local_map;
-        uint64_t num_unique_clusters = 0;
-        for (auto cb_ii = cluster_bags[c].begin();
-             cb_ii != cluster_bags[c].end(); ++cb_ii) {
-          assert(
-              graph.getData(*cb_ii, flag_no_lock).curr_comm_ass ==
-              c);  // All nodes in this bag must have same cluster id
-
-          for (auto ii = graph.edge_begin(*cb_ii); ii != graph.edge_end(*cb_ii);
-               ++ii) {
-            GNode dst = graph.getEdgeDst(ii);
-            auto dst_data = graph.getData(dst, flag_no_lock);
-            assert(dst_data.curr_comm_ass != UNASSIGNED);
-            auto stored_already = cluster_local_map.find(
-                dst_data.curr_comm_ass);  // Check if it already exists
-            if (stored_already != cluster_local_map.end()) {
-              edges_data[c][stored_already->second] += graph.getEdgeData(ii);
+        AggregationScratch* local = scratch.getLocal();
+        std::vector<std::pair<uint32_t, EdgeTy>>& edges = local->edges;
+        uint64_t begin = edges.size();
+
+        for (uint64_t i = cluster_begin[c]; i < cluster_begin[c + 1]; ++i) {
+          GNode n = members[i];
+          for (auto e : graph.edges(n)) {
+            uint64_t dst_cluster =
+                graph.template GetData<CommunityIdTy>(*graph.GetEdgeDest(e));
+            assert(dst_cluster != UNASSIGNED);
+            EdgeTy edge_wt = graph.template GetEdgeData<EdgeWeight>(e);
+            auto [it, inserted] =
+                local->edge_index.try_emplace(dst_cluster, edges.size());
+            if (inserted) {
+              edges.emplace_back(dst_cluster, edge_wt);
             } else {
-              cluster_local_map[dst_data.curr_comm_ass] = num_unique_clusters;
-              edges_id[c].push_back(dst_data.curr_comm_ass);
-              edges_data[c].push_back(graph.getEdgeData(ii));
-              num_unique_clusters++;
+              edges[it->second].second += edge_wt;
             }
-          }  // End edge loop
+          }
         }
-      },
-      galois::steal(), galois::loopname("BuildGrah: Find edges"));
-
-  /* Serial loop to reduce all the edge counts */
-  std::vector<uint64_t> prefix_edges_count(num_unique_clusters);
-  galois::GAccumulator<uint64_t> num_edges_acc;
-  galois::do_all(galois::iterate((uint32_t)0, num_nodes_next), [&](uint32_t c) {
-    prefix_edges_count[c] = edges_id[c].size();
-    num_edges_acc += prefix_edges_count[c];
-  });
 
-  num_edges_next = num_edges_acc.reduce();
-  for (uint32_t c = 1; c < num_nodes_next; ++c) {
-    prefix_edges_count[c] += prefix_edges_count[c - 1];
-  }
+        // Erase only the keys of this cluster: clearing the whole map costs
+        // as much as the largest cluster the thread has aggregated
+        for (uint64_t i = begin; i < edges.size(); ++i) {
+          local->edge_index.erase(edges[i].first);
+        }
+        std::sort(edges.begin() + begin, edges.end());
+
+        indices[c] = edges.size() - begin;
+        cluster_edges[c] =
+            AggregatedEdges{galois::substrate::ThreadPool::getTID(), begin};
+        fn(c, members.data() + cluster_begin[c],
+           members.data() + cluster_begin[c + 1]);
+      },
+      galois::steal(), galois::loopname("BuildGraph: Merge edges"));
 
-  assert(prefix_edges_count[num_unique_clusters - 1] == num_edges_next);
+  /* Build the CSR of the next level graph */
+  galois::ParallelSTL::partial_sum(
+      indices, indices + num_nodes_next, indices);
+  uint64_t num_edges_next = num_nodes_next ? indices[num_nodes_next - 1] : 0;
   galois::gPrint(
       "#nodes : ", num_nodes_next, ", #edges : ", num_edges_next, "\n");
-  std::cerr << "Graph construction started"
-            << "\n";
-  galois::StatTimer TimerConstructFrom("Timer_Construct_From");
-  TimerConstructFrom.start();
-  graph_next.constructFrom(
-      num_nodes_next, num_edges_next, prefix_edges_count, edges_id, edges_data);
-  TimerConstructFrom.stop();
-
-  TimerGraphBuild.stop();
-  galois::gPrint("Graph construction done\n");
-}
-
-template <typename GraphTy>
-void
-buildNextLevelGraphSubComm(
-    GraphTy& graph, GraphTy& graph_next, uint64_t num_unique_clusters,
-    std::vector<uint64_t>& original_comm_ass,
-    std::vector<uint64_t>& cluster_node_wt) {
-  using GNode = typename GraphTy::GraphNode;
-
-  galois::StatTimer TimerGraphBuild("Timer_Graph_build");
-  TimerGraphBuild.start();
-  uint32_t num_nodes_next = num_unique_clusters;
-  uint64_t num_edges_next = 0;  // Unknown right now
 
-  std::vector<std::vector<GNode>> cluster_bags(num_unique_clusters);
-  // Comment: Serial separation is better than do_all due to contention
-  for (GNode n = 0; n < graph.size(); ++n) {
-    auto n_data = graph.getData(n, flag_no_lock);
-    original_comm_ass[n_data.curr_subcomm_ass] =
-        graph.getData(n_data.curr_comm_ass).curr_subcomm_ass;
-    assert(n_data.curr_comm_ass != UNASSIGNED);
-    cluster_bags[n_data.curr_subcomm_ass].push_back(n);
-    cluster_node_wt[n_data.curr_subcomm_ass] += n_data.node_wt;
+  auto dests_result = arrow::AllocateBuffer(num_edges_next * sizeof(uint32_t));
+  auto weights_result = arrow::AllocateBuffer(num_edges_next * sizeof(EdgeTy));
+  if (!dests_result.ok() || !weights_result.ok()) {
+    GALOIS_LOG_FATAL("could not allocate the edges of the next level graph");
   }
+  std::shared_ptr<arrow::Buffer> dests_buffer =
+      std::move(dests_result.ValueOrDie());
+  std::shared_ptr<arrow::Buffer> weights_buffer =
+      std::move(weights_result.ValueOrDie());
+  auto* dests = reinterpret_cast<uint32_t*>(dests_buffer->mutable_data());
+  auto* weights = reinterpret_cast<EdgeTy*>(weights_buffer->mutable_data());
 
-  std::vector<std::vector<uint32_t>> edges_id(num_unique_clusters);
-  std::vector<std::vector<EdgeTy>> edges_data(num_unique_clusters);
-
-  /* First pass to find the number of edges */
   galois::do_all(
-      galois::iterate((uint64_t)0, num_unique_clusters),
+      galois::iterate(uint64_t{0}, num_nodes_next),
       [&](uint64_t c) {
-        std::map<uint64_t, uint64_t> cluster_local_map;
-        uint64_t num_unique_clusters = 0;
-        for (auto cb_ii = cluster_bags[c].begin();
-             cb_ii != cluster_bags[c].end(); ++cb_ii) {
-          assert(
-              graph.getData(*cb_ii, flag_no_lock).curr_subcomm_ass ==
-              c);  // All nodes in this bag must have same cluster id
-
-          for (auto ii = graph.edge_begin(*cb_ii); ii != graph.edge_end(*cb_ii);
-               ++ii) {
-            GNode dst = graph.getEdgeDst(ii);
-            auto dst_data = graph.getData(dst, flag_no_lock);
-            assert(dst_data.curr_subcomm_ass != UNASSIGNED);
-            auto stored_already = cluster_local_map.find(
-                dst_data.curr_subcomm_ass);  // Check if it already exists
-            if (stored_already != cluster_local_map.end()) {
-              edges_data[c][stored_already->second] += graph.getEdgeData(ii);
-            } else {
-              cluster_local_map[dst_data.curr_subcomm_ass] =
-                  num_unique_clusters;
-              edges_id[c].push_back(dst_data.curr_subcomm_ass);
-              edges_data[c].push_back(graph.getEdgeData(ii));
-              num_unique_clusters++;
-            }
-          }  // End edge loop
+        uint64_t begin = c ? indices[c - 1] : 0;
+        const auto* edges =
+            scratch.getRemote(cluster_edges[c].thread)->edges.data() +
+            cluster_edges[c].begin;
+        for (uint64_t i = begin; i < indices[c]; ++i, ++edges) {
+          dests[i] = edges->first;
+          weights[i] = edges->second;
         }
       },
-      galois::steal(), galois::loopname("BuildGrah: Find edges"));
-
-  /* Serial loop to reduce all the edge counts */
-  std::vector<uint64_t> prefix_edges_count(num_unique_clusters);
-  galois::GAccumulator<uint64_t> num_edges_acc;
-  galois::do_all(galois::iterate((uint32_t)0, num_nodes_next), [&](uint32_t c) {
-    prefix_edges_count[c] = edges_id[c].size();
-    num_edges_acc += prefix_edges_count[c];
-  });
+      galois::steal(), galois::loopname("BuildGraph: Copy edges"));
+
+  auto pfg_next = std::make_unique<galois::graphs::PropertyFileGraph>();
+  if (auto r = pfg_next->SetTopology(galois::graphs::GraphTopology{
+          .out_indices = std::make_shared<arrow::UInt64Array>(
+              num_nodes_next, indices_buffer),
+          .out_dests = std::make_shared<arrow::UInt32Array>(
+              num_edges_next, dests_buffer),
+          .edges_sorted_by_dest = true,
+      });
+      !r) {
+    GALOIS_LOG_FATAL("could not set topology: {}", r.error());
+  }
 
-  num_edges_next = num_edges_acc.reduce();
-  for (uint32_t c = 1; c < num_nodes_next; ++c) {
-    prefix_edges_count[c] += prefix_edges_count[c - 1];
+  using WeightArrowType = arrow::CTypeTraits<EdgeTy>::ArrowType;
+  auto weights_type = arrow::TypeTraits<WeightArrowType>::type_singleton();
+  auto weights_table = arrow::Table::Make(
+      arrow::schema({arrow::field(kEdgeWeightProperty, weights_type)}),
+      {std::make_shared<arrow::NumericArray<WeightArrowType>>(
+          num_edges_next, weights_buffer)});
+  if (auto r = pfg_next->AddEdgeProperties(weights_table); !r) {
+    GALOIS_LOG_FATAL("could not add edge property: {}", r.error());
   }
 
-  assert(prefix_edges_count[num_unique_clusters - 1] == num_edges_next);
-  galois::gPrint(
-      "#nodes : ", num_nodes_next, ", #edges : ", num_edges_next, "\n");
-  galois::gPrint(
-      "#prefix last : ", prefix_edges_count[num_unique_clusters - 1], "\n");
+  TimerGraphBuild.stop();
+  galois::gPrint("Graph construction done\n");
+  return pfg_next;
+}
 
-  std::cerr << "Graph construction started"
-            << "\n";
+template <typename GraphTy>
+std::unique_ptr<galois::graphs::PropertyFileGraph>
+buildNextLevelGraph(GraphTy& graph, uint64_t num_unique_clusters) {
+  std::cerr << "Inside buildNextLevelGraph\n";
+  return aggregateClusters<CurrentCommunityId>(
+      graph, num_unique_clusters,
+      [](uint64_t, const typename GraphTy::Node*,
+         const typename GraphTy::Node*) {});
+}
 
-  galois::StatTimer TimerConstructFrom("Timer_Construct_From");
-  TimerConstructFrom.start();
-  graph_next.constructFrom(
-      num_nodes_next, num_edges_next, prefix_edges_count, edges_id, edges_data);
-  TimerConstructFrom.stop();
+/**
+ * Like buildNextLevelGraph over the subcommunities instead of the
+ * communities. Sets original_comm_ass of each subcommunity to the
+ * subcommunity of the node its community is named after, and
+ * cluster_node_wt to the sum of the weights of its nodes.
+ */
+template <typename GraphTy>
+std::unique_ptr<galois::graphs::PropertyFileGraph>
+buildNextLevelGraphSubComm(
+    GraphTy& graph, uint64_t num_unique_clusters,
+    std::vector<uint64_t>& original_comm_ass,
+    std::vector<uint64_t>& cluster_node_wt) {
+  using GNode = typename GraphTy::Node;
+
+  auto pfg_next = aggregateClusters<CurrentSubCommunityId>(
+      graph, num_unique_clusters,
+      [&](uint64_t c, const GNode* members_begin, const GNode* members_end) {
+        assert(members_begin != members_end);
+        uint64_t comm =
+            graph.template GetData<CurrentCommunityId>(*members_begin);
+        assert(comm != UNASSIGNED);
+        original_comm_ass[c] =
+            graph.template GetData<CurrentSubCommunityId>(comm);
+        uint64_t node_wt = 0;
+        for (const GNode* n = members_begin; n != members_end; ++n) {
+          node_wt += graph.template GetData<NodeWeight>(*n);
+        }
+        cluster_node_wt[c] = node_wt;
+      });
 
   std::cout << " c1:" << calConstantForSecondTerm(graph) << "\n";
-  TimerGraphBuild.stop();
-  galois::gPrint("Graph construction done\n");
+  return pfg_next;
 }
 
 #endif  // CLUSTERING_H
@@ -20,6 +20,8 @@
 #include <deque>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <type_traits>
 
 #include "Lonestar/BoilerPlate.h"
@@ -28,8 +30,6 @@
 #include "galois/Galois.h"
 #include "galois/Reduction.h"
 #include "galois/Timer.h"
-#include "galois/graphs/LCGraph.h"
-#include "galois/graphs/TypeTraits.h"
 #include "galois/gstl.h"
 #include "llvm/Support/CommandLine.h"
 
@@ -60,20 +60,16 @@ struct Comm {
 };
 
 typedef galois::LargeArray<Comm> CommArray;
+
 // Graph Node information
-struct Node {
-  uint64_t prev_comm_ass;
-  uint64_t curr_comm_ass;
-  EdgeTy degree_wt;
-  int64_t colorId;
-  /** Only required for Leiden **/
-  uint64_t curr_subcomm_ass;
-  uint64_t node_wt;
-};
+using NodeData = std::tuple<
+    CurrentCommunityId, DegreeWeight, CurrentSubCommunityId, NodeWeight>;
 
-using Graph = galois::graphs::LC_CSR_Graph<Node, EdgeTy>::with_no_lockable<
-    false>::type::with_numa_alloc<true>::type;
-using GNode = Graph::GraphNode;
+static const std::vector<std::string> kNodePropertyNames{
+    "curr_comm_ass", "degree_wt", "curr_subcomm_ass", "node_wt"};
+
+using Graph = galois::graphs::PropertyGraph<NodeData, EdgeData>;
+using GNode = Graph::Node;
 
 double
 algoLeidenWithLocking(
@@ -111,11 +107,12 @@ algoLeidenWithLocking(
     });
 
     galois::do_all(galois::iterate(graph), [&](GNode n) {
-      auto& n_data = graph.getData(n);
-      galois::atomicAdd(c_info[n_data.curr_comm_ass].size, uint64_t{1});
-      galois::atomicAdd(c_info[n_data.curr_comm_ass].node_wt, n_data.node_wt);
+      uint64_t n_curr_comm = graph.GetData<CurrentCommunityId>(n);
+      galois::atomicAdd(c_info[n_curr_comm].size, uint64_t{1});
+      galois::atomicAdd(
+          c_info[n_curr_comm].node_wt, graph.GetData<NodeWeight>(n));
       galois::atomicAdd(
-          c_info[n_data.curr_comm_ass].degree_wt, n_data.degree_wt);
+          c_info[n_curr_comm].degree_wt, graph.GetData<DegreeWeight>(n));
     });
   }
 
@@ -142,10 +139,10 @@ algoLeidenWithLocking(
     galois::for_each(
         galois::iterate(graph),
         [&](GNode n, auto&) {
-          auto& n_data = graph.getData(n, flag_write_lock);
-          uint64_t degree = std::distance(
-              graph.edge_begin(n, flag_write_lock),
-              graph.edge_end(n, flag_write_lock));
+          auto& n_curr_comm = graph.GetData<CurrentCommunityId>(n);
+          EdgeTy n_degree_wt = graph.GetData<DegreeWeight>(n);
+          uint64_t n_node_wt = graph.GetData<NodeWeight>(n);
+          uint64_t degree = Degree(graph, n);
 
           uint64_t local_target = UNASSIGNED;
           std::map<uint64_t, uint64_t>
@@ -160,30 +157,25 @@ algoLeidenWithLocking(
                 graph, n, cluster_local_map, counter, self_loop_wt);
             local_target = maxModularity(
                 cluster_local_map, counter, self_loop_wt, c_info,
-                n_data.degree_wt, n_data.curr_comm_ass,
-                constant_for_second_term);
+                n_degree_wt, n_curr_comm, constant_for_second_term);
             // local_target = maxCPMQuality<Graph, CommArray>(cluster_local_map,
-            // counter, self_loop_wt, c_info, n_data.node_wt,
-            // n_data.curr_comm_ass);
+            // counter, self_loop_wt, c_info, n_node_wt, n_curr_comm);
           } else {
             local_target = UNASSIGNED;
           }
 
           /* Update cluster info */
-          if (local_target != n_data.curr_comm_ass &&
-              local_target != UNASSIGNED) {
-            galois::atomicAdd(c_info[local_target].degree_wt, n_data.degree_wt);
+          if (local_target != n_curr_comm && local_target != UNASSIGNED) {
+            galois::atomicAdd(c_info[local_target].degree_wt, n_degree_wt);
             galois::atomicAdd(c_info[local_target].size, uint64_t{1});
-            galois::atomicAdd(c_info[local_target].node_wt, n_data.node_wt);
+            galois::atomicAdd(c_info[local_target].node_wt, n_node_wt);
 
-            galois::atomicSub(
-                c_info[n_data.curr_comm_ass].degree_wt, n_data.degree_wt);
-            galois::atomicSub(c_info[n_data.curr_comm_ass].size, uint64_t{1});
-            galois::atomicSub(
-                c_info[n_data.curr_comm_ass].node_wt, n_data.node_wt);
+            galois::atomicSub(c_info[n_curr_comm].degree_wt, n_degree_wt);
+            galois::atomicSub(c_info[n_curr_comm].size, uint64_t{1});
+            galois::atomicSub(c_info[n_curr_comm].node_wt, n_node_wt);
 
             /* Set the new cluster id */
-            n_data.curr_comm_ass = local_target;
+            n_curr_comm = local_target;
           }
         },
         galois::loopname("leiden algo: Phase 1"), galois::no_pushes());
@@ -234,20 +226,21 @@ runMultiPhaseLouvainAlgorithm(
   uint32_t phase = 0;
 
   Graph* graph_curr = &graph;
-  Graph graph_next;
+  std::unique_ptr<galois::graphs::PropertyFileGraph> pfg_next;
+  std::optional<Graph> graph_next;
   uint32_t iter = 0;
   uint64_t num_nodes_orig = clusters_orig.size();
   /**
    * Assign cluster id from previous iteration
    */
   galois::do_all(galois::iterate(*graph_curr), [&](GNode n) {
-    graph_curr->getData(n).curr_comm_ass = n;
-    graph_curr->getData(n).curr_subcomm_ass = n;
-    graph_curr->getData(n).node_wt = 1;
+    graph_curr->GetData<CurrentCommunityId>(n) = n;
+    graph_curr->GetData<CurrentSubCommunityId>(n) = n;
+    graph_curr->GetData<NodeWeight>(n) = 1;
   });
   for (GNode i = 0; i < graph.size(); ++i) {
-    if (graph.getData(i).node_wt > 1)
-      galois::gPrint("-->node wt : ", graph.getData(i).node_wt, "\n");
+    if (graph.GetData<NodeWeight>(i) > 1)
+      galois::gPrint("-->node wt : ", graph.GetData<NodeWeight>(i), "\n");
   }
   while (true) {
     iter++;
@@ -281,31 +274,36 @@ runMultiPhaseLouvainAlgorithm(
       if (phase == 1) {
         galois::do_all(
             galois::iterate(uint64_t{0}, num_nodes_orig), [&](GNode n) {
-              clusters_orig[n] = (*graph_curr).getData(n).curr_subcomm_ass;
+              clusters_orig[n] =
+                  graph_curr->GetData<CurrentSubCommunityId>(n);
             });
       } else {
         galois::do_all(
             galois::iterate(uint64_t{0}, num_nodes_orig),
             [&](GNode n) {
               assert(clusters_orig[n] < (*graph_curr).size());
-              clusters_orig[n] =
-                  (*graph_curr).getData(clusters_orig[n]).curr_subcomm_ass;
+              clusters_orig[n] = graph_curr->GetData<CurrentSubCommunityId>(
+                  clusters_orig[n]);
             },
             galois::steal());
       }
-      buildNextLevelGraphSubComm(
-          *graph_curr, graph_next, num_unique_subclusters, original_comm_ass,
+      // graph_curr may be graph_next, so it is replaced only once the next
+      // level is built
+      auto pfg_coarse = buildNextLevelGraphSubComm(
+          *graph_curr, num_unique_subclusters, original_comm_ass,
           cluster_node_wt);
+      graph_next.emplace(
+          makeClusteringGraph<Graph>(pfg_coarse.get(), kNodePropertyNames));
+      pfg_next = std::move(pfg_coarse);
       prev_mod = curr_mod;
-      graph_curr = &graph_next;
+      graph_curr = &graph_next.value();
       /**
        * Assign cluster id from previous iteration
        */
       galois::do_all(galois::iterate(*graph_curr), [&](GNode n) {
-        auto& n_data = graph_curr->getData(n);
-        n_data.curr_comm_ass = original_comm_ass[n];
-        n_data.curr_subcomm_ass = original_comm_ass[n];
-        n_data.node_wt = cluster_node_wt[n];
+        graph_curr->GetData<CurrentCommunityId>(n) = original_comm_ass[n];
+        graph_curr->GetData<CurrentSubCommunityId>(n) = original_comm_ass[n];
+        graph_curr->GetData<NodeWeight>(n) = cluster_node_wt[n];
       });
 
       cluster_node_wt.clear();
@@ -332,18 +330,19 @@ main(int argc, char** argv) {
   galois::StatTimer totalTime("TimerTotal");
   totalTime.start();
 
-  Graph graph;
-  Graph graph_next;
-  Graph* graph_curr;
-
   std::cout << "Reading from file: " << inputFile << "\n";
   std::cout << "[WARNING:] Make sure " << inputFile
             << " is symmetric graph without duplicate edges\n";
-  galois::graphs::readGraph(graph, inputFile);
-  std::cout << "Read " << graph.size() << " nodes, " << graph.sizeEdges()
+  std::unique_ptr<galois::graphs::PropertyFileGraph> pfg =
+      MakeFileGraph(inputFile, edge_property_name);
+  constructEdgeWeights(pfg.get(), edge_property_name);
+  Graph graph = makeClusteringGraph<Graph>(pfg.get(), kNodePropertyNames);
+  std::cout << "Read " << graph.num_nodes() << " nodes, " << graph.num_edges()
             << " edges\n";
 
-  graph_curr = &graph;
+  std::unique_ptr<galois::graphs::PropertyFileGraph> pfg_next;
+  std::optional<Graph> graph_next;
+  Graph* graph_curr = &graph;
 
   /*
    * To keep track of communities for nodes in the original graph.
@@ -367,14 +366,14 @@ main(int argc, char** argv) {
      *Initialize node cluster id.
      */
     galois::do_all(galois::iterate(*graph_curr), [&](GNode n) {
-      clusters_orig[n] = graph.getData(n, flag_no_lock).curr_comm_ass;
+      clusters_orig[n] = graph.GetData<CurrentCommunityId>(n);
     });
 
-    /*
-     * Build new graph to remove the isolated nodes
-     */
-    buildNextLevelGraph(*graph_curr, graph_next, num_unique_clusters);
-    graph_curr = &graph_next;
+    // Build new graph to remove the isolated nodes
+    pfg_next = buildNextLevelGraph(*graph_curr, num_unique_clusters);
+    graph_next.emplace(
+        makeClusteringGraph<Graph>(pfg_next.get(), kNodePropertyNames));
+    graph_curr = &graph_next.value();
     printGraphCharateristics(*graph_curr);
   } else {
     /*
@@ -402,6 +401,14 @@ main(int argc, char** argv) {
     printNodeClusterId(graph, output_CID_filename);
   }
 
+  if (output) {
+    std::vector<uint64_t> results(graph.size());
+    galois::do_all(galois::iterate(graph), [&](GNode n) {
+      results[n] = graph.GetData<CurrentCommunityId>(n);
+    });
+    writeOutput(outputLocation, results.data(), results.size());
+  }
+
   totalTime.stop();
 
   return 0;
@@ -20,6 +20,8 @@
 #include <deque>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <type_traits>
 
 #include "Lonestar/BoilerPlate.h"
@@ -28,8 +30,7 @@
 #include "galois/Galois.h"
 #include "galois/Reduction.h"
 #include "galois/Timer.h"
-#include "galois/graphs/LCGraph.h"
-#include "galois/graphs/TypeTraits.h"
+#include "galois/analytics/graph_coloring/graph_coloring_internal.h"
 #include "galois/gstl.h"
 #include "llvm/Support/CommandLine.h"
 
@@ -69,17 +70,19 @@ struct Comm {
 
 typedef galois::LargeArray<Comm> CommArray;
 
+// The largest edge tiles in which the neighbors of a node are compared while
+// coloring
+constexpr ptrdiff_t kColoringEdgeTileSize = 256;
+
 // Graph Node information
-struct Node {
-  uint64_t prev_comm_ass;
-  uint64_t curr_comm_ass;
-  EdgeTy degree_wt;
-  int64_t colorId;
-};
+using NodeData = std::tuple<
+    PreviousCommunityId, CurrentCommunityId, DegreeWeight, ColorId>;
 
-using Graph = galois::graphs::LC_CSR_Graph<Node, EdgeTy>::with_no_lockable<
-    false>::type::with_numa_alloc<true>::type;
-using GNode = Graph::GraphNode;
+static const std::vector<std::string> kNodePropertyNames{
+    "prev_comm_ass", "curr_comm_ass", "degree_wt", "colorId"};
+
+using Graph = galois::graphs::PropertyGraph<NodeData, EdgeData>;
+using GNode = Graph::Node;
 
 double
 algoLouvainWithLocking(
@@ -105,8 +108,8 @@ algoLouvainWithLocking(
 
   /* Initialization each node to its own cluster */
   galois::do_all(galois::iterate(graph), [&graph](GNode n) {
-    graph.getData(n).curr_comm_ass = n;
-    graph.getData(n).prev_comm_ass = n;
+    graph.GetData<CurrentCommunityId>(n) = n;
+    graph.GetData<PreviousCommunityId>(n) = n;
   });
 
   galois::gPrint("Init Done\n");
@@ -128,6 +131,8 @@ algoLouvainWithLocking(
       "============================================================="
       "===========================================\n");
 
+  ActiveNodes active(graph.size(), enable_pruning);
+
   galois::StatTimer TimerClusteringWhile("Timer_Clustering_While");
   TimerClusteringWhile.start();
   while (true) {
@@ -141,10 +146,12 @@ algoLouvainWithLocking(
     galois::for_each(
         galois::iterate(graph),
         [&](GNode n, auto&) {
-          auto& n_data = graph.getData(n, flag_write_lock);
-          uint64_t degree = std::distance(
-              graph.edge_begin(n, flag_write_lock),
-              graph.edge_end(n, flag_write_lock));
+          if (!active.IsActive(n)) {
+            return;
+          }
+          auto& n_curr_comm = graph.GetData<CurrentCommunityId>(n);
+          EdgeTy n_degree_wt = graph.GetData<DegreeWeight>(n);
+          uint64_t degree = Degree(graph, n);
           uint64_t local_target = UNASSIGNED;
           std::map<uint64_t, uint64_t>
               cluster_local_map;  // Map each neighbor's cluster to local number:
@@ -158,24 +165,22 @@ algoLouvainWithLocking(
             // Find the max gain in modularity
             local_target = maxModularity(
                 cluster_local_map, counter, self_loop_wt, c_info,
-                n_data.degree_wt, n_data.curr_comm_ass,
-                constant_for_second_term);
+                n_degree_wt, n_curr_comm, constant_for_second_term);
 
           } else {
             local_target = UNASSIGNED;
           }
 
           /* Update cluster info */
-          if (local_target != n_data.curr_comm_ass &&
-              local_target != UNASSIGNED) {
-            galois::atomicAdd(c_info[local_target].degree_wt, n_data.degree_wt);
+          if (local_target != n_curr_comm && local_target != UNASSIGNED) {
+            galois::atomicAdd(c_info[local_target].degree_wt, n_degree_wt);
             galois::atomicAdd(c_info[local_target].size, (uint64_t)1);
-            galois::atomicSub(
-                c_info[n_data.curr_comm_ass].degree_wt, n_data.degree_wt);
-            galois::atomicSub(c_info[n_data.curr_comm_ass].size, (uint64_t)1);
+            galois::atomicSub(c_info[n_curr_comm].degree_wt, n_degree_wt);
+            galois::atomicSub(c_info[n_curr_comm].size, (uint64_t)1);
 
             /* Set the new cluster id */
-            n_data.curr_comm_ass = local_target;
+            n_curr_comm = local_target;
+            active.ActivateNeighbors(graph, n);
           }
         },
         galois::loopname("louvain algo: Phase 1"), galois::no_pushes());
@@ -200,6 +205,7 @@ algoLouvainWithLocking(
     }
 
     prev_mod = curr_mod;
+    active.Advance();
 
   }  // End while
   TimerClusteringWhile.stop();
@@ -240,9 +246,9 @@ algoLouvainWithoutLockingDoAll(
 
   /* Initialization each node to its own cluster */
   galois::do_all(galois::iterate(graph), [&graph](GNode n) {
-    graph.getData(n).curr_comm_ass = n;
-    graph.getData(n).prev_comm_ass = n;
-    graph.getData(n).colorId = -1;
+    graph.GetData<CurrentCommunityId>(n) = n;
+    graph.GetData<PreviousCommunityId>(n) = n;
+    graph.GetData<ColorId>(n) = -1;
   });
 
   galois::gPrint("Init Done\n");
@@ -264,6 +270,8 @@ algoLouvainWithoutLockingDoAll(
       "============================================================="
       "===========================================\n");
 
+  ActiveNodes active(graph.size(), enable_pruning);
+
   galois::StatTimer TimerClusteringWhile("Timer_Clustering_While");
   TimerClusteringWhile.start();
   while (true) {
@@ -277,10 +285,12 @@ algoLouvainWithoutLockingDoAll(
     galois::do_all(
         galois::iterate(graph),
         [&](GNode n) {
-          auto& n_data = graph.getData(n, flag_write_lock);
-          uint64_t degree = std::distance(
-              graph.edge_begin(n, flag_no_lock),
-              graph.edge_end(n, flag_no_lock));
+          if (!active.IsActive(n)) {
+            return;
+          }
+          auto& n_curr_comm = graph.GetData<CurrentCommunityId>(n);
+          EdgeTy n_degree_wt = graph.GetData<DegreeWeight>(n);
+          uint64_t degree = Degree(graph, n);
           uint64_t local_target = UNASSIGNED;
           std::map<uint64_t, uint64_t>
               cluster_local_map;  // Map each neighbor's cluster to local number:
@@ -295,24 +305,22 @@ algoLouvainWithoutLockingDoAll(
             // Find the max gain in modularity
             local_target = maxModularityWithoutSwaps(
                 cluster_local_map, counter, self_loop_wt, c_info,
-                n_data.degree_wt, n_data.curr_comm_ass,
-                constant_for_second_term);
+                n_degree_wt, n_curr_comm, constant_for_second_term);
 
           } else {
             local_target = UNASSIGNED;
           }
 
           /* Update cluster info */
-          if (local_target != n_data.curr_comm_ass &&
-              local_target != UNASSIGNED) {
-            galois::atomicAdd(c_info[local_target].degree_wt, n_data.degree_wt);
+          if (local_target != n_curr_comm && local_target != UNASSIGNED) {
+            galois::atomicAdd(c_info[local_target].degree_wt, n_degree_wt);
             galois::atomicAdd(c_info[local_target].size, (uint64_t)1);
-            galois::atomicSub(
-                c_info[n_data.curr_comm_ass].degree_wt, n_data.degree_wt);
-            galois::atomicSub(c_info[n_data.curr_comm_ass].size, (uint64_t)1);
+            galois::atomicSub(c_info[n_curr_comm].degree_wt, n_degree_wt);
+            galois::atomicSub(c_info[n_curr_comm].size, (uint64_t)1);
 
             /* Set the new cluster id */
-            n_data.curr_comm_ass = local_target;
+            n_curr_comm = local_target;
+            active.ActivateNeighbors(graph, n);
           }
         },
         galois::loopname("louvain algo: Phase 1"));
@@ -337,6 +345,7 @@ algoLouvainWithoutLockingDoAll(
     }
 
     prev_mod = curr_mod;
+    active.Advance();
 
   }  // End while
   TimerClusteringWhile.stop();
@@ -377,9 +386,9 @@ algoLouvainWithLockingDelayUpdate(
 
   /* Initialization each node to its own cluster */
   galois::do_all(galois::iterate(graph), [&graph](GNode n) {
-    graph.getData(n).curr_comm_ass = n;
-    graph.getData(n).prev_comm_ass = n;
-    graph.getData(n).colorId = -1;
+    graph.GetData<CurrentCommunityId>(n) = n;
+    graph.GetData<PreviousCommunityId>(n) = n;
+    graph.GetData<ColorId>(n) = -1;
   });
 
   galois::gPrint("Init Done\n");
@@ -401,6 +410,8 @@ algoLouvainWithLockingDelayUpdate(
       "============================================================="
       "===========================================\n");
 
+  ActiveNodes active(graph.size(), enable_pruning);
+
   galois::StatTimer TimerClusteringWhile("Timer_Clustering_While");
   TimerClusteringWhile.start();
   while (true) {
@@ -416,10 +427,13 @@ algoLouvainWithLockingDelayUpdate(
     galois::do_all(
         galois::iterate(graph),
         [&](GNode n) {
-          auto& n_data = graph.getData(n, flag_write_lock);
-          uint64_t degree = std::distance(
-              graph.edge_begin(n, flag_no_lock),
-              graph.edge_end(n, flag_no_lock));
+          auto& n_curr_comm = graph.GetData<CurrentCommunityId>(n);
+          if (!active.IsActive(n)) {
+            local_target[n] = n_curr_comm;
+            return;
+          }
+          EdgeTy n_degree_wt = graph.GetData<DegreeWeight>(n);
+          uint64_t degree = Degree(graph, n);
           std::map<uint64_t, uint64_t>
               cluster_local_map;  // Map each neighbor's cluster to local number:
                                   // Community --> Index
@@ -433,21 +447,17 @@ algoLouvainWithLockingDelayUpdate(
             // Find the max gain in modularity
             local_target[n] = maxModularity(
                 cluster_local_map, counter, self_loop_wt, c_info,
-                n_data.degree_wt, n_data.curr_comm_ass,
-                constant_for_second_term);
+                n_degree_wt, n_curr_comm, constant_for_second_term);
           } else {
             local_target[n] = UNASSIGNED;
           }
 
           /* Update cluster info */
-          if (local_target[n] != n_data.curr_comm_ass &&
-              local_target[n] != UNASSIGNED) {
-            galois::atomicAdd(
-                c_update[local_target[n]].degree_wt, n_data.degree_wt);
+          if (local_target[n] != n_curr_comm && local_target[n] != UNASSIGNED) {
+            galois::atomicAdd(c_update[local_target[n]].degree_wt, n_degree_wt);
             galois::atomicAdd(c_update[local_target[n]].size, (uint64_t)1);
-            galois::atomicSub(
-                c_update[n_data.curr_comm_ass].degree_wt, n_data.degree_wt);
-            galois::atomicSub(c_update[n_data.curr_comm_ass].size, (uint64_t)1);
+            galois::atomicSub(c_update[n_curr_comm].degree_wt, n_degree_wt);
+            galois::atomicSub(c_update[n_curr_comm].size, (uint64_t)1);
           }
         },
         galois::loopname("louvain algo: Phase 1"));
@@ -475,15 +485,19 @@ algoLouvainWithLockingDelayUpdate(
       prev_mod = lower;
 
     galois::do_all(galois::iterate(graph), [&](GNode n) {
-      auto& n_data = graph.getData(n, flag_no_lock);
-      n_data.prev_comm_ass = n_data.curr_comm_ass;
-      n_data.curr_comm_ass = local_target[n];
+      auto& n_curr_comm = graph.GetData<CurrentCommunityId>(n);
+      if (local_target[n] != n_curr_comm && local_target[n] != UNASSIGNED) {
+        active.ActivateNeighbors(graph, n);
+      }
+      graph.GetData<PreviousCommunityId>(n) = n_curr_comm;
+      n_curr_comm = local_target[n];
       galois::atomicAdd(c_info[n].size, c_update[n].size.load());
       galois::atomicAdd(c_info[n].degree_wt, c_update[n].degree_wt.load());
 
       c_update[n].size = 0;
       c_update[n].degree_wt = 0;
     });
+    active.Advance();
 
   }  // End while
   TimerClusteringWhile.stop();
@@ -500,86 +514,30 @@ algoLouvainWithLockingDelayUpdate(
   return prev_mod;
 }
 
+/**
+ * Colors graph with the library Jones-Plassmann rounds, which never give two
+ * neighbors the same color, and copies the colors into ColorId.
+ *
+ * @returns the number of colors
+ */
 uint64_t
 coloringDistanceOne(Graph& graph) {
-  galois::for_each(
-      galois::iterate(graph),
-      [&](GNode n, auto&) {
-        auto& n_data = graph.getData(n, flag_write_lock);
-
-        /* Grab lock on neighbours: Cautious operator */
-        for (auto ii = graph.edge_begin(n, flag_write_lock);
-             ii != graph.edge_end(n, flag_write_lock); ++ii) {
-          graph.getData(
-              graph.getEdgeDst(ii),
-              flag_write_lock);  // TODO: Can we use read lock?
-        }
-
-        int64_t max_color = -1;
-        int64_t my_color = 0;
-        int64_t degree = std::distance(graph.edge_begin(n), graph.edge_end(n));
-        if (degree > 0) {
-          std::vector<bool> isColorSet;
-          isColorSet.resize(degree, false);
-          for (auto ii = graph.edge_begin(n, flag_write_lock);
-               ii != graph.edge_end(n, flag_write_lock); ++ii) {
-            auto dst = graph.getEdgeDst(ii);
-            if (dst == n)
-              continue;
-
-            auto& dst_data = graph.getData(
-                dst, flag_write_lock);  // TODO: Can we use read lock?
-            if (dst_data.colorId >= 0) {
-              if (dst_data.colorId >= degree)
-                isColorSet.resize(dst_data.colorId);
-
-              isColorSet[dst_data.colorId] = true;
-              if ((dst_data.colorId > max_color)) {
-                max_color = dst_data.colorId;
-              }
-            }
-          }
-
-          if (max_color >= 0) {
-            /* Assign color */
-            for (; my_color <= max_color; my_color++) {
-              if (isColorSet[my_color] == false) {
-                break;
-              }
-            }
+  galois::LargeArray<std::atomic<uint32_t>> colors;
+  colors.allocateBlocked(graph.size());
+  galois::do_all(
+      galois::iterate(graph), [&](GNode n) { colors.constructAt(n, 0U); },
+      galois::no_stats());
 
-            if (my_color == max_color)
-              my_color++;
-          }
-        }
-        n_data.colorId = my_color;
-      },
-      galois::loopname("Coloring loop"));
+  uint32_t num_colors = galois::analytics::JonesPlassmannColoring(
+      graph, kColoringEdgeTileSize,
+      [&](GNode n) -> std::atomic<uint32_t>& { return colors[n]; });
 
-  galois::gPrint("Checking for conflicts\n");
-  /* Check for conflicts */
-  galois::GAccumulator<uint64_t> conflicts;
   galois::do_all(
       galois::iterate(graph),
       [&](GNode n) {
-        auto& n_data = graph.getData(n, flag_no_lock);
-        for (auto ii = graph.edge_begin(n, flag_write_lock);
-             ii != graph.edge_end(n, flag_write_lock); ++ii) {
-          auto dst = graph.getEdgeDst(ii);
-          auto& dst_data = graph.getData(dst, flag_no_lock);
-          if (dst_data.colorId == n_data.colorId)
-            conflicts += 1;
-        }
+        graph.GetData<ColorId>(n) = colors[n].load(std::memory_order_relaxed);
       },
-      galois::loopname("Coloring conflicts"));
-  galois::gPrint("WARNING: Conflicts found : ", conflicts.reduce(), "\n");
-
-  int64_t num_colors = 0;
-  for (GNode n = 0; n < graph.size(); ++n) {
-    int64_t color = graph.getData(n, flag_no_lock).colorId;
-    if (color > num_colors)
-      num_colors = color;
-  }
+      galois::loopname("Coloring copy"));
 
   return num_colors;
 }
@@ -608,9 +566,9 @@ algoLouvainWithColoring(
 
   /* Initialization each node to its own cluster */
   galois::do_all(galois::iterate(graph), [&graph](GNode n) {
-    graph.getData(n).curr_comm_ass = n;
-    graph.getData(n).prev_comm_ass = n;
-    graph.getData(n).colorId = -1;
+    graph.GetData<CurrentCommunityId>(n) = n;
+    graph.GetData<PreviousCommunityId>(n) = n;
+    graph.GetData<ColorId>(n) = -1;
   });
 
   galois::gPrint("Coloring\n");
@@ -642,6 +600,8 @@ algoLouvainWithColoring(
     c_update[n].size = 0;
   });
 
+  ActiveNodes active(graph.size(), enable_pruning);
+
   galois::StatTimer TimerClusteringWhile("Timer_Clustering_While");
   TimerClusteringWhile.start();
   while (true) {
@@ -652,11 +612,10 @@ algoLouvainWithColoring(
       galois::do_all(
           galois::iterate(graph),
           [&](GNode n) {
-            auto& n_data = graph.getData(n, flag_write_lock);
-            if (n_data.colorId == c) {
-              uint64_t degree = std::distance(
-                  graph.edge_begin(n, flag_no_lock),
-                  graph.edge_end(n, flag_no_lock));
+            if (graph.GetData<ColorId>(n) == c && active.IsActive(n)) {
+              auto& n_curr_comm = graph.GetData<CurrentCommunityId>(n);
+              EdgeTy n_degree_wt = graph.GetData<DegreeWeight>(n);
+              uint64_t degree = Degree(graph, n);
               uint64_t local_target = UNASSIGNED;
               std::map<uint64_t, uint64_t>
                   cluster_local_map;  // Map each neighbor's cluster to local
@@ -671,23 +630,20 @@ algoLouvainWithColoring(
                 // Find the max gain in modularity
                 local_target = maxModularity(
                     cluster_local_map, counter, self_loop_wt, c_info,
-                    n_data.degree_wt, n_data.curr_comm_ass,
-                    constant_for_second_term);
+                    n_degree_wt, n_curr_comm, constant_for_second_term);
               } else {
                 local_target = UNASSIGNED;
               }
               /* Update cluster info */
-              if (local_target != n_data.curr_comm_ass &&
-                  local_target != UNASSIGNED) {
+              if (local_target != n_curr_comm && local_target != UNASSIGNED) {
                 galois::atomicAdd(
-                    c_update[local_target].degree_wt, n_data.degree_wt);
+                    c_update[local_target].degree_wt, n_degree_wt);
                 galois::atomicAdd(c_update[local_target].size, (uint64_t)1);
-                galois::atomicSub(
-                    c_update[n_data.curr_comm_ass].degree_wt, n_data.degree_wt);
-                galois::atomicSub(
-                    c_update[n_data.curr_comm_ass].size, (uint64_t)1);
+                galois::atomicSub(c_update[n_curr_comm].degree_wt, n_degree_wt);
+                galois::atomicSub(c_update[n_curr_comm].size, (uint64_t)1);
                 /* Set the new cluster id */
-                n_data.curr_comm_ass = local_target;
+                n_curr_comm = local_target;
+                active.ActivateNeighbors(graph, n);
               }
             }
           },
@@ -720,6 +676,7 @@ algoLouvainWithColoring(
     }
 
     prev_mod = curr_mod;
+    active.Advance();
 
   }  // End while
   TimerClusteringWhile.stop();
@@ -746,7 +703,8 @@ runMultiPhaseLouvainAlgorithm(
   uint32_t phase = 0;
 
   Graph* graph_curr = &graph;
-  Graph graph_next;
+  std::unique_ptr<galois::graphs::PropertyFileGraph> pfg_next;
+  std::optional<Graph> graph_next;
   uint32_t iter = 0;
   uint64_t num_nodes_orig = clusters_orig.size();
   while (true) {
@@ -787,23 +745,26 @@ runMultiPhaseLouvainAlgorithm(
       if (!enable_VF && phase == 1) {
         assert(num_nodes_orig == (*graph_curr).size());
         galois::do_all(galois::iterate(*graph_curr), [&](GNode n) {
-          clusters_orig[n] =
-              (*graph_curr).getData(n, flag_no_lock).curr_comm_ass;
+          clusters_orig[n] = graph_curr->GetData<CurrentCommunityId>(n);
         });
       } else {
         galois::do_all(
             galois::iterate((uint64_t)0, num_nodes_orig), [&](GNode n) {
               if (clusters_orig[n] != UNASSIGNED) {
                 assert(clusters_orig[n] < graph_curr->size());
-                clusters_orig[n] = (*graph_curr)
-                                       .getData(clusters_orig[n], flag_no_lock)
-                                       .curr_comm_ass;
+                clusters_orig[n] =
+                    graph_curr->GetData<CurrentCommunityId>(clusters_orig[n]);
               }
             });
       }
-      buildNextLevelGraph(*graph_curr, graph_next, num_unique_clusters);
+      // graph_curr may be graph_next, so it is replaced only once the next
+      // level is built
+      auto pfg_coarse = buildNextLevelGraph(*graph_curr, num_unique_clusters);
+      graph_next.emplace(
+          makeClusteringGraph<Graph>(pfg_coarse.get(), kNodePropertyNames));
+      pfg_next = std::move(pfg_coarse);
       prev_mod = curr_mod;
-      graph_curr = &graph_next;
+      graph_curr = &graph_next.value();
       printGraphCharateristics(*graph_curr);
     } else {
       break;
@@ -828,18 +789,19 @@ main(int argc, char** argv) {
   galois::StatTimer totalTime("TimerTotal");
   totalTime.start();
 
-  Graph graph;
-  Graph graph_next;
-  Graph* graph_curr;
-
   std::cout << "Reading from file: " << inputFile << "\n";
   std::cout << "[WARNING:] Make sure " << inputFile
             << " is symmetric graph without duplicate edges\n";
-  galois::graphs::readGraph(graph, inputFile);
-  std::cout << "Read " << graph.size() << " nodes, " << graph.sizeEdges()
+  std::unique_ptr<galois::graphs::PropertyFileGraph> pfg =
+      MakeFileGraph(inputFile, edge_property_name);
+  constructEdgeWeights(pfg.get(), edge_property_name);
+  Graph graph = makeClusteringGraph<Graph>(pfg.get(), kNodePropertyNames);
+  std::cout << "Read " << graph.num_nodes() << " nodes, " << graph.num_edges()
             << " edges\n";
 
-  graph_curr = &graph;
+  std::unique_ptr<galois::graphs::PropertyFileGraph> pfg_next;
+  std::optional<Graph> graph_next;
+  Graph* graph_curr = &graph;
 
   /*
    * To keep track of communities for nodes in the original graph.
@@ -863,12 +825,14 @@ main(int argc, char** argv) {
      *Initialize node cluster id.
      */
     galois::do_all(galois::iterate(*graph_curr), [&](GNode n) {
-      clusters_orig[n] = graph.getData(n, flag_no_lock).curr_comm_ass;
+      clusters_orig[n] = graph.GetData<CurrentCommunityId>(n);
     });
 
     // Build new graph to remove the isolated nodes
-    buildNextLevelGraph(*graph_curr, graph_next, num_unique_clusters);
-    graph_curr = &graph_next;
+    pfg_next = buildNextLevelGraph(*graph_curr, num_unique_clusters);
+    graph_next.emplace(
+        makeClusteringGraph<Graph>(pfg_next.get(), kNodePropertyNames));
+    graph_curr = &graph_next.value();
     printGraphCharateristics(*graph_curr);
   } else {
     /*
@@ -894,6 +858,14 @@ main(int argc, char** argv) {
     printNodeClusterId(graph, output_CID_filename);
   }
 
+  if (output) {
+    std::vector<uint64_t> results(graph.size());
+    galois::do_all(galois::iterate(graph), [&](GNode n) {
+      results[n] = graph.GetData<CurrentCommunityId>(n);
+    });
+    writeOutput(outputLocation, results.data(), results.size());
+  }
+
   totalTime.stop();
 
   return 0;
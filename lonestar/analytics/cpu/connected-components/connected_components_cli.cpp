@@ -0,0 +1,252 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include "Lonestar/BoilerPlate.h"
+#include "galois/analytics/connected_components/connected_components.h"
+
+using namespace galois::analytics;
+
+namespace cll = llvm::cl;
+
+static const char* name = "Connected Components";
+
+static const char* desc =
+    "Computes the connected components of a graph with the analytics library";
+
+static const char* url = nullptr;
+
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+
+static cll::opt<ConnectedComponentsPlan::Algorithm> algo(
+    "algo", cll::desc("Choose an algorithm (default value Automatic):"),
+    cll::values(
+        clEnumValN(ConnectedComponentsPlan::kAsynchronous, "Async", "Async"),
+        clEnumValN(
+            ConnectedComponentsPlan::kEdgeAsynchronous, "EdgeAsync",
+            "EdgeAsync"),
+        clEnumValN(
+            ConnectedComponentsPlan::kEdgeTiledAsynchronous, "EdgetiledAsync",
+            "EdgetiledAsync"),
+        clEnumValN(
+            ConnectedComponentsPlan::kBlockedAsynchronous, "BlockedAsync",
+            "BlockedAsync"),
+        clEnumValN(
+            ConnectedComponentsPlan::kLabelProp, "LabelProp", "LabelProp"),
+        clEnumValN(ConnectedComponentsPlan::kSerial, "Serial", "Serial"),
+        clEnumValN(ConnectedComponentsPlan::kSynchronous, "Sync", "Sync"),
+        clEnumValN(ConnectedComponentsPlan::kAfforest, "Afforest", "Afforest"),
+        clEnumValN(
+            ConnectedComponentsPlan::kEdgeAfforest, "EdgeAfforest",
+            "EdgeAfforest"),
+        clEnumValN(
+            ConnectedComponentsPlan::kEdgeTiledAfforest, "EdgetiledAfforest",
+            "EdgetiledAfforest"),
+        clEnumValN(
+            ConnectedComponentsPlan::kAutomatic, "Automatic", "Automatic")),
+    cll::init(ConnectedComponentsPlan::kAutomatic));
+
+static cll::opt<uint32_t> edgeTileSize(
+    "edgeTileSize",
+    cll::desc("(For Edgetiled algos) Size of edge tiles (default 512)"),
+    cll::init(ConnectedComponentsPlan::kDefaultEdgeTileSize));
+//! parameter for the Vertex Neighbor Sampling step of Afforest algorithm
+static cll::opt<uint32_t> neighborSamples(
+    "vns",
+    cll::desc("(For Afforest and its variants) number of edges "
+              "per vertice to process initially for exposing "
+              "partial connectivity (default 2)"),
+    cll::init(ConnectedComponentsPlan::kDefaultNeighborSampleSize));
+//! parameter for the Large Component Skipping step of Afforest algorithm
+static cll::opt<uint32_t> componentSamples(
+    "lcs",
+    cll::desc("(For Afforest and its variants) number of times "
+              "randomly sampling over vertices to approximately "
+              "capture the largest intermediate component "
+              "(default 1024)"),
+    cll::init(ConnectedComponentsPlan::kDefaultComponentSampleFrequency));
+
+std::string
+AlgorithmName(ConnectedComponentsPlan::Algorithm algorithm) {
+  switch (algorithm) {
+  case ConnectedComponentsPlan::kSerial:
+    return "Serial";
+  case ConnectedComponentsPlan::kLabelProp:
+    return "LabelProp";
+  case ConnectedComponentsPlan::kSynchronous:
+    return "Sync";
+  case ConnectedComponentsPlan::kAsynchronous:
+    return "Async";
+  case ConnectedComponentsPlan::kEdgeAsynchronous:
+    return "EdgeAsync";
+  case ConnectedComponentsPlan::kEdgeTiledAsynchronous:
+    return "EdgetiledAsync";
+  case ConnectedComponentsPlan::kBlockedAsynchronous:
+    return "BlockedAsync";
+  case ConnectedComponentsPlan::kAfforest:
+    return "Afforest";
+  case ConnectedComponentsPlan::kEdgeAfforest:
+    return "EdgeAfforest";
+  case ConnectedComponentsPlan::kEdgeTiledAfforest:
+    return "EdgetiledAfforest";
+  case ConnectedComponentsPlan::kAutomatic:
+    return "Automatic";
+  default:
+    return "Unknown";
+  }
+}
+
+ConnectedComponentsPlan
+MakePlan(const galois::graphs::PropertyFileGraph* pfg) {
+  switch (algo) {
+  case ConnectedComponentsPlan::kSerial:
+    return ConnectedComponentsPlan::Serial();
+  case ConnectedComponentsPlan::kLabelProp:
+    return ConnectedComponentsPlan::LabelProp();
+  case ConnectedComponentsPlan::kSynchronous:
+    return ConnectedComponentsPlan::Synchronous();
+  case ConnectedComponentsPlan::kAsynchronous:
+    return ConnectedComponentsPlan::Asynchronous();
+  case ConnectedComponentsPlan::kEdgeAsynchronous:
+    return ConnectedComponentsPlan::EdgeAsynchronous();
+  case ConnectedComponentsPlan::kEdgeTiledAsynchronous:
+    return ConnectedComponentsPlan::EdgeTiledAsynchronous(edgeTileSize);
+  case ConnectedComponentsPlan::kBlockedAsynchronous:
+    return ConnectedComponentsPlan::BlockedAsynchronous();
+  case ConnectedComponentsPlan::kAfforest:
+    return ConnectedComponentsPlan::Afforest(neighborSamples, componentSamples);
+  case ConnectedComponentsPlan::kEdgeAfforest:
+    return ConnectedComponentsPlan::EdgeAfforest(
+        neighborSamples, componentSamples);
+  case ConnectedComponentsPlan::kEdgeTiledAfforest:
+    return ConnectedComponentsPlan::EdgeTiledAfforest(
+        edgeTileSize, neighborSamples, componentSamples);
+  case ConnectedComponentsPlan::kAutomatic:
+  default:
+    return ConnectedComponentsPlan::Automatic(pfg);
+  }
+}
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<galois::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  galois::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  if (!symmetricGraph) {
+    GALOIS_DIE(
+        "This application requires a symmetric graph input;"
+        " please use the -symmetricGraph flag "
+        " to indicate the input is a symmetric graph.");
+  }
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<galois::graphs::PropertyFileGraph> pfg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  std::cout << "Read " << pfg->topology().num_nodes() << " nodes, "
+            << pfg->topology().num_edges() << " edges\n";
+
+  ConnectedComponentsPlan plan = MakePlan(pfg.get());
+
+  std::cout << "Running " << AlgorithmName(plan.algorithm()) << "\n";
+
+  galois::reportPageAlloc("MeminfoPre");
+
+  LonestarRun(pfg.get(), {"component"}, {}, [&]() {
+    if (auto r = ConnectedComponents(pfg.get(), "component", plan); !r) {
+      std::cerr << r.error().message() << "\n";
+      abort();
+    }
+  });
+
+  using Graph = galois::graphs::PropertyGraph<
+      std::tuple<ConnectedComponentsNodeComponent>, std::tuple<>>;
+  auto pg_result = Graph::Make(pfg.get(), {"component"}, {});
+  if (!pg_result) {
+    std::cerr << pg_result.error().message() << "\n";
+    abort();
+  }
+  Graph graph = pg_result.value();
+
+  galois::reportPageAlloc("MeminfoPost");
+
+  // Sanity checking code; components are labeled by their smallest node
+  std::vector<uint64_t> component_sizes(graph.num_nodes());
+  for (auto node : graph) {
+    component_sizes[graph.GetData<ConnectedComponentsNodeComponent>(node)] += 1;
+  }
+  size_t num_components = 0;
+  size_t num_non_trivial = 0;
+  uint64_t largest_size = 0;
+  for (uint64_t size : component_sizes) {
+    num_components += size > 0;
+    num_non_trivial += size > 1;
+    largest_size = std::max(largest_size, size);
+  }
+
+  std::cout << "Total components: " << num_components << "\n";
+  std::cout << "Number of non-trivial components: " << num_non_trivial
+            << " (largest size: " << largest_size << ")\n";
+
+  if (!skipVerify) {
+    galois::GReduceLogicalOr bad;
+    galois::do_all(
+        galois::iterate(graph),
+        [&](uint32_t n) {
+          auto component = graph.GetData<ConnectedComponentsNodeComponent>(n);
+          for (auto e : graph.edges(n)) {
+            auto dest = graph.GetEdgeDest(e);
+            if (graph.GetData<ConnectedComponentsNodeComponent>(dest) !=
+                component) {
+              bad.update(true);
+            }
+          }
+        },
+        galois::loopname("Verify"), galois::no_stats());
+
+    if (!bad.reduce()) {
+      std::cout << "Verification successful.\n";
+    } else {
+      GALOIS_DIE("verification failed");
+    }
+  }
+
+  if (output) {
+    std::vector<uint64_t> results;
+    results.reserve(graph.num_nodes());
+    for (auto node : graph) {
+      results.push_back(graph.GetData<ConnectedComponentsNodeComponent>(node));
+    }
+
+    writeOutput(outputLocation, results.data(), results.size());
+  }
+
+  LonestarCommit(pfg.get());
+
+  totalTime.stop();
+
+  return 0;
+}
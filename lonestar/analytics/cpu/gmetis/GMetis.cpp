@@ -36,6 +36,7 @@
 #include "Lonestar/BoilerPlate.h"
 #include "galois/LargeArray.h"
 #include "galois/graphs/FileGraph.h"
+#include "galois/graphs/PropertyFileGraph.h"
 
 namespace cll = llvm::cl;
 
@@ -80,6 +81,11 @@ static cll::opt<double> imbalance(
     "balance",
     cll::desc("Fraction deviated from mean partition size (default 0.01)"),
     cll::init(0.01));
+static cll::opt<std::string> outputRDG(
+    "outputRDG",
+    cll::desc(
+        "Read the input as a property graph and write it to this RDG with "
+        "the nodes of each partition numbered contiguously"));
 
 // const double COARSEN_FRACTION = 0.9;
 
@@ -174,6 +180,171 @@ struct order_by_degree {
 typedef galois::substrate::PerThreadStorage<std::map<GNode, uint64_t>>
     PerThreadDegInfo;
 
+/// The node property in which -outputRDG records the partition of each node
+constexpr char kPartitionProperty[] = "partition";
+
+/**
+ * Constructs graph from the topology of pfg with unit edge weights.
+ *
+ * @param pfg Property graph to read
+ * @param graph Graph to construct
+ * @param nodes Set to the node of graph of each node of pfg
+ */
+void
+ReadPropertyGraph(
+    const galois::graphs::PropertyFileGraph& pfg, GGraph* graph,
+    GGraph::ReadGraphAuxData* nodes) {
+  const galois::graphs::GraphTopology& topology = pfg.topology();
+  uint64_t num_nodes = topology.num_nodes();
+  const uint32_t* dests = topology.out_dests->raw_values();
+
+  // The edges of pfg are already grouped by source, so the degrees and the
+  // neighbors of each node can be filled in parallel
+  galois::graphs::FileGraphWriter file_graph;
+  file_graph.setNumNodes(num_nodes);
+  file_graph.setNumEdges(topology.num_edges());
+  file_graph.setSizeofEdgeData(sizeof(int));
+  file_graph.phase1();
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        auto [begin, end] = topology.edge_range(n);
+        file_graph.incrementDegree(n, end - begin);
+      },
+      galois::no_stats(), galois::loopname("ReadPropertyGraphDegrees"));
+  file_graph.phase2();
+  galois::do_all(
+      galois::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        auto [begin, end] = topology.edge_range(n);
+        for (uint64_t e = begin; e < end; ++e) {
+          file_graph.addNeighbor(n, dests[e]);
+        }
+      },
+      galois::steal(), galois::no_stats(),
+      galois::loopname("ReadPropertyGraphEdges"));
+  int* weights = file_graph.finish<int>();
+  galois::do_all(
+      galois::iterate(uint64_t{0}, topology.num_edges()),
+      [&](uint64_t e) { weights[e] = 1; }, galois::no_stats());
+
+  graph->allocateFrom(file_graph, *nodes);
+  galois::on_each([&](unsigned tid, unsigned total) {
+    graph->constructNodesFrom(file_graph, tid, total, *nodes);
+  });
+  galois::on_each([&](unsigned tid, unsigned total) {
+    graph->constructEdgesFrom(file_graph, tid, total, *nodes);
+  });
+}
+
+/**
+ * Relabels the nodes of pfg so that the nodes of each partition are
+ * contiguous, in the order of the partitions, records the partition of each
+ * node in kPartitionProperty and writes pfg to rdg_name.
+ *
+ * Within a partition the nodes keep their relative order, so whatever
+ * locality the input numbering had is kept inside the partitions. The new
+ * ids come from a stable counting sort by partition: each thread counts the
+ * partitions of a block of nodes, and then places its block at the offsets
+ * of the prefix sum of the counts.
+ *
+ * @param pfg Property graph that graph was read from
+ * @param graph Partitioned graph
+ * @param nodes Node of graph of each node of pfg
+ * @param num_partitions Number of partitions
+ * @param rdg_name RDG to write
+ * @param command_line Command line recorded with the RDG
+ */
+void
+WritePartitionedRDG(
+    galois::graphs::PropertyFileGraph* pfg, GGraph& graph,
+    const GGraph::ReadGraphAuxData& nodes, uint32_t num_partitions,
+    const std::string& rdg_name, const std::string& command_line) {
+  uint64_t num_nodes = pfg->topology().num_nodes();
+  uint32_t num_blocks = galois::getActiveThreads();
+  auto block_begin = [&](uint32_t b) { return num_nodes * b / num_blocks; };
+
+  std::vector<uint32_t> parts(num_nodes);
+  // offsets[b * num_partitions + p] is the first new id of the nodes of
+  // partition p in block b
+  std::vector<uint64_t> offsets(uint64_t{num_blocks} * num_partitions);
+  galois::do_all(
+      galois::iterate(uint32_t{0}, num_blocks),
+      [&](uint32_t b) {
+        uint64_t* counts = &offsets[uint64_t{b} * num_partitions];
+        for (uint64_t n = block_begin(b); n < block_begin(b + 1); ++n) {
+          parts[n] = graph.getData(nodes[n], galois::MethodFlag::UNPROTECTED)
+                         .getPart();
+          ++counts[parts[n]];
+        }
+      },
+      galois::no_stats(), galois::loopname("CountPartitions"));
+
+  std::vector<uint64_t> partition_begin(num_partitions + 1);
+  uint64_t next = 0;
+  for (uint32_t p = 0; p < num_partitions; ++p) {
+    partition_begin[p] = next;
+    for (uint32_t b = 0; b < num_blocks; ++b) {
+      uint64_t count = offsets[uint64_t{b} * num_partitions + p];
+      offsets[uint64_t{b} * num_partitions + p] = next;
+      next += count;
+    }
+  }
+  partition_begin[num_partitions] = next;
+
+  std::vector<uint32_t> new_to_old(num_nodes);
+  galois::do_all(
+      galois::iterate(uint32_t{0}, num_blocks),
+      [&](uint32_t b) {
+        uint64_t* cursors = &offsets[uint64_t{b} * num_partitions];
+        for (uint64_t n = block_begin(b); n < block_begin(b + 1); ++n) {
+          new_to_old[cursors[parts[n]]++] = n;
+        }
+      },
+      galois::no_stats(), galois::loopname("OrderByPartition"));
+
+  if (auto res = galois::graphs::PermuteNodes(pfg, new_to_old); !res) {
+    GALOIS_LOG_FATAL("could not relabel nodes: {}", res.error());
+  }
+
+  // the partitions of the new ids are nondecreasing
+  arrow::UInt32Builder builder;
+  if (auto status = builder.Reserve(num_nodes); !status.ok()) {
+    GALOIS_LOG_FATAL("arrow error: {}", status);
+  }
+  for (uint32_t p = 0; p < num_partitions; ++p) {
+    for (uint64_t n = partition_begin[p]; n < partition_begin[p + 1]; ++n) {
+      builder.UnsafeAppend(p);
+    }
+  }
+  std::shared_ptr<arrow::Array> partition_ids;
+  if (auto status = builder.Finish(&partition_ids); !status.ok()) {
+    GALOIS_LOG_FATAL("arrow error: {}", status);
+  }
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(kPartitionProperty, arrow::uint32())}),
+      {partition_ids});
+  if (auto res = pfg->AddNodeProperties(table); !res) {
+    GALOIS_LOG_FATAL("could not add partition property: {}", res.error());
+  }
+  std::vector<std::string> persist(pfg->NodePropertyNames().size());
+  persist.back() = kPartitionProperty;
+  if (auto res = pfg->MarkNodePropertiesPersistent(persist); !res) {
+    GALOIS_LOG_FATAL("could not persist partition property: {}", res.error());
+  }
+
+  if (verbose) {
+    for (uint32_t p = 0; p < num_partitions; ++p) {
+      std::cout << "Partition " << p << ": nodes [" << partition_begin[p]
+                << ", " << partition_begin[p + 1] << ")\n";
+    }
+  }
+
+  if (auto res = pfg->Write(rdg_name, command_line); !res) {
+    GALOIS_LOG_FATAL("could not write {}: {}", rdg_name, res.error());
+  }
+}
+
 int
 main(int argc, char** argv) {
   std::unique_ptr<galois::SharedMemSys> G =
@@ -186,7 +357,14 @@ main(int argc, char** argv) {
   MetisGraph metisGraph;
   GGraph& graph = *metisGraph.getGraph();
 
-  galois::graphs::readGraph(graph, inputFile);
+  std::unique_ptr<galois::graphs::PropertyFileGraph> pfg;
+  GGraph::ReadGraphAuxData pfg_nodes;
+  if (outputRDG != "") {
+    pfg = MakeFileGraph(inputFile, "");
+    ReadPropertyGraph(*pfg, &graph, &pfg_nodes);
+  } else {
+    galois::graphs::readGraph(graph, inputFile);
+  }
 
   galois::do_all(
       galois::iterate(graph),
@@ -213,6 +391,16 @@ main(int argc, char** argv) {
 
   std::cout << "Total edge cut: " << computeCut(graph) << "\n";
 
+  if (outputRDG != "") {
+    std::string command_line;
+    for (int i = 0; i < argc; ++i) {
+      command_line += i ? " " : "";
+      command_line += argv[i];
+    }
+    WritePartitionedRDG(
+        pfg.get(), graph, pfg_nodes, numPartitions, outputRDG, command_line);
+  }
+
   if (outputFilename != "") {
     MetisGraph* coarseGraph = &metisGraph;
     while (coarseGraph->getCoarserGraph())
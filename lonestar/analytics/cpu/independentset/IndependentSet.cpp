@@ -28,10 +28,12 @@
 
 #include "Lonestar/BoilerPlate.h"
 #include "galois/Bag.h"
+#include "galois/EdgeTiles.h"
 #include "galois/Galois.h"
 #include "galois/ParallelSTL.h"
 #include "galois/Reduction.h"
 #include "galois/Timer.h"
+#include "galois/analytics/independent_set/independent_set.h"
 #include "galois/runtime/Profile.h"
 #include "llvm/Support/CommandLine.h"
 
@@ -40,7 +42,7 @@ const char* desc =
     "Computes a maximal independent set (not maximum) of nodes in a graph";
 const char* url = "independent_set";
 
-enum Algo { serial, pull, nondet, detBase, prio, edgetiledprio };
+enum Algo { serial, pull, nondet, detBase, prio, edgetiledprio, packedprio };
 
 namespace cll = llvm::cl;
 static cll::opt<std::string> inputFile(
@@ -59,7 +61,11 @@ static cll::opt<Algo> algo(
             "prio algo based on Martin's GPU ECL-MIS algorithm (default)"),
         clEnumVal(
             edgetiledprio,
-            "edge-tiled prio algo based on Martin's GPU ECL-MIS algorithm")),
+            "edge-tiled prio algo based on Martin's GPU ECL-MIS algorithm"),
+        clEnumVal(
+            packedprio,
+            "library prio rounds over packed 2-bit node states "
+            "(galois::analytics::IndependentSet)")),
     cll::init(prio));
 
 enum MatchFlag : char { KUnMatched, KOtherMatched, Matched };
@@ -463,7 +469,7 @@ struct EdgeTiledPrioAlgo {
     galois::GReduceLogicalOr unmatched;
     galois::substrate::PerThreadStorage<std::mt19937*> generator;
     galois::InsertBag<EdgeTile> works;
-    const int EDGE_TILE_SIZE = 64;
+    constexpr ptrdiff_t kEdgeTileSize = 64;
     galois::do_all(
         galois::iterate(*graph),
         [&](const GNode& src) {
@@ -489,18 +495,12 @@ struct EdgeTiledPrioAlgo {
           uint8_t val = (res + res) | 0x03;
 
           src_flag = val;
-          assert(beg <= end);
-          if ((end - beg) > EDGE_TILE_SIZE) {
-            for (; beg + EDGE_TILE_SIZE < end;) {
-              auto ne = beg + EDGE_TILE_SIZE;
-              assert(ne < end);
-              works.push_back(EdgeTile{src, beg, ne, false});
-              beg = ne;
-            }
-          }
-          if ((end - beg) > 0) {
-            works.push_back(EdgeTile{src, beg, end, false});
-          }
+          galois::ForEachEdgeTile(
+              beg, end, kEdgeTileSize,
+              [&](const Graph::edge_iterator& tile_beg,
+                  const Graph::edge_iterator& tile_end) {
+                works.push_back(EdgeTile{src, tile_beg, tile_end, false});
+              });
         },
         galois::loopname("init-prio"), galois::steal());
 
@@ -723,6 +723,80 @@ run() {
             << "\n";
 }
 
+/**
+ * Runs galois::analytics::IndependentSet, which keeps its own node states, and
+ * checks its output flags: 1 for IN and 0 for OUT.
+ */
+void
+runPackedPrio() {
+  using galois::analytics::IndependentSetNodeFlag;
+  using Graph = galois::graphs::PropertyGraph<
+      std::tuple<IndependentSetNodeFlag>, std::tuple<>>;
+  using GNode = Graph::Node;
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<galois::graphs::PropertyFileGraph> pfg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  std::cout << "Read " << pfg->topology().num_nodes() << " nodes, "
+            << pfg->topology().num_edges() << " edges\n";
+
+  galois::reportPageAlloc("MeminfoPre");
+  galois::StatTimer execTime("Timer_0");
+
+  execTime.start();
+  if (auto r = galois::analytics::IndependentSet(
+          pfg.get(), "in_set",
+          galois::analytics::IndependentSetPlan::Priority());
+      !r) {
+    GALOIS_LOG_FATAL("failed to compute independent set: {}", r.error());
+  }
+  execTime.stop();
+
+  galois::reportPageAlloc("MeminfoPost");
+
+  auto pg_result = Graph::Make(pfg.get(), {"in_set"}, {});
+  if (!pg_result) {
+    GALOIS_LOG_FATAL("could not make property graph: {}", pg_result.error());
+  }
+  Graph graph = pg_result.value();
+
+  auto in_set = [&](const GNode& n) {
+    return graph.GetData<IndependentSetNodeFlag>(n) == 1;
+  };
+
+  auto is_bad = [&](const GNode& n) {
+    bool has_in_neighbor = false;
+    for (auto ii : graph.edges(n)) {
+      auto dest = graph.GetEdgeDest(ii);
+      if (*dest != n && in_set(*dest)) {
+        has_in_neighbor = true;
+      }
+    }
+    if (in_set(n) && has_in_neighbor) {
+      std::cerr << "double match\n";
+      return true;
+    }
+    if (!in_set(n) && !has_in_neighbor) {
+      std::cerr << "not maximal\n";
+      return true;
+    }
+    return false;
+  };
+
+  if (!skipVerify && galois::ParallelSTL::find_if(
+                         graph.begin(), graph.end(), is_bad) != graph.end()) {
+    std::cerr << "verification failed\n";
+    assert(0 && "verification failed");
+    abort();
+  }
+
+  std::cout << "Cardinality of maximal independent set: "
+            << galois::ParallelSTL::count_if(
+                   graph.begin(), graph.end(), in_set)
+            << "\n";
+}
+
 int
 main(int argc, char** argv) {
   std::unique_ptr<galois::SharedMemSys> G =
@@ -771,6 +845,9 @@ main(int argc, char** argv) {
   case edgetiledprio:
     run<EdgeTiledPrioAlgo>();
     break;
+  case packedprio:
+    runPackedPrio();
+    break;
   default:
     std::cerr << "Unknown algorithm" << algo << "\n";
     abort();
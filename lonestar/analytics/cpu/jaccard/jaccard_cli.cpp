@@ -17,12 +17,12 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
-#include <deque>
 #include <iostream>
-#include <type_traits>
-#include <unordered_set>
 
 #include "Lonestar/BoilerPlate.h"
+#include "galois/analytics/jaccard/jaccard.h"
+
+using namespace galois::analytics;
 
 namespace cll = llvm::cl;
 
@@ -43,50 +43,15 @@ static cll::opt<unsigned int> report_node(
     "reportNode",
     cll::desc("Node to report the similarity of (default value 1)"),
     cll::init(1));
+static cll::opt<unsigned int> top_k(
+    "topK",
+    cll::desc("Also find this many nodes most similar to the base node "
+              "(default value 0)"),
+    cll::init(0));
 
-struct NodeValue : public galois::PODProperty<double> {};
-
-using NodeData = std::tuple<NodeValue>;
-using EdgeData = std::tuple<>;
-
-typedef galois::graphs::PropertyGraph<NodeData, EdgeData> Graph;
-typedef typename Graph::Node GNode;
-
-void
-algo(Graph* graph, const GNode& base) {
-  std::unordered_set<GNode> base_neighbors;
-
-  // Collect all the neighbors of the base node into a hash set.
-  for (const auto& e : graph->edges(base)) {
-    auto dest = graph->GetEdgeDest(e);
-    base_neighbors.emplace(*dest);
-  }
-
-  // Compute the similarity for each node
-  galois::do_all(
-      galois::iterate(*graph),
-      [&](const GNode& n2) {
-        double& n2_data = graph->GetData<NodeValue>(n2);
-        uint32_t n2_size = 0, intersection_size = 0;
-        // TODO: Using a sorted edge list would allow a much faster intersection
-        // operation. Use that here.
-        // Count the number of neighbors of n2 and the number that are shared
-        // with base
-        for (const auto& e : graph->edges(n2)) {
-          auto neighbor = graph->GetEdgeDest(e);
-          if (base_neighbors.count(*neighbor) > 0)
-            intersection_size++;
-          n2_size++;
-        }
-        uint32_t union_size =
-            base_neighbors.size() + n2_size - intersection_size;
-        double similarity =
-            union_size > 0 ? (double)intersection_size / union_size : 1;
-        // Store the similarity back into the graph.
-        n2_data = similarity;
-      },
-      galois::steal(), galois::loopname("jaccard"));
-}
+using Graph = galois::graphs::PropertyGraph<
+    std::tuple<JaccardSimilarity>, std::tuple<>>;
+using GNode = Graph::Node;
 
 int
 main(int argc, char** argv) {
@@ -100,47 +65,50 @@ main(int argc, char** argv) {
   std::unique_ptr<galois::graphs::PropertyFileGraph> pfg =
       MakeFileGraph(inputFile, edge_property_name);
 
-  auto result = ConstructNodeProperties<NodeData>(pfg.get());
-  if (!result) {
-    GALOIS_LOG_FATAL("failed to construct node properties: {}", result.error());
-  }
-
-  auto pg_result =
-      galois::graphs::PropertyGraph<NodeData, EdgeData>::Make(pfg.get());
-  if (!pg_result) {
-    GALOIS_LOG_FATAL("could not make property graph: {}", pg_result.error());
-  }
-  Graph graph = pg_result.value();
+  std::cout << "Read " << pfg->topology().num_nodes() << " nodes, "
+            << pfg->topology().num_edges() << " edges\n";
 
-  std::cout << "Read " << graph.num_nodes() << " nodes, " << graph.num_edges()
-            << " edges\n";
-
-  if (base_node >= graph.size() || report_node >= graph.size()) {
+  if (base_node >= pfg->topology().num_nodes() ||
+      report_node >= pfg->topology().num_nodes()) {
     std::cerr << "failed to set report: " << report_node
               << " or failed to set base: " << base_node << "\n";
     abort();
   }
 
-  auto it = graph.begin();
-  std::advance(it, base_node.getValue());
-  GNode base = *it;
-  it = graph.begin();
-  std::advance(it, report_node.getValue());
-  GNode report = *it;
-
   galois::reportPageAlloc("MeminfoPre");
 
-  galois::StatTimer execTime("Timer_0");
-  execTime.start();
-
-  algo(&graph, base);
-
-  execTime.stop();
+  LonestarRun(pfg.get(), {"similarity"}, {}, [&]() {
+    if (auto r = Jaccard(pfg.get(), base_node, "similarity"); !r) {
+      std::cerr << r.error().message() << "\n";
+      abort();
+    }
+  });
 
   galois::reportPageAlloc("MeminfoPost");
 
+  auto pg_result = Graph::Make(pfg.get(), {"similarity"}, {});
+  if (!pg_result) {
+    GALOIS_LOG_FATAL("could not make property graph: {}", pg_result.error());
+  }
+  Graph graph = pg_result.value();
+  GNode base = base_node;
+  GNode report = report_node;
+
   std::cout << "Node " << report_node << " has similarity "
-            << graph.GetData<NodeValue>(report) << "\n";
+            << graph.GetData<JaccardSimilarity>(report) << "\n";
+
+  if (top_k) {
+    auto top_result = TopKSimilarNodes(pfg.get(), {base}, top_k);
+    if (!top_result) {
+      std::cerr << top_result.error().message() << "\n";
+      abort();
+    }
+    const TopKSimilarity& top = top_result.value();
+    for (uint64_t i = top.offsets[0]; i < top.offsets[1]; ++i) {
+      std::cout << "Node " << top.nodes[i] << " has similarity "
+                << top.similarities[i] << "\n";
+    }
+  }
 
   // Sanity checking code
   galois::GReduceMax<double> max_similarity;
@@ -151,8 +119,8 @@ main(int argc, char** argv) {
   galois::do_all(
       galois::iterate(graph),
       [&](const GNode& i) {
-        double similarity = graph.GetData<NodeValue>(i);
-        if ((unsigned int)i != (unsigned int)base) {
+        double similarity = graph.GetData<JaccardSimilarity>(i);
+        if (i != base) {
           max_similarity.update(similarity);
           min_similarity.update(similarity);
         }
@@ -162,12 +130,11 @@ main(int argc, char** argv) {
   galois::gInfo(
       "Maximum similarity (excluding base) is ", max_similarity.reduce());
   galois::gInfo("Minimum similarity is ", min_similarity.reduce());
-  galois::gInfo("Base similarity is ", graph.GetData<NodeValue>(base));
-
-  // TODO: Verify?
+  galois::gInfo(
+      "Base similarity is ", graph.GetData<JaccardSimilarity>(base));
 
   if (!skipVerify) {
-    if (graph.GetData<NodeValue>(base) == 1.0) {
+    if (graph.GetData<JaccardSimilarity>(base) == 1.0) {
       std::cout << "Verification successful.\n";
     } else {
       GALOIS_LOG_FATAL(
@@ -176,6 +143,8 @@ main(int argc, char** argv) {
     }
   }
 
+  LonestarCommit(pfg.get());
+
   totalTime.stop();
 
   return 0;
@@ -0,0 +1,184 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause
+ * BSD License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2019, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include "Lonestar/BoilerPlate.h"
+#include "galois/analytics/k_core/k_core.h"
+
+using namespace galois::analytics;
+
+namespace cll = llvm::cl;
+
+static const char* name = "k-core";
+
+static const char* desc =
+    "Computes the coreness of each node of a graph, the largest k such that "
+    "the node is in the k-core, the subgraph where all vertices have degree "
+    "at least k.";
+
+static const char* url = nullptr;
+
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+
+static cll::opt<KCorePlan::Algorithm> algo(
+    "algo", cll::desc("Choose an algorithm (default Bucketed):"),
+    cll::values(
+        clEnumValN(KCorePlan::kSynchronous, "Sync", "Synchronous"),
+        clEnumValN(KCorePlan::kBucketed, "Bucketed", "Bucketed")),
+    cll::init(KCorePlan::kBucketed));
+
+static cll::opt<uint32_t> k_core_num(
+    "kcore",
+    cll::desc("k-core value; if given, whether each node is in the k-core is "
+              "written instead of its coreness"),
+    cll::init(0));
+
+std::string
+AlgorithmName(KCorePlan::Algorithm algorithm) {
+  switch (algorithm) {
+  case KCorePlan::kSynchronous:
+    return "Synchronous";
+  case KCorePlan::kBucketed:
+    return "Bucketed";
+  default:
+    return "Unknown";
+  }
+}
+
+KCorePlan
+MakePlan() {
+  switch (algo) {
+  case KCorePlan::kSynchronous:
+    return KCorePlan::Synchronous();
+  case KCorePlan::kBucketed:
+  default:
+    return KCorePlan::Bucketed();
+  }
+}
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<galois::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  galois::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  if (!symmetricGraph) {
+    GALOIS_DIE(
+        "This application requires a symmetric graph input;"
+        " please use the -symmetricGraph flag "
+        " to indicate the input is a symmetric graph.");
+  }
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<galois::graphs::PropertyFileGraph> pfg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  std::cout << "Read " << pfg->topology().num_nodes() << " nodes, "
+            << pfg->topology().num_edges() << " edges\n";
+
+  KCorePlan plan = MakePlan();
+
+  std::cout << "Running " << AlgorithmName(plan.algorithm()) << "\n";
+
+  galois::reportPageAlloc("MemAllocPre");
+
+  LonestarRun(pfg.get(), {"coreness"}, {}, [&]() {
+    if (auto r = KCore(pfg.get(), "coreness", plan); !r) {
+      std::cerr << r.error().message() << "\n";
+      abort();
+    }
+  });
+
+  galois::reportPageAlloc("MemAllocPost");
+
+  using Graph = galois::graphs::PropertyGraph<
+      std::tuple<KCoreNodeCoreness>, std::tuple<>>;
+  auto pg_result = Graph::Make(pfg.get(), {"coreness"}, {});
+  if (!pg_result) {
+    std::cerr << pg_result.error().message() << "\n";
+    abort();
+  }
+  Graph graph = pg_result.value();
+
+  uint32_t max_coreness = 0;
+  size_t k_core_size = 0;
+  for (auto node : graph) {
+    uint32_t coreness = graph.GetData<KCoreNodeCoreness>(node);
+    max_coreness = std::max(max_coreness, coreness);
+    k_core_size += coreness >= k_core_num;
+  }
+
+  std::cout << "Largest coreness: " << max_coreness << "\n";
+  if (k_core_num.getNumOccurrences()) {
+    std::cout << "Number of nodes in the " << k_core_num << "-core is "
+              << k_core_size << "\n";
+  }
+
+  if (!skipVerify) {
+    // A node of coreness k has at least k neighbors of coreness at least k
+    galois::GReduceLogicalOr bad;
+    galois::do_all(
+        galois::iterate(graph),
+        [&](uint32_t n) {
+          uint32_t coreness = graph.GetData<KCoreNodeCoreness>(n);
+          uint32_t supporting = 0;
+          for (auto e : graph.edges(n)) {
+            auto dest = graph.GetEdgeDest(e);
+            supporting += graph.GetData<KCoreNodeCoreness>(dest) >= coreness;
+          }
+          if (supporting < coreness) {
+            bad.update(true);
+          }
+        },
+        galois::loopname("Verify"), galois::no_stats());
+
+    if (!bad.reduce()) {
+      std::cout << "Verification successful.\n";
+    } else {
+      GALOIS_DIE("verification failed");
+    }
+  }
+
+  if (output) {
+    std::vector<uint32_t> results;
+    results.reserve(graph.num_nodes());
+    for (auto node : graph) {
+      uint32_t coreness = graph.GetData<KCoreNodeCoreness>(node);
+      if (k_core_num.getNumOccurrences()) {
+        results.push_back(coreness >= k_core_num ? 1 : 0);
+      } else {
+        results.push_back(coreness);
+      }
+    }
+
+    writeOutput(outputLocation, results.data(), results.size());
+  }
+
+  LonestarCommit(pfg.get());
+
+  totalTime.stop();
+
+  return 0;
+}
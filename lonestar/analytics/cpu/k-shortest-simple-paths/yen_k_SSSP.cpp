@@ -17,12 +17,18 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <algorithm>
+#include <functional>
 #include <iostream>
+#include <limits>
 #include <map>
+#include <queue>
+#include <vector>
 
 #include "Lonestar/BoilerPlate.h"
 #include "Lonestar/K_SSSP.h"
 #include "galois/AtomicHelpers.h"
+#include "galois/substrate/PerThreadStorage.h"
 
 namespace cll = llvm::cl;
 
@@ -50,15 +56,20 @@ static cll::opt<unsigned int> numPaths(
               "value 10)"),
     cll::init(10));
 
-enum Algo { deltaTile = 0, deltaStep, deltaStepBarrier };
+enum Algo { deltaTile = 0, deltaStep, deltaStepBarrier, batched };
 
-const char* const ALGO_NAMES[] = {"deltaTile", "deltaStep", "deltaStepBarrier"};
+const char* const ALGO_NAMES[] = {
+    "deltaTile", "deltaStep", "deltaStepBarrier", "batched"};
 
 static cll::opt<Algo> algo(
     "algo", cll::desc("Choose an algorithm:"),
     cll::values(
         clEnumVal(deltaTile, "deltaTile"), clEnumVal(deltaStep, "deltaStep"),
-        clEnumVal(deltaStepBarrier, "deltaStepBarrier")),
+        clEnumVal(deltaStepBarrier, "deltaStepBarrier"),
+        clEnumVal(
+            batched,
+            "Concurrent point-to-point searches for the spur paths of each "
+            "path")),
     cll::init(deltaTile));
 
 struct Path {
@@ -300,6 +311,38 @@ FindShortestPath(
   return path_exists;
 }
 
+//add path to the candidates unless it is one already
+void
+AddCandidate(
+    std::multimap<uint32_t, std::vector<std::pair<GNode, uint32_t>>>*
+        candidates,
+    std::vector<std::pair<GNode, uint32_t>>&& path) {
+  uint32_t wt = (path.rbegin())->second;
+  auto same_wt = candidates->equal_range(wt);
+  for (auto it = same_wt.first; it != same_wt.second; ++it) {
+    if (std::equal(
+            path.begin(), path.end(), it->second.begin(), it->second.end(),
+            [](const auto& a, const auto& b) { return a.first == b.first; })) {
+      return;
+    }
+  }
+  candidates->emplace(wt, std::move(path));
+}
+
+//the weight of the n-th lightest candidate, or infinity if there are fewer
+//candidates; since candidates are distinct, a new candidate heavier than that
+//can never be one of the next n paths picked
+uint64_t
+CandidateBound(
+    const std::multimap<uint32_t, std::vector<std::pair<GNode, uint32_t>>>&
+        candidates,
+    size_t n) {
+  if (n == 0 || candidates.size() < n) {
+    return std::numeric_limits<uint64_t>::max();
+  }
+  return std::next(candidates.begin(), n - 1)->first;
+}
+
 //find the next shortest simple path from source to report node
 bool
 FindNextPath(
@@ -382,7 +425,6 @@ YenKSP(
   k_paths.push_back(shortest_path);
 
   // store candidate paths
-  std::vector<std::vector<std::pair<GNode, uint32_t>>> candidate_paths;
   std::multimap<uint32_t, std::vector<std::pair<GNode, uint32_t>>> candidates;
 
   //find k paths one by one
@@ -428,10 +470,7 @@ YenKSP(
 
       //add this new path to the candidates set
       if (path_exists) {
-        candidate_paths.push_back(cur_path);
-        uint32_t wt = (cur_path.rbegin())->second;
-
-        candidates.insert(std::make_pair(wt, cur_path));
+        AddCandidate(&candidates, std::move(cur_path));
       }
     }
 
@@ -448,6 +487,191 @@ YenKSP(
   }  // end for
 }
 
+//position of the nodes that are not on the path whose spurs are searched
+constexpr static const uint32_t kNotOnPath =
+    std::numeric_limits<uint32_t>::max();
+
+/**
+ * A point-to-point Dijkstra search with distances of its own, so that the
+ * spur searches of a path can run concurrently, one per thread. Only the
+ * nodes reached by a search are reset for the next one.
+ */
+class SpurSearch {
+  using HeapItem = std::pair<Distance, GNode>;
+
+  std::vector<Distance> dist_;
+  std::vector<GNode> parent_;
+  std::vector<GNode> reached_;
+  std::priority_queue<HeapItem, std::vector<HeapItem>, std::greater<HeapItem>>
+      heap_;
+
+  void Reach(GNode n, Distance dist, GNode parent) {
+    if (dist_[n] == SSSP::kDistInfinity) {
+      reached_.push_back(n);
+    }
+    dist_[n] = dist;
+    parent_[n] = parent;
+    heap_.push(std::make_pair(dist, n));
+  }
+
+public:
+  /**
+   * Find a shortest path from the spur node at position spur of a path to
+   * report. The nodes at an earlier position of that path, given by
+   * positions, and the edges from the spur node to forbidden are masked out.
+   * The search gives up on paths weighing more than bound including
+   * prefix_wt, the weight of the path up to the spur node.
+   *
+   * @returns true if a path was found, in which case it is appended to
+   * cur_path from the spur node on
+   */
+  bool Run(
+      Graph* graph, const std::vector<uint32_t>& positions, uint32_t spur,
+      const GNode& source, const GNode& report,
+      const std::vector<GNode>& forbidden, uint32_t prefix_wt, uint64_t bound,
+      std::vector<std::pair<GNode, uint32_t>>* cur_path) {
+    if (dist_.empty()) {
+      dist_.assign(graph->num_nodes(), SSSP::kDistInfinity);
+      parent_.resize(graph->num_nodes());
+    }
+
+    bool path_exists = false;
+    Reach(source, 0, source);
+    while (!heap_.empty()) {
+      auto [dist, n] = heap_.top();
+      heap_.pop();
+      if (dist > dist_[n]) {
+        continue;
+      }
+      if (uint64_t{prefix_wt} + dist > bound) {
+        break;
+      }
+      if (n == report) {
+        path_exists = true;
+        break;
+      }
+
+      for (auto edge : graph->edges(n)) {
+        auto dest = *graph->GetEdgeDest(edge);
+        if (positions[dest] < spur) {
+          continue;
+        }
+        if (n == source && std::find(forbidden.begin(), forbidden.end(),
+                                     dest) != forbidden.end()) {
+          continue;
+        }
+        Distance new_dist = dist + graph->GetEdgeData<EdgeWeight>(edge);
+        if (new_dist < dist_[dest]) {
+          Reach(dest, new_dist, n);
+        }
+      }
+    }
+
+    if (path_exists) {
+      size_t prefix_len = cur_path->size();
+      for (GNode n = report; n != source; n = parent_[n]) {
+        cur_path->push_back(std::make_pair(n, prefix_wt + dist_[n]));
+      }
+      cur_path->push_back(std::make_pair(source, prefix_wt));
+      std::reverse(cur_path->begin() + prefix_len, cur_path->end());
+    }
+
+    for (GNode n : reached_) {
+      dist_[n] = SSSP::kDistInfinity;
+    }
+    reached_.clear();
+    heap_ = decltype(heap_)();
+    return path_exists;
+  }
+};
+
+//find k simple shortest paths from source to report node, searching the spur
+//paths of each path concurrently
+void
+BatchedYenKSP(
+    Graph* graph, const GNode& source, const GNode& report,
+    std::vector<std::vector<std::pair<GNode, uint32_t>>>& k_paths) {
+  galois::substrate::PerThreadStorage<SpurSearch> searches;
+
+  // the position of each node on the last path picked, shared by the spur
+  // searches of that path as their mask of the nodes of their root path
+  std::vector<uint32_t> positions(graph->num_nodes(), kNotOnPath);
+
+  std::vector<std::pair<GNode, uint32_t>> shortest_path;
+  bool path_exists = searches.getLocal()->Run(
+      graph, positions, 0, source, report, {}, 0,
+      std::numeric_limits<uint64_t>::max(), &shortest_path);
+
+  if (!path_exists) {
+    galois::gPrint("no shortest path exists from source to sink \n");
+    return;
+  }
+
+  k_paths.push_back(shortest_path);
+
+  std::multimap<uint32_t, std::vector<std::pair<GNode, uint32_t>>> candidates;
+
+  //find k paths one by one
+  for (uint32_t k = 1; k < numPaths; k++) {
+    const std::vector<std::pair<GNode, uint32_t>>& last = k_paths[k - 1];
+    uint32_t len = last.size();
+    uint32_t num_spurs = len - 1;
+
+    for (uint32_t l = 0; l < len; l++) {
+      positions[last[l].first] = l;
+    }
+
+    // The spur search from the i-th node removes the links that are part of
+    // the previous shortest paths which share the same root path
+    std::vector<std::vector<GNode>> forbidden(num_spurs);
+    for (const auto& path : k_paths) {
+      uint32_t common = 0;
+      while (common < path.size() && common < len &&
+             path[common].first == last[common].first) {
+        common++;
+      }
+      for (uint32_t i = 0; i < std::min(common, num_spurs); i++) {
+        if (i + 1 < path.size()) {
+          forbidden[i].push_back(path[i + 1].first);
+        }
+      }
+    }
+
+    uint64_t bound = CandidateBound(candidates, numPaths - k);
+
+    std::vector<std::vector<std::pair<GNode, uint32_t>>> spur_paths(num_spurs);
+    std::vector<uint8_t> found(num_spurs);
+    galois::do_all(
+        galois::iterate(uint32_t{0}, num_spurs),
+        [&](uint32_t i) {
+          std::vector<std::pair<GNode, uint32_t>>& cur_path = spur_paths[i];
+          cur_path.assign(last.begin(), last.begin() + i);
+          found[i] = searches.getLocal()->Run(
+              graph, positions, i, last[i].first, report, forbidden[i],
+              last[i].second, bound, &cur_path);
+        },
+        galois::steal(), galois::chunk_size<1>(),
+        galois::loopname("SpurSearches"));
+
+    for (uint32_t l = 0; l < len; l++) {
+      positions[last[l].first] = kNotOnPath;
+    }
+
+    for (uint32_t i = 0; i < num_spurs; i++) {
+      if (found[i]) {
+        AddCandidate(&candidates, std::move(spur_paths[i]));
+      }
+    }
+
+    // pick a new path and add it to k
+    bool next_path = FindNextPath(&candidates, &k_paths);
+
+    if (!next_path) {
+      break;
+    }
+  }  // end for
+}
+
 //print k paths
 void
 PrintKPaths(std::vector<std::vector<std::pair<GNode, uint32_t>>>& k_paths) {
@@ -530,7 +754,11 @@ main(int argc, char** argv) {
   execTime.start();
 
   std::vector<std::vector<std::pair<GNode, uint32_t>>> k_paths;
-  YenKSP(&graph, source, report, k_paths);
+  if (algo == batched) {
+    BatchedYenKSP(&graph, source, report, k_paths);
+  } else {
+    YenKSP(&graph, source, report, k_paths);
+  }
 
   execTime.stop();
 
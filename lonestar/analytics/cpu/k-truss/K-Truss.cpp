@@ -24,11 +24,13 @@
 #include <memory>
 
 #include "Lonestar/BoilerPlate.h"
+#include "galois/analytics/k_truss/k_truss.h"
 
 enum Algo {
   bspJacobi,
   bsp,
   bspCoreThenTruss,
+  decomposition,
 };
 
 namespace cll = llvm::cl;
@@ -55,7 +57,10 @@ static cll::opt<Algo> algo(
         clEnumValN(Algo::bsp, "bsp", "Bulk-synchronous parallel (default)"),
         clEnumValN(
             Algo::bspCoreThenTruss, "bspCoreThenTruss",
-            "Compute k-1 core and then k-truss")),
+            "Compute k-1 core and then k-truss"),
+        clEnumValN(
+            Algo::decomposition, "decomposition",
+            "Compute the trussness of every edge and then k-truss")),
     cll::init(Algo::bsp));
 
 using NodeData = std::tuple<>;
@@ -485,6 +490,73 @@ run() {
   galois::gInfo("Number of edges left in truss is ", numEdges);
 }
 
+/**
+ * Compute the trussness of every edge (\see galois::analytics::KTruss), and
+ * report the trussNum-truss, the edges of trussness at least trussNum, like
+ * the other algorithms.
+ */
+void
+runDecomposition() {
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<galois::graphs::PropertyFileGraph> pfg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  std::cout << "Read " << pfg->topology().num_nodes() << " nodes, "
+            << pfg->topology().num_edges() << " edges\n";
+
+  std::cout << "Running decomposition algorithm for all trusses\n";
+
+  galois::reportPageAlloc("MeminfoPre");
+
+  galois::StatTimer execTime("Timer_0");
+  execTime.start();
+  if (auto r = galois::analytics::KTruss(pfg.get(), "trussness"); !r) {
+    GALOIS_LOG_FATAL("failed to compute trussness: {}", r.error());
+  }
+  execTime.stop();
+
+  galois::reportPageAlloc("MeminfoPost");
+
+  using TrussGraph = galois::graphs::PropertyGraph<
+      std::tuple<>, std::tuple<galois::analytics::KTrussEdgeTrussness>>;
+  auto pg_result = TrussGraph::Make(pfg.get(), {}, {"trussness"});
+  if (!pg_result) {
+    GALOIS_LOG_FATAL("could not make property graph: {}", pg_result.error());
+  }
+  TrussGraph graph = pg_result.value();
+
+  std::ofstream of;
+  if (!outName.empty()) {
+    of.open(outName);
+    if (!of.is_open()) {
+      std::cerr << "Cannot open " << outName << " for output.\n";
+    }
+  }
+
+  uint32_t maxTrussness = 0;
+  uint64_t numEdges = 0;
+  for (auto n : graph) {
+    for (auto e : graph.edges(n)) {
+      auto dest = graph.GetEdgeDest(e);
+      uint32_t trussness =
+          graph.GetEdgeData<galois::analytics::KTrussEdgeTrussness>(e);
+      if (n >= *dest) {
+        continue;
+      }
+      maxTrussness = std::max(maxTrussness, trussness);
+      if (trussness >= trussNum) {
+        numEdges++;
+        if (of.is_open()) {
+          of << n << " " << *dest << " " << trussness << "\n";
+        }
+      }
+    }
+  }
+
+  galois::gInfo("Largest trussness is ", maxTrussness);
+  galois::gInfo("Number of edges left in truss is ", numEdges);
+}
+
 int
 main(int argc, char** argv) {
   std::unique_ptr<galois::SharedMemSys> G =
@@ -515,6 +587,9 @@ main(int argc, char** argv) {
   case bspCoreThenTruss:
     run<BSPCoreThenTrussAlgo>();
     break;
+  case decomposition:
+    runDecomposition();
+    break;
   default:
     std::cerr << "Unknown algorithm\n";
     abort();
@@ -22,6 +22,11 @@
 
 #include <cassert>
 #include <string>
+#include <type_traits>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 #include <galois/gstl.h>
 
@@ -118,6 +123,167 @@ static cll::opt<bool> useDetInit(
               "use deterministic values for latent vector"),
     cll::init(false));
 
+// The SGD algorithms spend most of their time in innerProduct and
+// doGradientUpdate on a pair of latent vectors. When the application is built
+// for AVX-512 or AVX2 (e.g., via GALOIS_USE_ARCH), the float versions use
+// explicit vector kernels: LATENT_VECTOR_SIZE is not a multiple of the vector
+// width, and writing the remainder as a masked (AVX-512) or 4-wide (AVX2) step
+// keeps the whole update in registers instead of leaving a scalar tail
+// loop to the auto-vectorizer.
+namespace internal {
+
+#if defined(__AVX512F__)
+
+//! Lanes of the last, partial vector of a latent vector
+constexpr __mmask16 kLatentTailMask =
+    (1U << (LATENT_VECTOR_SIZE % 16)) - 1;
+
+inline float
+innerProductSIMD(
+    const float* __restrict__ first1, const float* __restrict__ first2,
+    float init) {
+  __m512 sum = _mm512_setzero_ps();
+  int i = 0;
+  for (; i + 16 <= LATENT_VECTOR_SIZE; i += 16) {
+    sum = _mm512_fmadd_ps(
+        _mm512_loadu_ps(first1 + i), _mm512_loadu_ps(first2 + i), sum);
+  }
+  if (LATENT_VECTOR_SIZE % 16) {
+    sum = _mm512_fmadd_ps(
+        _mm512_maskz_loadu_ps(kLatentTailMask, first1 + i),
+        _mm512_maskz_loadu_ps(kLatentTailMask, first2 + i), sum);
+  }
+  return init + _mm512_reduce_add_ps(sum);
+}
+
+inline void
+gradientStepSIMD(
+    float* __restrict__ itemLatent, float* __restrict__ userLatent,
+    float error, float l, float step) {
+  const __m512 e = _mm512_set1_ps(error);
+  const __m512 r = _mm512_set1_ps(l);
+  const __m512 s = _mm512_set1_ps(step);
+  auto update = [&](__m512 prevItem, __m512 prevUser, __m512* item,
+                    __m512* user) {
+    // prev - step * (error * other + lambda * prev)
+    *item = _mm512_fnmadd_ps(
+        s, _mm512_fmadd_ps(e, prevUser, _mm512_mul_ps(r, prevItem)),
+        prevItem);
+    *user = _mm512_fnmadd_ps(
+        s, _mm512_fmadd_ps(e, prevItem, _mm512_mul_ps(r, prevUser)),
+        prevUser);
+  };
+  int i = 0;
+  for (; i + 16 <= LATENT_VECTOR_SIZE; i += 16) {
+    __m512 item, user;
+    update(
+        _mm512_loadu_ps(itemLatent + i), _mm512_loadu_ps(userLatent + i),
+        &item, &user);
+    _mm512_storeu_ps(itemLatent + i, item);
+    _mm512_storeu_ps(userLatent + i, user);
+  }
+  if (LATENT_VECTOR_SIZE % 16) {
+    __m512 item, user;
+    update(
+        _mm512_maskz_loadu_ps(kLatentTailMask, itemLatent + i),
+        _mm512_maskz_loadu_ps(kLatentTailMask, userLatent + i), &item, &user);
+    _mm512_mask_storeu_ps(itemLatent + i, kLatentTailMask, item);
+    _mm512_mask_storeu_ps(userLatent + i, kLatentTailMask, user);
+  }
+}
+
+#elif defined(__AVX2__)
+
+inline float
+innerProductSIMD(
+    const float* __restrict__ first1, const float* __restrict__ first2,
+    float init) {
+  __m256 sum = _mm256_setzero_ps();
+  int i = 0;
+  for (; i + 8 <= LATENT_VECTOR_SIZE; i += 8) {
+    __m256 product =
+        _mm256_mul_ps(_mm256_loadu_ps(first1 + i), _mm256_loadu_ps(first2 + i));
+    sum = _mm256_add_ps(sum, product);
+  }
+  __m128 half = _mm_add_ps(
+      _mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+  for (; i + 4 <= LATENT_VECTOR_SIZE; i += 4) {
+    half = _mm_add_ps(
+        half, _mm_mul_ps(_mm_loadu_ps(first1 + i), _mm_loadu_ps(first2 + i)));
+  }
+  half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+  half = _mm_add_ss(half, _mm_movehdup_ps(half));
+  init += _mm_cvtss_f32(half);
+  if (LATENT_VECTOR_SIZE % 4) {
+    for (; i < LATENT_VECTOR_SIZE; ++i) {
+      init += first1[i] * first2[i];
+    }
+  }
+  return init;
+}
+
+inline void
+gradientStepSIMD(
+    float* __restrict__ itemLatent, float* __restrict__ userLatent,
+    float error, float l, float step) {
+  int i = 0;
+  {
+    const __m256 e = _mm256_set1_ps(error);
+    const __m256 r = _mm256_set1_ps(l);
+    const __m256 s = _mm256_set1_ps(step);
+    for (; i + 8 <= LATENT_VECTOR_SIZE; i += 8) {
+      __m256 prevItem = _mm256_loadu_ps(itemLatent + i);
+      __m256 prevUser = _mm256_loadu_ps(userLatent + i);
+      __m256 gradItem = _mm256_add_ps(
+          _mm256_mul_ps(e, prevUser), _mm256_mul_ps(r, prevItem));
+      __m256 gradUser = _mm256_add_ps(
+          _mm256_mul_ps(e, prevItem), _mm256_mul_ps(r, prevUser));
+      _mm256_storeu_ps(
+          itemLatent + i, _mm256_sub_ps(prevItem, _mm256_mul_ps(s, gradItem)));
+      _mm256_storeu_ps(
+          userLatent + i, _mm256_sub_ps(prevUser, _mm256_mul_ps(s, gradUser)));
+    }
+  }
+  {
+    const __m128 e = _mm_set1_ps(error);
+    const __m128 r = _mm_set1_ps(l);
+    const __m128 s = _mm_set1_ps(step);
+    for (; i + 4 <= LATENT_VECTOR_SIZE; i += 4) {
+      __m128 prevItem = _mm_loadu_ps(itemLatent + i);
+      __m128 prevUser = _mm_loadu_ps(userLatent + i);
+      __m128 gradItem =
+          _mm_add_ps(_mm_mul_ps(e, prevUser), _mm_mul_ps(r, prevItem));
+      __m128 gradUser =
+          _mm_add_ps(_mm_mul_ps(e, prevItem), _mm_mul_ps(r, prevUser));
+      _mm_storeu_ps(
+          itemLatent + i, _mm_sub_ps(prevItem, _mm_mul_ps(s, gradItem)));
+      _mm_storeu_ps(
+          userLatent + i, _mm_sub_ps(prevUser, _mm_mul_ps(s, gradUser)));
+    }
+  }
+  if (LATENT_VECTOR_SIZE % 4) {
+    for (; i < LATENT_VECTOR_SIZE; ++i) {
+      float prevItem = itemLatent[i];
+      float prevUser = userLatent[i];
+      itemLatent[i] -= step * (error * prevUser + l * prevItem);
+      userLatent[i] -= step * (error * prevItem + l * prevUser);
+    }
+  }
+}
+
+#endif
+
+//! True if innerProduct and doGradientUpdate have vector kernels for T
+template <typename T>
+constexpr bool kHasSIMDKernels =
+#if defined(__AVX512F__) || defined(__AVX2__)
+    std::is_same_v<T, float>;
+#else
+    false;
+#endif
+
+}  // namespace internal
+
 /**
  * Inner product of 2 vectors.
  *
@@ -139,10 +305,14 @@ innerProduct(
     T* __restrict__ first1, [[maybe_unused]] T* __restrict__ last1,
     T* __restrict__ first2, T init) {
   assert(first1 + LATENT_VECTOR_SIZE == last1);
-  for (int i = 0; i < LATENT_VECTOR_SIZE; ++i) {
-    init += first1[i] * first2[i];
+  if constexpr (internal::kHasSIMDKernels<T>) {
+    return internal::innerProductSIMD(first1, first2, init);
+  } else {
+    for (int i = 0; i < LATENT_VECTOR_SIZE; ++i) {
+      init += first1[i] * first2[i];
+    }
+    return init;
   }
-  return init;
 }
 
 template <typename T>
@@ -182,11 +352,15 @@ doGradientUpdate(
       itemLatent, itemLatent + LATENT_VECTOR_SIZE, userLatent, -rating);
 
   // Take gradient step to reduce error
-  for (int i = 0; i < LATENT_VECTOR_SIZE; i++) {
-    T prevItem = itemLatent[i];
-    T prevUser = userLatent[i];
-    itemLatent[i] -= step * (error * prevUser + l * prevItem);
-    userLatent[i] -= step * (error * prevItem + l * prevUser);
+  if constexpr (internal::kHasSIMDKernels<T>) {
+    internal::gradientStepSIMD(itemLatent, userLatent, error, l, step);
+  } else {
+    for (int i = 0; i < LATENT_VECTOR_SIZE; i++) {
+      T prevItem = itemLatent[i];
+      T prevUser = userLatent[i];
+      itemLatent[i] -= step * (error * prevUser + l * prevItem);
+      userLatent[i] -= step * (error * prevItem + l * prevUser);
+    }
   }
 
   return error;
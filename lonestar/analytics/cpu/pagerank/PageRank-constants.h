@@ -22,6 +22,8 @@
 
 #include <iostream>
 
+#include "galois/VectorReduction.h"
+
 #define DEBUG 0
 
 static const char* name = "Page Rank";
@@ -81,30 +83,20 @@ void
 printTop(Graph* graph, unsigned topn = PRINT_TOP) {
   using GNode = typename Graph::Node;
   typedef TopPair<GNode> Pair;
-  typedef std::map<Pair, GNode> TopMap;
-
-  TopMap top;
-
-  for (auto ii = graph->begin(), ei = graph->end(); ii != ei; ++ii) {
-    GNode src = *ii;
-    PRTy value = graph->template GetData<NodeValue>(ii);
-    Pair key(value, src);
 
-    if (top.size() < topn) {
-      top.insert(std::make_pair(key, src));
-      continue;
-    }
-
-    if (top.begin()->first < key) {
-      top.erase(top.begin());
-      top.insert(std::make_pair(key, src));
-    }
-  }
+  galois::GTopK<Pair> top(topn);
+  galois::do_all(
+      galois::iterate(*graph),
+      [&](const GNode& src) {
+        top.update(Pair(graph->template GetData<NodeValue>(src), src));
+      },
+      galois::no_stats());
 
   int rank = 1;
   std::cout << "Rank PageRank Id\n";
-  for (auto ii = top.rbegin(), ei = top.rend(); ii != ei; ++ii, ++rank) {
-    std::cout << rank << ": " << ii->first.value << " " << ii->first.id << "\n";
+  for (const Pair& p : top.reduce()) {
+    std::cout << rank << ": " << p.value << " " << p.id << "\n";
+    ++rank;
   }
 }
 
@@ -0,0 +1,182 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include <iostream>
+
+#include "Lonestar/BoilerPlate.h"
+#include "galois/analytics/pagerank/pagerank.h"
+
+using namespace galois::analytics;
+
+namespace cll = llvm::cl;
+
+static const char* name = "Page Rank";
+
+static const char* desc =
+    "Computes page ranks a la Page and Brin with the analytics library";
+
+static const char* url = nullptr;
+
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+static cll::opt<float> tolerance(
+    "tolerance", cll::desc("tolerance"),
+    cll::init(PagerankPlan::kDefaultTolerance));
+static cll::opt<unsigned int> maxIterations(
+    "maxIterations",
+    cll::desc("Maximum iterations, applies round-based versions only"),
+    cll::init(PagerankPlan::kDefaultMaxIterations));
+static cll::opt<unsigned int> reportNode(
+    "reportNode", cll::desc("Node to report rank of (default value 0)"),
+    cll::init(0));
+
+static cll::opt<PagerankPlan::Algorithm> algo(
+    "algo", cll::desc("Choose an algorithm (default value PushAsynchronous):"),
+    cll::values(
+        clEnumVal(PagerankPlan::kPullTopological, "PullTopological"),
+        clEnumVal(PagerankPlan::kPullResidual, "PullResidual"),
+        clEnumVal(PagerankPlan::kPushAsynchronous, "PushAsynchronous"),
+        clEnumVal(PagerankPlan::kPushSynchronous, "PushSynchronous"),
+        clEnumVal(PagerankPlan::kPropagationBlocking, "PropagationBlocking")),
+    cll::init(PagerankPlan::kPushAsynchronous));
+
+static cll::opt<uint32_t> binShift(
+    "binShift",
+    cll::desc("log2 of the number of destinations per bin of "
+              "PropagationBlocking (default value 16)"),
+    cll::init(PagerankPlan::kDefaultBinShift));
+
+std::string
+AlgorithmName(PagerankPlan::Algorithm algorithm) {
+  switch (algorithm) {
+  case PagerankPlan::kPullTopological:
+    return "PullTopological";
+  case PagerankPlan::kPullResidual:
+    return "PullResidual";
+  case PagerankPlan::kPushAsynchronous:
+    return "PushAsynchronous";
+  case PagerankPlan::kPushSynchronous:
+    return "PushSynchronous";
+  case PagerankPlan::kPropagationBlocking:
+    return "PropagationBlocking";
+  default:
+    return "Unknown";
+  }
+}
+
+PagerankPlan
+MakePlan() {
+  switch (algo) {
+  case PagerankPlan::kPullTopological:
+    return PagerankPlan::PullTopological(tolerance, maxIterations);
+  case PagerankPlan::kPullResidual:
+    return PagerankPlan::PullResidual(tolerance, maxIterations);
+  case PagerankPlan::kPushSynchronous:
+    return PagerankPlan::PushSynchronous(tolerance, maxIterations);
+  case PagerankPlan::kPropagationBlocking:
+    return PagerankPlan::PropagationBlocking(
+        tolerance, maxIterations, PagerankPlan::kDefaultAlpha, binShift);
+  case PagerankPlan::kPushAsynchronous:
+  default:
+    return PagerankPlan::PushAsynchronous(tolerance);
+  }
+}
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<galois::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  galois::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<galois::graphs::PropertyFileGraph> pfg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  std::cout << "Read " << pfg->topology().num_nodes() << " nodes, "
+            << pfg->topology().num_edges() << " edges\n";
+
+  if (reportNode >= pfg->topology().num_nodes()) {
+    std::cerr << "failed to set report: " << reportNode << "\n";
+    abort();
+  }
+
+  std::cout << "Running " << AlgorithmName(algo)
+            << ", tolerance:" << tolerance
+            << ", maxIterations:" << maxIterations << "\n";
+
+  galois::reportPageAlloc("MeminfoPre");
+
+  LonestarRun(pfg.get(), {"rank"}, {}, [&]() {
+    if (auto r = Pagerank(pfg.get(), "rank", MakePlan()); !r) {
+      std::cerr << r.error().message() << "\n";
+      abort();
+    }
+  });
+
+  using Graph = galois::graphs::PropertyGraph<
+      std::tuple<PagerankNodeValue>, std::tuple<>>;
+  auto pg_result = Graph::Make(pfg.get(), {"rank"}, {});
+  if (!pg_result) {
+    std::cerr << pg_result.error().message() << "\n";
+    abort();
+  }
+  Graph graph = pg_result.value();
+
+  galois::reportPageAlloc("MeminfoPost");
+
+  std::cout << "Node " << reportNode << " has rank "
+            << graph.GetData<PagerankNodeValue>(reportNode) << "\n";
+
+  // Sanity checking code
+  galois::GReduceMax<float> max_rank;
+  galois::GReduceMin<float> min_rank;
+  galois::GAccumulator<float> sum_rank;
+
+  galois::do_all(
+      galois::iterate(graph),
+      [&](uint32_t i) {
+        float rank = graph.GetData<PagerankNodeValue>(i);
+        max_rank.update(rank);
+        min_rank.update(rank);
+        sum_rank += rank;
+      },
+      galois::loopname("Sanity check"), galois::no_stats());
+
+  galois::gInfo("Max rank is ", max_rank.reduce());
+  galois::gInfo("Min rank is ", min_rank.reduce());
+  galois::gInfo("Sum is ", sum_rank.reduce());
+
+  if (output) {
+    std::vector<float> results;
+    results.reserve(graph.num_nodes());
+    for (auto node : graph) {
+      results.push_back(graph.GetData<PagerankNodeValue>(node));
+    }
+
+    writeOutput(outputLocation, results.data(), results.size());
+  }
+
+  LonestarCommit(pfg.get());
+
+  totalTime.stop();
+
+  return 0;
+}
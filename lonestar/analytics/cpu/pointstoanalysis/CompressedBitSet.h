@@ -0,0 +1,478 @@
+#ifndef _GALOIS_COMPRESSEDBITSET_
+#define _GALOIS_COMPRESSEDBITSET_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#include <boost/iterator/iterator_facade.hpp>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace galois {
+
+/**
+ * Immutable set of unsigned ints compressed in the manner of Roaring bitmaps
+ * (Chambi et al., SPE '16; Lemire et al., SPE '18 for run containers).
+ *
+ * The values are split by their high 16 bits into containers of the low 16
+ * bits. A container is a sorted array of up to kArrayMax values, a bitmap of
+ * all 2^16 values, or a sorted list of runs of consecutive values, whichever
+ * is smallest. The choice only depends on the contents of the container, so
+ * equal sets have equal representations, and hash() and operator== can be
+ * used to intern sets (\see CompressedBitSetPool).
+ *
+ * Unions of bitmaps are word-wise ors, 256 bits at a time with AVX2.
+ */
+class CompressedBitSet {
+public:
+  //! Containers with more values than this are not arrays
+  static constexpr uint32_t kArrayMax = 4096;
+  //! Number of 64-bit words of a bitmap container
+  static constexpr uint32_t kBitmapWords = (1U << 16) / 64;
+
+  enum class Kind : uint8_t { kArray, kBitmap, kRun };
+
+  /**
+   * The values of the set whose high 16 bits are key.
+   */
+  struct Container {
+    uint16_t key{0};
+    Kind kind{Kind::kArray};
+    uint32_t cardinality{0};
+    //! kArray: the sorted values; kRun: a (start, length - 1) pair for each
+    //! run, sorted and separated by at least one missing value
+    std::vector<uint16_t> values;
+    //! kBitmap: kBitmapWords words
+    std::vector<uint64_t> words;
+
+    bool test(uint16_t low) const {
+      switch (kind) {
+      case Kind::kArray:
+        return std::binary_search(values.begin(), values.end(), low);
+      case Kind::kBitmap:
+        return (words[low / 64] >> (low % 64)) & 1;
+      case Kind::kRun: {
+        // find the last run starting at or before low
+        size_t lo = 0;
+        size_t hi = values.size() / 2;
+        while (lo < hi) {
+          size_t mid = (lo + hi) / 2;
+          if (values[2 * mid] <= low) {
+            lo = mid + 1;
+          } else {
+            hi = mid;
+          }
+        }
+        return lo > 0 &&
+               low - values[2 * (lo - 1)] <= values[2 * (lo - 1) + 1];
+      }
+      }
+      return false;
+    }
+
+    bool operator==(const Container& other) const {
+      return key == other.key && kind == other.kind &&
+             cardinality == other.cardinality && values == other.values &&
+             words == other.words;
+    }
+  };
+
+  /**
+   * Iterator over the values of a set in increasing order.
+   */
+  class Iterator
+      : public boost::iterator_facade<
+            Iterator, const unsigned, boost::forward_traversal_tag> {
+    //! nullptr for the end
+    const std::vector<Container>* containers{nullptr};
+    size_t index{0};
+    //! array: index of the value; run: index of the run; bitmap: the value
+    uint32_t position{0};
+    //! run: offset of the value into its run
+    uint32_t offset{0};
+    unsigned value{0};
+
+    /**
+     * Moves to the first value at or after the current position, going on
+     * to later containers as needed.
+     */
+    void settle() {
+      while (index < containers->size()) {
+        const Container& c = (*containers)[index];
+        uint32_t low = 1U << 16;
+        switch (c.kind) {
+        case Kind::kArray:
+          if (position < c.values.size()) {
+            low = c.values[position];
+          }
+          break;
+        case Kind::kBitmap:
+          low = nextBit(c.words.data(), position, true);
+          position = low;
+          break;
+        case Kind::kRun:
+          if (2 * position < c.values.size()) {
+            low = c.values[2 * position] + offset;
+          }
+          break;
+        }
+        if (low < (1U << 16)) {
+          value = (unsigned{c.key} << 16) | low;
+          return;
+        }
+        ++index;
+        position = 0;
+        offset = 0;
+      }
+      containers = nullptr;
+    }
+
+    friend class boost::iterator_core_access;
+
+    void increment() {
+      const Container& c = (*containers)[index];
+      if (c.kind == Kind::kRun && offset < c.values[2 * position + 1]) {
+        ++offset;
+      } else {
+        ++position;
+        offset = 0;
+      }
+      settle();
+    }
+
+    bool equal(const Iterator& other) const {
+      return containers == other.containers &&
+             (containers == nullptr ||
+              (index == other.index && value == other.value));
+    }
+
+    const unsigned& dereference() const { return value; }
+
+  public:
+    //! The end iterator
+    Iterator() = default;
+
+    explicit Iterator(const std::vector<Container>* c) : containers(c) {
+      settle();
+    }
+  };
+
+private:
+  std::vector<Container> containers;  // sorted by key
+  uint32_t cardinality{0};
+  size_t hashValue{0};
+
+  static void hashCombine(size_t* h, size_t v) {
+    *h ^= v + 0x9e3779b97f4a7c15ULL + (*h << 6) + (*h >> 2);
+  }
+
+  /**
+   * @returns the first value at or after from that is set (or unset if set
+   * is false) in the bitmap words, or 2^16 if there is none
+   */
+  static uint32_t nextBit(const uint64_t* words, uint32_t from, bool set) {
+    uint32_t i = from / 64;
+    if (i >= kBitmapWords) {
+      return 1U << 16;
+    }
+    uint64_t w = (set ? words[i] : ~words[i]) & (~uint64_t{0} << (from % 64));
+    while (w == 0) {
+      if (++i == kBitmapWords) {
+        return 1U << 16;
+      }
+      w = set ? words[i] : ~words[i];
+    }
+    return i * 64 + __builtin_ctzll(w);
+  }
+
+  //! Sets the bits of the values of c in words
+  static void addTo(const Container& c, uint64_t* words) {
+    switch (c.kind) {
+    case Kind::kArray:
+      for (uint16_t v : c.values) {
+        words[v / 64] |= uint64_t{1} << (v % 64);
+      }
+      break;
+    case Kind::kBitmap:
+      orWords(words, c.words.data());
+      break;
+    case Kind::kRun:
+      for (size_t r = 0; r < c.values.size(); r += 2) {
+        uint32_t first = c.values[r];
+        uint32_t last = first + c.values[r + 1];
+        for (uint32_t v = first; v <= last;) {
+          // set the bits from v up to last or the end of the word of v
+          uint32_t end = std::min(last, v | 63);
+          uint32_t width = end - v + 1;
+          uint64_t bits =
+              width == 64 ? ~uint64_t{0} : (uint64_t{1} << width) - 1;
+          words[v / 64] |= bits << (v % 64);
+          v = end + 1;
+        }
+      }
+      break;
+    }
+  }
+
+  static void orWords(uint64_t* out, const uint64_t* in) {
+#if defined(__AVX2__)
+    for (uint32_t i = 0; i < kBitmapWords; i += 4) {
+      __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(out + i));
+      __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+      _mm256_storeu_si256(
+          reinterpret_cast<__m256i*>(out + i), _mm256_or_si256(a, b));
+    }
+#else
+    for (uint32_t i = 0; i < kBitmapWords; ++i) {
+      out[i] |= in[i];
+    }
+#endif
+  }
+
+  /**
+   * @returns the smallest kind for a container of cardinality values in
+   * runs runs; ties go to arrays, then bitmaps
+   */
+  static Kind chooseKind(uint32_t cardinality, uint32_t runs) {
+    size_t arrayBytes = cardinality <= kArrayMax ? 2 * cardinality : SIZE_MAX;
+    size_t bitmapBytes = kBitmapWords * sizeof(uint64_t);
+    size_t runBytes = 2 + 4 * size_t{runs};
+    if (runBytes < std::min(arrayBytes, bitmapBytes)) {
+      return Kind::kRun;
+    }
+    return cardinality <= kArrayMax ? Kind::kArray : Kind::kBitmap;
+  }
+
+  //! @returns the container of the bits set in words
+  static Container fromBitmap(uint16_t key, std::vector<uint64_t>&& words) {
+    Container c;
+    c.key = key;
+    uint32_t runs = 0;
+    uint64_t carry = 0;
+    for (uint64_t w : words) {
+      c.cardinality += __builtin_popcountll(w);
+      // a run starts at every set bit whose predecessor is not set
+      runs += __builtin_popcountll(w & ~((w << 1) | carry));
+      carry = w >> 63;
+    }
+    c.kind = chooseKind(c.cardinality, runs);
+
+    switch (c.kind) {
+    case Kind::kArray:
+      c.values.reserve(c.cardinality);
+      for (uint32_t i = 0; i < kBitmapWords; ++i) {
+        for (uint64_t w = words[i]; w != 0; w &= w - 1) {
+          c.values.push_back(i * 64 + __builtin_ctzll(w));
+        }
+      }
+      break;
+    case Kind::kBitmap:
+      c.words = std::move(words);
+      break;
+    case Kind::kRun:
+      c.values.reserve(2 * runs);
+      for (uint32_t first = nextBit(words.data(), 0, true); first < (1U << 16);
+           first = nextBit(words.data(), first, true)) {
+        uint32_t end = nextBit(words.data(), first, false);
+        c.values.push_back(first);
+        c.values.push_back(end - 1 - first);
+        first = end;
+      }
+      break;
+    }
+    return c;
+  }
+
+  //! @returns the container of the sorted distinct values
+  static Container fromArray(uint16_t key, std::vector<uint16_t>&& values) {
+    if (values.size() > kArrayMax) {
+      std::vector<uint64_t> words(kBitmapWords, 0);
+      for (uint16_t v : values) {
+        words[v / 64] |= uint64_t{1} << (v % 64);
+      }
+      return fromBitmap(key, std::move(words));
+    }
+
+    Container c;
+    c.key = key;
+    c.cardinality = values.size();
+    uint32_t runs = 0;
+    for (size_t i = 0; i < values.size(); ++i) {
+      runs += i == 0 || values[i] != values[i - 1] + 1;
+    }
+    c.kind = chooseKind(c.cardinality, runs);
+    if (c.kind == Kind::kArray) {
+      c.values = std::move(values);
+      return c;
+    }
+    c.values.reserve(2 * runs);
+    for (size_t i = 0; i < values.size(); ++i) {
+      if (i == 0 || values[i] != values[i - 1] + 1) {
+        c.values.push_back(values[i]);
+        c.values.push_back(0);
+      } else {
+        ++c.values.back();
+      }
+    }
+    return c;
+  }
+
+  static Container unite(const Container& a, const Container& b) {
+    if (a.kind == Kind::kArray && b.kind == Kind::kArray) {
+      std::vector<uint16_t> values;
+      values.reserve(a.values.size() + b.values.size());
+      std::set_union(
+          a.values.begin(), a.values.end(), b.values.begin(), b.values.end(),
+          std::back_inserter(values));
+      return fromArray(a.key, std::move(values));
+    }
+
+    std::vector<uint64_t> words;
+    if (a.kind == Kind::kBitmap) {
+      words = a.words;
+    } else {
+      words.assign(kBitmapWords, 0);
+      addTo(a, words.data());
+    }
+    addTo(b, words.data());
+    return fromBitmap(a.key, std::move(words));
+  }
+
+  static bool isSubsetEq(const Container& a, const Container& b) {
+    if (a.cardinality > b.cardinality) {
+      return false;
+    }
+    if (a.kind == Kind::kArray && b.kind == Kind::kArray) {
+      return std::includes(
+          b.values.begin(), b.values.end(), a.values.begin(), a.values.end());
+    }
+    if (a.kind == Kind::kArray && b.kind == Kind::kBitmap) {
+      return std::all_of(a.values.begin(), a.values.end(), [&](uint16_t v) {
+        return b.test(v);
+      });
+    }
+
+    std::vector<uint64_t> aBuffer;
+    std::vector<uint64_t> bBuffer;
+    const uint64_t* aWords = a.words.data();
+    const uint64_t* bWords = b.words.data();
+    if (a.kind != Kind::kBitmap) {
+      aBuffer.assign(kBitmapWords, 0);
+      addTo(a, aBuffer.data());
+      aWords = aBuffer.data();
+    }
+    if (b.kind != Kind::kBitmap) {
+      bBuffer.assign(kBitmapWords, 0);
+      addTo(b, bBuffer.data());
+      bWords = bBuffer.data();
+    }
+    for (uint32_t i = 0; i < kBitmapWords; ++i) {
+      if ((aWords[i] & ~bWords[i]) != 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  //! Computes the cardinality and hash of the set from its containers
+  void finish() {
+    cardinality = 0;
+    hashValue = containers.size();
+    for (const Container& c : containers) {
+      cardinality += c.cardinality;
+      hashCombine(&hashValue, c.key);
+      hashCombine(&hashValue, static_cast<size_t>(c.kind));
+      for (uint16_t v : c.values) {
+        hashCombine(&hashValue, v);
+      }
+      for (uint64_t w : c.words) {
+        hashCombine(&hashValue, w);
+      }
+    }
+  }
+
+public:
+  //! The empty set
+  CompressedBitSet() = default;
+
+  //! @returns the set of just num
+  static CompressedBitSet singleton(unsigned num) {
+    CompressedBitSet s;
+    Container c;
+    c.key = num >> 16;
+    c.cardinality = 1;
+    c.values.push_back(num & 0xffff);
+    s.containers.emplace_back(std::move(c));
+    s.finish();
+    return s;
+  }
+
+  //! @returns the union of a and b
+  static CompressedBitSet unite(
+      const CompressedBitSet& a, const CompressedBitSet& b) {
+    CompressedBitSet s;
+    s.containers.reserve(a.containers.size() + b.containers.size());
+    auto ia = a.containers.begin();
+    auto ib = b.containers.begin();
+    while (ia != a.containers.end() || ib != b.containers.end()) {
+      if (ib == b.containers.end() ||
+          (ia != a.containers.end() && ia->key < ib->key)) {
+        s.containers.push_back(*ia++);
+      } else if (ia == a.containers.end() || ib->key < ia->key) {
+        s.containers.push_back(*ib++);
+      } else {
+        s.containers.emplace_back(unite(*ia++, *ib++));
+      }
+    }
+    s.finish();
+    return s;
+  }
+
+  bool test(unsigned num) const {
+    uint16_t key = num >> 16;
+    auto it = std::lower_bound(
+        containers.begin(), containers.end(), key,
+        [](const Container& c, uint16_t k) { return c.key < k; });
+    return it != containers.end() && it->key == key && it->test(num & 0xffff);
+  }
+
+  //! @returns true if every value of this set is in second
+  bool isSubsetEq(const CompressedBitSet& second) const {
+    if (cardinality > second.cardinality) {
+      return false;
+    }
+    auto ib = second.containers.begin();
+    for (const Container& c : containers) {
+      while (ib != second.containers.end() && ib->key < c.key) {
+        ++ib;
+      }
+      if (ib == second.containers.end() || ib->key != c.key ||
+          !isSubsetEq(c, *ib)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  unsigned count() const { return cardinality; }
+
+  size_t hash() const { return hashValue; }
+
+  bool operator==(const CompressedBitSet& other) const {
+    return hashValue == other.hashValue && cardinality == other.cardinality &&
+           containers == other.containers;
+  }
+
+  Iterator begin() const { return Iterator(&containers); }
+
+  Iterator end() const { return Iterator(); }
+};
+
+}  // namespace galois
+
+#endif
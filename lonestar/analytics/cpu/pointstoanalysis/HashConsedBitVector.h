@@ -0,0 +1,313 @@
+#ifndef _GALOIS_HASHCONSEDBITVECTOR_
+#define _GALOIS_HASHCONSEDBITVECTOR_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <galois/AtomicWrapper.h>
+#include <galois/substrate/CacheLineStorage.h>
+#include <galois/substrate/SimpleLock.h>
+
+#include "CompressedBitSet.h"
+
+namespace galois {
+
+/**
+ * Hash-consing of CompressedBitSets: every distinct set is stored once, and
+ * sets are passed around as pointers to their single copy (Barbar and Sui,
+ * Hash Consed Points-To Sets, SAS '21). Points-to sets of large programs are
+ * mostly duplicates of a few distinct sets, so this saves most of their
+ * memory, equal sets compare in constant time, and unions are memoized by
+ * the pointers of their operands.
+ *
+ * Sets live until the pool is destroyed. The pool is sharded by hash, and
+ * each shard has a lock, so it can be used concurrently.
+ */
+class CompressedBitSetPool {
+  static constexpr size_t kNumShards = 64;
+
+  using SetPair = std::pair<const CompressedBitSet*, const CompressedBitSet*>;
+
+  struct SetHash {
+    size_t operator()(const CompressedBitSet* s) const { return s->hash(); }
+  };
+  struct SetEqual {
+    bool operator()(
+        const CompressedBitSet* a, const CompressedBitSet* b) const {
+      return *a == *b;
+    }
+  };
+  struct PairHash {
+    size_t operator()(const SetPair& p) const {
+      return std::hash<const void*>()(p.first) * 31 +
+             std::hash<const void*>()(p.second);
+    }
+  };
+
+  struct Shard {
+    galois::substrate::SimpleLock lock;
+    std::unordered_set<const CompressedBitSet*, SetHash, SetEqual> sets;
+    std::unordered_map<SetPair, const CompressedBitSet*, PairHash> unions;
+  };
+
+  std::array<galois::substrate::CacheLineStorage<Shard>, kNumShards> shards;
+
+  Shard& shardOf(size_t hash) { return shards[hash % kNumShards].data; }
+
+public:
+  CompressedBitSetPool() = default;
+  CompressedBitSetPool(const CompressedBitSetPool&) = delete;
+  CompressedBitSetPool& operator=(const CompressedBitSetPool&) = delete;
+
+  ~CompressedBitSetPool() {
+    for (auto& shard : shards) {
+      for (const CompressedBitSet* s : shard.data.sets) {
+        delete s;
+      }
+    }
+  }
+
+  /**
+   * @returns the single copy of set
+   */
+  const CompressedBitSet* intern(CompressedBitSet&& set) {
+    Shard& shard = shardOf(set.hash());
+    std::lock_guard<galois::substrate::SimpleLock> lock(shard.lock);
+    auto it = shard.sets.find(&set);
+    if (it != shard.sets.end()) {
+      return *it;
+    }
+    const CompressedBitSet* copy = new CompressedBitSet(std::move(set));
+    shard.sets.insert(copy);
+    return copy;
+  }
+
+  /**
+   * @returns the union of interned sets a and b; nullptr is the empty set
+   */
+  const CompressedBitSet* unite(
+      const CompressedBitSet* a, const CompressedBitSet* b) {
+    if (a == b || b == nullptr) {
+      return a;
+    }
+    if (a == nullptr) {
+      return b;
+    }
+    SetPair key = std::minmax(a, b);
+    Shard& shard = shardOf(PairHash()(key));
+    {
+      std::lock_guard<galois::substrate::SimpleLock> lock(shard.lock);
+      auto it = shard.unions.find(key);
+      if (it != shard.unions.end()) {
+        return it->second;
+      }
+    }
+    const CompressedBitSet* result = intern(CompressedBitSet::unite(*a, *b));
+    std::lock_guard<galois::substrate::SimpleLock> lock(shard.lock);
+    shard.unions.emplace(key, result);
+    return result;
+  }
+
+  /**
+   * @returns true if interned set a is a subset of interned set b; nullptr
+   * is the empty set. A subset is remembered as the union of a and b being
+   * b, so checking a pair of sets again, or uniting it, costs a lookup.
+   */
+  bool isSubsetEq(const CompressedBitSet* a, const CompressedBitSet* b) {
+    if (a == b || a == nullptr) {
+      return true;
+    }
+    if (b == nullptr) {
+      return false;
+    }
+
+    SetPair key = std::minmax(a, b);
+    Shard& shard = shardOf(PairHash()(key));
+    {
+      std::lock_guard<galois::substrate::SimpleLock> lock(shard.lock);
+      auto it = shard.unions.find(key);
+      if (it != shard.unions.end()) {
+        return it->second == b;
+      }
+    }
+    if (!a->isSubsetEq(*b)) {
+      return false;
+    }
+    std::lock_guard<galois::substrate::SimpleLock> lock(shard.lock);
+    shard.unions.emplace(key, b);
+    return true;
+  }
+
+  /**
+   * @returns the interned set of a and num; nullptr is the empty set
+   */
+  const CompressedBitSet* insert(const CompressedBitSet* a, unsigned num) {
+    return unite(a, intern(CompressedBitSet::singleton(num)));
+  }
+
+  /**
+   * @returns the number of distinct sets interned. Not thread safe.
+   */
+  size_t size() const {
+    size_t n = 0;
+    for (const auto& shard : shards) {
+      n += shard.data.sets.size();
+    }
+    return n;
+  }
+};
+
+/**
+ * A drop-in alternative to SparseBitVector whose contents are a pointer to a
+ * set interned in a CompressedBitSetPool. Updates replace the pointer, with
+ * compare and swap if IsConcurrent, so readers always see a whole set, and
+ * iterating over the vector while another thread updates it visits the set
+ * as it was when begin() was called.
+ */
+template <bool IsConcurrent>
+struct HashConsedBitVector {
+  using Allocator = CompressedBitSetPool;
+  using SetPointer = typename std::conditional<
+      IsConcurrent, galois::CopyableAtomic<const CompressedBitSet*>,
+      const CompressedBitSet*>::type;
+
+  //! nullptr for the empty set
+  SetPointer contents{nullptr};
+  CompressedBitSetPool* pool{nullptr};
+
+private:
+  const CompressedBitSet* load() const { return contents; }
+
+  /**
+   * Replaces expected by desired unless another thread changed the set
+   * since expected was loaded.
+   */
+  bool
+  replace(const CompressedBitSet* expected, const CompressedBitSet* desired) {
+    if constexpr (IsConcurrent) {
+      return std::atomic_compare_exchange_weak(&contents, &expected, desired);
+    } else {
+      contents = desired;
+      return true;
+    }
+  }
+
+public:
+  /**
+   * Initialize to the empty set of pool.
+   *
+   * @param _pool pool to intern the sets of this vector in
+   */
+  void init(CompressedBitSetPool* _pool) {
+    contents = nullptr;
+    pool = _pool;
+  }
+
+  //! Empties the vector; the pool owns the memory of the sets
+  void freeAll() { contents = nullptr; }
+
+  CompressedBitSet::Iterator begin() const {
+    const CompressedBitSet* s = load();
+    return s ? s->begin() : CompressedBitSet::Iterator();
+  }
+
+  CompressedBitSet::Iterator end() const {
+    return CompressedBitSet::Iterator();
+  }
+
+  /**
+   * @param num The bit to set in the bitvector
+   * @returns true if the bit set wasn't set previously
+   */
+  bool set(unsigned num) {
+    while (true) {
+      const CompressedBitSet* old = load();
+      if (old && old->test(num)) {
+        return false;
+      }
+      if (replace(old, pool->insert(old, num))) {
+        return true;
+      }
+    }
+  }
+
+  bool test(unsigned num) const {
+    const CompressedBitSet* s = load();
+    return s && s->test(num);
+  }
+
+  /**
+   * @param second Vector to check if this vector is a subset of
+   * @returns true if this vector is a subset of the second vector
+   */
+  bool isSubsetEq(const HashConsedBitVector& second) const {
+    return pool->isSubsetEq(load(), second.load());
+  }
+
+  /**
+   * Takes the passed in bitvector and does an "or" with it to update this
+   * bitvector.
+   *
+   * @param second BitVector to merge this one with
+   * @returns a non-negative value if something changed
+   */
+  unsigned unify(const HashConsedBitVector& second) {
+    const CompressedBitSet* other = second.load();
+    while (true) {
+      const CompressedBitSet* old = load();
+      const CompressedBitSet* merged = pool->unite(old, other);
+      if (merged == old) {
+        return 0;
+      }
+      if (replace(old, merged)) {
+        return 1;
+      }
+    }
+  }
+
+  /**
+   * @returns number of bits set in this bitvector
+   */
+  unsigned count() const {
+    const CompressedBitSet* s = load();
+    return s ? s->count() : 0;
+  }
+
+  /**
+   * @returns Vector with all set bits
+   */
+  std::vector<unsigned> getAllSetBits() const {
+    return std::vector<unsigned>(begin(), end());
+  }
+
+  /**
+   * Output the bits that are set in this bitvector.
+   *
+   * @param out Stream to output to
+   * @param prefix A string to append to the set bit numbers
+   */
+  void print(std::ostream& out, std::string prefix = std::string("")) const {
+    std::vector<unsigned> setBits = getAllSetBits();
+    out << "Elements(" << setBits.size() << "): ";
+
+    for (auto setBitNum : setBits) {
+      out << prefix << setBitNum << ", ";
+    }
+
+    out << "\n";
+  }
+};
+
+}  // namespace galois
+
+#endif
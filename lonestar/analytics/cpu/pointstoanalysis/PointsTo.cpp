@@ -17,12 +17,17 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <algorithm>
 #include <deque>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <type_traits>
 
+#include "HashConsedBitVector.h"
 #include "Lonestar/BoilerPlate.h"
 #include "SparseBitVector.h"
+#include "galois/ConcurrentUnionFind.h"
 #include "galois/Galois.h"
 #include "llvm/Support/CommandLine.h"
 
@@ -55,10 +60,21 @@ static cll::opt<bool> printAnswer(
 static cll::opt<bool> useCycleDetection(
     "ocd",
     cll::desc("If set, online cycle detection is"
-              " used in algorithm (serial only) "
+              " used in algorithm "
               "(default false)"),
     cll::init(false));
 
+enum PointsToSet { sparse, hashConsed };
+
+static cll::opt<PointsToSet> pointsToSet(
+    "pointsToSet", cll::desc("Representation of points-to sets:"),
+    cll::values(
+        clEnumVal(sparse, "Linked list of bit vector words (default)"),
+        clEnumVal(
+            hashConsed,
+            "Compressed bitmaps, each distinct set stored once in a pool")),
+    cll::init(sparse));
+
 static cll::opt<unsigned> THRESHOLD_LS(
     "lsThreshold",
     cll::desc("Determines how many constraints to "
@@ -130,22 +146,29 @@ public:
  *
  * @tparam IsConcurrent if set to true, the data structures used for points
  * to results and outgoing edges will be thread safe
+ * @tparam PointsToSet bit vector type of the points to results, either
+ * SparseBitVector or HashConsedBitVector
  */
-template <bool IsConcurrent>
+template <bool IsConcurrent, typename PointsToSet>
 class PTABase {
   // sparse bit vector is concurrent or serial based on template parameter
   using SparseBitVector = galois::SparseBitVector<IsConcurrent>;
 
   using PointsToConstraints = std::vector<PtsToCons>;
-  using PointsToInfo = std::vector<SparseBitVector>;
+  using PointsToInfo = std::vector<PointsToSet>;
   using EdgeVector = std::vector<SparseBitVector>;
 
-  using NodeAllocator =
-      galois::FixedSizeAllocator<typename SparseBitVector::Node>;
+public:
+  using NodeAllocator = typename SparseBitVector::Allocator;
+  using PointsToAllocator = typename PointsToSet::Allocator;
 
 protected:
   PointsToInfo pointsToResult;  // pointsTo results for nodes
   EdgeVector outgoingEdges;     // holds outgoing edges of a node
+  EdgeVector lcdCheckedEdges;   // edges checked by lazy cycle detection
+
+  // nodes to look for cycles from at the next cycle detection
+  galois::InsertBag<unsigned> cycleCandidates;
 
   PointsToConstraints addressCopyConstraints;
   PointsToConstraints loadStoreConstraints;
@@ -155,212 +178,231 @@ protected:
   ////////////////////////////////////////////////////////////////////////////////
   /**
    * Online Cycle Detection and elimination structure + functions.
+   *
+   * The nodes of a cycle of the constraint graph end up with the same
+   * points-to set, so each cycle found is collapsed into one representative
+   * node that takes the points-to sets and edges of the others. Cycles are
+   * looked for from the sources of new edges and, as in lazy cycle detection
+   * (Hardekopf and Lin, PLDI '07), from the destination of every edge whose
+   * endpoints had the same points-to set after propagating along it, which
+   * is checked once per edge. Detection is Tarjan's algorithm over the graph
+   * of representatives, which also orders the components it visits
+   * topologically for the worklist. The representatives of the nodes are the
+   * roots of a ConcurrentUnionFind, so they can be looked up concurrently,
+   * and cycles are collapsed in parallel.
    */
   struct OnlineCycleDetection {
   private:
-    PTABase<IsConcurrent>&
-        outerPTA;  // reference to outer PTA instance to get runtime info
-
-    galois::gstl::Vector<unsigned>
-        ancestors;                       // TODO find better representation
-    galois::gstl::Vector<bool> visited;  // TODO use better representation
-    galois::gstl::Vector<unsigned> representative;
-
-    unsigned NoRepresentative;  // "constant" that represents no representative
+    //! index of nodes not visited by the current detection
+    static constexpr unsigned kUnvisited = ~0U;
+    //! topological orders are coarsened to at most this many priorities
+    static constexpr unsigned kMaxPriorities = 1024;
+
+    PTABase& outerPTA;  // reference to outer PTA instance to get runtime info
+
+    std::unique_ptr<galois::ConcurrentUnionFind<unsigned>> representatives;
+
+    // Tarjan's algorithm; indexed by representative
+    galois::gstl::Vector<unsigned> index;
+    galois::gstl::Vector<unsigned> lowlink;
+    galois::gstl::Vector<bool> onStack;
+    galois::gstl::Vector<unsigned> stack;
+    unsigned nextIndex = 0;
+
+    //! topological priority of the representatives visited by the last
+    //! detection; sources of the graph come first
+    galois::gstl::Vector<unsigned> priorities;
+    //! the component of each representative visited, numbered in the order
+    //! Tarjan's algorithm finishes them, i.e., sinks first
+    galois::gstl::Vector<unsigned> components;
+    unsigned numComponents = 0;
 
     /**
-     * @returns true of the nodeid is an ancestor node
-     * FIXME find better way to do this instead of linear scan
-     */
-    bool isAncestor(unsigned nodeid) {
-      for (unsigned ii : ancestors) {
-        if (ii == nodeid) {
-          return true;
-        }
-      }
-      return false;
-    }
-
-    /**
-     * Depth first recursion of the nodeid to see if it eventually
-     * reaches an ancestor, in which case there is a cycle. The cycle is
-     * then collapsed, i.e. all nodes in the cycle have their representative
-     * changed to the representative of the node where the cycle starts.
+     * Tarjan's algorithm from root, without recursion since constraint
+     * graphs can have very long paths. Adds the components with more than
+     * one node to cycles.
      *
-     * Note it is okay not to detect all cycles as it is only an efficiency
-     * concern.
-     *
-     * @param nodeid nodeid to check the existance of a cycle
-     * @param cyclenode This is used as OUTPUT parameter; if a node is
-     * detected to be an ancestor, it is returned via this variable.
-     * @returns true if a cycle has been detected (i.e. a node has a path
-     * to an ancestor), false otherwise
+     * @param root representative to search from
+     * @param cycles output: the cycles found
      */
-    bool cycleDetect(unsigned nodeID, unsigned& cycleNode) {
-      unsigned nodeRep = getFinalRepresentative(nodeID);
-
-      // if the node is an ancestor, that means there's a path from the ancestor
-      // to the ancestor (i.e. cycle)
-      if (isAncestor(nodeRep)) {
-        cycleNode = nodeRep;
-        return true;
-      }
-
-      if (visited[nodeRep]) {
-        return false;
-      }
-
-      visited[nodeRep] = true;
-
-      // keep track of the current depth first search path
-      ancestors.push_back(nodeRep);
-
-      // don't use an iterator here because outgoing edges might get updated
-      // during this loop
-      std::vector<unsigned> repOutgoingEdges =
-          outerPTA.outgoingEdges[nodeRep].getAllSetBits();
-
-      for (auto dst : repOutgoingEdges) {
-        // recursive depth first cycle detection; if a cycle is found,
-        // collapse the path
-        if (cycleDetect(dst, cycleNode)) {
-          cycleCollapse(cycleNode);
-        }
-      }
-      ancestors.pop_back();
-
-      return false;
-    }
-
-    /**
-     * Make all nodes that are a part of some detected cycle starting at
-     * repr have their representatives changed to the representative of
-     * repr (thereby "collapsing" the cycle).
-     *
-     * @param repr The node at which the cycle begins
-     */
-    void cycleCollapse(unsigned repr) {
-      // assert(repr is present in ancestors).
-      unsigned repToChangeTo = getFinalRepresentative(repr);
-
-      for (auto ii = ancestors.begin(); ii != ancestors.end(); ++ii) {
-        if (*ii == repr) {
-          galois::gDebug("collapsing cycle for ", repr);
-          // cycle exists between nodes ancestors[*ii..end].
-          for (auto jj = ii; jj != ancestors.end(); ++jj) {
-            // jjRepr has no representative.
-            unsigned jjRepr = getFinalRepresentative(*jj);
-            makeRepr(jjRepr, repToChangeTo);
+    void strongConnect(
+        unsigned root, std::vector<std::vector<unsigned>>* cycles) {
+      struct Frame {
+        unsigned node;
+        typename SparseBitVector::SBVIterator next;
+      };
+      std::vector<Frame> path;
+
+      auto visit = [&](unsigned n) {
+        index[n] = lowlink[n] = nextIndex++;
+        stack.push_back(n);
+        onStack[n] = true;
+        path.push_back(Frame{n, outerPTA.outgoingEdges[n].begin()});
+      };
+
+      visit(root);
+      while (!path.empty()) {
+        Frame& frame = path.back();
+        unsigned n = frame.node;
+        if (frame.next != outerPTA.outgoingEdges[n].end()) {
+          unsigned dst = getFinalRepresentative(*frame.next);
+          ++frame.next;
+          if (index[dst] == kUnvisited) {
+            visit(dst);
+          } else if (onStack[dst]) {
+            lowlink[n] = std::min(lowlink[n], index[dst]);
           }
+          continue;
+        }
 
-          break;
+        path.pop_back();
+        if (!path.empty()) {
+          unsigned parent = path.back().node;
+          lowlink[parent] = std::min(lowlink[parent], lowlink[n]);
+        }
+        if (lowlink[n] != index[n]) {
+          continue;
+        }
+        // n is the first node of its component; what is above it on the
+        // stack is the rest of the component
+        std::vector<unsigned> component;
+        unsigned member;
+        do {
+          member = stack.back();
+          stack.pop_back();
+          onStack[member] = false;
+          components[member] = numComponents;
+          component.push_back(member);
+        } while (member != n);
+        ++numComponents;
+
+        if (component.size() > 1) {
+          cycles->emplace_back(std::move(component));
         }
       }
     }
 
     /**
-     * Make repr the representative of nodeID.
+     * Make the members of every cycle share one representative, which gets
+     * all of their points-to sets and edges.
      *
-     * @param nodeID node to change the representative of
-     * @param repr nodeID will have its representative changed to this
+     * @tparam LoopInvoker Functor that will run the loop over the cycles
+     * @param cycles the cycles to collapse; disjoint sets of representatives
      */
-    void makeRepr(unsigned nodeID, unsigned repr) {
-      if (repr != nodeID) {
-        galois::gDebug("change repr[", nodeID, "] = ", repr);
-
-        representative[nodeID] = repr;
-
-        // the representative needs to have all of the items that the nodes
-        // it is representing has, so if the node has more than the rep,
-        // unify
-        if (!outerPTA.pointsToResult[nodeID].isSubsetEq(
-                outerPTA.pointsToResult[repr])) {
-          outerPTA.pointsToResult[repr].unify(outerPTA.pointsToResult[nodeID]);
-        }
-
-        // unify edges as well if necessary since rep represents it now
-        if (!outerPTA.outgoingEdges[nodeID].isSubsetEq(
-                outerPTA.outgoingEdges[repr])) {
-          outerPTA.outgoingEdges[repr].unify(outerPTA.outgoingEdges[nodeID]);
+    template <typename LoopInvoker>
+    void collapse(const std::vector<std::vector<unsigned>>& cycles) {
+      std::vector<std::pair<unsigned, unsigned>> links;
+      for (const std::vector<unsigned>& cycle : cycles) {
+        for (unsigned member : cycle) {
+          links.emplace_back(cycle.front(), member);
         }
       }
+      representatives->UniteAll(links, "PointsToCollapseCyclesLink");
+
+      // every cycle only touches the sets of its own members, so cycles can
+      // be merged in parallel
+      LoopInvoker()(galois::iterate(cycles), [&](const auto& cycle) {
+        unsigned repr = getFinalRepresentative(cycle.front());
+        galois::gDebug("collapsing cycle of ", cycle.size(), " into ", repr);
+        for (unsigned member : cycle) {
+          if (member == repr) {
+            continue;
+          }
+          // the representative needs to have all of the items that the
+          // nodes it is representing have, and their edges as well
+          outerPTA.pointsToResult[repr].unify(outerPTA.pointsToResult[member]);
+          outerPTA.outgoingEdges[repr].unify(outerPTA.outgoingEdges[member]);
+        }
+      });
     }
 
   public:
-    OnlineCycleDetection(PTABase<IsConcurrent>& o) : outerPTA(o) {}
+    OnlineCycleDetection(PTABase& o) : outerPTA(o) {}
 
     /**
      * Init fields (outerPTA needs to have numNodes set).
      */
     void init() {
-      NoRepresentative = outerPTA.numNodes;
-      visited.resize(outerPTA.numNodes);
-      representative.resize(outerPTA.numNodes);
-
-      for (unsigned ii = 0; ii < outerPTA.numNodes; ++ii) {
-        representative[ii] = NoRepresentative;
-      }
+      representatives =
+          std::make_unique<galois::ConcurrentUnionFind<unsigned>>(
+              outerPTA.numNodes);
+      index.assign(outerPTA.numNodes, kUnvisited);
+      lowlink.resize(outerPTA.numNodes);
+      onStack.assign(outerPTA.numNodes, false);
+      priorities.assign(outerPTA.numNodes, 0);
+      components.resize(outerPTA.numNodes);
     }
 
     /**
      * Given a node id, find its representative. Also, do path compression
-     * of the path to the representative.
+     * of the path to the representative. Thread safe.
      *
      * @param nodeid Node id to get the representative of
      * @returns The representative of nodeid
      */
     unsigned getFinalRepresentative(unsigned nodeid) {
-      unsigned finalRep = nodeid;
-
-      // follow chain of representatives until a "root" is reached
-      while (representative[finalRep] != NoRepresentative) {
-        finalRep = representative[finalRep];
-      }
-
-      // path compression; make all things along path to final representative
-      // point to the final representative
-      unsigned curRep = representative[nodeid];
-
-      while (curRep != NoRepresentative) {
-        representative[nodeid] = finalRep;
-        nodeid = curRep;
-        curRep = representative[nodeid];
-      }
-
-      return finalRep;
+      return representatives->Find(nodeid);
     }
 
     /**
-     * Go over all sources of new edges to see if there are cycles in them.
-     * If so, collapse the cycles.
+     * @param repr a representative
+     * @returns its priority in the topological order found by the last
+     * detection: lower for nodes closer to the sources of the graph
+     */
+    unsigned getPriority(unsigned repr) const { return priorities[repr]; }
+
+    /**
+     * Go over all sources of new edges and the nodes queued by lazy cycle
+     * detection to see if there are cycles in them. If so, collapse the
+     * cycles. Then orders the nodes visited topologically.
      *
+     * @tparam LoopInvoker Functor that will run the loop over the cycles
      * @param updates vector of nodes that are sources of new edges.
      */
-    template <typename VecType>
+    template <typename LoopInvoker, typename VecType>
     void process(VecType& updates) {
       if (!useCycleDetection) {
         return;
       }
 
-      // TODO this can probably be made more efficient (fill?)
-      for (unsigned ii = 0; ii < outerPTA.numNodes; ++ii) {
-        visited[ii] = false;
-      }
-
-      unsigned cycleNode = NoRepresentative;  // set to invalid id.
+      std::fill(index.begin(), index.end(), kUnvisited);
+      nextIndex = 0;
+      numComponents = 0;
 
+      std::vector<std::vector<unsigned>> cycles;
+      auto search = [&](unsigned node) {
+        unsigned repr = getFinalRepresentative(node);
+        if (index[repr] == kUnvisited) {
+          strongConnect(repr, &cycles);
+        }
+      };
       for (unsigned update : updates) {
-        galois::gDebug("cycle process ", update);
+        search(update);
+      }
+      for (unsigned candidate : outerPTA.cycleCandidates) {
+        search(candidate);
+      }
+      outerPTA.cycleCandidates.clear();
 
-        if (cycleDetect(update, cycleNode)) {
-          cycleCollapse(cycleNode);
-        }
+      collapse<LoopInvoker>(cycles);
+
+      // reverse the finishing order of the components to go from sources
+      // to sinks, in at most kMaxPriorities steps
+      unsigned shift = 0;
+      while ((numComponents >> shift) > kMaxPriorities) {
+        ++shift;
       }
+      LoopInvoker()(
+          galois::iterate(size_t{0}, outerPTA.numNodes), [&](size_t n) {
+            priorities[n] = index[n] == kUnvisited
+                                ? 0
+                                : (numComponents - 1 - components[n]) >> shift;
+          });
     }
   };  // end struct OnlineCycleDetection
   ////////////////////////////////////////////////////////////////////////////////
 
-  OnlineCycleDetection ocd;  // cycle detector/squasher; only works with serial
+  OnlineCycleDetection ocd;  // cycle detector/squasher
 
   /**
    * Adds edges to the graph based on load/store constraints.
@@ -488,6 +530,14 @@ protected:
         // newPtsTo is positive if changes are made
         newPtsTo += pointsToResult[dstRepr].unify(pointsToResult[srcRepr]);
       }
+
+      // lazy cycle detection: the same points-to set at both ends of an edge
+      // hints at a cycle through it, so look for one from dst once per edge
+      if (useCycleDetection && srcRepr != dstRepr &&
+          pointsToResult[dstRepr].isSubsetEq(pointsToResult[srcRepr]) &&
+          lcdCheckedEdges[srcRepr].set(dstRepr)) {
+        cycleCandidates.push_back(dstRepr);
+      }
     }
 
     return newPtsTo;
@@ -503,18 +553,23 @@ public:
    * @param n Number of nodes in the constraint graph
    * @param nodeAllocator galois allocator object to allocate nodes in the
    * sparse bit vector
+   * @param pointsToAllocator allocator of the points to results
    */
-  void initialize(size_t n, NodeAllocator& nodeAllocator) {
+  void initialize(
+      size_t n, NodeAllocator& nodeAllocator,
+      PointsToAllocator& pointsToAllocator) {
     numNodes = n;
 
     // initialize different constructs based on which version is being run
     pointsToResult.resize(numNodes);
     outgoingEdges.resize(numNodes);
+    lcdCheckedEdges.resize(numNodes);
 
     // initialize vectors
     for (unsigned i = 0; i < numNodes; i++) {
-      pointsToResult[i].init(&nodeAllocator);
+      pointsToResult[i].init(&pointsToAllocator);
       outgoingEdges[i].init(&nodeAllocator);
+      lcdCheckedEdges[i].init(&nodeAllocator);
     }
 
     ocd.init();
@@ -525,6 +580,7 @@ public:
     for (unsigned i = 0; i < numNodes; i++) {
       pointsToResult[i].freeAll();
       outgoingEdges[i].freeAll();
+      lcdCheckedEdges[i].freeAll();
     }
   }
 
@@ -672,7 +728,16 @@ public:
 /**
  * Serial points to executor.
  */
-class PTASerial : public PTABase<false> {
+template <typename PointsToSet>
+class PTASerial : public PTABase<false, PointsToSet> {
+  using Base = PTABase<false, PointsToSet>;
+  using Base::addressCopyConstraints;
+  using Base::loadStoreConstraints;
+  using Base::numNodes;
+  using Base::ocd;
+  using Base::outgoingEdges;
+  using Base::propagate;
+
 public:
   /**
    * Run points-to-analysis on a single thread.
@@ -684,9 +749,10 @@ public:
     galois::gDebug("no of nodes = ", numNodes);
 
     std::deque<unsigned> updates;
-    updates = processAddressOfCopy<galois::StdForEach, std::deque<unsigned>>(
-        addressCopyConstraints);
-    processLoadStore<galois::StdForEach>(loadStoreConstraints, updates);
+    updates = this->template processAddressOfCopy<
+        galois::StdForEach, std::deque<unsigned>>(addressCopyConstraints);
+    this->template processLoadStore<galois::StdForEach>(
+        loadStoreConstraints, updates);
 
     unsigned numUps = 0;
 
@@ -708,15 +774,23 @@ public:
 
       if (updates.empty() || numUps >= THRESHOLD_LS) {
         galois::gDebug(
-            "No of points-to facts computed = ", countPointsToFacts());
+            "No of points-to facts computed = ", this->countPointsToFacts());
         numUps = 0;
 
         // After propagating all constraints, see if load/store
         // constraints need to be added in since graph was potentially updated
-        processLoadStore<galois::StdForEach>(loadStoreConstraints, updates);
-
-        // do cycle squashing
-        ocd.process(updates);
+        this->template processLoadStore<galois::StdForEach>(
+            loadStoreConstraints, updates);
+
+        // do cycle squashing, then go through the updates in topological
+        // order
+        ocd.template process<galois::StdForEach>(updates);
+        if (useCycleDetection) {
+          std::stable_sort(
+              updates.begin(), updates.end(), [&](unsigned a, unsigned b) {
+                return ocd.getPriority(a) < ocd.getPriority(b);
+              });
+        }
       }
     }
   }
@@ -725,7 +799,38 @@ public:
 /**
  * Concurrent points to executor.
  */
-class PTAConcurrent : public PTABase<true> {
+template <typename PointsToSet>
+class PTAConcurrent : public PTABase<true, PointsToSet> {
+  using Base = PTABase<true, PointsToSet>;
+  using Base::addressCopyConstraints;
+  using Base::loadStoreConstraints;
+  using Base::numNodes;
+  using Base::ocd;
+
+  /**
+   * Propagate points to information along the edges of the updated nodes
+   * until no points to set changes.
+   *
+   * @param updates nodes whose points to set or edges changed
+   * @param wl worklist of the loop
+   */
+  template <typename WL>
+  void propagateUpdates(galois::InsertBag<unsigned>& updates, WL wl) {
+    galois::for_each(
+        galois::iterate(updates),
+        [this](unsigned req, auto& ctx) {
+          for (auto dst = this->outgoingEdges[req].begin();
+               dst != this->outgoingEdges[req].end(); dst++) {
+            unsigned newPtsTo = this->propagate(req, *dst);
+
+            if (newPtsTo)
+              ctx.push(this->ocd.getFinalRepresentative(*dst));
+          }
+        },
+        galois::loopname("PointsToMainUpdateLoop"),
+        galois::disable_conflict_detection(), wl);
+  }
+
 public:
   /**
    * Run points-to-analysis using galois::for_each as the main loop.
@@ -736,37 +841,39 @@ public:
         ", no of load+store constraints = ", loadStoreConstraints.size());
     galois::gDebug("no of nodes = ", numNodes);
 
+    // with cycle detection, nodes closer to the sources of the constraint
+    // graph go first, so that their points to sets are complete before they
+    // are propagated further
+    auto priority = [this](unsigned n) { return this->ocd.getPriority(n); };
+    using Chunk = galois::worklists::PerSocketChunkFIFO<8>;
+    using OBIM =
+        galois::worklists::OrderedByIntegerMetric<decltype(priority), Chunk>;
+
     galois::InsertBag<unsigned> updates;
-    updates = processAddressOfCopy<galois::DoAll, galois::InsertBag<unsigned>>(
-        addressCopyConstraints);
-    processLoadStore<galois::DoAll>(loadStoreConstraints, updates);
+    updates = this->template processAddressOfCopy<
+        galois::DoAll, galois::InsertBag<unsigned>>(addressCopyConstraints);
+    this->template processLoadStore<galois::DoAll>(
+        loadStoreConstraints, updates);
 
     while (!updates.empty()) {
-      galois::for_each(
-          galois::iterate(updates),
-          [this](unsigned req, auto& ctx) {
-            for (auto dst = this->outgoingEdges[req].begin();
-                 dst != this->outgoingEdges[req].end(); dst++) {
-              unsigned newPtsTo = this->propagate(req, *dst);
-
-              if (newPtsTo)
-                ctx.push(this->ocd.getFinalRepresentative(*dst));
-            }
-          },
-          galois::loopname("PointsToMainUpdateLoop"),
-          galois::disable_conflict_detection(),
-          galois::wl<galois::worklists::PerSocketChunkFIFO<8>>());
-
-      galois::gDebug("No of points-to facts computed = ", countPointsToFacts());
+      if (useCycleDetection) {
+        propagateUpdates(updates, galois::wl<OBIM>(priority));
+      } else {
+        propagateUpdates(updates, galois::wl<Chunk>());
+      }
+
+      galois::gDebug(
+          "No of points-to facts computed = ", this->countPointsToFacts());
 
       updates.clear();
 
       // After propagating all constraints, see if load/store constraints need
       // to be added in since graph was potentially updated
-      processLoadStore<galois::DoAll>(loadStoreConstraints, updates);
+      this->template processLoadStore<galois::DoAll>(
+          loadStoreConstraints, updates);
 
       // do cycle squashing
-      // ocd.process(updates); // TODO have parallel OCD, if possible
+      ocd.template process<galois::DoAll>(updates);
     }
   }
 };
@@ -774,11 +881,15 @@ public:
 /**
  * Method from running PTA.
  */
-template <typename PTAClass, typename Alloc>
+template <typename PTAClass>
 void
-runPTA(PTAClass& pta, Alloc& nodeAllocator) {
+runPTA() {
+  typename PTAClass::NodeAllocator nodeAllocator;
+  typename PTAClass::PointsToAllocator pointsToAllocator;
+  PTAClass pta;
+
   size_t numNodes = pta.readConstraints(inputFile.c_str());
-  pta.initialize(numNodes, nodeAllocator);
+  pta.initialize(numNodes, nodeAllocator, pointsToAllocator);
 
   galois::StatTimer execTime("Timer_0");
 
@@ -787,6 +898,11 @@ runPTA(PTAClass& pta, Alloc& nodeAllocator) {
   execTime.stop();
 
   galois::gInfo("No of points-to facts computed = ", pta.countPointsToFacts());
+  if constexpr (std::is_same_v<
+                    typename PTAClass::PointsToAllocator,
+                    galois::CompressedBitSetPool>) {
+    galois::gInfo("No of distinct points-to sets = ", pointsToAllocator.size());
+  }
 
   if (!skipVerify) {
     galois::gInfo("Doing verification step");
@@ -819,20 +935,22 @@ main(int argc, char** argv) {
         "Note correctness of this version is relative to the serial "
         "version.");
 
-    PTAConcurrent p;
-    galois::FixedSizeAllocator<typename galois::SparseBitVector<true>::Node>
-        nodeAllocator;
-    runPTA(p, nodeAllocator);
+    if (pointsToSet == hashConsed) {
+      runPTA<PTAConcurrent<galois::HashConsedBitVector<true>>>();
+    } else {
+      runPTA<PTAConcurrent<galois::SparseBitVector<true>>>();
+    }
   } else {
     galois::gInfo("-------- Sequential version.");
     galois::gInfo(
         "The load store threshold (-lsThreshold) may need tweaking for "
         "best performance; its current setting may not be the best for "
         "your input and may actually degrade performance.");
-    PTASerial p;
-    galois::FixedSizeAllocator<typename galois::SparseBitVector<false>::Node>
-        nodeAllocator;
-    runPTA(p, nodeAllocator);
+    if (pointsToSet == hashConsed) {
+      runPTA<PTASerial<galois::HashConsedBitVector<false>>>();
+    } else {
+      runPTA<PTASerial<galois::SparseBitVector<false>>>();
+    }
   }
 
   totalTime.stop();
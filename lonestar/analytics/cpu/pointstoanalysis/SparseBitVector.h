@@ -356,6 +356,8 @@ struct SparseBitVector {
 
   //////////////////////////////////////////////////////////////////////////////
 
+  using Allocator = galois::FixedSizeAllocator<Node>;
+
   using NodeType = typename std::conditional<
       IsConcurrent, galois::CopyableAtomic<Node*>, Node*>::type;
   // head of linked list
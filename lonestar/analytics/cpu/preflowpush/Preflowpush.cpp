@@ -17,6 +17,7 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <atomic>
 #include <fstream>
 #include <iostream>
 
@@ -25,6 +26,7 @@
 #include "Lonestar/BoilerPlate.h"
 #include "galois/Bag.h"
 #include "galois/Galois.h"
+#include "galois/LargeArray.h"
 #include "galois/Reduction.h"
 #include "galois/Timer.h"
 #include "galois/graphs/LCGraph.h"
@@ -59,6 +61,10 @@ static cll::opt<int> relabelInt(
     cll::desc("relabel interval X: relabel every X iterations "
               "(default 0 uses default interval)"),
     cll::init(0));
+static cll::opt<bool> useGapHeuristic(
+    "useGapHeuristic",
+    cll::desc("Lift the nodes above a height that no node has (default true)"),
+    cll::init(true));
 static cll::opt<DetAlgo> detAlgo(
     cll::desc("Deterministic algorithm:"),
     cll::values(
@@ -111,6 +117,13 @@ struct PreflowPush {
   GNode source;
   int global_relabel_interval;
   bool should_global_relabel = false;
+  bool should_gap_relabel = false;
+  //! number of nodes at each height below graph.size(), for the gap heuristic
+  galois::LargeArray<std::atomic<int>> heightCounts;
+  //! lowest height that a relabel left empty since the heights were reset
+  std::atomic<int> gapHeight;
+  uint64_t numGapRelabels = 0;
+  uint64_t numGapLifted = 0;
   galois::LargeArray<Graph::edge_iterator>
       reverseDirectionEdgeIterator;  // ideally should be on the graph as
                                      // graph.getReverseEdgeIterator()
@@ -222,12 +235,28 @@ struct PreflowPush {
     ++minHeight;
 
     Node& node = graph.getData(src, galois::MethodFlag::UNPROTECTED);
+    int oldHeight = node.height;
     if (minHeight < (int)graph.size()) {
       node.height = minHeight;
       node.current = minEdge;
+      ++heightCounts[minHeight];
     } else {
       node.height = graph.size();
     }
+
+    // Count the new height before leaving the old one, so that a count that
+    // drops to 0 means that no node has that height
+    if (--heightCounts[oldHeight] == 0 && useGapHeuristic &&
+        minHeight < (int)graph.size()) {
+      recordGap(oldHeight);
+    }
+  }
+
+  void recordGap(int height) {
+    int prev = gapHeight.load(std::memory_order_relaxed);
+    while (height < prev && !gapHeight.compare_exchange_weak(prev, height)) {
+    }
+    should_gap_relabel = true;
   }
 
   template <typename C>
@@ -310,7 +339,7 @@ struct PreflowPush {
         this->should_global_relabel = true;
         return true;
       } else {
-        return false;
+        return this->should_gap_relabel;
       }
     };
 
@@ -365,72 +394,77 @@ struct PreflowPush {
             ctx.breakLoop();
             return;
           }
+          if (this->should_gap_relabel) {
+            ctx.breakLoop();
+            return;
+          }
         },
         galois::loopname("nonDetDischarge"), galois::parallel_break(), wl_opt);
   }
 
   /**
    * Do reverse BFS on residual graph.
+   *
+   * Sets the height of each node that can reach the sink to its distance to
+   * the sink and counts the nodes at each height. The BFS is
+   * level-synchronous over the transpose of the residual graph: the nodes of
+   * a level are expanded in parallel, and the first thread to reach a node
+   * claims it for the next level with a CAS, so that each node is expanded
+   * once. The heights are the same for every schedule.
    */
-  template <DetAlgo version, typename WL, bool useCAS = true>
   void updateHeights() {
-    galois::for_each(
-        galois::iterate({sink}),
-        [&, this](const GNode& src, auto& ctx) {
-          if (version != nondet) {
-            if (ctx.isFirstPass()) {
-              for (auto ii :
-                   this->graph.edges(src, galois::MethodFlag::WRITE)) {
-                GNode dst = this->graph.getEdgeDst(ii);
-                int64_t rdata =
-                    this->graph.getEdgeData(reverseDirectionEdgeIterator[*ii]);
-                if (rdata > 0) {
-                  this->graph.getData(dst, galois::MethodFlag::WRITE);
-                }
-              }
-            }
-
-            if (version == detDisjoint && ctx.isFirstPass()) {
-              return;
-            } else {
-              this->graph.getData(src, galois::MethodFlag::WRITE);
-              ctx.cautiousPoint();
-            }
-          }
-
-          for (auto ii : this->graph.edges(
-                   src, useCAS ? galois::MethodFlag::UNPROTECTED
-                               : galois::MethodFlag::WRITE)) {
-            GNode dst = this->graph.getEdgeDst(ii);
-            int64_t rdata =
-                this->graph.getEdgeData(reverseDirectionEdgeIterator[*ii]);
-            if (rdata > 0) {
+    const int size = graph.size();
+    galois::InsertBag<GNode> levels[2];
+    levels[0].push(sink);
+    heightCounts[0] = 1;
+
+    for (int level = 1; !levels[(level - 1) % 2].empty(); ++level) {
+      galois::InsertBag<GNode>& current = levels[(level - 1) % 2];
+      galois::InsertBag<GNode>& next = levels[level % 2];
+      galois::GAccumulator<int> reached;
+
+      galois::do_all(
+          galois::iterate(current),
+          [&, this](const GNode& src) {
+            for (auto ii : this->graph.edges(
+                     src, galois::MethodFlag::UNPROTECTED)) {
+              // dst reaches src if the edge from dst to src is residual
+              int64_t rdata =
+                  this->graph.getEdgeData(reverseDirectionEdgeIterator[*ii]);
+              if (rdata <= 0)
+                continue;
+              GNode dst = this->graph.getEdgeDst(ii);
               Node& node =
                   this->graph.getData(dst, galois::MethodFlag::UNPROTECTED);
-              int newHeight =
-                  this->graph.getData(src, galois::MethodFlag::UNPROTECTED)
-                      .height +
-                  1;
-              if (useCAS) {
-                int oldHeight = 0;
-                while (newHeight < (oldHeight = node.height)) {
-                  if (__sync_bool_compare_and_swap(
-                          &node.height, oldHeight, newHeight)) {
-                    ctx.push(dst);
-                    break;
-                  }
-                }
-              } else {
-                if (newHeight < node.height) {
-                  node.height = newHeight;
-                  ctx.push(dst);
-                }
+              if (node.height == size && dst != this->source &&
+                  __sync_bool_compare_and_swap(&node.height, size, level)) {
+                next.push(dst);
+                reached += 1;
               }
             }
-          }  // end for
+          },
+          galois::steal(), galois::loopname("updateHeights"));
+
+      current.clear();
+      if (level < size)
+        heightCounts[level] = reached.reduce();
+    }
+  }
+
+  template <typename IncomingWL>
+  void findWork(IncomingWL& incoming) {
+    galois::do_all(
+        galois::iterate(graph),
+        [&incoming, this](const GNode& src) {
+          Node& node =
+              this->graph.getData(src, galois::MethodFlag::UNPROTECTED);
+          if (src == this->sink || src == this->source ||
+              node.height >= (int)this->graph.size())
+            return;
+          if (node.excess > 0)
+            incoming.push_back(src);
         },
-        galois::wl<WL>(), galois::disable_conflict_detection(),
-        galois::loopname("updateHeights"));
+        galois::loopname("FindWork"));
   }
 
   template <typename IncomingWL>
@@ -445,48 +479,68 @@ struct PreflowPush {
             node.height = 0;
         },
         galois::loopname("ResetHeights"));
+    galois::do_all(
+        galois::iterate(size_t{0}, graph.size()),
+        [&](size_t height) { heightCounts[height] = 0; },
+        galois::loopname("ResetHeightCounts"));
 
-    using BSWL = galois::worklists::BulkSynchronous<>;
-    using DWL = galois::worklists::Deterministic<>;
-    switch (detAlgo) {
-    case nondet:
-      updateHeights<nondet, BSWL>();
-      break;
-    case detBase:
-      updateHeights<detBase, DWL>();
-      break;
-    case detDisjoint:
-      updateHeights<detDisjoint, DWL>();
-      break;
-    default:
-      std::cerr << "Unknown algorithm" << detAlgo << "\n";
-      abort();
+    updateHeights();
+
+    gapHeight = graph.size();
+    should_gap_relabel = false;
+    findWork(incoming);
+  }
+
+  /**
+   * Gap heuristic (Cherkassky and Goldberg): if no node has some height below
+   * graph.size(), the nodes above it cannot reach the sink, so they are
+   * lifted to graph.size() at once instead of being relabeled up one by one.
+   *
+   * Relabels record the lowest height they leave empty and stop the
+   * discharge phase; this runs between phases, when the counts are exact.
+   * The recorded height may have been refilled in the meantime, so the gap
+   * is the first empty height from it.
+   */
+  template <typename IncomingWL>
+  void gapRelabel(IncomingWL& incoming) {
+    const int size = graph.size();
+    int gap = gapHeight;
+    while (gap < size && heightCounts[gap] > 0)
+      ++gap;
+
+    if (gap < size) {
+      galois::GAccumulator<int> lifted;
+      galois::do_all(
+          galois::iterate(graph),
+          [&, this](const GNode& src) {
+            Node& node =
+                this->graph.getData(src, galois::MethodFlag::UNPROTECTED);
+            if (node.height > gap && node.height < size) {
+              node.height = size;
+              lifted += 1;
+            }
+          },
+          galois::loopname("GapRelabel"));
+      galois::do_all(
+          galois::iterate(gap + 1, size),
+          [&](int height) { heightCounts[height] = 0; },
+          galois::loopname("ResetHeightCounts"));
+      numGapLifted += lifted.reduce();
     }
+    ++numGapRelabels;
 
-    galois::do_all(
-        galois::iterate(graph),
-        [&incoming, this](const GNode& src) {
-          Node& node =
-              this->graph.getData(src, galois::MethodFlag::UNPROTECTED);
-          if (src == this->sink || src == this->source ||
-              node.height >= (int)this->graph.size())
-            return;
-          if (node.excess > 0)
-            incoming.push_back(src);
-        },
-        galois::loopname("FindWork"));
+    gapHeight = size;
+    should_gap_relabel = false;
+    findWork(incoming);
   }
 
-  template <typename C>
-  void initializePreflow(C& initial) {
+  void initializePreflow() {
     for (auto ii : graph.edges(source)) {
       GNode dst = graph.getEdgeDst(ii);
       int64_t cap = graph.getEdgeData(ii);
       reduceCapacity(ii, cap);
       Node& node = graph.getData(dst);
       node.excess += cap;
-      if (cap > 0)
-        initial.push_back(dst);
     }
   }
 
@@ -502,8 +556,16 @@ struct PreflowPush {
         decltype(obimIndexer), Chunk>
         OBIM;
 
+    heightCounts.allocateBlocked(graph.size());
+    galois::do_all(
+        galois::iterate(size_t{0}, graph.size()),
+        [&](size_t height) { heightCounts.constructAt(height, 0); },
+        galois::no_stats());
+
+    // Start from exact heights, which also finds the nodes with excess
     galois::InsertBag<GNode> initial;
-    initializePreflow(initial);
+    initializePreflow();
+    globalRelabel(initial);
 
     while (initial.begin() != initial.end()) {
       galois::StatTimer T_discharge("DischargeTime");
@@ -538,10 +600,19 @@ struct PreflowPush {
         std::cout << " Flow after global relabel: "
                   << graph.getData(sink).excess << "\n";
         T_global_relabel.stop();
+      } else if (should_gap_relabel) {
+        galois::StatTimer T_gap_relabel("GapRelabelTime");
+        T_gap_relabel.start();
+        initial.clear();
+        gapRelabel(initial);
+        T_gap_relabel.stop();
       } else {
         break;
       }
     }
+
+    galois::ReportStatSingle("PreflowPush", "GapRelabels", numGapRelabels);
+    galois::ReportStatSingle("PreflowPush", "GapLiftedNodes", numGapLifted);
   }
 
   template <typename EdgeTy>
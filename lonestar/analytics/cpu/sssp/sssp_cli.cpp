@@ -43,6 +43,27 @@ static cll::opt<unsigned int> reportNode(
 static cll::opt<unsigned int> stepShift(
     "delta", cll::desc("Shift value for the deltastep (default value 13)"),
     cll::init(13));
+static cll::opt<bool> adaptiveDelta(
+    "adaptiveDelta",
+    cll::desc("Estimate delta from the edge weights and the average degree "
+              "instead of using -delta (default false)"),
+    cll::init(false));
+static cll::opt<uint32_t> denseFrontierDivisor(
+    "denseFrontierDivisor",
+    cll::desc("Use a dense frontier when the frontier has more than "
+              "1/denseFrontierDivisor of the edges; 0 disables (default "
+              "value 20)"),
+    cll::init(galois::analytics::kDefaultDenseFrontierDivisor));
+static cll::opt<bool> inlineEdges(
+    "inlineEdges",
+    cll::desc("Read the destination and the weight of each edge from one "
+              "interleaved copy of them (default false)"),
+    cll::init(false));
+static cll::opt<unsigned> relaxation(
+    "relaxation",
+    cll::desc("Number of priority queues per thread of MultiQueue (default "
+              "value 2)"),
+    cll::init(SsspPlan::kDefaultRelaxation));
 
 static cll::opt<SsspPlan::Algorithm> algo(
     "algo", cll::desc("Choose an algorithm (default value auto):"),
@@ -56,6 +77,9 @@ static cll::opt<SsspPlan::Algorithm> algo(
         clEnumVal(SsspPlan::kDijkstra, "Dijkstra"),
         clEnumVal(SsspPlan::kTopo, "Topo"),
         clEnumVal(SsspPlan::kTopoTile, "TopoTile"),
+        clEnumVal(SsspPlan::kDeltaStepFusion, "DeltaStepFusion"),
+        clEnumVal(SsspPlan::kMultiQueue, "MultiQueue"),
+        clEnumVal(SsspPlan::kDeltaStepPmod, "DeltaStepPmod"),
         clEnumVal(
             SsspPlan::kAutomatic,
             "Automatic: choose among the algorithms automatically")),
@@ -173,6 +197,12 @@ AlgorithmName(SsspPlan::Algorithm algorithm) {
     return "Topo";
   case SsspPlan::kTopoTile:
     return "TopoTile";
+  case SsspPlan::kDeltaStepFusion:
+    return "DeltaStepFusion";
+  case SsspPlan::kMultiQueue:
+    return "MultiQueue";
+  case SsspPlan::kDeltaStepPmod:
+    return "DeltaStepPmod";
   case SsspPlan::kAutomatic:
     return "Automatic";
   default:
@@ -204,8 +234,12 @@ main(int argc, char** argv) {
 
   galois::reportPageAlloc("MeminfoPre");
 
-  if (algo == SsspPlan::kDeltaStep || algo == SsspPlan::kDeltaTile ||
-      algo == SsspPlan::kSerialDelta || algo == SsspPlan::kSerialDeltaTile) {
+  unsigned delta = adaptiveDelta ? SsspPlan::kAdaptiveDelta : stepShift;
+
+  if (!adaptiveDelta &&
+      (algo == SsspPlan::kDeltaStep || algo == SsspPlan::kDeltaTile ||
+       algo == SsspPlan::kSerialDelta || algo == SsspPlan::kSerialDeltaTile ||
+       algo == SsspPlan::kDeltaStepFusion)) {
     std::cout
         << "INFO: Using delta-step of " << (1 << stepShift) << "\n"
         << "WARNING: Performance varies considerably due to delta parameter.\n"
@@ -217,19 +251,19 @@ main(int argc, char** argv) {
   SsspPlan plan = SsspPlan::Automatic();
   switch (algo) {
   case SsspPlan::kDeltaTile:
-    plan = SsspPlan::DeltaTile(stepShift);
+    plan = SsspPlan::DeltaTile(delta);
     break;
   case SsspPlan::kDeltaStep:
-    plan = SsspPlan::DeltaStep(stepShift);
+    plan = SsspPlan::DeltaStep(delta);
     break;
   case SsspPlan::kDeltaStepBarrier:
-    plan = SsspPlan::DeltaStepBarrier(stepShift);
+    plan = SsspPlan::DeltaStepBarrier(delta);
     break;
   case SsspPlan::kSerialDeltaTile:
-    plan = SsspPlan::SerialDeltaTile(stepShift);
+    plan = SsspPlan::SerialDeltaTile(delta);
     break;
   case SsspPlan::kSerialDelta:
-    plan = SsspPlan::SerialDelta(stepShift);
+    plan = SsspPlan::SerialDelta(delta);
     break;
   case SsspPlan::kDijkstraTile:
     plan = SsspPlan::DijkstraTile();
@@ -238,11 +272,20 @@ main(int argc, char** argv) {
     plan = SsspPlan::Dijkstra();
     break;
   case SsspPlan::kTopo:
-    plan = SsspPlan::Topo();
+    plan = SsspPlan::Topo(denseFrontierDivisor);
     break;
   case SsspPlan::kTopoTile:
     plan = SsspPlan::TopoTile();
     break;
+  case SsspPlan::kDeltaStepFusion:
+    plan = SsspPlan::DeltaStepFusion(delta);
+    break;
+  case SsspPlan::kMultiQueue:
+    plan = SsspPlan::MultiQueue(relaxation);
+    break;
+  case SsspPlan::kDeltaStepPmod:
+    plan = SsspPlan::DeltaStepPmod(delta);
+    break;
   case SsspPlan::kAutomatic:
     plan = SsspPlan::Automatic();
     break;
@@ -250,12 +293,15 @@ main(int argc, char** argv) {
     std::cerr << "Invalid algorithm\n";
     abort();
   }
+  plan = plan.WithInlineEdges(inlineEdges);
 
-  auto pg_result =
-      Sssp(pfg.get(), startNode, edge_property_name, "distance", plan);
-  if (!pg_result) {
-    GALOIS_LOG_FATAL("Failed to run SSSP: {}", pg_result.error());
-  }
+  LonestarRun(pfg.get(), {"distance"}, {}, [&]() {
+    auto pg_result =
+        Sssp(pfg.get(), startNode, edge_property_name, "distance", plan);
+    if (!pg_result) {
+      GALOIS_LOG_FATAL("Failed to run SSSP: {}", pg_result.error());
+    }
+  });
 
   switch (pfg->EdgeProperty(edge_property_name)->type()->id()) {
   case arrow::UInt32Type::type_id:
@@ -280,6 +326,8 @@ main(int argc, char** argv) {
     abort();
   }
 
+  LonestarCommit(pfg.get());
+
   totalTime.stop();
 
   return 0;
@@ -0,0 +1,229 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include <iostream>
+#include <vector>
+
+#include "Lonestar/BoilerPlate.h"
+#include "galois/analytics/triangle_count/triangle_count.h"
+
+using namespace galois::analytics;
+
+namespace cll = llvm::cl;
+
+static const char* name = "Triangles";
+
+static const char* desc =
+    "Counts the triangles in a graph with the analytics library";
+
+static const char* url = nullptr;
+
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+
+static cll::opt<TriangleCountPlan::Algorithm> algo(
+    "algo", cll::desc("Choose an algorithm:"),
+    cll::values(
+        clEnumValN(
+            TriangleCountPlan::kNodeIteration, "nodeiterator",
+            "Node Iterator"),
+        clEnumValN(
+            TriangleCountPlan::kEdgeIteration, "edgeiterator",
+            "Edge Iterator"),
+        clEnumValN(
+            TriangleCountPlan::kOrderedCount, "orderedCount",
+            "Ordered Simple Count"),
+        clEnumValN(
+            TriangleCountPlan::kDegreeOrderedDag, "degreeOrderedDag",
+            "Degree Ordered DAG (default)")),
+    cll::init(TriangleCountPlan::kDegreeOrderedDag));
+
+static cll::opt<bool> relabel(
+    "relabel",
+    cll::desc("Relabel nodes of the graph before nodeiterator, edgeiterator "
+              "or orderedCount (default value of false => choose "
+              "automatically)"),
+    cll::init(false));
+
+static cll::opt<uint64_t> approximateSamples(
+    "approximateSamples",
+    cll::desc("Estimate the number of triangles from this many wedge samples "
+              "instead of counting them (default value of 0 => count "
+              "exactly)"),
+    cll::init(0));
+
+static cll::opt<double> confidence(
+    "confidence",
+    cll::desc("(For approximateSamples) Probability that the true count lies "
+              "within the reported bounds (default 0.95)"),
+    cll::init(0.95));
+
+std::string
+AlgorithmName(TriangleCountPlan::Algorithm algorithm) {
+  switch (algorithm) {
+  case TriangleCountPlan::kNodeIteration:
+    return "NodeIteration";
+  case TriangleCountPlan::kEdgeIteration:
+    return "EdgeIteration";
+  case TriangleCountPlan::kOrderedCount:
+    return "OrderedCount";
+  case TriangleCountPlan::kDegreeOrderedDag:
+    return "DegreeOrderedDag";
+  default:
+    return "Unknown";
+  }
+}
+
+TriangleCountPlan
+MakePlan() {
+  switch (algo) {
+  case TriangleCountPlan::kNodeIteration:
+    return TriangleCountPlan::NodeIteration();
+  case TriangleCountPlan::kEdgeIteration:
+    return TriangleCountPlan::EdgeIteration();
+  case TriangleCountPlan::kOrderedCount:
+    return TriangleCountPlan::OrderedCount();
+  case TriangleCountPlan::kDegreeOrderedDag:
+  default:
+    return TriangleCountPlan::DegreeOrderedDag();
+  }
+}
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<galois::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  galois::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  if (!symmetricGraph) {
+    GALOIS_DIE(
+        "This application requires a symmetric graph input;"
+        " please use the -symmetricGraph flag "
+        " to indicate the input is a symmetric graph.");
+  }
+
+  galois::StatTimer timer_graph_read("GraphReadingTime");
+  galois::StatTimer timer_auto_algo("AutoAlgo_0");
+
+  timer_graph_read.start();
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<galois::graphs::PropertyFileGraph> pfg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  if (approximateSamples > 0) {
+    std::cout << "Read " << pfg->topology().num_nodes() << " nodes, "
+              << pfg->topology().num_edges() << " edges\n";
+    timer_graph_read.stop();
+
+    auto estimate =
+        EstimateTriangleCount(pfg.get(), approximateSamples, confidence);
+    if (!estimate) {
+      std::cerr << estimate.error().message() << "\n";
+      abort();
+    }
+    std::cout << "Estimated Triangles: " << estimate.value().estimate << " ["
+              << estimate.value().lower_bound << ", "
+              << estimate.value().upper_bound << "] with confidence "
+              << confidence << "\n";
+
+    totalTime.stop();
+    return 0;
+  }
+
+  TriangleCountPlan plan = MakePlan();
+
+  // The degree ordered DAG orders nodes by degree itself; the other
+  // algorithms need sorted edges and benefit from relabeling
+  if (plan.algorithm() != TriangleCountPlan::kDegreeOrderedDag) {
+    if (!relabel) {
+      auto pg_result =
+          galois::graphs::PropertyGraph<std::tuple<>, std::tuple<>>::Make(
+              pfg.get(), {}, {});
+      if (!pg_result) {
+        GALOIS_LOG_FATAL(
+            "could not make property graph: {}", pg_result.error());
+      }
+      timer_auto_algo.start();
+      relabel = isApproximateDegreeDistributionPowerLaw(pg_result.value());
+      timer_auto_algo.stop();
+    }
+
+    if (relabel) {
+      galois::gInfo("Relabeling and sorting graph...");
+      galois::StatTimer timer_relabel("GraphRelabelTimer");
+      timer_relabel.start();
+      if (auto r = galois::graphs::SortNodesByDegree(pfg.get()); !r) {
+        GALOIS_LOG_FATAL(
+            "Relabeling and sorting by node degree failed: {}", r.error());
+      }
+      timer_relabel.stop();
+    }
+
+    if (auto r = galois::graphs::SortAllEdgesByDest(pfg.get()); !r) {
+      GALOIS_LOG_FATAL("Sorting edge destination failed: {}", r.error());
+    }
+  }
+
+  std::cout << "Read " << pfg->topology().num_nodes() << " nodes, "
+            << pfg->topology().num_edges() << " edges\n";
+
+  timer_graph_read.stop();
+
+  std::cout << "Running " << AlgorithmName(plan.algorithm()) << "\n";
+
+  galois::reportPageAlloc("MeminfoPre");
+
+  galois::Result<uint64_t> num_triangles =
+      output ? TriangleCount(pfg.get(), "triangles", plan)
+             : TriangleCount(pfg.get(), plan);
+  if (!num_triangles) {
+    std::cerr << num_triangles.error().message() << "\n";
+    abort();
+  }
+
+  galois::reportPageAlloc("MeminfoPost");
+
+  std::cout << "Num Triangles: " << num_triangles.value() << "\n";
+
+  if (output) {
+    using Graph = galois::graphs::PropertyGraph<
+        std::tuple<TriangleCountNodeCount>, std::tuple<>>;
+    auto pg_result = Graph::Make(pfg.get(), {"triangles"}, {});
+    if (!pg_result) {
+      std::cerr << pg_result.error().message() << "\n";
+      abort();
+    }
+    Graph graph = pg_result.value();
+
+    std::vector<uint64_t> results;
+    results.reserve(graph.num_nodes());
+    for (auto node : graph) {
+      results.push_back(graph.GetData<TriangleCountNodeCount>(node));
+    }
+
+    writeOutput(outputLocation, results.data(), results.size());
+  }
+
+  totalTime.stop();
+
+  return 0;
+}
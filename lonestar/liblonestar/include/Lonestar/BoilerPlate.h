@@ -20,6 +20,10 @@
 #ifndef LONESTAR_BOILERPLATE_H
 #define LONESTAR_BOILERPLATE_H
 
+#include <functional>
+#include <string>
+#include <vector>
+
 #include "Lonestar/Utils.h"
 #include "galois/Galois.h"
 #include "galois/SharedMemSys.h"
@@ -39,10 +43,29 @@ extern llvm::cl::opt<std::string> edge_property_name;
 //! Where to write output if output is set
 extern llvm::cl::opt<std::string> outputLocation;
 extern llvm::cl::opt<bool> output;
+//! Number of times LonestarRun runs the computation
+extern llvm::cl::opt<unsigned> benchmarkRuns;
+//! Whether LonestarCommit writes the output properties back to the input
+extern llvm::cl::opt<bool> commitOutput;
 
 //! initialize lonestar benchmark
 std::unique_ptr<galois::SharedMemSys> LonestarStart(
     int argc, char** argv, const char* app, const char* desc, const char* url,
     llvm::cl::opt<std::string>* input);
 std::unique_ptr<galois::SharedMemSys> LonestarStart(int argc, char** argv);
+
+//! Run compute, which adds the output properties of the benchmark to pfg,
+//! -runs times, timing each run with a StatTimer named Run<i> and reporting
+//! the fastest and mean times as RunTimeMin and RunTimeMean. Before each run
+//! but the first, the output properties named by node_outputs and
+//! edge_outputs are removed again.
+void LonestarRun(
+    galois::graphs::PropertyFileGraph* pfg,
+    const std::vector<std::string>& node_outputs,
+    const std::vector<std::string>& edge_outputs,
+    const std::function<void()>& compute);
+
+//! With -commit, commit the properties added to pfg to the RDG it was loaded
+//! from, recording the command line of the benchmark
+void LonestarCommit(galois::graphs::PropertyFileGraph* pfg);
 #endif
@@ -20,49 +20,168 @@
 #ifndef LONESTAR_UTILS_H
 #define LONESTAR_UTILS_H
 
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <type_traits>
 #include <vector>
 
-#include <boost/filesystem.hpp>
+#include <arrow/api.h>
 
+#include "galois/Galois.h"
 #include "galois/analytics/Utils.h"
 #include "galois/graphs/PropertyGraph.h"
+#include "llvm/Support/CommandLine.h"
 
+//! Whether MakeFileGraph copies the graph to the NUMA nodes of the threads
+//! that use it (defined with the other options of BoilerPlate.h)
+extern llvm::cl::opt<bool> numaDistribute;
+//! Whether numaDistribute interleaves the pages of the graph rather than
+//! blocking them by thread
+extern llvm::cl::opt<bool> numaInterleave;
+//! Properties MakeFileGraph loads besides the ones the application reads
+extern llvm::cl::list<std::string> nodePropertyNames;
+extern llvm::cl::list<std::string> edgePropertyNames;
+
+enum OutputFormat { kOutputText, kOutputBinary, kOutputParquet };
+//! How writeOutput writes its values
+extern llvm::cl::opt<OutputFormat> outputFormat;
+
+//! Load the RDG rdg_name with only the given properties, the ones the
+//! application reads, and those of -nodeProperties and -edgeProperties
 inline std::unique_ptr<galois::graphs::PropertyFileGraph>
 MakeFileGraph(
-    const std::string& rdg_name, const std::string& edge_property_name) {
-  std::vector<std::string> edge_properties;
-  std::vector<std::string> node_properties;
-  if (!edge_property_name.empty())
-    edge_properties.emplace_back(edge_property_name);
+    const std::string& rdg_name, std::vector<std::string> node_properties,
+    std::vector<std::string> edge_properties) {
+  auto add_properties = [](std::vector<std::string>* properties,
+                           const llvm::cl::list<std::string>& extra) {
+    for (const std::string& name : extra) {
+      if (std::find(properties->begin(), properties->end(), name) ==
+          properties->end()) {
+        properties->emplace_back(name);
+      }
+    }
+  };
+  add_properties(&node_properties, nodePropertyNames);
+  add_properties(&edge_properties, edgePropertyNames);
 
   auto pfg_result = galois::graphs::PropertyFileGraph::Make(
       rdg_name, node_properties, edge_properties);
   if (!pfg_result) {
     GALOIS_LOG_FATAL("cannot make graph: {}", pfg_result.error());
   }
+  if (numaDistribute) {
+    auto policy = numaInterleave ? galois::graphs::NumaPolicy::kInterleaved
+                                 : galois::graphs::NumaPolicy::kBlocked;
+    if (auto res = pfg_result.value()->DistributeToNumaNodes(policy); !res) {
+      GALOIS_LOG_FATAL("cannot distribute graph: {}", res.error());
+    }
+  }
   return std::move(pfg_result.value());
 }
 
+inline std::unique_ptr<galois::graphs::PropertyFileGraph>
+MakeFileGraph(
+    const std::string& rdg_name, const std::string& edge_property_name) {
+  std::vector<std::string> edge_properties;
+  if (!edge_property_name.empty()) {
+    edge_properties.emplace_back(edge_property_name);
+  }
+  return MakeFileGraph(rdg_name, {}, std::move(edge_properties));
+}
+
+//! Store size bytes of data in the file filename of outputDir, which may be
+//! any URI tsuba can store to
+void StoreOutput(
+    const std::string& outputDir, const std::string& filename,
+    const uint8_t* data, uint64_t size);
+
+//! Store values as the single column "value" of a parquet file
+//! output.parquet in outputDir
+void StoreParquetOutput(
+    const std::string& outputDir, const std::shared_ptr<arrow::Array>& values);
+
+namespace lonestar::internal {
+
+//! Append a line "<index> <value>\n" to out, printing value as an
+//! std::ostream would by default
 template <typename T>
 void
-writeOutput(const std::string& outputDir, T* values, size_t length) {
-  namespace fs = boost::filesystem;
-  fs::path filename{outputDir};
-  filename = filename.append("output");
+AppendTextLine(std::string* out, size_t index, T value) {
+  char line[64];
+  char* end = std::to_chars(line, line + sizeof(line), index).ptr;
+  *end++ = ' ';
+  if constexpr (std::is_floating_point_v<T>) {
+    end += std::snprintf(
+        end, line + sizeof(line) - end, "%g", static_cast<double>(value));
+  } else if constexpr (std::is_same_v<T, bool>) {
+    *end++ = value ? '1' : '0';
+  } else {
+    end = std::to_chars(end, line + sizeof(line), +value).ptr;
+  }
+  *end++ = '\n';
+  out->append(line, end);
+}
 
-  std::ofstream outputFile(filename.string().c_str());
+}  // namespace lonestar::internal
 
-  if (!outputFile) {
-    GALOIS_LOG_FATAL("could not open file: {}", filename);
+//! Write the values of nodes 0 to length - 1 to outputDir in the format of
+//! -outputFormat: text lines "<node> <value>" in the file output, the raw
+//! values in output.bin, or a parquet column in output.parquet. Text is
+//! formatted in parallel chunks; the file is then stored with tsuba.
+template <typename T>
+void
+writeOutput(const std::string& outputDir, T* values, size_t length) {
+  switch (outputFormat) {
+  case kOutputBinary:
+    StoreOutput(
+        outputDir, "output.bin", reinterpret_cast<const uint8_t*>(values),
+        length * sizeof(T));
+    return;
+  case kOutputParquet: {
+    using ArrowType = typename arrow::CTypeTraits<T>::ArrowType;
+    auto array = std::make_shared<arrow::NumericArray<ArrowType>>(
+        length, arrow::Buffer::Wrap(values, length));
+    StoreParquetOutput(outputDir, array);
+    return;
   }
-
-  for (size_t i = 0; i < length; i++) {
-    outputFile << i << " " << *(values++) << "\n";
+  case kOutputText:
+  default:
+    break;
   }
 
-  if (!outputFile) {
-    GALOIS_LOG_FATAL("failed to write file: {}", filename);
+  constexpr size_t kLinesPerChunk = 1 << 16;
+  size_t num_chunks = (length + kLinesPerChunk - 1) / kLinesPerChunk;
+  std::vector<std::string> chunks(num_chunks);
+  galois::do_all(
+      galois::iterate(size_t{0}, num_chunks),
+      [&](size_t chunk) {
+        size_t begin = chunk * kLinesPerChunk;
+        size_t end = std::min(length, begin + kLinesPerChunk);
+        for (size_t i = begin; i < end; ++i) {
+          lonestar::internal::AppendTextLine(&chunks[chunk], i, values[i]);
+        }
+      },
+      galois::steal(), galois::no_stats());
+
+  std::vector<size_t> offsets(num_chunks + 1, 0);
+  for (size_t chunk = 0; chunk < num_chunks; ++chunk) {
+    offsets[chunk + 1] = offsets[chunk] + chunks[chunk].size();
   }
+  std::vector<uint8_t> text(offsets[num_chunks]);
+  galois::do_all(
+      galois::iterate(size_t{0}, num_chunks),
+      [&](size_t chunk) {
+        std::copy(
+            chunks[chunk].begin(), chunks[chunk].end(),
+            text.begin() + offsets[chunk]);
+        std::string().swap(chunks[chunk]);
+      },
+      galois::no_stats());
+
+  StoreOutput(outputDir, "output", text.data(), text.size());
 }
 
 #endif
@@ -19,6 +19,8 @@
 
 #include "Lonestar/BoilerPlate.h"
 
+#include <algorithm>
+#include <limits>
 #include <sstream>
 
 #include "galois/SharedMemSys.h"
@@ -56,6 +58,56 @@ llvm::cl::opt<bool> output(
     "output", llvm::cl::desc("Write result (default false)"),
     llvm::cl::init(false));
 
+llvm::cl::opt<OutputFormat> outputFormat(
+    "outputFormat",
+    llvm::cl::desc("Format of the result with -output (default text):"),
+    llvm::cl::values(
+        clEnumValN(kOutputText, "text", "Lines of node and value"),
+        clEnumValN(kOutputBinary, "binary", "Raw values in node order"),
+        clEnumValN(kOutputParquet, "parquet", "A parquet column of values")),
+    llvm::cl::init(kOutputText));
+
+llvm::cl::opt<bool> numaDistribute(
+    "numaDistribute",
+    llvm::cl::desc(
+        "Copy the loaded graph to the NUMA nodes of the threads that use it "
+        "(default false)"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<bool> numaInterleave(
+    "numaInterleave",
+    llvm::cl::desc(
+        "With -numaDistribute, spread the pages of the graph evenly over the "
+        "NUMA nodes instead of giving each thread its block of nodes "
+        "(default false)"),
+    llvm::cl::init(false));
+
+llvm::cl::list<std::string> nodePropertyNames(
+    "nodeProperties", llvm::cl::CommaSeparated,
+    llvm::cl::desc(
+        "Node properties to load besides those the application reads "
+        "(default none)"));
+
+llvm::cl::list<std::string> edgePropertyNames(
+    "edgeProperties", llvm::cl::CommaSeparated,
+    llvm::cl::desc(
+        "Edge properties to load besides those the application reads "
+        "(default none)"));
+
+llvm::cl::opt<unsigned> benchmarkRuns(
+    "runs",
+    llvm::cl::desc("Number of times to run the computation (default value 1)"),
+    llvm::cl::init(1));
+
+llvm::cl::opt<bool> commitOutput(
+    "commit",
+    llvm::cl::desc(
+        "Commit the output properties to the input graph (default false)"),
+    llvm::cl::init(false));
+
+//! The command line of the benchmark, recorded in committed graphs
+static std::string lonestar_command_line;
+
 static void
 LonestarPrintVersion(llvm::raw_ostream& out) {
   out << "LoneStar Benchmark Suite v" << galois::getVersion() << " ("
@@ -106,7 +158,8 @@ LonestarStart(
     }
   }
 
-  galois::ReportParam("(NULL)", "CommandLine", cmdout.str());
+  lonestar_command_line = cmdout.str();
+  galois::ReportParam("(NULL)", "CommandLine", lonestar_command_line);
   galois::ReportParam("(NULL)", "Threads", numThreads);
   galois::ReportParam("(NULL)", "Hosts", 1);
   if (input) {
@@ -118,3 +171,57 @@ LonestarStart(
   galois::ReportParam("(NULL)", "Hostname", name);
   return shared_mem_sys;
 }
+
+void
+LonestarRun(
+    galois::graphs::PropertyFileGraph* pfg,
+    const std::vector<std::string>& node_outputs,
+    const std::vector<std::string>& edge_outputs,
+    const std::function<void()>& compute) {
+  if (benchmarkRuns == 0) {
+    GALOIS_LOG_FATAL("-runs must be at least 1");
+  }
+
+  uint64_t min_usec = std::numeric_limits<uint64_t>::max();
+  uint64_t total_usec = 0;
+  for (unsigned run = 0; run < benchmarkRuns; ++run) {
+    if (run > 0) {
+      for (const std::string& name : node_outputs) {
+        if (auto res = pfg->RemoveNodeProperty(name); !res) {
+          GALOIS_LOG_FATAL(
+              "cannot remove node property {}: {}", name, res.error());
+        }
+      }
+      for (const std::string& name : edge_outputs) {
+        if (auto res = pfg->RemoveEdgeProperty(name); !res) {
+          GALOIS_LOG_FATAL(
+              "cannot remove edge property {}: {}", name, res.error());
+        }
+      }
+    }
+
+    std::string timer_name = "Run" + std::to_string(run);
+    galois::StatTimer timer(timer_name.c_str());
+    timer.start();
+    compute();
+    timer.stop();
+
+    uint64_t usec = timer.get_usec();
+    min_usec = std::min(min_usec, usec);
+    total_usec += usec;
+  }
+
+  galois::ReportStatSingle("(NULL)", "RunTimeMin", min_usec);
+  galois::ReportStatSingle(
+      "(NULL)", "RunTimeMean", total_usec / benchmarkRuns);
+}
+
+void
+LonestarCommit(galois::graphs::PropertyFileGraph* pfg) {
+  if (!commitOutput) {
+    return;
+  }
+  if (auto res = pfg->Commit(lonestar_command_line); !res) {
+    GALOIS_LOG_FATAL("cannot commit graph: {}", res.error());
+  }
+}
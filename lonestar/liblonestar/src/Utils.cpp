@@ -0,0 +1,62 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "Lonestar/Utils.h"
+
+#include <limits>
+
+#include <parquet/arrow/writer.h>
+
+#include "galois/Logging.h"
+#include "galois/Uri.h"
+#include "tsuba/FileFrame.h"
+#include "tsuba/file.h"
+
+void
+StoreOutput(
+    const std::string& outputDir, const std::string& filename,
+    const uint8_t* data, uint64_t size) {
+  std::string path = galois::Uri::JoinPath(outputDir, filename);
+  if (auto res = tsuba::FileStoreAsync(path, data, size).get(); !res) {
+    GALOIS_LOG_FATAL("failed to write file: {}: {}", path, res.error());
+  }
+}
+
+void
+StoreParquetOutput(
+    const std::string& outputDir, const std::shared_ptr<arrow::Array>& values) {
+  std::string path = galois::Uri::JoinPath(outputDir, "output.parquet");
+  std::shared_ptr<arrow::Table> table = arrow::Table::Make(
+      arrow::schema({arrow::field("value", values->type())}), {values});
+
+  auto ff = std::make_shared<tsuba::FileFrame>();
+  if (auto res = ff->Init(); !res) {
+    GALOIS_LOG_FATAL("failed to write file: {}: {}", path, res.error());
+  }
+  if (auto status = parquet::arrow::WriteTable(
+          *table, arrow::default_memory_pool(), ff,
+          std::numeric_limits<int64_t>::max());
+      !status.ok()) {
+    GALOIS_LOG_FATAL("failed to write file: {}: {}", path, status);
+  }
+  ff->Bind(path);
+  if (auto res = ff->PersistAsync().get(); !res) {
+    GALOIS_LOG_FATAL("failed to write file: {}: {}", path, res.error());
+  }
+}
@@ -1,2 +1,17 @@
-from galois.analytics._wrappers import bfs, BfsPlan
-from galois.analytics._wrappers import sssp, SsspPlan
+from galois.analytics._wrappers import AnalyticsCall
+from galois.analytics._wrappers import bfs, bfs_async, BfsPlan
+from galois.analytics._wrappers import multi_source_bfs, multi_source_reachability, multi_source_bfs_batch_size
+from galois.analytics._wrappers import sssp, sssp_async, sssp_point_to_point, SsspPlan
+from galois.analytics._wrappers import sssp_landmarks, sssp_point_to_point_landmarks, SsspLandmarkSelection
+from galois.analytics._wrappers import pagerank, personalized_pagerank, PagerankPlan
+from galois.analytics._wrappers import connected_components, connected_components_incremental, ConnectedComponentsPlan
+from galois.analytics._wrappers import jaccard, top_k_similar_nodes, Similarity, JaccardPlan
+from galois.analytics._wrappers import k_core, KCorePlan
+from galois.analytics._wrappers import k_truss, KTrussPlan
+from galois.analytics._wrappers import independent_set, IndependentSetPlan
+from galois.analytics._wrappers import graph_coloring, GraphColoringPlan
+from galois.analytics._wrappers import minimum_spanning_forest, MinimumSpanningForestPlan
+from galois.analytics._wrappers import bipartite_matching, BipartiteMatchingPlan
+from galois.analytics._wrappers import random_walks, RandomWalksPlan
+from galois.analytics._wrappers import triangle_count, local_clustering_coefficient, estimate_triangle_count, TriangleCountPlan
+from galois.analytics._wrappers import partition_quality
@@ -1,9 +1,17 @@
-from galois.cpp.libstd.boost cimport std_result, handle_result_void
+from galois.cpp.libstd.boost cimport std_result, handle_result_void, raise_error_code
+from cython.operator cimport dereference as deref
 from libc.stddef cimport ptrdiff_t
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp cimport bool
+from libcpp.memory cimport shared_ptr, unique_ptr
+from libcpp.pair cimport pair
 from libcpp.string cimport string
+from libcpp.vector cimport vector
 from galois.cpp.libgalois.graphs.Graph cimport PropertyFileGraph
 from galois.property_graph cimport PropertyGraph
+from pyarrow.lib cimport CTable, pyarrow_wrap_table
 
+import asyncio
 from enum import Enum
 
 cdef extern from "galois/Analytics.h" namespace "galois::analytics" nogil:
@@ -15,6 +23,108 @@ cdef extern from "galois/Analytics.h" namespace "galois::analytics" nogil:
     cppclass Plan:
         Architecture architecture() const
 
+# Asynchronous calls
+
+cdef extern from "galois/analytics/Async.h" namespace "galois::analytics" nogil:
+    cppclass AsyncResult[T]:
+        AsyncResult(AsyncResult[T])
+        bool Ready()
+        std_result[T] Wait()
+        void Cancel()
+        uint64_t rounds()
+        uint64_t work_items()
+
+
+cdef class AnalyticsCall:
+    """
+    A handle to an analytics call running on its own thread, returned by the ``*_async`` functions.
+
+    The call uses the thread pool, so no other parallel loop may run until it finishes. The graph must not be used
+    until then either. Awaiting the handle waits for the call without blocking the event loop:
+
+    >>> call = sssp_async(graph, 0, "weight", "distance")
+    >>> await call
+    """
+    cdef:
+        unique_ptr[AsyncResult[void]] underlying
+        PropertyGraph graph
+        object error
+        bint done
+
+    def __init__(self):
+        raise TypeError("AnalyticsCall cannot be created from Python.")
+
+    @staticmethod
+    cdef AnalyticsCall make(AsyncResult[void]* u, PropertyGraph graph):
+        f = <AnalyticsCall>AnalyticsCall.__new__(AnalyticsCall)
+        f.underlying.reset(u)
+        # keep the graph alive until the call finishes
+        f.graph = graph
+        return f
+
+    def __dealloc__(self):
+        # the destructor waits for the call to finish
+        with nogil:
+            self.underlying.reset()
+
+    def ready(self):
+        """Return True if the call finished, so that `wait` will not block."""
+        return self.done or self.underlying.get().Ready()
+
+    def wait(self):
+        """Wait for the call to finish without holding the GIL; raise its error, if any."""
+        cdef std_result[void] res
+        if not self.done:
+            with nogil:
+                res = self.underlying.get().Wait()
+            self.done = True
+            if not res.has_value():
+                try:
+                    raise_error_code(res.error())
+                except Exception as e:
+                    self.error = e
+        if self.error is not None:
+            raise self.error
+
+    def cancel(self):
+        """Ask the call to stop after its current round; the output of a cancelled call is incomplete."""
+        self.underlying.get().Cancel()
+
+    @property
+    def rounds(self):
+        """The number of rounds (e.g., BFS levels) that the call finished so far."""
+        return self.underlying.get().rounds()
+
+    @property
+    def work_items(self):
+        """The number of work items (e.g., frontier nodes) of the rounds finished so far."""
+        return self.underlying.get().work_items()
+
+    async def result(self, poll_interval = 0.01):
+        """Wait for the call to finish without blocking the event loop, polling every poll_interval seconds."""
+        while not self.ready():
+            await asyncio.sleep(poll_interval)
+        self.wait()
+
+    def __await__(self):
+        return self.result().__await__()
+
+# Traversal filters
+
+cdef extern from "galois/analytics/TraversalFilter.h" namespace "galois::analytics" nogil:
+    cppclass TraversalFilter:
+        vector[string] edge_types
+        vector[string] node_labels
+
+
+cdef TraversalFilter make_traversal_filter(edge_types, node_labels):
+    cdef TraversalFilter f
+    for t in edge_types or ():
+        f.edge_types.push_back(bytes(t, "utf-8"))
+    for l in node_labels or ():
+        f.node_labels.push_back(bytes(l, "utf-8"))
+    return f
+
 # BFS
 
 cdef extern from "galois/Analytics.h" namespace "galois::analytics" nogil:
@@ -24,9 +134,15 @@ cdef extern from "galois/Analytics.h" namespace "galois::analytics" nogil:
             kAsync "galois::analytics::BfsPlan::kAsync"
             kSyncTile "galois::analytics::BfsPlan::kSyncTile"
             kSync "galois::analytics::BfsPlan::kSync"
+            kSyncDirectionOpt "galois::analytics::BfsPlan::kSyncDirectionOpt"
 
         _BfsPlan.Algorithm algorithm() const
         ptrdiff_t edge_tile_size() const
+        uint32_t alpha() const
+        uint32_t beta() const
+        uint32_t dense_frontier_divisor() const
+        unsigned relaxation() const
+        _BfsPlan WithFilter(TraversalFilter filter) const
 
         @staticmethod
         _BfsPlan AsyncTile()
@@ -43,6 +159,11 @@ cdef extern from "galois/Analytics.h" namespace "galois::analytics" nogil:
 
         @staticmethod
         _BfsPlan Sync()
+        @staticmethod
+        _BfsPlan Sync_1 "Sync"(uint32_t dense_frontier_divisor)
+
+        @staticmethod
+        _BfsPlan SyncDirectionOpt(uint32_t alpha, uint32_t beta)
 
         @staticmethod
         _BfsPlan Automatic()
@@ -55,11 +176,27 @@ cdef extern from "galois/Analytics.h" namespace "galois::analytics" nogil:
                          string output_property_name,
                          _BfsPlan algo)
 
+    AsyncResult[void] BfsAsync(PropertyFileGraph * pfg,
+                               size_t start_node,
+                               string output_property_name,
+                               _BfsPlan algo)
+
+    std_result[void] MultiSourceBfs(PropertyFileGraph * pfg,
+                                    const vector[uint32_t]& sources,
+                                    const vector[string]& output_property_names)
+
+    std_result[void] MultiSourceReachability(PropertyFileGraph * pfg,
+                                             const vector[uint32_t]& sources,
+                                             const vector[string]& output_property_names)
+
+    size_t kMultiSourceBfsBatchSize
+
 class _BfsAlgorithm(Enum):
     AsyncTile = _BfsPlan.Algorithm.kAsyncTile
     Async = _BfsPlan.Algorithm.kAsync
     SyncTile = _BfsPlan.Algorithm.kSyncTile
     Sync = _BfsPlan.Algorithm.kSync
+    SyncDirectionOpt = _BfsPlan.Algorithm.kSyncDirectionOpt
 
 
 cdef class BfsPlan:
@@ -82,6 +219,22 @@ cdef class BfsPlan:
     def edge_tile_size(self) -> int:
         return self.underlying.edge_tile_size()
 
+    @property
+    def alpha(self) -> int:
+        return self.underlying.alpha()
+
+    @property
+    def beta(self) -> int:
+        return self.underlying.beta()
+
+    @property
+    def dense_frontier_divisor(self) -> int:
+        return self.underlying.dense_frontier_divisor()
+
+    @property
+    def relaxation(self) -> int:
+        return self.underlying.relaxation()
+
     @staticmethod
     def async_tile(edge_tile_size=None):
         if edge_tile_size is not None:
@@ -99,9 +252,15 @@ cdef class BfsPlan:
         return BfsPlan.make(_BfsPlan.SyncTile())
 
     @staticmethod
-    def sync():
+    def sync(dense_frontier_divisor=None):
+        if dense_frontier_divisor is not None:
+            return BfsPlan.make(_BfsPlan.Sync_1(dense_frontier_divisor))
         return BfsPlan.make(_BfsPlan.Sync())
 
+    @staticmethod
+    def sync_direction_opt(alpha=15, beta=18):
+        return BfsPlan.make(_BfsPlan.SyncDirectionOpt(alpha, beta))
+
     @staticmethod
     def automatic():
         return BfsPlan.make(_BfsPlan.Automatic())
@@ -110,6 +269,13 @@ cdef class BfsPlan:
     def from_algorithm(algorithm):
         return BfsPlan.make(_BfsPlan.FromAlgorithm(int(algorithm)))
 
+    def with_filter(self, edge_types=None, node_labels=None):
+        """
+        Return this plan restricted to the edges with one of edge_types between the nodes with one of node_labels.
+        Types and labels are boolean properties; None or empty keeps all edges or nodes.
+        """
+        return BfsPlan.make(self.underlying.WithFilter(make_traversal_filter(edge_types, node_labels)))
+
 
 def bfs(PropertyGraph pg, size_t start_node, str output_property_name, BfsPlan plan = BfsPlan.automatic()):
     output_property_name_bytes = bytes(output_property_name, "utf-8")
@@ -117,6 +283,34 @@ def bfs(PropertyGraph pg, size_t start_node, str output_property_name, BfsPlan p
     with nogil:
         handle_result_void(Bfs(pg.underlying.get(), start_node, output_property_name_cstr, plan.underlying))
 
+
+def bfs_async(PropertyGraph pg, size_t start_node, str output_property_name, BfsPlan plan = BfsPlan.automatic()):
+    """Start `bfs` on its own thread and return an `AnalyticsCall` for it at once."""
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    cdef AsyncResult[void]* call
+    with nogil:
+        call = new AsyncResult[void](BfsAsync(pg.underlying.get(), start_node, output_property_name_cstr,
+                                              plan.underlying))
+    return AnalyticsCall.make(call, pg)
+
+
+multi_source_bfs_batch_size = kMultiSourceBfsBatchSize
+
+
+def multi_source_bfs(PropertyGraph pg, sources, output_property_names):
+    cdef vector[uint32_t] sources_vec = sources
+    cdef vector[string] names_vec = [bytes(n, "utf-8") for n in output_property_names]
+    with nogil:
+        handle_result_void(MultiSourceBfs(pg.underlying.get(), sources_vec, names_vec))
+
+
+def multi_source_reachability(PropertyGraph pg, sources, output_property_names):
+    cdef vector[uint32_t] sources_vec = sources
+    cdef vector[string] names_vec = [bytes(n, "utf-8") for n in output_property_names]
+    with nogil:
+        handle_result_void(MultiSourceReachability(pg.underlying.get(), sources_vec, names_vec))
+
 # SSSP
 
 cdef extern from "galois/Analytics.h" namespace "galois::analytics" nogil:
@@ -131,11 +325,16 @@ cdef extern from "galois/Analytics.h" namespace "galois::analytics" nogil:
             kDijkstra "galois::analytics::SsspPlan::kDijkstra"
             kTopo "galois::analytics::SsspPlan::kTopo"
             kTopoTile "galois::analytics::SsspPlan::kTopoTile"
+            kDeltaStepFusion "galois::analytics::SsspPlan::kDeltaStepFusion"
+            kMultiQueue "galois::analytics::SsspPlan::kMultiQueue"
+            kDeltaStepPmod "galois::analytics::SsspPlan::kDeltaStepPmod"
             kAutomatic "galois::analytics::SsspPlan::kAutomatic"
 
         _SsspPlan.Algorithm algorithm() const
         unsigned delta() const
         ptrdiff_t edge_tile_size() const
+        uint32_t dense_frontier_divisor() const
+        _SsspPlan WithFilter(TraversalFilter filter) const
 
         @staticmethod
         _SsspPlan DeltaTile()
@@ -149,6 +348,18 @@ cdef extern from "galois/Analytics.h" namespace "galois::analytics" nogil:
         _SsspPlan DeltaStepBarrier()
         @staticmethod
         _SsspPlan DeltaStepBarrier_1 "DeltaStepBarrier"(unsigned delta)
+        @staticmethod
+        _SsspPlan DeltaStepFusion()
+        @staticmethod
+        _SsspPlan DeltaStepFusion_1 "DeltaStepFusion"(unsigned delta)
+        @staticmethod
+        _SsspPlan MultiQueue()
+        @staticmethod
+        _SsspPlan MultiQueue_1 "MultiQueue"(unsigned relaxation)
+        @staticmethod
+        _SsspPlan DeltaStepPmod()
+        @staticmethod
+        _SsspPlan DeltaStepPmod_1 "DeltaStepPmod"(unsigned delta)
 
         @staticmethod
         _SsspPlan SerialDeltaTile()
@@ -169,6 +380,8 @@ cdef extern from "galois/Analytics.h" namespace "galois::analytics" nogil:
 
         @staticmethod
         _SsspPlan Topo()
+        @staticmethod
+        _SsspPlan Topo_1 "Topo"(uint32_t dense_frontier_divisor)
 
         @staticmethod
         _SsspPlan TopoTile()
@@ -185,6 +398,23 @@ cdef extern from "galois/Analytics.h" namespace "galois::analytics" nogil:
         string edge_weight_property_name, string output_property_name,
         _SsspPlan plan)
 
+    AsyncResult[void] SsspAsync(PropertyFileGraph* pfg, size_t start_node,
+        string edge_weight_property_name, string output_property_name,
+        _SsspPlan plan)
+
+    std_result[double] SsspPointToPoint(PropertyFileGraph* pfg, size_t source, size_t target,
+        string edge_weight_property_name, bool bidirectional)
+
+    enum LandmarkSelection "galois::analytics::LandmarkSelection":
+        kFarthest "galois::analytics::LandmarkSelection::kFarthest"
+        kDegree "galois::analytics::LandmarkSelection::kDegree"
+
+    std_result[vector[uint32_t]] SsspLandmarks(PropertyFileGraph* pfg, string edge_weight_property_name,
+        uint32_t num_landmarks, string output_property_prefix, LandmarkSelection selection, _SsspPlan plan)
+
+    std_result[double] SsspPointToPointLandmarks(PropertyFileGraph* pfg, size_t source, size_t target,
+        string edge_weight_property_name, string landmark_property_prefix)
+
 
 class _SsspAlgorithm(Enum):
     DeltaTile = _SsspPlan.Algorithm.kDeltaTile
@@ -196,6 +426,9 @@ class _SsspAlgorithm(Enum):
     Dijkstra = _SsspPlan.Algorithm.kDijkstra
     Topo = _SsspPlan.Algorithm.kTopo
     TopoTile = _SsspPlan.Algorithm.kTopoTile
+    DeltaStepFusion = _SsspPlan.Algorithm.kDeltaStepFusion
+    MultiQueue = _SsspPlan.Algorithm.kMultiQueue
+    DeltaStepPmod = _SsspPlan.Algorithm.kDeltaStepPmod
     Automatic = _SsspPlan.Algorithm.kAutomatic
 
 
@@ -229,6 +462,10 @@ cdef class SsspPlan:
     def edge_tile_size(self) -> int:
         return self.underlying.edge_tile_size()
 
+    @property
+    def dense_frontier_divisor(self) -> int:
+        return self.underlying.dense_frontier_divisor()
+
     @staticmethod
     def delta_tile(delta=None, edge_tile_size=None):
         default = _SsspPlan.DeltaTile()
@@ -254,6 +491,27 @@ cdef class SsspPlan:
             return SsspPlan.make(_SsspPlan.DeltaStepBarrier())
         return SsspPlan.make(_SsspPlan.DeltaStepBarrier_1(delta))
 
+    @staticmethod
+    def delta_step_fusion(delta=None):
+        """Delta-stepping with bucket fusion; delta defaults to an estimate from the graph."""
+        if delta is None:
+            return SsspPlan.make(_SsspPlan.DeltaStepFusion())
+        return SsspPlan.make(_SsspPlan.DeltaStepFusion_1(delta))
+
+    @staticmethod
+    def delta_step_pmod(delta=None):
+        """Delta-stepping with buckets that merge and split at runtime; delta is the initial bucket width."""
+        if delta is None:
+            return SsspPlan.make(_SsspPlan.DeltaStepPmod())
+        return SsspPlan.make(_SsspPlan.DeltaStepPmod_1(delta))
+
+    @staticmethod
+    def multi_queue(relaxation=None):
+        """Asynchronous SSSP over a relaxed priority queue with relaxation heaps per thread."""
+        if relaxation is None:
+            return SsspPlan.make(_SsspPlan.MultiQueue())
+        return SsspPlan.make(_SsspPlan.MultiQueue_1(relaxation))
+
     @staticmethod
     def serial_delta_tile(delta=None, edge_tile_size=None):
         default = _SsspPlan.SerialDeltaTile()
@@ -284,8 +542,10 @@ cdef class SsspPlan:
         return SsspPlan.make(_SsspPlan.TopoTile_1(edge_tile_size))
 
     @staticmethod
-    def topo():
-        return SsspPlan.make(_SsspPlan.Topo())
+    def topo(dense_frontier_divisor=None):
+        if dense_frontier_divisor is None:
+            return SsspPlan.make(_SsspPlan.Topo())
+        return SsspPlan.make(_SsspPlan.Topo_1(dense_frontier_divisor))
 
     @staticmethod
     def automatic(graph = None):
@@ -293,6 +553,10 @@ cdef class SsspPlan:
             return SsspPlan.make(_SsspPlan.Automatic())
         return SsspPlan.make(_SsspPlan.Automatic_1((<PropertyGraph>graph).underlying.get()))
 
+    def with_filter(self, edge_types=None, node_labels=None):
+        """Return this plan restricted to the edges with one of edge_types between the nodes with one of node_labels."""
+        return SsspPlan.make(self.underlying.WithFilter(make_traversal_filter(edge_types, node_labels)))
+
 
 def sssp(PropertyGraph pg, size_t start_node, str edge_weight_property_name, str output_property_name,
          SsspPlan plan = SsspPlan.automatic()):
@@ -303,3 +567,1250 @@ def sssp(PropertyGraph pg, size_t start_node, str edge_weight_property_name, str
     with nogil:
         handle_result_void(Sssp(pg.underlying.get(), start_node, edge_weight_property_name_cstr,
                                 output_property_name_cstr, plan.underlying))
+
+
+def sssp_async(PropertyGraph pg, size_t start_node, str edge_weight_property_name, str output_property_name,
+               SsspPlan plan = SsspPlan.automatic()):
+    """Start `sssp` on its own thread and return an `AnalyticsCall` for it at once."""
+    edge_weight_property_name_bytes = bytes(edge_weight_property_name, "utf-8")
+    edge_weight_property_name_cstr = <string>edge_weight_property_name_bytes
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    cdef AsyncResult[void]* call
+    with nogil:
+        call = new AsyncResult[void](SsspAsync(pg.underlying.get(), start_node, edge_weight_property_name_cstr,
+                                               output_property_name_cstr, plan.underlying))
+    return AnalyticsCall.make(call, pg)
+
+
+cdef double handle_result_double(std_result[double] res) except *:
+    if not res.has_value():
+        raise_error_code(res.error())
+    return res.value()
+
+
+def sssp_point_to_point(PropertyGraph pg, size_t source, size_t target, str edge_weight_property_name,
+                        bool bidirectional = False):
+    """Return the length of a shortest path from source to target, or infinity if there is none."""
+    edge_weight_property_name_bytes = bytes(edge_weight_property_name, "utf-8")
+    edge_weight_property_name_cstr = <string>edge_weight_property_name_bytes
+    cdef std_result[double] res
+    with nogil:
+        res = SsspPointToPoint(pg.underlying.get(), source, target, edge_weight_property_name_cstr, bidirectional)
+    return handle_result_double(res)
+
+
+class SsspLandmarkSelection(Enum):
+    Farthest = LandmarkSelection.kFarthest
+    Degree = LandmarkSelection.kDegree
+
+
+def sssp_landmarks(PropertyGraph pg, str edge_weight_property_name, uint32_t num_landmarks,
+                   str output_property_prefix, selection = SsspLandmarkSelection.Farthest,
+                   SsspPlan plan = SsspPlan.automatic()):
+    """
+    Build a landmark index for `sssp_point_to_point_landmarks`: store the distances from each of num_landmarks
+    landmarks in the node properties output_property_prefix + "0", output_property_prefix + "1", and so on. Return
+    the landmarks.
+    """
+    edge_weight_property_name_bytes = bytes(edge_weight_property_name, "utf-8")
+    edge_weight_property_name_cstr = <string>edge_weight_property_name_bytes
+    output_property_prefix_bytes = bytes(output_property_prefix, "utf-8")
+    output_property_prefix_cstr = <string>output_property_prefix_bytes
+    cdef LandmarkSelection selection_value = selection.value
+    cdef std_result[vector[uint32_t]] res
+    with nogil:
+        res = SsspLandmarks(pg.underlying.get(), edge_weight_property_name_cstr, num_landmarks,
+                            output_property_prefix_cstr, selection_value, plan.underlying)
+    if not res.has_value():
+        raise_error_code(res.error())
+    return list(res.value())
+
+
+def sssp_point_to_point_landmarks(PropertyGraph pg, size_t source, size_t target, str edge_weight_property_name,
+                                  str landmark_property_prefix):
+    """
+    Like `sssp_point_to_point`, but guided by the landmark index built by `sssp_landmarks` with
+    landmark_property_prefix.
+    """
+    edge_weight_property_name_bytes = bytes(edge_weight_property_name, "utf-8")
+    edge_weight_property_name_cstr = <string>edge_weight_property_name_bytes
+    landmark_property_prefix_bytes = bytes(landmark_property_prefix, "utf-8")
+    landmark_property_prefix_cstr = <string>landmark_property_prefix_bytes
+    cdef std_result[double] res
+    with nogil:
+        res = SsspPointToPointLandmarks(pg.underlying.get(), source, target, edge_weight_property_name_cstr,
+                                        landmark_property_prefix_cstr)
+    return handle_result_double(res)
+
+# PageRank
+
+cdef extern from "galois/Analytics.h" namespace "galois::analytics" nogil:
+    cppclass _PagerankPlan "galois::analytics::PagerankPlan":
+        enum Algorithm:
+            kPullTopological "galois::analytics::PagerankPlan::kPullTopological"
+            kPullResidual "galois::analytics::PagerankPlan::kPullResidual"
+            kPushAsynchronous "galois::analytics::PagerankPlan::kPushAsynchronous"
+            kPushSynchronous "galois::analytics::PagerankPlan::kPushSynchronous"
+            kPropagationBlocking "galois::analytics::PagerankPlan::kPropagationBlocking"
+
+        _PagerankPlan.Algorithm algorithm() const
+        float tolerance() const
+        uint32_t max_iterations() const
+        float alpha() const
+        uint32_t bin_shift() const
+
+        @staticmethod
+        _PagerankPlan PullTopological(float tolerance, uint32_t max_iterations, float alpha)
+
+        @staticmethod
+        _PagerankPlan PullResidual(float tolerance, uint32_t max_iterations, float alpha)
+
+        @staticmethod
+        _PagerankPlan PushAsynchronous(float tolerance, float alpha)
+
+        @staticmethod
+        _PagerankPlan PushSynchronous(float tolerance, uint32_t max_iterations, float alpha)
+
+        @staticmethod
+        _PagerankPlan PropagationBlocking(float tolerance, uint32_t max_iterations, float alpha,
+                                          uint32_t bin_shift)
+
+        @staticmethod
+        _PagerankPlan Automatic()
+
+    float kDefaultTolerance "galois::analytics::PagerankPlan::kDefaultTolerance"
+    uint32_t kDefaultMaxIterations "galois::analytics::PagerankPlan::kDefaultMaxIterations"
+    float kDefaultAlpha "galois::analytics::PagerankPlan::kDefaultAlpha"
+    uint32_t kDefaultBinShift "galois::analytics::PagerankPlan::kDefaultBinShift"
+
+    std_result[void] Pagerank(PropertyFileGraph* pfg, string output_property_name, _PagerankPlan plan)
+
+    cppclass TopKPersonalizedPagerank:
+        vector[uint64_t] offsets
+        vector[uint32_t] nodes
+        vector[double] ranks
+
+    std_result[TopKPersonalizedPagerank] PersonalizedPagerank(PropertyFileGraph* pfg, const vector[uint32_t]& seeds,
+                                                              uint32_t k, double epsilon, float alpha)
+
+
+class _PagerankAlgorithm(Enum):
+    PullTopological = _PagerankPlan.Algorithm.kPullTopological
+    PullResidual = _PagerankPlan.Algorithm.kPullResidual
+    PushAsynchronous = _PagerankPlan.Algorithm.kPushAsynchronous
+    PushSynchronous = _PagerankPlan.Algorithm.kPushSynchronous
+    PropagationBlocking = _PagerankPlan.Algorithm.kPropagationBlocking
+
+
+cdef class PagerankPlan:
+    cdef:
+        _PagerankPlan underlying
+
+    @staticmethod
+    cdef PagerankPlan make(_PagerankPlan u):
+        f = <PagerankPlan>PagerankPlan.__new__(PagerankPlan)
+        f.underlying = u
+        return f
+
+    Algorithm = _PagerankAlgorithm
+
+    @property
+    def algorithm(self) -> _PagerankAlgorithm:
+        return _PagerankAlgorithm(self.underlying.algorithm())
+
+    @property
+    def tolerance(self) -> float:
+        return self.underlying.tolerance()
+
+    @property
+    def max_iterations(self) -> int:
+        return self.underlying.max_iterations()
+
+    @property
+    def alpha(self) -> float:
+        return self.underlying.alpha()
+
+    @property
+    def bin_shift(self) -> int:
+        return self.underlying.bin_shift()
+
+    @staticmethod
+    def pull_topological(tolerance=None, max_iterations=None, alpha=None):
+        return PagerankPlan.make(
+            _PagerankPlan.PullTopological(default_value(tolerance, kDefaultTolerance),
+                                          default_value(max_iterations, kDefaultMaxIterations),
+                                          default_value(alpha, kDefaultAlpha)))
+
+    @staticmethod
+    def pull_residual(tolerance=None, max_iterations=None, alpha=None):
+        return PagerankPlan.make(
+            _PagerankPlan.PullResidual(default_value(tolerance, kDefaultTolerance),
+                                       default_value(max_iterations, kDefaultMaxIterations),
+                                       default_value(alpha, kDefaultAlpha)))
+
+    @staticmethod
+    def push_asynchronous(tolerance=None, alpha=None):
+        return PagerankPlan.make(
+            _PagerankPlan.PushAsynchronous(default_value(tolerance, kDefaultTolerance),
+                                           default_value(alpha, kDefaultAlpha)))
+
+    @staticmethod
+    def push_synchronous(tolerance=None, max_iterations=None, alpha=None):
+        """Delta-based PageRank: only nodes whose residual exceeds the tolerance push each round."""
+        return PagerankPlan.make(
+            _PagerankPlan.PushSynchronous(default_value(tolerance, kDefaultTolerance),
+                                          default_value(max_iterations, kDefaultMaxIterations),
+                                          default_value(alpha, kDefaultAlpha)))
+
+    @staticmethod
+    def propagation_blocking(tolerance=None, max_iterations=None, alpha=None, bin_shift=None):
+        """Pull-topological with edges binned by destination so that each bin's partial sums fit in cache."""
+        return PagerankPlan.make(
+            _PagerankPlan.PropagationBlocking(default_value(tolerance, kDefaultTolerance),
+                                              default_value(max_iterations, kDefaultMaxIterations),
+                                              default_value(alpha, kDefaultAlpha),
+                                              default_value(bin_shift, kDefaultBinShift)))
+
+    @staticmethod
+    def automatic():
+        return PagerankPlan.make(_PagerankPlan.Automatic())
+
+
+def pagerank(PropertyGraph pg, str output_property_name, PagerankPlan plan = PagerankPlan.automatic()):
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    with nogil:
+        handle_result_void(Pagerank(pg.underlying.get(), output_property_name_cstr, plan.underlying))
+
+
+def personalized_pagerank(PropertyGraph pg, seeds, uint32_t k, double epsilon = 1.0e-6, float alpha = kDefaultAlpha):
+    """
+    Return, for each of seeds, a list of up to k (node, rank) pairs for the nodes of highest personalized PageRank
+    from it, from highest to lowest rank. Ranks are approximated by forward push until every residual is below
+    epsilon times the out-degree of its node.
+    """
+    cdef vector[uint32_t] seeds_vec = seeds
+    cdef std_result[TopKPersonalizedPagerank] res
+    with nogil:
+        res = PersonalizedPagerank(pg.underlying.get(), seeds_vec, k, epsilon, alpha)
+    if not res.has_value():
+        raise_error_code(res.error())
+    cdef TopKPersonalizedPagerank* top = &res.value()
+    return [
+        [(top.nodes[j], top.ranks[j]) for j in range(top.offsets[i], top.offsets[i + 1])]
+        for i in range(seeds_vec.size())
+    ]
+
+
+# Connected Components
+
+cdef extern from "galois/Analytics.h" namespace "galois::analytics" nogil:
+    cppclass _ConnectedComponentsPlan "galois::analytics::ConnectedComponentsPlan":
+        enum Algorithm:
+            kSerial "galois::analytics::ConnectedComponentsPlan::kSerial"
+            kLabelProp "galois::analytics::ConnectedComponentsPlan::kLabelProp"
+            kSynchronous "galois::analytics::ConnectedComponentsPlan::kSynchronous"
+            kAsynchronous "galois::analytics::ConnectedComponentsPlan::kAsynchronous"
+            kEdgeAsynchronous "galois::analytics::ConnectedComponentsPlan::kEdgeAsynchronous"
+            kEdgeTiledAsynchronous "galois::analytics::ConnectedComponentsPlan::kEdgeTiledAsynchronous"
+            kBlockedAsynchronous "galois::analytics::ConnectedComponentsPlan::kBlockedAsynchronous"
+            kAfforest "galois::analytics::ConnectedComponentsPlan::kAfforest"
+            kEdgeAfforest "galois::analytics::ConnectedComponentsPlan::kEdgeAfforest"
+            kEdgeTiledAfforest "galois::analytics::ConnectedComponentsPlan::kEdgeTiledAfforest"
+            kAutomatic "galois::analytics::ConnectedComponentsPlan::kAutomatic"
+
+        _ConnectedComponentsPlan.Algorithm algorithm() const
+        ptrdiff_t edge_tile_size() const
+        uint32_t neighbor_sample_size() const
+        uint32_t component_sample_frequency() const
+        _ConnectedComponentsPlan WithFilter(TraversalFilter filter) const
+
+        @staticmethod
+        _ConnectedComponentsPlan Serial()
+        @staticmethod
+        _ConnectedComponentsPlan LabelProp()
+        @staticmethod
+        _ConnectedComponentsPlan Synchronous()
+        @staticmethod
+        _ConnectedComponentsPlan Asynchronous()
+        @staticmethod
+        _ConnectedComponentsPlan EdgeAsynchronous()
+        @staticmethod
+        _ConnectedComponentsPlan EdgeTiledAsynchronous(ptrdiff_t edge_tile_size)
+        @staticmethod
+        _ConnectedComponentsPlan BlockedAsynchronous()
+        @staticmethod
+        _ConnectedComponentsPlan Afforest(uint32_t neighbor_sample_size, uint32_t component_sample_frequency)
+        @staticmethod
+        _ConnectedComponentsPlan EdgeAfforest(uint32_t neighbor_sample_size, uint32_t component_sample_frequency)
+        @staticmethod
+        _ConnectedComponentsPlan EdgeTiledAfforest(ptrdiff_t edge_tile_size, uint32_t neighbor_sample_size,
+                                                   uint32_t component_sample_frequency)
+
+        @staticmethod
+        _ConnectedComponentsPlan Automatic()
+        @staticmethod
+        _ConnectedComponentsPlan Automatic_1 "Automatic"(const PropertyFileGraph * pfg)
+
+    ptrdiff_t kDefaultEdgeTileSize "galois::analytics::ConnectedComponentsPlan::kDefaultEdgeTileSize"
+    uint32_t kDefaultNeighborSampleSize "galois::analytics::ConnectedComponentsPlan::kDefaultNeighborSampleSize"
+    uint32_t kDefaultComponentSampleFrequency "galois::analytics::ConnectedComponentsPlan::kDefaultComponentSampleFrequency"
+
+    std_result[void] ConnectedComponents(PropertyFileGraph* pfg, string output_property_name,
+                                         _ConnectedComponentsPlan plan)
+
+    std_result[void] ConnectedComponentsIncremental(PropertyFileGraph* pfg, string component_property_name,
+                                                    vector[pair[uint32_t, uint32_t]] new_edges, bool compress)
+
+
+class _ConnectedComponentsAlgorithm(Enum):
+    Serial = _ConnectedComponentsPlan.Algorithm.kSerial
+    LabelProp = _ConnectedComponentsPlan.Algorithm.kLabelProp
+    Synchronous = _ConnectedComponentsPlan.Algorithm.kSynchronous
+    Asynchronous = _ConnectedComponentsPlan.Algorithm.kAsynchronous
+    EdgeAsynchronous = _ConnectedComponentsPlan.Algorithm.kEdgeAsynchronous
+    EdgeTiledAsynchronous = _ConnectedComponentsPlan.Algorithm.kEdgeTiledAsynchronous
+    BlockedAsynchronous = _ConnectedComponentsPlan.Algorithm.kBlockedAsynchronous
+    Afforest = _ConnectedComponentsPlan.Algorithm.kAfforest
+    EdgeAfforest = _ConnectedComponentsPlan.Algorithm.kEdgeAfforest
+    EdgeTiledAfforest = _ConnectedComponentsPlan.Algorithm.kEdgeTiledAfforest
+    Automatic = _ConnectedComponentsPlan.Algorithm.kAutomatic
+
+
+cdef class ConnectedComponentsPlan:
+    cdef:
+        _ConnectedComponentsPlan underlying
+
+    @staticmethod
+    cdef ConnectedComponentsPlan make(_ConnectedComponentsPlan u):
+        f = <ConnectedComponentsPlan>ConnectedComponentsPlan.__new__(ConnectedComponentsPlan)
+        f.underlying = u
+        return f
+
+    Algorithm = _ConnectedComponentsAlgorithm
+
+    @property
+    def algorithm(self) -> _ConnectedComponentsAlgorithm:
+        return _ConnectedComponentsAlgorithm(self.underlying.algorithm())
+
+    @property
+    def edge_tile_size(self) -> int:
+        return self.underlying.edge_tile_size()
+
+    @property
+    def neighbor_sample_size(self) -> int:
+        return self.underlying.neighbor_sample_size()
+
+    @property
+    def component_sample_frequency(self) -> int:
+        return self.underlying.component_sample_frequency()
+
+    @staticmethod
+    def serial():
+        return ConnectedComponentsPlan.make(_ConnectedComponentsPlan.Serial())
+
+    @staticmethod
+    def label_prop():
+        return ConnectedComponentsPlan.make(_ConnectedComponentsPlan.LabelProp())
+
+    @staticmethod
+    def synchronous():
+        return ConnectedComponentsPlan.make(_ConnectedComponentsPlan.Synchronous())
+
+    @staticmethod
+    def asynchronous():
+        return ConnectedComponentsPlan.make(_ConnectedComponentsPlan.Asynchronous())
+
+    @staticmethod
+    def edge_asynchronous():
+        return ConnectedComponentsPlan.make(_ConnectedComponentsPlan.EdgeAsynchronous())
+
+    @staticmethod
+    def edge_tiled_asynchronous(edge_tile_size=None):
+        return ConnectedComponentsPlan.make(
+            _ConnectedComponentsPlan.EdgeTiledAsynchronous(default_value(edge_tile_size, kDefaultEdgeTileSize)))
+
+    @staticmethod
+    def blocked_asynchronous():
+        return ConnectedComponentsPlan.make(_ConnectedComponentsPlan.BlockedAsynchronous())
+
+    @staticmethod
+    def afforest(neighbor_sample_size=None, component_sample_frequency=None):
+        """Union-find that skips the edges of the largest component after linking a sample of edges."""
+        return ConnectedComponentsPlan.make(
+            _ConnectedComponentsPlan.Afforest(
+                default_value(neighbor_sample_size, kDefaultNeighborSampleSize),
+                default_value(component_sample_frequency, kDefaultComponentSampleFrequency)))
+
+    @staticmethod
+    def edge_afforest(neighbor_sample_size=None, component_sample_frequency=None):
+        return ConnectedComponentsPlan.make(
+            _ConnectedComponentsPlan.EdgeAfforest(
+                default_value(neighbor_sample_size, kDefaultNeighborSampleSize),
+                default_value(component_sample_frequency, kDefaultComponentSampleFrequency)))
+
+    @staticmethod
+    def edge_tiled_afforest(edge_tile_size=None, neighbor_sample_size=None, component_sample_frequency=None):
+        return ConnectedComponentsPlan.make(
+            _ConnectedComponentsPlan.EdgeTiledAfforest(
+                default_value(edge_tile_size, kDefaultEdgeTileSize),
+                default_value(neighbor_sample_size, kDefaultNeighborSampleSize),
+                default_value(component_sample_frequency, kDefaultComponentSampleFrequency)))
+
+    @staticmethod
+    def automatic(graph = None):
+        if graph is None:
+            return ConnectedComponentsPlan.make(_ConnectedComponentsPlan.Automatic())
+        return ConnectedComponentsPlan.make(_ConnectedComponentsPlan.Automatic_1((<PropertyGraph>graph).underlying.get()))
+
+    def with_filter(self, edge_types=None, node_labels=None):
+        """Return this plan restricted to the edges with one of edge_types between the nodes with one of node_labels."""
+        return ConnectedComponentsPlan.make(
+            self.underlying.WithFilter(make_traversal_filter(edge_types, node_labels)))
+
+
+def connected_components(PropertyGraph pg, str output_property_name,
+                         ConnectedComponentsPlan plan = ConnectedComponentsPlan.automatic()):
+    """Label each node with the smallest node id in its component. The graph must be symmetric."""
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    with nogil:
+        handle_result_void(ConnectedComponents(pg.underlying.get(), output_property_name_cstr, plan.underlying))
+
+
+def connected_components_incremental(PropertyGraph pg, str component_property_name, new_edges, bool compress = False):
+    """
+    Update the components computed by connected_components after the (source, destination) pairs new_edges were added
+    to the graph. Without compress, nodes of merged components may be left pointing at a former root of their
+    component instead of at the root itself.
+    """
+    component_property_name_bytes = bytes(component_property_name, "utf-8")
+    component_property_name_cstr = <string>component_property_name_bytes
+    cdef vector[pair[uint32_t, uint32_t]] new_edges_vec = new_edges
+    with nogil:
+        handle_result_void(ConnectedComponentsIncremental(pg.underlying.get(), component_property_name_cstr,
+                                                          new_edges_vec, compress))
+
+
+# Jaccard
+
+cdef extern from "galois/Analytics.h" namespace "galois::analytics" nogil:
+    cppclass _JaccardPlan "galois::analytics::JaccardPlan":
+        enum EdgeSorting:
+            kSorted "galois::analytics::JaccardPlan::kSorted"
+            kUnsorted "galois::analytics::JaccardPlan::kUnsorted"
+            kUnknown "galois::analytics::JaccardPlan::kUnknown"
+
+        _JaccardPlan.EdgeSorting edge_sorting() const
+
+        @staticmethod
+        _JaccardPlan Sorted()
+        @staticmethod
+        _JaccardPlan Unsorted()
+
+        @staticmethod
+        _JaccardPlan Automatic()
+
+    std_result[void] Jaccard(PropertyFileGraph* pfg, uint32_t compare_node, string output_property_name,
+                             _JaccardPlan plan)
+
+    enum SimilarityMeasure "galois::analytics::SimilarityMeasure":
+        kJaccardSimilarity "galois::analytics::kJaccardSimilarity"
+        kCosineSimilarity "galois::analytics::kCosineSimilarity"
+        kOverlapSimilarity "galois::analytics::kOverlapSimilarity"
+
+    cppclass TopKSimilarity:
+        vector[uint64_t] offsets
+        vector[uint32_t] nodes
+        vector[double] similarities
+
+    std_result[TopKSimilarity] TopKSimilarNodes(PropertyFileGraph* pfg, const vector[uint32_t]& query_nodes,
+                                                uint32_t k, SimilarityMeasure measure)
+
+
+class _JaccardEdgeSorting(Enum):
+    Sorted = _JaccardPlan.EdgeSorting.kSorted
+    Unsorted = _JaccardPlan.EdgeSorting.kUnsorted
+    Unknown = _JaccardPlan.EdgeSorting.kUnknown
+
+
+cdef class JaccardPlan:
+    cdef:
+        _JaccardPlan underlying
+
+    @staticmethod
+    cdef JaccardPlan make(_JaccardPlan u):
+        f = <JaccardPlan>JaccardPlan.__new__(JaccardPlan)
+        f.underlying = u
+        return f
+
+    EdgeSorting = _JaccardEdgeSorting
+
+    @property
+    def edge_sorting(self) -> _JaccardEdgeSorting:
+        return _JaccardEdgeSorting(self.underlying.edge_sorting())
+
+    @staticmethod
+    def sorted():
+        """Merge sorted neighbor lists; requires edges sorted by destination."""
+        return JaccardPlan.make(_JaccardPlan.Sorted())
+
+    @staticmethod
+    def unsorted():
+        return JaccardPlan.make(_JaccardPlan.Unsorted())
+
+    @staticmethod
+    def automatic():
+        return JaccardPlan.make(_JaccardPlan.Automatic())
+
+
+def jaccard(PropertyGraph pg, uint32_t compare_node, str output_property_name,
+            JaccardPlan plan = JaccardPlan.automatic()):
+    """Store the Jaccard similarity of the neighbors of each node to those of compare_node in a new node property."""
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    with nogil:
+        handle_result_void(Jaccard(pg.underlying.get(), compare_node, output_property_name_cstr, plan.underlying))
+
+
+class Similarity(Enum):
+    Jaccard = SimilarityMeasure.kJaccardSimilarity
+    Cosine = SimilarityMeasure.kCosineSimilarity
+    Overlap = SimilarityMeasure.kOverlapSimilarity
+
+
+def top_k_similar_nodes(PropertyGraph pg, query_nodes, uint32_t k, measure = Similarity.Jaccard):
+    """
+    Return, for each of query_nodes, a list of up to k (node, similarity) pairs for the nodes most similar to it, from
+    most to least similar. Only nodes that share a neighbor with a query node are considered. The graph must be
+    symmetric.
+    """
+    cdef vector[uint32_t] query_nodes_vec = query_nodes
+    cdef SimilarityMeasure measure_value = measure.value
+    cdef std_result[TopKSimilarity] res
+    with nogil:
+        res = TopKSimilarNodes(pg.underlying.get(), query_nodes_vec, k, measure_value)
+    if not res.has_value():
+        raise_error_code(res.error())
+    cdef TopKSimilarity* top = &res.value()
+    return [
+        [(top.nodes[j], top.similarities[j]) for j in range(top.offsets[i], top.offsets[i + 1])]
+        for i in range(query_nodes_vec.size())
+    ]
+
+
+# k-core
+
+cdef extern from "galois/Analytics.h" namespace "galois::analytics" nogil:
+    cppclass _KCorePlan "galois::analytics::KCorePlan":
+        enum Algorithm:
+            kSynchronous "galois::analytics::KCorePlan::kSynchronous"
+            kBucketed "galois::analytics::KCorePlan::kBucketed"
+
+        _KCorePlan.Algorithm algorithm() const
+
+        @staticmethod
+        _KCorePlan Synchronous()
+        @staticmethod
+        _KCorePlan Bucketed()
+
+        @staticmethod
+        _KCorePlan Automatic()
+
+    std_result[void] KCore(PropertyFileGraph* pfg, string output_property_name, _KCorePlan plan)
+
+
+class _KCoreAlgorithm(Enum):
+    Synchronous = _KCorePlan.Algorithm.kSynchronous
+    Bucketed = _KCorePlan.Algorithm.kBucketed
+
+
+cdef class KCorePlan:
+    cdef:
+        _KCorePlan underlying
+
+    @staticmethod
+    cdef KCorePlan make(_KCorePlan u):
+        f = <KCorePlan>KCorePlan.__new__(KCorePlan)
+        f.underlying = u
+        return f
+
+    Algorithm = _KCoreAlgorithm
+
+    @property
+    def algorithm(self) -> _KCoreAlgorithm:
+        return _KCoreAlgorithm(self.underlying.algorithm())
+
+    @staticmethod
+    def synchronous():
+        return KCorePlan.make(_KCorePlan.Synchronous())
+
+    @staticmethod
+    def bucketed():
+        """Peel nodes from buckets by remaining degree, moving a node to a lower bucket when a neighbor is removed."""
+        return KCorePlan.make(_KCorePlan.Bucketed())
+
+    @staticmethod
+    def automatic():
+        return KCorePlan.make(_KCorePlan.Automatic())
+
+
+def k_core(PropertyGraph pg, str output_property_name, KCorePlan plan = KCorePlan.automatic()):
+    """
+    Store the coreness of each node, the largest k such that the node is in the k-core, in a new node property. The
+    graph must be symmetric.
+    """
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    with nogil:
+        handle_result_void(KCore(pg.underlying.get(), output_property_name_cstr, plan.underlying))
+
+
+# k-truss
+
+cdef extern from "galois/Analytics.h" namespace "galois::analytics" nogil:
+    cppclass _KTrussPlan "galois::analytics::KTrussPlan":
+        enum Algorithm:
+            kBucketed "galois::analytics::KTrussPlan::kBucketed"
+
+        _KTrussPlan.Algorithm algorithm() const
+
+        @staticmethod
+        _KTrussPlan Bucketed()
+
+        @staticmethod
+        _KTrussPlan Automatic()
+
+    std_result[void] KTruss(PropertyFileGraph* pfg, string output_property_name, _KTrussPlan plan)
+
+
+class _KTrussAlgorithm(Enum):
+    Bucketed = _KTrussPlan.Algorithm.kBucketed
+
+
+cdef class KTrussPlan:
+    cdef:
+        _KTrussPlan underlying
+
+    @staticmethod
+    cdef KTrussPlan make(_KTrussPlan u):
+        f = <KTrussPlan>KTrussPlan.__new__(KTrussPlan)
+        f.underlying = u
+        return f
+
+    Algorithm = _KTrussAlgorithm
+
+    @property
+    def algorithm(self) -> _KTrussAlgorithm:
+        return _KTrussAlgorithm(self.underlying.algorithm())
+
+    @staticmethod
+    def bucketed():
+        """Peel edges from buckets by remaining support, only recomputing the support of edges in triangles with removed ones."""
+        return KTrussPlan.make(_KTrussPlan.Bucketed())
+
+    @staticmethod
+    def automatic():
+        return KTrussPlan.make(_KTrussPlan.Automatic())
+
+
+def k_truss(PropertyGraph pg, str output_property_name, KTrussPlan plan = KTrussPlan.automatic()):
+    """
+    Store the trussness of each edge, the largest k such that the edge is in the k-truss, in a new edge property. The
+    graph is viewed as undirected; self loops get a trussness of 0.
+    """
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    with nogil:
+        handle_result_void(KTruss(pg.underlying.get(), output_property_name_cstr, plan.underlying))
+
+
+# Independent set
+
+cdef extern from "galois/Analytics.h" namespace "galois::analytics" nogil:
+    cppclass _IndependentSetPlan "galois::analytics::IndependentSetPlan":
+        enum Algorithm:
+            kSerial "galois::analytics::IndependentSetPlan::kSerial"
+            kPriority "galois::analytics::IndependentSetPlan::kPriority"
+
+        _IndependentSetPlan.Algorithm algorithm() const
+        ptrdiff_t edge_tile_size() const
+
+        @staticmethod
+        _IndependentSetPlan Serial()
+        @staticmethod
+        _IndependentSetPlan Priority(ptrdiff_t edge_tile_size)
+
+        @staticmethod
+        _IndependentSetPlan Automatic()
+
+    std_result[void] IndependentSet(PropertyFileGraph* pfg, string output_property_name, _IndependentSetPlan plan)
+
+
+class _IndependentSetAlgorithm(Enum):
+    Serial = _IndependentSetPlan.Algorithm.kSerial
+    Priority = _IndependentSetPlan.Algorithm.kPriority
+
+
+cdef class IndependentSetPlan:
+    cdef:
+        _IndependentSetPlan underlying
+
+    @staticmethod
+    cdef IndependentSetPlan make(_IndependentSetPlan u):
+        f = <IndependentSetPlan>IndependentSetPlan.__new__(IndependentSetPlan)
+        f.underlying = u
+        return f
+
+    Algorithm = _IndependentSetAlgorithm
+
+    @property
+    def algorithm(self) -> _IndependentSetAlgorithm:
+        return _IndependentSetAlgorithm(self.underlying.algorithm())
+
+    @property
+    def edge_tile_size(self) -> int:
+        return self.underlying.edge_tile_size()
+
+    @staticmethod
+    def serial():
+        return IndependentSetPlan.make(_IndependentSetPlan.Serial())
+
+    @staticmethod
+    def priority(edge_tile_size=256):
+        """Add the nodes of higher priority than all their undecided neighbors to the set in rounds."""
+        return IndependentSetPlan.make(_IndependentSetPlan.Priority(edge_tile_size))
+
+    @staticmethod
+    def automatic():
+        return IndependentSetPlan.make(_IndependentSetPlan.Automatic())
+
+
+def independent_set(PropertyGraph pg, str output_property_name, IndependentSetPlan plan = IndependentSetPlan.automatic()):
+    """
+    Store a maximal independent set in a new node property: 1 for the nodes in the set and 0 for the others. The graph
+    must be symmetric.
+    """
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    with nogil:
+        handle_result_void(IndependentSet(pg.underlying.get(), output_property_name_cstr, plan.underlying))
+
+
+# Graph coloring
+
+cdef extern from "galois/Analytics.h" namespace "galois::analytics" nogil:
+    cppclass _GraphColoringPlan "galois::analytics::GraphColoringPlan":
+        enum Algorithm:
+            kJonesPlassmann "galois::analytics::GraphColoringPlan::kJonesPlassmann"
+
+        _GraphColoringPlan.Algorithm algorithm() const
+        ptrdiff_t edge_tile_size() const
+
+        @staticmethod
+        _GraphColoringPlan JonesPlassmann(ptrdiff_t edge_tile_size)
+
+        @staticmethod
+        _GraphColoringPlan Automatic()
+
+    std_result[void] GraphColoring(PropertyFileGraph* pfg, string output_property_name, _GraphColoringPlan plan)
+
+
+class _GraphColoringAlgorithm(Enum):
+    JonesPlassmann = _GraphColoringPlan.Algorithm.kJonesPlassmann
+
+
+cdef class GraphColoringPlan:
+    cdef:
+        _GraphColoringPlan underlying
+
+    @staticmethod
+    cdef GraphColoringPlan make(_GraphColoringPlan u):
+        f = <GraphColoringPlan>GraphColoringPlan.__new__(GraphColoringPlan)
+        f.underlying = u
+        return f
+
+    Algorithm = _GraphColoringAlgorithm
+
+    @property
+    def algorithm(self) -> _GraphColoringAlgorithm:
+        return _GraphColoringAlgorithm(self.underlying.algorithm())
+
+    @property
+    def edge_tile_size(self) -> int:
+        return self.underlying.edge_tile_size()
+
+    @staticmethod
+    def jones_plassmann(edge_tile_size=256):
+        """Color the nodes of higher priority than all their uncolored neighbors in rounds."""
+        return GraphColoringPlan.make(_GraphColoringPlan.JonesPlassmann(edge_tile_size))
+
+    @staticmethod
+    def automatic():
+        return GraphColoringPlan.make(_GraphColoringPlan.Automatic())
+
+
+def graph_coloring(PropertyGraph pg, str output_property_name, GraphColoringPlan plan = GraphColoringPlan.automatic()):
+    """
+    Store a color for each node, such that no two neighbors have the same color, in a new node property. The graph
+    must be symmetric.
+    """
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    with nogil:
+        handle_result_void(GraphColoring(pg.underlying.get(), output_property_name_cstr, plan.underlying))
+
+
+# Minimum spanning forest
+
+cdef extern from "galois/Analytics.h" namespace "galois::analytics" nogil:
+    cppclass _MinimumSpanningForestPlan "galois::analytics::MinimumSpanningForestPlan":
+        enum Algorithm:
+            kBoruvka "galois::analytics::MinimumSpanningForestPlan::kBoruvka"
+            kFilterKruskal "galois::analytics::MinimumSpanningForestPlan::kFilterKruskal"
+
+        _MinimumSpanningForestPlan.Algorithm algorithm() const
+
+        @staticmethod
+        _MinimumSpanningForestPlan Boruvka()
+
+        @staticmethod
+        _MinimumSpanningForestPlan FilterKruskal()
+
+        @staticmethod
+        _MinimumSpanningForestPlan Automatic()
+
+    std_result[void] MinimumSpanningForest(PropertyFileGraph* pfg, string edge_weight_property_name,
+                                           string output_property_name, _MinimumSpanningForestPlan plan)
+
+
+class _MinimumSpanningForestAlgorithm(Enum):
+    Boruvka = _MinimumSpanningForestPlan.Algorithm.kBoruvka
+    FilterKruskal = _MinimumSpanningForestPlan.Algorithm.kFilterKruskal
+
+
+cdef class MinimumSpanningForestPlan:
+    cdef:
+        _MinimumSpanningForestPlan underlying
+
+    @staticmethod
+    cdef MinimumSpanningForestPlan make(_MinimumSpanningForestPlan u):
+        f = <MinimumSpanningForestPlan>MinimumSpanningForestPlan.__new__(MinimumSpanningForestPlan)
+        f.underlying = u
+        return f
+
+    Algorithm = _MinimumSpanningForestAlgorithm
+
+    @property
+    def algorithm(self) -> _MinimumSpanningForestAlgorithm:
+        return _MinimumSpanningForestAlgorithm(self.underlying.algorithm())
+
+    @staticmethod
+    def boruvka():
+        """Contract the graph in rounds, joining every tree to another along its lightest edge."""
+        return MinimumSpanningForestPlan.make(_MinimumSpanningForestPlan.Boruvka())
+
+    @staticmethod
+    def filter_kruskal():
+        """Kruskal's algorithm with the sort replaced by a parallel partition that filters out heavy edges inside trees."""
+        return MinimumSpanningForestPlan.make(_MinimumSpanningForestPlan.FilterKruskal())
+
+    @staticmethod
+    def automatic():
+        return MinimumSpanningForestPlan.make(_MinimumSpanningForestPlan.Automatic())
+
+
+def minimum_spanning_forest(PropertyGraph pg, str edge_weight_property_name, str output_property_name,
+                            MinimumSpanningForestPlan plan = MinimumSpanningForestPlan.automatic()):
+    """
+    Flag the edges of a minimum spanning forest, with 1, in a new edge property. The graph is viewed as undirected and
+    ties between weights are broken by edge index, so every plan flags the same edges.
+    """
+    edge_weight_property_name_bytes = bytes(edge_weight_property_name, "utf-8")
+    edge_weight_property_name_cstr = <string>edge_weight_property_name_bytes
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    with nogil:
+        handle_result_void(MinimumSpanningForest(pg.underlying.get(), edge_weight_property_name_cstr,
+                                                 output_property_name_cstr, plan.underlying))
+
+
+# Bipartite matching
+
+cdef extern from "galois/Analytics.h" namespace "galois::analytics" nogil:
+    cppclass _BipartiteMatchingPlan "galois::analytics::BipartiteMatchingPlan":
+        enum Algorithm:
+            kHopcroftKarp "galois::analytics::BipartiteMatchingPlan::kHopcroftKarp"
+            kPushRelabel "galois::analytics::BipartiteMatchingPlan::kPushRelabel"
+
+        _BipartiteMatchingPlan.Algorithm algorithm() const
+
+        @staticmethod
+        _BipartiteMatchingPlan HopcroftKarp()
+
+        @staticmethod
+        _BipartiteMatchingPlan PushRelabel()
+
+        @staticmethod
+        _BipartiteMatchingPlan Automatic()
+
+    std_result[void] BipartiteMatching(PropertyFileGraph* pfg, string output_property_name, _BipartiteMatchingPlan plan)
+
+
+class _BipartiteMatchingAlgorithm(Enum):
+    HopcroftKarp = _BipartiteMatchingPlan.Algorithm.kHopcroftKarp
+    PushRelabel = _BipartiteMatchingPlan.Algorithm.kPushRelabel
+
+
+cdef class BipartiteMatchingPlan:
+    cdef:
+        _BipartiteMatchingPlan underlying
+
+    @staticmethod
+    cdef BipartiteMatchingPlan make(_BipartiteMatchingPlan u):
+        f = <BipartiteMatchingPlan>BipartiteMatchingPlan.__new__(BipartiteMatchingPlan)
+        f.underlying = u
+        return f
+
+    Algorithm = _BipartiteMatchingAlgorithm
+
+    @property
+    def algorithm(self) -> _BipartiteMatchingAlgorithm:
+        return _BipartiteMatchingAlgorithm(self.underlying.algorithm())
+
+    @staticmethod
+    def hopcroft_karp():
+        """Augment in phases along disjoint shortest augmenting paths, found by a parallel breadth-first search and parallel depth-first searches."""
+        return BipartiteMatchingPlan.make(_BipartiteMatchingPlan.HopcroftKarp())
+
+    @staticmethod
+    def push_relabel():
+        """Unmatched left nodes take their lowest labeled neighbor in parallel, with global relabeling between passes."""
+        return BipartiteMatchingPlan.make(_BipartiteMatchingPlan.PushRelabel())
+
+    @staticmethod
+    def automatic():
+        return BipartiteMatchingPlan.make(_BipartiteMatchingPlan.Automatic())
+
+
+def bipartite_matching(PropertyGraph pg, str output_property_name,
+                       BipartiteMatchingPlan plan = BipartiteMatchingPlan.automatic()):
+    """
+    Flag the edges of a maximum matching, with 1, in a new edge property. Each edge goes from its source as a left node
+    to its destination as a right node, and every node is both a left and a right node.
+    """
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    with nogil:
+        handle_result_void(BipartiteMatching(pg.underlying.get(), output_property_name_cstr, plan.underlying))
+
+
+# Random Walks
+
+cdef extern from "galois/Analytics.h" namespace "galois::analytics" nogil:
+    cppclass _RandomWalksPlan "galois::analytics::RandomWalksPlan":
+        enum Algorithm:
+            kUniform "galois::analytics::RandomWalksPlan::kUniform"
+            kWeighted "galois::analytics::RandomWalksPlan::kWeighted"
+            kNode2vec "galois::analytics::RandomWalksPlan::kNode2vec"
+
+        _RandomWalksPlan.Algorithm algorithm() const
+        uint32_t walk_length() const
+        uint32_t walks_per_node() const
+        double return_parameter() const
+        double in_out_parameter() const
+
+        @staticmethod
+        _RandomWalksPlan Uniform(uint32_t walk_length, uint32_t walks_per_node)
+        @staticmethod
+        _RandomWalksPlan Weighted(uint32_t walk_length, uint32_t walks_per_node)
+        @staticmethod
+        _RandomWalksPlan Node2vec(uint32_t walk_length, uint32_t walks_per_node, double return_parameter,
+                                  double in_out_parameter)
+
+        @staticmethod
+        _RandomWalksPlan Automatic()
+
+    uint32_t kDefaultWalkLength "galois::analytics::RandomWalksPlan::kDefaultWalkLength"
+    uint32_t kDefaultWalksPerNode "galois::analytics::RandomWalksPlan::kDefaultWalksPerNode"
+    double kDefaultReturnParameter "galois::analytics::RandomWalksPlan::kDefaultReturnParameter"
+    double kDefaultInOutParameter "galois::analytics::RandomWalksPlan::kDefaultInOutParameter"
+
+    std_result[shared_ptr[CTable]] RandomWalks(PropertyFileGraph* pfg, string edge_weight_property_name,
+                                               uint64_t random_seed, _RandomWalksPlan plan)
+
+    std_result[void] WriteRandomWalks(shared_ptr[CTable] walks, string uri)
+
+
+class _RandomWalksAlgorithm(Enum):
+    Uniform = _RandomWalksPlan.Algorithm.kUniform
+    Weighted = _RandomWalksPlan.Algorithm.kWeighted
+    Node2vec = _RandomWalksPlan.Algorithm.kNode2vec
+
+
+cdef class RandomWalksPlan:
+    cdef:
+        _RandomWalksPlan underlying
+
+    @staticmethod
+    cdef RandomWalksPlan make(_RandomWalksPlan u):
+        f = <RandomWalksPlan>RandomWalksPlan.__new__(RandomWalksPlan)
+        f.underlying = u
+        return f
+
+    Algorithm = _RandomWalksAlgorithm
+
+    @property
+    def algorithm(self) -> _RandomWalksAlgorithm:
+        return _RandomWalksAlgorithm(self.underlying.algorithm())
+
+    @property
+    def walk_length(self) -> int:
+        return self.underlying.walk_length()
+
+    @property
+    def walks_per_node(self) -> int:
+        return self.underlying.walks_per_node()
+
+    @property
+    def return_parameter(self) -> float:
+        return self.underlying.return_parameter()
+
+    @property
+    def in_out_parameter(self) -> float:
+        return self.underlying.in_out_parameter()
+
+    @staticmethod
+    def uniform(walk_length=None, walks_per_node=None):
+        """Each step follows an out-edge chosen uniformly at random (DeepWalk)."""
+        return RandomWalksPlan.make(
+            _RandomWalksPlan.Uniform(default_value(walk_length, kDefaultWalkLength),
+                                     default_value(walks_per_node, kDefaultWalksPerNode)))
+
+    @staticmethod
+    def weighted(walk_length=None, walks_per_node=None):
+        """Each step follows an out-edge chosen in proportion to its weight, drawn from per-node alias tables."""
+        return RandomWalksPlan.make(
+            _RandomWalksPlan.Weighted(default_value(walk_length, kDefaultWalkLength),
+                                      default_value(walks_per_node, kDefaultWalksPerNode)))
+
+    @staticmethod
+    def node2vec(walk_length=None, walks_per_node=None, return_parameter=None, in_out_parameter=None):
+        """Second-order walks biased by the return parameter p and the in-out parameter q of node2vec."""
+        return RandomWalksPlan.make(
+            _RandomWalksPlan.Node2vec(default_value(walk_length, kDefaultWalkLength),
+                                      default_value(walks_per_node, kDefaultWalksPerNode),
+                                      default_value(return_parameter, kDefaultReturnParameter),
+                                      default_value(in_out_parameter, kDefaultInOutParameter)))
+
+    @staticmethod
+    def automatic():
+        return RandomWalksPlan.make(_RandomWalksPlan.Automatic())
+
+
+def random_walks(PropertyGraph pg, RandomWalksPlan plan = RandomWalksPlan.automatic(),
+                 str edge_weight_property_name = None, uint64_t seed = 0, str output_uri = None):
+    """
+    Generate random walks over the graph and return them as a pyarrow Table with a single column "walk" of lists of
+    node ids, one row per walk. Walk w starts at node w % num_nodes and stops early at a node without out-edges. The
+    same seed gives the same walks for any number of threads.
+
+    Weighted walks need edge_weight_property_name; node2vec walks weigh every edge 1 without it. If output_uri is
+    given, the walks are also written to a parquet file there.
+    """
+    edge_weight_property_name_bytes = bytes(edge_weight_property_name or "", "utf-8")
+    edge_weight_property_name_cstr = <string>edge_weight_property_name_bytes
+    cdef std_result[shared_ptr[CTable]] res
+    with nogil:
+        res = RandomWalks(pg.underlying.get(), edge_weight_property_name_cstr, seed, plan.underlying)
+    if not res.has_value():
+        raise_error_code(res.error())
+    cdef shared_ptr[CTable] walks = res.value()
+    cdef string output_uri_cstr
+    if output_uri is not None:
+        output_uri_cstr = bytes(output_uri, "utf-8")
+        with nogil:
+            handle_result_void(WriteRandomWalks(walks, output_uri_cstr))
+    return pyarrow_wrap_table(walks)
+
+
+# Triangle Counting
+
+cdef extern from "galois/Analytics.h" namespace "galois::analytics" nogil:
+    cppclass _TriangleCountPlan "galois::analytics::TriangleCountPlan":
+        enum Algorithm:
+            kNodeIteration "galois::analytics::TriangleCountPlan::kNodeIteration"
+            kEdgeIteration "galois::analytics::TriangleCountPlan::kEdgeIteration"
+            kOrderedCount "galois::analytics::TriangleCountPlan::kOrderedCount"
+            kDegreeOrderedDag "galois::analytics::TriangleCountPlan::kDegreeOrderedDag"
+
+        _TriangleCountPlan.Algorithm algorithm() const
+
+        @staticmethod
+        _TriangleCountPlan NodeIteration()
+        @staticmethod
+        _TriangleCountPlan EdgeIteration()
+        @staticmethod
+        _TriangleCountPlan OrderedCount()
+        @staticmethod
+        _TriangleCountPlan DegreeOrderedDag()
+
+        @staticmethod
+        _TriangleCountPlan Automatic()
+
+    std_result[uint64_t] TriangleCount(PropertyFileGraph* pfg, _TriangleCountPlan plan)
+
+    std_result[uint64_t] TriangleCount(PropertyFileGraph* pfg, string output_property_name, _TriangleCountPlan plan)
+
+    std_result[void] LocalClusteringCoefficient(PropertyFileGraph* pfg, string output_property_name,
+                                                _TriangleCountPlan plan)
+
+    cppclass TriangleCountEstimate:
+        double estimate
+        double lower_bound
+        double upper_bound
+
+    std_result[TriangleCountEstimate] EstimateTriangleCount(PropertyFileGraph* pfg, uint64_t num_samples,
+                                                            double confidence, uint64_t seed)
+
+
+class _TriangleCountAlgorithm(Enum):
+    NodeIteration = _TriangleCountPlan.Algorithm.kNodeIteration
+    EdgeIteration = _TriangleCountPlan.Algorithm.kEdgeIteration
+    OrderedCount = _TriangleCountPlan.Algorithm.kOrderedCount
+    DegreeOrderedDag = _TriangleCountPlan.Algorithm.kDegreeOrderedDag
+
+
+cdef class TriangleCountPlan:
+    cdef:
+        _TriangleCountPlan underlying
+
+    @staticmethod
+    cdef TriangleCountPlan make(_TriangleCountPlan u):
+        f = <TriangleCountPlan>TriangleCountPlan.__new__(TriangleCountPlan)
+        f.underlying = u
+        return f
+
+    Algorithm = _TriangleCountAlgorithm
+
+    @property
+    def algorithm(self) -> _TriangleCountAlgorithm:
+        return _TriangleCountAlgorithm(self.underlying.algorithm())
+
+    @staticmethod
+    def node_iteration():
+        return TriangleCountPlan.make(_TriangleCountPlan.NodeIteration())
+
+    @staticmethod
+    def edge_iteration():
+        return TriangleCountPlan.make(_TriangleCountPlan.EdgeIteration())
+
+    @staticmethod
+    def ordered_count():
+        return TriangleCountPlan.make(_TriangleCountPlan.OrderedCount())
+
+    @staticmethod
+    def degree_ordered_dag():
+        """Intersect the out-neighbors of the endpoints of each edge after orienting edges by degree."""
+        return TriangleCountPlan.make(_TriangleCountPlan.DegreeOrderedDag())
+
+    @staticmethod
+    def automatic():
+        return TriangleCountPlan.make(_TriangleCountPlan.Automatic())
+
+
+cdef uint64_t handle_result_uint64(std_result[uint64_t] res) except *:
+    if not res.has_value():
+        raise_error_code(res.error())
+    return res.value()
+
+
+def triangle_count(PropertyGraph pg, str output_property_name = None,
+                   TriangleCountPlan plan = TriangleCountPlan.automatic()):
+    """
+    Return the number of triangles of the graph, viewed as undirected. With output_property_name, also store the
+    number of triangles each node is part of in a new node property of that name.
+    """
+    cdef std_result[uint64_t] res
+    cdef string output_property_name_cstr
+    if output_property_name is None:
+        with nogil:
+            res = TriangleCount(pg.underlying.get(), plan.underlying)
+        return handle_result_uint64(res)
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    with nogil:
+        res = TriangleCount(pg.underlying.get(), output_property_name_cstr, plan.underlying)
+    return handle_result_uint64(res)
+
+
+def local_clustering_coefficient(PropertyGraph pg, str output_property_name,
+                                 TriangleCountPlan plan = TriangleCountPlan.automatic()):
+    """Store the fraction of the pairs of neighbors of each node that are adjacent in a new node property."""
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    with nogil:
+        handle_result_void(LocalClusteringCoefficient(pg.underlying.get(), output_property_name_cstr,
+                                                      plan.underlying))
+
+
+def estimate_triangle_count(PropertyGraph pg, uint64_t num_samples, double confidence = 0.95, uint64_t seed = 0):
+    """
+    Estimate the number of triangles of the graph, which must be symmetric, from num_samples random wedges. Return
+    the estimate and the bounds of an interval that holds the true count with probability at least confidence.
+    """
+    cdef std_result[TriangleCountEstimate] res
+    with nogil:
+        res = EstimateTriangleCount(pg.underlying.get(), num_samples, confidence, seed)
+    if not res.has_value():
+        raise_error_code(res.error())
+    return res.value().estimate, res.value().lower_bound, res.value().upper_bound
+
+
+# Partition quality
+
+cdef extern from "galois/Analytics.h" namespace "galois::analytics" nogil:
+    cppclass PartitionQuality:
+        vector[uint64_t] part_sizes
+        vector[double] part_volumes
+        vector[double] part_cuts
+        vector[double] part_conductances
+        double edge_cut
+        uint64_t communication_volume
+        double modularity
+        double max_conductance
+        double balance
+
+    std_result[PartitionQuality] ComputePartitionQuality(const PropertyFileGraph& pfg, string part_property,
+                                                         string weight_property)
+
+
+def partition_quality(PropertyGraph pg, str part_property, str weight_property = ""):
+    """
+    Measure the partition of the nodes given by the integer node property part_property, with edges weighted by
+    weight_property, or 1 each if it is empty. Return a dict of the edge cut, communication volume, modularity
+    (for symmetric graphs), largest conductance and balance of the partition, and of the size, volume, cut and
+    conductance of each part, indexed by part id.
+    """
+    part_property_bytes = bytes(part_property, "utf-8")
+    part_property_cstr = <string>part_property_bytes
+    weight_property_bytes = bytes(weight_property, "utf-8")
+    weight_property_cstr = <string>weight_property_bytes
+    cdef std_result[PartitionQuality] res
+    with nogil:
+        res = ComputePartitionQuality(deref(pg.underlying.get()), part_property_cstr, weight_property_cstr)
+    if not res.has_value():
+        raise_error_code(res.error())
+    cdef PartitionQuality* quality = &res.value()
+    return {
+        "edge_cut": quality.edge_cut,
+        "communication_volume": quality.communication_volume,
+        "modularity": quality.modularity,
+        "max_conductance": quality.max_conductance,
+        "balance": quality.balance,
+        "part_sizes": list(quality.part_sizes),
+        "part_volumes": list(quality.part_volumes),
+        "part_cuts": list(quality.part_cuts),
+        "part_conductances": list(quality.part_conductances),
+    }
@@ -23,6 +23,15 @@ cdef extern from "galois/Reduction.h" namespace "galois" nogil:
     cppclass GReduceLogicalOr(Reducible[bint]):
         pass
 
+cdef extern from "galois/VectorReduction.h" namespace "galois" nogil:
+    cppclass GVectorAccumulator[T]:
+        GVectorAccumulator()
+        size_t size()
+        void resize(size_t)
+        void update(size_t, const T&)
+        void reduce_into(T*)
+        void reset()
+
 cdef extern from "galois/AtomicHelpers.h" namespace "galois" nogil:
     const T atomicMin[T](atomic[T]&, const T)
     const T atomicMax[T](atomic[T]&, const T)
@@ -9,6 +9,8 @@ cdef extern from "galois/Bag.h" namespace "galois" nogil:
 
         void push(T)
         bint empty()
+        size_t size()
+        void copy_parallel(T*)
         void swap(InsertBag&)
         void clear()
 
@@ -2,7 +2,7 @@ from libcpp.string cimport string
 from ..Galois cimport MethodFlag, NoDerefIterator, StandardRange
 from libcpp.memory cimport unique_ptr, shared_ptr
 from libcpp.vector cimport vector
-from libc.stdint cimport uint64_t
+from libc.stdint cimport uint32_t, uint64_t
 from galois.cpp.libstd.boost cimport std_result
 from pyarrow.lib cimport CSchema, CChunkedArray, CArray, CTable, CUInt32Array, CUInt64Array
 
@@ -107,6 +107,23 @@ cdef extern from "galois/graphs/Graph.h" namespace "galois::graphs" nogil:
         uint64_t num_nodes()
         uint64_t num_edges()
 
+    cppclass PropertyMemoryUsage:
+        string name
+        uint64_t bytes
+        bint loaded
+        bint evictable
+
+    cppclass MemoryUsage:
+        uint64_t topology_bytes
+        uint64_t in_edges_bytes
+        uint64_t edge_types_bytes
+        uint64_t inline_edges_bytes
+        uint64_t file_view_bytes
+        vector[PropertyMemoryUsage] node_properties
+        vector[PropertyMemoryUsage] edge_properties
+        uint64_t property_bytes()
+        uint64_t total_bytes()
+
     cppclass PropertyFileGraph:
         PropertyFileGraph()
         @staticmethod
@@ -133,3 +150,31 @@ cdef extern from "galois/graphs/Graph.h" namespace "galois::graphs" nogil:
 
         std_result[void] RemoveNodeProperty(int)
         std_result[void] RemoveEdgeProperty(int)
+
+        MemoryUsage GetMemoryUsage()
+        void ReportMemoryUsage(string region)
+        void set_memory_budget(uint64_t bytes)
+        uint64_t memory_budget()
+        std_result[uint64_t] EnforceMemoryBudget()
+
+cdef extern from "galois/graphs/SharedMemoryGraph.h" namespace "galois::graphs" nogil:
+    std_result[void] ExportToSharedMemory(const PropertyFileGraph& pfg, string name)
+    std_result[unique_ptr[PropertyFileGraph]] AttachSharedMemory(string name)
+    std_result[void] RemoveSharedMemory(string name)
+
+cdef extern from "galois/graphs/Subgraph.h" namespace "galois::graphs" nogil:
+    std_result[unique_ptr[PropertyFileGraph]] ExtractInducedSubgraph(const PropertyFileGraph& pfg, vector[uint32_t] nodes,
+                                                                     vector[string] node_properties,
+                                                                     vector[string] edge_properties)
+    std_result[unique_ptr[PropertyFileGraph]] SampleNeighborhood(const PropertyFileGraph& pfg, vector[uint32_t] seeds,
+                                                                 vector[uint32_t] fanouts, uint64_t random_seed,
+                                                                 vector[string] node_properties,
+                                                                 vector[string] edge_properties)
+    std_result[vector[uint32_t]] RandomWalks(const GraphTopology& topology, vector[uint32_t] starts,
+                                             uint32_t walk_length, uint64_t random_seed)
+    std_result[unique_ptr[PropertyFileGraph]] SampleRandomWalks(const PropertyFileGraph& pfg, vector[uint32_t] starts,
+                                                                uint32_t walk_length, uint64_t random_seed,
+                                                                vector[string] node_properties,
+                                                                vector[string] edge_properties)
+    uint32_t kAllNeighbors
+    uint32_t kNoNode
@@ -2,7 +2,7 @@ import numpy as np
 import numba.types
 import pyarrow
 
-from galois.atomic import atomic_min, GAccumulator, GReduceMax
+from galois.atomic import atomic_relax_min, GAccumulator, GReduceMax
 from galois.datastructures import InsertBag
 from galois.loops import (
     for_each_operator,
@@ -37,7 +37,7 @@ def sssp_operator(g: PropertyGraph, dists: np.ndarray, edge_weights, item, ctx:
         dst = g.get_edge_dst(ii)
         edge_length = edge_weights[ii]
         new_distance = edge_length + dists[item.src]
-        old_distance = atomic_min(dists, dst, new_distance)
+        old_distance = atomic_relax_min(dists, dst, new_distance)
         if new_distance < old_distance:
             ctx.push((dst, new_distance))
 
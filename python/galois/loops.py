@@ -6,6 +6,7 @@ import numba.types
 
 from ._loops import (
     do_all,
+    do_all_chunks,
     for_each,
     OrderedByIntegerMetric,
     UserContext,
@@ -17,6 +18,8 @@ from .numba_support.galois_compiler import OperatorCompiler
 __all__ = [
     "do_all",
     "do_all_operator",
+    "do_all_chunks",
+    "do_all_chunk_operator",
     "for_each",
     "for_each_operator",
     "obim_metric",
@@ -73,6 +76,44 @@ def is_do_all_operator_closure(v):
     return isinstance(v, Closure) and len(v.unbound_argument_types) == 1
 
 
+def do_all_chunk_operator(typ=None, nopython=True, **kws):
+    """
+    >>> @do_all_chunk_operator()
+    ... def f(arg0, ..., argn, begin, end): ...
+
+    Decorator to declare an operator for use with a `do_all_chunks`, which calls it once per chunk ``range(begin, end)``
+    of the loop range instead of once per element.
+    The loop over the chunk is compiled with the body of the operator, so numba can inline and vectorize it, which
+    removes the call per element of `do_all_operator` for cheap operators.
+    Arguments are bound and operators are restricted as for `do_all_operator`.
+    """
+
+    def decorator(f):
+        n_args = f.__code__.co_argcount - 2
+        f_jit = numba.jit(typ, nopython=nopython, pipeline_class=OperatorCompiler, **kws)(f)
+        builder = wraps(f)(ClosureBuilder(f_jit, n_unbound_arguments=2))
+        if n_args == 0:
+            return builder()
+        return builder
+
+    return decorator
+
+
+def is_do_all_chunk_operator_cfunc(v):
+    try:
+        return isinstance(v, numba.core.ccallback.CFunc) and v.__wrapped__.__code__.co_argcount == 3
+    except AttributeError:
+        return False
+
+
+def is_do_all_chunk_operator_closure(v):
+    return (
+        isinstance(v, Closure)
+        and len(v.unbound_argument_types) == 2
+        and all(t == numba.types.uint64 for t in v.unbound_argument_types)
+    )
+
+
 def for_each_operator(typ=None, nopython=True, **kws):
     """
     >>> @for_each_operator()
@@ -1,10 +1,20 @@
+import numba
+from llvmlite import ir
 from numba import types
 from numba.core import cgutils
 from numba.core.typing.arraydecl import get_array_index_type
 from numba.extending import lower_builtin, type_callable
 from numba.np.arrayobj import make_array, normalize_indices, basic_indexing
 
-__all__ = ["atomic_add", "atomic_sub", "atomic_max", "atomic_min"]
+__all__ = [
+    "atomic_add",
+    "atomic_sub",
+    "atomic_max",
+    "atomic_min",
+    "atomic_relax_min",
+    "atomic_relax_max",
+    "atomic_relax_min_many",
+]
 
 
 def atomic_rmw(context, builder, op, arrayty, val, ptr):
@@ -13,7 +23,66 @@ def atomic_rmw(context, builder, op, arrayty, val, ptr):
     return builder.atomic_rmw(op, ptr, dataval, "monotonic")
 
 
-def declare_atomic_array_op(iop, uop, fop):
+def atomic_relax(context, builder, arrayty, val, ptr, less):
+    """
+    Emit a compare-and-swap loop that stores val to ptr while it is `less` than the stored value, and returns the
+    stored value it replaced or kept.
+
+    The stored value is read before any compare-and-swap, so updates that would not change it only read the cache
+    line instead of taking it exclusively. For the relaxations of SSSP and the like most updates are of that kind.
+    """
+    assert arrayty.aligned  # We probably have to have aligned arrays.
+    dtype = arrayty.dtype
+    dataval = context.get_value_as_data(builder, dtype, val)
+    llty = dataval.type
+    align = context.get_abi_sizeof(llty)
+    if isinstance(dtype, types.Float):
+        # cmpxchg only takes integers
+        intty = ir.IntType(align * 8)
+        cas_ptr = builder.bitcast(ptr, intty.as_pointer())
+
+        def to_int(v):
+            return builder.bitcast(v, intty)
+
+        def from_int(v):
+            return builder.bitcast(v, llty)
+
+    else:
+        cas_ptr = ptr
+
+        def to_int(v):
+            return v
+
+        from_int = to_int
+
+    entry = builder.block
+    loop = builder.append_basic_block("atomic_relax.loop")
+    swap = builder.append_basic_block("atomic_relax.swap")
+    done = builder.append_basic_block("atomic_relax.done")
+
+    first = builder.load_atomic(ptr, "monotonic", align)
+    builder.branch(loop)
+
+    builder.position_at_end(loop)
+    current = builder.phi(llty)
+    current.add_incoming(first, entry)
+    builder.cbranch(less(builder, dataval, current), swap, done)
+
+    builder.position_at_end(swap)
+    res = builder.cmpxchg(cas_ptr, to_int(current), to_int(dataval), "monotonic", "monotonic")
+    current.add_incoming(from_int(builder.extract_value(res, 0)), swap)
+    builder.cbranch(builder.extract_value(res, 1), done, loop)
+
+    builder.position_at_end(done)
+    return current
+
+
+def declare_array_element_op(lower_element):
+    """
+    Declare a numba builtin func(ary, i, v) on the element ary[i], which is lowered by
+    lower_element(context, builder, arrayty, val, ptr) with val already cast to the element type.
+    """
+
     def decorator(func):
         @type_callable(func)
         def func_type(context):
@@ -54,22 +123,53 @@ def declare_atomic_array_op(iop, uop, fop):
 
             # Store source value the given location
             val = context.cast(builder, val, valty, aryty.dtype)
-            op = None
-            if isinstance(aryty.dtype, types.Integer) and aryty.dtype.signed:
-                op = iop
-            elif isinstance(aryty.dtype, types.Integer) and not aryty.dtype.signed:
-                op = uop
-            elif isinstance(aryty.dtype, types.Float):
-                op = fop
-            if op is None:
-                raise TypeError("Atomic operation not supported on " + str(aryty))
-            return atomic_rmw(context, builder, op, aryty, val, dataptr)
+            return lower_element(context, builder, aryty, val, dataptr)
 
         return func
 
     return decorator
 
 
+def declare_atomic_array_op(iop, uop, fop):
+    def lower_element(context, builder, aryty, val, dataptr):
+        op = None
+        if isinstance(aryty.dtype, types.Integer) and aryty.dtype.signed:
+            op = iop
+        elif isinstance(aryty.dtype, types.Integer) and not aryty.dtype.signed:
+            op = uop
+        elif isinstance(aryty.dtype, types.Float):
+            op = fop
+        if op is None:
+            raise TypeError("Atomic operation not supported on " + str(aryty))
+        return atomic_rmw(context, builder, op, aryty, val, dataptr)
+
+    return declare_array_element_op(lower_element)
+
+
+def declare_atomic_relax_op(iop, fop):
+    def lower_element(context, builder, aryty, val, dataptr):
+        if isinstance(aryty.dtype, types.Integer) and aryty.dtype.signed:
+
+            def less(builder, a, b):
+                return builder.icmp_signed(iop, a, b)
+
+        elif isinstance(aryty.dtype, types.Integer) and not aryty.dtype.signed:
+
+            def less(builder, a, b):
+                return builder.icmp_unsigned(iop, a, b)
+
+        elif isinstance(aryty.dtype, types.Float):
+
+            def less(builder, a, b):
+                return builder.fcmp_ordered(fop, a, b)
+
+        else:
+            raise TypeError("Atomic operation not supported on " + str(aryty))
+        return atomic_relax(context, builder, aryty, val, dataptr, less)
+
+    return declare_array_element_op(lower_element)
+
+
 @declare_atomic_array_op("add", "add", "fadd")
 def atomic_add(ary, i, v):
     """
@@ -126,3 +226,59 @@ def atomic_min(ary, i, v):
     orig = ary[i]
     ary[i] = min(ary[i], v)
     return orig
+
+
+@declare_atomic_relax_op("<", "<")
+def atomic_relax_min(ary, i, v):
+    """
+    Atomically, perform `ary[i] = min(ary[i], v)` and return the previous value of `ary[i]`, like `atomic_min`.
+    Unlike `atomic_min`, this supports floating-point values.
+
+    `ary[i]` is read first and only written, with a compare-and-swap, if `v` is less. That makes it much cheaper than
+    `atomic_min` when most updates do not lower the value, as for the relaxations of SSSP.
+
+    i must be a simple index for a single element of ary. Broadcasting and vector operations are not supported.
+
+    This should be used from numba compiled code.
+    """
+    orig = ary[i]
+    ary[i] = min(ary[i], v)
+    return orig
+
+
+@declare_atomic_relax_op(">", ">")
+def atomic_relax_max(ary, i, v):
+    """
+    Atomically, perform `ary[i] = max(ary[i], v)` and return the previous value of `ary[i]`, like `atomic_max`.
+    Unlike `atomic_max`, this supports floating-point values.
+
+    `ary[i]` is read first and only written, with a compare-and-swap, if `v` is greater.
+
+    i must be a simple index for a single element of ary. Broadcasting and vector operations are not supported.
+
+    This should be used from numba compiled code.
+    """
+    orig = ary[i]
+    ary[i] = max(ary[i], v)
+    return orig
+
+
+@numba.njit(nogil=True)
+def atomic_relax_min_many(ary, indices, values, improved):
+    """
+    For each k, atomically perform `ary[indices[k]] = min(ary[indices[k]], values[k])` with `atomic_relax_min`, set
+    `improved[k]` to whether that lowered `ary[indices[k]]`, and return how many did, e.g., to relax all the edges of
+    a node in SSSP:
+
+    >>> if atomic_relax_min_many(dists, dsts, dist + weights, improved) > 0:
+    ...     for dst in dsts[improved]: ...
+
+    This may be called from numba compiled code.
+    """
+    count = 0
+    for k in range(len(indices)):
+        lowered = atomic_relax_min(ary, indices[k], values[k]) > values[k]
+        improved[k] = lowered
+        if lowered:
+            count += 1
+    return count
@@ -7,10 +7,14 @@ from galois.atomic import (
     GReduceMin,
     GReduceLogicalAnd,
     GReduceLogicalOr,
+    GVectorAccumulator,
     atomic_add,
     atomic_sub,
     atomic_max,
     atomic_min,
+    atomic_relax_min,
+    atomic_relax_max,
+    atomic_relax_min_many,
 )
 from galois.datastructures import LargeArray
 from galois.loops import do_all_operator, do_all
@@ -188,3 +192,78 @@ def test_atomic_min_parallel(dtype, threads_many):
     out = np.array([500], dtype=dtype)
     do_all(range(1000), f(out), steal=False)
     assert out[0] == 0
+
+
+@pytest.mark.parametrize("dtype", dtypes)
+def test_atomic_relax_min_parallel(dtype, threads_many):
+    @do_all_operator()
+    def f(out, i):
+        atomic_relax_min(out, i % 10, 1000 - i)
+
+    out = np.full(10, 500, dtype=dtype)
+    do_all(range(1000), f(out), steal=False)
+    assert list(out) == list(range(10, 0, -1))
+
+
+@pytest.mark.parametrize("dtype", dtypes)
+def test_atomic_relax_max_parallel(dtype, threads_many):
+    @do_all_operator()
+    def f(out, i):
+        atomic_relax_max(out, i % 10, i)
+
+    out = np.full(10, 500, dtype=dtype)
+    do_all(range(1000), f(out), steal=False)
+    assert list(out) == list(range(990, 1000))
+
+
+def test_atomic_relax_min_many(threads_many):
+    @do_all_operator()
+    def f(dists, dsts, i):
+        values = np.full(len(dsts), 1000 - i, dtype=dists.dtype)
+        improved = np.empty(len(dsts), dtype=np.bool_)
+        atomic_relax_min_many(dists, dsts, values, improved)
+
+    dists = np.full(4, np.inf)
+    dsts = np.array([1, 3], dtype=np.uint64)
+    do_all(range(1000), f(dists, dsts), steal=False)
+    assert list(dists) == [np.inf, 1, np.inf, 1]
+
+    improved = np.empty(3, dtype=np.bool_)
+    count = atomic_relax_min_many(dists, np.array([0, 1, 1]), np.array([5.0, 0.5, 2.0]), improved)
+    assert count == 2
+    assert list(improved) == [True, True, False]
+    assert list(dists) == [5.0, 0.5, np.inf, 1]
+
+
+@pytest.mark.parametrize("typ", types)
+def test_GVectorAccumulator(typ):
+    T = GVectorAccumulator[typ]
+    acc = T(10)
+    assert len(acc) == 10
+    acc.update(3, 2)
+    acc.update(3, 1)
+    assert list(acc.reduce()) == [0, 0, 0, 3, 0, 0, 0, 0, 0, 0]
+    with pytest.raises(IndexError):
+        acc.update(10, 1)
+    acc.reset()
+    assert list(acc.reduce()) == [0] * 10
+
+
+@pytest.mark.parametrize("typ", types)
+def test_GVectorAccumulator_parallel(typ, threads_many):
+    T = GVectorAccumulator[typ]
+    acc = T(7)
+
+    @do_all_operator()
+    def f(acc, i):
+        acc.update(i % 7, 1)
+
+    do_all(range(1000), f(acc), steal=False)
+    counts = acc.reduce()
+    assert list(counts) == [1000 // 7 + (1 if b < 1000 % 7 else 0) for b in range(7)]
+
+    out = np.full(7, 100, dtype=counts.dtype)
+    assert acc.reduce(out) is out
+    assert list(out) == list(counts)
+    with pytest.raises(ValueError):
+        acc.reduce(np.empty(3, dtype=counts.dtype))
@@ -1,4 +1,22 @@
-from galois.analytics import bfs, sssp
+import asyncio
+
+import numpy as np
+
+from galois.analytics import bfs_async, sssp_async
+from galois.analytics import sssp_landmarks, sssp_point_to_point_landmarks, SsspLandmarkSelection
+from galois.analytics import personalized_pagerank
+from galois.analytics import bfs, sssp, sssp_point_to_point, pagerank, BfsPlan, SsspPlan, PagerankPlan, multi_source_bfs, multi_source_reachability
+from galois.analytics import connected_components, connected_components_incremental, ConnectedComponentsPlan
+from galois.analytics import jaccard, top_k_similar_nodes, Similarity, JaccardPlan
+from galois.analytics import k_core, KCorePlan
+from galois.analytics import k_truss, KTrussPlan
+from galois.analytics import independent_set, IndependentSetPlan
+from galois.analytics import graph_coloring, GraphColoringPlan
+from galois.analytics import minimum_spanning_forest, MinimumSpanningForestPlan
+from galois.analytics import bipartite_matching, BipartiteMatchingPlan
+from galois.analytics import random_walks, RandomWalksPlan
+from galois.analytics import partition_quality
+from galois.analytics import triangle_count, local_clustering_coefficient, estimate_triangle_count, TriangleCountPlan
 from galois.property_graph import PropertyGraph
 from pyarrow import Schema
 
@@ -25,6 +43,58 @@ def test_bfs(property_graph: PropertyGraph):
     # TODO: This should assert that the results are correct.
 
 
+def test_bfs_direction_opt(property_graph: PropertyGraph):
+    property_name = "NewProp"
+    start_node = 0
+
+    bfs(property_graph, start_node, property_name, BfsPlan.sync_direction_opt())
+
+    new_property_id = len(property_graph.node_schema()) - 1
+    assert property_graph.get_node_property(property_name)[start_node].as_py() == 0
+
+    verify_bfs(property_graph, start_node, new_property_id)
+
+
+def test_bfs_dense_frontier(property_graph: PropertyGraph):
+    property_name = "NewProp"
+    start_node = 0
+
+    # a large divisor makes nearly every frontier dense
+    bfs(property_graph, start_node, property_name, BfsPlan.sync(1000))
+
+    new_property_id = len(property_graph.node_schema()) - 1
+    assert property_graph.get_node_property(property_name)[start_node].as_py() == 0
+
+    verify_bfs(property_graph, start_node, new_property_id)
+
+
+def test_multi_source_bfs(property_graph: PropertyGraph):
+    sources = list(range(70))
+    names = ["Level{}".format(s) for s in sources]
+
+    multi_source_bfs(property_graph, sources, names)
+
+    for source in [0, 1, 69]:
+        bfs(property_graph, source, "Single{}".format(source))
+        levels = property_graph.get_node_property(names[source])
+        assert levels[source].as_py() == 0
+        assert levels == property_graph.get_node_property("Single{}".format(source))
+
+
+def test_multi_source_reachability(property_graph: PropertyGraph):
+    sources = list(range(70))
+
+    multi_source_reachability(property_graph, sources, ["Reach0", "Reach1"])
+
+    reach = property_graph.get_node_property("Reach1")
+    bfs(property_graph, 69, "Single69")
+    levels = property_graph.get_node_property("Single69")
+    # sources[69] is bit 5 of the second batch
+    infinity = (2 ** 32 - 1) // 4
+    for n in range(0, len(levels), 97):
+        assert bool(reach[n].as_py() >> 5 & 1) == (levels[n].as_py() != infinity)
+
+
 def test_sssp(property_graph: PropertyGraph):
     property_name = "NewProp"
     start_node = 0
@@ -44,4 +114,347 @@ def test_sssp(property_graph: PropertyGraph):
     # TODO: This should assert that the results are correct.
 
 
+def test_bfs_sssp_async(property_graph: PropertyGraph):
+    start_node = 0
+
+    call = bfs_async(property_graph, start_node, "level", BfsPlan.sync())
+    call.wait()
+    assert call.ready()
+    assert call.rounds > 0
+    bfs(property_graph, start_node, "level_sync", BfsPlan.sync())
+    assert property_graph.get_node_property("level") == property_graph.get_node_property("level_sync")
+
+    async def run():
+        return await sssp_async(property_graph, start_node, "workFrom", "distance")
+
+    asyncio.run(run())
+    new_property_id = property_graph.node_schema().names.index("distance")
+    verify_sssp(property_graph, start_node, new_property_id)
+
+
+def test_sssp_topo(property_graph: PropertyGraph):
+    property_name = "NewProp"
+    start_node = 0
+
+    sssp(property_graph, start_node, "workFrom", property_name, SsspPlan.topo())
+
+    new_property_id = len(property_graph.node_schema()) - 1
+    assert property_graph.get_node_property(property_name)[start_node].as_py() == 0
+
+    verify_sssp(property_graph, start_node, new_property_id)
+
+
+def test_sssp_delta_step_fusion(property_graph: PropertyGraph):
+    property_name = "NewProp"
+    start_node = 0
+
+    sssp(property_graph, start_node, "workFrom", property_name, SsspPlan.delta_step_fusion())
+
+    new_property_id = len(property_graph.node_schema()) - 1
+    assert property_graph.get_node_property(property_name)[start_node].as_py() == 0
+
+    verify_sssp(property_graph, start_node, new_property_id)
+
+
+def test_sssp_delta_step_pmod(property_graph: PropertyGraph):
+    property_name = "NewProp"
+    start_node = 0
+
+    sssp(property_graph, start_node, "workFrom", property_name, SsspPlan.delta_step_pmod())
+
+    new_property_id = len(property_graph.node_schema()) - 1
+    assert property_graph.get_node_property(property_name)[start_node].as_py() == 0
+
+    verify_sssp(property_graph, start_node, new_property_id)
+
+
+def test_sssp_multi_queue(property_graph: PropertyGraph):
+    property_name = "NewProp"
+    start_node = 0
+
+    sssp(property_graph, start_node, "workFrom", property_name, SsspPlan.multi_queue())
+
+    new_property_id = len(property_graph.node_schema()) - 1
+    assert property_graph.get_node_property(property_name)[start_node].as_py() == 0
+
+    verify_sssp(property_graph, start_node, new_property_id)
+
+
+
+def test_sssp_point_to_point(property_graph: PropertyGraph):
+    property_name = "NewProp"
+    start_node = 0
+
+    sssp(property_graph, start_node, "workFrom", property_name, SsspPlan.dijkstra())
+    distances = property_graph.get_node_property(property_name)
+
+    assert sssp_point_to_point(property_graph, start_node, start_node, "workFrom") == 0
+    for target in range(0, len(distances), max(1, len(distances) // 16)):
+        expected = distances[target].as_py()
+        found = sssp_point_to_point(property_graph, start_node, target, "workFrom")
+        found_bidirectional = sssp_point_to_point(property_graph, start_node, target, "workFrom", bidirectional=True)
+        assert found == found_bidirectional
+        if found != float("inf"):
+            assert found == expected
+
+
+def test_sssp_point_to_point_landmarks(property_graph: PropertyGraph):
+    start_node = 0
+
+    sssp(property_graph, start_node, "workFrom", "NewProp", SsspPlan.dijkstra())
+    distances = property_graph.get_node_property("NewProp")
+
+    for selection in [SsspLandmarkSelection.Farthest, SsspLandmarkSelection.Degree]:
+        prefix = f"Landmark{selection.name}"
+        landmarks = sssp_landmarks(property_graph, "workFrom", 4, prefix, selection)
+        assert len(set(landmarks)) == len(landmarks) == 4
+
+        for target in range(0, len(distances), max(1, len(distances) // 16)):
+            expected = sssp_point_to_point(property_graph, start_node, target, "workFrom")
+            found = sssp_point_to_point_landmarks(property_graph, start_node, target, "workFrom", prefix)
+            assert found == expected
+
+
+def test_pagerank(property_graph: PropertyGraph):
+    property_name = "NewProp"
+
+    pagerank(property_graph, property_name)
+
+    node_schema: Schema = property_graph.node_schema()
+    assert node_schema.names[len(node_schema) - 1] == property_name
+
+    ranks = property_graph.get_node_property(property_name).to_numpy()
+    assert (ranks >= 1 - PagerankPlan.automatic().alpha - 1e-3).all()
+
+
+def test_pagerank_plans_agree(property_graph: PropertyGraph):
+    plans = [
+        PagerankPlan.pull_topological(tolerance=1e-5),
+        PagerankPlan.pull_residual(tolerance=1e-5),
+        PagerankPlan.push_asynchronous(tolerance=1e-5),
+        PagerankPlan.push_synchronous(tolerance=1e-5),
+        # small bins so that the test graph spans several
+        PagerankPlan.propagation_blocking(tolerance=1e-5, bin_shift=6),
+    ]
+    results = []
+    for i, plan in enumerate(plans):
+        property_name = "Rank{}".format(i)
+        pagerank(property_graph, property_name, plan)
+        results.append(property_graph.get_node_property(property_name).to_numpy())
+
+    for ranks in results[1:]:
+        assert (abs(ranks - results[0]) <= 1e-2 * (1 + results[0])).all()
+
+
+def test_personalized_pagerank(property_graph: PropertyGraph):
+    alpha = PagerankPlan.automatic().alpha
+    seeds = [0, 1, 2, 0]
+    results = personalized_pagerank(property_graph, seeds, 10, epsilon=1e-5)
+
+    assert len(results) == len(seeds)
+    assert results[0] == results[3]
+    for seed, top in zip(seeds, results):
+        assert 0 < len(top) <= 10
+        ranks = [rank for _, rank in top]
+        assert ranks == sorted(ranks, reverse=True)
+        assert sum(ranks) <= 1 + 1e-6
+        # the first push keeps 1 - alpha at the seed, so fewer than seven nodes
+        # can outrank it
+        assert dict(top)[seed] >= 1 - alpha - 1e-6
+
+    coarse = personalized_pagerank(property_graph, [0], 1, epsilon=1e-2)
+    assert len(coarse[0]) <= 1
+
+    plans = [
+        ConnectedComponentsPlan.automatic(),
+        ConnectedComponentsPlan.serial(),
+        ConnectedComponentsPlan.label_prop(),
+        ConnectedComponentsPlan.synchronous(),
+        ConnectedComponentsPlan.edge_tiled_asynchronous(edge_tile_size=4),
+        ConnectedComponentsPlan.afforest(),
+        ConnectedComponentsPlan.edge_afforest(),
+        ConnectedComponentsPlan.edge_tiled_afforest(edge_tile_size=4),
+    ]
+    for i, plan in enumerate(plans):
+        property_name = "Component{}".format(i)
+        connected_components(property_graph, property_name, plan)
+
+        components = property_graph.get_node_property(property_name).to_numpy()
+        # every component is labeled by its smallest node, which labels itself
+        assert (components <= range(len(components))).all()
+        assert (components[components] == components).all()
+
+
+def test_connected_components_incremental(property_graph: PropertyGraph):
+    connected_components(property_graph, "Component", ConnectedComponentsPlan.serial())
+    before = property_graph.get_node_property("Component").to_numpy()
+
+    n = len(before)
+    new_edges = [(n - 1, 0), (n // 2, n // 3)]
+    connected_components_incremental(property_graph, "Component", new_edges, compress=True)
+    after = property_graph.get_node_property("Component").to_numpy()
+
+    expected = before.copy()
+    for src, dest in new_edges:
+        low = min(expected[src], expected[dest])
+        high = max(expected[src], expected[dest])
+        expected[expected == high] = low
+    assert (after == expected).all()
+
+
+def test_partition_quality(property_graph: PropertyGraph):
+    num_nodes = property_graph.num_nodes()
+    num_edges = property_graph.num_edges()
+
+    # no edge leaves a component
+    connected_components(property_graph, "Component", ConnectedComponentsPlan.serial())
+    quality = partition_quality(property_graph, "Component")
+    assert quality["edge_cut"] == 0
+    assert quality["communication_volume"] == 0
+    assert quality["max_conductance"] == 0
+    assert sum(quality["part_sizes"]) == num_nodes
+    assert sum(quality["part_volumes"]) == num_edges
+    assert quality["balance"] >= 1
+
+    # a single part holds every edge and has modularity 0
+    property_graph.add_node_property(dict(Whole=np.zeros(num_nodes, dtype=np.uint32)))
+    quality = partition_quality(property_graph, "Whole", "workFrom")
+    assert quality["part_sizes"] == [num_nodes]
+    assert quality["edge_cut"] == 0
+    assert quality["balance"] == 1
+    assert abs(quality["modularity"]) < 1e-9
+
+    compare_node = 0
+    jaccard(property_graph, compare_node, "Similarity", JaccardPlan.unsorted())
+    similarity = property_graph.get_node_property("Similarity").to_numpy()
+
+    assert similarity[compare_node] == 1
+    assert ((similarity >= 0) & (similarity <= 1)).all()
+
+
+def test_top_k_similar_nodes(property_graph: PropertyGraph):
+    queries = [0, 1, 2]
+    k = 5
+    results = top_k_similar_nodes(property_graph, queries, k)
+
+    assert len(results) == len(queries)
+    for query, top in zip(queries, results):
+        assert len(top) <= k
+        assert query not in [node for node, _ in top]
+        similarities = [s for _, s in top]
+        assert similarities == sorted(similarities, reverse=True)
+
+    for measure in Similarity:
+        assert len(top_k_similar_nodes(property_graph, queries, k, measure)) == len(queries)
+
+
+def test_k_core(property_graph: PropertyGraph):
+    k_core(property_graph, "Coreness")
+    coreness = property_graph.get_node_property("Coreness").to_numpy()
+
+    k_core(property_graph, "CorenessSync", KCorePlan.synchronous())
+    coreness_sync = property_graph.get_node_property("CorenessSync").to_numpy()
+
+    assert (coreness == coreness_sync).all()
+    assert all(coreness[n] <= len(property_graph.edges(n)) for n in range(len(coreness)))
+
+
+def test_k_truss(property_graph: PropertyGraph):
+    k_truss(property_graph, "Trussness", KTrussPlan.bucketed())
+    trussness = property_graph.get_edge_property("Trussness").to_numpy()
+
+    for n in range(len(property_graph)):
+        for e in property_graph.edges(n):
+            if property_graph.get_edge_dst(e) == n:
+                assert trussness[e] == 0
+            else:
+                assert trussness[e] >= 2
+
+
+
+def test_independent_set(property_graph: PropertyGraph):
+    independent_set(property_graph, "InSet")
+    in_set = property_graph.get_node_property("InSet").to_numpy()
+
+    independent_set(property_graph, "InSetSerial", IndependentSetPlan.serial())
+    in_set_serial = property_graph.get_node_property("InSetSerial").to_numpy()
+
+    assert ((in_set == 0) | (in_set == 1)).all()
+    assert ((in_set_serial == 0) | (in_set_serial == 1)).all()
+    assert in_set.any()
+    assert in_set_serial.any()
+
+
+def test_graph_coloring(property_graph: PropertyGraph):
+    graph_coloring(property_graph, "Color", GraphColoringPlan.jones_plassmann())
+    color = property_graph.get_node_property("Color").to_numpy()
+
+    assert all(color[n] <= len(property_graph.edges(n)) for n in range(len(color)))
+
+
+def test_minimum_spanning_forest(property_graph: PropertyGraph):
+    minimum_spanning_forest(property_graph, "workFrom", "InForest", MinimumSpanningForestPlan.boruvka())
+    minimum_spanning_forest(property_graph, "workFrom", "InForestKruskal", MinimumSpanningForestPlan.filter_kruskal())
+    in_forest = property_graph.get_edge_property("InForest").to_numpy()
+    in_forest_kruskal = property_graph.get_edge_property("InForestKruskal").to_numpy()
+
+    assert (in_forest == in_forest_kruskal).all()
+    assert 0 < in_forest.sum() < len(property_graph)
+    assert all(
+        property_graph.get_edge_dst(e) != n for n in range(len(property_graph)) for e in property_graph.edges(n) if in_forest[e]
+    )
+
+
+def test_bipartite_matching(property_graph: PropertyGraph):
+    bipartite_matching(property_graph, "Matched", BipartiteMatchingPlan.hopcroft_karp())
+    bipartite_matching(property_graph, "MatchedPushRelabel", BipartiteMatchingPlan.push_relabel())
+    matched = property_graph.get_edge_property("Matched").to_numpy()
+    matched_push_relabel = property_graph.get_edge_property("MatchedPushRelabel").to_numpy()
+
+    assert 0 < matched.sum() == matched_push_relabel.sum()
+    for flags in (matched, matched_push_relabel):
+        dests = [property_graph.get_edge_dst(e) for n in range(len(property_graph)) for e in property_graph.edges(n) if flags[e]]
+        assert len(set(dests)) == len(dests)
+        assert all(sum(flags[e] for e in property_graph.edges(n)) <= 1 for n in range(len(property_graph)))
+
+
+def test_random_walks(property_graph: PropertyGraph, tmp_path):
+    num_nodes = len(property_graph)
+    walks = random_walks(property_graph, RandomWalksPlan.uniform(5, 2), seed=1)
+    assert walks.num_rows == 2 * num_nodes
+    walk_lists = walks.column("walk").to_pylist()
+    for w, walk in enumerate(walk_lists):
+        assert walk[0] == w % num_nodes
+        assert 1 <= len(walk) <= 6
+        for src, dst in zip(walk, walk[1:]):
+            assert dst in [property_graph.get_edge_dst(e) for e in property_graph.edges(src)]
+    assert random_walks(property_graph, RandomWalksPlan.uniform(5, 2), seed=1).equals(walks)
+
+    output = tmp_path / "walks.parquet"
+    weighted = random_walks(property_graph, RandomWalksPlan.weighted(5, 1), "workFrom", output_uri=str(output))
+    assert weighted.num_rows == num_nodes
+    assert output.exists()
+
+    node2vec = random_walks(property_graph, RandomWalksPlan.node2vec(5, 1, return_parameter=0.5, in_out_parameter=2))
+    assert node2vec.num_rows == num_nodes
+
+
+def test_triangle_count(property_graph: PropertyGraph):
+    total = triangle_count(property_graph)
+    assert total == triangle_count(property_graph, "Triangles", TriangleCountPlan.degree_ordered_dag())
+
+    per_node = property_graph.get_node_property("Triangles").to_numpy()
+    assert per_node.sum() == 3 * total
+
+    local_clustering_coefficient(property_graph, "Clustering")
+    clustering = property_graph.get_node_property("Clustering").to_numpy()
+    assert ((clustering >= 0) & (clustering <= 1)).all()
+    assert ((clustering > 0) == (per_node > 0)).all()
+
+
+def test_estimate_triangle_count(property_graph: PropertyGraph):
+    estimate, lower_bound, upper_bound = estimate_triangle_count(property_graph, 10000, seed=1)
+    assert 0 <= lower_bound <= estimate <= upper_bound
+    assert estimate_triangle_count(property_graph, 10000, seed=1) == (estimate, lower_bound, upper_bound)
+
 # TODO: Add more tests.
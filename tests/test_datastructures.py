@@ -78,6 +78,32 @@ def test_InsertBag_parallel_opaque():
         assert s.x == pytest.approx(s.y / 2.0)
 
 
+@pytest.mark.parametrize("typ", types)
+def test_InsertBag_numpy(typ):
+    T = InsertBag[typ]
+    bag = T()
+    assert len(bag.to_numpy()) == 0
+    bag.push_many(np.arange(10000))
+    bag.push(3)
+    arr = bag.to_numpy()
+    assert arr.dtype == bag.dtype
+    assert list(arr) == list(bag)
+    assert sorted(arr) == sorted(list(range(10000)) + [3])
+
+
+def test_InsertBag_numpy_opaque_extra_space():
+    dt = np.dtype([("x", np.int8), ("y", np.int8),], align=True)
+    bag = InsertBag[dt]()
+    values = np.array([(i % 100, i % 7) for i in range(3000)], dtype=dt)
+    bag.push_many(values)
+    arr = bag.to_numpy()
+    assert arr.dtype == dt
+    assert sorted(arr.tolist()) == sorted(values.tolist())
+    for s, v in zip(bag, arr):
+        assert s.x == v["x"]
+        assert s.y == v["y"]
+
+
 @pytest.mark.parametrize("typ", types)
 def test_LargeArray_simple(typ):
     T = LargeArray[typ]
@@ -186,6 +212,16 @@ def test_LargeArray_numpy(typ):
         arr[10] = 0
 
 
+@pytest.mark.parametrize("typ", types)
+def test_LargeArray_asarray(typ):
+    larr = LargeArray[typ](5, AllocationPolicy.INTERLEAVED)
+    arr = np.asarray(larr)
+    arr[:] = np.arange(5)
+    assert list(larr) == [0, 1, 2, 3, 4]
+    assert np.sum(larr) == 10
+    assert np.asarray(larr, dtype=np.float64).dtype == np.float64
+
+
 @pytest.mark.parametrize("typ", types)
 def test_LargeArray_numpy_parallel(typ):
     T = LargeArray[typ]
@@ -6,6 +6,8 @@ import pytest
 from numba import from_dtype
 
 from galois.loops import (
+    do_all_chunk_operator,
+    do_all_chunks,
     do_all_operator,
     do_all,
     for_each_operator,
@@ -101,6 +103,42 @@ def test_do_all(modes):
     assert np.allclose(out, np.array(range(1, 11)))
 
 
+@pytest.mark.parametrize("modes", simple_modes)
+def test_do_all_chunks(modes):
+    @do_all_chunk_operator()
+    def f(out, begin, end):
+        for i in range(begin, end):
+            out[i] = i + 1
+
+    out = np.zeros(10000, dtype=int)
+    do_all_chunks(range(10000), f(out), chunk_size=64, **modes)
+    assert np.allclose(out, np.arange(1, 10001))
+
+    out = np.zeros(10, dtype=int)
+    do_all_chunks(range(3, 10), f(out), chunk_size=4, **modes)
+    assert np.allclose(out, np.array([0, 0, 0, 4, 5, 6, 7, 8, 9, 10]))
+
+
+def test_do_all_chunks_python():
+    chunks = []
+
+    def f(begin, end):
+        chunks.append((begin, end))
+
+    do_all_chunks(range(10), f, chunk_size=4)
+    assert sorted(chunks) == [(0, 4), (4, 8), (8, 10)]
+
+
+def test_do_all_chunks_wrong_closure():
+    @do_all_operator()
+    def f(out, i):
+        out[i] = i + 1
+
+    out = np.zeros(10, dtype=int)
+    with pytest.raises(TypeError):
+        do_all_chunks(range(10), f(out))
+
+
 @pytest.mark.parametrize("modes", simple_modes)
 def test_do_all_opaque(modes):
     from galois.datastructures import InsertBag
@@ -6,7 +6,7 @@ import pyarrow
 import pytest
 
 from galois.loops import do_all_operator, do_all
-from galois.property_graph import PropertyGraph
+from galois.property_graph import PropertyGraph, remove_shared_memory, ALL_NEIGHBORS, NO_NODE
 from galois import TsubaError
 
 
@@ -36,6 +36,58 @@ def test_nodes_count_edges(property_graph):
     assert property_graph.num_edges() == total
 
 
+def test_out_indices_out_dests(property_graph):
+    indices = property_graph.out_indices()
+    dests = property_graph.out_dests()
+    assert isinstance(indices, pyarrow.UInt64Array)
+    assert len(indices) == property_graph.num_nodes()
+    assert len(dests) == property_graph.num_edges()
+    assert indices.to_numpy()[-1] == property_graph.num_edges()
+    assert list(dests.to_numpy()[property_graph.edges(10)]) == [2011, 1422, 1409, 4798, 9483]
+
+
+def test_out_degrees(property_graph):
+    degrees = property_graph.out_degrees()
+    assert len(degrees) == property_graph.num_nodes()
+    assert degrees.sum() == property_graph.num_edges()
+    assert degrees[10] == 5
+    assert list(property_graph.out_degrees([10, 0, 10])) == [5, degrees[0], 5]
+
+
+def test_csr_slice(property_graph):
+    nodes = np.array([10, 0, 29091, 10])
+    out_indices, out_dests, edge_ids = property_graph.csr_slice(nodes)
+    assert list(out_indices) == list(np.cumsum(property_graph.out_degrees(nodes)))
+    expected = [e for n in nodes for e in property_graph.edges(n)]
+    assert list(edge_ids) == expected
+    assert list(out_dests) == [property_graph.get_edge_dst(e) for e in expected]
+    assert list(property_graph.neighbors(nodes)) == list(out_dests)
+    assert len(property_graph.neighbors([])) == 0
+    with pytest.raises(IndexError):
+        property_graph.neighbors([property_graph.num_nodes()])
+
+
+def test_property_numpy_views(property_graph):
+    n = property_graph.num_nodes()
+    property_graph.add_node_property(dict(rank=np.zeros(n)))
+
+    @do_all_operator()
+    def f(indices, rank, node):
+        begin = 0 if node == 0 else indices[node - 1]
+        rank[node] = indices[node] - begin
+
+    rank = property_graph.get_node_property_numpy("rank")
+    do_all(range(n), f(property_graph.out_indices().to_numpy(), rank))
+    assert property_graph.get_node_property("rank")[10].as_py() == 5.0
+    assert rank.sum() == property_graph.num_edges()
+
+    with pytest.raises(TypeError):
+        property_graph.get_node_property_numpy("title")
+    with pytest.raises(TypeError):
+        # booleans are stored as bits
+        property_graph.get_edge_property_numpy(15)
+
+
 def test_get_node_property_exception(property_graph):
     # with pytest.raises(RuntimeError):
     #     prop1 = property_graph.get_node_property(100)
@@ -83,6 +135,18 @@ def test_add_node_property(property_graph):
     assert property_graph.get_node_property("new_prop") == pyarrow.array(range(property_graph.num_nodes()))
 
 
+def test_add_node_properties_at_once(property_graph):
+    n = property_graph.num_nodes()
+    property_graph.add_node_property(dict(a=np.arange(n), b=np.ones(n)))
+    batch = pyarrow.RecordBatch.from_arrays([pyarrow.array(range(n))], names=["c"])
+    property_graph.add_node_property(batch)
+    assert len(property_graph.node_schema()) == 34
+    assert property_graph.get_node_property("b")[7].as_py() == 1.0
+    assert property_graph.get_node_property("c")[7].as_py() == 7
+    with pytest.raises(TypeError):
+        property_graph.add_node_property([1, 2])
+
+
 def test_get_edge_property(property_graph):
     prop1 = property_graph.get_edge_property(15)
     assert prop1[10].as_py() == False
@@ -123,6 +187,106 @@ def test_add_edge_property(property_graph):
     assert property_graph.get_edge_property("new_prop") == pyarrow.array(range(property_graph.num_edges()))
 
 
+def test_shared_memory(property_graph):
+    name = "test-property-graph-{}".format(os.getpid())
+    property_graph.add_node_property(dict(rank=np.arange(property_graph.num_nodes(), dtype=np.float64)))
+    property_graph.export_to_shared_memory(name)
+    try:
+        attached = PropertyGraph.attach_shared_memory(name)
+    finally:
+        remove_shared_memory(name)
+
+    assert attached.num_nodes() == property_graph.num_nodes()
+    assert attached.num_edges() == property_graph.num_edges()
+    assert attached.out_dests().equals(property_graph.out_dests())
+    assert attached.node_schema().names == property_graph.node_schema().names
+    assert attached.get_node_property(0) == property_graph.get_node_property(0)
+
+    rank = attached.get_node_property_numpy("rank")
+    assert rank[10] == 10.0
+    assert not rank.flags.writeable
+
+    with pytest.raises(Exception):
+        PropertyGraph.attach_shared_memory(name)
+
+
+def test_memory_usage(property_graph):
+    property_graph.add_node_property(dict(rank=np.arange(property_graph.num_nodes(), dtype=np.float64)))
+    usage = property_graph.memory_usage()
+
+    assert usage["topology"] >= 8 * property_graph.num_nodes() + 4 * property_graph.num_edges()
+    rank = usage["node_properties"]["rank"]
+    assert rank["loaded"]
+    assert not rank["evictable"]
+    assert rank["bytes"] >= 8 * property_graph.num_nodes()
+    assert usage["node_properties"][property_graph.node_schema()[0].name]["evictable"]
+
+    property_bytes = sum(
+        p["bytes"] for props in (usage["node_properties"], usage["edge_properties"]) for p in props.values()
+    )
+    assert usage["total"] == (
+        usage["topology"] + usage["in_edges"] + usage["edge_types"] + usage["inline_edges"] + property_bytes
+    )
+
+
+def test_memory_budget(property_graph):
+    name = property_graph.node_schema()[0].name
+    values = property_graph.get_node_property(0)
+    property_graph.add_node_property(dict(rank=np.arange(property_graph.num_nodes(), dtype=np.float64)))
+
+    property_graph.memory_budget = 1
+    assert property_graph.memory_budget == 1
+    assert property_graph.enforce_memory_budget() > 0
+    usage = property_graph.memory_usage()
+    # added properties have no stored copy to load again
+    assert usage["node_properties"]["rank"]["loaded"]
+    assert not any(
+        p["evictable"] for props in (usage["node_properties"], usage["edge_properties"]) for p in props.values()
+    )
+
+    # fetched again on use
+    assert property_graph.get_node_property(0) == values
+    assert property_graph.memory_usage()["node_properties"][name]["loaded"]
+
+
+def test_induced_subgraph(property_graph):
+    nodes = [10] + list(property_graph.neighbors([10]))
+    sub = property_graph.induced_subgraph(nodes, node_properties=[], edge_properties=[])
+    assert sub.num_nodes() == len(set(nodes))
+    assert list(sub.out_dests().to_numpy()[sub.edges(0)]) == list(range(1, len(nodes)))
+    assert sub.get_node_property("parent_node_id").to_pylist() == nodes
+    assert sub.node_schema().names == ["parent_node_id"]
+
+    with pytest.raises(Exception):
+        property_graph.induced_subgraph([10, 10])
+
+
+def test_sample_neighborhood(property_graph):
+    sub = property_graph.sample_neighborhood([10], [2, ALL_NEIGHBORS], seed=3, node_properties=[], edge_properties=[])
+    assert sub.get_node_property("parent_node_id")[0].as_py() == 10
+    assert len(sub.edges(0)) == 2
+    parent_edges = sub.get_edge_property("parent_edge_id").to_numpy()
+    assert set(parent_edges[sub.edges(0)]) <= set(property_graph.edges(10))
+    again = property_graph.sample_neighborhood([10], [2, ALL_NEIGHBORS], seed=3, node_properties=[], edge_properties=[])
+    assert again.out_dests().equals(sub.out_dests())
+
+
+def test_random_walks(property_graph):
+    walks = property_graph.random_walks([10, 20], 4, seed=5)
+    assert walks.shape == (2, 5)
+    assert list(walks[:, 0]) == [10, 20]
+    dests = property_graph.out_dests().to_numpy()
+    for walk in walks:
+        for a, b in zip(walk[:-1], walk[1:]):
+            if a == NO_NODE:
+                break
+            assert b == NO_NODE or b in dests[property_graph.edges(a)]
+
+    sub = property_graph.sample_random_walks([10, 20], 4, seed=5, node_properties=[], edge_properties=[])
+    visited = set(walks.flatten()) - {NO_NODE}
+    assert set(sub.get_node_property("parent_node_id").to_pylist()) == visited
+
+
 def test_load_invalid_path():
     with pytest.raises(TsubaError):
         PropertyGraph("non-existent")
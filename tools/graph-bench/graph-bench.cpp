@@ -0,0 +1,269 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+#include <llvm/Support/CommandLine.h>
+#include <nlohmann/json.hpp>
+
+#include "galois/Galois.h"
+#include "galois/JSON.h"
+#include "galois/Logging.h"
+#include "galois/analytics/bfs/bfs.h"
+#include "galois/analytics/connected_components/connected_components.h"
+#include "galois/analytics/k_core/k_core.h"
+#include "galois/analytics/pagerank/pagerank.h"
+#include "galois/analytics/sssp/sssp.h"
+#include "galois/analytics/triangle_count/triangle_count.h"
+#include "galois/graphs/PropertyFileGraph.h"
+
+#ifndef GALOIS_BENCH_VERSION
+#define GALOIS_BENCH_VERSION "unknown"
+#endif
+
+namespace cll = llvm::cl;
+
+namespace {
+
+cll::list<std::string> inputs(
+    cll::Positional, cll::desc("<input rdg>..."), cll::OneOrMore);
+cll::list<unsigned> thread_counts(
+    "threads",
+    cll::desc("Comma separated thread counts to run with (default: the "
+              "maximum usable)"),
+    cll::CommaSeparated);
+cll::list<std::string> algorithm_names(
+    "algos",
+    cll::desc("Comma separated algorithms to run: bfs, sssp, cc, pagerank, "
+              "tc, kcore (default: all)"),
+    cll::CommaSeparated);
+cll::opt<unsigned> warmup(
+    "warmup", cll::desc("Untimed runs before the timed ones (default 1)"),
+    cll::init(1));
+cll::opt<unsigned> repetitions(
+    "repetitions", cll::desc("Timed runs of each algorithm (default 5)"),
+    cll::init(5));
+cll::opt<unsigned> start_node(
+    "startNode", cll::desc("Source of bfs and sssp (default 0)"),
+    cll::init(0));
+cll::opt<std::string> edge_weight_property(
+    "edgePropertyName",
+    cll::desc("Edge weights of sssp (default: the first edge property; sssp "
+              "is skipped if there is none)"),
+    cll::init(""));
+cll::opt<std::string> output_file(
+    "output", cll::desc("Write the JSON report here instead of to stdout"),
+    cll::init(""));
+
+constexpr const char* kOutputProperty = "graph-bench-output";
+
+/// One analytics call, which leaves its result, if any, in kOutputProperty
+struct Algorithm {
+  std::string name;
+  std::function<galois::Result<void>(galois::graphs::PropertyFileGraph*)> run;
+  bool has_output;
+};
+
+std::vector<Algorithm>
+MakeAlgorithms(const galois::graphs::PropertyFileGraph& pfg) {
+  namespace ga = galois::analytics;
+
+  std::string weight = edge_weight_property;
+  if (weight.empty() && pfg.edge_schema()->num_fields() > 0) {
+    weight = pfg.edge_schema()->field(0)->name();
+  }
+
+  std::vector<Algorithm> all{
+      {"bfs",
+       [](auto* g) { return ga::Bfs(g, start_node, kOutputProperty); }, true},
+      {"sssp",
+       [weight](auto* g) {
+         return ga::Sssp(g, start_node, weight, kOutputProperty);
+       },
+       true},
+      {"cc",
+       [](auto* g) { return ga::ConnectedComponents(g, kOutputProperty); },
+       true},
+      {"pagerank", [](auto* g) { return ga::Pagerank(g, kOutputProperty); },
+       true},
+      {"tc",
+       [](auto* g) -> galois::Result<void> {
+         if (auto res = ga::TriangleCount(g); !res) {
+           return res.error();
+         }
+         return galois::ResultSuccess();
+       },
+       false},
+      {"kcore", [](auto* g) { return ga::KCore(g, kOutputProperty); }, true},
+  };
+
+  std::vector<Algorithm> selected;
+  for (Algorithm& algorithm : all) {
+    if (!algorithm_names.empty() &&
+        std::find(
+            algorithm_names.begin(), algorithm_names.end(), algorithm.name) ==
+            algorithm_names.end()) {
+      continue;
+    }
+    if (algorithm.name == "sssp" && weight.empty()) {
+      GALOIS_LOG_WARN("skipping sssp: the graph has no edge properties");
+      continue;
+    }
+    selected.emplace_back(std::move(algorithm));
+  }
+  return selected;
+}
+
+/// The value below which p percent of the sorted values lie (nearest rank)
+double
+Percentile(const std::vector<double>& sorted, double p) {
+  size_t rank = std::ceil(p / 100 * sorted.size());
+  return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+double
+Median(const std::vector<double>& sorted) {
+  size_t mid = sorted.size() / 2;
+  if (sorted.size() % 2 == 1) {
+    return sorted[mid];
+  }
+  return (sorted[mid - 1] + sorted[mid]) / 2;
+}
+
+/// Runs algorithm warmup + repetitions times and returns its report; the
+/// output of each run is removed before the next
+nlohmann::json
+Measure(galois::graphs::PropertyFileGraph* pfg, const Algorithm& algorithm) {
+  nlohmann::json report;
+  std::vector<double> times_ms;
+  for (unsigned i = 0; i < warmup + repetitions; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    auto res = algorithm.run(pfg);
+    auto end = std::chrono::steady_clock::now();
+    if (!res) {
+      report["error"] = res.error().message();
+      return report;
+    }
+    if (algorithm.has_output) {
+      if (auto rm = pfg->RemoveNodeProperty(kOutputProperty); !rm) {
+        report["error"] = rm.error().message();
+        return report;
+      }
+    }
+    if (i >= warmup) {
+      times_ms.emplace_back(
+          std::chrono::duration<double, std::milli>(end - start).count());
+    }
+  }
+
+  report["times_ms"] = times_ms;
+  if (times_ms.empty()) {
+    return report;
+  }
+  std::vector<double> sorted = times_ms;
+  std::sort(sorted.begin(), sorted.end());
+  report["min_ms"] = sorted.front();
+  report["median_ms"] = Median(sorted);
+  report["p95_ms"] = Percentile(sorted, 95);
+  report["max_ms"] = sorted.back();
+  return report;
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  galois::SharedMemSys sys;
+  llvm::cl::ParseCommandLineOptions(
+      argc, argv, "Times the library analytics over a set of graphs\n");
+
+  std::vector<unsigned> threads(thread_counts.begin(), thread_counts.end());
+  if (threads.empty()) {
+    threads.emplace_back(
+        galois::substrate::GetThreadPool().getMaxUsableThreads());
+  }
+
+  nlohmann::json results = nlohmann::json::array();
+  bool failed = false;
+  for (const std::string& input : inputs) {
+    auto pfg_res = galois::graphs::PropertyFileGraph::Make(input);
+    if (!pfg_res) {
+      GALOIS_LOG_FATAL("cannot load {}: {}", input, pfg_res.error());
+    }
+    std::unique_ptr<galois::graphs::PropertyFileGraph> pfg =
+        std::move(pfg_res.value());
+    if (start_node >= pfg->topology().num_nodes()) {
+      GALOIS_LOG_FATAL(
+          "start node {} is not a node of {}", start_node.getValue(), input);
+    }
+
+    std::vector<Algorithm> algorithms = MakeAlgorithms(*pfg);
+    for (unsigned requested : threads) {
+      unsigned active = galois::setActiveThreads(requested);
+      for (const Algorithm& algorithm : algorithms) {
+        nlohmann::json result = Measure(pfg.get(), algorithm);
+        if (result.contains("error")) {
+          GALOIS_LOG_ERROR(
+              "{} on {} with {} threads failed: {}", algorithm.name, input,
+              active, result["error"].get<std::string>());
+          failed = true;
+        }
+        result["input"] = input;
+        result["nodes"] = pfg->topology().num_nodes();
+        result["edges"] = pfg->topology().num_edges();
+        result["threads"] = active;
+        result["algorithm"] = algorithm.name;
+        results.push_back(std::move(result));
+      }
+    }
+  }
+
+  nlohmann::json report{
+      {"version", GALOIS_BENCH_VERSION},
+      {"warmup", warmup.getValue()},
+      {"repetitions", repetitions.getValue()},
+      {"start_node", start_node.getValue()},
+      {"results", std::move(results)},
+  };
+  auto dumped = galois::JsonDump(report);
+  if (!dumped) {
+    GALOIS_LOG_FATAL("cannot print report: {}", dumped.error());
+  }
+
+  if (output_file.empty()) {
+    std::cout << dumped.value() << "\n";
+  } else {
+    std::ofstream out(output_file);
+    out << dumped.value() << "\n";
+    if (!out) {
+      GALOIS_LOG_FATAL("cannot write {}", output_file.getValue());
+    }
+  }
+
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,48 @@
+#ifndef GALOIS_TOOLS_GRAPH_CONVERT_PIPELINEDFETCH_H
+#define GALOIS_TOOLS_GRAPH_CONVERT_PIPELINEDFETCH_H
+
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <utility>
+
+namespace galois {
+
+/// FetchInOrder calls fetch(i) for every batch i in [0, num_batches) with up
+/// to max_inflight calls running at once on background threads and passes the
+/// result of each to consume in batch order.
+///
+/// Consuming a batch overlaps with fetching the batches after it, so a serial
+/// consumer like PropertyGraphBuilder stays busy while a source is read over
+/// several connections. At most max_inflight fetched batches are held at a
+/// time.
+template <typename FetchFn, typename ConsumeFn>
+void
+FetchInOrder(
+    size_t num_batches, size_t max_inflight, FetchFn fetch,
+    ConsumeFn consume) {
+  using Batch = decltype(fetch(size_t{0}));
+
+  std::deque<std::future<Batch>> inflight;
+  size_t next = 0;
+  auto launch = [&]() {
+    inflight.emplace_back(std::async(std::launch::async, fetch, next));
+    ++next;
+  };
+
+  while (next < num_batches && inflight.size() < max_inflight) {
+    launch();
+  }
+  while (!inflight.empty()) {
+    Batch batch = inflight.front().get();
+    inflight.pop_front();
+    if (next < num_batches) {
+      launch();
+    }
+    consume(std::move(batch));
+  }
+}
+
+}  // namespace galois
+
+#endif
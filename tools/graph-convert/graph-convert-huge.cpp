@@ -18,30 +18,50 @@
  */
 
 #include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <algorithm>
+#include <cerrno>
 #include <chrono>
 #include <cstdint>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <deque>
 #include <fstream>
+#include <functional>
+#include <future>
 #include <ios>
 #include <iostream>
 #include <limits>
-#include <random>
+#include <memory>
 #include <regex>
+#include <string>
+#include <utility>
 #include <vector>
 
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
 #include <boost/iostreams/filtering_streambuf.hpp>
-#include <boost/mpl/if.hpp>
 
-#include "galois/LargeArray.h"
-#include "galois/graphs/FileGraph.h"
+#if defined(GALOIS_ZSTD_FOUND)
+#include <zstd.h>
+#endif
+
+#include "galois/ExternalSort.h"
+#include "galois/Galois.h"
+#include "galois/Uri.h"
 #include "galois/graphs/OfflineGraph.h"
 #include "llvm/Support/CommandLine.h"
 
 namespace cll = llvm::cl;
+namespace io = boost::iostreams;
+
+enum Compression { detect_, none_, gzip_, zstd_ };
 
 static cll::opt<std::string> inputFilename(
     cll::Positional, cll::desc("<input file>"), cll::Required);
@@ -54,106 +74,562 @@ static cll::opt<bool> edgesSorted(
     cll::init(false));
 static cll::opt<unsigned long long> numNodes(
     "numNodes", cll::desc("Total number of nodes given."), cll::init(0));
+static cll::opt<Compression> compression(
+    "compression", cll::desc("Compression of the input:"),
+    cll::values(
+        clEnumValN(detect_, "auto", "detect from the start of the file"),
+        clEnumValN(none_, "none", "uncompressed text"),
+        clEnumValN(
+            gzip_, "gzip",
+            "gzip; BGZF (bgzip) files are decompressed in parallel"),
+        clEnumValN(
+            zstd_, "zstd",
+            "zstd; multi-frame (pzstd) files are decompressed in parallel")),
+    cll::init(detect_));
+static cll::opt<unsigned> chunkSizeMB(
+    "chunkSize", cll::desc("MB of input read by each parallel task"),
+    cll::init(16));
+static cll::opt<unsigned long long> sortBufferMB(
+    "sortBuffer",
+    cll::desc("MB of memory for the external sort of unsorted edges"),
+    cll::init(4096));
+static cll::opt<std::string> tmpDir(
+    "tmpDir",
+    cll::desc("Directory or URI for the sorted runs of unsorted edges "
+              "(default: the directory of the output file)"),
+    cll::init(""));
+static cll::opt<bool> transpose(
+    "transpose",
+    cll::desc("Write the transpose of the graph; the input may be in any "
+              "order"),
+    cll::init(false));
+static cll::opt<int> numThreads(
+    "t", cll::desc("Number of threads to use (default all)"), cll::init(0));
+
+using Edge = std::pair<uint64_t, uint64_t>;
+
+static uint64_t
+chunkBytes() {
+  return std::max<uint64_t>(uint64_t{chunkSizeMB} << 20, 1);
+}
+
+//! The number of chunks read and parsed together
+static size_t
+batchChunks() {
+  return 2 * galois::getActiveThreads();
+}
+
+//! An input file that any thread can read a range of
+class InputFile {
+  std::string fileName;
+  int fd = -1;
+  uint64_t fileSize = 0;
+
+public:
+  InputFile() = default;
+  InputFile(const InputFile&) = delete;
+  InputFile& operator=(const InputFile&) = delete;
+  ~InputFile() {
+    if (fd >= 0)
+      close(fd);
+  }
+
+  bool open(const std::string& name) {
+    fileName = name;
+    fd = ::open(name.c_str(), O_RDONLY);
+    if (fd < 0)
+      return false;
+    struct stat buf;
+    if (fstat(fd, &buf) != 0)
+      return false;
+    fileSize = buf.st_size;
+    return true;
+  }
+
+  const std::string& name() const { return fileName; }
+  uint64_t size() const { return fileSize; }
+
+  void read(uint64_t offset, uint64_t size, char* buf) const {
+    while (size > 0) {
+      ssize_t n = pread(fd, buf, size, offset);
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n <= 0) {
+        std::cerr << "Error: failed to read " << fileName << ": "
+                  << (n < 0 ? std::strerror(errno) : "unexpected end of file")
+                  << "\n";
+        abort();
+      }
+      buf += n;
+      offset += n;
+      size -= n;
+    }
+  }
+};
 
-union dataTy {
-  int64_t ival;
-  double dval;
-  float fval;
-  int32_t i32val;
+//! A source of the text of the input, a batch of chunks at a time
+class ChunkReader {
+public:
+  virtual ~ChunkReader() = default;
+  //! Replaces chunks with the next batch of text in the order of the input;
+  //! returns false at the end of the input
+  virtual bool nextBatch(std::vector<std::string>* chunks) = 0;
 };
 
-void
-perEdge(
-    std::istream& is, std::function<void(uint64_t, uint64_t, dataTy)> fn,
-    std::function<void(uint64_t, uint64_t)> fnPreSize) {
-  std::string line;
+//! Reads an uncompressed file, the chunks of a batch in parallel
+class PlainReader : public ChunkReader {
+  const InputFile& file;
+  uint64_t offset = 0;
 
-  uint64_t bytes = 0;
-  uint64_t counter = 0;
-  uint64_t totalBytes = 0;
+public:
+  explicit PlainReader(const InputFile& f) : file(f) {}
 
-  const std::regex problemLine(
-      "^p[[:space:]]+[[:alpha:]]+[[:space:]]+([[:"
-      "digit:]]+)[[:space:]]+([[:digit:]]+)");
-  const std::regex noData(
-      "^a?[[:space:]]*([[:digit:]]+)[[:space:]]+([[:digit:]]+)[[:space:]]*");
-  // const std::regex noData_nospace(
-  // "^a?[[:space:]]*([[:digit:]]+)[[:space:]]+([[:digit:]]+)");
-  const std::regex intData(
-      "^a?[[:space:]]*([[:digit:]]+)[[:space:]]+([[:digit:"
-      "]]+)[[:space:]]+(-?[[:digit:]]+)");
-  const std::regex floatData(
-      "^a?[[:space:]]*([[:digit:]]+)[[:space:]]+([[:digit:]]+)[[:space:]]+(-?[["
-      ":digit:]]+\\.[[:digit:]]+)");
+  bool nextBatch(std::vector<std::string>* chunks) override {
+    uint64_t remaining = file.size() - offset;
+    size_t n = std::min<uint64_t>(
+        batchChunks(), (remaining + chunkBytes() - 1) / chunkBytes());
+    chunks->resize(n);
+    galois::do_all(
+        galois::iterate(size_t{0}, n),
+        [&](size_t i) {
+          uint64_t begin = offset + i * chunkBytes();
+          uint64_t size = std::min(chunkBytes(), file.size() - begin);
+          (*chunks)[i].resize(size);
+          file.read(begin, size, &(*chunks)[i][0]);
+        },
+        galois::no_stats(), galois::loopname("ReadChunks"));
+    offset = std::min(offset + n * chunkBytes(), file.size());
+    return n > 0;
+  }
+};
 
-  auto timer = std::chrono::system_clock::now();
-  auto timerStart = timer;
+#if defined(GALOIS_ZSTD_FOUND)
+//! A boost::iostreams source of the decompressed content of the zstd frames
+//! of a file from offset on
+class ZstdSource {
+  struct State {
+    std::ifstream file;
+    std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> ctx{
+        ZSTD_createDCtx(), ZSTD_freeDCtx};
+    std::vector<char> input = std::vector<char>(ZSTD_DStreamInSize());
+    ZSTD_inBuffer in{nullptr, 0, 0};
+    //! nonzero while a frame is not finished
+    size_t pending = 0;
+  };
+  std::shared_ptr<State> state;
 
-  std::smatch matches;
-  bool zeroBased = false;  // set to 1 if file is one-indexed
-  bool seenEdge = false;
+public:
+  using char_type = char;
+  using category = io::source_tag;
+
+  ZstdSource(const std::string& name, uint64_t offset)
+      : state(std::make_shared<State>()) {
+    state->file.open(name, std::ios_base::in | std::ios_base::binary);
+    state->file.seekg(offset, std::ios_base::beg);
+  }
 
-  while (std::getline(is, line)) {
-    auto t = line.size() + 1;
-    bytes += t;
-    totalBytes += t;
-    ++counter;
-
-    if (counter == 1024 * 128) {
-      counter = 0;
-      auto timer2 = std::chrono::system_clock::now();
-      std::cout << "Scan: "
-                << (double)bytes /
-                       std::chrono::duration_cast<std::chrono::microseconds>(
-                           timer2 - timer)
-                           .count()
-                << " MB/s\n";
-      timer = timer2;
-      bytes = 0;
+  std::streamsize read(char* s, std::streamsize n) {
+    State& st = *state;
+    ZSTD_outBuffer out{s, static_cast<size_t>(n), 0};
+    while (out.pos == 0) {
+      if (st.in.pos == st.in.size) {
+        st.file.read(st.input.data(), st.input.size());
+        st.in = ZSTD_inBuffer{st.input.data(),
+                              static_cast<size_t>(st.file.gcount()), 0};
+        if (st.in.size == 0 && st.pending == 0)
+          return -1;
+      }
+      size_t before = out.pos;
+      st.pending = ZSTD_decompressStream(st.ctx.get(), &out, &st.in);
+      if (ZSTD_isError(st.pending))
+        throw std::ios_base::failure(ZSTD_getErrorName(st.pending));
+      if (st.in.size == 0 && out.pos == before)
+        throw std::ios_base::failure("truncated zstd frame");
     }
+    return out.pos;
+  }
+};
+#endif
 
-    dataTy data;
-    bool match = false;
-    if (std::regex_match(line, matches, floatData)) {
-      if (useSmallData)
-        data.fval = std::stof(matches[3].str());
-      else
-        data.dval = std::stod(matches[3].str());
-      match = true;
-    } else if (std::regex_match(line, matches, intData)) {
-      if (useSmallData)
-        data.i32val = std::stoul(matches[3].str());
-      else
-        data.ival = std::stoll(matches[3].str());
-      match = true;
-    } else if (std::regex_match(
-                   line, matches,
-                   noData)) {  // || std::regex_match(line, matches,
-                               // noData_nospace)) {
-      data.ival = 0;
-      match = true;
-    } else if (std::regex_match(line, matches, problemLine)) {
-      if (seenEdge) {
-        std::cerr << "Error: seeing a dimacs problem line after seeing edges\n";
-        abort();
+//! Decompresses a stream that cannot be split, such as a gzip file written by
+//! gzip or pigz or a zstd file of one frame, on a thread of its own: the next
+//! batch is decompressed while the current one is parsed
+class StreamReader : public ChunkReader {
+  std::ifstream file;
+  io::filtering_istreambuf in;
+  std::future<std::vector<std::string>> next;
+
+  std::vector<std::string> readBatch() {
+    std::vector<std::string> chunks;
+    for (size_t i = 0; i < batchChunks(); ++i) {
+      std::string chunk(chunkBytes(), '\0');
+      std::streamsize n = in.sgetn(&chunk[0], chunk.size());
+      if (n <= 0)
+        break;
+      chunk.resize(n);
+      chunks.emplace_back(std::move(chunk));
+      if (static_cast<uint64_t>(n) < chunkBytes())
+        break;
+    }
+    return chunks;
+  }
+
+public:
+  StreamReader(const InputFile& f, Compression kind, uint64_t offset) {
+    if (kind == gzip_) {
+      file.open(f.name(), std::ios_base::in | std::ios_base::binary);
+      file.seekg(offset, std::ios_base::beg);
+      in.push(io::gzip_decompressor());
+      in.push(file);
+    } else {
+#if defined(GALOIS_ZSTD_FOUND)
+      in.push(ZstdSource(f.name(), offset));
+#endif
+    }
+    next = std::async(std::launch::async, [this] { return readBatch(); });
+  }
+
+  ~StreamReader() {
+    if (next.valid())
+      next.wait();
+  }
+
+  bool nextBatch(std::vector<std::string>* chunks) override {
+    *chunks = next.get();
+    if (chunks->empty())
+      return false;
+    next = std::async(std::launch::async, [this] { return readBatch(); });
+    return true;
+  }
+};
+
+//! The size of the BGZF member at the start of data, or 0 if data does not
+//! start with the whole of one
+static size_t
+bgzfMemberSize(const unsigned char* data, size_t size) {
+  // ID1 ID2 CM FLG MTIME(4) XFL OS XLEN(2) then subfields of the extra field
+  if (size < 12 || data[0] != 0x1f || data[1] != 0x8b || data[2] != 8 ||
+      (data[3] & 4) == 0)
+    return 0;
+  size_t extraEnd = 12 + (data[10] | (data[11] << 8));
+  if (size < extraEnd)
+    return 0;
+  for (size_t i = 12; i + 4 <= extraEnd;) {
+    size_t len = data[i + 2] | (data[i + 3] << 8);
+    if (data[i] == 'B' && data[i + 1] == 'C' && len == 2 &&
+        i + 6 <= extraEnd) {
+      size_t memberSize = (data[i + 4] | (data[i + 5] << 8)) + 1;
+      return memberSize <= size ? memberSize : 0;
+    }
+    i += 4 + len;
+  }
+  return 0;
+}
+
+//! The size of the independently compressed member at the start of data, or
+//! 0 if data does not start with the whole of one
+static size_t
+memberSize(Compression kind, const char* data, size_t size) {
+  if (kind == gzip_)
+    return bgzfMemberSize(reinterpret_cast<const unsigned char*>(data), size);
+#if defined(GALOIS_ZSTD_FOUND)
+  size_t frameSize = ZSTD_findFrameCompressedSize(data, size);
+  return ZSTD_isError(frameSize) ? 0 : frameSize;
+#else
+  return 0;
+#endif
+}
+
+//! Decompresses whole members into out
+static void
+decompress(Compression kind, const char* data, size_t size, std::string* out) {
+  out->clear();
+  if (kind == gzip_) {
+    try {
+      io::filtering_istreambuf in;
+      in.push(io::gzip_decompressor());
+      in.push(io::array_source(data, size));
+      io::copy(in, io::back_inserter(*out));
+    } catch (const std::exception& e) {
+      std::cerr << "Error: failed to decompress gzip member: " << e.what()
+                << "\n";
+      abort();
+    }
+    return;
+  }
+#if defined(GALOIS_ZSTD_FOUND)
+  std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> ctx(
+      ZSTD_createDCtx(), ZSTD_freeDCtx);
+  ZSTD_inBuffer in{data, size, 0};
+  ZSTD_outBuffer outBuf;
+  do {
+    size_t used = out->size();
+    out->resize(used + ZSTD_DStreamOutSize());
+    outBuf = ZSTD_outBuffer{&(*out)[used], ZSTD_DStreamOutSize(), 0};
+    size_t ret = ZSTD_decompressStream(ctx.get(), &outBuf, &in);
+    if (ZSTD_isError(ret)) {
+      std::cerr << "Error: failed to decompress zstd frame: "
+                << ZSTD_getErrorName(ret) << "\n";
+      abort();
+    }
+    out->resize(used + outBuf.pos);
+  } while (in.pos < in.size || outBuf.pos == outBuf.size);
+#endif
+}
+
+//! Reads a file of independently compressed members, such as a BGZF (bgzip)
+//! gzip file or a multi-frame (pzstd) zstd file, and decompresses the members
+//! of a batch in parallel. Members are found from their headers without
+//! decompressing them. From a member that is not splittable or that is longer
+//! than a batch on, the rest of the file is read by a StreamReader.
+class FrameReader : public ChunkReader {
+  const InputFile& file;
+  Compression kind;
+  //! compressed bytes read but not yet decompressed, which end at readOffset
+  std::string window;
+  uint64_t readOffset = 0;
+  std::unique_ptr<ChunkReader> stream;
+
+public:
+  FrameReader(const InputFile& f, Compression k) : file(f), kind(k) {}
+
+  bool nextBatch(std::vector<std::string>* chunks) override {
+    if (stream)
+      return stream->nextBatch(chunks);
+
+    uint64_t target = batchChunks() * chunkBytes();
+    if (window.size() < target && readOffset < file.size()) {
+      uint64_t n =
+          std::min(target - window.size(), file.size() - readOffset);
+      size_t used = window.size();
+      window.resize(used + n);
+      file.read(readOffset, n, &window[used]);
+      readOffset += n;
+    }
+    if (window.empty())
+      return false;
+
+    // Group whole members into units of about a chunk of compressed bytes
+    std::vector<std::pair<size_t, size_t>> units;
+    size_t pos = 0;
+    size_t unitBegin = 0;
+    while (pos < window.size()) {
+      size_t size = memberSize(kind, window.data() + pos, window.size() - pos);
+      if (size == 0)
+        break;
+      pos += size;
+      if (pos - unitBegin >= chunkBytes()) {
+        units.emplace_back(unitBegin, pos);
+        unitBegin = pos;
       }
-      zeroBased = true;  // dimacs files are 1-indexed
-      fnPreSize(std::stoull(matches[1].str()), std::stoull(matches[2].str()));
     }
-    if (match) {
-      seenEdge = true;
-      uint64_t src = std::stoull(matches[1].str());
-      uint64_t dst = std::stoull(matches[2].str());
-      if (zeroBased) {
-        if (src == 0 || dst == 0) {
-          std::cerr << "Error: node id 0 in a dimacs graph\n";
+    if (pos > unitBegin)
+      units.emplace_back(unitBegin, pos);
+
+    if (units.empty()) {
+      stream = std::make_unique<StreamReader>(
+          file, kind, readOffset - window.size());
+      window.clear();
+      window.shrink_to_fit();
+      return stream->nextBatch(chunks);
+    }
+
+    chunks->resize(units.size());
+    galois::do_all(
+        galois::iterate(size_t{0}, units.size()),
+        [&](size_t i) {
+          decompress(
+              kind, window.data() + units[i].first,
+              units[i].second - units[i].first, &(*chunks)[i]);
+        },
+        galois::steal(), galois::no_stats(),
+        galois::loopname("DecompressMembers"));
+    window.erase(0, pos);
+    return true;
+  }
+};
+
+static std::unique_ptr<ChunkReader>
+makeReader(const InputFile& file) {
+  Compression kind = compression;
+  if (kind == detect_) {
+    unsigned char magic[4] = {0, 0, 0, 0};
+    if (file.size() >= sizeof(magic))
+      file.read(0, sizeof(magic), reinterpret_cast<char*>(magic));
+    if (magic[0] == 0x1f && magic[1] == 0x8b)
+      kind = gzip_;
+    else if (
+        magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f &&
+        magic[3] == 0xfd)
+      kind = zstd_;
+    else
+      kind = none_;
+  }
+#if !defined(GALOIS_ZSTD_FOUND)
+  if (kind == zstd_) {
+    std::cerr << "Error: built without zstd support\n";
+    abort();
+  }
+#endif
+  std::cout << "Compression: "
+            << (kind == gzip_ ? "gzip" : kind == zstd_ ? "zstd" : "none")
+            << "\n";
+  if (kind == none_)
+    return std::make_unique<PlainReader>(file);
+  return std::make_unique<FrameReader>(file, kind);
+}
+
+//! The edges of one chunk of text
+struct ParsedChunk {
+  std::vector<Edge> edges;
+  bool hasProblem = false;
+  //! whether an edge comes before the dimacs problem line of this chunk
+  bool edgeBeforeProblem = false;
+  uint64_t problemNodes = 0;
+};
+
+static const std::regex problemLine(
+    "^p[[:space:]]+[[:alpha:]]+[[:space:]]+([[:"
+    "digit:]]+)[[:space:]]+([[:digit:]]+)");
+static const std::regex noData(
+    "^a?[[:space:]]*([[:digit:]]+)[[:space:]]+([[:digit:]]+)[[:space:]]*");
+static const std::regex intData(
+    "^a?[[:space:]]*([[:digit:]]+)[[:space:]]+([[:digit:"
+    "]]+)[[:space:]]+(-?[[:digit:]]+)");
+static const std::regex floatData(
+    "^a?[[:space:]]*([[:digit:]]+)[[:space:]]+([[:digit:]]+)[[:space:]]+(-?[["
+    ":digit:]]+\\.[[:digit:]]+)");
+
+//! Parses the line [begin, end); the character at end must not be a digit
+static void
+parseLine(const char* begin, const char* end, ParsedChunk* chunk) {
+  std::cmatch matches;
+  if (std::regex_match(begin, end, matches, floatData) ||
+      std::regex_match(begin, end, matches, intData) ||
+      std::regex_match(begin, end, matches, noData)) {
+    chunk->edges.emplace_back(
+        std::strtoull(matches[1].first, nullptr, 10),
+        std::strtoull(matches[2].first, nullptr, 10));
+  } else if (std::regex_match(begin, end, matches, problemLine)) {
+    if (!chunk->edges.empty())
+      chunk->edgeBeforeProblem = true;
+    chunk->hasProblem = true;
+    chunk->problemNodes = std::strtoull(matches[1].first, nullptr, 10);
+  }
+}
+
+//! Parses a batch of text in parallel. A line can be split between chunks and
+//! between batches: the text after the last newline of a chunk is joined with
+//! the start of the next chunk, and the end of the batch is left in carry.
+static void
+parseBatch(
+    const std::vector<std::string>& text, std::string* carry,
+    std::vector<ParsedChunk>* parsed) {
+  size_t n = text.size();
+  std::vector<std::string> leads(n);
+  std::vector<std::pair<size_t, size_t>> bodies(n, {0, 0});
+  for (size_t i = 0; i < n; ++i) {
+    const std::string& t = text[i];
+    size_t first = t.find('\n');
+    if (first == std::string::npos) {
+      carry->append(t);
+      continue;
+    }
+    size_t last = t.rfind('\n');
+    leads[i] = std::move(*carry);
+    leads[i].append(t, 0, first);
+    carry->assign(t, last + 1, std::string::npos);
+    bodies[i] = {first + 1, last + 1};
+  }
+
+  parsed->clear();
+  parsed->resize(n);
+  galois::do_all(
+      galois::iterate(size_t{0}, n),
+      [&](size_t i) {
+        ParsedChunk* chunk = &(*parsed)[i];
+        parseLine(leads[i].data(), leads[i].data() + leads[i].size(), chunk);
+        const char* begin = text[i].data() + bodies[i].first;
+        const char* end = text[i].data() + bodies[i].second;
+        while (begin < end) {
+          const char* eol = std::find(begin, end, '\n');
+          parseLine(begin, eol, chunk);
+          begin = eol + 1;
+        }
+      },
+      galois::steal(), galois::no_stats(), galois::loopname("ParseEdges"));
+}
+
+//! Calls fn with every batch of edges of the input in order, with zero-based
+//! node ids, and fnPreSize with the number of nodes of a dimacs problem line
+void
+perBatch(
+    ChunkReader& reader, std::function<void(std::vector<ParsedChunk>&)> fn,
+    std::function<void(uint64_t)> fnPreSize) {
+  uint64_t totalBytes = 0;
+  bool oneIndexed = false;  // set if the file is a dimacs graph
+  bool seenEdge = false;
+
+  std::vector<std::string> text;
+  std::vector<ParsedChunk> parsed;
+  std::string carry;
+
+  auto process = [&]() {
+    for (const ParsedChunk& chunk : parsed) {
+      if (chunk.hasProblem) {
+        if (seenEdge || chunk.edgeBeforeProblem) {
+          std::cerr
+              << "Error: seeing a dimacs problem line after seeing edges\n";
           abort();
         }
-        src -= 1;
-        dst -= 1;
+        oneIndexed = true;  // dimacs files are 1-indexed
+        fnPreSize(chunk.problemNodes);
       }
-      fn(src, dst, data);
+      if (!chunk.edges.empty())
+        seenEdge = true;
+    }
+    if (oneIndexed) {
+      galois::do_all(
+          galois::iterate(parsed),
+          [](ParsedChunk& chunk) {
+            for (Edge& edge : chunk.edges) {
+              if (edge.first == 0 || edge.second == 0) {
+                std::cerr << "Error: node id 0 in a dimacs graph\n";
+                abort();
+              }
+              edge.first -= 1;
+              edge.second -= 1;
+            }
+          },
+          galois::no_stats(), galois::loopname("OneIndexed"));
     }
+    fn(parsed);
+  };
+
+  auto timer = std::chrono::system_clock::now();
+  auto timerStart = timer;
+  while (reader.nextBatch(&text)) {
+    uint64_t bytes = 0;
+    for (const std::string& t : text)
+      bytes += t.size();
+    totalBytes += bytes;
+    parseBatch(text, &carry, &parsed);
+    process();
+
+    auto timer2 = std::chrono::system_clock::now();
+    std::cout << "Scan: "
+              << (double)bytes /
+                     std::chrono::duration_cast<std::chrono::microseconds>(
+                         timer2 - timer)
+                         .count()
+              << " MB/s\n";
+    timer = timer2;
+  }
+  // The last line need not end with a newline
+  if (!carry.empty()) {
+    parsed.assign(1, ParsedChunk());
+    parseLine(carry.data(), carry.data() + carry.size(), &parsed[0]);
+    process();
   }
   auto timer2 = std::chrono::system_clock::now();
   std::cout << "File Scan: "
@@ -164,32 +640,76 @@ perEdge(
             << " MB/s\n";
 }
 
+//! A new directory for the runs of the external sort of unsorted edges
+static galois::Uri
+sortDir() {
+  std::string base = outputFilename;
+  if (!tmpDir.empty()) {
+    size_t slash = base.rfind('/');
+    base = tmpDir + "/" +
+           (slash == std::string::npos ? base : base.substr(slash + 1));
+  }
+  auto res = galois::Uri::MakeRand(base + ".sort");
+  if (!res) {
+    std::cerr << "Error: bad sort directory " << base << "\n";
+    abort();
+  }
+  return res.value();
+}
+
+static void
+checkSort(const galois::Result<void>& res) {
+  if (!res) {
+    std::cerr << "Error: external sort failed: " << res.error().message()
+              << "\n";
+    abort();
+  }
+}
+
+//! Converts edges in any order with an external sort: batches of edges are
+//! sorted in parallel and stored as runs, which are then merged into the
+//! output. No runs are stored if all edges fit in the sort buffer. With
+//! transpose, edges are sorted by destination instead.
 void
-go(std::istream& input) {
+go(ChunkReader& reader) {
   try {
-    std::deque<uint64_t> edgeCount;
-    perEdge(
-        input,
-        [&edgeCount](uint64_t src, uint64_t, dataTy) {
-          if (edgeCount.size() <= src)
-            edgeCount.resize(src + 1);
-          ++edgeCount[src];
+    std::deque<uint64_t> edgeCount(numNodes, 0);
+    galois::ExternalSortOptions options;
+    options.memory_budget = sortBufferMB << 20;
+    galois::Uri dir = sortDir();
+    galois::ExternalSort<Edge> sorter(dir, options);
+
+    perBatch(
+        reader,
+        [&](std::vector<ParsedChunk>& parsed) {
+          for (ParsedChunk& chunk : parsed) {
+            for (Edge& edge : chunk.edges) {
+              if (transpose)
+                std::swap(edge.first, edge.second);
+              if (edgeCount.size() <= edge.first)
+                edgeCount.resize(edge.first + 1);
+              ++edgeCount[edge.first];
+            }
+            checkSort(sorter.Append(chunk.edges.data(), chunk.edges.size()));
+          }
         },
-        [&edgeCount](uint64_t nodes, uint64_t) { edgeCount.resize(nodes); });
-    input.clear();
-    input.seekg(0, std::ios_base::beg);
+        [&edgeCount](uint64_t nodes) {
+          if (edgeCount.size() < nodes)
+            edgeCount.resize(nodes);
+        });
+
     galois::graphs::OfflineGraphWriter outFile(outputFilename, useSmallData);
     outFile.setCounts(edgeCount);
-    perEdge(
-        input,
-        [&outFile, &edgeCount](uint64_t src, uint64_t dst, dataTy data) {
-          auto off = --edgeCount[src];
-          if (useSmallData)
-            outFile.setEdge(src, off, dst, data.i32val);
-          else
-            outFile.setEdge(src, off, dst, data.ival);
-        },
-        [](uint64_t, uint64_t) {});
+    outFile.seekEdgesDstStart();
+    if (sorter.num_runs() > 0)
+      std::cout << "Merging " << sorter.num_runs() << " runs\n";
+    checkSort(sorter.Merge([&outFile](const Edge* edges, uint64_t n) {
+      for (uint64_t i = 0; i < n; ++i)
+        outFile.setEdgeSorted(edges[i].second);
+    }));
+    // The runs are gone; remove their directory if it is local
+    boost::system::error_code err;
+    boost::filesystem::remove(dir.path(), err);
   } catch (const char* c) {
     std::cerr << "Failed with: " << c << "\n";
     abort();
@@ -197,37 +717,41 @@ go(std::istream& input) {
 }
 
 void
-go_edgesSorted(std::istream& input, uint64_t numNodes) {
+go_edgesSorted(ChunkReader& reader, uint64_t numNodes) {
   try {
     std::deque<uint64_t> edgeCount(numNodes, 0);
-    input.clear();
-    input.seekg(0, std::ios_base::beg);
     galois::graphs::OfflineGraphWriter outFile(
         outputFilename, useSmallData, numNodes);
     outFile.setCounts(edgeCount);
     outFile.seekEdgesDstStart();
     uint64_t curr_src = 0;
     uint64_t curr_src_edgeCount = 0;
-    perEdge(
-        input,
-        [&outFile, &edgeCount, &curr_src, &curr_src_edgeCount](
-            uint64_t src, uint64_t dst, dataTy) {
-          if (src == curr_src) {
-            ++curr_src_edgeCount;
-          } else {
-            // std::cout << "CHANGES : " << src << " : " << curr_src << "
-            // COUNT : " << curr_src_edgeCount << "\n";
-            if (src < curr_src) {
-              std::cerr << " ERROR : File is not sorted\n";
-              abort();
+    perBatch(
+        reader,
+        [&](std::vector<ParsedChunk>& parsed) {
+          for (const ParsedChunk& chunk : parsed) {
+            for (const auto& [src, dst] : chunk.edges) {
+              if (src == curr_src) {
+                ++curr_src_edgeCount;
+              } else {
+                if (src < curr_src) {
+                  std::cerr << " ERROR : File is not sorted\n";
+                  abort();
+                }
+                if (src >= numNodes) {
+                  std::cerr << " ERROR : Node " << src
+                            << " is not less than numNodes\n";
+                  abort();
+                }
+                edgeCount[curr_src] = curr_src_edgeCount;
+                curr_src = src;
+                curr_src_edgeCount = 1;
+              }
+              outFile.setEdgeSorted(dst);
             }
-            edgeCount[curr_src] = curr_src_edgeCount;
-            curr_src = src;
-            curr_src_edgeCount = 1;
           }
-          outFile.setEdgeSorted(dst);
         },
-        [](uint64_t, uint64_t) {});
+        [](uint64_t) {});
     // To take care of the last src node ID.
     edgeCount[curr_src] = curr_src_edgeCount;
     outFile.setCounts(edgeCount);
@@ -239,19 +763,28 @@ go_edgesSorted(std::istream& input, uint64_t numNodes) {
 
 int
 main(int argc, char** argv) {
+  galois::SharedMemSys G;
   llvm::cl::ParseCommandLineOptions(argc, argv);
+  galois::setActiveThreads(
+      numThreads > 0 ? numThreads : std::numeric_limits<unsigned>::max());
   std::cout << "Data will be " << (useSmallData ? 4 : 8) << " Bytes\n";
 
-  std::ifstream infile(inputFilename, std::ios_base::in);
-  if (!infile) {
+  InputFile infile;
+  if (!infile.open(inputFilename)) {
     std::cout << "Failed to open " << inputFilename << "\n";
     return 1;
   }
 
-  if (numNodes > 0 && edgesSorted) {
-    go_edgesSorted(infile, numNodes);
-  } else {
-    go(infile);
+  try {
+    std::unique_ptr<ChunkReader> reader = makeReader(infile);
+    if (numNodes > 0 && edgesSorted && !transpose) {
+      go_edgesSorted(*reader, numNodes);
+    } else {
+      go(*reader);
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "Failed with: " << e.what() << "\n";
+    abort();
   }
 
   return 0;
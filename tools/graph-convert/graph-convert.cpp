@@ -18,16 +18,23 @@
  */
 
 #include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <algorithm>
+#include <charconv>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <deque>
 #include <fstream>
 #include <iostream>
 #include <limits>
+#include <optional>
 #include <random>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include <boost/mpl/if.hpp>
@@ -35,6 +42,7 @@
 
 #include "galois/Galois.h"
 #include "galois/LargeArray.h"
+#include "galois/graphs/EdgeTransforms.h"
 #include "galois/graphs/FileGraph.h"
 
 // TODO: move these enums to a common location for all graph convert tools
@@ -43,8 +51,11 @@ enum ConvertMode {
   bipartitegr2littlepetsc,
   bipartitegr2sorteddegreegr,
   dimacs2gr,
+  dimacs2kg,
   edgelist2gr,
+  edgelist2kg,
   csv2gr,
+  csv2kg,
   gr2biggr,
   gr2binarypbbs32,
   gr2binarypbbs64,
@@ -79,7 +90,11 @@ enum ConvertMode {
   gr2totem,
   gr2neo4j,
   gr2kg,
+  kg2ckg,
+  kg2skg,
+  kg2tkg,
   mtx2gr,
+  mtx2kg,
   nodelist2gr,
   pbbs2gr,
   svmlight2gr,
@@ -129,8 +144,14 @@ static cll::opt<ConvertMode> convertMode(
             bipartitegr2sorteddegreegr,
             "Sort nodes of bipartite binary gr by degree"),
         clEnumVal(dimacs2gr, "Convert dimacs to binary gr"),
+        clEnumVal(
+            dimacs2kg, "Convert dimacs to a property graph for katana graph"),
         clEnumVal(edgelist2gr, "Convert edge list to binary gr"),
+        clEnumVal(
+            edgelist2kg,
+            "Convert edge list to a property graph for katana graph"),
         clEnumVal(csv2gr, "Convert csv to binary gr"),
+        clEnumVal(csv2kg, "Convert csv to a property graph for katana graph"),
         clEnumVal(
             gr2biggr,
             "Convert binary gr with little-endian edge data to "
@@ -194,7 +215,19 @@ static cll::opt<ConvertMode> convertMode(
         clEnumVal(gr2neo4j, "Convert binary gr to a vertex/edge csv for neo4j"),
         clEnumVal(
             gr2kg, "Convert binary gr to a property graph for katana graph"),
+        clEnumVal(
+            kg2ckg,
+            "Clean up a property graph: remove self edges and multi-edges"),
+        clEnumVal(
+            kg2skg,
+            "Convert a property graph to a symmetric one by adding reverse "
+            "edges"),
+        clEnumVal(kg2tkg, "Transpose a property graph"),
         clEnumVal(mtx2gr, "Convert matrix market format to binary gr"),
+        clEnumVal(
+            mtx2kg,
+            "Convert matrix market format to a property graph for katana "
+            "graph"),
         clEnumVal(nodelist2gr, "Convert node list to binary gr"),
         clEnumVal(pbbs2gr, "Convert pbbs graph to binary gr"),
         clEnumVal(svmlight2gr, "Convert svmlight file to binary gr"),
@@ -217,8 +250,21 @@ static cll::opt<int> minValue(
     "minValue",
     cll::desc("minimum weight to add for random weight conversions"),
     cll::init(1));
+static cll::opt<int> numThreads(
+    "t",
+    cll::desc("Number of threads to use for conversions that run in parallel "
+              "(default all)"),
+    cll::init(0));
 static cll::opt<int> maxDegree(
     "maxDegree", cll::desc("maximum degree to keep"), cll::init(2 * 1024));
+static cll::opt<bool> removeSelfLoops(
+    "removeSelfLoops",
+    cll::desc("Remove self edges in kg2skg and kg2tkg conversions"),
+    cll::init(false));
+static cll::opt<bool> removeMultiEdges(
+    "removeMultiEdges",
+    cll::desc("Remove multi-edges in kg2skg and kg2tkg conversions"),
+    cll::init(false));
 
 struct Conversion {};
 struct HasOnlyVoidSpecialization {};
@@ -371,208 +417,451 @@ skipLine(std::ifstream& infile) {
 }
 
 /**
- * Common parsing for edgelist style text files.
- *
- * src dst [weight]
- * ...
- *
- * If delim is set, this function expects that each entry is separated by delim
- * surrounded by optional whitespace.
+ * A read-only mapping of an input file.
  */
-template <typename EdgeTy>
-void
-convertEdgelist(
-    const std::string& infilename, const std::string& outfilename,
-    const bool skipFirstLine, std::optional<char> delim) {
-  typedef galois::graphs::FileGraphWriter Writer;
-  typedef galois::LargeArray<EdgeTy> EdgeData;
-  typedef typename EdgeData::value_type edge_value_type;
-
-  Writer p;
-  EdgeData edgeData;
-  std::ifstream infile(infilename.c_str());
+class MappedFile {
+  void* data_{nullptr};
+  size_t size_{0};
 
-  size_t numNodes = 0;
-  size_t numEdges = 0;
-  size_t lineNumber = 0;
-
-  if (skipFirstLine) {
-    galois::gWarn(
-        "first line is assumed to contain labels and will be ignored\n");
-    skipLine(infile);
-    ++lineNumber;
-  }
-
-  const bool hasDelim = static_cast<bool>(delim);
-  std::optional<size_t> skippedLine;
-  std::string line;
-  char readDelim;
-
-  for (; std::getline(infile, line); ++lineNumber) {
-    std::stringstream iss(line);
-
-    size_t src;
-    if (!(iss >> src)) {
-      skippedLine = lineNumber;
-      continue;
+public:
+  explicit MappedFile(const std::string& filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+      GALOIS_DIE("failed to open input file: ", filename);
     }
-
-    if (hasDelim) {
-      if (!(iss >> readDelim) || readDelim != delim) {
-        skippedLine = lineNumber;
-        continue;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      GALOIS_DIE("failed to stat input file: ", filename);
+    }
+    size_ = st.st_size;
+    if (size_ > 0) {
+      data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data_ == MAP_FAILED) {
+        GALOIS_DIE("failed to map input file: ", filename);
       }
+      madvise(data_, size_, MADV_SEQUENTIAL);
     }
+    close(fd);
+  }
 
-    size_t dst;
-    if (!(iss >> dst)) {
-      skippedLine = lineNumber;
-      continue;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  ~MappedFile() {
+    if (data_ != nullptr) {
+      munmap(data_, size_);
     }
+  }
 
-    edge_value_type data{};
-    if (EdgeData::has_value) {
-      if (hasDelim) {
-        if (!(iss >> readDelim) || readDelim != delim) {
-          skippedLine = lineNumber;
-          continue;
-        }
-      }
+  const char* begin() const { return static_cast<const char*>(data_); }
+  const char* end() const { return begin() + size_; }
+};
 
-      if (!(iss >> data)) {
-        skippedLine = lineNumber;
-        continue;
-      }
-    }
+//! Returns the end of the line starting at p, i.e., its newline or end
+const char*
+lineEnd(const char* p, const char* end) {
+  const void* nl = std::memchr(p, '\n', end - p);
+  return nl ? static_cast<const char*>(nl) : end;
+}
 
-    if (infile) {
-      ++numEdges;
-      if (src > numNodes)
-        numNodes = src;
-      if (dst > numNodes)
-        numNodes = dst;
-    }
-  }
+//! Returns the start of the line after the one containing p
+const char*
+nextLine(const char* p, const char* end) {
+  const char* e = lineEnd(p, end);
+  return e == end ? end : e + 1;
+}
 
-  if (skippedLine) {
-    galois::gWarn(
-        "ignored at least one line (line ", *skippedLine,
-        ") because it did not match the expected format\n");
+const char*
+skipBlanks(const char* p, const char* end) {
+  while (p != end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+    ++p;
   }
+  return p;
+}
 
-  numNodes++;
-  p.setNumNodes(numNodes);
-  p.setNumEdges(numEdges);
-  p.setSizeofEdgeData(EdgeData::size_of::value);
-  edgeData.create(numEdges);
-
-  infile.clear();
-  infile.seekg(0, std::ios::beg);
-  p.phase1();
+/**
+ * Parses the number after optional blanks at *p and advances *p past it.
+ *
+ * Unlike iostreams this does not consult locales or do any allocation, which
+ * matters when parsing billions of numbers on many threads.
+ */
+template <typename T>
+bool
+parseToken(const char** p, const char* end, T* value) {
+  const char* b = skipBlanks(*p, end);
+  if constexpr (std::is_integral<T>::value) {
+    auto [ptr, ec] = std::from_chars(b, end, *value);
+    if (ec != std::errc()) {
+      return false;
+    }
+    *p = ptr;
+  } else {
+    // strtod needs a terminated string and the input is not necessarily
+    // terminated
+    char buf[64];
+    size_t n = 0;
+    while (b + n != end && n + 1 < sizeof(buf) && b[n] != ' ' &&
+           b[n] != '\t' && b[n] != '\r' && b[n] != ',') {
+      buf[n] = b[n];
+      ++n;
+    }
+    buf[n] = '\0';
+    char* tail;
+    double parsed = std::strtod(buf, &tail);
+    if (tail == buf) {
+      return false;
+    }
+    *value = static_cast<T>(parsed);
+    *p = b + (tail - buf);
+  }
+  return true;
+}
 
-  if (skipFirstLine) {
-    skipLine(infile);
+//! Skips optional blanks and delim at *p
+bool
+skipDelim(const char** p, const char* end, char delim) {
+  const char* b = skipBlanks(*p, end);
+  if (b == end || *b != delim) {
+    return false;
   }
+  *p = b + 1;
+  return true;
+}
 
-  while (std::getline(infile, line)) {
-    std::stringstream iss(line);
+//! Edges read from a text file in the order of their lines
+template <typename EdgeTy>
+struct ParsedEdges {
+  galois::LargeArray<uint64_t> srcs;
+  galois::LargeArray<uint64_t> dsts;
+  galois::LargeArray<EdgeTy> data;
+  size_t numEdges = 0;
+  //! Largest src or dst
+  uint64_t maxNode = 0;
+  //! Last line that was not an edge
+  std::optional<size_t> skippedLine;
+};
 
-    size_t src;
-    if (!(iss >> src)) {
-      continue;
-    }
+/**
+ * Parses the edges in the lines of [begin, end) in parallel.
+ *
+ * The input is split at line boundaries into a few pieces per thread.
+ * parseLine(line, lineEnd, &src, &dst, &data) should return false for lines
+ * that are not edges. Line numbers are counted from firstLine.
+ */
+template <typename EdgeTy, typename ParseLine>
+void
+parseEdges(
+    const char* begin, const char* end, size_t firstLine, ParseLine parseLine,
+    ParsedEdges<EdgeTy>* edges) {
+  typedef galois::LargeArray<EdgeTy> EdgeData;
+  typedef typename EdgeData::value_type edge_value_type;
 
-    if (hasDelim) {
-      if (!(iss >> readDelim) || readDelim != delim) {
-        continue;
-      }
-    }
+  struct Piece {
+    const char* begin;
+    const char* end;
+    std::vector<uint64_t> srcs;
+    std::vector<uint64_t> dsts;
+    std::vector<edge_value_type> data;
+    size_t numLines = 0;
+    uint64_t maxNode = 0;
+    std::optional<size_t> skippedLine;
+  };
 
-    size_t dst;
-    if (!(iss >> dst)) {
-      continue;
+  size_t numPieces = galois::getActiveThreads() * 4;
+  std::vector<Piece> pieces(numPieces);
+  const char* pos = begin;
+  for (size_t i = 0; i < numPieces; ++i) {
+    pieces[i].begin = pos;
+    if (i + 1 == numPieces) {
+      pos = end;
+    } else {
+      const char* split = begin + (end - begin) / numPieces * (i + 1);
+      pos = split <= pos ? pos : nextLine(split - 1, end);
     }
+    pieces[i].end = pos;
+  }
 
-    edge_value_type data{};
-    if (EdgeData::has_value) {
-      if (hasDelim) {
-        if (!(iss >> readDelim) || readDelim != delim) {
-          continue;
+  galois::do_all(
+      galois::iterate(pieces),
+      [&](Piece& piece) {
+        for (const char* line = piece.begin; line < piece.end;
+             ++piece.numLines) {
+          const char* e = lineEnd(line, piece.end);
+          uint64_t src;
+          uint64_t dst;
+          edge_value_type value{};
+          if (parseLine(line, e, &src, &dst, &value)) {
+            piece.srcs.emplace_back(src);
+            piece.dsts.emplace_back(dst);
+            if constexpr (EdgeData::has_value) {
+              piece.data.emplace_back(value);
+            }
+            piece.maxNode = std::max(piece.maxNode, std::max(src, dst));
+          } else {
+            piece.skippedLine = piece.numLines;
+          }
+          line = e + 1;
         }
-      }
+      },
+      galois::steal(), galois::loopname("ParseEdges"), galois::no_stats());
+
+  std::vector<size_t> offsets(numPieces + 1);
+  size_t lineOffset = firstLine;
+  for (size_t i = 0; i < numPieces; ++i) {
+    offsets[i + 1] = offsets[i] + pieces[i].srcs.size();
+    edges->maxNode = std::max(edges->maxNode, pieces[i].maxNode);
+    if (pieces[i].skippedLine) {
+      edges->skippedLine = lineOffset + *pieces[i].skippedLine;
+    }
+    lineOffset += pieces[i].numLines;
+  }
 
-      if (!(iss >> data)) {
-        continue;
-      }
-    }
+  edges->numEdges = offsets[numPieces];
+  edges->srcs.allocateInterleaved(edges->numEdges);
+  edges->dsts.allocateInterleaved(edges->numEdges);
+  edges->data.allocateInterleaved(edges->numEdges);
+  galois::do_all(
+      galois::iterate(size_t{0}, numPieces),
+      [&](size_t i) {
+        Piece& piece = pieces[i];
+        std::copy(
+            piece.srcs.begin(), piece.srcs.end(),
+            edges->srcs.data() + offsets[i]);
+        std::copy(
+            piece.dsts.begin(), piece.dsts.end(),
+            edges->dsts.data() + offsets[i]);
+        if constexpr (EdgeData::has_value) {
+          std::copy(
+              piece.data.begin(), piece.data.end(),
+              edges->data.data() + offsets[i]);
+        }
+        piece = Piece{};
+      },
+      galois::loopname("GatherEdges"), galois::no_stats());
+}
 
-    if (infile) {
-      p.incrementDegree(src);
-    }
+/**
+ * This is Required gr to kg conversion to append edge data 
+ * as the edge property. 
+ */
+template <typename EdgeTy>
+galois::Result<void>
+AppendEdgeData(
+    galois::graphs::PropertyFileGraph* pfg,
+    const galois::LargeArray<EdgeTy>& edge_data) {
+  using Builder = typename arrow::CTypeTraits<EdgeTy>::BuilderType;
+  using ArrowType = typename arrow::CTypeTraits<EdgeTy>::ArrowType;
+  Builder builder;
+  if (auto r = builder.AppendValues(edge_data.begin(), edge_data.end());
+      !r.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", r);
+    return galois::ErrorCode::ArrowError;
   }
 
-  infile.clear();
-  infile.seekg(0, std::ios::beg);
-  p.phase2();
-
-  if (skipFirstLine) {
-    skipLine(infile);
+  std::shared_ptr<arrow::Array> ret;
+  if (auto r = builder.Finish(&ret); !r.ok()) {
+    GALOIS_LOG_DEBUG("arrow error: {}", r);
+    return galois::ErrorCode::ArrowError;
   }
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  fields.emplace_back(arrow::field(("value"), std::make_shared<ArrowType>()));
+  columns.emplace_back(ret);
+  auto edge_data_table = arrow::Table::Make(arrow::schema(fields), columns);
+  if (auto r = pfg->AddEdgeProperties(edge_data_table); !r) {
+    GALOIS_LOG_DEBUG("could not add edge property: {}", r.error());
+    return r;
+  }
+  return galois::ResultSuccess();
+}
 
-  while (std::getline(infile, line)) {
-    std::stringstream iss(line);
+template <>
+galois::Result<void>
+AppendEdgeData<void>(
+    galois::graphs::PropertyFileGraph*, const galois::LargeArray<void>&) {
+  return galois::ResultSuccess();
+}
 
-    size_t src;
-    if (!(iss >> src)) {
-      continue;
-    }
+/**
+ * Writes graph as a katana property graph. Edge data, if any, becomes the
+ * edge property "value".
+ */
+template <typename EdgeTy>
+void
+writeKg(galois::graphs::FileGraph& graph, const std::string& outfilename) {
+  using Graph = galois::graphs::FileGraph;
+  using GNode = Graph::GraphNode;
+  using EdgeData = galois::LargeArray<EdgeTy>;
+  using edge_value_type = typename EdgeData::value_type;
 
-    if (hasDelim) {
-      if (!(iss >> readDelim) || readDelim != delim) {
-        continue;
-      }
-    }
+  galois::LargeArray<uint64_t> out_indices;
+  out_indices.allocateBlocked(graph.size());
 
-    size_t dst;
-    if (!(iss >> dst)) {
-      continue;
-    }
+  galois::LargeArray<uint32_t> out_dests;
+  out_dests.allocateBlocked(graph.sizeEdges());
 
-    edge_value_type data{};
-    if (EdgeData::has_value) {
-      if (hasDelim) {
-        if (!(iss >> readDelim) || readDelim != delim) {
-          continue;
+  galois::LargeArray<EdgeTy> out_dests_data;
+  if (EdgeData::has_value) {
+    out_dests_data.allocateBlocked(graph.sizeEdges());
+  }
+
+  // write edges
+  galois::do_all(
+      galois::iterate(graph.begin(), graph.end()),
+      [&](GNode src) {
+        out_indices[src] = *graph.edge_end(src);
+        for (Graph::edge_iterator jj = graph.edge_begin(src),
+                                  ej = graph.edge_end(src);
+             jj != ej; ++jj) {
+          GNode dst = graph.getEdgeDst(jj);
+          out_dests[*jj] = dst;
+          if (EdgeData::has_value) {
+            out_dests_data.set(*jj, graph.getEdgeData<edge_value_type>(jj));
+          }
         }
-      }
+      },
+      galois::steal(), galois::loopname("WriteKgTopology"), galois::no_stats());
+
+  auto numeric_array_out_indices =
+      std::make_shared<arrow::NumericArray<arrow::UInt64Type>>(
+          static_cast<int64_t>(graph.size()),
+          arrow::MutableBuffer::Wrap(out_indices.data(), graph.size()));
+
+  auto numeric_array_out_dests =
+      std::make_shared<arrow::NumericArray<arrow::UInt32Type>>(
+          static_cast<int64_t>(graph.sizeEdges()),
+          arrow::MutableBuffer::Wrap(out_dests.data(), graph.sizeEdges()));
+
+  auto pfg = std::make_unique<galois::graphs::PropertyFileGraph>();
+  auto set_result = pfg->SetTopology(galois::graphs::GraphTopology{
+      .out_indices = std::move(numeric_array_out_indices),
+      .out_dests = std::move(numeric_array_out_dests),
+  });
+
+  if (!set_result) {
+    GALOIS_LOG_FATAL(
+        "Failed to set topology for property file graph: {}",
+        set_result.error());
+  }
 
-      if (!(iss >> data)) {
-        continue;
-      }
+  if (EdgeData::has_value) {
+    if (auto r = AppendEdgeData<EdgeTy>(pfg.get(), out_dests_data); !r) {
+      GALOIS_LOG_FATAL("could not add edge property: {}", r.error());
     }
+  }
 
-    if (infile) {
-      edgeData.set(p.addNeighbor(src, dst), data);
-    }
+  pfg->MarkAllPropertiesPersistent();
+
+  galois::gPrint("Edge Schema : ", pfg->edge_schema()->ToString(), "\n");
+  galois::gPrint("Node Schema : ", pfg->node_schema()->ToString(), "\n");
+
+  if (auto r = pfg->Write(outfilename, "cmd"); !r) {
+    GALOIS_LOG_FATAL("Failed to write property file graph: {}", r.error());
   }
+}
+
+/**
+ * Builds a graph with a parallel degree count, prefix sum and fill from parsed
+ * edges and writes it to outfilename as a gr or, if toKg is set, directly as
+ * a katana property graph without an intermediate gr.
+ */
+template <typename EdgeTy>
+void
+writeParsedEdges(
+    const ParsedEdges<EdgeTy>& edges, size_t numNodes,
+    const std::string& outfilename, bool toKg) {
+  typedef galois::graphs::FileGraphWriter Writer;
+  typedef galois::LargeArray<EdgeTy> EdgeData;
+  typedef typename EdgeData::value_type edge_value_type;
+
+  Writer p;
+  p.setNumNodes(numNodes);
+  p.setSizeofEdgeData(EdgeData::size_of::value);
+
+  std::vector<uint64_t> edgeIds;
+  p.addEdgesParallel(
+      edges.srcs.data(), edges.dsts.data(), edges.numEdges, &edgeIds);
 
   edge_value_type* rawEdgeData = p.finish<edge_value_type>();
-  if (EdgeData::has_value)
-    std::uninitialized_copy(
-        std::make_move_iterator(edgeData.begin()),
-        std::make_move_iterator(edgeData.end()), rawEdgeData);
+  if constexpr (EdgeData::has_value) {
+    galois::do_all(
+        galois::iterate(size_t{0}, edges.numEdges),
+        [&](size_t i) { rawEdgeData[i] = edges.data[edgeIds[i]]; },
+        galois::loopname("CopyEdgeData"), galois::no_stats());
+  }
 
-  p.toFile(outfilename);
-  printStatus(numNodes, numEdges);
+  if (toKg) {
+    writeKg<EdgeTy>(p, outfilename);
+  } else {
+    p.toFile(outfilename);
+  }
 }
 
+/**
+ * Common parsing for edgelist style text files.
+ *
+ * src dst [weight]
+ * ...
+ *
+ * If delim is set, this function expects that each entry is separated by delim
+ * surrounded by optional whitespace. If toKg is set, the output is a katana
+ * property graph rather than a gr.
+ */
 template <typename EdgeTy>
 void
 convertEdgelist(
     const std::string& infilename, const std::string& outfilename,
-    const bool skipFirstLine) {
-  convertEdgelist<EdgeTy>(
-      infilename, outfilename, skipFirstLine, std::optional<char>());
+    const bool skipFirstLine, std::optional<char> delim, bool toKg) {
+  typedef galois::LargeArray<EdgeTy> EdgeData;
+  typedef typename EdgeData::value_type edge_value_type;
+
+  MappedFile infile(infilename);
+  const char* begin = infile.begin();
+  size_t lineNumber = 0;
+
+  if (skipFirstLine) {
+    galois::gWarn(
+        "first line is assumed to contain labels and will be ignored\n");
+    begin = nextLine(begin, infile.end());
+    ++lineNumber;
+  }
+
+  ParsedEdges<EdgeTy> edges;
+  parseEdges<EdgeTy>(
+      begin, infile.end(), lineNumber,
+      [delim](
+          const char* p, const char* end, uint64_t* src, uint64_t* dst,
+          edge_value_type* data) {
+        if (!parseToken(&p, end, src)) {
+          return false;
+        }
+        if (delim && !skipDelim(&p, end, *delim)) {
+          return false;
+        }
+        if (!parseToken(&p, end, dst)) {
+          return false;
+        }
+        if constexpr (EdgeData::has_value) {
+          if (delim && !skipDelim(&p, end, *delim)) {
+            return false;
+          }
+          if (!parseToken(&p, end, data)) {
+            return false;
+          }
+        }
+        return true;
+      },
+      &edges);
+
+  if (edges.skippedLine) {
+    galois::gWarn(
+        "ignored at least one line (line ", *edges.skippedLine,
+        ") because it did not match the expected format\n");
+  }
+
+  size_t numNodes = edges.maxNode + 1;
+  writeParsedEdges(edges, numNodes, outfilename, toKg);
+  printStatus(numNodes, edges.numEdges);
 }
 
 /**
@@ -580,24 +869,33 @@ convertEdgelist(
  * Just a bunch of pairs or triples:
  * src dst weight?
  */
-struct CSV2Gr : public Conversion {
+template <bool ToKg>
+struct CSV2 : public Conversion {
   template <typename EdgeTy>
   void convert(const std::string& infilename, const std::string& outfilename) {
-    convertEdgelist<EdgeTy>(infilename, outfilename, true, ',');
+    convertEdgelist<EdgeTy>(infilename, outfilename, true, ',', ToKg);
   }
 };
 
+using CSV2Gr = CSV2<false>;
+using CSV2Kg = CSV2<true>;
+
 /**
  * Just a bunch of pairs or triples:
  * src dst weight?
  */
-struct Edgelist2Gr : public Conversion {
+template <bool ToKg>
+struct Edgelist2 : public Conversion {
   template <typename EdgeTy>
   void convert(const std::string& infilename, const std::string& outfilename) {
-    convertEdgelist<EdgeTy>(infilename, outfilename, false);
+    convertEdgelist<EdgeTy>(
+        infilename, outfilename, false, std::optional<char>(), ToKg);
   }
 };
 
+using Edgelist2Gr = Edgelist2<false>;
+using Edgelist2Kg = Edgelist2<true>;
+
 /**
  * Convert edgelist to binary edgelist format
  * Assumes no edge data.
@@ -675,111 +973,86 @@ struct Edgelist2Binary : public Conversion {
  *
  * src and dst start at 1.
  */
-struct Mtx2Gr : public HasNoVoidSpecialization {
+template <bool ToKg>
+struct Mtx2 : public HasNoVoidSpecialization {
   template <typename EdgeTy>
   void convert(const std::string& infilename, const std::string& outfilename) {
-    typedef galois::graphs::FileGraphWriter Writer;
     typedef galois::LargeArray<EdgeTy> EdgeData;
     typedef typename EdgeData::value_type edge_value_type;
 
-    Writer p;
-    EdgeData edgeData;
-    uint32_t nnodes;
-    size_t nedges;
-
-    for (int phase = 0; phase < 2; ++phase) {
-      std::ifstream infile(infilename.c_str());
-      if (!infile) {
-        GALOIS_DIE("failed to open input file");
-      }
-
-      // Skip comments
-      while (infile) {
-        if (infile.peek() != '%') {
-          break;
-        }
-        skipLine(infile);
-      }
-
-      // Read header
-      char header[256];
-      infile.getline(header, 256);
-      std::istringstream line(header, std::istringstream::in);
-      std::vector<std::string> tokens;
-      while (line) {
-        std::string tmp;
-        line >> tmp;
-        if (line) {
-          tokens.push_back(tmp);
-        }
-      }
-      if (tokens.size() != 3) {
-        GALOIS_DIE("unknown problem specification line: ", line.str());
-      }
-      // Prefer C functions for maximum compatibility
-      // nnodes = std::stoull(tokens[0]);
-      // nedges = std::stoull(tokens[2]);
-      nnodes = strtoull(tokens[0].c_str(), NULL, 0);
-      nedges = strtoull(tokens[2].c_str(), NULL, 0);
-
-      // Parse edges
-      if (phase == 0) {
-        p.setNumNodes(nnodes);
-        p.setNumEdges(nedges);
-        p.setSizeofEdgeData(EdgeData::size_of::value);
-        edgeData.create(nedges);
-        p.phase1();
-      } else {
-        p.phase2();
-      }
-
-      for (size_t edge_num = 0; edge_num < nedges; ++edge_num) {
-        if ((edge_num % (nedges / 500)) == 0) {
-          printf(
-              "Phase %d: current edge progress %lf%%\n", phase,
-              ((double)edge_num / nedges) * 100);
-        }
-        uint32_t cur_id, neighbor_id;
-        double weight = 1;
-
-        infile >> cur_id >> neighbor_id >> weight;
-        if (cur_id == 0 || cur_id > nnodes) {
-          GALOIS_DIE("node id out of range: ", cur_id);
-        }
-        if (neighbor_id == 0 || neighbor_id > nnodes) {
-          GALOIS_DIE("neighbor id out of range: ", neighbor_id);
-        }
-
-        // 1 indexed
-        if (phase == 0) {
-          p.incrementDegree(cur_id - 1);
-        } else {
-          edgeData.set(
-              p.addNeighbor(cur_id - 1, neighbor_id - 1),
-              static_cast<edge_value_type>(weight));
-        }
+    MappedFile infile(infilename);
+    const char* begin = infile.begin();
+    const char* end = infile.end();
+
+    // Skip comments
+    while (begin != end && *begin == '%') {
+      begin = nextLine(begin, end);
+    }
+
+    // Read header
+    std::istringstream line(
+        std::string(begin, lineEnd(begin, end)), std::istringstream::in);
+    std::vector<std::string> tokens;
+    while (line) {
+      std::string tmp;
+      line >> tmp;
+      if (line) {
+        tokens.push_back(tmp);
+      }
+    }
+    if (tokens.size() != 3) {
+      GALOIS_DIE("unknown problem specification line: ", line.str());
+    }
+    // Prefer C functions for maximum compatibility
+    // nnodes = std::stoull(tokens[0]);
+    // nedges = std::stoull(tokens[2]);
+    uint64_t nnodes = strtoull(tokens[0].c_str(), NULL, 0);
+    size_t nedges = strtoull(tokens[2].c_str(), NULL, 0);
+
+    // Parse edges
+    ParsedEdges<EdgeTy> edges;
+    parseEdges<EdgeTy>(
+        nextLine(begin, end), end, 0,
+        [nnodes](
+            const char* p, const char* e, uint64_t* src, uint64_t* dst,
+            edge_value_type* data) {
+          uint64_t cur_id;
+          uint64_t neighbor_id;
+          double weight = 1;
+          if (!parseToken(&p, e, &cur_id)) {
+            return false;
+          }
+          if (!parseToken(&p, e, &neighbor_id)) {
+            GALOIS_DIE("missing neighbor of node: ", cur_id);
+          }
+          parseToken(&p, e, &weight);
+          if (cur_id == 0 || cur_id > nnodes) {
+            GALOIS_DIE("node id out of range: ", cur_id);
+          }
+          if (neighbor_id == 0 || neighbor_id > nnodes) {
+            GALOIS_DIE("neighbor id out of range: ", neighbor_id);
+          }
 
-        skipLine(infile);
-      }
+          // 1 indexed
+          *src = cur_id - 1;
+          *dst = neighbor_id - 1;
+          *data = static_cast<edge_value_type>(weight);
+          return true;
+        },
+        &edges);
 
-      infile.peek();
-      if (!infile.eof()) {
-        GALOIS_DIE("additional lines in file");
-      }
+    if (edges.numEdges != nedges) {
+      GALOIS_DIE("expected ", nedges, " edges but found ", edges.numEdges);
     }
-    // this is for the progress print
-
-    edge_value_type* rawEdgeData = p.finish<edge_value_type>();
-    if (EdgeData::has_value)
-      std::uninitialized_copy(
-          std::make_move_iterator(edgeData.begin()),
-          std::make_move_iterator(edgeData.end()), rawEdgeData);
 
-    p.toFile(outfilename);
-    printStatus(p.size(), p.sizeEdges());
+    writeParsedEdges(edges, nnodes, outfilename, ToKg);
+    printStatus(nnodes, nedges);
   }
 };
 
+using Mtx2Gr = Mtx2<false>;
+using Mtx2Kg = Mtx2<true>;
+
 struct Gr2Mtx : public HasNoVoidSpecialization {
   template <typename EdgeTy>
   void convert(const std::string& infilename, const std::string& outfilename) {
@@ -2253,109 +2526,91 @@ struct MakeUnsymmetric : public Conversion {
 //  p XXX* <num nodes> <num edges>
 //  a <src id> <dst id> <weight>
 //  ....
-struct Dimacs2Gr : public HasNoVoidSpecialization {
+template <bool ToKg>
+struct Dimacs2 : public HasNoVoidSpecialization {
   template <typename EdgeTy>
   void convert(const std::string& infilename, const std::string& outfilename) {
-    typedef galois::graphs::FileGraphWriter Writer;
     typedef galois::LargeArray<EdgeTy> EdgeData;
     typedef typename EdgeData::value_type edge_value_type;
 
-    Writer p;
-    EdgeData edgeData;
-    uint32_t nnodes;
-    size_t nedges;
-
-    for (int phase = 0; phase < 2; ++phase) {
-      std::ifstream infile(infilename.c_str());
-
-      // Skip comments
-      while (infile) {
-        if (infile.peek() == 'p') {
-          break;
-        }
-        skipLine(infile);
-      }
-
-      // Read header
-      char header[256];
-      infile.getline(header, 256);
-      std::istringstream line(header, std::istringstream::in);
-      std::vector<std::string> tokens;
-      while (line) {
-        std::string tmp;
-        line >> tmp;
-        if (line) {
-          tokens.push_back(tmp);
-        }
-      }
-      if (tokens.size() < 3 || tokens[0].compare("p") != 0) {
-        GALOIS_DIE("unknown problem specification line: ", line.str());
-      }
-      // Prefer C functions for maximum compatibility
-      // nnodes = std::stoull(tokens[tokens.size() - 2]);
-      // nedges = std::stoull(tokens[tokens.size() - 1]);
-      nnodes = strtoull(tokens[tokens.size() - 2].c_str(), NULL, 0);
-      nedges = strtoull(tokens[tokens.size() - 1].c_str(), NULL, 0);
-
-      // Parse edges
-      if (phase == 0) {
-        p.setNumNodes(nnodes);
-        p.setNumEdges(nedges);
-        p.setSizeofEdgeData(EdgeData::size_of::value);
-        edgeData.create(nedges);
-        p.phase1();
-      } else {
-        p.phase2();
-      }
-
-      for (size_t edge_num = 0; edge_num < nedges; ++edge_num) {
-        uint32_t cur_id;
-        uint32_t neighbor_id;
-        int32_t weight;
-        std::string tmp;
-        infile >> tmp;
-
-        if (tmp.compare("a") != 0) {
-          --edge_num;
-          skipLine(infile);
-          continue;
-        }
-
-        infile >> cur_id >> neighbor_id >> weight;
-        if (cur_id == 0 || cur_id > nnodes) {
-          GALOIS_DIE("node id out of range: ", cur_id);
-        }
-        if (neighbor_id == 0 || neighbor_id > nnodes) {
-          GALOIS_DIE("neighbor id out of range: ", neighbor_id);
-        }
-
-        // 1 indexed
-        if (phase == 0) {
-          p.incrementDegree(cur_id - 1);
-        } else {
-          edgeData.set(p.addNeighbor(cur_id - 1, neighbor_id - 1), weight);
-        }
+    MappedFile infile(infilename);
+    const char* begin = infile.begin();
+    const char* end = infile.end();
+
+    // Skip comments
+    while (begin != end && *begin != 'p') {
+      begin = nextLine(begin, end);
+    }
+
+    // Read header
+    std::istringstream line(
+        std::string(begin, lineEnd(begin, end)), std::istringstream::in);
+    std::vector<std::string> tokens;
+    while (line) {
+      std::string tmp;
+      line >> tmp;
+      if (line) {
+        tokens.push_back(tmp);
+      }
+    }
+    if (tokens.size() < 3 || tokens[0].compare("p") != 0) {
+      GALOIS_DIE("unknown problem specification line: ", line.str());
+    }
+    // Prefer C functions for maximum compatibility
+    // nnodes = std::stoull(tokens[tokens.size() - 2]);
+    // nedges = std::stoull(tokens[tokens.size() - 1]);
+    uint64_t nnodes = strtoull(tokens[tokens.size() - 2].c_str(), NULL, 0);
+    size_t nedges = strtoull(tokens[tokens.size() - 1].c_str(), NULL, 0);
+
+    // Parse edges; lines other than "a <src> <dst> <weight>" are ignored
+    ParsedEdges<EdgeTy> edges;
+    parseEdges<EdgeTy>(
+        nextLine(begin, end), end, 0,
+        [nnodes](
+            const char* p, const char* e, uint64_t* src, uint64_t* dst,
+            edge_value_type* data) {
+          p = skipBlanks(p, e);
+          if (p == e || *p != 'a' ||
+              (p + 1 != e && *(p + 1) != ' ' && *(p + 1) != '\t')) {
+            return false;
+          }
+          ++p;
+
+          uint64_t cur_id;
+          uint64_t neighbor_id;
+          int32_t weight;
+          if (!parseToken(&p, e, &cur_id) ||
+              !parseToken(&p, e, &neighbor_id) ||
+              !parseToken(&p, e, &weight)) {
+            GALOIS_DIE("malformed arc: ", std::string(p, e));
+          }
+          if (cur_id == 0 || cur_id > nnodes) {
+            GALOIS_DIE("node id out of range: ", cur_id);
+          }
+          if (neighbor_id == 0 || neighbor_id > nnodes) {
+            GALOIS_DIE("neighbor id out of range: ", neighbor_id);
+          }
 
-        skipLine(infile);
-      }
+          // 1 indexed
+          *src = cur_id - 1;
+          *dst = neighbor_id - 1;
+          *data = static_cast<edge_value_type>(weight);
+          return true;
+        },
+        &edges);
 
-      infile.peek();
-      if (!infile.eof()) {
-        GALOIS_DIE("additional lines in file");
-      }
+    if (edges.numEdges != nedges) {
+      GALOIS_DIE("expected ", nedges, " edges but found ", edges.numEdges);
     }
 
-    edge_value_type* rawEdgeData = p.finish<edge_value_type>();
-    if (EdgeData::has_value)
-      std::uninitialized_copy(
-          std::make_move_iterator(edgeData.begin()),
-          std::make_move_iterator(edgeData.end()), rawEdgeData);
-
-    p.toFile(outfilename);
-    printStatus(p.size(), p.sizeEdges());
+    writeParsedEdges(edges, nnodes, outfilename, ToKg);
+    printStatus(nnodes, nedges);
   }
 };
 
+using Dimacs2Gr = Dimacs2<false>;
+using Dimacs2Kg = Dimacs2<true>;
+
 /**
  * PBBS input is an ASCII file of tokens that serialize a CSR graph. I.e.,
  * elements in brackets are non-literals:
@@ -2824,48 +3079,6 @@ struct Gr2Neo4j : public Conversion {
   }
 };
 
-/**
- * This is Required gr to kg conversion to append edge data 
- * as the edge property. 
- */
-template <typename EdgeTy>
-galois::Result<void>
-AppendEdgeData(
-    galois::graphs::PropertyFileGraph* pfg,
-    const galois::LargeArray<EdgeTy>& edge_data) {
-  using Builder = typename arrow::CTypeTraits<EdgeTy>::BuilderType;
-  using ArrowType = typename arrow::CTypeTraits<EdgeTy>::ArrowType;
-  Builder builder;
-  if (auto r = builder.AppendValues(edge_data.begin(), edge_data.end());
-      !r.ok()) {
-    GALOIS_LOG_DEBUG("arrow error: {}", r);
-    return galois::ErrorCode::ArrowError;
-  }
-
-  std::shared_ptr<arrow::Array> ret;
-  if (auto r = builder.Finish(&ret); !r.ok()) {
-    GALOIS_LOG_DEBUG("arrow error: {}", r);
-    return galois::ErrorCode::ArrowError;
-  }
-  std::vector<std::shared_ptr<arrow::Field>> fields;
-  std::vector<std::shared_ptr<arrow::Array>> columns;
-  fields.emplace_back(arrow::field(("value"), std::make_shared<ArrowType>()));
-  columns.emplace_back(ret);
-  auto edge_data_table = arrow::Table::Make(arrow::schema(fields), columns);
-  if (auto r = pfg->AddEdgeProperties(edge_data_table); !r) {
-    GALOIS_LOG_DEBUG("could not add edge property: {}", r.error());
-    return r;
-  }
-  return galois::ResultSuccess();
-}
-
-template <>
-galois::Result<void>
-AppendEdgeData<void>(
-    galois::graphs::PropertyFileGraph*, const galois::LargeArray<void>&) {
-  return galois::ResultSuccess();
-}
-
 /**
  * Gr2Kg reads in the binary csr (.gr) files and produces
  * katana graph property graphs. 
@@ -2873,76 +3086,10 @@ AppendEdgeData<void>(
 struct Gr2Kg : public Conversion {
   template <typename EdgeTy>
   void convert(const std::string& infilename, const std::string& outfilename) {
-    using Graph = galois::graphs::FileGraph;
-    using GNode = Graph::GraphNode;
-    using EdgeData = galois::LargeArray<EdgeTy>;
-    using edge_value_type = typename EdgeData::value_type;
-
-    Graph graph;
+    galois::graphs::FileGraph graph;
     graph.fromFile(infilename);
 
-    galois::LargeArray<uint64_t> out_indices;
-    out_indices.allocateBlocked(graph.size());
-
-    galois::LargeArray<uint32_t> out_dests;
-    out_dests.allocateBlocked(graph.sizeEdges());
-
-    galois::LargeArray<EdgeTy> out_dests_data;
-    if (EdgeData::has_value) {
-      out_dests_data.allocateBlocked(graph.sizeEdges());
-    }
-
-    // write edges
-    for (Graph::iterator ii = graph.begin(), ei = graph.end(); ii != ei; ++ii) {
-      GNode src = *ii;
-      out_indices[src] = *graph.edge_end(src);
-      for (Graph::edge_iterator jj = graph.edge_begin(src),
-                                ej = graph.edge_end(src);
-           jj != ej; ++jj) {
-        GNode dst = graph.getEdgeDst(jj);
-        out_dests[*jj] = dst;
-        if (EdgeData::has_value) {
-          out_dests_data.set(*jj, graph.getEdgeData<edge_value_type>(jj));
-        }
-      }
-    }
-
-    auto numeric_array_out_indices =
-        std::make_shared<arrow::NumericArray<arrow::UInt64Type>>(
-            static_cast<int64_t>(graph.size()),
-            arrow::MutableBuffer::Wrap(out_indices.data(), graph.size()));
-
-    auto numeric_array_out_dests =
-        std::make_shared<arrow::NumericArray<arrow::UInt32Type>>(
-            static_cast<int64_t>(graph.sizeEdges()),
-            arrow::MutableBuffer::Wrap(out_dests.data(), graph.sizeEdges()));
-
-    auto pfg = std::make_unique<galois::graphs::PropertyFileGraph>();
-    auto set_result = pfg->SetTopology(galois::graphs::GraphTopology{
-        .out_indices = std::move(numeric_array_out_indices),
-        .out_dests = std::move(numeric_array_out_dests),
-    });
-
-    if (!set_result) {
-      GALOIS_LOG_FATAL(
-          "Failed to set topology for property file graph: {}",
-          set_result.error());
-    }
-
-    if (EdgeData::has_value) {
-      if (auto r = AppendEdgeData<EdgeTy>(pfg.get(), out_dests_data); !r) {
-        GALOIS_LOG_FATAL("could not add edge property: {}", r.error());
-      }
-    }
-
-    pfg->MarkAllPropertiesPersistent();
-
-    galois::gPrint("Edge Schema : ", pfg->edge_schema()->ToString(), "\n");
-    galois::gPrint("Node Schema : ", pfg->node_schema()->ToString(), "\n");
-
-    if (auto r = pfg->Write(outfilename, "cmd"); !r) {
-      GALOIS_LOG_FATAL("Failed to write property file graph: {}", r.error());
-    }
+    writeKg<EdgeTy>(graph, outfilename);
     printStatus(graph.size(), graph.sizeEdges());
   }
 };
@@ -3198,6 +3345,47 @@ struct Svmlight2Gr : public HasNoVoidSpecialization {
   }
 };
 
+/**
+ * Transforms the edges of the property graph inputFilename in parallel and
+ * writes the result to the property graph outputFilename, carrying the node
+ * and edge properties along.
+ */
+void
+transformKg(ConvertMode mode, const std::string& commandLine) {
+  auto pfgResult = galois::graphs::PropertyFileGraph::Make(inputFilename);
+  if (!pfgResult) {
+    GALOIS_LOG_FATAL("cannot load {}: {}", inputFilename, pfgResult.error());
+  }
+  const galois::graphs::PropertyFileGraph& pfg = *pfgResult.value();
+
+  galois::graphs::EdgeFilter filter{removeSelfLoops, removeMultiEdges};
+  galois::Result<std::unique_ptr<galois::graphs::PropertyFileGraph>> result =
+      galois::ErrorCode::InvalidArgument;
+  switch (mode) {
+  case kg2ckg:
+    result = galois::graphs::SimplifyEdges(pfg);
+    break;
+  case kg2skg:
+    result = galois::graphs::Symmetrize(pfg, filter);
+    break;
+  case kg2tkg:
+    result = galois::graphs::Transpose(pfg, filter);
+    break;
+  default:
+    break;
+  }
+  if (!result) {
+    GALOIS_LOG_FATAL("cannot transform {}: {}", inputFilename, result.error());
+  }
+
+  const galois::graphs::GraphTopology& topology = result.value()->topology();
+  std::cout << "Nodes: " << topology.num_nodes()
+            << " Edges: " << topology.num_edges() << "\n";
+  if (auto r = result.value()->Write(outputFilename, commandLine); !r) {
+    GALOIS_LOG_FATAL("cannot write {}: {}", outputFilename, r.error());
+  }
+}
+
 int
 main(int argc, char** argv) {
   galois::SharedMemSys G;
@@ -3206,6 +3394,8 @@ main(int argc, char** argv) {
       "Converter for old graphs to gr formats for galois\n\n"
       "  For converting property graphs use graph-properties-convert\n");
   std::ios_base::sync_with_stdio(false);
+  galois::setActiveThreads(
+      numThreads > 0 ? numThreads : std::numeric_limits<unsigned>::max());
   switch (convertMode) {
   case bipartitegr2bigpetsc:
     convert<Bipartitegr2Petsc<double, false>>();
@@ -3219,12 +3409,21 @@ main(int argc, char** argv) {
   case dimacs2gr:
     convert<Dimacs2Gr>();
     break;
+  case dimacs2kg:
+    convert<Dimacs2Kg>();
+    break;
   case edgelist2gr:
     convert<Edgelist2Gr>();
     break;
+  case edgelist2kg:
+    convert<Edgelist2Kg>();
+    break;
   case csv2gr:
     convert<CSV2Gr>();
     break;
+  case csv2kg:
+    convert<CSV2Kg>();
+    break;
   case gr2biggr:
     convert<ToBigEndian>();
     break;
@@ -3327,9 +3526,23 @@ main(int argc, char** argv) {
   case gr2kg:
     convert<Gr2Kg>();
     break;
+  case kg2ckg:
+  case kg2skg:
+  case kg2tkg: {
+    std::string commandLine;
+    for (int i = 0; i < argc; ++i) {
+      commandLine += i ? " " : "";
+      commandLine += argv[i];
+    }
+    transformKg(convertMode, commandLine);
+    break;
+  }
   case mtx2gr:
     convert<Mtx2Gr>();
     break;
+  case mtx2kg:
+    convert<Mtx2Kg>();
+    break;
   case nodelist2gr:
     convert<Nodelist2Gr>();
     break;
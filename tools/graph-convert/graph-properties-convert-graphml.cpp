@@ -1,8 +1,15 @@
 #include "graph-properties-convert-graphml.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <algorithm>
+#include <array>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <deque>
 #include <fstream>
 #include <iostream>
@@ -11,6 +18,7 @@
 #include <optional>
 #include <random>
 #include <sstream>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -18,6 +26,7 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include "galois/Env.h"
 #include "galois/ErrorCode.h"
 #include "galois/Galois.h"
 #include "galois/Logging.h"
@@ -328,22 +337,31 @@ ProcessData(xmlTextReaderPtr reader) {
   }
   return make_pair(key, propertyData);
 }
+/// A node or edge parsed from a GraphML file, held until it is added to the
+/// PropertyGraphBuilder so that parsing and building can happen on different
+/// threads
+struct GraphMLElement {
+  bool is_node{false};
+  std::string id;
+  std::string source;
+  std::string target;
+  std::vector<std::string> labels;
+  std::vector<std::pair<std::string, std::string>> properties;
+};
 
 /*
  * reader should be pointing at the node element before calling
  *
- * parses the node from a GraphML file into readable form
+ * parses the node from a GraphML file into readable form, returns false if
+ * the node is missing its id
  */
-void
-ProcessNode(xmlTextReaderPtr reader, galois::PropertyGraphBuilder* builder) {
+bool
+ProcessNode(xmlTextReaderPtr reader, GraphMLElement* node) {
   auto minimum_depth = xmlTextReaderDepth(reader);
 
   int ret = xmlTextReaderMoveToNextAttribute(reader);
   xmlChar *name, *value;
 
-  std::string id;
-  std::vector<std::string> labels;
-
   bool extractedLabels = false;  // neo4j includes these twice so only parse 1
 
   // parse node attributes for id (required) and label(s) (optional)
@@ -353,7 +371,7 @@ ProcessNode(xmlTextReaderPtr reader, galois::PropertyGraphBuilder* builder) {
 
     if (name != NULL) {
       if (xmlStrEqual(name, BAD_CAST "id")) {
-        id = std::string((const char*)value);
+        node->id = std::string((const char*)value);
       } else if (
           xmlStrEqual(name, BAD_CAST "labels") ||
           xmlStrEqual(name, BAD_CAST "label")) {
@@ -362,7 +380,7 @@ ProcessNode(xmlTextReaderPtr reader, galois::PropertyGraphBuilder* builder) {
         if (data.front() == ':') {
           data.erase(0, 1);
         }
-        boost::split(labels, data, boost::is_any_of(":"));
+        boost::split(node->labels, data, boost::is_any_of(":"));
         extractedLabels = true;
       } else {
         GALOIS_LOG_ERROR(
@@ -376,11 +394,6 @@ ProcessNode(xmlTextReaderPtr reader, galois::PropertyGraphBuilder* builder) {
     ret = xmlTextReaderMoveToNextAttribute(reader);
   }
 
-  bool validNode = !id.empty();
-  if (validNode) {
-    builder->StartNode(id);
-  }
-
   // parse "data" xml nodes for properties
   ret = xmlTextReaderRead(reader);
   // will terminate when </node> reached or an improper read
@@ -404,22 +417,11 @@ ProcessNode(xmlTextReaderPtr reader, galois::PropertyGraphBuilder* builder) {
               if (data.front() == ':') {
                 data.erase(0, 1);
               }
-              boost::split(labels, data, boost::is_any_of(":"));
+              boost::split(node->labels, data, boost::is_any_of(":"));
               extractedLabels = true;
             }
           } else if (property.first != std::string("IGNORE")) {
-            if (validNode) {
-              const std::string& value = property.second;
-              builder->AddValue(
-                  property.first,
-                  [&]() {
-                    return PropertyKey{
-                        property.first, ImportDataType::kString, false};
-                  },
-                  [&value](ImportDataType type, bool is_list) {
-                    return ResolveValue(value, type, is_list);
-                  });
-            }
+            node->properties.emplace_back(std::move(property));
           }
         }
       } else {
@@ -433,31 +435,22 @@ ProcessNode(xmlTextReaderPtr reader, galois::PropertyGraphBuilder* builder) {
     ret = xmlTextReaderRead(reader);
   }
 
-  // add labels if they exists
-  if (validNode) {
-    if (!labels.empty()) {
-      for (std::string label : labels) {
-        builder->AddLabel(label);
-      }
-    }
-    builder->FinishNode();
-  }
+  return !node->id.empty();
 }
 
 /*
  * reader should be pointing at the edge element before calling
  *
- * parses the edge from a GraphML file into readable form
+ * parses the edge from a GraphML file into readable form, returns false if
+ * the edge is missing its source or target
  */
-void
-ProcessEdge(xmlTextReaderPtr reader, galois::PropertyGraphBuilder* builder) {
+bool
+ProcessEdge(xmlTextReaderPtr reader, GraphMLElement* edge) {
   auto minimum_depth = xmlTextReaderDepth(reader);
 
   int ret = xmlTextReaderMoveToNextAttribute(reader);
   xmlChar *name, *value;
 
-  std::string source;
-  std::string target;
   std::string type;
   bool extracted_type = false;  // neo4j includes these twice so only parse 1
 
@@ -469,9 +462,9 @@ ProcessEdge(xmlTextReaderPtr reader, galois::PropertyGraphBuilder* builder) {
     if (name != NULL) {
       if (xmlStrEqual(name, BAD_CAST "id")) {
       } else if (xmlStrEqual(name, BAD_CAST "source")) {
-        source = std::string((const char*)value);
+        edge->source = std::string((const char*)value);
       } else if (xmlStrEqual(name, BAD_CAST "target")) {
-        target = std::string((const char*)value);
+        edge->target = std::string((const char*)value);
       } else if (
           xmlStrEqual(name, BAD_CAST "labels") ||
           xmlStrEqual(name, BAD_CAST "label")) {
@@ -489,11 +482,6 @@ ProcessEdge(xmlTextReaderPtr reader, galois::PropertyGraphBuilder* builder) {
     ret = xmlTextReaderMoveToNextAttribute(reader);
   }
 
-  bool valid_edge = !source.empty() && !target.empty();
-  if (valid_edge) {
-    valid_edge = builder->StartEdge(source, target);
-  }
-
   // parse "data" xml edges for properties
   ret = xmlTextReaderRead(reader);
   // will terminate when </edge> reached or an improper read
@@ -516,18 +504,7 @@ ProcessEdge(xmlTextReaderPtr reader, galois::PropertyGraphBuilder* builder) {
               extracted_type = true;
             }
           } else if (property.first != std::string("IGNORE")) {
-            if (valid_edge) {
-              const std::string& value = property.second;
-              builder->AddValue(
-                  property.first,
-                  [&]() {
-                    return PropertyKey{
-                        property.first, ImportDataType::kString, false};
-                  },
-                  [&value](ImportDataType type, bool is_list) {
-                    return ResolveValue(value, type, is_list);
-                  });
-            }
+            edge->properties.emplace_back(std::move(property));
           }
         }
       } else {
@@ -540,27 +517,24 @@ ProcessEdge(xmlTextReaderPtr reader, galois::PropertyGraphBuilder* builder) {
     ret = xmlTextReaderRead(reader);
   }
 
-  // add type if it exists
-  if (valid_edge) {
-    if (type.length() > 0) {
-      builder->AddLabel(type);
-    }
-    builder->FinishEdge();
+  if (type.length() > 0) {
+    edge->labels.emplace_back(std::move(type));
   }
+  return !edge->source.empty() && !edge->target.empty();
 }
 
 /*
  * reader should be pointing at the graph element before calling
  *
- * parses the graph structure from a GraphML file into Galois format
+ * parses the nodes and edges of a graph element and passes each valid one to
+ * add in document order, returns the status of the last read
  */
-void
-ProcessGraph(xmlTextReaderPtr reader, galois::PropertyGraphBuilder* builder) {
+template <typename AddFn>
+int
+ProcessGraph(xmlTextReaderPtr reader, AddFn add) {
   auto minimum_depth = xmlTextReaderDepth(reader);
   int ret = xmlTextReaderRead(reader);
 
-  bool finished_nodes = false;
-
   // will terminate when </graph> reached or an improper read
   while (ret == 1 && minimum_depth < xmlTextReaderDepth(reader)) {
     xmlChar* name;
@@ -572,14 +546,17 @@ ProcessGraph(xmlTextReaderPtr reader, galois::PropertyGraphBuilder* builder) {
     if (xmlTextReaderNodeType(reader) == 1) {
       // if elt is a "node" xml node read it in
       if (xmlStrEqual(name, BAD_CAST "node")) {
-        ProcessNode(reader, builder);
-      } else if (xmlStrEqual(name, BAD_CAST "edge")) {
-        if (!finished_nodes) {
-          finished_nodes = true;
-          std::cout << "Finished processing nodes\n";
+        GraphMLElement node;
+        node.is_node = true;
+        if (ProcessNode(reader, &node)) {
+          add(std::move(node));
         }
+      } else if (xmlStrEqual(name, BAD_CAST "edge")) {
         // if elt is an "egde" xml node read it in
-        ProcessEdge(reader, builder);
+        GraphMLElement edge;
+        if (ProcessEdge(reader, &edge)) {
+          add(std::move(edge));
+        }
       } else {
         GALOIS_LOG_ERROR(
             "Found element: {}, which was ignored",
@@ -590,13 +567,254 @@ ProcessGraph(xmlTextReaderPtr reader, galois::PropertyGraphBuilder* builder) {
     xmlFree(name);
     ret = xmlTextReaderRead(reader);
   }
-  std::cout << "Finished processing edges\n";
+  return ret;
+}
+
+/// AddElement adds a parsed node or edge to the graph being built
+void
+AddElement(const GraphMLElement& elt, galois::PropertyGraphBuilder* builder) {
+  if (elt.is_node) {
+    builder->StartNode(elt.id);
+  } else if (!builder->StartEdge(elt.source, elt.target)) {
+    return;
+  }
+
+  for (const auto& property : elt.properties) {
+    const std::string& value = property.second;
+    builder->AddValue(
+        property.first,
+        [&]() {
+          return PropertyKey{property.first, ImportDataType::kString, false};
+        },
+        [&value](ImportDataType type, bool is_list) {
+          return ResolveValue(value, type, is_list);
+        });
+  }
+  for (const std::string& label : elt.labels) {
+    builder->AddLabel(label);
+  }
+
+  if (elt.is_node) {
+    builder->FinishNode();
+  } else {
+    builder->FinishEdge();
+  }
+}
+
+/***************************************************/
+/* Functions for parsing GraphML files in parallel */
+/***************************************************/
+
+/// Bytes of the graph element given to each parallel parsing task
+constexpr int kDefaultSegmentBytes = 8 << 20;
+
+bool
+IsNameEnd(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '>' ||
+         c == '/';
+}
+
+/// FindGraphBody returns the range between the open and close tags of the
+/// graph element, or std::nullopt if the file cannot safely be split at
+/// node/edge tags. Splitting is done by looking for "<node" and "<edge" in the
+/// raw bytes so files with comments, CDATA sections, DTDs (and their
+/// entities) or nested graphs are left to the serial parser.
+std::optional<std::string_view>
+FindGraphBody(std::string_view file) {
+  size_t open = file.find("<graph");
+  while (open != std::string_view::npos &&
+         (open + 6 >= file.size() || !IsNameEnd(file[open + 6]))) {
+    open = file.find("<graph", open + 1);
+  }
+  if (open == std::string_view::npos ||
+      file.substr(0, open).find("<!DOCTYPE") != std::string_view::npos) {
+    return std::nullopt;
+  }
+  size_t open_end = file.find('>', open);
+  size_t close_tag = file.rfind("</graph>");
+  if (open_end == std::string_view::npos || file[open_end - 1] == '/' ||
+      close_tag == std::string_view::npos || close_tag <= open_end) {
+    return std::nullopt;
+  }
+
+  std::string_view body =
+      file.substr(open_end + 1, close_tag - open_end - 1);
+  if (body.find("<!") != std::string_view::npos ||
+      body.find("<graph") != std::string_view::npos) {
+    return std::nullopt;
+  }
+  return body;
+}
+
+/// NextElement returns the offset of the first node or edge open tag in body
+/// at or after pos
+size_t
+NextElement(std::string_view body, size_t pos) {
+  while (pos < body.size()) {
+    pos = body.find('<', pos);
+    if (pos == std::string_view::npos || pos + 5 >= body.size()) {
+      break;
+    }
+    std::string_view tag = body.substr(pos + 1, 4);
+    if ((tag == "node" || tag == "edge") && IsNameEnd(body[pos + 5])) {
+      return pos;
+    }
+    ++pos;
+  }
+  return body.size();
+}
+
+std::vector<std::string_view>
+SplitGraphBody(std::string_view body, size_t segment_bytes) {
+  std::vector<std::string_view> segments;
+  size_t begin = 0;
+  while (begin < body.size()) {
+    size_t end = NextElement(body, begin + segment_bytes);
+    segments.emplace_back(body.substr(begin, end - begin));
+    begin = end;
+  }
+  return segments;
+}
+
+/// SegmentInput feeds a segment to libxml2 wrapped in a graph element so that
+/// it parses as a document of its own without copying it
+struct SegmentInput {
+  std::array<std::string_view, 3> parts;
+  size_t part{0};
+  size_t offset{0};
+};
+
+int
+ReadSegment(void* context, char* buffer, int len) {
+  auto* input = static_cast<SegmentInput*>(context);
+  int read = 0;
+  while (read < len && input->part < input->parts.size()) {
+    std::string_view part = input->parts[input->part];
+    size_t n = std::min<size_t>(len - read, part.size() - input->offset);
+    std::memcpy(buffer + read, part.data() + input->offset, n);
+    read += n;
+    input->offset += n;
+    if (input->offset == part.size()) {
+      ++input->part;
+      input->offset = 0;
+    }
+  }
+  return read;
+}
+
+int
+ParseSegment(
+    std::string_view segment, std::vector<GraphMLElement>* elements) {
+  SegmentInput input{{"<graph>", segment, "</graph>"}};
+  xmlTextReaderPtr reader =
+      xmlReaderForIO(ReadSegment, nullptr, &input, nullptr, "UTF-8", 0);
+  if (reader == NULL) {
+    return -1;
+  }
+  int ret = xmlTextReaderRead(reader);
+  if (ret == 1) {
+    ret = ProcessGraph(reader, [elements](GraphMLElement&& elt) {
+      elements->emplace_back(std::move(elt));
+    });
+  }
+  xmlFreeTextReader(reader);
+  return ret;
+}
+
+/*
+ * reader should be pointing at the graph element of infilename before calling
+ *
+ * splits the graph element into segments at node/edge boundaries and parses
+ * rounds of segments on all active threads, adding the elements of each round
+ * to the builder in document order
+ *
+ * returns the status of the parse, or std::nullopt if the file is not suited
+ * to splitting and should be parsed serially with reader
+ */
+template <typename AddFn>
+std::optional<int>
+ProcessGraphParallel(
+    const std::string& infilename, xmlTextReaderPtr reader, AddFn add) {
+  size_t num_threads = galois::getActiveThreads();
+  // segments are parsed as UTF-8, so only encodings it is a superset of work
+  const xmlChar* encoding = xmlTextReaderConstEncoding(reader);
+  if (num_threads < 2 ||
+      (encoding != NULL && xmlStrcasecmp(encoding, BAD_CAST "UTF-8") != 0 &&
+       xmlStrcasecmp(encoding, BAD_CAST "US-ASCII") != 0)) {
+    return std::nullopt;
+  }
+
+  int segment_bytes = kDefaultSegmentBytes;
+  galois::GetEnv("GALOIS_GRAPHML_SEGMENT_BYTES", &segment_bytes);
+  if (segment_bytes <= 0) {
+    return std::nullopt;
+  }
+
+  int fd = open(infilename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return std::nullopt;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    close(fd);
+    return std::nullopt;
+  }
+  void* map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    return std::nullopt;
+  }
+  madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+  std::optional<int> ret;
+  std::string_view file(static_cast<const char*>(map), st.st_size);
+  std::vector<std::string_view> segments;
+  if (auto body = FindGraphBody(file); body) {
+    segments = SplitGraphBody(*body, segment_bytes);
+  }
+
+  if (segments.size() > 1) {
+    std::cout << "Parsing graph in " << segments.size() << " segments\n";
+    // make sure global parser state is set up before readers are created
+    // concurrently
+    xmlInitParser();
+
+    // bound memory use to a round of parsed elements at a time
+    std::vector<std::vector<GraphMLElement>> parsed(num_threads);
+    std::vector<int> rets(num_threads);
+    ret = 1;
+    for (size_t round = 0; round < segments.size() && *ret >= 0;
+         round += num_threads) {
+      size_t num_tasks = std::min(num_threads, segments.size() - round);
+      galois::do_all(
+          galois::iterate(size_t{0}, num_tasks),
+          [&](size_t i) {
+            parsed[i].clear();
+            rets[i] = ParseSegment(segments[round + i], &parsed[i]);
+          },
+          galois::no_stats(), galois::steal());
+
+      for (size_t i = 0; i < num_tasks && *ret >= 0; ++i) {
+        ret = rets[i];
+        for (GraphMLElement& elt : parsed[i]) {
+          add(std::move(elt));
+        }
+      }
+    }
+  }
+
+  munmap(map, st.st_size);
+  return ret;
 }
 
 }  // end of unnamed namespace
 
 /// ConvertGraphML converts a GraphML file into katana form
 ///
+/// The graph element may be parsed in parallel; see ProcessGraphParallel.
+/// GALOIS_GRAPHML_SEGMENT_BYTES sets the amount of the file given to each
+/// parallel task (default 8MB).
+///
 /// \param infilename path to source graphml file
 /// \returns arrow tables of node properties/labels, edge properties/types, and
 /// csr topology
@@ -604,6 +822,7 @@ galois::GraphComponents
 galois::ConvertGraphML(const std::string& infilename, size_t chunk_size) {
   xmlTextReaderPtr reader;
   int ret = 0;
+  int graph_ret = 1;
 
   galois::PropertyGraphBuilder builder{chunk_size};
 
@@ -611,6 +830,15 @@ galois::ConvertGraphML(const std::string& infilename, size_t chunk_size) {
   bool finishedGraph = false;
   std::cout << "Start converting GraphML file: " << infilename << "\n";
 
+  bool finished_nodes = false;
+  auto add = [&](GraphMLElement&& elt) {
+    if (!elt.is_node && !finished_nodes) {
+      finished_nodes = true;
+      std::cout << "Finished processing nodes\n";
+    }
+    AddElement(elt, &builder);
+  };
+
   reader = xmlNewTextReaderFilename(infilename.c_str());
   if (reader != NULL) {
     ret = xmlTextReaderRead(reader);
@@ -640,7 +868,13 @@ galois::ConvertGraphML(const std::string& infilename, size_t chunk_size) {
           }
         } else if (xmlStrEqual(name, BAD_CAST "graph")) {
           std::cout << "Finished processing property headers\n";
-          ProcessGraph(reader, &builder);
+          if (auto parallel_ret = ProcessGraphParallel(infilename, reader, add);
+              parallel_ret) {
+            graph_ret = *parallel_ret;
+          } else {
+            graph_ret = ProcessGraph(reader, add);
+          }
+          std::cout << "Finished processing edges\n";
           finishedGraph = true;
         }
       }
@@ -649,7 +883,7 @@ galois::ConvertGraphML(const std::string& infilename, size_t chunk_size) {
       ret = xmlTextReaderRead(reader);
     }
     xmlFreeTextReader(reader);
-    if (ret < 0) {
+    if (ret < 0 || graph_ret < 0) {
       GALOIS_LOG_FATAL(
           "Failed to parse {}, incorrect xml format\n"
           "Please verify there are no illegal characters in the GraphML file\n"
@@ -83,6 +83,14 @@ cll::opt<std::string> user(
     cll::desc("Username for the target database if needed, default is root"),
     cll::init("root"));
 
+cll::opt<int> connections(
+    "connections",
+    cll::desc("Number of concurrent connections used to read each MongoDB "
+              "collection or MySQL table\n"
+              "Collections are split into ranges of _id and tables into ranges "
+              "of their primary key, which must be a single integer column"),
+    cll::init(1));
+
 cll::opt<bool> export_graphml(
     "export",
     cll::desc("Exports a Katana graph to graphml format\n"
@@ -166,7 +174,8 @@ ParseMongoDB() {
     galois::GenerateMappingMongoDB(input_filename, output_directory);
   } else {
     galois::WritePropertyGraph(
-        galois::ConvertMongoDB(input_filename, mapping, chunk_size),
+        galois::ConvertMongoDB(
+            input_filename, mapping, chunk_size, connections),
         output_directory);
   }
 #else
@@ -181,7 +190,8 @@ ParseMysql() {
     galois::GenerateMappingMysql(input_filename, output_directory, host, user);
   } else {
     galois::WritePropertyGraph(
-        galois::ConvertMysql(input_filename, mapping, chunk_size, host, user),
+        galois::ConvertMysql(
+            input_filename, mapping, chunk_size, host, user, connections),
         output_directory);
   }
 #else
@@ -8,6 +8,7 @@
 #include <iostream>
 #include <limits>
 #include <map>
+#include <memory>
 #include <optional>
 #include <random>
 #include <sstream>
@@ -23,6 +24,7 @@
 #include "galois/Logging.h"
 #include "galois/SharedMemSys.h"
 #include "galois/Threads.h"
+#include "PipelinedFetch.h"
 #include "galois/graphs/PropertyFileGraph.h"
 #include "graph-properties-convert-schema.h"
 
@@ -47,6 +49,28 @@ struct MongoClient {
   ~MongoClient() { mongoc_client_destroy(client); }
 };
 
+struct MongoClientPool {
+  mongoc_client_pool_t* pool;
+
+  MongoClientPool(mongoc_client_pool_t* pool_) : pool(pool_) {}
+  ~MongoClientPool() { mongoc_client_pool_destroy(pool); }
+};
+
+/// Documents copied out of a cursor so that they outlive it
+struct BsonBatch {
+  std::vector<bson_t*> docs;
+
+  BsonBatch() = default;
+  BsonBatch(BsonBatch&& other) = default;
+  BsonBatch(const BsonBatch& no_copy) = delete;
+  BsonBatch& operator=(const BsonBatch& no_copy) = delete;
+  ~BsonBatch() {
+    for (bson_t* doc : docs) {
+      bson_destroy(doc);
+    }
+  }
+};
+
 struct bson_value_t_wrapper {
   bson_value_t val;
 };
@@ -529,6 +553,28 @@ GetMongoClient(const char* uri_string) {
   return client;
 }
 
+// mongoc_init() should be called before this function
+mongoc_client_pool_t*
+GetMongoClientPool(const char* uri_string, size_t max_size) {
+  bson_error_t error;
+  mongoc_uri_t* uri = mongoc_uri_new_with_error(uri_string, &error);
+  if (!uri) {
+    GALOIS_LOG_FATAL(
+        "Failed to parse URI: {}\n"
+        "Error message: {}\n",
+        uri_string, error.message);
+  }
+  mongoc_client_pool_t* pool = mongoc_client_pool_new(uri);
+  if (!pool) {
+    GALOIS_LOG_FATAL("Could not create client pool for URI: {}", uri_string);
+  }
+  mongoc_client_pool_max_size(pool, max_size);
+  mongoc_client_pool_set_appname(pool, "graph-properties-convert");
+  mongoc_uri_destroy(uri);
+
+  return pool;
+}
+
 std::vector<std::string>
 GetCollectionNames(mongoc_database_t* database) {
   std::vector<std::string> coll_names;
@@ -570,6 +616,166 @@ QueryEntireCollection(
   mongoc_collection_destroy(collection);
 }
 
+/// Number of documents read per query when reading a collection over several
+/// connections
+constexpr int64_t kDocumentsPerBatch = 100000;
+
+/// PartitionCollection returns boundaries b_0, ..., b_n of the _id values of
+/// a collection such that [b_i, b_i+1) (and [b_n-1, b_n] for the last range)
+/// each hold about kDocumentsPerBatch documents. Returns no boundaries if the
+/// collection cannot be partitioned because its _ids are of different types.
+std::vector<bson_value_t>
+PartitionCollection(
+    mongoc_database_t* database, const std::string& coll_name,
+    size_t num_connections) {
+  std::vector<bson_value_t> bounds;
+  bson_error_t error;
+  auto collection = mongoc_database_get_collection(database, coll_name.c_str());
+
+  int64_t num_docs = mongoc_collection_estimated_document_count(
+      collection, nullptr, nullptr, nullptr, &error);
+  if (num_docs < 0) {
+    GALOIS_LOG_ERROR(
+        "Could not count documents of {}: {}", coll_name, error.message);
+    mongoc_collection_destroy(collection);
+    return bounds;
+  }
+  int64_t num_buckets = std::max<int64_t>(
+      num_connections, num_docs / kDocumentsPerBatch + 1);
+
+  bson_t* pipeline = BCON_NEW(
+      "pipeline", "[", "{", "$project", "{", "_id", BCON_INT32(1), "}", "}",
+      "{", "$bucketAuto", "{", "groupBy", BCON_UTF8("$_id"), "buckets",
+      BCON_INT32(static_cast<int32_t>(
+          std::min<int64_t>(num_buckets, std::numeric_limits<int32_t>::max()))),
+      "}", "}", "]");
+  bson_t* opts = BCON_NEW("allowDiskUse", BCON_BOOL(true));
+  auto docs = mongoc_collection_aggregate(
+      collection, MONGOC_QUERY_NONE, pipeline, opts, nullptr);
+  bson_destroy(pipeline);
+  bson_destroy(opts);
+
+  // each bucket is {_id: {min: lower bound, max: upper bound}, count: n}
+  // where the upper bound is exclusive except for the last bucket
+  auto append_bound = [&bounds](const bson_t* doc, const char* key) {
+    bson_iter_t iter;
+    bson_iter_t child;
+    if (!bson_iter_init(&iter, doc) ||
+        !bson_iter_find_descendant(&iter, key, &child)) {
+      return false;
+    }
+    bson_value_t bound;
+    bson_value_copy(bson_iter_value(&child), &bound);
+    bounds.emplace_back(bound);
+    return true;
+  };
+  const bson_t* doc;
+  bool valid = true;
+  while (valid && mongoc_cursor_next(docs, &doc)) {
+    valid = (!bounds.empty() || append_bound(doc, "_id.min")) &&
+            append_bound(doc, "_id.max");
+  }
+  if (mongoc_cursor_error(docs, &error)) {
+    GALOIS_LOG_ERROR(
+        "An error occurred with a mongodb cursor: {}", error.message);
+    valid = false;
+  }
+  mongoc_cursor_destroy(docs);
+  mongoc_collection_destroy(collection);
+
+  // range queries only match _ids of the same type as their bounds
+  for (const bson_value_t& bound : bounds) {
+    valid = valid && bound.value_type == bounds.front().value_type;
+  }
+  if (!valid) {
+    for (bson_value_t& bound : bounds) {
+      bson_value_destroy(&bound);
+    }
+    bounds.clear();
+  }
+  return bounds;
+}
+
+BsonBatch
+QueryCollectionRange(
+    MongoClientPool* pool, const std::string& db_name,
+    const std::string& coll_name, const bson_value_t& lower,
+    const bson_value_t& upper, bool upper_inclusive) {
+  BsonBatch batch;
+  bson_error_t error;
+  mongoc_client_t* client = mongoc_client_pool_pop(pool->pool);
+  auto collection = mongoc_client_get_collection(
+      client, db_name.c_str(), coll_name.c_str());
+
+  bson_t filter;
+  bson_t range;
+  bson_init(&filter);
+  BSON_APPEND_DOCUMENT_BEGIN(&filter, "_id", &range);
+  BSON_APPEND_VALUE(&range, "$gte", &lower);
+  BSON_APPEND_VALUE(&range, upper_inclusive ? "$lte" : "$lt", &upper);
+  bson_append_document_end(&filter, &range);
+  bson_t* opts = BCON_NEW("sort", "{", "_id", BCON_INT32(1), "}");
+  auto cursor =
+      mongoc_collection_find_with_opts(collection, &filter, opts, nullptr);
+
+  const bson_t* doc;
+  while (mongoc_cursor_next(cursor, &doc)) {
+    batch.docs.emplace_back(bson_copy(doc));
+  }
+  if (mongoc_cursor_error(cursor, &error)) {
+    GALOIS_LOG_ERROR(
+        "An error occurred with a mongodb cursor: {}", error.message);
+  }
+
+  bson_destroy(opts);
+  bson_destroy(&filter);
+  mongoc_cursor_destroy(cursor);
+  mongoc_collection_destroy(collection);
+  mongoc_client_pool_push(pool->pool, client);
+  return batch;
+}
+
+/// QueryCollection calls document_op on each document of a collection like
+/// QueryEntireCollection. If pool is given the collection is instead read as
+/// ranges of _id over the clients of pool, in _id order.
+template <typename T>
+void
+QueryCollection(
+    mongoc_database_t* database, MongoClientPool* pool,
+    size_t num_connections, const std::string& db_name,
+    const bson_t** document, const std::string& coll_name, T document_op) {
+  std::vector<bson_value_t> bounds;
+  if (pool != nullptr) {
+    bounds = PartitionCollection(database, coll_name, num_connections);
+  }
+  if (bounds.size() < 2) {
+    QueryEntireCollection(database, document, coll_name, document_op);
+    for (bson_value_t& bound : bounds) {
+      bson_value_destroy(&bound);
+    }
+    return;
+  }
+
+  size_t num_ranges = bounds.size() - 1;
+  galois::FetchInOrder(
+      num_ranges, num_connections,
+      [&](size_t i) {
+        return QueryCollectionRange(
+            pool, db_name, coll_name, bounds[i], bounds[i + 1],
+            i + 1 == num_ranges);
+      },
+      [&](BsonBatch batch) {
+        for (const bson_t* doc : batch.docs) {
+          *document = doc;
+          document_op();
+        }
+      });
+
+  for (bson_value_t& bound : bounds) {
+    bson_value_destroy(&bound);
+  }
+}
+
 /***************************************/
 /* Functions for MongoDB preprocessing */
 /***************************************/
@@ -1112,7 +1318,8 @@ galois::GenerateMappingMongoDB(
 
 galois::GraphComponents
 galois::ConvertMongoDB(
-    const std::string& db_name, const std::string& mapping, size_t chunk_size) {
+    const std::string& db_name, const std::string& mapping, size_t chunk_size,
+    size_t num_connections) {
   const char* uri_string = "mongodb://localhost:27017";
   const bson_t* document = nullptr;
 
@@ -1121,6 +1328,11 @@ galois::ConvertMongoDB(
 
   mongoc_init();
   MongoClient client_wrapper{GetMongoClient(uri_string)};
+  std::unique_ptr<MongoClientPool> pool;
+  if (num_connections > 1) {
+    pool = std::make_unique<MongoClientPool>(
+        GetMongoClientPool(uri_string, num_connections));
+  }
   mongoc_database_t* database =
       mongoc_client_get_database(client_wrapper.client, db_name.c_str());
   std::vector<std::string> coll_names = GetCollectionNames(database);
@@ -1141,17 +1353,22 @@ galois::ConvertMongoDB(
 
   // add all edges first
   for (auto coll_name : edges) {
-    QueryEntireCollection(database, &document, coll_name, [&]() {
-      galois::HandleEdgeDocumentMongoDB(&builder, document, coll_name);
-    });
+    QueryCollection(
+        database, pool.get(), num_connections, db_name, &document, coll_name,
+        [&]() {
+          galois::HandleEdgeDocumentMongoDB(&builder, document, coll_name);
+        });
   }
   // then add all nodes
   for (auto coll_name : nodes) {
-    QueryEntireCollection(database, &document, coll_name, [&]() {
-      galois::HandleNodeDocumentMongoDB(&builder, document, coll_name);
-    });
+    QueryCollection(
+        database, pool.get(), num_connections, db_name, &document, coll_name,
+        [&]() {
+          galois::HandleNodeDocumentMongoDB(&builder, document, coll_name);
+        });
   }
 
+  pool.reset();
   mongoc_cleanup();
   return builder.Finish();
 }
@@ -15,9 +15,12 @@ void HandleEdgeDocumentMongoDB(
     PropertyGraphBuilder*, const bson_t* doc,
     const std::string& collection_name);
 
+/// ConvertMongoDB reads the collections of db_name into katana form. If
+/// num_connections is greater than 1, collections are read as ranges of _id
+/// over that many concurrent connections.
 GraphComponents ConvertMongoDB(
     const std::string& db_name, const std::string& mapping,
-    const size_t chunk_size);
+    const size_t chunk_size, size_t num_connections = 1);
 void GenerateMappingMongoDB(
     const std::string& db_name, const std::string& outfile);
 
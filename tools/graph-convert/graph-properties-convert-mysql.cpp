@@ -11,6 +11,8 @@
 #include <iostream>
 #include <limits>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <random>
 #include <sstream>
@@ -26,6 +28,7 @@
 #include "galois/Logging.h"
 #include "galois/SharedMemSys.h"
 #include "galois/Threads.h"
+#include "PipelinedFetch.h"
 #include "galois/graphs/PropertyFileGraph.h"
 #include "graph-properties-convert-schema.h"
 
@@ -41,9 +44,47 @@ struct MysqlRes {
   MYSQL_RES* res;
 
   MysqlRes(MYSQL_RES* res_) : res(res_) {}
+  MysqlRes(MysqlRes&& other) noexcept : res(other.res) { other.res = nullptr; }
+  MysqlRes(const MysqlRes& no_copy) = delete;
+  MysqlRes& operator=(const MysqlRes& no_copy) = delete;
   ~MysqlRes() { mysql_free_result(res); }
 };
 
+/// A fixed set of connections shared by the threads reading key ranges of a
+/// table
+class MysqlPool {
+  std::mutex mutex_;
+  std::vector<MYSQL*> idle_;
+  size_t size_;
+
+public:
+  MysqlPool(std::vector<MYSQL*> connections)
+      : idle_(std::move(connections)), size_(idle_.size()) {}
+  MysqlPool(const MysqlPool& no_copy) = delete;
+  MysqlPool& operator=(const MysqlPool& no_copy) = delete;
+  ~MysqlPool() {
+    for (MYSQL* con : idle_) {
+      mysql_close(con);
+    }
+  }
+
+  /// Callers must not hold more than size() connections at once
+  MYSQL* Acquire() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    GALOIS_LOG_ASSERT(!idle_.empty());
+    MYSQL* con = idle_.back();
+    idle_.pop_back();
+    return con;
+  }
+
+  void Release(MYSQL* con) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_.emplace_back(con);
+  }
+
+  size_t size() const { return size_; }
+};
+
 struct Relationship {
   std::string label;
   std::string source_table;
@@ -67,6 +108,9 @@ struct TableData {
   std::string name;
   bool is_node;
   int64_t primary_key_index;
+  std::string primary_key_name;
+  bool primary_key_is_integer;
+  size_t num_primary_keys;
   std::vector<Relationship> out_references;
   std::vector<Relationship> in_references;
   std::vector<std::string> field_names;
@@ -77,6 +121,8 @@ struct TableData {
       : name(std::move(name_)),
         is_node(true),
         primary_key_index(-1),
+        primary_key_is_integer(false),
+        num_primary_keys(0),
         out_references(std::vector<Relationship>{}),
         in_references(std::vector<Relationship>{}),
         field_names(std::vector<std::string>{}),
@@ -91,6 +137,11 @@ struct TableData {
     }
   }
 
+  /// Tables with a single integer primary key can be read as key ranges
+  bool CanPartition() const {
+    return num_primary_keys == 1 && primary_key_is_integer;
+  }
+
   bool IsValidEdge() {
     if (this->out_references.size() != 2) {
       return false;
@@ -220,6 +271,24 @@ GenerateFetchTableQuery(const std::string& table) {
   return std::string{"SELECT * FROM " + table + ";"};
 }
 
+std::string
+GenerateFetchKeyBoundsQuery(const TableData& table_data) {
+  const std::string& key = table_data.primary_key_name;
+  return std::string{
+      "SELECT MIN(" + key + "), MAX(" + key + ") FROM " + table_data.name +
+      ";"};
+}
+
+std::string
+GenerateFetchKeyRangeQuery(
+    const TableData& table_data, const std::pair<int64_t, int64_t>& range) {
+  const std::string& key = table_data.primary_key_name;
+  return std::string{
+      "SELECT * FROM " + table_data.name + " WHERE " + key +
+      " >= " + std::to_string(range.first) + " AND " + key +
+      " <= " + std::to_string(range.second) + " ORDER BY " + key + ";"};
+}
+
 std::vector<std::string>
 FetchTableNames(MYSQL* con) {
   std::vector<std::string> table_names;
@@ -256,15 +325,109 @@ RunQuery(MYSQL* con, const std::string& query) {
   return MysqlRes(mysql_use_result(con));
 }
 
+/// RunQuery but with the whole result set read into client memory so that
+/// con can be reused while the rows are processed
+MysqlRes
+RunStoredQuery(MYSQL* con, const std::string& query) {
+  if (mysql_real_query(con, query.c_str(), query.size())) {
+    GALOIS_LOG_FATAL("Could not run query {}: {}", query, mysql_error(con));
+  }
+  MYSQL_RES* res = mysql_store_result(con);
+  if (res == nullptr) {
+    GALOIS_LOG_FATAL("Could not read rows of {}: {}", query, mysql_error(con));
+  }
+  return MysqlRes(res);
+}
+
+MYSQL*
+Connect(
+    const std::string& db_name, const std::string& host,
+    const std::string& user, const std::string& password) {
+  MYSQL* con = mysql_init(NULL);
+  if (con == nullptr) {
+    GALOIS_LOG_FATAL("mysql_init() failed");
+  }
+  if (mysql_real_connect(
+          con, host.c_str(), user.c_str(), password.c_str(), db_name.c_str(), 0,
+          NULL, 0) == NULL) {
+    GALOIS_LOG_FATAL(
+        "Could not establish mysql connection: {}", mysql_error(con));
+  }
+  return con;
+}
+
+/// Number of primary key values read per query when reading a table over
+/// several connections
+constexpr uint64_t kKeysPerBatch = 100000;
+
+std::vector<std::pair<int64_t, int64_t>>
+PartitionTable(MYSQL* con, const TableData& table_data) {
+  std::vector<std::pair<int64_t, int64_t>> ranges;
+
+  MysqlRes bounds =
+      RunStoredQuery(con, GenerateFetchKeyBoundsQuery(table_data));
+  MYSQL_ROW row = mysql_fetch_row(bounds.res);
+  // MIN and MAX are NULL for empty tables
+  if (row == NULL || row[0] == NULL || row[1] == NULL) {
+    return ranges;
+  }
+  int64_t min = boost::lexical_cast<int64_t>(row[0]);
+  int64_t max = boost::lexical_cast<int64_t>(row[1]);
+
+  for (int64_t lo = min;;) {
+    // compare as unsigned to avoid overflow at the ends of the key space
+    uint64_t remaining = static_cast<uint64_t>(max) - static_cast<uint64_t>(lo);
+    if (remaining < kKeysPerBatch) {
+      ranges.emplace_back(lo, max);
+      break;
+    }
+    int64_t hi = static_cast<int64_t>(
+        static_cast<uint64_t>(lo) + kKeysPerBatch - 1);
+    ranges.emplace_back(lo, hi);
+    lo = hi + 1;
+  }
+  return ranges;
+}
+
+/// ForEachTableBatch passes the rows of a table to add_rows, either as a
+/// single result streamed over con or, if pool is given and the table has a
+/// single integer primary key, as a sequence of key ranges read concurrently
+/// over the connections of pool
+template <typename AddRowsFn>
 void
-AddNodeTable(
-    galois::PropertyGraphBuilder* builder, MYSQL* con,
+ForEachTableBatch(
+    MYSQL* con, MysqlPool* pool, const TableData& table_data,
+    AddRowsFn add_rows) {
+  if (pool == nullptr || !table_data.CanPartition()) {
+    MysqlRes table = RunQuery(con, GenerateFetchTableQuery(table_data.name));
+    add_rows(&table);
+    return;
+  }
+
+  std::vector<std::pair<int64_t, int64_t>> ranges =
+      PartitionTable(con, table_data);
+  galois::FetchInOrder(
+      ranges.size(), pool->size(),
+      [pool, &table_data, &ranges](size_t i) {
+        mysql_thread_init();
+        MYSQL* range_con = pool->Acquire();
+        MysqlRes rows = RunStoredQuery(
+            range_con, GenerateFetchKeyRangeQuery(table_data, ranges[i]));
+        pool->Release(range_con);
+        mysql_thread_end();
+        return rows;
+      },
+      [&add_rows](MysqlRes rows) { add_rows(&rows); });
+}
+
+void
+AddNodeRows(
+    galois::PropertyGraphBuilder* builder, MysqlRes* table,
     const TableData& table_data) {
-  MysqlRes table = RunQuery(con, GenerateFetchTableQuery(table_data.name));
   MYSQL_ROW row;
 
-  while ((row = mysql_fetch_row(table.res))) {
-    auto lengths = mysql_fetch_lengths(table.res);
+  while ((row = mysql_fetch_row(table->res))) {
+    auto lengths = mysql_fetch_lengths(table->res);
 
     builder->StartNode();
     builder->AddLabel(table_data.name);
@@ -310,14 +473,13 @@ AddNodeTable(
 }
 
 void
-AddEdgeTable(
-    galois::PropertyGraphBuilder* builder, MYSQL* con,
+AddEdgeRows(
+    galois::PropertyGraphBuilder* builder, MysqlRes* table,
     const TableData& table_data) {
-  MysqlRes table = RunQuery(con, GenerateFetchTableQuery(table_data.name));
   MYSQL_ROW row;
 
-  while ((row = mysql_fetch_row(table.res))) {
-    auto lengths = mysql_fetch_lengths(table.res);
+  while ((row = mysql_fetch_row(table->res))) {
+    auto lengths = mysql_fetch_lengths(table->res);
 
     builder->StartEdge();
     builder->AddLabel(table_data.name);
@@ -358,6 +520,24 @@ AddEdgeTable(
   }
 }
 
+void
+AddNodeTable(
+    galois::PropertyGraphBuilder* builder, MYSQL* con, MysqlPool* pool,
+    const TableData& table_data) {
+  ForEachTableBatch(con, pool, table_data, [&](MysqlRes* rows) {
+    AddNodeRows(builder, rows, table_data);
+  });
+}
+
+void
+AddEdgeTable(
+    galois::PropertyGraphBuilder* builder, MYSQL* con, MysqlPool* pool,
+    const TableData& table_data) {
+  ForEachTableBatch(con, pool, table_data, [&](MysqlRes* rows) {
+    AddEdgeRows(builder, rows, table_data);
+  });
+}
+
 /************************************/
 /* Functions for getting user input */
 /************************************/
@@ -529,6 +709,20 @@ ContainsKey(
   return false;
 }
 
+bool
+IsIntegerField(enum_field_types type) {
+  switch (type) {
+  case MYSQL_TYPE_TINY:
+  case MYSQL_TYPE_SHORT:
+  case MYSQL_TYPE_INT24:
+  case MYSQL_TYPE_LONG:
+  case MYSQL_TYPE_LONGLONG:
+    return true;
+  default:
+    return false;
+  }
+}
+
 PropertyKey
 ProcessField(MYSQL_FIELD* field) {
   std::string id{field->name, field->name_length};
@@ -642,6 +836,9 @@ PreprocessFields(
     // if this field is a primary key, do not add it for now
     if (IS_PRI_KEY(field->flags)) {
       table_iter->second.primary_key_index = static_cast<int64_t>(index);
+      table_iter->second.primary_key_name = key.id;
+      table_iter->second.primary_key_is_integer = IsIntegerField(field->type);
+      table_iter->second.num_primary_keys++;
     } else if (
         table_iter->second.ignore_list.find(key.id) ==
         table_iter->second.ignore_list.end()) {
@@ -675,6 +872,9 @@ PreprocessFields(
     // if this field is a primary key, do not add it for now
     if (IS_PRI_KEY(field->flags)) {
       table_iter->second.primary_key_index = static_cast<int64_t>(index);
+      table_iter->second.primary_key_name = key.id;
+      table_iter->second.primary_key_is_integer = IsIntegerField(field->type);
+      table_iter->second.num_primary_keys++;
     } else if (
         table_iter->second.ignore_list.find(key.id) !=
         table_iter->second.ignore_list.end()) {
@@ -859,20 +1059,21 @@ GetMappingInput(
 GraphComponents
 galois::ConvertMysql(
     const std::string& db_name, const std::string& mapping,
-    const size_t chunk_size, const std::string& host, const std::string& user) {
+    const size_t chunk_size, const std::string& host, const std::string& user,
+    size_t num_connections) {
   galois::PropertyGraphBuilder builder{chunk_size};
   std::string password{getpass("MySQL Password: ")};
 
-  MYSQL* con = mysql_init(NULL);
-  if (con == nullptr) {
-    GALOIS_LOG_FATAL("mysql_init() failed");
-  }
-  if (mysql_real_connect(
-          con, host.c_str(), user.c_str(), password.c_str(), db_name.c_str(), 0,
-          NULL, 0) == NULL) {
-    GALOIS_LOG_FATAL(
-        "Could not establish mysql connection: {}", mysql_error(con));
+  MYSQL* con = Connect(db_name, host, user, password);
+  std::unique_ptr<MysqlPool> pool;
+  if (num_connections > 1) {
+    std::vector<MYSQL*> connections;
+    for (size_t i = 0; i < num_connections; ++i) {
+      connections.emplace_back(Connect(db_name, host, user, password));
+    }
+    pool = std::make_unique<MysqlPool>(std::move(connections));
   }
+
   std::vector<std::string> table_names = FetchTableNames(con);
   std::unordered_map<std::string, TableData> table_data;
   if (!mapping.empty()) {
@@ -886,11 +1087,12 @@ galois::ConvertMysql(
 
   for (auto table : table_data) {
     if (table.second.is_node) {
-      AddNodeTable(&builder, con, table.second);
+      AddNodeTable(&builder, con, pool.get(), table.second);
     } else {
-      AddEdgeTable(&builder, con, table.second);
+      AddEdgeTable(&builder, con, pool.get(), table.second);
     }
   }
+  pool.reset();
   mysql_close(con);
   auto out = builder.Finish();
   out.Dump();
@@ -903,16 +1105,7 @@ galois::GenerateMappingMysql(
     const std::string& host, const std::string& user) {
   std::string password{getpass("MySQL Password: ")};
 
-  MYSQL* con = mysql_init(NULL);
-  if (con == nullptr) {
-    GALOIS_LOG_FATAL("mysql_init() failed");
-  }
-  if (mysql_real_connect(
-          con, host.c_str(), user.c_str(), password.c_str(), db_name.c_str(), 0,
-          NULL, 0) == NULL) {
-    GALOIS_LOG_FATAL(
-        "Could not establish mysql connection: {}", mysql_error(con));
-  }
+  MYSQL* con = Connect(db_name, host, user, password);
   std::vector<std::string> table_names = FetchTableNames(con);
 
   // get user input on node/edge mappings, label names, property names and
@@ -5,9 +5,13 @@
 
 namespace galois {
 
+/// ConvertMysql reads the tables of db_name into katana form. If
+/// num_connections is greater than 1, tables with a single integer primary key
+/// are read as key ranges over that many concurrent connections.
 GraphComponents ConvertMysql(
     const std::string& db_name, const std::string& mapping,
-    const size_t chunk_size, const std::string& host, const std::string& user);
+    const size_t chunk_size, const std::string& host, const std::string& user,
+    size_t num_connections = 1);
 void GenerateMappingMysql(
     const std::string& db_name, const std::string& outfile,
     const std::string& host, const std::string& user);
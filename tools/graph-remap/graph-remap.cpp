@@ -18,8 +18,10 @@
  */
 
 #include "galois/Galois.h"
+#include "galois/Logging.h"
 #include "galois/graphs/BufferedGraph.h"
 #include "galois/graphs/FileGraph.h"
+#include "galois/graphs/PropertyFileGraph.h"
 #include "llvm/Support/CommandLine.h"
 
 namespace cll = llvm::cl;
@@ -29,16 +31,21 @@ static cll::opt<std::string> inputFilename(
 static cll::opt<std::string> mappingFilename(
     cll::Positional, cll::desc("<mapping file>"), cll::Required);
 static cll::opt<std::string> outputFilename(
-    cll::Positional, cll::desc("<output file>"), cll::Required);
+    cll::Positional, cll::desc("<output file>"), cll::Optional);
+static cll::opt<bool> rdgInput(
+    "rdg",
+    cll::desc("Input is an RDG: remap its topology and every node and edge "
+              "property, writing the output RDG or, if there is no output, "
+              "a new version of the input"),
+    cll::init(false));
 
 using Writer = galois::graphs::FileGraphWriter;
 
 /**
- * Create node map from file
+ * Read the mapping file: the node listed on line n becomes node n
  */
-std::map<uint32_t, uint32_t>
-createNodeMap() {
-  galois::gInfo("Creating node map");
+std::vector<uint32_t>
+readNewToOld() {
   // read new mapping
   std::ifstream mapFile(mappingFilename);
   mapFile.seekg(0, std::ios_base::end);
@@ -53,15 +60,30 @@ createNodeMap() {
     GALOIS_DIE("failed to read file");
   }
 
-  // remap node listed on line n in the mapping to node n
-  std::map<uint32_t, uint32_t> remapper;
-  uint64_t counter = 0;
+  std::vector<uint32_t> newToOld;
   while (((int64_t)mapFile.tellg() + 1) != endOfFile) {
     uint64_t nodeID;
     mapFile >> nodeID;
     if (!mapFile) {
       GALOIS_DIE("failed to read file");
     }
+    newToOld.emplace_back(nodeID);
+  }
+  return newToOld;
+}
+
+/**
+ * Create node map from file
+ */
+std::map<uint32_t, uint32_t>
+createNodeMap() {
+  galois::gInfo("Creating node map");
+  std::vector<uint32_t> newToOld = readNewToOld();
+
+  // remap node listed on line n in the mapping to node n
+  std::map<uint32_t, uint32_t> remapper;
+  uint64_t counter = 0;
+  for (uint32_t nodeID : newToOld) {
     remapper[nodeID] = counter++;
   }
 
@@ -73,11 +95,64 @@ createNodeMap() {
   return remapper;
 }
 
+/**
+ * Remap an RDG with PermuteNodes, which applies the permutation to the
+ * topology and every property in parallel. Unlike a gr file, every node must
+ * be in the mapping.
+ */
+void
+remapRDG(const std::string& commandLine) {
+  std::vector<uint32_t> newToOld = readNewToOld();
+  galois::gInfo("Remapping ", newToOld.size(), " nodes");
+
+  galois::gInfo("Loading graph to remap");
+  auto pfgResult = galois::graphs::PropertyFileGraph::Make(inputFilename);
+  if (!pfgResult) {
+    GALOIS_LOG_FATAL("cannot load {}: {}", inputFilename, pfgResult.error());
+  }
+  std::unique_ptr<galois::graphs::PropertyFileGraph> pfg =
+      std::move(pfgResult.value());
+  galois::gInfo("Graph loaded");
+
+  if (auto res = galois::graphs::PermuteNodes(pfg.get(), newToOld); !res) {
+    GALOIS_LOG_FATAL("cannot remap {}: {}", inputFilename, res.error());
+  }
+
+  if (outputFilename.empty()) {
+    galois::gInfo("Committing a new version of ", inputFilename);
+    if (auto res = pfg->Commit(commandLine); !res) {
+      GALOIS_LOG_FATAL("cannot commit {}: {}", inputFilename, res.error());
+    }
+  } else {
+    galois::gInfo("Writing ", outputFilename);
+    if (auto res = pfg->Write(outputFilename, commandLine); !res) {
+      GALOIS_LOG_FATAL("cannot write {}: {}", outputFilename, res.error());
+    }
+  }
+
+  galois::gInfo(
+      "new size is ", pfg->topology().num_nodes(), " num edges ",
+      pfg->topology().num_edges());
+}
+
 int
 main(int argc, char** argv) {
   galois::SharedMemSys G;
   llvm::cl::ParseCommandLineOptions(argc, argv);
 
+  if (rdgInput) {
+    std::string commandLine;
+    for (int i = 0; i < argc; ++i) {
+      commandLine += i ? " " : "";
+      commandLine += argv[i];
+    }
+    remapRDG(commandLine);
+    return 0;
+  }
+  if (outputFilename.empty()) {
+    GALOIS_DIE("an output file is required for a gr file");
+  }
+
   std::map<uint32_t, uint32_t> remapper = createNodeMap();
 
   galois::gInfo("Loading graph to remap");
@@ -17,14 +17,28 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <cstdlib>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
 #include <vector>
 
 #include "galois/Galois.h"
-#include "galois/graphs/LCGraph.h"
-#include "galois/graphs/OfflineGraph.h"
+#include "galois/Logging.h"
+#include "galois/Reduction.h"
+#include "galois/VectorReduction.h"
+#include "galois/graphs/FileGraph.h"
+#include "galois/graphs/PropertyFileGraph.h"
 #include "llvm/Support/CommandLine.h"
+#include "tsuba/RDGPrefix.h"
+#include "tsuba/tsuba.h"
 
 namespace cll = llvm::cl;
 
@@ -36,7 +50,10 @@ enum StatMode {
   indegreehist,
   sortedlogoffsethist,
   sparsityPattern,
-  summary
+  summary,
+  degreepercentiles,
+  indegreepercentiles,
+  distinctdsts
 };
 
 static cll::opt<std::string> inputfilename(
@@ -56,55 +73,155 @@ static cll::list<StatMode> statModeList(
             sparsityPattern,
             "Pattern of non-zeros when graph is "
             "interpreted as a sparse matrix"),
-        clEnumVal(summary, "Graph summary")));
+        clEnumVal(summary, "Graph summary"),
+        clEnumVal(degreepercentiles, "Percentiles of degrees"),
+        clEnumVal(indegreepercentiles, "Percentiles of indegrees"),
+        clEnumVal(
+            distinctdsts,
+            "Approximate number of distinct destinations")));
 static cll::opt<int> numBins(
     "numBins", cll::desc("Number of bins"), cll::init(-1));
 static cll::opt<int> columns(
     "columns", cll::desc("Columns for sparsity"), cll::init(80));
+static cll::opt<bool> rdgInput(
+    "rdg",
+    cll::desc("Input is an RDG rather than a gr file; stats of out-degrees "
+              "read only its out indices"),
+    cll::init(false));
+static cll::opt<int> numThreads(
+    "t", cll::desc("Number of threads to use (default all)"), cll::init(0));
 
-typedef galois::graphs::OfflineGraph Graph;
-typedef Graph::GraphNode GNode;
+/**
+ * A graph in the gr format. The file is mapped, so stats of out-degrees only
+ * touch its out indices.
+ */
+class GrGraph {
+  galois::graphs::FileGraph graph;
 
-void
-doSummary(Graph& graph) {
-  std::cout << "NumNodes: " << graph.size() << "\n";
-  std::cout << "NumEdges: " << graph.sizeEdges() << "\n";
-  std::cout << "SizeofEdge: " << graph.edgeSize() << "\n";
-}
+public:
+  explicit GrGraph(const std::string& filename) { graph.fromFile(filename); }
 
-void
-doDegrees(Graph& graph) {
-  for (auto n : graph) {
-    std::cout << std::distance(graph.edge_begin(n), graph.edge_end(n)) << "\n";
+  uint64_t size() { return graph.size(); }
+  uint64_t sizeEdges() { return graph.sizeEdges(); }
+
+  void printSummary() {
+    std::cout << "NumNodes: " << graph.size() << "\n";
+    std::cout << "NumEdges: " << graph.sizeEdges() << "\n";
+    std::cout << "SizeofEdge: " << graph.edgeSize() << "\n";
   }
-}
 
-void
-findMaxDegreeNode(Graph& graph) {
-  uint64_t nodeId = 0;
-  size_t MaxDegree = 0;
-  uint64_t MaxDegreeNode = 0;
-  for (auto n : graph) {
-    size_t degree = std::distance(graph.edge_begin(n), graph.edge_end(n));
-    if (MaxDegree < degree) {
-      MaxDegree = degree;
-      MaxDegreeNode = nodeId;
+  uint64_t degree(uint64_t n) {
+    return std::distance(graph.edge_begin(n), graph.edge_end(n));
+  }
+
+  void loadDests() {}
+
+  template <typename Fn>
+  void forEachDst(uint64_t n, const Fn& fn) {
+    for (auto jj : graph.edges(n)) {
+      fn(graph.getEdgeDst(jj));
+    }
+  }
+};
+
+/**
+ * A graph stored as an RDG. Stats of out-degrees read only the prefix of its
+ * topology, the out indices, so they do not fetch the edge destinations.
+ * Those are loaded by loadDests for the stats that need them.
+ */
+class RdgGraph {
+  std::string name;
+  std::optional<tsuba::RDGFile> file;
+  std::optional<tsuba::RDGPrefix> prefix;
+  std::unique_ptr<galois::graphs::PropertyFileGraph> pfg;
+  uint64_t numNodes = 0;
+  uint64_t numEdges = 0;
+  const uint64_t* outIndexes = nullptr;
+  const uint32_t* dests = nullptr;
+
+public:
+  explicit RdgGraph(const std::string& rdgName) : name(rdgName) {
+    auto handle_res = tsuba::Open(name, tsuba::kReadOnly);
+    if (!handle_res) {
+      GALOIS_LOG_FATAL("cannot open {}: {}", name, handle_res.error());
+    }
+    file.emplace(handle_res.value());
+    auto prefix_res = tsuba::RDGPrefix::Make(*file);
+    // Only uncompressed version 1 topologies start with the out indices
+    if (prefix_res && prefix_res.value().Valid() &&
+        prefix_res.value().version() == 1) {
+      prefix.emplace(std::move(prefix_res.value()));
+      numNodes = prefix->num_nodes();
+      numEdges = prefix->num_edges();
+      outIndexes = prefix->out_indexes();
+    } else {
+      loadDests();
     }
-    ++nodeId;
   }
-  std::cout << "MaxDegreeNode : " << MaxDegreeNode
-            << " , MaxDegree : " << MaxDegree << "\n";
+
+  uint64_t size() { return numNodes; }
+  uint64_t sizeEdges() { return numEdges; }
+
+  void printSummary() {
+    std::cout << "NumNodes: " << numNodes << "\n";
+    std::cout << "NumEdges: " << numEdges << "\n";
+  }
+
+  uint64_t degree(uint64_t n) {
+    return outIndexes[n] - (n == 0 ? 0 : outIndexes[n - 1]);
+  }
+
+  void loadDests() {
+    if (pfg) {
+      return;
+    }
+    auto pfg_res = galois::graphs::PropertyFileGraph::Make(name, {}, {});
+    if (!pfg_res) {
+      GALOIS_LOG_FATAL("cannot load {}: {}", name, pfg_res.error());
+    }
+    pfg = std::move(pfg_res.value());
+    const galois::graphs::GraphTopology& topology = pfg->topology();
+    numNodes = topology.num_nodes();
+    numEdges = topology.num_edges();
+    outIndexes = topology.out_indices->raw_values();
+    dests = topology.out_dests->raw_values();
+  }
+
+  template <typename Fn>
+  void forEachDst(uint64_t n, const Fn& fn) {
+    for (uint64_t e = n == 0 ? 0 : outIndexes[n - 1]; e < outIndexes[n]; ++e) {
+      fn(dests[e]);
+    }
+  }
+};
+
+//! Whether stat was requested
+static bool
+wants(StatMode stat) {
+  return std::find(statModeList.begin(), statModeList.end(), stat) !=
+         statModeList.end();
 }
 
+/**
+ * Prints a histogram of counts by value, which are in order of value and
+ * which have values up to max
+ */
 void
-printHistogram(const std::string& name, std::map<uint64_t, uint64_t>& hists) {
+printHistogram(
+    const std::string& name, const std::map<uint64_t, uint64_t>& hists) {
+  if (hists.empty()) {
+    std::cout << name << "Bin,Start,End,Count\n";
+    return;
+  }
   auto max = hists.rbegin()->first;
   if (numBins <= 0) {
     std::cout << name << "Bin,Start,End,Count\n";
-    for (unsigned x = 0; x <= max; ++x) {
+    auto ii = hists.begin();
+    for (uint64_t x = 0; x <= max; ++x) {
       std::cout << x << ',' << x << ',' << x + 1 << ',';
-      if (hists.count(x)) {
-        std::cout << hists[x] << '\n';
+      if (ii->first == x) {
+        std::cout << ii->second << '\n';
+        ++ii;
       } else {
         std::cout << "0\n";
       }
@@ -115,8 +232,7 @@ printHistogram(const std::string& name, std::map<uint64_t, uint64_t>& hists) {
     if ((max + 1) % numBins) {
       ++bwidth;
     }
-    // std::cerr << "* " << max << " " << numBins << " " << bwidth << "\n";
-    for (auto p : hists) {
+    for (const auto& p : hists) {
       bins.at(p.first / bwidth) += p.second;
     }
     std::cout << name << "Bin,Start,End,Count\n";
@@ -127,55 +243,145 @@ printHistogram(const std::string& name, std::map<uint64_t, uint64_t>& hists) {
   }
 }
 
+/**
+ * Prints percentiles of a distribution given as the number of items with
+ * each value
+ */
 void
-doSparsityPattern(
-    Graph& graph, std::function<void(unsigned, unsigned, bool)> printFn) {
-  unsigned blockSize = (graph.size() + columns - 1) / columns;
-
-  for (int i = 0; i < columns; ++i) {
-    std::vector<bool> row(columns);
-    auto p = galois::block_range(graph.begin(), graph.end(), i, columns);
-    for (auto ii = p.first, ei = p.second; ii != ei; ++ii) {
-      for (auto jj : graph.edges(*ii)) {
-        row[graph.getEdgeDst(jj) / blockSize] = true;
-      }
-    }
-    for (int x = 0; x < columns; ++x) {
-      printFn(x, i, row[x]);
+printPercentiles(
+    const std::string& name, const std::map<uint64_t, uint64_t>& hists) {
+  uint64_t total = 0;
+  for (const auto& p : hists) {
+    total += p.second;
+  }
+  std::cout << name << "Percentile,Value\n";
+  if (total == 0) {
+    return;
+  }
+  const double percentiles[] = {0, 25, 50, 75, 90, 99, 99.9, 100};
+  auto ii = hists.begin();
+  uint64_t seen = ii->second;
+  for (double p : percentiles) {
+    // the value of the item at rank ceil(p% of total), counting from 1
+    uint64_t rank =
+        std::max<uint64_t>(std::ceil(p / 100 * total), uint64_t{1});
+    while (seen < rank) {
+      ++ii;
+      seen += ii->second;
     }
+    std::cout << p << ',' << ii->first << '\n';
   }
 }
 
-void
-doDegreeHistogram(Graph& graph) {
+//! The reduced results of the pass over out-degrees
+struct DegreeStats {
   std::map<uint64_t, uint64_t> hist;
-  for (auto ii : graph) {
-    ++hist[std::distance(graph.edge_begin(ii), graph.edge_end(ii))];
+  //! (degree, node) of the node of greatest degree
+  std::pair<uint64_t, uint64_t> max{0, 0};
+};
+
+//! The reduced results of the pass over edge destinations
+struct DstStats {
+  //! indegree of every node, which is also the histogram of destinations
+  std::vector<uint64_t> indegrees;
+  std::map<uint64_t, uint64_t> indegreeHist;
+  double distinct = 0;
+};
+
+/**
+ * Computes every out-degree stat in one parallel pass over the nodes; this
+ * needs only the out indices
+ */
+template <typename Graph>
+DegreeStats
+computeDegreeStats(Graph& graph) {
+  galois::GSparseHistogram<> hist;
+  // prefers the least node among those of greatest degree
+  auto lessDegree = [](const std::pair<uint64_t, uint64_t>& a,
+                       const std::pair<uint64_t, uint64_t>& b) {
+    return a.first < b.first || (a.first == b.first && a.second > b.second);
+  };
+  galois::GTopK<std::pair<uint64_t, uint64_t>, decltype(lessDegree)> top(
+      1, lessDegree);
+  galois::do_all(
+      galois::iterate(uint64_t{0}, graph.size()),
+      [&](uint64_t n) {
+        uint64_t degree = graph.degree(n);
+        hist.update(degree);
+        top.update(std::make_pair(degree, n));
+      },
+      galois::no_stats(), galois::loopname("DegreeStats"));
+
+  DegreeStats stats;
+  stats.hist = hist.reduce();
+  std::vector<std::pair<uint64_t, uint64_t>> max = top.reduce();
+  if (!max.empty()) {
+    stats.max = max[0];
   }
-  printHistogram("Degree", hist);
+  return stats;
+}
+
+/**
+ * Computes every stat of destinations in one parallel pass over the edges
+ */
+template <typename Graph>
+DstStats
+computeDstStats(Graph& graph) {
+  graph.loadDests();
+  uint64_t numNodes = graph.size();
+  std::vector<std::atomic<uint64_t>> indegrees(numNodes);
+  galois::GApproxDistinct distinct;
+  galois::do_all(
+      galois::iterate(uint64_t{0}, numNodes),
+      [&](uint64_t n) {
+        graph.forEachDst(n, [&](uint64_t dst) {
+          indegrees[dst].fetch_add(1, std::memory_order_relaxed);
+          distinct.update(dst);
+        });
+      },
+      galois::steal(), galois::no_stats(), galois::loopname("DstStats"));
+
+  DstStats stats;
+  stats.indegrees.resize(numNodes);
+  galois::GSparseHistogram<> hist;
+  galois::do_all(
+      galois::iterate(uint64_t{0}, numNodes),
+      [&](uint64_t n) {
+        stats.indegrees[n] = indegrees[n].load(std::memory_order_relaxed);
+        hist.update(stats.indegrees[n]);
+      },
+      galois::no_stats(), galois::loopname("IndegreeHistogram"));
+  stats.indegreeHist = hist.reduce();
+  stats.distinct = distinct.reduce();
+  return stats;
 }
 
+template <typename Graph>
 void
-doInDegreeHistogram(Graph& graph) {
-  std::vector<uint64_t> inv(graph.size());
-  std::map<uint64_t, uint64_t> hist;
-  for (auto ii : graph) {
-    for (auto jj : graph.edges(ii)) {
-      ++inv[graph.getEdgeDst(jj)];
+doSparsityPattern(
+    Graph& graph, std::function<void(unsigned, unsigned, bool)> printFn) {
+  graph.loadDests();
+  uint64_t blockSize = (graph.size() + columns - 1) / columns;
+
+  std::vector<std::vector<uint8_t>> rows(columns);
+  galois::do_all(
+      galois::iterate(0, static_cast<int>(columns)),
+      [&](int i) {
+        std::vector<uint8_t>& row = rows[i];
+        row.resize(columns);
+        auto p = galois::block_range(uint64_t{0}, graph.size(), i, columns);
+        for (uint64_t n = p.first; n < p.second; ++n) {
+          graph.forEachDst(n, [&](uint64_t dst) { row[dst / blockSize] = 1; });
+        }
+      },
+      galois::steal(), galois::no_stats(), galois::loopname("Sparsity"));
+  for (int i = 0; i < columns; ++i) {
+    for (int x = 0; x < columns; ++x) {
+      printFn(x, i, rows[i][x]);
     }
   }
-  for (uint64_t n : inv) {
-    ++hist[n];
-  }
-  printHistogram("InDegree", hist);
 }
 
-struct EdgeComp {
-  typedef galois::graphs::EdgeSortValue<GNode, void> Edge;
-
-  bool operator()(const Edge& a, const Edge& b) const { return a.dst < b.dst; }
-};
-
 int
 getLogIndex(ptrdiff_t x) {
   int logvalue = 0;
@@ -192,7 +398,7 @@ getLogIndex(ptrdiff_t x) {
 }
 
 void
-doSortedLogOffsetHistogram([[maybe_unused]] Graph& graph) {
+doSortedLogOffsetHistogram() {
   // Graph copy;
   // {
   //   // Original FileGraph is immutable because it is backed by a file
@@ -240,61 +446,94 @@ doSortedLogOffsetHistogram([[maybe_unused]] Graph& graph) {
   // printHistogram("LogOffset", hists);
 }
 
+template <typename Graph>
 void
-doDestinationHistogram(Graph& graph) {
-  std::map<uint64_t, uint64_t> hist;
-  for (auto ii : graph) {
-    for (auto jj : graph.edges(ii)) {
-      ++hist[graph.getEdgeDst(jj)];
+doStats(Graph& graph) {
+  std::optional<DegreeStats> degreeStats;
+  std::optional<DstStats> dstStats;
+  if (wants(degreehist) || wants(maxDegreeNode) || wants(degreepercentiles)) {
+    degreeStats = computeDegreeStats(graph);
+  }
+  if (wants(dsthist) || wants(indegreehist) || wants(indegreepercentiles) ||
+      wants(distinctdsts)) {
+    dstStats = computeDstStats(graph);
+  }
+
+  for (unsigned i = 0; i != statModeList.size(); ++i) {
+    switch (statModeList[i]) {
+    case degreehist:
+      printHistogram("Degree", degreeStats->hist);
+      break;
+    case degrees:
+      for (uint64_t n = 0; n < graph.size(); ++n) {
+        std::cout << graph.degree(n) << "\n";
+      }
+      break;
+    case maxDegreeNode:
+      std::cout << "MaxDegreeNode : " << degreeStats->max.second
+                << " , MaxDegree : " << degreeStats->max.first << "\n";
+      break;
+    case dsthist: {
+      std::map<uint64_t, uint64_t> hist;
+      for (uint64_t n = 0; n < dstStats->indegrees.size(); ++n) {
+        if (dstStats->indegrees[n] > 0) {
+          hist.emplace_hint(hist.end(), n, dstStats->indegrees[n]);
+        }
+      }
+      printHistogram("DestinationBin", hist);
+      break;
+    }
+    case indegreehist:
+      printHistogram("InDegree", dstStats->indegreeHist);
+      break;
+    case sortedlogoffsethist:
+      doSortedLogOffsetHistogram();
+      break;
+    case sparsityPattern: {
+      unsigned lastrow = ~0;
+      doSparsityPattern(graph, [&lastrow](unsigned, unsigned y, bool val) {
+        if (y != lastrow) {
+          lastrow = y;
+          std::cout << '\n';
+        }
+        std::cout << (val ? 'x' : '.');
+      });
+      std::cout << '\n';
+      break;
+    }
+    case summary:
+      graph.printSummary();
+      break;
+    case degreepercentiles:
+      printPercentiles("Degree", degreeStats->hist);
+      break;
+    case indegreepercentiles:
+      printPercentiles("InDegree", dstStats->indegreeHist);
+      break;
+    case distinctdsts:
+      std::cout << "DistinctDestinations: "
+                << static_cast<uint64_t>(dstStats->distinct + 0.5) << "\n";
+      break;
+    default:
+      std::cerr << "Unknown stat requested\n";
+      break;
     }
   }
-  printHistogram("DestinationBin", hist);
 }
 
 int
 main(int argc, char** argv) {
+  galois::SharedMemSys G;
   llvm::cl::ParseCommandLineOptions(argc, argv);
+  galois::setActiveThreads(
+      numThreads > 0 ? numThreads : std::numeric_limits<unsigned>::max());
   try {
-    Graph graph(inputfilename);
-    for (unsigned i = 0; i != statModeList.size(); ++i) {
-      switch (statModeList[i]) {
-      case degreehist:
-        doDegreeHistogram(graph);
-        break;
-      case degrees:
-        doDegrees(graph);
-        break;
-      case maxDegreeNode:
-        findMaxDegreeNode(graph);
-        break;
-      case dsthist:
-        doDestinationHistogram(graph);
-        break;
-      case indegreehist:
-        doInDegreeHistogram(graph);
-        break;
-      case sortedlogoffsethist:
-        doSortedLogOffsetHistogram(graph);
-        break;
-      case sparsityPattern: {
-        unsigned lastrow = ~0;
-        doSparsityPattern(graph, [&lastrow](unsigned, unsigned y, bool val) {
-          if (y != lastrow) {
-            lastrow = y;
-            std::cout << '\n';
-          }
-          std::cout << (val ? 'x' : '.');
-        });
-        std::cout << '\n';
-        break;
-      }
-      case summary:
-        doSummary(graph);
-        break;
-      default:
-        std::cerr << "Unknown stat requested\n";
-        break;
-      }
+    if (rdgInput) {
+      RdgGraph graph(inputfilename);
+      doStats(graph);
+    } else {
+      GrGraph graph(inputfilename);
+      doStats(graph);
     }
     return 0;
   } catch (...) {
@@ -0,0 +1,408 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <llvm/Support/CommandLine.h>
+#include <nlohmann/json.hpp>
+
+#include "galois/JSON.h"
+#include "galois/Logging.h"
+#include "galois/Uri.h"
+#include "tsuba/FileView.h"
+#include "tsuba/IOStats.h"
+#include "tsuba/RDG.h"
+#include "tsuba/file.h"
+#include "tsuba/tsuba.h"
+
+namespace cll = llvm::cl;
+
+namespace {
+
+cll::opt<std::string> directory(
+    cll::Positional,
+    cll::desc("<directory uri where the benchmark files are written>"),
+    cll::Required);
+cll::list<unsigned> sizes_mb(
+    "sizesMB", cll::desc("Comma separated file sizes (default 1,16,256)"),
+    cll::CommaSeparated);
+cll::list<unsigned> concurrencies(
+    "concurrency",
+    cll::desc("Comma separated numbers of operations in flight (default "
+              "1,4,16)"),
+    cll::CommaSeparated);
+cll::list<unsigned> block_sizes_kb(
+    "blockSizesKB",
+    cll::desc("Comma separated read sizes, and multipart part sizes of "
+              "stores (default 256,4096)"),
+    cll::CommaSeparated);
+cll::list<std::string> op_names(
+    "ops",
+    cll::desc("Comma separated paths to benchmark: store (FileStoreAsync), "
+              "get (FileGetAsync), view (FileView reads) (default: all)"),
+    cll::CommaSeparated);
+cll::opt<unsigned> repetitions(
+    "repetitions", cll::desc("Runs of each configuration (default 3)"),
+    cll::init(3));
+cll::opt<std::string> rdg_name(
+    "rdg", cll::desc("Also time RDG::Make of this RDG"), cll::init(""));
+cll::opt<bool> keep_files(
+    "keep", cll::desc("Do not delete the benchmark files at the end"),
+    cll::init(false));
+cll::opt<std::string> output_file(
+    "output", cll::desc("Write the JSON report here instead of to stdout"),
+    cll::init(""));
+
+using Clock = std::chrono::steady_clock;
+
+std::vector<unsigned>
+OrDefault(const cll::list<unsigned>& values, std::vector<unsigned> defaults) {
+  if (values.empty()) {
+    return defaults;
+  }
+  return std::vector<unsigned>(values.begin(), values.end());
+}
+
+bool
+OpSelected(const std::string& op) {
+  return op_names.empty() ||
+         std::find(op_names.begin(), op_names.end(), op) != op_names.end();
+}
+
+uint64_t
+Usec(Clock::time_point start, Clock::time_point end) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+      .count();
+}
+
+/// The results of the runs of one configuration
+struct Measurement {
+  std::vector<uint64_t> latencies_usec;
+  /// bytes moved per second of wall time in each run
+  std::vector<double> gbps;
+
+  void AddRun(uint64_t bytes, Clock::time_point start, Clock::time_point end) {
+    uint64_t usec = std::max<uint64_t>(Usec(start, end), 1);
+    gbps.emplace_back(static_cast<double>(bytes) / usec / 1e3);
+  }
+
+  nlohmann::json ToJSON() {
+    nlohmann::json j;
+    std::sort(gbps.begin(), gbps.end());
+    std::sort(latencies_usec.begin(), latencies_usec.end());
+    j["gbps_median"] = gbps.empty() ? 0 : gbps[gbps.size() / 2];
+    j["gbps_max"] = gbps.empty() ? 0 : gbps.back();
+    // nearest rank
+    auto percentile = [this](double p) -> uint64_t {
+      if (latencies_usec.empty()) {
+        return 0;
+      }
+      size_t rank = std::ceil(p / 100 * latencies_usec.size());
+      return latencies_usec[std::max<size_t>(rank, 1) - 1];
+    };
+    j["ops"] = latencies_usec.size();
+    j["latency_usec"] = {
+        {"p50", percentile(50)},
+        {"p95", percentile(95)},
+        {"p99", percentile(99)},
+        {"max", percentile(100)},
+    };
+    return j;
+  }
+};
+
+std::string
+BaseName(uint64_t size, uint32_t i) {
+  return "tsuba-bench-" + std::to_string(size) + "-" + std::to_string(i);
+}
+
+std::string
+FileName(uint64_t size, uint32_t i) {
+  return galois::Uri::JoinPath(directory, BaseName(size, i));
+}
+
+/// Stores concurrency files of size bytes at once, each in parts of
+/// block_size if it is smaller than the file
+Measurement
+BenchStore(
+    const std::vector<uint8_t>& data, uint64_t size, uint32_t concurrency,
+    uint64_t block_size, std::unordered_set<std::string>* files) {
+  Measurement m;
+  for (unsigned rep = 0; rep < repetitions; ++rep) {
+    std::vector<std::future<uint64_t>> ops;
+    auto start = Clock::now();
+    for (uint32_t i = 0; i < concurrency; ++i) {
+      std::string file = FileName(size, i);
+      files->emplace(BaseName(size, i));
+      ops.emplace_back(std::async(
+          std::launch::async, [&data, file, size, block_size]() -> uint64_t {
+            auto op_start = Clock::now();
+            auto fut = block_size < size
+                           ? tsuba::FileStoreMultipartAsync(
+                                 file, data.data(), size, block_size,
+                                 tsuba::GetMultipartConfig().concurrency)
+                           : tsuba::FileStoreAsync(file, data.data(), size);
+            if (auto res = fut.get(); !res) {
+              GALOIS_LOG_FATAL("storing {}: {}", file, res.error());
+            }
+            return Usec(op_start, Clock::now());
+          }));
+    }
+    for (auto& op : ops) {
+      m.latencies_usec.emplace_back(op.get());
+    }
+    m.AddRun(size * concurrency, start, Clock::now());
+  }
+  return m;
+}
+
+/// Reads a stored file in blocks with FileGetAsync, keeping up to
+/// concurrency blocks in flight. The latency of a block runs until the
+/// reader, which consumes blocks in order, has it.
+Measurement
+BenchGet(
+    std::vector<uint8_t>* buffer, uint64_t size, uint32_t concurrency,
+    uint64_t block_size) {
+  Measurement m;
+  std::string file = FileName(size, 0);
+  for (unsigned rep = 0; rep < repetitions; ++rep) {
+    std::deque<std::pair<std::future<galois::Result<void>>, Clock::time_point>>
+        in_flight;
+    auto finish_oldest = [&]() {
+      if (auto res = in_flight.front().first.get(); !res) {
+        GALOIS_LOG_FATAL("reading {}: {}", file, res.error());
+      }
+      m.latencies_usec.emplace_back(
+          Usec(in_flight.front().second, Clock::now()));
+      in_flight.pop_front();
+    };
+
+    auto start = Clock::now();
+    for (uint64_t off = 0; off < size; off += block_size) {
+      if (in_flight.size() == concurrency) {
+        finish_oldest();
+      }
+      uint64_t len = std::min(block_size, size - off);
+      in_flight.emplace_back(
+          tsuba::FileGetAsync(file, buffer->data() + off, off, len),
+          Clock::now());
+    }
+    while (!in_flight.empty()) {
+      finish_oldest();
+    }
+    m.AddRun(size, start, Clock::now());
+  }
+  return m;
+}
+
+/// Reads a stored file through a streaming FileView in reads of block_size
+/// with concurrency - 1 blocks of read-ahead
+Measurement
+BenchView(
+    std::vector<uint8_t>* buffer, uint64_t size, uint32_t concurrency,
+    uint64_t block_size) {
+  Measurement m;
+  std::string file = FileName(size, 0);
+  for (unsigned rep = 0; rep < repetitions; ++rep) {
+    auto start = Clock::now();
+    tsuba::FileView fv;
+    if (auto res = fv.Bind(file, 0, 0, false); !res) {
+      GALOIS_LOG_FATAL("binding {}: {}", file, res.error());
+    }
+    fv.SetStreaming(block_size * (concurrency - 1), true);
+    for (uint64_t off = 0; off < size; off += block_size) {
+      auto read_start = Clock::now();
+      auto res = fv.Read(block_size, buffer->data());
+      if (!res.ok()) {
+        GALOIS_LOG_FATAL("reading {}: {}", file, res.status());
+      }
+      m.latencies_usec.emplace_back(Usec(read_start, Clock::now()));
+    }
+    m.AddRun(size, start, Clock::now());
+  }
+  return m;
+}
+
+/// Bytes read from storage so far, including mapped files
+uint64_t
+BytesRead() {
+  uint64_t bytes = 0;
+  for (const tsuba::IOStatsEntry& entry : tsuba::GetIOStats()) {
+    if (entry.op == tsuba::IOOp::kGet || entry.op == tsuba::IOOp::kMmap) {
+      bytes += entry.stats.bytes;
+    }
+  }
+  return bytes;
+}
+
+nlohmann::json
+BenchRDG() {
+  auto handle_res = tsuba::Open(rdg_name, tsuba::kReadOnly);
+  if (!handle_res) {
+    GALOIS_LOG_FATAL("opening {}: {}", rdg_name.getValue(), handle_res.error());
+  }
+  tsuba::RDGHandle handle = handle_res.value();
+
+  std::vector<uint64_t> times_usec;
+  nlohmann::json gbps = nlohmann::json::array();
+  for (unsigned rep = 0; rep < repetitions; ++rep) {
+    uint64_t bytes_before = BytesRead();
+    auto start = Clock::now();
+    auto rdg_res = tsuba::RDG::Make(handle);
+    auto end = Clock::now();
+    if (!rdg_res) {
+      GALOIS_LOG_FATAL("loading {}: {}", rdg_name.getValue(), rdg_res.error());
+    }
+    uint64_t usec = std::max<uint64_t>(Usec(start, end), 1);
+    times_usec.emplace_back(usec);
+    uint64_t bytes = BytesRead() - bytes_before;
+    gbps.push_back(static_cast<double>(bytes) / usec / 1e3);
+  }
+
+  if (auto res = tsuba::Close(handle); !res) {
+    GALOIS_LOG_ERROR("closing {}: {}", rdg_name.getValue(), res.error());
+  }
+  return nlohmann::json{
+      {"op", "rdg_make"},
+      {"rdg", rdg_name.getValue()},
+      {"times_usec", times_usec},
+      {"gbps", gbps},
+  };
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  llvm::cl::ParseCommandLineOptions(
+      argc, argv, "Measures tsuba storage throughput and latency\n");
+  if (auto res = tsuba::Init(); !res) {
+    GALOIS_LOG_FATAL("tsuba::Init: {}", res.error());
+  }
+
+  std::vector<unsigned> sizes = OrDefault(sizes_mb, {1, 16, 256});
+  std::vector<unsigned> concurrency_list = OrDefault(concurrencies, {1, 4, 16});
+  std::vector<unsigned> block_sizes = OrDefault(block_sizes_kb, {256, 4096});
+  for (const auto* list : {&sizes, &concurrency_list, &block_sizes}) {
+    if (std::find(list->begin(), list->end(), 0) != list->end()) {
+      GALOIS_LOG_FATAL("sizes, concurrency and block sizes must be positive");
+    }
+  }
+
+  nlohmann::json results = nlohmann::json::array();
+  auto add_result = [&](const std::string& op, uint64_t size,
+                        uint32_t concurrency, uint64_t block_size,
+                        Measurement m) {
+    nlohmann::json j = m.ToJSON();
+    j["op"] = op;
+    j["size_bytes"] = size;
+    j["concurrency"] = concurrency;
+    j["block_size_bytes"] = block_size;
+    results.push_back(std::move(j));
+  };
+
+  std::unordered_set<std::string> files;
+  for (uint64_t size_mb : sizes) {
+    uint64_t size = size_mb << 20;
+    std::vector<uint8_t> data(size);
+    // not all zeroes, which a backend might store more cheaply
+    uint64_t x = 88172645463325252ULL;
+    for (uint8_t& b : data) {
+      x ^= x << 13;
+      x ^= x >> 7;
+      x ^= x << 17;
+      b = static_cast<uint8_t>(x);
+    }
+
+    // the reads need a file to read
+    if (!OpSelected("store")) {
+      if (auto res = tsuba::FileStore(FileName(size, 0), data.data(), size);
+          !res) {
+        GALOIS_LOG_FATAL("storing {}: {}", FileName(size, 0), res.error());
+      }
+      files.emplace(BaseName(size, 0));
+    }
+
+    for (uint32_t concurrency : concurrency_list) {
+      for (uint64_t block_kb : block_sizes) {
+        uint64_t block_size = block_kb << 10;
+        if (OpSelected("store")) {
+          add_result(
+              "store", size, concurrency, block_size,
+              BenchStore(data, size, concurrency, block_size, &files));
+        }
+        if (OpSelected("get")) {
+          add_result(
+              "get", size, concurrency, block_size,
+              BenchGet(&data, size, concurrency, block_size));
+        }
+        if (OpSelected("view")) {
+          add_result(
+              "view", size, concurrency, block_size,
+              BenchView(&data, size, concurrency, block_size));
+        }
+      }
+    }
+  }
+
+  if (!rdg_name.empty()) {
+    results.push_back(BenchRDG());
+  }
+
+  if (!keep_files && !files.empty()) {
+    if (auto res = tsuba::FileDelete(directory, files); !res) {
+      GALOIS_LOG_ERROR("deleting benchmark files: {}", res.error());
+    }
+  }
+
+  nlohmann::json report{
+      {"directory", directory.getValue()},
+      {"repetitions", repetitions.getValue()},
+      {"results", std::move(results)},
+  };
+  auto dumped = galois::JsonDump(report);
+  if (!dumped) {
+    GALOIS_LOG_FATAL("cannot print report: {}", dumped.error());
+  }
+  if (output_file.empty()) {
+    std::cout << dumped.value() << "\n";
+  } else {
+    std::ofstream out(output_file);
+    out << dumped.value() << "\n";
+    if (!out) {
+      GALOIS_LOG_FATAL("cannot write {}", output_file.getValue());
+    }
+  }
+
+  if (auto res = tsuba::Fini(); !res) {
+    GALOIS_LOG_FATAL("tsuba::Fini: {}", res.error());
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,444 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+#include <arrow/flight/api.h>
+#include <fmt/format.h>
+#include <llvm/Support/CommandLine.h>
+#include <nlohmann/json.hpp>
+
+#include "galois/JSON.h"
+#include "galois/Logging.h"
+#include "tsuba/RDG.h"
+#include "tsuba/RDGPrefix.h"
+#include "tsuba/RDGSlice.h"
+#include "tsuba/file.h"
+#include "tsuba/tsuba.h"
+
+namespace cll = llvm::cl;
+namespace flight = arrow::flight;
+
+namespace {
+
+cll::opt<std::string> host(
+    "host", cll::desc("Address to listen on (default 0.0.0.0)"),
+    cll::init("0.0.0.0"));
+cll::opt<int> port(
+    "port", cll::desc("Port to listen on (default 8815)"), cll::init(8815));
+cll::opt<uint32_t> default_slices(
+    "slices",
+    cll::desc("Edge-balanced slices per request that names none (default 16)"),
+    cll::init(16));
+cll::opt<int64_t> batch_rows(
+    "batchRows", cll::desc("Rows per record batch (default 65536)"),
+    cll::init(65536));
+
+/// The 8-byte words of the header of a topology file: version, edge data
+/// size, number of nodes and number of edges
+constexpr uint64_t kTopologyHeaderSize = 4 * sizeof(uint64_t);
+
+/// The topology version whose out indices and 32-bit destinations can be
+/// read by range (\see tsuba::RDGSlice)
+constexpr uint64_t kSliceableTopologyVersion = 1;
+
+/// The columns that streams add before the properties: the end of the edges
+/// of each node, and the destination of each edge
+constexpr char kOutIndexColumn[] = "out_index";
+constexpr char kDestColumn[] = "dest";
+
+/// What a stream reads: the nodes (or edges) [begin, end) of a version of an
+/// RDG, with the named properties or all of them. Tickets hold it as JSON.
+struct Request {
+  std::string rdg;
+  uint64_t version{0};
+  bool nodes{true};
+  uint64_t begin{0};
+  uint64_t end{0};
+  uint64_t num_nodes{0};
+  std::optional<std::vector<std::string>> properties;
+};
+
+void
+to_json(nlohmann::json& j, const Request& request) {
+  j = nlohmann::json{
+      {"rdg", request.rdg},
+      {"version", request.version},
+      {"table", request.nodes ? "nodes" : "edges"},
+      {"begin", request.begin},
+      {"end", request.end},
+      {"num_nodes", request.num_nodes},
+  };
+  if (request.properties) {
+    j["properties"] = *request.properties;
+  }
+}
+
+arrow::Status
+ErrorStatus(const std::string& what, const std::error_code& error) {
+  return arrow::Status::IOError(fmt::format("{}: {}", what, error));
+}
+
+/// Parse the JSON of a ticket, or of the command of a descriptor, which has
+/// no version, range nor number of nodes, but may have a number of "slices"
+arrow::Status
+ParseRequest(
+    const std::string& s, Request* request, uint32_t* slices = nullptr) {
+  try {
+    auto j = nlohmann::json::parse(s);
+    j.at("rdg").get_to(request->rdg);
+    std::string table = j.value("table", "nodes");
+    if (table != "nodes" && table != "edges") {
+      return arrow::Status::Invalid("table must be nodes or edges: ", table);
+    }
+    request->nodes = table == "nodes";
+    request->version = j.value("version", uint64_t{0});
+    request->begin = j.value("begin", uint64_t{0});
+    request->end = j.value("end", uint64_t{0});
+    request->num_nodes = j.value("num_nodes", uint64_t{0});
+    if (j.contains("properties")) {
+      request->properties = j["properties"].get<std::vector<std::string>>();
+    }
+    if (slices != nullptr) {
+      *slices = j.value("slices", default_slices.getValue());
+    }
+  } catch (const std::exception& e) {
+    return arrow::Status::Invalid("malformed request: ", e.what());
+  }
+  if (request->begin > request->end) {
+    return arrow::Status::Invalid("empty range");
+  }
+  return arrow::Status::OK();
+}
+
+/// A tsuba::RDGHandle that is closed when it goes out of scope
+class Handle {
+  tsuba::RDGHandle handle_;
+
+public:
+  explicit Handle(tsuba::RDGHandle handle) : handle_(handle) {}
+  Handle(const Handle&) = delete;
+  Handle& operator=(const Handle&) = delete;
+  ~Handle() {
+    if (auto res = tsuba::Close(handle_); !res) {
+      GALOIS_LOG_WARN("closing RDG handle: {}", res.error());
+    }
+  }
+
+  tsuba::RDGHandle get() const { return handle_; }
+};
+
+/// Memory of the topology of a slice, which the buffer keeps alive so that
+/// batches can refer to it without copies
+class SliceBuffer : public arrow::Buffer {
+  std::shared_ptr<const tsuba::RDGSlice> slice_;
+
+public:
+  SliceBuffer(
+      std::shared_ptr<const tsuba::RDGSlice> slice, const uint8_t* data,
+      int64_t size)
+      : arrow::Buffer(data, size), slice_(std::move(slice)) {}
+};
+
+/// Cuts a table into record batches of batch_rows rows, without copies
+class TableReader : public arrow::RecordBatchReader {
+  std::shared_ptr<arrow::Table> table_;
+  arrow::TableBatchReader reader_;
+
+public:
+  explicit TableReader(std::shared_ptr<arrow::Table> table)
+      : table_(std::move(table)), reader_(*table_) {
+    reader_.set_chunksize(batch_rows);
+  }
+
+  std::shared_ptr<arrow::Schema> schema() const override {
+    return table_->schema();
+  }
+
+  arrow::Status ReadNext(std::shared_ptr<arrow::RecordBatch>* batch) override {
+    return reader_.ReadNext(batch);
+  }
+};
+
+/// The schema of streams of request, and whether the RDG can be sliced; the
+/// properties are read from the metadata of the property files only
+arrow::Status
+StreamSchema(
+    tsuba::RDGHandle handle, const Request& request,
+    std::shared_ptr<arrow::Schema>* schema) {
+  const std::vector<std::string> none;
+  const std::vector<std::string>* properties =
+      request.properties ? &*request.properties : nullptr;
+  auto rdg_res = request.nodes
+                     ? tsuba::RDG::MakeLazy(handle, properties, &none)
+                     : tsuba::RDG::MakeLazy(handle, &none, properties);
+  if (!rdg_res) {
+    return ErrorStatus("reading schema", rdg_res.error());
+  }
+  const tsuba::RDG& rdg = rdg_res.value();
+  std::shared_ptr<arrow::Schema> table_schema =
+      request.nodes ? rdg.node_table()->schema() : rdg.edge_table()->schema();
+
+  std::vector<std::shared_ptr<arrow::Field>> fields{
+      request.nodes ? arrow::field(kOutIndexColumn, arrow::uint64(), false)
+                    : arrow::field(kDestColumn, arrow::uint32(), false)};
+  for (const auto& field : table_schema->fields()) {
+    fields.emplace_back(field);
+  }
+  *schema = arrow::schema(fields);
+  return arrow::Status::OK();
+}
+
+/// Load the properties and the topology of the range of request: the out
+/// indices of the nodes or the destinations of the edges, read from their
+/// offsets in the topology file through the block cache of tsuba
+arrow::Status
+LoadSlice(const Request& request, std::shared_ptr<arrow::Table>* table) {
+  auto handle_res = tsuba::Open(request.rdg, request.version, tsuba::kReadOnly);
+  if (!handle_res) {
+    return ErrorStatus("opening " + request.rdg, handle_res.error());
+  }
+  Handle handle(handle_res.value());
+
+  uint64_t length = request.end - request.begin;
+  uint64_t width = request.nodes ? sizeof(uint64_t) : sizeof(uint32_t);
+  uint64_t topology_begin = request.nodes
+                                ? kTopologyHeaderSize
+                                : kTopologyHeaderSize +
+                                      request.num_nodes * sizeof(uint64_t);
+  tsuba::RDGSlice::SliceArg arg{
+      .node_range = {0, 0},
+      .edge_range = {0, 0},
+      .topo_off = topology_begin + request.begin * width,
+      .topo_size = length * width,
+  };
+  if (request.nodes) {
+    arg.node_range = {request.begin, request.end};
+  } else {
+    arg.edge_range = {request.begin, request.end};
+  }
+
+  const std::vector<std::string> none;
+  const std::vector<std::string>* properties =
+      request.properties ? &*request.properties : nullptr;
+  auto slice_res =
+      request.nodes
+          ? tsuba::RDGSlice::Make(handle.get(), arg, properties, &none)
+          : tsuba::RDGSlice::Make(handle.get(), arg, &none, properties);
+  if (!slice_res) {
+    return ErrorStatus("loading slice", slice_res.error());
+  }
+  auto slice =
+      std::make_shared<const tsuba::RDGSlice>(std::move(slice_res.value()));
+
+  auto topology = std::make_shared<SliceBuffer>(
+      slice, slice->topology_file_storage().ptr<uint8_t>(arg.topo_off),
+      arg.topo_size);
+  std::shared_ptr<arrow::Array> topology_array;
+  if (request.nodes) {
+    topology_array = std::make_shared<arrow::UInt64Array>(length, topology);
+  } else {
+    topology_array = std::make_shared<arrow::UInt32Array>(length, topology);
+  }
+
+  const std::shared_ptr<arrow::Table>& properties_table =
+      request.nodes ? slice->node_table() : slice->edge_table();
+  std::vector<std::shared_ptr<arrow::Field>> fields{arrow::field(
+      request.nodes ? kOutIndexColumn : kDestColumn, topology_array->type(),
+      false)};
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns{
+      std::make_shared<arrow::ChunkedArray>(topology_array)};
+  if (properties_table) {
+    for (int i = 0; i < properties_table->num_columns(); ++i) {
+      fields.emplace_back(properties_table->field(i));
+      columns.emplace_back(properties_table->column(i));
+    }
+  }
+  *table = arrow::Table::Make(arrow::schema(fields), columns, length);
+  return arrow::Status::OK();
+}
+
+/// Serves ranges of the nodes or edges of RDGs with their properties as
+/// streams of record batches.
+///
+/// GetFlightInfo takes a command descriptor, JSON of the form
+///
+///   {"rdg": "s3://bucket/graph", "table": "nodes" or "edges",
+///    "properties": ["name", ...], "slices": 16}
+///
+/// where everything but "rdg" is optional: the table defaults to nodes and
+/// the properties to all of them. It returns the schema of the streams and
+/// one endpoint per edge-balanced slice (\see
+/// tsuba::RDGSlice::EdgeBalancedSlices), whose ticket reads the nodes or the
+/// edges of the slice from the version of the RDG that was latest then.
+/// Clients read the endpoints in parallel, e.g., one per Spark task.
+///
+/// Node streams start with column out_index, the end of the edges of each
+/// node; edge streams start with column dest, the destination of each edge.
+///
+/// DoAction "stats" returns the counters of the block cache of tsuba as
+/// JSON.
+class TsubaFlightServer : public flight::FlightServerBase {
+public:
+  arrow::Status GetFlightInfo(
+      const flight::ServerCallContext&,
+      const flight::FlightDescriptor& descriptor,
+      std::unique_ptr<flight::FlightInfo>* info) override {
+    if (descriptor.type != flight::FlightDescriptor::CMD) {
+      return arrow::Status::Invalid("expected a command descriptor");
+    }
+    Request request;
+    uint32_t num_slices = 0;
+    ARROW_RETURN_NOT_OK(ParseRequest(descriptor.cmd, &request, &num_slices));
+    if (num_slices == 0) {
+      return arrow::Status::Invalid("slices must be positive");
+    }
+
+    auto handle_res = tsuba::Open(request.rdg, tsuba::kReadOnly);
+    if (!handle_res) {
+      return ErrorStatus("opening " + request.rdg, handle_res.error());
+    }
+    Handle handle(handle_res.value());
+    request.version = tsuba::Version(handle.get());
+
+    std::shared_ptr<arrow::Schema> schema;
+    ARROW_RETURN_NOT_OK(StreamSchema(handle.get(), request, &schema));
+
+    auto prefix_res = tsuba::RDGPrefix::Make(handle.get());
+    if (!prefix_res) {
+      return ErrorStatus("reading topology", prefix_res.error());
+    }
+    const tsuba::RDGPrefix& prefix = prefix_res.value();
+    if (!prefix.Valid() || prefix.version() != kSliceableTopologyVersion) {
+      return arrow::Status::NotImplemented(
+          "cannot slice the topology of ", request.rdg);
+    }
+    request.num_nodes = prefix.num_nodes();
+
+    std::vector<flight::FlightEndpoint> endpoints;
+    for (const tsuba::RDGSlice::SliceArg& slice :
+         tsuba::RDGSlice::EdgeBalancedSlices(prefix, num_slices)) {
+      std::tie(request.begin, request.end) =
+          request.nodes ? slice.node_range : slice.edge_range;
+      if (request.begin == request.end) {
+        continue;
+      }
+      auto ticket_res = galois::JsonDump(request);
+      if (!ticket_res) {
+        return ErrorStatus("making ticket", ticket_res.error());
+      }
+      endpoints.emplace_back(
+          flight::FlightEndpoint{{std::move(ticket_res.value())}, {}});
+    }
+
+    int64_t rows = request.nodes ? prefix.num_nodes() : prefix.num_edges();
+    ARROW_ASSIGN_OR_RAISE(
+        auto made,
+        flight::FlightInfo::Make(*schema, descriptor, endpoints, rows, -1));
+    *info = std::make_unique<flight::FlightInfo>(std::move(made));
+    return arrow::Status::OK();
+  }
+
+  arrow::Status DoGet(
+      const flight::ServerCallContext&, const flight::Ticket& ticket,
+      std::unique_ptr<flight::FlightDataStream>* stream) override {
+    Request request;
+    ARROW_RETURN_NOT_OK(ParseRequest(ticket.ticket, &request));
+
+    std::shared_ptr<arrow::Table> table;
+    ARROW_RETURN_NOT_OK(LoadSlice(request, &table));
+    *stream = std::make_unique<flight::RecordBatchStream>(
+        std::make_shared<TableReader>(std::move(table)));
+    return arrow::Status::OK();
+  }
+
+  arrow::Status ListActions(
+      const flight::ServerCallContext&,
+      std::vector<flight::ActionType>* actions) override {
+    *actions = {{"stats", "Counters of the block cache as JSON"}};
+    return arrow::Status::OK();
+  }
+
+  arrow::Status DoAction(
+      const flight::ServerCallContext&, const flight::Action& action,
+      std::unique_ptr<flight::ResultStream>* result) override {
+    if (action.type != "stats") {
+      return arrow::Status::NotImplemented("unknown action ", action.type);
+    }
+    tsuba::BlockCacheStats stats = tsuba::GetBlockCacheStats();
+    auto json_res = galois::JsonDump(nlohmann::json{
+        {"hits", stats.hits},
+        {"misses", stats.misses},
+        {"evictions", stats.evictions},
+        {"bytes", stats.bytes},
+    });
+    if (!json_res) {
+      return ErrorStatus("dumping stats", json_res.error());
+    }
+    std::vector<flight::Result> results{
+        {arrow::Buffer::FromString(std::move(json_res.value()))}};
+    *result = std::make_unique<flight::SimpleResultStream>(std::move(results));
+    return arrow::Status::OK();
+  }
+};
+
+arrow::Status
+Serve() {
+  flight::Location location;
+  ARROW_RETURN_NOT_OK(flight::Location::ForGrpcTcp(host, port, &location));
+  flight::FlightServerOptions options(location);
+
+  TsubaFlightServer server;
+  ARROW_RETURN_NOT_OK(server.Init(options));
+  ARROW_RETURN_NOT_OK(server.SetShutdownOnSignals({SIGINT, SIGTERM}));
+  GALOIS_LOG_VERBOSE("serving RDGs on {}:{}", host, server.port());
+  return server.Serve();
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  llvm::cl::ParseCommandLineOptions(
+      argc, argv, "Serves slices of RDGs over Arrow Flight\n");
+  if (auto res = tsuba::Init(); !res) {
+    GALOIS_LOG_FATAL("tsuba::Init: {}", res.error());
+  }
+
+  int ret = EXIT_SUCCESS;
+  if (arrow::Status status = Serve(); !status.ok()) {
+    GALOIS_LOG_ERROR("serving: {}", status.ToString());
+    ret = EXIT_FAILURE;
+  }
+
+  if (auto res = tsuba::Fini(); !res) {
+    GALOIS_LOG_FATAL("tsuba::Fini: {}", res.error());
+  }
+  return ret;
+}
@@ -0,0 +1,71 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <fmt/format.h>
+#include <llvm/Support/CommandLine.h>
+
+#include "galois/Logging.h"
+#include "tsuba/tsuba.h"
+
+namespace cll = llvm::cl;
+
+namespace {
+
+cll::list<std::string> rdg_names(
+    cll::Positional, cll::desc("<rdg names>"), cll::OneOrMore);
+cll::opt<unsigned> keep_versions(
+    "keep", cll::desc("Latest versions whose files are kept (default 1)"),
+    cll::init(1));
+cll::opt<bool> dry_run(
+    "dryRun", cll::desc("Only report what would be deleted"), cll::init(false));
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  llvm::cl::ParseCommandLineOptions(
+      argc, argv, "Deletes the files of old versions of RDGs\n");
+  if (auto res = tsuba::Init(); !res) {
+    GALOIS_LOG_FATAL("tsuba::Init: {}", res.error());
+  }
+
+  int ret = EXIT_SUCCESS;
+  for (const std::string& name : rdg_names) {
+    auto res = tsuba::GarbageCollect(name, keep_versions, dry_run);
+    if (!res) {
+      GALOIS_LOG_ERROR("collecting {}: {}", name, res.error());
+      ret = EXIT_FAILURE;
+      continue;
+    }
+    const tsuba::GarbageCollectStats& stats = res.value();
+    std::cout << fmt::format(
+        "{}: kept {} versions, {} {} files ({} bytes)\n", name,
+        stats.versions_kept, dry_run ? "would delete" : "deleted",
+        stats.files_deleted, stats.bytes_deleted);
+  }
+
+  if (auto res = tsuba::Fini(); !res) {
+    GALOIS_LOG_FATAL("tsuba::Fini: {}", res.error());
+  }
+  return ret;
+}